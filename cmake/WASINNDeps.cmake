@@ -30,11 +30,13 @@ function(wasmedge_setup_wasinn_target target)
       target_compile_definitions(${target} PUBLIC WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINOGENAI)
       find_package(OpenVINO REQUIRED)
       find_package(OpenVINOGenAI REQUIRED)
+      wasmedge_setup_simdjson()
       target_link_libraries(${target}
         PRIVATE
         openvino::runtime
         openvino::runtime::c
         openvino::genai
+        simdjson::simdjson
       )
     elseif(BACKEND STREQUAL "pytorch")
       if(WASMEDGE_WASINNDEPS_${target}_PLUGINLIB)
@@ -46,6 +48,10 @@ function(wasmedge_setup_wasinn_target target)
         PRIVATE
         ${TORCH_LIBRARIES}
       )
+      if(TARGET c10_cuda)
+        # Replay the computes on CUDA as CUDA graphs.
+        target_compile_definitions(${target} PRIVATE WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA)
+      endif()
       target_compile_options(${target}
         PRIVATE
         -Wno-error=unused-parameter
@@ -89,6 +95,7 @@ function(wasmedge_setup_wasinn_target target)
       target_compile_definitions(${target}
         PRIVATE
         PYTHON_LIB_PATH="${Python3_LIBRARIES}"
+        PYTHON_EXECUTABLE="${Python3_EXECUTABLE}"
       )
       target_include_directories(${target}
         PRIVATE
@@ -28,6 +28,11 @@ public:
   void update(Span<const Byte> Data) noexcept;
   void finalize(Span<Byte> Output) noexcept;
 
+  /// Hash the whole data at once. The chunks of the large data are hashed on
+  /// the worker threads, and the result equals the one of update() and
+  /// finalize().
+  static void hash(Span<const Byte> Data, Span<Byte> Output) noexcept;
+
 private:
   blake3_hasher Hasher;
 };
@@ -13,26 +13,130 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/configure.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
 #include "common/span.h"
 #include "common/types.h"
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace WasmEdge {
 namespace AOT {
 
 /// Caching compiled module.
+///
+/// The entries are shared by the processes. They are published by renaming a
+/// complete temporary file, compiled once under a lock file when several
+/// processes miss the same entry, and evicted from the least recently used
+/// when a cache directory grows over the size limit. The local misses can be
+/// fetched from a remote store shared by the hosts.
 class Cache {
 public:
   enum class StorageScope {
     Global,
     Local,
   };
+
+  /// Remote store of the entries, addressed by the names from getRemoteName.
+  class RemoteBackend {
+  public:
+    virtual ~RemoteBackend() noexcept = default;
+    /// Get the entry, or std::nullopt if missing or failed.
+    virtual std::optional<std::vector<Byte>>
+    get(std::string_view Name) noexcept = 0;
+    /// Put the entry. Return false if failed.
+    virtual bool put(std::string_view Name, Span<const Byte> Data) noexcept = 0;
+  };
+
+  /// Exclusive lock of an entry across the processes, released when
+  /// destroyed. The locks are advisory and not supported on Windows, where
+  /// every lock is owned.
+  class Lock {
+  public:
+    Lock() noexcept = default;
+    Lock(Lock &&RHS) noexcept : Fd(std::exchange(RHS.Fd, -1)) {}
+    Lock &operator=(Lock &&RHS) noexcept {
+      std::swap(Fd, RHS.Fd);
+      return *this;
+    }
+    ~Lock() noexcept;
+
+    /// Lock the entry, waiting at most the timeout for the other holder.
+    static Lock acquire(const std::filesystem::path &Path,
+                        std::chrono::milliseconds Timeout) noexcept;
+
+    bool owns() const noexcept { return Fd != -1; }
+
+  private:
+    /// The lock file, or -2 if owned without one.
+    int Fd = -1;
+  };
+
   static Expect<std::filesystem::path>
   getPath(Span<const Byte> Data, StorageScope Scope, std::string_view Key = {});
+  /// Get the path of the data compiled under the configuration by this
+  /// runtime version.
+  static Expect<std::filesystem::path> getPath(Span<const Byte> Data,
+                                               const Configure &Conf,
+                                               StorageScope Scope,
+                                               std::string_view Key = {});
+  /// Get the path like above of the data mapped from the file. The hash of
+  /// the file unchanged since the last lookup, by its inode, size, and
+  /// modification time, is reused instead of hashing the data again.
+  static Expect<std::filesystem::path>
+  getPath(Span<const Byte> Data, const std::filesystem::path &File,
+          const Configure &Conf, StorageScope Scope, std::string_view Key = {});
+
+  /// Write the entry through a temporary file, so that the concurrent readers
+  /// never see a partial entry.
+  static Expect<void> publish(const std::filesystem::path &Path,
+                              Span<const Byte> Data) noexcept;
+  /// Record the use of the entry for the eviction, if it exists.
+  static void touch(const std::filesystem::path &Path) noexcept;
+  /// Remove the least recently used entries of the directory until it is
+  /// within the size limit. The locked entries are kept.
+  static void evict(const std::filesystem::path &Dir) noexcept;
+
+  /// Set the size limit of every cache directory. Zero disables the eviction.
+  static void setMaxSize(uint64_t Bytes) noexcept;
+  static uint64_t getMaxSize() noexcept;
+
+  /// Set the root of the local entries instead of the cache directory in the
+  /// home directory. An empty path restores the default.
+  static void setLocalRoot(std::filesystem::path Root) noexcept;
+
+  /// Remove the entries not locked by a compilation.
   static void clear(StorageScope Scope, std::string_view Key = {});
+
+  /// Create the backend getting and putting the entries at `URL/Name` by
+  /// HTTP/1.1, e.g. an S3 compatible bucket or a gateway of one. Only the
+  /// `http://` URLs are supported, so the HTTPS and the request signing are
+  /// left to the gateway or a custom backend.
+  static std::shared_ptr<RemoteBackend>
+  createHTTPBackend(std::string_view URL) noexcept;
+  /// Set the remote store, and whether the compiled entries are put into it.
+  static void setRemote(std::shared_ptr<RemoteBackend> Backend,
+                        bool Upload) noexcept;
+  /// Get the name of the entry in the remote store, with the target triple
+  /// and CPU the entry is compiled for.
+  static std::string getRemoteName(const std::filesystem::path &Path,
+                                   std::string_view Target);
+  /// Fetch the entry from the remote store into the path.
+  ///
+  /// @return True if the entry is published.
+  static bool fetch(const std::filesystem::path &Path,
+                    std::string_view Target) noexcept;
+  /// Put the entry into the remote store if the upload is enabled.
+  static void upload(const std::filesystem::path &Path, std::string_view Target,
+                     Span<const Byte> Data) noexcept;
 };
 
 } // namespace AOT
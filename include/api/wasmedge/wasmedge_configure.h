@@ -157,6 +157,70 @@ WasmEdge_ConfigureSetMaxMemoryPage(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern uint32_t
 WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the default memory budget of the instantiated module instances.
+///
+/// The budget accounts the memory instances, table instances, and GC objects
+/// owned by a module instance. The `memory.grow` and `table.grow` fail when
+/// exceeding the soft limit, and the instantiation and GC allocations fail
+/// when exceeding the hard limit.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the memory budget.
+/// \param SoftLimit the soft limit in bytes. 0 for no limit.
+/// \param HardLimit the hard limit in bytes. 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetMemoryBudget(WasmEdge_ConfigureContext *Cxt,
+                                  const uint64_t SoftLimit,
+                                  const uint64_t HardLimit);
+
+/// Get the soft limit of the default memory budget.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the setting.
+///
+/// \returns the soft limit in bytes. 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern uint64_t WasmEdge_ConfigureGetMemoryBudgetSoftLimit(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Get the hard limit of the default memory budget.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the setting.
+///
+/// \returns the hard limit in bytes. 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern uint64_t WasmEdge_ConfigureGetMemoryBudgetHardLimit(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the threshold of collecting the unreachable GC objects.
+///
+/// Once the GC objects allocated by a module instance in the interpreter
+/// since the last collection exceed the threshold, the objects unreachable
+/// from the interpreter stacks and from the globals, tables, and element
+/// segments of the module instance are released. The references held only by
+/// the host or by the other module instances are not kept alive, and should
+/// be stored into a global or a table of the module instance instead.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the threshold.
+/// \param Bytes the threshold in bytes. 0 for never collecting.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetGCThreshold(WasmEdge_ConfigureContext *Cxt,
+                                 const uint64_t Bytes);
+
+/// Get the threshold of collecting the unreachable GC objects.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the setting.
+///
+/// \returns the threshold in bytes. 0 for never collecting.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureGetGCThreshold(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the force interpreter mode execution option.
 ///
 /// This function is thread-safe.
@@ -201,6 +265,500 @@ WasmEdge_ConfigureSetAllowAFUNIX(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureIsAllowAFUNIX(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the option of fusing the common instruction sequences into
+/// super-instructions for the interpreter.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to fuse the instruction
+/// sequences when validating or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableSuperInstructions(WasmEdge_ConfigureContext *Cxt,
+                                             const bool IsEnable);
+
+/// Get the EnableSuperInstructions option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to fuse the instruction sequences
+/// for the interpreter or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureIsEnableSuperInstructions(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the value stack size of the interpreter.
+///
+/// A non-zero size makes the interpreter use a fixed-capacity value stack of
+/// this many entries, guarded by an inaccessible page, instead of the growable
+/// one. The execution fails with the stack overflow error when the value stack
+/// is exhausted.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the value stack size.
+/// \param Size the value stack size in entries. 0 for the growable value
+/// stack.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetValueStackSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t Size);
+
+/// Get the setting of the value stack size of the interpreter.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the value stack size.
+///
+/// \returns the value stack size in entries.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetValueStackSize(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the option of referencing the data segments and custom sections in the
+/// memory-mapped WASM file instead of copying them when loading.
+///
+/// The WASM file must not be modified while the loaded module is alive.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to load the WASM file
+/// without copying the data or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableZeroCopyLoad(WasmEdge_ConfigureContext *Cxt,
+                                        const bool IsEnable);
+
+/// Get the EnableZeroCopyLoad option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to load the WASM file without
+/// copying the data or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableZeroCopyLoad(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value to decode and validate the function bodies lazily.
+///
+/// The function bodies are decoded and validated at their first call in
+/// interpreter mode, or before the AOT or JIT compilation. The validation
+/// errors of the function bodies are reported at that time.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to load the function bodies
+/// lazily or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableLazyFunctionBody(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsEnable);
+
+/// Get the EnableLazyFunctionBody option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to load the function bodies lazily
+/// or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureIsEnableLazyFunctionBody(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value to trust the AOT compiled code.
+///
+/// The AOT section of a universal WASM file is used only if it matches the
+/// hash of the module bytes embedded by the compiler, and the function bodies
+/// are then neither decoded nor validated. The function bodies of an AOT
+/// compiled shared library are always skipped in this mode.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to trust the AOT compiled
+/// code or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableTrustedAOT(WasmEdge_ConfigureContext *Cxt,
+                                      const bool IsEnable);
+
+/// Get the EnableTrustedAOT option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to trust the AOT compiled code or
+/// not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableTrustedAOT(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the thread count to validate the function bodies.
+///
+/// Each thread validates a part of the function bodies with its own checker.
+/// Default is 1 for validating in the calling thread, and 0 for the hardware
+/// concurrency.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Count the thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetValidationThreadCount(WasmEdge_ConfigureContext *Cxt,
+                                           const uint32_t Count);
+
+/// Get the thread count to validate the function bodies.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ConfigureGetValidationThreadCount(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the thread count to decode the function bodies.
+///
+/// The loader passes over the boundaries of the function bodies in the code
+/// section first, and each thread decodes a part of them. Not applied to the
+/// lazy loading mode and the streaming input. Default is 1 for decoding in the
+/// calling thread, and 0 for the hardware concurrency.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the thread count.
+/// \param Count the thread count.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetLoadingThreadCount(WasmEdge_ConfigureContext *Cxt,
+                                        const uint32_t Count);
+
+/// Get the thread count to decode the function bodies.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the thread count.
+///
+/// \returns the thread count.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ConfigureGetLoadingThreadCount(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the count of the released linear memory reservations kept for reuse.
+///
+/// The reserved address space of a released memory instance is reset and
+/// reused by the later memory instances instead of being unmapped. The pool is
+/// process-wide and applied when an executor or VM is created with this
+/// configure. Default is 0 for not changing the pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the pool size.
+/// \param Count the count of the kept reservations.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetMemoryPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t Count);
+
+/// Get the count of the released linear memory reservations kept for reuse.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the pool size.
+///
+/// \returns the count of the kept reservations.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetMemoryPoolSize(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the page count of the striped linear memories.
+///
+/// The later linear memories, whose maximum is at most the page count, are
+/// striped into the slots of one shared address space reservation instead of
+/// reserving 12 GiB for each, and the compiled code of a module instance is
+/// isolated from the memories of the others by the memory protection keys.
+/// The slots may be enlarged when the keys are not enough. The setting is
+/// process-wide and enabled once when an executor or VM is created with this
+/// configure, which should be before creating the threads accessing the
+/// memories. Only supported on x86-64 Linux with the protection keys, and
+/// ignored elsewhere. Default is 0 for not enabling it.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the page count.
+/// \param Pages the maximum page count of the striped memories.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetStripedMemoryPages(WasmEdge_ConfigureContext *Cxt,
+                                        const uint32_t Pages);
+
+/// Get the page count of the striped linear memories.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the page count.
+///
+/// \returns the maximum page count of the striped memories.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureGetStripedMemoryPages(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value of the memory image mode.
+///
+/// The initialized memories of a module are recorded at its first
+/// instantiation, and the memories of the later instances of the same AST
+/// module are mapped copy-on-write from the records instead of copying the
+/// data segments. Modules whose data segments have non-constant offsets or
+/// target imported memories are instantiated as usual.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to use the memory images or
+/// not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableMemoryImage(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnable);
+
+/// Get the EnableMemoryImage option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the memory images or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableMemoryImage(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value of backing the linear memories with huge pages.
+///
+/// The later linear memories are aligned to and backed with the transparent
+/// huge pages. The setting is process-wide and applied when an executor or VM
+/// is created with this configure. The normal pages are used if the platform
+/// or the kernel does not provide the transparent huge pages.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to use the huge pages for
+/// the linear memories or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableHugePages(WasmEdge_ConfigureContext *Cxt,
+                                     const bool IsEnable);
+
+/// Get the EnableHugePages option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the huge pages for the
+/// linear memories or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableHugePages(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value to destroy the deleted modules in the background.
+///
+/// The setting is process-wide and applied when an executor or a VM context is
+/// created with this configure. When enabled, the AST modules and the module
+/// instances deleted by `WasmEdge_ASTModuleDelete`,
+/// `WasmEdge_ModuleInstanceDelete`, and the VM cleanup are destroyed in batches
+/// on a background thread, and the finalizers of their host data run there.
+/// Disabled by default.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to destroy the deleted
+/// modules in the background or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableBackgroundReclamation(WasmEdge_ConfigureContext *Cxt,
+                                                 const bool IsEnable);
+
+/// Get the EnableBackgroundReclamation option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to destroy the deleted modules in
+/// the background or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableBackgroundReclamation(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the NUMA node to place the instances on.
+///
+/// The linear memories instantiated with this configure prefer the pages of
+/// the node, and the threads executing the functions are pinned on the CPUs
+/// of the node. Only supported on Linux, and ignored on the other platforms.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the NUMA node.
+/// \param Node the index of the NUMA node, or negative for no placement.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetNumaNode(WasmEdge_ConfigureContext *Cxt,
+                              const int32_t Node);
+
+/// Get the NUMA node to place the instances on.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the NUMA node.
+///
+/// \returns the index of the NUMA node, negative for no placement.
+WASMEDGE_CAPI_EXPORT extern int32_t
+WasmEdge_ConfigureGetNumaNode(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the size of the dedicated stacks running the compiled code.
+///
+/// The AOT and JIT compiled functions run on a stack of this size per
+/// executing thread, with a guard page below it, and the overflows trap with
+/// the stack overflow error instead of crashing the thread. Only supported on
+/// Linux and macOS, and ignored on the other platforms.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the stack size.
+/// \param Size the size of the stacks in bytes, or 0 for running on the
+/// stacks of the calling threads.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetNativeStackSize(WasmEdge_ConfigureContext *Cxt,
+                                     const uint64_t Size);
+
+/// Get the size of the dedicated stacks running the compiled code.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the stack size.
+///
+/// \returns the size of the stacks in bytes, 0 for no dedicated stacks.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_ConfigureGetNativeStackSize(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value of backing the AOT code with huge pages.
+///
+/// The code loaded from the AOT sections of the universal WASM format is
+/// backed with the transparent huge pages when it is at least 2 MiB. The
+/// normal pages are used if not supported.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to use the huge pages for
+/// the AOT code or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableHugePageCode(WasmEdge_ConfigureContext *Cxt,
+                                        const bool IsEnable);
+
+/// Get the EnableHugePageCode option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the huge pages for the AOT
+/// code or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableHugePageCode(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value of the lazy table mode.
+///
+/// The function references of the active element segments are resolved into
+/// the tables defined by the module at their first access, such as
+/// `call_indirect` or `table.get`, instead of at instantiation. Only the
+/// segments whose initialization expressions are all `ref.func` are deferred.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to initialize the tables
+/// lazily or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableLazyTable(WasmEdge_ConfigureContext *Cxt,
+                                     const bool IsEnable);
+
+/// Get the EnableLazyTable option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to initialize the tables lazily or
+/// not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableLazyTable(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the boolean value of the guard region mode.
+///
+/// The interpreter skips the bounds checks of the scalar memory loads and
+/// stores, and the out-of-bounds accesses are trapped in the guard region
+/// reserved around the linear memories, as the AOT compiled code does. The
+/// option is ignored on the platforms without the guard region.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to rely on the guard region
+/// or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableGuardRegion(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnable);
+
+/// Get the EnableGuardRegion option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to rely on the guard region or
+/// not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableGuardRegion(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the io_uring option for the WASI polling.
+///
+/// The WASI `poll_oneoff` submits the polls of all the subscribed file
+/// descriptors to io_uring in a batch instead of registering them into epoll.
+/// The polling falls back to epoll if io_uring is unavailable. The option is
+/// ignored on the platforms other than Linux.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to use io_uring or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableIoUring(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnable);
+
+/// Get the EnableIoUring option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use io_uring or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableIoUring(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the path cache option for the WASI pre-opened directories.
+///
+/// The WASI path resolution keeps the intermediate directories open per
+/// pre-opened directory, and drops them once their entries changed. The option
+/// is ignored on the platforms other than Linux.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsEnable the boolean value to determine to cache the paths or not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureSetEnableWasiPathCache(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsEnable);
+
+/// Get the EnableWasiPathCache option.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to cache the paths or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureIsEnableWasiPathCache(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the optimization level of the AOT compiler.
 ///
 /// This function is thread-safe.
@@ -308,6 +866,132 @@ WasmEdge_ConfigureCompilerSetInterruptible(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool
 WasmEdge_ConfigureCompilerIsInterruptible(const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the partition count of the AOT compiler.
+///
+/// The AOT compiler splits the functions into this many partitions, which are
+/// optimized and code generated in parallel.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the partition count.
+/// \param Count the partition count. 0 or 1 for compiling in one partition.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetPartitionCount(WasmEdge_ConfigureContext *Cxt,
+                                            const uint32_t Count);
+
+/// Get the partition count of the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the partition count.
+///
+/// \returns the partition count.
+WASMEDGE_CAPI_EXPORT extern uint32_t WasmEdge_ConfigureCompilerGetPartitionCount(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the function cache option of the AOT compiler.
+///
+/// The AOT compiler compiles every function into its own object and keeps the
+/// objects in the local cache, so functions unchanged since an earlier
+/// compilation are not compiled again.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsFunctionCache the boolean value to determine to use the function
+/// cache or not when compilation in AOT compiler.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetFunctionCache(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsFunctionCache);
+
+/// Get the function cache option of the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to use the function cache or not
+/// when compilation in AOT compiler.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureCompilerIsFunctionCache(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the coarse gas check option of the AOT compiler.
+///
+/// The AOT compiled code with the cost measuring checks the gas limit only at
+/// the loop headers, the calls, and the returns. The total cost is unchanged,
+/// but an execution exceeding the limit may trap a few instructions later.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsCoarseGasCheck the boolean value to determine to check the gas
+/// limit coarsely or not when compilation in AOT compiler.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetCoarseGasCheck(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsCoarseGasCheck);
+
+/// Get the coarse gas check option of the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to check the gas limit coarsely or
+/// not when compilation in AOT compiler.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureCompilerIsCoarseGasCheck(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the x86-64 micro-architecture level of the AOT compiled code.
+///
+/// The level 1 to 4 generates the code for the `x86-64` to `x86-64-v4` CPUs
+/// instead of the host CPU. A universal wasm file can embed the AOT sections
+/// of several levels, and the loader uses the highest one supported by the
+/// running CPU. The level 0 (default) targets the host CPU. The level is
+/// ignored on the other architectures.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the level.
+/// \param Level the x86-64 micro-architecture level from 0 to 4.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetTargetLevel(WasmEdge_ConfigureContext *Cxt,
+                                         const uint8_t Level);
+
+/// Get the x86-64 micro-architecture level of the AOT compiled code.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the level.
+///
+/// \returns the x86-64 micro-architecture level, 0 for the host CPU.
+WASMEDGE_CAPI_EXPORT extern uint8_t
+WasmEdge_ConfigureCompilerGetTargetLevel(const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the inline budget of the AOT compiler.
+///
+/// The AOT compiler always inlines the functions with at most `Budget`
+/// instructions, and the trampolines of the imported host functions, into
+/// their callers. The budget 0 (default) leaves the inlining to the cost model
+/// of the optimization level.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the budget.
+/// \param Budget the maximum instruction count of the inlined functions.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureCompilerSetInlineBudget(WasmEdge_ConfigureContext *Cxt,
+                                          const uint32_t Budget);
+
+/// Get the inline budget of the AOT compiler.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the budget.
+///
+/// \returns the maximum instruction count of the inlined functions.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ConfigureCompilerGetInlineBudget(const WasmEdge_ConfigureContext *Cxt);
+
 /// Set the instruction counting option for the statistics.
 ///
 /// This function is thread-safe.
@@ -375,6 +1059,56 @@ WasmEdge_ConfigureStatisticsSetTimeMeasuring(WasmEdge_ConfigureContext *Cxt,
 WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureStatisticsIsTimeMeasuring(
     const WasmEdge_ConfigureContext *Cxt);
 
+/// Set the WASI I/O measuring option for the statistics.
+///
+/// The WASI module instances created from this configuration will count the
+/// transferred bytes, calls, and poll wakeups, and record the latency
+/// histograms of the WASI functions.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsMeasure the boolean value to determine to measure the WASI I/O or
+/// not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureStatisticsSetIOMeasuring(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsMeasure);
+
+/// Get the WASI I/O measuring option for the statistics.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to measure the WASI I/O or not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_ConfigureStatisticsIsIOMeasuring(
+    const WasmEdge_ConfigureContext *Cxt);
+
+/// Set the function profiling option for the statistics.
+///
+/// The interpreter will count the calls, the instructions, and the self time
+/// of every function, and log the top functions with the other statistics.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to set the boolean value.
+/// \param IsProfile the boolean value to determine to profile the functions or
+/// not.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ConfigureStatisticsSetFunctionProfiling(WasmEdge_ConfigureContext *Cxt,
+                                                 const bool IsProfile);
+
+/// Get the function profiling option for the statistics.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ConfigureContext to get the boolean value.
+///
+/// \returns the boolean value to determine to profile the functions or not.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ConfigureStatisticsIsFunctionProfiling(
+    const WasmEdge_ConfigureContext *Cxt);
+
 /// Deletion of the WasmEdge_ConfigureContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -460,6 +1194,42 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt);
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge metrics functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Start recording the process-wide runtime metrics.
+///
+/// The executions, the host function calls, and the code cache lookups of all
+/// executors are aggregated per module instance after enabling. The
+/// instruction counts and the gas are taken from the statistics of the
+/// executors if set.
+///
+/// This function is thread-safe.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_MetricsEnable(void);
+
+/// Check the runtime metrics are recorded.
+///
+/// This function is thread-safe.
+///
+/// \returns true if the metrics are recorded, false if not.
+WASMEDGE_CAPI_EXPORT extern bool WasmEdge_MetricsIsEnabled(void);
+
+/// Render the runtime metrics in the OpenMetrics text format.
+///
+/// The caller owns the string object and should call `WasmEdge_StringDelete`
+/// to destroy it.
+///
+/// This function is thread-safe.
+///
+/// \returns the rendered metrics for the Prometheus scrapers.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_String WasmEdge_MetricsRender(void);
+
+/// Drop the recorded runtime metrics.
+///
+/// This function is thread-safe.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_MetricsClear(void);
+
+// <<<<<<<< WasmEdge metrics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 #ifdef __cplusplus
 } /// extern "C"
 #endif
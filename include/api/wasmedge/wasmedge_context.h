@@ -85,9 +85,24 @@ typedef struct WasmEdge_CallingFrameContext WasmEdge_CallingFrameContext;
 /// Opaque struct of WasmEdge asynchronous result.
 typedef struct WasmEdge_Async WasmEdge_Async;
 
+/// Opaque struct of WasmEdge resumable execution.
+typedef struct WasmEdge_Resumable WasmEdge_Resumable;
+
 /// Opaque struct of WasmEdge VM.
 typedef struct WasmEdge_VMContext WasmEdge_VMContext;
 
+/// Opaque struct of WasmEdge VM pool.
+typedef struct WasmEdge_VMPoolContext WasmEdge_VMPoolContext;
+
+/// Opaque struct of WasmEdge prepared call.
+typedef struct WasmEdge_PreparedCallContext WasmEdge_PreparedCallContext;
+
+/// Opaque struct of WasmEdge module instance snapshot.
+typedef struct WasmEdge_ModuleSnapshotContext WasmEdge_ModuleSnapshotContext;
+
+/// Opaque struct of WasmEdge pre-linked module.
+typedef struct WasmEdge_ModulePrelinkContext WasmEdge_ModulePrelinkContext;
+
 /// Opaque struct of WasmEdge Plugin.
 typedef struct WasmEdge_PluginContext WasmEdge_PluginContext;
 
@@ -9,7 +9,7 @@
 ///
 /// \file
 /// This file contains the functions about WASM execution (loader, validator,
-/// executor, calling frame, store, and async) in WasmEdge C API.
+/// executor, calling frame, store, async, and resumable) in WasmEdge C API.
 ///
 //===----------------------------------------------------------------------===//
 
@@ -182,6 +182,131 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_ExecutorInstantiate(
     WasmEdge_ExecutorContext *Cxt, WasmEdge_ModuleInstanceContext **ModuleCxt,
     WasmEdge_StoreContext *StoreCxt, const WasmEdge_ASTModuleContext *ASTCxt);
 
+/// Pre-link an AST Module for the repeated instantiations.
+///
+/// Resolve and type-check the imports of the AST Module against the registered
+/// modules in the store once. Instantiating the pre-linked module binds the
+/// imports by index without the lookups by name. The caller owns the object
+/// and should call `WasmEdge_ModulePrelinkDelete` to destroy it. The AST Module
+/// and the store should outlive the pre-linked module.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param [out] PrelinkCxt the output WasmEdge_ModulePrelinkContext if
+/// succeeded.
+/// \param StoreCxt the WasmEdge_StoreContext to resolve the imports in.
+/// \param ASTCxt the WasmEdge_ASTModuleContext to pre-link.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorPrelink(WasmEdge_ExecutorContext *Cxt,
+                         WasmEdge_ModulePrelinkContext **PrelinkCxt,
+                         const WasmEdge_StoreContext *StoreCxt,
+                         const WasmEdge_ASTModuleContext *ASTCxt);
+
+/// Instantiate a pre-linked AST Module into an anonymous module instance.
+///
+/// Same as `WasmEdge_ExecutorInstantiate`, but the imports resolved by
+/// `WasmEdge_ExecutorPrelink` are bound by index. If the registered modules in
+/// the store changed after the pre-linking, or the store is another one, the
+/// imports are resolved again. The caller owns the object and should call
+/// `WasmEdge_ModuleInstanceDelete` to destroy it.
+///
+/// \param Cxt the WasmEdge_ExecutorContext to instantiate the module.
+/// \param [out] ModuleCxt the output WasmEdge_ModuleInstanceContext if
+/// succeeded.
+/// \param StoreCxt the WasmEdge_StoreContext to link the imports.
+/// \param PrelinkCxt the WasmEdge_ModulePrelinkContext to instantiate.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorInstantiatePrelinked(
+    WasmEdge_ExecutorContext *Cxt, WasmEdge_ModuleInstanceContext **ModuleCxt,
+    WasmEdge_StoreContext *StoreCxt,
+    const WasmEdge_ModulePrelinkContext *PrelinkCxt);
+
+/// Deletion of the WasmEdge_ModulePrelinkContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_ModulePrelinkContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ModulePrelinkDelete(WasmEdge_ModulePrelinkContext *Cxt);
+
+/// Clone an instantiated module instance.
+///
+/// Create a new anonymous module instance with the same state as the template
+/// module instance without running the instantiation again. The tables and
+/// globals are copied by value, the memories are mapped copy-on-write when
+/// supported, and the function bodies are shared. The imports of the template
+/// are shared by the clone. The template module instance should not be executed
+/// after being cloned. The caller owns the object and should call
+/// `WasmEdge_ModuleInstanceDelete` to destroy it.
+/// The module instances containing host functions cannot be cloned.
+///
+/// \param Cxt the WasmEdge_ExecutorContext to clone the module instance.
+/// \param [out] ModuleCxt the output WasmEdge_ModuleInstanceContext if
+/// succeeded.
+/// \param TemplateCxt the WasmEdge_ModuleInstanceContext to clone from.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorClone(WasmEdge_ExecutorContext *Cxt,
+                       WasmEdge_ModuleInstanceContext **ModuleCxt,
+                       const WasmEdge_ModuleInstanceContext *TemplateCxt);
+
+/// Take a snapshot of a module instance.
+///
+/// Record the owned memories, tables, and globals of the module instance, so
+/// that it can be reset to this state between the requests instead of being
+/// instantiated again. The memories are recorded as images mapped
+/// copy-on-write when restoring where supported, so that only the pages
+/// touched after the snapshot are dropped. The imported instances and the
+/// dropped segments are not recorded. The caller owns the object and should
+/// call `WasmEdge_ModuleSnapshotDelete` to destroy it.
+/// The module instances owning GC objects cannot be recorded.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param [out] SnapshotCxt the output WasmEdge_ModuleSnapshotContext if
+/// succeeded.
+/// \param ModuleCxt the WasmEdge_ModuleInstanceContext to record.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorSnapshot(WasmEdge_ExecutorContext *Cxt,
+                          WasmEdge_ModuleSnapshotContext **SnapshotCxt,
+                          const WasmEdge_ModuleInstanceContext *ModuleCxt);
+
+/// Restore a module instance to a snapshot.
+///
+/// The snapshot should be taken from the same module instance. The memories
+/// grown after the snapshot are shrunk. The module instance should not be
+/// executed during the restoring.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param ModuleCxt the WasmEdge_ModuleInstanceContext to restore.
+/// \param SnapshotCxt the WasmEdge_ModuleSnapshotContext to restore from.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ExecutorRestore(WasmEdge_ExecutorContext *Cxt,
+                         WasmEdge_ModuleInstanceContext *ModuleCxt,
+                         const WasmEdge_ModuleSnapshotContext *SnapshotCxt);
+
+/// Deletion of the WasmEdge_ModuleSnapshotContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_ModuleSnapshotContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ModuleSnapshotDelete(WasmEdge_ModuleSnapshotContext *Cxt);
+
 /// Instantiate an AST Module into a named module instance and link into store.
 ///
 /// Instantiate an AST Module with the module name, return the instantiated
@@ -259,6 +384,35 @@ WasmEdge_ExecutorInvoke(WasmEdge_ExecutorContext *Cxt,
                         const WasmEdge_Value *Params, const uint32_t ParamLen,
                         WasmEdge_Value *Returns, const uint32_t ReturnLen);
 
+/// Invoke a WASM function once for every row of a batch.
+///
+/// The arguments and the return values are in the struct-of-arrays layout.
+/// Every column is an array of `Rows` values of its number type in the native
+/// layout: `int32_t` for i32, `int64_t` for i64, `float` for f32, `double` for
+/// f64, and 16 bytes for v128. The functions with reference types cannot be
+/// invoked in batches. With `Threads` greater than 1, the rows are split into
+/// shards executed concurrently, so the function should not write the
+/// non-shared state of its module instance.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param FuncCxt the function instance context to invoke.
+/// \param ParamTypes the WasmEdge_ValType buffer with the parameter types.
+/// \param Params the buffer of the parameter columns.
+/// \param ParamLen the length of the parameter types and columns buffers.
+/// \param [out] Returns the buffer of the return value columns to fill.
+/// \param ReturnLen the return value columns buffer length.
+/// \param Rows the count of the rows.
+/// \param Threads the count of the threads to execute the rows.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_ExecutorInvokeBatch(
+    WasmEdge_ExecutorContext *Cxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_ValType *ParamTypes, const void *const *Params,
+    const uint32_t ParamLen, void *const *Returns, const uint32_t ReturnLen,
+    const uint32_t Rows, const uint32_t Threads);
+
 /// Asynchronous invoke a WASM function by the function instance.
 ///
 /// After instantiating a WASM module, developers can get the function instance
@@ -278,6 +432,45 @@ WasmEdge_ExecutorAsyncInvoke(WasmEdge_ExecutorContext *Cxt,
                              const WasmEdge_Value *Params,
                              const uint32_t ParamLen);
 
+/// Invoke a WASM function by the function instance in a resumable execution.
+///
+/// The execution runs on its own stack on the calling thread of
+/// `WasmEdge_ResumableResume`, and is suspended when a host function calls
+/// `WasmEdge_CallingFrameSuspend`. This lets an embedder with its own event
+/// loop drive many executions waiting in the host functions on one thread,
+/// instead of blocking a thread for each of them. The execution is not
+/// started until the first resumption.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param FuncCxt the function instance context to invoke.
+/// \param Params the WasmEdge_Value buffer with the parameter values.
+/// \param ParamLen the parameter buffer length.
+///
+/// \returns WasmEdge_Resumable. Call `WasmEdge_ResumableResume` to run it, and
+/// call `WasmEdge_ResumableDelete` to destroy this object. NULL if failed or
+/// not supported on this platform.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Resumable *
+WasmEdge_ExecutorResumableInvoke(
+    WasmEdge_ExecutorContext *Cxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_Value *Params, const uint32_t ParamLen);
+
+/// Set the epoch deadline of the executions.
+///
+/// The executions by this executor are interrupted once the global epoch
+/// advances by the ticks from now. The interpreter checks the deadline at the
+/// branches and the calls, and the AOT compiled code checks it at the loops
+/// when compiled with the interruptible option. The deadline stays until it is
+/// set again, so the later executions are also interrupted.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ExecutorContext.
+/// \param Ticks the epoch ticks from now. UINT64_MAX for no deadline.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ExecutorSetEpochDeadline(WasmEdge_ExecutorContext *Cxt,
+                                  const uint64_t Ticks);
+
 /// Deletion of the WasmEdge_ExecutorContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -289,6 +482,115 @@ WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt);
 
 // <<<<<<<< WasmEdge executor functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge prepared call functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Creation of the WasmEdge_PreparedCallContext.
+///
+/// The prepared call checks the function instance and its parameter types
+/// once, and then invokes the function repeatedly with the raw values without
+/// converting, checking, or allocating per call. The executor and the function
+/// instance should outlive the prepared call.
+///
+/// The caller owns the object and should call `WasmEdge_PreparedCallDelete` to
+/// destroy it.
+///
+/// \param ExecCxt the WasmEdge_ExecutorContext to invoke the function.
+/// \param FuncCxt the function instance context to invoke.
+/// \param ParamTypes the WasmEdge_ValType buffer with the parameter types.
+/// \param ParamLen the parameter types buffer length.
+///
+/// \returns pointer to context, NULL if failed or the parameter types do not
+/// match the function type.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_PreparedCallContext *
+WasmEdge_PreparedCallCreate(WasmEdge_ExecutorContext *ExecCxt,
+                            const WasmEdge_FunctionInstanceContext *FuncCxt,
+                            const WasmEdge_ValType *ParamTypes,
+                            const uint32_t ParamLen);
+
+/// Get the parameter count of the function of the prepared call.
+///
+/// \param Cxt the WasmEdge_PreparedCallContext.
+///
+/// \returns the parameter count, 0 if the context is NULL.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_PreparedCallGetParamLength(const WasmEdge_PreparedCallContext *Cxt);
+
+/// Get the return count of the function of the prepared call.
+///
+/// \param Cxt the WasmEdge_PreparedCallContext.
+///
+/// \returns the return count, 0 if the context is NULL.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_PreparedCallGetReturnLength(const WasmEdge_PreparedCallContext *Cxt);
+
+/// Invoke the function of the prepared call.
+///
+/// The parameters and the return values are in the raw 128-bit slots, which
+/// are the `Value` fields of the `WasmEdge_Value` generated by the
+/// `WasmEdge_ValueGen` functions. The i32, i64, f32, and f64 values are in the
+/// low bits of the slots. The parameter count should match the function type,
+/// and the return values are filled up to the return buffer length.
+///
+/// The prepared call reuses its own buffers, so it should not be invoked by
+/// multiple threads at the same time. Create a prepared call for every thread
+/// instead.
+///
+/// \param Cxt the WasmEdge_PreparedCallContext.
+/// \param Params the buffer with the parameter values.
+/// \param ParamLen the parameter buffer length.
+/// \param [out] Returns the buffer to fill the return values.
+/// \param ReturnLen the return buffer length.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_PreparedCallInvoke(WasmEdge_PreparedCallContext *Cxt,
+                            const uint128_t *Params, const uint32_t ParamLen,
+                            uint128_t *Returns, const uint32_t ReturnLen);
+
+/// Deletion of the WasmEdge_PreparedCallContext.
+///
+/// After calling this function, the context will be destroyed and should
+/// __NOT__ be used.
+///
+/// \param Cxt the WasmEdge_PreparedCallContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_PreparedCallDelete(WasmEdge_PreparedCallContext *Cxt);
+
+// <<<<<<<< WasmEdge prepared call functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>> WasmEdge epoch functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Get the global epoch shared by all executors.
+///
+/// This function is thread-safe.
+///
+/// \returns the current epoch.
+WASMEDGE_CAPI_EXPORT extern uint64_t WasmEdge_EpochGet(void);
+
+/// Advance the global epoch by one tick.
+///
+/// This function is thread-safe.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_EpochIncrement(void);
+
+/// Start the timer thread advancing the global epoch periodically.
+///
+/// One timer serves the epoch deadlines of all executors. If the timer is
+/// already running, it is restarted with the new interval.
+///
+/// This function is thread-safe.
+///
+/// \param IntervalMilliseconds the interval of the ticks in milliseconds.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_EpochStartTimer(const uint64_t IntervalMilliseconds);
+
+/// Stop the timer thread advancing the global epoch.
+///
+/// This function is thread-safe.
+WASMEDGE_CAPI_EXPORT extern void WasmEdge_EpochStopTimer(void);
+
+// <<<<<<<< WasmEdge epoch functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge store functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 /// Creation of the WasmEdge_StoreContext.
@@ -406,6 +708,26 @@ WASMEDGE_CAPI_EXPORT extern WasmEdge_MemoryInstanceContext *
 WasmEdge_CallingFrameGetMemoryInstance(const WasmEdge_CallingFrameContext *Cxt,
                                        const uint32_t Idx);
 
+/// Suspend the resumable execution calling the host function.
+///
+/// The host function can start an operation, register the wake-up of its
+/// completion in the event loop of the embedder, and call this function. Then
+/// the `WasmEdge_ResumableResume` running the execution returns, and this
+/// function returns after the execution is resumed, where the host function
+/// checks the completion of the operation.
+///
+/// This function returns false at once if the execution is not resumable, in
+/// which case the host function should block until the completion instead.
+/// It also returns false if the execution is being deleted, in which case the
+/// host function should fail, such as by returning
+/// `WasmEdge_Result_Terminate`.
+///
+/// \param Cxt the WasmEdge_CallingFrameContext.
+///
+/// \returns true if suspended and resumed, false if not suspended.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_CallingFrameSuspend(const WasmEdge_CallingFrameContext *Cxt);
+
 // <<<<<<<< WasmEdge calling frame functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge Async functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -461,6 +783,46 @@ WASMEDGE_CAPI_EXPORT WasmEdge_Result
 WasmEdge_AsyncGet(const WasmEdge_Async *Cxt, WasmEdge_Value *Returns,
                   const uint32_t ReturnLen);
 
+/// Set the callback of the completion of a WasmEdge_Async execution.
+///
+/// The callback will be called on the worker thread when the execution
+/// finished, or on the calling thread before returning if already finished.
+/// Calling `WasmEdge_AsyncGet` in the callback will not block. Only the last
+/// set callback before the completion will be called.
+///
+/// \param Cxt the WasmEdge_ASync.
+/// \param Callback the function to call with the data.
+/// \param Data the data pointer passed to the callback.
+WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncSetCallback(WasmEdge_Async *Cxt,
+                                                    void (*Callback)(void *),
+                                                    void *Data);
+
+/// Set the maximum count of the worker threads running the WasmEdge_Async
+/// executions.
+///
+/// The executions are run on a process-wide thread pool, whose workers are
+/// reused across the executions. When the maximum count of workers are all
+/// running, the new executions wait until a worker is free. The default value
+/// 0 is for unbounded.
+///
+/// This function is thread-safe.
+///
+/// \param MaxThreads the maximum count of the worker threads.
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_AsyncSetMaxThreads(const uint32_t MaxThreads);
+
+/// Pin the worker threads running the WasmEdge_Async executions on the CPUs.
+///
+/// The workers are pinned on the CPUs in turn. Set an empty list to clear the
+/// pinning. Only supported on Linux, and ignored on the other platforms.
+///
+/// This function is thread-safe.
+///
+/// \param CPUs the CPU index array.
+/// \param Len the length of the CPU index array.
+WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncSetAffinity(const uint32_t *CPUs,
+                                                    const uint32_t Len);
+
 /// Deletion of the WasmEdge_Async.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -471,6 +833,59 @@ WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncDelete(WasmEdge_Async *Cxt);
 
 // <<<<<<<< WasmEdge Async functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge Resumable functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Resume a WasmEdge_Resumable execution.
+///
+/// Run the execution on the calling thread until it is suspended by a host
+/// function or finished. Once started, the execution should be resumed on
+/// the same thread.
+///
+/// \param Cxt the WasmEdge_Resumable.
+///
+/// \returns true if the execution finished or the Cxt is NULL, false if
+/// suspended.
+WASMEDGE_CAPI_EXPORT extern bool
+WasmEdge_ResumableResume(WasmEdge_Resumable *Cxt);
+
+/// Get the return list length of the finished WasmEdge_Resumable execution.
+///
+/// \param Cxt the WasmEdge_Resumable.
+///
+/// \returns the return list length of the executed function. 0 if the `Cxt` is
+/// NULL, the execution was not finished, or the execution was failed.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ResumableGetReturnsLength(const WasmEdge_Resumable *Cxt);
+
+/// Get the result of the finished WasmEdge_Resumable execution.
+///
+/// If the `Returns` buffer length is smaller than the arity of the function,
+/// the overflowed return values will be discarded.
+///
+/// \param Cxt the WasmEdge_Resumable.
+/// \param [out] Returns the WasmEdge_Value buffer to fill the return values.
+/// \param ReturnLen the return buffer length.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message. `WasmEdge_ErrCode_WrongVMWorkflow` if the execution was not
+/// finished.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_ResumableGet(const WasmEdge_Resumable *Cxt, WasmEdge_Value *Returns,
+                      const uint32_t ReturnLen);
+
+/// Deletion of the WasmEdge_Resumable.
+///
+/// A started but unfinished execution is resumed to the end first, with the
+/// suspensions refused, so that the host functions can clean up. After
+/// calling this function, the context will be destroyed and should __NOT__ be
+/// used.
+///
+/// \param Cxt the WasmEdge_Resumable to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ResumableDelete(WasmEdge_Resumable *Cxt);
+
+// <<<<<<<< WasmEdge Resumable functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 #ifdef __cplusplus
 } /// extern "C"
 #endif
@@ -163,6 +163,50 @@ WasmEdge_ModuleInstanceWASIGetNativeHandler(
     const WasmEdge_ModuleInstanceContext *Cxt, int32_t Fd,
     uint64_t *NativeHandler);
 
+/// Struct of the WASI I/O statistics.
+typedef struct WasmEdge_WASIIOStatistics {
+  /// Bytes read by the file and socket reading functions.
+  uint64_t BytesRead;
+  /// Bytes written by the file and socket writing functions.
+  uint64_t BytesWritten;
+  /// Count of the calls to the WASI functions.
+  uint64_t Calls;
+  /// Count of the returns from `poll_oneoff`.
+  uint64_t PollWakeups;
+} WasmEdge_WASIIOStatistics;
+
+/// Get the WASI I/O statistics.
+///
+/// The statistics are only collected when the I/O measuring option is set in
+/// the configuration creating the WASI module instance. See
+/// `WasmEdge_ConfigureStatisticsSetIOMeasuring`.
+///
+/// \param Cxt the WasmEdge_ModuleInstanceContext of WASI import object.
+///
+/// \returns the WASI I/O statistics. Return all zero if the `Cxt` is NULL or
+/// not a WASI host module.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_WASIIOStatistics
+WasmEdge_ModuleInstanceWASIGetIOStatistics(
+    const WasmEdge_ModuleInstanceContext *Cxt);
+
+/// Get the latency histogram of a WASI function.
+///
+/// The bucket `I` counts the calls taking less than `2^I` nanoseconds and not
+/// less than `2^(I-1)` nanoseconds, and the last bucket also counts the longer
+/// calls.
+///
+/// \param Cxt the WasmEdge_ModuleInstanceContext of WASI import object.
+/// \param FuncName the name of the WASI function, such as `fd_read`.
+/// \param [out] Buckets the uint64_t buffer to output the buckets.
+/// \param Len the buffer length.
+///
+/// \returns the count of the buckets, which is 32. Return `0` if the `Cxt` is
+/// NULL, not a WASI host module, or the function is not found.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_ModuleInstanceWASIGetLatencyHistogram(
+    const WasmEdge_ModuleInstanceContext *Cxt, const WasmEdge_String FuncName,
+    uint64_t *Buckets, const uint32_t Len);
+
 /// Initialize the WasmEdge_ModuleInstanceContext for the wasmedge_process
 /// specification.
 ///
@@ -203,6 +247,46 @@ WasmEdge_ModuleInstanceGetModuleName(const WasmEdge_ModuleInstanceContext *Cxt);
 WASMEDGE_CAPI_EXPORT extern void *
 WasmEdge_ModuleInstanceGetHostData(const WasmEdge_ModuleInstanceContext *Cxt);
 
+/// Get the memory usage of the module instance.
+///
+/// The usage accounts the memory instances, table instances, and GC objects
+/// owned by the module instance.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ModuleInstanceContext.
+///
+/// \returns the currently used bytes. 0 if the module instance context is NULL.
+WASMEDGE_CAPI_EXPORT extern uint64_t WasmEdge_ModuleInstanceGetMemoryUsage(
+    const WasmEdge_ModuleInstanceContext *Cxt);
+
+/// Get the peak memory usage of the module instance.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ModuleInstanceContext.
+///
+/// \returns the maximum used bytes ever. 0 if the module instance context is
+/// NULL.
+WASMEDGE_CAPI_EXPORT extern uint64_t WasmEdge_ModuleInstanceGetMemoryPeakUsage(
+    const WasmEdge_ModuleInstanceContext *Cxt);
+
+/// Set the memory budget of the module instance.
+///
+/// The `memory.grow` and `table.grow` fail when exceeding the soft limit, and
+/// the GC allocations trap when exceeding the hard limit. The instances added
+/// by the host are always accounted regardless of the limits.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_ModuleInstanceContext to set the budget.
+/// \param SoftLimit the soft limit in bytes. 0 for no limit.
+/// \param HardLimit the hard limit in bytes. 0 for no limit.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_ModuleInstanceSetMemoryBudget(WasmEdge_ModuleInstanceContext *Cxt,
+                                       const uint64_t SoftLimit,
+                                       const uint64_t HardLimit);
+
 /// Get the exported function instance context of a module instance.
 ///
 /// The result function instance context links to the function instance in the
@@ -804,11 +888,38 @@ WasmEdge_TableInstanceDelete(WasmEdge_TableInstanceContext *Cxt);
 WASMEDGE_CAPI_EXPORT extern WasmEdge_MemoryInstanceContext *
 WasmEdge_MemoryInstanceCreate(const WasmEdge_MemoryTypeContext *MemType);
 
+/// Creation of the WasmEdge_MemoryInstanceContext with the data mapped from a
+/// file, such as a memfd.
+///
+/// The data is mapped shared, so the writes are seen by the host and all the
+/// other memory instances mapping the same file without copies. A memory
+/// instance can also be imported by the modules in several VMs and threads.
+/// The file should have at least the bytes of the minimum pages in the memory
+/// type, and can be closed after this function returns. The memory instance
+/// never grows, and the writes to a read-only memory instance trap as out of
+/// bounds. The caller owns the object and should call
+/// `WasmEdge_MemoryInstanceDelete` to destroy it after all the module
+/// instances importing it are deleted. Only supported on the platforms with
+/// the `mmap`.
+///
+/// \param MemType the memory type context to initialize the memory instance
+/// context.
+/// \param FileDescriptor the file descriptor of the file to map.
+/// \param Writable true if the memory instance can be written.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_MemoryInstanceContext *
+WasmEdge_MemoryInstanceCreateFromFile(const WasmEdge_MemoryTypeContext *MemType,
+                                      const int FileDescriptor,
+                                      const bool Writable);
+
 /// Get the memory type context from a memory instance.
 ///
 /// The memory type context links to the memory type in the memory instance
 /// context and owned by the context. The caller should __NOT__ call the
-/// `WasmEdge_MemoryTypeDelete`.
+/// `WasmEdge_MemoryTypeDelete`. The minimum of its limit is the page count at
+/// the instantiation, and the current page count is got by the
+/// `WasmEdge_MemoryInstanceGetPageSize`.
 ///
 /// \param Cxt the WasmEdge_MemoryInstanceContext.
 ///
@@ -853,7 +964,8 @@ WasmEdge_MemoryInstanceSetData(WasmEdge_MemoryInstanceContext *Cxt,
 /// \param Length the requested data length. If the `Offset + Length` is larger
 /// than the data size in the memory instance, this function will return NULL.
 ///
-/// \returns the pointer to data with the start offset. NULL if failed.
+/// \returns the pointer to data with the start offset. NULL if failed or the
+/// memory instance is mapped read-only.
 WASMEDGE_CAPI_EXPORT extern uint8_t *
 WasmEdge_MemoryInstanceGetPointer(WasmEdge_MemoryInstanceContext *Cxt,
                                   const uint32_t Offset, const uint32_t Length);
@@ -871,6 +983,20 @@ WasmEdge_MemoryInstanceGetPointerConst(
     const WasmEdge_MemoryInstanceContext *Cxt, const uint32_t Offset,
     const uint32_t Length);
 
+/// Get the generation of a memory instance.
+///
+/// The generation changes when the memory instance grows, which may move the
+/// data. The pointers from `WasmEdge_MemoryInstanceGetPointer` and the sizes
+/// are only valid while the generation is unchanged, so the bindings can keep
+/// the borrowed views over the data instead of copying it, and renew them
+/// when the generation changes.
+///
+/// \param Cxt the WasmEdge_MemoryInstanceContext.
+///
+/// \returns the generation of the memory instance. 0 if failed.
+WASMEDGE_CAPI_EXPORT extern uint64_t
+WasmEdge_MemoryInstanceGetGeneration(const WasmEdge_MemoryInstanceContext *Cxt);
+
 /// Get the current page size (64 KiB of each page) of a memory instance.
 ///
 /// \param Cxt the WasmEdge_MemoryInstanceContext.
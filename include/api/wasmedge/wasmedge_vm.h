@@ -414,6 +414,49 @@ WasmEdge_VMExecute(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
                    const WasmEdge_Value *Params, const uint32_t ParamLen,
                    WasmEdge_Value *Returns, const uint32_t ReturnLen);
 
+/// Invoke a WASM function by name once for every row of a batch.
+///
+/// The function is looked up once for the whole batch. See
+/// `WasmEdge_ExecutorInvokeBatch` for the layout of the columns.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param FuncName the function name WasmEdge_String.
+/// \param ParamTypes the WasmEdge_ValType buffer with the parameter types.
+/// \param Params the buffer of the parameter columns.
+/// \param ParamLen the length of the parameter types and columns buffers.
+/// \param [out] Returns the buffer of the return value columns to fill.
+/// \param ReturnLen the return value columns buffer length.
+/// \param Rows the count of the rows.
+/// \param Threads the count of the threads to execute the rows.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result WasmEdge_VMExecuteBatch(
+    WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
+    const WasmEdge_ValType *ParamTypes, const void *const *Params,
+    const uint32_t ParamLen, void *const *Returns, const uint32_t ReturnLen,
+    const uint32_t Rows, const uint32_t Threads);
+
+/// Prepare the call of a WASM function by name in the active module.
+///
+/// The function is looked up and checked once, and invoked with
+/// `WasmEdge_PreparedCallInvoke` by the executor of the VM. The prepared call
+/// should be deleted before the VM instantiates another module or is
+/// destroyed. See `WasmEdge_PreparedCallCreate` for details.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param FuncName the function name WasmEdge_String.
+/// \param ParamTypes the WasmEdge_ValType buffer with the parameter types.
+/// \param ParamLen the parameter types buffer length.
+///
+/// \returns pointer to the prepared call context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_PreparedCallContext *
+WasmEdge_VMPrepareCall(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
+                       const WasmEdge_ValType *ParamTypes,
+                       const uint32_t ParamLen);
+
 /// Invoke a WASM function by its module name and function name.
 ///
 /// After registering a WASM module in the VM context, you can repeatedly call
@@ -752,6 +795,18 @@ WasmEdge_VMGetExecutorContext(WasmEdge_VMContext *Cxt);
 WASMEDGE_CAPI_EXPORT extern WasmEdge_StatisticsContext *
 WasmEdge_VMGetStatisticsContext(WasmEdge_VMContext *Cxt);
 
+/// Set the epoch deadline of the executions in the VM context.
+///
+/// The executions are interrupted once the global epoch advances by the ticks
+/// from now. See `WasmEdge_ExecutorSetEpochDeadline` for the details.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMContext.
+/// \param Ticks the epoch ticks from now. UINT64_MAX for no deadline.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_VMSetEpochDeadline(WasmEdge_VMContext *Cxt, const uint64_t Ticks);
+
 /// Deletion of the WasmEdge_VMContext.
 ///
 /// After calling this function, the context will be destroyed and should
@@ -762,6 +817,167 @@ WASMEDGE_CAPI_EXPORT extern void WasmEdge_VMDelete(WasmEdge_VMContext *Cxt);
 
 // <<<<<<<< WasmEdge VM functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge VM pool functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+/// Reset strategy of the VMs returned to the VM pool.
+typedef enum WasmEdge_VMPoolReset {
+  /// Instantiate the module again.
+  WasmEdge_VMPoolReset_Reinstantiate,
+  /// Restore the module instance from the snapshot taken after instantiation.
+  WasmEdge_VMPoolReset_Snapshot,
+  /// Keep the state left by the previous leases.
+  WasmEdge_VMPoolReset_Reuse,
+} WasmEdge_VMPoolReset;
+
+/// Metrics of the VM pool. The times are in nanoseconds.
+typedef struct WasmEdge_VMPoolMetrics {
+  uint64_t Leases;
+  uint64_t Hits;
+  uint64_t Misses;
+  uint64_t ResetFailures;
+  uint32_t InUse;
+  uint64_t WaitTime;
+  uint64_t MaxWaitTime;
+  uint64_t ResetTime;
+} WasmEdge_VMPoolMetrics;
+
+/// Creation of the WasmEdge_VMPoolContext.
+///
+/// The VM pool holds the VMs instantiating the same module, and leases them
+/// for serving one request per VM. Every VM has its own store, executor, and
+/// host modules. The caller owns the object and should call
+/// `WasmEdge_VMPoolDelete` to destroy it.
+///
+/// \param ConfCxt the WasmEdge_ConfigureContext as the configuration of the
+/// VMs. NULL for the default configuration.
+/// \param Size the count of the VMs.
+/// \param Reset the reset strategy of the returned VMs.
+///
+/// \returns pointer to context, NULL if failed.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_VMPoolContext *
+WasmEdge_VMPoolCreate(const WasmEdge_ConfigureContext *ConfCxt,
+                      const uint32_t Size, const WasmEdge_VMPoolReset Reset);
+
+/// Get the count of the VMs in the VM pool.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+///
+/// \returns the count of the VMs.
+WASMEDGE_CAPI_EXPORT extern uint32_t
+WasmEdge_VMPoolGetSize(const WasmEdge_VMPoolContext *Cxt);
+
+/// Get the VM in the VM pool by index.
+///
+/// The VMs can be set up before the instantiation, such as registering the
+/// imports. The returned VM context is owned by the VM pool, and the caller
+/// should __NOT__ call the `WasmEdge_VMDelete`.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param Index the index of the VM.
+///
+/// \returns pointer to the VM context, NULL if the index is out of range.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_VMContext *
+WasmEdge_VMPoolGetVMContext(WasmEdge_VMPoolContext *Cxt, const uint32_t Index);
+
+/// Instantiate the AST module in all VMs of the VM pool.
+///
+/// Load, validate, and instantiate the AST module in every VM, and start
+/// leasing them. This function can only be called once.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param ASTCxt the WasmEdge_ASTModuleContext to instantiate.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_VMPoolInstantiate(WasmEdge_VMPoolContext *Cxt,
+                           const WasmEdge_ASTModuleContext *ASTCxt);
+
+/// Lease a VM from the VM pool.
+///
+/// Wait until any VM is returned if all of them are leased. The leased VM
+/// should be returned by `WasmEdge_VMPoolReturn`.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param [out] VMCxt the leased WasmEdge_VMContext if succeeded.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_VMPoolLease(WasmEdge_VMPoolContext *Cxt, WasmEdge_VMContext **VMCxt);
+
+/// Lease a VM from the VM pool without waiting.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param [out] VMCxt the leased WasmEdge_VMContext if succeeded, or NULL if
+/// all VMs are leased.
+///
+/// \returns WasmEdge_Result. Call `WasmEdge_ResultGetMessage` for the error
+/// message.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Result
+WasmEdge_VMPoolTryLease(WasmEdge_VMPoolContext *Cxt,
+                        WasmEdge_VMContext **VMCxt);
+
+/// Return the leased VM to the VM pool.
+///
+/// The VM is reset by the reset strategy before being leased again.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param VMCxt the WasmEdge_VMContext leased from the VM pool.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_VMPoolReturn(WasmEdge_VMPoolContext *Cxt, WasmEdge_VMContext *VMCxt);
+
+/// Asynchronous invoke a WASM function by name on a VM leased from the VM
+/// pool.
+///
+/// The execution runs on the thread pool, and the VM is returned to the VM
+/// pool after the execution. The worker threads and the instantiated VMs are
+/// reused by the later executions. Cancelling the execution stops all leased
+/// VMs of the VM pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param FuncName the function name WasmEdge_String.
+/// \param Params the WasmEdge_Value buffer with the parameter values.
+/// \param ParamLen the parameter buffer length.
+///
+/// \returns WasmEdge_Async. Call `WasmEdge_AsyncGet` for the result, and call
+/// `WasmEdge_AsyncDelete` to destroy this object.
+WASMEDGE_CAPI_EXPORT extern WasmEdge_Async *
+WasmEdge_VMPoolAsyncExecute(WasmEdge_VMPoolContext *Cxt,
+                            const WasmEdge_String FuncName,
+                            const WasmEdge_Value *Params,
+                            const uint32_t ParamLen);
+
+/// Get the metrics of the VM pool.
+///
+/// This function is thread-safe.
+///
+/// \param Cxt the WasmEdge_VMPoolContext.
+/// \param [out] Metrics the metrics of the VM pool.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_VMPoolGetMetrics(const WasmEdge_VMPoolContext *Cxt,
+                          WasmEdge_VMPoolMetrics *Metrics);
+
+/// Deletion of the WasmEdge_VMPoolContext.
+///
+/// All leased VMs should be returned before calling this function. After
+/// calling this function, the context will be destroyed and should __NOT__ be
+/// used.
+///
+/// \param Cxt the WasmEdge_VMPoolContext to destroy.
+WASMEDGE_CAPI_EXPORT extern void
+WasmEdge_VMPoolDelete(WasmEdge_VMPoolContext *Cxt);
+
+// <<<<<<<< WasmEdge VM pool functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 #ifdef __cplusplus
 } /// extern "C"
 #endif
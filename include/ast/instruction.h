@@ -13,11 +13,13 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/arena.h"
 #include "common/enum_ast.hpp"
 #include "common/span.h"
 #include "common/types.h"
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 
 namespace WasmEdge {
@@ -45,32 +47,63 @@ public:
   };
   struct TryDescriptor {
     BlockType ResType;
-    uint32_t BlockParamNum;
+    /// Operand stack height under the block parameters, and distance back to
+    /// the enclosing try_table instruction or 0 for none. Set by the
+    /// validator for finding the handlers when an exception is thrown.
+    uint32_t StackHeight;
+    uint32_t TryOffset;
     uint32_t JumpEnd;
     std::vector<CatchDescriptor> Catch;
   };
+  struct HandlerDescriptor {
+    /// Switch to the continuation given by the switch instruction instead of
+    /// branching to the label.
+    bool IsSwitch;
+    uint32_t TagIndex;
+    uint32_t LabelIndex;
+    /// Continuation type of the suspended continuation passed to the label,
+    /// resolved by the validator.
+    uint32_t ContTypeIndex;
+    struct JumpDescriptor Jump;
+  };
+  struct ResumeDescriptor {
+    uint32_t ContTypeIndex;
+    /// Tag of the exception thrown at the suspension by resume_throw.
+    uint32_t TagIndex;
+    std::vector<HandlerDescriptor> Handlers;
+  };
+  /// Super-instruction kinds for the interpreter. The fused instruction is the
+  /// head of the sequence, and the following instructions are left unchanged
+  /// for the other consumers of the AST.
+  enum class SuperInstr : uint8_t {
+    None,
+    // local.get; local.get; binop
+    LocalLocalBinOp,
+    // local.get; local.get; binop; local.set
+    LocalLocalBinOpSet,
+    // local.get; t.const; binop
+    LocalConstBinOp,
+    // local.get; t.const; binop; local.set
+    LocalConstBinOpSet,
+  };
 
 public:
   /// Constructor assigns the OpCode and the Offset.
   Instruction(OpCode Byte, uint32_t Off = 0) noexcept
-      : Offset(Off), Code(Byte) {
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
-    Data.Num = static_cast<uint128_t>(0);
-#else
+      : Offset(Off), Code(static_cast<uint16_t>(Byte)) {
     Data.Num.Low = static_cast<uint64_t>(0);
     Data.Num.High = static_cast<uint64_t>(0);
-#endif
     Flags.IsAllocLabelList = false;
     Flags.IsAllocValTypeList = false;
     Flags.IsAllocBrCast = false;
     Flags.IsAllocTryCatch = false;
+    Flags.IsAllocResume = false;
   }
 
   /// Copy constructor.
   Instruction(const Instruction &Instr) noexcept
       : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
+        Flags(Instr.Flags), Super(Instr.Super) {
     if (Flags.IsAllocLabelList) {
       Data.BrTable.LabelList = new JumpDescriptor[Data.BrTable.LabelListSize];
       std::copy_n(Instr.Data.BrTable.LabelList, Data.BrTable.LabelListSize,
@@ -83,17 +116,20 @@ public:
       Data.BrCast = new BrCastDescriptor(*Instr.Data.BrCast);
     } else if (Flags.IsAllocTryCatch) {
       Data.TryCatch = new TryDescriptor(*Instr.Data.TryCatch);
+    } else if (Flags.IsAllocResume) {
+      Data.Resume = new ResumeDescriptor(*Instr.Data.Resume);
     }
   }
 
   /// Move constructor.
   Instruction(Instruction &&Instr) noexcept
       : Data(Instr.Data), Offset(Instr.Offset), Code(Instr.Code),
-        Flags(Instr.Flags) {
+        Flags(Instr.Flags), Super(Instr.Super) {
     Instr.Flags.IsAllocLabelList = false;
     Instr.Flags.IsAllocValTypeList = false;
     Instr.Flags.IsAllocBrCast = false;
     Instr.Flags.IsAllocTryCatch = false;
+    Instr.Flags.IsAllocResume = false;
   }
 
   /// Destructor.
@@ -109,11 +145,15 @@ public:
   }
 
   /// Getter of OpCode.
-  OpCode getOpCode() const noexcept { return Code; }
+  OpCode getOpCode() const noexcept { return static_cast<OpCode>(Code); }
 
   /// Getter of Offset.
   uint32_t getOffset() const noexcept { return Offset; }
 
+  /// Getter and setter of the super-instruction kind.
+  SuperInstr getSuperInstr() const noexcept { return Super; }
+  void setSuperInstr(SuperInstr Kind) noexcept { Super = Kind; }
+
   /// Getter and setter of block type.
   const BlockType &getBlockType() const noexcept { return Data.Blocks.ResType; }
   BlockType &getBlockType() noexcept { return Data.Blocks.ResType; }
@@ -166,21 +206,25 @@ public:
   const JumpDescriptor &getJump() const noexcept { return Data.Jump; }
   JumpDescriptor &getJump() noexcept { return Data.Jump; }
 
-  /// Getter and setter of selecting value types list.
+  /// Getter and setter of selecting value types list. The single value type,
+  /// which is the only valid case, is stored inline without allocation.
   void setValTypeListSize(uint32_t Size) {
     reset();
-    if (Size > 0) {
-      Data.SelectT.ValTypeListSize = Size;
+    Data.SelectT.ValTypeListSize = Size;
+    if (Size > 1) {
       Data.SelectT.ValTypeList = new ValType[Size];
       Flags.IsAllocValTypeList = true;
     }
   }
   Span<const ValType> getValTypeList() const noexcept {
-    return Span<const ValType>(Data.SelectT.ValTypeList,
+    return Span<const ValType>(Flags.IsAllocValTypeList
+                                   ? Data.SelectT.ValTypeList
+                                   : &Data.SelectT.ValTypeInline,
                                Data.SelectT.ValTypeListSize);
   }
   Span<ValType> getValTypeList() noexcept {
-    return Span<ValType>(Data.SelectT.ValTypeList,
+    return Span<ValType>(Flags.IsAllocValTypeList ? Data.SelectT.ValTypeList
+                                                  : &Data.SelectT.ValTypeInline,
                          Data.SelectT.ValTypeListSize);
   }
 
@@ -192,17 +236,41 @@ public:
   uint32_t getSourceIndex() const noexcept { return Data.Indices.SourceIdx; }
   uint32_t &getSourceIndex() noexcept { return Data.Indices.SourceIdx; }
 
+  /// Getter and setter of the byte size of the value of the variable
+  /// instructions, recorded by the validator. The values of the number types
+  /// are moved in their own sizes instead of the whole slots. 0 for the
+  /// others.
+  uint32_t getValueSize() const noexcept { return Data.Indices.SourceIdx; }
+  uint32_t &getValueSize() noexcept { return Data.Indices.SourceIdx; }
+
   /// Getter and setter of stack offset.
   uint32_t getStackOffset() const noexcept { return Data.Indices.StackOffset; }
   uint32_t &getStackOffset() noexcept { return Data.Indices.StackOffset; }
 
+  /// Getter and setter of the distance back to the innermost enclosing
+  /// try_table instruction for the throwing and calling instructions. 0 for
+  /// none.
+  uint32_t getTryOffset() const noexcept { return Data.Indices.TryOffset; }
+  uint32_t &getTryOffset() noexcept { return Data.Indices.TryOffset; }
+
   /// Getter and setter of memory alignment.
   uint32_t getMemoryAlign() const noexcept { return Data.Memories.MemAlign; }
   uint32_t &getMemoryAlign() noexcept { return Data.Memories.MemAlign; }
 
-  /// Getter of memory offset.
-  uint32_t getMemoryOffset() const noexcept { return Data.Memories.MemOffset; }
-  uint32_t &getMemoryOffset() noexcept { return Data.Memories.MemOffset; }
+  /// Getter and setter of memory offset. The offsets are kept in 48 bits,
+  /// and the larger ones are saturated, which are out of bounds for any
+  /// memory anyway.
+  uint64_t getMemoryOffset() const noexcept {
+    return static_cast<uint64_t>(Data.Memories.MemOffsetHigh) << 32 |
+           Data.Memories.MemOffset;
+  }
+  void setMemoryOffset(uint64_t Off) noexcept {
+    Off = std::min(Off, kMaxMemoryOffset);
+    Data.Memories.MemOffset = static_cast<uint32_t>(Off);
+    Data.Memories.MemOffsetHigh = static_cast<uint16_t>(Off >> 32);
+  }
+  static inline constexpr const uint64_t kMaxMemoryOffset =
+      (UINT64_C(1) << 48) - 1;
 
   /// Getter of memory lane.
   uint8_t getMemoryLane() const noexcept { return Data.Memories.MemLane; }
@@ -212,7 +280,8 @@ public:
   ValVariant getNum() const noexcept {
 #if defined(__x86_64__) || defined(__aarch64__) ||                             \
     (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
-    return ValVariant(Data.Num);
+    return ValVariant(static_cast<uint128_t>(Data.Num.High) << 64 |
+                      static_cast<uint128_t>(Data.Num.Low));
 #else
     uint128_t N{Data.Num.High, Data.Num.Low};
     return ValVariant(N);
@@ -221,7 +290,9 @@ public:
   void setNum(ValVariant N) noexcept {
 #if defined(__x86_64__) || defined(__aarch64__) ||                             \
     (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
-    Data.Num = N.get<uint128_t>();
+    uint128_t V = N.get<uint128_t>();
+    Data.Num.Low = static_cast<uint64_t>(V);
+    Data.Num.High = static_cast<uint64_t>(V >> 64);
 #else
     uint128_t V = N.get<uint128_t>();
     Data.Num.Low = V.low();
@@ -248,6 +319,29 @@ public:
   const TryDescriptor &getTryCatch() const noexcept { return *Data.TryCatch; }
   TryDescriptor &getTryCatch() noexcept { return *Data.TryCatch; }
 
+  /// Getter and setter of the handlers for resume and resume_throw
+  /// instructions. The try offset is kept beside them.
+  void setResume() {
+    reset();
+    Data.Resume = new ResumeDescriptor();
+    Flags.IsAllocResume = true;
+  }
+  const ResumeDescriptor &getResume() const noexcept {
+    return *Data.Resume;
+  }
+  ResumeDescriptor &getResume() noexcept { return *Data.Resume; }
+
+  /// Getter and setter of the raw content, for the validated code cache on the
+  /// same host. The allocated contents are not included, and are set by their
+  /// setters instead.
+  Span<const uint8_t> getRawContent() const noexcept {
+    return {reinterpret_cast<const uint8_t *>(&Data), sizeof(Data)};
+  }
+  void setRawContent(Span<const uint8_t> Raw) noexcept {
+    reset();
+    std::memcpy(&Data, Raw.data(), std::min(Raw.size(), sizeof(Data)));
+  }
+
 private:
   /// Release allocated resources.
   void reset() noexcept {
@@ -261,11 +355,14 @@ private:
       delete Data.BrCast;
     } else if (Flags.IsAllocTryCatch) {
       delete Data.TryCatch;
+    } else if (Flags.IsAllocResume) {
+      delete Data.Resume;
     }
     Flags.IsAllocLabelList = false;
     Flags.IsAllocValTypeList = false;
     Flags.IsAllocBrCast = false;
     Flags.IsAllocTryCatch = false;
+    Flags.IsAllocResume = false;
   }
 
   /// Swap function.
@@ -274,6 +371,7 @@ private:
     std::swap(Offset, Instr.Offset);
     std::swap(Code, Instr.Code);
     std::swap(Flags, Instr.Flags);
+    std::swap(Super, Instr.Super);
   }
 
   /// \name Data of instructions.
@@ -285,11 +383,13 @@ private:
       uint32_t JumpElse;
       BlockType ResType;
     } Blocks;
-    // Type 2: TargetIdx, SourceIdx and StackOffset.
+    // Type 2: TargetIdx, SourceIdx, StackOffset, and TryOffset. The variable
+    // instructions keep the value size in SourceIdx.
     struct {
       uint32_t TargetIdx;
       uint32_t SourceIdx;
       uint32_t StackOffset;
+      uint32_t TryOffset;
     } Indices;
     // Type 3: Jump.
     JumpDescriptor Jump;
@@ -303,25 +403,26 @@ private:
     // Type 6: ValTypeList.
     struct {
       uint32_t ValTypeListSize;
-      ValType *ValTypeList;
+      union {
+        ValType *ValTypeList;
+        ValType ValTypeInline;
+      };
     } SelectT;
-    // Type 7: TargetIdx, MemAlign, MemOffset, and MemLane.
+    // Type 7: TargetIdx, MemAlign, MemOffset, and MemLane. The high bits of
+    // the offset are in the padding.
     struct {
       uint32_t TargetIdx;
       uint32_t MemAlign;
       uint32_t MemOffset;
       uint8_t MemLane;
+      uint16_t MemOffsetHigh;
     } Memories;
-    // Type 8: Num.
-#if defined(__x86_64__) || defined(__aarch64__) ||                             \
-    (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
-    uint128_t Num;
-#else
+    // Type 8: Num. Stored in halves to keep the instructions 8-byte aligned,
+    // which shrinks them from 32 to 24 bytes.
     struct {
       uint64_t Low;
       uint64_t High;
     } Num;
-#endif
     // Type 9: End flags.
     struct {
       bool IsExprLast : 1;
@@ -331,20 +432,30 @@ private:
     BrCastDescriptor *BrCast;
     // Type 11: Try Block.
     TryDescriptor *TryCatch;
+    // Type 12: Resume handlers. The pointer is kept clear of the TryOffset of
+    // Type 2, which is also set for the resume instructions.
+    ResumeDescriptor *Resume;
   } Data;
   uint32_t Offset = 0;
-  OpCode Code = OpCode::End;
+  /// The opcodes are enumerated densely, and fit in 16 bits.
+  uint16_t Code = static_cast<uint16_t>(OpCode::End);
   struct {
     bool IsAllocLabelList : 1;
     bool IsAllocValTypeList : 1;
     bool IsAllocBrCast : 1;
     bool IsAllocTryCatch : 1;
+    bool IsAllocResume : 1;
   } Flags;
+  SuperInstr Super = SuperInstr::None;
   /// @}
 };
 
-// Type aliasing
-using InstrVec = std::vector<Instruction>;
+// The interpreter walks the instruction arrays, so keep them compact.
+static_assert(sizeof(Instruction) == 24, "Instruction should be 24 bytes");
+
+// Type aliasing. The instructions of a loaded module are allocated from the
+// arena of the module.
+using InstrVec = std::vector<Instruction, ArenaAllocator<Instruction>>;
 using InstrView = Span<const Instruction>;
 
 } // namespace AST
@@ -15,10 +15,16 @@
 #pragma once
 
 #include "ast/section.h"
+#include "common/arena.h"
+#include "common/filesystem.h"
 
+#include <memory>
 #include <vector>
 
 namespace WasmEdge {
+
+class MemoryImage;
+
 namespace AST {
 
 /// AST Module node.
@@ -68,17 +74,45 @@ public:
   const AOTSection &getAOTSection() const { return AOTSec; }
   AOTSection &getAOTSection() { return AOTSec; }
 
+  /// Getter of the arena allocating the nodes of this module. Shared with the
+  /// copies of this module, whose nodes are allocated from the heap.
+  Arena *getArena() const noexcept { return NodeArena.get(); }
+
   /// Getter and setter of compiled symbol.
   const auto &getSymbol() const noexcept { return IntrSymbol; }
   void setSymbol(Symbol<const Executable::IntrinsicsTable *> S) noexcept {
     IntrSymbol = std::move(S);
   }
 
+  /// Getter and setter of the memory images recorded at the first
+  /// instantiation, indexed by the defined memory index. An empty list marks
+  /// the module whose memories cannot be instantiated from images.
+  using MemoryImageList = std::vector<std::shared_ptr<const MemoryImage>>;
+  std::shared_ptr<const MemoryImageList> getMemoryImages() const noexcept {
+    return std::atomic_load(&MemImages);
+  }
+  void
+  setMemoryImages(std::shared_ptr<const MemoryImageList> Images) const noexcept {
+    std::atomic_store(&MemImages, std::move(Images));
+  }
+
+  /// Getter and setter of the path of the validated code cache to be saved.
+  /// Empty if the code cache is not used or the bodies are restored from it.
+  const std::filesystem::path &getCodeCachePath() const noexcept {
+    return CodeCachePath;
+  }
+  void setCodeCachePath(std::filesystem::path Path) noexcept {
+    CodeCachePath = std::move(Path);
+  }
+
   /// Getter and setter of validated flag.
   bool getIsValidated() const noexcept { return IsValidated; }
   void setIsValidated(bool V = true) noexcept { IsValidated = V; }
 
 private:
+  /// Arena of the nodes. Declared first to outlive them.
+  std::shared_ptr<Arena> NodeArena = std::make_shared<Arena>();
+
   /// \name Data of Module node.
   /// @{
   std::vector<Byte> Magic;
@@ -109,6 +143,16 @@ private:
   Symbol<const Executable::IntrinsicsTable *> IntrSymbol;
   /// @}
 
+  /// \name Data of memory images.
+  /// @{
+  mutable std::shared_ptr<const MemoryImageList> MemImages;
+  /// @}
+
+  /// \name Data of the validated code cache.
+  /// @{
+  std::filesystem::path CodeCachePath;
+  /// @}
+
   /// \name Validated flag.
   /// @{
   bool IsValidated = false;
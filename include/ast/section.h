@@ -15,7 +15,10 @@
 
 #include "ast/description.h"
 #include "ast/segment.h"
+#include "system/mmap.h"
 
+#include <array>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -48,15 +51,34 @@ public:
   std::string_view getName() const noexcept { return Name; }
   void setName(std::string_view N) { Name = N; }
 
-  /// Getter of content vector.
-  Span<const Byte> getContent() const noexcept { return Content; }
-  std::vector<Byte> &getContent() noexcept { return Content; }
+  /// Getter of content vector. The mutable getter copies the referenced
+  /// content first.
+  Span<const Byte> getContent() const noexcept {
+    return ContentHolder ? ContentView : Span<const Byte>(Content);
+  }
+  std::vector<Byte> &getContent() noexcept {
+    if (ContentHolder) {
+      Content.assign(ContentView.begin(), ContentView.end());
+      ContentHolder.reset();
+    }
+    return Content;
+  }
+
+  /// Setter of content referencing the memory kept alive by the holder.
+  void setContent(Span<const Byte> View,
+                  std::shared_ptr<const void> Holder) noexcept {
+    Content.clear();
+    ContentView = View;
+    ContentHolder = std::move(Holder);
+  }
 
 private:
   /// \name Data of CustomSection.
   /// @{
   std::string Name;
   std::vector<Byte> Content;
+  Span<const Byte> ContentView;
+  std::shared_ptr<const void> ContentHolder;
   /// @}
 };
 
@@ -257,6 +279,15 @@ public:
   uint8_t getArchType() const noexcept { return ArchType; }
   void setArchType(uint8_t Type) noexcept { ArchType = Type; }
 
+  /// Getter and setter of x86-64 micro-architecture level, 0 for any CPU.
+  uint8_t getTargetLevel() const noexcept { return TargetLevel; }
+  void setTargetLevel(uint8_t Level) noexcept { TargetLevel = Level; }
+
+  /// Getter of the Blake3 hash of the module bytes before the section, which
+  /// the code is compiled from.
+  constexpr const auto &getModuleHash() const noexcept { return ModuleHash; }
+  constexpr auto &getModuleHash() noexcept { return ModuleHash; }
+
   /// Getter and setter of version address.
   uint64_t getVersionAddress() const noexcept { return VersionAddress; }
   void setVersionAddress(uint64_t Addr) noexcept { VersionAddress = Addr; }
@@ -283,18 +314,40 @@ public:
   constexpr const auto &getSections() const noexcept { return Sections; }
   constexpr auto &getSections() noexcept { return Sections; }
 
+  /// Getter and setter of the file which the section is read from, and the
+  /// offset of the section content in the file. The text sections are left in
+  /// the file to be mapped directly. Null if not read from a file.
+  const std::shared_ptr<MMap> &getSourceFile() const noexcept {
+    return SourceFile;
+  }
+  uint64_t getSourceOffset() const noexcept { return SourceOffset; }
+  void setSourceFile(std::shared_ptr<MMap> File, uint64_t Offset) noexcept {
+    SourceFile = std::move(File);
+    SourceOffset = Offset;
+  }
+
+  /// Getter of the file offsets of the section contents left in the source
+  /// file, or 0 for the contents read in.
+  constexpr const auto &getFileOffsets() const noexcept { return FileOffsets; }
+  constexpr auto &getFileOffsets() noexcept { return FileOffsets; }
+
 private:
   /// \name Data of AOTSection.
   /// @{
   uint32_t Version;
   uint8_t OSType;
   uint8_t ArchType;
+  uint8_t TargetLevel;
+  std::array<Byte, 32> ModuleHash = {};
   uint64_t VersionAddress;
   uint64_t IntrinsicsAddress;
   std::vector<uintptr_t> TypesAddress;
   std::vector<uintptr_t> CodesAddress;
   std::vector<std::tuple<uint8_t, uint64_t, uint64_t, std::vector<Byte>>>
       Sections;
+  std::shared_ptr<MMap> SourceFile;
+  uint64_t SourceOffset = 0;
+  std::vector<uint64_t> FileOffsets;
   std::vector<uint8_t> Bytecodes;
   /// @}
 };
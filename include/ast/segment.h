@@ -16,7 +16,12 @@
 
 #include "ast/expression.h"
 #include "ast/type.h"
+#include "common/errcode.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace WasmEdge {
@@ -73,6 +78,17 @@ public:
   Span<const Expression> getInitExprs() const noexcept { return InitExprs; }
   std::vector<Expression> &getInitExprs() noexcept { return InitExprs; }
 
+  /// Getter and setter of the function indices of the initialization
+  /// expressions, recorded at the first instantiation. An empty list marks the
+  /// segment whose expressions are not all a single `ref.func`.
+  std::shared_ptr<const std::vector<uint32_t>> getFuncIdxs() const noexcept {
+    return std::atomic_load(&FuncIdxs);
+  }
+  void
+  setFuncIdxs(std::shared_ptr<const std::vector<uint32_t>> Idxs) const noexcept {
+    std::atomic_store(&FuncIdxs, std::move(Idxs));
+  }
+
 private:
   /// \name Data of ElementSegment node.
   /// @{
@@ -80,6 +96,7 @@ private:
   ValType Type = TypeCode::FuncRef;
   uint32_t TableIdx = 0;
   std::vector<Expression> InitExprs;
+  mutable std::shared_ptr<const std::vector<uint32_t>> FuncIdxs;
   /// @}
 };
 
@@ -97,6 +114,76 @@ private:
   /// @}
 };
 
+/// Function body deferred by the lazy loading mode. The body bytes are kept
+/// and decoded and validated by the registered passes on first use.
+class LazyFunctionBody {
+public:
+  /// Pass to decode or validate the body bytes into the expression.
+  using Pass = std::function<Expect<void>(Span<const Byte>, Expression &)>;
+
+  LazyFunctionBody(Span<const Byte> Code,
+                   std::shared_ptr<const void> Holder) noexcept
+      : Code(Code), Holder(std::move(Holder)) {}
+
+  /// Getter of the body bytes.
+  Span<const Byte> getCode() const noexcept { return Code; }
+
+  /// Setters of the decoding and validation passes.
+  void setDecoder(Pass P) { Decoder = std::move(P); }
+  void setValidator(Pass P) { Validator = std::move(P); }
+
+  /// Getter of checking the passes have been run.
+  bool isMaterialized() const noexcept {
+    return Materialized.load(std::memory_order_acquire);
+  }
+
+  /// Run the decoding and validation passes once. Thread-safe: the result,
+  /// including a failure, is kept for all the later callers.
+  Expect<void> materialize() noexcept {
+    if (likely(isMaterialized())) {
+      return Result;
+    }
+    std::unique_lock Lock(Mutex);
+    if (!Materialized.load(std::memory_order_relaxed)) {
+      if (Decoder) {
+        Result = Decoder(Code, Expr);
+      }
+      if (Result && Validator) {
+        Result = Validator(Code, Expr);
+      }
+      // The bytes and the contexts captured by the passes are not needed any
+      // more.
+      Decoder = nullptr;
+      Validator = nullptr;
+      Code = {};
+      Holder.reset();
+      Materialized.store(true, std::memory_order_release);
+    }
+    return Result;
+  }
+
+  /// Getter of the expression. Empty before materialized.
+  const Expression &getExpr() const noexcept { return Expr; }
+
+  /// Getter of the instructions. Empty before materialized.
+  InstrView getInstrs() const noexcept {
+    return isMaterialized() ? Expr.getInstrs() : InstrView();
+  }
+
+private:
+  /// \name Data of LazyFunctionBody.
+  /// @{
+  Span<const Byte> Code;
+  std::shared_ptr<const void> Holder;
+  Pass Decoder;
+  Pass Validator;
+  Expression Expr;
+  Expect<void> Result;
+  std::atomic<bool> Materialized = false;
+  std::mutex Mutex;
+  /// @}
+};
+
 /// AST CodeSegment node.
 class CodeSegment : public Segment {
 public:
@@ -116,12 +203,38 @@ public:
   const auto &getSymbol() const noexcept { return FuncSymbol; }
   void setSymbol(Symbol<void> S) noexcept { FuncSymbol = std::move(S); }
 
+  /// Getter and setter of the deferred body in the lazy loading mode. The
+  /// expression is empty if the body is deferred.
+  const std::shared_ptr<LazyFunctionBody> &getLazyBody() const noexcept {
+    return LazyBody;
+  }
+  void setLazyBody(std::shared_ptr<LazyFunctionBody> Body) noexcept {
+    LazyBody = std::move(Body);
+  }
+
+  /// Getter and setter of the flag of the body restored from the validated
+  /// code cache, which is not validated again.
+  bool isValidated() const noexcept { return Validated; }
+  void setValidated(bool V = true) noexcept { Validated = V; }
+
+  /// Getter of the function body instructions, which materializes the
+  /// deferred body first.
+  Expect<InstrView> getBodyInstrs() const noexcept {
+    if (LazyBody) {
+      EXPECTED_TRY(LazyBody->materialize());
+      return LazyBody->getInstrs();
+    }
+    return Expr.getInstrs();
+  }
+
 private:
   /// \name Data of CodeSegment node.
   /// @{
   uint32_t SegSize = 0;
   std::vector<std::pair<uint32_t, ValType>> Locals;
   Symbol<void> FuncSymbol;
+  std::shared_ptr<LazyFunctionBody> LazyBody;
+  bool Validated = false;
   /// @}
 };
 
@@ -139,9 +252,30 @@ public:
   uint32_t getIdx() const noexcept { return MemoryIdx; }
   void setIdx(uint32_t Idx) noexcept { MemoryIdx = Idx; }
 
-  /// Getter of data.
-  Span<const Byte> getData() const noexcept { return Data; }
-  std::vector<Byte> &getData() noexcept { return Data; }
+  /// Getter of data. The mutable getter copies the referenced data first.
+  Span<const Byte> getData() const noexcept {
+    return DataHolder ? DataView : Span<const Byte>(Data);
+  }
+  std::vector<Byte> &getData() noexcept {
+    if (DataHolder) {
+      Data.assign(DataView.begin(), DataView.end());
+      DataHolder.reset();
+    }
+    return Data;
+  }
+
+  /// Setter of data referencing the memory kept alive by the holder.
+  void setData(Span<const Byte> View,
+               std::shared_ptr<const void> Holder) noexcept {
+    Data.clear();
+    DataView = View;
+    DataHolder = std::move(Holder);
+  }
+
+  /// Getter of the holder of the referenced data. Null if the data is owned.
+  const std::shared_ptr<const void> &getDataHolder() const noexcept {
+    return DataHolder;
+  }
 
 private:
   /// \name Data of DataSegment node.
@@ -149,6 +283,8 @@ private:
   DataMode Mode = DataMode::Active;
   uint32_t MemoryIdx = 0;
   std::vector<Byte> Data;
+  Span<const Byte> DataView;
+  std::shared_ptr<const void> DataHolder;
   /// @}
 };
 
@@ -19,6 +19,7 @@
 #include "common/symbol.h"
 #include "common/types.h"
 
+#include <algorithm>
 #include <optional>
 #include <vector>
 
@@ -32,8 +33,12 @@ public:
   enum class LimitType : uint8_t {
     HasMin = 0x00,
     HasMinMax = 0x01,
-    SharedNoMax = 0x02, // For threads proposal, invalid
-    Shared = 0x03       // For threads proposal
+    SharedNoMax = 0x02,    // For threads proposal, invalid
+    Shared = 0x03,         // For threads proposal
+    I64HasMin = 0x04,      // For memory64 proposal
+    I64HasMinMax = 0x05,   // For memory64 proposal
+    I64SharedNoMax = 0x06, // For memory64 and threads proposal, invalid
+    I64Shared = 0x07       // For memory64 and threads proposal
   };
 
   /// Constructors.
@@ -52,6 +57,9 @@ public:
   /// Getter and setter of limit mode.
   bool hasMax() const noexcept { return static_cast<uint8_t>(Type) & 0x01U; }
   bool isShared() const noexcept { return static_cast<uint8_t>(Type) & 0x02U; }
+  /// The 64-bit index type of the memory64 proposal. The page counts are
+  /// still in 32 bits, which is 256 TiB and beyond the host address space.
+  bool is64() const noexcept { return static_cast<uint8_t>(Type) & 0x04U; }
   void setType(LimitType TargetType) noexcept { Type = TargetType; }
 
   /// Getter and setter of min value.
@@ -137,6 +145,13 @@ public:
   ValMut getValMut() const noexcept { return Mut; }
   void setValMut(ValMut VMut) noexcept { Mut = VMut; }
 
+  /// Getter of the byte size of the packed storage of the field. The packed
+  /// types are stored in their widths, and the references in whole.
+  uint32_t getStorageSize() const noexcept {
+    return Type.isRefType() ? static_cast<uint32_t>(sizeof(RefVariant))
+                            : Type.getBitWidth() / 8U;
+  }
+
 private:
   /// \name Data of FieldType.
   /// @{
@@ -163,20 +178,37 @@ public:
   const std::vector<FieldType> &getFieldTypes() const noexcept {
     return *std::get_if<std::vector<FieldType>>(&FType);
   }
+  /// Getter of the function type index of a continuation type.
+  uint32_t getContTypeIndex() const noexcept {
+    return *std::get_if<uint32_t>(&FType);
+  }
+
+  /// Getter of the byte offsets of the fields in the packed storage, and of
+  /// the byte size of the storage of a struct.
+  Span<const uint32_t> getFieldOffsets() const noexcept {
+    return FieldOffsets;
+  }
+  uint32_t getFieldsSize() const noexcept { return FieldsSize; }
 
   /// Setter of content.
   void setArrayType(FieldType &&FT) noexcept {
     Type = TypeCode::Array;
     FType = std::vector<FieldType>{std::move(FT)};
+    computeLayout();
   }
   void setStructType(std::vector<FieldType> &&VFT) noexcept {
     Type = TypeCode::Struct;
     FType = std::move(VFT);
+    computeLayout();
   }
   void setFunctionType(FunctionType &&FT) noexcept {
     Type = TypeCode::Func;
     FType = std::move(FT);
   }
+  void setContType(uint32_t FuncTypeIdx) noexcept {
+    Type = TypeCode::Cont;
+    FType = FuncTypeIdx;
+  }
 
   /// Getter of content type.
   TypeCode getContentTypeCode() const noexcept { return Type; }
@@ -184,6 +216,9 @@ public:
   /// Checker if is a function type.
   bool isFunc() const noexcept { return (Type == TypeCode::Func); }
 
+  /// Checker if is a continuation type.
+  bool isCont() const noexcept { return (Type == TypeCode::Cont); }
+
   /// Expand the composite type to its reference.
   TypeCode expand() const noexcept {
     switch (Type) {
@@ -193,16 +228,36 @@ public:
       return TypeCode::StructRef;
     case TypeCode::Array:
       return TypeCode::ArrayRef;
+    case TypeCode::Cont:
+      return TypeCode::ContRef;
     default:
       assumingUnreachable();
     }
   }
 
 private:
+  /// Lay out the fields in order with the natural alignments, so that the
+  /// offsets of the fields of a subtype are the same as its supertypes.
+  void computeLayout() noexcept {
+    const auto &Fields = getFieldTypes();
+    FieldOffsets.resize(Fields.size());
+    uint32_t Offset = 0;
+    for (size_t I = 0; I < Fields.size(); ++I) {
+      const uint32_t Size = Fields[I].getStorageSize();
+      const uint32_t Align = std::min(Size, 8U);
+      Offset = (Offset + Align - 1U) / Align * Align;
+      FieldOffsets[I] = Offset;
+      Offset += Size;
+    }
+    FieldsSize = Offset;
+  }
+
   /// \name Data of CompositeType.
   /// @{
   TypeCode Type;
-  std::variant<std::vector<FieldType>, FunctionType> FType;
+  std::variant<std::vector<FieldType>, FunctionType, uint32_t> FType;
+  std::vector<uint32_t> FieldOffsets;
+  uint32_t FieldsSize = 0;
   /// @}
 };
 
@@ -329,6 +384,9 @@ public:
       const auto &GotFType = Got.getFieldTypes();
       return isFieldTypeMatched(ExpFType[0], GotFType[0]);
     }
+    case TypeCode::Cont:
+      return matchType(TypeList, Exp.getContTypeIndex(),
+                       Got.getContTypeIndex());
     default:
       return false;
     }
@@ -416,6 +474,8 @@ public:
           return matchTypeCode(TypeCode::FuncRef, ExpandGotType);
         case TypeCode::NullExternRef:
           return matchTypeCode(TypeCode::ExternRef, ExpandGotType);
+        case TypeCode::NullContRef:
+          return matchTypeCode(TypeCode::ContRef, ExpandGotType);
         default:
           return false;
         }
@@ -557,9 +617,10 @@ private:
       return true;
     };
 
-    auto isCompTypeEqual = [isFuncTypeEqual, isFieldTypeEqual](
-                               const CompositeType &LCompType,
-                               const CompositeType &RCompType) -> bool {
+    auto isCompTypeEqual =
+        [isValTypeEqual, isFuncTypeEqual, isFieldTypeEqual](
+            const CompositeType &LCompType,
+            const CompositeType &RCompType) -> bool {
       if (LCompType.expand() != RCompType.expand()) {
         return false;
       }
@@ -571,6 +632,10 @@ private:
       case TypeCode::ArrayRef:
         return isFieldTypeEqual(LCompType.getFieldTypes(),
                                 RCompType.getFieldTypes());
+      case TypeCode::ContRef:
+        return isValTypeEqual(
+            ValType(TypeCode::Ref, LCompType.getContTypeIndex()),
+            ValType(TypeCode::Ref, RCompType.getContTypeIndex()));
       default:
         assumingUnreachable();
       }
@@ -635,6 +700,14 @@ private:
       return false;
     }
 
+    // Match the continuation types: nocont <= cont
+    if (Exp == TypeCode::ContRef || Exp == TypeCode::NullContRef) {
+      return Got == TypeCode::NullContRef;
+    }
+    if (Got == TypeCode::ContRef || Got == TypeCode::NullContRef) {
+      return false;
+    }
+
     // Match the other types: none <= i31 | struct | array <= eq <= any
     switch (Exp) {
     case TypeCode::I31Ref:
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/arena.h - Arena allocator definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the monotonic arena and the allocator
+/// of the containers allocating from it.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace WasmEdge {
+
+/// Monotonic arena allocating from large blocks. The memory is only released
+/// when the arena is destroyed, so that the nodes sharing the lifetime of the
+/// arena are allocated by bumping a pointer and released all at once. Not
+/// thread-safe.
+class Arena {
+public:
+  Arena() noexcept = default;
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *allocate(size_t Size, size_t Align) {
+    auto Ptr = alignUp(Cur, Align);
+    if (Ptr + Size > End) {
+      // The oversized requests get their own blocks without changing the
+      // current block.
+      if (Size + Align > kMaxBlockSize) {
+        auto &Block = Blocks.emplace_back(new std::byte[Size + Align]);
+        Allocated += Size + Align;
+        return reinterpret_cast<void *>(
+            alignUp(reinterpret_cast<uintptr_t>(Block.get()), Align));
+      }
+      const size_t BlockSize = std::max(NextBlockSize, Size + Align);
+      NextBlockSize = std::min(NextBlockSize * 2, kMaxBlockSize);
+      auto &Block = Blocks.emplace_back(new std::byte[BlockSize]);
+      Allocated += BlockSize;
+      Cur = reinterpret_cast<uintptr_t>(Block.get());
+      End = Cur + BlockSize;
+      Ptr = alignUp(Cur, Align);
+    }
+    Cur = Ptr + Size;
+    return reinterpret_cast<void *>(Ptr);
+  }
+
+  /// Getter of the total size of the blocks.
+  size_t getAllocatedSize() const noexcept { return Allocated; }
+
+private:
+  static inline constexpr size_t kMinBlockSize = 64 * 1024;
+  static inline constexpr size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+  static uintptr_t alignUp(uintptr_t Ptr, size_t Align) noexcept {
+    return (Ptr + Align - 1) & ~static_cast<uintptr_t>(Align - 1);
+  }
+
+  std::vector<std::unique_ptr<std::byte[]>> Blocks;
+  uintptr_t Cur = 0;
+  uintptr_t End = 0;
+  size_t NextBlockSize = kMinBlockSize;
+  size_t Allocated = 0;
+};
+
+/// Allocator of the containers allocating from an arena, or from the heap if
+/// no arena is given. The copies of the containers are allocated from the
+/// heap, so that they can outlive the arena.
+template <typename T> class ArenaAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() noexcept = default;
+  explicit ArenaAllocator(Arena *A) noexcept : Owner(A) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &RHS) noexcept
+      : Owner(RHS.getArena()) {}
+
+  T *allocate(size_t N) {
+    if (Owner) {
+      return static_cast<T *>(Owner->allocate(N * sizeof(T), alignof(T)));
+    }
+    return std::allocator<T>().allocate(N);
+  }
+  void deallocate(T *Ptr, size_t N) noexcept {
+    if (!Owner) {
+      std::allocator<T>().deallocate(Ptr, N);
+    }
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const noexcept {
+    return ArenaAllocator();
+  }
+
+  Arena *getArena() const noexcept { return Owner; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &RHS) const noexcept {
+    return Owner == RHS.getArena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &RHS) const noexcept {
+    return Owner != RHS.getArena();
+  }
+
+private:
+  Arena *Owner = nullptr;
+};
+
+} // namespace WasmEdge
@@ -14,28 +14,39 @@
 #pragma once
 
 #include "errcode.h"
+#include "threadpool.h"
 
+#include <functional>
 #include <future>
-#include <thread>
+#include <mutex>
 
 namespace WasmEdge {
 
-/// Async execution flow class
+/// Async execution flow class. The execution runs on the default thread pool.
 template <typename T> class Async {
 public:
   Async() noexcept = default;
   template <typename Inst, typename... FArgsT, typename... ArgsT>
   Async(T (Inst::*FPtr)(FArgsT...), Inst &TargetInst, ArgsT &&...Args)
-      : StopFunc([&TargetInst]() { TargetInst.stop(); }) {
+      : StopFunc([&TargetInst]() { TargetInst.stop(); }),
+        Done(std::make_shared<Completion>()) {
     std::promise<T> Promise;
     Future = Promise.get_future();
-    Thread =
-        std::thread([FPtr, P = std::move(Promise),
-                     Tuple = std::tuple(
-                         &TargetInst, std::forward<ArgsT>(Args)...)]() mutable {
+    ThreadPool::getDefault().submit(
+        [FPtr, P = std::move(Promise), F = Future, D = Done,
+         Tuple = std::tuple(&TargetInst,
+                            std::forward<ArgsT>(Args)...)]() mutable {
           P.set_value(std::apply(FPtr, Tuple));
+          std::function<void(const T &)> Callback;
+          {
+            std::unique_lock Lock(D->Mutex);
+            D->IsDone = true;
+            Callback = std::move(D->Callback);
+          }
+          if (Callback) {
+            Callback(F.get());
+          }
         });
-    Thread.detach();
   }
   Async(const Async &) noexcept = delete;
   Async(Async &&Other) noexcept : Async() { swap(*this, Other); }
@@ -61,11 +72,27 @@ public:
     return Future.wait_until(Timeout) == std::future_status::ready;
   }
 
+  /// Call the callback with the result on the worker when completed, or on
+  /// the calling thread now if already completed.
+  void setCallback(std::function<void(const T &)> Callback) {
+    if (unlikely(!Done)) {
+      return;
+    }
+    {
+      std::unique_lock Lock(Done->Mutex);
+      if (!Done->IsDone) {
+        Done->Callback = std::move(Callback);
+        return;
+      }
+    }
+    Callback(Future.get());
+  }
+
   friend void swap(Async &LHS, Async &RHS) noexcept {
     using std::swap;
     swap(LHS.Future, RHS.Future);
-    swap(LHS.Thread, RHS.Thread);
     swap(LHS.StopFunc, RHS.StopFunc);
+    swap(LHS.Done, RHS.Done);
   }
 
   void cancel() noexcept {
@@ -75,9 +102,15 @@ public:
   }
 
 protected:
+  struct Completion {
+    std::mutex Mutex;
+    bool IsDone = false;
+    std::function<void(const T &)> Callback;
+  };
+
   std::shared_future<T> Future;
-  std::thread Thread;
   std::function<void()> StopFunc;
+  std::shared_ptr<Completion> Done;
 };
 
 } // namespace WasmEdge
@@ -38,7 +38,12 @@ public:
         OFormat(RHS.OFormat.load(std::memory_order_relaxed)),
         DumpIR(RHS.DumpIR.load(std::memory_order_relaxed)),
         GenericBinary(RHS.GenericBinary.load(std::memory_order_relaxed)),
-        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)) {}
+        Interruptible(RHS.Interruptible.load(std::memory_order_relaxed)),
+        PartitionCount(RHS.PartitionCount.load(std::memory_order_relaxed)),
+        FunctionCache(RHS.FunctionCache.load(std::memory_order_relaxed)),
+        CoarseGasCheck(RHS.CoarseGasCheck.load(std::memory_order_relaxed)),
+        TargetLevel(RHS.TargetLevel.load(std::memory_order_relaxed)),
+        InlineBudget(RHS.InlineBudget.load(std::memory_order_relaxed)) {}
 
   /// AOT compiler optimization level enum class.
   enum class OptimizationLevel : uint8_t {
@@ -102,12 +107,73 @@ public:
     return Interruptible.load(std::memory_order_relaxed);
   }
 
+  /// Split the functions into this many LLVM modules, which are optimized and
+  /// code generated in parallel. 0 or 1 for a single module.
+  void setPartitionCount(uint32_t Count) noexcept {
+    PartitionCount.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getPartitionCount() const noexcept {
+    return PartitionCount.load(std::memory_order_relaxed);
+  }
+
+  /// Compile every function into its own object and keep the objects in the
+  /// local cache, keyed by the hash of the function IR and the code generation
+  /// options. Unchanged functions are reused by later compilations.
+  void setFunctionCache(bool IsFunctionCache) noexcept {
+    FunctionCache.store(IsFunctionCache, std::memory_order_relaxed);
+  }
+
+  bool isFunctionCache() const noexcept {
+    return FunctionCache.load(std::memory_order_relaxed);
+  }
+
+  /// Check the gas limit of the cost measuring only at the loop headers, the
+  /// calls, and the returns, instead of also at every block. The total cost is
+  /// the same, but a run exceeding the limit may trap a little later.
+  void setCoarseGasCheck(bool IsCoarseGasCheck) noexcept {
+    CoarseGasCheck.store(IsCoarseGasCheck, std::memory_order_relaxed);
+  }
+
+  bool isCoarseGasCheck() const noexcept {
+    return CoarseGasCheck.load(std::memory_order_relaxed);
+  }
+
+  /// Generate the code for the x86-64 micro-architecture level 1 to 4 instead
+  /// of the host CPU, and record the level in the AOT section. The loader
+  /// picks the highest level supported by the running CPU among the AOT
+  /// sections of a universal wasm file. 0 for the host CPU. Ignored on the
+  /// other architectures.
+  void setTargetLevel(uint8_t Level) noexcept {
+    TargetLevel.store(Level, std::memory_order_relaxed);
+  }
+
+  uint8_t getTargetLevel() const noexcept {
+    return TargetLevel.load(std::memory_order_relaxed);
+  }
+
+  /// Always inline the functions with at most this many instructions, and the
+  /// host function trampolines, into their callers. 0 leaves the inlining to
+  /// the cost model of the optimization level.
+  void setInlineBudget(uint32_t Budget) noexcept {
+    InlineBudget.store(Budget, std::memory_order_relaxed);
+  }
+
+  uint32_t getInlineBudget() const noexcept {
+    return InlineBudget.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<OptimizationLevel> OptLevel = OptimizationLevel::O3;
   std::atomic<OutputFormat> OFormat = OutputFormat::Wasm;
   std::atomic<bool> DumpIR = false;
   std::atomic<bool> GenericBinary = false;
   std::atomic<bool> Interruptible = false;
+  std::atomic<uint32_t> PartitionCount = 1;
+  std::atomic<bool> FunctionCache = false;
+  std::atomic<bool> CoarseGasCheck = false;
+  std::atomic<uint8_t> TargetLevel = 0;
+  std::atomic<uint32_t> InlineBudget = 0;
 };
 
 class RuntimeConfigure {
@@ -116,10 +182,56 @@ public:
   RuntimeConfigure(const RuntimeConfigure &RHS) noexcept
       : MaxMemPage(RHS.MaxMemPage.load(std::memory_order_relaxed)),
         EnableJIT(RHS.EnableJIT.load(std::memory_order_relaxed)),
+        EnableLazyJIT(RHS.EnableLazyJIT.load(std::memory_order_relaxed)),
+        EnableJITSpeculation(
+            RHS.EnableJITSpeculation.load(std::memory_order_relaxed)),
+        EnableJITCache(RHS.EnableJITCache.load(std::memory_order_relaxed)),
         EnableCoredump(RHS.EnableCoredump.load(std::memory_order_relaxed)),
         CoredumpWasmgdb(RHS.CoredumpWasmgdb.load(std::memory_order_relaxed)),
+        CoredumpAsync(RHS.CoredumpAsync.load(std::memory_order_relaxed)),
+        CoredumpInterval(RHS.CoredumpInterval.load(std::memory_order_relaxed)),
         ForceInterpreter(RHS.ForceInterpreter.load(std::memory_order_relaxed)),
-        AllowAFUNIX(RHS.AllowAFUNIX.load(std::memory_order_relaxed)) {}
+        AllowAFUNIX(RHS.AllowAFUNIX.load(std::memory_order_relaxed)),
+        EnableSuperInstructions(
+            RHS.EnableSuperInstructions.load(std::memory_order_relaxed)),
+        ValueStackSize(RHS.ValueStackSize.load(std::memory_order_relaxed)),
+        EnableTieredJIT(RHS.EnableTieredJIT.load(std::memory_order_relaxed)),
+        TierUpThreshold(RHS.TierUpThreshold.load(std::memory_order_relaxed)),
+        EnableZeroCopyLoad(
+            RHS.EnableZeroCopyLoad.load(std::memory_order_relaxed)),
+        EnableLazyFunctionBody(
+            RHS.EnableLazyFunctionBody.load(std::memory_order_relaxed)),
+        EnableTrustedAOT(RHS.EnableTrustedAOT.load(std::memory_order_relaxed)),
+        ValidationThreadCount(
+            RHS.ValidationThreadCount.load(std::memory_order_relaxed)),
+        LoadingThreadCount(
+            RHS.LoadingThreadCount.load(std::memory_order_relaxed)),
+        MemoryPoolSize(RHS.MemoryPoolSize.load(std::memory_order_relaxed)),
+        StripedMemoryPages(
+            RHS.StripedMemoryPages.load(std::memory_order_relaxed)),
+        EnableMemoryImage(
+            RHS.EnableMemoryImage.load(std::memory_order_relaxed)),
+        EnableHugePages(RHS.EnableHugePages.load(std::memory_order_relaxed)),
+        EnableBackgroundReclamation(
+            RHS.EnableBackgroundReclamation.load(std::memory_order_relaxed)),
+        EnableHugePageCode(
+            RHS.EnableHugePageCode.load(std::memory_order_relaxed)),
+        EnableLazyTable(RHS.EnableLazyTable.load(std::memory_order_relaxed)),
+        EnableGuardRegion(
+            RHS.EnableGuardRegion.load(std::memory_order_relaxed)),
+        MemoryBudgetSoft(RHS.MemoryBudgetSoft.load(std::memory_order_relaxed)),
+        MemoryBudgetHard(RHS.MemoryBudgetHard.load(std::memory_order_relaxed)),
+        GCThreshold(RHS.GCThreshold.load(std::memory_order_relaxed)),
+        EnableIoUring(RHS.EnableIoUring.load(std::memory_order_relaxed)),
+        EnableWasiPathCache(
+            RHS.EnableWasiPathCache.load(std::memory_order_relaxed)),
+        EnableCodeCache(RHS.EnableCodeCache.load(std::memory_order_relaxed)),
+        EnableFusedValidation(
+            RHS.EnableFusedValidation.load(std::memory_order_relaxed)),
+        NumaNode(RHS.NumaNode.load(std::memory_order_relaxed)),
+        EnableCpuAccounting(
+            RHS.EnableCpuAccounting.load(std::memory_order_relaxed)),
+        NativeStackSize(RHS.NativeStackSize.load(std::memory_order_relaxed)) {}
 
   void setMaxMemoryPage(const uint32_t Page) noexcept {
     MaxMemPage.store(Page, std::memory_order_relaxed);
@@ -137,6 +249,37 @@ public:
     return EnableJIT.load(std::memory_order_relaxed);
   }
 
+  /// Compile every function of the JIT mode at its first call instead of
+  /// compiling the whole module before the instantiation.
+  void setEnableLazyJIT(bool IsEnableLazyJIT) noexcept {
+    EnableLazyJIT.store(IsEnableLazyJIT, std::memory_order_relaxed);
+  }
+
+  bool isEnableLazyJIT() const noexcept {
+    return EnableLazyJIT.load(std::memory_order_relaxed);
+  }
+
+  /// Compile the callees of a function in the lazy JIT mode on a background
+  /// thread once the function is compiled.
+  void setEnableJITSpeculation(bool IsEnableJITSpeculation) noexcept {
+    EnableJITSpeculation.store(IsEnableJITSpeculation,
+                               std::memory_order_relaxed);
+  }
+
+  bool isEnableJITSpeculation() const noexcept {
+    return EnableJITSpeculation.load(std::memory_order_relaxed);
+  }
+
+  /// Store the shared library compiled by the JIT mode into the AOT cache,
+  /// and load it instead of compiling again on the later runs.
+  void setEnableJITCache(bool IsEnableJITCache) noexcept {
+    EnableJITCache.store(IsEnableJITCache, std::memory_order_relaxed);
+  }
+
+  bool isEnableJITCache() const noexcept {
+    return EnableJITCache.load(std::memory_order_relaxed);
+  }
+
   void setEnableCoredump(bool IsEnableCoredump) noexcept {
     EnableCoredump.store(IsEnableCoredump, std::memory_order_relaxed);
   }
@@ -153,6 +296,26 @@ public:
     return CoredumpWasmgdb.load(std::memory_order_relaxed);
   }
 
+  /// Serialize and write the coredumps by the thread pool instead of the
+  /// trapped thread. The pending coredumps are not waited for at exit.
+  void setCoredumpAsync(bool IsCoredumpAsync) noexcept {
+    CoredumpAsync.store(IsCoredumpAsync, std::memory_order_relaxed);
+  }
+
+  bool isCoredumpAsync() const noexcept {
+    return CoredumpAsync.load(std::memory_order_relaxed);
+  }
+
+  /// Minimum seconds between the coredumps of the same module. 0 for no
+  /// limit.
+  void setCoredumpInterval(const uint32_t Seconds) noexcept {
+    CoredumpInterval.store(Seconds, std::memory_order_relaxed);
+  }
+
+  uint32_t getCoredumpInterval() const noexcept {
+    return CoredumpInterval.load(std::memory_order_relaxed);
+  }
+
   void setForceInterpreter(bool IsForceInterpreter) noexcept {
     ForceInterpreter.store(IsForceInterpreter, std::memory_order_relaxed);
   }
@@ -169,13 +332,338 @@ public:
     return AllowAFUNIX.load(std::memory_order_relaxed);
   }
 
+  /// Fuse the common instruction sequences into super-instructions for the
+  /// interpreter when validating.
+  void setEnableSuperInstructions(bool IsEnable) noexcept {
+    EnableSuperInstructions.store(IsEnable, std::memory_order_relaxed);
+  }
+
+  bool isEnableSuperInstructions() const noexcept {
+    return EnableSuperInstructions.load(std::memory_order_relaxed);
+  }
+
+  /// Use a fixed-capacity, guard-paged value stack of this many entries for
+  /// the interpreter. 0 for the growable value stack.
+  void setValueStackSize(const uint32_t Size) noexcept {
+    ValueStackSize.store(Size, std::memory_order_relaxed);
+  }
+
+  uint32_t getValueStackSize() const noexcept {
+    return ValueStackSize.load(std::memory_order_relaxed);
+  }
+
+  /// Start in the interpreter and JIT compile the module on a background
+  /// thread once one of its functions becomes hot.
+  void setEnableTieredJIT(bool IsEnableTieredJIT) noexcept {
+    EnableTieredJIT.store(IsEnableTieredJIT, std::memory_order_relaxed);
+  }
+
+  bool isEnableTieredJIT() const noexcept {
+    return EnableTieredJIT.load(std::memory_order_relaxed);
+  }
+
+  /// Count of calls and loop back-edges after which a function is hot.
+  void setTierUpThreshold(const uint32_t Threshold) noexcept {
+    TierUpThreshold.store(Threshold, std::memory_order_relaxed);
+  }
+
+  uint32_t getTierUpThreshold() const noexcept {
+    return TierUpThreshold.load(std::memory_order_relaxed);
+  }
+
+  /// Reference the data segments and custom sections in the loaded file or
+  /// buffer instead of copying them. The file must not be modified while the
+  /// module is alive.
+  void setEnableZeroCopyLoad(bool IsEnableZeroCopyLoad) noexcept {
+    EnableZeroCopyLoad.store(IsEnableZeroCopyLoad, std::memory_order_relaxed);
+  }
+
+  bool isEnableZeroCopyLoad() const noexcept {
+    return EnableZeroCopyLoad.load(std::memory_order_relaxed);
+  }
+
+  /// Defer decoding and validating the function bodies to their first call
+  /// in interpreter mode, or to the AOT or JIT compilation.
+  void setEnableLazyFunctionBody(bool IsEnableLazyFunctionBody) noexcept {
+    EnableLazyFunctionBody.store(IsEnableLazyFunctionBody,
+                                 std::memory_order_relaxed);
+  }
+
+  bool isEnableLazyFunctionBody() const noexcept {
+    return EnableLazyFunctionBody.load(std::memory_order_relaxed);
+  }
+
+  /// Trust the AOT compiled code which matches the module hash embedded by the
+  /// compiler, and skip decoding and validating the function bodies.
+  void setEnableTrustedAOT(bool IsEnableTrustedAOT) noexcept {
+    EnableTrustedAOT.store(IsEnableTrustedAOT, std::memory_order_relaxed);
+  }
+
+  bool isEnableTrustedAOT() const noexcept {
+    return EnableTrustedAOT.load(std::memory_order_relaxed);
+  }
+
+  /// Validate the function bodies in this many threads, each with its own
+  /// formal checker. 0 for the hardware concurrency.
+  void setValidationThreadCount(const uint32_t Count) noexcept {
+    ValidationThreadCount.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getValidationThreadCount() const noexcept {
+    return ValidationThreadCount.load(std::memory_order_relaxed);
+  }
+
+  /// Decode the function bodies in this many threads, after a pass over the
+  /// boundaries of the bodies in the code section. 0 for the hardware
+  /// concurrency.
+  void setLoadingThreadCount(const uint32_t Count) noexcept {
+    LoadingThreadCount.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getLoadingThreadCount() const noexcept {
+    return LoadingThreadCount.load(std::memory_order_relaxed);
+  }
+
+  /// Keep up to this many released linear memory reservations for the later
+  /// memory instances instead of unmapping them. The pool is process-wide and
+  /// applied when an executor is created. 0 for not changing the pool.
+  void setMemoryPoolSize(const uint32_t Count) noexcept {
+    MemoryPoolSize.store(Count, std::memory_order_relaxed);
+  }
+
+  uint32_t getMemoryPoolSize() const noexcept {
+    return MemoryPoolSize.load(std::memory_order_relaxed);
+  }
+
+  /// Stripe the linear memories of at most this many pages into the slots of
+  /// a shared reservation isolated by the memory protection keys, instead of
+  /// reserving 12G for each. The setting is process-wide and enabled once
+  /// when an executor is created. 0 for not enabling it.
+  void setStripedMemoryPages(const uint32_t Pages) noexcept {
+    StripedMemoryPages.store(Pages, std::memory_order_relaxed);
+  }
+
+  uint32_t getStripedMemoryPages() const noexcept {
+    return StripedMemoryPages.load(std::memory_order_relaxed);
+  }
+
+  /// Record the initialized memories of a module at its first instantiation,
+  /// and map them copy-on-write into the memories of the later instances
+  /// instead of copying the data segments again.
+  void setEnableMemoryImage(bool IsEnableMemoryImage) noexcept {
+    EnableMemoryImage.store(IsEnableMemoryImage, std::memory_order_relaxed);
+  }
+
+  bool isEnableMemoryImage() const noexcept {
+    return EnableMemoryImage.load(std::memory_order_relaxed);
+  }
+
+  /// Back the linear memories with the transparent huge pages. The setting is
+  /// process-wide and applied when an executor is created.
+  void setEnableHugePages(bool IsEnableHugePages) noexcept {
+    EnableHugePages.store(IsEnableHugePages, std::memory_order_relaxed);
+  }
+
+  bool isEnableHugePages() const noexcept {
+    return EnableHugePages.load(std::memory_order_relaxed);
+  }
+
+  /// Destroy the released module instances and AST modules on a background
+  /// thread. The setting is process-wide and applied when an executor is
+  /// created.
+  void setEnableBackgroundReclamation(bool IsEnable) noexcept {
+    EnableBackgroundReclamation.store(IsEnable, std::memory_order_relaxed);
+  }
+
+  bool isEnableBackgroundReclamation() const noexcept {
+    return EnableBackgroundReclamation.load(std::memory_order_relaxed);
+  }
+
+  /// Back the code loaded from the AOT sections with the transparent huge
+  /// pages.
+  void setEnableHugePageCode(bool IsEnableHugePageCode) noexcept {
+    EnableHugePageCode.store(IsEnableHugePageCode, std::memory_order_relaxed);
+  }
+
+  bool isEnableHugePageCode() const noexcept {
+    return EnableHugePageCode.load(std::memory_order_relaxed);
+  }
+
+  /// Resolve the function references of the active element segments into the
+  /// tables at their first access instead of at instantiation.
+  void setEnableLazyTable(bool IsEnableLazyTable) noexcept {
+    EnableLazyTable.store(IsEnableLazyTable, std::memory_order_relaxed);
+  }
+
+  bool isEnableLazyTable() const noexcept {
+    return EnableLazyTable.load(std::memory_order_relaxed);
+  }
+
+  /// Skip the bounds checks of the scalar loads and stores in the interpreter,
+  /// and trap the out-of-bounds accesses in the guard region of the linear
+  /// memories with the fault handler as the AOT code. Ignored on the platforms
+  /// without the guard region.
+  void setEnableGuardRegion(bool IsEnableGuardRegion) noexcept {
+    EnableGuardRegion.store(IsEnableGuardRegion, std::memory_order_relaxed);
+  }
+
+  bool isEnableGuardRegion() const noexcept {
+    return EnableGuardRegion.load(std::memory_order_relaxed);
+  }
+
+  /// Set the default memory budget in bytes of the instantiated module
+  /// instances, which accounts their memories, tables, and GC objects. The
+  /// memory and table growing fail when exceeding the soft limit, and the
+  /// instantiation and GC allocations fail when exceeding the hard limit. 0
+  /// for no limit.
+  void setMemoryBudget(uint64_t Soft, uint64_t Hard) noexcept {
+    MemoryBudgetSoft.store(Soft, std::memory_order_relaxed);
+    MemoryBudgetHard.store(Hard, std::memory_order_relaxed);
+  }
+
+  uint64_t getMemoryBudgetSoftLimit() const noexcept {
+    return MemoryBudgetSoft.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getMemoryBudgetHardLimit() const noexcept {
+    return MemoryBudgetHard.load(std::memory_order_relaxed);
+  }
+
+  /// Collect the unreachable GC objects of a module instance in the
+  /// interpreter once the bytes allocated since the last collection exceed
+  /// the threshold. The roots are the interpreter stacks on the thread, and
+  /// the globals, tables, and element segments of the module instance, so the
+  /// references held only by the host or by the other module instances are
+  /// not kept alive. The collection is skipped while any compiled function is
+  /// on the stacks. 0 for never collecting.
+  void setGCThreshold(uint64_t Bytes) noexcept {
+    GCThreshold.store(Bytes, std::memory_order_relaxed);
+  }
+
+  uint64_t getGCThreshold() const noexcept {
+    return GCThreshold.load(std::memory_order_relaxed);
+  }
+
+  /// Wait for the WASI `poll_oneoff` events with io_uring instead of epoll on
+  /// Linux, and fall back to epoll if io_uring is unavailable.
+  void setEnableIoUring(bool IsEnableIoUring) noexcept {
+    EnableIoUring.store(IsEnableIoUring, std::memory_order_relaxed);
+  }
+
+  bool isEnableIoUring() const noexcept {
+    return EnableIoUring.load(std::memory_order_relaxed);
+  }
+
+  /// Keep the directories resolved under the WASI pre-opened directories open,
+  /// and drop them once changed. Only available on Linux.
+  void setEnableWasiPathCache(bool IsEnableWasiPathCache) noexcept {
+    EnableWasiPathCache.store(IsEnableWasiPathCache,
+                              std::memory_order_relaxed);
+  }
+
+  bool isEnableWasiPathCache() const noexcept {
+    return EnableWasiPathCache.load(std::memory_order_relaxed);
+  }
+
+  /// Restore the validated function bodies of the interpreter from the code
+  /// cache keyed by the module bytes, instead of decoding and validating them
+  /// again. The bodies are saved into the cache after the validation on a
+  /// miss. The cache directory is trusted like the AOT cache.
+  void setEnableCodeCache(bool IsEnableCodeCache) noexcept {
+    EnableCodeCache.store(IsEnableCodeCache, std::memory_order_relaxed);
+  }
+
+  bool isEnableCodeCache() const noexcept {
+    return EnableCodeCache.load(std::memory_order_relaxed);
+  }
+
+  /// Validate each function body of the interpreter right after it is
+  /// decoded in the loader, instead of traversing all the bodies again in the
+  /// validator. The invalid modules fail in loading. The bodies are decoded
+  /// sequentially, so this takes precedence over the parallel loading, but
+  /// not over the lazy loading.
+  void setEnableFusedValidation(bool IsEnableFusedValidation) noexcept {
+    EnableFusedValidation.store(IsEnableFusedValidation,
+                                std::memory_order_relaxed);
+  }
+
+  bool isEnableFusedValidation() const noexcept {
+    return EnableFusedValidation.load(std::memory_order_relaxed);
+  }
+
+  /// Place the instances on the NUMA node: the linear memories prefer the
+  /// pages of the node, and the threads executing the functions are pinned on
+  /// its CPUs. Negative for no placement. Only supported on Linux.
+  void setNumaNode(int32_t Node) noexcept {
+    NumaNode.store(Node, std::memory_order_relaxed);
+  }
+
+  int32_t getNumaNode() const noexcept {
+    return NumaNode.load(std::memory_order_relaxed);
+  }
+
+  /// Charge the CPU time of the executing threads to the CPU budgets of the
+  /// entered module instances. The time is sampled at the host function calls
+  /// and at the epoch ticks, so the budgets are checked there.
+  void setEnableCpuAccounting(bool IsEnableCpuAccounting) noexcept {
+    EnableCpuAccounting.store(IsEnableCpuAccounting,
+                              std::memory_order_relaxed);
+  }
+
+  bool isEnableCpuAccounting() const noexcept {
+    return EnableCpuAccounting.load(std::memory_order_relaxed);
+  }
+
+  /// Run the compiled code on a dedicated stack of this size per executing
+  /// thread, with a guard page below it for trapping the overflows. 0 for
+  /// running on the stack of the calling thread.
+  void setNativeStackSize(const uint64_t Size) noexcept {
+    NativeStackSize.store(Size, std::memory_order_relaxed);
+  }
+
+  uint64_t getNativeStackSize() const noexcept {
+    return NativeStackSize.load(std::memory_order_relaxed);
+  }
+
 private:
   std::atomic<uint32_t> MaxMemPage = 65536;
   std::atomic<bool> EnableJIT = false;
+  std::atomic<bool> EnableLazyJIT = false;
+  std::atomic<bool> EnableJITSpeculation = false;
+  std::atomic<bool> EnableJITCache = false;
   std::atomic<bool> EnableCoredump = false;
   std::atomic<bool> CoredumpWasmgdb = false;
+  std::atomic<bool> CoredumpAsync = false;
+  std::atomic<uint32_t> CoredumpInterval = 0;
   std::atomic<bool> ForceInterpreter = false;
   std::atomic<bool> AllowAFUNIX = false;
+  std::atomic<bool> EnableSuperInstructions = false;
+  std::atomic<uint32_t> ValueStackSize = 0;
+  std::atomic<bool> EnableTieredJIT = false;
+  std::atomic<uint32_t> TierUpThreshold = 1000;
+  std::atomic<bool> EnableZeroCopyLoad = false;
+  std::atomic<bool> EnableLazyFunctionBody = false;
+  std::atomic<bool> EnableTrustedAOT = false;
+  std::atomic<uint32_t> ValidationThreadCount = 1;
+  std::atomic<uint32_t> LoadingThreadCount = 1;
+  std::atomic<uint32_t> MemoryPoolSize = 0;
+  std::atomic<uint32_t> StripedMemoryPages = 0;
+  std::atomic<bool> EnableMemoryImage = false;
+  std::atomic<bool> EnableHugePages = false;
+  std::atomic<bool> EnableBackgroundReclamation = false;
+  std::atomic<bool> EnableHugePageCode = false;
+  std::atomic<bool> EnableLazyTable = false;
+  std::atomic<bool> EnableGuardRegion = false;
+  std::atomic<uint64_t> MemoryBudgetSoft = 0;
+  std::atomic<uint64_t> MemoryBudgetHard = 0;
+  std::atomic<uint64_t> GCThreshold = 0;
+  std::atomic<bool> EnableIoUring = false;
+  std::atomic<bool> EnableWasiPathCache = false;
+  std::atomic<bool> EnableCodeCache = false;
+  std::atomic<bool> EnableFusedValidation = false;
+  std::atomic<int32_t> NumaNode = -1;
+  std::atomic<bool> EnableCpuAccounting = false;
+  std::atomic<uint64_t> NativeStackSize = 0;
 };
 
 class StatisticsConfigure {
@@ -184,7 +672,12 @@ public:
   StatisticsConfigure(const StatisticsConfigure &RHS) noexcept
       : InstrCounting(RHS.InstrCounting.load(std::memory_order_relaxed)),
         CostMeasuring(RHS.CostMeasuring.load(std::memory_order_relaxed)),
-        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)) {}
+        TimeMeasuring(RHS.TimeMeasuring.load(std::memory_order_relaxed)),
+        IOMeasuring(RHS.IOMeasuring.load(std::memory_order_relaxed)),
+        ProfileGenerating(
+            RHS.ProfileGenerating.load(std::memory_order_relaxed)),
+        FunctionProfiling(
+            RHS.FunctionProfiling.load(std::memory_order_relaxed)) {}
 
   void setInstructionCounting(bool IsCount) noexcept {
     InstrCounting.store(IsCount, std::memory_order_relaxed);
@@ -210,6 +703,35 @@ public:
     return TimeMeasuring.load(std::memory_order_relaxed);
   }
 
+  /// Measure the bytes, calls, and latencies of the WASI I/O.
+  void setIOMeasuring(bool IsIOMeasure) noexcept {
+    IOMeasuring.store(IsIOMeasure, std::memory_order_relaxed);
+  }
+
+  bool isIOMeasuring() const noexcept {
+    return IOMeasuring.load(std::memory_order_relaxed);
+  }
+
+  /// Record the execution profile of the interpreter for the profile-guided
+  /// AOT compilation.
+  void setProfileGenerating(bool IsGenerate) noexcept {
+    ProfileGenerating.store(IsGenerate, std::memory_order_relaxed);
+  }
+
+  bool isProfileGenerating() const noexcept {
+    return ProfileGenerating.load(std::memory_order_relaxed);
+  }
+
+  /// Count the calls, the instructions, and the self time of every function
+  /// in the interpreter.
+  void setFunctionProfiling(bool IsProfile) noexcept {
+    FunctionProfiling.store(IsProfile, std::memory_order_relaxed);
+  }
+
+  bool isFunctionProfiling() const noexcept {
+    return FunctionProfiling.load(std::memory_order_relaxed);
+  }
+
   void setCostLimit(uint64_t Cost) noexcept {
     CostLimit.store(Cost, std::memory_order_relaxed);
   }
@@ -222,6 +744,9 @@ private:
   std::atomic<bool> InstrCounting = false;
   std::atomic<bool> CostMeasuring = false;
   std::atomic<bool> TimeMeasuring = false;
+  std::atomic<bool> IOMeasuring = false;
+  std::atomic<bool> ProfileGenerating = false;
+  std::atomic<bool> FunctionProfiling = false;
 
   std::atomic<uint64_t> CostLimit = std::numeric_limits<uint64_t>::max();
 };
@@ -440,6 +965,11 @@ public:
       if (unlikely(!hasProposal(Proposal::ExceptionHandling))) {
         return Proposal::ExceptionHandling;
       }
+    } else if (Code >= OpCode::Cont__new && Code <= OpCode::Switch) {
+      // These instructions are for StackSwitching proposal.
+      if (unlikely(!hasProposal(Proposal::StackSwitching))) {
+        return Proposal::StackSwitching;
+      }
     }
     return {};
   }
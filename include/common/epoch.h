@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/epoch.h - Epoch counter definition ----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the process-wide epoch counter for the wall-clock
+/// deadlines of the executions.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Epoch {
+
+/// The epoch counter shared by all executors. The executions compare it with
+/// their deadlines at the loop headers and the function calls, so one timer
+/// bumping the counter serves the timeouts of any number of instances.
+std::atomic_uint64_t &getCounter() noexcept;
+
+/// Getter of the current epoch.
+inline uint64_t get() noexcept {
+  return getCounter().load(std::memory_order_relaxed);
+}
+
+/// Advance the epoch by one tick.
+inline void increment() noexcept {
+  getCounter().fetch_add(1, std::memory_order_relaxed);
+}
+
+/// Start the timer thread advancing the epoch every interval, or restart it
+/// with the new interval if it is already running.
+void startTimer(std::chrono::nanoseconds Interval) noexcept;
+
+/// Stop the timer thread. The epoch keeps its value.
+void stopTimer() noexcept;
+
+} // namespace Epoch
+} // namespace WasmEdge
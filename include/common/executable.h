@@ -82,6 +82,15 @@ public:
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
 
+  /// Maximum count of the values of the exceptions propagated between the
+  /// compiled functions.
+  static inline constexpr uint32_t kMaxExceptionValues = 16;
+
+  /// Byte offset of the compiled entry in the function instances, after the
+  /// module instance pointer and the type index of the composite base, for
+  /// the compiled code to call the function references directly.
+  static inline constexpr size_t kFuncEntryOffset = 2 * sizeof(void *);
+
   virtual Symbol<const IntrinsicsTable *> getIntrinsics() noexcept = 0;
 
   virtual std::vector<Symbol<Wrapper>> getTypes(size_t Size) noexcept = 0;
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/metrics.h - Runtime metrics definition ------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the process-wide registry of the runtime metrics, which
+/// aggregates the executions per module and renders them in the OpenMetrics
+/// text format for the Prometheus scrapers.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace WasmEdge {
+namespace Metrics {
+
+/// Finished execution of an exported function.
+struct Invocation {
+  /// Name of the module instance of the function.
+  std::string_view Module;
+  /// Wall time of the execution, including the host functions.
+  std::chrono::nanoseconds Duration;
+  /// Time spent in the host functions.
+  std::chrono::nanoseconds HostTime;
+  /// Instructions and gas charged to the statistics during the execution.
+  uint64_t InstrCount;
+  uint64_t Cost;
+  /// Pages of the memories of the module instance after the execution.
+  uint64_t MemoryPages;
+  /// Error of the execution, or success.
+  ErrCode Result;
+};
+
+/// Start recording the metrics. Nothing is recorded before enabling.
+void enable() noexcept;
+
+/// Check the metrics are recorded.
+bool isEnabled() noexcept;
+
+/// Record a finished execution.
+void recordInvocation(const Invocation &Inv) noexcept;
+
+/// Record a call of a host function of the module, such as a plugin module.
+void recordHostCall(std::string_view Module,
+                    std::chrono::nanoseconds Duration) noexcept;
+
+/// Getter of the time spent in the host functions called on this thread, for
+/// computing the host time of an execution.
+std::chrono::nanoseconds getThreadHostTime() noexcept;
+
+/// Record the lookups of a cache. The name should be a string literal.
+void recordCacheLookup(std::string_view Cache, uint64_t Hits,
+                       uint64_t Misses) noexcept;
+
+/// Render the metrics in the OpenMetrics text format.
+std::string render();
+
+/// Drop the recorded metrics.
+void clear() noexcept;
+
+} // namespace Metrics
+} // namespace WasmEdge
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/profile.h - Execution profile definition ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the execution profile recorded by an instrumented run,
+/// which guides the AOT compiler.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace WasmEdge {
+namespace Statistics {
+
+/// Execution profile of a module: the function call counts, the branch
+/// weights, and the indirect call targets. Everything is keyed by the offset
+/// in the wasm binary, so a profile only applies to the same binary. A
+/// function is keyed by the offset of the first instruction of its body.
+class Profile {
+public:
+  struct Branch {
+    uint64_t Taken = 0;
+    uint64_t NotTaken = 0;
+  };
+
+  Profile() noexcept = default;
+  Profile(const Profile &) = delete;
+  Profile &operator=(const Profile &) = delete;
+
+  /// Record a call of the function.
+  void recordCall(uint32_t FuncOffset) noexcept;
+
+  /// Record the direction of the `if` or `br_if` instruction.
+  void recordBranch(uint32_t Offset, bool IsTaken) noexcept;
+
+  /// Record the target function of the `call_indirect` instruction.
+  void recordIndirectCall(uint32_t Offset, uint32_t FuncOffset) noexcept;
+
+  /// Getter of the call count of the function.
+  uint64_t getCallCount(uint32_t FuncOffset) const noexcept;
+
+  /// Getter of the branch weights, or nullptr if not recorded.
+  const Branch *getBranch(uint32_t Offset) const noexcept;
+
+  /// Getter of the call counts of the targets sorted by the function offsets,
+  /// or nullptr if not recorded.
+  const std::map<uint32_t, uint64_t> *
+  getIndirectCall(uint32_t Offset) const noexcept;
+
+  bool empty() const noexcept;
+  void clear() noexcept;
+
+  /// Write the profile to a text file.
+  Expect<void> save(const std::filesystem::path &Path) const noexcept;
+
+  /// Merge the profile in a text file written by `save`.
+  Expect<void> load(const std::filesystem::path &Path) noexcept;
+
+private:
+  mutable std::mutex Mutex;
+  std::unordered_map<uint32_t, uint64_t> Calls;
+  std::unordered_map<uint32_t, Branch> Branches;
+  std::unordered_map<uint32_t, std::map<uint32_t, uint64_t>> IndirectCalls;
+};
+
+} // namespace Statistics
+} // namespace WasmEdge
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/reclaimer.h - Background reclamation --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the background reclamation, which
+/// destroys the released module instances and AST modules off the releasing
+/// threads.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/threadpool.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace WasmEdge {
+
+/// Process-wide queue of the objects to destroy in the background. Destroying
+/// a module instance or an AST module frees every memory, table, AST node and
+/// compiled code chunk of it, so when enabled, the released objects are
+/// destroyed in batches on a background thread instead, and the releasing
+/// thread returns at once. The memories released there are kept in the memory
+/// pool of the allocator for reuse if it is enabled.
+///
+/// The queued objects must not depend on the objects destroyed by the caller
+/// after releasing them, and their destructors, such as the finalizers of the
+/// host data, run on the background thread.
+class Reclaimer {
+public:
+  /// Setter and getter of the background reclamation. Disabling it waits
+  /// until the queued objects are destroyed.
+  static void setEnabled(bool IsEnable) noexcept;
+  static bool isEnabled() noexcept;
+
+  /// Destroy the object in the background if enabled, or at once otherwise.
+  template <typename T> static void release(std::unique_ptr<T> Ptr) noexcept {
+    if (Ptr && isEnabled()) {
+      enqueue(ThreadPool::Task([P = std::move(Ptr)]() mutable { P.reset(); }));
+    }
+  }
+
+  /// Wait until the objects queued before are destroyed.
+  static void drain() noexcept;
+
+  /// Getter of the count of the queued objects not destroyed yet.
+  static uint64_t getPendingCount() noexcept;
+
+private:
+  struct State;
+  static State &getState() noexcept;
+  static void enqueue(ThreadPool::Task T) noexcept;
+};
+
+} // namespace WasmEdge
@@ -16,11 +16,17 @@
 #include "common/configure.h"
 #include "common/enum_ast.hpp"
 #include "common/errcode.h"
+#include "common/profile.h"
 #include "common/span.h"
 #include "common/spdlog.h"
 #include "common/timer.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace WasmEdge {
@@ -28,12 +34,18 @@ namespace Statistics {
 
 class Statistics {
 public:
+  /// Counters of a function merged from the executions.
+  struct FunctionRecord {
+    std::string Name;
+    uint64_t Calls = 0;
+    uint64_t InstrCount = 0;
+    Timer::Timer::Clock::duration SelfTime{};
+  };
+
   Statistics(const uint64_t Lim = UINT64_MAX)
-      : CostTab(UINT16_MAX + 1, 1ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {
-  }
+      : CostTab(UINT16_MAX + 1, 1ULL), CostLimit(Lim), CostSum(0) {}
   Statistics(Span<const uint64_t> Tab, const uint64_t Lim = UINT64_MAX)
-      : CostTab(Tab.begin(), Tab.end()), InstrCnt(0), CostLimit(Lim),
-        CostSum(0) {
+      : CostTab(Tab.begin(), Tab.end()), CostLimit(Lim), CostSum(0) {
     if (CostTab.size() < UINT16_MAX + 1) {
       CostTab.resize(UINT16_MAX + 1, 0ULL);
     }
@@ -41,17 +53,26 @@ public:
   ~Statistics() = default;
 
   /// Increment of instruction counter.
-  void incInstrCount() { InstrCnt.fetch_add(1, std::memory_order_relaxed); }
+  void incInstrCount() {
+    getInstrCountRef().fetch_add(1, std::memory_order_relaxed);
+  }
 
-  /// Getter of instruction counter.
+  /// Getter of instruction counter, summed from the counters of the threads.
   uint64_t getInstrCount() const {
-    return InstrCnt.load(std::memory_order_relaxed);
+    uint64_t Count = 0;
+    for (const auto &S : Shards) {
+      Count += S.InstrCnt.load(std::memory_order_relaxed);
+    }
+    return Count;
+  }
+  /// Getter of the instruction counter of the calling thread.
+  std::atomic_uint64_t &getInstrCountRef() {
+    return Shards[getShardIndex()].InstrCnt;
   }
-  std::atomic_uint64_t &getInstrCountRef() { return InstrCnt; }
 
   /// Getter of instruction per second.
   double getInstrPerSecond() const {
-    return static_cast<double>(InstrCnt) /
+    return static_cast<double>(getInstrCount()) /
            std::chrono::duration<double>(getWasmExecTime()).count();
   }
 
@@ -98,6 +119,34 @@ public:
     return true;
   }
 
+  /// Add cost and take a lease of the cost under the limit for the later
+  /// charges of the thread, which should be returned by `returnCost()` if not
+  /// used. The leases are shrunk near the limit, so that the threads with
+  /// their leases left do not exhaust the limit of the others. Returns false
+  /// if exceeded limit.
+  bool leaseCost(uint64_t Cost, uint64_t &Lease) {
+    using namespace std::literals;
+    const auto Limit = CostLimit;
+    uint64_t OldCostSum = CostSum.load(std::memory_order_relaxed);
+    uint64_t NewCostSum;
+    do {
+      const uint64_t Room = Limit > OldCostSum ? Limit - OldCostSum : 0;
+      if (unlikely(Cost > Room)) {
+        spdlog::error("Cost exceeded limit. Force terminate the execution."sv);
+        return false;
+      }
+      Lease = std::min(kCostLeaseSize, (Room - Cost) / kShardNum);
+      NewCostSum = OldCostSum + Cost + Lease;
+    } while (!CostSum.compare_exchange_weak(OldCostSum, NewCostSum,
+                                            std::memory_order_relaxed));
+    return true;
+  }
+
+  /// Return the unused lease taken by `leaseCost()`.
+  void returnCost(uint64_t Lease) {
+    CostSum.fetch_sub(Lease, std::memory_order_relaxed);
+  }
+
   /// Return cost back.
   bool subCost(uint64_t Cost) {
     uint64_t OldCostSum = CostSum.load(std::memory_order_relaxed);
@@ -115,10 +164,52 @@ public:
   /// Clear measurement data for instructions.
   void clear() noexcept {
     TimeRecorder.reset();
-    InstrCnt.store(0, std::memory_order_relaxed);
+    for (auto &S : Shards) {
+      S.InstrCnt.store(0, std::memory_order_relaxed);
+    }
     CostSum.store(0, std::memory_order_relaxed);
+    Prof.clear();
+    std::unique_lock Lock(FuncMutex);
+    FuncRecords.clear();
+  }
+
+  /// Merge the counters of the function from an execution. The name is only
+  /// got at the first merging of the function.
+  template <typename NameT>
+  void addFunctionRecord(const void *Func, uint64_t Calls, uint64_t InstrCount,
+                         Timer::Timer::Clock::duration SelfTime,
+                         NameT &&GetName) {
+    std::unique_lock Lock(FuncMutex);
+    auto [It, Inserted] = FuncRecords.try_emplace(Func);
+    if (Inserted) {
+      It->second.Name = std::forward<NameT>(GetName)();
+    }
+    It->second.Calls += Calls;
+    It->second.InstrCount += InstrCount;
+    It->second.SelfTime += SelfTime;
+  }
+
+  /// Getter of the function records, sorted by the instruction counts.
+  std::vector<FunctionRecord> getFunctionRecords() const {
+    std::vector<FunctionRecord> Records;
+    {
+      std::unique_lock Lock(FuncMutex);
+      Records.reserve(FuncRecords.size());
+      for (const auto &Record : FuncRecords) {
+        Records.push_back(Record.second);
+      }
+    }
+    std::sort(Records.begin(), Records.end(),
+              [](const FunctionRecord &LHS, const FunctionRecord &RHS) {
+                return LHS.InstrCount > RHS.InstrCount;
+              });
+    return Records;
   }
 
+  /// Getter of the execution profile.
+  const Profile &getProfile() const noexcept { return Prof; }
+  Profile &getProfile() noexcept { return Prof; }
+
   /// Start recording wasm time.
   void startRecordWasm() noexcept {
     TimeRecorder.startRecord(Timer::TimerTag::Wasm);
@@ -157,8 +248,10 @@ public:
       return std::chrono::nanoseconds(Duration).count();
     };
     const auto &StatConf = Conf.getStatisticsConfigure();
-    if (StatConf.isTimeMeasuring() || StatConf.isInstructionCounting() ||
-        StatConf.isCostMeasuring()) {
+    const bool IsDump =
+        StatConf.isTimeMeasuring() || StatConf.isInstructionCounting() ||
+        StatConf.isCostMeasuring() || StatConf.isFunctionProfiling();
+    if (IsDump) {
       spdlog::info("====================  Statistics  ===================="sv);
     }
     if (StatConf.isTimeMeasuring()) {
@@ -181,18 +274,65 @@ public:
                        ? static_cast<uint64_t>(IPS)
                        : std::numeric_limits<uint64_t>::max());
     }
-    if (StatConf.isTimeMeasuring() || StatConf.isInstructionCounting() ||
-        StatConf.isCostMeasuring()) {
+    if (StatConf.isFunctionProfiling()) {
+      auto Records = getFunctionRecords();
+      const size_t Num = std::min(Records.size(), kDumpFunctionNum);
+      const auto Dump = [&](size_t I) {
+        spdlog::info("   {}: {} instructions, {} calls, {} ns self time"sv,
+                     Records[I].Name, Records[I].InstrCount, Records[I].Calls,
+                     Nano(Records[I].SelfTime));
+      };
+      spdlog::info(" Top functions by instructions:"sv);
+      for (size_t I = 0; I < Num; ++I) {
+        Dump(I);
+      }
+      std::partial_sort(
+          Records.begin(), Records.begin() + static_cast<ptrdiff_t>(Num),
+          Records.end(),
+          [](const FunctionRecord &LHS, const FunctionRecord &RHS) {
+            return LHS.SelfTime > RHS.SelfTime;
+          });
+      spdlog::info(" Top functions by self time:"sv);
+      for (size_t I = 0; I < Num; ++I) {
+        Dump(I);
+      }
+    }
+    if (IsDump) {
       spdlog::info("=======================   End   ======================"sv);
     }
   }
 
 private:
+  /// Count of the functions in each list of the dumped top functions.
+  static inline constexpr const size_t kDumpFunctionNum = 10;
+  /// Count of the instruction counter shards.
+  static inline constexpr const size_t kShardNum = 32;
+  /// Maximum cost of the leases.
+  static inline constexpr const uint64_t kCostLeaseSize = UINT64_C(1) << 16;
+
+  /// Instruction counter of the threads, padded to its own cache line so that
+  /// the guest threads do not contend on the counting.
+  struct alignas(64) Shard {
+    std::atomic_uint64_t InstrCnt = 0;
+  };
+
+  /// Index of the shard of the calling thread. The threads are assigned to
+  /// the shards in turn.
+  static size_t getShardIndex() noexcept {
+    static std::atomic_size_t Next = 0;
+    thread_local const size_t Index =
+        Next.fetch_add(1, std::memory_order_relaxed) % kShardNum;
+    return Index;
+  }
+
   std::vector<uint64_t> CostTab;
-  std::atomic_uint64_t InstrCnt;
+  std::array<Shard, kShardNum> Shards;
   uint64_t CostLimit;
   std::atomic_uint64_t CostSum;
   Timer::Timer TimeRecorder;
+  Profile Prof;
+  mutable std::mutex FuncMutex;
+  std::unordered_map<const void *, FunctionRecord> FuncRecords;
 };
 
 } // namespace Statistics
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/threadpool.h - Thread pool class definition -------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of the work-stealing thread pool running
+/// the asynchronous executions.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+
+/// Work-stealing thread pool. Every worker has its own task queue, which also
+/// receives the tasks submitted from the worker. The other tasks are queued
+/// globally, and the idle workers take the global tasks first and steal from
+/// the other workers then.
+///
+/// The workers are started when there is no idle worker, until the maximum
+/// count is reached, and leave after idling for a while. The executions may
+/// block the workers for long, so when the maximum count is reached, the new
+/// tasks wait until a worker becomes free.
+class ThreadPool {
+public:
+  /// Move-only task.
+  class Task {
+  public:
+    Task() noexcept = default;
+    template <typename FuncT,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<FuncT>, Task>>>
+    Task(FuncT &&Func)
+        : Impl(std::make_unique<Model<std::decay_t<FuncT>>>(
+              std::forward<FuncT>(Func))) {}
+    explicit operator bool() const noexcept { return Impl != nullptr; }
+    void operator()() { Impl->run(); }
+
+  private:
+    struct Concept {
+      virtual ~Concept() noexcept = default;
+      virtual void run() = 0;
+    };
+    template <typename FuncT> struct Model final : Concept {
+      Model(FuncT &&F) : Func(std::move(F)) {}
+      Model(const FuncT &F) : Func(F) {}
+      void run() override { Func(); }
+      FuncT Func;
+    };
+    std::unique_ptr<Concept> Impl;
+  };
+
+  ThreadPool() noexcept;
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// The process-wide pool running the `Async` executions. It is never
+  /// destroyed, so the running executions are not joined at exit.
+  static ThreadPool &getDefault() noexcept;
+
+  /// Submit the task to run on a worker.
+  void submit(Task T) noexcept;
+
+  /// Setter and getter of the maximum count of the workers. 0 for unbounded.
+  void setMaxThreads(uint32_t Max) noexcept;
+  uint32_t getMaxThreads() const noexcept;
+
+  /// Pin the workers on the CPUs in turn, or clear the pinning if empty.
+  /// Only supported on Linux, and ignored on the other platforms.
+  void setAffinity(std::vector<uint32_t> CPUs) noexcept;
+
+  /// Getter of the count of the running workers.
+  uint32_t getThreadCount() const noexcept;
+
+private:
+  struct Worker;
+  struct State;
+
+  std::shared_ptr<State> Shared;
+};
+
+} // namespace WasmEdge
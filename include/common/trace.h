@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/common/trace.h - Startup trace definition ----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the recorder of the startup phases, such as loading the
+/// plugins, loading, validating, and instantiating the module, for
+/// attributing the cold-start time.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge {
+namespace Trace {
+
+/// Recorded phase. The start time is relative to the enabling of the trace.
+struct Event {
+  std::string_view Category;
+  std::string Name;
+  std::chrono::nanoseconds Start;
+  std::chrono::nanoseconds Duration;
+  uint64_t ThreadId;
+};
+
+/// Start recording the phases. Nothing is recorded before enabling, and the
+/// time origin is set by the first call.
+void enable() noexcept;
+
+/// Check the phases are recorded.
+bool isEnabled() noexcept;
+
+/// Record a finished phase. The category should be a string literal.
+void record(std::string_view Category, std::string Name,
+            std::chrono::steady_clock::time_point Start,
+            std::chrono::steady_clock::time_point End) noexcept;
+
+/// Getter of the recorded phases sorted by the start time.
+std::vector<Event> getEvents() noexcept;
+
+/// Log the recorded phases and their durations, indented by nesting.
+void dumpToLog() noexcept;
+
+/// Write the recorded phases in the Chrome trace event format, which is also
+/// read by Perfetto.
+Expect<void> saveChromeTrace(const std::filesystem::path &Path) noexcept;
+
+/// Record the enclosing scope as a phase if the trace is enabled. The name is
+/// only built when enabled, so the scope costs a flag check otherwise.
+class Scope {
+public:
+  Scope(std::string_view Category, std::string_view Name,
+        std::string_view Detail = {}) noexcept {
+    if (isEnabled()) {
+      Active = true;
+      Cat = Category;
+      Label = Name;
+      if (!Detail.empty()) {
+        Label.append(" ");
+        Label.append(Detail);
+      }
+      Start = std::chrono::steady_clock::now();
+    }
+  }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+  ~Scope() noexcept {
+    if (Active) {
+      record(Cat, std::move(Label), Start, std::chrono::steady_clock::now());
+    }
+  }
+
+private:
+  bool Active = false;
+  std::string_view Cat;
+  std::string Label;
+  std::chrono::steady_clock::time_point Start;
+};
+
+} // namespace Trace
+} // namespace WasmEdge
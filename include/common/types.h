@@ -22,9 +22,12 @@
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 namespace WasmEdge {
 
@@ -111,6 +114,7 @@ public:
       Inner.Data.Code = C;
       Inner.Data.HTCode = TypeCode::Epsilon;
       break;
+    case TypeCode::NullContRef:
     case TypeCode::NullExnRef:
     case TypeCode::NullFuncRef:
     case TypeCode::NullExternRef:
@@ -123,6 +127,7 @@ public:
     case TypeCode::StructRef:
     case TypeCode::ArrayRef:
     case TypeCode::ExnRef:
+    case TypeCode::ContRef:
       // Abstract heap type
       Inner.Data.Code = TypeCode::RefNull;
       Inner.Data.HTCode = C;
@@ -225,6 +230,7 @@ public:
   bool isAbsHeapType() const noexcept {
     if (isRefType()) {
       switch (Inner.Data.HTCode) {
+      case TypeCode::NullContRef:
       case TypeCode::NullExnRef:
       case TypeCode::NullFuncRef:
       case TypeCode::NullExternRef:
@@ -237,6 +243,7 @@ public:
       case TypeCode::StructRef:
       case TypeCode::ArrayRef:
       case TypeCode::ExnRef:
+      case TypeCode::ContRef:
         return true;
       default:
         return false;
@@ -385,6 +392,19 @@ struct RefVariant {
     setData(TypeCode::ArrayRef, reinterpret_cast<const void *>(P));
   }
 
+  /// Create the i31 reference. The value is unboxed in the pointer with the
+  /// lowest bit tagged, which is never an address of the aligned objects and
+  /// never null.
+  static RefVariant fromI31(uint32_t Val) noexcept {
+    RefVariant Ref(ValType(TypeCode::Ref, TypeCode::I31Ref));
+    Ref.toArray()[1] = (static_cast<uint64_t>(Val & 0x7FFFFFFFU) << 1) | 1U;
+    return Ref;
+  }
+  /// Check if the pointer is a tagged i31 value.
+  static bool isI31Tagged(const void *Ptr) noexcept {
+    return reinterpret_cast<uintptr_t>(Ptr) & 1U;
+  }
+
   // Getter of type.
   const ValType &getType() const noexcept {
     return reinterpret_cast<const ValType &>(toArray()[0]);
@@ -401,6 +421,14 @@ struct RefVariant {
   // Check is null.
   bool isNull() const { return getPtr<void>() == nullptr; }
 
+  // Getter of the signed and unsigned values of the non-null i31 reference.
+  uint32_t getI31S() const noexcept {
+    return static_cast<uint32_t>(static_cast<int32_t>(toArray()[1]) >> 1);
+  }
+  uint32_t getI31U() const noexcept {
+    return static_cast<uint32_t>(toArray()[1]) >> 1;
+  }
+
   // Getter of the raw data.
   uint64x2_t getRawData() const noexcept { return Data; }
 
@@ -512,6 +540,8 @@ private:
 
 // >>>>>>>> Component Model Value definitions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
+struct ComponentValComposite;
+
 using ComponentValVariant = std::variant<
     // constant types in component types
     uint8_t, uint16_t, uint32_t, uint64_t, int8_t, int16_t, int32_t, int64_t,
@@ -519,10 +549,19 @@ using ComponentValVariant = std::variant<
     // composition type like List, Record, Variant
     //
     // we need to copy them at many place, so we just use shared_ptr
-    // std::shared_ptr<ValComp>,
+    std::shared_ptr<ComponentValComposite>,
     // wasm values
     ValVariant>;
 
+/// Value of the composite component types. The fields of the records and the
+/// tuples, and the elements of the lists are in `Values`. The variants, enums,
+/// options, and results have the case index in `Discriminant` and the payload
+/// of the case, if any, in `Values`. The flags have the bits in `Discriminant`.
+struct ComponentValComposite {
+  uint32_t Discriminant = 0;
+  std::vector<ComponentValVariant> Values;
+};
+
 // <<<<<<<< Component Model Value definitions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> Const expressions to checking value types >>>>>>>>>>>>>>>>>>>>>>>>>>
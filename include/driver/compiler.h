@@ -28,6 +28,66 @@ struct DriverCompilerOptions {
         ConfDumpIR(
             PO::Description("Dump LLVM IR to `wasm.ll` and `wasm-opt.ll`."sv)),
         ConfInterruptible(PO::Description("Generate a interruptible binary"sv)),
+        ConfPartitionCount(
+            PO::Description("Split the functions into `COUNT` partitions and "
+                            "compile them in parallel."sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(1)),
+        ConfBatch(PO::Description(
+            "Compile the modules listed in the manifest `WASM`, one `INPUT "
+            "OUTPUT` pair per line, in one process. The relative outputs are "
+            "placed under the directory `WASM_SO`."sv)),
+        ConfJobs(
+            PO::Description("Compile at most `COUNT` modules of a batch in "
+                            "parallel. 0 for one per hardware thread."sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        ConfModuleCache(PO::Description(
+            "Keep the output of every compiled module in the local cache and "
+            "copy it for the unchanged modules."sv)),
+        ConfFunctionCache(PO::Description(
+            "Keep the object of every compiled function in the local cache "
+            "and reuse the unchanged ones."sv)),
+        ConfCacheMaxSize(
+            PO::Description(
+                "Size limit in MiB of the function cache, over which the least "
+                "recently used functions are evicted. 0 for no limit, default "
+                "value is 2048"sv),
+            PO::MetaVar("MIB"sv), PO::DefaultValue<uint64_t>(2048)),
+        ConfCacheRemote(
+            PO::Description(
+                "Fetch the functions missing in the function cache from the "
+                "HTTP server at `URL`, as `GET URL/TARGET/functions/HASH`."sv),
+            PO::MetaVar("URL"sv)),
+        ConfCacheRemoteUpload(PO::Description(
+            "Also store the compiled functions to the remote cache by the "
+            "`PUT` requests."sv)),
+        ConfCoarseGasCheck(PO::Description(
+            "Check the gas limit only at the loops, the calls, and the "
+            "returns."sv)),
+        ConfTargetLevel(
+            PO::Description(
+                "Generate the code for the x86-64 micro-architecture levels in "
+                "`LEVELS`, a comma-separated list of 1 to 4, instead of the "
+                "host CPU. The universal wasm output embeds the code of every "
+                "level, and the loader runs the highest one supported by the "
+                "CPU."sv),
+            PO::MetaVar("LEVELS"sv)),
+        ConfInlineBudget(
+            PO::Description(
+                "Always inline the functions with at most `COUNT` "
+                "instructions, and the host function trampolines, into their "
+                "callers. 0 leaves the inlining to the optimization level."sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        ConfProfileUse(
+            PO::Description(
+                "Guide the optimizations by the execution profile in `PATH` "
+                "written by `wasmedge --profile-generate`"sv),
+            PO::MetaVar("PATH"sv)),
+        ConfCompileReport(
+            PO::Description(
+                "Write the compile time and the code size of every function, "
+                "and the time of every optimization pass, as JSON to "
+                "`PATH`"sv),
+            PO::MetaVar("PATH"sv)),
         ConfEnableInstructionCounting(PO::Description(
             "Enable generating code for counting Wasm instructions executed."sv)),
         ConfEnableGasMeasuring(PO::Description(
@@ -93,6 +153,19 @@ struct DriverCompilerOptions {
   PO::Option<PO::Toggle> ConfGenericBinary;
   PO::Option<PO::Toggle> ConfDumpIR;
   PO::Option<PO::Toggle> ConfInterruptible;
+  PO::Option<uint32_t> ConfPartitionCount;
+  PO::Option<PO::Toggle> ConfBatch;
+  PO::Option<uint32_t> ConfJobs;
+  PO::Option<PO::Toggle> ConfModuleCache;
+  PO::Option<PO::Toggle> ConfFunctionCache;
+  PO::Option<uint64_t> ConfCacheMaxSize;
+  PO::Option<std::string> ConfCacheRemote;
+  PO::Option<PO::Toggle> ConfCacheRemoteUpload;
+  PO::Option<PO::Toggle> ConfCoarseGasCheck;
+  PO::Option<std::string> ConfTargetLevel;
+  PO::Option<uint32_t> ConfInlineBudget;
+  PO::Option<std::string> ConfProfileUse;
+  PO::Option<std::string> ConfCompileReport;
   PO::Option<PO::Toggle> ConfEnableInstructionCounting;
   PO::Option<PO::Toggle> ConfEnableGasMeasuring;
   PO::Option<PO::Toggle> ConfEnableTimeMeasuring;
@@ -132,6 +205,19 @@ struct DriverCompilerOptions {
         .add_option(SoName)
         .add_option("dump"sv, ConfDumpIR)
         .add_option("interruptible"sv, ConfInterruptible)
+        .add_option("partition-count"sv, ConfPartitionCount)
+        .add_option("batch"sv, ConfBatch)
+        .add_option("jobs"sv, ConfJobs)
+        .add_option("module-cache"sv, ConfModuleCache)
+        .add_option("function-cache"sv, ConfFunctionCache)
+        .add_option("cache-max-size"sv, ConfCacheMaxSize)
+        .add_option("cache-remote"sv, ConfCacheRemote)
+        .add_option("cache-remote-upload"sv, ConfCacheRemoteUpload)
+        .add_option("coarse-gas-check"sv, ConfCoarseGasCheck)
+        .add_option("target-level"sv, ConfTargetLevel)
+        .add_option("inline-budget"sv, ConfInlineBudget)
+        .add_option("profile-use"sv, ConfProfileUse)
+        .add_option("compile-report"sv, ConfCompileReport)
         .add_option("enable-instruction-count"sv, ConfEnableInstructionCounting)
         .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
         .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
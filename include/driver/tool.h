@@ -12,6 +12,7 @@
 ///
 //===----------------------------------------------------------------------===//
 #pragma once
+#include "common/trace.h"
 #include "plugin/plugin.h"
 #include "po/argument_parser.h"
 #include <string_view>
@@ -36,7 +37,10 @@ struct DriverToolOptions {
                 "that will correspond to `host_path` for calls like `fopen` in "
                 "the guest. The default permission is `readwrite`, however, "
                 "you can use --dir `guest_path:host_path:readonly` to make the "
-                "mapping directory become a read only mode."sv),
+                "mapping directory become a read only mode. An uncompressed "
+                "tar file can be mapped by --dir "
+                "`guest_path:host_tar_path:archive` as a read only "
+                "directory."sv),
             PO::MetaVar("PREOPEN_DIRS"sv)),
         Env(PO::Description(
                 "Environ variables. Each variable can be specified as --env "
@@ -88,9 +92,10 @@ struct DriverToolOptions {
             "(DEPRECATED) Enable Exception handling proposal. WASM 3.0 "
             "includes this proposal, and this option will be removed in the "
             "future."sv)),
-        // TODO: MEMORY64 - enable the option.
-        // PropMemory64(PO::Description("Disable Memory64 proposal"sv)),
+        PropMemory64(PO::Description("Enable Memory64 proposal"sv)),
         PropThreads(PO::Description("Enable Threads proposal"sv)),
+        PropStackSwitching(PO::Description(
+            "Enable Stack Switching proposal, interpreter only"sv)),
         PropComponent(PO::Description(
             "Enable Component Model proposal, this is experimental"sv)),
         PropAll(PO::Description("Enable all features"sv)),
@@ -100,11 +105,73 @@ struct DriverToolOptions {
             "Enable generating code for counting gas burned during execution."sv)),
         ConfEnableTimeMeasuring(PO::Description(
             "Enable generating code for counting time during execution."sv)),
+        ConfEnableIOStatistics(PO::Description(
+            "Enable measuring the bytes, calls, and latencies of WASI I/O."sv)),
         ConfEnableAllStatistics(PO::Description(
             "Enable generating code for all statistics options include "
-            "instruction counting, gas measuring, and execution time"sv)),
+            "instruction counting, gas measuring, execution time, and WASI "
+            "I/O"sv)),
+        ConfEnableFunctionProfiling(PO::Description(
+            "Count the calls, the instructions, and the self time of every "
+            "function, and list the top functions after the execution"sv)),
         ConfEnableJIT(
             PO::Description("Enable Just-In-Time compiler for running WASM"sv)),
+        ConfEnableLazyJIT(PO::Description(
+            "Compile every function at its first call in the JIT mode, "
+            "instead of the whole module before running"sv)),
+        ConfEnableJITSpeculation(PO::Description(
+            "Compile the callees of the called functions on a background "
+            "thread in the lazy JIT mode"sv)),
+        ConfEnableJITCache(PO::Description(
+            "Store the code compiled by the JIT or the tiered JIT into the AOT "
+            "cache, and load it on the later runs of the same module"sv)),
+        ConfEnableTieredJIT(PO::Description(
+            "Start in interpreter mode and JIT compile the module in the "
+            "background once its functions become hot"sv)),
+        TierUpThreshold(
+            PO::Description(
+                "Count of calls and loop iterations after which a function "
+                "is hot in the tiered JIT mode, default value is 1000"sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(1000)),
+        ProfileGenerate(
+            PO::Description(
+                "Run in interpreter mode and write the execution profile to "
+                "`PATH` for `wasmedgec --profile-use`"sv),
+            PO::MetaVar("PATH"sv)),
+        SampleProfile(
+            PO::Description(
+                "Sample the executions and write the collapsed stacks to "
+                "`PATH` for the flame graph tools"sv),
+            PO::MetaVar("PATH"sv)),
+        SampleFrequency(
+            PO::Description(
+                "Sampling frequency in Hz of the CPU time of every thread, "
+                "default value is 99"sv),
+            PO::MetaVar("HZ"sv), PO::DefaultValue<uint32_t>(99)),
+        RecordHostCalls(
+            PO::Description(
+                "Record the results and memory writes of the host calls to "
+                "`PATH` for `--replay-host-calls`"sv),
+            PO::MetaVar("PATH"sv)),
+        ReplayHostCalls(
+            PO::Description(
+                "Satisfy the host calls from the trace in `PATH` instead of "
+                "running them, for the reproducible benchmarks"sv),
+            PO::MetaVar("PATH"sv)),
+        TraceStartup(PO::Description(
+            "Log the durations of the startup phases, such as loading the "
+            "plugins, loading, validating, and instantiating the module"sv)),
+        TraceStartupOutput(
+            PO::Description(
+                "Trace the startup phases and write them to `PATH` in the "
+                "Chrome trace event format for Perfetto"sv),
+            PO::MetaVar("PATH"sv)),
+        MetricsPort(
+            PO::Description(
+                "Serve the runtime metrics at `/metrics` on `PORT` in the "
+                "OpenMetrics text format. The workers serve on the following "
+                "ports, default value is 0 for no serving"sv),
+            PO::MetaVar("PORT"sv), PO::DefaultValue<uint32_t>(0)),
         ConfEnableCoredump(PO::Description(
             "Enable coredump when WebAssembly enters a trap"sv)),
         ConfCoredumpWasmgdb(
@@ -112,6 +179,49 @@ struct DriverToolOptions {
         ConfForceInterpreter(
             PO::Description("Forcibly run WASM in interpreter mode."sv)),
         ConfAFUNIX(PO::Description("Enable UNIX domain sockets"sv)),
+        ConfEnableSuperInstructions(PO::Description(
+            "Enable fusing common instruction sequences into "
+            "super-instructions in interpreter mode."sv)),
+        ConfEnableZeroCopyLoad(PO::Description(
+            "Reference the data segments and custom sections in the "
+            "memory-mapped WASM file instead of copying them."sv)),
+        ConfEnableLazyFunctionBody(PO::Description(
+            "Decode and validate the function bodies at their first call."sv)),
+        ConfEnableTrustedAOT(PO::Description(
+            "Skip decoding and validating the function bodies of the AOT "
+            "compiled code matching the embedded module hash."sv)),
+        ConfEnableMemoryImage(PO::Description(
+            "Map the initialized memories recorded at the first "
+            "instantiation copy-on-write into the later instances."sv)),
+        ConfEnableHugePages(PO::Description(
+            "Back the linear memories with transparent huge pages."sv)),
+        ConfEnableHugePageCode(PO::Description(
+            "Back the code loaded from the AOT sections with transparent huge "
+            "pages."sv)),
+        ConfEnableLazyTable(PO::Description(
+            "Resolve the function references of the element segments into "
+            "the tables at their first access."sv)),
+        ConfEnableGuardRegion(PO::Description(
+            "Trap the out-of-bounds memory accesses of the interpreter with "
+            "the guard region instead of the bounds checks."sv)),
+        ConfEnableIoUring(PO::Description(
+            "Wait for the WASI poll events with io_uring on Linux, falling "
+            "back to epoll if unavailable."sv)),
+        ConfEnableWasiPathCache(PO::Description(
+            "Cache the directories resolved under the WASI pre-opened "
+            "directories on Linux."sv)),
+        ConfEnableCodeCache(PO::Description(
+            "Cache the validated function bodies of the interpreter, keyed by "
+            "the module bytes."sv)),
+        ConfEnableFusedValidation(PO::Description(
+            "Validate the function bodies of the interpreter while loading "
+            "them."sv)),
+        CacheMaxSize(
+            PO::Description(
+                "Size limit in MiB of every cache directory, over which the "
+                "least recently used entries are evicted. 0 for no limit, "
+                "default value is 2048"sv),
+            PO::MetaVar("MIB"sv), PO::DefaultValue<uint64_t>(2048)),
         TimeLim(
             PO::Description(
                 "Limitation of maximum time(in milliseconds) for execution, "
@@ -128,6 +238,49 @@ struct DriverToolOptions {
                 "instance. Upper bound can be specified as --memory-page-limit "
                 "`PAGE_COUNT`."sv),
             PO::MetaVar("PAGE_COUNT"sv)),
+        ValueStackSize(
+            PO::Description(
+                "Size in entries of the fixed-capacity value stack in "
+                "interpreter mode, default value is 0 for the growable value "
+                "stack"sv),
+            PO::MetaVar("ENTRY_COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        ValidationThreads(
+            PO::Description(
+                "Count of threads to validate the function bodies, default "
+                "value is 1, and 0 for the hardware concurrency"sv),
+            PO::MetaVar("THREAD_COUNT"sv), PO::DefaultValue<uint32_t>(1)),
+        LoadingThreads(
+            PO::Description(
+                "Count of threads to decode the function bodies, default "
+                "value is 1, and 0 for the hardware concurrency"sv),
+            PO::MetaVar("THREAD_COUNT"sv), PO::DefaultValue<uint32_t>(1)),
+        MemoryPoolSize(
+            PO::Description(
+                "Count of the released linear memory reservations kept for "
+                "reuse, default value is 0 for unmapping them"sv),
+            PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        StripedMemoryPages(
+            PO::Description(
+                "Stripe the linear memories of at most this many pages into "
+                "a shared reservation isolated by the memory protection keys, "
+                "default value is 0 for disabled"sv),
+            PO::MetaVar("PAGE_COUNT"sv), PO::DefaultValue<uint32_t>(0)),
+        NumaNode(PO::Description(
+                     "Place the linear memories and the executing threads on "
+                     "the NUMA node, default value is -1 for no placement"sv),
+                 PO::MetaVar("NODE"sv), PO::DefaultValue<int32_t>(-1)),
+        NativeStackSize(
+            PO::Description(
+                "Run the compiled code on a dedicated stack of `BYTES` per "
+                "thread, with a guard page for trapping the overflows, "
+                "default value is 0 for the stacks of the threads"sv),
+            PO::MetaVar("BYTES"sv), PO::DefaultValue<uint64_t>(0)),
+        Workers(PO::Description(
+                    "Fork `COUNT` worker processes after loading the module, "
+                    "each running its own instance. The internet sockets bound "
+                    "by the workers share the port by SO_REUSEPORT, default "
+                    "value is 1 for running in this process"sv),
+                PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(1)),
         ForbiddenPlugins(PO::Description("List of plugins to ignore."sv),
                          PO::MetaVar("NAMES"sv)) {}
 
@@ -160,26 +313,66 @@ struct DriverToolOptions {
   PO::Option<PO::Toggle> PropMultiMemDeprecated;
   PO::Option<PO::Toggle> PropRelaxedSIMDDeprecated;
   PO::Option<PO::Toggle> PropExceptionHandlingDeprecated;
-  // TODO: MEMORY64 - enable the option.
-  // PO::Option<PO::Toggle> PropMemory64;
+  PO::Option<PO::Toggle> PropMemory64;
   PO::Option<PO::Toggle> PropThreads;
+  PO::Option<PO::Toggle> PropStackSwitching;
   PO::Option<PO::Toggle> PropComponent;
   PO::Option<PO::Toggle> PropAll;
   PO::Option<PO::Toggle> ConfEnableInstructionCounting;
   PO::Option<PO::Toggle> ConfEnableGasMeasuring;
   PO::Option<PO::Toggle> ConfEnableTimeMeasuring;
+  PO::Option<PO::Toggle> ConfEnableIOStatistics;
   PO::Option<PO::Toggle> ConfEnableAllStatistics;
+  PO::Option<PO::Toggle> ConfEnableFunctionProfiling;
   PO::Option<PO::Toggle> ConfEnableJIT;
+  PO::Option<PO::Toggle> ConfEnableLazyJIT;
+  PO::Option<PO::Toggle> ConfEnableJITSpeculation;
+  PO::Option<PO::Toggle> ConfEnableJITCache;
+  PO::Option<PO::Toggle> ConfEnableTieredJIT;
+  PO::Option<uint32_t> TierUpThreshold;
+  PO::Option<std::string> ProfileGenerate;
+  PO::Option<std::string> SampleProfile;
+  PO::Option<uint32_t> SampleFrequency;
+  PO::Option<std::string> RecordHostCalls;
+  PO::Option<std::string> ReplayHostCalls;
+  PO::Option<PO::Toggle> TraceStartup;
+  PO::Option<std::string> TraceStartupOutput;
+  PO::Option<uint32_t> MetricsPort;
   PO::Option<PO::Toggle> ConfEnableCoredump;
   PO::Option<PO::Toggle> ConfCoredumpWasmgdb;
   PO::Option<PO::Toggle> ConfForceInterpreter;
   PO::Option<PO::Toggle> ConfAFUNIX;
+  PO::Option<PO::Toggle> ConfEnableSuperInstructions;
+  PO::Option<PO::Toggle> ConfEnableZeroCopyLoad;
+  PO::Option<PO::Toggle> ConfEnableLazyFunctionBody;
+  PO::Option<PO::Toggle> ConfEnableTrustedAOT;
+  PO::Option<PO::Toggle> ConfEnableMemoryImage;
+  PO::Option<PO::Toggle> ConfEnableHugePages;
+  PO::Option<PO::Toggle> ConfEnableHugePageCode;
+  PO::Option<PO::Toggle> ConfEnableLazyTable;
+  PO::Option<PO::Toggle> ConfEnableGuardRegion;
+  PO::Option<PO::Toggle> ConfEnableIoUring;
+  PO::Option<PO::Toggle> ConfEnableWasiPathCache;
+  PO::Option<PO::Toggle> ConfEnableCodeCache;
+  PO::Option<PO::Toggle> ConfEnableFusedValidation;
+  PO::Option<uint64_t> CacheMaxSize;
   PO::Option<uint64_t> TimeLim;
   PO::List<int> GasLim;
   PO::List<int> MemLim;
+  PO::Option<uint32_t> ValueStackSize;
+  PO::Option<uint32_t> ValidationThreads;
+  PO::Option<uint32_t> LoadingThreads;
+  PO::Option<uint32_t> MemoryPoolSize;
+  PO::Option<uint32_t> StripedMemoryPages;
+  PO::Option<int32_t> NumaNode;
+  PO::Option<uint64_t> NativeStackSize;
+  PO::Option<uint32_t> Workers;
   PO::List<std::string> ForbiddenPlugins;
 
-  void add_option(PO::ArgumentParser &Parser) noexcept {
+  /// Add the options into the parser. The plugins are loaded only if their
+  /// options are in the arguments, if given.
+  void add_option(PO::ArgumentParser &Parser,
+                  Span<const char *const> CommandLine = {}) noexcept {
 
     Parser.add_option(SoName)
         .add_option(Args)
@@ -189,12 +382,41 @@ struct DriverToolOptions {
         .add_option("enable-instruction-count"sv, ConfEnableInstructionCounting)
         .add_option("enable-gas-measuring"sv, ConfEnableGasMeasuring)
         .add_option("enable-time-measuring"sv, ConfEnableTimeMeasuring)
+        .add_option("enable-io-statistics"sv, ConfEnableIOStatistics)
         .add_option("enable-all-statistics"sv, ConfEnableAllStatistics)
+        .add_option("profile"sv, ConfEnableFunctionProfiling)
         .add_option("enable-jit"sv, ConfEnableJIT)
+        .add_option("enable-lazy-jit"sv, ConfEnableLazyJIT)
+        .add_option("enable-jit-speculation"sv, ConfEnableJITSpeculation)
+        .add_option("enable-jit-cache"sv, ConfEnableJITCache)
+        .add_option("enable-tiered-jit"sv, ConfEnableTieredJIT)
+        .add_option("tier-up-threshold"sv, TierUpThreshold)
+        .add_option("profile-generate"sv, ProfileGenerate)
+        .add_option("sample-profile"sv, SampleProfile)
+        .add_option("sample-frequency"sv, SampleFrequency)
+        .add_option("record-host-calls"sv, RecordHostCalls)
+        .add_option("replay-host-calls"sv, ReplayHostCalls)
+        .add_option("trace-startup"sv, TraceStartup)
+        .add_option("trace-startup-output"sv, TraceStartupOutput)
+        .add_option("metrics-port"sv, MetricsPort)
         .add_option("enable-coredump"sv, ConfEnableCoredump)
         .add_option("coredump-for-wasmgdb"sv, ConfCoredumpWasmgdb)
         .add_option("force-interpreter"sv, ConfForceInterpreter)
         .add_option("allow-af-unix"sv, ConfAFUNIX)
+        .add_option("enable-super-instructions"sv, ConfEnableSuperInstructions)
+        .add_option("enable-zero-copy-load"sv, ConfEnableZeroCopyLoad)
+        .add_option("enable-lazy-function-body"sv, ConfEnableLazyFunctionBody)
+        .add_option("enable-trusted-aot"sv, ConfEnableTrustedAOT)
+        .add_option("enable-memory-image"sv, ConfEnableMemoryImage)
+        .add_option("enable-huge-pages"sv, ConfEnableHugePages)
+        .add_option("enable-huge-page-code"sv, ConfEnableHugePageCode)
+        .add_option("enable-lazy-table"sv, ConfEnableLazyTable)
+        .add_option("enable-guard-region"sv, ConfEnableGuardRegion)
+        .add_option("enable-io-uring"sv, ConfEnableIoUring)
+        .add_option("enable-wasi-path-cache"sv, ConfEnableWasiPathCache)
+        .add_option("enable-code-cache"sv, ConfEnableCodeCache)
+        .add_option("enable-fused-validation"sv, ConfEnableFusedValidation)
+        .add_option("cache-max-size"sv, CacheMaxSize)
         .add_option("wasm-1"sv, PropWASM1)
         .add_option("wasm-2"sv, PropWASM2)
         .add_option("wasm-3"sv, PropWASM3)
@@ -221,18 +443,35 @@ struct DriverToolOptions {
         .add_option("enable-relaxed-simd"sv, PropRelaxedSIMDDeprecated)
         .add_option("enable-exception-handling"sv,
                     PropExceptionHandlingDeprecated)
-        // TODO: MEMORY64 - enable the option.
-        // .add_option("disable-memory64"sv, PropMemory64)
+        .add_option("enable-memory64"sv, PropMemory64)
         .add_option("enable-threads"sv, PropThreads)
+        .add_option("enable-stack-switching"sv, PropStackSwitching)
         .add_option("enable-component"sv, PropComponent)
         .add_option("enable-all"sv, PropAll)
         .add_option("time-limit"sv, TimeLim)
         .add_option("gas-limit"sv, GasLim)
         .add_option("memory-page-limit"sv, MemLim)
+        .add_option("value-stack-size"sv, ValueStackSize)
+        .add_option("validation-threads"sv, ValidationThreads)
+        .add_option("loading-threads"sv, LoadingThreads)
+        .add_option("memory-pool-size"sv, MemoryPoolSize)
+        .add_option("striped-memory-pages"sv, StripedMemoryPages)
+        .add_option("numa-node"sv, NumaNode)
+        .add_option("native-stack-size"sv, NativeStackSize)
+        .add_option("workers"sv, Workers)
         .add_option("forbidden-plugin"sv, ForbiddenPlugins);
 
+    // The plugins are loaded before parsing, so the trace is enabled by
+    // looking for its options first.
+    for (const char *Arg : CommandLine) {
+      if (std::string_view(Arg).rfind("--trace-startup"sv, 0) == 0) {
+        Trace::enable();
+        break;
+      }
+    }
+    Trace::Scope PluginScope("driver"sv, "load plugins"sv);
     Plugin::Plugin::loadFromDefaultPaths();
-    Plugin::Plugin::addPluginOptions(Parser);
+    Plugin::Plugin::addPluginOptions(Parser, CommandLine);
   }
 };
 
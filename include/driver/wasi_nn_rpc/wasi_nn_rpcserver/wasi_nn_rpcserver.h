@@ -5,6 +5,8 @@
 #include "wasi_ephemeral_nn.grpc.pb.h"
 
 #include <grpc/grpc.h>
+#include <map>
+#include <mutex>
 #include <string_view>
 
 using namespace std::literals;
@@ -227,47 +229,9 @@ public:
   SetInput(grpc::ServerContext *RPCContext,
            const wasi_ephemeral_nn::SetInputRequest *RPCRequest,
            google::protobuf::Empty * /*RPCResult*/) {
-    std::string_view FuncName = "set_input"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
-    uint32_t Index = RPCRequest->index();
-    auto Tensor = RPCRequest->tensor();
-    auto TensorDim = Tensor.dimensions();
-    uint32_t TensorDimSize = TensorDim.size();
-    uint32_t TensorTy = Tensor.ty();
-    auto TensorData = Tensor.data();
-    uint32_t TensorDataSize = static_cast<uint32_t>(TensorData.size());
-
-    /* clang-format off */
-    /**
-       0                    : FatPointer (20, TensorDimSize)
-       8                    : TensorTy
-      12                    : FatPointer (20 + TensorDimSize * 4, TensorDataSize)
-      20                    : TensorDim
-      20 + TensorDimSize * 4: TensorData
-    */
-    /* clang-format on */
-    uint32_t BuilderPtr = UINT32_C(0);
-    uint32_t SetInputEntryPtr = BuilderPtr;
-    uint32_t TensorDimPtr = UINT32_C(20);
-    uint32_t TensorDataPtr = TensorDimPtr + TensorDimSize * 4;
-    uint32_t MemorySize = TensorDataPtr + TensorDataSize;
-
-    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
-    auto &MemInst = HostFuncCaller.getMemInst();
-    writeFatPointerWithBuilderPtr(MemInst, TensorDimPtr, TensorDimSize,
-                                  BuilderPtr);
-    writeUInt32WithBuilderPtr(MemInst, TensorTy, BuilderPtr);
-    writeFatPointerWithBuilderPtr(MemInst, TensorDataPtr, TensorDataSize,
-                                  BuilderPtr);
-    writeBinaries<uint32_t>(MemInst, TensorDim, TensorDimPtr);
-    writeBinaries(MemInst, TensorData, TensorDataPtr);
-
-    uint32_t Errno =
-        HostFuncCaller.call({ResourceHandle, Index, SetInputEntryPtr});
-    if (Errno != 0) {
-      return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
-    }
-    return grpc::Status::OK;
+    auto Lock = lockContext(ResourceHandle);
+    return setInput(RPCContext, ResourceHandle, *RPCRequest);
   }
 
   /*
@@ -277,15 +241,9 @@ public:
   Compute(grpc::ServerContext *RPCContext,
           const wasi_ephemeral_nn::ComputeRequest *RPCRequest,
           google::protobuf::Empty * /*RPCResult*/) {
-    std::string_view FuncName = "compute"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
-    uint32_t MemorySize = UINT32_C(0);
-    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
-    uint32_t Errno = HostFuncCaller.call({ResourceHandle});
-    if (Errno != 0) {
-      return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
-    }
-    return grpc::Status::OK;
+    auto Lock = lockContext(ResourceHandle);
+    return callWithContext(RPCContext, "compute"sv, ResourceHandle);
   }
 
   /*
@@ -296,15 +254,9 @@ public:
   ComputeSingle(grpc::ServerContext *RPCContext,
                 const wasi_ephemeral_nn::ComputeRequest *RPCRequest,
                 google::protobuf::Empty * /*RPCResult*/) {
-    std::string_view FuncName = "compute_single"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
-    uint32_t MemorySize = UINT32_C(0);
-    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
-    uint32_t Errno = HostFuncCaller.call({ResourceHandle});
-    if (Errno != 0) {
-      return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
-    }
-    return grpc::Status::OK;
+    auto Lock = lockContext(ResourceHandle);
+    return callWithContext(RPCContext, "compute_single"sv, ResourceHandle);
   }
 
   /*
@@ -318,27 +270,12 @@ public:
             wasi_ephemeral_nn::GetOutputResult *RPCResult) {
     std::string_view FuncName = "get_output"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
-    uint32_t Index = RPCRequest->index();
-    uint32_t MemorySize = UINT32_C(65536); // FIXME
-    uint32_t BytesWrittenPtr = UINT32_C(0);
-    uint32_t BufPtr = BytesWrittenPtr + UINT32_C(4);
-    uint32_t BufMaxSize = MemorySize - BufPtr;
-    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
-    auto &MemInst = HostFuncCaller.getMemInst();
-    uint32_t Errno = HostFuncCaller.call(
-        {ResourceHandle, Index, BufPtr, BufMaxSize, BytesWrittenPtr});
+    auto Lock = lockContext(ResourceHandle);
+    uint32_t Errno = getOutput(FuncName, ResourceHandle, RPCRequest->index(),
+                               *RPCResult->mutable_data());
     if (Errno != 0) {
       return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
     }
-    /* clang-format off */
-    /**
-       0                    : BytesWritten
-       4                    : Buf
-    */
-    /* clang-format on */
-    auto BytesWritten = *MemInst.getPointer<uint32_t *>(BytesWrittenPtr);
-    auto *Buf = MemInst.getPointer<char *>(BufPtr);
-    RPCResult->set_data(Buf, BytesWritten);
     return grpc::Status::OK;
   }
 
@@ -353,27 +290,12 @@ public:
                   wasi_ephemeral_nn::GetOutputResult *RPCResult) {
     std::string_view FuncName = "get_output_single"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
-    uint32_t Index = RPCRequest->index();
-    uint32_t MemorySize = UINT32_C(65536); // FIXME
-    uint32_t BytesWrittenPtr = UINT32_C(0);
-    uint32_t BufPtr = BytesWrittenPtr + UINT32_C(4);
-    uint32_t BufMaxSize = MemorySize - BufPtr;
-    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
-    auto &MemInst = HostFuncCaller.getMemInst();
-    uint32_t Errno = HostFuncCaller.call(
-        {ResourceHandle, Index, BufPtr, BufMaxSize, BytesWrittenPtr});
+    auto Lock = lockContext(ResourceHandle);
+    uint32_t Errno = getOutput(FuncName, ResourceHandle, RPCRequest->index(),
+                               *RPCResult->mutable_data());
     if (Errno != 0) {
       return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
     }
-    /* clang-format off */
-    /**
-       0                    : BytesWritten
-       4                    : Buf
-    */
-    /* clang-format on */
-    auto BytesWritten = *MemInst.getPointer<uint32_t *>(BytesWrittenPtr);
-    auto *Buf = MemInst.getPointer<char *>(BufPtr);
-    RPCResult->set_data(Buf, BytesWritten);
     return grpc::Status::OK;
   }
 
@@ -385,8 +307,89 @@ public:
   FiniSingle(grpc::ServerContext *RPCContext,
              const wasi_ephemeral_nn::FiniSingleRequest *RPCRequest,
              google::protobuf::Empty * /*RPCResult*/) {
-    std::string_view FuncName = "fini_single"sv;
     uint32_t ResourceHandle = RPCRequest->resource_handle();
+    auto Lock = lockContext(ResourceHandle);
+    return callWithContext(RPCContext, "fini_single"sv, ResourceHandle);
+  }
+
+  // set_input, compute and get_output in one round trip. The outputs which
+  // cannot be read are left out, and the client reads them again with
+  // GetOutput to get the errno.
+  virtual grpc::Status
+  ComputeWithIO(grpc::ServerContext *RPCContext,
+                const wasi_ephemeral_nn::ComputeWithIORequest *RPCRequest,
+                wasi_ephemeral_nn::ComputeWithIOResult *RPCResult) {
+    uint32_t ResourceHandle = RPCRequest->resource_handle();
+    auto Lock = lockContext(ResourceHandle);
+    for (const auto &Input : RPCRequest->inputs()) {
+      if (auto Status = setInput(RPCContext, ResourceHandle, Input);
+          !Status.ok()) {
+        return Status;
+      }
+    }
+    if (auto Status = callWithContext(RPCContext, "compute"sv, ResourceHandle);
+        !Status.ok()) {
+      return Status;
+    }
+    for (const auto Index : RPCRequest->output_indices()) {
+      wasi_ephemeral_nn::Output Output;
+      if (getOutput("get_output"sv, ResourceHandle, Index,
+                    *Output.mutable_data()) == 0) {
+        Output.set_index(Index);
+        *RPCResult->add_outputs() = std::move(Output);
+      }
+    }
+    return grpc::Status::OK;
+  }
+
+  // Streams the output of every compute_single. The concurrent streams of the
+  // contexts sharing a graph are batched by the backend.
+  virtual grpc::Status ComputeSingleStream(
+      grpc::ServerContext *RPCContext,
+      const wasi_ephemeral_nn::ComputeWithIORequest *RPCRequest,
+      grpc::ServerWriter<wasi_ephemeral_nn::GetOutputResult> *Writer) {
+    uint32_t ResourceHandle = RPCRequest->resource_handle();
+    auto Lock = lockContext(ResourceHandle);
+    for (const auto &Input : RPCRequest->inputs()) {
+      if (auto Status = setInput(RPCContext, ResourceHandle, Input);
+          !Status.ok()) {
+        return Status;
+      }
+    }
+    HostFuncCaller Compute(NNMod, "compute_single"sv, UINT32_C(0));
+    while (!RPCContext->IsCancelled()) {
+      if (uint32_t Errno = Compute.call({ResourceHandle}); Errno != 0) {
+        return createRPCStatusFromErrno(RPCContext, "compute_single"sv,
+                                        Errno);
+      }
+      wasi_ephemeral_nn::GetOutputResult Result;
+      if (uint32_t Errno = getOutput("get_output_single"sv, ResourceHandle,
+                                     UINT32_C(0), *Result.mutable_data());
+          Errno != 0) {
+        return createRPCStatusFromErrno(RPCContext, "get_output_single"sv,
+                                        Errno);
+      }
+      if (!Writer->Write(Result)) {
+        // The client has finished the stream.
+        break;
+      }
+    }
+    return grpc::Status::CANCELLED;
+  }
+
+private:
+  // The requests of a context run one at a time, so that a stream stops
+  // before the next request of its context.
+  std::unique_lock<std::mutex> lockContext(uint32_t ResourceHandle) {
+    std::unique_lock Lock(ContextsMutex);
+    auto &Mutex = ContextMutexes[ResourceHandle];
+    Lock.unlock();
+    return std::unique_lock(Mutex);
+  }
+
+  grpc::Status callWithContext(grpc::ServerContext *RPCContext,
+                               std::string_view FuncName,
+                               uint32_t ResourceHandle) {
     uint32_t MemorySize = UINT32_C(0);
     HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
     uint32_t Errno = HostFuncCaller.call({ResourceHandle});
@@ -396,8 +399,79 @@ public:
     return grpc::Status::OK;
   }
 
-private:
+  grpc::Status setInput(grpc::ServerContext *RPCContext,
+                        uint32_t ResourceHandle,
+                        const wasi_ephemeral_nn::SetInputRequest &RPCRequest) {
+    std::string_view FuncName = "set_input"sv;
+    uint32_t Index = RPCRequest.index();
+    const auto &Tensor = RPCRequest.tensor();
+    const auto &TensorDim = Tensor.dimensions();
+    uint32_t TensorDimSize = TensorDim.size();
+    uint32_t TensorTy = Tensor.ty();
+    const auto &TensorData = Tensor.data();
+    uint32_t TensorDataSize = static_cast<uint32_t>(TensorData.size());
+
+    /* clang-format off */
+    /**
+       0                    : FatPointer (20, TensorDimSize)
+       8                    : TensorTy
+      12                    : FatPointer (20 + TensorDimSize * 4, TensorDataSize)
+      20                    : TensorDim
+      20 + TensorDimSize * 4: TensorData
+    */
+    /* clang-format on */
+    uint32_t BuilderPtr = UINT32_C(0);
+    uint32_t SetInputEntryPtr = BuilderPtr;
+    uint32_t TensorDimPtr = UINT32_C(20);
+    uint32_t TensorDataPtr = TensorDimPtr + TensorDimSize * 4;
+    uint32_t MemorySize = TensorDataPtr + TensorDataSize;
+
+    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
+    auto &MemInst = HostFuncCaller.getMemInst();
+    writeFatPointerWithBuilderPtr(MemInst, TensorDimPtr, TensorDimSize,
+                                  BuilderPtr);
+    writeUInt32WithBuilderPtr(MemInst, TensorTy, BuilderPtr);
+    writeFatPointerWithBuilderPtr(MemInst, TensorDataPtr, TensorDataSize,
+                                  BuilderPtr);
+    writeBinaries<uint32_t>(MemInst, TensorDim, TensorDimPtr);
+    writeBinaries(MemInst, TensorData, TensorDataPtr);
+
+    uint32_t Errno =
+        HostFuncCaller.call({ResourceHandle, Index, SetInputEntryPtr});
+    if (Errno != 0) {
+      return createRPCStatusFromErrno(RPCContext, FuncName, Errno);
+    }
+    return grpc::Status::OK;
+  }
+
+  uint32_t getOutput(std::string_view FuncName, uint32_t ResourceHandle,
+                     uint32_t Index, std::string &Data) {
+    uint32_t MemorySize = UINT32_C(65536); // FIXME
+    uint32_t BytesWrittenPtr = UINT32_C(0);
+    uint32_t BufPtr = BytesWrittenPtr + UINT32_C(4);
+    uint32_t BufMaxSize = MemorySize - BufPtr;
+    HostFuncCaller HostFuncCaller(NNMod, FuncName, MemorySize);
+    auto &MemInst = HostFuncCaller.getMemInst();
+    uint32_t Errno = HostFuncCaller.call(
+        {ResourceHandle, Index, BufPtr, BufMaxSize, BytesWrittenPtr});
+    if (Errno != 0) {
+      return Errno;
+    }
+    /* clang-format off */
+    /**
+       0                    : BytesWritten
+       4                    : Buf
+    */
+    /* clang-format on */
+    auto BytesWritten = *MemInst.getPointer<uint32_t *>(BytesWrittenPtr);
+    auto *Buf = MemInst.getPointer<char *>(BufPtr);
+    Data.assign(Buf, BytesWritten);
+    return 0;
+  }
+
   const Runtime::Instance::ModuleInstance &NNMod;
+  std::mutex ContextsMutex;
+  std::map<uint32_t, std::mutex> ContextMutexes;
 };
 
 class ServiceSet {
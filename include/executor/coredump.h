@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 #include "ast/section.h"
 #include "ast/type.h"
+#include "common/configure.h"
 #include "common/errcode.h"
 #include "common/span.h"
 #include "loader/serialize.h"
@@ -11,8 +12,13 @@
 namespace WasmEdge {
 namespace Coredump {
 
+/// Generate the coredump of the current module instance and write it into
+/// the working directory. The memory is dumped sparsely, and the dumps of the
+/// same module are limited by the interval of the configuration. The file is
+/// serialized and written by the thread pool if the asynchronous writing is
+/// enabled.
 void generateCoredump(const Runtime::StackManager &StackMgr,
-                      bool ForWasmgdb) noexcept;
+                      const RuntimeConfigure &Conf) noexcept;
 AST::CustomSection createCore();
 AST::CustomSection createCoremodules(
     Loader::Serializer &Ser,
@@ -26,7 +32,8 @@ AST::MemorySection createMemory(
     Span<const Runtime::Instance::MemoryInstance *const> MemoryInstances);
 AST::GlobalSection createGlobals(
     Span<const Runtime::Instance::GlobalInstance *const> GlobalInstances);
-AST::DataSection
-createData(Span<const Runtime::Instance::DataInstance *const> DataInstances);
+/// Create the data segments of the non-zero contents of the first memory.
+AST::DataSection createData(
+    Span<const Runtime::Instance::MemoryInstance *const> MemoryInstances);
 } // namespace Coredump
 } // namespace WasmEdge
@@ -5,7 +5,6 @@
 #include "common/types.h"
 #include "executor/executor.h"
 #include "runtime/instance/memory.h"
-#include <experimental/scope.hpp>
 
 #include <cstdint>
 
@@ -20,18 +19,9 @@ TypeT<T> Executor::runAtomicWaitOp(Runtime::StackManager &StackMgr,
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
 
-  uint32_t Address = RawAddress.get<uint32_t>();
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(T), Instr));
 
   if (Address % sizeof(T) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -57,19 +47,9 @@ TypeT<T> Executor::runAtomicLoadOp(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::MemoryInstance &MemInst,
                                    const AST::Instruction &Instr) {
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -79,7 +59,7 @@ TypeT<T> Executor::runAtomicLoadOp(Runtime::StackManager &StackMgr,
   }
 
   // make sure the address no OOB with size I
-  auto *AtomicObj = MemInst.getPointer<std::atomic<I> *>(Address);
+  auto *AtomicObj = MemInst.getPointer<const std::atomic<I> *>(Address);
   if (!AtomicObj) {
     spdlog::error(ErrCode::Value::MemoryOutOfBounds);
     spdlog::error(
@@ -98,19 +78,9 @@ TypeT<T> Executor::runAtomicStoreOp(Runtime::StackManager &StackMgr,
                                     const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant RawAddress = StackMgr.pop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -155,19 +125,9 @@ TypeT<T> Executor::runAtomicAddOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -200,19 +160,9 @@ TypeT<T> Executor::runAtomicSubOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -245,19 +195,9 @@ TypeT<T> Executor::runAtomicOrOp(Runtime::StackManager &StackMgr,
                                  const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -287,19 +227,9 @@ TypeT<T> Executor::runAtomicAndOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -329,19 +259,9 @@ TypeT<T> Executor::runAtomicXorOp(Runtime::StackManager &StackMgr,
                                   const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -372,19 +292,9 @@ Executor::runAtomicExchangeOp(Runtime::StackManager &StackMgr,
                               const AST::Instruction &Instr) {
   ValVariant RawValue = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -416,19 +326,9 @@ Executor::runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
   ValVariant RawReplacement = StackMgr.pop();
   ValVariant RawExpected = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(I),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(I), Instr));
 
   if (Address % sizeof(I) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -456,7 +356,7 @@ Executor::runAtomicCompareExchangeOp(Runtime::StackManager &StackMgr,
 template <typename T>
 Expect<uint32_t>
 Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
-                     uint32_t Address, EndianValue<T> Expected,
+                     uint64_t Address, EndianValue<T> Expected,
                      int64_t Timeout) noexcept {
   // The error message should be handled by the caller, or the AOT mode will
   // produce the duplicated messages.
@@ -464,7 +364,7 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
     return Unexpect(ErrCode::Value::ExpectSharedMemory);
   }
 
-  if (auto *AtomicObj = MemInst.getPointer<std::atomic<T> *>(Address);
+  if (auto *AtomicObj = MemInst.getPointer<const std::atomic<T> *>(Address);
       !AtomicObj) {
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
@@ -475,42 +375,35 @@ Executor::atomicWait(Runtime::Instance::MemoryInstance &MemInst,
                   std::chrono::nanoseconds(Timeout));
   }
 
-  auto *AtomicObj = MemInst.getPointer<std::atomic<T> *>(Address);
+  auto *AtomicObj = MemInst.getPointer<const std::atomic<T> *>(Address);
   assuming(AtomicObj);
 
+  // Link the waiter before checking the value, so that the notifiers after
+  // changing the value will see the waiter.
+  Waiter W(&MemInst, Address);
+  auto &Shard = getWaiterShard(MemInst, Address);
+  std::unique_lock Lock(Shard.Mutex);
+  Shard.link(W);
   if (AtomicObj->load() != Expected.le()) {
+    Shard.unlink(W);
     return UINT32_C(1); // NotEqual
   }
-
-  decltype(WaiterMap)::iterator WaiterIterator;
-  {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterIterator = WaiterMap.emplace(Address, &MemInst);
+  if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
+    Shard.unlink(W);
+    return Unexpect(ErrCode::Value::Interrupted);
   }
 
-  cxx20::scope_exit ScopeExitHolder([&]() noexcept {
-    std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-    WaiterMap.erase(WaiterIterator);
-  });
-
-  while (true) {
-    std::unique_lock<decltype(WaiterIterator->second.Mutex)> Locker(
-        WaiterIterator->second.Mutex);
-    std::cv_status WaitResult = std::cv_status::no_timeout;
-    if (!Until) {
-      WaiterIterator->second.Cond.wait(Locker);
-    } else {
-      WaitResult = WaiterIterator->second.Cond.wait_until(Locker, *Until);
-    }
-    if (unlikely(StopToken.load(std::memory_order_relaxed) != 0)) {
-      return Unexpect(ErrCode::Value::Interrupted);
-    }
-    if (likely(AtomicObj->load() != Expected.le())) {
-      return UINT32_C(0); // ok
-    }
-    if (WaitResult == std::cv_status::timeout) {
-      return UINT32_C(2); // Timed-out
-    }
+  parkWaiter(Shard, Lock, W, Until ? &*Until : nullptr);
+  if (W.Linked) {
+    Shard.unlink(W);
+  }
+  switch (W.State.load(std::memory_order_acquire)) {
+  case Waiter::Notified:
+    return UINT32_C(0); // ok
+  case Waiter::Interrupted:
+    return Unexpect(ErrCode::Value::Interrupted);
+  default:
+    return UINT32_C(2); // Timed-out
   }
 }
 
@@ -104,6 +104,12 @@ Expect<void> Executor::runVectorNarrowOp(ValVariant &Val1,
   using HVTOut [[gnu::vector_size(8)]] = TOut;
   using VTOut [[gnu::vector_size(16)]] = TOut;
 
+  if (VTOut Result;
+      detail::vectorNarrow(Result, Val1.get<VTIn>(), Val2.get<VTIn>())) {
+    Val1.emplace<VTOut>(Result);
+    return {};
+  }
+
   const VTIn Min = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::min());
   const VTIn Max = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::max());
   VTIn V1 = Val1.get<VTIn>();
@@ -174,6 +180,10 @@ Expect<void> Executor::runVectorAddSatOp(ValVariant &Val1,
                                          const ValVariant &Val2) const {
   using VT [[gnu::vector_size(16)]] = T;
   using UVT [[gnu::vector_size(16)]] = std::make_unsigned_t<T>;
+  if (detail::vectorAddSat(Val1.get<VT>(), Val2.get<VT>())) {
+    return {};
+  }
+
   UVT &V1 = Val1.get<UVT>();
   const UVT &V2 = Val2.get<UVT>();
   const UVT Result = V1 + V2;
@@ -205,6 +215,10 @@ Expect<void> Executor::runVectorSubSatOp(ValVariant &Val1,
                                          const ValVariant &Val2) const {
   using VT [[gnu::vector_size(16)]] = T;
   using UVT [[gnu::vector_size(16)]] = std::make_unsigned_t<T>;
+  if (detail::vectorSubSat(Val1.get<VT>(), Val2.get<VT>())) {
+    return {};
+  }
+
   UVT &V1 = Val1.get<UVT>();
   const UVT &V2 = Val2.get<UVT>();
   const UVT Result = V1 - V2;
@@ -378,6 +392,9 @@ Expect<void> Executor::runVectorExtMulHighOp(ValVariant &Val1,
 
 inline Expect<void>
 Executor::runVectorQ15MulSatOp(ValVariant &Val1, const ValVariant &Val2) const {
+  if (detail::vectorQ15MulrSat(Val1.get<int16x8_t>(), Val2.get<int16x8_t>())) {
+    return {};
+  }
   using int32x8_t [[gnu::vector_size(32)]] = int32_t;
   const auto &V1 = Val1.get<int16x8_t>();
   const auto &V2 = Val2.get<int16x8_t>();
@@ -407,6 +424,11 @@ Executor::runVectorRelaxedLaneselectOp(ValVariant &Val1, const ValVariant &Val2,
 inline Expect<void>
 Executor::runVectorRelaxedIntegerDotProductOp(ValVariant &Val1,
                                               const ValVariant &Val2) const {
+  if (WasmEdge::int16x8_t Result; detail::vectorRelaxedDot(
+          Result, Val1.get<int8x16_t>(), Val2.get<int8x16_t>())) {
+    Val1.emplace<WasmEdge::int16x8_t>(Result);
+    return {};
+  }
   using int16x8_t [[gnu::vector_size(16)]] = int16_t;
 
   const int16x8_t &V1 = Val1.get<int16x8_t>();
@@ -424,6 +446,13 @@ Executor::runVectorRelaxedIntegerDotProductOp(ValVariant &Val1,
 
 inline Expect<void> Executor::runVectorRelaxedIntegerDotProductOpAdd(
     ValVariant &Val1, const ValVariant &Val2, const ValVariant &C) const {
+  if (WasmEdge::int32x4_t Result;
+      detail::vectorRelaxedDotAdd(Result, Val1.get<int8x16_t>(),
+                                  Val2.get<int8x16_t>(),
+                                  C.get<WasmEdge::int32x4_t>())) {
+    Val1.emplace<WasmEdge::int32x4_t>(Result);
+    return {};
+  }
   using int16x8_t [[gnu::vector_size(16)]] = int16_t;
   using int32x4_t [[gnu::vector_size(16)]] = int32_t;
 
@@ -9,23 +9,41 @@
 namespace WasmEdge {
 namespace Executor {
 
+inline Expect<uint64_t> Executor::getEffectiveAddress(
+    const Runtime::Instance::MemoryInstance &MemInst, uint64_t Addr,
+    uint32_t Length, const AST::Instruction &Instr) const noexcept {
+  // The offsets are less than 2^48, so only the 64-bit addresses overflow.
+  // The effective addresses beyond the 32-bit memories fail the bounds checks.
+  if (unlikely(Addr > std::numeric_limits<uint64_t>::max() -
+                          Instr.getMemoryOffset())) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    spdlog::error(ErrInfo::InfoBoundary(Addr, Length, MemInst.getBoundIdx()));
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  return Addr + Instr.getMemoryOffset();
+}
+
 template <typename T, uint32_t BitWidth>
 TypeT<T> Executor::runLoadOp(Runtime::StackManager &StackMgr,
                              Runtime::Instance::MemoryInstance &MemInst,
                              const AST::Instruction &Instr) {
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        BitWidth / 8, MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  const uint64_t Addr = getAddress(Val, MemInst);
+  if (GuardRegion &&
+      likely(Instr.getMemoryOffset() <=
+                 Runtime::Instance::MemoryInstance::kGuardedOffsetLimit &&
+             Addr < MemInst.getGuardedAddressLimit() &&
+             MemInst.getDataPtr() != nullptr)) {
+    // The out-of-bounds access faults in the guard region.
+    MemInst.loadValueUnchecked<T, BitWidth / 8>(Val.emplace<T>(),
+                                                Addr + Instr.getMemoryOffset());
+    return {};
   }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst, Addr, BitWidth / 8, Instr));
 
   // Value = Mem.Data[EA : N / 8]
   return MemInst.loadValue<T, BitWidth / 8>(Val.emplace<T>(), EA)
@@ -44,17 +62,19 @@ TypeN<T> Executor::runStoreOp(Runtime::StackManager &StackMgr,
   T C = StackMgr.pop().get<T>();
 
   // Calculate EA = i + offset
-  uint32_t I = StackMgr.pop().get<uint32_t>();
-  if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        I + static_cast<uint64_t>(Instr.getMemoryOffset()), BitWidth / 8,
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  const uint64_t I = getAddress(StackMgr.pop(), MemInst);
+  if (GuardRegion &&
+      likely(Instr.getMemoryOffset() <=
+                 Runtime::Instance::MemoryInstance::kGuardedOffsetLimit &&
+             I < MemInst.getGuardedAddressLimit() &&
+             MemInst.getDataPtr() != nullptr && !MemInst.isReadOnly())) {
+    // The out-of-bounds access faults in the guard region.
+    MemInst.storeValueUnchecked<T, BitWidth / 8>(C,
+                                                 I + Instr.getMemoryOffset());
+    return {};
   }
-  uint32_t EA = I + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst, I, BitWidth / 8, Instr));
 
   // Store value to bytes.
   return MemInst.storeValue<T, BitWidth / 8>(C, EA).map_error([&Instr](auto E) {
@@ -72,17 +92,9 @@ Executor::runLoadExpandOp(Runtime::StackManager &StackMgr,
   static_assert(sizeof(TOut) == sizeof(TIn) * 2);
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()), 8,
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst, getAddress(Val, MemInst),
+                                   8, Instr));
 
   // Value = Mem.Data[EA : N / 8]
   uint64_t Buffer;
@@ -117,17 +129,9 @@ Executor::runLoadSplatOp(Runtime::StackManager &StackMgr,
                          const AST::Instruction &Instr) {
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  if (Val.get<uint32_t>() >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Val.get<uint32_t>() + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        sizeof(T), MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  uint32_t EA = Val.get<uint32_t>() + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst, getAddress(Val, MemInst),
+                                   sizeof(T), Instr));
 
   // Value = Mem.Data[EA : N / 8]
   using VT = SIMDArray<T, 16>;
@@ -165,17 +169,9 @@ Expect<void> Executor::runLoadLaneOp(Runtime::StackManager &StackMgr,
                             : (16 / sizeof(T)) - 1 - Instr.getMemoryLane();
   // Calculate EA
   ValVariant &Val = StackMgr.getTop();
-  const uint32_t Offset = Val.get<uint32_t>();
-  if (Offset > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Offset + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  const uint32_t EA = Offset + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst, getAddress(Val, MemInst),
+                                   sizeof(T), Instr));
 
   // Value = Mem.Data[EA : N / 8]
   uint64_t Buffer;
@@ -204,17 +200,10 @@ Executor::runStoreLaneOp(Runtime::StackManager &StackMgr,
   const TBuf C = StackMgr.pop().get<VT>()[Lane];
 
   // Calculate EA = i + offset
-  uint32_t I = StackMgr.pop().get<uint32_t>();
-  if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        I + static_cast<uint64_t>(Instr.getMemoryOffset()), sizeof(T),
-        MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  uint32_t EA = I + Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t EA,
+               getEffectiveAddress(MemInst,
+                                   getAddress(StackMgr.pop(), MemInst),
+                                   sizeof(T), Instr));
 
   // Store value to bytes.
   return MemInst.storeValue<decltype(C), sizeof(T)>(C, EA).map_error(
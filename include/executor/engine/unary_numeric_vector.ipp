@@ -165,6 +165,12 @@ Expect<void> Executor::runVectorTruncSatOp(ValVariant &Val) const {
   static_assert((sizeof(TIn) == 4 || sizeof(TIn) == 8) && sizeof(TOut) == 4);
   using VTIn [[gnu::vector_size(16)]] = TIn;
   using VTOut [[gnu::vector_size(16)]] = TOut;
+  if constexpr (std::is_same_v<TIn, float>) {
+    if (VTOut Result; detail::vectorTruncSat(Result, Val.get<VTIn>())) {
+      Val.emplace<VTOut>(Result);
+      return {};
+    }
+  }
   const VTIn FMin = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::min());
   const VTIn FMax = VTIn{} + static_cast<TIn>(std::numeric_limits<TOut>::max());
   auto &V = Val.get<VTIn>();
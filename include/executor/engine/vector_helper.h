@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include "common/types.h"
+
 #include <type_traits>
 
 namespace WasmEdge {
 namespace Executor {
 namespace detail {
 
+#if !defined(_MSC_VER) || defined(__clang__)
 template <typename U, typename V>
 [[gnu::always_inline]] constexpr inline std::enable_if_t<
     !std::is_arithmetic_v<V>, V>
@@ -20,6 +23,60 @@ vectorSelect(U Cond, V A, V B) noexcept {
   return Cond ? A : B;
 #endif
 }
+#endif
+
+/// \name Accelerated v128 operations.
+///
+/// These operations are not lowered well from the generic vector code on the
+/// baseline targets, so they are implemented with the SSE instructions on
+/// x86-64 and the NEON instructions on AArch64. The instructions beyond the
+/// baseline are detected on the host CPU at runtime. Each function returns
+/// false without touching the operands if not supported, and the caller falls
+/// back to the generic implementation.
+/// @{
+bool vectorSwizzle(uint8x16_t &Vector, const uint8x16_t &Index) noexcept;
+bool vectorShuffle(uint8x16_t &V1, const uint8x16_t &V2,
+                   const uint8x16_t &Index) noexcept;
+bool vectorAddSat(int8x16_t &V1, const int8x16_t &V2) noexcept;
+bool vectorAddSat(uint8x16_t &V1, const uint8x16_t &V2) noexcept;
+bool vectorAddSat(int16x8_t &V1, const int16x8_t &V2) noexcept;
+bool vectorAddSat(uint16x8_t &V1, const uint16x8_t &V2) noexcept;
+bool vectorSubSat(int8x16_t &V1, const int8x16_t &V2) noexcept;
+bool vectorSubSat(uint8x16_t &V1, const uint8x16_t &V2) noexcept;
+bool vectorSubSat(int16x8_t &V1, const int16x8_t &V2) noexcept;
+bool vectorSubSat(uint16x8_t &V1, const uint16x8_t &V2) noexcept;
+bool vectorNarrow(int8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept;
+bool vectorNarrow(uint8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept;
+bool vectorNarrow(int16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept;
+bool vectorNarrow(uint16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept;
+bool vectorQ15MulrSat(int16x8_t &V1, const int16x8_t &V2) noexcept;
+bool vectorDot(int32x4_t &Result, const int16x8_t &V1,
+               const int16x8_t &V2) noexcept;
+bool vectorTruncSat(int32x4_t &Result, const floatx4_t &V) noexcept;
+bool vectorTruncSat(uint32x4_t &Result, const floatx4_t &V) noexcept;
+/// @}
+
+/// \name Relaxed v128 operations.
+///
+/// These operations are lowered to the native instructions whose results are
+/// allowed by the relaxed SIMD proposal, as the compiled code does, instead
+/// of the deterministic ones. They return false if not supported as above.
+/// @{
+bool vectorRelaxedSwizzle(uint8x16_t &Vector, const uint8x16_t &Index) noexcept;
+/// V1 = V1 * V2 + V3, or -(V1 * V2) + V3 if Negate, fused if supported.
+bool vectorRelaxedMAdd(floatx4_t &V1, const floatx4_t &V2, const floatx4_t &V3,
+                       bool Negate) noexcept;
+bool vectorRelaxedMAdd(doublex2_t &V1, const doublex2_t &V2,
+                       const doublex2_t &V3, bool Negate) noexcept;
+bool vectorRelaxedDot(int16x8_t &Result, const int8x16_t &V1,
+                      const int8x16_t &V2) noexcept;
+bool vectorRelaxedDotAdd(int32x4_t &Result, const int8x16_t &V1,
+                         const int8x16_t &V2, const int32x4_t &C) noexcept;
+/// @}
 
 } // namespace detail
 } // namespace Executor
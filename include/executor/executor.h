@@ -19,16 +19,25 @@
 #include "common/async.h"
 #include "common/configure.h"
 #include "common/defines.h"
+#include "common/epoch.h"
 #include "common/errcode.h"
+#include "common/reclaimer.h"
 #include "common/statistics.h"
 #include "common/types.h"
+#include "executor/hosttrace.h"
 #include "runtime/callingframe.h"
 #include "runtime/instance/component/component.h"
 #include "runtime/instance/module.h"
+#include "runtime/instance/prelink.h"
+#include "runtime/instance/snapshot.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
+#include "system/allocator.h"
+#include "system/fiber.h"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <csignal>
 #include <cstdint>
@@ -146,7 +155,8 @@ public:
       : Conf(Conf) {
     if (Conf.getStatisticsConfigure().isInstructionCounting() ||
         Conf.getStatisticsConfigure().isCostMeasuring() ||
-        Conf.getStatisticsConfigure().isTimeMeasuring()) {
+        Conf.getStatisticsConfigure().isTimeMeasuring() ||
+        Conf.getStatisticsConfigure().isFunctionProfiling()) {
       Stat = S;
     } else {
       Stat = nullptr;
@@ -154,6 +164,24 @@ public:
     if (Stat) {
       Stat->setCostLimit(Conf.getStatisticsConfigure().getCostLimit());
     }
+    if (S && Conf.getStatisticsConfigure().isProfileGenerating()) {
+      Prof = &S->getProfile();
+    }
+    if (const auto Size = Conf.getRuntimeConfigure().getMemoryPoolSize()) {
+      Allocator::setPoolCapacity(Size);
+    }
+    if (Conf.getRuntimeConfigure().isEnableHugePages()) {
+      Allocator::setHugePages(true);
+    }
+    if (Conf.getRuntimeConfigure().isEnableBackgroundReclamation()) {
+      Reclaimer::setEnabled(true);
+    }
+    if (const auto Pages = Conf.getRuntimeConfigure().getStripedMemoryPages()) {
+      Allocator::enableStriping(Pages);
+    }
+    GuardRegion = WASMEDGE_ALLOCATOR_IS_STABLE &&
+                  Conf.getRuntimeConfigure().isEnableGuardRegion();
+    CpuAccounting = Conf.getRuntimeConfigure().isEnableCpuAccounting();
   }
 
   /// Getter of Configure
@@ -163,6 +191,18 @@ public:
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   instantiateModule(Runtime::StoreManager &StoreMgr, const AST::Module &Mod);
 
+  /// Resolve and type-check the imports of a WASM module against the
+  /// registered modules of the store once, for instantiating it repeatedly.
+  Expect<std::unique_ptr<Runtime::Instance::ModulePrelink>>
+  prelinkModule(const Runtime::StoreManager &StoreMgr, const AST::Module &Mod);
+
+  /// Instantiate a pre-linked WASM module into an anonymous module instance.
+  /// The imports are bound by index, or resolved again if the registered
+  /// modules of the store changed after the pre-linking.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  instantiateModule(Runtime::StoreManager &StoreMgr,
+                    const Runtime::Instance::ModulePrelink &Prelink);
+
   /// Instantiate and register a WASM module into a named module instance.
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   registerModule(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
@@ -172,6 +212,26 @@ public:
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const Runtime::Instance::ModuleInstance &ModInst);
 
+  /// Clone an instantiated module instance into an anonymous module instance.
+  /// The clone shares the imports and function bodies with the source, and
+  /// copies the tables, globals, and segments. The memories are mapped
+  /// copy-on-write from the images recorded at the first clone of the source,
+  /// so the source should not be executed after being cloned.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+  cloneModule(const Runtime::Instance::ModuleInstance &ModInst);
+
+  /// Take a snapshot of the owned memories, tables, and globals of a module
+  /// instance, for resetting it between the requests instead of instantiating
+  /// it again. The imported instances and the dropped segments are not
+  /// recorded.
+  Expect<std::unique_ptr<Runtime::Instance::ModuleSnapshot>>
+  snapshotModule(const Runtime::Instance::ModuleInstance &ModInst);
+
+  /// Restore a module instance to its snapshot. The memories grown after the
+  /// snapshot are shrunk, and should not be accessed during the restoring.
+  Expect<void> restoreModule(Runtime::Instance::ModuleInstance &ModInst,
+                             const Runtime::Instance::ModuleSnapshot &Snapshot);
+
   /// Instantiate a Component into an anonymous component instance.
   Expect<std::unique_ptr<Runtime::Instance::ComponentInstance>>
   instantiateComponent(Runtime::StoreManager &StoreMgr,
@@ -198,6 +258,30 @@ public:
   Expect<void> registerPostHostFunction(void *HostData,
                                         std::function<void(void *)> HostFunc);
 
+  /// Register the function which will be invoked when a native wasm function
+  /// of the module instance becomes hot in the tiered JIT mode. The function
+  /// is invoked on the executing thread and may be invoked more than once.
+  Expect<void> registerTierUpFunction(
+      std::function<void(const Runtime::Instance::ModuleInstance &)> Func);
+
+  /// Register the function which will be invoked when the CPU time charged to
+  /// the entered module instance exceeds its budget. It is invoked on the
+  /// executing thread with the usage in nanoseconds at the samples of the CPU
+  /// accounting, and may deprioritize the thread, such as by sleeping or
+  /// lowering its priority, before returning. The execution is interrupted if
+  /// it returns false, or if no function is registered.
+  Expect<void> registerCpuSchedulerFunction(
+      std::function<bool(const Runtime::Instance::ModuleInstance &, uint64_t)>
+          Func);
+
+  /// Register the trace to record the host calls into, or to replay the host
+  /// calls from. The host calls are run as usual if the trace is nullptr.
+  Expect<void> registerHostCallTrace(std::shared_ptr<HostCallTrace> Trace);
+
+  /// Check the function instance and the parameter types before invoking.
+  Expect<void> checkInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
+                           Span<const ValType> ParamTypes) const;
+
   /// Invoke a WASM function by function instance.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   invoke(const Runtime::Instance::FunctionInstance *FuncInst,
@@ -214,13 +298,91 @@ public:
   asyncInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
               Span<const ValVariant> Params, Span<const ValType> ParamTypes);
 
+  /// Invoke a WASM function by function instance without checking the
+  /// arguments, for the callers which already checked the function type. The
+  /// counts of `Params` and `Returns` should match the function type, and the
+  /// results are written into `Returns` without allocating.
+  Expect<void>
+  invokeUnchecked(const Runtime::Instance::FunctionInstance &FuncInst,
+                  Span<const ValVariant> Params, Span<ValVariant> Returns);
+
+  /// Invoke a WASM function once for every row of a batch. The arguments and
+  /// the results are in the struct-of-arrays layout: every column is an array
+  /// of `Rows` values of its number type in the native layout, such as
+  /// `uint32_t` for i32 and `double` for f64. The function is resolved and
+  /// checked once for the whole batch. With `Threads` greater than 1, the rows
+  /// are split into shards executed concurrently on their own stacks, so the
+  /// function should not write the non-shared state of the instance.
+  Expect<void> invokeBatch(const Runtime::Instance::FunctionInstance *FuncInst,
+                           Span<const ValType> ParamTypes,
+                           Span<const void *const> Params,
+                           Span<void *const> Returns, uint32_t Rows,
+                           uint32_t Threads = 1);
+
   /// Stop execution
   void stop() noexcept {
     StopToken.store(1, std::memory_order_relaxed);
     atomicNotifyAll();
   }
 
+  /// Interrupt the executions once the global epoch advances by the ticks
+  /// from now. The deadline stays until it is set again, so the later
+  /// executions are also interrupted. UINT64_MAX for no deadline.
+  void setEpochDeadline(uint64_t Ticks) noexcept {
+    const uint64_t Now = Epoch::get();
+    EpochDeadline.store(Ticks > UINT64_MAX - Now ? UINT64_MAX : Now + Ticks,
+                        std::memory_order_relaxed);
+  }
+
 private:
+  /// Consume the stop token, and check the epoch deadline.
+  bool isInterrupted() noexcept {
+    if (unlikely(StopToken.load(std::memory_order_relaxed) != 0) &&
+        StopToken.exchange(0, std::memory_order_relaxed)) {
+      return true;
+    }
+    // Sample the CPU time when the epoch advanced.
+    if (unlikely(CpuAccounting) && CpuTime &&
+        CpuTime->LastEpoch != Epoch::get() && !checkCpuBudget()) {
+      return true;
+    }
+    return unlikely(Epoch::get() >=
+                    EpochDeadline.load(std::memory_order_relaxed));
+  }
+
+  /// Charge the CPU time of the execution on this thread since the last
+  /// sample, and check the budget. Returns false to interrupt the execution.
+  bool checkCpuBudget() noexcept;
+
+  /// Charge the instructions and their cost to the statistics batch of the
+  /// stack instead of the shared counters. The batch takes the cost from the
+  /// lease of the cost taken from the statistics, and takes a new lease after
+  /// using up it, so the limit is still checked at the exact instruction.
+  /// Returns false if the cost limit is exceeded.
+  bool chargeStatBatch(Runtime::StackManager &StackMgr, uint64_t InstrCount,
+                       uint64_t Cost) noexcept {
+    auto &Batch = StackMgr.getStatBatch();
+    Batch.InstrCount += InstrCount;
+    if (likely(Cost <= Batch.CostRoom)) {
+      Batch.Cost += Cost;
+      Batch.CostRoom -= Cost;
+      return true;
+    }
+    return chargeStatCost(StackMgr, Cost);
+  }
+
+  /// Charge the batch and the cost to the statistics, and take a new lease of
+  /// the cost. Returns false if the cost limit is exceeded.
+  bool chargeStatCost(Runtime::StackManager &StackMgr, uint64_t Cost) noexcept;
+
+  /// Return the cost of an instruction not executed to the batch.
+  bool refundStatBatch(Runtime::StackManager &StackMgr, uint64_t Cost) noexcept;
+
+  /// Charge the batch to the statistics and return the lease left, before
+  /// leaving the interpreter or calling the functions which read or charge
+  /// the statistics themselves.
+  void flushStatBatch(Runtime::StackManager &StackMgr) noexcept;
+
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StackManager &StackMgr,
                              AST::InstrView Instrs);
@@ -230,17 +392,40 @@ private:
                            const Runtime::Instance::FunctionInstance &Func,
                            Span<const ValVariant> Params);
 
+  /// Run Wasm function for the rows in [Begin, End) of a batch, until
+  /// failed or cancelled.
+  Expect<void> runBatch(Runtime::StackManager &StackMgr,
+                        const Runtime::Instance::FunctionInstance &Func,
+                        Span<const void *const> Params,
+                        Span<void *const> Returns, uint32_t Begin,
+                        uint32_t End, const std::atomic<bool> &Cancelled);
+
   /// Execute instructions.
   Expect<void> execute(Runtime::StackManager &StackMgr,
                        const AST::InstrView::iterator Start,
                        const AST::InstrView::iterator End);
 
+  /// Execute instructions without flushing the statistics batch. Only holds
+  /// the trivially destructible objects, as the faults of the guarded
+  /// execution jump over it.
+  Expect<void> executeInstrs(Runtime::StackManager &StackMgr,
+                             const AST::InstrView::iterator Start,
+                             const AST::InstrView::iterator End);
+
+  /// Execute instructions with a fault handler which turns the fault on the
+  /// guard region of the fixed-capacity value stack into the stack overflow
+  /// error.
+  Expect<void> executeGuarded(Runtime::StackManager &StackMgr,
+                              const AST::InstrView::iterator Start,
+                              const AST::InstrView::iterator End);
+
   /// \name Functions for instantiation.
   /// @{
   /// Instantiation of Module Instance.
   Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
   instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
-              std::optional<std::string_view> Name = std::nullopt);
+              std::optional<std::string_view> Name = std::nullopt,
+              const Runtime::Instance::ModulePrelink *Prelink = nullptr);
 
   /// Instantiation of Imports.
   Expect<void> instantiate(
@@ -249,6 +434,18 @@ private:
       Runtime::Instance::ModuleInstance &ModInst,
       const AST::ImportSection &ImportSec);
 
+  /// Resolve and type-check the imports against the types of the module.
+  Expect<void> resolveImports(
+      std::function<const Runtime::Instance::ModuleInstance *(std::string_view)>
+          ModuleFinder,
+      Span<const AST::SubType *const> TypeList,
+      const AST::ImportSection &ImportSec,
+      Runtime::Instance::ModulePrelink &Prelink);
+
+  /// Bind the resolved imports into the module instance.
+  void bindImports(Runtime::Instance::ModuleInstance &ModInst,
+                   const Runtime::Instance::ModulePrelink &Prelink);
+
   /// Instantiation of Function Instances.
   Expect<void> instantiate(Runtime::Instance::ModuleInstance &ModInst,
                            const AST::FunctionSection &FuncSec,
@@ -281,6 +478,10 @@ private:
   Expect<void> initTable(Runtime::StackManager &StackMgr,
                          const AST::ElementSection &ElemSec);
 
+  /// Check the active element segment is applied to the table lazily.
+  bool isLazyElemSeg(const Runtime::Instance::ModuleInstance &ModInst,
+                     const AST::ElementSegment &ElemSeg) const;
+
   /// Instantiation of Data Instances.
   Expect<void> instantiate(Runtime::StackManager &StackMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
@@ -290,6 +491,12 @@ private:
   Expect<void> initMemory(Runtime::StackManager &StackMgr,
                           const AST::DataSection &DataSec);
 
+  /// Initialize memory from the images recorded at the first instantiation
+  /// of the module, or initialize memory and record the images.
+  Expect<void> initMemoryImage(Runtime::StackManager &StackMgr,
+                               const Runtime::Instance::ModuleInstance &ModInst,
+                               const AST::Module &Mod);
+
   /// Instantiation of Exports.
   Expect<void> instantiate(Runtime::Instance::ModuleInstance &ModInst,
                            const AST::ExportSection &ExportSec);
@@ -367,16 +574,18 @@ private:
 
   /// \name Helper Functions for canonical ABI
   /// @{
-  std::vector<ValVariant>
-  convValsToCoreWASM(Span<const ComponentValVariant> Vals,
-                     Span<const ComponentValType> ValTypes,
-                     Runtime::Instance::FunctionInstance *RFuncInst,
-                     Runtime::Instance::MemoryInstance *MemInst) noexcept;
-
-  std::vector<std::pair<ComponentValVariant, ComponentValType>>
-  convValsToComponent(Span<const std::pair<ValVariant, ValType>> CoreVals,
-                      Span<const ComponentValType> ValTypes,
-                      Runtime::Instance::MemoryInstance *MemInst) noexcept;
+  /// Lower the component values into the core arguments by the adapter of
+  /// the lifted function.
+  Expect<void>
+  lowerCanonValues(const Runtime::Instance::Component::FunctionInstance &Func,
+                   Span<const ComponentValVariant> Vals,
+                   std::vector<ValVariant> &CoreArgs);
+
+  /// Lift the core returns into the component values by the adapter of the
+  /// lifted function.
+  Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
+  liftCanonValues(const Runtime::Instance::Component::FunctionInstance &Func,
+                  Span<const ValVariant> CoreRets);
   /// @}
 
   /// \name Helper Functions for block controls.
@@ -387,6 +596,20 @@ private:
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator RetIt, bool IsTailCall = false);
 
+  /// Helper function for entering a materialized native wasm function without
+  /// the checks of the function kinds. Return the start of the function body.
+  AST::InstrView::iterator
+  enterWasmFunction(Runtime::StackManager &StackMgr,
+                    const Runtime::Instance::FunctionInstance &Func,
+                    const AST::InstrView::iterator RetIt, bool IsTailCall);
+
+  /// Helper function for calling a host function through its fast call entry
+  /// from the compiled code. The arguments and the returns stay in the slots
+  /// of the compiled code, and no frame is pushed.
+  Expect<void> callFastHostFunc(Runtime::StackManager &StackMgr,
+                                const Runtime::Instance::FunctionInstance &Func,
+                                const ValVariant *Args, ValVariant *Rets);
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StackManager &StackMgr,
                              const AST::Instruction::JumpDescriptor &JumpDesc,
@@ -398,8 +621,43 @@ private:
                               AST::InstrView::iterator &PC) noexcept;
   /// @}
 
+  /// \name Helper Functions for stack switching.
+  /// @{
+  struct ContState;
+  /// Take the execution state of a continuation for resuming it.
+  Expect<std::unique_ptr<ContState>>
+  takeContState(const RefVariant &Ref,
+                const AST::Instruction &Instr) const noexcept;
+  /// Create a continuation instance of the type in the module instance.
+  Expect<RefVariant> contNew(const Runtime::Instance::ModuleInstance &ModInst,
+                             const uint32_t TypeIdx,
+                             std::unique_ptr<ContState> State,
+                             const AST::Instruction &Instr) const noexcept;
+  /// Run the function of the continuation on its fiber.
+  void runContinuation(ContState &State) noexcept;
+  /// Resume the continuation until it returns, and handle its suspensions
+  /// by the handlers of the resume instruction.
+  Expect<void> resumeContinuation(Runtime::StackManager &StackMgr,
+                                  std::unique_ptr<ContState> State,
+                                  const AST::Instruction &Instr,
+                                  AST::InstrView::iterator &PC) noexcept;
+  /// Suspend the running continuation to the innermost handler of the tag,
+  /// and take the values or the exception of the resumption.
+  Expect<void> suspendContinuation(Runtime::StackManager &StackMgr,
+                                   Runtime::Instance::TagInstance &TagInst,
+                                   std::vector<ValVariant> Values,
+                                   std::unique_ptr<ContState> SwitchTo,
+                                   const uint32_t SwitchTypeIdx,
+                                   const AST::Instruction &Instr,
+                                   AST::InstrView::iterator &PC) noexcept;
+  /// @}
+
   /// \name Helper Functions for GC instructions.
   /// @{
+  /// Collect the unreachable GC objects of the current module instance if
+  /// the allocated bytes since the last collection exceed the threshold.
+  /// Should only be called by the interpreter, before popping the operands.
+  void collectGarbage(Runtime::StackManager &StackMgr) const noexcept;
   Expect<RefVariant> structNew(Runtime::StackManager &StackMgr,
                                const uint32_t TypeIdx,
                                Span<const ValVariant> Args = {}) const noexcept;
@@ -448,14 +706,31 @@ private:
                          const uint32_t Cnt) const noexcept;
   /// @}
 
+  /// \name Helper Functions for memory accesses.
+  /// @{
+  /// Helper function for getting the address operand by the address type of
+  /// the memory.
+  static uint64_t
+  getAddress(const ValVariant &Val,
+             const Runtime::Instance::MemoryInstance &MemInst) noexcept {
+    return MemInst.is64() ? Val.get<uint64_t>() : Val.get<uint32_t>();
+  }
+  /// Helper function for calculating the effective address of the memory
+  /// instruction. Fail if the address overflows.
+  Expect<uint64_t>
+  getEffectiveAddress(const Runtime::Instance::MemoryInstance &MemInst,
+                      uint64_t Addr, uint32_t Length,
+                      const AST::Instruction &Instr) const noexcept;
+  /// @}
+
   /// \name Helper Functions for atomic operations.
   /// @{
   template <typename T>
   Expect<uint32_t> atomicWait(Runtime::Instance::MemoryInstance &MemInst,
-                              uint32_t Address, EndianValue<T> Expected,
+                              uint64_t Address, EndianValue<T> Expected,
                               int64_t Timeout) noexcept;
   Expect<uint32_t> atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
-                                uint32_t Address, uint32_t Count) noexcept;
+                                uint64_t Address, uint32_t Count) noexcept;
   void atomicNotifyAll() noexcept;
   /// @}
 
@@ -479,6 +754,11 @@ private:
   const ValType &getArrayStorageTypeByIdx(Runtime::StackManager &StackMgr,
                                           const uint32_t Idx) const noexcept;
 
+  /// Helper function for getting function type of continuation type by index.
+  const AST::FunctionType &
+  getContFuncTypeByIdx(Runtime::StackManager &StackMgr,
+                       const uint32_t Idx) const noexcept;
+
   /// Helper function for getting function instance by index.
   Runtime::Instance::FunctionInstance *
   getFuncInstByIdx(Runtime::StackManager &StackMgr, const uint32_t Idx) const;
@@ -507,6 +787,32 @@ private:
   Runtime::Instance::DataInstance *
   getDataInstByIdx(Runtime::StackManager &StackMgr, const uint32_t Idx) const;
 
+  /// Helper function for getting the function of an indirect call at the
+  /// in-bound table index and checking its type, cached in the stack manager.
+  Expect<const Runtime::Instance::FunctionInstance *>
+  getIndirectCallFunc(Runtime::StackManager &StackMgr,
+                      const Runtime::Instance::TableInstance &TabInst,
+                      const uint32_t TypeIdx,
+                      const uint32_t Idx) const noexcept;
+
+  /// Helper function for getting the canonical types of the defined types of a
+  /// module instance, which are assigned at the first call.
+  static Span<const Runtime::CanonicalType *const>
+  getCanonicalTypes(const Runtime::Instance::ModuleInstance &ModInst) noexcept;
+
+  /// Helper function for matching 2 defined types of the module instances,
+  /// which is constant time for the canonicalized types.
+  static bool
+  matchDefinedType(const Runtime::Instance::ModuleInstance &ExpModInst,
+                   uint32_t ExpIdx,
+                   const Runtime::Instance::ModuleInstance &GotModInst,
+                   uint32_t GotIdx) noexcept;
+
+  /// Helper function for matching the type of a reference to the expected
+  /// type in the module instance, for the cast instructions.
+  static bool matchRefType(const Runtime::Instance::ModuleInstance &ModInst,
+                           const ValType &Exp, const RefVariant &Ref) noexcept;
+
   /// Helper function for converting into bottom abstract heap type.
   TypeCode toBottomType(Runtime::StackManager &StackMgr,
                         const ValType &Type) const;
@@ -571,20 +877,38 @@ private:
                                  const AST::Instruction &Instr,
                                  AST::InstrView::iterator &PC,
                                  bool IsTailCall = false) noexcept;
-  Expect<void> runTryTableOp(Runtime::StackManager &StackMgr,
-                             const AST::Instruction &Instr,
-                             AST::InstrView::iterator &PC) noexcept;
+  /// ======= Stack switching instructions =======
+  Expect<void> runContNewOp(Runtime::StackManager &StackMgr,
+                            const AST::Instruction &Instr) noexcept;
+  Expect<void> runContBindOp(Runtime::StackManager &StackMgr,
+                             const AST::Instruction &Instr) noexcept;
+  Expect<void> runSuspendOp(Runtime::StackManager &StackMgr,
+                            const AST::Instruction &Instr,
+                            AST::InstrView::iterator &PC) noexcept;
+  Expect<void> runResumeOp(Runtime::StackManager &StackMgr,
+                           const AST::Instruction &Instr,
+                           AST::InstrView::iterator &PC) noexcept;
+  Expect<void> runSwitchOp(Runtime::StackManager &StackMgr,
+                           const AST::Instruction &Instr,
+                           AST::InstrView::iterator &PC) noexcept;
   /// ======= Variable instructions =======
   Expect<void> runLocalGetOp(Runtime::StackManager &StackMgr,
-                             uint32_t StackOffset) const noexcept;
+                             uint32_t StackOffset,
+                             uint32_t ValueSize = 0) const noexcept;
   Expect<void> runLocalSetOp(Runtime::StackManager &StackMgr,
-                             uint32_t StackOffset) const noexcept;
+                             uint32_t StackOffset,
+                             uint32_t ValueSize = 0) const noexcept;
   Expect<void> runLocalTeeOp(Runtime::StackManager &StackMgr,
-                             uint32_t StackOffset) const noexcept;
-  Expect<void> runGlobalGetOp(Runtime::StackManager &StackMgr,
-                              uint32_t Idx) const noexcept;
-  Expect<void> runGlobalSetOp(Runtime::StackManager &StackMgr,
-                              uint32_t Idx) const noexcept;
+                             uint32_t StackOffset,
+                             uint32_t ValueSize = 0) const noexcept;
+  Expect<void> runGlobalGetOp(Runtime::StackManager &StackMgr, uint32_t Idx,
+                              uint32_t ValueSize = 0) const noexcept;
+  Expect<void> runGlobalSetOp(Runtime::StackManager &StackMgr, uint32_t Idx,
+                              uint32_t ValueSize = 0) const noexcept;
+  /// ======= Super-instructions =======
+  Expect<void> runSuperInstrOp(Runtime::StackManager &StackMgr,
+                               const AST::Instruction &Instr,
+                               AST::InstrView::iterator &PC) const noexcept;
   /// ======= Reference instructions =======
   Expect<void> runRefNullOp(Runtime::StackManager &StackMgr,
                             const ValType &Type) const noexcept;
@@ -1088,6 +1412,23 @@ private:
     std::atomic_uint64_t *Gas;
     uint64_t GasLimit;
     std::atomic_uint32_t *StopToken;
+    const std::atomic_uint64_t *Epoch;
+    const std::atomic_uint64_t *EpochDeadline;
+    Runtime::Instance::TagInstance *const *Tags;
+    const Runtime::Instance::TagInstance **ExceptionTag;
+    ValVariant *ExceptionValues;
+    Runtime::Instance::TableInstance::NativeTable *const *Tables;
+    const uint64_t *TypeIds;
+    ValVariant *GlobalValues;
+    const uint64_t *const *MemorySizes;
+  };
+
+  /// Exception propagated between the compiled functions. The compiled
+  /// functions return with the tag set if the exception is not caught, and
+  /// the callers dispatch it to their handlers.
+  struct CompiledExceptionStruct {
+    const Runtime::Instance::TagInstance *Tag = nullptr;
+    std::array<ValVariant, Executable::kMaxExceptionValues> Values;
   };
 
   /// Restores thread local VM reference after overwriting it.
@@ -1103,38 +1444,223 @@ private:
     Executor *SavedThis;
     Runtime::StackManager *SavedCurrentStack;
     ExecutionContextStruct SavedExecutionContext;
+    /// Rights of the protection keys of the striped memories.
+    uint32_t SavedRights = 0;
+  };
+
+  /// Stack of an execution on this thread, linked to the stack of the outer
+  /// execution. The stacks are the roots of the garbage collection.
+  struct ActiveStackScope {
+    ActiveStackScope(const Runtime::StackManager &StackMgr) noexcept
+        : Stack(StackMgr), Prev(std::exchange(ActiveStack, this)) {}
+    ~ActiveStackScope() noexcept { ActiveStack = Prev; }
+    ActiveStackScope(const ActiveStackScope &) = delete;
+    ActiveStackScope &operator=(const ActiveStackScope &) = delete;
+
+    const Runtime::StackManager &Stack;
+    const ActiveStackScope *Prev;
+  };
+
+  /// CPU time accounting of an execution on this thread, linked to the
+  /// accounting of the outer execution, which is paused meanwhile.
+  struct CpuTimeScope {
+    CpuTimeScope(const Runtime::Instance::ModuleInstance *ModInst) noexcept;
+    ~CpuTimeScope() noexcept;
+    CpuTimeScope(const CpuTimeScope &) = delete;
+    CpuTimeScope &operator=(const CpuTimeScope &) = delete;
+
+    /// Charge the CPU time since the last sample, and return the usage.
+    uint64_t sample() noexcept;
+    /// Restart from now without charging, such as on another thread.
+    void restart() noexcept;
+
+    const Runtime::Instance::ModuleInstance *Module;
+    CpuTimeScope *Prev;
+    uint64_t Last = 0;
+    uint64_t LastEpoch = 0;
+  };
+
+  /// Execution state of a continuation, which runs on its own value stack
+  /// and fiber. Switching between the continuations swaps the fibers without
+  /// copying the stacks.
+  struct ContState final : public Runtime::Instance::ContInstance::State {
+    /// Reason of the last return from the fiber.
+    enum class Event : uint8_t { Return, Suspend, Switch, Throw, Trap };
+
+    /// The value stack is configured as the stacks of the executions, with
+    /// the fixed capacity of `ValueStackSize` entries if not 0.
+    ContState(const Runtime::Instance::FunctionInstance &F,
+              uint32_t ValueStackSize) noexcept
+        : Stack(ValueStackSize), Func(&F) {}
+
+    /// Releasing the stack of a suspended fiber would leak the objects alive
+    /// on it, so the fiber is resumed to fail at its suspension and unwind
+    /// before destroying. As resuming, it must be done on the same thread.
+    ~ContState() noexcept override {
+      if (Fib && !Fib->done()) {
+        Cancelled = true;
+        Fib->resume();
+      }
+    }
+
+    Runtime::StackManager Stack;
+    /// Fiber created at the first resumption.
+    std::unique_ptr<Fiber> Fib;
+    /// Function to run at the first resumption, nullptr after started.
+    const Runtime::Instance::FunctionInstance *Func;
+    /// The resumer while running: the state of the continuation running the
+    /// resume instruction or nullptr, its stacks, and the instruction with the
+    /// handlers in its module instance.
+    ContState *Parent = nullptr;
+    const ActiveStackScope *ResumerStack = nullptr;
+    /// The continuation resumed by this one, until it returns to this one.
+    ContState *Child = nullptr;
+    const Runtime::Instance::ModuleInstance *HandlerModule = nullptr;
+    const AST::Instruction *Handler = nullptr;
+    /// The event of the last return, with the tag, the state whose resumer
+    /// handles it, and the index of the handler. The switch event also takes
+    /// the target, and the type of the switching continuation.
+    Event Ev = Event::Return;
+    Runtime::Instance::TagInstance *Tag = nullptr;
+    ContState *Target = nullptr;
+    uint32_t HandlerIdx = 0;
+    std::unique_ptr<ContState> SwitchTo;
+    const Runtime::Instance::ModuleInstance *SwitchModule = nullptr;
+    uint32_t SwitchTypeIdx = 0;
+    ErrCode Err;
+    /// Exception thrown at the suspension by resume_throw.
+    Runtime::Instance::TagInstance *ThrowTag = nullptr;
+    /// Set when the suspended continuation is dropped, to unwind its fiber.
+    bool Cancelled = false;
+    /// The values passed in both directions: the arguments of the resumption,
+    /// and the results or the tag arguments of the return.
+    std::vector<ValVariant> Values;
+  };
+
+  /// Thread local states kept per fiber, for the executions suspended in the
+  /// host functions.
+  struct FiberLocal {
+    Executor *This;
+    Runtime::StackManager *CurrentStack;
+    const ActiveStackScope *ActiveStack;
+    ContState *CurrentCont;
+    CpuTimeScope *CpuTime;
+    ExecutionContextStruct ExecutionContext;
+    CompiledExceptionStruct CompiledException;
+    std::array<uint32_t, 256> StackTrace;
+    size_t StackTraceSize;
   };
+  static void swapFiberLocal(void *Storage) noexcept;
+  static const bool FiberLocalRegistered;
 
   /// Pointer to current object.
   static thread_local Executor *This;
   /// Stack for passing into compiled functions
   static thread_local Runtime::StackManager *CurrentStack;
+  /// Innermost execution stack on this thread
+  static thread_local const ActiveStackScope *ActiveStack;
+  /// Continuation running on this fiber
+  static thread_local ContState *CurrentCont;
+  /// Innermost CPU time accounting on this thread
+  static thread_local CpuTimeScope *CpuTime;
   /// Execution context for compiled functions
   static thread_local ExecutionContextStruct ExecutionContext;
+  /// Pending exception of compiled functions
+  static thread_local CompiledExceptionStruct CompiledException;
   /// Record stack track on error
   static thread_local std::array<uint32_t, 256> StackTrace;
   static thread_local size_t StackTraceSize;
 
-  /// Waiter struct for atomic instructions
+  /// Waiter struct for atomic instructions, linked in the waiter shard of the
+  /// address until woken up.
   struct Waiter {
+    /// Wake-up states of the waiter.
+    enum : uint32_t { Waiting = 0, Notified = 1, Interrupted = 2 };
+    Waiter(Runtime::Instance::MemoryInstance *Inst, uint64_t Addr) noexcept
+        : MemInst(Inst), Address(Addr) {}
+    Runtime::Instance::MemoryInstance *MemInst;
+    uint64_t Address;
+    /// Wake-up state, which is also the futex word on Linux.
+    std::atomic<uint32_t> State = Waiting;
+    Waiter *Prev = nullptr;
+    Waiter *Next = nullptr;
+    bool Linked = false;
+  };
+  /// Shard of the waiters, which are queued in order by the addresses hashed
+  /// into the shard.
+  struct alignas(64) WaiterShard {
     std::mutex Mutex;
+    /// Condition variable of the waiters without futex.
     std::condition_variable Cond;
-    Runtime::Instance::MemoryInstance *MemInst;
-    Waiter(Runtime::Instance::MemoryInstance *Inst) noexcept : MemInst(Inst) {}
+    Waiter *Head = nullptr;
+    Waiter *Tail = nullptr;
+    /// Count of the linked waiters, for notifying without the lock.
+    std::atomic<uint32_t> Count = 0;
+
+    /// Link and unlink the waiter. Should be called with the lock held.
+    void link(Waiter &W) noexcept {
+      W.Prev = Tail;
+      W.Next = nullptr;
+      (Tail ? Tail->Next : Head) = &W;
+      Tail = &W;
+      W.Linked = true;
+      Count.fetch_add(1);
+    }
+    void unlink(Waiter &W) noexcept {
+      (W.Prev ? W.Prev->Next : Head) = W.Next;
+      (W.Next ? W.Next->Prev : Tail) = W.Prev;
+      W.Linked = false;
+      Count.fetch_sub(1, std::memory_order_relaxed);
+    }
   };
-  /// Waiter map mutex
-  std::mutex WaiterMapMutex;
-  /// Waiter multimap
-  std::unordered_multimap<uint32_t, Waiter> WaiterMap;
+  static inline constexpr uint32_t WaiterShardNum = 64;
+  /// Getter of the waiter shard of the address.
+  WaiterShard &getWaiterShard(const Runtime::Instance::MemoryInstance &MemInst,
+                              uint64_t Address) noexcept {
+    const auto Key = (reinterpret_cast<uintptr_t>(&MemInst) >> 6) ^
+                     (static_cast<uintptr_t>(Address) >> 2);
+    return WaiterShards[Key % WaiterShardNum];
+  }
+  /// Sleep until the waiter is woken up or the deadline if not null. Should
+  /// be called with the lock of the shard held, which is released during
+  /// sleeping.
+  static void
+  parkWaiter(WaiterShard &Shard, std::unique_lock<std::mutex> &Lock, Waiter &W,
+             const std::chrono::steady_clock::time_point *Until) noexcept;
+  /// Wake up the waiter with the state. Should be called with the lock of the
+  /// shard held, so that the waiter is alive.
+  static void unparkWaiter(WaiterShard &Shard, Waiter &W,
+                           uint32_t State) noexcept;
+  /// Waiter shards
+  std::array<WaiterShard, WaiterShardNum> WaiterShards;
 
   /// WasmEdge configuration
   const Configure Conf;
   /// Executor statistics
   Statistics::Statistics *Stat;
+  /// Execution profile recorded by the interpreter, or nullptr if disabled.
+  Statistics::Profile *Prof = nullptr;
   /// Stop Execution
   std::atomic_uint32_t StopToken = 0;
+  /// Epoch deadline of the executions.
+  std::atomic_uint64_t EpochDeadline = UINT64_MAX;
   /// Executor Host Function Handler
   HostFuncHandler HostFuncHelper = {};
+  /// Trace to record or replay the host calls.
+  std::shared_ptr<HostCallTrace> HostTrace;
+  /// Rely on the guard region for the bounds checks of the interpreter.
+  bool GuardRegion = false;
+  /// \name Tiered JIT mode. The threshold is 0 if the mode is disabled.
+  /// @{
+  uint32_t TierUpThreshold = 0;
+  std::function<void(const Runtime::Instance::ModuleInstance &)> TierUpFunc;
+  /// @}
+  /// \name CPU time accounting.
+  /// @{
+  bool CpuAccounting = false;
+  std::function<bool(const Runtime::Instance::ModuleInstance &, uint64_t)>
+      CpuSchedulerFunc;
+  /// @}
 };
 
 } // namespace Executor
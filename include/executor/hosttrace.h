@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/executor/hosttrace.h - Host call trace definition --------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the host call trace, which records the
+/// results of the host calls and replays them without running the hosts.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "runtime/callingframe.h"
+#include "runtime/instance/function.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+/// Trace of the host calls for the reproducible benchmarks. In the record
+/// mode, the host calls run as usual, and their names, results, returns, and
+/// writes to the memories of the calling module are appended to the trace
+/// file. In the replay mode, the host calls are satisfied from the trace in
+/// order without running the hosts, so the executions are reproduced without
+/// the real I/O, clocks, and randomness.
+///
+/// Only the outermost host calls of a thread are traced, as the executions
+/// nested in them are covered by their writes. The writes are found by
+/// comparing the memories with their copies before the calls, so recording is
+/// slow for the large memories, and the memories should not be written by the
+/// other threads meanwhile.
+class HostCallTrace {
+public:
+  enum class Mode : uint8_t { Record, Replay };
+
+  /// Create the trace file to record, or read the whole trace file to replay.
+  /// Return nullptr on failure.
+  static std::unique_ptr<HostCallTrace> open(const std::filesystem::path &Path,
+                                             Mode M) noexcept;
+
+  Mode getMode() const noexcept { return TraceMode; }
+
+  /// Run the host call by `Run` and record it, or replay it from the trace.
+  template <typename RunT>
+  Expect<void> call(const Runtime::Instance::FunctionInstance &Func,
+                    const Runtime::CallingFrame &Frame, Span<ValVariant> Rets,
+                    RunT &&Run) {
+    if (Depth > 0) {
+      return Run();
+    }
+    if (TraceMode == Mode::Replay) {
+      return replay(Func, Frame, Rets);
+    }
+    snapshot(Frame);
+    ++Depth;
+    Expect<void> Res = Run();
+    --Depth;
+    record(Func, Frame, Rets, Res);
+    return Res;
+  }
+
+private:
+  HostCallTrace(Mode M) noexcept : TraceMode(M) {}
+
+  /// Copy the memories of the calling module before the call.
+  void snapshot(const Runtime::CallingFrame &Frame) noexcept;
+  /// Append the call and the differences of the memories to the trace.
+  void record(const Runtime::Instance::FunctionInstance &Func,
+              const Runtime::CallingFrame &Frame, Span<const ValVariant> Rets,
+              const Expect<void> &Res) noexcept;
+  /// Apply the next call in the trace.
+  Expect<void> replay(const Runtime::Instance::FunctionInstance &Func,
+                      const Runtime::CallingFrame &Frame,
+                      Span<ValVariant> Rets) noexcept;
+  /// Get the name of the host function to check the calls in order.
+  const std::string &
+  getName(const Runtime::Instance::FunctionInstance &Func) noexcept;
+
+  /// Nesting depth of the traced host calls on this thread, which is kept per
+  /// fiber for the host calls suspended in the fibers.
+  static thread_local uint32_t Depth;
+  static void swapFiberLocal(void *Storage) noexcept;
+  static const bool FiberLocalRegistered;
+
+  const Mode TraceMode;
+  std::mutex Mutex;
+  std::unordered_map<const Runtime::Instance::FunctionInstance *, std::string>
+      Names;
+  /// Trace file and the copies of the memories in the record mode.
+  std::ofstream Output;
+  std::unordered_map<const Runtime::Instance::MemoryInstance *,
+                     std::vector<uint8_t>>
+      Copies;
+  /// Whole trace and the read position in the replay mode.
+  std::vector<uint8_t> Input;
+  size_t Cursor = 0;
+};
+
+} // namespace Executor
+} // namespace WasmEdge
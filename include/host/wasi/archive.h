@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "common/span.h"
+#include "host/wasi/error.h"
+#include "host/wasi/inode.h"
+#include "system/mmap.h"
+#include "wasi/api.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+/// Read-only directory tree indexed from an uncompressed tar image.
+///
+/// The file contents are served from the image directly, which is either
+/// mapped from a host file or provided in memory by the caller.
+class Archive {
+public:
+  struct Entry {
+    __wasi_filetype_t Type = __WASI_FILETYPE_DIRECTORY;
+    /// Offset of the file content in the image.
+    uint64_t Offset = 0;
+    uint64_t Size = 0;
+    __wasi_timestamp_t MTime = 0;
+    uint32_t Parent = 0;
+    /// Target of the symbolic link.
+    std::string Link;
+    /// Entries of the directory, sorted by name.
+    std::vector<std::pair<std::string, uint32_t>> Children;
+  };
+
+  /// Map the tar file of the host, and index it.
+  static WasiExpect<std::shared_ptr<const Archive>>
+  open(const std::filesystem::path &Path) noexcept;
+
+  /// Index the tar image in memory. The image must outlive the archive.
+  static WasiExpect<std::shared_ptr<const Archive>>
+  fromImage(Span<const uint8_t> Image) noexcept;
+
+  const Entry &entry(uint32_t Index) const noexcept { return Entries[Index]; }
+
+  /// Find the entry of the directory by name, or -1 if not found.
+  int64_t find(uint32_t Dir, std::string_view Name) const noexcept;
+
+  /// The content of the regular file.
+  Span<const uint8_t> content(const Entry &E) const noexcept {
+    return Image.subspan(E.Offset, E.Size);
+  }
+
+private:
+  Archive() noexcept = default;
+
+  WasiExpect<void> parse() noexcept;
+
+  /// Find the entry of the path, or -1 if not found.
+  int64_t resolve(std::string_view Path) const noexcept;
+
+  /// Find or create the entry of the path, creating the missing parents.
+  WasiExpect<uint32_t> emplace(std::string_view Path,
+                               __wasi_filetype_t Type) noexcept;
+
+  std::unique_ptr<MMap> Map;
+  Span<const uint8_t> Image;
+  /// The first entry is the root directory.
+  std::vector<Entry> Entries;
+};
+
+/// Opened file or directory of an archive, providing the read-only subset of
+/// the `INode` operations.
+class ArchiveNode {
+public:
+  ArchiveNode(std::shared_ptr<const Archive> A, uint32_t I) noexcept
+      : Image(std::move(A)), Index(I) {}
+  ArchiveNode(ArchiveNode &&RHS) noexcept
+      : Image(std::move(RHS.Image)), Index(RHS.Index),
+        Offset(RHS.Offset.load(std::memory_order_relaxed)) {}
+
+  static ArchiveNode root(std::shared_ptr<const Archive> A) noexcept {
+    return ArchiveNode(std::move(A), 0);
+  }
+
+  WasiExpect<void> fdFdstatGet(__wasi_fdstat_t &FdStat) const noexcept;
+
+  WasiExpect<void> fdFilestatGet(__wasi_filestat_t &Filestat) const noexcept;
+
+  WasiExpect<void> fdPread(Span<Span<uint8_t>> IOVs, __wasi_filesize_t Offset,
+                           __wasi_size_t &NRead) const noexcept;
+
+  WasiExpect<void> fdRead(Span<Span<uint8_t>> IOVs,
+                          __wasi_size_t &NRead) noexcept;
+
+  WasiExpect<void> fdReaddir(Span<uint8_t> Buffer, __wasi_dircookie_t Cookie,
+                             __wasi_size_t &Size) const noexcept;
+
+  WasiExpect<void> fdSeek(__wasi_filedelta_t Offset, __wasi_whence_t Whence,
+                          __wasi_filesize_t &Size) noexcept;
+
+  WasiExpect<void> fdTell(__wasi_filesize_t &Size) const noexcept;
+
+  /// Write the content from the current offset to the host file.
+  WasiExpect<void> fdSendfile(const INode &Out, __wasi_filesize_t Count,
+                              __wasi_filesize_t &NWritten) noexcept;
+
+  /// @param[in] Path Path, contains one element only.
+  WasiExpect<void> pathFilestatGet(std::string_view Path,
+                                   __wasi_filestat_t &Filestat) const noexcept;
+
+  /// @param[in] Path Path, contains one element only.
+  WasiExpect<ArchiveNode> pathOpen(std::string_view Path,
+                                   __wasi_oflags_t OpenFlags) const noexcept;
+
+  /// @param[in] Path Path, contains one element only.
+  WasiExpect<void> pathReadlink(std::string_view Path, Span<char> Buffer,
+                                __wasi_size_t &NRead) const noexcept;
+
+  bool isDirectory() const noexcept {
+    return entry().Type == __WASI_FILETYPE_DIRECTORY;
+  }
+
+  bool isSymlink() const noexcept {
+    return entry().Type == __WASI_FILETYPE_SYMBOLIC_LINK;
+  }
+
+private:
+  const Archive::Entry &entry() const noexcept { return Image->entry(Index); }
+
+  /// Find the entry of the path, which is "." or a name in this directory.
+  WasiExpect<uint32_t> lookup(std::string_view Path) const noexcept;
+
+  void stat(uint32_t I, __wasi_filestat_t &Filestat) const noexcept;
+
+  /// Copy the content from the offset, and return the copied size.
+  __wasi_size_t copy(Span<Span<uint8_t>> IOVs,
+                     __wasi_filesize_t Offset) const noexcept;
+
+  std::shared_ptr<const Archive> Image;
+  uint32_t Index;
+  std::atomic<__wasi_filesize_t> Offset = 0;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
@@ -10,6 +10,9 @@
 #include "common/types.h"
 #include "host/wasi/clock.h"
 #include "host/wasi/error.h"
+#include "host/wasi/eventloop.h"
+#include "host/wasi/fdtable.h"
+#include "host/wasi/iostatistics.h"
 #include "host/wasi/vfs.h"
 #include "host/wasi/vinode.h"
 #include "wasi/api.hpp"
@@ -23,7 +26,6 @@
 #include <shared_mutex>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -33,6 +35,8 @@ namespace WASI {
 
 inline namespace detail {
 inline constexpr const int32_t kIOVMax = 1024;
+// Maximum number of datagrams of a batched socket I/O.
+inline constexpr const uint32_t kMmsgMax = 64;
 // Large enough to store SaData in sockaddr_in6
 // = sizeof(sockaddr_in6) - sizeof(sockaddr_in6::sin6_family)
 inline constexpr const int32_t kMaxSaDataLen = 26;
@@ -53,6 +57,18 @@ struct WasiAddrStorage {
 };
 static_assert(sizeof(WasiAddrStorage) == 128, "wrong size");
 
+/// Guest layout of a datagram of the batched socket I/O extensions,
+/// `sock_recv_mmsg` and `sock_send_mmsg`.
+struct WasiMmsgHdr {
+  uint32_t IOVs;    ///< Pointer to the `__wasi_iovec_t` array.
+  uint32_t IOVsLen; ///< Length of the `__wasi_iovec_t` array.
+  uint32_t Address; ///< Pointer to a `WasiAddrStorage`, or 0 for none.
+  uint16_t Port;    ///< Port of the peer.
+  uint16_t RoFlags; ///< `__wasi_roflags_t` of the received datagram.
+  uint32_t DataLen; ///< Number of bytes transferred.
+};
+static_assert(sizeof(WasiMmsgHdr) == 20, "wrong size");
+
 class EVPoller;
 class Environ : public PollerContext {
 public:
@@ -69,6 +85,19 @@ public:
 
   void fini() noexcept;
 
+  /// Cache the path resolution of the pre-opened directories bound later.
+  void setEnablePathCache(bool IsEnable) noexcept {
+    EnablePathCache = IsEnable;
+  }
+
+  /// Set SO_REUSEPORT on the bound internet sockets, for sharing the
+  /// listening port among the worker processes running the same module.
+  void setEnableReusePort(bool IsEnable) noexcept { ReusePort = IsEnable; }
+
+  /// I/O statistics of the calls to this environment.
+  IOStatistics &getIOStatistics() noexcept { return IOStats; }
+  const IOStatistics &getIOStatistics() const noexcept { return IOStats; }
+
   WasiExpect<void> getAddrInfo(std::string_view Node, std::string_view Service,
                                const __wasi_addrinfo_t &Hint,
                                uint32_t MaxResLength,
@@ -229,7 +258,7 @@ public:
   WasiExpect<void> fdAdvise(__wasi_fd_t Fd, __wasi_filesize_t Offset,
                             __wasi_filesize_t Len,
                             __wasi_advice_t Advice) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -245,7 +274,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdAllocate(__wasi_fd_t Fd, __wasi_filesize_t Offset,
                               __wasi_filesize_t Len) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -258,12 +287,10 @@ public:
   ///
   /// @return Nothing or WASI error
   WasiExpect<void> fdClose(__wasi_fd_t Fd) noexcept {
-    std::unique_lock Lock(FdMutex);
-    if (auto It = FdMap.find(Fd); It == FdMap.end()) {
+    if (auto Node = Fds.erase(Fd); unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     } else {
-      close(It->second);
-      FdMap.erase(It);
+      close(std::move(Node));
       return {};
     }
   }
@@ -274,7 +301,7 @@ public:
   ///
   /// @return Nothing or WASI error
   WasiExpect<void> fdDatasync(__wasi_fd_t Fd) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -290,7 +317,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdFdstatGet(__wasi_fd_t Fd,
                                __wasi_fdstat_t &FdStat) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -305,7 +332,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdFdstatSetFlags(__wasi_fd_t Fd,
                                     __wasi_fdflags_t FdFlags) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -323,7 +350,7 @@ public:
   WasiExpect<void>
   fdFdstatSetRights(__wasi_fd_t Fd, __wasi_rights_t FsRightsBase,
                     __wasi_rights_t FsRightsInheriting) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -336,7 +363,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdFilestatGet(__wasi_fd_t Fd,
                                  __wasi_filestat_t &Filestat) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -352,7 +379,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdFilestatSetSize(__wasi_fd_t Fd,
                                      __wasi_filesize_t Size) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -371,7 +398,7 @@ public:
   fdFilestatSetTimes(__wasi_fd_t Fd, __wasi_timestamp_t ATim,
                      __wasi_timestamp_t MTim,
                      __wasi_fstflags_t FstFlags) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -390,11 +417,13 @@ public:
   WasiExpect<void> fdPread(__wasi_fd_t Fd, Span<Span<uint8_t>> IOVs,
                            __wasi_filesize_t Offset,
                            __wasi_size_t &NRead) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->fdPread(IOVs, Offset, NRead);
+    EXPECTED_TRY(Node->fdPread(IOVs, Offset, NRead));
+    IOStats.addBytesRead(NRead);
+    return {};
   }
 
   /// Return a description of the given preopened file descriptor.
@@ -403,7 +432,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdPrestatGet(__wasi_fd_t Fd,
                                 __wasi_prestat_t &PreStat) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -424,7 +453,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdPrestatDirName(__wasi_fd_t Fd,
                                     Span<uint8_t> Buffer) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -451,11 +480,13 @@ public:
   WasiExpect<void> fdPwrite(__wasi_fd_t Fd, Span<Span<const uint8_t>> IOVs,
                             __wasi_filesize_t Offset,
                             __wasi_size_t &NWritten) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->fdPwrite(IOVs, Offset, NWritten);
+    EXPECTED_TRY(Node->fdPwrite(IOVs, Offset, NWritten));
+    IOStats.addBytesWritten(NWritten);
+    return {};
   }
 
   /// Read from a file descriptor.
@@ -467,11 +498,13 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdRead(__wasi_fd_t Fd, Span<Span<uint8_t>> IOVs,
                           __wasi_size_t &NRead) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->fdRead(IOVs, NRead);
+    EXPECTED_TRY(Node->fdRead(IOVs, NRead));
+    IOStats.addBytesRead(NRead);
+    return {};
   }
 
   /// Read directory entries from a directory.
@@ -495,7 +528,7 @@ public:
   WasiExpect<void> fdReaddir(__wasi_fd_t Fd, Span<uint8_t> Buffer,
                              __wasi_dircookie_t Cookie,
                              __wasi_size_t &Size) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -517,20 +550,14 @@ public:
   /// @param[in] To The file descriptor to overwrite.
   /// @return Nothing or WASI error
   WasiExpect<void> fdRenumber(__wasi_fd_t Fd, __wasi_fd_t To) noexcept {
-    std::unique_lock Lock(FdMutex);
-    if (auto It = FdMap.find(Fd); It == FdMap.end()) {
+    auto Replaced = Fd != To ? getNodeOrNull(To) : nullptr;
+    if (unlikely(!Fds.renumber(Fd, To))) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
-    } else if (Fd == To) {
-      return {};
-    } else if (auto It2 = FdMap.find(To); It2 == FdMap.end()) {
-      return WasiUnexpect(__WASI_ERRNO_BADF);
-    } else {
-      FdMap.erase(It2);
-      auto Node = FdMap.extract(It);
-      Node.key() = To;
-      FdMap.insert(std::move(Node));
-      return {};
     }
+    if (Replaced) {
+      close(std::move(Replaced));
+    }
+    return {};
   }
 
   /// Move the offset of a file descriptor.
@@ -545,7 +572,7 @@ public:
   WasiExpect<void> fdSeek(__wasi_fd_t Fd, __wasi_filedelta_t Offset,
                           __wasi_whence_t Whence,
                           __wasi_filesize_t &Size) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -558,7 +585,7 @@ public:
   ///
   /// @return Nothing or WASI error
   WasiExpect<void> fdSync(__wasi_fd_t Fd) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -574,7 +601,7 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdTell(__wasi_fd_t Fd,
                           __wasi_filesize_t &Size) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -591,11 +618,38 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> fdWrite(__wasi_fd_t Fd, Span<Span<const uint8_t>> IOVs,
                            __wasi_size_t &NWritten) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->fdWrite(IOVs, NWritten);
+    EXPECTED_TRY(Node->fdWrite(IOVs, NWritten));
+    IOStats.addBytesWritten(NWritten);
+    return {};
+  }
+
+  /// Transfer data between file descriptors without copying through the
+  /// guest memory.
+  ///
+  /// Note: This is similar to `sendfile` in Linux.
+  ///
+  /// @param[in] InFd The file descriptor to read from.
+  /// @param[in] Count The maximum number of bytes to transfer.
+  /// @param[out] NWritten The number of bytes transferred.
+  /// @return Nothing or WASI error
+  WasiExpect<void> fdSendfile(__wasi_fd_t Fd, __wasi_fd_t InFd,
+                              __wasi_filesize_t Count,
+                              __wasi_filesize_t &NWritten) const noexcept {
+    auto Node = findNode(Fd);
+    if (unlikely(!Node)) {
+      return WasiUnexpect(__WASI_ERRNO_BADF);
+    }
+    auto InNode = findNode(InFd);
+    if (unlikely(!InNode)) {
+      return WasiUnexpect(__WASI_ERRNO_BADF);
+    }
+    EXPECTED_TRY(Node->fdSendfile(*InNode, Count, NWritten));
+    IOStats.addBytesWritten(NWritten);
+    return {};
   }
 
   /// Create a directory.
@@ -749,7 +803,7 @@ public:
                  VINode::pathOpen(std::move(Node), Path, LookupFlags, OpenFlags,
                                   FsRightsBase, FsRightsInheriting, FdFlags));
 
-    return generateRandomFdToNode(Node);
+    return insertNode(Node);
   }
 
   /// Read the contents of a symbolic link.
@@ -978,22 +1032,26 @@ public:
       Node = std::move(*Res);
     }
 
-    return generateRandomFdToNode(Node);
+    return insertNode(Node);
   }
 
   WasiExpect<void> sockBind(__wasi_fd_t Fd,
                             __wasi_address_family_t AddressFamily,
                             Span<const uint8_t> Address,
                             uint16_t Port) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
+    if (ReusePort && (AddressFamily == __WASI_ADDRESS_FAMILY_INET4 ||
+                      AddressFamily == __WASI_ADDRESS_FAMILY_INET6)) {
+      EXPECTED_TRY(Node->sockSetReusePort());
+    }
     return Node->sockBind(AddressFamily, Address, Port);
   }
 
   WasiExpect<void> sockListen(__wasi_fd_t Fd, int32_t Backlog) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1002,21 +1060,22 @@ public:
 
   WasiExpect<__wasi_fd_t> sockAccept(__wasi_fd_t Fd,
                                      __wasi_fdflags_t FdFlags) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
 
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_READ));
     EXPECTED_TRY(auto NewNode, Node->sockAccept(FdFlags));
 
-    return generateRandomFdToNode(NewNode);
+    return insertNode(NewNode);
   }
 
   WasiExpect<void> sockConnect(__wasi_fd_t Fd,
                                __wasi_address_family_t AddressFamily,
                                Span<const uint8_t> Address,
                                uint16_t Port) noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1036,11 +1095,14 @@ public:
   WasiExpect<void> sockRecv(__wasi_fd_t Fd, Span<Span<uint8_t>> RiData,
                             __wasi_riflags_t RiFlags, __wasi_size_t &NRead,
                             __wasi_roflags_t &RoFlags) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->sockRecv(RiData, RiFlags, NRead, RoFlags);
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_READ));
+    EXPECTED_TRY(Node->sockRecv(RiData, RiFlags, NRead, RoFlags));
+    IOStats.addBytesRead(NRead);
+    return {};
   }
 
   /// Receive a message from a socket.
@@ -1062,12 +1124,15 @@ public:
                                 Span<uint8_t> Address, uint16_t *PortPtr,
                                 __wasi_size_t &NRead,
                                 __wasi_roflags_t &RoFlags) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->sockRecvFrom(RiData, RiFlags, AddressFamilyPtr, Address,
-                              PortPtr, NRead, RoFlags);
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_READ));
+    EXPECTED_TRY(Node->sockRecvFrom(RiData, RiFlags, AddressFamilyPtr,
+                                    Address, PortPtr, NRead, RoFlags));
+    IOStats.addBytesRead(NRead);
+    return {};
   }
 
   /// Send a message on a socket.
@@ -1083,11 +1148,14 @@ public:
   WasiExpect<void> sockSend(__wasi_fd_t Fd, Span<Span<const uint8_t>> SiData,
                             __wasi_siflags_t SiFlags,
                             __wasi_size_t &NWritten) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->sockSend(SiData, SiFlags, NWritten);
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_WRITE));
+    EXPECTED_TRY(Node->sockSend(SiData, SiFlags, NWritten));
+    IOStats.addBytesWritten(NWritten);
+    return {};
   }
 
   /// Send a message on a socket.
@@ -1108,12 +1176,15 @@ public:
                               __wasi_address_family_t AddressFamily,
                               Span<const uint8_t> Address, uint16_t Port,
                               __wasi_size_t &NWritten) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
-    return Node->sockSendTo(SiData, SiFlags, AddressFamily, Address, Port,
-                            NWritten);
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_WRITE));
+    EXPECTED_TRY(Node->sockSendTo(SiData, SiFlags, AddressFamily, Address,
+                                  Port, NWritten));
+    IOStats.addBytesWritten(NWritten);
+    return {};
   }
 
   /// Shut down socket send and receive channels.
@@ -1124,18 +1195,64 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> sockShutdown(__wasi_fd_t Fd,
                                 __wasi_sdflags_t SdFlags) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
     return Node->sockShutdown(SdFlags);
   }
 
+  /// Receive a batch of datagrams from a socket.
+  ///
+  /// Note: This is similar to `recvmmsg` in Linux.
+  ///
+  /// @param[in,out] Msgs The datagrams to receive into.
+  /// @param[in] RiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams received.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockRecvMmsg(__wasi_fd_t Fd, Span<RecvMessage> Msgs,
+                                __wasi_riflags_t RiFlags,
+                                __wasi_size_t &NMsgs) const noexcept {
+    auto Node = findNode(Fd);
+    if (unlikely(!Node)) {
+      return WasiUnexpect(__WASI_ERRNO_BADF);
+    }
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_READ));
+    EXPECTED_TRY(Node->sockRecvMmsg(Msgs, RiFlags, NMsgs));
+    for (const auto &Msg : Msgs.first(NMsgs)) {
+      IOStats.addBytesRead(Msg.Size);
+    }
+    return {};
+  }
+
+  /// Send a batch of datagrams on a socket.
+  ///
+  /// Note: This is similar to `sendmmsg` in Linux.
+  ///
+  /// @param[in,out] Msgs The datagrams to send.
+  /// @param[in] SiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams sent.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockSendMmsg(__wasi_fd_t Fd, Span<SendMessage> Msgs,
+                                __wasi_siflags_t SiFlags,
+                                __wasi_size_t &NMsgs) const noexcept {
+    auto Node = findNode(Fd);
+    if (unlikely(!Node)) {
+      return WasiUnexpect(__WASI_ERRNO_BADF);
+    }
+    EXPECTED_TRY(park(*Node, __WASI_EVENTTYPE_FD_WRITE));
+    EXPECTED_TRY(Node->sockSendMmsg(Msgs, SiFlags, NMsgs));
+    for (const auto &Msg : Msgs.first(NMsgs)) {
+      IOStats.addBytesWritten(Msg.Size);
+    }
+    return {};
+  }
+
   WasiExpect<void> sockGetOpt(__wasi_fd_t Fd,
                               __wasi_sock_opt_level_t SockOptLevel,
                               __wasi_sock_opt_so_t SockOptName,
                               Span<uint8_t> &Flag) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1146,7 +1263,7 @@ public:
                               __wasi_sock_opt_level_t SockOptLevel,
                               __wasi_sock_opt_so_t SockOptName,
                               Span<const uint8_t> Flag) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1158,7 +1275,7 @@ public:
                                     __wasi_address_family_t *AddressFamilyPtr,
                                     Span<uint8_t> Address,
                                     uint16_t *PortPtr) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1170,7 +1287,7 @@ public:
                                    __wasi_address_family_t *AddressFamilyPtr,
                                    Span<uint8_t> Address,
                                    uint16_t *PortPtr) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1178,7 +1295,7 @@ public:
   }
 
   WasiExpect<uint64_t> getNativeHandler(__wasi_fd_t Fd) const noexcept {
-    auto Node = getNodeOrNull(Fd);
+    auto Node = findNode(Fd);
     if (unlikely(!Node)) {
       return WasiUnexpect(__WASI_ERRNO_BADF);
     }
@@ -1204,32 +1321,34 @@ private:
   std::vector<std::string> Arguments;
   std::vector<std::string> EnvironVariables;
   __wasi_exitcode_t ExitCode = 0;
+  bool EnablePathCache = false;
+  bool ReusePort = false;
+  mutable IOStatistics IOStats;
 
   mutable std::shared_mutex PollerMutex; ///< Protect PollerPool
   std::vector<EVPoller> PollerPool;
   friend class EVPoller;
 
-  mutable std::shared_mutex FdMutex; ///< Protect FdMap
-  std::unordered_map<__wasi_fd_t, std::shared_ptr<VINode>> FdMap;
+  FdTable Fds;
 
-  std::shared_ptr<VINode> getNodeOrNull(__wasi_fd_t Fd) const {
-    std::shared_lock Lock(FdMutex);
-    if (auto It = FdMap.find(Fd); It != FdMap.end()) {
-      return It->second;
-    }
-    return {};
+  FdTable::Ref findNode(__wasi_fd_t Fd) const noexcept { return Fds.find(Fd); }
+
+  std::shared_ptr<VINode> getNodeOrNull(__wasi_fd_t Fd) const noexcept {
+    return Fds.get(Fd);
   }
 
-  WasiExpect<__wasi_fd_t> generateRandomFdToNode(std::shared_ptr<VINode> Node) {
-    std::uniform_int_distribution<__wasi_fd_t> Distribution(0, 0x7FFFFFFF);
-    bool Success = false;
-    __wasi_fd_t NewFd;
-    while (!Success) {
-      NewFd = Distribution(Hash::RandEngine);
-      std::unique_lock Lock(FdMutex);
-      Success = FdMap.emplace(NewFd, Node).second;
+  WasiExpect<__wasi_fd_t> insertNode(std::shared_ptr<VINode> Node) noexcept {
+    return Fds.insert(std::move(Node));
+  }
+
+  /// Park the calling task until the event of the node is ready, if running
+  /// in an event loop, so that the blocking call does not block the thread.
+  static WasiExpect<void> park(VINode &Node,
+                               __wasi_eventtype_t Type) noexcept {
+    if (auto *Loop = EventLoop::current(); Loop) {
+      return Loop->wait(Node, Type);
     }
-    return NewFd;
+    return {};
   }
 };
 
@@ -1244,6 +1363,7 @@ public:
   using VPoller::prepare;
   using VPoller::reset;
   using VPoller::result;
+  using VPoller::useUring;
   using VPoller::VPoller;
   using VPoller::wait;
 
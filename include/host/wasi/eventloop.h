@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "host/wasi/error.h"
+#include "host/wasi/inode.h"
+#include "host/wasi/vinode.h"
+#include "system/fiber.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+/// Cooperative scheduler of the tasks blocked in the WASI socket calls.
+///
+/// The tasks run in fibers on the thread calling `run`. A socket call which
+/// would block parks its task instead, and the thread runs the other tasks
+/// until the socket is ready, so that a few threads can serve many guest
+/// instances.
+class EventLoop : public PollerContext {
+public:
+  explicit EventLoop(size_t StackSize = Fiber::kDefaultStackSize) noexcept;
+  EventLoop(const EventLoop &) = delete;
+  EventLoop &operator=(const EventLoop &) = delete;
+
+  /// Add a task, such as executing a guest instance. The function must not
+  /// throw.
+  ///
+  /// @return Nothing, or WASI error.
+  WasiExpect<void> spawn(std::function<void()> Func) noexcept;
+
+  /// Run the tasks on the calling thread until all of them finished.
+  ///
+  /// @return Nothing, or WASI error if failed to poll the parked tasks.
+  WasiExpect<void> run() noexcept;
+
+  /// The loop running the calling task, or nullptr if not called in a task.
+  static EventLoop *current() noexcept;
+
+  /// Park the calling task until the event of the node is ready. Return at
+  /// once if it is ready, or the node is non-blocking.
+  ///
+  /// @param[in] Node The node to wait for.
+  /// @param[in] Type `__WASI_EVENTTYPE_FD_READ` or `__WASI_EVENTTYPE_FD_WRITE`.
+  /// @return Nothing, or WASI error.
+  WasiExpect<void> wait(VINode &Node, __wasi_eventtype_t Type) noexcept;
+
+  /// Let the other ready tasks run before the calling task.
+  void yield() noexcept;
+
+private:
+  struct Task {
+    std::unique_ptr<Fiber> Context;
+    /// The node and the event the task is parked for.
+    std::shared_ptr<VINode> Node;
+    __wasi_eventtype_t Type = __WASI_EVENTTYPE_FD_READ;
+  };
+
+  /// Move the parked tasks of the ready events to the ready queue, blocking
+  /// only if no task is ready.
+  WasiExpect<void> poll() noexcept;
+
+  size_t StackSize;
+  std::vector<std::unique_ptr<Task>> Ready;
+  std::vector<std::unique_ptr<Task>> Parked;
+  Task *Running = nullptr;
+  VPoller Poller;
+  std::vector<__wasi_event_t> Events;
+  /// Index of the parked task subscribing the event for each parked task, for
+  /// the tasks waiting for the same event.
+  std::vector<size_t> Subscribers;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "host/wasi/error.h"
+#include "host/wasi/vinode.h"
+#include "wasi/api.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+/// Dense file descriptor table.
+///
+/// Lookups take no lock and do not touch the reference count of the nodes:
+/// the found entry is published in a hazard slot of the calling thread, and
+/// the writers, which are serialized by a mutex, only reclaim the removed
+/// entries not published by any thread. The entries left are reclaimed when
+/// the last reference to them is released, so a blocking call on a closed
+/// node keeps the node open until the call returns only.
+class FdTable {
+  struct Entry {
+    explicit Entry(std::shared_ptr<VINode> N) noexcept : Node(std::move(N)) {}
+    std::shared_ptr<VINode> Node;
+  };
+
+public:
+  /// Reference to a node found in the table. The node is kept alive until the
+  /// reference is destroyed, which must happen on the thread that found it.
+  class Ref {
+  public:
+    Ref() noexcept = default;
+    Ref(const Ref &) = delete;
+    Ref &operator=(const Ref &) = delete;
+    Ref(Ref &&R) noexcept
+        : Table(std::exchange(R.Table, nullptr)),
+          Slot(std::exchange(R.Slot, nullptr)),
+          Found(std::exchange(R.Found, nullptr)), Owner(std::move(R.Owner)) {}
+    Ref &operator=(Ref &&) = delete;
+    ~Ref() noexcept {
+      if (Slot) {
+        FdTable::releaseHazard(Slot);
+        // Pair with the store in `retire()`: either the writer sees the hazard
+        // released, or the entry is reclaimed here.
+        if (Table->Pending.load(std::memory_order_seq_cst)) {
+          Table->reclaim();
+        }
+      }
+    }
+
+    explicit operator bool() const noexcept { return get() != nullptr; }
+    VINode *get() const noexcept {
+      return Found ? Found->Node.get() : Owner.get();
+    }
+    VINode *operator->() const noexcept { return get(); }
+    VINode &operator*() const noexcept { return *get(); }
+
+    /// Share the ownership of the node.
+    std::shared_ptr<VINode> share() const noexcept {
+      return Found ? Found->Node : Owner;
+    }
+
+  private:
+    friend class FdTable;
+    const FdTable *Table = nullptr;
+    std::atomic<const void *> *Slot = nullptr;
+    const Entry *Found = nullptr;
+    /// Fallback when running out of the hazard slots of this thread.
+    std::shared_ptr<VINode> Owner;
+  };
+
+  FdTable() noexcept = default;
+  FdTable(const FdTable &) = delete;
+  FdTable &operator=(const FdTable &) = delete;
+  ~FdTable() noexcept;
+
+  /// Find the node of the file descriptor without locking.
+  Ref find(__wasi_fd_t Fd) const noexcept;
+
+  /// Find the node of the file descriptor and share its ownership.
+  std::shared_ptr<VINode> get(__wasi_fd_t Fd) const noexcept {
+    return find(Fd).share();
+  }
+
+  /// Place the node at the given file descriptor, replacing the existing one.
+  void emplace(__wasi_fd_t Fd, std::shared_ptr<VINode> Node) noexcept;
+
+  /// Place the node at the lowest free file descriptor.
+  WasiExpect<__wasi_fd_t> insert(std::shared_ptr<VINode> Node) noexcept;
+
+  /// Remove the file descriptor, and return its node if exists.
+  std::shared_ptr<VINode> erase(__wasi_fd_t Fd) noexcept;
+
+  /// Move the node of `Fd` to `To`, replacing the node of `To`. Return false
+  /// if any of them does not exist.
+  bool renumber(__wasi_fd_t Fd, __wasi_fd_t To) noexcept;
+
+  /// Remove all file descriptors.
+  void clear() noexcept;
+
+private:
+  static inline constexpr const uint32_t kSegmentBits = 10;
+  static inline constexpr const uint32_t kSegmentSize = 1U << kSegmentBits;
+  static inline constexpr const uint32_t kMaxSegments = 1024;
+  static inline constexpr const uint32_t kMaxFds = kSegmentSize * kMaxSegments;
+
+  struct Segment {
+    std::array<std::atomic<const Entry *>, kSegmentSize> Slots{};
+  };
+
+  static std::atomic<const void *> *acquireHazard() noexcept;
+  static void releaseHazard(std::atomic<const void *> *Slot) noexcept;
+
+  /// Slot of the file descriptor, allocating its segment if `Create` is set.
+  /// Must hold `Mutex` when `Create` is set.
+  std::atomic<const Entry *> *slot(__wasi_fd_t Fd, bool Create) const noexcept;
+  /// Take the ownership of the removed entry and reclaim the unpublished ones.
+  /// Must hold `Mutex`.
+  void retire(const Entry *E) noexcept;
+  /// Reclaim the retired entries not published by any thread. Must hold
+  /// `Mutex`.
+  void scan() const noexcept;
+  /// Lock and reclaim the retired entries, called on releasing a reference.
+  void reclaim() const noexcept;
+  /// Mark the file descriptor used. Must hold `Mutex`.
+  void reserve(__wasi_fd_t Fd) noexcept;
+
+  mutable std::array<std::atomic<Segment *>, kMaxSegments> Segments{};
+  mutable std::mutex Mutex; ///< Serialize the writers
+  /// Min-heap of the free file descriptors below `NextFd`.
+  std::vector<__wasi_fd_t> FreeFds;
+  __wasi_fd_t NextFd = 0;
+  mutable std::vector<std::unique_ptr<const Entry>> Retired;
+  /// Set while `Retired` is not empty.
+  mutable std::atomic<bool> Pending = false;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
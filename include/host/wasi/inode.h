@@ -9,6 +9,7 @@
 #include "common/types.h"
 #include "host/wasi/error.h"
 #include "host/wasi/vfs.h"
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <optional>
@@ -49,6 +50,31 @@ namespace WasmEdge {
 namespace Host {
 namespace WASI {
 
+/// A datagram received by the batched socket I/O.
+struct RecvMessage {
+  /// Scatter/gather vectors to store the data.
+  Span<Span<uint8_t>> Data;
+  /// Buffer to store the peer address, empty if not needed.
+  Span<uint8_t> Address;
+  __wasi_address_family_t AddressFamily = __WASI_ADDRESS_FAMILY_UNSPEC;
+  uint16_t Port = 0;
+  /// Number of bytes received.
+  __wasi_size_t Size = 0;
+  __wasi_roflags_t RoFlags = static_cast<__wasi_roflags_t>(0);
+};
+
+/// A datagram sent by the batched socket I/O.
+struct SendMessage {
+  /// Scatter/gather vectors to retrieve the data.
+  Span<Span<const uint8_t>> Data;
+  /// Address of the target, empty for the connected peer.
+  Span<const uint8_t> Address;
+  __wasi_address_family_t AddressFamily = __WASI_ADDRESS_FAMILY_UNSPEC;
+  uint16_t Port = 0;
+  /// Number of bytes sent.
+  __wasi_size_t Size = 0;
+};
+
 #if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
 struct FdHolder {
   FdHolder(const FdHolder &) = delete;
@@ -141,6 +167,62 @@ struct TimerHolder {
   }
   std::optional<timer_t> Id;
 };
+
+/// Holder of an io_uring instance and its mapped queues.
+struct UringHolder : public FdHolder {
+  UringHolder(const UringHolder &) = delete;
+  UringHolder &operator=(const UringHolder &) = delete;
+  UringHolder(UringHolder &&RHS) noexcept
+      : FdHolder(std::move(RHS)), Queues(std::exchange(RHS.Queues, {})) {}
+  UringHolder &operator=(UringHolder &&RHS) noexcept {
+    using std::swap;
+    FdHolder::operator=(std::move(RHS));
+    swap(Queues, RHS.Queues);
+    return *this;
+  }
+
+  UringHolder() noexcept = default;
+  ~UringHolder() noexcept { unmap(); }
+
+  /// Setup the io_uring instance with at least `Entries` submission entries.
+  WasiExpect<void> create(uint32_t Entries) noexcept;
+
+  /// Queue a one-shot poll of the events on the fd, submitting the queued
+  /// entries first if the submission queue is full.
+  WasiExpect<void> pollAdd(int PollFd, uint32_t Events,
+                           uint64_t UserData) noexcept;
+
+  /// Queue a removal of the poll queued with the user data.
+  WasiExpect<void> pollRemove(uint64_t UserData) noexcept;
+
+  /// Submit the queued entries and wait for at least `WaitNr` completions.
+  WasiExpect<void> submit(uint32_t WaitNr) noexcept;
+
+  /// Pop a completion. Return false if no completion is available.
+  bool pop(uint64_t &UserData, int32_t &Result) noexcept;
+
+  void unmap() noexcept;
+
+  struct QueueData {
+    void *SqRing = nullptr;
+    size_t SqRingSize = 0;
+    void *CqRing = nullptr;
+    size_t CqRingSize = 0;
+    void *Sqes = nullptr;
+    size_t SqesSize = 0;
+    uint32_t *SqHead = nullptr;
+    uint32_t *SqTail = nullptr;
+    uint32_t *SqArray = nullptr;
+    uint32_t SqMask = 0;
+    uint32_t SqEntries = 0;
+    uint32_t *CqHead = nullptr;
+    uint32_t *CqTail = nullptr;
+    void *Cqes = nullptr;
+    uint32_t CqMask = 0;
+    /// Queued but not submitted entries.
+    uint32_t Queued = 0;
+  } Queues;
+};
 #endif
 
 #if WASMEDGE_OS_WINDOWS
@@ -341,6 +423,9 @@ public:
   INode(INode &&RHS) noexcept = default;
   INode &operator=(INode &&RHS) noexcept = default;
 
+  /// Create an invalid node, for the nodes not backed by the host.
+  INode() noexcept = default;
+
   static INode stdIn() noexcept;
 
   static INode stdOut() noexcept;
@@ -531,6 +616,20 @@ public:
   WasiExpect<void> fdWrite(Span<Span<const uint8_t>> IOVs,
                            __wasi_size_t &NWritten) const noexcept;
 
+  /// Transfer data from another file descriptor without copying through the
+  /// guest memory.
+  ///
+  /// Note: This is similar to `sendfile` in Linux. The data is read from the
+  /// current offset of `In`, and both offsets are advanced by the bytes
+  /// transferred only.
+  ///
+  /// @param[in] In The file descriptor to read from.
+  /// @param[in] Count The maximum number of bytes to transfer.
+  /// @param[out] NWritten The number of bytes transferred.
+  /// @return Nothing or WASI error
+  WasiExpect<void> fdSendfile(const INode &In, __wasi_filesize_t Count,
+                              __wasi_filesize_t &NWritten) const noexcept;
+
   /// Get the native handler.
   ///
   /// Note: Users should cast this native handler to corresponding types
@@ -557,6 +656,21 @@ public:
   WasiExpect<void> pathFilestatGet(std::string Path,
                                    __wasi_filestat_t &Filestat) const noexcept;
 
+  /// Return the attributes of a file or directory, resolving every component
+  /// of the path beneath this directory in the kernel.
+  ///
+  /// Note: This is similar to `openat2` with `RESOLVE_BENEATH` and `fstat` in
+  /// Linux.
+  ///
+  /// @param[in] Path The relative path of the file or directory to inspect.
+  /// @param[in] Follow Follow the symbolic link of the last component.
+  /// @param[out] Filestat The buffer where the file's attributes are stored.
+  /// @return Nothing, NOSYS if the path should be resolved by the caller, or
+  /// WASI error
+  WasiExpect<void>
+  pathFilestatGetBeneath(std::string Path, bool Follow,
+                         __wasi_filestat_t &Filestat) const noexcept;
+
   /// Adjust the timestamps of a file or directory.
   ///
   /// Note: This is similar to `utimensat` in POSIX.
@@ -608,6 +722,23 @@ public:
                              __wasi_fdflags_t FdFlags,
                              VFS::Flags VFSFlags) const noexcept;
 
+  /// Open a file or directory, resolving every component of the path beneath
+  /// this directory in the kernel.
+  ///
+  /// Note: This is similar to `openat2` with `RESOLVE_BENEATH` in Linux.
+  ///
+  /// @param[in] Path The relative path of the file or directory to open.
+  /// @param[in] OpenFlags The method by which to open the file.
+  /// @param[in] FdFlags The method by which to open the file.
+  /// @param[in] VFSFlags The method by which to open the file.
+  /// @param[in] Follow Follow the symbolic link of the last component.
+  /// @return The file descriptor of the file that has been opened, NOSYS if
+  /// the path should be resolved by the caller, or WASI error.
+  WasiExpect<INode> pathOpenBeneath(std::string Path, __wasi_oflags_t OpenFlags,
+                                    __wasi_fdflags_t FdFlags,
+                                    VFS::Flags VFSFlags,
+                                    bool Follow) const noexcept;
+
   /// Read the contents of a symbolic link.
   ///
   /// Note: This is similar to `readlinkat` in POSIX.
@@ -682,6 +813,10 @@ public:
                             Span<const uint8_t> Address,
                             uint16_t Port) noexcept;
 
+  /// Let the sockets of the other processes bind the same address, so that
+  /// the worker processes share the listening port.
+  WasiExpect<void> sockSetReusePort() noexcept;
+
   WasiExpect<void> sockListen(int32_t Backlog) noexcept;
 
   WasiExpect<INode> sockAccept(__wasi_fdflags_t FdFlags) noexcept;
@@ -765,6 +900,33 @@ public:
   /// @return Nothing or WASI error
   WasiExpect<void> sockShutdown(__wasi_sdflags_t SdFlags) const noexcept;
 
+  /// Receive a batch of datagrams from a socket.
+  ///
+  /// Note: This is similar to `recvmmsg` in Linux. Wait for the first
+  /// datagram only, and return the ones already arrived after it. The peer
+  /// addresses which cannot be converted, such as the ones not fitting in
+  /// `Address`, are returned as unspecified.
+  ///
+  /// @param[in,out] Msgs The datagrams to receive into.
+  /// @param[in] RiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams received.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockRecvMmsg(Span<RecvMessage> Msgs,
+                                __wasi_riflags_t RiFlags,
+                                __wasi_size_t &NMsgs) const noexcept;
+
+  /// Send a batch of datagrams on a socket.
+  ///
+  /// Note: This is similar to `sendmmsg` in Linux.
+  ///
+  /// @param[in,out] Msgs The datagrams to send.
+  /// @param[in] SiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams sent.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockSendMmsg(Span<SendMessage> Msgs,
+                                __wasi_siflags_t SiFlags,
+                                __wasi_size_t &NMsgs) const noexcept;
+
   WasiExpect<void> sockGetOpt(__wasi_sock_opt_level_t SockOptLevel,
                               __wasi_sock_opt_so_t SockOptName,
                               Span<uint8_t> &Flag) const noexcept;
@@ -796,6 +958,12 @@ public:
   /// Check if current user has execute permission on this inode.
   bool canBrowse() const noexcept;
 
+  /// Check if the event of this inode is ready without blocking.
+  ///
+  /// @param[in] Type `__WASI_EVENTTYPE_FD_READ` or `__WASI_EVENTTYPE_FD_WRITE`.
+  /// @return Whether the event is ready, or WASI error.
+  WasiExpect<bool> isReady(__wasi_eventtype_t Type) const noexcept;
+
 private:
   friend class Poller;
 
@@ -806,6 +974,13 @@ public:
 private:
   mutable std::optional<struct stat> Stat;
 
+#if WASMEDGE_OS_LINUX
+  /// Serial number of the node, which tells the pollers apart the nodes
+  /// reusing the fd numbers and the addresses of the closed ones.
+  static inline std::atomic<uint64_t> NextSerial = 1;
+  uint64_t Serial = NextSerial.fetch_add(1, std::memory_order_relaxed);
+#endif
+
   DirHolder Dir;
 
   __wasi_filetype_t unsafeFiletype() const noexcept;
@@ -887,6 +1062,14 @@ public:
              __wasi_userdata_t UserData) noexcept;
 
   void close(const INode &Fd) noexcept;
+
+  /// Wait for the events with io_uring instead of epoll. The io_uring poller
+  /// submits the polls of all the subscribed fds in a batch. Fall back to
+  /// epoll if io_uring is not supported.
+  ///
+  /// @param[in] Enable Whether to use io_uring.
+  void useUring(bool Enable) noexcept;
+
   /// Concurrently poll for events.
   void wait() noexcept;
 
@@ -924,8 +1107,15 @@ private:
   struct FdData {
     OptionalEvent *ReadEvent = nullptr;
     OptionalEvent *WriteEvent = nullptr;
+#if WASMEDGE_OS_LINUX
+    const INode *Node = nullptr;
+    bool Edge = false;
+#endif
   };
   std::unordered_map<int, FdData> FdDatas;
+#endif
+
+#if WASMEDGE_OS_MACOS
   std::unordered_map<int, FdData> OldFdDatas;
 #endif
 
@@ -933,9 +1123,16 @@ private:
   struct SocketData {
     OptionalEvent *ReadEvent = nullptr;
     OptionalEvent *WriteEvent = nullptr;
+    /// Index of the socket in `PollFds`.
+    size_t Index = 0;
   };
   std::unordered_map<winapi::SOCKET_, SocketData> SocketDatas;
-  winapi::FD_SET_ ReadFds = {0, {}}, WriteFds = {0, {}};
+  /// The polled sockets, which are not limited by `FD_SETSIZE` as `select`.
+  std::vector<winapi::WSAPOLLFD_> PollFds;
+
+  /// Add the event of the socket to the polled sockets.
+  void subscribe(winapi::SOCKET_ Socket, OptionalEvent &Event,
+                 winapi::SHORT_ Flags) noexcept;
 #endif
 
 #if WASMEDGE_OS_LINUX
@@ -962,6 +1159,26 @@ private:
 
   std::vector<Timer> Timers;
   std::vector<struct epoll_event> EPollEvents;
+
+  /// The fds kept in the epoll set across the waits, so that only the
+  /// changed subscriptions cost `epoll_ctl` calls.
+  struct Registration {
+    /// Serial number of the registered node, as the closed fds are removed
+    /// from the epoll set by the kernel behind the poller.
+    uint64_t Serial = 0;
+    uint32_t Events = 0;
+    /// Edge-triggered and reported by the last wait, which needs re-arming
+    /// to report the fd again if still ready.
+    bool Rearm = false;
+  };
+  std::unordered_map<int, Registration> Registered;
+
+  void update(int NodeFd, const FdData &Data) noexcept;
+  void dispatch(const struct epoll_event &EPollEvent) noexcept;
+  void waitUring() noexcept;
+
+  UringHolder Ring;
+  bool UseUring = false;
 #endif
 
 #if WASMEDGE_OS_MACOS
@@ -976,6 +1193,52 @@ private:
 #endif
 };
 
+/// Watcher of the entry changes of directories.
+class Watcher
+#if WASMEDGE_OS_LINUX
+    : public FdHolder
+#endif
+{
+public:
+  /// A changed entry of a watched directory.
+  struct Event {
+    /// Watch id of the directory, or -1 if the events overflowed.
+    int32_t Id;
+    /// Name of the changed entry, or empty if the directory itself changed.
+    std::string Name;
+  };
+
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+  Watcher(Watcher &&RHS) noexcept = default;
+  Watcher &operator=(Watcher &&RHS) noexcept = default;
+
+  /// Create a watcher, or NOSYS if the platform does not support it.
+  static WasiExpect<Watcher> create() noexcept;
+
+  /// Watch the entries of the directory.
+  ///
+  /// Watching the same directory again returns the same id.
+  ///
+  /// @param[in] Dir The directory to watch.
+  /// @return The watch id, or WASI error.
+  WasiExpect<int32_t> add(const INode &Dir) noexcept;
+
+  /// Stop watching the directory.
+  void remove(int32_t Id) noexcept;
+
+  /// Read the pending changes without blocking.
+  ///
+  /// @param[out] Events The changed entries.
+  /// @return Nothing, or WASI error.
+  WasiExpect<void> read(std::vector<Event> &Events) noexcept;
+
+#if WASMEDGE_OS_LINUX
+private:
+  explicit Watcher(int Fd) noexcept : FdHolder(Fd) {}
+#endif
+};
+
 class PollerContext {
 #if WASMEDGE_OS_LINUX
 public:
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "common/span.h"
+#include "common/spdlog.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+/// I/O statistics of a WASI environment: the transferred bytes, the calls and
+/// their latencies, and the wakeups of the polls. Only collected if enabled.
+class IOStatistics {
+public:
+  /// Count of the latency buckets. The bucket `I` counts the calls taking
+  /// less than `2^I` ns and not less than `2^(I-1)` ns, and the last bucket
+  /// also counts the longer calls.
+  static inline constexpr const uint32_t kBuckets = 32;
+
+  /// Latency histogram of a WASI function.
+  class Histogram {
+  public:
+    void record(uint64_t Nanoseconds) noexcept {
+      uint32_t Index = 0;
+      for (uint64_t V = Nanoseconds; V != 0 && Index < kBuckets - 1;
+           V >>= 1) {
+        ++Index;
+      }
+      Buckets[Index].fetch_add(1, std::memory_order_relaxed);
+      Count.fetch_add(1, std::memory_order_relaxed);
+      Total.fetch_add(Nanoseconds, std::memory_order_relaxed);
+    }
+
+    uint64_t getBucket(uint32_t Index) const noexcept {
+      return Buckets[Index].load(std::memory_order_relaxed);
+    }
+
+    /// Getter of the count of the calls.
+    uint64_t getCount() const noexcept {
+      return Count.load(std::memory_order_relaxed);
+    }
+
+    /// Getter of the total latency in ns.
+    uint64_t getTotal() const noexcept {
+      return Total.load(std::memory_order_relaxed);
+    }
+
+    /// Upper bound in ns of the latency of the given percent of the calls.
+    uint64_t getPercentile(uint32_t Percent) const noexcept {
+      const uint64_t Target = (getCount() * Percent + 99) / 100;
+      uint64_t Sum = 0;
+      for (uint32_t I = 0; I < kBuckets; ++I) {
+        Sum += getBucket(I);
+        if (Sum >= Target) {
+          return UINT64_C(1) << I;
+        }
+      }
+      return UINT64_C(1) << (kBuckets - 1);
+    }
+
+    void clear() noexcept {
+      for (auto &Bucket : Buckets) {
+        Bucket.store(0, std::memory_order_relaxed);
+      }
+      Count.store(0, std::memory_order_relaxed);
+      Total.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    std::array<std::atomic_uint64_t, kBuckets> Buckets{};
+    std::atomic_uint64_t Count = 0;
+    std::atomic_uint64_t Total = 0;
+  };
+
+  void setEnable(bool IsEnable) noexcept {
+    Enabled.store(IsEnable, std::memory_order_relaxed);
+  }
+
+  bool isEnabled() const noexcept {
+    return Enabled.load(std::memory_order_relaxed);
+  }
+
+  /// Add the histograms of the WASI functions, which must be done once before
+  /// any call is recorded. The names should outlive this object.
+  void setFunctions(Span<const std::string_view> FuncNames) {
+    Names = FuncNames;
+    Functions = std::make_unique<Histogram[]>(Names.size());
+  }
+
+  /// Find the histogram of the WASI function, or nullptr if not added.
+  const Histogram *getFunction(std::string_view Name) const noexcept {
+    for (size_t I = 0; I < Names.size(); ++I) {
+      if (Names[I] == Name) {
+        return &Functions[I];
+      }
+    }
+    return nullptr;
+  }
+
+  /// Find the histogram by the position of the function name, or nullptr if
+  /// not added.
+  Histogram *getFunction(uint32_t Index) noexcept {
+    return Index < Names.size() ? &Functions[Index] : nullptr;
+  }
+
+  void addBytesRead(uint64_t Bytes) noexcept {
+    if (isEnabled()) {
+      BytesRead.fetch_add(Bytes, std::memory_order_relaxed);
+    }
+  }
+
+  void addBytesWritten(uint64_t Bytes) noexcept {
+    if (isEnabled()) {
+      BytesWritten.fetch_add(Bytes, std::memory_order_relaxed);
+    }
+  }
+
+  void addPollWakeup() noexcept {
+    if (isEnabled()) {
+      PollWakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t getBytesRead() const noexcept {
+    return BytesRead.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getBytesWritten() const noexcept {
+    return BytesWritten.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getPollWakeups() const noexcept {
+    return PollWakeups.load(std::memory_order_relaxed);
+  }
+
+  /// Getter of the count of the WASI calls.
+  uint64_t getCalls() const noexcept {
+    uint64_t Calls = 0;
+    for (size_t I = 0; I < Names.size(); ++I) {
+      Calls += Functions[I].getCount();
+    }
+    return Calls;
+  }
+
+  void clear() noexcept {
+    BytesRead.store(0, std::memory_order_relaxed);
+    BytesWritten.store(0, std::memory_order_relaxed);
+    PollWakeups.store(0, std::memory_order_relaxed);
+    for (size_t I = 0; I < Names.size(); ++I) {
+      Functions[I].clear();
+    }
+  }
+
+  void dumpToLog() const noexcept {
+    using namespace std::literals;
+    spdlog::info("=================  WASI I/O Statistics  ================"sv);
+    spdlog::info(" Bytes read: {}"sv, getBytesRead());
+    spdlog::info(" Bytes written: {}"sv, getBytesWritten());
+    spdlog::info(" WASI calls: {}"sv, getCalls());
+    spdlog::info(" Poll wakeups: {}"sv, getPollWakeups());
+    for (size_t I = 0; I < Names.size(); ++I) {
+      const auto &Func = Functions[I];
+      if (const uint64_t Count = Func.getCount(); Count > 0) {
+        spdlog::info(
+            " {}: {} calls, {} ns in total, p50 < {} ns, p99 < {} ns"sv,
+            Names[I], Count, Func.getTotal(), Func.getPercentile(50),
+            Func.getPercentile(99));
+      }
+    }
+    spdlog::info("=======================   End   ======================"sv);
+  }
+
+private:
+  std::atomic<bool> Enabled = false;
+  std::atomic_uint64_t BytesRead = 0;
+  std::atomic_uint64_t BytesWritten = 0;
+  std::atomic_uint64_t PollWakeups = 0;
+  /// Histograms of the WASI functions, in the order of the names.
+  Span<const std::string_view> Names;
+  std::unique_ptr<Histogram[]> Functions;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
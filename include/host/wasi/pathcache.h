@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "host/wasi/inode.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+class VINode;
+
+/// Cache of the directories resolved under a pre-opened directory.
+///
+/// The cached directories are kept open, so that resolving a path through them
+/// skips the `fstatat` and `openat` of each component. Every cached directory
+/// is watched, and a changed entry is dropped with its descendants before the
+/// next resolving.
+class PathCache {
+public:
+  PathCache(const PathCache &) = delete;
+  PathCache &operator=(const PathCache &) = delete;
+
+  /// Create the cache of the pre-opened directory, or nullptr if the platform
+  /// cannot watch directories.
+  static std::shared_ptr<PathCache> create(const VINode &Root) noexcept;
+
+  /// Drop the changed entries.
+  void sync() noexcept;
+
+  /// Find the cached child directory.
+  std::shared_ptr<VINode> find(const VINode &Parent,
+                               std::string_view Name) noexcept;
+
+  /// Cache the child directory if the parent is cached.
+  void insert(const VINode &Parent, std::string_view Name,
+              std::shared_ptr<VINode> Child) noexcept;
+
+private:
+  /// Maximum cached directories, bounding the opened file descriptors.
+  static inline constexpr const size_t kMaxDirs = 256;
+
+  struct Dir {
+    std::shared_ptr<VINode> Node; ///< Empty for the root
+    int32_t WatchId;
+    const VINode *Parent;
+    std::string Name;
+    std::map<std::string, const VINode *, std::less<>> Children;
+  };
+
+  PathCache(Watcher &&W, const VINode &Root, int32_t WatchId) noexcept;
+
+  /// Drop the directory and its descendants, or only the descendants of the
+  /// root. Must hold `Mutex`.
+  void erase(const VINode *Node) noexcept;
+
+  std::mutex Mutex;
+  Watcher Watch;
+  const VINode *Root;
+  std::unordered_map<const VINode *, Dir> Dirs;
+  std::unordered_multimap<int32_t, const VINode *> Watches;
+  std::vector<Watcher::Event> Events;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
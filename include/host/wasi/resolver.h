@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "host/wasi/error.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+/// Process-wide cache of the address lookups of `sock_getaddrinfo`.
+///
+/// The system resolver does not report the TTL of the records, so the results
+/// are kept for a fixed time. A missed lookup in an event loop task runs on a
+/// background thread while the task is parked, so that the other tasks on the
+/// thread keep running.
+class Resolver {
+public:
+  /// Size of `sa_data` of the largest supported address, the IPv6 one.
+  static inline constexpr const size_t kSaDataSize = 26;
+
+  struct Addrinfo {
+    /// The fields of the result, without the guest pointers.
+    __wasi_addrinfo_t Info;
+    __wasi_address_family_t SaFamily;
+    __wasi_size_t SaDataLen;
+    std::array<char, kSaDataSize> SaData;
+    std::string CanonName;
+  };
+  using Result = std::shared_ptr<const std::vector<Addrinfo>>;
+
+  static Resolver &getDefault() noexcept;
+
+  /// Set the time the results are kept. Zero disables the caching.
+  void setTTL(std::chrono::nanoseconds NewTTL) noexcept;
+
+  /// Look up the addresses, or get the cached ones.
+  ///
+  /// @param[in] Node The host name or the numeric address.
+  /// @param[in] Service The service name or the port number.
+  /// @param[in] Hint The flags, family, socket type, and protocol of the
+  /// lookup.
+  /// @return The shared results, or WASI error.
+  WasiExpect<Result> resolve(std::string_view Node, std::string_view Service,
+                             const __wasi_addrinfo_t &Hint) noexcept;
+
+  /// Drop the cached results.
+  void clear() noexcept;
+
+private:
+  /// Maximum cached lookups.
+  static inline constexpr const size_t kMaxEntries = 1024;
+
+  struct Entry {
+    Result Value;
+    std::chrono::steady_clock::time_point Expiry;
+  };
+
+  std::mutex Mutex;
+  std::chrono::nanoseconds TTL = std::chrono::seconds(30);
+  std::unordered_map<std::string, Entry> Cache;
+};
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
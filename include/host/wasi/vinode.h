@@ -5,8 +5,10 @@
 
 #include "common/filesystem.h"
 #include "common/types.h"
+#include "host/wasi/archive.h"
 #include "host/wasi/error.h"
 #include "host/wasi/inode.h"
+#include "host/wasi/pathcache.h"
 #include "host/wasi/vfs.h"
 
 #include <cstdint>
@@ -42,6 +44,14 @@ public:
   VINode(INode Node, __wasi_rights_t FRB, __wasi_rights_t FRI,
          std::string N = {});
 
+  /// Create a VINode of an archive entry.
+  ///
+  /// @param[in] Node Archive node.
+  /// @param[in] FRB The desired rights of the VINode.
+  /// @param[in] FRI The desired rights of the VINode.
+  VINode(ArchiveNode Node, __wasi_rights_t FRB, __wasi_rights_t FRI,
+         std::string N = {});
+
   /// Check path is valid.
   static bool isPathValid(std::string_view Path) noexcept {
     return Path.find('\0') == std::string_view::npos;
@@ -63,8 +73,17 @@ public:
                                                   std::string Name,
                                                   std::string SystemPath);
 
+  /// Bind the root of a tar archive of the host as a read-only directory.
+  static WasiExpect<std::shared_ptr<VINode>>
+  bindArchive(__wasi_rights_t FRB, __wasi_rights_t FRI, std::string Name,
+              std::string SystemPath);
+
   constexpr const std::string &name() const { return Name; }
 
+  /// Cache the directories resolved under this pre-opened directory. Ignored
+  /// if the platform cannot watch directories.
+  void enablePathCache() noexcept { Cache = PathCache::create(*this); }
+
   /// Provide file advisory information on a file descriptor.
   ///
   /// Note: This is similar to `posix_fadvise` in POSIX.
@@ -79,6 +98,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_ADVISE)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return {};
+    }
     return Node.fdAdvise(Offset, Len, Advice);
   }
 
@@ -119,6 +141,9 @@ public:
   WasiExpect<void> fdFdstatGet(__wasi_fdstat_t &FdStat) const noexcept {
     FdStat.fs_rights_base = EndianValue(FsRightsBase).le();
     FdStat.fs_rights_inheriting = EndianValue(FsRightsInheriting).le();
+    if (Archived) {
+      return Archived->fdFdstatGet(FdStat);
+    }
     return Node.fdFdstatGet(FdStat);
   }
 
@@ -175,6 +200,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_FILESTAT_GET)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdFilestatGet(Filestat);
+    }
     return Node.fdFilestatGet(Filestat);
   }
 
@@ -223,6 +251,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_READ | __WASI_RIGHTS_FD_SEEK)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdPread(IOVs, Offset, NRead);
+    }
     return Node.fdPread(IOVs, Offset, NRead);
   }
 
@@ -257,6 +288,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_READ)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdRead(IOVs, NRead);
+    }
     return Node.fdRead(IOVs, NRead);
   }
 
@@ -283,6 +317,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_READDIR)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdReaddir(Buffer, Cookie, Size);
+    }
     return Node.fdReaddir(Buffer, Cookie, Size);
   }
 
@@ -300,6 +337,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_SEEK)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdSeek(Offset, Whence, Size);
+    }
     return Node.fdSeek(Offset, Whence, Size);
   }
 
@@ -326,6 +366,9 @@ public:
     if (!can(__WASI_RIGHTS_FD_TELL)) {
       return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
     }
+    if (Archived) {
+      return Archived->fdTell(Size);
+    }
     return Node.fdTell(Size);
   }
 
@@ -345,6 +388,26 @@ public:
     return Node.fdWrite(IOVs, NWritten);
   }
 
+  /// Transfer data from another file descriptor without copying through the
+  /// guest memory.
+  ///
+  /// Note: This is similar to `sendfile` in Linux.
+  ///
+  /// @param[in] In The file descriptor to read from.
+  /// @param[in] Count The maximum number of bytes to transfer.
+  /// @param[out] NWritten The number of bytes transferred.
+  /// @return Nothing or WASI error
+  WasiExpect<void> fdSendfile(const VINode &In, __wasi_filesize_t Count,
+                              __wasi_filesize_t &NWritten) const noexcept {
+    if (!can(__WASI_RIGHTS_FD_WRITE) || !In.can(__WASI_RIGHTS_FD_READ)) {
+      return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
+    }
+    if (In.Archived) {
+      return In.Archived->fdSendfile(Node, Count, NWritten);
+    }
+    return Node.fdSendfile(In.Node, Count, NWritten);
+  }
+
   /// Get the native handler.
   ///
   /// Note: Users should cast this native handler to corresponding types
@@ -542,6 +605,10 @@ public:
     return Node.sockBind(AddressFamily, Address, Port);
   }
 
+  WasiExpect<void> sockSetReusePort() noexcept {
+    return Node.sockSetReusePort();
+  }
+
   WasiExpect<void> sockListen(int32_t Backlog) noexcept {
     return Node.sockListen(Backlog);
   }
@@ -641,6 +708,34 @@ public:
     return Node.sockShutdown(SdFlags);
   }
 
+  /// Receive a batch of datagrams from a socket.
+  ///
+  /// Note: This is similar to `recvmmsg` in Linux.
+  ///
+  /// @param[in,out] Msgs The datagrams to receive into.
+  /// @param[in] RiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams received.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockRecvMmsg(Span<RecvMessage> Msgs,
+                                __wasi_riflags_t RiFlags,
+                                __wasi_size_t &NMsgs) const noexcept {
+    return Node.sockRecvMmsg(Msgs, RiFlags, NMsgs);
+  }
+
+  /// Send a batch of datagrams on a socket.
+  ///
+  /// Note: This is similar to `sendmmsg` in Linux.
+  ///
+  /// @param[in,out] Msgs The datagrams to send.
+  /// @param[in] SiFlags Message flags.
+  /// @param[out] NMsgs Return the number of datagrams sent.
+  /// @return Nothing or WASI error.
+  WasiExpect<void> sockSendMmsg(Span<SendMessage> Msgs,
+                                __wasi_siflags_t SiFlags,
+                                __wasi_size_t &NMsgs) const noexcept {
+    return Node.sockSendMmsg(Msgs, SiFlags, NMsgs);
+  }
+
   WasiExpect<void> sockGetOpt(__wasi_sock_opt_level_t SockOptLevel,
                               __wasi_sock_opt_so_t SockOptName,
                               Span<uint8_t> &Flag) const noexcept {
@@ -672,13 +767,27 @@ public:
   }
 
   /// Check if this vinode is a directory.
-  bool isDirectory() const noexcept { return Node.isDirectory(); }
+  bool isDirectory() const noexcept {
+    return Archived ? Archived->isDirectory() : Node.isDirectory();
+  }
 
   /// Check if current user has execute permission on this vinode directory.
-  bool canBrowse() const noexcept { return Node.canBrowse(); }
+  bool canBrowse() const noexcept {
+    return Archived ? Archived->isDirectory() : Node.canBrowse();
+  }
 
   /// Check if this vinode is a symbolic link.
-  bool isSymlink() const noexcept { return Node.isSymlink(); }
+  bool isSymlink() const noexcept {
+    return Archived ? Archived->isSymlink() : Node.isSymlink();
+  }
+
+  /// Check if the event of this vinode is ready without blocking.
+  WasiExpect<bool> isReady(__wasi_eventtype_t Type) const noexcept {
+    if (Archived) {
+      return true;
+    }
+    return Node.isReady(Type);
+  }
 
   static constexpr __wasi_rights_t imply(__wasi_rights_t Rights) noexcept {
     if (Rights & __WASI_RIGHTS_FD_SEEK) {
@@ -704,7 +813,11 @@ private:
   __wasi_rights_t FsRightsBase;
   __wasi_rights_t FsRightsInheriting;
   std::string Name;
+  std::shared_ptr<PathCache> Cache;
+  /// The archive entry served instead of `Node`, if set.
+  std::unique_ptr<ArchiveNode> Archived;
 
+  friend class PathCache;
   friend class VPoller;
 
   /// Open path without resolve.
@@ -716,6 +829,13 @@ private:
              __wasi_fdflags_t FdFlags, VFS::Flags VFSFlags,
              __wasi_rights_t RightsBase, __wasi_rights_t RightsInheriting);
 
+  /// Check if the path can be resolved beneath the directory by the kernel,
+  /// leaving the other cases and their errors to `resolvePath`.
+  bool canResolveBeneath(std::string_view Path) const noexcept {
+    return !Archived && !Path.empty() && Path[0] != '/' &&
+           Node.isDirectory() && Node.canBrowse();
+  }
+
   /// Resolve path until last element.
   /// @param[in,out] Fd Fd. Return parent of last part if found.
   /// @param[in,out] Path path. Return last part of path if found.
@@ -755,6 +875,7 @@ public:
   using Poller::prepare;
   using Poller::reset;
   using Poller::result;
+  using Poller::useUring;
   using Poller::wait;
 
   void read(std::shared_ptr<VINode> Fd, TriggerType Trigger,
@@ -4,19 +4,103 @@
 #pragma once
 
 #include "common/errcode.h"
+#include "common/spdlog.h"
 #include "host/wasi/environ.h"
+#include "host/wasi/wasimodule.h"
 #include "runtime/callingframe.h"
 #include "runtime/hostfunc.h"
 
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
 namespace WasmEdge {
 namespace Host {
 
 template <typename T> class Wasi : public Runtime::HostFunction<T> {
 public:
-  Wasi(WASI::Environ &HostEnv) : Runtime::HostFunction<T>(0), Env(HostEnv) {}
+  /// Create the function bound to the environment.
+  Wasi(WASI::Environ &HostEnv)
+      : Runtime::HostFunction<T>(0), BoundEnv(&HostEnv) {
+    this->FastCall = &fastCall;
+  }
+  /// Create the function shared between the WASI modules, which uses the
+  /// environment of the called module.
+  Wasi() : Runtime::HostFunction<T>(0) { this->FastCall = &fastCall; }
+
+  /// Record the latencies of the calls in the histogram of the index when the
+  /// I/O statistics is enabled.
+  void setLatencyIndex(uint32_t Index) noexcept { LatencyIndex = Index; }
+
+  Expect<void> run(const Runtime::CallingFrame &CallFrame,
+                   Span<const ValVariant> Args,
+                   Span<ValVariant> Rets) override {
+    return measure(CallFrame, [&]() {
+      return Runtime::HostFunction<T>::run(CallFrame, Args, Rets);
+    });
+  }
 
 protected:
-  WASI::Environ &Env;
+  static Expect<void> fastCall(Runtime::HostFunctionBase &Func,
+                               const Runtime::CallingFrame &CallFrame,
+                               const ValVariant *Args, ValVariant *Rets) {
+    return static_cast<Wasi &>(Func).measure(CallFrame, [&]() {
+      return Runtime::HostFunction<T>::fastCall(Func, CallFrame, Args, Rets);
+    });
+  }
+
+  /// Get the environment of the function, which is checked to be found before
+  /// calling the body.
+  WASI::Environ &getEnv(const Runtime::CallingFrame &Frame) const noexcept {
+    return *findEnv(Frame);
+  }
+
+private:
+  /// Find the bound environment, or the one of the called WASI module, or the
+  /// one of the WASI module of the calling module for the frames without the
+  /// called module. Return nullptr if not found.
+  WASI::Environ *findEnv(const Runtime::CallingFrame &Frame) const noexcept {
+    if (BoundEnv) {
+      return BoundEnv;
+    }
+    const auto *Mod =
+        dynamic_cast<const WasiModule *>(Frame.getCalleeModule());
+    if (!Mod) {
+      Mod = dynamic_cast<const WasiModule *>(Frame.getWASIModule());
+    }
+    if (!Mod) {
+      return nullptr;
+    }
+    return const_cast<WASI::Environ *>(Mod->getEnv());
+  }
+
+  template <typename CallT>
+  Expect<void> measure(const Runtime::CallingFrame &Frame, CallT &&Call) {
+    using namespace std::literals;
+    auto *Env = findEnv(Frame);
+    if (unlikely(!Env)) {
+      spdlog::error("WASI environment of the called function not found"sv);
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    auto &Stat = Env->getIOStatistics();
+    if (!Stat.isEnabled()) {
+      return Call();
+    }
+    auto *Histogram = Stat.getFunction(LatencyIndex);
+    if (!Histogram) {
+      return Call();
+    }
+    const auto Start = std::chrono::steady_clock::now();
+    auto Res = Call();
+    Histogram->record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - Start)
+            .count()));
+    return Res;
+  }
+
+  WASI::Environ *BoundEnv = nullptr;
+  uint32_t LatencyIndex = std::numeric_limits<uint32_t>::max();
 };
 
 } // namespace Host
@@ -12,7 +12,7 @@ namespace Host {
 
 class WasiArgsGet : public Wasi<WasiArgsGet> {
 public:
-  WasiArgsGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t ArgvPtr,
                         uint32_t ArgvBufPtr);
@@ -20,7 +20,7 @@ public:
 
 class WasiArgsSizesGet : public Wasi<WasiArgsSizesGet> {
 public:
-  WasiArgsSizesGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
                         uint32_t /* Out */ ArgcPtr,
@@ -29,7 +29,7 @@ public:
 
 class WasiEnvironGet : public Wasi<WasiEnvironGet> {
 public:
-  WasiEnvironGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t EnvPtr,
                         uint32_t EnvBufPtr);
@@ -37,7 +37,7 @@ public:
 
 class WasiEnvironSizesGet : public Wasi<WasiEnvironSizesGet> {
 public:
-  WasiEnvironSizesGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
                         uint32_t /* Out */ EnvCntPtr,
@@ -46,7 +46,7 @@ public:
 
 class WasiClockResGet : public Wasi<WasiClockResGet> {
 public:
-  WasiClockResGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t ClockId,
                         uint32_t /* Out */ ResolutionPtr);
@@ -54,7 +54,7 @@ public:
 
 class WasiClockTimeGet : public Wasi<WasiClockTimeGet> {
 public:
-  WasiClockTimeGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t ClockId,
                         uint64_t Precision, uint32_t /* Out */ TimePtr);
@@ -62,7 +62,7 @@ public:
 
 class WasiFdAdvise : public Wasi<WasiFdAdvise> {
 public:
-  WasiFdAdvise(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint64_t Offset, uint64_t Len, uint32_t Advice);
@@ -70,7 +70,7 @@ public:
 
 class WasiFdAllocate : public Wasi<WasiFdAllocate> {
 public:
-  WasiFdAllocate(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint64_t Offset, uint64_t Len);
@@ -78,21 +78,21 @@ public:
 
 class WasiFdClose : public Wasi<WasiFdClose> {
 public:
-  WasiFdClose(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd);
 };
 
 class WasiFdDatasync : public Wasi<WasiFdDatasync> {
 public:
-  WasiFdDatasync(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd);
 };
 
 class WasiFdFdstatGet : public Wasi<WasiFdFdstatGet> {
 public:
-  WasiFdFdstatGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t /* Out */ FdStatPtr);
@@ -100,7 +100,7 @@ public:
 
 class WasiFdFdstatSetFlags : public Wasi<WasiFdFdstatSetFlags> {
 public:
-  WasiFdFdstatSetFlags(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t FsFlags);
@@ -108,7 +108,7 @@ public:
 
 class WasiFdFdstatSetRights : public Wasi<WasiFdFdstatSetRights> {
 public:
-  WasiFdFdstatSetRights(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint64_t FsRightsBase, uint64_t FsRightsInheriting);
@@ -116,7 +116,7 @@ public:
 
 class WasiFdFilestatGet : public Wasi<WasiFdFilestatGet> {
 public:
-  WasiFdFilestatGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t /* Out */ FilestatPtr);
@@ -124,7 +124,7 @@ public:
 
 class WasiFdFilestatSetSize : public Wasi<WasiFdFilestatSetSize> {
 public:
-  WasiFdFilestatSetSize(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint64_t Size);
@@ -132,7 +132,7 @@ public:
 
 class WasiFdFilestatSetTimes : public Wasi<WasiFdFilestatSetTimes> {
 public:
-  WasiFdFilestatSetTimes(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint64_t ATim, uint64_t MTim, uint32_t FstFlags);
@@ -140,7 +140,7 @@ public:
 
 class WasiFdPread : public Wasi<WasiFdPread> {
 public:
-  WasiFdPread(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t IOVsPtr, uint32_t IOVsLen, uint64_t Offset,
@@ -149,7 +149,7 @@ public:
 
 class WasiFdPrestatGet : public Wasi<WasiFdPrestatGet> {
 public:
-  WasiFdPrestatGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t /* Out */ PreStatPtr);
@@ -157,7 +157,7 @@ public:
 
 class WasiFdPrestatDirName : public Wasi<WasiFdPrestatDirName> {
 public:
-  WasiFdPrestatDirName(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t PathBufPtr, uint32_t PathLen);
@@ -165,7 +165,7 @@ public:
 
 class WasiFdPwrite : public Wasi<WasiFdPwrite> {
 public:
-  WasiFdPwrite(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t IOVSPtr, uint32_t IOVSLen, uint64_t Offset,
@@ -174,7 +174,7 @@ public:
 
 class WasiFdRead : public Wasi<WasiFdRead> {
 public:
-  WasiFdRead(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t IOVSPtr, uint32_t IOVSLen,
@@ -183,7 +183,7 @@ public:
 
 class WasiFdReadDir : public Wasi<WasiFdReadDir> {
 public:
-  WasiFdReadDir(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t BufPtr, uint32_t BufLen, uint64_t Cookie,
@@ -192,7 +192,7 @@ public:
 
 class WasiFdRenumber : public Wasi<WasiFdRenumber> {
 public:
-  WasiFdRenumber(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         int32_t ToFd);
@@ -200,7 +200,7 @@ public:
 
 class WasiFdSeek : public Wasi<WasiFdSeek> {
 public:
-  WasiFdSeek(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<int32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                        int64_t Offset, uint32_t Whence,
@@ -209,14 +209,14 @@ public:
 
 class WasiFdSync : public Wasi<WasiFdSync> {
 public:
-  WasiFdSync(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd);
 };
 
 class WasiFdTell : public Wasi<WasiFdTell> {
 public:
-  WasiFdTell(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t /* Out */ OffsetPtr);
@@ -224,16 +224,25 @@ public:
 
 class WasiFdWrite : public Wasi<WasiFdWrite> {
 public:
-  WasiFdWrite(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t IOVSPtr, uint32_t IOVSLen,
                         uint32_t /* Out */ NWrittenPtr);
 };
 
+class WasiFdSendfile : public Wasi<WasiFdSendfile> {
+public:
+  using Wasi::Wasi;
+
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
+                        int32_t InFd, uint64_t Count,
+                        uint32_t /* Out */ NWrittenPtr);
+};
+
 class WasiPathCreateDirectory : public Wasi<WasiPathCreateDirectory> {
 public:
-  WasiPathCreateDirectory(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t PathPtr, uint32_t PathLen);
@@ -241,7 +250,7 @@ public:
 
 class WasiPathFilestatGet : public Wasi<WasiPathFilestatGet> {
 public:
-  WasiPathFilestatGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t Flags, uint32_t PathPtr, uint32_t PathLen,
@@ -250,7 +259,7 @@ public:
 
 class WasiPathFilestatSetTimes : public Wasi<WasiPathFilestatSetTimes> {
 public:
-  WasiPathFilestatSetTimes(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t Flags, uint32_t PathPtr, uint32_t PathLen,
@@ -259,7 +268,7 @@ public:
 
 class WasiPathLink : public Wasi<WasiPathLink> {
 public:
-  WasiPathLink(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t OldFd,
                         uint32_t OldFlags, uint32_t OldPathPtr,
@@ -269,7 +278,7 @@ public:
 
 class WasiPathOpen : public Wasi<WasiPathOpen> {
 public:
-  WasiPathOpen(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t DirFd,
                         uint32_t DirFlags, uint32_t PathPtr, uint32_t PathLen,
@@ -280,7 +289,7 @@ public:
 
 class WasiPathReadLink : public Wasi<WasiPathReadLink> {
 public:
-  WasiPathReadLink(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t PathPtr, uint32_t PathLen, uint32_t BufPtr,
@@ -289,7 +298,7 @@ public:
 
 class WasiPathRemoveDirectory : public Wasi<WasiPathRemoveDirectory> {
 public:
-  WasiPathRemoveDirectory(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t PathPtr, uint32_t PathLen);
@@ -297,7 +306,7 @@ public:
 
 class WasiPathRename : public Wasi<WasiPathRename> {
 public:
-  WasiPathRename(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t OldPathPtr, uint32_t OldPathLen, int32_t NewFd,
@@ -306,7 +315,7 @@ public:
 
 class WasiPathSymlink : public Wasi<WasiPathSymlink> {
 public:
-  WasiPathSymlink(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t OldPathPtr,
                         uint32_t OldPathLen, int32_t Fd, uint32_t NewPathPtr,
@@ -315,7 +324,7 @@ public:
 
 class WasiPathUnlinkFile : public Wasi<WasiPathUnlinkFile> {
 public:
-  WasiPathUnlinkFile(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t PathPtr, uint32_t PathLen);
@@ -324,7 +333,7 @@ public:
 template <WASI::TriggerType Trigger>
 class WasiPollOneoff : public Wasi<WasiPollOneoff<Trigger>> {
 public:
-  WasiPollOneoff(WASI::Environ &HostEnv) : Wasi<WasiPollOneoff>(HostEnv) {}
+  using Wasi<WasiPollOneoff>::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t InPtr,
                         uint32_t OutPtr, uint32_t NSubscriptions,
@@ -333,28 +342,28 @@ public:
 
 class WasiProcExit : public Wasi<WasiProcExit> {
 public:
-  WasiProcExit(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<void> body(const Runtime::CallingFrame &Frame, uint32_t Status);
 };
 
 class WasiProcRaise : public Wasi<WasiProcRaise> {
 public:
-  WasiProcRaise(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Signal);
 };
 
 class WasiSchedYield : public Wasi<WasiSchedYield> {
 public:
-  WasiSchedYield(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame);
 };
 
 class WasiRandomGet : public Wasi<WasiRandomGet> {
 public:
-  WasiRandomGet(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t BufPtr,
                         uint32_t BufLen);
@@ -362,7 +371,7 @@ public:
 
 class WasiSockOpenV1 : public Wasi<WasiSockOpenV1> {
 public:
-  WasiSockOpenV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
                         uint32_t AddressFamily, uint32_t SockType,
@@ -371,7 +380,7 @@ public:
 
 class WasiSockBindV1 : public Wasi<WasiSockBindV1> {
 public:
-  WasiSockBindV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t Port);
@@ -379,7 +388,7 @@ public:
 
 class WasiSockListenV1 : public Wasi<WasiSockListenV1> {
 public:
-  WasiSockListenV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         int32_t Backlog);
@@ -387,7 +396,7 @@ public:
 
 class WasiSockAcceptV1 : public Wasi<WasiSockAcceptV1> {
 public:
-  WasiSockAcceptV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t /* Out */ RoFdPtr);
@@ -395,7 +404,7 @@ public:
 
 class WasiSockConnectV1 : public Wasi<WasiSockConnectV1> {
 public:
-  WasiSockConnectV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t Port);
@@ -403,7 +412,7 @@ public:
 
 class WasiSockRecvV1 : public Wasi<WasiSockRecvV1> {
 public:
-  WasiSockRecvV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t RiDataPtr, uint32_t RiDataLen,
@@ -413,7 +422,7 @@ public:
 
 class WasiSockRecvFromV1 : public Wasi<WasiSockRecvFromV1> {
 public:
-  WasiSockRecvFromV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t RiDataPtr, uint32_t RiDataLen,
@@ -424,7 +433,7 @@ public:
 
 class WasiSockSendV1 : public Wasi<WasiSockSendV1> {
 public:
-  WasiSockSendV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SiDataPtr, uint32_t SiDataLen,
@@ -433,7 +442,7 @@ public:
 
 class WasiSockSendToV1 : public Wasi<WasiSockSendToV1> {
 public:
-  WasiSockSendToV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SiDataPtr, uint32_t SiDataLen,
@@ -443,15 +452,33 @@ public:
 
 class WasiSockShutdown : public Wasi<WasiSockShutdown> {
 public:
-  WasiSockShutdown(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SdFlags);
 };
 
+class WasiSockRecvMmsg : public Wasi<WasiSockRecvMmsg> {
+public:
+  using Wasi::Wasi;
+
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
+                        uint32_t MsgsPtr, uint32_t MsgsLen, uint32_t RiFlags,
+                        uint32_t /* Out */ NMsgsPtr);
+};
+
+class WasiSockSendMmsg : public Wasi<WasiSockSendMmsg> {
+public:
+  using Wasi::Wasi;
+
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
+                        uint32_t MsgsPtr, uint32_t MsgsLen, uint32_t SiFlags,
+                        uint32_t /* Out */ NMsgsPtr);
+};
+
 class WasiSockGetOpt : public Wasi<WasiSockGetOpt> {
 public:
-  WasiSockGetOpt(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SockOptLevel, uint32_t SockOptName,
@@ -460,7 +487,7 @@ public:
 
 class WasiSockSetOpt : public Wasi<WasiSockSetOpt> {
 public:
-  WasiSockSetOpt(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SockOptLevel, uint32_t SockOptName,
@@ -469,7 +496,7 @@ public:
 
 class WasiSockGetLocalAddrV1 : public Wasi<WasiSockGetLocalAddrV1> {
 public:
-  WasiSockGetLocalAddrV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t AddressTypePtr,
@@ -478,7 +505,7 @@ public:
 
 class WasiSockGetPeerAddrV1 : public Wasi<WasiSockGetPeerAddrV1> {
 public:
-  WasiSockGetPeerAddrV1(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t AddressTypePtr,
@@ -487,7 +514,7 @@ public:
 
 class WasiSockGetAddrinfo : public Wasi<WasiSockGetAddrinfo> {
 public:
-  WasiSockGetAddrinfo(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t NodePtr,
                         uint32_t NodeLen, uint32_t ServicePtr,
@@ -497,7 +524,7 @@ public:
 
 class WasiSockOpenV2 : public Wasi<WasiSockOpenV2> {
 public:
-  WasiSockOpenV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
                         uint32_t AddressFamily, uint32_t SockType,
@@ -506,7 +533,7 @@ public:
 
 class WasiSockBindV2 : public Wasi<WasiSockBindV2> {
 public:
-  WasiSockBindV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t Port);
@@ -514,7 +541,7 @@ public:
 
 class WasiSockListenV2 : public Wasi<WasiSockListenV2> {
 public:
-  WasiSockListenV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         int32_t Backlog);
@@ -522,7 +549,7 @@ public:
 
 class WasiSockAcceptV2 : public Wasi<WasiSockAcceptV2> {
 public:
-  WasiSockAcceptV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t FsFlags, uint32_t /* Out */ RoFdPtr);
@@ -530,7 +557,7 @@ public:
 
 class WasiSockConnectV2 : public Wasi<WasiSockConnectV2> {
 public:
-  WasiSockConnectV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t Port);
@@ -538,7 +565,7 @@ public:
 
 class WasiSockRecvV2 : public Wasi<WasiSockRecvV2> {
 public:
-  WasiSockRecvV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t RiDataPtr, uint32_t RiDataLen,
@@ -548,7 +575,7 @@ public:
 
 class WasiSockRecvFromV2 : public Wasi<WasiSockRecvFromV2> {
 public:
-  WasiSockRecvFromV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t RiDataPtr, uint32_t RiDataLen,
@@ -560,7 +587,7 @@ public:
 
 class WasiSockSendV2 : public Wasi<WasiSockSendV2> {
 public:
-  WasiSockSendV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SiDataPtr, uint32_t SiDataLen,
@@ -569,7 +596,7 @@ public:
 
 class WasiSockSendToV2 : public Wasi<WasiSockSendToV2> {
 public:
-  WasiSockSendToV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t SiDataPtr, uint32_t SiDataLen,
@@ -579,7 +606,7 @@ public:
 
 class WasiSockGetLocalAddrV2 : public Wasi<WasiSockGetLocalAddrV2> {
 public:
-  WasiSockGetLocalAddrV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t PortPtr);
@@ -587,7 +614,7 @@ public:
 
 class WasiSockGetPeerAddrV2 : public Wasi<WasiSockGetPeerAddrV2> {
 public:
-  WasiSockGetPeerAddrV2(WASI::Environ &HostEnv) : Wasi(HostEnv) {}
+  using Wasi::Wasi;
 
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame, int32_t Fd,
                         uint32_t AddressPtr, uint32_t PortPtr);
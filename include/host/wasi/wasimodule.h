@@ -6,6 +6,9 @@
 #include "host/wasi/environ.h"
 #include "runtime/instance/module.h"
 
+#include <memory>
+#include <string_view>
+
 namespace WasmEdge {
 namespace Host {
 
@@ -35,6 +38,25 @@ public:
 
   const WASI::Environ *getEnv() const noexcept { return &Env; }
 
+  /// Cache the path resolution of the pre-opened directories bound later.
+  void setEnablePathCache(bool IsEnable) noexcept {
+    Env.setEnablePathCache(IsEnable);
+  }
+
+  /// Share the listening ports with the other worker processes.
+  void setEnableReusePort(bool IsEnable) noexcept {
+    Env.setEnableReusePort(IsEnable);
+  }
+
+  /// Collect the I/O statistics of the WASI calls.
+  void setEnableIOStatistics(bool IsEnable) noexcept {
+    Env.getIOStatistics().setEnable(IsEnable);
+  }
+
+  const WASI::IOStatistics &getIOStatistics() const noexcept {
+    return Env.getIOStatistics();
+  }
+
 private:
   WASI::Environ Env;
 };
@@ -19,6 +19,7 @@
 #include "common/filesystem.h"
 #include "common/span.h"
 #include "llvm/data.h"
+#include "llvm/report.h"
 
 #include <mutex>
 
@@ -31,8 +32,13 @@ public:
   Expect<void> codegen(Span<const Byte> WasmData, Data D,
                        std::filesystem::path OutputPath) noexcept;
 
+  /// Record the code generation time and the machine code size of every
+  /// function in the report, which must outlive the code generations.
+  void setReport(CompileReport *R) noexcept { Report = R; }
+
 private:
   const Configure Conf;
+  CompileReport *Report = nullptr;
 };
 
 } // namespace WasmEdge::LLVM
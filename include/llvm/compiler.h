@@ -17,8 +17,10 @@
 #include "common/configure.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
+#include "common/profile.h"
 #include "common/span.h"
 #include "llvm/data.h"
+#include "llvm/report.h"
 
 #include <mutex>
 
@@ -33,11 +35,24 @@ public:
 
   Expect<Data> compile(const AST::Module &Module) noexcept;
 
+  /// Guide the optimizations by the execution profile of the same module. The
+  /// profile must outlive the compilations.
+  void setProfile(const Statistics::Profile *P) noexcept { Prof = P; }
+
+  /// Record the compile time and the IR size of every function in the report,
+  /// which must outlive the compilations.
+  void setReport(CompileReport *R) noexcept { Report = R; }
+
+  /// Leave every function unoptimized in a deferred partition of its own, for
+  /// the JIT to compile at its first call. Ignored with the function cache.
+  void setLazyFunctions(bool L) noexcept { LazyFunctions = L; }
+
   struct CompileContext;
 
 private:
   void compile(const AST::ImportSection &ImportSection) noexcept;
   void compile(const AST::ExportSection &ExportSection) noexcept;
+  void compile(const AST::TagSection &TagSection) noexcept;
   void compile(const AST::TypeSection &TypeSection) noexcept;
   void compile(const AST::GlobalSection &GlobalSection) noexcept;
   void compile(const AST::MemorySection &MemorySection,
@@ -50,6 +65,9 @@ private:
   std::mutex Mutex;
   CompileContext *Context;
   const Configure Conf;
+  const Statistics::Profile *Prof = nullptr;
+  CompileReport *Report = nullptr;
+  bool LazyFunctions = false;
 };
 
 } // namespace WasmEdge::LLVM
@@ -17,6 +17,9 @@
 #include "common/configure.h"
 #include "common/errcode.h"
 #include "llvm/data.h"
+
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace WasmEdge::LLVM {
@@ -24,7 +27,10 @@ class OrcLLJIT;
 
 class JITLibrary : public Executable {
 public:
-  JITLibrary(OrcLLJIT JIT) noexcept;
+  /// State of the functions compiled at their first calls.
+  struct LazyContext;
+
+  JITLibrary(OrcLLJIT JIT, std::unique_ptr<LazyContext> Lazy) noexcept;
   ~JITLibrary() noexcept override;
 
   Symbol<const IntrinsicsTable *> getIntrinsics() noexcept override;
@@ -36,6 +42,7 @@ public:
 
 private:
   OrcLLJIT *J;
+  std::unique_ptr<LazyContext> Lazy;
 };
 
 class JIT {
@@ -47,4 +54,19 @@ private:
   const Configure Conf;
 };
 
+/// Process-wide cache of the JIT executables, keyed by the BLAKE3 hash of the
+/// module bytes and the configurations affecting the generated code. The VMs
+/// loading the same module share one executable, which is released with its
+/// last user.
+class JITCache {
+public:
+  /// Get the executable of the module bytes, or call `Load` to create it when
+  /// no alive executable matches. Concurrent loads of the same key wait for
+  /// the first one instead of compiling again.
+  static Expect<std::shared_ptr<Executable>>
+  getOrLoad(Span<const Byte> Code, const Configure &Conf,
+            const std::function<Expect<std::shared_ptr<Executable>>()>
+                &Load) noexcept;
+};
+
 } // namespace WasmEdge::LLVM
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/llvm/report.h - Compile report definition ----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the report of the compile time and the code size of an
+/// AOT compilation.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge::LLVM {
+
+/// Compile time and code size of a module, filled in by the compiler and the
+/// code generator. The functions are keyed by their symbol names, e.g. `f3`
+/// for the function at index 3.
+class CompileReport {
+public:
+  struct Function {
+    /// IR instructions before and after the optimizations.
+    uint64_t Instructions = 0;
+    uint64_t OptimizedInstructions = 0;
+    /// Time of the optimization passes run on the function.
+    std::chrono::nanoseconds OptimizeTime{0};
+    /// Time of the code generation, only known if the function is emitted
+    /// alone, e.g. with the function cache.
+    std::chrono::nanoseconds CodegenTime{0};
+    /// Bytes of the machine code.
+    uint64_t CodeSize = 0;
+  };
+
+  struct Pass {
+    uint64_t Runs = 0;
+    /// Time of the pass itself, without the nested passes.
+    std::chrono::nanoseconds Time{0};
+  };
+
+  CompileReport() noexcept = default;
+  CompileReport(const CompileReport &) = delete;
+  CompileReport &operator=(const CompileReport &) = delete;
+
+  /// Record the IR instruction count of the function.
+  void recordInstructions(std::string_view Name, uint64_t Count,
+                          bool IsOptimized) noexcept;
+
+  /// Record a run of the pass. The function is empty for the passes run on
+  /// the module or the call graph.
+  void recordPass(std::string_view Name, std::string_view Function,
+                  std::chrono::nanoseconds Time) noexcept;
+
+  /// Record the code generation of an object with the functions.
+  void recordCodegen(Span<const std::string> Functions,
+                     std::chrono::nanoseconds Time) noexcept;
+
+  /// Record the machine code size of a recorded function.
+  void recordCodeSize(std::string_view Name, uint64_t Size) noexcept;
+
+  /// Record the time of a compilation phase, e.g. `optimize`.
+  void recordPhase(std::string_view Name,
+                   std::chrono::nanoseconds Time) noexcept;
+
+  /// Add the records of the other report into this one.
+  void merge(const CompileReport &Other) noexcept;
+
+  /// Getter of the function record, or nullptr if not recorded.
+  const Function *getFunction(std::string_view Name) const noexcept;
+
+  /// Getter of the pass record, or nullptr if not recorded.
+  const Pass *getPass(std::string_view Name) const noexcept;
+
+  bool empty() const noexcept;
+
+  /// Write the report to a JSON file.
+  Expect<void> save(const std::filesystem::path &Path) const noexcept;
+
+private:
+  mutable std::mutex Mutex;
+  std::map<std::string, Function, std::less<>> Functions;
+  std::map<std::string, Pass, std::less<>> Passes;
+  std::map<std::string, std::chrono::nanoseconds, std::less<>> Phases;
+  /// Function count and code generation time of every object.
+  std::vector<std::pair<uint64_t, std::chrono::nanoseconds>> Objects;
+};
+
+} // namespace WasmEdge::LLVM
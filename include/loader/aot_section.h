@@ -31,7 +31,8 @@ class AOTSection : public Executable {
 public:
   AOTSection() noexcept = default;
   ~AOTSection() noexcept override { unload(); }
-  Expect<void> load(const AST::AOTSection &AOTSec) noexcept;
+  Expect<void> load(const AST::AOTSection &AOTSec,
+                    bool HugePages = false) noexcept;
   void unload() noexcept;
 
   Symbol<const IntrinsicsTable *> getIntrinsics() noexcept override {
@@ -19,17 +19,61 @@
 #include "system/mmap.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
-#include <optional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace WasmEdge {
 
+/// Bytes of a wasm binary arriving in chunks, e.g. from the network. The
+/// loader decodes the arrived bytes while the producer appends the rest, and
+/// waits for the bytes it needs next. The total size is known ahead, so the
+/// buffer never moves.
+class CodeStream {
+public:
+  explicit CodeStream(size_t Size)
+      : Buffer(std::make_shared<std::vector<Byte>>(Size)) {}
+
+  /// Append the next chunk. Return false if the chunk exceeds the total size
+  /// or the stream is closed.
+  bool append(Span<const Byte> Chunk) noexcept;
+
+  /// End the stream before all bytes arrived, e.g. when the download fails.
+  /// The loader gets the unexpected end error for the missing bytes.
+  void close() noexcept;
+
+  /// Getter of the total size.
+  size_t size() const noexcept { return Buffer->size(); }
+
+  /// Wait until the first `End` bytes arrived or the stream is closed, and
+  /// return the count of the arrived bytes.
+  uint64_t wait(uint64_t End) noexcept;
+
+private:
+  friend class FileMgr;
+
+  std::shared_ptr<std::vector<Byte>> Buffer;
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  uint64_t Filled = 0;
+  bool Closed = false;
+};
+
 /// File manager interface.
+///
+/// The zstd-compressed data is detected by the magic bytes when built with
+/// `WASMEDGE_USE_ZSTD`, and decompressed by a worker thread into a stream,
+/// so that the loader decodes the module while the rest is decompressed.
 class FileMgr {
 public:
+  FileMgr() noexcept = default;
+  ~FileMgr() noexcept { reset(); }
+
   enum class FileHeader : uint8_t {
     // WASM or universal WASM.
     Wasm,
@@ -48,18 +92,33 @@ public:
   /// Set the file path.
   Expect<void> setPath(const std::filesystem::path &FilePath);
 
-  /// Set the binary data.
+  /// Set the binary data. The compressed data is read until reset, so it
+  /// should be kept alive until then.
   Expect<void> setCode(Span<const Byte> CodeData);
 
   /// Set the binary data.
   Expect<void> setCode(std::vector<Byte> CodeData);
 
+  /// Set the binary data arriving in the stream. The reads wait for the bytes
+  /// not arrived yet. The compressed stream is detected in getHeaderType().
+  Expect<void> setCode(std::shared_ptr<CodeStream> CodeData);
+
+  /// Check whether the binary data is from a stream.
+  bool isStreaming() const noexcept { return static_cast<bool>(Stream); }
+
+  /// Check whether the binary data is decompressed from the zstd frames.
+  bool isCompressed() const noexcept { return Compressed; }
+
   /// Read one byte.
   Expect<Byte> readByte();
 
   /// Read number of bytes into a vector.
   Expect<std::vector<Byte>> readBytes(size_t SizeToRead);
 
+  /// Read number of bytes as a view of the data without copying. The view
+  /// stays valid as long as the data holder is alive, see getDataHolder().
+  Expect<Span<const Byte>> readSpan(size_t SizeToRead);
+
   /// Read an unsigned int.
   Expect<uint32_t> readU32();
 
@@ -89,9 +148,34 @@ public:
   /// Peek one byte.
   Expect<Byte> peekByte();
 
-  /// Get the file header type.
+  /// Get the file header type. A compressed stream is switched to the
+  /// decompressed data first.
   FileHeader getHeaderType();
 
+  /// Get the owner of the data, which keeps the views from readSpan() valid
+  /// after the file manager is reset. Null if the data is borrowed from the
+  /// caller of setCode().
+  std::shared_ptr<const void> getDataHolder() const noexcept {
+    if (FileMap) {
+      return FileMap;
+    }
+    return DataHolder;
+  }
+
+  /// Get the mapped file, or null if the data is not from a file.
+  std::shared_ptr<MMap> getFileMap() const noexcept { return FileMap; }
+
+  /// Get the path of the mapped file, or empty if the data is not from a file.
+  const std::filesystem::path &getFilePath() const noexcept {
+    return MappedPath;
+  }
+
+  /// Get the whole data. The bytes stay valid as long as the file manager is
+  /// not reset or the data holder is alive.
+  Span<const Byte> getData() const noexcept {
+    return Span<const Byte>(Data, static_cast<size_t>(Size));
+  }
+
   /// Get current offset.
   uint64_t getOffset() const noexcept { return Pos; }
 
@@ -113,24 +197,43 @@ public:
     }
   }
 
-  /// Reset status
+  /// Reset status. The decompression in progress is cancelled, and the source
+  /// stream of it is closed.
   void reset() {
+    stopDecompression();
     Status = ErrCode::Value::UnexpectedEnd;
     LastPos = 0;
     Pos = 0;
     Size = 0;
     Data = nullptr;
     FileMap.reset();
+    MappedPath.clear();
     DataHolder.reset();
+    Stream.reset();
+    Arrived = 0;
+    Compressed = false;
   }
 
 private:
+  /// Helper function for setting the data decompressed from the zstd frames
+  /// in In[0 : InSize). The bytes of the source stream are waited for if set.
+  Expect<void> setCompressed(const Byte *In, uint64_t InSize,
+                             std::shared_ptr<CodeStream> InStream,
+                             std::shared_ptr<const void> InHolder);
+
+  /// Helper function for cancelling and joining the decompression.
+  void stopDecompression() noexcept;
+
   /// Helper function for reading number of bytes into a vector.
   Expect<void> readBytes(Span<Byte> Buffer);
 
   /// Helper function for checking boundary.
   Expect<void> testRead(uint64_t Read);
 
+  /// Helper function for loading the next 8 bytes as a little-endian word for
+  /// the fast paths, if they are ready without waiting for the stream.
+  bool peekWord(uint64_t &Word) const noexcept;
+
   /// File manager status.
   ErrCode::Value Status = ErrCode::Value::UnexpectedEnd;
 
@@ -148,8 +251,18 @@ private:
 
   /// File or data management.
   const Byte *Data;
-  std::optional<MMap> FileMap;
-  std::optional<std::vector<Byte>> DataHolder;
+  std::shared_ptr<MMap> FileMap;
+  std::filesystem::path MappedPath;
+  std::shared_ptr<std::vector<Byte>> DataHolder;
+
+  /// Stream of the data and the count of the bytes known to have arrived.
+  std::shared_ptr<CodeStream> Stream;
+  uint64_t Arrived = 0;
+
+  /// Worker thread of the decompression and its source stream.
+  bool Compressed = false;
+  std::thread Decompressor;
+  std::shared_ptr<CodeStream> Source;
 };
 
 } // namespace WasmEdge
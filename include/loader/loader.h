@@ -23,6 +23,7 @@
 #include "loader/shared_library.h"
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -235,6 +236,12 @@ public:
                       std::unique_ptr<AST::Module>>>
   parseWasmUnit(Span<const uint8_t> Code);
 
+  /// Parse module or component from byte code arriving in the stream. The
+  /// decoding overlaps with the arrival of the bytes.
+  Expect<std::variant<std::unique_ptr<AST::Component::Component>,
+                      std::unique_ptr<AST::Module>>>
+  parseWasmUnit(std::shared_ptr<CodeStream> Code);
+
   /// Parse module from file path.
   Expect<std::unique_ptr<AST::Module>>
   parseModule(const std::filesystem::path &FilePath);
@@ -242,6 +249,10 @@ public:
   /// Parse module from byte code.
   Expect<std::unique_ptr<AST::Module>> parseModule(Span<const uint8_t> Code);
 
+  /// Parse module from byte code arriving in the stream.
+  Expect<std::unique_ptr<AST::Module>>
+  parseModule(std::shared_ptr<CodeStream> Code);
+
   /// Serialize module into byte code.
   Expect<std::vector<Byte>> serializeModule(const AST::Module &Mod);
 
@@ -252,6 +263,31 @@ public:
   Expect<void> loadExecutable(AST::Module &Mod,
                               std::shared_ptr<Executable> Library);
 
+  /// Setter of the key function of the validated code cache, which returns
+  /// the cache file path of the module bytes and the path of the file they
+  /// are mapped from, empty if not from a file.
+  using CodeCacheKeyFunc = std::function<Expect<std::filesystem::path>(
+      Span<const Byte>, const std::filesystem::path &)>;
+  void setCodeCacheKey(CodeCacheKeyFunc Func) noexcept {
+    CodeCacheKey = std::move(Func);
+  }
+
+  /// Setter of the validator functions of the fused loading and validation.
+  /// The sections before the code section are validated when the code
+  /// section begins, and each function body right after it is decoded.
+  struct FusedValidatorFuncs {
+    std::function<Expect<void>(const AST::Module &)> Begin;
+    std::function<Expect<void>(AST::CodeSegment &)> Body;
+  };
+  void setFusedValidator(FusedValidatorFuncs Funcs) noexcept {
+    FusedValidator = std::move(Funcs);
+  }
+
+  /// Save the validated function bodies of the module into the code cache.
+  /// Only for the module missing the cache when loaded, and should be called
+  /// after the validation.
+  Expect<void> saveCodeCache(const AST::Module &Mod);
+
 private:
   /// \name Helper functions to print error log when loading AST nodes
   /// @{
@@ -273,6 +309,15 @@ private:
   }
   /// @}
 
+  /// Shared state of the deferred function bodies in the lazy loading mode.
+  struct LazyContext {
+    Configure Conf;
+    bool HasDataSection;
+    /// The whole input, kept alive by the holder.
+    Span<const Byte> Code;
+    std::shared_ptr<const void> Holder;
+  };
+
   /// \name Load AST Module functions
   /// @{
   // Load component or module unit.
@@ -287,6 +332,13 @@ private:
   Expect<void> loadModule(AST::Module &Mod,
                           std::optional<uint64_t> Bound = std::nullopt);
 
+  // Decode the function bodies skipped in the parallel loading mode.
+  Expect<void> loadParallelBodies(uint32_t ThreadCount);
+
+  // Load the validated function bodies from the code cache file. Returns
+  // false on a miss or a stale cache.
+  bool loadCodeCache(const std::filesystem::path &Path, Arena *BodyArena);
+
   // Load WASM for AOT.
   Expect<void> loadUniversalWASM(AST::Module &Mod);
   Expect<void> loadModuleAOT(AST::AOTSection &AOTSection);
@@ -407,6 +459,9 @@ private:
   Expect<void> loadType(AST::TagType &TgType);
   Expect<void> loadExpression(AST::Expression &Expr,
                               std::optional<uint64_t> SizeBound = std::nullopt);
+  static Expect<void> loadLazyExpression(const LazyContext &Ctx,
+                                         Span<const Byte> Body,
+                                         AST::Expression &Expr);
   Expect<OpCode> loadOpCode();
   Expect<AST::InstrVec> loadInstrSeq(std::optional<uint64_t> SizeBound);
   Expect<void> loadInstruction(AST::Instruction &Instr);
@@ -517,6 +572,30 @@ private:
   /// Input data type enumeration.
   enum class InputType : uint8_t { WASM, UniversalWASM, SharedLibrary };
   InputType WASMType = InputType::WASM;
+  /// Context of the code section being loaded in the lazy loading mode.
+  std::shared_ptr<const LazyContext> LazyCtx;
+  /// Arena of the module being loaded, and the reused buffer of decoding the
+  /// instruction sequences before copying them into the arena.
+  Arena *NodeArena = nullptr;
+  AST::InstrVec InstrBuffer;
+  /// Lock of the arena shared by the workers in the parallel loading mode.
+  std::mutex *ArenaMutex = nullptr;
+  /// In the parallel loading mode, the function bodies skipped in the code
+  /// section and decoded by the workers after.
+  bool ParallelLoad = false;
+  std::vector<std::pair<AST::CodeSegment *, Span<const Byte>>> ParallelBodies;
+  /// Key function of the validated code cache, and the bodies restored from
+  /// the cache for the module being loaded.
+  CodeCacheKeyFunc CodeCacheKey;
+  std::vector<AST::InstrVec> CachedBodies;
+  size_t NextCachedBody = 0;
+  /// Validator functions of the fused mode, and whether the function bodies
+  /// of the code section being loaded are validated when decoded.
+  FusedValidatorFuncs FusedValidator;
+  bool ValidateBodies = false;
+  /// Whether the AOT compiled code of the module being loaded is trusted, so
+  /// that the function bodies are neither decoded nor validated.
+  bool TrustedAOT = false;
   /// @}
 
   // Metadata
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #define EXPORT_GET_DESCRIPTOR(Descriptor)                                      \
@@ -148,14 +149,19 @@ public:
   // Static function to get default plugin paths.
   static std::vector<std::filesystem::path> getDefaultPluginPaths() noexcept;
 
-  // Static function to load all plugins from given path.
+  // Static function to load all plugins from given path. The plugins with the
+  // up-to-date manifests in the cache are registered without loading the
+  // libraries, which are loaded when their contents are used.
   WASMEDGE_EXPORT static bool load(const std::filesystem::path &Path) noexcept;
 
   // Static function to register plugin with descriptor.
   static bool registerPlugin(const PluginDescriptor *Desc) noexcept;
 
-  // Static function to add plugin options from arguments.
-  static void addPluginOptions(PO::ArgumentParser &Parser) noexcept;
+  // Static function to add plugin options from arguments. If the command line
+  // arguments are given, the deferred plugins are loaded only when their
+  // options or the help option are in the arguments.
+  static void addPluginOptions(PO::ArgumentParser &Parser,
+                               Span<const char *const> Args = {}) noexcept;
 
   // Static function to find loaded plugin by name.
   WASMEDGE_EXPORT static const Plugin *find(std::string_view Name) noexcept;
@@ -171,37 +177,44 @@ public:
   Plugin() noexcept = default;
   explicit Plugin(const PluginDescriptor *D) noexcept;
 
-  constexpr const char *name() const noexcept {
-    assuming(Desc);
-    return Desc->Name;
+  const char *name() const noexcept {
+    return Info ? Info->Name.c_str() : Desc->Name;
   }
 
-  constexpr const char *description() const noexcept {
-    assuming(Desc);
-    return Desc->Description;
+  const char *description() const noexcept {
+    return ensureLoaded() ? Desc->Description : "";
   }
 
-  constexpr VersionData version() const noexcept {
-    assuming(Desc);
-    return Desc->Version;
+  VersionData version() const noexcept {
+    return Info ? Info->Version : Desc->Version;
   }
 
   void registerOptions(PO::ArgumentParser &Parser) const noexcept {
-    assuming(Desc);
-    if (Desc->AddOptions) {
+    if (ensureLoaded() && Desc->AddOptions) {
       Desc->AddOptions(Desc, Parser);
     }
   }
 
   Span<const PluginModule> modules() const noexcept {
-    assuming(Desc);
+    ensureLoaded();
     return ModuleRegistry;
   }
   Span<const PluginComponent> components() const noexcept {
-    assuming(Desc);
+    ensureLoaded();
     return ComponentRegistry;
   }
 
+  // Check the library of the plugin is loaded. Thread-safe.
+  bool isLoaded() const noexcept;
+
+  // Check the plugin has the module without loading the library.
+  bool hasModule(std::string_view Name) const noexcept;
+
+  // Check the plugin has any component without loading the library.
+  bool hasComponents() const noexcept {
+    return Info ? !Info->Components.empty() : !ComponentRegistry.empty();
+  }
+
   WASMEDGE_EXPORT const PluginModule *
   findModule(std::string_view Name) const noexcept;
 
@@ -211,6 +224,16 @@ public:
   std::filesystem::path path() const noexcept { return Path; }
 
 private:
+  // Contents of a plugin recorded in the manifest, which are known without
+  // loading the library.
+  struct Manifest {
+    std::string Name;
+    VersionData Version;
+    std::vector<std::string> Options;
+    std::vector<std::string> Modules;
+    std::vector<std::string> Components;
+  };
+
   static std::mutex Mutex;
   static std::vector<Plugin> PluginRegistry;
   static std::unordered_map<std::string_view, std::size_t, Hash::Hash>
@@ -222,10 +245,31 @@ private:
   // Static function to register built-in plugins. Thread-safe.
   static void registerBuiltInPlugins() noexcept;
 
+  // Static function to load the library and get the plugin descriptor. Should
+  // be called with the lock held.
+  static const PluginDescriptor *
+  loadLibrary(const std::filesystem::path &Path,
+              std::shared_ptr<Loader::SharedLibrary> &Lib) noexcept;
+
+  // Static functions to read and write the manifest of the plugin library in
+  // the cache.
+  static std::unique_ptr<Manifest>
+  readManifest(const std::filesystem::path &Path) noexcept;
+  static void writeManifest(const Plugin &P) noexcept;
+
+  // Register the modules and components of the descriptor.
+  void setDescriptor(const PluginDescriptor *D) noexcept;
+
+  // Load the library of the deferred plugin. Thread-safe.
+  bool ensureLoaded() const noexcept;
+
   // Plugin contents.
   std::filesystem::path Path;
+  // Manifest of the deferred plugin, which owns the name in the lookup.
+  std::unique_ptr<const Manifest> Info;
   const PluginDescriptor *Desc = nullptr;
   std::shared_ptr<Loader::SharedLibrary> Lib;
+  bool LoadFailed = false;
   std::vector<PluginModule> ModuleRegistry;
   std::vector<PluginComponent> ComponentRegistry;
   std::unordered_map<std::string_view, std::size_t, Hash::Hash>
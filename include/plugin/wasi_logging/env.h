@@ -8,6 +8,7 @@
 
 #include "common/hexstr.h"
 #include "common/spdlog.h"
+#include "po/option.h"
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -54,6 +55,7 @@ public:
     } while (RegisteredID.find(InstanceID) != RegisteredID.cend());
     LogRegName = "wasi_logging_file_" + convertUIntToHexStr(InstanceID);
     RegisteredID.insert(InstanceID);
+    Async = AsyncMode.value();
   }
 
   ~LogEnv() noexcept {
@@ -71,6 +73,11 @@ public:
 
   uint64_t getInstanceID() const noexcept { return InstanceID; }
 
+  /// Write the messages on the background thread of the log queue.
+  bool isAsync() const noexcept { return Async; }
+  void setAsync(bool Value) noexcept { Async = Value; }
+
+  static PO::Option<PO::Toggle> AsyncMode;
   static std::mutex Mutex;
   static std::unordered_set<uint64_t> RegisteredID;
   static const std::string DefFormat;
@@ -82,6 +89,7 @@ private:
   std::string LogFileName;
   std::string LogRegName;
   uint64_t InstanceID;
+  bool Async = false;
 };
 
 } // namespace WASILogging
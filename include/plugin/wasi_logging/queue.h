@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+// BUILTIN-PLUGIN: Temporary move the wasi-logging plugin sources here until
+// the new plugin architecture ready in 0.15.0.
+
+#pragma once
+
+#include "common/spdlog.h"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASILogging {
+
+/// Process-wide queue of the asynchronous log messages.
+///
+/// The guest threads copy the messages into a bounded ring without locking,
+/// and a background thread formats and writes them in batches, flushing every
+/// logger once per batch. A message is dropped if the ring is full, so that
+/// the cost of a call is bounded under the log floods.
+class LogQueue {
+public:
+  /// Slots of the ring, which must be a power of two.
+  static inline constexpr const size_t kCapacity = 8192;
+
+  LogQueue(const LogQueue &) = delete;
+  LogQueue &operator=(const LogQueue &) = delete;
+  ~LogQueue() noexcept;
+
+  /// The queue of the process. The background thread starts at the first use.
+  static LogQueue &getDefault() noexcept;
+
+  /// Copy the message into the ring.
+  ///
+  /// @return False if the ring is full and the message is dropped.
+  bool push(std::shared_ptr<spdlog::logger> Logger,
+            spdlog::level::level_enum Level, std::string_view Message) noexcept;
+
+  /// Wait until the messages pushed before are written.
+  void flush() noexcept;
+
+  /// Getter of the count of the dropped messages.
+  uint64_t getDropped() const noexcept {
+    return Dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  LogQueue();
+
+  struct Slot {
+    /// Position of the slot when free for writing, or the position plus one
+    /// when written.
+    std::atomic<size_t> Sequence;
+    std::shared_ptr<spdlog::logger> Logger;
+    spdlog::level::level_enum Level;
+    spdlog::log_clock::time_point Time;
+    /// The capacity is kept by the later messages of the slot.
+    std::string Message;
+  };
+
+  /// Write the messages of the written slots in a batch.
+  void drain() noexcept;
+  void run() noexcept;
+
+  std::unique_ptr<Slot[]> Slots;
+  alignas(64) std::atomic<size_t> Head = 0;
+  alignas(64) size_t Tail = 0;
+  std::atomic<size_t> Written = 0;
+  std::atomic<uint64_t> Dropped = 0;
+  uint64_t ReportedDropped = 0;
+
+  std::mutex Mutex;
+  std::condition_variable Wakeup;
+  std::condition_variable Done;
+  bool Stop = false;
+  std::thread Flusher;
+};
+
+} // namespace WASILogging
+} // namespace Host
+} // namespace WasmEdge
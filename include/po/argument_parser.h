@@ -161,6 +161,18 @@ private:
                        std::string_view Desc) const noexcept;
     bool isHelp() const noexcept { return HelpOpt->value(); }
 
+    std::vector<std::string_view> option_names() const noexcept {
+      std::vector<std::string_view> Names;
+      const auto HelpIndex = OptionMap.find(HelpOpt.get())->second;
+      for (const auto Index : NonpositionalList) {
+        if (Index != HelpIndex) {
+          const auto &Options = ArgumentDescriptors[Index].options();
+          Names.insert(Names.end(), Options.begin(), Options.end());
+        }
+      }
+      return Names;
+    }
+
   private:
     cxx20::expected<ArgumentDescriptor *, Error>
     consume_short_options(std::string_view Arg) noexcept;
@@ -256,6 +268,11 @@ public:
     SubCommandDescriptors.front().help(Out);
   }
   bool isVersion() const noexcept { return VerOpt.value(); }
+  /// Getter of the names of the non-positional options in the current
+  /// subcommand, except the help option.
+  std::vector<std::string_view> option_names() const noexcept {
+    return SubCommandDescriptors[CurrentSubCommandId].option_names();
+  }
   bool isHelp() const noexcept {
     bool is_help_select = false;
     for (const auto &iter : SubCommandDescriptors) {
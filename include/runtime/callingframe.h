@@ -25,9 +25,9 @@ namespace Runtime {
 
 class CallingFrame {
 public:
-  CallingFrame(Executor::Executor *E,
-               const Instance::ModuleInstance *M) noexcept
-      : Exec(E), Module(M) {}
+  CallingFrame(Executor::Executor *E, const Instance::ModuleInstance *M,
+               const Instance::ModuleInstance *C = nullptr) noexcept
+      : Exec(E), Module(M), Callee(C) {}
 
   /// Get the current executor.
   Executor::Executor *getExecutor() const noexcept { return Exec; }
@@ -35,6 +35,11 @@ public:
   /// Get the current module on this frame.
   const Instance::ModuleInstance *getModule() const noexcept { return Module; }
 
+  /// Get the module of the called host function, or nullptr if unknown.
+  const Instance::ModuleInstance *getCalleeModule() const noexcept {
+    return Callee;
+  }
+
   /// Helper function of getting the WASI module.
   const Instance::ModuleInstance *getWASIModule() const noexcept {
     if (Module) {
@@ -56,6 +61,7 @@ public:
 private:
   Executor::Executor *Exec;
   const Instance::ModuleInstance *Module;
+  const Instance::ModuleInstance *Callee;
 };
 
 } // namespace Runtime
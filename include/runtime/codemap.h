@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/codemap.h - Code map definition ------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the code map, which maps the
+/// instructions and the native code addresses to the function indices of a
+/// module instance for the stack traces.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+#include "runtime/instance/function.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+
+/// Sorted code ranges of the functions in a module instance. The map is built
+/// once from the functions, and the addresses in the frames are looked up by
+/// binary search instead of collecting the functions for every trap.
+class CodeMap {
+public:
+  /// Build the map of the functions.
+  explicit CodeMap(
+      Span<const Instance::FunctionInstance *const> FuncInsts) noexcept {
+    for (uint32_t I = 0; I < FuncInsts.size(); ++I) {
+      const auto *Func = FuncInsts[I];
+      if (Func && Func->isWasmFunction()) {
+        const auto Instrs = Func->getInstrs();
+        if (Instrs.empty()) {
+          // The deferred body is not materialized yet.
+          Deferred.push_back(I);
+          continue;
+        }
+        Interpreted.push_back({toAddr(Instrs.data()), I});
+        Interpreted.push_back({toAddr(Instrs.data() + Instrs.size()), kEnd});
+      } else if (Func && Func->isCompiledFunction()) {
+        // The wrapper is recorded as the end of the previous function.
+        Compiled.push_back({toAddr(Func->getSymbol().get()), I});
+        Compiled.push_back(
+            {reinterpret_cast<uintptr_t>(Func->getFuncType().getSymbol().get()),
+             kEnd});
+      }
+    }
+    sortEntries(Interpreted);
+    sortEntries(Compiled);
+  }
+
+  /// Check the deferred bodies were materialized after the map was built.
+  bool isStale(
+      Span<const Instance::FunctionInstance *const> FuncInsts) const noexcept {
+    return std::any_of(Deferred.begin(), Deferred.end(), [&](uint32_t I) {
+      return I < FuncInsts.size() && !FuncInsts[I]->getInstrs().empty();
+    });
+  }
+
+  /// Find the function index of the instruction.
+  std::optional<uint32_t>
+  findInstruction(AST::InstrView::iterator Instr) const noexcept {
+    return find(Interpreted, toAddr(Instr));
+  }
+
+  /// Find the function index of the native code address.
+  std::optional<uint32_t> findNative(const void *Addr) const noexcept {
+    return find(Compiled, toAddr(Addr));
+  }
+
+private:
+  static inline constexpr uint32_t kEnd = UINT32_MAX;
+
+  struct Entry {
+    uintptr_t Addr;
+    /// Function index, or kEnd for the end of a function.
+    uint32_t Index;
+  };
+
+  static uintptr_t toAddr(const void *Ptr) noexcept {
+    return reinterpret_cast<uintptr_t>(Ptr);
+  }
+
+  /// Sort by address, and keep the function beginning over the end of the
+  /// previous function at the same address.
+  static void sortEntries(std::vector<Entry> &Entries) noexcept {
+    std::sort(Entries.begin(), Entries.end(),
+              [](const Entry &LHS, const Entry &RHS) {
+                return LHS.Addr < RHS.Addr ||
+                       (LHS.Addr == RHS.Addr && LHS.Index < RHS.Index);
+              });
+    Entries.erase(std::unique(Entries.begin(), Entries.end(),
+                              [](const Entry &LHS, const Entry &RHS) {
+                                return LHS.Addr == RHS.Addr;
+                              }),
+                  Entries.end());
+  }
+
+  /// The address is in the function of the last entry before it. The
+  /// beginnings of the functions are not in the frames.
+  static std::optional<uint32_t> find(const std::vector<Entry> &Entries,
+                                      uintptr_t Addr) noexcept {
+    auto Iter = std::lower_bound(
+        Entries.begin(), Entries.end(), Addr,
+        [](const Entry &E, uintptr_t A) { return E.Addr < A; });
+    if ((Iter != Entries.end() && Iter->Addr == Addr) ||
+        Iter == Entries.begin()) {
+      return std::nullopt;
+    }
+    --Iter;
+    if (Iter->Index == kEnd) {
+      return std::nullopt;
+    }
+    return Iter->Index;
+  }
+
+  std::vector<Entry> Interpreted;
+  std::vector<Entry> Compiled;
+  /// Indices of the functions with the deferred bodies.
+  std::vector<uint32_t> Deferred;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/cpubudget.h - CPU time budget definition ---------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the CPU time budget, which accounts
+/// the CPU time of the threads executing the functions of a module instance.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Runtime {
+
+class CpuBudget {
+public:
+  /// Set the limit of the CPU time in nanoseconds. 0 for no limit.
+  void setLimit(uint64_t Nanoseconds) noexcept {
+    Limit.store(Nanoseconds, std::memory_order_relaxed);
+  }
+
+  uint64_t getLimit() const noexcept {
+    return Limit.load(std::memory_order_relaxed);
+  }
+
+  /// Getter of the charged CPU time in nanoseconds.
+  uint64_t getUsage() const noexcept {
+    return Usage.load(std::memory_order_relaxed);
+  }
+
+  /// Check the usage is over the limit.
+  bool isExceeded() const noexcept {
+    const uint64_t L = getLimit();
+    return L > 0 && getUsage() > L;
+  }
+
+  /// Charge the CPU time, and return the usage after charging.
+  uint64_t charge(uint64_t Nanoseconds) noexcept {
+    return Usage.fetch_add(Nanoseconds, std::memory_order_relaxed) +
+           Nanoseconds;
+  }
+
+  /// Clear the usage, such as at the start of a scheduling period.
+  void reset() noexcept { Usage.store(0, std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> Usage = 0;
+  std::atomic<uint64_t> Limit = 0;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace WasmEdge {
@@ -29,6 +30,13 @@ class CallingFrame;
 
 class HostFunctionBase {
 public:
+  /// Entry of the host function for the calls from the compiled code, which
+  /// reads the arguments and writes the returns in the value slots directly.
+  /// The signature is already checked by the caller.
+  using FastCallT = Expect<void> (*)(HostFunctionBase &Func,
+                                     const CallingFrame &CallFrame,
+                                     const ValVariant *Args, ValVariant *Rets);
+
   HostFunctionBase() = delete;
   HostFunctionBase(const uint64_t FuncCost)
       : DefType(AST::FunctionType()), Cost(FuncCost) {}
@@ -50,15 +58,24 @@ public:
   /// Getter of defined type.
   const AST::SubType &getDefinedType() const noexcept { return DefType; }
 
+  /// Getter of the fast call entry. Nullptr if only run() is supported.
+  FastCallT getFastCall() const noexcept { return FastCall; }
+
 protected:
   AST::SubType DefType;
   const uint64_t Cost;
+  FastCallT FastCall = nullptr;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
 public:
   HostFunction(const uint64_t FuncCost = 0) : HostFunctionBase(FuncCost) {
     initializeFuncType();
+    // The subclasses overriding run() should set their own fast call entry.
+    if constexpr (std::is_same_v<decltype(&T::run),
+                                 decltype(&HostFunction::run)>) {
+      FastCall = &fastCall;
+    }
   }
 
   Expect<void> run(const CallingFrame &CallFrame, Span<const ValVariant> Args,
@@ -74,6 +91,15 @@ public:
   }
 
 protected:
+  static Expect<void> fastCall(HostFunctionBase &Func,
+                               const CallingFrame &CallFrame,
+                               const ValVariant *Args, ValVariant *Rets) {
+    using F = FuncTraits<decltype(&T::body)>;
+    return static_cast<HostFunction &>(Func).invoke(
+        CallFrame, Span<const ValVariant, F::ArgsN>(Args, F::ArgsN),
+        Span<ValVariant, F::RetsN>(Rets, F::RetsN));
+  }
+
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(const CallingFrame &CallFrame, SpanA &&Args,
                       SpanR &&Rets) {
@@ -18,6 +18,8 @@
 #include "common/types.h"
 #include "runtime/instance/composite.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 namespace WasmEdge {
@@ -27,40 +29,77 @@ namespace Instance {
 class ArrayInstance : public CompositeBase {
 public:
   ArrayInstance() = delete;
+  /// Construct the array with the byte size of the packed elements, which are
+  /// initialized with zeros.
   ArrayInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                const uint32_t Size, const ValVariant &Init) noexcept
-      : CompositeBase(Mod, Idx), Data(Size, Init) {
+                const uint32_t Size, const uint32_t ESize) noexcept
+      : CompositeBase(Mod, Idx), Length(Size), ElemSize(ESize),
+        Data(static_cast<size_t>(Size) * ESize) {
     assuming(ModInst);
   }
+  /// Construct the array filled with the packed value.
   ArrayInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                std::vector<ValVariant> &&Init) noexcept
-      : CompositeBase(Mod, Idx), Data(std::move(Init)) {
-    assuming(ModInst);
+                const uint32_t Size, const uint32_t ESize,
+                const ValVariant &Init) noexcept
+      : ArrayInstance(Mod, Idx, Size, ESize) {
+    fill(0, Size, Init);
   }
 
-  /// Get field data in array instance.
-  ValVariant &getData(uint32_t Idx) noexcept { return Data[Idx]; }
-  const ValVariant &getData(uint32_t Idx) const noexcept { return Data[Idx]; }
+  /// Get and set the packed element data in array instance.
+  ValVariant getData(uint32_t Idx) const noexcept {
+    assuming(Idx < Length);
+    return loadPacked(&Data[static_cast<size_t>(Idx) * ElemSize], ElemSize);
+  }
+  void setData(uint32_t Idx, const ValVariant &Val) noexcept {
+    assuming(Idx < Length);
+    storePacked(&Data[static_cast<size_t>(Idx) * ElemSize], ElemSize, Val);
+  }
 
-  /// Get full array.
-  Span<ValVariant> getArray() noexcept { return Data; }
-  Span<const ValVariant> getArray() const noexcept { return Data; }
+  /// Fill the elements of [Idx, Idx + Cnt) with the packed value.
+  void fill(uint32_t Idx, uint32_t Cnt, const ValVariant &Val) noexcept {
+    assuming(static_cast<uint64_t>(Idx) + Cnt <= Length);
+    if (Cnt == 0) {
+      return;
+    }
+    uint8_t *Ptr = &Data[static_cast<size_t>(Idx) * ElemSize];
+    const size_t Total = static_cast<size_t>(Cnt) * ElemSize;
+    storePacked(Ptr, ElemSize, Val);
+    if (ElemSize == 1) {
+      std::memset(Ptr, *Ptr, Total);
+      return;
+    }
+    // Double the filled bytes by copying themselves.
+    for (size_t Filled = ElemSize; Filled < Total; Filled *= 2) {
+      std::memcpy(Ptr + Filled, Ptr, std::min(Filled, Total - Filled));
+    }
+  }
+
+  /// Get the packed storage of the elements.
+  Span<uint8_t> getBytes() noexcept { return Data; }
+  Span<const uint8_t> getBytes() const noexcept { return Data; }
 
   /// Get array length.
-  uint32_t getLength() const noexcept {
-    return static_cast<uint32_t>(Data.size());
+  uint32_t getLength() const noexcept { return Length; }
+
+  /// Get the byte size of the packed elements.
+  uint32_t getElemSize() const noexcept { return ElemSize; }
+
+  /// Get the bytes charged to the memory budget of the owner module.
+  uint64_t getByteSize() const noexcept {
+    return sizeof(ArrayInstance) + Data.size();
   }
 
   /// Get boundary index.
   uint32_t getBoundIdx() const noexcept {
-    return std::max(static_cast<uint32_t>(Data.size()), UINT32_C(1)) -
-           UINT32_C(1);
+    return std::max(Length, UINT32_C(1)) - UINT32_C(1);
   }
 
 private:
   /// \name Data of array instance.
   /// @{
-  std::vector<ValVariant> Data;
+  uint32_t Length;
+  uint32_t ElemSize;
+  std::vector<uint8_t> Data;
   /// @}
 };
 
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+#pragma once
+
+#include "common/types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+namespace Instance {
+namespace Component {
+
+/// Canonical ABI adapter of a lifted component function, compiled once from
+/// the function type when lifting. The value types are resolved and
+/// despecialized into layouts, so that the values are lowered into and lifted
+/// from the core values and the linear memory without interpreting the types
+/// per call.
+struct CanonAdapter {
+  /// The despecialized value types. The tuples are records, and the enums,
+  /// options, and results are variants.
+  enum class Kind : uint8_t {
+    Bool,
+    S8,
+    U8,
+    S16,
+    U16,
+    S32,
+    U32,
+    S64,
+    U64,
+    F32,
+    F64,
+    Char,
+    String,
+    List,
+    Record,
+    Variant,
+    Flags,
+  };
+
+  /// Index of no payload in the variant cases.
+  static inline constexpr uint32_t NoPayload = UINT32_MAX;
+  /// Limits of the flattened parameters and results passed by values.
+  static inline constexpr uint32_t MaxFlatParams = 16;
+  static inline constexpr uint32_t MaxFlatResults = 1;
+
+  /// Layout of a value type.
+  struct Layout {
+    Kind Code = Kind::Bool;
+    /// Byte size and alignment in the linear memory.
+    uint32_t Size = 0;
+    uint32_t Align = 1;
+    /// Layout indices of the list element, of the record fields, or of the
+    /// variant case payloads.
+    std::vector<uint32_t> Children;
+    /// Byte offsets of the record fields.
+    std::vector<uint32_t> Offsets;
+    /// Byte size of the discriminant and offset of the payload of variants.
+    uint32_t DiscSize = 0;
+    uint32_t PayloadOffset = 0;
+    /// Count of the labels of flags.
+    uint32_t Labels = 0;
+    /// The value has strings or lists pointing into the linear memory.
+    bool UsesMemory = false;
+    /// Flattened core value types.
+    std::vector<ValType> Flat;
+  };
+
+  std::vector<Layout> Layouts;
+  /// Declared types and layout indices of the parameters and the results.
+  std::vector<ComponentValType> ParamTypes, ResultTypes;
+  std::vector<uint32_t> Params, Results;
+  /// Layout indices of the parameter and the result tuples in the memory.
+  uint32_t ParamTuple = 0, ResultTuple = 0;
+  /// Flattened core function type.
+  std::vector<ValType> CoreParams, CoreResults;
+  /// The parameters or the results are passed through the linear memory if
+  /// flattened into more than the limits.
+  bool ParamsInMemory = false, ResultsInMemory = false;
+  /// The lowering allocates in the linear memory by the realloc function, and
+  /// the lifting reads the linear memory.
+  bool NeedRealloc = false, NeedMemory = false;
+};
+
+} // namespace Component
+} // namespace Instance
+} // namespace Runtime
+} // namespace WasmEdge
@@ -19,6 +19,7 @@
 #include "common/errcode.h"
 #include "common/types.h"
 #include "runtime/instance/component/function.h"
+#include "runtime/instance/component/resource.h"
 #include "runtime/instance/module.h"
 
 #include <atomic>
@@ -316,6 +317,9 @@ public:
     return findExport(ExpCoreGlobInsts, Name);
   }
 
+  // Resource handles owned or borrowed by this instance.
+  Component::ResourceTable &getResourceTable() noexcept { return Resources; }
+
   // Index space: core type.
   // TODO: deep copy the type
   void addCoreType(const AST::Component::CoreDefType &Ty) noexcept {
@@ -354,6 +358,9 @@ private:
   // value
   std::vector<ComponentValVariant> ValueList;
 
+  // Resource handle table.
+  Component::ResourceTable Resources;
+
   // Index spaces.
   // The index spaces of AST should be cleaned after instantiation.
   std::vector<Component::FunctionInstance *> FuncInsts;
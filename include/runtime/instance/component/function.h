@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ast/component/type.h"
+#include "runtime/instance/component/canon.h"
 #include "runtime/instance/function.h"
 #include "runtime/instance/memory.h"
 
@@ -22,13 +23,16 @@ public:
   /// Move constructor.
   FunctionInstance(FunctionInstance &&Inst) noexcept
       : FuncType(Inst.FuncType), LowerFunc(Inst.LowerFunc),
-        MemInst(Inst.MemInst), ReallocFunc(Inst.ReallocFunc) {}
+        MemInst(Inst.MemInst), ReallocFunc(Inst.ReallocFunc),
+        Adapter(std::move(Inst.Adapter)) {}
   /// Constructor for component native function.
   FunctionInstance(const AST::Component::FuncType &Type,
                    Runtime::Instance::FunctionInstance *F,
                    Runtime::Instance::MemoryInstance *M,
-                   Runtime::Instance::FunctionInstance *R) noexcept
-      : FuncType(Type), LowerFunc(F), MemInst(M), ReallocFunc(R) {}
+                   Runtime::Instance::FunctionInstance *R,
+                   std::unique_ptr<const CanonAdapter> A) noexcept
+      : FuncType(Type), LowerFunc(F), MemInst(M), ReallocFunc(R),
+        Adapter(std::move(A)) {}
 
   /// Getter of component function type.
   const AST::Component::FuncType &getFuncType() const noexcept {
@@ -50,11 +54,15 @@ public:
     return ReallocFunc;
   }
 
+  /// Getter of canonical ABI adapter compiled from the function type.
+  const CanonAdapter &getAdapter() const noexcept { return *Adapter; }
+
 protected:
   const AST::Component::FuncType &FuncType;
   Runtime::Instance::FunctionInstance *LowerFunc;
   Runtime::Instance::MemoryInstance *MemInst;
   Runtime::Instance::FunctionInstance *ReallocFunc;
+  std::unique_ptr<const CanonAdapter> Adapter;
 };
 
 } // namespace Component
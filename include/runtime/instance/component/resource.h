@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/instance/component/resource.h - Resource table ---===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the resource handle table of the component instances.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/spdlog.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+namespace Instance {
+namespace Component {
+
+/// Borrows lent into a call of a lifted function. The scope lives on the
+/// native stack of the call, and the borrow handles refer to it, so that the
+/// borrows are counted without allocation.
+struct BorrowScope {
+  uint32_t NumBorrows = 0;
+};
+
+/// Table of the resource handles of a component instance.
+///
+/// A handle is the slot index tagged with the generation of the slot, so that
+/// the stale handles of the dropped resources are rejected after their slots
+/// are reused. The slots are allocated in the fixed-size slabs which are
+/// never moved, and the free slots are linked into a list, so that the
+/// handles are added, looked up, and removed in O(1) without allocation once
+/// the table is warmed up.
+class ResourceTable {
+public:
+  /// Resource handle entry.
+  struct Entry {
+    /// Identity of the resource type, nullptr for the free slots.
+    const void *Type = nullptr;
+    /// Representation of the resource.
+    uint32_t Rep = 0;
+    /// Count of the outstanding borrows of the own handle.
+    uint32_t LendCount = 0;
+    /// Call scope of the borrow handle, nullptr for the own handles.
+    BorrowScope *Scope = nullptr;
+
+    bool isOwn() const noexcept { return Scope == nullptr; }
+  };
+
+  /// Add an own handle of the resource.
+  Expect<uint32_t> addOwn(const void *Type, uint32_t Rep) noexcept {
+    return add(Type, Rep, nullptr);
+  }
+
+  /// Add a borrow handle of the resource lent into the call scope.
+  Expect<uint32_t> addBorrow(const void *Type, uint32_t Rep,
+                             BorrowScope &Scope) noexcept {
+    EXPECTED_TRY(uint32_t Handle, add(Type, Rep, &Scope));
+    ++Scope.NumBorrows;
+    return Handle;
+  }
+
+  /// Get the entry of the handle of the resource type.
+  Expect<Entry *> get(uint32_t Handle, const void *Type) noexcept {
+    using namespace std::literals;
+    const uint32_t Idx = Handle & IndexMask;
+    if (likely(Idx != 0 && Idx < Size)) {
+      auto &S = slot(Idx);
+      if (likely(S.E.Type != nullptr && S.E.Type == Type &&
+                 S.Gen == (Handle >> IndexBits))) {
+        return &S.E;
+      }
+    }
+    spdlog::error(ErrCode::Value::InvalidResourceHandle);
+    spdlog::error("    Unknown handle {} of the resource type."sv, Handle);
+    return Unexpect(ErrCode::Value::InvalidResourceHandle);
+  }
+
+  /// Lend the own handle for a borrow during a call, and return the entry.
+  /// The entry is kept valid until it is returned by `unlend()`.
+  Expect<Entry *> lend(uint32_t Handle, const void *Type) noexcept {
+    EXPECTED_TRY(auto *E, get(Handle, Type));
+    if (E->isOwn()) {
+      ++E->LendCount;
+    }
+    return E;
+  }
+
+  /// Return the own handle lent by `lend()` when the call exits.
+  static void unlend(Entry &E) noexcept {
+    if (E.isOwn()) {
+      --E.LendCount;
+    }
+  }
+
+  /// Remove the handle, and return the removed entry. The own handles with
+  /// outstanding borrows cannot be removed.
+  Expect<Entry> remove(uint32_t Handle, const void *Type) noexcept {
+    using namespace std::literals;
+    EXPECTED_TRY(auto *E, get(Handle, Type));
+    if (unlikely(E->isOwn() && E->LendCount != 0)) {
+      spdlog::error(ErrCode::Value::InvalidResourceHandle);
+      spdlog::error("    Resource of handle {} has {} outstanding borrows."sv,
+                    Handle, E->LendCount);
+      return Unexpect(ErrCode::Value::InvalidResourceHandle);
+    }
+    const Entry Removed = *E;
+    if (!Removed.isOwn()) {
+      --Removed.Scope->NumBorrows;
+    }
+    const uint32_t Idx = Handle & IndexMask;
+    auto &S = slot(Idx);
+    S.E = Entry();
+    S.Gen = (S.Gen + 1) & GenMask;
+    S.NextFree = FreeHead;
+    FreeHead = Idx;
+    return Removed;
+  }
+
+  /// Check that the borrows lent into the call are dropped when it exits.
+  static Expect<void> checkScope(const BorrowScope &Scope) noexcept {
+    using namespace std::literals;
+    if (unlikely(Scope.NumBorrows != 0)) {
+      spdlog::error(ErrCode::Value::InvalidResourceHandle);
+      spdlog::error("    {} borrow handles are not dropped in the call."sv,
+                    Scope.NumBorrows);
+      return Unexpect(ErrCode::Value::InvalidResourceHandle);
+    }
+    return {};
+  }
+
+private:
+  /// The handles are the 24-bit slot indices with the 8-bit generations. The
+  /// slot 0 is reserved, so that the handles are never zero.
+  static inline constexpr uint32_t IndexBits = 24;
+  static inline constexpr uint32_t IndexMask = (UINT32_C(1) << IndexBits) - 1;
+  static inline constexpr uint32_t GenMask = UINT32_MAX >> IndexBits;
+  static inline constexpr uint32_t SlabBits = 8;
+  static inline constexpr uint32_t SlabSize = UINT32_C(1) << SlabBits;
+
+  struct Slot {
+    Entry E;
+    uint32_t Gen = 0;
+    /// Next slot in the free list, 0 for the end.
+    uint32_t NextFree = 0;
+  };
+
+  Slot &slot(uint32_t Idx) noexcept {
+    return (*Slabs[Idx >> SlabBits])[Idx & (SlabSize - 1)];
+  }
+
+  Expect<uint32_t> add(const void *Type, uint32_t Rep,
+                       BorrowScope *Scope) noexcept {
+    using namespace std::literals;
+    uint32_t Idx = FreeHead;
+    if (Idx != 0) {
+      FreeHead = slot(Idx).NextFree;
+    } else {
+      if (unlikely(Size > IndexMask)) {
+        spdlog::error(ErrCode::Value::InvalidResourceHandle);
+        spdlog::error("    Resource table is full."sv);
+        return Unexpect(ErrCode::Value::InvalidResourceHandle);
+      }
+      if ((Size >> SlabBits) >= Slabs.size()) {
+        Slabs.push_back(std::make_unique<std::array<Slot, SlabSize>>());
+      }
+      Idx = Size++;
+    }
+    auto &S = slot(Idx);
+    S.E.Type = Type;
+    S.E.Rep = Rep;
+    S.E.LendCount = 0;
+    S.E.Scope = Scope;
+    return (S.Gen << IndexBits) | Idx;
+  }
+
+  std::vector<std::unique_ptr<std::array<Slot, SlabSize>>> Slabs;
+  /// Count of the slots ever used, including the reserved slot 0.
+  uint32_t Size = 1;
+  /// Head of the free slot list, 0 for empty.
+  uint32_t FreeHead = 0;
+};
+
+} // namespace Component
+} // namespace Instance
+} // namespace Runtime
+} // namespace WasmEdge
@@ -17,6 +17,8 @@
 #include "ast/type.h"
 #include "common/types.h"
 
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace WasmEdge {
@@ -52,6 +54,20 @@ public:
   }
 
 protected:
+  /// Load and store the field values in the packed storage of the struct and
+  /// array instances. The packed values are the first bytes of the values.
+  static ValVariant loadPacked(const uint8_t *Ptr, uint32_t Size) noexcept {
+    assuming(Size <= sizeof(ValVariant));
+    ValVariant Val(static_cast<uint128_t>(0U));
+    std::memcpy(&Val, Ptr, Size);
+    return Val;
+  }
+  static void storePacked(uint8_t *Ptr, uint32_t Size,
+                          const ValVariant &Val) noexcept {
+    assuming(Size <= sizeof(ValVariant));
+    std::memcpy(Ptr, &Val, Size);
+  }
+
   friend class ModuleInstance;
   void linkDefinedType(const ModuleInstance *Mod,
                        const uint32_t Index) noexcept {
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/instance/cont.h - Continuation Instance ----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the continuation instance definition in store manager.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "runtime/instance/composite.h"
+
+#include <memory>
+#include <utility>
+
+namespace WasmEdge {
+namespace Runtime {
+namespace Instance {
+
+class ContInstance : public CompositeBase {
+public:
+  /// Execution state of the continuation, kept by the executor. The state is
+  /// moved between the continuation instances on every suspension, as the
+  /// continuations are resumed at most once.
+  struct State {
+    virtual ~State() noexcept = default;
+  };
+
+  ContInstance() = delete;
+  ContInstance(const ModuleInstance *Mod, const uint32_t Idx,
+               std::unique_ptr<State> S) noexcept
+      : CompositeBase(Mod, Idx), St(std::move(S)) {
+    assuming(ModInst);
+  }
+
+  /// Getter of the execution state, nullptr if the continuation is resumed.
+  State *getState() const noexcept { return St.get(); }
+
+  /// Take the execution state for resuming the continuation.
+  std::unique_ptr<State> take() noexcept { return std::move(St); }
+
+  /// Get the bytes counted for the garbage collection of the owner module.
+  uint64_t getByteSize() const noexcept { return sizeof(ContInstance); }
+
+private:
+  /// \name Data of continuation instance.
+  /// @{
+  std::unique_ptr<State> St;
+  /// @}
+};
+
+} // namespace Instance
+} // namespace Runtime
+} // namespace WasmEdge
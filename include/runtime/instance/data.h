@@ -16,6 +16,7 @@
 #include "common/span.h"
 #include "common/types.h"
 
+#include <memory>
 #include <vector>
 
 namespace WasmEdge {
@@ -25,40 +26,69 @@ namespace Instance {
 class DataInstance {
 public:
   DataInstance() = delete;
-  DataInstance(const uint32_t Offset, Span<const Byte> Init) noexcept
+  DataInstance(const uint64_t Offset, Span<const Byte> Init) noexcept
       : Off(Offset), Data(Init.begin(), Init.end()) {}
+  /// Reference the data kept alive by the holder instead of copying it. The
+  /// data is copied if the holder is null.
+  DataInstance(const uint64_t Offset, Span<const Byte> Init,
+               std::shared_ptr<const void> Holder) noexcept
+      : Off(Offset), View(Init), Holder(std::move(Holder)) {
+    if (!this->Holder) {
+      Data.assign(Init.begin(), Init.end());
+    }
+  }
 
   /// Get offset in data instance.
-  uint32_t getOffset() const noexcept { return Off; }
+  uint64_t getOffset() const noexcept { return Off; }
 
   /// Get data in data instance.
-  Span<const Byte> getData() const noexcept { return Data; }
+  Span<const Byte> getData() const noexcept {
+    return Holder ? View : Span<const Byte>(Data);
+  }
 
   /// Load bytes to value.
   ValVariant loadValue(uint32_t Offset, uint32_t N) const noexcept {
     assuming(N <= 16);
     // Check the data boundary.
+    const auto Bytes = getData();
     if (unlikely(static_cast<uint64_t>(Offset) + static_cast<uint64_t>(N) >
-                 Data.size())) {
+                 Bytes.size())) {
       return 0;
     }
     // Load the data to the value.
     EndianValue<uint128_t> Value;
-    std::memcpy(&Value.raw(), &Data[Offset], N);
+    std::memcpy(&Value.raw(), &Bytes[Offset], N);
     if constexpr (Endian::native == Endian::big) {
       Value.raw() >>= (128 - N * 8);
     }
     return Value.le();
   }
 
+  /// Copy the data referenced without an owner, which is the data of the AST
+  /// module borrowed by the active data instances, so that it outlives the
+  /// AST module.
+  void ownData() {
+    if (Holder && Holder.use_count() == 0) {
+      Data.assign(View.begin(), View.end());
+      View = {};
+      Holder.reset();
+    }
+  }
+
   /// Clear data in data instance.
-  void clear() { Data.clear(); }
+  void clear() {
+    Data.clear();
+    View = {};
+    Holder.reset();
+  }
 
 private:
   /// \name Data of data instance.
   /// @{
-  const uint32_t Off;
+  const uint64_t Off;
   std::vector<Byte> Data;
+  Span<const Byte> View;
+  std::shared_ptr<const void> Holder;
   /// @}
 };
 
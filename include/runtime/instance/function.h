@@ -14,10 +14,13 @@
 #pragma once
 
 #include "ast/instruction.h"
+#include "ast/segment.h"
+#include "common/executable.h"
 #include "common/symbol.h"
 #include "runtime/hostfunc.h"
 #include "runtime/instance/composite.h"
 
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -33,11 +36,21 @@ class FunctionInstance : public CompositeBase {
 public:
   using CompiledFunction = void;
 
+  /// Compiled entry of a native wasm function, installed by the tiered
+  /// execution mode once the function becomes hot.
+  struct TieredEntry {
+    Symbol<Executable::Wrapper> Wrapper;
+    Symbol<CompiledFunction> Code;
+  };
+
   FunctionInstance() = delete;
   /// Move constructor.
   FunctionInstance(FunctionInstance &&Inst) noexcept
-      : CompositeBase(Inst.ModInst, Inst.TypeIdx), FuncType(Inst.FuncType),
-        Data(std::move(Inst.Data)) {
+      : CompositeBase(Inst.ModInst, Inst.TypeIdx),
+        NativeEntry(Inst.NativeEntry), FuncType(Inst.FuncType),
+        Data(std::move(Inst.Data)),
+        Hotness(Inst.Hotness.load(std::memory_order_relaxed)),
+        Tiered(Inst.Tiered.exchange(nullptr, std::memory_order_relaxed)) {
     assuming(ModInst);
   }
   /// Constructor for native function.
@@ -49,26 +62,61 @@ public:
         Data(std::in_place_type_t<WasmFunction>(), Locs, Expr) {
     assuming(ModInst);
   }
+  /// Constructor for native function with the deferred body in the lazy
+  /// loading mode.
+  FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
+                   const AST::FunctionType &Type,
+                   Span<const std::pair<uint32_t, ValType>> Locs,
+                   std::shared_ptr<AST::LazyFunctionBody> Body) noexcept
+      : CompositeBase(Mod, TIdx), FuncType(Type),
+        Data(std::in_place_type_t<WasmFunction>(), Locs, std::move(Body)) {
+    assuming(ModInst);
+  }
   /// Constructor for compiled function.
   FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
                    const AST::FunctionType &Type,
                    Symbol<CompiledFunction> S) noexcept
-      : CompositeBase(Mod, TIdx), FuncType(Type),
+      : CompositeBase(Mod, TIdx), NativeEntry(S.get()), FuncType(Type),
         Data(std::in_place_type_t<Symbol<CompiledFunction>>(), std::move(S)) {
     assuming(ModInst);
+    assuming(reinterpret_cast<const uint8_t *>(&NativeEntry) -
+                 reinterpret_cast<const uint8_t *>(this) ==
+             Executable::kFuncEntryOffset);
+  }
+  /// Constructor for the native or compiled function of a cloned module
+  /// instance. The function body is shared with the source function.
+  FunctionInstance(const ModuleInstance *Mod, const AST::FunctionType &Type,
+                   const FunctionInstance &Inst) noexcept
+      : CompositeBase(Mod, Inst.TypeIdx), NativeEntry(Inst.NativeEntry),
+        FuncType(Type), Data(cloneData(Inst.Data)) {
+    assuming(ModInst);
   }
+
   /// Constructors for host function.
   FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
                    std::unique_ptr<HostFunctionBase> &&Func) noexcept
       : CompositeBase(Mod, TIdx), FuncType(Func->getFuncType()),
-        Data(std::in_place_type_t<std::unique_ptr<HostFunctionBase>>(),
-             std::move(Func)) {
+        Data(std::in_place_type_t<HostFuncPtr>(), Func.release(),
+             HostFuncDeleter{false}) {
     assuming(ModInst);
   }
   FunctionInstance(std::unique_ptr<HostFunctionBase> &&Func) noexcept
       : CompositeBase(), FuncType(Func->getFuncType()),
-        Data(std::in_place_type_t<std::unique_ptr<HostFunctionBase>>(),
-             std::move(Func)) {}
+        Data(std::in_place_type_t<HostFuncPtr>(), Func.release(),
+             HostFuncDeleter{false}) {}
+  /// Constructor for the host function shared between the module instances,
+  /// which is not owned and should outlive this function instance.
+  FunctionInstance(const ModuleInstance *Mod, const uint32_t TIdx,
+                   HostFunctionBase &Func) noexcept
+      : CompositeBase(Mod, TIdx), FuncType(Func.getFuncType()),
+        Data(std::in_place_type_t<HostFuncPtr>(), &Func,
+             HostFuncDeleter{true}) {
+    assuming(ModInst);
+  }
+
+  ~FunctionInstance() noexcept {
+    delete Tiered.load(std::memory_order_relaxed);
+  }
 
   /// Getter of checking is native wasm function.
   bool isWasmFunction() const noexcept {
@@ -82,7 +130,7 @@ public:
 
   /// Getter of checking is host function.
   bool isHostFunction() const noexcept {
-    return std::holds_alternative<std::unique_ptr<HostFunctionBase>>(Data);
+    return std::holds_alternative<HostFuncPtr>(Data);
   }
 
   /// Getter of function type.
@@ -98,15 +146,27 @@ public:
     return std::get_if<WasmFunction>(&Data)->LocalNum;
   }
 
-  /// Getter of function body instrs.
+  /// Getter of function body instrs. Empty for the deferred body before
+  /// materialized.
   AST::InstrView getInstrs() const noexcept {
-    if (std::holds_alternative<WasmFunction>(Data)) {
-      return std::get<WasmFunction>(Data).Instrs;
+    if (const auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return Func->LazyBody ? Func->LazyBody->getInstrs()
+                            : AST::InstrView(*Func->Instrs);
     } else {
       return {};
     }
   }
 
+  /// Decode and validate the deferred body in the lazy loading mode. No-op
+  /// for the other functions.
+  Expect<void> materialize() const noexcept {
+    if (const auto *Func = std::get_if<WasmFunction>(&Data);
+        Func && Func->LazyBody) {
+      return Func->LazyBody->materialize();
+    }
+    return {};
+  }
+
   /// Getter of symbol
   auto &getSymbol() const noexcept {
     return *std::get_if<Symbol<CompiledFunction>>(&Data);
@@ -114,14 +174,41 @@ public:
 
   /// Getter of host function.
   HostFunctionBase &getHostFunc() const noexcept {
-    return *std::get_if<std::unique_ptr<HostFunctionBase>>(&Data)->get();
+    return *std::get_if<HostFuncPtr>(&Data)->get();
+  }
+
+  /// Increase the hotness of a native wasm function and return the new value.
+  /// The counter is not synchronized between threads, so concurrent callers
+  /// may lose updates; it is only a heuristic for the tiered execution mode.
+  uint32_t addHotness() const noexcept {
+    const uint32_t Value = Hotness.load(std::memory_order_relaxed) + 1;
+    Hotness.store(Value, std::memory_order_relaxed);
+    return Value;
+  }
+
+  /// Getter of the compiled entry installed by the tiered execution mode.
+  /// nullptr if the function still runs in the interpreter.
+  const TieredEntry *getTieredEntry() const noexcept {
+    return Tiered.load(std::memory_order_acquire);
+  }
+
+  /// Install the compiled entry of a native wasm function. Only the first
+  /// installed entry is kept.
+  void setTieredEntry(std::unique_ptr<TieredEntry> Entry) const noexcept {
+    const TieredEntry *Expected = nullptr;
+    if (Tiered.compare_exchange_strong(Expected, Entry.get(),
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+      Entry.release();
+    }
   }
 
 private:
   struct WasmFunction {
     const std::vector<std::pair<uint32_t, ValType>> Locals;
     const uint32_t LocalNum;
-    AST::InstrVec Instrs;
+    /// Shared with the functions of the cloned module instances.
+    std::shared_ptr<const AST::InstrVec> Instrs;
     WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
                  AST::InstrView Expr) noexcept
         : Locals(Locs.begin(), Locs.end()),
@@ -131,18 +218,57 @@ private:
                                 return N + Pair.first;
                               })) {
       // FIXME: Modify the capacity to prevent from connection of 2 vectors.
-      Instrs.reserve(Expr.size() + 1);
-      Instrs.assign(Expr.begin(), Expr.end());
+      auto Vec = std::make_shared<AST::InstrVec>();
+      Vec->reserve(Expr.size() + 1);
+      Vec->assign(Expr.begin(), Expr.end());
+      Instrs = std::move(Vec);
     }
+    WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
+                 std::shared_ptr<AST::LazyFunctionBody> Body) noexcept
+        : WasmFunction(Locs, AST::InstrView()) {
+      LazyBody = std::move(Body);
+    }
+    std::shared_ptr<AST::LazyFunctionBody> LazyBody;
   };
 
+  /// Deleter of the host functions, which keeps the shared ones.
+  struct HostFuncDeleter {
+    bool Shared;
+    void operator()(HostFunctionBase *Func) const noexcept {
+      if (!Shared) {
+        delete Func;
+      }
+    }
+  };
+  using HostFuncPtr = std::unique_ptr<HostFunctionBase, HostFuncDeleter>;
+
+  using DataType =
+      std::variant<WasmFunction, Symbol<CompiledFunction>, HostFuncPtr>;
+
+  /// Copy the data of a native or compiled function.
+  static DataType cloneData(const DataType &Src) noexcept {
+    if (const auto *Func = std::get_if<WasmFunction>(&Src)) {
+      return DataType(std::in_place_type_t<WasmFunction>(), *Func);
+    }
+    assuming(std::holds_alternative<Symbol<CompiledFunction>>(Src));
+    return DataType(std::in_place_type_t<Symbol<CompiledFunction>>(),
+                    *std::get_if<Symbol<CompiledFunction>>(&Src));
+  }
+
   /// \name Data of function instance.
   /// @{
 
+  /// Entry of the compiled function, or nullptr for the others. Kept first
+  /// at Executable::kFuncEntryOffset for the compiled call_ref.
+  void *NativeEntry = nullptr;
   const AST::FunctionType &FuncType;
-  std::variant<WasmFunction, Symbol<CompiledFunction>,
-               std::unique_ptr<HostFunctionBase>>
-      Data;
+  DataType Data;
+  /// @}
+
+  /// \name Data of the tiered execution mode.
+  /// @{
+  mutable std::atomic<uint32_t> Hotness = 0;
+  mutable std::atomic<const TieredEntry *> Tiered = nullptr;
   /// @}
 };
 
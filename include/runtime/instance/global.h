@@ -29,22 +29,34 @@ public:
              GType.getValType().isNullableRefType() ||
              !Val.get<RefVariant>().isNull());
   }
+  GlobalInstance(const GlobalInstance &) = delete;
+  GlobalInstance &operator=(const GlobalInstance &) = delete;
 
   /// Getter of global type.
   const AST::GlobalType &getGlobalType() const noexcept { return GlobType; }
 
   /// Getter of value.
-  const ValVariant &getValue() const noexcept { return Value; }
-  ValVariant &getValue() noexcept { return Value; }
+  const ValVariant &getValue() const noexcept { return *Slot; }
+  ValVariant &getValue() noexcept { return *Slot; }
 
   /// Setter of value.
-  void setValue(const ValVariant &Val) noexcept { Value = Val; }
+  void setValue(const ValVariant &Val) noexcept { *Slot = Val; }
+
+  /// Move the value into the slot in the contiguous global values of the
+  /// owner module instance, which is read by the compiled functions at a fixed
+  /// offset.
+  void bindSlot(ValVariant *S) noexcept {
+    *S = *Slot;
+    Slot = S;
+  }
 
 private:
   /// \name Data of global instance.
   /// @{
   AST::GlobalType GlobType;
   alignas(16) ValVariant Value;
+  /// Storage of the value, which is the value above unless bound.
+  ValVariant *Slot = &Value;
   /// @}
 };
 
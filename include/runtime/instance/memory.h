@@ -19,14 +19,19 @@
 #include "common/int128.h"
 #include "common/spdlog.h"
 #include "common/types.h"
+#include "runtime/membudget.h"
 #include "system/allocator.h"
+#include "system/memimage.h"
+#include "system/numa.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <memory>
 #include <set>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -34,16 +39,38 @@ namespace WasmEdge {
 namespace Runtime {
 namespace Instance {
 
+/// Memory instance.
+///
+/// The grows of the shared memories are safe to run concurrently with each
+/// other and with the accesses of the other threads. The page count and the
+/// data size are published by the release stores after the pages are
+/// committed, and read by the acquire loads without locks, so that the
+/// accesses within the observed size never fault. On the platforms with the
+/// stable allocator, the pages are reserved up to the maximum when allocating
+/// and the data never moves.
 class MemoryInstance {
 
 public:
   static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
   static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
+  /// Maximum static offset of the accesses which are always trapped by the
+  /// guard region of the allocator, for any 32-bit address and value size.
+  static inline constexpr const uint64_t kGuardedOffsetLimit = k4G - 16;
+  /// Maximum reserved pages of the 64-bit memories, which is 1 TiB.
+  static inline constexpr const uint32_t kMaxReservedPages = UINT32_C(1) << 24;
   MemoryInstance() = delete;
   MemoryInstance(MemoryInstance &&Inst) noexcept
       : MemType(Inst.MemType), DataPtr(Inst.DataPtr),
-        PageLimit(Inst.PageLimit) {
+        PageLimit(Inst.PageLimit), ReservedPages(Inst.ReservedPages),
+        ImageSize(Inst.ImageSize), FileMapped(Inst.FileMapped),
+        ReadOnly(Inst.ReadOnly), Striped(Inst.Striped), Budget(Inst.Budget),
+        PublishedPages(Inst.PublishedPages.load(std::memory_order_relaxed)),
+        ClaimedPages(Inst.ClaimedPages.load(std::memory_order_relaxed)),
+        Generation(Inst.Generation.load(std::memory_order_relaxed)),
+        DataSize(Inst.DataSize.load(std::memory_order_relaxed)) {
     Inst.DataPtr = nullptr;
+    Inst.ImageSize = 0;
+    Inst.Budget = nullptr;
   }
   MemoryInstance(const AST::MemoryType &MType,
                  uint32_t PageLim = UINT32_C(65536)) noexcept
@@ -54,90 +81,300 @@ public:
                     PageLimit);
       MemType.getLimit().setMin(PageLimit);
     }
-    DataPtr = Allocator::allocate(MemType.getLimit().getMin());
+    if (is64()) {
+      // The 64-bit memories reserve the pages up to the maximum, which is
+      // limited by the configuration, and never move when growing.
+      const auto &Limit = MemType.getLimit();
+      ReservedPages = std::max(
+          std::min({Limit.hasMax() ? Limit.getMax() : UINT32_MAX, PageLimit,
+                    kMaxReservedPages}),
+          Limit.getMin());
+      DataPtr = Allocator::allocate64(Limit.getMin(), ReservedPages);
+    } else {
+      // The memories never growing beyond a slot are striped if enabled.
+      const auto &Limit = MemType.getLimit();
+      if (const uint32_t SlotPages = Allocator::getStripedSlotPages();
+          SlotPages > 0 &&
+          std::min(Limit.hasMax() ? Limit.getMax() : UINT32_C(65536),
+                   PageLimit) <= SlotPages) {
+        DataPtr = Allocator::allocateStriped(Limit.getMin());
+        Striped = DataPtr != nullptr;
+      }
+      if (DataPtr == nullptr) {
+        DataPtr = Allocator::allocate(Limit.getMin());
+      }
+    }
     if (DataPtr == nullptr) {
       spdlog::error("Memory Instance: Unable to find usable memory address."sv);
-      MemType.getLimit().setMin(0U);
+      setPages(0U);
       return;
     }
+    setPages(MemType.getLimit().getMin());
   }
   ~MemoryInstance() noexcept {
-    Allocator::release(DataPtr, MemType.getLimit().getMin());
+    if (ImageSize > 0) {
+      // Restore the anonymous pages before releasing them to the allocator.
+      MemoryImage::unmap(DataPtr, ImageSize);
+    }
+    if (is64()) {
+      Allocator::release64(DataPtr, ReservedPages);
+    } else {
+      Allocator::release(DataPtr, getPageSize());
+    }
+    if (Budget) {
+      Budget->release(getPageSize() * kPageSize);
+    }
+  }
+
+  /// Charge the pages to the memory budget of the owner module instance.
+  void setBudget(MemoryBudget *B) noexcept {
+    assuming(Budget == nullptr);
+    Budget = B;
+    Budget->forceCharge(getPageSize() * kPageSize);
+  }
+
+  /// Map the initialized image copy-on-write at the start of the untouched
+  /// memory instead of copying the data into it, or over the same copied data
+  /// to share the pages. On failure, the pages are zeroed.
+  bool mapImage(const MemoryImage &Image) noexcept {
+    if (ImageSize > 0 || DataPtr == nullptr ||
+        Image.size() > getPageSize() * kPageSize) {
+      return false;
+    }
+    if (!Image.map(DataPtr)) {
+      MemoryImage::unmap(DataPtr, Image.size());
+      return false;
+    }
+    ImageSize = Image.size();
+    return true;
+  }
+
+  /// Map the file shared over the whole memory instead of the anonymous
+  /// pages, so that the data is shared with the host and the other memories
+  /// mapping the same file without copies. The file should have at least the
+  /// bytes of the pages, and the memory never grows or restores the snapshots
+  /// after mapped. The writes to the read-only memory trap as out of bounds in
+  /// the executions, and fail in the setters and the accessors of the
+  /// non-const data for the hosts.
+  bool mapFile(int File, bool Writable) noexcept {
+    const uint64_t Size = getPageSize() * kPageSize;
+    if (ImageSize > 0 || DataPtr == nullptr || Size == 0 ||
+        !MemoryImage::mapShared(File, DataPtr, Size, Writable)) {
+      return false;
+    }
+    ImageSize = Size;
+    FileMapped = true;
+    ReadOnly = !Writable;
+    return true;
+  }
+
+  /// Check the data is mapped from a file by `mapFile()`.
+  bool isFileMapped() const noexcept { return FileMapped; }
+
+  /// Check the data is mapped from a file read-only.
+  bool isReadOnly() const noexcept { return ReadOnly; }
+
+  /// Prefer the NUMA node for the pages of the memory. The whole reservation
+  /// is bound, so the pages of the later growth are placed on the node too.
+  bool bindNumaNode(uint32_t Node [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_IS_STABLE
+    const uint64_t Size =
+        Striped ? Allocator::getStripedSlotPages() * kPageSize
+                : getGuardedAddressLimit();
+    return DataPtr != nullptr && Numa::bindMemory(DataPtr, Size, Node);
+#else
+    // The memory moves when growing.
+    return false;
+#endif
+  }
+
+  /// Grow or shrink the memory to the page count of a snapshot. The data
+  /// should be restored after, and no grow should be in progress.
+  bool resetPages(uint32_t Pages) noexcept {
+    if (FileMapped) {
+      return false;
+    }
+    const uint32_t Min = getPageSize();
+    if (Pages >= Min) {
+      return growPage(Pages - Min);
+    }
+    if (DataPtr == nullptr || !Allocator::shrink(DataPtr, Min, Pages)) {
+      return false;
+    }
+    // The image mapped in the released pages is replaced.
+    ImageSize = std::min(ImageSize, Pages * kPageSize);
+    if (Budget) {
+      Budget->release((Min - Pages) * kPageSize);
+    }
+    setPages(Pages);
+    Generation.fetch_add(1, std::memory_order_release);
+    return true;
+  }
+
+  /// Restore the data of the whole memory from the image of a snapshot by
+  /// mapping it copy-on-write again, so that only the pages touched after the
+  /// last mapping are dropped instead of copying all the data back.
+  bool restoreImage(const MemoryImage &Image) noexcept {
+    if (DataPtr == nullptr || FileMapped ||
+        Image.size() != getPageSize() * kPageSize) {
+      return false;
+    }
+    if (!Image.map(DataPtr)) {
+      MemoryImage::unmap(DataPtr, Image.size());
+      ImageSize = 0;
+      return false;
+    }
+    ImageSize = Image.size();
+    return true;
   }
 
   bool isShared() const noexcept { return MemType.getLimit().isShared(); }
 
+  /// Check the memory is in a slot striped with the other memories, which are
+  /// isolated by the protection keys for the compiled code only.
+  bool isStriped() const noexcept { return Striped; }
+
+  /// Check the memory is indexed by the 64-bit addresses.
+  bool is64() const noexcept { return MemType.getLimit().is64(); }
+
   /// Get page size of memory.data
   uint32_t getPageSize() const noexcept {
-    // The memory page size is binded with the limit in memory type.
-    return MemType.getLimit().getMin();
+    return PublishedPages.load(std::memory_order_acquire);
+  }
+
+  /// Getter of memory type. The minimum of the limit is the page count, which
+  /// is read from the published page count, as the shared memory may be grown
+  /// by the other threads.
+  AST::MemoryType getMemoryType() const noexcept {
+    AST::MemoryType Type = MemType;
+    Type.getLimit().setMin(getPageSize());
+    return Type;
   }
 
-  /// Getter of memory type.
-  const AST::MemoryType &getMemoryType() const noexcept { return MemType; }
+  /// Getter of the memory type at the instantiation, whose minimum of the
+  /// limit is the initial page count.
+  const AST::MemoryType &getInitialMemoryType() const noexcept {
+    return MemType;
+  }
+
+  /// Getter of the count of the successful grows. The pointers and the sizes
+  /// of the data borrowed by the hosts are invalidated when it changes.
+  uint64_t getGeneration() const noexcept {
+    return Generation.load(std::memory_order_acquire);
+  }
 
   /// Check access size is valid.
-  bool checkAccessBound(uint32_t Offset, uint32_t Length) const noexcept {
-    const uint64_t AccessLen =
-        static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length);
-    return AccessLen <= MemType.getLimit().getMin() * kPageSize;
+  bool checkAccessBound(uint64_t Offset, uint64_t Length) const noexcept {
+    const uint64_t Size = getPageSize() * kPageSize;
+    return Offset <= Size && Length <= Size - Offset;
+  }
+
+  /// Getter of the exclusive limit of the addresses, under which the accesses
+  /// with the static offsets up to `kGuardedOffsetLimit` are in the memory or
+  /// fault in the guard region of the allocator.
+  uint64_t getGuardedAddressLimit() const noexcept {
+    if (is64()) {
+      return ReservedPages * kPageSize;
+    }
+    // The accesses beyond a striped memory reach the other memories.
+    return Striped ? 0 : k4G;
   }
 
   /// Get boundary index.
-  uint32_t getBoundIdx() const noexcept {
-    return MemType.getLimit().getMin() > 0
-               ? MemType.getLimit().getMin() * kPageSize - 1
-               : 0;
+  uint64_t getBoundIdx() const noexcept {
+    const uint32_t Pages = getPageSize();
+    return Pages > 0 ? Pages * kPageSize - 1 : 0;
   }
 
   /// Grow page
   bool growPage(const uint32_t Count) {
+    uint32_t OldPages;
+    return growPage(Count, OldPages);
+  }
+
+  /// Grow the pages, and get the page count before the grow on success.
+  ///
+  /// The pages are admitted against the limits by the compare-and-swap of the
+  /// claimed page count, so that the failed grows return without waiting for
+  /// the others. The admitted grows commit the pages and publish the new size
+  /// one after another in the order of their tickets, as the committed pages
+  /// should be contiguous, and the readers never wait for them.
+  bool growPage(const uint32_t Count, uint32_t &OldPages) {
     if (Count == 0) {
+      OldPages = getPageSize();
       return true;
     }
-    // Maximum pages count, 65536
-    uint32_t MaxPageCaped = k4G / kPageSize;
-    uint32_t Min = MemType.getLimit().getMin();
-    assuming(MaxPageCaped >= Min);
+    if (FileMapped) {
+      return false;
+    }
+    // Maximum pages count, 65536, or the reserved pages of 64-bit memories.
+    uint32_t MaxPageCaped =
+        is64() ? ReservedPages : static_cast<uint32_t>(k4G / kPageSize);
     if (MemType.getLimit().hasMax()) {
-      uint32_t Max = MemType.getLimit().getMax();
-      assuming(Max >= Min);
-      MaxPageCaped = std::min(Max, MaxPageCaped);
+      MaxPageCaped = std::min(MemType.getLimit().getMax(), MaxPageCaped);
     }
-    if (Count > MaxPageCaped - Min) {
+    uint32_t Claimed = ClaimedPages.load(std::memory_order_relaxed);
+    do {
+      assuming(MaxPageCaped >= Claimed);
+      if (Count > MaxPageCaped - Claimed) {
+        return false;
+      }
+      assuming(PageLimit >= Claimed);
+      if (Count > PageLimit - Claimed) {
+        spdlog::error("Memory Instance: Memory grow page failed, exceeded "
+                      "limited {} page size in configuration.",
+                      PageLimit);
+        return false;
+      }
+    } while (!ClaimedPages.compare_exchange_weak(Claimed, Claimed + Count,
+                                                 std::memory_order_relaxed));
+    if (Budget && !Budget->charge(Count * kPageSize, true)) {
+      ClaimedPages.fetch_sub(Count, std::memory_order_relaxed);
       return false;
     }
-    assuming(PageLimit >= Min);
-    if (Count > PageLimit - Min) {
-      spdlog::error("Memory Instance: Memory grow page failed, exceeded "
-                    "limited {} page size in configuration.",
-                    PageLimit);
-      return false;
+
+    // Wait for the earlier admitted grows to publish their pages.
+    const uint32_t Ticket = NextTicket.fetch_add(1, std::memory_order_relaxed);
+    while (ServingTicket.load(std::memory_order_acquire) != Ticket) {
+      std::this_thread::yield();
     }
+    const uint32_t Min = PublishedPages.load(std::memory_order_relaxed);
+    bool Success = false;
     if (auto NewPtr = Allocator::resize(DataPtr, Min, Min + Count);
         NewPtr == nullptr) {
-      return false;
+      ClaimedPages.fetch_sub(Count, std::memory_order_relaxed);
+      if (Budget) {
+        Budget->release(Count * kPageSize);
+      }
     } else {
-      DataPtr = NewPtr;
+      // The data only moves without the stable allocator.
+      if (NewPtr != DataPtr) {
+        DataPtr = NewPtr;
+      }
+      Generation.fetch_add(1, std::memory_order_relaxed);
+      DataSize.store((Min + Count) * kPageSize, std::memory_order_release);
+      PublishedPages.store(Min + Count, std::memory_order_release);
+      OldPages = Min;
+      Success = true;
     }
-    MemType.getLimit().setMin(Min + Count);
-    return true;
+    ServingTicket.store(Ticket + 1, std::memory_order_release);
+    return Success;
   }
 
   /// Get slice of Data[Offset : Offset + Length - 1]
-  Expect<Span<Byte>> getBytes(uint32_t Offset, uint32_t Length) const noexcept {
+  Expect<Span<Byte>> getBytes(uint64_t Offset, uint64_t Length) const noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
-    return Span<Byte>(&DataPtr[Offset], Length);
+    return Span<Byte>(&DataPtr[Offset], static_cast<size_t>(Length));
   }
 
   /// Replace the bytes of Data[Offset :] by Slice[Start : Start + Length - 1]
-  Expect<void> setBytes(Span<const Byte> Slice, uint32_t Offset, uint32_t Start,
-                        uint32_t Length) noexcept {
+  Expect<void> setBytes(Span<const Byte> Slice, uint64_t Offset, uint32_t Start,
+                        uint64_t Length) noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
@@ -146,35 +383,47 @@ public:
     }
 
     // Check the input data validation.
-    if (unlikely(static_cast<uint64_t>(Start) + static_cast<uint64_t>(Length) >
-                 Slice.size())) {
+    if (unlikely(static_cast<uint64_t>(Start) + Length > Slice.size())) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
+    EXPECTED_TRY(checkWritable(Length));
 
     // Copy the data.
-    if (likely(Length > 0)) {
-      std::copy(Slice.begin() + Start, Slice.begin() + Start + Length,
-                DataPtr + Offset);
-    }
+    moveBytes(DataPtr + Offset, Slice.data() + Start, Length);
     return {};
   }
 
   /// Fill the bytes of Data[Offset : Offset + Length - 1] by Val.
-  Expect<void> fillBytes(uint8_t Val, uint32_t Offset,
-                         uint32_t Length) noexcept {
+  Expect<void> fillBytes(uint8_t Val, uint64_t Offset,
+                         uint64_t Length) noexcept {
     // Check the memory boundary.
     if (unlikely(!checkAccessBound(Offset, Length))) {
       spdlog::error(ErrCode::Value::MemoryOutOfBounds);
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
+    EXPECTED_TRY(checkWritable(Length));
 
-    // Copy the data.
-    if (likely(Length > 0)) {
-      std::fill(DataPtr + Offset, DataPtr + Offset + Length, Val);
+    // Zero the large range by discarding the whole pages, which are not
+    // backed by the file of the image, and only fill the remaining bytes. The
+    // shared memory is skipped for the accesses of the other threads.
+    if (Val == 0 && Length >= kDiscardThreshold && !isShared()) {
+      const uint64_t End = Offset + Length;
+      const uint64_t Begin = std::max(
+          (Offset + kPageSize - 1) / kPageSize,
+          (ImageSize + kPageSize - 1) / kPageSize) * kPageSize;
+      const uint64_t Last = End / kPageSize * kPageSize;
+      if (Begin < Last && Allocator::discard(DataPtr + Begin, Last - Begin)) {
+        fillRange(DataPtr + Offset, Val, Begin - Offset);
+        fillRange(DataPtr + Last, Val, End - Last);
+        return {};
+      }
     }
+
+    // Fill the data.
+    fillRange(DataPtr + Offset, Val, Length);
     return {};
   }
 
@@ -207,6 +456,7 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
+    EXPECTED_TRY(checkWritable(Length));
     if (likely(Length > 0)) {
       // Copy the data.
       if (IsReverse) {
@@ -218,10 +468,25 @@ public:
     return {};
   }
 
-  /// Get pointer to specific offset of memory or null.
+  /// Check the bytes can be written, which fails on the read-only mappings.
+  Expect<void> checkWritable(uint64_t Length) const noexcept {
+    using namespace std::literals;
+    if (unlikely(ReadOnly && Length > 0)) {
+      spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+      spdlog::error("    Memory is mapped read-only."sv);
+      return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+    }
+    return {};
+  }
+
+  /// Get pointer to specific offset of memory or null. The pointers to the
+  /// non-const objects are null for the read-only memory.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
   getPointerOrNull(uint32_t Offset) const noexcept {
+    if (!std::is_const_v<std::remove_pointer_t<T>> && unlikely(ReadOnly)) {
+      return nullptr;
+    }
     if (Offset == 0 ||
         unlikely(!checkAccessBound(Offset, sizeof(std::remove_pointer_t<T>)))) {
       return nullptr;
@@ -229,11 +494,15 @@ public:
     return reinterpret_cast<T>(&DataPtr[Offset]);
   }
 
-  /// Get pointer to specific offset of memory.
+  /// Get pointer to specific offset of memory. The pointers to the non-const
+  /// objects are null for the read-only memory.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
-  getPointer(uint32_t Offset) const noexcept {
+  getPointer(uint64_t Offset) const noexcept {
     using Type = std::remove_pointer_t<T>;
+    if (!std::is_const_v<Type> && unlikely(ReadOnly)) {
+      return nullptr;
+    }
     uint32_t ByteSize = static_cast<uint32_t>(sizeof(Type));
     if (unlikely(!checkAccessBound(Offset, ByteSize))) {
       return nullptr;
@@ -241,9 +510,13 @@ public:
     return reinterpret_cast<T>(&DataPtr[Offset]);
   }
 
-  /// Get array of object with count at specific offset of memory.
+  /// Get array of object with count at specific offset of memory. The spans
+  /// of the non-const objects are empty for the read-only memory.
   template <typename T>
   Span<T> getSpan(uint32_t Offset, uint32_t Count) const noexcept {
+    if (!std::is_const_v<T> && unlikely(ReadOnly)) {
+      return Span<T>();
+    }
     uint32_t Size;
 #if defined(_MSC_VER) && !defined(__clang__) // MSVC
     // Should extend for memory64 proposal.
@@ -286,7 +559,7 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T, uint32_t Length = sizeof(T)>
   typename std::enable_if_t<IsWasmNumV<T>, Expect<void>>
-  loadValue(T &Value, uint32_t Offset) const noexcept {
+  loadValue(T &Value, uint64_t Offset) const noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
@@ -295,6 +568,24 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
+    loadValueUnchecked<T, Length>(Value, Offset);
+    return {};
+  }
+
+  /// Template of loading bytes and convert to a value without the bounds
+  /// check.
+  ///
+  /// The out-of-bounds access faults in the guard region, so the caller should
+  /// ensure that the data pointer is allocated, the allocator has the guard
+  /// region, and the offset is less than `getGuardedAddressLimit()` plus
+  /// `kGuardedOffsetLimit`.
+  ///
+  /// \param Value the constructed output value.
+  /// \param Offset the start offset in data array.
+  template <typename T, uint32_t Length = sizeof(T)>
+  typename std::enable_if_t<IsWasmNumV<T>, void>
+  loadValueUnchecked(T &Value, uint64_t Offset) const noexcept {
+    static_assert(Length <= sizeof(T));
     // Load the data to the value.
     if (likely(Length > 0)) {
       if constexpr (std::is_floating_point_v<T>) {
@@ -323,7 +614,6 @@ public:
         }
       }
     }
-    return {};
   }
 
   /// Template of loading bytes and convert to a value.
@@ -337,7 +627,7 @@ public:
   /// \returns void when success, ErrCode when failed.
   template <typename T, uint32_t Length = sizeof(T)>
   typename std::enable_if_t<IsWasmNativeNumV<T>, Expect<void>>
-  storeValue(const T &Value, uint32_t Offset) noexcept {
+  storeValue(const T &Value, uint64_t Offset) noexcept {
     // Check the data boundary.
     static_assert(Length <= sizeof(T));
     // Check the memory boundary.
@@ -346,23 +636,123 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::MemoryOutOfBounds);
     }
+    EXPECTED_TRY(checkWritable(Length));
+    storeValueUnchecked<T, Length>(Value, Offset);
+    return {};
+  }
+
+  /// Template of storing a value into bytes without the bounds check.
+  ///
+  /// The requirements are the same as `loadValueUnchecked()`.
+  ///
+  /// \param Value the value want to store into data array.
+  /// \param Offset the start offset in data array.
+  template <typename T, uint32_t Length = sizeof(T)>
+  typename std::enable_if_t<IsWasmNativeNumV<T>, void>
+  storeValueUnchecked(const T &Value, uint64_t Offset) noexcept {
+    static_assert(Length <= sizeof(T));
     // Copy the stored data to the value.
     if (likely(Length > 0)) {
       T StoreValue = EndianValue<T>(Value).le();
       std::memcpy(&DataPtr[Offset], &StoreValue, Length);
     }
-    return {};
   }
 
   uint8_t *const &getDataPtr() const noexcept { return DataPtr; }
   uint8_t *&getDataPtr() noexcept { return DataPtr; }
 
+  /// Getter of the size in bytes of the data, which is read by the bounds
+  /// checks of the compiled functions without the guard regions.
+  const uint64_t &getDataSize() const noexcept {
+    static_assert(sizeof(DataSize) == sizeof(uint64_t) &&
+                  std::atomic<uint64_t>::is_always_lock_free);
+    return *reinterpret_cast<const uint64_t *>(&DataSize);
+  }
+
 private:
+  /// Set the page count when no grow is in progress.
+  void setPages(uint32_t Pages) noexcept {
+    ClaimedPages.store(Pages, std::memory_order_relaxed);
+    DataSize.store(Pages * kPageSize, std::memory_order_relaxed);
+    PublishedPages.store(Pages, std::memory_order_release);
+  }
+
+  /// Copy the bytes between the possibly overlapped ranges. The small ranges
+  /// are copied inline, and the others are left to `memmove`, which is tuned
+  /// for the large sizes by the C library.
+  static void moveBytes(uint8_t *Dst, const uint8_t *Src,
+                        uint64_t Length) noexcept {
+    // Load all the bytes before storing for the overlapped ranges.
+    if (Length >= 8 && Length <= 16) {
+      uint64_t Head, Tail;
+      std::memcpy(&Head, Src, 8);
+      std::memcpy(&Tail, Src + Length - 8, 8);
+      std::memcpy(Dst, &Head, 8);
+      std::memcpy(Dst + Length - 8, &Tail, 8);
+    } else if (Length >= 4 && Length < 8) {
+      uint32_t Head, Tail;
+      std::memcpy(&Head, Src, 4);
+      std::memcpy(&Tail, Src + Length - 4, 4);
+      std::memcpy(Dst, &Head, 4);
+      std::memcpy(Dst + Length - 4, &Tail, 4);
+    } else if (Length > 0 && Length < 4) {
+      const uint8_t Head = Src[0];
+      const uint8_t Middle = Src[Length / 2];
+      const uint8_t Tail = Src[Length - 1];
+      Dst[0] = Head;
+      Dst[Length / 2] = Middle;
+      Dst[Length - 1] = Tail;
+    } else if (Length > 16) {
+      std::memmove(Dst, Src, Length);
+    }
+  }
+
+  /// Fill the bytes of the range. The small ranges are filled inline as
+  /// `moveBytes()`.
+  static void fillRange(uint8_t *Dst, uint8_t Val, uint64_t Length) noexcept {
+    if (Length >= 8 && Length <= 16) {
+      const uint64_t Pattern = Val * UINT64_C(0x0101010101010101);
+      std::memcpy(Dst, &Pattern, 8);
+      std::memcpy(Dst + Length - 8, &Pattern, 8);
+    } else if (Length > 0 && Length < 8) {
+      for (uint64_t I = 0; I < Length; ++I) {
+        Dst[I] = Val;
+      }
+    } else if (Length > 16) {
+      std::memset(Dst, Val, Length);
+    }
+  }
+
+  /// Minimum size of `memory.fill` with zero to discard the pages.
+  static inline constexpr const uint64_t kDiscardThreshold = UINT64_C(1048576);
+
   /// \name Data of memory instance.
   /// @{
   AST::MemoryType MemType;
   uint8_t *DataPtr = nullptr;
   const uint32_t PageLimit;
+  /// Reserved pages of the 64-bit memory, or 0 for the 32-bit memory.
+  uint32_t ReservedPages = 0;
+  /// Size in bytes of the mapped memory image at the start of data.
+  uint64_t ImageSize = 0;
+  /// The whole data is mapped from a file, and read-only if set.
+  bool FileMapped = false;
+  bool ReadOnly = false;
+  /// The data is in a slot of the striped memories.
+  bool Striped = false;
+  /// Memory budget of the owner module instance.
+  MemoryBudget *Budget = nullptr;
+  /// Page count published after the pages are committed.
+  std::atomic<uint32_t> PublishedPages = 0;
+  /// Page count admitted by the limits, including the grows in progress.
+  std::atomic<uint32_t> ClaimedPages = 0;
+  /// Tickets ordering the admitted grows.
+  std::atomic<uint32_t> NextTicket = 0;
+  std::atomic<uint32_t> ServingTicket = 0;
+  /// Count of the successful grows.
+  std::atomic<uint64_t> Generation = 0;
+  /// Size in bytes of the data.
+  std::atomic<uint64_t> DataSize = 0;
   /// @}
 };
 
@@ -16,8 +16,11 @@
 #include "ast/component/component.h"
 #include "ast/module.h"
 #include "common/errcode.h"
+#include "runtime/codemap.h"
+#include "runtime/cpubudget.h"
 #include "runtime/hostfunc.h"
 #include "runtime/instance/array.h"
+#include "runtime/instance/cont.h"
 #include "runtime/instance/data.h"
 #include "runtime/instance/elem.h"
 #include "runtime/instance/function.h"
@@ -26,6 +29,9 @@
 #include "runtime/instance/struct.h"
 #include "runtime/instance/table.h"
 #include "runtime/instance/tag.h"
+#include "runtime/membudget.h"
+#include "runtime/nameindex.h"
+#include "runtime/typeregistry.h"
 
 #include <atomic>
 #include <functional>
@@ -47,6 +53,7 @@ class Executor;
 namespace Runtime {
 
 class StoreManager;
+class StackManager;
 class CallingFrame;
 
 namespace Instance {
@@ -76,6 +83,9 @@ public:
                  std::function<void(void *)> Finalizer = nullptr)
       : ModName(Name), HostData(Data), HostDataFinalizer(Finalizer) {}
   virtual ~ModuleInstance() noexcept {
+    // The dropped suspended continuations unwind their executions, which may
+    // still refer to this module instance.
+    OwnedContInsts.clear();
     // When destroying this module instance, call the callbacks to unlink to the
     // store managers.
     for (auto &&Pair : LinkedStore) {
@@ -92,6 +102,36 @@ public:
     return ModName;
   }
 
+  /// Unlink from the linked store managers now instead of in the destructor,
+  /// for destroying this module instance later on another thread.
+  void unlinkStores() noexcept {
+    decltype(LinkedStore) Stores;
+    {
+      std::unique_lock Lock(Mutex);
+      Stores.swap(LinkedStore);
+    }
+    // Call the callbacks without the lock, as they lock the store managers.
+    for (auto &&Pair : Stores) {
+      assuming(Pair.second);
+      Pair.second(Pair.first, this);
+    }
+  }
+
+  /// Getter of the identifier, which is unique among all the module instances
+  /// created in the process and never reused.
+  uint64_t getId() const noexcept { return Id; }
+
+  /// Getter of the memory budget, which accounts the memories, tables, and GC
+  /// objects owned by this module instance.
+  MemoryBudget &getMemoryBudget() noexcept { return Budget; }
+  const MemoryBudget &getMemoryBudget() const noexcept { return Budget; }
+
+  /// Getter of the CPU time budget, which accounts the executions entering
+  /// this module instance, including the host functions and the other module
+  /// instances they call. Only charged if enabled in the configuration. The
+  /// budget is accounting state, so it is mutable even if the instance is not.
+  CpuBudget &getCpuBudget() const noexcept { return CpuTime; }
+
   void *getHostData() const noexcept { return HostData; }
 
   Span<const FunctionInstance *const> getFunctionInstances() const noexcept {
@@ -100,6 +140,20 @@ public:
         FuncInsts.size());
   }
 
+  /// Getter of the code map of the functions for the stack traces. The map is
+  /// built at the first use, and rebuilt once the deferred bodies recorded in
+  /// it were materialized.
+  std::shared_ptr<const CodeMap> getCodeMap() const noexcept {
+    auto Map = std::atomic_load_explicit(&Code, std::memory_order_acquire);
+    if (Map && !Map->isStale(getFunctionInstances())) {
+      return Map;
+    }
+    std::shared_lock Lock(Mutex);
+    Map = std::make_shared<const CodeMap>(getFunctionInstances());
+    std::atomic_store_explicit(&Code, Map, std::memory_order_release);
+    return Map;
+  }
+
   Span<const MemoryInstance *const> getMemoryInstances() const noexcept {
     return Span<const MemoryInstance *const>(
         const_cast<const MemoryInstance *const *>(MemInsts.data()),
@@ -124,10 +178,25 @@ public:
     std::unique_lock Lock(Mutex);
     unsafeImportDefinedType(Func->getDefinedType());
     unsafeAddHostInstance(
-        Name, OwnedFuncInsts, FuncInsts, ExpFuncs,
+        Name, OwnedFuncInsts, FuncInsts, ExpFuncs, ExpFuncsIndex,
         std::make_unique<FunctionInstance>(
             this, static_cast<uint32_t>(Types.size()) - 1, std::move(Func)));
   }
+  /// Add the host function shared with the other module instances, which
+  /// should outlive this module instance. The defined type is copied with the
+  /// type index of this module instance.
+  void addHostFunc(std::string_view Name, HostFunctionBase &Func) {
+    std::unique_lock Lock(Mutex);
+    auto Type = std::make_unique<AST::SubType>(Func.getDefinedType());
+    Type->setTypeIndex(static_cast<uint32_t>(Types.size()));
+    Types.push_back(Type.get());
+    OwnedTypes.push_back(std::move(Type));
+    NativeTypeIds.push_back(newId());
+    unsafeAddHostInstance(
+        Name, OwnedFuncInsts, FuncInsts, ExpFuncs, ExpFuncsIndex,
+        std::make_unique<FunctionInstance>(
+            this, static_cast<uint32_t>(Types.size()) - 1, Func));
+  }
   void addHostFunc(std::string_view Name,
                    std::unique_ptr<FunctionInstance> &&Func) {
     std::unique_lock Lock(Mutex);
@@ -135,48 +204,56 @@ public:
     unsafeImportDefinedType(Func->getHostFunc().getDefinedType());
     Func->linkDefinedType(this, static_cast<uint32_t>(Types.size()) - 1);
     unsafeAddHostInstance(Name, OwnedFuncInsts, FuncInsts, ExpFuncs,
-                          std::move(Func));
+                          ExpFuncsIndex, std::move(Func));
   }
 
   void addHostTable(std::string_view Name,
                     std::unique_ptr<TableInstance> &&Tab) {
     std::unique_lock Lock(Mutex);
+    Tab->setBudget(&Budget);
     unsafeAddHostInstance(Name, OwnedTabInsts, TabInsts, ExpTables,
-                          std::move(Tab));
+                          ExpTablesIndex, std::move(Tab));
   }
   void addHostMemory(std::string_view Name,
                      std::unique_ptr<MemoryInstance> &&Mem) {
     std::unique_lock Lock(Mutex);
+    Mem->setBudget(&Budget);
     unsafeAddHostInstance(Name, OwnedMemInsts, MemInsts, ExpMems,
-                          std::move(Mem));
+                          ExpMemsIndex, std::move(Mem));
   }
   void addHostGlobal(std::string_view Name,
                      std::unique_ptr<GlobalInstance> &&Glob) {
     std::unique_lock Lock(Mutex);
     unsafeAddHostInstance(Name, OwnedGlobInsts, GlobInsts, ExpGlobals,
-                          std::move(Glob));
+                          ExpGlobalsIndex, std::move(Glob));
   }
 
-  /// Find and get the exported instance by name.
+  /// Find and get the exported instance by name. The lookups take no lock
+  /// once the hash index of the exports is built.
   FunctionInstance *findFuncExports(std::string_view ExtName) const noexcept {
-    std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpFuncs, ExtName);
+    return ExpFuncsIndex.find(ExpFuncs, Mutex, ExtName);
   }
   TableInstance *findTableExports(std::string_view ExtName) const noexcept {
-    std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpTables, ExtName);
+    return ExpTablesIndex.find(ExpTables, Mutex, ExtName);
   }
   MemoryInstance *findMemoryExports(std::string_view ExtName) const noexcept {
-    std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpMems, ExtName);
+    return ExpMemsIndex.find(ExpMems, Mutex, ExtName);
   }
   TagInstance *findTagExports(std::string_view ExtName) const noexcept {
-    std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpTags, ExtName);
+    return ExpTagsIndex.find(ExpTags, Mutex, ExtName);
   }
   GlobalInstance *findGlobalExports(std::string_view ExtName) const noexcept {
-    std::shared_lock Lock(Mutex);
-    return unsafeFindExports(ExpGlobals, ExtName);
+    return ExpGlobalsIndex.find(ExpGlobals, Mutex, ExtName);
+  }
+
+  /// Build the hash indices of the exports after the instantiation, so that
+  /// even the first lookups take no lock.
+  void buildExportIndices() const {
+    ExpFuncsIndex.build(ExpFuncs, Mutex);
+    ExpTablesIndex.build(ExpTables, Mutex);
+    ExpMemsIndex.build(ExpMems, Mutex);
+    ExpTagsIndex.build(ExpTags, Mutex);
+    ExpGlobalsIndex.build(ExpGlobals, Mutex);
   }
 
   /// Get the exported instances count.
@@ -232,12 +309,14 @@ protected:
   friend class Executor::Executor;
   friend class ComponentInstance;
   friend class Runtime::CallingFrame;
+  friend class Runtime::StackManager;
 
   /// Create and copy the defined type to this module instance.
   void addDefinedType(const AST::SubType &SType) {
     std::unique_lock Lock(Mutex);
     OwnedTypes.push_back(std::make_unique<AST::SubType>(SType));
     Types.push_back(OwnedTypes.back().get());
+    NativeTypeIds.push_back(newId());
   }
 
   /// Create and add instances into this module instance.
@@ -245,14 +324,19 @@ protected:
     std::unique_lock Lock(Mutex);
     unsafeAddInstance(OwnedFuncInsts, FuncInsts, this,
                       std::forward<Args>(Values)...);
+    std::atomic_store_explicit(&Code, std::shared_ptr<const CodeMap>(),
+                               std::memory_order_release);
   }
   template <typename... Args> void addTable(Args &&...Values) {
     std::unique_lock Lock(Mutex);
     unsafeAddInstance(OwnedTabInsts, TabInsts, std::forward<Args>(Values)...);
+    OwnedTabInsts.back()->setBudget(&Budget);
+    NativeTablePtrs.push_back(TabInsts.back()->getNativeTable());
   }
   template <typename... Args> void addMemory(Args &&...Values) {
     std::unique_lock Lock(Mutex);
     unsafeAddInstance(OwnedMemInsts, MemInsts, std::forward<Args>(Values)...);
+    OwnedMemInsts.back()->setBudget(&Budget);
   }
   template <typename... Args> void addTag(Args &&...Values) {
     std::unique_lock Lock(Mutex);
@@ -274,23 +358,35 @@ protected:
     std::unique_lock Lock(Mutex);
     OwnedArrayInsts.push_back(
         std::make_unique<ArrayInstance>(this, std::forward<Args>(Values)...));
+    GCAllocated += OwnedArrayInsts.back()->getByteSize();
     return OwnedArrayInsts.back().get();
   }
   template <typename... Args> StructInstance *newStruct(Args &&...Values) {
     std::unique_lock Lock(Mutex);
     OwnedStructInsts.push_back(
         std::make_unique<StructInstance>(this, std::forward<Args>(Values)...));
+    GCAllocated += OwnedStructInsts.back()->getByteSize();
     return OwnedStructInsts.back().get();
   }
+  template <typename... Args> ContInstance *newCont(Args &&...Values) {
+    std::unique_lock Lock(Mutex);
+    OwnedContInsts.push_back(
+        std::make_unique<ContInstance>(this, std::forward<Args>(Values)...));
+    GCAllocated += OwnedContInsts.back()->getByteSize();
+    return OwnedContInsts.back().get();
+  }
 
   /// Import instances into this module instance.
   void importFunction(FunctionInstance *Func) {
     std::unique_lock Lock(Mutex);
     unsafeImportInstance(FuncInsts, Func);
+    std::atomic_store_explicit(&Code, std::shared_ptr<const CodeMap>(),
+                               std::memory_order_release);
   }
   void importTable(TableInstance *Tab) {
     std::unique_lock Lock(Mutex);
     unsafeImportInstance(TabInsts, Tab);
+    NativeTablePtrs.push_back(Tab->getNativeTable());
   }
   void importMemory(MemoryInstance *Mem) {
     std::unique_lock Lock(Mutex);
@@ -310,22 +406,27 @@ protected:
   void exportFunction(std::string_view Name, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
     ExpFuncs.insert_or_assign(std::string(Name), FuncInsts[Idx]);
+    ExpFuncsIndex.invalidate();
   }
   void exportTable(std::string_view Name, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
     ExpTables.insert_or_assign(std::string(Name), TabInsts[Idx]);
+    ExpTablesIndex.invalidate();
   }
   void exportMemory(std::string_view Name, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
     ExpMems.insert_or_assign(std::string(Name), MemInsts[Idx]);
+    ExpMemsIndex.invalidate();
   }
   void exportGlobal(std::string_view Name, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
     ExpGlobals.insert_or_assign(std::string(Name), GlobInsts[Idx]);
+    ExpGlobalsIndex.invalidate();
   }
   void exportTag(std::string_view Name, uint32_t Idx) {
     std::unique_lock Lock(Mutex);
     ExpTags.insert_or_assign(std::string(Name), TagInsts[Idx]);
+    ExpTagsIndex.invalidate();
   }
 
   /// Get defined type list.
@@ -376,6 +477,11 @@ protected:
   MemoryInstance *unsafeGetMemory(uint32_t Idx) const noexcept {
     return MemInsts[Idx];
   }
+  /// Unsafe getter of the memory instance array, which is not changed after
+  /// the instantiation, for the frames to cache.
+  MemoryInstance *const *unsafeGetMemories() const noexcept {
+    return MemInsts.data();
+  }
   TagInstance *unsafeGetTag(uint32_t Idx) const noexcept {
     return TagInsts[Idx];
   }
@@ -466,6 +572,7 @@ protected:
     Types.push_back(&SType);
     const_cast<AST::SubType *>(Types.back())
         ->setTypeIndex(static_cast<uint32_t>(Types.size()) - 1);
+    NativeTypeIds.push_back(newId());
   }
 
   /// Unsafe create and add the instance into this module.
@@ -484,10 +591,11 @@ protected:
                         std::vector<std::unique_ptr<T>> &OwnedInstsVec,
                         std::vector<T *> &InstsVec,
                         std::map<std::string, T *, std::less<>> &InstsMap,
-                        std::unique_ptr<T> &&Inst) {
+                        NameIndex<T> &Index, std::unique_ptr<T> &&Inst) {
     OwnedInstsVec.push_back(std::move(Inst));
     InstsVec.push_back(OwnedInstsVec.back().get());
     InstsMap.insert_or_assign(std::string(Name), InstsVec.back());
+    Index.invalidate();
   }
 
   /// Unsafe find and get the exported instance by name.
@@ -509,7 +617,16 @@ protected:
 #else
   std::vector<uint8_t **> MemoryPtrs;
 #endif
+  /// Sizes of the memories, for the bounds checks without the guard regions.
+  std::vector<const uint64_t *> MemorySizePtrs;
   std::vector<ValVariant *> GlobalPtrs;
+  /// Values of the globals defined in this module, which are contiguous after
+  /// the imported ones.
+  std::unique_ptr<ValVariant[]> GlobalValues;
+  std::vector<TableInstance::NativeTable *> NativeTablePtrs;
+  /// Type IDs of the native dispatch tables, which are never reused as the
+  /// module identifiers, so a cached entry never matches another type.
+  std::vector<uint64_t> NativeTypeIds;
   /// @}
 
   friend class Runtime::StoreManager;
@@ -538,6 +655,12 @@ protected:
   std::vector<const AST::SubType *> Types;
   std::vector<std::unique_ptr<const AST::SubType>> OwnedTypes;
 
+  /// Memory budget of the owned instances. Declared before the owned
+  /// instances to outlive them.
+  MemoryBudget Budget;
+  /// CPU time budget of the executions.
+  mutable CpuBudget CpuTime;
+
   /// Owned instances in this module.
   std::vector<std::unique_ptr<FunctionInstance>> OwnedFuncInsts;
   std::vector<std::unique_ptr<TableInstance>> OwnedTabInsts;
@@ -548,6 +671,9 @@ protected:
   std::vector<std::unique_ptr<DataInstance>> OwnedDataInsts;
   std::vector<std::unique_ptr<ArrayInstance>> OwnedArrayInsts;
   std::vector<std::unique_ptr<StructInstance>> OwnedStructInsts;
+  std::vector<std::unique_ptr<ContInstance>> OwnedContInsts;
+  /// Bytes of the GC objects allocated since the last collection.
+  uint64_t GCAllocated = 0;
 
   /// Imported and added instances in this module.
   std::vector<FunctionInstance *> FuncInsts;
@@ -567,13 +693,40 @@ protected:
   std::map<std::string, MemoryInstance *, std::less<>> ExpMems;
   std::map<std::string, TagInstance *, std::less<>> ExpTags;
   std::map<std::string, GlobalInstance *, std::less<>> ExpGlobals;
+  /// Hash indices of the exported name maps for the lookups.
+  NameIndex<FunctionInstance> ExpFuncsIndex;
+  NameIndex<TableInstance> ExpTablesIndex;
+  NameIndex<MemoryInstance> ExpMemsIndex;
+  NameIndex<TagInstance> ExpTagsIndex;
+  NameIndex<GlobalInstance> ExpGlobalsIndex;
 
   /// Start function instance.
   const FunctionInstance *StartFunc = nullptr;
 
+  /// Code map of the functions, built at the first stack trace.
+  mutable std::shared_ptr<const CodeMap> Code;
+
+  /// Get a new identifier. The identifier 0 is never used.
+  static uint64_t newId() noexcept {
+    static std::atomic<uint64_t> Counter = 0;
+    return Counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  /// Unique identifier of this module instance.
+  const uint64_t Id = newId();
+
   /// Imported WASI module instance when instantiation.
   const ModuleInstance *WASIModInst = nullptr;
 
+  /// Canonical types of the defined types, assigned at the instantiation or
+  /// at the first cast of the host module instances.
+  mutable std::once_flag CanonTypesFlag;
+  mutable std::vector<const CanonicalType *> CanonTypes;
+
+  /// Memory images of the owned memories, recorded at the first clone.
+  mutable std::once_flag CloneImagesFlag;
+  mutable std::vector<std::shared_ptr<const MemoryImage>> CloneImages;
+
   /// Linked store.
   std::map<StoreManager *, std::function<BeforeModuleDestroyCallback>>
       LinkedStore;
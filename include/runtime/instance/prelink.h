@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/instance/prelink.h - Pre-linking definition ------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the resolved imports of a module, which are bound by
+/// index when instantiating the module repeatedly.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace WasmEdge {
+
+namespace AST {
+class Module;
+}
+
+namespace Runtime {
+
+class StoreManager;
+
+namespace Instance {
+
+class ModuleInstance;
+class FunctionInstance;
+class TableInstance;
+class MemoryInstance;
+class TagInstance;
+class GlobalInstance;
+
+/// Imports of a module resolved and type-checked against the registered
+/// modules of a store, in the order of the import section.
+struct ModulePrelink {
+  using Import = std::variant<FunctionInstance *, TableInstance *,
+                              MemoryInstance *, TagInstance *, GlobalInstance *>;
+
+  /// The module pre-linked, which is the only one to instantiate.
+  const AST::Module *Module = nullptr;
+  /// The store resolved in, and its generation at the resolving. The imports
+  /// are resolved again if the registered modules changed after.
+  const StoreManager *Store = nullptr;
+  uint64_t Generation = 0;
+  std::vector<Import> Imports;
+  /// The first imported WASI module, if any.
+  const ModuleInstance *WASIModule = nullptr;
+};
+
+} // namespace Instance
+} // namespace Runtime
+} // namespace WasmEdge
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/instance/snapshot.h - Snapshot definition --------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the snapshot of the mutable state of a module instance,
+/// which is restored to reset the instance between the requests.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/types.h"
+#include "system/memimage.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+namespace Instance {
+
+class ModuleInstance;
+
+/// Snapshot of the owned memories, tables, and globals of a module instance.
+/// The memories are recorded as images, which are mapped copy-on-write when
+/// restoring, so that only the pages touched after the snapshot are dropped.
+struct ModuleSnapshot {
+  struct Memory {
+    uint32_t Pages = 0;
+    /// Image of the data, or nullptr if the memory is empty or the images are
+    /// not supported.
+    std::unique_ptr<MemoryImage> Image;
+    /// Copy of the data if the images are not supported.
+    std::vector<uint8_t> Data;
+  };
+
+  /// The module instance taken the snapshot, which is the only one to restore.
+  const ModuleInstance *Source = nullptr;
+  std::vector<Memory> Memories;
+  std::vector<std::vector<RefVariant>> Tables;
+  std::vector<ValVariant> Globals;
+};
+
+} // namespace Instance
+} // namespace Runtime
+} // namespace WasmEdge
@@ -27,20 +27,38 @@ namespace Instance {
 class StructInstance : public CompositeBase {
 public:
   StructInstance() = delete;
+  /// Construct the struct with the byte size of the packed fields, which are
+  /// initialized with zeros.
   StructInstance(const ModuleInstance *Mod, const uint32_t Idx,
-                 std::vector<ValVariant> &&Init) noexcept
-      : CompositeBase(Mod, Idx), Data(std::move(Init)) {
+                 const uint32_t Size) noexcept
+      : CompositeBase(Mod, Idx), Data(Size) {
     assuming(ModInst);
   }
 
-  /// Get field data in struct instance.
-  ValVariant &getField(uint32_t Idx) noexcept { return Data[Idx]; }
-  const ValVariant &getField(uint32_t Idx) const noexcept { return Data[Idx]; }
+  /// Get and set the packed field data by the byte offset and size of the
+  /// field in struct instance.
+  ValVariant getField(uint32_t Offset, uint32_t Size) const noexcept {
+    assuming(static_cast<uint64_t>(Offset) + Size <= Data.size());
+    return loadPacked(&Data[Offset], Size);
+  }
+  void setField(uint32_t Offset, uint32_t Size,
+                const ValVariant &Val) noexcept {
+    assuming(static_cast<uint64_t>(Offset) + Size <= Data.size());
+    storePacked(&Data[Offset], Size, Val);
+  }
+
+  /// Get the packed storage of the fields in struct instance.
+  Span<const uint8_t> getBytes() const noexcept { return Data; }
+
+  /// Get the bytes charged to the memory budget of the owner module.
+  uint64_t getByteSize() const noexcept {
+    return sizeof(StructInstance) + Data.size();
+  }
 
 private:
   /// \name Data of struct instance.
   /// @{
-  std::vector<ValVariant> Data;
+  std::vector<uint8_t> Data;
   /// @}
 };
 
@@ -18,9 +18,14 @@
 #include "common/errcode.h"
 #include "common/errinfo.h"
 #include "common/spdlog.h"
+#include "runtime/membudget.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace WasmEdge {
@@ -29,6 +34,20 @@ namespace Instance {
 
 class TableInstance {
 public:
+  /// Entry of the native dispatch table, which caches the symbol of a slot
+  /// for the indirect calls with the type ID. Cleared to zeros whenever the
+  /// slot is modified.
+  struct NativeEntry {
+    uint64_t TypeId;
+    void *Symbol;
+  };
+  /// Native dispatch table of the compiled `call_indirect`. The entries are
+  /// only allocated for the function reference tables.
+  struct NativeTable {
+    NativeEntry *Entries = nullptr;
+    uint64_t Size = 0;
+  };
+
   TableInstance() = delete;
   TableInstance(const AST::TableType &TType) noexcept
       : TabType(TType),
@@ -36,12 +55,26 @@ public:
         InitValue(RefVariant(TType.getRefType())) {
     // The reftype should a nullable reference because of no init ref.
     assuming(TType.getRefType().isNullableRefType());
+    resizeNative();
   }
   TableInstance(const AST::TableType &TType, const RefVariant &InitVal) noexcept
       : TabType(TType), Refs(TType.getLimit().getMin(), InitVal),
         InitValue(InitVal) {
     // If the reftype is not a nullable reference, the init ref is required.
     assuming(TType.getRefType().isNullableRefType() || !InitVal.isNull());
+    resizeNative();
+  }
+  ~TableInstance() noexcept {
+    if (Budget) {
+      Budget->release(Refs.size() * sizeof(RefVariant));
+    }
+  }
+
+  /// Charge the references to the memory budget of the owner module instance.
+  void setBudget(MemoryBudget *B) noexcept {
+    assuming(Budget == nullptr);
+    Budget = B;
+    Budget->forceCharge(Refs.size() * sizeof(RefVariant));
   }
 
   /// Get size of table.refs
@@ -53,6 +86,29 @@ public:
   /// Getter of table type.
   const AST::TableType &getTableType() const noexcept { return TabType; }
 
+  /// Getter of the initial value of the grown elements.
+  const RefVariant &getInitValue() const noexcept { return InitValue; }
+
+  /// Getter of the generation, which is unique among all the table instances
+  /// and renewed whenever the references are modified or the table grows.
+  uint64_t getGeneration() const noexcept { return Generation; }
+
+  /// Getter of the native dispatch table, which is kept at the same address
+  /// during the lifetime of the table instance.
+  NativeTable *getNativeTable() const noexcept { return &Native; }
+
+  /// Cache the symbol of the slot which has passed the type check of the
+  /// type ID. The symbol is written first so that a matched type ID always
+  /// comes with it.
+  void setNativeEntry(uint32_t Idx, uint64_t TypeId,
+                      void *Symbol) const noexcept {
+    if (Idx < NativeEntries.size()) {
+      NativeEntries[Idx].Symbol = Symbol;
+      std::atomic_thread_fence(std::memory_order_release);
+      NativeEntries[Idx].TypeId = TypeId;
+    }
+  }
+
   /// Check is out of bound.
   bool checkAccessBound(uint32_t Offset, uint32_t Length) const noexcept {
     const uint64_t AccessLen =
@@ -77,15 +133,38 @@ public:
     if (Count > MaxSizeCaped - Refs.size()) {
       return false;
     }
+    if (Budget &&
+        !Budget->charge(static_cast<uint64_t>(Count) * sizeof(RefVariant),
+                        true)) {
+      return false;
+    }
     Refs.resize(Refs.size() + Count);
     std::fill_n(Refs.end() - Count, Count, Val);
     TabType.getLimit().setMin(Min + Count);
+    Generation = newGeneration();
+    resizeNative();
     return true;
   }
   bool growTable(uint32_t Count) noexcept {
     return growTable(Count, InitValue);
   }
 
+  /// Replace the references and the size by the ones of a snapshot.
+  void restoreRefs(Span<const RefVariant> Snapshot) noexcept {
+    if (unlikely(LazySize > 0)) {
+      dropLazyRefs(0, LazySize);
+    }
+    if (Budget) {
+      Budget->release(Refs.size() * sizeof(RefVariant));
+      Budget->forceCharge(Snapshot.size() * sizeof(RefVariant));
+    }
+    Refs.assign(Snapshot.begin(), Snapshot.end());
+    TabType.getLimit().setMin(static_cast<uint32_t>(Snapshot.size()));
+    Generation = newGeneration();
+    NativeEntries.clear();
+    resizeNative();
+  }
+
   /// Get slice of Refs[Offset : Offset + Length - 1]
   Expect<Span<const RefVariant>> getRefs(uint32_t Offset,
                                          uint32_t Length) const noexcept {
@@ -95,6 +174,9 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
       return Unexpect(ErrCode::Value::TableOutOfBounds);
     }
+    if (unlikely(LazySize > 0)) {
+      resolveLazyRefs(Offset, Length);
+    }
     return Span<const RefVariant>(Refs.begin() + Offset, Length);
   }
 
@@ -117,14 +199,20 @@ public:
       return Unexpect(ErrCode::Value::TableOutOfBounds);
     }
 
-    // Copy the references.
-    if (Dst <= Src) {
-      std::copy(Slice.begin() + Src, Slice.begin() + Src + Length,
-                Refs.begin() + Dst);
+    if (unlikely(LazySize > 0)) {
+      dropLazyRefs(Dst, Length);
+    }
+    Generation = newGeneration();
+    clearNative(Dst, Length);
+
+    // Copy the references. The slice may be a part of this table, so copy in
+    // the direction that handles the overlapping ranges as memmove does.
+    const RefVariant *From = Slice.data() + Src;
+    RefVariant *To = Refs.data() + Dst;
+    if (std::less_equal<const RefVariant *>()(To, From)) {
+      std::copy(From, From + Length, To);
     } else {
-      std::copy(std::make_reverse_iterator(Slice.begin() + Src + Length),
-                std::make_reverse_iterator(Slice.begin() + Src),
-                std::make_reverse_iterator(Refs.begin() + Dst + Length));
+      std::copy_backward(From, From + Length, To + Length);
     }
     return {};
   }
@@ -139,11 +227,46 @@ public:
       return Unexpect(ErrCode::Value::TableOutOfBounds);
     }
 
+    if (unlikely(LazySize > 0)) {
+      dropLazyRefs(Offset, Length);
+    }
+    Generation = newGeneration();
+    clearNative(Offset, Length);
+
     // Fill the references.
     std::fill_n(Refs.begin() + Offset, Length, Val);
     return {};
   }
 
+  /// Resolver of the lazy references by the index in the lazy range.
+  using LazyResolver = std::function<RefVariant(uint32_t)>;
+
+  /// Set the Refs[Offset : Offset + Length - 1] to be resolved by Resolver on
+  /// their first access instead of now. The later ranges override the former
+  /// ones. This should be called before the table is shared between threads.
+  Expect<void> setLazyRefs(uint32_t Offset, uint32_t Length,
+                           LazyResolver Resolver) noexcept {
+    // Check the accessing boundary.
+    if (!checkAccessBound(Offset, Length)) {
+      spdlog::error(ErrCode::Value::TableOutOfBounds);
+      spdlog::error(ErrInfo::InfoBoundary(Offset, Length, getBoundIdx()));
+      return Unexpect(ErrCode::Value::TableOutOfBounds);
+    }
+    if (Length == 0) {
+      return {};
+    }
+    if (LazySize == 0) {
+      // The grown elements are never lazy, so the bits of the current size
+      // are enough.
+      LazySize = static_cast<uint32_t>(Refs.size());
+      LazyBits.reset(new std::atomic<uint64_t>[(LazySize + 63) / 64]());
+    }
+    LazyRanges.push_back({Offset, Length, std::move(Resolver)});
+    markLazyRefs(Offset, Offset + Length, true);
+    clearNative(Offset, Length);
+    return {};
+  }
+
   /// Get the elem address.
   Expect<RefVariant> getRefAddr(uint32_t Idx) const noexcept {
     if (Idx >= Refs.size()) {
@@ -151,6 +274,9 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Idx, 1, getBoundIdx()));
       return Unexpect(ErrCode::Value::TableOutOfBounds);
     }
+    if (unlikely(LazySize > 0) && isLazyRef(Idx)) {
+      resolveLazyRefs(Idx, 1);
+    }
     return Refs[Idx];
   }
 
@@ -161,16 +287,117 @@ public:
       spdlog::error(ErrInfo::InfoBoundary(Idx, 1, getBoundIdx()));
       return Unexpect(ErrCode::Value::TableOutOfBounds);
     }
+    if (unlikely(LazySize > 0)) {
+      dropLazyRefs(Idx, 1);
+    }
+    Generation = newGeneration();
+    clearNative(Idx, 1);
     Refs[Idx] = Val;
     return {};
   }
 
 private:
+  /// Get a new generation. The generation 0 is never used.
+  static uint64_t newGeneration() noexcept {
+    static std::atomic<uint64_t> Counter = 0;
+    return Counter.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  /// Resize the native dispatch table to the table size with the cleared
+  /// entries, and update its address.
+  void resizeNative() noexcept {
+    if (!TabType.getRefType().isFuncRefType()) {
+      return;
+    }
+    NativeEntries.resize(Refs.size(), NativeEntry{0, nullptr});
+    Native.Entries = NativeEntries.data();
+    Native.Size = NativeEntries.size();
+  }
+
+  /// Clear the native entries of Refs[Offset : Offset + Length - 1].
+  void clearNative(uint32_t Offset, uint32_t Length) noexcept {
+    if (Offset < NativeEntries.size()) {
+      std::fill_n(NativeEntries.begin() + Offset,
+                  std::min<size_t>(Length, NativeEntries.size() - Offset),
+                  NativeEntry{0, nullptr});
+    }
+  }
+
+  /// Check the reference is not resolved yet. The resolved reference is
+  /// written before its bit is cleared.
+  bool isLazyRef(uint32_t Idx) const noexcept {
+    return Idx < LazySize &&
+           (LazyBits[Idx / 64].load(std::memory_order_acquire) >> (Idx % 64)) &
+               UINT64_C(1);
+  }
+
+  /// Resolve the lazy references in Refs[Offset : Offset + Length - 1].
+  void resolveLazyRefs(uint32_t Offset, uint32_t Length) const noexcept {
+    const uint32_t End = std::min(Offset + Length, LazySize);
+    std::unique_lock Lock(LazyMutex);
+    for (uint32_t I = Offset; I < End; ++I) {
+      if (!isLazyRef(I)) {
+        continue;
+      }
+      for (auto It = LazyRanges.rbegin(); It != LazyRanges.rend(); ++It) {
+        if (I >= It->Offset && I - It->Offset < It->Length) {
+          Refs[I] = It->Resolve(I - It->Offset);
+          break;
+        }
+      }
+      LazyBits[I / 64].fetch_and(~(UINT64_C(1) << (I % 64)),
+                                 std::memory_order_release);
+    }
+  }
+
+  /// Drop the lazy references in Refs[Offset : Offset + Length - 1] which are
+  /// going to be overwritten.
+  void dropLazyRefs(uint32_t Offset, uint32_t Length) noexcept {
+    std::unique_lock Lock(LazyMutex);
+    markLazyRefs(Offset, std::min(Offset + Length, LazySize), false);
+  }
+
+  /// Set or clear the bits of Refs[Offset : End - 1] word by word.
+  void markLazyRefs(uint32_t Offset, uint32_t End, bool IsLazy) noexcept {
+    while (Offset < End) {
+      const uint32_t Shift = Offset % 64;
+      const uint32_t Count = std::min(64 - Shift, End - Offset);
+      const uint64_t Mask =
+          (Count == 64 ? ~UINT64_C(0) : (UINT64_C(1) << Count) - 1) << Shift;
+      if (IsLazy) {
+        LazyBits[Offset / 64].fetch_or(Mask, std::memory_order_relaxed);
+      } else {
+        LazyBits[Offset / 64].fetch_and(~Mask, std::memory_order_relaxed);
+      }
+      Offset += Count;
+    }
+  }
+
+  struct LazyRange {
+    uint32_t Offset;
+    uint32_t Length;
+    LazyResolver Resolve;
+  };
+
   /// \name Data of table instance.
   /// @{
   AST::TableType TabType;
-  std::vector<RefVariant> Refs;
+  mutable std::vector<RefVariant> Refs;
   RefVariant InitValue;
+  uint64_t Generation = newGeneration();
+  /// Native dispatch table of the compiled functions.
+  mutable std::vector<NativeEntry> NativeEntries;
+  mutable NativeTable Native;
+  /// Memory budget of the owner module instance.
+  MemoryBudget *Budget = nullptr;
+  /// @}
+
+  /// \name Data of the lazy references.
+  /// @{
+  uint32_t LazySize = 0;
+  std::unique_ptr<std::atomic<uint64_t>[]> LazyBits;
+  std::vector<LazyRange> LazyRanges;
+  mutable std::mutex LazyMutex;
   /// @}
 };
 
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/membudget.h - Memory budget definition -----------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the memory budget, which accounts the
+/// memory used by the instances owned by a module instance.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Runtime {
+
+class MemoryBudget {
+public:
+  /// Set the soft and hard limits in bytes. The growing requests fail when
+  /// exceeding the soft limit, and all the charges fail when exceeding the
+  /// hard limit. 0 for no limit.
+  void setLimits(uint64_t Soft, uint64_t Hard) noexcept {
+    SoftLimit.store(Soft, std::memory_order_relaxed);
+    HardLimit.store(Hard, std::memory_order_relaxed);
+  }
+
+  uint64_t getSoftLimit() const noexcept {
+    return SoftLimit.load(std::memory_order_relaxed);
+  }
+
+  uint64_t getHardLimit() const noexcept {
+    return HardLimit.load(std::memory_order_relaxed);
+  }
+
+  /// Getter of the currently charged bytes.
+  uint64_t getUsage() const noexcept {
+    return Usage.load(std::memory_order_relaxed);
+  }
+
+  /// Getter of the maximum charged bytes ever.
+  uint64_t getPeak() const noexcept {
+    return Peak.load(std::memory_order_relaxed);
+  }
+
+  /// Check the usage is over the hard limit.
+  bool isExceeded() const noexcept {
+    const uint64_t Hard = getHardLimit();
+    return Hard > 0 && getUsage() > Hard;
+  }
+
+  /// Charge the bytes if not exceeding the hard limit, or also the soft limit
+  /// if `IsGrow` is set. Return false without charging otherwise.
+  bool charge(uint64_t Bytes, bool IsGrow) noexcept {
+    uint64_t Limit = getHardLimit();
+    if (IsGrow) {
+      const uint64_t Soft = getSoftLimit();
+      if (Soft > 0 && (Limit == 0 || Soft < Limit)) {
+        Limit = Soft;
+      }
+    }
+    uint64_t Old = Usage.load(std::memory_order_relaxed);
+    uint64_t New;
+    do {
+      if (Bytes > UINT64_MAX - Old || (Limit > 0 && Old + Bytes > Limit)) {
+        return false;
+      }
+      New = Old + Bytes;
+    } while (!Usage.compare_exchange_weak(Old, New,
+                                          std::memory_order_relaxed));
+    updatePeak(New);
+    return true;
+  }
+
+  /// Charge the bytes regardless of the limits, such as the memory of the
+  /// instances added by the host.
+  void forceCharge(uint64_t Bytes) noexcept {
+    updatePeak(Usage.fetch_add(Bytes, std::memory_order_relaxed) + Bytes);
+  }
+
+  /// Release the charged bytes.
+  void release(uint64_t Bytes) noexcept {
+    Usage.fetch_sub(Bytes, std::memory_order_relaxed);
+  }
+
+private:
+  void updatePeak(uint64_t Value) noexcept {
+    uint64_t Old = Peak.load(std::memory_order_relaxed);
+    while (Old < Value &&
+           !Peak.compare_exchange_weak(Old, Value, std::memory_order_relaxed)) {
+    }
+  }
+
+  std::atomic<uint64_t> Usage = 0;
+  std::atomic<uint64_t> Peak = 0;
+  std::atomic<uint64_t> SoftLimit = 0;
+  std::atomic<uint64_t> HardLimit = 0;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/nameindex.h - Name index definition --------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the name index, which is the immutable
+/// hash index of a name map for looking up without taking the lock of the map.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/hash.h"
+#include "common/span.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+
+/// Immutable hash index of a name map guarded by a shared mutex. The index is
+/// built from the map by `build()` or at the first lookup after the map
+/// changed, and published atomically. The lookups on the published index take
+/// no lock of the map, and the owners should invalidate the index with the
+/// exclusive lock held after changing the map. The names should be mapped to
+/// non-null pointers.
+template <typename T> class NameIndex {
+public:
+  NameIndex() noexcept = default;
+  NameIndex(const NameIndex &) = delete;
+  NameIndex &operator=(const NameIndex &) = delete;
+  ~NameIndex() noexcept { delete Current.load(std::memory_order_relaxed); }
+
+  /// Find the name in the published index, or build and publish the index
+  /// from the map first.
+  template <typename MapT>
+  T *find(const MapT &Map, std::shared_mutex &Mutex,
+          std::string_view Name) const {
+    const uint64_t Hash = hashName(Name);
+    // Count the lookup before loading the index, so that the index is not
+    // freed by the invalidations during the lookup.
+    Readers.fetch_add(1, std::memory_order_seq_cst);
+    const Snapshot *Index = Current.load(std::memory_order_seq_cst);
+    if (unlikely(Index == nullptr)) {
+      Index = publish(Map, Mutex);
+    }
+    T *Result = Index->find(Name, Hash);
+    Readers.fetch_sub(1, std::memory_order_release);
+    return Result;
+  }
+
+  /// Build and publish the index from the map if not published yet.
+  template <typename MapT>
+  void build(const MapT &Map, std::shared_mutex &Mutex) const {
+    if (Current.load(std::memory_order_acquire) == nullptr) {
+      publish(Map, Mutex);
+    }
+  }
+
+  /// Drop the published index. Should be called with the exclusive lock of
+  /// the map held after changing it.
+  void invalidate() noexcept {
+    if (const auto *Old = Current.exchange(nullptr)) {
+      Retired.emplace_back(Old);
+    }
+    // The dropped indices are freed once no lookup is in progress.
+    if (Readers.load(std::memory_order_seq_cst) == 0) {
+      Retired.clear();
+    }
+  }
+
+private:
+  static uint64_t hashName(std::string_view Name) noexcept {
+    return Hash::Hash::rapidHash(
+        cxx20::as_bytes(Span<const char>(Name.data(), Name.size())));
+  }
+
+  /// Open addressing hash table with the linear probing. The names are packed
+  /// in one buffer, and their hashes are kept in the slots to skip the string
+  /// comparisons of the collided names.
+  struct Snapshot {
+    template <typename MapT> explicit Snapshot(const MapT &Map) {
+      size_t Bytes = 0;
+      for (const auto &Pair : Map) {
+        Bytes += Pair.first.size();
+      }
+      Names.reserve(Bytes);
+      // Keep the load factor at most a half.
+      size_t Capacity = 4;
+      while (Capacity < Map.size() * 2) {
+        Capacity <<= 1;
+      }
+      Slots.resize(Capacity);
+      Mask = Capacity - 1;
+      for (const auto &[Name, Ptr] : Map) {
+        const uint64_t Hash = hashName(Name);
+        size_t I = static_cast<size_t>(Hash) & Mask;
+        while (Slots[I].Ptr != nullptr) {
+          I = (I + 1) & Mask;
+        }
+        Slots[I] = {Hash, static_cast<uint32_t>(Names.size()),
+                    static_cast<uint32_t>(Name.size()), Ptr};
+        Names.append(Name);
+      }
+    }
+    T *find(std::string_view Name, uint64_t Hash) const noexcept {
+      for (size_t I = static_cast<size_t>(Hash) & Mask;; I = (I + 1) & Mask) {
+        const auto &S = Slots[I];
+        if (S.Ptr == nullptr) {
+          return nullptr;
+        }
+        if (S.Hash == Hash &&
+            std::string_view(Names).substr(S.Offset, S.Size) == Name) {
+          return S.Ptr;
+        }
+      }
+    }
+
+    struct Slot {
+      uint64_t Hash = 0;
+      uint32_t Offset = 0;
+      uint32_t Size = 0;
+      T *Ptr = nullptr;
+    };
+    std::string Names;
+    std::vector<Slot> Slots;
+    size_t Mask = 0;
+  };
+
+  /// Build the index under the shared lock, so that it is never newer than
+  /// the invalidation by the changes of the map. The first one published by
+  /// the concurrent builders is used.
+  template <typename MapT>
+  const Snapshot *publish(const MapT &Map, std::shared_mutex &Mutex) const {
+    std::shared_lock Lock(Mutex);
+    auto Index = std::make_unique<const Snapshot>(Map);
+    const Snapshot *Expected = nullptr;
+    if (Current.compare_exchange_strong(Expected, Index.get(),
+                                        std::memory_order_seq_cst)) {
+      return Index.release();
+    }
+    return Expected;
+  }
+
+  mutable std::atomic<const Snapshot *> Current = nullptr;
+  /// Count of the lookups in progress.
+  mutable std::atomic<uint32_t> Readers = 0;
+  /// Dropped indices which may be still used by the lookups.
+  std::vector<std::unique_ptr<const Snapshot>> Retired;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
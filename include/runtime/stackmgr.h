@@ -15,8 +15,14 @@
 
 #include "ast/instruction.h"
 #include "runtime/instance/module.h"
+#include "system/allocator.h"
 
+#include <chrono>
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
@@ -26,100 +32,200 @@ class StackManager {
 public:
   using Value = ValVariant;
 
-  struct Handler {
-    Handler(AST::InstrView::iterator TryIt, uint32_t V,
-            Span<const AST::Instruction::CatchDescriptor> C)
-        : Try(TryIt), VPos(V), CatchClause(C) {}
-    AST::InstrView::iterator Try;
-    uint32_t VPos;
-    Span<const AST::Instruction::CatchDescriptor> CatchClause;
-  };
-
   struct Frame {
     Frame() = delete;
-    Frame(const Instance::ModuleInstance *Mod, AST::InstrView::iterator FromIt,
+    Frame(const Instance::ModuleInstance *Mod,
+          const Instance::FunctionInstance *F, AST::InstrView::iterator FromIt,
           uint32_t L, uint32_t A, uint32_t V) noexcept
-        : Module(Mod), From(FromIt), Locals(L), Arity(A), VPos(V) {}
+        : Module(Mod), Memories(Mod ? Mod->unsafeGetMemories() : nullptr),
+          Func(F), From(FromIt), Locals(L), Arity(A), VPos(V) {}
     const Instance::ModuleInstance *Module;
+    /// Memory instances of the module cached for the memory instructions,
+    /// which saves the lookup through the module for every access.
+    Instance::MemoryInstance *const *Memories;
+    /// Function of this frame, nullptr for the dummy frames.
+    const Instance::FunctionInstance *Func;
     AST::InstrView::iterator From;
     uint32_t Locals;
     uint32_t Arity;
     uint32_t VPos;
-    std::vector<Handler> HandlerStack;
   };
 
+  /// Function of a table slot which has passed the type check of the indirect
+  /// calls with the type index in the module. The table generation and the
+  /// module ID are never reused, so a matched entry is always valid.
+  struct IndirectCallEntry {
+    uint64_t Generation;
+    uint64_t ModuleId;
+    uint32_t Slot;
+    uint32_t TypeIdx;
+    const Instance::FunctionInstance *Func;
+  };
+
+  /// Native wasm function called last by a call_ref instruction in the
+  /// module. As the indirect call entries, a matched entry is always valid.
+  struct CallRefEntry {
+    const AST::Instruction *Site;
+    uint64_t ModuleId;
+    const Instance::FunctionInstance *Func;
+  };
+
+  /// Counters of the executions of a function on this stack. The self time
+  /// excludes the callees with frames.
+  struct FunctionCounter {
+    uint64_t Calls = 0;
+    uint64_t Instrs = 0;
+    std::chrono::nanoseconds SelfTime{};
+  };
+  using FunctionCounterMap =
+      std::unordered_map<const Instance::FunctionInstance *, FunctionCounter>;
+
   /// Stack manager provides the stack control for Wasm execution with VALIDATED
   /// modules. All operations of instructions passed validation, therefore no
   /// unexpect operations will occur.
   StackManager() noexcept {
-    ValueStack.reserve(2048U);
+    growValueStack();
     FrameStack.reserve(16U);
   }
-  ~StackManager() = default;
+
+  /// Stack manager with a fixed-capacity value stack of at least `Capacity`
+  /// entries, rounded up to 64 KiB and followed by an inaccessible guard
+  /// region. Pushes never check the capacity: overflowing the stack faults on
+  /// the guard region instead. Falls back to the growable value stack when
+  /// `Capacity` is 0 or the region cannot be mapped.
+  explicit StackManager(uint32_t Capacity) noexcept {
+    if (Capacity > 0) {
+      const uint64_t Size =
+          (static_cast<uint64_t>(Capacity) * sizeof(Value) + kGuardSize - 1) &
+          ~(kGuardSize - 1);
+      if (uint8_t *Ptr = Allocator::allocate_chunk(Size + kGuardSize)) {
+        if (Allocator::set_chunk_inaccessible(Ptr + Size, kGuardSize)) {
+          // The end pointer stays null, so the growing path in `push` is never
+          // taken.
+          ValueBase = ValueTop = reinterpret_cast<Value *>(Ptr);
+          ValueGuard = reinterpret_cast<Value *>(Ptr + Size);
+          FrameStack.reserve(16U);
+          return;
+        }
+        Allocator::release_chunk(Ptr, Size + kGuardSize);
+      }
+    }
+    growValueStack();
+    FrameStack.reserve(16U);
+  }
+
+  StackManager(const StackManager &) = delete;
+  StackManager &operator=(const StackManager &) = delete;
+
+  ~StackManager() noexcept {
+    if (ValueGuard) {
+      Allocator::release_chunk(
+          reinterpret_cast<uint8_t *>(ValueBase),
+          static_cast<uint64_t>(reinterpret_cast<uint8_t *>(ValueGuard) -
+                                reinterpret_cast<uint8_t *>(ValueBase)) +
+              kGuardSize);
+    } else {
+      std::allocator<Value>().deallocate(
+          ValueBase, static_cast<size_t>(ValueEnd - ValueBase));
+    }
+  }
 
   /// Getter of stack size.
-  size_t size() const noexcept { return ValueStack.size(); }
+  size_t size() const noexcept {
+    return static_cast<size_t>(ValueTop - ValueBase);
+  }
+
+  /// Getter of whether the value stack is the fixed-capacity one.
+  bool isFixedValueStack() const noexcept { return ValueGuard != nullptr; }
+
+  /// Getter of whether the fixed-capacity value stack is full. A fault on the
+  /// guard region leaves the top pointer at the guard.
+  bool isValueStackExhausted() const noexcept {
+    return ValueGuard != nullptr && ValueTop >= ValueGuard;
+  }
+
+  /// Getter of whether `N` more values can be pushed without faulting on the
+  /// guard region of the fixed-capacity value stack.
+  bool hasValueRoom(uint32_t N) const noexcept {
+    return ValueGuard == nullptr ||
+           static_cast<size_t>(ValueGuard - ValueTop) >= N;
+  }
 
   /// Unsafe getter of top entry of stack.
-  Value &getTop() { return ValueStack.back(); }
+  Value &getTop() { return ValueTop[-1]; }
 
   /// Unsafe getter of top N-th value entry of stack.
   Value &getTopN(uint32_t Offset) noexcept {
-    assuming(0 < Offset && Offset <= ValueStack.size());
-    return ValueStack[ValueStack.size() - Offset];
+    assuming(0 < Offset && Offset <= size());
+    return *(ValueTop - Offset);
   }
 
   /// Unsafe getter of top N value entries of stack.
-  Span<Value> getTopSpan(uint32_t N) {
-    return Span<Value>(ValueStack.end() - N, N);
-  }
+  Span<Value> getTopSpan(uint32_t N) { return Span<Value>(ValueTop - N, N); }
 
   /// Push a new value entry to stack.
   template <typename T> void push(T &&Val) {
-    ValueStack.push_back(std::forward<T>(Val));
+    if (unlikely(ValueTop == ValueEnd)) {
+      // The value may refer to an entry of the stack, so copy it out before
+      // reallocating.
+      Value V(std::forward<T>(Val));
+      growValueStack();
+      ::new (ValueTop++) Value(V);
+      return;
+    }
+    ::new (ValueTop++) Value(std::forward<T>(Val));
+  }
+
+  /// Push `N` copies of the value, such as the zero values of the locals of a
+  /// function, with one capacity check.
+  void pushN(uint32_t N, const Value &Val) {
+    if (ValueEnd) {
+      while (unlikely(static_cast<size_t>(ValueEnd - ValueTop) < N)) {
+        growValueStack();
+      }
+    }
+    ValueTop = std::uninitialized_fill_n(ValueTop, N, Val);
   }
 
   /// Push a vector of value to stack
   void pushValVec(const std::vector<Value> &ValVec) {
-    ValueStack.insert(ValueStack.end(), ValVec.begin(), ValVec.end());
+    for (const auto &Val : ValVec) {
+      push(Val);
+    }
   }
 
   /// Unsafe pop and return the top entry.
-  Value pop() {
-    Value V = std::move(ValueStack.back());
-    ValueStack.pop_back();
-    return V;
-  }
+  Value pop() { return *--ValueTop; }
 
   /// Unsafe pop and return the top N entries.
   std::vector<Value> pop(uint32_t N) {
-    std::vector<Value> Vec;
-    Vec.reserve(N);
-    std::move(ValueStack.end() - N, ValueStack.end(), std::back_inserter(Vec));
-    ValueStack.erase(ValueStack.end() - N, ValueStack.end());
+    std::vector<Value> Vec(ValueTop - N, ValueTop);
+    ValueTop -= N;
     return Vec;
   }
 
   /// Push a new frame entry to stack.
   void pushFrame(const Instance::ModuleInstance *Module,
                  AST::InstrView::iterator From, uint32_t LocalNum = 0,
-                 uint32_t Arity = 0, bool IsTailCall = false) noexcept {
+                 uint32_t Arity = 0, bool IsTailCall = false,
+                 const Instance::FunctionInstance *Func = nullptr) noexcept {
     if (!IsTailCall) {
-      FrameStack.emplace_back(Module, From, LocalNum, Arity,
-                              static_cast<uint32_t>(ValueStack.size()));
+      FrameStack.emplace_back(Module, Func, From, LocalNum, Arity,
+                              static_cast<uint32_t>(size()));
     } else {
       assuming(!FrameStack.empty());
       assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
       assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
-               ValueStack.size() - LocalNum);
-      ValueStack.erase(ValueStack.begin() + FrameStack.back().VPos -
-                           FrameStack.back().Locals,
-                       ValueStack.end() - LocalNum);
+               size() - LocalNum);
+      eraseValues(ValueBase + FrameStack.back().VPos - FrameStack.back().Locals,
+                  ValueTop - LocalNum);
       FrameStack.back().Module = Module;
+      FrameStack.back().Memories =
+          Module ? Module->unsafeGetMemories() : nullptr;
+      FrameStack.back().Func = Func;
       FrameStack.back().Locals = LocalNum;
       FrameStack.back().Arity = Arity;
-      FrameStack.back().VPos = static_cast<uint32_t>(ValueStack.size());
-      FrameStack.back().HandlerStack.clear();
+      FrameStack.back().VPos = static_cast<uint32_t>(size());
     }
   }
 
@@ -128,81 +234,64 @@ public:
     assuming(!FrameStack.empty());
     assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
     assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
-             ValueStack.size() - FrameStack.back().Arity);
-    ValueStack.erase(ValueStack.begin() + FrameStack.back().VPos -
-                         FrameStack.back().Locals,
-                     ValueStack.end() - FrameStack.back().Arity);
+             size() - FrameStack.back().Arity);
+    eraseValues(ValueBase + FrameStack.back().VPos - FrameStack.back().Locals,
+                ValueTop - FrameStack.back().Arity);
     auto From = FrameStack.back().From;
     FrameStack.pop_back();
     return From;
   }
 
+  /// Unsafe move the top `ArgsN` arguments to the base of the top frame and
+  /// drop the other values of the frame, for the tail call of a wasm function
+  /// reusing the frame. The locals of the callee are then pushed in place, so
+  /// that only the arguments are moved.
+  void prepareTailCall(uint32_t ArgsN) noexcept {
+    assuming(!FrameStack.empty());
+    assuming(FrameStack.back().VPos >= FrameStack.back().Locals);
+    assuming(FrameStack.back().VPos - FrameStack.back().Locals <=
+             size() - ArgsN);
+    eraseValues(ValueBase + FrameStack.back().VPos - FrameStack.back().Locals,
+                ValueTop - ArgsN);
+  }
+
   // Get all frames
   Span<const Frame> getFramesSpan() const { return FrameStack; }
 
-  /// Push handler for try-catch block.
-  void
-  pushHandler(AST::InstrView::iterator TryIt, uint32_t BlockParamNum,
-              Span<const AST::Instruction::CatchDescriptor> Catch) noexcept {
+  /// Unsafe pop top frame without erasing the values for unwinding an
+  /// exception. Returns the return PC of the popped frame.
+  AST::InstrView::iterator unwindFrame() noexcept {
     assuming(!FrameStack.empty());
-    FrameStack.back().HandlerStack.emplace_back(
-        TryIt, static_cast<uint32_t>(ValueStack.size()) - BlockParamNum, Catch);
-  }
-
-  /// Pop the top handler on the stack.
-  std::optional<Handler> popTopHandler(uint32_t AssocValSize) noexcept {
-    while (!FrameStack.empty()) {
-      auto &Frame = FrameStack.back();
-      if (!Frame.HandlerStack.empty()) {
-        auto TopHandler = std::move(Frame.HandlerStack.back());
-        Frame.HandlerStack.pop_back();
-        assuming(TopHandler.VPos <= ValueStack.size() - AssocValSize);
-        ValueStack.erase(ValueStack.begin() + TopHandler.VPos,
-                         ValueStack.end() - AssocValSize);
-        return TopHandler;
-      }
-      FrameStack.pop_back();
-    }
-    return std::nullopt;
+    auto From = FrameStack.back().From;
+    FrameStack.pop_back();
+    return From;
   }
 
-  /// Unsafe remove inactive handler.
-  void removeInactiveHandler(AST::InstrView::iterator PC) noexcept {
+  /// Unsafe erase the values of the top frame above the operand stack height
+  /// except the top `Keep` ones, for entering an exception handler.
+  void unwindValues(uint32_t Height, uint32_t Keep) noexcept {
     assuming(!FrameStack.empty());
-    // First pop the inactive handlers. Br instructions may cause the handlers
-    // in current frame becomes inactive.
-    auto &HandlerStack = FrameStack.back().HandlerStack;
-    while (!HandlerStack.empty()) {
-      auto &Handler = HandlerStack.back();
-      if (PC < Handler.Try ||
-          PC > Handler.Try + Handler.Try->getTryCatch().JumpEnd) {
-        HandlerStack.pop_back();
-      } else {
-        break;
-      }
-    }
+    assuming(FrameStack.back().VPos + Height <= size() - Keep);
+    eraseValues(ValueBase + FrameStack.back().VPos + Height, ValueTop - Keep);
   }
 
   /// Unsafe erase value stack.
   void eraseValueStack(uint32_t EraseBegin, uint32_t EraseEnd) noexcept {
-    assuming(EraseEnd <= EraseBegin && EraseBegin <= ValueStack.size());
-    ValueStack.erase(ValueStack.end() - EraseBegin,
-                     ValueStack.end() - EraseEnd);
+    assuming(EraseEnd <= EraseBegin && EraseBegin <= size());
+    eraseValues(ValueTop - EraseBegin, ValueTop - EraseEnd);
   }
 
   // Get all Value
-  Span<const Value> getValueSpan() const { return ValueStack; }
+  Span<const Value> getValueSpan() const {
+    return Span<const Value>(ValueBase, size());
+  }
 
   /// Unsafe leave top label.
-  AST::InstrView::iterator
-  maybePopFrameOrHandler(AST::InstrView::iterator PC) noexcept {
+  AST::InstrView::iterator maybePopFrame(AST::InstrView::iterator PC) noexcept {
     if (FrameStack.size() > 1 && PC->isExprLast()) {
       // Noted that there's always a base frame in stack.
       return popFrame();
     }
-    if (PC->isTryBlockLast()) {
-      FrameStack.back().HandlerStack.pop_back();
-    }
     return PC;
   }
 
@@ -214,17 +303,153 @@ public:
     return FrameStack.back().Module;
   }
 
+  /// Unsafe getter of the memory instance of the module of the top frame.
+  /// Returns nullptr for the dummy frame.
+  Instance::MemoryInstance *getMemory(uint32_t Idx) const noexcept {
+    if (unlikely(FrameStack.empty() || !FrameStack.back().Memories)) {
+      return nullptr;
+    }
+    return FrameStack.back().Memories[Idx];
+  }
+
+  /// Get the native wasm function of the top frame.
+  const Instance::FunctionInstance *getFunction() const noexcept {
+    if (unlikely(FrameStack.empty())) {
+      return nullptr;
+    }
+    return FrameStack.back().Func;
+  }
+
+  /// Count a call of the function.
+  void countCall(const Instance::FunctionInstance *Func) noexcept {
+    ++FuncCounters[Func].Calls;
+  }
+
+  /// Count an executed instruction of the function of the top frame.
+  void countInstr() noexcept {
+    const auto *Func = getFunction();
+    if (unlikely(!CountedFunc || Func != CountedFunc->first)) {
+      switchCountedFunction(Func);
+    }
+    ++CountedFunc->second.Instrs;
+  }
+
+  /// Count the self time from now on to the function.
+  void switchCountedFunction(const Instance::FunctionInstance *Func) noexcept {
+    const auto Now = std::chrono::steady_clock::now();
+    if (CountedFunc) {
+      CountedFunc->second.SelfTime += Now - CountedSince;
+    }
+    CountedFunc = &*FuncCounters.try_emplace(Func).first;
+    CountedSince = Now;
+  }
+
+  /// Take the function counters since the last taking, for merging into the
+  /// statistics.
+  FunctionCounterMap takeFunctionCounters() noexcept {
+    if (CountedFunc) {
+      CountedFunc->second.SelfTime +=
+          std::chrono::steady_clock::now() - CountedSince;
+      CountedFunc = nullptr;
+    }
+    return std::exchange(FuncCounters, {});
+  }
+
+  /// Instruction count executed by the interpreter and not charged to the
+  /// statistics yet, the cost charged from the lease, and the lease of the
+  /// cost left, which is taken from the statistics and can be charged before
+  /// checking the cost limit again.
+  struct StatBatch {
+    uint64_t InstrCount = 0;
+    uint64_t Cost = 0;
+    uint64_t CostRoom = 0;
+  };
+  StatBatch &getStatBatch() noexcept { return Batch; }
+
+  /// Get the indirect call cache entry of the key. The entry may hold another
+  /// key, and should be checked and filled by the caller.
+  IndirectCallEntry &getIndirectCallEntry(uint64_t Generation, uint32_t Slot,
+                                          uint32_t TypeIdx) noexcept {
+    if (unlikely(!IndirectCallCache)) {
+      // The generation 0 never matches.
+      IndirectCallCache.reset(new IndirectCallEntry[kIndirectCallCacheSize]());
+    }
+    const uint64_t Hash = Generation ^ Slot ^ (uint64_t(TypeIdx) << 5);
+    return IndirectCallCache[Hash & (kIndirectCallCacheSize - 1)];
+  }
+
+  /// Get the call_ref cache entry of the instruction. The entry may hold
+  /// another instruction, and should be checked and filled by the caller.
+  CallRefEntry &getCallRefEntry(const AST::Instruction *Site) noexcept {
+    if (unlikely(!CallRefCache)) {
+      CallRefCache.reset(new CallRefEntry[kCallRefCacheSize]());
+    }
+    const auto Hash = reinterpret_cast<uintptr_t>(Site) / sizeof(*Site);
+    return CallRefCache[Hash & (kCallRefCacheSize - 1)];
+  }
+
   /// Reset stack.
   void reset() noexcept {
-    ValueStack.clear();
+    ValueTop = ValueBase;
     FrameStack.clear();
   }
 
 private:
+  static_assert(std::is_trivially_copyable_v<Value> &&
+                std::is_trivially_destructible_v<Value>);
+
+  /// Size of the guard region after the fixed-capacity value stack.
+  static inline constexpr const uint64_t kGuardSize = UINT64_C(65536);
+
+  /// Count of the indirect call cache entries. Should be a power of 2.
+  static inline constexpr const uint32_t kIndirectCallCacheSize = 256;
+  /// Count of the call_ref cache entries. Should be a power of 2.
+  static inline constexpr const uint32_t kCallRefCacheSize = 256;
+
+  /// Double the capacity of the growable value stack.
+  void growValueStack() noexcept {
+    const size_t Size = size();
+    const size_t Capacity =
+        ValueBase ? static_cast<size_t>(ValueEnd - ValueBase) * 2 : 2048U;
+    Value *NewBase = std::allocator<Value>().allocate(Capacity);
+    if (ValueBase) {
+      std::uninitialized_copy(ValueBase, ValueTop, NewBase);
+      std::allocator<Value>().deallocate(
+          ValueBase, static_cast<size_t>(ValueEnd - ValueBase));
+    }
+    ValueBase = NewBase;
+    ValueTop = NewBase + Size;
+    ValueEnd = NewBase + Capacity;
+  }
+
+  /// Erase the value entries in [Begin, End) and move the entries above down.
+  void eraseValues(Value *Begin, Value *End) noexcept {
+    if (Begin != End) {
+      ValueTop = std::copy(End, ValueTop, Begin);
+    }
+  }
+
   /// \name Data of stack manager.
   /// @{
-  std::vector<Value> ValueStack;
+  /// Value stack in [ValueBase, ValueTop). `ValueEnd` is the end of the
+  /// growable storage and null for the fixed-capacity value stack, whose guard
+  /// region starts at `ValueGuard`.
+  Value *ValueBase = nullptr;
+  Value *ValueTop = nullptr;
+  Value *ValueEnd = nullptr;
+  Value *ValueGuard = nullptr;
   std::vector<Frame> FrameStack;
+  /// Cache of the indirect calls, allocated at the first use.
+  std::unique_ptr<IndirectCallEntry[]> IndirectCallCache;
+  /// Cache of the call_ref instructions, allocated at the first use.
+  std::unique_ptr<CallRefEntry[]> CallRefCache;
+  /// Function counters, and the counter of the function counting the self
+  /// time since the time point.
+  FunctionCounterMap FuncCounters;
+  FunctionCounterMap::value_type *CountedFunc = nullptr;
+  std::chrono::steady_clock::time_point CountedSince;
+  /// Statistics of the interpreter charged in batches.
+  StatBatch Batch;
   /// @}
 };
 
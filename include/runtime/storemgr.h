@@ -15,7 +15,9 @@
 
 #include "runtime/instance/component/component.h"
 #include "runtime/instance/module.h"
+#include "runtime/nameindex.h"
 
+#include <atomic>
 #include <mutex>
 #include <shared_mutex>
 #include <vector>
@@ -49,13 +51,10 @@ public:
     return std::forward<CallbackT>(CallBack)(NamedMod);
   }
 
-  /// Find module by name.
+  /// Find module by name. The lookups take no lock once the hash index of
+  /// the registered modules is built.
   const Instance::ModuleInstance *findModule(std::string_view Name) const {
-    std::shared_lock Lock(Mutex);
-    if (auto Iter = NamedMod.find(Name); likely(Iter != NamedMod.cend())) {
-      return Iter->second;
-    }
-    return nullptr;
+    return NamedModIndex.find(NamedMod, Mutex, Name);
   }
 
   /// Find component by name.
@@ -68,13 +67,21 @@ public:
     return nullptr;
   }
 
+  /// Getter of the generation, which changes whenever the registered modules
+  /// change.
+  uint64_t getGeneration() const noexcept {
+    return Generation.load(std::memory_order_acquire);
+  }
+
   /// Reset this store manager and unlink all the registered module instances.
   void reset() noexcept {
-    std::shared_lock Lock(Mutex);
+    std::unique_lock Lock(Mutex);
     for (auto &&Pair : NamedMod) {
       (const_cast<Instance::ModuleInstance *>(Pair.second))->unlinkStore(this);
     }
     NamedMod.clear();
+    NamedModIndex.invalidate();
+    Generation.fetch_add(1, std::memory_order_release);
   }
 
   /// Register named module into this store.
@@ -85,6 +92,8 @@ public:
       return Unexpect(ErrCode::Value::ModuleNameConflict);
     }
     NamedMod.emplace(ModInst->getModuleName(), ModInst);
+    NamedModIndex.invalidate();
+    Generation.fetch_add(1, std::memory_order_release);
     // Link the module instance to this store manager.
     (const_cast<Instance::ModuleInstance *>(ModInst))
         ->linkStore(this, [](StoreManager *Store,
@@ -92,6 +101,8 @@ public:
           // The unlink callback.
           std::unique_lock CallbackLock(Store->Mutex);
           (Store->NamedMod).erase(std::string(Inst->getModuleName()));
+          Store->NamedModIndex.invalidate();
+          Store->Generation.fetch_add(1, std::memory_order_release);
         });
     return {};
   }
@@ -105,6 +116,8 @@ public:
     }
     (const_cast<Instance::ModuleInstance *>(Iter->second))->unlinkStore(this);
     NamedMod.erase(Iter);
+    NamedModIndex.invalidate();
+    Generation.fetch_add(1, std::memory_order_release);
     return {};
   }
 
@@ -132,6 +145,10 @@ private:
 
   /// \name Module name mapping.
   std::map<std::string, const Instance::ModuleInstance *, std::less<>> NamedMod;
+  /// Hash index of the module name mapping for the lookups.
+  NameIndex<const Instance::ModuleInstance> NamedModIndex;
+  /// Generation of the module name mapping.
+  std::atomic<uint64_t> Generation = 0;
   /// \name Component name mapping.
   std::map<std::string, const Instance::ComponentInstance *, std::less<>>
       NamedComp;
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/runtime/typeregistry.h - Type registry definition --------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the type registry, which assigns the
+/// canonical types to the defined types of the module instances for the
+/// constant-time subtype checks of the GC cast instructions.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/type.h"
+#include "common/span.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Runtime {
+
+/// Canonical defined type. The equivalent defined types under the
+/// iso-recursive type equivalence share the same canonical type across the
+/// modules.
+struct CanonicalType {
+  /// Identifier of the equivalent defined types.
+  uint32_t Id;
+  /// Identifiers of the supertype chain from the root type to this type,
+  /// indexed by the depth of the types.
+  std::vector<uint32_t> Display;
+
+  /// Check if this type is a subtype of the expected type.
+  bool isSubTypeOf(const CanonicalType &Exp) const noexcept {
+    const size_t Depth = Exp.Display.size() - 1;
+    return Depth < Display.size() && Display[Depth] == Exp.Id;
+  }
+};
+
+/// Process-wide registry of the canonical types. The canonical types are
+/// never released, so that the references to them are valid in all module
+/// instances.
+class TypeRegistry {
+public:
+  /// The registry of the process.
+  static TypeRegistry &getDefault() noexcept;
+
+  /// Canonicalize the defined types in the order of the type list, by the
+  /// recursive type groups. The result stops before the first group which
+  /// is incomplete or refers to an unknown type.
+  std::vector<const CanonicalType *>
+  canonicalize(Span<const AST::SubType *const> TypeList);
+
+private:
+  /// Encode the recursive type group, where the types out of the group are
+  /// referred by their canonical identifiers.
+  static bool encode(Span<const AST::SubType *const> TypeList, uint32_t Start,
+                     uint32_t Size, Span<const CanonicalType *const> Known,
+                     std::vector<uint64_t> &Key);
+
+  struct KeyHash {
+    size_t operator()(const std::vector<uint64_t> &Key) const noexcept;
+  };
+
+  std::mutex Mutex;
+  /// Identifier of the first type of the encoded recursive type groups.
+  std::unordered_map<std::vector<uint64_t>, uint32_t, KeyHash> Groups;
+  /// Canonical types indexed by the identifiers.
+  std::deque<CanonicalType> Types;
+};
+
+} // namespace Runtime
+} // namespace WasmEdge
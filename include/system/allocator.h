@@ -14,6 +14,7 @@
 #pragma once
 
 #include "common/defines.h"
+#include "common/span.h"
 #include <cstdint>
 
 namespace WasmEdge {
@@ -36,12 +37,87 @@ public:
   WASMEDGE_EXPORT static void release(uint8_t *Pointer,
                                       uint32_t PageCount) noexcept;
 
-  static uint8_t *allocate_chunk(uint64_t Size) noexcept;
+  /// Shrink a linear memory in place, which makes the pages after the new
+  /// size inaccessible and releases them. Return false if unsupported or
+  /// failed.
+  WASMEDGE_EXPORT static bool shrink(uint8_t *Pointer, uint32_t OldPageCount,
+                                     uint32_t NewPageCount) noexcept;
+
+  /// Allocate a 64-bit linear memory, which reserves ReservedPageCount pages
+  /// followed by a 4G guard region instead of the 32-bit layout. The memory
+  /// can be resized up to the reserved pages without moving, and any access
+  /// below the reserved size plus 4G faults instead of being checked.
+  WASMEDGE_EXPORT static uint8_t *
+  allocate64(uint32_t PageCount, uint32_t ReservedPageCount) noexcept;
+
+  WASMEDGE_EXPORT static void release64(uint8_t *Pointer,
+                                        uint32_t ReservedPageCount) noexcept;
+
+  /// Discard the accessible anonymous pages of a linear memory in the range,
+  /// which read as zeros afterwards. The range should be aligned to the
+  /// WebAssembly page size. Return false if unsupported or failed.
+  WASMEDGE_EXPORT static bool discard(uint8_t *Pointer, uint64_t Size) noexcept;
+
+  /// Keep up to Count released linear memory reservations for reuse by the
+  /// later allocate() calls, instead of returning them to the OS. The pages
+  /// of a kept reservation are discarded, so it is zeroed when reused. The
+  /// pool is process-wide; 0 disables it and frees the kept reservations.
+  WASMEDGE_EXPORT static void setPoolCapacity(uint32_t Count) noexcept;
+  WASMEDGE_EXPORT static uint32_t getPoolCapacity() noexcept;
+
+  /// Back the later linear memories with the transparent huge pages. The
+  /// setting is process-wide; it is ignored where unsupported, and the normal
+  /// pages are used if the kernel does not provide the huge pages.
+  WASMEDGE_EXPORT static void setHugePages(bool IsEnable) noexcept;
+  WASMEDGE_EXPORT static bool isHugePages() noexcept;
+
+  /// Stripe the later linear memories of at most SlotPages pages into the
+  /// slots of one shared reservation, instead of reserving 12G for each of
+  /// them. The slots are tagged with the memory protection keys in turn, so
+  /// that the slots within the 8G reach of the compiled code from a memory
+  /// have the other keys, and the compiled code of a module instance only has
+  /// the rights of the keys of its memories. The slots are enlarged when the
+  /// keys are not enough for SlotPages. The setting is process-wide and kept
+  /// once enabled. Only supported on x86-64 Linux with the protection keys;
+  /// return false if unsupported or failed.
+  ///
+  /// The threads created before have no rights of the keys until they enter
+  /// the executions, so it should be enabled before creating the threads
+  /// accessing the memories.
+  WASMEDGE_EXPORT static bool enableStriping(uint32_t SlotPages) noexcept;
+  /// Get the pages of a slot, or 0 if the striping is not enabled.
+  WASMEDGE_EXPORT static uint32_t getStripedSlotPages() noexcept;
+
+  /// Allocate a linear memory in a slot, which can be resized up to the pages
+  /// of a slot and is released by release(). Return nullptr if the striping
+  /// is not enabled or the slots are exhausted.
+  WASMEDGE_EXPORT static uint8_t *allocateStriped(uint32_t PageCount) noexcept;
+
+  /// Tag the pages mapped again in a striped linear memory with the key of
+  /// its slot, as the new mappings have the default key. Do nothing for the
+  /// other memories.
+  WASMEDGE_EXPORT static bool tagStripedPages(uint8_t *Pointer, uint64_t Size,
+                                              bool Writable) noexcept;
+
+  /// Deny the accesses of this thread to the striped memories except the
+  /// given ones, and return the rights before for restoreProtectionKeys().
+  WASMEDGE_EXPORT static uint32_t
+  restrictProtectionKeys(Span<uint8_t *const> Memories) noexcept;
+  /// Allow the accesses of this thread to all the striped memories, and
+  /// return the rights before for restoreProtectionKeys().
+  WASMEDGE_EXPORT static uint32_t allowProtectionKeys() noexcept;
+  WASMEDGE_EXPORT static void restoreProtectionKeys(uint32_t Rights) noexcept;
+
+  /// Allocate a readable and writable chunk. If HugePages is set, the chunk is
+  /// aligned to and backed with the transparent huge pages when possible.
+  static uint8_t *allocate_chunk(uint64_t Size,
+                                 bool HugePages = false) noexcept;
   static void release_chunk(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_executable(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_readable(uint8_t *Pointer, uint64_t Size) noexcept;
   static bool set_chunk_readable_writable(uint8_t *Pointer,
                                           uint64_t Size) noexcept;
+  static bool set_chunk_inaccessible(uint8_t *Pointer, uint64_t Size) noexcept;
 };
 
 } // namespace WasmEdge
@@ -14,31 +14,55 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/defines.h"
 #include "common/errcode.h"
 #include <array>
 #include <csetjmp>
 
+// The traps of the compiled code unwind to the handler on the targets where
+// the fault handler can redirect the faulting thread to a throwing stub.
+#if WASMEDGE_OS_LINUX && defined(__x86_64__)
+#define WASMEDGE_FAULT_UNWINDING 1
+#else
+#define WASMEDGE_FAULT_UNWINDING 0
+#endif
+
 namespace WasmEdge {
 
 class Fault {
 public:
+  /// Tag of the handlers catching the faults by unwinding.
+  struct Unwinding {};
+
+  /// Construct the handler jumping back to the buffer prepared by
+  /// PREPARE_FAULT.
   Fault();
 
+  /// Construct the handler where the faults are thrown as ErrCode, which the
+  /// caller catches. No buffer is prepared, so entering the compiled code
+  /// costs no setjmp. Only the faults in the compiled code and the faults
+  /// emitted by the intrinsics can be thrown. The host code run by the
+  /// compiled code needs a jumping handler for its own faults.
+  explicit Fault(Unwinding) noexcept;
+
   ~Fault() noexcept;
 
   [[noreturn]] static void emitFault(ErrCode Error);
 
   std::jmp_buf &buffer() noexcept { return Buffer; }
 
+  bool isUnwinding() const noexcept { return Unwind; }
+
   Span<void *const> stacktrace() const noexcept {
     return Span<void *const>{StackTraceBuffer}.first(StackTraceSize);
   }
 
 private:
   Fault *Prev = nullptr;
+  bool Unwind = false;
   std::jmp_buf Buffer;
   std::array<void *, 256> StackTraceBuffer;
-  size_t StackTraceSize;
+  size_t StackTraceSize = 0;
 };
 
 } // namespace WasmEdge
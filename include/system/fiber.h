@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/system/fiber.h - Stackful coroutine ----------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the fiber, which runs a function on its own stack and
+/// can be suspended and resumed on the same thread.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace WasmEdge {
+
+class Fiber {
+public:
+  static inline constexpr const size_t kDefaultStackSize = 2 * 1024 * 1024;
+
+  /// Swap the thread local state with the storage of a fiber. The storage is
+  /// zero-initialized when the fiber is created.
+  using SwapLocalFunc = void (*)(void *Storage) noexcept;
+
+  /// Register the thread local state kept per fiber, which must be done
+  /// during the static initialization, before any fiber is created.
+  ///
+  /// @param[in] Size The size of the storage of the state.
+  /// @param[in] Swap The function to swap the state with the storage.
+  /// @return Always true, for initializing a static variable.
+  static bool registerLocal(size_t Size, SwapLocalFunc Swap) noexcept;
+
+  /// Create a fiber running the function. The function must not throw.
+  ///
+  /// @return The fiber, or nullptr if failed or not supported.
+  static std::unique_ptr<Fiber>
+  create(std::function<void()> Func,
+         size_t StackSize = kDefaultStackSize) noexcept;
+
+  Fiber(const Fiber &) = delete;
+  Fiber &operator=(const Fiber &) = delete;
+  /// Destroying an unfinished fiber releases its stack without unwinding it.
+  ~Fiber() noexcept;
+
+  /// Run the fiber on the calling thread, until it suspends or finishes. A
+  /// suspended fiber must be resumed on the same thread.
+  void resume() noexcept;
+
+  /// Suspend the running fiber, and return to the caller of `resume`.
+  static void suspend() noexcept;
+
+  /// The fiber running on the calling thread, or nullptr.
+  static Fiber *current() noexcept;
+
+  bool done() const noexcept { return Finished; }
+
+private:
+  struct Context;
+
+  Fiber() noexcept;
+
+  static void entry() noexcept;
+  void swapLocals() noexcept;
+
+  std::unique_ptr<Context> Ctx;
+  std::function<void()> Func;
+  std::unique_ptr<std::max_align_t[]> Locals;
+  void *Stack = nullptr;
+  size_t StackSize = 0;
+  Fiber *Prev = nullptr;
+  bool Finished = false;
+};
+
+} // namespace WasmEdge
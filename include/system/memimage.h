@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/system/memimage.h - Linear memory image ------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the snapshot of initialized linear memory, which can be
+/// mapped copy-on-write into the memory reservations of the allocator.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/span.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace WasmEdge {
+
+class MemoryImage {
+public:
+  MemoryImage(const MemoryImage &) = delete;
+  MemoryImage &operator=(const MemoryImage &) = delete;
+  ~MemoryImage() noexcept;
+
+  /// Record the bytes into an anonymous file. The size of the bytes should be
+  /// aligned to the host page size. Returns nullptr if not supported or
+  /// failed.
+  static std::unique_ptr<MemoryImage> create(Span<const uint8_t> Data) noexcept;
+
+  /// Size in bytes of the image.
+  uint64_t size() const noexcept { return Size; }
+
+  /// Map the image as private writable pages over Pointer[0 : size()), which
+  /// should be the accessible pages of a memory allocated by the allocator.
+  bool map(uint8_t *Pointer) const noexcept;
+
+  /// Replace the mapped image at Pointer[0 : Size) by zeroed anonymous
+  /// writable pages, which the allocator can release or resize as usual.
+  static bool unmap(uint8_t *Pointer, uint64_t Size) noexcept;
+
+  /// Map the file as shared pages over Pointer[0 : Size), which should be the
+  /// accessible pages of a memory allocated by the allocator, so that the data
+  /// is shared with all the other mappings of the file. The pages are
+  /// read-only if not writable. The file should have at least Size bytes, and
+  /// can be closed after mapped.
+  static bool mapShared(int File, uint8_t *Pointer, uint64_t Size,
+                        bool Writable) noexcept;
+
+  static bool supported() noexcept;
+
+private:
+  MemoryImage(int F, uint64_t S) noexcept : File(F), Size(S) {}
+
+  int File;
+  uint64_t Size;
+};
+
+} // namespace WasmEdge
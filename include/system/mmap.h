@@ -16,6 +16,8 @@
 
 #include "common/filesystem.h"
 
+#include <cstdint>
+
 namespace WasmEdge {
 
 class MMap {
@@ -25,6 +27,13 @@ public:
   void *address() const noexcept;
   static bool supported() noexcept;
 
+  /// Map the file range at the offset over the pages at the address, read-only
+  /// and executable. The pages share the page cache with the other processes
+  /// mapping the same file. The address, offset and size should be aligned to
+  /// the page size. Return false if unsupported or failed.
+  bool mapExecutable(void *Address, uint64_t Offset,
+                     uint64_t Size) const noexcept;
+
 private:
   void *Handle;
 };
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/system/nativestack.h - Dedicated native stack ------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the dedicated stack of the executing threads for the
+/// compiled code, which has a guard page for trapping the overflows.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace WasmEdge {
+
+class NativeStack {
+public:
+  using Func = void (*)(void *Data) noexcept;
+
+  /// Run the function on the dedicated stack of the calling thread, which has
+  /// a guard page below it. The stack is mapped at the first run and reused
+  /// by the later runs on the thread. A run nested in another one stays on
+  /// the same stack. The function must not throw.
+  ///
+  /// @param[in] Size The size of the stack, rounded up to the pages.
+  /// @return False if not supported, where the function is not run.
+  static bool run(size_t Size, Func F, void *Data) noexcept;
+
+  template <typename FuncT> static bool run(size_t Size, FuncT &F) noexcept {
+    return run(
+        Size, [](void *Data) noexcept { (*static_cast<FuncT *>(Data))(); },
+        &F);
+  }
+
+  /// Check the address is in the guard page of the stack of the calling
+  /// thread, for reporting the overflows in the fault handler.
+  static bool isGuardAddress(const void *Addr) noexcept;
+};
+
+} // namespace WasmEdge
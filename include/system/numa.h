@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/system/numa.h - NUMA placement ---------------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the placement of the linear memories and the executing
+/// threads on the NUMA nodes. Only supported on Linux, and the functions fail
+/// or return empty results on the other platforms.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace WasmEdge {
+
+class Numa {
+public:
+  /// Count of the NUMA nodes of the host, or 0 if not supported.
+  static uint32_t getNodeCount() noexcept;
+
+  /// Getter of the CPUs of the node.
+  static std::vector<uint32_t> getNodeCPUs(uint32_t Node) noexcept;
+
+  /// Prefer the node for the pages in Pointer[0 : Size), which should be
+  /// mapped and aligned to the host pages. The pages faulted in after binding
+  /// are allocated on the node, or on the others if the node is full.
+  static bool bindMemory(void *Pointer, uint64_t Size, uint32_t Node) noexcept;
+
+  /// Pin the calling thread on the CPUs of the node.
+  static bool bindThread(uint32_t Node) noexcept;
+};
+
+} // namespace WasmEdge
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/system/sampler.h - Sampling profiler ---------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the sampling profiler of the wasm executions.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "runtime/instance/module.h"
+#include "runtime/stackmgr.h"
+
+#include <cstdint>
+
+namespace WasmEdge {
+
+/// Process-wide sampling profiler of the wasm executions. Every thread in a
+/// `Scope` gets a timer of its CPU time, which interrupts it with SIGPROF. The
+/// signal handler records the native wasm functions in the frames of the
+/// interpreter and the return addresses of the native stack, without any
+/// allocation or lock. The samples are aggregated by the recorded stacks, and
+/// only resolved to the functions of the registered modules when writing.
+///
+/// Only supported on Linux.
+class Sampler {
+public:
+  /// Start sampling at the frequency in Hz, and clear the recorded samples.
+  /// Returns false if the sampling is not supported or already started.
+  static bool start(uint32_t Frequency = 99) noexcept;
+
+  /// Stop sampling. The recorded samples are kept until the next start.
+  static void stop() noexcept;
+
+  static bool isActive() noexcept;
+
+  /// Getter of the count of the recorded samples, and of the samples dropped
+  /// because there were too many different stacks.
+  static uint64_t getSampleCount() noexcept;
+  static uint64_t getDroppedCount() noexcept;
+
+  /// Record the names of the functions of the instantiated module, from the
+  /// function names subsection of the name section or from the exports.
+  static void registerModule(const Runtime::Instance::ModuleInstance &ModInst,
+                             const AST::Module &Mod) noexcept;
+
+  /// Write the samples in the collapsed stack format of the flame graph
+  /// tools. Every line is a stack of function names from the root separated
+  /// by `;`, followed by its sample count.
+  static Expect<void> saveCollapsed(const std::filesystem::path &Path) noexcept;
+
+  /// Sample the executions of the stack manager on the calling thread during
+  /// the scope. The scopes can be nested.
+  class Scope {
+  public:
+    Scope(const Runtime::StackManager &StackMgr) noexcept;
+    ~Scope() noexcept;
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    const Runtime::StackManager *Prev;
+  };
+};
+
+} // namespace WasmEdge
@@ -823,6 +823,9 @@ SetFileTime(WasmEdge::winapi::HANDLE_ hFile,
             const WasmEdge::winapi::FILETIME_ *lpLastAccessTime,
             const WasmEdge::winapi::FILETIME_ *lpLastWriteTime);
 
+WASMEDGE_WINAPI_SYMBOL_IMPORT WasmEdge::winapi::VOID_ WASMEDGE_WINAPI_WINAPI_CC
+Sleep(WasmEdge::winapi::DWORD_ dwMilliseconds);
+
 WASMEDGE_WINAPI_SYMBOL_IMPORT WasmEdge::winapi::BOOL_
     WASMEDGE_WINAPI_WINAPI_CC SwitchToThread(WasmEdge::winapi::VOID_);
 
@@ -1055,6 +1058,7 @@ using ::RemoveDirectoryW;
 using ::SetEndOfFile;
 using ::SetFilePointerEx;
 using ::SetFileTime;
+using ::Sleep;
 using ::SwitchToThread;
 using ::UnmapViewOfFile;
 using ::WaitForMultipleObjects;
@@ -1318,6 +1322,7 @@ using ::SHGetKnownFolderPath;
 namespace WasmEdge::winapi {
 static inline constexpr const DWORD_ MEM_COMMIT_ = 0x00001000;
 static inline constexpr const DWORD_ MEM_RESERVE_ = 0x00002000;
+static inline constexpr const DWORD_ MEM_DECOMMIT_ = 0x00004000;
 static inline constexpr const DWORD_ MEM_RELEASE_ = 0x00008000;
 
 static inline constexpr const DWORD_ PAGE_NOACCESS_ = 0x01;
@@ -1372,6 +1377,7 @@ static inline constexpr const DWORD_ EXCEPTION_INT_DIVIDE_BY_ZERO_ =
 static inline constexpr const DWORD_ EXCEPTION_INT_OVERFLOW_ = 0xC0000095L;
 static inline constexpr const LONG_ EXCEPTION_CONTINUE_EXECUTION_ =
     static_cast<LONG_>(0xffffffff);
+static inline constexpr const LONG_ EXCEPTION_CONTINUE_SEARCH_ = 0;
 
 using EXCEPTION_RECORD_ = struct _EXCEPTION_RECORD {
   DWORD_ ExceptionCode;
@@ -1637,6 +1643,18 @@ using LINGER = struct linger {
   u_short l_linger;
 };
 
+using WSAPOLLFD_ = struct pollfd {
+  SOCKET_ fd;
+  SHORT_ events;
+  SHORT_ revents;
+};
+
+static inline constexpr const SHORT_ POLLERR = 0x0001;
+static inline constexpr const SHORT_ POLLHUP = 0x0002;
+static inline constexpr const SHORT_ POLLNVAL = 0x0004;
+static inline constexpr const SHORT_ POLLWRNORM = 0x0010;
+static inline constexpr const SHORT_ POLLRDNORM = 0x0100;
+
 static inline constexpr const int AI_PASSIVE = 0x00000001;
 static inline constexpr const int AI_CANONNAME = 0x00000002;
 static inline constexpr const int AI_NUMERICHOST = 0x00000004;
@@ -1822,6 +1840,10 @@ WASMEDGE_WINAPI_SYMBOL_IMPORT int
 WASMEDGE_WINAPI_SYMBOL_IMPORT int
     WASMEDGE_WINAPI_WINAPI_CC WSAGetLastError(WasmEdge::winapi::VOID_);
 
+WASMEDGE_WINAPI_SYMBOL_IMPORT int WASMEDGE_WINAPI_WINAPI_CC
+WSAPoll(WasmEdge::winapi::WSAPOLLFD_ *fdArray, WasmEdge::winapi::ULONG_ fds,
+        WasmEdge::winapi::INT_ timeout);
+
 WASMEDGE_WINAPI_SYMBOL_IMPORT int WASMEDGE_WINAPI_WINAPI_CC
 WSAStartup(WasmEdge::winapi::WORD_ wVersionRequested,
            WasmEdge::winapi::LPWSADATA_ lpWSAData);
@@ -1853,6 +1875,7 @@ using ::shutdown;
 using ::socket;
 using ::WSACleanup;
 using ::WSAGetLastError;
+using ::WSAPoll;
 using ::WSAStartup;
 } // namespace WasmEdge::winapi
 
@@ -50,11 +50,20 @@ public:
   void addElem(const AST::ElementSegment &Elem);
   void addData(const AST::DataSegment &Data);
   void addRef(const uint32_t FuncIdx);
-  void addLocal(const ValType &V, bool Initialized);
+  void addLocal(const ValType &V, bool Initialized) {
+    addLocals(1, V, Initialized);
+  }
+  /// Add `Count` locals of the same type as a group.
+  void addLocals(uint32_t Count, const ValType &V, bool Initialized);
   void addTag(const uint32_t TypeIdx);
 
   std::vector<VType> result() { return ValStack; }
   auto &getTypes() const { return Types; }
+  /// Replace the type contexts, e.g. by the copies owned by the caller when
+  /// this checker outlives the module.
+  void setTypes(std::vector<const AST::SubType *> NewTypes) {
+    Types = std::move(NewTypes);
+  }
   auto &getFunctions() { return Funcs; }
   auto &getTables() { return Tables; }
   auto &getMemories() { return Mems; }
@@ -92,12 +101,19 @@ public:
     OpCode Code;
   };
 
-  struct LocalType {
-    LocalType(ValType VT, bool Initialized = false)
-        : IsInit(Initialized), VType(VT) {}
-    bool IsInit;
-    const ValType VType;
+  /// Run-length group of the locals of the same type. The groups are sorted
+  /// by the local indices, so a local is found by binary search instead of
+  /// expanding every local of the function.
+  struct LocalGroup {
+    /// Index of the first local and the index after the last local.
+    uint32_t Begin;
+    uint32_t End;
+    /// Offset of the first local in the initialization flags, or
+    /// `kInitialized` if the locals are always initialized.
+    uint32_t InitOffset;
+    ValType VType;
   };
+  static inline constexpr uint32_t kInitialized = UINT32_MAX;
 
 private:
   /// Checking expression
@@ -109,6 +125,9 @@ private:
   /// Instruction iteration
   Expect<void> checkInstr(const AST::Instruction &Instr);
 
+  /// Find the group of the local. The index should be checked first.
+  const LocalGroup &getLocalGroup(uint32_t Idx) const noexcept;
+
   /// Stack operations
   void pushType(VType);
   void pushTypes(Span<const VType> Input);
@@ -129,14 +148,19 @@ private:
   std::vector<const AST::SubType *> Types;
   std::vector<uint32_t> Funcs;
   std::vector<ValType> Tables;
-  uint32_t Mems = 0;
+  /// Address types of the memories.
+  std::vector<ValType> Mems;
   std::vector<std::pair<ValType, ValMut>> Globals;
   std::vector<ValType> Elems;
   std::vector<uint32_t> Datas;
   std::unordered_set<uint32_t> Refs;
   uint32_t NumImportFuncs = 0;
   uint32_t NumImportGlobals = 0;
-  std::vector<LocalType> Locals;
+  std::vector<LocalGroup> Locals;
+  uint32_t LocalNum = 0;
+  /// Initialization flags of the locals without default values, and the
+  /// offsets of the flags set in the current control frames.
+  std::vector<bool> LocalInitFlags;
   std::vector<uint32_t> LocalInits;
   std::vector<ValType> Returns;
   std::vector<uint32_t> Tags;
@@ -144,6 +168,8 @@ private:
   /// Running stack.
   std::vector<CtrlFrame> CtrlStack;
   std::vector<VType> ValStack;
+  /// Entered try_table instructions.
+  std::vector<const AST::Instruction *> TryStack;
 };
 
 } // namespace Validator
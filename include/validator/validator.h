@@ -20,6 +20,9 @@
 #include "validator/formchecker.h"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace WasmEdge {
 namespace Validator {
@@ -35,7 +38,21 @@ public:
   /// Validate AST::Component.
   Expect<void> validate(const AST::Component::Component &Comp) noexcept;
 
+  /// \name Fused loading and validation of a module
+  /// @{
+  /// Validate the sections before the code section of the module being
+  /// loaded, and register their contexts for the function bodies.
+  Expect<void> validateBeforeCode(const AST::Module &Mod);
+  /// Validate the next function body of the module being loaded right after
+  /// it is decoded, and mark it as validated. The later module validation
+  /// skips the validated bodies.
+  Expect<void> validateNextBody(AST::CodeSegment &CodeSeg);
+  /// @}
+
 private:
+  /// Validate and register the sections before the code section.
+  Expect<void> validateContexts(const AST::Module &Mod);
+
   /// \name Validate WASM AST nodes
   /// @{
   // Validate AST::Types
@@ -77,6 +94,9 @@ private:
   // Validate component
   Expect<void>
   validateComponent(const AST::Component::Component &Comp) noexcept;
+  // Validate the core modules of the component and the nested components
+  Expect<void>
+  validateCoreModules(const AST::Component::Component &Comp) noexcept;
   // Validate component sections
   Expect<void>
   validate(const AST::Component::CoreModuleSection &ModSec) noexcept;
@@ -130,6 +150,18 @@ private:
   const Configure Conf;
   /// Formal checker
   FormChecker Checker;
+  /// Index of the next function body in the fused loading and validation.
+  uint32_t NextBody = 0;
+  /// Formal checker shared by the deferred function bodies of the module in
+  /// the lazy loading mode. It owns the copies of the types so that the bodies
+  /// can be validated after the AST module is released.
+  struct LazyContext {
+    LazyContext(const FormChecker &C) : Checker(C) {}
+    std::vector<std::unique_ptr<const AST::SubType>> Types;
+    FormChecker Checker;
+    std::mutex Mutex;
+  };
+  std::shared_ptr<LazyContext> LazyCtx;
   /// Context for Component validation
   ComponentContext CompCtx;
 };
@@ -28,9 +28,11 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -44,7 +46,7 @@ public:
   VM() = delete;
   VM(const Configure &Conf);
   VM(const Configure &Conf, Runtime::StoreManager &S);
-  ~VM() = default;
+  ~VM();
 
   /// ======= Functions can be called before instantiated stage. =======
   /// Register wasm modules and host modules.
@@ -131,6 +133,12 @@ public:
     std::unique_lock Lock(Mutex);
     return unsafeLoadWasm(Module);
   }
+  /// Load the wasm bytecode arriving in the stream, decoding the arrived bytes
+  /// while the rest is still downloading.
+  Expect<void> loadWasm(std::shared_ptr<CodeStream> Code) {
+    std::unique_lock Lock(Mutex);
+    return unsafeLoadWasm(std::move(Code));
+  }
 
   /// ======= Functions can be called after loaded stage. =======
   /// Validate loaded wasm module.
@@ -147,6 +155,19 @@ public:
   }
 
   /// ======= Functions can be called after instantiated stage. =======
+  /// Keep the active module instance as the snapshot, and continue with a
+  /// clone of it. The snapshot is dropped by the next instantiation.
+  Expect<void> snapshot() {
+    std::unique_lock Lock(Mutex);
+    return unsafeSnapshot();
+  }
+
+  /// Replace the active module instance with a new clone of the snapshot.
+  Expect<void> restore() {
+    std::unique_lock Lock(Mutex);
+    return unsafeRestore();
+  }
+
   /// Execute wasm with given input.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   execute(std::string_view Func, Span<const ValVariant> Params = {},
@@ -164,6 +185,18 @@ public:
     return unsafeExecute(ModName, Func, Params, ParamTypes);
   }
 
+  /// Execute wasm once for every row of a batch, with the arguments and the
+  /// results in the struct-of-arrays columns. See `Executor::invokeBatch`.
+  Expect<void> executeBatch(std::string_view Func,
+                            Span<const ValType> ParamTypes,
+                            Span<const void *const> Params,
+                            Span<void *const> Returns, uint32_t Rows,
+                            uint32_t Threads = 1) {
+    std::shared_lock Lock(Mutex);
+    return unsafeExecuteBatch(Func, ParamTypes, Params, Returns, Rows,
+                              Threads);
+  }
+
   /// Execute component function with given input.
   Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
   executeComponent(std::string_view Func,
@@ -289,12 +322,16 @@ private:
 
   Expect<void> unsafeLoadWasm(const std::filesystem::path &Path);
   Expect<void> unsafeLoadWasm(Span<const Byte> Code);
+  Expect<void> unsafeLoadWasm(std::shared_ptr<CodeStream> Code);
   Expect<void> unsafeLoadWasm(const AST::Module &Module);
 
   Expect<void> unsafeValidate();
 
   Expect<void> unsafeInstantiate();
 
+  Expect<void> unsafeSnapshot();
+  Expect<void> unsafeRestore();
+
   Expect<std::vector<std::pair<ValVariant, ValType>>>
   unsafeExecute(std::string_view Func, Span<const ValVariant> Params = {},
                 Span<const ValType> ParamTypes = {});
@@ -304,6 +341,12 @@ private:
                 Span<const ValVariant> Params = {},
                 Span<const ValType> ParamTypes = {});
 
+  Expect<void> unsafeExecuteBatch(std::string_view Func,
+                                  Span<const ValType> ParamTypes,
+                                  Span<const void *const> Params,
+                                  Span<void *const> Returns, uint32_t Rows,
+                                  uint32_t Threads);
+
   Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
   unsafeExecuteComponent(std::string_view Func,
                          Span<const ComponentValVariant> Params = {},
@@ -334,6 +377,12 @@ private:
   void unsafeLoadPlugInHosts();
   void unsafeRegisterBuiltInHosts();
   void unsafeRegisterPlugInHosts();
+  /// Load and register the deferred plugins providing the imports.
+  Expect<void> unsafeLoadDeferredPlugInHosts(const AST::Module &Module);
+
+  /// Helper functions for the tiered JIT mode.
+  void requestTierUp(const Runtime::Instance::ModuleInstance &ModInst);
+  void unsafeStopTierUp();
 
   /// Helper function for execution.
   Expect<std::vector<std::pair<ValVariant, ValType>>>
@@ -370,6 +419,8 @@ private:
   /// Active module instance.
   std::unique_ptr<Runtime::Instance::ModuleInstance> ActiveModInst;
   std::unique_ptr<Runtime::Instance::ComponentInstance> ActiveCompInst;
+  /// Snapshot of the active module instance, which is never executed.
+  std::unique_ptr<Runtime::Instance::ModuleInstance> SnapshotModInst;
   /// Registered module instances by user.
   std::vector<std::unique_ptr<Runtime::Instance::ModuleInstance>> RegModInsts;
   /// Built-in module instances mapped to the configurations. For WASI.
@@ -386,6 +437,16 @@ private:
   /// Reference to the store.
   Runtime::StoreManager &StoreRef;
   /// @}
+
+  /// \name Tiered JIT mode.
+  /// @{
+  /// AST module of the active module instance, nullptr if it is not owned by
+  /// the VM.
+  const AST::Module *TierUpMod = nullptr;
+  /// Background compilation of the active module instance.
+  std::mutex TierUpMutex;
+  std::thread TierUpThread;
+  /// @}
 };
 
 } // namespace VM
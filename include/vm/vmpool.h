@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/vm/vmpool.h - VM pool class definition -------------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file is the definition class of VMPool class, which leases the
+/// pre-instantiated VMs of a module for serving one request per instance.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/async.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "vm/vm.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace WasmEdge {
+namespace VM {
+
+/// Pool of VMs instantiating the same module. Every VM has its own store,
+/// executor, and host modules, and is leased to one user at a time. The
+/// returned VMs are reset by the strategy before being leased again.
+class VMPool {
+public:
+  /// Reset strategy of the returned VMs.
+  enum class ResetStrategy : uint8_t {
+    /// Instantiate the module again. The start function is executed again.
+    Reinstantiate,
+    /// Restore the module instance from the snapshot taken right after the
+    /// instantiation. The memories are mapped copy-on-write, so the reset
+    /// cost depends on the pages written instead of the memory size. The
+    /// module instances owning host functions cannot be restored.
+    Snapshot,
+    /// Keep the state left by the previous leases.
+    Reuse,
+  };
+
+  /// Metrics of the pool.
+  struct Metrics {
+    /// Count of the leases, of the leases getting a free VM at once, and of
+    /// the leases which had to wait for a VM.
+    uint64_t Leases = 0;
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    /// Count of the failed resets. The VM is reset again before the next
+    /// lease.
+    uint64_t ResetFailures = 0;
+    /// Count of the leased VMs now.
+    uint32_t InUse = 0;
+    /// Total and maximum waiting time of the leases.
+    std::chrono::nanoseconds WaitTime{0};
+    std::chrono::nanoseconds MaxWaitTime{0};
+    /// Total time of the resets.
+    std::chrono::nanoseconds ResetTime{0};
+  };
+
+  /// Leased VM, which is returned to the pool when destroyed.
+  class Lease {
+  public:
+    Lease() noexcept = default;
+    Lease(Lease &&RHS) noexcept
+        : Pool(std::exchange(RHS.Pool, nullptr)), Index(RHS.Index) {}
+    Lease &operator=(Lease &&RHS) noexcept {
+      if (this != &RHS) {
+        release();
+        Pool = std::exchange(RHS.Pool, nullptr);
+        Index = RHS.Index;
+      }
+      return *this;
+    }
+    ~Lease() noexcept { release(); }
+
+    explicit operator bool() const noexcept { return Pool != nullptr; }
+    VM &operator*() const noexcept { return Pool->getVM(Index); }
+    VM *operator->() const noexcept { return &Pool->getVM(Index); }
+    /// Index of the leased VM in the pool.
+    uint32_t getIndex() const noexcept { return Index; }
+
+    /// Return the VM to the pool.
+    void release() noexcept {
+      if (Pool) {
+        std::exchange(Pool, nullptr)->giveBack(Index);
+      }
+    }
+
+  private:
+    friend class VMPool;
+    Lease(VMPool &P, uint32_t I) noexcept : Pool(&P), Index(I) {}
+
+    VMPool *Pool = nullptr;
+    uint32_t Index = 0;
+  };
+
+  /// Create the VMs with the configuration. The VMs can be set up, such as
+  /// registering the imports, through `getVM` before the instantiation. If
+  /// SpreadNumaNodes is set on a NUMA host, the VMs are placed on the nodes in
+  /// turn, which overrides the NUMA node of the configuration.
+  VMPool(const Configure &Conf, uint32_t Size,
+         ResetStrategy Strategy = ResetStrategy::Snapshot,
+         bool SpreadNumaNodes = false);
+  VMPool(const VMPool &) = delete;
+  VMPool &operator=(const VMPool &) = delete;
+
+  /// Load, validate, and instantiate the module in all VMs, and start leasing
+  /// them. Can only be called once, before leasing.
+  Expect<void> instantiate(const AST::Module &Mod);
+
+  /// Lease a VM, and wait until any VM is returned if all of them are leased.
+  Expect<Lease> lease();
+
+  /// Lease a VM without waiting. Returns nullopt if all of them are leased.
+  Expect<std::optional<Lease>> tryLease();
+
+  /// Lease a VM, execute the function on the calling thread, and return the
+  /// VM.
+  Expect<std::vector<std::pair<ValVariant, ValType>>>
+  execute(std::string_view Func, Span<const ValVariant> Params = {},
+          Span<const ValType> ParamTypes = {});
+
+  /// Execute the function on a leased VM by the thread pool. The workers and
+  /// the instances are reused by the later executions, instead of starting a
+  /// thread and instantiating the module for every short-lived task. The
+  /// cancellation stops all leased VMs.
+  Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+  asyncExecute(std::string_view Func, Span<const ValVariant> Params = {},
+               Span<const ValType> ParamTypes = {});
+
+  /// Stop the executions on the leased VMs.
+  void stop() noexcept;
+
+  /// Getter of the VM by index, for setting up before the instantiation.
+  VM &getVM(uint32_t Index) noexcept { return *VMs[Index]; }
+
+  uint32_t getSize() const noexcept {
+    return static_cast<uint32_t>(VMs.size());
+  }
+  ResetStrategy getResetStrategy() const noexcept { return Strategy; }
+
+  /// Getter of the metrics.
+  Metrics getMetrics() const noexcept;
+
+private:
+  /// Take a free VM and reset it if needed. Should be called with the lock
+  /// held, which is released during the reset.
+  Expect<Lease> unsafeTake(std::unique_lock<std::mutex> &Lock);
+  /// Reset and return the VM.
+  void giveBack(uint32_t Index) noexcept;
+  /// Reset the VM by the strategy.
+  Expect<void> reset(uint32_t Index);
+
+  const ResetStrategy Strategy;
+  std::vector<std::unique_ptr<VM>> VMs;
+
+  mutable std::mutex Mutex;
+  std::condition_variable Cond;
+  bool Instantiated = false;
+  /// Indices of the free VMs, and flags of the VMs failed to be reset and of
+  /// the leased VMs.
+  std::vector<uint32_t> Free;
+  std::vector<bool> NeedReset;
+  std::vector<bool> Leased;
+  Metrics Stat;
+};
+
+} // namespace VM
+} // namespace WasmEdge
@@ -6,10 +6,148 @@
 #include "common/config.h"
 #include "common/defines.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Internal functions of the bundled BLAKE3 from blake3_impl.h, which dispatch
+// to the SIMD implementations.
+extern "C" {
+void blake3_compress_in_place(uint32_t cv[8], const uint8_t block[64],
+                              uint8_t block_len, uint64_t counter,
+                              uint8_t flags);
+void blake3_compress_xof(const uint32_t cv[8], const uint8_t block[64],
+                         uint8_t block_len, uint64_t counter, uint8_t flags,
+                         uint8_t out[64]);
+void blake3_hash_many(const uint8_t *const *inputs, size_t num_inputs,
+                      size_t blocks, const uint32_t key[8], uint64_t counter,
+                      bool increment_counter, uint8_t flags,
+                      uint8_t flags_start, uint8_t flags_end, uint8_t *out);
+}
+
 namespace WasmEdge {
 namespace AOT {
 
-namespace {}
+namespace {
+/// Data size from which the chunks are hashed on the worker threads.
+static inline constexpr const size_t kParallelSize = size_t(4) << 20;
+/// Chunks hashed by a worker thread at least.
+static inline constexpr const size_t kChunksPerThread = 1024;
+/// Chunks passed to a blake3_hash_many call.
+static inline constexpr const size_t kChunksPerBatch = 64;
+
+static inline constexpr const uint8_t kChunkStart = 1;
+static inline constexpr const uint8_t kChunkEnd = 2;
+static inline constexpr const uint8_t kParent = 4;
+static inline constexpr const uint8_t kRoot = 8;
+
+/// Chaining values of the full chunks in [Begin, End).
+void hashChunks(const Byte *Data, size_t Begin, size_t End,
+                const uint32_t *Key, Byte *Out) noexcept {
+  std::array<const uint8_t *, kChunksPerBatch> Inputs;
+  while (Begin < End) {
+    const size_t Count = std::min(End - Begin, kChunksPerBatch);
+    for (size_t I = 0; I < Count; ++I) {
+      Inputs[I] = Data + (Begin + I) * BLAKE3_CHUNK_LEN;
+    }
+    blake3_hash_many(Inputs.data(), Count,
+                     BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, Key, Begin, true, 0,
+                     kChunkStart, kChunkEnd, Out + Begin * BLAKE3_OUT_LEN);
+    Begin += Count;
+  }
+}
+
+/// Chaining value of the last chunk, which may be partial.
+void hashLastChunk(Span<const Byte> Chunk, uint64_t Counter,
+                   const uint32_t *Key, Byte *Out) noexcept {
+  std::array<uint32_t, 8> CV;
+  std::copy_n(Key, CV.size(), CV.begin());
+  uint8_t Flags = kChunkStart;
+  while (Chunk.size() > BLAKE3_BLOCK_LEN) {
+    blake3_compress_in_place(CV.data(), Chunk.data(), BLAKE3_BLOCK_LEN,
+                             Counter, Flags);
+    Chunk = Chunk.subspan(BLAKE3_BLOCK_LEN);
+    Flags = 0;
+  }
+  std::array<uint8_t, BLAKE3_BLOCK_LEN> Block = {};
+  std::copy(Chunk.begin(), Chunk.end(), Block.begin());
+  blake3_compress_in_place(CV.data(), Block.data(),
+                           static_cast<uint8_t>(Chunk.size()), Counter,
+                           Flags | kChunkEnd);
+  for (size_t I = 0; I < CV.size(); ++I) {
+    for (size_t J = 0; J < 4; ++J) {
+      Out[I * 4 + J] = static_cast<Byte>(CV[I] >> (J * 8));
+    }
+  }
+}
+
+/// Hash the data of more than one chunk by the tree of the chaining values.
+/// Merging the adjacent pairs level by level builds the same left-complete
+/// tree as the incremental hasher.
+void hashTree(Span<const Byte> Data, Span<Byte> Output) {
+  blake3_hasher Init;
+  blake3_hasher_init(&Init);
+  const uint32_t *Key = Init.key;
+
+  const size_t FullChunks = (Data.size() - 1) / BLAKE3_CHUNK_LEN;
+  size_t Count = FullChunks + 1;
+  std::vector<Byte> CVs(Count * BLAKE3_OUT_LEN);
+  std::vector<Byte> Parents((Count / 2 + 1) * BLAKE3_OUT_LEN);
+
+  const size_t ThreadCount = std::clamp<size_t>(
+      FullChunks / kChunksPerThread, 1,
+      std::max(std::thread::hardware_concurrency(), 1u));
+  const size_t Step = (FullChunks + ThreadCount - 1) / ThreadCount;
+  std::vector<std::thread> Workers;
+  Workers.reserve(ThreadCount - 1);
+  size_t Begin = Step;
+  try {
+    for (; Begin < FullChunks; Begin += Step) {
+      Workers.emplace_back(hashChunks, Data.data(), Begin,
+                           std::min(Begin + Step, FullChunks), Key,
+                           CVs.data());
+    }
+  } catch (std::system_error &) {
+    // Hash the chunks not taken by the threads here.
+    hashChunks(Data.data(), Begin, FullChunks, Key, CVs.data());
+  }
+  hashChunks(Data.data(), 0, std::min(Step, FullChunks), Key, CVs.data());
+  hashLastChunk(Data.subspan(FullChunks * BLAKE3_CHUNK_LEN), FullChunks, Key,
+                CVs.data() + FullChunks * BLAKE3_OUT_LEN);
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+
+  std::vector<const uint8_t *> Inputs(Count / 2);
+  while (Count > 2) {
+    const size_t Pairs = Count / 2;
+    for (size_t I = 0; I < Pairs; ++I) {
+      Inputs[I] = CVs.data() + I * 2 * BLAKE3_OUT_LEN;
+    }
+    blake3_hash_many(Inputs.data(), Pairs, 1, Key, 0, false, kParent, 0, 0,
+                     Parents.data());
+    if (Count % 2 != 0) {
+      std::copy_n(CVs.data() + (Count - 1) * BLAKE3_OUT_LEN, BLAKE3_OUT_LEN,
+                  Parents.data() + Pairs * BLAKE3_OUT_LEN);
+    }
+    std::swap(CVs, Parents);
+    Count = Pairs + Count % 2;
+  }
+
+  std::array<uint8_t, BLAKE3_BLOCK_LEN> Block;
+  for (uint64_t Counter = 0; !Output.empty(); ++Counter) {
+    blake3_compress_xof(Key, CVs.data(), BLAKE3_BLOCK_LEN, Counter,
+                        kParent | kRoot, Block.data());
+    const size_t Size = std::min(Output.size(), Block.size());
+    std::copy_n(Block.begin(), Size, Output.begin());
+    Output = Output.subspan(Size);
+  }
+}
+} // namespace
 
 Blake3::Blake3() noexcept { blake3_hasher_init(&Hasher); }
 
@@ -21,5 +159,18 @@ void Blake3::finalize(Span<Byte> Output) noexcept {
   blake3_hasher_finalize(&Hasher, Output.data(), Output.size());
 }
 
+void Blake3::hash(Span<const Byte> Data, Span<Byte> Output) noexcept {
+  if (Data.size() >= kParallelSize) {
+    try {
+      hashTree(Data, Output);
+      return;
+    } catch (std::bad_alloc &) {
+    }
+  }
+  Blake3 Hasher;
+  Hasher.update(Data);
+  Hasher.finalize(Output);
+}
+
 } // namespace AOT
 } // namespace WasmEdge
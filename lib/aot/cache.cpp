@@ -4,24 +4,86 @@
 #include "aot/cache.h"
 
 #include "aot/blake3.h"
+#include "aot/version.h"
 #include "common/config.h"
 #include "common/defines.h"
+#include "common/hash.h"
 #include "common/hexstr.h"
+#include "common/trace.h"
+#include "common/version.h"
 #include "system/path.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <vector>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace WasmEdge {
 namespace AOT {
 
 namespace {
+/// Default size limit of a cache directory.
+static inline constexpr const uint64_t kDefaultMaxSize = UINT64_C(2) << 30;
+/// Age of the temporary files treated as left by a crashed writer.
+static inline constexpr const std::chrono::hours kStaleTempAge{1};
+/// Time between the attempts to lock a busy entry.
+static inline constexpr const std::chrono::milliseconds kLockRetry{20};
+/// File descriptor of an owned lock without a lock file.
+static inline constexpr const int kNoLockFile = -2;
+/// Age of a file from which its hash is memoized. The younger files may be
+/// written again within the resolution of the modification time.
+static inline constexpr const std::chrono::seconds kMemoMinAge{2};
+
+std::atomic<uint64_t> MaxSize = kDefaultMaxSize;
+
+struct RemoteState {
+  std::mutex Mutex;
+  std::shared_ptr<Cache::RemoteBackend> Backend;
+  bool Upload = false;
+};
+
+RemoteState &getRemote() noexcept {
+  static RemoteState State;
+  return State;
+}
+
+struct LocalRootState {
+  std::mutex Mutex;
+  std::filesystem::path Root;
+};
+
+LocalRootState &getLocalRoot() noexcept {
+  static LocalRootState State;
+  return State;
+}
+
 std::filesystem::path getRoot(Cache::StorageScope Scope) {
   switch (Scope) {
   case Cache::StorageScope::Global:
     return std::filesystem::u8path(kCacheRoot);
   case Cache::StorageScope::Local: {
+    {
+      auto &State = getLocalRoot();
+      std::unique_lock Lock(State.Mutex);
+      if (!State.Root.empty()) {
+        return State.Root;
+      }
+    }
     if (const auto Home = Path::home(); !Home.empty()) {
       return Home / "cache"sv;
     }
@@ -31,33 +93,435 @@ std::filesystem::path getRoot(Cache::StorageScope Scope) {
     assumingUnreachable();
   }
 }
-} // namespace
 
-Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
-                                             Cache::StorageScope Scope,
-                                             std::string_view Key) {
+std::filesystem::path getDir(Cache::StorageScope Scope, std::string_view Key) {
   auto Root = getRoot(Scope);
   if (!Key.empty()) {
     Root /= std::filesystem::u8path(Key);
   }
+  return Root;
+}
 
-  Blake3 Hasher;
-  Hasher.update(Data);
-  std::array<Byte, 32> Hash;
-  Hasher.finalize(Hash);
+std::filesystem::path getEntry(std::filesystem::path Dir,
+                               Span<const Byte> Hash) {
   std::string HexStr;
   convertBytesToHexStr(Hash, HexStr);
+  return Dir / HexStr;
+}
+
+std::filesystem::path getEntry(std::filesystem::path Dir, Blake3 &Hasher) {
+  std::array<Byte, 32> Hash;
+  Hasher.finalize(Hash);
+  return getEntry(std::move(Dir), Hash);
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Identity of the file contents, which changes when the file is written.
+struct FileStamp {
+  uint64_t Device;
+  uint64_t Inode;
+  uint64_t Size;
+  uint64_t ModifyTime;
+};
+
+bool getStamp(const std::filesystem::path &File, FileStamp &Stamp) noexcept {
+  struct stat Stat;
+  if (::stat(File.c_str(), &Stat) != 0) {
+    return false;
+  }
+#if WASMEDGE_OS_MACOS
+  const auto &Time = Stat.st_mtimespec;
+#else
+  const auto &Time = Stat.st_mtim;
+#endif
+  Stamp.Device = static_cast<uint64_t>(Stat.st_dev);
+  Stamp.Inode = static_cast<uint64_t>(Stat.st_ino);
+  Stamp.Size = static_cast<uint64_t>(Stat.st_size);
+  Stamp.ModifyTime = static_cast<uint64_t>(Time.tv_sec) * UINT64_C(1000000000) +
+                     static_cast<uint64_t>(Time.tv_nsec);
+  return true;
+}
+#endif
+
+/// Hash of the data mapped from the file. The hash of an unchanged file is
+/// read from the memo of the last lookup instead of hashing the data again.
+std::array<Byte, 32> getDigest(Span<const Byte> Data,
+                               const std::filesystem::path &File) {
+  std::array<Byte, 32> Digest;
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  FileStamp Stamp;
+  std::array<Byte, sizeof(FileStamp) + 32> Record;
+  std::filesystem::path MemoPath;
+  if (!File.empty() && !getRoot(Cache::StorageScope::Local).empty() &&
+      getStamp(File, Stamp) && Stamp.Size == Data.size()) {
+    std::error_code Error;
+    const auto Name = std::filesystem::absolute(File, Error).u8string();
+    std::array<Byte, 32> NameHash;
+    Blake3::hash(Span<const Byte>(reinterpret_cast<const Byte *>(Name.data()),
+                                  Name.size()),
+                 NameHash);
+    MemoPath = getEntry(getDir(Cache::StorageScope::Local, "digests"sv),
+                        NameHash);
+    std::ifstream Memo(MemoPath, std::ios::binary);
+    if (Memo.read(reinterpret_cast<char *>(Record.data()), Record.size()) &&
+        std::memcmp(Record.data(), &Stamp, sizeof(Stamp)) == 0) {
+      std::copy(Record.begin() + sizeof(Stamp), Record.end(), Digest.begin());
+      return Digest;
+    }
+  }
+#endif
+  Blake3::hash(Data, Digest);
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  const auto Now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  if (!MemoPath.empty() &&
+      Stamp.ModifyTime + std::chrono::nanoseconds(kMemoMinAge).count() <
+          static_cast<uint64_t>(Now)) {
+    std::memcpy(Record.data(), &Stamp, sizeof(Stamp));
+    std::copy(Digest.begin(), Digest.end(), Record.begin() + sizeof(Stamp));
+    Cache::publish(MemoPath, Record);
+  }
+#endif
+  return Digest;
+}
+
+std::filesystem::path getLockPath(const std::filesystem::path &Path) {
+  auto LockPath = Path;
+  LockPath += ".lock"sv;
+  return LockPath;
+}
+
+struct Item {
+  std::filesystem::path Path;
+  uint64_t Size;
+  std::filesystem::file_time_type Time;
+};
+
+/// Collect the entries and the orphan lock files under the directory, and
+/// remove the temporary files of the crashed writers.
+void collect(const std::filesystem::path &Dir, std::vector<Item> &Entries,
+             std::vector<std::filesystem::path> &Orphans) {
+  const auto Now = std::filesystem::file_time_type::clock::now();
+  std::error_code Error;
+  std::filesystem::recursive_directory_iterator It(Dir, Error), End;
+  for (; !Error && It != End; It.increment(Error)) {
+    std::error_code ItemError;
+    if (!It->is_regular_file(ItemError)) {
+      continue;
+    }
+    const auto &Path = It->path();
+    const auto Time = It->last_write_time(ItemError);
+    if (ItemError) {
+      continue;
+    }
+    if (Path.extension() == ".tmp"sv) {
+      if (Now - Time > kStaleTempAge) {
+        std::filesystem::remove(Path, ItemError);
+      }
+    } else if (Path.extension() == ".lock"sv) {
+      auto EntryPath = Path;
+      EntryPath.replace_extension();
+      if (!std::filesystem::exists(EntryPath, ItemError)) {
+        Orphans.push_back(std::move(EntryPath));
+      }
+    } else if (const auto Size = It->file_size(ItemError); !ItemError) {
+      Entries.push_back({Path, Size, Time});
+    }
+  }
+}
+
+/// Remove the entry and its lock file if no compilation holds the lock.
+bool removeEntry(const std::filesystem::path &Path) noexcept {
+  auto Lock = Cache::Lock::acquire(Path, std::chrono::milliseconds(0));
+  if (!Lock.owns()) {
+    return false;
+  }
+  std::error_code Error;
+  std::filesystem::remove(Path, Error);
+  if (Error) {
+    return false;
+  }
+  std::filesystem::remove(getLockPath(Path), Error);
+  return true;
+}
+} // namespace
+
+Cache::Lock::~Lock() noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (Fd >= 0) {
+    ::close(Fd);
+  }
+#endif
+}
+
+Cache::Lock Cache::Lock::acquire(const std::filesystem::path &Path,
+                                 std::chrono::milliseconds Timeout) noexcept {
+  Lock Result;
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  std::error_code Error;
+  std::filesystem::create_directories(Path.parent_path(), Error);
+  const int Fd =
+      ::open(getLockPath(Path).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (unlikely(Fd < 0)) {
+    // Compile without the lock, e.g. in a read-only cache.
+    Result.Fd = kNoLockFile;
+    return Result;
+  }
+  const auto Deadline = std::chrono::steady_clock::now() + Timeout;
+  while (true) {
+    if (::flock(Fd, LOCK_EX | LOCK_NB) == 0) {
+      Result.Fd = Fd;
+      return Result;
+    }
+    if (errno != EWOULDBLOCK && errno != EINTR) {
+      ::close(Fd);
+      Result.Fd = kNoLockFile;
+      return Result;
+    }
+    if (std::chrono::steady_clock::now() >= Deadline) {
+      ::close(Fd);
+      return Result;
+    }
+    std::this_thread::sleep_for(kLockRetry);
+  }
+#else
+  static_cast<void>(Path);
+  static_cast<void>(Timeout);
+  Result.Fd = kNoLockFile;
+  return Result;
+#endif
+}
+
+Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
+                                             Cache::StorageScope Scope,
+                                             std::string_view Key) {
+  Trace::Scope TraceScope("aot"sv, "cache lookup"sv, Key);
+  std::array<Byte, 32> Hash;
+  Blake3::hash(Data, Hash);
+  return getEntry(getDir(Scope, Key), Hash);
+}
+
+Expect<std::filesystem::path> Cache::getPath(Span<const Byte> Data,
+                                             const Configure &Conf,
+                                             Cache::StorageScope Scope,
+                                             std::string_view Key) {
+  return getPath(Data, {}, Conf, Scope, Key);
+}
+
+Expect<std::filesystem::path>
+Cache::getPath(Span<const Byte> Data, const std::filesystem::path &File,
+               const Configure &Conf, Cache::StorageScope Scope,
+               std::string_view Key) {
+  Trace::Scope TraceScope("aot"sv, "cache lookup"sv, Key);
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const auto &StatConf = Conf.getStatisticsConfigure();
+  std::vector<Byte> Options = {
+      static_cast<Byte>(CompilerConf.getOptimizationLevel()),
+      static_cast<Byte>(CompilerConf.getOutputFormat()),
+      static_cast<Byte>(CompilerConf.isGenericBinary()),
+      static_cast<Byte>(CompilerConf.isInterruptible()),
+      static_cast<Byte>(CompilerConf.isCoarseGasCheck()),
+      CompilerConf.getTargetLevel(),
+      static_cast<Byte>(StatConf.isInstructionCounting()),
+      static_cast<Byte>(StatConf.isCostMeasuring()),
+      static_cast<Byte>(
+          Conf.getRuntimeConfigure().isEnableSuperInstructions()),
+  };
+  const uint32_t InlineBudget = CompilerConf.getInlineBudget();
+  for (uint32_t Shift = 0; Shift < 32; Shift += 8) {
+    Options.push_back(static_cast<Byte>(InlineBudget >> Shift));
+    Options.push_back(static_cast<Byte>(kBinaryVersion >> Shift));
+  }
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    Options.push_back(
+        static_cast<Byte>(Conf.hasProposal(static_cast<Proposal>(I))));
+  }
+  Options.insert(Options.end(), kVersionString.begin(), kVersionString.end());
+
+  // The options are hashed after the hash of the data, so the hash of a
+  // module file is reused under every configuration.
+  Blake3 Hasher;
+  Hasher.update(getDigest(Data, File));
+  Hasher.update(Options);
+  return getEntry(getDir(Scope, Key), Hasher);
+}
+
+Expect<void> Cache::publish(const std::filesystem::path &Path,
+                            Span<const Byte> Data) noexcept {
+  std::error_code Error;
+  std::filesystem::create_directories(Path.parent_path(), Error);
+  if (Error) {
+    spdlog::warn("cache directory creation failed:{}"sv,
+                 Path.parent_path().u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  auto TempPath = Path;
+  TempPath += fmt::format(".{:016x}.tmp"sv, Hash::RandEngine());
+  {
+    std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+    File.write(reinterpret_cast<const char *>(Data.data()),
+               static_cast<std::streamsize>(Data.size()));
+    if (!File.good()) {
+      File.close();
+      std::filesystem::remove(TempPath, Error);
+      spdlog::warn("cache entry write failed:{}"sv, TempPath.u8string());
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+  std::filesystem::rename(TempPath, Path, Error);
+  if (Error) {
+    std::filesystem::remove(TempPath, Error);
+    spdlog::warn("cache entry publish failed:{}"sv, Path.u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+void Cache::touch(const std::filesystem::path &Path) noexcept {
+  // The access times are often not updated by the reads, so the modified
+  // time is used instead.
+  std::error_code Error;
+  std::filesystem::last_write_time(
+      Path, std::filesystem::file_time_type::clock::now(), Error);
+}
+
+void Cache::evict(const std::filesystem::path &Dir) noexcept {
+  const uint64_t Limit = MaxSize.load(std::memory_order_relaxed);
+  if (Limit == 0) {
+    return;
+  }
+  try {
+    std::vector<Item> Entries;
+    std::vector<std::filesystem::path> Orphans;
+    collect(Dir, Entries, Orphans);
+    uint64_t Total = 0;
+    for (const auto &Entry : Entries) {
+      Total += Entry.Size;
+    }
+    if (Total <= Limit) {
+      return;
+    }
+    std::sort(Entries.begin(), Entries.end(),
+              [](const Item &LHS, const Item &RHS) {
+                return LHS.Time < RHS.Time;
+              });
+    for (const auto &Entry : Entries) {
+      if (Total <= Limit) {
+        break;
+      }
+      if (removeEntry(Entry.Path)) {
+        Total -= Entry.Size;
+      }
+    }
+  } catch (std::bad_alloc &) {
+  }
+}
+
+void Cache::setMaxSize(uint64_t Bytes) noexcept {
+  MaxSize.store(Bytes, std::memory_order_relaxed);
+}
+
+uint64_t Cache::getMaxSize() noexcept {
+  return MaxSize.load(std::memory_order_relaxed);
+}
+
+void Cache::setLocalRoot(std::filesystem::path Root) noexcept {
+  auto &State = getLocalRoot();
+  std::unique_lock Lock(State.Mutex);
+  State.Root = std::move(Root);
+}
 
-  return Root / HexStr;
+void Cache::setRemote(std::shared_ptr<RemoteBackend> Backend,
+                      bool Upload) noexcept {
+  auto &State = getRemote();
+  std::unique_lock Lock(State.Mutex);
+  State.Backend = std::move(Backend);
+  State.Upload = Upload;
+}
+
+std::string Cache::getRemoteName(const std::filesystem::path &Path,
+                                 std::string_view Target) {
+  return fmt::format("{}/{}/{}"sv, Target,
+                     Path.parent_path().filename().u8string(),
+                     Path.filename().u8string());
+}
+
+bool Cache::fetch(const std::filesystem::path &Path,
+                  std::string_view Target) noexcept {
+  std::shared_ptr<RemoteBackend> Backend;
+  {
+    auto &State = getRemote();
+    std::unique_lock Lock(State.Mutex);
+    Backend = State.Backend;
+  }
+  if (!Backend) {
+    return false;
+  }
+  try {
+    const auto Name = getRemoteName(Path, Target);
+    auto Data = Backend->get(Name);
+    if (!Data || !publish(Path, *Data)) {
+      return false;
+    }
+    spdlog::debug("remote cache hit {}"sv, Name);
+    return true;
+  } catch (std::bad_alloc &) {
+    return false;
+  }
+}
+
+void Cache::upload(const std::filesystem::path &Path, std::string_view Target,
+                   Span<const Byte> Data) noexcept {
+  std::shared_ptr<RemoteBackend> Backend;
+  {
+    auto &State = getRemote();
+    std::unique_lock Lock(State.Mutex);
+    if (!State.Upload) {
+      return;
+    }
+    Backend = State.Backend;
+  }
+  if (!Backend) {
+    return;
+  }
+  try {
+    Backend->put(getRemoteName(Path, Target), Data);
+  } catch (std::bad_alloc &) {
+  }
 }
 
 void Cache::clear(Cache::StorageScope Scope, std::string_view Key) {
-  auto Root = getRoot(Scope);
-  if (!Key.empty()) {
-    Root /= std::filesystem::u8path(Key);
+  const auto Root = getDir(Scope, Key);
+  std::vector<Item> Entries;
+  std::vector<std::filesystem::path> Orphans;
+  collect(Root, Entries, Orphans);
+  for (const auto &Entry : Entries) {
+    removeEntry(Entry.Path);
+  }
+  for (const auto &Orphan : Orphans) {
+    removeEntry(Orphan);
+  }
+
+  // Remove the directories left empty, the deepest first.
+  std::vector<std::filesystem::path> Dirs;
+  std::error_code Error;
+  std::filesystem::recursive_directory_iterator It(Root, Error), End;
+  for (; !Error && It != End; It.increment(Error)) {
+    std::error_code ItemError;
+    if (It->is_directory(ItemError)) {
+      Dirs.push_back(It->path());
+    }
+  }
+  std::sort(Dirs.begin(), Dirs.end(),
+            [](const std::filesystem::path &LHS,
+               const std::filesystem::path &RHS) {
+              return LHS.native().size() > RHS.native().size();
+            });
+  Dirs.push_back(Root);
+  for (const auto &Dir : Dirs) {
+    std::filesystem::remove(Dir, Error);
   }
-  std::error_code ErrCode;
-  std::filesystem::remove_all(Root, ErrCode);
 }
 
 } // namespace AOT
@@ -0,0 +1,314 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "aot/cache.h"
+
+#include "common/defines.h"
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <new>
+#include <string>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace AOT {
+
+namespace {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Timeout of connecting, sending, and receiving.
+static inline constexpr const std::chrono::seconds kTimeout{30};
+/// Size limit of a fetched entry.
+static inline constexpr const size_t kMaxEntrySize = size_t(1) << 30;
+
+bool iequals(std::string_view LHS, std::string_view RHS) noexcept {
+  return LHS.size() == RHS.size() &&
+         std::equal(LHS.begin(), LHS.end(), RHS.begin(), [](char L, char R) {
+           return std::tolower(static_cast<unsigned char>(L)) ==
+                  std::tolower(static_cast<unsigned char>(R));
+         });
+}
+
+/// Decode the chunked transfer coding of the body.
+bool decodeChunked(std::string_view Raw, std::vector<Byte> &Body) {
+  while (true) {
+    const auto LineEnd = Raw.find("\r\n"sv);
+    if (LineEnd == std::string_view::npos) {
+      return false;
+    }
+    size_t Size = 0;
+    const auto [Ptr, Err] =
+        std::from_chars(Raw.data(), Raw.data() + LineEnd, Size, 16);
+    if (Err != std::errc() || Ptr == Raw.data()) {
+      return false;
+    }
+    Raw.remove_prefix(LineEnd + 2);
+    if (Size == 0) {
+      return true;
+    }
+    if (Raw.size() < Size + 2 || Body.size() + Size > kMaxEntrySize) {
+      return false;
+    }
+    Body.insert(Body.end(), Raw.begin(), Raw.begin() + Size);
+    Raw.remove_prefix(Size + 2);
+  }
+}
+
+/// Remote store of the entries on an HTTP server, one request per
+/// connection.
+class HTTPBackend final : public Cache::RemoteBackend {
+public:
+  HTTPBackend(std::string HostPort, std::string Host, std::string Port,
+              std::string Prefix) noexcept
+      : HostPort(std::move(HostPort)), Host(std::move(Host)),
+        Port(std::move(Port)), Prefix(std::move(Prefix)) {}
+
+  std::optional<std::vector<Byte>>
+  get(std::string_view Name) noexcept override {
+    auto Res = request("GET"sv, Name, {});
+    if (!Res || Res->Status != 200) {
+      return std::nullopt;
+    }
+    return std::move(Res->Body);
+  }
+
+  bool put(std::string_view Name, Span<const Byte> Data) noexcept override {
+    auto Res = request("PUT"sv, Name, Data);
+    if (!Res) {
+      return false;
+    }
+    if (Res->Status / 100 != 2) {
+      spdlog::warn("remote cache put {} failed with status {}"sv, Name,
+                   Res->Status);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  struct Response {
+    int Status = 0;
+    std::vector<Byte> Body;
+  };
+
+  int connect() const noexcept {
+    addrinfo Hints = {};
+    Hints.ai_family = AF_UNSPEC;
+    Hints.ai_socktype = SOCK_STREAM;
+    addrinfo *Infos = nullptr;
+    if (::getaddrinfo(Host.c_str(), Port.c_str(), &Hints, &Infos) != 0) {
+      spdlog::warn("remote cache host {} not resolved"sv, Host);
+      return -1;
+    }
+    timeval Timeout = {};
+    Timeout.tv_sec = static_cast<decltype(Timeout.tv_sec)>(kTimeout.count());
+    int Fd = -1;
+    for (auto *Info = Infos; Info; Info = Info->ai_next) {
+      Fd = ::socket(Info->ai_family, Info->ai_socktype, Info->ai_protocol);
+      if (Fd < 0) {
+        continue;
+      }
+      // The send timeout also bounds the connect on Linux.
+      ::setsockopt(Fd, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+      ::setsockopt(Fd, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout));
+#if WASMEDGE_OS_MACOS
+      const int NoSigPipe = 1;
+      ::setsockopt(Fd, SOL_SOCKET, SO_NOSIGPIPE, &NoSigPipe,
+                   sizeof(NoSigPipe));
+#endif
+      if (::connect(Fd, Info->ai_addr, Info->ai_addrlen) == 0) {
+        break;
+      }
+      ::close(Fd);
+      Fd = -1;
+    }
+    ::freeaddrinfo(Infos);
+    if (Fd < 0) {
+      spdlog::warn("remote cache host {} not connected"sv, HostPort);
+    }
+    return Fd;
+  }
+
+  static bool sendAll(int Fd, const void *Data, size_t Size) noexcept {
+#if WASMEDGE_OS_LINUX
+    const int Flags = MSG_NOSIGNAL;
+#else
+    const int Flags = 0;
+#endif
+    const auto *Ptr = static_cast<const char *>(Data);
+    while (Size > 0) {
+      const auto Sent = ::send(Fd, Ptr, Size, Flags);
+      if (Sent <= 0) {
+        return false;
+      }
+      Ptr += Sent;
+      Size -= static_cast<size_t>(Sent);
+    }
+    return true;
+  }
+
+  std::optional<Response> request(std::string_view Method,
+                                  std::string_view Name,
+                                  Span<const Byte> Body) noexcept {
+    try {
+      const int Fd = connect();
+      if (Fd < 0) {
+        return std::nullopt;
+      }
+      const auto Header = fmt::format(
+          "{} {}/{} HTTP/1.1\r\nHost: {}\r\nContent-Length: {}\r\n"
+          "Content-Type: application/octet-stream\r\nConnection: close\r\n"
+          "\r\n"sv,
+          Method, Prefix, Name, HostPort, Body.size());
+      std::string Raw;
+      bool Ok = sendAll(Fd, Header.data(), Header.size()) &&
+                sendAll(Fd, Body.data(), Body.size());
+      if (Ok) {
+        std::array<char, 65536> Buffer;
+        while (true) {
+          const auto Received = ::recv(Fd, Buffer.data(), Buffer.size(), 0);
+          if (Received == 0) {
+            break;
+          }
+          if (Received < 0 || Raw.size() > kMaxEntrySize) {
+            Ok = false;
+            break;
+          }
+          Raw.append(Buffer.data(), static_cast<size_t>(Received));
+        }
+      }
+      ::close(Fd);
+      if (!Ok) {
+        spdlog::warn("remote cache {} {} failed"sv, Method, Name);
+        return std::nullopt;
+      }
+      return parse(Raw);
+    } catch (std::bad_alloc &) {
+      return std::nullopt;
+    }
+  }
+
+  static std::optional<Response> parse(std::string_view Raw) {
+    const auto HeaderEnd = Raw.find("\r\n\r\n"sv);
+    if (Raw.substr(0, 5) != "HTTP/"sv || HeaderEnd == std::string_view::npos) {
+      return std::nullopt;
+    }
+    auto Head = Raw.substr(0, HeaderEnd + 2);
+    const auto Content = Raw.substr(HeaderEnd + 4);
+    Response Res;
+    const auto StatusPos = Head.find(' ');
+    if (StatusPos == std::string_view::npos ||
+        std::from_chars(Head.data() + StatusPos + 1,
+                        Head.data() + Head.size(), Res.Status)
+                .ec != std::errc()) {
+      return std::nullopt;
+    }
+
+    std::optional<size_t> Length;
+    bool Chunked = false;
+    Head.remove_prefix(Head.find("\r\n"sv) + 2);
+    while (!Head.empty()) {
+      const auto Line = Head.substr(0, Head.find("\r\n"sv));
+      Head.remove_prefix(Line.size() + 2);
+      const auto Colon = Line.find(':');
+      if (Colon == std::string_view::npos) {
+        continue;
+      }
+      const auto Key = Line.substr(0, Colon);
+      auto Value = Line.substr(Colon + 1);
+      Value.remove_prefix(std::min(Value.find_first_not_of(' '), Value.size()));
+      if (iequals(Key, "content-length"sv)) {
+        size_t Size = 0;
+        if (std::from_chars(Value.data(), Value.data() + Value.size(), Size)
+                .ec == std::errc()) {
+          Length = Size;
+        }
+      } else if (iequals(Key, "transfer-encoding"sv) &&
+                 iequals(Value, "chunked"sv)) {
+        Chunked = true;
+      }
+    }
+
+    if (Chunked) {
+      if (!decodeChunked(Content, Res.Body)) {
+        return std::nullopt;
+      }
+    } else if (Length) {
+      // The truncated entries are dropped.
+      if (Content.size() < *Length) {
+        return std::nullopt;
+      }
+      Res.Body.assign(Content.begin(), Content.begin() + *Length);
+    } else {
+      Res.Body.assign(Content.begin(), Content.end());
+    }
+    return Res;
+  }
+
+  std::string HostPort;
+  std::string Host;
+  std::string Port;
+  std::string Prefix;
+};
+#endif
+} // namespace
+
+std::shared_ptr<Cache::RemoteBackend>
+Cache::createHTTPBackend(std::string_view URL) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (URL.substr(0, 7) != "http://"sv) {
+    spdlog::error("remote cache URL {} is not an http:// URL"sv, URL);
+    return {};
+  }
+  URL.remove_prefix(7);
+  const auto Slash = std::min(URL.find('/'), URL.size());
+  const auto HostPort = URL.substr(0, Slash);
+  auto Prefix = URL.substr(Slash);
+  while (!Prefix.empty() && Prefix.back() == '/') {
+    Prefix.remove_suffix(1);
+  }
+
+  // The IPv6 addresses are in brackets.
+  std::string_view Host = HostPort;
+  std::string_view Port = "80"sv;
+  const auto PortPos = HostPort.rfind(':');
+  if (PortPos != std::string_view::npos &&
+      HostPort.find(']', PortPos) == std::string_view::npos) {
+    Host = HostPort.substr(0, PortPos);
+    Port = HostPort.substr(PortPos + 1);
+  }
+  if (Host.size() >= 2 && Host.front() == '[' && Host.back() == ']') {
+    Host = Host.substr(1, Host.size() - 2);
+  }
+  if (Host.empty() || Port.empty()) {
+    spdlog::error("remote cache URL {} has no host"sv, URL);
+    return {};
+  }
+  try {
+    return std::make_shared<HTTPBackend>(std::string(HostPort),
+                                         std::string(Host), std::string(Port),
+                                         std::string(Prefix));
+  } catch (std::bad_alloc &) {
+    return {};
+  }
+#else
+  spdlog::error("remote cache is not supported on this platform"sv);
+  static_cast<void>(URL);
+  return {};
+#endif
+}
+
+} // namespace AOT
+} // namespace WasmEdge
@@ -4,13 +4,17 @@
 #include "wasmedge/wasmedge.h"
 
 #include "common/defines.h"
+#include "common/metrics.h"
+#include "common/reclaimer.h"
 #include "driver/compiler.h"
 #include "driver/tool.h"
 #include "driver/unitool.h"
 #include "host/wasi/wasimodule.h"
 #include "plugin/plugin.h"
+#include "system/fiber.h"
 #include "system/winapi.h"
 #include "vm/vm.h"
+#include "vm/vmpool.h"
 #include "llvm/codegen.h"
 #include "llvm/compiler.h"
 
@@ -24,6 +28,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -123,12 +128,65 @@ struct WasmEdge_Async {
       Async;
 };
 
+// WasmEdge_Resumable implementation.
+struct WasmEdge_Resumable {
+  WasmEdge::Executor::Executor *Exec = nullptr;
+  const WasmEdge::Runtime::Instance::FunctionInstance *Func = nullptr;
+  std::vector<WasmEdge::ValVariant> Params;
+  std::vector<WasmEdge::ValType> ParamTypes;
+  std::unique_ptr<WasmEdge::Fiber> Fib;
+  WasmEdge::Expect<
+      std::vector<std::pair<WasmEdge::ValVariant, WasmEdge::ValType>>>
+      Result;
+  bool Started = false;
+  /// Refuse the suspensions to finish the execution before the deletion.
+  bool Cancelled = false;
+};
+
 // WasmEdge_VMContext implementation.
 struct WasmEdge_VMContext {
   template <typename... Args>
   WasmEdge_VMContext(Args &&...Vals) noexcept
-      : VM(std::forward<Args>(Vals)...) {}
-  WasmEdge::VM::VM VM;
+      : Owned(std::make_unique<WasmEdge::VM::VM>(std::forward<Args>(Vals)...)),
+        VM(*Owned) {}
+  /// Borrow the VM owned by the VM pool.
+  struct BorrowTag {};
+  WasmEdge_VMContext(BorrowTag, WasmEdge::VM::VM &V) noexcept : VM(V) {}
+  std::unique_ptr<WasmEdge::VM::VM> Owned;
+  WasmEdge::VM::VM &VM;
+};
+
+// WasmEdge_VMPoolContext implementation.
+struct WasmEdge_VMPoolContext {
+  WasmEdge_VMPoolContext(const WasmEdge::Configure &Conf, uint32_t Size,
+                         WasmEdge::VM::VMPool::ResetStrategy Strategy)
+      : Pool(Conf, Size, Strategy), Leases(Size) {
+    VMCxts.reserve(Size);
+    for (uint32_t I = 0; I < Size; ++I) {
+      VMCxts.push_back(std::make_unique<WasmEdge_VMContext>(
+          WasmEdge_VMContext::BorrowTag{}, Pool.getVM(I)));
+    }
+  }
+  WasmEdge::VM::VMPool Pool;
+  std::vector<std::unique_ptr<WasmEdge_VMContext>> VMCxts;
+  /// Leases by the index of the VMs. Every element is only accessed by the
+  /// holder of the lease.
+  std::vector<WasmEdge::VM::VMPool::Lease> Leases;
+};
+
+// WasmEdge_PreparedCallContext implementation.
+struct WasmEdge_PreparedCallContext {
+  WasmEdge_PreparedCallContext(
+      WasmEdge::Executor::Executor &E,
+      const WasmEdge::Runtime::Instance::FunctionInstance &F) noexcept
+      : Executor(E), Func(F),
+        Params(F.getFuncType().getParamTypes().size()),
+        Returns(F.getFuncType().getReturnTypes().size()) {}
+  WasmEdge::Executor::Executor &Executor;
+  const WasmEdge::Runtime::Instance::FunctionInstance &Func;
+  /// Buffers of the values reused by the invocations.
+  std::vector<WasmEdge::ValVariant> Params;
+  std::vector<WasmEdge::ValVariant> Returns;
 };
 
 // WasmEdge_PluginContext implementation.
@@ -357,6 +415,8 @@ CONVTO(Tag, Runtime::Instance::TagInstance, TagInstance, )
 CONVTO(Glob, Runtime::Instance::GlobalInstance, GlobalInstance, )
 CONVTO(CallFrame, Runtime::CallingFrame, CallingFrame, const)
 CONVTO(Plugin, Plugin::Plugin, Plugin, const)
+CONVTO(Snapshot, Runtime::Instance::ModuleSnapshot, ModuleSnapshot, )
+CONVTO(Prelink, Runtime::Instance::ModulePrelink, ModulePrelink, )
 #undef CONVTO
 
 #define CONVFROM(SIMP, INST, NAME, QUANT)                                      \
@@ -397,6 +457,10 @@ CONVFROM(Glob, Runtime::Instance::GlobalInstance, GlobalInstance, )
 CONVFROM(Glob, Runtime::Instance::GlobalInstance, GlobalInstance, const)
 CONVFROM(CallFrame, Runtime::CallingFrame, CallingFrame, const)
 CONVFROM(Plugin, Plugin::Plugin, Plugin, const)
+CONVFROM(Snapshot, Runtime::Instance::ModuleSnapshot, ModuleSnapshot, )
+CONVFROM(Snapshot, Runtime::Instance::ModuleSnapshot, ModuleSnapshot, const)
+CONVFROM(Prelink, Runtime::Instance::ModulePrelink, ModulePrelink, )
+CONVFROM(Prelink, Runtime::Instance::ModulePrelink, ModulePrelink, const)
 #undef CONVFROM
 
 // C API Host function class
@@ -421,24 +485,34 @@ public:
                    Span<const ValVariant> Args,
                    Span<ValVariant> Rets) override {
     auto &FuncType = DefType.getCompositeType().getFuncType();
-    std::vector<WasmEdge_Value> Params(FuncType.getParamTypes().size()),
-        Returns(FuncType.getReturnTypes().size());
+    const size_t ParamsN = FuncType.getParamTypes().size();
+    const size_t ReturnsN = FuncType.getReturnTypes().size();
+    // Keep the values of the common signatures on the stack to avoid the
+    // allocations on every call.
+    std::array<WasmEdge_Value, 16> InlineValues;
+    std::vector<WasmEdge_Value> HeapValues;
+    WasmEdge_Value *Values = InlineValues.data();
+    if (unlikely(ParamsN + ReturnsN > InlineValues.size())) {
+      HeapValues.resize(ParamsN + ReturnsN);
+      Values = HeapValues.data();
+    }
     for (uint32_t I = 0; I < Args.size(); I++) {
-      Params[I] = genWasmEdge_Value(Args[I], FuncType.getParamTypes()[I]);
+      Values[I] = genWasmEdge_Value(Args[I], FuncType.getParamTypes()[I]);
     }
-    WasmEdge_Value *PPtr = Params.size() ? (&Params[0]) : nullptr;
-    WasmEdge_Value *RPtr = Returns.size() ? (&Returns[0]) : nullptr;
+    std::fill_n(Values + ParamsN, ReturnsN, WasmEdge_Value{});
+    WasmEdge_Value *PPtr = ParamsN ? Values : nullptr;
+    WasmEdge_Value *RPtr = ReturnsN ? Values + ParamsN : nullptr;
     auto *CallFrameCxt = toCallFrameCxt(&CallFrame);
     WasmEdge_Result Stat;
     if (Func) {
       Stat = Func(Data, CallFrameCxt, PPtr, RPtr);
     } else {
       Stat = Wrap(Binding, Data, CallFrameCxt, PPtr,
-                  static_cast<uint32_t>(Params.size()), RPtr,
-                  static_cast<uint32_t>(Returns.size()));
+                  static_cast<uint32_t>(ParamsN), RPtr,
+                  static_cast<uint32_t>(ReturnsN));
     }
     for (uint32_t I = 0; I < Rets.size(); I++) {
-      Rets[I] = to_WasmEdge_128_t<WasmEdge::uint128_t>(Returns[I].Value);
+      Rets[I] = to_WasmEdge_128_t<WasmEdge::uint128_t>(RPtr[I].Value);
     }
     if (WasmEdge_ResultOK(Stat)) {
       if (WasmEdge_ResultGetCode(Stat) == 0x01U) {
@@ -460,6 +534,23 @@ private:
   void *Data;
 };
 
+// Helper function for checking the parameter types once and creating the
+// prepared call.
+WasmEdge_PreparedCallContext *
+genPreparedCall(WasmEdge::Executor::Executor &Executor,
+                const WasmEdge::Runtime::Instance::FunctionInstance *Func,
+                const WasmEdge_ValType *ParamTypes,
+                const uint32_t ParamLen) noexcept {
+  std::vector<ValType> Types;
+  for (auto Type : genSpan(ParamTypes, ParamLen)) {
+    Types.push_back(genValType(Type));
+  }
+  if (!Executor.checkInvoke(Func, Types)) {
+    return nullptr;
+  }
+  return new WasmEdge_PreparedCallContext(Executor, *Func);
+}
+
 } // namespace
 
 #ifdef __cplusplus
@@ -933,6 +1024,47 @@ WasmEdge_ConfigureGetMaxMemoryPage(const WasmEdge_ConfigureContext *Cxt) {
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetMemoryBudget(WasmEdge_ConfigureContext *Cxt,
+                                  const uint64_t SoftLimit,
+                                  const uint64_t HardLimit) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMemoryBudget(SoftLimit, HardLimit);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ConfigureGetMemoryBudgetSoftLimit(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMemoryBudgetSoftLimit();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ConfigureGetMemoryBudgetHardLimit(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMemoryBudgetHardLimit();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetGCThreshold(WasmEdge_ConfigureContext *Cxt,
+                                 const uint64_t Bytes) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setGCThreshold(Bytes);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_ConfigureGetGCThreshold(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getGCThreshold();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ConfigureSetForceInterpreter(WasmEdge_ConfigureContext *Cxt,
                                       const bool IsForceInterpreter) {
@@ -957,6 +1089,310 @@ WasmEdge_ConfigureIsAllowAFUNIX(const WasmEdge_ConfigureContext *Cxt) {
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableSuperInstructions(WasmEdge_ConfigureContext *Cxt,
+                                             const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableSuperInstructions(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureIsEnableSuperInstructions(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableSuperInstructions();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetValueStackSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t Size) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setValueStackSize(Size);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetValueStackSize(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getValueStackSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableZeroCopyLoad(WasmEdge_ConfigureContext *Cxt,
+                                        const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableZeroCopyLoad(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableZeroCopyLoad(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableZeroCopyLoad();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableLazyFunctionBody(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableLazyFunctionBody(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureIsEnableLazyFunctionBody(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableLazyFunctionBody();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableTrustedAOT(WasmEdge_ConfigureContext *Cxt,
+                                      const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableTrustedAOT(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableTrustedAOT(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableTrustedAOT();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetValidationThreadCount(WasmEdge_ConfigureContext *Cxt,
+                                           const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setValidationThreadCount(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureGetValidationThreadCount(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getValidationThreadCount();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetLoadingThreadCount(WasmEdge_ConfigureContext *Cxt,
+                                        const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setLoadingThreadCount(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureGetLoadingThreadCount(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getLoadingThreadCount();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetMemoryPoolSize(WasmEdge_ConfigureContext *Cxt,
+                                    const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setMemoryPoolSize(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetMemoryPoolSize(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getMemoryPoolSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableMemoryImage(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableMemoryImage(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableMemoryImage(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableMemoryImage();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetStripedMemoryPages(WasmEdge_ConfigureContext *Cxt,
+                                        const uint32_t Pages) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setStripedMemoryPages(Pages);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ConfigureGetStripedMemoryPages(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getStripedMemoryPages();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableHugePages(WasmEdge_ConfigureContext *Cxt,
+                                     const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableHugePages(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableHugePages(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableHugePages();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableBackgroundReclamation(WasmEdge_ConfigureContext *Cxt,
+                                                 const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableBackgroundReclamation(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureIsEnableBackgroundReclamation(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableBackgroundReclamation();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetNumaNode(WasmEdge_ConfigureContext *Cxt,
+                              const int32_t Node) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setNumaNode(Node);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT int32_t
+WasmEdge_ConfigureGetNumaNode(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getNumaNode();
+  }
+  return -1;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetNativeStackSize(WasmEdge_ConfigureContext *Cxt,
+                                     const uint64_t Size) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setNativeStackSize(Size);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t
+WasmEdge_ConfigureGetNativeStackSize(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().getNativeStackSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableHugePageCode(WasmEdge_ConfigureContext *Cxt,
+                                        const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableHugePageCode(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableHugePageCode(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableHugePageCode();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableLazyTable(WasmEdge_ConfigureContext *Cxt,
+                                     const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableLazyTable(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableLazyTable(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableLazyTable();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableGuardRegion(WasmEdge_ConfigureContext *Cxt,
+                                       const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableGuardRegion(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableGuardRegion(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableGuardRegion();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableIoUring(WasmEdge_ConfigureContext *Cxt,
+                                   const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableIoUring(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableIoUring(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableIoUring();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureSetEnableWasiPathCache(WasmEdge_ConfigureContext *Cxt,
+                                         const bool IsEnable) {
+  if (Cxt) {
+    Cxt->Conf.getRuntimeConfigure().setEnableWasiPathCache(IsEnable);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_ConfigureIsEnableWasiPathCache(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getRuntimeConfigure().isEnableWasiPathCache();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT bool
 WasmEdge_ConfigureIsForceInterpreter(const WasmEdge_ConfigureContext *Cxt) {
   if (Cxt) {
@@ -1051,6 +1487,86 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsInterruptible(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetPartitionCount(WasmEdge_ConfigureContext *Cxt,
+                                            const uint32_t Count) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setPartitionCount(Count);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureCompilerGetPartitionCount(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getPartitionCount();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetFunctionCache(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsFunctionCache) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setFunctionCache(IsFunctionCache);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsFunctionCache(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().isFunctionCache();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetCoarseGasCheck(WasmEdge_ConfigureContext *Cxt,
+                                            const bool IsCoarseGasCheck) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setCoarseGasCheck(IsCoarseGasCheck);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureCompilerIsCoarseGasCheck(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().isCoarseGasCheck();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetTargetLevel(WasmEdge_ConfigureContext *Cxt,
+                                         const uint8_t Level) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setTargetLevel(Level);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint8_t
+WasmEdge_ConfigureCompilerGetTargetLevel(const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getTargetLevel();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureCompilerSetInlineBudget(WasmEdge_ConfigureContext *Cxt,
+                                          const uint32_t Budget) {
+  if (Cxt) {
+    Cxt->Conf.getCompilerConfigure().setInlineBudget(Budget);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ConfigureCompilerGetInlineBudget(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getCompilerConfigure().getInlineBudget();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetInstructionCounting(
     WasmEdge_ConfigureContext *Cxt, const bool IsCount) {
   if (Cxt) {
@@ -1098,6 +1614,37 @@ WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureStatisticsIsTimeMeasuring(
   return false;
 }
 
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ConfigureStatisticsSetIOMeasuring(WasmEdge_ConfigureContext *Cxt,
+                                           const bool IsMeasure) {
+  if (Cxt) {
+    Cxt->Conf.getStatisticsConfigure().setIOMeasuring(IsMeasure);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureStatisticsIsIOMeasuring(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getStatisticsConfigure().isIOMeasuring();
+  }
+  return false;
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ConfigureStatisticsSetFunctionProfiling(
+    WasmEdge_ConfigureContext *Cxt, const bool IsProfile) {
+  if (Cxt) {
+    Cxt->Conf.getStatisticsConfigure().setFunctionProfiling(IsProfile);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ConfigureStatisticsIsFunctionProfiling(
+    const WasmEdge_ConfigureContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Conf.getStatisticsConfigure().isFunctionProfiling();
+  }
+  return false;
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ConfigureDelete(WasmEdge_ConfigureContext *Cxt) {
   delete Cxt;
@@ -1166,6 +1713,28 @@ WasmEdge_StatisticsDelete(WasmEdge_StatisticsContext *Cxt) {
 
 // <<<<<<<< WasmEdge statistics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge metrics functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_MetricsEnable(void) {
+  WasmEdge::Metrics::enable();
+}
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_MetricsIsEnabled(void) {
+  return WasmEdge::Metrics::isEnabled();
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_String WasmEdge_MetricsRender(void) {
+  const auto Text = WasmEdge::Metrics::render();
+  return WasmEdge_StringCreateByBuffer(Text.data(),
+                                       static_cast<uint32_t>(Text.size()));
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_MetricsClear(void) {
+  WasmEdge::Metrics::clear();
+}
+
+// <<<<<<<< WasmEdge metrics functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge AST module functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT uint32_t
@@ -1218,7 +1787,8 @@ WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ASTModuleListExports(
 
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ASTModuleDelete(WasmEdge_ASTModuleContext *Cxt) {
-  std::unique_ptr<WasmEdge::AST::Module> Own(fromASTModCxt(Cxt));
+  WasmEdge::Reclaimer::release(
+      std::unique_ptr<WasmEdge::AST::Module>(fromASTModCxt(Cxt)));
 }
 
 // <<<<<<<< WasmEdge AST module functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -1907,16 +2477,89 @@ WasmEdge_ExecutorCreate(const WasmEdge_ConfigureContext *ConfCxt,
   }
 }
 
-WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorInstantiate(
-    WasmEdge_ExecutorContext *Cxt, WasmEdge_ModuleInstanceContext **ModuleCxt,
-    WasmEdge_StoreContext *StoreCxt, const WasmEdge_ASTModuleContext *ASTCxt) {
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorInstantiate(
+    WasmEdge_ExecutorContext *Cxt, WasmEdge_ModuleInstanceContext **ModuleCxt,
+    WasmEdge_StoreContext *StoreCxt, const WasmEdge_ASTModuleContext *ASTCxt) {
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->instantiateModule(*fromStoreCxt(StoreCxt),
+                                                       *fromASTModCxt(ASTCxt));
+      },
+      [&](auto &&Res) { *ModuleCxt = toModCxt((*Res).release()); }, Cxt,
+      ModuleCxt, StoreCxt, ASTCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ExecutorPrelink(WasmEdge_ExecutorContext *Cxt,
+                         WasmEdge_ModulePrelinkContext **PrelinkCxt,
+                         const WasmEdge_StoreContext *StoreCxt,
+                         const WasmEdge_ASTModuleContext *ASTCxt) {
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->prelinkModule(*fromStoreCxt(StoreCxt),
+                                                   *fromASTModCxt(ASTCxt));
+      },
+      [&](auto &&Res) { *PrelinkCxt = toPrelinkCxt((*Res).release()); }, Cxt,
+      PrelinkCxt, StoreCxt, ASTCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorInstantiatePrelinked(
+    WasmEdge_ExecutorContext *Cxt, WasmEdge_ModuleInstanceContext **ModuleCxt,
+    WasmEdge_StoreContext *StoreCxt,
+    const WasmEdge_ModulePrelinkContext *PrelinkCxt) {
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->instantiateModule(
+            *fromStoreCxt(StoreCxt), *fromPrelinkCxt(PrelinkCxt));
+      },
+      [&](auto &&Res) { *ModuleCxt = toModCxt((*Res).release()); }, Cxt,
+      ModuleCxt, StoreCxt, PrelinkCxt);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ModulePrelinkDelete(WasmEdge_ModulePrelinkContext *Cxt) {
+  delete fromPrelinkCxt(Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ExecutorClone(WasmEdge_ExecutorContext *Cxt,
+                       WasmEdge_ModuleInstanceContext **ModuleCxt,
+                       const WasmEdge_ModuleInstanceContext *TemplateCxt) {
   return wrap(
       [&]() {
-        return fromExecutorCxt(Cxt)->instantiateModule(*fromStoreCxt(StoreCxt),
-                                                       *fromASTModCxt(ASTCxt));
+        return fromExecutorCxt(Cxt)->cloneModule(*fromModCxt(TemplateCxt));
       },
       [&](auto &&Res) { *ModuleCxt = toModCxt((*Res).release()); }, Cxt,
-      ModuleCxt, StoreCxt, ASTCxt);
+      ModuleCxt, TemplateCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ExecutorSnapshot(WasmEdge_ExecutorContext *Cxt,
+                          WasmEdge_ModuleSnapshotContext **SnapshotCxt,
+                          const WasmEdge_ModuleInstanceContext *ModuleCxt) {
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->snapshotModule(*fromModCxt(ModuleCxt));
+      },
+      [&](auto &&Res) { *SnapshotCxt = toSnapshotCxt((*Res).release()); },
+      Cxt, SnapshotCxt, ModuleCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ExecutorRestore(WasmEdge_ExecutorContext *Cxt,
+                         WasmEdge_ModuleInstanceContext *ModuleCxt,
+                         const WasmEdge_ModuleSnapshotContext *SnapshotCxt) {
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->restoreModule(
+            *fromModCxt(ModuleCxt), *fromSnapshotCxt(SnapshotCxt));
+      },
+      EmptyThen, Cxt, ModuleCxt, SnapshotCxt);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ModuleSnapshotDelete(WasmEdge_ModuleSnapshotContext *Cxt) {
+  delete fromSnapshotCxt(Cxt);
 }
 
 WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorRegister(
@@ -1961,6 +2604,25 @@ WasmEdge_ExecutorInvoke(WasmEdge_ExecutorContext *Cxt,
       FuncCxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_ExecutorInvokeBatch(
+    WasmEdge_ExecutorContext *Cxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_ValType *ParamTypes, const void *const *Params,
+    const uint32_t ParamLen, void *const *Returns, const uint32_t ReturnLen,
+    const uint32_t Rows, const uint32_t Threads) {
+  std::vector<ValType> Types;
+  for (auto Type : genSpan(ParamTypes, ParamLen)) {
+    Types.push_back(genValType(Type));
+  }
+  return wrap(
+      [&]() {
+        return fromExecutorCxt(Cxt)->invokeBatch(
+            fromFuncCxt(FuncCxt), Types, genSpan(Params, ParamLen),
+            genSpan(Returns, ReturnLen), Rows, Threads);
+      },
+      EmptyThen, Cxt, FuncCxt);
+}
+
 WASMEDGE_CAPI_EXPORT WasmEdge_Async *
 WasmEdge_ExecutorAsyncInvoke(WasmEdge_ExecutorContext *Cxt,
                              const WasmEdge_FunctionInstanceContext *FuncCxt,
@@ -1974,6 +2636,35 @@ WasmEdge_ExecutorAsyncInvoke(WasmEdge_ExecutorContext *Cxt,
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Resumable *WasmEdge_ExecutorResumableInvoke(
+    WasmEdge_ExecutorContext *Cxt,
+    const WasmEdge_FunctionInstanceContext *FuncCxt,
+    const WasmEdge_Value *Params, const uint32_t ParamLen) {
+  if (Cxt && FuncCxt) {
+    auto Res = std::make_unique<WasmEdge_Resumable>();
+    Res->Exec = fromExecutorCxt(Cxt);
+    Res->Func = fromFuncCxt(FuncCxt);
+    auto ParamPair = genParamPair(Params, ParamLen);
+    Res->Params = std::move(ParamPair.first);
+    Res->ParamTypes = std::move(ParamPair.second);
+    Res->Fib = Fiber::create([R = Res.get()]() {
+      R->Result = R->Exec->invoke(R->Func, R->Params, R->ParamTypes);
+    });
+    if (Res->Fib) {
+      return Res.release();
+    }
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ExecutorSetEpochDeadline(WasmEdge_ExecutorContext *Cxt,
+                                  const uint64_t Ticks) {
+  if (Cxt) {
+    fromExecutorCxt(Cxt)->setEpochDeadline(Ticks);
+  }
+}
+
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt) {
   delete fromExecutorCxt(Cxt);
@@ -1981,6 +2672,96 @@ WasmEdge_ExecutorDelete(WasmEdge_ExecutorContext *Cxt) {
 
 // <<<<<<<< WasmEdge executor functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge prepared call functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT WasmEdge_PreparedCallContext *
+WasmEdge_PreparedCallCreate(WasmEdge_ExecutorContext *ExecCxt,
+                            const WasmEdge_FunctionInstanceContext *FuncCxt,
+                            const WasmEdge_ValType *ParamTypes,
+                            const uint32_t ParamLen) {
+  if (ExecCxt && FuncCxt) {
+    return genPreparedCall(*fromExecutorCxt(ExecCxt), fromFuncCxt(FuncCxt),
+                           ParamTypes, ParamLen);
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_PreparedCallGetParamLength(const WasmEdge_PreparedCallContext *Cxt) {
+  if (Cxt) {
+    return static_cast<uint32_t>(Cxt->Params.size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_PreparedCallGetReturnLength(const WasmEdge_PreparedCallContext *Cxt) {
+  if (Cxt) {
+    return static_cast<uint32_t>(Cxt->Returns.size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_PreparedCallInvoke(WasmEdge_PreparedCallContext *Cxt,
+                            const uint128_t *Params, const uint32_t ParamLen,
+                            uint128_t *Returns, const uint32_t ReturnLen) {
+  return wrap(
+      [&]() -> WasmEdge::Expect<void> {
+        if (unlikely(ParamLen != Cxt->Params.size() ||
+                     (ParamLen > 0 && Params == nullptr))) {
+          spdlog::error(ErrCode::Value::FuncSigMismatch);
+          return Unexpect(ErrCode::Value::FuncSigMismatch);
+        }
+        for (uint32_t I = 0; I < ParamLen; ++I) {
+          Cxt->Params[I] = ValVariant::wrap<WasmEdge::uint128_t>(
+              to_WasmEdge_128_t<WasmEdge::uint128_t>(Params[I]));
+        }
+        return Cxt->Executor.invokeUnchecked(Cxt->Func, Cxt->Params,
+                                             Cxt->Returns);
+      },
+      [&](auto &&) {
+        if (Returns == nullptr) {
+          return;
+        }
+        const auto Len = std::min(
+            ReturnLen, static_cast<uint32_t>(Cxt->Returns.size()));
+        for (uint32_t I = 0; I < Len; ++I) {
+          Returns[I] = to_uint128_t(Cxt->Returns[I].unwrap());
+        }
+      },
+      Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_PreparedCallDelete(WasmEdge_PreparedCallContext *Cxt) {
+  delete Cxt;
+}
+
+// <<<<<<<< WasmEdge prepared call functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
+// >>>>>>>> WasmEdge epoch functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_EpochGet(void) {
+  return WasmEdge::Epoch::get();
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_EpochIncrement(void) {
+  WasmEdge::Epoch::increment();
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_EpochStartTimer(const uint64_t IntervalMilliseconds) {
+  WasmEdge::Epoch::startTimer(
+      std::chrono::milliseconds(std::max(IntervalMilliseconds, UINT64_C(1))));
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_EpochStopTimer(void) {
+  WasmEdge::Epoch::stopTimer();
+}
+
+// <<<<<<<< WasmEdge epoch functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge store functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT WasmEdge_StoreContext *WasmEdge_StoreCreate(void) {
@@ -2156,6 +2937,51 @@ WasmEdge_ModuleInstanceWASIGetNativeHandler(
   return 0;
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_WASIIOStatistics
+WasmEdge_ModuleInstanceWASIGetIOStatistics(
+    const WasmEdge_ModuleInstanceContext *Cxt) {
+  WasmEdge_WASIIOStatistics Res{0, 0, 0, 0};
+  if (!Cxt) {
+    return Res;
+  }
+  auto *WasiMod =
+      dynamic_cast<const WasmEdge::Host::WasiModule *>(fromModCxt(Cxt));
+  if (!WasiMod) {
+    return Res;
+  }
+  const auto &Stat = WasiMod->getIOStatistics();
+  Res.BytesRead = Stat.getBytesRead();
+  Res.BytesWritten = Stat.getBytesWritten();
+  Res.Calls = Stat.getCalls();
+  Res.PollWakeups = Stat.getPollWakeups();
+  return Res;
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ModuleInstanceWASIGetLatencyHistogram(
+    const WasmEdge_ModuleInstanceContext *Cxt, const WasmEdge_String FuncName,
+    uint64_t *Buckets, const uint32_t Len) {
+  if (!Cxt) {
+    return 0;
+  }
+  auto *WasiMod =
+      dynamic_cast<const WasmEdge::Host::WasiModule *>(fromModCxt(Cxt));
+  if (!WasiMod) {
+    return 0;
+  }
+  const auto *Histogram =
+      WasiMod->getIOStatistics().getFunction(genStrView(FuncName));
+  if (!Histogram) {
+    return 0;
+  }
+  using WasmEdge::Host::WASI::IOStatistics;
+  if (Buckets) {
+    for (uint32_t I = 0; I < std::min(Len, IOStatistics::kBuckets); ++I) {
+      Buckets[I] = Histogram->getBucket(I);
+    }
+  }
+  return IOStatistics::kBuckets;
+}
+
 WASMEDGE_CAPI_EXPORT uint32_t WasmEdge_ModuleInstanceWASIGetExitCode(
     const WasmEdge_ModuleInstanceContext *Cxt) {
   if (!Cxt) {
@@ -2205,6 +3031,31 @@ WasmEdge_ModuleInstanceGetHostData(const WasmEdge_ModuleInstanceContext *Cxt) {
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ModuleInstanceGetMemoryUsage(
+    const WasmEdge_ModuleInstanceContext *Cxt) {
+  if (Cxt) {
+    return fromModCxt(Cxt)->getMemoryBudget().getUsage();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_ModuleInstanceGetMemoryPeakUsage(
+    const WasmEdge_ModuleInstanceContext *Cxt) {
+  if (Cxt) {
+    return fromModCxt(Cxt)->getMemoryBudget().getPeak();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_ModuleInstanceSetMemoryBudget(WasmEdge_ModuleInstanceContext *Cxt,
+                                       const uint64_t SoftLimit,
+                                       const uint64_t HardLimit) {
+  if (Cxt) {
+    fromModCxt(Cxt)->getMemoryBudget().setLimits(SoftLimit, HardLimit);
+  }
+}
+
 WASMEDGE_CAPI_EXPORT WasmEdge_FunctionInstanceContext *
 WasmEdge_ModuleInstanceFindFunction(const WasmEdge_ModuleInstanceContext *Cxt,
                                     const WasmEdge_String Name) {
@@ -2391,7 +3242,12 @@ WasmEdge_ModuleInstanceAddGlobal(WasmEdge_ModuleInstanceContext *Cxt,
 
 WASMEDGE_CAPI_EXPORT void
 WasmEdge_ModuleInstanceDelete(WasmEdge_ModuleInstanceContext *Cxt) {
-  delete fromModCxt(Cxt);
+  if (auto *ModInst = fromModCxt(Cxt)) {
+    // Unlink from the stores here, as the destructor may run in the background.
+    ModInst->unlinkStores();
+    WasmEdge::Reclaimer::release(
+        std::unique_ptr<WasmEdge::Runtime::Instance::ModuleInstance>(ModInst));
+  }
 }
 
 // <<<<<<<< WasmEdge module instance functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
@@ -2582,11 +3438,26 @@ WasmEdge_MemoryInstanceCreate(const WasmEdge_MemoryTypeContext *MemType) {
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_MemoryInstanceContext *
+WasmEdge_MemoryInstanceCreateFromFile(const WasmEdge_MemoryTypeContext *MemType,
+                                      const int FileDescriptor,
+                                      const bool Writable) {
+  if (MemType) {
+    auto MemInst =
+        std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+            *fromMemTypeCxt(MemType));
+    if (MemInst->mapFile(FileDescriptor, Writable)) {
+      return toMemCxt(MemInst.release());
+    }
+  }
+  return nullptr;
+}
+
 WASMEDGE_CAPI_EXPORT const WasmEdge_MemoryTypeContext *
 WasmEdge_MemoryInstanceGetMemoryType(
     const WasmEdge_MemoryInstanceContext *Cxt) {
   if (Cxt) {
-    return toMemTypeCxt(&fromMemCxt(Cxt)->getMemoryType());
+    return toMemTypeCxt(&fromMemCxt(Cxt)->getInitialMemoryType());
   }
   return nullptr;
 }
@@ -2635,6 +3506,14 @@ WASMEDGE_CAPI_EXPORT const uint8_t *WasmEdge_MemoryInstanceGetPointerConst(
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT uint64_t WasmEdge_MemoryInstanceGetGeneration(
+    const WasmEdge_MemoryInstanceContext *Cxt) {
+  if (Cxt) {
+    return fromMemCxt(Cxt)->getGeneration();
+  }
+  return 0;
+}
+
 WASMEDGE_CAPI_EXPORT uint32_t
 WasmEdge_MemoryInstanceGetPageSize(const WasmEdge_MemoryInstanceContext *Cxt) {
   if (Cxt) {
@@ -2822,6 +3701,23 @@ WasmEdge_CallingFrameGetMemoryInstance(const WasmEdge_CallingFrameContext *Cxt,
   return nullptr;
 }
 
+namespace {
+/// The resumable execution running on the calling thread.
+thread_local WasmEdge_Resumable *CurrentResumable = nullptr;
+} // namespace
+
+WASMEDGE_CAPI_EXPORT bool
+WasmEdge_CallingFrameSuspend(const WasmEdge_CallingFrameContext *Cxt) {
+  // Only suspend the fiber of the execution, but not the nested ones, such as
+  // the fibers of the continuations.
+  auto *Self = CurrentResumable;
+  if (!Cxt || !Self || Self->Cancelled || Fiber::current() != Self->Fib.get()) {
+    return false;
+  }
+  Fiber::suspend();
+  return !Self->Cancelled;
+}
+
 // <<<<<<<< WasmEdge calling frame functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
 // >>>>>>>> WasmEdge Async functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -2864,12 +3760,80 @@ WasmEdge_AsyncGet(const WasmEdge_Async *Cxt, WasmEdge_Value *Returns,
       [&](auto Res) { fillWasmEdge_ValueArr(*Res, Returns, ReturnLen); }, Cxt);
 }
 
+WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncSetCallback(WasmEdge_Async *Cxt,
+                                                    void (*Callback)(void *),
+                                                    void *Data) {
+  if (Cxt && Callback) {
+    Cxt->Async.setCallback([Callback, Data](const auto &) { Callback(Data); });
+  }
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_AsyncSetMaxThreads(const uint32_t MaxThreads) {
+  WasmEdge::ThreadPool::getDefault().setMaxThreads(MaxThreads);
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncSetAffinity(const uint32_t *CPUs,
+                                                    const uint32_t Len) {
+  std::vector<uint32_t> List;
+  if (CPUs) {
+    List.assign(CPUs, CPUs + Len);
+  }
+  WasmEdge::ThreadPool::getDefault().setAffinity(std::move(List));
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_AsyncDelete(WasmEdge_Async *Cxt) {
   delete Cxt;
 }
 
 // <<<<<<<< WasmEdge Async functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge Resumable functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT bool WasmEdge_ResumableResume(WasmEdge_Resumable *Cxt) {
+  if (!Cxt) {
+    return true;
+  }
+  if (!Cxt->Fib->done()) {
+    Cxt->Started = true;
+    auto *Saved = std::exchange(CurrentResumable, Cxt);
+    Cxt->Fib->resume();
+    CurrentResumable = Saved;
+  }
+  return Cxt->Fib->done();
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_ResumableGetReturnsLength(const WasmEdge_Resumable *Cxt) {
+  if (Cxt && Cxt->Fib->done() && Cxt->Result) {
+    return static_cast<uint32_t>((*Cxt->Result).size());
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_ResumableGet(const WasmEdge_Resumable *Cxt, WasmEdge_Value *Returns,
+                      const uint32_t ReturnLen) {
+  if (Cxt && !Cxt->Fib->done()) {
+    return genWasmEdge_Result(ErrCode::Value::WrongVMWorkflow);
+  }
+  return wrap(
+      [&]() { return Cxt->Result; },
+      [&](auto Res) { fillWasmEdge_ValueArr(*Res, Returns, ReturnLen); }, Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_ResumableDelete(WasmEdge_Resumable *Cxt) {
+  if (Cxt && Cxt->Started) {
+    // Unwind the stack of the execution by finishing it.
+    Cxt->Cancelled = true;
+    while (!WasmEdge_ResumableResume(Cxt)) {
+    }
+  }
+  delete Cxt;
+}
+
+// <<<<<<<< WasmEdge Resumable functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge VM functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 WASMEDGE_CAPI_EXPORT WasmEdge_VMContext *
@@ -3088,6 +4052,41 @@ WasmEdge_VMExecute(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
       Cxt);
 }
 
+WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMExecuteBatch(
+    WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
+    const WasmEdge_ValType *ParamTypes, const void *const *Params,
+    const uint32_t ParamLen, void *const *Returns, const uint32_t ReturnLen,
+    const uint32_t Rows, const uint32_t Threads) {
+  std::vector<ValType> Types;
+  for (auto Type : genSpan(ParamTypes, ParamLen)) {
+    Types.push_back(genValType(Type));
+  }
+  return wrap(
+      [&]() {
+        return Cxt->VM.executeBatch(genStrView(FuncName), Types,
+                                    genSpan(Params, ParamLen),
+                                    genSpan(Returns, ReturnLen), Rows, Threads);
+      },
+      EmptyThen, Cxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_PreparedCallContext *
+WasmEdge_VMPrepareCall(WasmEdge_VMContext *Cxt, const WasmEdge_String FuncName,
+                       const WasmEdge_ValType *ParamTypes,
+                       const uint32_t ParamLen) {
+  if (!Cxt) {
+    return nullptr;
+  }
+  const auto *ModInst = Cxt->VM.getActiveModule();
+  if (ModInst == nullptr) {
+    spdlog::error(ErrCode::Value::WrongInstanceAddress);
+    return nullptr;
+  }
+  return genPreparedCall(Cxt->VM.getExecutor(),
+                         ModInst->findFuncExports(genStrView(FuncName)),
+                         ParamTypes, ParamLen);
+}
+
 WASMEDGE_CAPI_EXPORT WasmEdge_Result WasmEdge_VMExecuteRegistered(
     WasmEdge_VMContext *Cxt, const WasmEdge_String ModuleName,
     const WasmEdge_String FuncName, const WasmEdge_Value *Params,
@@ -3309,12 +4308,145 @@ WasmEdge_VMGetStatisticsContext(WasmEdge_VMContext *Cxt) {
   return nullptr;
 }
 
+WASMEDGE_CAPI_EXPORT void WasmEdge_VMSetEpochDeadline(WasmEdge_VMContext *Cxt,
+                                                      const uint64_t Ticks) {
+  if (Cxt) {
+    Cxt->VM.getExecutor().setEpochDeadline(Ticks);
+  }
+}
+
 WASMEDGE_CAPI_EXPORT void WasmEdge_VMDelete(WasmEdge_VMContext *Cxt) {
   delete Cxt;
 }
 
 // <<<<<<<< WasmEdge VM functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
 
+// >>>>>>>> WasmEdge VM pool functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+
+WASMEDGE_CAPI_EXPORT WasmEdge_VMPoolContext *
+WasmEdge_VMPoolCreate(const WasmEdge_ConfigureContext *ConfCxt,
+                      const uint32_t Size, const WasmEdge_VMPoolReset Reset) {
+  WasmEdge::VM::VMPool::ResetStrategy Strategy;
+  switch (Reset) {
+  case WasmEdge_VMPoolReset_Reinstantiate:
+    Strategy = WasmEdge::VM::VMPool::ResetStrategy::Reinstantiate;
+    break;
+  case WasmEdge_VMPoolReset_Snapshot:
+    Strategy = WasmEdge::VM::VMPool::ResetStrategy::Snapshot;
+    break;
+  case WasmEdge_VMPoolReset_Reuse:
+    Strategy = WasmEdge::VM::VMPool::ResetStrategy::Reuse;
+    break;
+  default:
+    return nullptr;
+  }
+  if (ConfCxt) {
+    return new WasmEdge_VMPoolContext(ConfCxt->Conf, Size, Strategy);
+  } else {
+    return new WasmEdge_VMPoolContext(WasmEdge::Configure(), Size, Strategy);
+  }
+}
+
+WASMEDGE_CAPI_EXPORT uint32_t
+WasmEdge_VMPoolGetSize(const WasmEdge_VMPoolContext *Cxt) {
+  if (Cxt) {
+    return Cxt->Pool.getSize();
+  }
+  return 0;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_VMContext *
+WasmEdge_VMPoolGetVMContext(WasmEdge_VMPoolContext *Cxt,
+                            const uint32_t Index) {
+  if (Cxt && Index < Cxt->VMCxts.size()) {
+    return Cxt->VMCxts[Index].get();
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_VMPoolInstantiate(WasmEdge_VMPoolContext *Cxt,
+                           const WasmEdge_ASTModuleContext *ASTCxt) {
+  return wrap([&]() { return Cxt->Pool.instantiate(*fromASTModCxt(ASTCxt)); },
+              EmptyThen, Cxt, ASTCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_VMPoolLease(WasmEdge_VMPoolContext *Cxt, WasmEdge_VMContext **VMCxt) {
+  return wrap([&]() { return Cxt->Pool.lease(); },
+              [&](auto &&Res) {
+                const uint32_t Index = Res->getIndex();
+                Cxt->Leases[Index] = std::move(*Res);
+                *VMCxt = Cxt->VMCxts[Index].get();
+              },
+              Cxt, VMCxt);
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Result
+WasmEdge_VMPoolTryLease(WasmEdge_VMPoolContext *Cxt,
+                        WasmEdge_VMContext **VMCxt) {
+  return wrap([&]() { return Cxt->Pool.tryLease(); },
+              [&](auto &&Res) {
+                if (!*Res) {
+                  *VMCxt = nullptr;
+                  return;
+                }
+                const uint32_t Index = (*Res)->getIndex();
+                Cxt->Leases[Index] = std::move(**Res);
+                *VMCxt = Cxt->VMCxts[Index].get();
+              },
+              Cxt, VMCxt);
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_VMPoolReturn(WasmEdge_VMPoolContext *Cxt,
+                                                WasmEdge_VMContext *VMCxt) {
+  if (!Cxt || !VMCxt) {
+    return;
+  }
+  for (uint32_t I = 0; I < Cxt->VMCxts.size(); ++I) {
+    if (Cxt->VMCxts[I].get() == VMCxt) {
+      Cxt->Leases[I].release();
+      return;
+    }
+  }
+}
+
+WASMEDGE_CAPI_EXPORT WasmEdge_Async *
+WasmEdge_VMPoolAsyncExecute(WasmEdge_VMPoolContext *Cxt,
+                            const WasmEdge_String FuncName,
+                            const WasmEdge_Value *Params,
+                            const uint32_t ParamLen) {
+  auto ParamPair = genParamPair(Params, ParamLen);
+  if (Cxt) {
+    return new WasmEdge_Async(Cxt->Pool.asyncExecute(
+        genStrView(FuncName), ParamPair.first, ParamPair.second));
+  }
+  return nullptr;
+}
+
+WASMEDGE_CAPI_EXPORT void
+WasmEdge_VMPoolGetMetrics(const WasmEdge_VMPoolContext *Cxt,
+                          WasmEdge_VMPoolMetrics *Metrics) {
+  if (!Cxt || !Metrics) {
+    return;
+  }
+  const auto Stat = Cxt->Pool.getMetrics();
+  Metrics->Leases = Stat.Leases;
+  Metrics->Hits = Stat.Hits;
+  Metrics->Misses = Stat.Misses;
+  Metrics->ResetFailures = Stat.ResetFailures;
+  Metrics->InUse = Stat.InUse;
+  Metrics->WaitTime = static_cast<uint64_t>(Stat.WaitTime.count());
+  Metrics->MaxWaitTime = static_cast<uint64_t>(Stat.MaxWaitTime.count());
+  Metrics->ResetTime = static_cast<uint64_t>(Stat.ResetTime.count());
+}
+
+WASMEDGE_CAPI_EXPORT void WasmEdge_VMPoolDelete(WasmEdge_VMPoolContext *Cxt) {
+  delete Cxt;
+}
+
+// <<<<<<<< WasmEdge VM pool functions <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+
 // >>>>>>>> WasmEdge Driver functions >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 
 #if WASMEDGE_OS_WINDOWS
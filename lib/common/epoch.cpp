@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/epoch.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace WasmEdge {
+namespace Epoch {
+
+namespace {
+struct Timer {
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::thread Thread;
+  bool Stopping = false;
+
+  void stop() noexcept {
+    {
+      std::unique_lock Lock(Mutex);
+      Stopping = true;
+    }
+    Cond.notify_all();
+    if (Thread.joinable()) {
+      Thread.join();
+    }
+    Stopping = false;
+  }
+
+  ~Timer() noexcept { stop(); }
+};
+
+Timer &getTimer() noexcept {
+  static Timer T;
+  return T;
+}
+
+/// Serialize the starts and the stops of the timer thread.
+std::mutex TimerMutex;
+} // namespace
+
+std::atomic_uint64_t &getCounter() noexcept {
+  static std::atomic_uint64_t Counter = 0;
+  return Counter;
+}
+
+void startTimer(std::chrono::nanoseconds Interval) noexcept {
+  std::unique_lock TimerLock(TimerMutex);
+  auto &T = getTimer();
+  T.stop();
+  T.Thread = std::thread([&T, Interval]() {
+    std::unique_lock Lock(T.Mutex);
+    auto Next = std::chrono::steady_clock::now() + Interval;
+    while (!T.Cond.wait_until(Lock, Next, [&T]() { return T.Stopping; })) {
+      increment();
+      Next += Interval;
+    }
+  });
+}
+
+void stopTimer() noexcept {
+  std::unique_lock TimerLock(TimerMutex);
+  getTimer().stop();
+}
+
+} // namespace Epoch
+} // namespace WasmEdge
@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/metrics.h"
+
+#include "common/spdlog.h"
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Metrics {
+
+namespace {
+
+/// Upper bounds of the histogram buckets in seconds.
+static inline constexpr const std::array<double, 7> kInvocationBuckets = {
+    0.0001, 0.001, 0.01, 0.1, 1.0, 10.0, 60.0};
+static inline constexpr const std::array<double, 7> kHostCallBuckets = {
+    0.000001, 0.00001, 0.0001, 0.001, 0.01, 0.1, 1.0};
+
+struct Histogram {
+  /// Counts of the buckets, which are not cumulative until rendering. The
+  /// last one is the +Inf bucket.
+  std::array<uint64_t, 8> Counts = {};
+  std::chrono::nanoseconds Sum{0};
+
+  void observe(const std::array<double, 7> &Bounds,
+               std::chrono::nanoseconds Duration) noexcept {
+    const double Seconds = std::chrono::duration<double>(Duration).count();
+    size_t I = 0;
+    while (I < Bounds.size() && Seconds > Bounds[I]) {
+      ++I;
+    }
+    ++Counts[I];
+    Sum += Duration;
+  }
+};
+
+struct ModuleSeries {
+  uint64_t Invocations = 0;
+  uint64_t InstrCount = 0;
+  uint64_t Cost = 0;
+  std::chrono::nanoseconds WasmTime{0};
+  std::chrono::nanoseconds HostTime{0};
+  uint64_t MemoryPages = 0;
+  Histogram Duration;
+  /// Counts of the failed executions by the error codes.
+  std::map<uint32_t, uint64_t> Traps;
+};
+
+struct HostSeries {
+  Histogram Duration;
+};
+
+struct CacheSeries {
+  uint64_t Hits = 0;
+  uint64_t Misses = 0;
+};
+
+struct Registry {
+  std::atomic_bool Enabled = false;
+  std::mutex Mutex;
+  /// The series are sorted by the labels for the stable output.
+  std::map<std::string, ModuleSeries, std::less<>> Modules;
+  std::map<std::string, HostSeries, std::less<>> Hosts;
+  std::map<std::string_view, CacheSeries> Caches;
+};
+
+Registry &getRegistry() noexcept {
+  static Registry R;
+  return R;
+}
+
+thread_local std::chrono::nanoseconds ThreadHostTime{0};
+
+template <typename MapT>
+auto &getSeries(MapT &Map, std::string_view Name) {
+  auto It = Map.find(Name);
+  if (It == Map.end()) {
+    It = Map.emplace(std::string(Name), typename MapT::mapped_type{}).first;
+  }
+  return It->second;
+}
+
+/// Escape the label value, where only the backslash, the double quote, and
+/// the line feed are escaped.
+std::string escapeLabel(std::string_view Value) {
+  std::string Escaped;
+  Escaped.reserve(Value.size());
+  for (const char C : Value) {
+    switch (C) {
+    case '\\':
+      Escaped += "\\\\"sv;
+      break;
+    case '"':
+      Escaped += "\\\""sv;
+      break;
+    case '\n':
+      Escaped += "\\n"sv;
+      break;
+    default:
+      Escaped += C;
+      break;
+    }
+  }
+  return Escaped;
+}
+
+double toSeconds(std::chrono::nanoseconds Duration) noexcept {
+  return std::chrono::duration<double>(Duration).count();
+}
+
+void renderHeader(std::string &Out, std::string_view Name,
+                  std::string_view Type, std::string_view Help) {
+  fmt::format_to(std::back_inserter(Out), "# TYPE {} {}\n# HELP {} {}\n"sv,
+                 Name, Type, Name, Help);
+}
+
+void renderHistogram(std::string &Out, std::string_view Name,
+                     std::string_view Labels,
+                     const std::array<double, 7> &Bounds, const Histogram &H) {
+  uint64_t Count = 0;
+  for (size_t I = 0; I < H.Counts.size(); ++I) {
+    Count += H.Counts[I];
+    if (I < Bounds.size()) {
+      fmt::format_to(std::back_inserter(Out),
+                     "{}_bucket{{{},le=\"{}\"}} {}\n"sv, Name, Labels,
+                     Bounds[I], Count);
+    } else {
+      fmt::format_to(std::back_inserter(Out),
+                     "{}_bucket{{{},le=\"+Inf\"}} {}\n"sv, Name, Labels, Count);
+    }
+  }
+  fmt::format_to(std::back_inserter(Out), "{}_count{{{}}} {}\n"sv, Name,
+                 Labels, Count);
+  fmt::format_to(std::back_inserter(Out), "{}_sum{{{}}} {}\n"sv, Name, Labels,
+                 toSeconds(H.Sum));
+}
+
+} // namespace
+
+void enable() noexcept {
+  getRegistry().Enabled.store(true, std::memory_order_release);
+}
+
+bool isEnabled() noexcept {
+  return getRegistry().Enabled.load(std::memory_order_acquire);
+}
+
+void recordInvocation(const Invocation &Inv) noexcept {
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  auto &Series = getSeries(R.Modules, Inv.Module);
+  ++Series.Invocations;
+  Series.InstrCount += Inv.InstrCount;
+  Series.Cost += Inv.Cost;
+  Series.HostTime += Inv.HostTime;
+  if (Inv.Duration > Inv.HostTime) {
+    Series.WasmTime += Inv.Duration - Inv.HostTime;
+  }
+  Series.MemoryPages = Inv.MemoryPages;
+  Series.Duration.observe(kInvocationBuckets, Inv.Duration);
+  // The termination by the module, such as `proc_exit`, is not a trap.
+  if (Inv.Result != ErrCode::Value::Success &&
+      Inv.Result != ErrCode::Value::Terminated) {
+    ++Series.Traps[Inv.Result.getCode()];
+  }
+}
+
+void recordHostCall(std::string_view Module,
+                    std::chrono::nanoseconds Duration) noexcept {
+  ThreadHostTime += Duration;
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  auto &Series = getSeries(R.Hosts, Module);
+  Series.Duration.observe(kHostCallBuckets, Duration);
+}
+
+std::chrono::nanoseconds getThreadHostTime() noexcept {
+  return ThreadHostTime;
+}
+
+void recordCacheLookup(std::string_view Cache, uint64_t Hits,
+                       uint64_t Misses) noexcept {
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  auto &Series = R.Caches[Cache];
+  Series.Hits += Hits;
+  Series.Misses += Misses;
+}
+
+std::string render() {
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  std::string Out;
+  auto It = std::back_inserter(Out);
+
+  std::vector<std::string> Labels;
+  Labels.reserve(R.Modules.size());
+  for (const auto &[Name, Series] : R.Modules) {
+    Labels.push_back(fmt::format("module=\"{}\""sv, escapeLabel(Name)));
+  }
+  // Render a sample of every module by the getter of the value.
+  auto RenderModules = [&](std::string_view Name, auto &&Get) {
+    size_t I = 0;
+    for (const auto &[_, Series] : R.Modules) {
+      fmt::format_to(It, "{}{{{}}} {}\n"sv, Name, Labels[I++], Get(Series));
+    }
+  };
+
+  renderHeader(Out, "wasmedge_invocations"sv, "counter"sv,
+               "Executions of the exported functions."sv);
+  RenderModules("wasmedge_invocations_total"sv,
+                [](const ModuleSeries &S) { return S.Invocations; });
+  renderHeader(Out, "wasmedge_instructions"sv, "counter"sv,
+               "Interpreted instructions, when the counting is enabled."sv);
+  RenderModules("wasmedge_instructions_total"sv,
+                [](const ModuleSeries &S) { return S.InstrCount; });
+  renderHeader(Out, "wasmedge_gas"sv, "counter"sv,
+               "Gas of the executions, when the cost measuring is enabled."sv);
+  RenderModules("wasmedge_gas_total"sv,
+                [](const ModuleSeries &S) { return S.Cost; });
+  renderHeader(Out, "wasmedge_wasm_seconds"sv, "counter"sv,
+               "Time spent in the wasm functions."sv);
+  RenderModules("wasmedge_wasm_seconds_total"sv,
+                [](const ModuleSeries &S) { return toSeconds(S.WasmTime); });
+  renderHeader(Out, "wasmedge_host_seconds"sv, "counter"sv,
+               "Time spent in the host functions."sv);
+  RenderModules("wasmedge_host_seconds_total"sv,
+                [](const ModuleSeries &S) { return toSeconds(S.HostTime); });
+  renderHeader(Out, "wasmedge_memory_pages"sv, "gauge"sv,
+               "Pages of the memories after the last execution."sv);
+  RenderModules("wasmedge_memory_pages"sv,
+                [](const ModuleSeries &S) { return S.MemoryPages; });
+
+  renderHeader(Out, "wasmedge_traps"sv, "counter"sv,
+               "Failed executions by the error codes."sv);
+  size_t I = 0;
+  for (const auto &[_, Series] : R.Modules) {
+    for (const auto &[Code, Count] : Series.Traps) {
+      fmt::format_to(It,
+                     "wasmedge_traps_total{{{},code=\"0x{:03x}\","
+                     "reason=\"{}\"}} {}\n"sv,
+                     Labels[I], Code,
+                     escapeLabel(ErrCodeStr[ErrCode(Code).getEnum()]), Count);
+    }
+    ++I;
+  }
+  renderHeader(Out, "wasmedge_invocation_duration_seconds"sv, "histogram"sv,
+               "Wall time of the executions."sv);
+  I = 0;
+  for (const auto &[_, Series] : R.Modules) {
+    renderHistogram(Out, "wasmedge_invocation_duration_seconds"sv, Labels[I++],
+                    kInvocationBuckets, Series.Duration);
+  }
+
+  renderHeader(Out, "wasmedge_host_call_duration_seconds"sv, "histogram"sv,
+               "Latency of the host function calls by the host modules."sv);
+  for (const auto &[Name, Series] : R.Hosts) {
+    renderHistogram(Out, "wasmedge_host_call_duration_seconds"sv,
+                    fmt::format("module=\"{}\""sv, escapeLabel(Name)),
+                    kHostCallBuckets, Series.Duration);
+  }
+
+  renderHeader(Out, "wasmedge_cache_lookups"sv, "counter"sv,
+               "Lookups of the compiled and validated code caches."sv);
+  for (const auto &[Name, Series] : R.Caches) {
+    fmt::format_to(It,
+                   "wasmedge_cache_lookups_total{{cache=\"{}\","
+                   "result=\"hit\"}} {}\n"sv,
+                   Name, Series.Hits);
+    fmt::format_to(It,
+                   "wasmedge_cache_lookups_total{{cache=\"{}\","
+                   "result=\"miss\"}} {}\n"sv,
+                   Name, Series.Misses);
+  }
+  Out += "# EOF\n"sv;
+  return Out;
+}
+
+void clear() noexcept {
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  R.Modules.clear();
+  R.Hosts.clear();
+  R.Caches.clear();
+}
+
+} // namespace Metrics
+} // namespace WasmEdge
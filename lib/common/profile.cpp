@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/profile.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Statistics {
+
+namespace {
+/// Header line of the profile file with the format version.
+static inline constexpr const std::string_view kHeader = "wasmedge-profile 1"sv;
+} // namespace
+
+void Profile::recordCall(uint32_t FuncOffset) noexcept {
+  std::unique_lock Lock(Mutex);
+  ++Calls[FuncOffset];
+}
+
+void Profile::recordBranch(uint32_t Offset, bool IsTaken) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto &B = Branches[Offset];
+  ++(IsTaken ? B.Taken : B.NotTaken);
+}
+
+void Profile::recordIndirectCall(uint32_t Offset,
+                                 uint32_t FuncOffset) noexcept {
+  std::unique_lock Lock(Mutex);
+  ++IndirectCalls[Offset][FuncOffset];
+}
+
+uint64_t Profile::getCallCount(uint32_t FuncOffset) const noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Calls.find(FuncOffset); It != Calls.end()) {
+    return It->second;
+  }
+  return 0;
+}
+
+const Profile::Branch *Profile::getBranch(uint32_t Offset) const noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Branches.find(Offset); It != Branches.end()) {
+    return &It->second;
+  }
+  return nullptr;
+}
+
+const std::map<uint32_t, uint64_t> *
+Profile::getIndirectCall(uint32_t Offset) const noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = IndirectCalls.find(Offset); It != IndirectCalls.end()) {
+    return &It->second;
+  }
+  return nullptr;
+}
+
+bool Profile::empty() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Calls.empty() && Branches.empty() && IndirectCalls.empty();
+}
+
+void Profile::clear() noexcept {
+  std::unique_lock Lock(Mutex);
+  Calls.clear();
+  Branches.clear();
+  IndirectCalls.clear();
+}
+
+Expect<void> Profile::save(const std::filesystem::path &Path) const noexcept {
+  std::unique_lock Lock(Mutex);
+  std::ofstream OS(Path, std::ios::out | std::ios::trunc);
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  // Sort the records for a stable output.
+  OS << kHeader << '\n';
+  std::vector<std::pair<uint32_t, uint64_t>> SortedCalls(Calls.begin(),
+                                                         Calls.end());
+  std::sort(SortedCalls.begin(), SortedCalls.end());
+  for (const auto &[Offset, Count] : SortedCalls) {
+    OS << "call " << Offset << ' ' << Count << '\n';
+  }
+  std::vector<std::pair<uint32_t, Branch>> SortedBranches(Branches.begin(),
+                                                          Branches.end());
+  std::sort(SortedBranches.begin(), SortedBranches.end(),
+            [](const auto &LHS, const auto &RHS) noexcept {
+              return LHS.first < RHS.first;
+            });
+  for (const auto &[Offset, B] : SortedBranches) {
+    OS << "branch " << Offset << ' ' << B.Taken << ' ' << B.NotTaken << '\n';
+  }
+  std::vector<uint32_t> SortedSites;
+  for (const auto &Site : IndirectCalls) {
+    SortedSites.push_back(Site.first);
+  }
+  std::sort(SortedSites.begin(), SortedSites.end());
+  for (const auto Offset : SortedSites) {
+    for (const auto &[Target, Count] : IndirectCalls.at(Offset)) {
+      OS << "icall " << Offset << ' ' << Target << ' ' << Count << '\n';
+    }
+  }
+
+  OS.flush();
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+Expect<void> Profile::load(const std::filesystem::path &Path) noexcept {
+  std::ifstream IS(Path, std::ios::in);
+  if (!IS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  auto Malformed = [&Path]() {
+    spdlog::error(ErrCode::Value::ReadError);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::ReadError);
+  };
+
+  std::string Line;
+  if (!std::getline(IS, Line) || Line != kHeader) {
+    return Malformed();
+  }
+
+  // Parse all records before merging, so a malformed file changes nothing.
+  std::vector<std::pair<uint32_t, uint64_t>> NewCalls;
+  std::vector<std::pair<uint32_t, Branch>> NewBranches;
+  std::vector<std::tuple<uint32_t, uint32_t, uint64_t>> NewIndirectCalls;
+  std::string Kind;
+  while (IS >> Kind) {
+    uint32_t Offset;
+    if (Kind == "call"sv) {
+      uint64_t Count;
+      if (!(IS >> Offset >> Count)) {
+        return Malformed();
+      }
+      NewCalls.emplace_back(Offset, Count);
+    } else if (Kind == "branch"sv) {
+      Branch B;
+      if (!(IS >> Offset >> B.Taken >> B.NotTaken)) {
+        return Malformed();
+      }
+      NewBranches.emplace_back(Offset, B);
+    } else if (Kind == "icall"sv) {
+      uint32_t Target;
+      uint64_t Count;
+      if (!(IS >> Offset >> Target >> Count)) {
+        return Malformed();
+      }
+      NewIndirectCalls.emplace_back(Offset, Target, Count);
+    } else {
+      return Malformed();
+    }
+  }
+  if (!IS.eof()) {
+    return Malformed();
+  }
+
+  std::unique_lock Lock(Mutex);
+  for (const auto &[Offset, Count] : NewCalls) {
+    Calls[Offset] += Count;
+  }
+  for (const auto &[Offset, B] : NewBranches) {
+    auto &Merged = Branches[Offset];
+    Merged.Taken += B.Taken;
+    Merged.NotTaken += B.NotTaken;
+  }
+  for (const auto &[Offset, Target, Count] : NewIndirectCalls) {
+    IndirectCalls[Offset][Target] += Count;
+  }
+  return {};
+}
+
+} // namespace Statistics
+} // namespace WasmEdge
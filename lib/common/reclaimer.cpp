@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/reclaimer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace WasmEdge {
+
+struct Reclaimer::State {
+  std::atomic<bool> Enabled = false;
+  std::mutex Mutex;
+  /// Signaled on queueing objects, and on finishing a batch.
+  std::condition_variable Queued;
+  std::condition_variable Finished;
+  std::deque<ThreadPool::Task> Queue;
+  /// Counts of the queued and the destroyed objects, for the draining.
+  uint64_t QueuedCount = 0;
+  uint64_t DestroyedCount = 0;
+  bool Started = false;
+
+  void run() noexcept {
+    std::deque<ThreadPool::Task> Batch;
+    while (true) {
+      {
+        std::unique_lock Lock(Mutex);
+        Queued.wait(Lock, [this]() noexcept { return !Queue.empty(); });
+        Batch.swap(Queue);
+      }
+      // Destroy the whole batch without holding the lock, so the releasing
+      // threads are not blocked by the destructors.
+      const uint64_t Count = Batch.size();
+      for (auto &T : Batch) {
+        T();
+      }
+      Batch.clear();
+      {
+        std::unique_lock Lock(Mutex);
+        DestroyedCount += Count;
+      }
+      Finished.notify_all();
+    }
+  }
+};
+
+Reclaimer::State &Reclaimer::getState() noexcept {
+  // Never destroyed, as the background thread is not joined at exit.
+  static State *S = new State;
+  return *S;
+}
+
+void Reclaimer::setEnabled(bool IsEnable) noexcept {
+  getState().Enabled.store(IsEnable, std::memory_order_relaxed);
+  if (!IsEnable) {
+    drain();
+  }
+}
+
+bool Reclaimer::isEnabled() noexcept {
+  return getState().Enabled.load(std::memory_order_relaxed);
+}
+
+void Reclaimer::drain() noexcept {
+  auto &S = getState();
+  std::unique_lock Lock(S.Mutex);
+  const uint64_t Target = S.QueuedCount;
+  S.Finished.wait(Lock, [&S, Target]() noexcept {
+    return S.DestroyedCount >= Target;
+  });
+}
+
+uint64_t Reclaimer::getPendingCount() noexcept {
+  auto &S = getState();
+  std::unique_lock Lock(S.Mutex);
+  return S.QueuedCount - S.DestroyedCount;
+}
+
+void Reclaimer::enqueue(ThreadPool::Task T) noexcept {
+  auto &S = getState();
+  {
+    std::unique_lock Lock(S.Mutex);
+    if (!S.Started) {
+      try {
+        std::thread([&S]() noexcept { S.run(); }).detach();
+        S.Started = true;
+      } catch (const std::system_error &) {
+        // Destroy the object at once if the thread cannot be started.
+        Lock.unlock();
+        T();
+        return;
+      }
+    }
+    S.Queue.push_back(std::move(T));
+    ++S.QueuedCount;
+  }
+  S.Queued.notify_one();
+}
+
+} // namespace WasmEdge
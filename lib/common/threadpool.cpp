@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/threadpool.h"
+
+#include "common/defines.h"
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if WASMEDGE_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std::literals;
+
+namespace WasmEdge {
+
+namespace {
+/// Time of idling before a worker leaves.
+inline constexpr auto kKeepAlive = 10s;
+} // namespace
+
+struct ThreadPool::Worker {
+  std::mutex Mutex;
+  std::deque<Task> Tasks;
+  /// Index in the started workers, for choosing the pinned CPU.
+  uint32_t Index = 0;
+  std::thread::native_handle_type Handle{};
+};
+
+struct ThreadPool::State {
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  /// Tasks submitted from the outside of the workers.
+  std::deque<Task> Injected;
+  std::vector<std::shared_ptr<Worker>> Workers;
+  /// Count of the queued tasks not taken yet, and of the waiting workers.
+  uint64_t Pending = 0;
+  uint32_t Idle = 0;
+  uint32_t MaxThreads = 0;
+  uint32_t NextIndex = 0;
+  std::vector<uint32_t> CPUs;
+
+  /// Apply the pinning to the worker. Should be called with the lock held.
+  void pin([[maybe_unused]] const Worker &W) noexcept {
+#if WASMEDGE_OS_LINUX
+    cpu_set_t Set;
+    CPU_ZERO(&Set);
+    if (CPUs.empty()) {
+      for (uint32_t I = 0; I < std::thread::hardware_concurrency(); ++I) {
+        CPU_SET(I, &Set);
+      }
+    } else {
+      CPU_SET(CPUs[W.Index % CPUs.size()], &Set);
+    }
+    pthread_setaffinity_np(W.Handle, sizeof(Set), &Set);
+#endif
+  }
+
+  /// Take a task from the worker's own queue, the global queue, and the other
+  /// workers' queues in order.
+  Task take(Worker &W) noexcept {
+    Task T;
+    {
+      std::unique_lock WLock(W.Mutex);
+      if (!W.Tasks.empty()) {
+        T = std::move(W.Tasks.back());
+        W.Tasks.pop_back();
+      }
+    }
+    std::vector<std::shared_ptr<Worker>> Others;
+    {
+      std::unique_lock Lock(Mutex);
+      if (!T && !Injected.empty()) {
+        T = std::move(Injected.front());
+        Injected.pop_front();
+      }
+      if (T) {
+        --Pending;
+        return T;
+      }
+      if (Pending == 0) {
+        return T;
+      }
+      Others = Workers;
+    }
+    // Steal the oldest task of the others.
+    const size_t Begin = W.Index % Others.size();
+    for (size_t I = 0; I < Others.size() && !T; ++I) {
+      auto &Other = *Others[(Begin + I) % Others.size()];
+      if (&Other == &W) {
+        continue;
+      }
+      std::unique_lock WLock(Other.Mutex);
+      if (!Other.Tasks.empty()) {
+        T = std::move(Other.Tasks.front());
+        Other.Tasks.pop_front();
+      }
+    }
+    if (T) {
+      std::unique_lock Lock(Mutex);
+      --Pending;
+    }
+    return T;
+  }
+};
+
+namespace {
+thread_local const void *LocalState = nullptr;
+thread_local void *LocalWorker = nullptr;
+} // namespace
+
+ThreadPool::ThreadPool() noexcept : Shared(std::make_shared<State>()) {}
+
+ThreadPool &ThreadPool::getDefault() noexcept {
+  static ThreadPool *Pool = new ThreadPool();
+  return *Pool;
+}
+
+void ThreadPool::submit(Task T) noexcept {
+  auto &S = *Shared;
+  std::unique_lock Lock(S.Mutex);
+  if (LocalState == &S) {
+    auto &W = *static_cast<Worker *>(LocalWorker);
+    std::unique_lock WLock(W.Mutex);
+    W.Tasks.push_back(std::move(T));
+  } else {
+    S.Injected.push_back(std::move(T));
+  }
+  ++S.Pending;
+
+  if (S.Pending <= S.Idle ||
+      (S.MaxThreads != 0 && S.Workers.size() >= S.MaxThreads)) {
+    S.Cond.notify_one();
+    return;
+  }
+
+  // Start a worker for the task.
+  auto W = std::make_shared<Worker>();
+  W->Index = S.NextIndex++;
+  try {
+    std::thread Thread([Shared = Shared, W]() noexcept {
+      auto &S = *Shared;
+      LocalState = &S;
+      LocalWorker = W.get();
+      while (true) {
+        if (Task T = S.take(*W)) {
+          T();
+          continue;
+        }
+        std::unique_lock Lock(S.Mutex);
+        if (S.Pending != 0) {
+          continue;
+        }
+        ++S.Idle;
+        const bool Woken = S.Cond.wait_for(Lock, kKeepAlive,
+                                           [&S]() { return S.Pending != 0; });
+        --S.Idle;
+        if (!Woken) {
+          // No task is left in the own queue when nothing is pending.
+          S.Workers.erase(std::find(S.Workers.begin(), S.Workers.end(), W));
+          return;
+        }
+      }
+    });
+    W->Handle = Thread.native_handle();
+    S.Workers.push_back(W);
+    if (!S.CPUs.empty()) {
+      S.pin(*W);
+    }
+    Thread.detach();
+  } catch (const std::system_error &Error) {
+    spdlog::error("Failed to start the thread pool worker: {}"sv,
+                  Error.what());
+    if (!S.Workers.empty()) {
+      return;
+    }
+    // Run the queued tasks here, as no worker will take them.
+    std::deque<Task> Tasks = std::move(S.Injected);
+    S.Injected.clear();
+    S.Pending -= Tasks.size();
+    Lock.unlock();
+    for (auto &Queued : Tasks) {
+      Queued();
+    }
+  }
+}
+
+void ThreadPool::setMaxThreads(uint32_t Max) noexcept {
+  std::unique_lock Lock(Shared->Mutex);
+  Shared->MaxThreads = Max;
+}
+
+uint32_t ThreadPool::getMaxThreads() const noexcept {
+  std::unique_lock Lock(Shared->Mutex);
+  return Shared->MaxThreads;
+}
+
+void ThreadPool::setAffinity(std::vector<uint32_t> CPUs) noexcept {
+  std::unique_lock Lock(Shared->Mutex);
+  Shared->CPUs = std::move(CPUs);
+  for (const auto &W : Shared->Workers) {
+    Shared->pin(*W);
+  }
+}
+
+uint32_t ThreadPool::getThreadCount() const noexcept {
+  std::unique_lock Lock(Shared->Mutex);
+  return static_cast<uint32_t>(Shared->Workers.size());
+}
+
+} // namespace WasmEdge
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/trace.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Trace {
+
+namespace {
+
+struct Recorder {
+  std::atomic_bool Enabled = false;
+  std::mutex Mutex;
+  std::chrono::steady_clock::time_point Origin;
+  std::vector<Event> Events;
+  /// Small sequential IDs of the threads for the readable output.
+  std::unordered_map<std::thread::id, uint64_t> ThreadIds;
+};
+
+Recorder &getRecorder() noexcept {
+  static Recorder R;
+  return R;
+}
+
+void writeJSONString(std::ostream &OS, std::string_view Str) {
+  OS << '"';
+  for (const char C : Str) {
+    switch (C) {
+    case '"':
+      OS << "\\\"";
+      break;
+    case '\\':
+      OS << "\\\\";
+      break;
+    case '\n':
+      OS << "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20) {
+        OS << fmt::format("\\u{:04x}"sv, static_cast<unsigned char>(C));
+      } else {
+        OS << C;
+      }
+      break;
+    }
+  }
+  OS << '"';
+}
+
+} // namespace
+
+void enable() noexcept {
+  auto &R = getRecorder();
+  std::unique_lock Lock(R.Mutex);
+  if (!R.Enabled.load(std::memory_order_relaxed)) {
+    R.Origin = std::chrono::steady_clock::now();
+    R.Enabled.store(true, std::memory_order_release);
+  }
+}
+
+bool isEnabled() noexcept {
+  return getRecorder().Enabled.load(std::memory_order_acquire);
+}
+
+void record(std::string_view Category, std::string Name,
+            std::chrono::steady_clock::time_point Start,
+            std::chrono::steady_clock::time_point End) noexcept {
+  auto &R = getRecorder();
+  std::unique_lock Lock(R.Mutex);
+  const auto ThreadId =
+      R.ThreadIds
+          .try_emplace(std::this_thread::get_id(), R.ThreadIds.size() + 1)
+          .first->second;
+  R.Events.push_back({Category, std::move(Name), Start - R.Origin, End - Start,
+                      ThreadId});
+}
+
+std::vector<Event> getEvents() noexcept {
+  auto &R = getRecorder();
+  std::vector<Event> Events;
+  {
+    std::unique_lock Lock(R.Mutex);
+    Events = R.Events;
+  }
+  // The enclosing phase starts first, or ends later at the same start time.
+  std::stable_sort(Events.begin(), Events.end(),
+                   [](const Event &LHS, const Event &RHS) noexcept {
+                     return LHS.Start < RHS.Start ||
+                            (LHS.Start == RHS.Start &&
+                             LHS.Duration > RHS.Duration);
+                   });
+  return Events;
+}
+
+void dumpToLog() noexcept {
+  const auto Events = getEvents();
+  // Ends of the enclosing phases of every thread.
+  std::unordered_map<uint64_t, std::vector<std::chrono::nanoseconds>> Stacks;
+  std::chrono::nanoseconds Total{0};
+  spdlog::info("====================  Startup trace  ===================="sv);
+  for (const auto &E : Events) {
+    auto &Stack = Stacks[E.ThreadId];
+    while (!Stack.empty() && Stack.back() <= E.Start) {
+      Stack.pop_back();
+    }
+    spdlog::info(" {:>10.3f} ms {:>10.3f} ms  {:{}}{}: {}"sv,
+                 std::chrono::duration<double, std::milli>(E.Start).count(),
+                 std::chrono::duration<double, std::milli>(E.Duration).count(),
+                 ""sv, Stack.size() * 2, E.Category, E.Name);
+    Stack.push_back(E.Start + E.Duration);
+    Total = std::max(Total, E.Start + E.Duration);
+  }
+  spdlog::info(" Total: {:.3f} ms"sv,
+               std::chrono::duration<double, std::milli>(Total).count());
+  spdlog::info("=======================   End   ======================="sv);
+}
+
+Expect<void> saveChromeTrace(const std::filesystem::path &Path) noexcept {
+  const auto Events = getEvents();
+  std::ofstream OS(Path, std::ios::out | std::ios::trunc);
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  // Complete events with the timestamps in microseconds.
+  OS << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool First = true;
+  for (const auto &E : Events) {
+    OS << (First ? "\n" : ",\n") << "{\"name\":";
+    writeJSONString(OS, E.Name);
+    OS << ",\"cat\":";
+    writeJSONString(OS, E.Category);
+    OS << fmt::format(
+        ",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}"sv,
+        std::chrono::duration<double, std::micro>(E.Start).count(),
+        std::chrono::duration<double, std::micro>(E.Duration).count(),
+        E.ThreadId);
+    First = false;
+  }
+  OS << "\n]}\n";
+
+  OS.flush();
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+} // namespace Trace
+} // namespace WasmEdge
@@ -1,25 +1,237 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
+#include "aot/cache.h"
 #include "common/configure.h"
 #include "common/defines.h"
 #include "common/filesystem.h"
+#include "common/profile.h"
 #include "common/version.h"
 #include "driver/compiler.h"
 #include "loader/loader.h"
 #include "validator/validator.h"
 #include "llvm/codegen.h"
 #include "llvm/compiler.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
 namespace WasmEdge {
 namespace Driver {
 
+namespace {
+#ifdef WASMEDGE_USE_LLVM
+/// Time waited for another process compiling the same module into the module
+/// cache.
+static inline constexpr const std::chrono::seconds kModuleCacheWait{60};
+
+enum class CompileResult : uint8_t { Failed, Compiled, Cached };
+
+/// Settings shared by the modules of a batch.
+struct CompileSettings {
+  std::vector<uint8_t> Levels;
+  const Statistics::Profile *Profile = nullptr;
+  LLVM::CompileReport *Report = nullptr;
+  bool ModuleCache = false;
+};
+
+std::string_view trim(std::string_view Str) noexcept {
+  const auto Begin = Str.find_first_not_of(" \t\r"sv);
+  if (Begin == std::string_view::npos) {
+    return {};
+  }
+  const auto End = Str.find_last_not_of(" \t\r"sv);
+  return Str.substr(Begin, End - Begin + 1);
+}
+
+/// Read the manifest of a batch, one `INPUT OUTPUT` pair per line separated
+/// by a tab or spaces. The empty lines and the lines starting with `#` are
+/// skipped. The relative inputs are resolved against the directory of the
+/// manifest, and the relative outputs against OutputDir.
+bool readManifest(
+    const std::filesystem::path &Manifest,
+    const std::filesystem::path &OutputDir,
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>>
+        &Jobs) {
+  std::ifstream File(Manifest);
+  if (!File) {
+    spdlog::error("Open manifest {} failed"sv, Manifest.u8string());
+    return false;
+  }
+  std::string Line;
+  for (size_t LineNo = 1; std::getline(File, Line); ++LineNo) {
+    const auto Entry = trim(Line);
+    if (Entry.empty() || Entry.front() == '#') {
+      continue;
+    }
+    auto Pos = Entry.find('\t');
+    if (Pos == std::string_view::npos) {
+      Pos = Entry.find(' ');
+    }
+    const auto Input = trim(Entry.substr(0, Pos));
+    const auto Output = Pos == std::string_view::npos
+                            ? std::string_view{}
+                            : trim(Entry.substr(Pos + 1));
+    if (Output.empty()) {
+      spdlog::error("{}:{}: expected `INPUT OUTPUT`"sv, Manifest.u8string(),
+                    LineNo);
+      return false;
+    }
+    Jobs.emplace_back(Manifest.parent_path() / std::filesystem::u8path(Input),
+                      OutputDir / std::filesystem::u8path(Output));
+  }
+  return true;
+}
+
+/// Compile the module in InputPath to OutputPath, or copy the output of the
+/// same module from the module cache.
+CompileResult compileModule(Configure Conf, const CompileSettings &Settings,
+                            const std::filesystem::path &InputPath,
+                            const std::filesystem::path &OutputPath) noexcept {
+  Loader::Loader Loader(Conf);
+
+  std::vector<Byte> Data;
+  if (auto Res = Loader.loadFile(InputPath)) {
+    Data = std::move(*Res);
+  } else {
+    const auto Err = static_cast<uint32_t>(Res.error());
+    spdlog::error("Load failed. Error code: {}"sv, Err);
+    return CompileResult::Failed;
+  }
+
+  std::unique_ptr<AST::Module> Module;
+  if (auto Res = Loader.parseModule(Data)) {
+    Module = std::move(*Res);
+  } else {
+    const auto Err = static_cast<uint32_t>(Res.error());
+    spdlog::error("Parse Module failed. Error code: {}"sv, Err);
+    return CompileResult::Failed;
+  }
+
+  {
+    Validator::Validator ValidatorEngine(Conf);
+    if (auto Res = ValidatorEngine.validate(*Module); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Validate Module failed. Error code: {}"sv, Err);
+      return CompileResult::Failed;
+    }
+  }
+
+  if (OutputPath.extension().u8string() == WASMEDGE_LIB_EXTENSION) {
+    Conf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+  }
+  const auto &Levels = Settings.Levels;
+  if (Levels.size() > 1 && Conf.getCompilerConfigure().getOutputFormat() !=
+                               CompilerConfigure::OutputFormat::Wasm) {
+    spdlog::error("Multiple target levels need the universal wasm output."sv);
+    return CompileResult::Failed;
+  }
+  std::error_code Error;
+  std::filesystem::create_directories(OutputPath.parent_path(), Error);
+
+  // The output is keyed by the module, the options, and the target levels,
+  // and the output format is kept in the extension.
+  std::filesystem::path CachePath;
+  AOT::Cache::Lock CacheLock;
+  if (Settings.ModuleCache) {
+    std::vector<Byte> Key(Data);
+    Key.insert(Key.end(), Levels.begin(), Levels.end());
+    Conf.getCompilerConfigure().setTargetLevel(Levels.front());
+    if (auto Res = AOT::Cache::getPath(
+            Key, Conf, AOT::Cache::StorageScope::Local, "modules"sv)) {
+      CachePath = std::move(*Res);
+      CachePath += OutputPath.extension();
+    }
+  }
+  auto CopyCached = [&]() noexcept {
+    if (CachePath.empty() ||
+        !std::filesystem::is_regular_file(CachePath, Error)) {
+      return false;
+    }
+    std::filesystem::copy_file(
+        CachePath, OutputPath,
+        std::filesystem::copy_options::overwrite_existing, Error);
+    if (Error) {
+      return false;
+    }
+    AOT::Cache::touch(CachePath);
+    return true;
+  };
+  if (CopyCached()) {
+    return CompileResult::Cached;
+  }
+  if (!CachePath.empty()) {
+    CacheLock = AOT::Cache::Lock::acquire(CachePath, kModuleCacheWait);
+    // Stored by another process between the lookup and the lock.
+    if (CopyCached()) {
+      return CompileResult::Cached;
+    }
+  }
+
+  for (size_t I = 0; I < Levels.size(); ++I) {
+    Conf.getCompilerConfigure().setTargetLevel(Levels[I]);
+    LLVM::Compiler Compiler(Conf);
+    if (auto Res = Compiler.checkConfigure(); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Compiler Configure failed. Error code: {}"sv, Err);
+      return CompileResult::Failed;
+    }
+    if (Settings.Profile && !Settings.Profile->empty()) {
+      Compiler.setProfile(Settings.Profile);
+    }
+    if (Settings.Report) {
+      Compiler.setReport(Settings.Report);
+    }
+    if (I > 0) {
+      // Append the AOT section of this level to the previous output.
+      if (auto Res = Loader.loadFile(OutputPath)) {
+        Data = std::move(*Res);
+      } else {
+        const auto Err = static_cast<uint32_t>(Res.error());
+        spdlog::error("Load failed. Error code: {}"sv, Err);
+        return CompileResult::Failed;
+      }
+    }
+    LLVM::CodeGen CodeGen(Conf);
+    if (Settings.Report) {
+      CodeGen.setReport(Settings.Report);
+    }
+    if (auto Res = Compiler.compile(*Module); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Compilation failed. Error code: {}"sv, Err);
+      return CompileResult::Failed;
+    } else if (auto Res2 = CodeGen.codegen(Data, std::move(*Res), OutputPath);
+               !Res2) {
+      const auto Err = static_cast<uint32_t>(Res2.error());
+      spdlog::error("Code Generation failed. Error code: {}"sv, Err);
+      return CompileResult::Failed;
+    }
+  }
+
+  // A failure to store only costs a compilation next time.
+  if (!CachePath.empty() && CacheLock.owns()) {
+    if (auto Res = Loader.loadFile(OutputPath)) {
+      if (AOT::Cache::publish(CachePath, *Res)) {
+        AOT::Cache::evict(CachePath.parent_path());
+      }
+    }
+  }
+  return CompileResult::Compiled;
+}
+#endif
+} // namespace
+
 int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
   using namespace std::literals;
 
@@ -147,39 +359,6 @@ int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
   // Set force interpreter here to load instructions of function body forcibly.
   Conf.getRuntimeConfigure().setForceInterpreter(true);
 
-  std::filesystem::path InputPath =
-      std::filesystem::absolute(std::filesystem::u8path(Opt.WasmName.value()));
-  std::filesystem::path OutputPath =
-      std::filesystem::absolute(std::filesystem::u8path(Opt.SoName.value()));
-  Loader::Loader Loader(Conf);
-
-  std::vector<Byte> Data;
-  if (auto Res = Loader.loadFile(InputPath)) {
-    Data = std::move(*Res);
-  } else {
-    const auto Err = static_cast<uint32_t>(Res.error());
-    spdlog::error("Load failed. Error code: {}"sv, Err);
-    return EXIT_FAILURE;
-  }
-
-  std::unique_ptr<AST::Module> Module;
-  if (auto Res = Loader.parseModule(Data)) {
-    Module = std::move(*Res);
-  } else {
-    const auto Err = static_cast<uint32_t>(Res.error());
-    spdlog::error("Parse Module failed. Error code: {}"sv, Err);
-    return EXIT_FAILURE;
-  }
-
-  {
-    Validator::Validator ValidatorEngine(Conf);
-    if (auto Res = ValidatorEngine.validate(*Module); !Res) {
-      const auto Err = static_cast<uint32_t>(Res.error());
-      spdlog::error("Validate Module failed. Error code: {}"sv, Err);
-      return EXIT_FAILURE;
-    }
-  }
-
   {
     if (Opt.ConfDumpIR.value()) {
       Conf.getCompilerConfigure().setDumpIR(true);
@@ -187,6 +366,24 @@ int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
     if (Opt.ConfInterruptible.value()) {
       Conf.getCompilerConfigure().setInterruptible(true);
     }
+    Conf.getCompilerConfigure().setPartitionCount(
+        Opt.ConfPartitionCount.value());
+    if (Opt.ConfFunctionCache.value()) {
+      Conf.getCompilerConfigure().setFunctionCache(true);
+    }
+    AOT::Cache::setMaxSize(Opt.ConfCacheMaxSize.value() << 20);
+    if (!Opt.ConfCacheRemote.value().empty()) {
+      auto Remote = AOT::Cache::createHTTPBackend(Opt.ConfCacheRemote.value());
+      if (!Remote) {
+        return EXIT_FAILURE;
+      }
+      AOT::Cache::setRemote(std::move(Remote),
+                            Opt.ConfCacheRemoteUpload.value());
+    }
+    if (Opt.ConfCoarseGasCheck.value()) {
+      Conf.getCompilerConfigure().setCoarseGasCheck(true);
+    }
+    Conf.getCompilerConfigure().setInlineBudget(Opt.ConfInlineBudget.value());
     if (Opt.ConfEnableAllStatistics.value()) {
       Conf.getStatisticsConfigure().setInstructionCounting(true);
       Conf.getStatisticsConfigure().setCostMeasuring(true);
@@ -205,25 +402,116 @@ int Compiler([[maybe_unused]] struct DriverCompilerOptions &Opt) noexcept {
     if (Opt.ConfGenericBinary.value()) {
       Conf.getCompilerConfigure().setGenericBinary(true);
     }
-    if (OutputPath.extension().u8string() == WASMEDGE_LIB_EXTENSION) {
-      Conf.getCompilerConfigure().setOutputFormat(
-          CompilerConfigure::OutputFormat::Native);
+  }
+
+  CompileSettings Settings;
+  Settings.ModuleCache = Opt.ConfModuleCache.value();
+  for (std::string_view List = Opt.ConfTargetLevel.value(); !List.empty();) {
+    const auto Pos = List.find(',');
+    const auto Item = List.substr(0, Pos);
+    List = Pos == std::string_view::npos ? ""sv : List.substr(Pos + 1);
+    uint32_t Level = 0;
+    if (auto [Ptr, Err] =
+            std::from_chars(Item.data(), Item.data() + Item.size(), Level);
+        Err != std::errc() || Ptr != Item.data() + Item.size() || Level < 1 ||
+        Level > 4) {
+      spdlog::error("Invalid x86-64 micro-architecture level: {}"sv, Item);
+      return EXIT_FAILURE;
     }
-    LLVM::Compiler Compiler(Conf);
-    if (auto Res = Compiler.checkConfigure(); !Res) {
-      const auto Err = static_cast<uint32_t>(Res.error());
-      spdlog::error("Compiler Configure failed. Error code: {}"sv, Err);
+    Settings.Levels.push_back(static_cast<uint8_t>(Level));
+  }
+  if (Settings.Levels.empty()) {
+    Settings.Levels.push_back(0);
+  }
+  Statistics::Profile Profile;
+  if (!Opt.ConfProfileUse.value().empty()) {
+    if (Opt.ConfBatch.value()) {
+      spdlog::error("The profile of one module cannot guide a batch."sv);
       return EXIT_FAILURE;
     }
-    LLVM::CodeGen CodeGen(Conf);
-    if (auto Res = Compiler.compile(*Module); !Res) {
+    if (auto Res =
+            Profile.load(std::filesystem::u8path(Opt.ConfProfileUse.value()));
+        !Res) {
       const auto Err = static_cast<uint32_t>(Res.error());
-      spdlog::error("Compilation failed. Error code: {}"sv, Err);
+      spdlog::error("Load profile failed. Error code: {}"sv, Err);
       return EXIT_FAILURE;
-    } else if (auto Res2 = CodeGen.codegen(Data, std::move(*Res), OutputPath);
-               !Res2) {
-      const auto Err = static_cast<uint32_t>(Res2.error());
-      spdlog::error("Code Generation failed. Error code: {}"sv, Err);
+    }
+    Settings.Profile = &Profile;
+  }
+  LLVM::CompileReport Report;
+  const bool IsReport = !Opt.ConfCompileReport.value().empty();
+  if (IsReport) {
+    Settings.Report = &Report;
+  }
+
+  std::filesystem::path InputPath =
+      std::filesystem::absolute(std::filesystem::u8path(Opt.WasmName.value()));
+  std::filesystem::path OutputPath =
+      std::filesystem::absolute(std::filesystem::u8path(Opt.SoName.value()));
+  if (!Opt.ConfBatch.value()) {
+    if (compileModule(Conf, Settings, InputPath, OutputPath) ==
+        CompileResult::Failed) {
+      return EXIT_FAILURE;
+    }
+  } else {
+    if (Opt.ConfDumpIR.value()) {
+      spdlog::error("The IR of a batch cannot be dumped."sv);
+      return EXIT_FAILURE;
+    }
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> Jobs;
+    if (!readManifest(InputPath, OutputPath, Jobs)) {
+      return EXIT_FAILURE;
+    }
+    std::vector<CompileResult> Results(Jobs.size(), CompileResult::Failed);
+    std::atomic<size_t> Next = 0;
+    auto Worker = [&]() noexcept {
+      for (size_t I; (I = Next.fetch_add(1, std::memory_order_relaxed)) <
+                     Jobs.size();) {
+        Results[I] =
+            compileModule(Conf, Settings, Jobs[I].first, Jobs[I].second);
+      }
+    };
+    uint32_t JobCount = Opt.ConfJobs.value();
+    if (JobCount == 0) {
+      JobCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    std::vector<std::thread> Workers;
+    for (size_t I = 1; I < std::min<size_t>(JobCount, Jobs.size()); ++I) {
+      Workers.emplace_back(Worker);
+    }
+    Worker();
+    for (auto &W : Workers) {
+      W.join();
+    }
+
+    size_t Compiled = 0, Cached = 0, Failed = 0;
+    for (size_t I = 0; I < Jobs.size(); ++I) {
+      switch (Results[I]) {
+      case CompileResult::Compiled:
+        ++Compiled;
+        break;
+      case CompileResult::Cached:
+        ++Cached;
+        break;
+      default:
+        spdlog::error("Failed to compile {}"sv, Jobs[I].first.u8string());
+        ++Failed;
+        break;
+      }
+    }
+    spdlog::info("batch: {} compiled, {} cached, {} failed"sv, Compiled,
+                 Cached, Failed);
+    if (Failed > 0) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (IsReport) {
+    if (auto Res =
+            Report.save(std::filesystem::u8path(Opt.ConfCompileReport.value()));
+        !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      spdlog::error("Save compile report failed. Error code: {}"sv, Err);
       return EXIT_FAILURE;
     }
   }
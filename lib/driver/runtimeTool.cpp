@@ -1,15 +1,21 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
+#include "aot/cache.h"
 #include "common/configure.h"
+#include "common/defines.h"
 #include "common/filesystem.h"
+#include "common/metrics.h"
 #include "common/spdlog.h"
+#include "common/trace.h"
 #include "common/types.h"
 #include "common/version.h"
 #include "driver/tool.h"
 #include "host/wasi/wasimodule.h"
+#include "system/sampler.h"
 #include "vm/vm.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -18,11 +24,178 @@
 #include <string_view>
 #include <vector>
 
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
 using namespace std::literals;
 
 namespace WasmEdge {
 namespace Driver {
 
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+namespace {
+/// Process IDs of the worker processes, for forwarding the signals. The
+/// storage is reserved before installing the handlers.
+std::vector<pid_t> WorkerPIDs;
+/// Index of this worker process, which is 0 without the workers.
+uint32_t WorkerIndex = 0;
+
+void forwardSignal(int Signal) noexcept {
+  for (const auto PID : WorkerPIDs) {
+    ::kill(PID, Signal);
+  }
+}
+
+/// Fork the worker processes. Returns nullopt in the workers, which go on to
+/// instantiate and run the module, and the exit code in this process after
+/// all workers exited. The loaded module and the mapped AOT code are shared
+/// copy-on-write. There should be no other threads when forking, which holds
+/// after loading and validating as their threads are joined.
+std::optional<int> forkWorkers(uint32_t Count) noexcept {
+  static constexpr const std::array<int, 3> kSignals = {SIGINT, SIGTERM,
+                                                        SIGHUP};
+  WorkerPIDs.reserve(Count);
+  struct sigaction Action = {};
+  Action.sa_handler = forwardSignal;
+  sigemptyset(&Action.sa_mask);
+  for (const int Signal : kSignals) {
+    ::sigaction(Signal, &Action, nullptr);
+  }
+
+  int ExitCode = EXIT_SUCCESS;
+  for (uint32_t I = 0; I < Count; ++I) {
+    const pid_t PID = ::fork();
+    if (PID == 0) {
+      WorkerPIDs.clear();
+      WorkerIndex = I;
+      for (const int Signal : kSignals) {
+        std::signal(Signal, SIG_DFL);
+      }
+      return std::nullopt;
+    }
+    if (PID < 0) {
+      spdlog::error("Failed to fork the worker process: {}"sv,
+                    std::strerror(errno));
+      forwardSignal(SIGTERM);
+      ExitCode = EXIT_FAILURE;
+      break;
+    }
+    WorkerPIDs.push_back(PID);
+  }
+  spdlog::info("Started {} worker processes"sv, WorkerPIDs.size());
+
+  // The other workers keep serving when a worker exits. The first failure
+  // is reported as the exit code.
+  for (size_t Remain = WorkerPIDs.size(); Remain > 0;) {
+    int Status = 0;
+    const pid_t PID = ::waitpid(-1, &Status, 0);
+    if (PID < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    --Remain;
+    const int Code = WIFEXITED(Status) ? WEXITSTATUS(Status)
+                                       : 128 + WTERMSIG(Status);
+    if (Code != EXIT_SUCCESS) {
+      spdlog::warn("Worker process {} exited with status {}"sv, PID, Code);
+      if (ExitCode == EXIT_SUCCESS) {
+        ExitCode = Code;
+      }
+    }
+  }
+  return ExitCode;
+}
+
+/// Answer a request of the metrics endpoint and close the connection.
+void answerMetrics(int Conn) noexcept {
+  // The request line is in the first read for the scrapers.
+  std::array<char, 1024> Buffer;
+  const auto Size = ::recv(Conn, Buffer.data(), Buffer.size(), 0);
+  const std::string_view Request(Buffer.data(),
+                                 static_cast<size_t>(Size > 0 ? Size : 0));
+  std::string Body;
+  std::string_view Status = "404 Not Found"sv;
+  std::string_view Type = "text/plain; charset=utf-8"sv;
+  if (Request.substr(0, 13) == "GET /metrics "sv ||
+      Request.substr(0, 13) == "GET /metrics?"sv) {
+    Body = Metrics::render();
+    Status = "200 OK"sv;
+    Type = "application/openmetrics-text; version=1.0.0; charset=utf-8"sv;
+  }
+  auto Response = fmt::format(
+      "HTTP/1.1 {}\r\nContent-Type: {}\r\nContent-Length: {}\r\n"
+      "Connection: close\r\n\r\n"sv,
+      Status, Type, Body.size());
+  Response += Body;
+  int Flags = 0;
+#ifdef MSG_NOSIGNAL
+  Flags = MSG_NOSIGNAL;
+#endif
+  for (std::string_view Rest = Response; !Rest.empty();) {
+    const auto Sent = ::send(Conn, Rest.data(), Rest.size(), Flags);
+    if (Sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Sent <= 0) {
+      break;
+    }
+    Rest.remove_prefix(static_cast<size_t>(Sent));
+  }
+  ::close(Conn);
+}
+
+/// Serve the metrics endpoint on the port of all addresses in a detached
+/// thread, which lives until the process exits.
+bool serveMetrics(uint16_t Port) noexcept {
+  const int Fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (Fd < 0) {
+    return false;
+  }
+  const int On = 1;
+  ::setsockopt(Fd, SOL_SOCKET, SO_REUSEADDR, &On, sizeof(On));
+  sockaddr_in Addr = {};
+  Addr.sin_family = AF_INET;
+  Addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  Addr.sin_port = htons(Port);
+  if (::bind(Fd, reinterpret_cast<const sockaddr *>(&Addr), sizeof(Addr)) !=
+          0 ||
+      ::listen(Fd, 16) != 0) {
+    ::close(Fd);
+    return false;
+  }
+  std::thread([Fd]() noexcept {
+    while (true) {
+      const int Conn = ::accept(Fd, nullptr, nullptr);
+      if (Conn < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        break;
+      }
+      // A stalled client does not block the later scrapes for long.
+      timeval Timeout = {5, 0};
+      ::setsockopt(Conn, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+      ::setsockopt(Conn, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout));
+      answerMetrics(Conn);
+    }
+    ::close(Fd);
+  }).detach();
+  return true;
+}
+} // namespace
+#endif
+
 static int
 ToolOnModule(WasmEdge::VM::VM &VM, const std::string &FuncName,
              std::optional<std::chrono::system_clock::time_point> Timeout,
@@ -77,6 +250,7 @@ ToolOnModule(WasmEdge::VM::VM &VM, const std::string &FuncName,
     }
   }
 
+  Trace::Scope EntryScope("driver"sv, "entry call"sv, FuncName);
   auto AsyncResult = VM.asyncExecute(FuncName, FuncArgs, FuncArgTypes);
   if (Timeout.has_value()) {
     if (!AsyncResult.waitUntil(*Timeout)) {
@@ -195,6 +369,7 @@ ToolOnComponent(WasmEdge::VM::VM &VM, const std::string &FuncName,
     }
   }
 
+  Trace::Scope EntryScope("driver"sv, "entry call"sv, FuncName);
   auto AsyncResult = VM.asyncExecuteComponent(FuncName, FuncArgs, FuncArgTypes);
   if (Timeout.has_value()) {
     if (!AsyncResult.waitUntil(*Timeout)) {
@@ -242,6 +417,27 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
   std::ios::sync_with_stdio(false);
   Log::setInfoLoggingLevel();
 
+  // Log and write the startup trace when leaving.
+  struct TraceWriter {
+    ~TraceWriter() noexcept {
+      if (Trace::isEnabled()) {
+        Trace::dumpToLog();
+        if (!Path.empty() &&
+            Trace::saveChromeTrace(std::filesystem::u8path(Path))) {
+          spdlog::info("Startup trace written to {}"sv, Path);
+        }
+      }
+    }
+    const std::string &Path;
+  } Tracing{Opt.TraceStartupOutput.value()};
+  if (Opt.TraceStartup.value() || !Opt.TraceStartupOutput.value().empty()) {
+    Trace::enable();
+  }
+  // Record the metrics from loading for the endpoint.
+  if (Opt.MetricsPort.value() != 0) {
+    Metrics::enable();
+  }
+
   Configure Conf;
   // WASM standard configuration has the highest priority.
   if (Opt.PropWASM1.value()) {
@@ -303,10 +499,6 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
   if (Opt.PropExceptionHandlingDeprecated.value()) {
     Conf.addProposal(Proposal::ExceptionHandling);
   }
-  // TODO: MEMORY64 - enable the option.
-  // if (Opt.PropMemory64.value()) {
-  //   Conf.removeProposal(Proposal::Memory64);
-  // }
 
   // Handle the proposal removal which has dependency.
   // The GC proposal depends on the func-ref proposal, and the func-ref proposal
@@ -330,16 +522,24 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
     Conf.addProposal(Proposal::GC);
   }
 
+  if (Opt.PropMemory64.value()) {
+    Conf.addProposal(Proposal::Memory64);
+  }
   if (Opt.PropThreads.value()) {
     Conf.addProposal(Proposal::Threads);
   }
+  if (Opt.PropStackSwitching.value()) {
+    Conf.addProposal(Proposal::StackSwitching);
+  }
   if (Opt.PropComponent.value()) {
     Conf.addProposal(Proposal::Component);
     spdlog::warn("component model is enabled, this is experimental."sv);
   }
   if (Opt.PropAll.value()) {
     Conf.setWASMStandard(Standard::WASM_3);
+    Conf.addProposal(Proposal::Memory64);
     Conf.addProposal(Proposal::Threads);
+    Conf.addProposal(Proposal::StackSwitching);
     spdlog::warn("component model is enabled, this is experimental."sv);
     Conf.addProposal(Proposal::Component);
   }
@@ -358,10 +558,26 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
     Conf.getRuntimeConfigure().setMaxMemoryPage(
         static_cast<uint32_t>(Opt.MemLim.value().back()));
   }
+  if (Opt.ValueStackSize.value() > 0) {
+    Conf.getRuntimeConfigure().setValueStackSize(Opt.ValueStackSize.value());
+  }
+  Conf.getRuntimeConfigure().setValidationThreadCount(
+      Opt.ValidationThreads.value());
+  Conf.getRuntimeConfigure().setLoadingThreadCount(Opt.LoadingThreads.value());
+  if (Opt.MemoryPoolSize.value() > 0) {
+    Conf.getRuntimeConfigure().setMemoryPoolSize(Opt.MemoryPoolSize.value());
+  }
+  if (Opt.StripedMemoryPages.value() > 0) {
+    Conf.getRuntimeConfigure().setStripedMemoryPages(
+        Opt.StripedMemoryPages.value());
+  }
+  Conf.getRuntimeConfigure().setNumaNode(Opt.NumaNode.value());
+  Conf.getRuntimeConfigure().setNativeStackSize(Opt.NativeStackSize.value());
   if (Opt.ConfEnableAllStatistics.value()) {
     Conf.getStatisticsConfigure().setInstructionCounting(true);
     Conf.getStatisticsConfigure().setCostMeasuring(true);
     Conf.getStatisticsConfigure().setTimeMeasuring(true);
+    Conf.getStatisticsConfigure().setIOMeasuring(true);
   } else {
     if (Opt.ConfEnableInstructionCounting.value()) {
       Conf.getStatisticsConfigure().setInstructionCounting(true);
@@ -372,11 +588,34 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
     if (Opt.ConfEnableTimeMeasuring.value()) {
       Conf.getStatisticsConfigure().setTimeMeasuring(true);
     }
+    if (Opt.ConfEnableIOStatistics.value()) {
+      Conf.getStatisticsConfigure().setIOMeasuring(true);
+    }
+  }
+  if (Opt.ConfEnableFunctionProfiling.value()) {
+    Conf.getStatisticsConfigure().setFunctionProfiling(true);
+  }
+  if (!Opt.ProfileGenerate.value().empty()) {
+    // Only the interpreter records the profile.
+    Conf.getStatisticsConfigure().setProfileGenerating(true);
+    Conf.getRuntimeConfigure().setForceInterpreter(true);
   }
   if (Opt.ConfEnableJIT.value()) {
     Conf.getRuntimeConfigure().setEnableJIT(true);
     Conf.getCompilerConfigure().setOptimizationLevel(
         WasmEdge::CompilerConfigure::OptimizationLevel::O1);
+    if (Opt.ConfEnableLazyJIT.value()) {
+      Conf.getRuntimeConfigure().setEnableLazyJIT(true);
+      Conf.getRuntimeConfigure().setEnableJITSpeculation(
+          Opt.ConfEnableJITSpeculation.value());
+    }
+  }
+  if (Opt.ConfEnableTieredJIT.value()) {
+    Conf.getRuntimeConfigure().setEnableTieredJIT(true);
+    Conf.getRuntimeConfigure().setTierUpThreshold(Opt.TierUpThreshold.value());
+  }
+  if (Opt.ConfEnableJITCache.value()) {
+    Conf.getRuntimeConfigure().setEnableJITCache(true);
   }
   if (Opt.ConfEnableCoredump.value()) {
     Conf.getRuntimeConfigure().setEnableCoredump(true);
@@ -390,6 +629,48 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
   if (Opt.ConfAFUNIX.value()) {
     Conf.getRuntimeConfigure().setAllowAFUNIX(true);
   }
+  if (Opt.ConfEnableSuperInstructions.value()) {
+    Conf.getRuntimeConfigure().setEnableSuperInstructions(true);
+  }
+  if (Opt.ConfEnableZeroCopyLoad.value()) {
+    Conf.getRuntimeConfigure().setEnableZeroCopyLoad(true);
+  }
+  if (Opt.ConfEnableLazyFunctionBody.value()) {
+    Conf.getRuntimeConfigure().setEnableLazyFunctionBody(true);
+  }
+  if (Opt.ConfEnableTrustedAOT.value()) {
+    Conf.getRuntimeConfigure().setEnableTrustedAOT(true);
+  }
+  if (Opt.ConfEnableMemoryImage.value()) {
+    Conf.getRuntimeConfigure().setEnableMemoryImage(true);
+  }
+  if (Opt.ConfEnableHugePages.value()) {
+    Conf.getRuntimeConfigure().setEnableHugePages(true);
+  }
+  if (Opt.ConfEnableHugePageCode.value()) {
+    Conf.getRuntimeConfigure().setEnableHugePageCode(true);
+  }
+  if (Opt.ConfEnableLazyTable.value()) {
+    Conf.getRuntimeConfigure().setEnableLazyTable(true);
+  }
+  if (Opt.ConfEnableGuardRegion.value()) {
+    Conf.getRuntimeConfigure().setEnableGuardRegion(true);
+  }
+  if (Opt.ConfEnableIoUring.value()) {
+    Conf.getRuntimeConfigure().setEnableIoUring(true);
+  }
+  if (Opt.ConfEnableWasiPathCache.value()) {
+    Conf.getRuntimeConfigure().setEnableWasiPathCache(true);
+  }
+  if (Opt.ConfEnableCodeCache.value()) {
+    Conf.getRuntimeConfigure().setEnableCodeCache(true);
+  }
+  if (Opt.ConfEnableFusedValidation.value()) {
+    Conf.getRuntimeConfigure().setEnableFusedValidation(true);
+  }
+#ifdef WASMEDGE_USE_LLVM
+  AOT::Cache::setMaxSize(Opt.CacheMaxSize.value() << 20);
+#endif
 
   for (const auto &Name : Opt.ForbiddenPlugins.value()) {
     Conf.addForbiddenPlugins(Name);
@@ -400,7 +681,10 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
       std::filesystem::absolute(std::filesystem::u8path(Opt.SoName.value()));
 
   // Create VM and get WASI module instance.
+  std::optional<Trace::Scope> CreateScope(std::in_place, "driver"sv,
+                                          "create VM"sv);
   VM::VM VM(Conf);
+  CreateScope.reset();
   Host::WasiModule *WasiMod = dynamic_cast<Host::WasiModule *>(
       VM.getImportModule(HostRegistration::Wasi));
 
@@ -411,6 +695,74 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
   if (auto Result = VM.validate(); !Result) {
     return EXIT_FAILURE;
   }
+
+  // Fork the worker processes after loading and validating the module once.
+  // Every worker instantiates the module and runs it by itself.
+  if (Opt.Workers.value() > 1) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+    WasiMod->setEnableReusePort(true);
+    if (auto ExitCode = forkWorkers(Opt.Workers.value())) {
+      return *ExitCode;
+    }
+#else
+    spdlog::warn("Worker processes are not supported on this platform"sv);
+#endif
+  }
+
+  // Serve the metrics of this process. Every worker takes its own port.
+  if (const auto Port = Opt.MetricsPort.value(); Port != 0) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+    const auto WorkerPort = Port + WorkerIndex;
+    if (WorkerPort > UINT16_MAX ||
+        !serveMetrics(static_cast<uint16_t>(WorkerPort))) {
+      spdlog::error("Failed to serve the metrics on port {}"sv, WorkerPort);
+      return EXIT_FAILURE;
+    }
+    spdlog::info("Serving the metrics on port {}"sv, WorkerPort);
+#else
+    spdlog::warn("Metrics endpoint is not supported on this platform"sv);
+#endif
+  }
+
+  // Sample the executions from the instantiation, and write the collapsed
+  // stacks when leaving.
+  struct SampleWriter {
+    ~SampleWriter() noexcept {
+      if (Sampler::isActive()) {
+        Sampler::stop();
+        if (Sampler::saveCollapsed(std::filesystem::u8path(Path))) {
+          spdlog::info("{} samples written to {}"sv,
+                       Sampler::getSampleCount(), Path);
+        }
+      }
+    }
+    const std::string &Path;
+  } Sampling{Opt.SampleProfile.value()};
+  if (!Opt.SampleProfile.value().empty() &&
+      !Sampler::start(Opt.SampleFrequency.value())) {
+    spdlog::warn("Sampling profiler is not supported on this platform"sv);
+  }
+
+  // Record or replay the host calls from the instantiation.
+  if (!Opt.RecordHostCalls.value().empty() ||
+      !Opt.ReplayHostCalls.value().empty()) {
+    if (!Opt.RecordHostCalls.value().empty() &&
+        !Opt.ReplayHostCalls.value().empty()) {
+      spdlog::error("Host calls cannot be recorded and replayed together"sv);
+      return EXIT_FAILURE;
+    }
+    const bool IsRecord = !Opt.RecordHostCalls.value().empty();
+    auto Trace = Executor::HostCallTrace::open(
+        std::filesystem::u8path(IsRecord ? Opt.RecordHostCalls.value()
+                                         : Opt.ReplayHostCalls.value()),
+        IsRecord ? Executor::HostCallTrace::Mode::Record
+                 : Executor::HostCallTrace::Mode::Replay);
+    if (!Trace) {
+      return EXIT_FAILURE;
+    }
+    VM.getExecutor().registerHostCallTrace(std::move(Trace));
+  }
+
   if (auto Result = VM.instantiate(); !Result) {
     return EXIT_FAILURE;
   }
@@ -443,16 +795,43 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
   bool EnterCommandMode = !Opt.Reactor.value() && HasValidCommandModStartFunc();
 
   // Initialize WASI module.
-  WasiMod->init(Opt.Dir.value(),
-                InputPath.filename()
-                    .replace_extension(std::filesystem::u8path("wasm"sv))
-                    .u8string(),
-                Opt.Args.value(), Opt.Env.value());
+  {
+    Trace::Scope WasiScope("driver"sv, "WASI init"sv);
+    WasiMod->init(Opt.Dir.value(),
+                  InputPath.filename()
+                      .replace_extension(std::filesystem::u8path("wasm"sv))
+                      .u8string(),
+                  Opt.Args.value(), Opt.Env.value());
+  }
+
+  // Dump the WASI I/O statistics when leaving after the execution.
+  struct IOStatisticsDumper {
+    ~IOStatisticsDumper() noexcept {
+      if (Mod) {
+        Mod->getIOStatistics().dumpToLog();
+      }
+    }
+    const Host::WasiModule *Mod;
+  } Dumper{Conf.getStatisticsConfigure().isIOMeasuring() ? WasiMod : nullptr};
+
+  // Write the execution profile when leaving after the execution.
+  struct ProfileWriter {
+    ~ProfileWriter() noexcept {
+      if (!Path.empty()) {
+        if (Stat.getProfile().save(std::filesystem::u8path(Path))) {
+          spdlog::info("Execution profile written to {}"sv, Path);
+        }
+      }
+    }
+    const Statistics::Statistics &Stat;
+    const std::string &Path;
+  } Writer{VM.getStatistics(), Opt.ProfileGenerate.value()};
 
   if (EnterCommandMode) {
     // command mode
 
     // TODO: COMPONENT - currently not supported.
+    Trace::Scope EntryScope("driver"sv, "entry call"sv, "_start"sv);
     auto AsyncResult = VM.asyncExecute("_start"sv);
     if (Timeout.has_value()) {
       if (!AsyncResult.waitUntil(*Timeout)) {
@@ -497,6 +876,7 @@ int Tool(struct DriverToolOptions &Opt) noexcept {
 
       // If found initialize function, invoke it first.
       if (HasInit) {
+        Trace::Scope InitScope("driver"sv, "entry call"sv, InitFunc);
         auto AsyncResult = VM.asyncExecute(InitFunc);
         if (Timeout.has_value()) {
           if (!AsyncResult.waitUntil(*Timeout)) {
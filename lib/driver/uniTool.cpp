@@ -26,20 +26,21 @@ int UniTool(int Argc, const char *Argv[], const ToolType ToolSelect) noexcept {
       PO::Description("Wasmedge compiler subcommand"sv));
   struct DriverToolOptions ToolOptions;
   struct DriverCompilerOptions CompilerOptions;
+  const Span<const char *const> CommandLine(Argv, static_cast<size_t>(Argc));
 
   // Construct Parser Subcommands and Options
   if (ToolSelect == ToolType::All) {
-    ToolOptions.add_option(Parser);
+    ToolOptions.add_option(Parser, CommandLine);
 
     Parser.begin_subcommand(CompilerSubCommand, "compile"sv);
     CompilerOptions.add_option(Parser);
     Parser.end_subcommand();
 
     Parser.begin_subcommand(ToolSubCommand, "run"sv);
-    ToolOptions.add_option(Parser);
+    ToolOptions.add_option(Parser, CommandLine);
     Parser.end_subcommand();
   } else if (ToolSelect == ToolType::Tool) {
-    ToolOptions.add_option(Parser);
+    ToolOptions.add_option(Parser, CommandLine);
   } else if (ToolSelect == ToolType::Compiler) {
     CompilerOptions.add_option(Parser);
   } else {
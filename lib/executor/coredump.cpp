@@ -3,28 +3,103 @@
 #include "executor/coredump.h"
 #include "ast/section.h"
 #include "common/errcode.h"
+#include "common/threadpool.h"
 #include "common/types.h"
 #include "runtime/stackmgr.h"
 #include "spdlog/spdlog.h"
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std::literals;
 
 namespace WasmEdge {
 namespace Coredump {
+
+namespace {
+/// Granularity of skipping the zero contents of the memory.
+inline constexpr uint64_t kChunkSize = 4096;
+
+bool isZeroChunk(const uint8_t *Data, uint64_t Size) noexcept {
+  for (uint64_t I = 0; I < Size; I += sizeof(uint64_t)) {
+    uint64_t Word;
+    std::memcpy(&Word, Data + I, sizeof(uint64_t));
+    if (Word != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Check and record the time of the coredump of the module. The modules are
+/// keyed by name, so that the instances re-instantiated from the same module
+/// share the limit.
+bool acquireCoredump(std::string_view Name, uint32_t Interval) noexcept {
+  if (Interval == 0) {
+    return true;
+  }
+  static std::mutex Mutex;
+  static std::unordered_map<std::string, std::chrono::steady_clock::time_point>
+      LastTime;
+  const auto Now = std::chrono::steady_clock::now();
+  std::unique_lock Lock(Mutex);
+  auto [Iter, Inserted] = LastTime.try_emplace(std::string(Name), Now);
+  if (!Inserted) {
+    if (Now - Iter->second < std::chrono::seconds(Interval)) {
+      return false;
+    }
+    Iter->second = Now;
+  }
+  return true;
+}
+
+void writeCoredump(const AST::Module &Module) noexcept {
+  const Configure Config;
+  Loader::Serializer Ser(Config);
+  auto Res = Ser.serializeModule(Module);
+  if (!Res) {
+    spdlog::error("Failed to serialize coredump."sv);
+    return;
+  }
+  std::time_t Time = std::time(nullptr);
+  std::string CoredumpPath = "coredump." + std::to_string(Time);
+  std::ofstream File(CoredumpPath, std::ios::out | std::ios::binary);
+  if (!File.is_open()) {
+    spdlog::error("Failed to generate coredump."sv);
+    return;
+  }
+  File.write(reinterpret_cast<const char *>(Res->data()),
+             static_cast<std::streamsize>(Res->size()));
+  File.close();
+  spdlog::info("Coredump generated."sv);
+}
+} // namespace
+
 void generateCoredump(const Runtime::StackManager &StackMgr,
-                      bool ForWasmgdb) noexcept {
+                      const RuntimeConfigure &Conf) noexcept {
+  const auto *CurrentInstance = StackMgr.getModule();
+  if (!acquireCoredump(CurrentInstance->getModuleName(),
+                       Conf.getCoredumpInterval())) {
+    spdlog::info("Coredump skipped by the interval limit."sv);
+    return;
+  }
+  const bool ForWasmgdb = Conf.isCoredumpWasmgdb();
   spdlog::info("Generating coredump..."sv);
   if (ForWasmgdb) {
     spdlog::info("For wasmgdb"sv);
   }
   // Generate coredump.
-  const auto *CurrentInstance = StackMgr.getModule();
   const Configure Config;
   Loader::Serializer Ser(Config);
-  AST::Module Module{};
+  auto ModulePtr = std::make_shared<AST::Module>();
+  AST::Module &Module = *ModulePtr;
   std::vector<Byte> &Magic = Module.getMagic();
   std::string MagicStr("\0asm", 4);
   Magic.insert(Magic.begin(), MagicStr.begin(), MagicStr.end());
@@ -35,9 +110,6 @@ void generateCoredump(const Runtime::StackManager &StackMgr,
   Module.getCustomSections().emplace_back(createCore());
   Module.getCustomSections().emplace_back(createCorestack(
       Ser, StackMgr.getFramesSpan(), StackMgr.getValueSpan(), ForWasmgdb));
-  // TODO: reconstruct data instances
-  // Module.getDataSection() =
-  //     createData(CurrentInstance->getOwnedDataInstances());
   // TODO: pass all module instances
   Module.getCustomSections().emplace_back(
       createCoremodules(Ser, {CurrentInstance}));
@@ -46,26 +118,16 @@ void generateCoredump(const Runtime::StackManager &StackMgr,
       createMemory(CurrentInstance->getMemoryInstances());
   Module.getGlobalSection() =
       createGlobals(CurrentInstance->getGlobalInstances());
-  auto Res = Ser.serializeModule(Module);
-  if (Res.has_value()) {
-    spdlog::info("Coredump generated."sv);
-    std::time_t Time = std::time(nullptr);
-    std::string CoredumpPath = "coredump." + std::to_string(Time);
-    std::ofstream File(CoredumpPath, std::ios::out | std::ios::binary);
-    if (File.is_open()) {
-      File.write(reinterpret_cast<const char *>(Res->data()),
-                 static_cast<uint32_t>(Res->size()));
-      File.close();
-    } else {
-      spdlog::error("Failed to generate coredump."sv);
-      assumingUnreachable();
-    }
+  Module.getDataSection() = createData(CurrentInstance->getMemoryInstances());
+
+  // The contents are copied above, so the trapped thread can go on while the
+  // file is serialized and written.
+  if (Conf.isCoredumpAsync()) {
+    ThreadPool::getDefault().submit(
+        [ModulePtr]() noexcept { writeCoredump(*ModulePtr); });
   } else {
-    spdlog::error("Failed to serialize coredump."sv);
-    assumingUnreachable();
+    writeCoredump(Module);
   }
-
-  return;
 }
 AST::CustomSection createCore() {
   AST::CustomSection Core;
@@ -148,19 +210,40 @@ AST::CustomSection createCorestack(
   return CoreStack;
 }
 
-// AST::DataSection
-// createData(Span<const Runtime::Instance::DataInstance *const> DataInstances)
-// {
-//   AST::DataSection DataSec;
-//   AST::DataSegment Seg;
-//   auto &Content = Seg.getData();
-//   for (auto &Data : DataInstances) {
-//     Content.insert(Content.end(), Data->getData().begin(),
-//                    Data->getData().end());
-//   }
-//   DataSec.getContent().push_back(Seg);
-//   return DataSec;
-// }
+AST::DataSection createData(
+    Span<const Runtime::Instance::MemoryInstance *const> MemoryInstances) {
+  AST::DataSection DataSec;
+  if (MemoryInstances.size() == 0) {
+    return DataSec;
+  }
+  // The memory is zero-initialized, so only the runs of the non-zero chunks
+  // are dumped as the active data segments.
+  const auto *Memory = MemoryInstances[0];
+  const uint8_t *Data = Memory->getDataPtr();
+  const uint64_t Size = static_cast<uint64_t>(Memory->getPageSize()) *
+                        Runtime::Instance::MemoryInstance::kPageSize;
+  uint64_t Offset = 0;
+  while (Offset < Size) {
+    if (isZeroChunk(Data + Offset, kChunkSize)) {
+      Offset += kChunkSize;
+      continue;
+    }
+    uint64_t End = Offset + kChunkSize;
+    while (End < Size && !isZeroChunk(Data + End, kChunkSize)) {
+      End += kChunkSize;
+    }
+    AST::DataSegment &Seg = DataSec.getContent().emplace_back();
+    Seg.setMode(AST::DataSegment::DataMode::Active);
+    Seg.setIdx(0);
+    AST::Instruction Const(OpCode::I32__const);
+    Const.setNum(static_cast<uint32_t>(Offset));
+    Seg.getExpr().getInstrs() = {Const, AST::Instruction(OpCode::End)};
+    Seg.getData().assign(Data + Offset, Data + End);
+    Offset = End;
+  }
+  return DataSec;
+}
+
 AST::GlobalSection createGlobals(
     Span<const Runtime::Instance::GlobalInstance *const> GlobalInstances) {
   AST::GlobalSection Globals;
@@ -13,6 +13,9 @@ Expect<void> Executor::runIfElseOp(Runtime::StackManager &StackMgr,
                                    AST::InstrView::iterator &PC) noexcept {
   // Get condition.
   uint32_t Cond = StackMgr.pop().get<uint32_t>();
+  if (unlikely(Prof)) {
+    Prof->recordBranch(Instr.getOffset(), Cond != 0);
+  }
 
   // If non-zero, run if-statement; else, run else-statement.
   if (Cond == 0) {
@@ -21,8 +24,8 @@ Expect<void> Executor::runIfElseOp(Runtime::StackManager &StackMgr,
       PC += (Instr.getJumpEnd() - 1);
     } else {
       if (Stat) {
-        Stat->incInstrCount();
-        if (unlikely(!Stat->addInstrCost(OpCode::Else))) {
+        if (unlikely(!chargeStatBatch(
+                StackMgr, 1, Stat->getCostTable()[uint16_t(OpCode::Else)]))) {
           return Unexpect(ErrCode::Value::CostLimitExceeded);
         }
       }
@@ -64,7 +67,11 @@ Expect<void> Executor::runBrOp(Runtime::StackManager &StackMgr,
 Expect<void> Executor::runBrIfOp(Runtime::StackManager &StackMgr,
                                  const AST::Instruction &Instr,
                                  AST::InstrView::iterator &PC) noexcept {
-  if (StackMgr.pop().get<uint32_t>() != 0) {
+  const bool IsTaken = StackMgr.pop().get<uint32_t>() != 0;
+  if (unlikely(Prof)) {
+    Prof->recordBranch(Instr.getOffset(), IsTaken);
+  }
+  if (IsTaken) {
     return runBrOp(StackMgr, Instr, PC);
   }
   return {};
@@ -112,29 +119,8 @@ Expect<void> Executor::runBrOnCastOp(Runtime::StackManager &StackMgr,
   // Get value on top of stack.
   const auto *ModInst = StackMgr.getModule();
   const auto &Val = StackMgr.getTop().get<RefVariant>();
-  const auto &VT = Val.getType();
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst = Val.getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  ValType NormalizedVT = VT;
-  if (NormalizedVT.isExternalized()) {
-    // An externalized reference must appear as an 'externref' to the matcher.
-    // We preserve the nullability (Ref vs RefNull).
-    NormalizedVT =
-        ValType(VT.isNullableRefType() ? TypeCode::RefNull : TypeCode::Ref,
-                TypeCode::ExternRef);
-  }
-
-  bool MatchResult = AST::TypeMatcher::matchType(ModInst->getTypeList(),
-                                                 Instr.getBrCast().RType2,
-                                                 GotTypeList, NormalizedVT);
+  const bool MatchResult =
+      matchRefType(*ModInst, Instr.getBrCast().RType2, Val);
   if (MatchResult != IsReverse) {
     return branchToLabel(StackMgr, Instr.getBrCast().Jump, PC);
   }
@@ -143,8 +129,8 @@ Expect<void> Executor::runBrOnCastOp(Runtime::StackManager &StackMgr,
 
 Expect<void> Executor::runReturnOp(Runtime::StackManager &StackMgr,
                                    AST::InstrView::iterator &PC) noexcept {
-  // Check stop token
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  // Check stop token and epoch deadline
+  if (isInterrupted()) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
@@ -178,8 +164,29 @@ Expect<void> Executor::runCallRefOp(Runtime::StackManager &StackMgr,
 
   // Get Function address.
   const auto *FuncInst = retrieveFuncRef(Ref);
+
+  // Fast path: the same native wasm function as the last call of this
+  // instruction, which is already materialized. The tiered JIT mode may
+  // replace it by the compiled entry, so it always goes the slow path.
+  const auto *ModInst = StackMgr.getModule();
+  assuming(ModInst);
+  auto &Entry = StackMgr.getCallRefEntry(&Instr);
+  if (likely(Entry.Func == FuncInst && Entry.Site == &Instr &&
+             Entry.ModuleId == ModInst->getId() && !TierUpThreshold)) {
+    if (isInterrupted()) {
+      spdlog::error(ErrCode::Value::Interrupted);
+      return Unexpect(ErrCode::Value::Interrupted);
+    }
+    PC = enterWasmFunction(StackMgr, *FuncInst, PC + 1, IsTailCall) - 1;
+    return {};
+  }
+
+  const uint64_t ModuleId = ModInst->getId();
   EXPECTED_TRY(auto NextPC,
                enterFunction(StackMgr, *FuncInst, PC + 1, IsTailCall));
+  if (FuncInst->isWasmFunction()) {
+    Entry = {&Instr, ModuleId, FuncInst};
+  }
   PC = NextPC - 1;
   return {};
 }
@@ -191,9 +198,7 @@ Expect<void> Executor::runCallIndirectOp(Runtime::StackManager &StackMgr,
   // Get Table Instance
   const auto *TabInst = getTabInstByIdx(StackMgr, Instr.getSourceIndex());
 
-  // Get function type at index x.
   const auto *ModInst = StackMgr.getModule();
-  const auto &ExpDefType = **ModInst->getType(Instr.getTargetIndex());
 
   // Pop the value i32.const i from the Stack.
   uint32_t Idx = StackMgr.pop().get<uint32_t>();
@@ -207,57 +212,143 @@ Expect<void> Executor::runCallIndirectOp(Runtime::StackManager &StackMgr,
     return Unexpect(ErrCode::Value::UndefinedElement);
   }
 
-  // Get function address. The bound is guaranteed.
-  RefVariant Ref = *TabInst->getRefAddr(Idx);
-  if (Ref.isNull()) {
-    spdlog::error(ErrCode::Value::UninitializedElement);
-    spdlog::error(ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset(),
-                                           {Idx},
-                                           {ValTypeFromType<uint32_t>()}));
-    return Unexpect(ErrCode::Value::UninitializedElement);
-  }
-
-  // Check function type.
-  const auto *FuncInst = retrieveFuncRef(Ref);
-  bool IsMatch = false;
-  if (FuncInst->getModule()) {
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), *ExpDefType.getTypeIndex(),
-        FuncInst->getModule()->getTypeList(), FuncInst->getTypeIndex());
-  } else {
-    // Independent host module instance case. Matching the composite type
-    // directly.
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), ExpDefType.getCompositeType(),
-        FuncInst->getHostFunc().getDefinedType().getCompositeType());
-  }
-  if (!IsMatch) {
-    auto &ExpFuncType = ExpDefType.getCompositeType().getFuncType();
-    auto &GotFuncType = FuncInst->getFuncType();
-    spdlog::error(ErrCode::Value::IndirectCallTypeMismatch);
+  // Get the function and check its type.
+  auto Res = getIndirectCallFunc(StackMgr, *TabInst, Instr.getTargetIndex(),
+                                 Idx);
+  if (unlikely(!Res)) {
+    spdlog::error(Res.error());
     spdlog::error(ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset(),
                                            {Idx},
                                            {ValTypeFromType<uint32_t>()}));
-    spdlog::error(ErrInfo::InfoMismatch(
-        ExpFuncType.getParamTypes(), ExpFuncType.getReturnTypes(),
-        GotFuncType.getParamTypes(), GotFuncType.getReturnTypes()));
-    return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
+    if (Res.error() == ErrCode::Value::IndirectCallTypeMismatch) {
+      const auto &ExpDefType = **ModInst->getType(Instr.getTargetIndex());
+      auto &ExpFuncType = ExpDefType.getCompositeType().getFuncType();
+      auto &GotFuncType =
+          retrieveFuncRef(*TabInst->getRefAddr(Idx))->getFuncType();
+      spdlog::error(ErrInfo::InfoMismatch(
+          ExpFuncType.getParamTypes(), ExpFuncType.getReturnTypes(),
+          GotFuncType.getParamTypes(), GotFuncType.getReturnTypes()));
+    }
+    return Unexpect(Res);
   }
+  const auto *FuncInst = *Res;
 
   // Enter the function.
   EXPECTED_TRY(auto NextPC,
                enterFunction(StackMgr, *FuncInst, PC + 1, IsTailCall));
+  // Only the targets in the same module can be promoted to direct calls.
+  if (unlikely(Prof) && FuncInst->getModule() == ModInst &&
+      !FuncInst->getInstrs().empty()) {
+    Prof->recordIndirectCall(Instr.getOffset(),
+                             FuncInst->getInstrs().begin()->getOffset());
+  }
   PC = NextPC - 1;
   return {};
 }
 
-Expect<void> Executor::runTryTableOp(Runtime::StackManager &StackMgr,
-                                     const AST::Instruction &Instr,
-                                     AST::InstrView::iterator &PC) noexcept {
-  const auto &TryDesc = Instr.getTryCatch();
-  StackMgr.pushHandler(PC, TryDesc.BlockParamNum, TryDesc.Catch);
+Expect<void> Executor::runContNewOp(Runtime::StackManager &StackMgr,
+                                    const AST::Instruction &Instr) noexcept {
+  collectGarbage(StackMgr);
+  const auto Ref = StackMgr.pop().get<RefVariant>();
+  if (Ref.isNull()) {
+    spdlog::error(ErrCode::Value::AccessNullFunc);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::AccessNullFunc);
+  }
+  // The stacks of the continuation are allocated here as configured, and its
+  // fiber is created at the first resumption.
+  EXPECTED_TRY(auto ContRef,
+               contNew(*StackMgr.getModule(), Instr.getTargetIndex(),
+                       std::make_unique<ContState>(
+                           *retrieveFuncRef(Ref),
+                           Conf.getRuntimeConfigure().getValueStackSize()),
+                       Instr));
+  StackMgr.push(ContRef);
   return {};
 }
 
+Expect<void> Executor::runContBindOp(Runtime::StackManager &StackMgr,
+                                     const AST::Instruction &Instr) noexcept {
+  collectGarbage(StackMgr);
+  const auto Ref = StackMgr.pop().get<RefVariant>();
+  EXPECTED_TRY(auto State, takeContState(Ref, Instr));
+  // The bound arguments are passed before the ones of the resumption.
+  const auto *ModInst = StackMgr.getModule();
+  const auto N = static_cast<uint32_t>(
+      getContFuncTypeByIdx(StackMgr, Instr.getTargetIndex())
+          .getParamTypes()
+          .size() -
+      getContFuncTypeByIdx(StackMgr, Instr.getSourceIndex())
+          .getParamTypes()
+          .size());
+  {
+    const auto Args = StackMgr.pop(N);
+    State->Values.insert(State->Values.end(), Args.begin(), Args.end());
+  }
+  EXPECTED_TRY(auto ContRef, contNew(*ModInst, Instr.getSourceIndex(),
+                                     std::move(State), Instr));
+  if (unlikely(!StackMgr.hasValueRoom(1))) {
+    spdlog::error(ErrCode::Value::StackOverflow);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::StackOverflow);
+  }
+  StackMgr.push(ContRef);
+  return {};
+}
+
+Expect<void> Executor::runSuspendOp(Runtime::StackManager &StackMgr,
+                                    const AST::Instruction &Instr,
+                                    AST::InstrView::iterator &PC) noexcept {
+  auto *TagInst = getTagInstByIdx(StackMgr, Instr.getTargetIndex());
+  auto Args = StackMgr.pop(TagInst->getTagType().getAssocValSize());
+  return suspendContinuation(StackMgr, *TagInst, std::move(Args), nullptr, 0,
+                             Instr, PC);
+}
+
+Expect<void> Executor::runResumeOp(Runtime::StackManager &StackMgr,
+                                   const AST::Instruction &Instr,
+                                   AST::InstrView::iterator &PC) noexcept {
+  const auto &Desc = Instr.getResume();
+  const auto Ref = StackMgr.pop().get<RefVariant>();
+  EXPECTED_TRY(auto State, takeContState(Ref, Instr));
+  if (Instr.getOpCode() == OpCode::Resume_throw) {
+    auto *TagInst = getTagInstByIdx(StackMgr, Desc.TagIndex);
+    if (State->Func) {
+      // The continuation is not started, and is dropped before the exception
+      // is thrown here with the values on the stack.
+      State.reset();
+      return throwException(StackMgr, *TagInst, PC);
+    }
+    State->ThrowTag = TagInst;
+    State->Values = StackMgr.pop(TagInst->getTagType().getAssocValSize());
+  } else {
+    const auto Args = StackMgr.pop(static_cast<uint32_t>(
+        getContFuncTypeByIdx(StackMgr, Desc.ContTypeIndex)
+            .getParamTypes()
+            .size()));
+    State->ThrowTag = nullptr;
+    State->Values.insert(State->Values.end(), Args.begin(), Args.end());
+  }
+  return resumeContinuation(StackMgr, std::move(State), Instr, PC);
+}
+
+Expect<void> Executor::runSwitchOp(Runtime::StackManager &StackMgr,
+                                   const AST::Instruction &Instr,
+                                   AST::InstrView::iterator &PC) noexcept {
+  const auto Ref = StackMgr.pop().get<RefVariant>();
+  EXPECTED_TRY(auto Target, takeContState(Ref, Instr));
+  // The last parameter of the target is the switching continuation.
+  const auto &Params =
+      getContFuncTypeByIdx(StackMgr, Instr.getTargetIndex()).getParamTypes();
+  auto *TagInst = getTagInstByIdx(StackMgr, Instr.getSourceIndex());
+  return suspendContinuation(StackMgr, *TagInst,
+                             StackMgr.pop(static_cast<uint32_t>(
+                                 Params.size() - 1)),
+                             std::move(Target), Params.back().getTypeIndex(),
+                             Instr, PC);
+}
+
 } // namespace Executor
 } // namespace WasmEdge
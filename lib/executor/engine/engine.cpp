@@ -2,19 +2,172 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
 #include "common/endian.h"
+#include "common/metrics.h"
 #include "executor/coredump.h"
+#include "executor/engine/vector_helper.h"
 #include "executor/executor.h"
+#include "experimental/scope.hpp"
+#include "system/fault.h"
+#include "system/numa.h"
+#include "system/sampler.h"
 #include "system/stacktrace.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <string>
+#include <type_traits>
 
 using namespace std::literals;
 
+// The threaded dispatch relies on the labels-as-values extension and on forcing
+// the handlers to be inlined into every label.
+#if defined(WASMEDGE_INTERPRETER_THREADED_DISPATCH) && !defined(__GNUC__)
+#undef WASMEDGE_INTERPRETER_THREADED_DISPATCH
+#endif
+#if defined(WASMEDGE_INTERPRETER_THREADED_DISPATCH)
+#define WASMEDGE_DISPATCH_INLINE __attribute__((always_inline))
+#else
+#define WASMEDGE_DISPATCH_INLINE
+#endif
+
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Name of the function in the statistics: the export name or the index,
+/// prefixed by the module name if any.
+std::string
+getFunctionName(const Runtime::Instance::FunctionInstance &Func) noexcept {
+  const auto *ModInst = Func.getModule();
+  if (!ModInst) {
+    return "[unknown]"s;
+  }
+  std::string Name = ModInst->getFuncExports([&](const auto &Exports) {
+    for (const auto &[ExportName, ExportFunc] : Exports) {
+      if (ExportFunc == &Func) {
+        return std::string(ExportName);
+      }
+    }
+    return std::string();
+  });
+  if (Name.empty()) {
+    const auto FuncInsts = ModInst->getFunctionInstances();
+    const auto It = std::find(FuncInsts.begin(), FuncInsts.end(), &Func);
+    Name = fmt::format("func[{}]"sv, It - FuncInsts.begin());
+  }
+  if (const auto ModName = ModInst->getModuleName(); !ModName.empty()) {
+    Name = fmt::format("{}::{}"sv, ModName, Name);
+  }
+  return Name;
+}
+
+/// Byte size of the value of the number type in the batch columns.
+uint32_t getColumnWidth(const ValType &Type) noexcept {
+  switch (Type.getCode()) {
+  case TypeCode::I32:
+  case TypeCode::F32:
+    return 4;
+  case TypeCode::I64:
+  case TypeCode::F64:
+    return 8;
+  default:
+    return 16;
+  }
+}
+
+/// Load the value of the row from the batch column.
+ValVariant loadColumn(const ValType &Type, const void *Column,
+                      uint32_t Row) noexcept {
+  const auto *Ptr =
+      static_cast<const uint8_t *>(Column) + Row * getColumnWidth(Type);
+  switch (Type.getCode()) {
+  case TypeCode::I32:
+  case TypeCode::F32: {
+    uint32_t V;
+    std::memcpy(&V, Ptr, sizeof(V));
+    return V;
+  }
+  case TypeCode::I64:
+  case TypeCode::F64: {
+    uint64_t V;
+    std::memcpy(&V, Ptr, sizeof(V));
+    return V;
+  }
+  default: {
+    uint128_t V;
+    std::memcpy(&V, Ptr, sizeof(V));
+    return V;
+  }
+  }
+}
+
+/// Store the value of the row into the batch column.
+void storeColumn(const ValType &Type, void *Column, uint32_t Row,
+                 const ValVariant &Val) noexcept {
+  auto *Ptr = static_cast<uint8_t *>(Column) + Row * getColumnWidth(Type);
+  switch (Type.getCode()) {
+  case TypeCode::I32:
+  case TypeCode::F32: {
+    const uint32_t V = Val.get<uint32_t>();
+    std::memcpy(Ptr, &V, sizeof(V));
+    break;
+  }
+  case TypeCode::I64:
+  case TypeCode::F64: {
+    const uint64_t V = Val.get<uint64_t>();
+    std::memcpy(Ptr, &V, sizeof(V));
+    break;
+  }
+  default: {
+    const uint128_t V = Val.get<uint128_t>();
+    std::memcpy(Ptr, &V, sizeof(V));
+    break;
+  }
+  }
+}
+
+/// Pin the calling thread on the CPUs of the NUMA node, once until the thread
+/// executes for another node.
+void bindThreadNumaNode(int32_t Node) noexcept {
+  thread_local int32_t BoundNode = -1;
+  if (BoundNode != Node) {
+    Numa::bindThread(static_cast<uint32_t>(Node));
+    BoundNode = Node;
+  }
+}
+
+/// Counters at the start of an execution, for recording it in the metrics.
+struct InvocationStart {
+  std::chrono::steady_clock::time_point Time;
+  std::chrono::nanoseconds HostTime;
+  uint64_t InstrCount;
+  uint64_t Cost;
+};
+
+/// Record the finished execution of the function in the metrics.
+void recordInvocation(const Runtime::Instance::FunctionInstance &Func,
+                      const InvocationStart &Start,
+                      const Statistics::Statistics *Stat,
+                      const Expect<void> &Res) noexcept {
+  const auto *ModInst = Func.getModule();
+  uint64_t Pages = 0;
+  if (ModInst) {
+    for (const auto *MemInst : ModInst->getMemoryInstances()) {
+      Pages += MemInst->getPageSize();
+    }
+  }
+  Metrics::recordInvocation(
+      {ModInst ? ModInst->getModuleName() : ""sv,
+       std::chrono::steady_clock::now() - Start.Time,
+       Metrics::getThreadHostTime() - Start.HostTime,
+       Stat ? Stat->getInstrCount() - Start.InstrCount : 0,
+       Stat ? Stat->getTotalCost() - Start.Cost : 0, Pages,
+       Res ? ErrCode(ErrCode::Value::Success) : Res.error()});
+}
+} // namespace
+
 Expect<void> Executor::runExpression(Runtime::StackManager &StackMgr,
                                      AST::InstrView Instrs) {
   return execute(StackMgr, Instrs.begin(), Instrs.end());
@@ -24,6 +177,36 @@ Expect<void>
 Executor::runFunction(Runtime::StackManager &StackMgr,
                       const Runtime::Instance::FunctionInstance &Func,
                       Span<const ValVariant> Params) {
+  // Keep the executing thread on the NUMA node of the memories.
+  if (const auto Node = Conf.getRuntimeConfigure().getNumaNode(); Node >= 0) {
+    bindThreadNumaNode(Node);
+  }
+
+  // The threads created before enabling the striped memories have no rights
+  // of their protection keys.
+  const uint32_t SavedRights = Allocator::allowProtectionKeys();
+  cxx20::scope_exit RestoreRights([SavedRights]() noexcept {
+    Allocator::restoreProtectionKeys(SavedRights);
+  });
+
+  // Sample the execution on this thread if the sampler is started.
+  Sampler::Scope SamplerScope(StackMgr);
+  ActiveStackScope StackScope(StackMgr);
+
+  // Charge the CPU time to the entered module instance.
+  std::optional<CpuTimeScope> CpuScope;
+  if (unlikely(CpuAccounting) && Func.getModule()) {
+    CpuScope.emplace(Func.getModule());
+  }
+
+  // Record the execution in the metrics if enabled.
+  std::optional<InvocationStart> MetricsStart;
+  if (Metrics::isEnabled()) {
+    MetricsStart.emplace(InvocationStart{
+        std::chrono::steady_clock::now(), Metrics::getThreadHostTime(),
+        Stat ? Stat->getInstrCount() : 0, Stat ? Stat->getTotalCost() : 0});
+  }
+
   // Set start time.
   if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
     Stat->startRecordWasm();
@@ -47,14 +230,21 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
     }
   }
 
-  // Enter and execute function.
+  // Enter and execute function. The deferred body in the lazy loading mode
+  // should be materialized before getting the instructions.
   Expect<void> Res =
-      enterFunction(StackMgr, Func, Func.getInstrs().end())
+      Func.materialize()
+          .and_then([&]() {
+            return enterFunction(StackMgr, Func, Func.getInstrs().end());
+          })
           .and_then([&](AST::InstrView::iterator StartIt) {
             // If not terminated, execute the instructions in interpreter mode.
             // For the entering AOT or host functions, the `StartIt` is equal to
             // the end of instruction list, therefore the execution will return
             // immediately.
+            if (StackMgr.isFixedValueStack() || GuardRegion) {
+              return executeGuarded(StackMgr, StartIt, Func.getInstrs().end());
+            }
             return execute(StackMgr, StartIt, Func.getInstrs().end());
           });
 
@@ -68,10 +258,24 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
     Stat->stopRecordWasm();
   }
 
+  // Merge the function counters of this execution.
+  if (Stat && Conf.getStatisticsConfigure().isFunctionProfiling()) {
+    for (const auto &[F, Counter] : StackMgr.takeFunctionCounters()) {
+      if (F) {
+        Stat->addFunctionRecord(F, Counter.Calls, Counter.Instrs,
+                                Counter.SelfTime,
+                                [F = F]() { return getFunctionName(*F); });
+      }
+    }
+  }
+
   // If Statistics is enabled, then dump it here.
   if (Stat) {
     Stat->dumpToLog(Conf);
   }
+  if (MetricsStart) {
+    recordInvocation(Func, *MetricsStart, Stat, Res);
+  }
 
   if (!Res && likely(Res.error() == ErrCode::Value::Terminated)) {
     StackMgr.reset();
@@ -80,15 +284,108 @@ Executor::runFunction(Runtime::StackManager &StackMgr,
   return Res;
 }
 
+Expect<void>
+Executor::runBatch(Runtime::StackManager &StackMgr,
+                   const Runtime::Instance::FunctionInstance &Func,
+                   Span<const void *const> Params, Span<void *const> Returns,
+                   uint32_t Begin, uint32_t End,
+                   const std::atomic<bool> &Cancelled) {
+  Sampler::Scope SamplerScope(StackMgr);
+  EXPECTED_TRY(Func.materialize());
+
+  // Resolve everything once, and only move the values of every row between
+  // the columns and the stack.
+  const auto &PTypes = Func.getFuncType().getParamTypes();
+  const auto &RTypes = Func.getFuncType().getReturnTypes();
+  const auto InstrEnd = Func.getInstrs().end();
+  const bool Guarded = StackMgr.isFixedValueStack() || GuardRegion;
+  Expect<void> Res;
+  for (uint32_t Row = Begin; Row < End; ++Row) {
+    if (unlikely(Cancelled.load(std::memory_order_relaxed))) {
+      break;
+    }
+    StackMgr.reset();
+    StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
+    for (uint32_t I = 0; I < PTypes.size(); ++I) {
+      StackMgr.push(loadColumn(PTypes[I], Params[I], Row));
+    }
+    Res = enterFunction(StackMgr, Func, InstrEnd)
+              .and_then([&](AST::InstrView::iterator StartIt) {
+                if (Guarded) {
+                  return executeGuarded(StackMgr, StartIt, InstrEnd);
+                }
+                return execute(StackMgr, StartIt, InstrEnd);
+              });
+    if (unlikely(!Res)) {
+      break;
+    }
+    for (uint32_t I = static_cast<uint32_t>(RTypes.size()); I-- > 0;) {
+      storeColumn(RTypes[I], Returns[I], Row, StackMgr.pop());
+    }
+  }
+  StackMgr.reset();
+
+  // Merge the function counters of this batch.
+  if (Stat && Conf.getStatisticsConfigure().isFunctionProfiling()) {
+    for (const auto &[F, Counter] : StackMgr.takeFunctionCounters()) {
+      if (F) {
+        Stat->addFunctionRecord(F, Counter.Calls, Counter.Instrs,
+                                Counter.SelfTime,
+                                [F = F]() { return getFunctionName(*F); });
+      }
+    }
+  }
+  return Res;
+}
+
+Expect<void> Executor::executeGuarded(Runtime::StackManager &StackMgr,
+                                      const AST::InstrView::iterator Start,
+                                      const AST::InstrView::iterator End) {
+  // The fault jumps back over the frames of `executeInstrs` and of the
+  // instructions, so none of them may hold an object with a non-trivial
+  // destructor when accessing the guard regions. The instructions which do
+  // check the room of the value stack instead.
+  Fault FaultHandler;
+  if (uint32_t Code = PREPARE_FAULT(FaultHandler); Code != 0) {
+    ErrCode Err(static_cast<ErrCategory>(Code >> 24), Code);
+    if (StackMgr.isValueStackExhausted()) {
+      Err = ErrCode::Value::StackOverflow;
+    }
+    if (Stat) {
+      flushStatBatch(StackMgr);
+    }
+    spdlog::error(Err);
+    StackTraceSize = interpreterStackTrace(StackMgr, StackTrace).size();
+    return Unexpect(Err);
+  }
+  auto Res = executeInstrs(StackMgr, Start, End);
+  if (Stat) {
+    flushStatBatch(StackMgr);
+  }
+  return Res;
+}
+
 Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
                                const AST::InstrView::iterator Start,
                                const AST::InstrView::iterator End) {
+  cxx20::scope_exit FlushStats([this, &StackMgr]() noexcept {
+    if (Stat) {
+      flushStatBatch(StackMgr);
+    }
+  });
+  return executeInstrs(StackMgr, Start, End);
+}
+
+Expect<void> Executor::executeInstrs(Runtime::StackManager &StackMgr,
+                                     const AST::InstrView::iterator Start,
+                                     const AST::InstrView::iterator End) {
   AST::InstrView::iterator PC = Start;
   AST::InstrView::iterator PCEnd = End;
 
-  auto Dispatch = [this, &PC, &StackMgr]() -> Expect<void> {
+  auto Dispatch = [this, &PC, &StackMgr](const OpCode Code)
+                      WASMEDGE_DISPATCH_INLINE -> Expect<void> {
     const AST::Instruction &Instr = *PC;
-    switch (Instr.getOpCode()) {
+    switch (Code) {
     // Control instructions
     case OpCode::Unreachable:
       spdlog::error(ErrCode::Value::Unreachable);
@@ -106,13 +403,16 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::Else:
       if (Stat && Conf.getStatisticsConfigure().isCostMeasuring()) {
         // Reach here means end of if-statement.
-        if (unlikely(!Stat->subInstrCost(Instr.getOpCode()))) {
+        const auto CostTab = Stat->getCostTable();
+        if (unlikely(!refundStatBatch(StackMgr,
+                                      CostTab[uint16_t(Instr.getOpCode())]))) {
           spdlog::error(ErrCode::Value::CostLimitExceeded);
           spdlog::error(
               ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
           return Unexpect(ErrCode::Value::CostLimitExceeded);
         }
-        if (unlikely(!Stat->addInstrCost(OpCode::End))) {
+        if (unlikely(!chargeStatBatch(StackMgr, 0,
+                                      CostTab[uint16_t(OpCode::End)]))) {
           spdlog::error(ErrCode::Value::CostLimitExceeded);
           spdlog::error(
               ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
@@ -122,7 +422,7 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
       PC += PC->getJumpEnd() - 1;
       return {};
     case OpCode::End:
-      PC = StackMgr.maybePopFrameOrHandler(PC);
+      PC = StackMgr.maybePopFrame(PC);
       return {};
     case OpCode::Throw:
       return runThrowOp(StackMgr, Instr, PC);
@@ -157,7 +457,21 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::Return_call_ref:
       return runCallRefOp(StackMgr, Instr, PC, true);
     case OpCode::Try_table:
-      return runTryTableOp(StackMgr, Instr, PC);
+      // The handlers are looked up only when throwing.
+      return {};
+
+    // Stack Switching Instructions
+    case OpCode::Cont__new:
+      return runContNewOp(StackMgr, Instr);
+    case OpCode::Cont__bind:
+      return runContBindOp(StackMgr, Instr);
+    case OpCode::Suspend:
+      return runSuspendOp(StackMgr, Instr, PC);
+    case OpCode::Resume:
+    case OpCode::Resume_throw:
+      return runResumeOp(StackMgr, Instr, PC);
+    case OpCode::Switch:
+      return runSwitchOp(StackMgr, Instr, PC);
 
     // Reference Instructions
     case OpCode::Ref__null:
@@ -271,15 +585,24 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
 
     // Variable Instructions
     case OpCode::Local__get:
-      return runLocalGetOp(StackMgr, Instr.getStackOffset());
+      if (Instr.getSuperInstr() != AST::Instruction::SuperInstr::None &&
+          !Stat) {
+        return runSuperInstrOp(StackMgr, Instr, PC);
+      }
+      return runLocalGetOp(StackMgr, Instr.getStackOffset(),
+                           Instr.getValueSize());
     case OpCode::Local__set:
-      return runLocalSetOp(StackMgr, Instr.getStackOffset());
+      return runLocalSetOp(StackMgr, Instr.getStackOffset(),
+                           Instr.getValueSize());
     case OpCode::Local__tee:
-      return runLocalTeeOp(StackMgr, Instr.getStackOffset());
+      return runLocalTeeOp(StackMgr, Instr.getStackOffset(),
+                           Instr.getValueSize());
     case OpCode::Global__get:
-      return runGlobalGetOp(StackMgr, Instr.getTargetIndex());
+      return runGlobalGetOp(StackMgr, Instr.getTargetIndex(),
+                            Instr.getValueSize());
     case OpCode::Global__set:
-      return runGlobalSetOp(StackMgr, Instr.getTargetIndex());
+      return runGlobalSetOp(StackMgr, Instr.getTargetIndex(),
+                            Instr.getValueSize());
 
     // Table Instructions
     case OpCode::Table__get:
@@ -913,6 +1236,10 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::I8x16__shuffle: {
       ValVariant Val2 = StackMgr.pop();
       ValVariant &Val1 = StackMgr.getTop();
+      if (detail::vectorShuffle(Val1.get<uint8x16_t>(), Val2.get<uint8x16_t>(),
+                                Instr.getNum().get<uint8x16_t>())) {
+        return {};
+      }
       std::array<uint8_t, 32> Data;
       std::array<uint8_t, 16> Result;
       std::memcpy(&Data[0], &Val1, 16);
@@ -1007,6 +1334,10 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::I8x16__swizzle: {
       const ValVariant Val2 = StackMgr.pop();
       ValVariant &Val1 = StackMgr.getTop();
+      if (detail::vectorSwizzle(Val1.get<uint8x16_t>(),
+                                Val2.get<uint8x16_t>())) {
+        return {};
+      }
       uint8x16_t Index = Val2.get<uint8x16_t>();
       if constexpr (Endian::native == Endian::big) {
         Index = 15 - Index;
@@ -1739,6 +2070,10 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
 
       auto &V2 = Val2.get<int16x8_t>();
       auto &V1 = Val1.get<int16x8_t>();
+      if (int32x4_t Result; detail::vectorDot(Result, V1, V2)) {
+        Val1.emplace<int32x4_t>(Result);
+        return {};
+      }
       const auto M = __builtin_convertvector(V1, int32x8_t) *
                      __builtin_convertvector(V2, int32x8_t);
       const int32x4_t L = {M[0], M[2], M[4], M[6]};
@@ -1769,6 +2104,10 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::I8x16__relaxed_swizzle: {
       const ValVariant Val2 = StackMgr.pop();
       ValVariant &Val1 = StackMgr.getTop();
+      if (detail::vectorRelaxedSwizzle(Val1.get<uint8x16_t>(),
+                                       Val2.get<uint8x16_t>())) {
+        return {};
+      }
       uint8x16_t Index = Val2.get<uint8x16_t>();
       if constexpr (Endian::native == Endian::big) {
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -1801,12 +2140,22 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::F32x4__relaxed_madd: {
       const ValVariant Val3 = StackMgr.pop();
       const ValVariant Val2 = StackMgr.pop();
+      if (detail::vectorRelaxedMAdd(StackMgr.getTop().get<floatx4_t>(),
+                                    Val2.get<floatx4_t>(),
+                                    Val3.get<floatx4_t>(), false)) {
+        return {};
+      }
       runVectorMulOp<float>(StackMgr.getTop(), Val2);
       return runVectorAddOp<float>(StackMgr.getTop(), Val3);
     }
     case OpCode::F32x4__relaxed_nmadd: {
       const ValVariant Val3 = StackMgr.pop();
       const ValVariant Val2 = StackMgr.pop();
+      if (detail::vectorRelaxedMAdd(StackMgr.getTop().get<floatx4_t>(),
+                                    Val2.get<floatx4_t>(),
+                                    Val3.get<floatx4_t>(), true)) {
+        return {};
+      }
       runVectorNegOp<float>(StackMgr.getTop());
       runVectorMulOp<float>(StackMgr.getTop(), Val2);
       return runVectorAddOp<float>(StackMgr.getTop(), Val3);
@@ -1814,12 +2163,22 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     case OpCode::F64x2__relaxed_madd: {
       const ValVariant Val3 = StackMgr.pop();
       const ValVariant Val2 = StackMgr.pop();
+      if (detail::vectorRelaxedMAdd(StackMgr.getTop().get<doublex2_t>(),
+                                    Val2.get<doublex2_t>(),
+                                    Val3.get<doublex2_t>(), false)) {
+        return {};
+      }
       runVectorMulOp<double>(StackMgr.getTop(), Val2);
       return runVectorAddOp<double>(StackMgr.getTop(), Val3);
     }
     case OpCode::F64x2__relaxed_nmadd: {
       const ValVariant Val3 = StackMgr.pop();
       const ValVariant Val2 = StackMgr.pop();
+      if (detail::vectorRelaxedMAdd(StackMgr.getTop().get<doublex2_t>(),
+                                    Val2.get<doublex2_t>(),
+                                    Val3.get<doublex2_t>(), true)) {
+        return {};
+      }
       runVectorMulOp<double>(StackMgr.getTop(), Val2);
       runVectorNegOp<double>(StackMgr.getTop());
       return runVectorAddOp<double>(StackMgr.getTop(), Val3);
@@ -2085,34 +2444,106 @@ Expect<void> Executor::execute(Runtime::StackManager &StackMgr,
     }
   };
 
-  while (PC != PCEnd) {
+  // The statistics flags are read once per execution, and the instructions
+  // are charged to the batch of the stack instead of the shared counters.
+  const uint64_t InstrCountStep =
+      Stat && Conf.getStatisticsConfigure().isInstructionCounting() ? 1 : 0;
+  const bool IsProfiling =
+      Stat && Conf.getStatisticsConfigure().isFunctionProfiling();
+  const uint64_t *CostTab =
+      Stat && Conf.getStatisticsConfigure().isCostMeasuring()
+          ? Stat->getCostTable().data()
+          : nullptr;
+
+  auto Account = [this, &PC, &StackMgr, InstrCountStep, IsProfiling,
+                  CostTab]() WASMEDGE_DISPATCH_INLINE -> Expect<void> {
     if (Stat) {
       OpCode Code = PC->getOpCode();
-      if (Conf.getStatisticsConfigure().isInstructionCounting()) {
-        Stat->incInstrCount();
+      if (IsProfiling) {
+        StackMgr.countInstr();
       }
       // Add cost. Note: if-else case should be processed additionally.
-      if (Conf.getStatisticsConfigure().isCostMeasuring()) {
-        if (unlikely(!Stat->addInstrCost(Code))) {
-          const AST::Instruction &Instr = *PC;
-          spdlog::error(
-              ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-          return Unexpect(ErrCode::Value::CostLimitExceeded);
-        }
+      const uint64_t Cost = CostTab ? CostTab[uint16_t(Code)] : 0;
+      if (unlikely(!chargeStatBatch(StackMgr, InstrCountStep, Cost))) {
+        const AST::Instruction &Instr = *PC;
+        spdlog::error(
+            ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+        return Unexpect(ErrCode::Value::CostLimitExceeded);
       }
     }
-    EXPECTED_TRY(Dispatch().map_error([this, &StackMgr](auto E) {
-      StackTraceSize = interpreterStackTrace(StackMgr, StackTrace).size();
-      if (Conf.getRuntimeConfigure().isEnableCoredump() &&
-          E.getErrCodePhase() == WasmPhase::Execution) {
-        Coredump::generateCoredump(
-            StackMgr, Conf.getRuntimeConfigure().isCoredumpWasmgdb());
-      }
-      return E;
-    }));
+    return {};
+  };
+
+  auto OnError = [this, &StackMgr](auto E) {
+    StackTraceSize = interpreterStackTrace(StackMgr, StackTrace).size();
+    if (Conf.getRuntimeConfigure().isEnableCoredump() &&
+        E.getErrCodePhase() == WasmPhase::Execution) {
+      Coredump::generateCoredump(StackMgr, Conf.getRuntimeConfigure());
+    }
+    return E;
+  };
+
+  // The guarded execution jumps over this frame on the faults.
+  static_assert(std::is_trivially_destructible_v<Expect<void>>);
+  static_assert(std::is_trivially_destructible_v<decltype(Dispatch)>);
+  static_assert(std::is_trivially_destructible_v<decltype(Account)>);
+  static_assert(std::is_trivially_destructible_v<decltype(OnError)>);
+
+#if defined(WASMEDGE_INTERPRETER_THREADED_DISPATCH)
+  // Direct-threaded dispatch. Every opcode owns a label which inlines its
+  // handler from the switch above with a constant opcode and ends with its own
+  // indirect jump to the next handler. The opcode enumeration is dense, so the
+  // opcode itself is the index into the label table.
+  static const void *const DispatchTable[] = {
+#define UseOpCode
+#define Line(NAME, STRING, PREFIX) &&Op_##NAME,
+#define Line_FB(NAME, STRING, PREFIX, EXTEND) &&Op_##NAME,
+#define Line_FC(NAME, STRING, PREFIX, EXTEND) &&Op_##NAME,
+#define Line_FD(NAME, STRING, PREFIX, EXTEND) &&Op_##NAME,
+#define Line_FE(NAME, STRING, PREFIX, EXTEND) &&Op_##NAME,
+#include "common/enum.inc"
+#undef Line
+#undef Line_FB
+#undef Line_FC
+#undef Line_FD
+#undef Line_FE
+#undef UseOpCode
+  };
+
+  if (PC == PCEnd) {
+    return {};
+  }
+  goto *DispatchTable[static_cast<uint32_t>(PC->getOpCode())];
+
+#define UseOpCode
+#define Line(NAME, STRING, PREFIX)                                             \
+  Op_##NAME : {                                                                \
+    EXPECTED_TRY(Account());                                                   \
+    EXPECTED_TRY(Dispatch(OpCode::NAME).map_error(OnError));                   \
+    if (++PC == PCEnd) {                                                       \
+      return {};                                                               \
+    }                                                                          \
+    goto *DispatchTable[static_cast<uint32_t>(PC->getOpCode())];               \
+  }
+#define Line_FB(NAME, STRING, PREFIX, EXTEND) Line(NAME, STRING, PREFIX)
+#define Line_FC(NAME, STRING, PREFIX, EXTEND) Line(NAME, STRING, PREFIX)
+#define Line_FD(NAME, STRING, PREFIX, EXTEND) Line(NAME, STRING, PREFIX)
+#define Line_FE(NAME, STRING, PREFIX, EXTEND) Line(NAME, STRING, PREFIX)
+#include "common/enum.inc"
+#undef Line
+#undef Line_FB
+#undef Line_FC
+#undef Line_FD
+#undef Line_FE
+#undef UseOpCode
+#else
+  while (PC != PCEnd) {
+    EXPECTED_TRY(Account());
+    EXPECTED_TRY(Dispatch(PC->getOpCode()).map_error(OnError));
     PC++;
   }
   return {};
+#endif
 }
 
 } // namespace Executor
@@ -10,7 +10,11 @@ Expect<void>
 Executor::runMemorySizeOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
   // Push SZ = page size to stack.
-  StackMgr.push(MemInst.getPageSize());
+  if (MemInst.is64()) {
+    StackMgr.push(static_cast<uint64_t>(MemInst.getPageSize()));
+  } else {
+    StackMgr.push(MemInst.getPageSize());
+  }
   return {};
 }
 
@@ -18,14 +22,19 @@ Expect<void>
 Executor::runMemoryGrowOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst) {
   // Pop N for growing page size.
-  uint32_t &N = StackMgr.getTop().get<uint32_t>();
+  ValVariant &Val = StackMgr.getTop();
+  const uint64_t N = getAddress(Val, MemInst);
 
-  // Grow page and push result.
-  const uint32_t CurrPageSize = static_cast<uint32_t>(MemInst.getPageSize());
-  if (MemInst.growPage(N)) {
-    N = CurrPageSize;
+  // Grow page and push result. The page counts of the 64-bit memories never
+  // exceed 32 bits. The old page size is got from the grow, as the shared
+  // memory may be grown by the other threads at the same time.
+  uint32_t OldPageSize = 0;
+  const bool Success = N <= UINT32_MAX &&
+                       MemInst.growPage(static_cast<uint32_t>(N), OldPageSize);
+  if (MemInst.is64()) {
+    Val.emplace<uint64_t>(Success ? OldPageSize : UINT64_MAX);
   } else {
-    N = static_cast<uint32_t>(-1);
+    Val.emplace<uint32_t>(Success ? OldPageSize : UINT32_MAX);
   }
   return {};
 }
@@ -36,7 +45,7 @@ Expect<void> Executor::runMemoryInitOp(
   // Pop the length, source, and destination from stack.
   uint32_t Len = StackMgr.pop().get<uint32_t>();
   uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  uint64_t Dst = getAddress(StackMgr.pop(), MemInst);
 
   // Replace mem[Dst : Dst + Len] with data[Src : Src + Len].
   return MemInst.setBytes(DataInst.getData(), Dst, Src, Len)
@@ -60,9 +69,13 @@ Executor::runMemoryCopyOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInstSrc,
                           const AST::Instruction &Instr) {
   // Pop the length, source, and destination from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
-  uint32_t Src = StackMgr.pop().get<uint32_t>();
-  uint32_t Dst = StackMgr.pop().get<uint32_t>();
+  // The length is 64-bit only if both memories are 64-bit.
+  const ValVariant RawLen = StackMgr.pop();
+  uint64_t Src = getAddress(StackMgr.pop(), MemInstSrc);
+  uint64_t Dst = getAddress(StackMgr.pop(), MemInstDst);
+  uint64_t Len = MemInstSrc.is64() && MemInstDst.is64()
+                     ? RawLen.get<uint64_t>()
+                     : RawLen.get<uint32_t>();
 
   // Replace mem[Dst : Dst + Len] with mem[Src : Src + Len].
   EXPECTED_TRY(auto Data,
@@ -83,9 +96,9 @@ Executor::runMemoryFillOp(Runtime::StackManager &StackMgr,
                           Runtime::Instance::MemoryInstance &MemInst,
                           const AST::Instruction &Instr) {
   // Pop the length, value, and offset from stack.
-  uint32_t Len = StackMgr.pop().get<uint32_t>();
+  uint64_t Len = getAddress(StackMgr.pop(), MemInst);
   uint8_t Val = static_cast<uint8_t>(StackMgr.pop().get<uint32_t>());
-  uint32_t Off = StackMgr.pop().get<uint32_t>();
+  uint64_t Off = getAddress(StackMgr.pop(), MemInst);
 
   // Fill data with Val.
   return MemInst.fillBytes(Val, Off, Len).map_error([&Instr](auto E) {
@@ -3,24 +3,56 @@
 
 #include "executor/executor.h"
 #include "system/fault.h"
+#include "system/fiber.h"
 
 #include <cstdint>
+#include <utility>
 
 namespace WasmEdge {
 namespace Executor {
 
 thread_local Executor *Executor::This = nullptr;
 thread_local Runtime::StackManager *Executor::CurrentStack = nullptr;
+thread_local const Executor::ActiveStackScope *Executor::ActiveStack =
+    nullptr;
+thread_local Executor::ContState *Executor::CurrentCont = nullptr;
+thread_local Executor::CpuTimeScope *Executor::CpuTime = nullptr;
 thread_local Executor::ExecutionContextStruct Executor::ExecutionContext;
+thread_local Executor::CompiledExceptionStruct Executor::CompiledException;
 thread_local std::array<uint32_t, 256> Executor::StackTrace;
 thread_local size_t Executor::StackTraceSize = 0;
 
+void Executor::swapFiberLocal(void *Storage) noexcept {
+  using std::swap;
+  auto &Local = *static_cast<FiberLocal *>(Storage);
+  // The suspended executions are not charged, and the resumed ones may run on
+  // another thread with its own CPU clock.
+  if (CpuTime) {
+    CpuTime->sample();
+  }
+  swap(Local.This, This);
+  swap(Local.CurrentStack, CurrentStack);
+  swap(Local.ActiveStack, ActiveStack);
+  swap(Local.CurrentCont, CurrentCont);
+  swap(Local.CpuTime, CpuTime);
+  if (CpuTime) {
+    CpuTime->restart();
+  }
+  swap(Local.ExecutionContext, ExecutionContext);
+  swap(Local.CompiledException, CompiledException);
+  swap(Local.StackTrace, StackTrace);
+  swap(Local.StackTraceSize, StackTraceSize);
+}
+
+const bool Executor::FiberLocalRegistered =
+    Fiber::registerLocal(sizeof(FiberLocal), &swapFiberLocal);
+
 template <typename RetT, typename... ArgsT>
 struct Executor::ProxyHelper<Expect<RetT> (Executor::*)(Runtime::StackManager &,
                                                         ArgsT...) noexcept> {
   template <Expect<RetT> (Executor::*Func)(Runtime::StackManager &,
                                            ArgsT...) noexcept>
-  static auto proxy(ArgsT... Args) {
+  static Expect<RetT> invoke(ArgsT... Args) noexcept {
 #if defined(__s390x__)
     // Required on s390x: materializing args prevents runtime failures in
     // release builds.
@@ -33,10 +65,40 @@ struct Executor::ProxyHelper<Expect<RetT> (Executor::*)(Runtime::StackManager &,
         return std::forward<decltype(A)>(A);
       }
     };
-    Expect<RetT> Res = (This->*Func)(*CurrentStack, Materialize(Args)...);
+    return (This->*Func)(*CurrentStack, Materialize(Args)...);
 #else
-    Expect<RetT> Res = (This->*Func)(*CurrentStack, Args...);
+    return (This->*Func)(*CurrentStack, Args...);
+#endif
+  }
+
+  /// The faults of the host code cannot be thrown through it to the unwinding
+  /// handler of the compiled code, so they jump back here instead.
+  template <Expect<RetT> (Executor::*Func)(Runtime::StackManager &,
+                                           ArgsT...) noexcept>
+  static Expect<RetT> invokeGuarded(ArgsT... Args) noexcept {
+#if WASMEDGE_FAULT_UNWINDING
+    Fault FaultHandler;
+    if (uint32_t Code = PREPARE_FAULT(FaultHandler); Code != 0) {
+      return Unexpect(static_cast<ErrCategory>(Code >> 24), Code);
+    }
 #endif
+    return invoke<Func>(Args...);
+  }
+
+  /// @tparam HostCode The function runs the host functions or the
+  /// interpreter, which may fault.
+  template <Expect<RetT> (Executor::*Func)(Runtime::StackManager &,
+                                           ArgsT...) noexcept,
+            bool HostCode = false>
+  static auto proxy(ArgsT... Args) {
+    // The host functions and the other modules access their own memories.
+    [[maybe_unused]] const uint32_t Rights =
+        HostCode ? Allocator::allowProtectionKeys() : 0;
+    Expect<RetT> Res =
+        HostCode ? invokeGuarded<Func>(Args...) : invoke<Func>(Args...);
+    if constexpr (HostCode) {
+      Allocator::restoreProtectionKeys(Rights);
+    }
     if (unlikely(!Res)) {
       Fault::emitFault(Res.error());
     }
@@ -63,16 +125,24 @@ const Executable::IntrinsicsTable Executor::Intrinsics = {
 #define ENTRY(NAME, FUNC)                                                      \
   reinterpret_cast<void *>(&Executor::ProxyHelper<                             \
                            decltype(&Executor::FUNC)>::proxy<&Executor::FUNC>)
+#define HOST_ENTRY(NAME, FUNC)                                                 \
+  reinterpret_cast<void *>(                                                    \
+      &Executor::ProxyHelper<decltype(&Executor::FUNC)>::proxy<                \
+          &Executor::FUNC, true>)
 #else
 #define ENTRY(NAME, FUNC)                                                      \
   [uint8_t(Executable::Intrinsics::NAME)] = reinterpret_cast<void *>(          \
       &Executor::ProxyHelper<decltype(&Executor::FUNC)>::proxy<                \
           &Executor::FUNC>)
+#define HOST_ENTRY(NAME, FUNC)                                                 \
+  [uint8_t(Executable::Intrinsics::NAME)] = reinterpret_cast<void *>(          \
+      &Executor::ProxyHelper<decltype(&Executor::FUNC)>::proxy<                \
+          &Executor::FUNC, true>)
 #endif
     ENTRY(kTrap, proxyTrap),
-    ENTRY(kCall, proxyCall),
-    ENTRY(kCallIndirect, proxyCallIndirect),
-    ENTRY(kCallRef, proxyCallRef),
+    HOST_ENTRY(kCall, proxyCall),
+    HOST_ENTRY(kCallIndirect, proxyCallIndirect),
+    HOST_ENTRY(kCallRef, proxyCallRef),
     ENTRY(kRefFunc, proxyRefFunc),
     ENTRY(kStructNew, proxyStructNew),
     ENTRY(kStructGet, proxyStructGet),
@@ -107,6 +177,7 @@ const Executable::IntrinsicsTable Executor::Intrinsics = {
     ENTRY(kMemAtomicWait, proxyMemAtomicWait),
     ENTRY(kTableGetFuncSymbol, proxyTableGetFuncSymbol),
     ENTRY(kRefGetFuncSymbol, proxyRefGetFuncSymbol),
+#undef HOST_ENTRY
 #undef ENTRY
 };
 
@@ -123,6 +194,11 @@ Expect<void> Executor::proxyCall(Runtime::StackManager &StackMgr,
                                  const uint32_t FuncIdx, const ValVariant *Args,
                                  ValVariant *Rets) noexcept {
   const auto *FuncInst = getFuncInstByIdx(StackMgr, FuncIdx);
+  // Call the typed host functions with the slots directly.
+  if (FuncInst->isHostFunction() && FuncInst->getHostFunc().getFastCall()) {
+    return callFastHostFunc(StackMgr, *FuncInst, Args, Rets);
+  }
+
   const auto &FuncType = FuncInst->getFuncType();
   const uint32_t ParamsSize =
       static_cast<uint32_t>(FuncType.getParamTypes().size());
@@ -133,6 +209,7 @@ Expect<void> Executor::proxyCall(Runtime::StackManager &StackMgr,
     StackMgr.push(Args[I]);
   }
 
+  EXPECTED_TRY(FuncInst->materialize());
   auto Instrs = FuncInst->getInstrs();
   EXPECTED_TRY(auto StartIt, enterFunction(StackMgr, *FuncInst, Instrs.end()));
   EXPECTED_TRY(execute(StackMgr, StartIt, Instrs.end()));
@@ -156,31 +233,13 @@ Expect<void> Executor::proxyCallIndirect(Runtime::StackManager &StackMgr,
     return Unexpect(ErrCode::Value::UndefinedElement);
   }
 
-  auto Ref = TabInst->getRefAddr(FuncIdx);
-  assuming(Ref);
-  if (unlikely(Ref->isNull())) {
-    return Unexpect(ErrCode::Value::UninitializedElement);
-  }
-
-  const auto *ModInst = StackMgr.getModule();
-  assuming(ModInst);
-  const auto &ExpDefType = **ModInst->getType(FuncTypeIdx);
-  const auto *FuncInst = retrieveFuncRef(*Ref);
+  EXPECTED_TRY(const auto *FuncInst,
+               getIndirectCallFunc(StackMgr, *TabInst, FuncTypeIdx, FuncIdx));
   assuming(FuncInst);
-  bool IsMatch = false;
-  if (FuncInst->getModule()) {
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), *ExpDefType.getTypeIndex(),
-        FuncInst->getModule()->getTypeList(), FuncInst->getTypeIndex());
-  } else {
-    // Independent host module instance case. Matching the composite type
-    // directly.
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), ExpDefType.getCompositeType(),
-        FuncInst->getHostFunc().getDefinedType().getCompositeType());
-  }
-  if (!IsMatch) {
-    return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
+
+  // Call the typed host functions with the slots directly.
+  if (FuncInst->isHostFunction() && FuncInst->getHostFunc().getFastCall()) {
+    return callFastHostFunc(StackMgr, *FuncInst, Args, Rets);
   }
 
   const auto &FuncType = FuncInst->getFuncType();
@@ -193,6 +252,7 @@ Expect<void> Executor::proxyCallIndirect(Runtime::StackManager &StackMgr,
     StackMgr.push(Args[I]);
   }
 
+  EXPECTED_TRY(FuncInst->materialize());
   auto Instrs = FuncInst->getInstrs();
   EXPECTED_TRY(auto StartIt, enterFunction(StackMgr, *FuncInst, Instrs.end()));
   EXPECTED_TRY(execute(StackMgr, StartIt, Instrs.end()));
@@ -208,6 +268,11 @@ Expect<void> Executor::proxyCallRef(Runtime::StackManager &StackMgr,
                                     const ValVariant *Args,
                                     ValVariant *Rets) noexcept {
   const auto *FuncInst = retrieveFuncRef(Ref);
+  // Call the typed host functions with the slots directly.
+  if (FuncInst->isHostFunction() && FuncInst->getHostFunc().getFastCall()) {
+    return callFastHostFunc(StackMgr, *FuncInst, Args, Rets);
+  }
+
   const auto &FuncType = FuncInst->getFuncType();
   const uint32_t ParamsSize =
       static_cast<uint32_t>(FuncType.getParamTypes().size());
@@ -218,6 +283,7 @@ Expect<void> Executor::proxyCallRef(Runtime::StackManager &StackMgr,
     StackMgr.push(Args[I]);
   }
 
+  EXPECTED_TRY(FuncInst->materialize());
   auto Instrs = FuncInst->getInstrs();
   EXPECTED_TRY(auto StartIt, enterFunction(StackMgr, *FuncInst, Instrs.end()));
   EXPECTED_TRY(execute(StackMgr, StartIt, Instrs.end()));
@@ -358,25 +424,9 @@ Expect<void> Executor::proxyArrayInitElem(
 Expect<uint32_t> Executor::proxyRefTest(Runtime::StackManager &StackMgr,
                                         const RefVariant Ref,
                                         ValType VTTest) noexcept {
-  // Copy the value type here due to handling the externalized case.
-  auto VT = Ref.getType();
-  if (VT.isExternalized()) {
-    VT = ValType(TypeCode::Ref, TypeCode::ExternRef);
-  }
   const auto *ModInst = StackMgr.getModule();
   assuming(ModInst);
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst = Ref.getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  if (AST::TypeMatcher::matchType(ModInst->getTypeList(), VTTest, GotTypeList,
-                                  VT)) {
+  if (matchRefType(*ModInst, VTTest, Ref)) {
     return static_cast<uint32_t>(1);
   } else {
     return static_cast<uint32_t>(0);
@@ -386,25 +436,9 @@ Expect<uint32_t> Executor::proxyRefTest(Runtime::StackManager &StackMgr,
 Expect<RefVariant> Executor::proxyRefCast(Runtime::StackManager &StackMgr,
                                           const RefVariant Ref,
                                           ValType VTCast) noexcept {
-  // Copy the value type here due to handling the externalized case.
-  auto VT = Ref.getType();
-  if (VT.isExternalized()) {
-    VT = ValType(TypeCode::Ref, TypeCode::ExternRef);
-  }
   const auto *ModInst = StackMgr.getModule();
   assuming(ModInst);
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst = Ref.getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  if (!AST::TypeMatcher::matchType(ModInst->getTypeList(), VTCast, GotTypeList,
-                                   VT)) {
+  if (!matchRefType(*ModInst, VTCast, Ref)) {
     return Unexpect(ErrCode::Value::CastFailed);
   }
   return Ref;
@@ -459,8 +493,8 @@ Expect<void> Executor::proxyTableCopy(Runtime::StackManager &StackMgr,
   auto *TabInstSrc = getTabInstByIdx(StackMgr, TableIdxSrc);
   assuming(TabInstSrc);
 
-  EXPECTED_TRY(auto Refs, TabInstSrc->getRefs(0, SrcOff + Len));
-  return TabInstDst->setRefs(Refs, DstOff, SrcOff, Len);
+  EXPECTED_TRY(auto Refs, TabInstSrc->getRefs(SrcOff, Len));
+  return TabInstDst->setRefs(Refs, DstOff, 0, Len);
 }
 
 Expect<uint32_t> Executor::proxyTableGrow(Runtime::StackManager &StackMgr,
@@ -498,9 +532,9 @@ Expect<uint32_t> Executor::proxyMemGrow(Runtime::StackManager &StackMgr,
                                         const uint32_t NewSize) noexcept {
   auto *MemInst = getMemInstByIdx(StackMgr, MemIdx);
   assuming(MemInst);
-  const uint32_t CurrPageSize = MemInst->getPageSize();
-  if (MemInst->growPage(NewSize)) {
-    return CurrPageSize;
+  uint32_t OldPageSize = 0;
+  if (MemInst->growPage(NewSize, OldPageSize)) {
+    return OldPageSize;
   } else {
     return static_cast<uint32_t>(-1);
   }
@@ -592,37 +626,22 @@ Expect<void *> Executor::proxyTableGetFuncSymbol(
     return Unexpect(ErrCode::Value::UndefinedElement);
   }
 
-  auto Ref = TabInst->getRefAddr(FuncIdx);
-  assuming(Ref);
-  if (unlikely(Ref->isNull())) {
-    return Unexpect(ErrCode::Value::UninitializedElement);
-  }
-
-  const auto *ModInst = StackMgr.getModule();
-  assuming(ModInst);
-  const auto &ExpDefType = **ModInst->getType(FuncTypeIdx);
-  const auto *FuncInst = retrieveFuncRef(*Ref);
+  EXPECTED_TRY(const auto *FuncInst,
+               getIndirectCallFunc(StackMgr, *TabInst, FuncTypeIdx, FuncIdx));
   assuming(FuncInst);
-  bool IsMatch = false;
-  if (FuncInst->getModule()) {
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), *ExpDefType.getTypeIndex(),
-        FuncInst->getModule()->getTypeList(), FuncInst->getTypeIndex());
-  } else {
-    // Independent host module instance case. Matching the composite type
-    // directly.
-    IsMatch = AST::TypeMatcher::matchType(
-        ModInst->getTypeList(), ExpDefType.getCompositeType(),
-        FuncInst->getHostFunc().getDefinedType().getCompositeType());
-  }
-  if (!IsMatch) {
-    return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
-  }
 
   if (unlikely(!FuncInst->isCompiledFunction())) {
     return nullptr;
   }
-  return FuncInst->getSymbol().get();
+  void *Symbol = FuncInst->getSymbol().get();
+  // Cache the checked slot for the native dispatch of the later calls. Only
+  // the functions of the same module share the execution context.
+  if (const auto *ModInst = StackMgr.getModule();
+      FuncInst->getModule() == ModInst) {
+    TabInst->setNativeEntry(FuncIdx, ModInst->NativeTypeIds[FuncTypeIdx],
+                            Symbol);
+  }
+  return Symbol;
 }
 
 Expect<void *> Executor::proxyRefGetFuncSymbol(Runtime::StackManager &,
@@ -3,6 +3,12 @@
 
 #include "executor/executor.h"
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace WasmEdge {
 namespace Executor {
 
@@ -74,6 +80,127 @@ void logTableOOB(const ErrCode &Code,
   }
 }
 
+/// Charge the GC object with the packed fields to the memory budget of the
+/// module instance which owns it.
+template <typename T>
+Expect<void> chargeGCObject(Runtime::Instance::ModuleInstance &ModInst,
+                            const uint64_t FieldBytes) noexcept {
+  if (!ModInst.getMemoryBudget().charge(sizeof(T) + FieldBytes, false)) {
+    spdlog::error(ErrCode::Value::MemoryBudgetExceeded);
+    return Unexpect(ErrCode::Value::MemoryBudgetExceeded);
+  }
+  return {};
+}
+
+/// Copy the packed elements from the data instance to the array. The bounds
+/// should be checked before.
+void copyDataToArray(Runtime::Instance::ArrayInstance &Inst,
+                     const uint32_t DstIdx,
+                     const Runtime::Instance::DataInstance &DataInst,
+                     const uint32_t SrcOff, const uint32_t Cnt) noexcept {
+  const uint32_t ESize = Inst.getElemSize();
+  if constexpr (Endian::native == Endian::little) {
+    // The data in little endian is the same as the packed elements.
+    if (Cnt > 0) {
+      std::memcpy(Inst.getBytes().data() + static_cast<size_t>(DstIdx) * ESize,
+                  DataInst.getData().data() + SrcOff,
+                  static_cast<size_t>(Cnt) * ESize);
+    }
+  } else {
+    for (uint32_t Idx = 0; Idx < Cnt; Idx++) {
+      Inst.setData(DstIdx + Idx,
+                   DataInst.loadValue(SrcOff + Idx * ESize, ESize));
+    }
+  }
+}
+
+/// Marker of the reachable GC objects of a module instance. The values are
+/// scanned conservatively, as the value stacks keep no types: every word of a
+/// value equal to an address of the objects keeps the object alive. The
+/// objects are traced precisely through their reference fields.
+class GCMarker {
+public:
+  /// Add the struct with the packed storage and the offsets of the reference
+  /// fields in it, or the array with the packed storage of the elements.
+  void addStruct(const void *Ptr, Span<const uint8_t> Bytes,
+                 Span<const uint32_t> RefOffsets) {
+    Objects.emplace(Ptr, Object{Bytes, RefOffsets, false});
+  }
+  void addArray(const void *Ptr, Span<const uint8_t> Bytes, bool HasRefs) {
+    Objects.emplace(Ptr, Object{HasRefs ? Bytes : Span<const uint8_t>(), {},
+                                HasRefs});
+  }
+  /// Add the continuation with the values of its stacks, which are scanned
+  /// conservatively.
+  void addCont(const void *Ptr, std::vector<Span<const ValVariant>> Values) {
+    Objects.emplace(Ptr, Object{{}, {}, false, std::move(Values)});
+  }
+  bool isMarked(const void *Ptr) const noexcept {
+    return Marked.count(Ptr) > 0;
+  }
+
+  void markValue(const ValVariant &Val) {
+    uint64_t Words[sizeof(ValVariant) / sizeof(uint64_t)];
+    std::memcpy(Words, &Val, sizeof(Words));
+    for (const uint64_t Word : Words) {
+      markPointer(reinterpret_cast<const void *>(Word));
+    }
+  }
+  void markRef(const RefVariant &Ref) { markPointer(Ref.getPtr<void>()); }
+
+  /// Trace the reference fields of the marked objects.
+  void trace() {
+    while (!Pending.empty()) {
+      const Object Obj = std::move(Pending.back());
+      Pending.pop_back();
+      if (Obj.RefArray) {
+        for (size_t Offset = 0; Offset < Obj.Bytes.size();
+             Offset += sizeof(RefVariant)) {
+          markRefAt(Obj.Bytes, Offset);
+        }
+      } else {
+        for (const uint32_t Offset : Obj.RefOffsets) {
+          markRefAt(Obj.Bytes, Offset);
+        }
+      }
+      for (const auto &Vals : Obj.Values) {
+        for (const auto &Val : Vals) {
+          markValue(Val);
+        }
+      }
+    }
+  }
+
+private:
+  struct Object {
+    Span<const uint8_t> Bytes;
+    Span<const uint32_t> RefOffsets;
+    bool RefArray;
+    std::vector<Span<const ValVariant>> Values = {};
+  };
+
+  void markRefAt(Span<const uint8_t> Bytes, size_t Offset) {
+    RefVariant Ref;
+    std::memcpy(&Ref, Bytes.data() + Offset, sizeof(RefVariant));
+    markRef(Ref);
+  }
+
+  void markPointer(const void *Ptr) {
+    // The i31 values are unboxed and never traced.
+    if (Ptr == nullptr || RefVariant::isI31Tagged(Ptr)) {
+      return;
+    }
+    if (auto Iter = Objects.find(Ptr);
+        Iter != Objects.end() && Marked.insert(Ptr).second) {
+      Pending.push_back(Iter->second);
+    }
+  }
+
+  std::unordered_map<const void *, Object> Objects;
+  std::unordered_set<const void *> Marked;
+  std::vector<Object> Pending;
+};
+
 } // namespace
 
 Expect<void> Executor::runRefNullOp(Runtime::StackManager &StackMgr,
@@ -117,13 +244,17 @@ Executor::runRefAsNonNullOp(RefVariant &Ref,
 Expect<void> Executor::runStructNewOp(Runtime::StackManager &StackMgr,
                                       const uint32_t TypeIdx,
                                       const bool IsDefault) const noexcept {
+  collectGarbage(StackMgr);
   if (IsDefault) {
-    StackMgr.push(*structNew(StackMgr, TypeIdx));
+    EXPECTED_TRY(auto InstRef, structNew(StackMgr, TypeIdx));
+    StackMgr.push(InstRef);
   } else {
     const auto &CompType = getCompositeTypeByIdx(StackMgr, TypeIdx);
     const uint32_t N = static_cast<uint32_t>(CompType.getFieldTypes().size());
-    std::vector<ValVariant> Vals = StackMgr.pop(N);
-    StackMgr.push(*structNew(StackMgr, TypeIdx, Vals));
+    // The values are released before pushing, which may fault in the guarded
+    // execution.
+    EXPECTED_TRY(auto InstRef, structNew(StackMgr, TypeIdx, StackMgr.pop(N)));
+    StackMgr.push(InstRef);
   }
   return {};
 }
@@ -160,13 +291,18 @@ Expect<void> Executor::runArrayNewOp(Runtime::StackManager &StackMgr,
                                      const uint32_t InitCnt,
                                      uint32_t Length) const noexcept {
   assuming(InitCnt == 0 || InitCnt == 1 || InitCnt == Length);
+  collectGarbage(StackMgr);
   if (InitCnt == 0) {
-    StackMgr.push(*arrayNew(StackMgr, TypeIdx, Length));
+    EXPECTED_TRY(auto InstRef, arrayNew(StackMgr, TypeIdx, Length));
+    StackMgr.push(InstRef);
   } else if (InitCnt == 1) {
-    StackMgr.getTop().emplace<RefVariant>(
-        *arrayNew(StackMgr, TypeIdx, Length, {StackMgr.getTop()}));
+    EXPECTED_TRY(auto InstRef,
+                 arrayNew(StackMgr, TypeIdx, Length, {StackMgr.getTop()}));
+    StackMgr.getTop().emplace<RefVariant>(InstRef);
   } else {
-    StackMgr.push(*arrayNew(StackMgr, TypeIdx, Length, StackMgr.pop(Length)));
+    EXPECTED_TRY(auto InstRef, arrayNew(StackMgr, TypeIdx, Length,
+                                        StackMgr.pop(Length)));
+    StackMgr.push(InstRef);
   }
   return {};
 }
@@ -175,6 +311,7 @@ Expect<void>
 Executor::runArrayNewDataOp(Runtime::StackManager &StackMgr,
                             const uint32_t TypeIdx, const uint32_t DataIdx,
                             const AST::Instruction &Instr) const noexcept {
+  collectGarbage(StackMgr);
   const uint32_t Length = StackMgr.pop().get<uint32_t>();
   const uint32_t Start = StackMgr.getTop().get<uint32_t>();
   EXPECTED_TRY(
@@ -196,6 +333,7 @@ Expect<void>
 Executor::runArrayNewElemOp(Runtime::StackManager &StackMgr,
                             const uint32_t TypeIdx, const uint32_t ElemIdx,
                             const AST::Instruction &Instr) const noexcept {
+  collectGarbage(StackMgr);
   const uint32_t Length = StackMgr.pop().get<uint32_t>();
   const uint32_t Start = StackMgr.getTop().get<uint32_t>();
   EXPECTED_TRY(auto InstRef,
@@ -327,31 +465,15 @@ Expect<void>
 Executor::runRefTestOp(const Runtime::Instance::ModuleInstance *ModInst,
                        ValVariant &Val, const AST::Instruction &Instr,
                        const bool IsCast) const noexcept {
-  // Copy the value type here due to handling the externalized case.
-  auto VT = Val.get<RefVariant>().getType();
-  if (VT.isExternalized()) {
-    VT = ValType(TypeCode::Ref, TypeCode::ExternRef);
-  }
-  Span<const AST::SubType *const> GotTypeList = ModInst->getTypeList();
-  if (!VT.isAbsHeapType()) {
-    auto *Inst =
-        Val.get<RefVariant>().getPtr<Runtime::Instance::CompositeBase>();
-    // Reference must not be nullptr here because the null references are typed
-    // with the least abstract heap type.
-    if (Inst->getModule()) {
-      GotTypeList = Inst->getModule()->getTypeList();
-    }
-  }
-
-  if (AST::TypeMatcher::matchType(ModInst->getTypeList(), Instr.getValType(),
-                                  GotTypeList, VT)) {
+  if (matchRefType(*ModInst, Instr.getValType(), Val.get<RefVariant>())) {
     if (!IsCast) {
       Val.emplace<uint32_t>(1U);
     }
   } else {
     if (IsCast) {
       spdlog::error(ErrCode::Value::CastFailed);
-      spdlog::error(ErrInfo::InfoMismatch(Instr.getValType(), VT));
+      spdlog::error(ErrInfo::InfoMismatch(Instr.getValType(),
+                                          Val.get<RefVariant>().getType()));
       spdlog::error(
           ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
       return Unexpect(ErrCode::Value::CastFailed);
@@ -388,28 +510,167 @@ Expect<void> Executor::runRefConvOp(RefVariant &Ref,
 }
 
 Expect<void> Executor::runRefI31Op(ValVariant &Val) const noexcept {
-  uint32_t RefNum = (Val.get<uint32_t>() & 0x7FFFFFFFU) | 0x80000000U;
-  Val = RefVariant(ValType(TypeCode::Ref, TypeCode::I31Ref),
-                   reinterpret_cast<void *>(static_cast<uint64_t>(RefNum)));
+  Val = RefVariant::fromI31(Val.get<uint32_t>());
   return {};
 }
 
 Expect<void> Executor::runI31GetOp(ValVariant &Val,
                                    const AST::Instruction &Instr,
                                    const bool IsSigned) const noexcept {
-  uint32_t RefNum = static_cast<uint32_t>(
-      reinterpret_cast<uintptr_t>(Val.get<RefVariant>().getPtr<void>()));
-  if ((RefNum & 0x80000000U) == 0) {
+  const auto &Ref = Val.get<RefVariant>();
+  if (unlikely(Ref.isNull())) {
     return Unexpect(logError(ErrCode::Value::AccessNullI31, Instr));
   }
-  RefNum &= 0x7FFFFFFFU;
-  if (IsSigned) {
-    RefNum |= ((RefNum & 0x40000000U) << 1);
-  }
-  Val.emplace<uint32_t>(RefNum);
+  Val.emplace<uint32_t>(IsSigned ? Ref.getI31S() : Ref.getI31U());
   return {};
 }
 
+void Executor::collectGarbage(Runtime::StackManager &StackMgr) const noexcept {
+  auto *ModInst =
+      const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
+  const uint64_t Threshold = Conf.getRuntimeConfigure().getGCThreshold();
+  if (Threshold == 0 || ModInst == nullptr ||
+      ModInst->GCAllocated < Threshold) {
+    return;
+  }
+  // The compiled functions keep the references out of the value stacks, so
+  // the roots are unknown if any of them is running.
+  if (TierUpThreshold != 0) {
+    return;
+  }
+  auto HasCompiledFrame = [](const Runtime::StackManager &Stack) {
+    for (const auto &F : Stack.getFramesSpan()) {
+      if (F.Func && F.Func->isCompiledFunction()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  // The dropped continuations are destroyed after unlocking, as unwinding
+  // their suspended executions may look up this module instance.
+  std::vector<std::unique_ptr<Runtime::Instance::ContInstance>> DroppedConts;
+  // The running stacks are the stacks of the executions on this fiber, and of
+  // the resumers of the running continuations on the other fibers.
+  std::vector<const Runtime::StackManager *> Stacks;
+  try {
+    for (const auto *Scope = ActiveStack; Scope; Scope = Scope->Prev) {
+      Stacks.push_back(&Scope->Stack);
+    }
+    for (const auto *Cont = CurrentCont; Cont; Cont = Cont->Parent) {
+      for (const auto *Scope = Cont->ResumerStack; Scope;
+           Scope = Scope->Prev) {
+        Stacks.push_back(&Scope->Stack);
+      }
+    }
+  } catch (const std::bad_alloc &) {
+    return;
+  }
+  for (const auto *Stack : Stacks) {
+    if (HasCompiledFrame(*Stack)) {
+      return;
+    }
+  }
+  for (const auto &Inst : ModInst->OwnedContInsts) {
+    for (const auto *State = static_cast<ContState *>(Inst->getState());
+         State; State = State->Child) {
+      if (HasCompiledFrame(State->Stack)) {
+        return;
+      }
+    }
+  }
+
+  try {
+    std::unique_lock Lock(ModInst->Mutex);
+    GCMarker Marker;
+    // Offsets of the reference fields of the struct types.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> RefOffsets;
+    for (const auto &Inst : ModInst->OwnedStructInsts) {
+      auto [Iter, Inserted] = RefOffsets.try_emplace(Inst->getTypeIndex());
+      if (Inserted) {
+        const auto &CompType =
+            ModInst->Types[Inst->getTypeIndex()]->getCompositeType();
+        const auto &FieldTypes = CompType.getFieldTypes();
+        for (size_t I = 0; I < FieldTypes.size(); ++I) {
+          if (FieldTypes[I].getStorageType().isRefType()) {
+            Iter->second.push_back(CompType.getFieldOffsets()[I]);
+          }
+        }
+      }
+      Marker.addStruct(Inst.get(), Inst->getBytes(), Iter->second);
+    }
+    for (const auto &Inst : ModInst->OwnedArrayInsts) {
+      const auto &CompType =
+          ModInst->Types[Inst->getTypeIndex()]->getCompositeType();
+      Marker.addArray(
+          Inst.get(), std::as_const(*Inst).getBytes(),
+          CompType.getFieldTypes()[0].getStorageType().isRefType());
+    }
+    // The suspended continuation includes the ones resumed by it.
+    for (const auto &Inst : ModInst->OwnedContInsts) {
+      std::vector<Span<const ValVariant>> Values;
+      for (const auto *State = static_cast<ContState *>(Inst->getState());
+           State; State = State->Child) {
+        Values.push_back(State->Stack.getValueSpan());
+        Values.push_back(State->Values);
+      }
+      Marker.addCont(Inst.get(), std::move(Values));
+    }
+
+    // Mark from the roots: the running value stacks on this thread, the
+    // globals, the tables, and the element segments.
+    for (const auto *Stack : Stacks) {
+      for (const auto &Val : Stack->getValueSpan()) {
+        Marker.markValue(Val);
+      }
+    }
+    for (const auto *GlobInst : ModInst->GlobInsts) {
+      Marker.markValue(GlobInst->getValue());
+    }
+    for (const auto *TabInst : ModInst->TabInsts) {
+      if (auto Refs = TabInst->getRefs(0, TabInst->getSize())) {
+        for (const auto &Ref : *Refs) {
+          Marker.markRef(Ref);
+        }
+      }
+    }
+    for (const auto *ElemInst : ModInst->ElemInsts) {
+      for (const auto &Ref : ElemInst->getRefs()) {
+        Marker.markRef(Ref);
+      }
+    }
+    Marker.trace();
+
+    // Sweep the unmarked objects.
+    uint64_t Freed = 0;
+    auto Sweep = [&](auto &Insts) {
+      auto End = std::remove_if(Insts.begin(), Insts.end(), [&](auto &Inst) {
+        if (Marker.isMarked(Inst.get())) {
+          return false;
+        }
+        Freed += Inst->getByteSize();
+        return true;
+      });
+      Insts.erase(End, Insts.end());
+    };
+    Sweep(ModInst->OwnedStructInsts);
+    Sweep(ModInst->OwnedArrayInsts);
+    auto &ContInsts = ModInst->OwnedContInsts;
+    const auto ContEnd =
+        std::partition(ContInsts.begin(), ContInsts.end(),
+                       [&](auto &Inst) { return Marker.isMarked(Inst.get()); });
+    DroppedConts.reserve(static_cast<size_t>(ContInsts.end() - ContEnd));
+    for (auto It = ContEnd; It != ContInsts.end(); ++It) {
+      Freed += (*It)->getByteSize();
+      DroppedConts.push_back(std::move(*It));
+    }
+    ContInsts.erase(ContEnd, ContInsts.end());
+    ModInst->getMemoryBudget().release(Freed);
+    ModInst->GCAllocated = 0;
+  } catch (const std::bad_alloc &) {
+    // Skip this collection and retry at the next allocation.
+  }
+}
+
 Expect<RefVariant>
 Executor::structNew(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
                     Span<const ValVariant> Args) const noexcept {
@@ -417,22 +678,26 @@ Executor::structNew(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
   /// currently because of referring the defined types of the module instances.
   /// This may be changed after applying the garbage collection mechanism.
   const auto &CompType = getCompositeTypeByIdx(StackMgr, TypeIdx);
-  uint32_t N = static_cast<uint32_t>(CompType.getFieldTypes().size());
+  const auto &FieldTypes = CompType.getFieldTypes();
+  const auto Offsets = CompType.getFieldOffsets();
+  uint32_t N = static_cast<uint32_t>(FieldTypes.size());
   Runtime::Instance::ModuleInstance *ModInst =
       const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
-  std::vector<ValVariant> Vals(N);
+  EXPECTED_TRY(chargeGCObject<Runtime::Instance::StructInstance>(
+      *ModInst, CompType.getFieldsSize()));
+  // The numeric fields are initialized with zeros.
+  WasmEdge::Runtime::Instance::StructInstance *Inst =
+      ModInst->newStruct(TypeIdx, CompType.getFieldsSize());
   for (uint32_t I = 0; I < N; I++) {
-    const auto &VType = CompType.getFieldTypes()[I].getStorageType();
+    const auto &VType = FieldTypes[I].getStorageType();
+    const uint32_t Size = FieldTypes[I].getStorageSize();
     if (Args.size() > 0) {
-      Vals[I] = packVal(VType, Args[I]);
-    } else {
-      Vals[I] = VType.isRefType()
-                    ? ValVariant(RefVariant(toBottomType(StackMgr, VType)))
-                    : ValVariant(static_cast<uint128_t>(0U));
+      Inst->setField(Offsets[I], Size, packVal(VType, Args[I]));
+    } else if (VType.isRefType()) {
+      Inst->setField(Offsets[I], Size,
+                     RefVariant(toBottomType(StackMgr, VType)));
     }
   }
-  WasmEdge::Runtime::Instance::StructInstance *Inst =
-      ModInst->newStruct(TypeIdx, std::move(Vals));
   return RefVariant(Inst->getDefType(), Inst);
 }
 
@@ -445,8 +710,12 @@ Expect<ValVariant> Executor::structGet(Runtime::StackManager &StackMgr,
   if (Inst == nullptr) {
     return Unexpect(ErrCode::Value::AccessNullStruct);
   }
-  const auto &VType = getStructStorageTypeByIdx(StackMgr, TypeIdx, Off);
-  return unpackVal(VType, Inst->getField(Off), IsSigned);
+  const auto &CompType = getCompositeTypeByIdx(StackMgr, TypeIdx);
+  const auto &FType = CompType.getFieldTypes()[Off];
+  return unpackVal(FType.getStorageType(),
+                   Inst->getField(CompType.getFieldOffsets()[Off],
+                                  FType.getStorageSize()),
+                   IsSigned);
 }
 
 Expect<void> Executor::structSet(Runtime::StackManager &StackMgr,
@@ -457,8 +726,10 @@ Expect<void> Executor::structSet(Runtime::StackManager &StackMgr,
   if (Inst == nullptr) {
     return Unexpect(ErrCode::Value::AccessNullStruct);
   }
-  const auto &VType = getStructStorageTypeByIdx(StackMgr, TypeIdx, Off);
-  Inst->getField(Off) = packVal(VType, Val);
+  const auto &CompType = getCompositeTypeByIdx(StackMgr, TypeIdx);
+  const auto &FType = CompType.getFieldTypes()[Off];
+  Inst->setField(CompType.getFieldOffsets()[Off], FType.getStorageSize(),
+                 packVal(FType.getStorageType(), Val));
   return {};
 }
 
@@ -469,24 +740,32 @@ Executor::arrayNew(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
   /// TODO: The array and struct instances are owned by the module instance
   /// currently because of referring the defined types of the module instances.
   /// This may be changed after applying the garbage collection mechanism.
-  const auto &VType = getArrayStorageTypeByIdx(StackMgr, TypeIdx);
+  const auto &FType =
+      getCompositeTypeByIdx(StackMgr, TypeIdx).getFieldTypes()[0];
+  const auto &VType = FType.getStorageType();
+  const uint32_t ESize = FType.getStorageSize();
   WasmEdge::Runtime::Instance::ArrayInstance *Inst = nullptr;
   Runtime::Instance::ModuleInstance *ModInst =
       const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
+  EXPECTED_TRY(chargeGCObject<Runtime::Instance::ArrayInstance>(
+      *ModInst, static_cast<uint64_t>(Length) * ESize));
   if (Args.size() == 0) {
-    // New and fill with default values.
-    auto InitVal = VType.isRefType()
-                       ? ValVariant(RefVariant(toBottomType(StackMgr, VType)))
-                       : ValVariant(static_cast<uint128_t>(0U));
-    Inst = ModInst->newArray(TypeIdx, Length, InitVal);
+    // New and fill with default values. The numeric ones are zeros.
+    if (VType.isRefType()) {
+      Inst = ModInst->newArray(TypeIdx, Length, ESize,
+                               RefVariant(toBottomType(StackMgr, VType)));
+    } else {
+      Inst = ModInst->newArray(TypeIdx, Length, ESize);
+    }
   } else if (Args.size() == 1) {
     // New and fill with the arg value.
-    Inst = ModInst->newArray(TypeIdx, Length, packVal(VType, Args[0]));
+    Inst = ModInst->newArray(TypeIdx, Length, ESize, packVal(VType, Args[0]));
   } else {
     // New with args.
-    Inst = ModInst->newArray(
-        TypeIdx,
-        packVals(VType, std::vector<ValVariant>(Args.begin(), Args.end())));
+    Inst = ModInst->newArray(TypeIdx, Length, ESize);
+    for (uint32_t Idx = 0; Idx < Length; Idx++) {
+      Inst->setData(Idx, packVal(VType, Args[Idx]));
+    }
   }
   return RefVariant(Inst->getDefType(), Inst);
 }
@@ -505,14 +784,11 @@ Executor::arrayNewData(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
   }
   Runtime::Instance::ModuleInstance *ModInst =
       const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
-  std::vector<ValVariant> Args;
-  Args.reserve(Length);
-  for (uint32_t Idx = 0; Idx < Length; Idx++) {
-    // The value has been packed.
-    Args.push_back(DataInst->loadValue(Start + Idx * BSize, BSize));
-  }
+  EXPECTED_TRY(chargeGCObject<Runtime::Instance::ArrayInstance>(
+      *ModInst, static_cast<uint64_t>(Length) * BSize));
   WasmEdge::Runtime::Instance::ArrayInstance *Inst =
-      ModInst->newArray(TypeIdx, std::move(Args));
+      ModInst->newArray(TypeIdx, Length, BSize);
+  copyDataToArray(*Inst, 0, *DataInst, Start, Length);
   return RefVariant(Inst->getDefType(), Inst);
 }
 
@@ -520,7 +796,8 @@ Expect<RefVariant>
 Executor::arrayNewElem(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
                        const uint32_t ElemIdx, const uint32_t Start,
                        const uint32_t Length) const noexcept {
-  const auto &VType = getArrayStorageTypeByIdx(StackMgr, TypeIdx);
+  const auto &FType =
+      getCompositeTypeByIdx(StackMgr, TypeIdx).getFieldTypes()[0];
   auto *ElemInst = getElemInstByIdx(StackMgr, ElemIdx);
   assuming(ElemInst);
   auto ElemSrc = ElemInst->getRefs();
@@ -528,12 +805,16 @@ Executor::arrayNewElem(Runtime::StackManager &StackMgr, const uint32_t TypeIdx,
       ElemSrc.size()) {
     return Unexpect(ErrCode::Value::TableOutOfBounds);
   }
-  std::vector<ValVariant> Refs(ElemSrc.begin() + Start,
-                               ElemSrc.begin() + Start + Length);
   Runtime::Instance::ModuleInstance *ModInst =
       const_cast<Runtime::Instance::ModuleInstance *>(StackMgr.getModule());
+  EXPECTED_TRY(chargeGCObject<Runtime::Instance::ArrayInstance>(
+      *ModInst, static_cast<uint64_t>(Length) * FType.getStorageSize()));
   WasmEdge::Runtime::Instance::ArrayInstance *Inst =
-      ModInst->newArray(TypeIdx, packVals(VType, std::move(Refs)));
+      ModInst->newArray(TypeIdx, Length, FType.getStorageSize());
+  // The references need no packing.
+  for (uint32_t Idx = 0; Idx < Length; Idx++) {
+    Inst->setData(Idx, ElemSrc[Start + Idx]);
+  }
   return RefVariant(Inst->getDefType(), Inst);
 }
 
@@ -565,7 +846,7 @@ Expect<void> Executor::arraySet(Runtime::StackManager &StackMgr,
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
   const auto &VType = getArrayStorageTypeByIdx(StackMgr, TypeIdx);
-  Inst->getData(Idx) = packVal(VType, Val);
+  Inst->setData(Idx, packVal(VType, Val));
   return {};
 }
 
@@ -582,8 +863,7 @@ Expect<void> Executor::arrayFill(Runtime::StackManager &StackMgr,
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
   const auto &VType = getArrayStorageTypeByIdx(StackMgr, TypeIdx);
-  auto Arr = Inst->getArray();
-  std::fill(Arr.begin() + Idx, Arr.begin() + Idx + Cnt, packVal(VType, Val));
+  Inst->fill(Idx, Cnt, packVal(VType, Val));
   return {};
 }
 
@@ -608,18 +888,13 @@ Executor::arrayInitData(Runtime::StackManager &StackMgr, const RefVariant &Ref,
       DataInst->getData().size()) {
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
-
-  for (uint32_t Idx = 0; Idx < Cnt; Idx++) {
-    // The value has been packed.
-    Inst->getData(DstIdx + Idx) =
-        DataInst->loadValue(SrcIdx + Idx * BSize, BSize);
-  }
+  copyDataToArray(*Inst, DstIdx, *DataInst, SrcIdx, Cnt);
   return {};
 }
 
 Expect<void>
 Executor::arrayInitElem(Runtime::StackManager &StackMgr, const RefVariant &Ref,
-                        const uint32_t TypeIdx, const uint32_t ElemIdx,
+                        const uint32_t, const uint32_t ElemIdx,
                         const uint32_t DstIdx, const uint32_t SrcIdx,
                         const uint32_t Cnt) const noexcept {
   auto *Inst = Ref.getPtr<Runtime::Instance::ArrayInstance>();
@@ -630,7 +905,6 @@ Executor::arrayInitElem(Runtime::StackManager &StackMgr, const RefVariant &Ref,
       Inst->getLength()) {
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
-  const auto &VType = getArrayStorageTypeByIdx(StackMgr, TypeIdx);
   auto *ElemInst = getElemInstByIdx(StackMgr, ElemIdx);
   assuming(ElemInst);
   auto ElemSrc = ElemInst->getRefs();
@@ -639,18 +913,17 @@ Executor::arrayInitElem(Runtime::StackManager &StackMgr, const RefVariant &Ref,
     return Unexpect(ErrCode::Value::TableOutOfBounds);
   }
 
-  auto Arr = Inst->getArray();
-  // The value has been packed.
-  std::transform(ElemSrc.begin() + SrcIdx, ElemSrc.begin() + SrcIdx + Cnt,
-                 Arr.begin() + DstIdx,
-                 [&](const RefVariant &V) { return packVal(VType, V); });
+  // The references need no packing.
+  for (uint32_t Idx = 0; Idx < Cnt; Idx++) {
+    Inst->setData(DstIdx + Idx, ElemSrc[SrcIdx + Idx]);
+  }
   return {};
 }
 
 Expect<void>
-Executor::arrayCopy(Runtime::StackManager &StackMgr, const RefVariant &DstRef,
-                    const uint32_t DstTypeIdx, const uint32_t DstIdx,
-                    const RefVariant &SrcRef, const uint32_t SrcTypeIdx,
+Executor::arrayCopy(Runtime::StackManager &, const RefVariant &DstRef,
+                    const uint32_t, const uint32_t DstIdx,
+                    const RefVariant &SrcRef, const uint32_t,
                     const uint32_t SrcIdx, const uint32_t Cnt) const noexcept {
   auto *SrcInst = SrcRef.getPtr<Runtime::Instance::ArrayInstance>();
   auto *DstInst = DstRef.getPtr<Runtime::Instance::ArrayInstance>();
@@ -669,22 +942,16 @@ Executor::arrayCopy(Runtime::StackManager &StackMgr, const RefVariant &DstRef,
     return Unexpect(ErrCode::Value::ArrayOutOfBounds);
   }
 
-  auto SrcArr = SrcInst->getArray();
-  auto DstArr = DstInst->getArray();
-  const auto &SrcVType = getArrayStorageTypeByIdx(StackMgr, SrcTypeIdx);
-  const auto &DstVType = getArrayStorageTypeByIdx(StackMgr, DstTypeIdx);
-  if (DstIdx <= SrcIdx) {
-    std::transform(SrcArr.begin() + SrcIdx, SrcArr.begin() + SrcIdx + Cnt,
-                   DstArr.begin() + DstIdx, [&](const ValVariant &V) {
-                     return packVal(DstVType, unpackVal(SrcVType, V));
-                   });
-  } else {
-    std::transform(std::make_reverse_iterator(SrcArr.begin() + SrcIdx + Cnt),
-                   std::make_reverse_iterator(SrcArr.begin() + SrcIdx),
-                   std::make_reverse_iterator(DstArr.begin() + DstIdx + Cnt),
-                   [&](const ValVariant &V) {
-                     return packVal(DstVType, unpackVal(SrcVType, V));
-                   });
+  // The validated storage types of both arrays are the same in the packed
+  // sizes, so the packed elements are copied as they are.
+  const uint32_t ESize = DstInst->getElemSize();
+  assuming(SrcInst->getElemSize() == ESize);
+  if (Cnt > 0) {
+    auto DstBytes = DstInst->getBytes();
+    auto SrcBytes = std::as_const(*SrcInst).getBytes();
+    std::memmove(DstBytes.data() + static_cast<size_t>(DstIdx) * ESize,
+                 SrcBytes.data() + static_cast<size_t>(SrcIdx) * ESize,
+                 static_cast<size_t>(Cnt) * ESize);
   }
   return {};
 }
@@ -81,9 +81,9 @@ Executor::runTableCopyOp(Runtime::StackManager &StackMgr,
   uint32_t Dst = StackMgr.pop().get<uint32_t>();
 
   // Replace tab_dst[Dst : Dst + Len] with tab_src[Src : Src + Len].
-  return TabInstSrc.getRefs(0, Src + Len)
+  return TabInstSrc.getRefs(Src, Len)
       .and_then(
-          [&](auto Refs) { return TabInstDst.setRefs(Refs, Dst, Src, Len); })
+          [&](auto Refs) { return TabInstDst.setRefs(Refs, Dst, 0, Len); })
       .map_error([&Instr](auto E) {
         spdlog::error(
             ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
@@ -3,9 +3,34 @@
 
 #include "executor/executor.h"
 
+#if WASMEDGE_OS_LINUX
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace WasmEdge {
 namespace Executor {
 
+#if WASMEDGE_OS_LINUX
+namespace {
+/// Sleep while the futex word equals to the value, until the relative timeout
+/// if given.
+void futexWait(std::atomic<uint32_t> &Word, uint32_t Value,
+               const struct timespec *Timeout) noexcept {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&Word), FUTEX_WAIT_PRIVATE,
+          Value, Timeout, nullptr, 0);
+}
+/// Wake up the threads sleeping on the futex word.
+void futexWake(std::atomic<uint32_t> &Word) noexcept {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&Word), FUTEX_WAKE_PRIVATE,
+          INT_MAX, nullptr, nullptr, 0);
+}
+} // namespace
+#endif
+
 Expect<void>
 Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
                             Runtime::Instance::MemoryInstance &MemInst,
@@ -13,19 +38,9 @@ Executor::runAtomicNotifyOp(Runtime::StackManager &StackMgr,
   ValVariant RawCount = StackMgr.pop();
   ValVariant &RawAddress = StackMgr.getTop();
 
-  uint32_t Address = RawAddress.get<uint32_t>();
-
-  if (Address >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
-    spdlog::error(ErrInfo::InfoBoundary(
-        Address + static_cast<uint64_t>(Instr.getMemoryOffset()),
-        sizeof(uint32_t), MemInst.getBoundIdx()));
-    spdlog::error(
-        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
-    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
-  }
-  Address += Instr.getMemoryOffset();
+  EXPECTED_TRY(const uint64_t Address,
+               getEffectiveAddress(MemInst, getAddress(RawAddress, MemInst),
+                                   sizeof(uint32_t), Instr));
 
   if (Address % sizeof(uint32_t) != 0) {
     spdlog::error(ErrCode::Value::UnalignedAtomicAccess);
@@ -54,34 +69,90 @@ Expect<void> Executor::runMemoryFenceOp() {
 
 Expect<uint32_t>
 Executor::atomicNotify(Runtime::Instance::MemoryInstance &MemInst,
-                       uint32_t Address, uint32_t Count) noexcept {
+                       uint64_t Address, uint32_t Count) noexcept {
   // The error message should be handled by the caller, or the AOT mode will
   // produce the duplicated messages.
-  if (auto *AtomicObj = MemInst.getPointer<std::atomic<uint32_t> *>(Address);
+  if (auto *AtomicObj =
+          MemInst.getPointer<const std::atomic<uint32_t> *>(Address);
       !AtomicObj) {
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
 
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
+  // The waiters are linked before checking the values, so the shard without
+  // waiters has no waiter of the value changed before.
+  auto &Shard = getWaiterShard(MemInst, Address);
+  if (Shard.Count.load() == 0) {
+    return 0;
+  }
+  std::unique_lock Lock(Shard.Mutex);
   uint32_t Total = 0;
-  auto Range = WaiterMap.equal_range(Address);
-  for (auto Iterator = Range.first; Total < Count && Iterator != Range.second;
-       ++Iterator) {
-    if (likely(&MemInst == Iterator->second.MemInst)) {
-      Iterator->second.Cond.notify_all();
+  for (Waiter *W = Shard.Head; Total < Count && W != nullptr;) {
+    Waiter *Next = W->Next;
+    if (W->MemInst == &MemInst && W->Address == Address) {
+      Shard.unlink(*W);
+      unparkWaiter(Shard, *W, Waiter::Notified);
       ++Total;
     }
+    W = Next;
   }
   return Total;
 }
 
 void Executor::atomicNotifyAll() noexcept {
-  std::unique_lock<decltype(WaiterMapMutex)> Locker(WaiterMapMutex);
-  for (auto Iterator = WaiterMap.begin(); Iterator != WaiterMap.end();
-       ++Iterator) {
-    Iterator->second.Cond.notify_all();
+  for (auto &Shard : WaiterShards) {
+    std::unique_lock Lock(Shard.Mutex);
+    while (Shard.Head) {
+      Waiter &W = *Shard.Head;
+      Shard.unlink(W);
+      unparkWaiter(Shard, W, Waiter::Interrupted);
+    }
   }
 }
 
+void Executor::parkWaiter(
+    [[maybe_unused]] WaiterShard &Shard, std::unique_lock<std::mutex> &Lock,
+    Waiter &W, const std::chrono::steady_clock::time_point *Until) noexcept {
+#if WASMEDGE_OS_LINUX
+  // Sleep on the futex word of the waiter without the lock.
+  Lock.unlock();
+  while (W.State.load(std::memory_order_acquire) == Waiter::Waiting) {
+    if (!Until) {
+      futexWait(W.State, Waiter::Waiting, nullptr);
+      continue;
+    }
+    const auto Now = std::chrono::steady_clock::now();
+    if (Now >= *Until) {
+      break;
+    }
+    const auto Rest =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(*Until - Now);
+    struct timespec Timeout;
+    Timeout.tv_sec = static_cast<time_t>(Rest.count() / 1000000000);
+    Timeout.tv_nsec = static_cast<long>(Rest.count() % 1000000000);
+    futexWait(W.State, Waiter::Waiting, &Timeout);
+  }
+  Lock.lock();
+#else
+  auto Woken = [&W]() noexcept {
+    return W.State.load(std::memory_order_relaxed) != Waiter::Waiting;
+  };
+  if (!Until) {
+    Shard.Cond.wait(Lock, Woken);
+  } else {
+    Shard.Cond.wait_until(Lock, *Until, Woken);
+  }
+#endif
+}
+
+void Executor::unparkWaiter([[maybe_unused]] WaiterShard &Shard, Waiter &W,
+                            uint32_t State) noexcept {
+  W.State.store(State, std::memory_order_release);
+#if WASMEDGE_OS_LINUX
+  futexWake(W.State);
+#else
+  Shard.Cond.notify_all();
+#endif
+}
+
 } // namespace Executor
 } // namespace WasmEdge
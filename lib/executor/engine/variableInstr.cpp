@@ -8,38 +8,205 @@
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Copy the value in the size recorded by the validator. The number values
+/// are written in their own sizes, so the copies in the same sizes halve the
+/// memory traffic and let the loads be forwarded from the stores.
+inline void copyValue(ValVariant &Dst, const ValVariant &Src,
+                      uint32_t ValueSize) noexcept {
+  switch (ValueSize) {
+  case 4:
+    Dst.emplace<uint32_t>(Src.get<uint32_t>());
+    break;
+  case 8:
+    Dst.emplace<uint64_t>(Src.get<uint64_t>());
+    break;
+  default:
+    Dst = Src;
+    break;
+  }
+}
+
+inline void pushValue(Runtime::StackManager &StackMgr, const ValVariant &Src,
+                      uint32_t ValueSize) noexcept {
+  switch (ValueSize) {
+  case 4:
+    StackMgr.push(Src.get<uint32_t>());
+    break;
+  case 8:
+    StackMgr.push(Src.get<uint64_t>());
+    break;
+  default:
+    StackMgr.push(Src);
+    break;
+  }
+}
+} // namespace
+
 Expect<void> Executor::runLocalGetOp(Runtime::StackManager &StackMgr,
-                                     uint32_t StackOffset) const noexcept {
-  StackMgr.push(StackMgr.getTopN(StackOffset));
+                                     uint32_t StackOffset,
+                                     uint32_t ValueSize) const noexcept {
+  pushValue(StackMgr, StackMgr.getTopN(StackOffset), ValueSize);
   return {};
 }
 
 Expect<void> Executor::runLocalSetOp(Runtime::StackManager &StackMgr,
-                                     uint32_t StackOffset) const noexcept {
-  StackMgr.getTopN(StackOffset - 1) = StackMgr.pop();
+                                     uint32_t StackOffset,
+                                     uint32_t ValueSize) const noexcept {
+  copyValue(StackMgr.getTopN(StackOffset), StackMgr.getTop(), ValueSize);
+  StackMgr.pop();
   return {};
 }
 
 Expect<void> Executor::runLocalTeeOp(Runtime::StackManager &StackMgr,
-                                     uint32_t StackOffset) const noexcept {
-  const ValVariant &Val = StackMgr.getTop();
-  StackMgr.getTopN(StackOffset) = Val;
+                                     uint32_t StackOffset,
+                                     uint32_t ValueSize) const noexcept {
+  copyValue(StackMgr.getTopN(StackOffset), StackMgr.getTop(), ValueSize);
   return {};
 }
 
 Expect<void> Executor::runGlobalGetOp(Runtime::StackManager &StackMgr,
-                                      uint32_t Idx) const noexcept {
+                                      uint32_t Idx,
+                                      uint32_t ValueSize) const noexcept {
   auto *GlobInst = getGlobInstByIdx(StackMgr, Idx);
   assuming(GlobInst);
-  StackMgr.push(GlobInst->getValue());
+  pushValue(StackMgr, GlobInst->getValue(), ValueSize);
   return {};
 }
 
 Expect<void> Executor::runGlobalSetOp(Runtime::StackManager &StackMgr,
-                                      uint32_t Idx) const noexcept {
+                                      uint32_t Idx,
+                                      uint32_t ValueSize) const noexcept {
   auto *GlobInst = getGlobInstByIdx(StackMgr, Idx);
   assuming(GlobInst);
-  GlobInst->setValue(StackMgr.pop());
+  copyValue(GlobInst->getValue(), StackMgr.getTop(), ValueSize);
+  StackMgr.pop();
+  return {};
+}
+
+Expect<void>
+Executor::runSuperInstrOp(Runtime::StackManager &StackMgr,
+                          const AST::Instruction &Instr,
+                          AST::InstrView::iterator &PC) const noexcept {
+  using SuperInstr = AST::Instruction::SuperInstr;
+  const AST::Instruction &Second = *(PC + 1);
+  const AST::Instruction &BinOp = *(PC + 2);
+
+  // The stack offsets of the following instructions were recorded with the
+  // intermediate value on the stack, which is not pushed here.
+  ValVariant Lhs = StackMgr.getTopN(Instr.getStackOffset());
+  ValVariant Rhs;
+  switch (Instr.getSuperInstr()) {
+  case SuperInstr::LocalLocalBinOp:
+  case SuperInstr::LocalLocalBinOpSet:
+    Rhs = StackMgr.getTopN(Second.getStackOffset() - 1);
+    break;
+  case SuperInstr::LocalConstBinOp:
+  case SuperInstr::LocalConstBinOpSet:
+    Rhs = Second.getNum();
+    break;
+  default:
+    assumingUnreachable();
+  }
+
+  switch (BinOp.getOpCode()) {
+  case OpCode::I32__eq:
+    runEqOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__ne:
+    runNeOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__lt_s:
+    runLtOp<int32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__lt_u:
+    runLtOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__gt_s:
+    runGtOp<int32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__gt_u:
+    runGtOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__le_s:
+    runLeOp<int32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__le_u:
+    runLeOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__ge_s:
+    runGeOp<int32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__ge_u:
+    runGeOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__add:
+    runAddOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__sub:
+    runSubOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__mul:
+    runMulOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__and:
+    runAndOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__or:
+    runOrOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__xor:
+    runXorOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__shl:
+    runShlOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__shr_s:
+    runShrOp<int32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I32__shr_u:
+    runShrOp<uint32_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__add:
+    runAddOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__sub:
+    runSubOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__mul:
+    runMulOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__and:
+    runAndOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__or:
+    runOrOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__xor:
+    runXorOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__shl:
+    runShlOp<uint64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__shr_s:
+    runShrOp<int64_t>(Lhs, Rhs);
+    break;
+  case OpCode::I64__shr_u:
+    runShrOp<uint64_t>(Lhs, Rhs);
+    break;
+  default:
+    assumingUnreachable();
+  }
+
+  if (Instr.getSuperInstr() == SuperInstr::LocalLocalBinOpSet ||
+      Instr.getSuperInstr() == SuperInstr::LocalConstBinOpSet) {
+    const AST::Instruction &Set = *(PC + 3);
+    StackMgr.getTopN(Set.getStackOffset() - 1) = Lhs;
+    PC += 3;
+  } else {
+    StackMgr.push(Lhs);
+    PC += 2;
+  }
   return {};
 }
 
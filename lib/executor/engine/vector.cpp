@@ -0,0 +1,517 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "executor/engine/vector_helper.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define WASMEDGE_VECTOR_SSE 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <smmintrin.h>
+#include <tmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON) &&                          \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define WASMEDGE_VECTOR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace WasmEdge {
+namespace Executor {
+namespace detail {
+
+#if defined(WASMEDGE_VECTOR_SSE)
+
+namespace {
+
+template <typename T> __m128i load(const T &V) noexcept {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(&V));
+}
+template <typename T> void store(T &V, __m128i R) noexcept {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(&V), R);
+}
+
+// SSE2 is the baseline of x86-64. SSSE3 and SSE4.1 are detected once.
+#if defined(__SSSE3__)
+constexpr bool hasSSSE3() noexcept { return true; }
+#define WASMEDGE_VECTOR_SSSE3
+#else
+bool hasSSSE3() noexcept {
+  static const bool Result = __builtin_cpu_supports("ssse3");
+  return Result;
+}
+#define WASMEDGE_VECTOR_SSSE3 [[gnu::target("ssse3")]]
+#endif
+#if defined(__SSE4_1__)
+constexpr bool hasSSE41() noexcept { return true; }
+#define WASMEDGE_VECTOR_SSE41
+#else
+bool hasSSE41() noexcept {
+  static const bool Result = __builtin_cpu_supports("sse4.1");
+  return Result;
+}
+#define WASMEDGE_VECTOR_SSE41 [[gnu::target("sse4.1")]]
+#endif
+#if defined(__FMA__)
+constexpr bool hasFMA() noexcept { return true; }
+#define WASMEDGE_VECTOR_FMA
+#else
+bool hasFMA() noexcept {
+  static const bool Result = __builtin_cpu_supports("fma");
+  return Result;
+}
+#define WASMEDGE_VECTOR_FMA [[gnu::target("fma")]]
+#endif
+
+WASMEDGE_VECTOR_SSSE3 void swizzleSSSE3(uint8x16_t &Vector,
+                                        const uint8x16_t &Index) noexcept {
+  // The `pshufb` zeroes the lanes whose index has the top bit set. Saturating
+  // adding 0x70 sets it for all the indices not less than 16.
+  const __m128i I = _mm_adds_epu8(load(Index), _mm_set1_epi8(0x70));
+  store(Vector, _mm_shuffle_epi8(load(Vector), I));
+}
+
+WASMEDGE_VECTOR_SSSE3 void shuffleSSSE3(uint8x16_t &V1, const uint8x16_t &V2,
+                                        const uint8x16_t &Index) noexcept {
+  // The indices are less than 32. Select the lanes of V1 with the indices
+  // less than 16, and the lanes of V2 with the other indices.
+  const __m128i I = load(Index);
+  const __m128i I1 = _mm_or_si128(I, _mm_cmpgt_epi8(I, _mm_set1_epi8(15)));
+  const __m128i I2 = _mm_sub_epi8(I, _mm_set1_epi8(16));
+  store(V1, _mm_or_si128(_mm_shuffle_epi8(load(V1), I1),
+                         _mm_shuffle_epi8(load(V2), I2)));
+}
+
+WASMEDGE_VECTOR_SSSE3 void q15MulrSatSSSE3(int16x8_t &V1,
+                                           const int16x8_t &V2) noexcept {
+  // The `pmulhrsw` only overflows for -32768 * -32768, which results in
+  // -32768 and should be saturated to 32767.
+  const __m128i R = _mm_mulhrs_epi16(load(V1), load(V2));
+  const __m128i Over = _mm_cmpeq_epi16(R, _mm_set1_epi16(INT16_MIN));
+  store(V1, _mm_xor_si128(R, Over));
+}
+
+WASMEDGE_VECTOR_SSSE3 void relaxedSwizzleSSSE3(
+    uint8x16_t &Vector, const uint8x16_t &Index) noexcept {
+  // The lanes of the indices not less than 16 are either zeroed or selected
+  // by the low 4 bits, both of which are allowed.
+  store(Vector, _mm_shuffle_epi8(load(Vector), load(Index)));
+}
+
+WASMEDGE_VECTOR_SSSE3 __m128i relaxedDotSSSE3(const int8x16_t &V1,
+                                              const int8x16_t &V2) noexcept {
+  // The `pmaddubsw` is unsigned(first) * signed(second) with the saturated
+  // sums, which is allowed for the 7-bit V2.
+  return _mm_maddubs_epi16(load(V2), load(V1));
+}
+
+WASMEDGE_VECTOR_FMA void relaxedMAddFMA(floatx4_t &V1, const floatx4_t &V2,
+                                        const floatx4_t &V3,
+                                        bool Negate) noexcept {
+  const __m128 A = _mm_loadu_ps(reinterpret_cast<const float *>(&V1));
+  const __m128 B = _mm_loadu_ps(reinterpret_cast<const float *>(&V2));
+  const __m128 C = _mm_loadu_ps(reinterpret_cast<const float *>(&V3));
+  _mm_storeu_ps(reinterpret_cast<float *>(&V1),
+                Negate ? _mm_fnmadd_ps(A, B, C) : _mm_fmadd_ps(A, B, C));
+}
+
+WASMEDGE_VECTOR_FMA void relaxedMAddFMA(doublex2_t &V1, const doublex2_t &V2,
+                                        const doublex2_t &V3,
+                                        bool Negate) noexcept {
+  const __m128d A = _mm_loadu_pd(reinterpret_cast<const double *>(&V1));
+  const __m128d B = _mm_loadu_pd(reinterpret_cast<const double *>(&V2));
+  const __m128d C = _mm_loadu_pd(reinterpret_cast<const double *>(&V3));
+  _mm_storeu_pd(reinterpret_cast<double *>(&V1),
+                Negate ? _mm_fnmadd_pd(A, B, C) : _mm_fmadd_pd(A, B, C));
+}
+
+WASMEDGE_VECTOR_SSE41 void narrowSSE41(uint16x8_t &Result, const int32x4_t &V1,
+                                       const int32x4_t &V2) noexcept {
+  store(Result, _mm_packus_epi32(load(V1), load(V2)));
+}
+
+} // namespace
+
+bool vectorSwizzle(uint8x16_t &Vector, const uint8x16_t &Index) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  swizzleSSSE3(Vector, Index);
+  return true;
+}
+
+bool vectorShuffle(uint8x16_t &V1, const uint8x16_t &V2,
+                   const uint8x16_t &Index) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  shuffleSSSE3(V1, V2, Index);
+  return true;
+}
+
+bool vectorAddSat(int8x16_t &V1, const int8x16_t &V2) noexcept {
+  store(V1, _mm_adds_epi8(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorAddSat(uint8x16_t &V1, const uint8x16_t &V2) noexcept {
+  store(V1, _mm_adds_epu8(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorAddSat(int16x8_t &V1, const int16x8_t &V2) noexcept {
+  store(V1, _mm_adds_epi16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorAddSat(uint16x8_t &V1, const uint16x8_t &V2) noexcept {
+  store(V1, _mm_adds_epu16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorSubSat(int8x16_t &V1, const int8x16_t &V2) noexcept {
+  store(V1, _mm_subs_epi8(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorSubSat(uint8x16_t &V1, const uint8x16_t &V2) noexcept {
+  store(V1, _mm_subs_epu8(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorSubSat(int16x8_t &V1, const int16x8_t &V2) noexcept {
+  store(V1, _mm_subs_epi16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorSubSat(uint16x8_t &V1, const uint16x8_t &V2) noexcept {
+  store(V1, _mm_subs_epu16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorNarrow(int8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept {
+  store(Result, _mm_packs_epi16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorNarrow(uint8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept {
+  store(Result, _mm_packus_epi16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorNarrow(int16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept {
+  store(Result, _mm_packs_epi32(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorNarrow(uint16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept {
+  if (!hasSSE41()) {
+    return false;
+  }
+  narrowSSE41(Result, V1, V2);
+  return true;
+}
+
+bool vectorQ15MulrSat(int16x8_t &V1, const int16x8_t &V2) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  q15MulrSatSSSE3(V1, V2);
+  return true;
+}
+
+bool vectorDot(int32x4_t &Result, const int16x8_t &V1,
+               const int16x8_t &V2) noexcept {
+  store(Result, _mm_madd_epi16(load(V1), load(V2)));
+  return true;
+}
+
+bool vectorTruncSat(int32x4_t &Result, const floatx4_t &V) noexcept {
+  // The `cvttps2dq` results in INT32_MIN for NaN and the values out of range.
+  // Flip it to INT32_MAX for the positive overflows, and clear it for NaN.
+  const __m128 X = _mm_loadu_ps(reinterpret_cast<const float *>(&V));
+  const __m128i Y = _mm_cvttps_epi32(X);
+  const __m128 Over = _mm_cmpge_ps(X, _mm_set1_ps(2147483648.0f));
+  const __m128 Ord = _mm_cmpord_ps(X, X);
+  store(Result, _mm_and_si128(_mm_xor_si128(Y, _mm_castps_si128(Over)),
+                              _mm_castps_si128(Ord)));
+  return true;
+}
+
+bool vectorTruncSat(uint32x4_t &, const floatx4_t &) noexcept { return false; }
+
+bool vectorRelaxedSwizzle(uint8x16_t &Vector,
+                          const uint8x16_t &Index) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  relaxedSwizzleSSSE3(Vector, Index);
+  return true;
+}
+
+bool vectorRelaxedMAdd(floatx4_t &V1, const floatx4_t &V2, const floatx4_t &V3,
+                       bool Negate) noexcept {
+  if (!hasFMA()) {
+    return false;
+  }
+  relaxedMAddFMA(V1, V2, V3, Negate);
+  return true;
+}
+
+bool vectorRelaxedMAdd(doublex2_t &V1, const doublex2_t &V2,
+                       const doublex2_t &V3, bool Negate) noexcept {
+  if (!hasFMA()) {
+    return false;
+  }
+  relaxedMAddFMA(V1, V2, V3, Negate);
+  return true;
+}
+
+bool vectorRelaxedDot(int16x8_t &Result, const int8x16_t &V1,
+                      const int8x16_t &V2) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  store(Result, relaxedDotSSSE3(V1, V2));
+  return true;
+}
+
+bool vectorRelaxedDotAdd(int32x4_t &Result, const int8x16_t &V1,
+                         const int8x16_t &V2, const int32x4_t &C) noexcept {
+  if (!hasSSSE3()) {
+    return false;
+  }
+  const __m128i Sum =
+      _mm_madd_epi16(relaxedDotSSSE3(V1, V2), _mm_set1_epi16(1));
+  store(Result, _mm_add_epi32(Sum, load(C)));
+  return true;
+}
+
+#elif defined(WASMEDGE_VECTOR_NEON)
+
+// NEON is the baseline of AArch64, and its saturating and table lookup
+// instructions match the semantics of WebAssembly directly.
+
+bool vectorSwizzle(uint8x16_t &Vector, const uint8x16_t &Index) noexcept {
+  const auto *V = reinterpret_cast<const uint8_t *>(&Vector);
+  const auto *I = reinterpret_cast<const uint8_t *>(&Index);
+  vst1q_u8(reinterpret_cast<uint8_t *>(&Vector),
+           vqtbl1q_u8(vld1q_u8(V), vld1q_u8(I)));
+  return true;
+}
+
+bool vectorShuffle(uint8x16_t &V1, const uint8x16_t &V2,
+                   const uint8x16_t &Index) noexcept {
+  uint8x16x2_t Table;
+  Table.val[0] = vld1q_u8(reinterpret_cast<const uint8_t *>(&V1));
+  Table.val[1] = vld1q_u8(reinterpret_cast<const uint8_t *>(&V2));
+  const auto I = vld1q_u8(reinterpret_cast<const uint8_t *>(&Index));
+  vst1q_u8(reinterpret_cast<uint8_t *>(&V1), vqtbl2q_u8(Table, I));
+  return true;
+}
+
+#define WASMEDGE_VECTOR_NEON_BINARY(Func, Type, Lane, Op, Suffix)              \
+  bool Func(Type &V1, const Type &V2) noexcept {                               \
+    auto *P1 = reinterpret_cast<Lane *>(&V1);                                  \
+    const auto *P2 = reinterpret_cast<const Lane *>(&V2);                      \
+    vst1q_##Suffix(P1, Op##_##Suffix(vld1q_##Suffix(P1), vld1q_##Suffix(P2))); \
+    return true;                                                               \
+  }
+
+WASMEDGE_VECTOR_NEON_BINARY(vectorAddSat, int8x16_t, int8_t, vqaddq, s8)
+WASMEDGE_VECTOR_NEON_BINARY(vectorAddSat, uint8x16_t, uint8_t, vqaddq, u8)
+WASMEDGE_VECTOR_NEON_BINARY(vectorAddSat, int16x8_t, int16_t, vqaddq, s16)
+WASMEDGE_VECTOR_NEON_BINARY(vectorAddSat, uint16x8_t, uint16_t, vqaddq, u16)
+WASMEDGE_VECTOR_NEON_BINARY(vectorSubSat, int8x16_t, int8_t, vqsubq, s8)
+WASMEDGE_VECTOR_NEON_BINARY(vectorSubSat, uint8x16_t, uint8_t, vqsubq, u8)
+WASMEDGE_VECTOR_NEON_BINARY(vectorSubSat, int16x8_t, int16_t, vqsubq, s16)
+WASMEDGE_VECTOR_NEON_BINARY(vectorSubSat, uint16x8_t, uint16_t, vqsubq, u16)
+// The rounding doubling multiply is equal to the Q15 rounding multiply.
+WASMEDGE_VECTOR_NEON_BINARY(vectorQ15MulrSat, int16x8_t, int16_t, vqrdmulhq,
+                            s16)
+
+#undef WASMEDGE_VECTOR_NEON_BINARY
+
+bool vectorNarrow(int8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept {
+  const auto L = vld1q_s16(reinterpret_cast<const int16_t *>(&V1));
+  const auto H = vld1q_s16(reinterpret_cast<const int16_t *>(&V2));
+  vst1q_s8(reinterpret_cast<int8_t *>(&Result),
+           vqmovn_high_s16(vqmovn_s16(L), H));
+  return true;
+}
+
+bool vectorNarrow(uint8x16_t &Result, const int16x8_t &V1,
+                  const int16x8_t &V2) noexcept {
+  const auto L = vld1q_s16(reinterpret_cast<const int16_t *>(&V1));
+  const auto H = vld1q_s16(reinterpret_cast<const int16_t *>(&V2));
+  vst1q_u8(reinterpret_cast<uint8_t *>(&Result),
+           vqmovun_high_s16(vqmovun_s16(L), H));
+  return true;
+}
+
+bool vectorNarrow(int16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept {
+  const auto L = vld1q_s32(reinterpret_cast<const int32_t *>(&V1));
+  const auto H = vld1q_s32(reinterpret_cast<const int32_t *>(&V2));
+  vst1q_s16(reinterpret_cast<int16_t *>(&Result),
+            vqmovn_high_s32(vqmovn_s32(L), H));
+  return true;
+}
+
+bool vectorNarrow(uint16x8_t &Result, const int32x4_t &V1,
+                  const int32x4_t &V2) noexcept {
+  const auto L = vld1q_s32(reinterpret_cast<const int32_t *>(&V1));
+  const auto H = vld1q_s32(reinterpret_cast<const int32_t *>(&V2));
+  vst1q_u16(reinterpret_cast<uint16_t *>(&Result),
+            vqmovun_high_s32(vqmovun_s32(L), H));
+  return true;
+}
+
+bool vectorDot(int32x4_t &Result, const int16x8_t &V1,
+               const int16x8_t &V2) noexcept {
+  const auto A = vld1q_s16(reinterpret_cast<const int16_t *>(&V1));
+  const auto B = vld1q_s16(reinterpret_cast<const int16_t *>(&V2));
+  // The pairwise sum wraps around as the WebAssembly semantics.
+  const auto L = vmull_s16(vget_low_s16(A), vget_low_s16(B));
+  const auto H = vmull_high_s16(A, B);
+  vst1q_s32(reinterpret_cast<int32_t *>(&Result), vpaddq_s32(L, H));
+  return true;
+}
+
+bool vectorTruncSat(int32x4_t &Result, const floatx4_t &V) noexcept {
+  // The conversion saturates and results in 0 for NaN.
+  vst1q_s32(reinterpret_cast<int32_t *>(&Result),
+            vcvtq_s32_f32(vld1q_f32(reinterpret_cast<const float *>(&V))));
+  return true;
+}
+
+bool vectorTruncSat(uint32x4_t &Result, const floatx4_t &V) noexcept {
+  vst1q_u32(reinterpret_cast<uint32_t *>(&Result),
+            vcvtq_u32_f32(vld1q_f32(reinterpret_cast<const float *>(&V))));
+  return true;
+}
+
+bool vectorRelaxedSwizzle(uint8x16_t &Vector,
+                          const uint8x16_t &Index) noexcept {
+  return vectorSwizzle(Vector, Index);
+}
+
+bool vectorRelaxedMAdd(floatx4_t &V1, const floatx4_t &V2, const floatx4_t &V3,
+                       bool Negate) noexcept {
+  auto *P1 = reinterpret_cast<float *>(&V1);
+  const auto A = vld1q_f32(P1);
+  const auto B = vld1q_f32(reinterpret_cast<const float *>(&V2));
+  const auto C = vld1q_f32(reinterpret_cast<const float *>(&V3));
+  vst1q_f32(P1, Negate ? vfmsq_f32(C, A, B) : vfmaq_f32(C, A, B));
+  return true;
+}
+
+bool vectorRelaxedMAdd(doublex2_t &V1, const doublex2_t &V2,
+                       const doublex2_t &V3, bool Negate) noexcept {
+  auto *P1 = reinterpret_cast<double *>(&V1);
+  const auto A = vld1q_f64(P1);
+  const auto B = vld1q_f64(reinterpret_cast<const double *>(&V2));
+  const auto C = vld1q_f64(reinterpret_cast<const double *>(&V3));
+  vst1q_f64(P1, Negate ? vfmsq_f64(C, A, B) : vfmaq_f64(C, A, B));
+  return true;
+}
+
+namespace {
+::int16x8_t relaxedDotNEON(const int8x16_t &V1,
+                           const int8x16_t &V2) noexcept {
+  const auto A = vld1q_s8(reinterpret_cast<const int8_t *>(&V1));
+  const auto B = vld1q_s8(reinterpret_cast<const int8_t *>(&V2));
+  // The pairwise sums of the products of 8-bit and 7-bit values never
+  // overflow.
+  const auto L = vmull_s8(vget_low_s8(A), vget_low_s8(B));
+  const auto H = vmull_high_s8(A, B);
+  return vpaddq_s16(L, H);
+}
+} // namespace
+
+bool vectorRelaxedDot(int16x8_t &Result, const int8x16_t &V1,
+                      const int8x16_t &V2) noexcept {
+  vst1q_s16(reinterpret_cast<int16_t *>(&Result), relaxedDotNEON(V1, V2));
+  return true;
+}
+
+bool vectorRelaxedDotAdd(int32x4_t &Result, const int8x16_t &V1,
+                         const int8x16_t &V2, const int32x4_t &C) noexcept {
+  const auto VC = vld1q_s32(reinterpret_cast<const int32_t *>(&C));
+#if defined(__ARM_FEATURE_DOTPROD)
+  const auto A = vld1q_s8(reinterpret_cast<const int8_t *>(&V1));
+  const auto B = vld1q_s8(reinterpret_cast<const int8_t *>(&V2));
+  vst1q_s32(reinterpret_cast<int32_t *>(&Result), vdotq_s32(VC, A, B));
+#else
+  vst1q_s32(reinterpret_cast<int32_t *>(&Result),
+            vpadalq_s16(VC, relaxedDotNEON(V1, V2)));
+#endif
+  return true;
+}
+
+#else
+
+bool vectorSwizzle(uint8x16_t &, const uint8x16_t &) noexcept { return false; }
+bool vectorShuffle(uint8x16_t &, const uint8x16_t &,
+                   const uint8x16_t &) noexcept {
+  return false;
+}
+bool vectorAddSat(int8x16_t &, const int8x16_t &) noexcept { return false; }
+bool vectorAddSat(uint8x16_t &, const uint8x16_t &) noexcept { return false; }
+bool vectorAddSat(int16x8_t &, const int16x8_t &) noexcept { return false; }
+bool vectorAddSat(uint16x8_t &, const uint16x8_t &) noexcept { return false; }
+bool vectorSubSat(int8x16_t &, const int8x16_t &) noexcept { return false; }
+bool vectorSubSat(uint8x16_t &, const uint8x16_t &) noexcept { return false; }
+bool vectorSubSat(int16x8_t &, const int16x8_t &) noexcept { return false; }
+bool vectorSubSat(uint16x8_t &, const uint16x8_t &) noexcept { return false; }
+bool vectorNarrow(int8x16_t &, const int16x8_t &, const int16x8_t &) noexcept {
+  return false;
+}
+bool vectorNarrow(uint8x16_t &, const int16x8_t &, const int16x8_t &) noexcept {
+  return false;
+}
+bool vectorNarrow(int16x8_t &, const int32x4_t &, const int32x4_t &) noexcept {
+  return false;
+}
+bool vectorNarrow(uint16x8_t &, const int32x4_t &, const int32x4_t &) noexcept {
+  return false;
+}
+bool vectorQ15MulrSat(int16x8_t &, const int16x8_t &) noexcept {
+  return false;
+}
+bool vectorDot(int32x4_t &, const int16x8_t &, const int16x8_t &) noexcept {
+  return false;
+}
+bool vectorTruncSat(int32x4_t &, const floatx4_t &) noexcept { return false; }
+bool vectorTruncSat(uint32x4_t &, const floatx4_t &) noexcept { return false; }
+bool vectorRelaxedSwizzle(uint8x16_t &, const uint8x16_t &) noexcept {
+  return false;
+}
+bool vectorRelaxedMAdd(floatx4_t &, const floatx4_t &, const floatx4_t &,
+                       bool) noexcept {
+  return false;
+}
+bool vectorRelaxedMAdd(doublex2_t &, const doublex2_t &, const doublex2_t &,
+                       bool) noexcept {
+  return false;
+}
+bool vectorRelaxedDot(int16x8_t &, const int8x16_t &,
+                      const int8x16_t &) noexcept {
+  return false;
+}
+bool vectorRelaxedDotAdd(int32x4_t &, const int8x16_t &, const int8x16_t &,
+                         const int32x4_t &) noexcept {
+  return false;
+}
+
+#endif
+
+} // namespace detail
+} // namespace Executor
+} // namespace WasmEdge
@@ -5,17 +5,70 @@
 
 #include "common/errinfo.h"
 #include "common/spdlog.h"
+#include "common/threadpool.h"
+#include "common/trace.h"
 #include "system/stacktrace.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 using namespace std::literals;
 
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+
+/// Maximum count of the reset stack managers kept in a thread.
+static inline constexpr const size_t kStackPoolSize = 8;
+
+/// Reset stack managers of this thread with their value stack sizes.
+thread_local std::vector<
+    std::pair<uint32_t, std::unique_ptr<Runtime::StackManager>>>
+    StackPool;
+
+/// Stack manager borrowed from the thread-local pool for an invocation. The
+/// nested invocations from host functions borrow their own ones.
+class PooledStackManager {
+public:
+  explicit PooledStackManager(uint32_t ValueStackSize) noexcept
+      : Size(ValueStackSize) {
+    for (auto It = StackPool.rbegin(); It != StackPool.rend(); ++It) {
+      if (It->first == Size) {
+        StackMgr = std::move(It->second);
+        StackPool.erase(std::next(It).base());
+        return;
+      }
+    }
+    StackMgr = std::make_unique<Runtime::StackManager>(Size);
+  }
+
+  ~PooledStackManager() noexcept {
+    if (StackPool.size() < kStackPoolSize) {
+      StackMgr->reset();
+      StackPool.emplace_back(Size, std::move(StackMgr));
+    }
+  }
+
+  Runtime::StackManager &operator*() noexcept { return *StackMgr; }
+
+private:
+  uint32_t Size;
+  std::unique_ptr<Runtime::StackManager> StackMgr;
+};
+
+} // namespace
+
 /// Instantiate a WASM Module. See "include/executor/executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
                             const AST::Module &Mod) {
+  Trace::Scope TraceScope("executor"sv, "instantiate"sv);
   return instantiate(StoreMgr, Mod).map_error([this](auto E) {
     // If Statistics is enabled, then dump it here.
     // When there is an error happened, the following execution will not
@@ -27,10 +80,25 @@ Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
   });
 }
 
+/// Instantiate a pre-linked WASM module. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+Executor::instantiateModule(Runtime::StoreManager &StoreMgr,
+                            const Runtime::Instance::ModulePrelink &Prelink) {
+  Trace::Scope TraceScope("executor"sv, "instantiate"sv);
+  return instantiate(StoreMgr, *Prelink.Module, std::nullopt, &Prelink)
+      .map_error([this](auto E) {
+        if (Stat) {
+          Stat->dumpToLog(Conf);
+        }
+        return E;
+      });
+}
+
 /// Register a named WASM module. See "include/executor/executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::registerModule(Runtime::StoreManager &StoreMgr,
                          const AST::Module &Mod, std::string_view Name) {
+  Trace::Scope TraceScope("executor"sv, "register"sv, Name);
   return instantiate(StoreMgr, Mod, Name).map_error([this](auto E) {
     // If Statistics is enabled, then dump it here.
     // When there is an error happened, the following execution will not
@@ -97,11 +165,37 @@ Expect<void> Executor::registerPostHostFunction(
   return {};
 }
 
-/// Invoke function. See "include/executor/executor.h".
-Expect<std::vector<std::pair<ValVariant, ValType>>>
-Executor::invoke(const Runtime::Instance::FunctionInstance *FuncInst,
-                 Span<const ValVariant> Params,
-                 Span<const ValType> ParamTypes) {
+/// Register the function which will be invoked when a native wasm function
+/// becomes hot in the tiered JIT mode.
+Expect<void> Executor::registerCpuSchedulerFunction(
+    std::function<bool(const Runtime::Instance::ModuleInstance &, uint64_t)>
+        Func) {
+  CpuSchedulerFunc = std::move(Func);
+  return {};
+}
+
+Expect<void> Executor::registerTierUpFunction(
+    std::function<void(const Runtime::Instance::ModuleInstance &)> Func) {
+  TierUpFunc = std::move(Func);
+  if (TierUpFunc && Conf.getRuntimeConfigure().isEnableTieredJIT()) {
+    TierUpThreshold =
+        std::max(Conf.getRuntimeConfigure().getTierUpThreshold(), UINT32_C(1));
+  } else {
+    TierUpThreshold = 0;
+  }
+  return {};
+}
+
+Expect<void>
+Executor::registerHostCallTrace(std::shared_ptr<HostCallTrace> Trace) {
+  HostTrace = std::move(Trace);
+  return {};
+}
+
+/// Check function before invoking. See "include/executor/executor.h".
+Expect<void>
+Executor::checkInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
+                      Span<const ValType> ParamTypes) const {
   if (unlikely(FuncInst == nullptr)) {
     spdlog::error(ErrCode::Value::FuncNotFound);
     return Unexpect(ErrCode::Value::FuncNotFound);
@@ -128,6 +222,16 @@ Executor::invoke(const Runtime::Instance::FunctionInstance *FuncInst,
         RTypes));
     return Unexpect(ErrCode::Value::FuncSigMismatch);
   }
+  return {};
+}
+
+/// Invoke function. See "include/executor/executor.h".
+Expect<std::vector<std::pair<ValVariant, ValType>>>
+Executor::invoke(const Runtime::Instance::FunctionInstance *FuncInst,
+                 Span<const ValVariant> Params,
+                 Span<const ValType> ParamTypes) {
+  EXPECTED_TRY(checkInvoke(FuncInst, ParamTypes));
+  const auto &RTypes = FuncInst->getFuncType().getReturnTypes();
 
   // Check the reference value validation.
   for (uint32_t I = 0; I < ParamTypes.size(); ++I) {
@@ -140,7 +244,9 @@ Executor::invoke(const Runtime::Instance::FunctionInstance *FuncInst,
     }
   }
 
-  Runtime::StackManager StackMgr;
+  PooledStackManager PooledStack(
+      Conf.getRuntimeConfigure().getValueStackSize());
+  Runtime::StackManager &StackMgr = *PooledStack;
 
   // Call runFunction.
   EXPECTED_TRY(runFunction(StackMgr, *FuncInst, Params).map_error([](auto E) {
@@ -206,6 +312,146 @@ Executor::asyncInvoke(const Runtime::Instance::FunctionInstance *FuncInst,
           std::vector(ParamTypes.begin(), ParamTypes.end())};
 }
 
+/// Invoke function without checking. See "include/executor/executor.h".
+Expect<void>
+Executor::invokeUnchecked(const Runtime::Instance::FunctionInstance &FuncInst,
+                          Span<const ValVariant> Params,
+                          Span<ValVariant> Returns) {
+  const auto &PTypes = FuncInst.getFuncType().getParamTypes();
+  const auto &RTypes = FuncInst.getFuncType().getReturnTypes();
+  assuming(Params.size() == PTypes.size() && Returns.size() == RTypes.size());
+
+  // The null references still depend on the values.
+  for (uint32_t I = 0; I < PTypes.size(); ++I) {
+    if (PTypes[I].isRefType() && (!PTypes[I].isNullableRefType() &&
+                                  Params[I].get<RefVariant>().isNull())) {
+      spdlog::error(ErrCode::Value::NonNullRequired);
+      spdlog::error("    Cannot pass a null reference as argument of {}."sv,
+                    PTypes[I]);
+      return Unexpect(ErrCode::Value::NonNullRequired);
+    }
+  }
+
+  PooledStackManager PooledStack(
+      Conf.getRuntimeConfigure().getValueStackSize());
+  Runtime::StackManager &StackMgr = *PooledStack;
+
+  EXPECTED_TRY(runFunction(StackMgr, FuncInst, Params).map_error([](auto E) {
+    if (E != ErrCode::Value::Terminated) {
+      dumpStackTrace(Span<const uint32_t>{StackTrace}.first(StackTraceSize));
+    }
+    return E;
+  }));
+
+  // The returned references keep their dynamic types in the values, and the
+  // unused bits of the numbers are erased as in `invoke`.
+  for (uint32_t I = static_cast<uint32_t>(RTypes.size()); I-- > 0;) {
+    Returns[I] = StackMgr.pop();
+    if (!RTypes[I].isRefType()) {
+      cleanNumericVal(Returns[I], RTypes[I]);
+    }
+  }
+  assuming(StackMgr.size() == 0);
+  return {};
+}
+
+/// Invoke function for a batch. See "include/executor/executor.h".
+Expect<void>
+Executor::invokeBatch(const Runtime::Instance::FunctionInstance *FuncInst,
+                      Span<const ValType> ParamTypes,
+                      Span<const void *const> Params,
+                      Span<void *const> Returns, uint32_t Rows,
+                      uint32_t Threads) {
+  EXPECTED_TRY(checkInvoke(FuncInst, ParamTypes));
+
+  // Matching columns and function type.
+  const auto &PTypes = FuncInst->getFuncType().getParamTypes();
+  const auto &RTypes = FuncInst->getFuncType().getReturnTypes();
+  if (Params.size() != PTypes.size() || Returns.size() != RTypes.size()) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    spdlog::error(ErrInfo::InfoMismatch(
+        PTypes, RTypes, std::vector(ParamTypes.begin(), ParamTypes.end()),
+        RTypes));
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
+  // Only the number types have the native layout in the columns.
+  auto IsNumType = [](const ValType &Type) { return Type.isNumType(); };
+  if (!std::all_of(PTypes.begin(), PTypes.end(), IsNumType) ||
+      !std::all_of(RTypes.begin(), RTypes.end(), IsNumType)) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    spdlog::error("    Only the number types can be invoked in batches."sv);
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
+  if (Rows == 0) {
+    return {};
+  }
+
+  // The shards are claimed in turn by this thread and the pool workers, so
+  // that the batch completes even if no worker becomes free. The late workers
+  // only touch the shared state.
+  struct State {
+    std::atomic<uint32_t> Next = 0;
+    std::atomic<bool> Cancelled = false;
+    std::mutex Mutex;
+    std::condition_variable Cond;
+    uint32_t Done = 0;
+    std::vector<Expect<void>> Results;
+  };
+  const uint32_t Shards = std::clamp(Threads, UINT32_C(1), Rows);
+  auto Shared = std::make_shared<State>();
+  Shared->Results.resize(Shards);
+  auto RunShards = [this, FuncInst, Params, Returns, Rows,
+                    Shards](State &S) noexcept {
+    uint32_t Shard;
+    while ((Shard = S.Next.fetch_add(1, std::memory_order_relaxed)) < Shards) {
+      const auto Begin = static_cast<uint32_t>(uint64_t(Rows) * Shard / Shards);
+      const auto End =
+          static_cast<uint32_t>(uint64_t(Rows) * (Shard + 1) / Shards);
+      PooledStackManager PooledStack(
+          Conf.getRuntimeConfigure().getValueStackSize());
+      auto Res = runBatch(*PooledStack, *FuncInst, Params, Returns, Begin, End,
+                          S.Cancelled);
+      if (!Res) {
+        S.Cancelled.store(true, std::memory_order_relaxed);
+      }
+      std::unique_lock Lock(S.Mutex);
+      S.Results[Shard] = std::move(Res);
+      if (++S.Done == Shards) {
+        S.Cond.notify_all();
+      }
+    }
+  };
+
+  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
+    Stat->startRecordWasm();
+  }
+  for (uint32_t I = 1; I < Shards; ++I) {
+    ThreadPool::getDefault().submit(
+        [Shared, RunShards]() noexcept { RunShards(*Shared); });
+  }
+  RunShards(*Shared);
+  {
+    std::unique_lock Lock(Shared->Mutex);
+    Shared->Cond.wait(Lock, [&]() { return Shared->Done == Shards; });
+  }
+  if (Stat && Conf.getStatisticsConfigure().isTimeMeasuring()) {
+    Stat->stopRecordWasm();
+  }
+  if (Stat) {
+    Stat->dumpToLog(Conf);
+  }
+
+  for (const auto &Res : Shared->Results) {
+    if (!Res) {
+      if (Res.error() != ErrCode::Value::Terminated) {
+        dumpStackTrace(Span<const uint32_t>{StackTrace}.first(StackTraceSize));
+      }
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
 /// Invoke component function. See "include/executor/executor.h".
 Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
 Executor::invoke(const Runtime::Instance::Component::FunctionInstance *FuncInst,
@@ -217,33 +463,27 @@ Executor::invoke(const Runtime::Instance::Component::FunctionInstance *FuncInst,
   }
 
   // Matching arguments and function type.
-  // TODO: COMPONENT - type matching.
-  // const auto &FuncType = FuncInst->getFuncType();
-  // const auto PTypes = FuncType.getParamList();
+  const auto &Adapter = FuncInst->getAdapter();
+  // The values are checked against the declared types by the lowering.
+  if (unlikely(Params.size() != ParamTypes.size() ||
+               Params.size() != Adapter.ParamTypes.size())) {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
 
-  // Convert the component params into core WASM params.
-  auto *ReallocFuncInst = FuncInst->getAllocFunction();
-  auto *MemInst = FuncInst->getMemoryInstance();
-  std::vector<ValVariant> CoreWASMArgs =
-      convValsToCoreWASM(Params, ParamTypes, ReallocFuncInst, MemInst);
+  // Lower the component params into core WASM params by the adapter compiled
+  // at the lifting. The core function type is checked there.
+  std::vector<ValVariant> CoreWASMArgs;
+  EXPECTED_TRY(lowerCanonValues(*FuncInst, Params, CoreWASMArgs));
 
-  // Call runFunction.
   auto *CoreFuncInst = FuncInst->getLowerFunction();
   assuming(CoreFuncInst);
-  const auto &CoreFuncType = CoreFuncInst->getFuncType();
-  // TODO: COMPONENT - check the ABI types between core functype and args.
-  EXPECTED_TRY(auto CoreWASMReturns, invoke(CoreFuncInst, CoreWASMArgs,
-                                            CoreFuncType.getParamTypes()));
+  std::vector<ValVariant> CoreWASMReturns(Adapter.CoreResults.size());
+  EXPECTED_TRY(
+      invokeUnchecked(*CoreFuncInst, CoreWASMArgs, CoreWASMReturns));
 
-  // Get return values.
-  std::vector<ComponentValType> ReturnTypes;
-  for (const auto &Type : FuncInst->getFuncType().getResultList()) {
-    ReturnTypes.push_back(Type.getValType());
-  }
-  std::vector<std::pair<ComponentValVariant, ComponentValType>> Returns =
-      convValsToComponent(CoreWASMReturns, ReturnTypes, MemInst);
-  assuming(Returns.size() == ReturnTypes.size());
-  return Returns;
+  // Lift the core WASM returns into the component values.
+  return liftCanonValues(*FuncInst, CoreWASMReturns);
 }
 
 } // namespace Executor
@@ -3,17 +3,102 @@
 
 #include "executor/executor.h"
 
+#include "common/metrics.h"
 #include "common/spdlog.h"
 #include "system/fault.h"
+#include "system/fiber.h"
+#include "system/nativestack.h"
 #include "system/stacktrace.h"
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <mutex>
 #include <utility>
 #include <vector>
 
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <time.h>
+#endif
+
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Returns of the host functions kept without allocation.
+constexpr uint32_t kInlineHostRets = 8;
+
+/// CPU time of the calling thread in nanoseconds, or the monotonic time where
+/// not supported.
+uint64_t getThreadCpuTime() noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  timespec TS;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &TS) == 0) {
+    return static_cast<uint64_t>(TS.tv_sec) * UINT64_C(1000000000) +
+           static_cast<uint64_t>(TS.tv_nsec);
+  }
+#endif
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+/// Record the latency of the host function by its module in the metrics.
+void recordHostCall(const Runtime::Instance::FunctionInstance &Func,
+                    std::chrono::steady_clock::time_point Start) noexcept {
+  using namespace std::literals;
+  const auto *ModInst = Func.getModule();
+  Metrics::recordHostCall(ModInst ? ModInst->getModuleName() : ""sv,
+                          std::chrono::steady_clock::now() - Start);
+}
+} // namespace
+
+Executor::CpuTimeScope::CpuTimeScope(
+    const Runtime::Instance::ModuleInstance *ModInst) noexcept
+    : Module(ModInst), Prev(CpuTime) {
+  // Pause the outer execution, which may charge another module instance.
+  if (Prev) {
+    Prev->sample();
+  }
+  restart();
+  CpuTime = this;
+}
+
+Executor::CpuTimeScope::~CpuTimeScope() noexcept {
+  sample();
+  CpuTime = Prev;
+  if (Prev) {
+    Prev->restart();
+  }
+}
+
+uint64_t Executor::CpuTimeScope::sample() noexcept {
+  const uint64_t Now = getThreadCpuTime();
+  LastEpoch = Epoch::get();
+  const uint64_t Usage =
+      Module->getCpuBudget().charge(Now >= Last ? Now - Last : 0);
+  Last = Now;
+  return Usage;
+}
+
+void Executor::CpuTimeScope::restart() noexcept {
+  Last = getThreadCpuTime();
+  LastEpoch = Epoch::get();
+}
+
+bool Executor::checkCpuBudget() noexcept {
+  if (CpuTime == nullptr) {
+    return true;
+  }
+  const uint64_t Usage = CpuTime->sample();
+  const auto &Budget = CpuTime->Module->getCpuBudget();
+  if (likely(!Budget.isExceeded())) {
+    return true;
+  }
+  return CpuSchedulerFunc && CpuSchedulerFunc(*CpuTime->Module, Usage);
+}
+
 Executor::SavedThreadLocal::SavedThreadLocal(
     Executor &Ex, Runtime::StackManager &StackMgr,
     const Runtime::Instance::FunctionInstance &Func) noexcept {
@@ -25,8 +110,17 @@ Executor::SavedThreadLocal::SavedThreadLocal(
 
   SavedExecutionContext = ExecutionContext;
   ExecutionContext.StopToken = &Ex.StopToken;
+  ExecutionContext.Epoch = &Epoch::getCounter();
+  ExecutionContext.EpochDeadline = &Ex.EpochDeadline;
   ExecutionContext.Memories = ModInst->MemoryPtrs.data();
   ExecutionContext.Globals = ModInst->GlobalPtrs.data();
+  ExecutionContext.Tags = ModInst->TagInsts.data();
+  ExecutionContext.ExceptionTag = &CompiledException.Tag;
+  ExecutionContext.ExceptionValues = CompiledException.Values.data();
+  ExecutionContext.Tables = ModInst->NativeTablePtrs.data();
+  ExecutionContext.TypeIds = ModInst->NativeTypeIds.data();
+  ExecutionContext.GlobalValues = ModInst->GlobalValues.get();
+  ExecutionContext.MemorySizes = ModInst->MemorySizePtrs.data();
   if (Ex.Stat) {
     ExecutionContext.InstrCount = &Ex.Stat->getInstrCountRef();
     ExecutionContext.CostTable = Ex.Stat->getCostTable().data();
@@ -36,14 +130,55 @@ Executor::SavedThreadLocal::SavedThreadLocal(
 
   SavedCurrentStack = CurrentStack;
   CurrentStack = &StackMgr;
+
+#if WASMEDGE_ALLOCATOR_IS_STABLE
+  // The compiled code only reaches the striped memories of the module.
+  SavedRights = Allocator::restrictProtectionKeys(ModInst->MemoryPtrs);
+#endif
 }
 
 Executor::SavedThreadLocal::~SavedThreadLocal() noexcept {
+  Allocator::restoreProtectionKeys(SavedRights);
   CurrentStack = SavedCurrentStack;
   ExecutionContext = SavedExecutionContext;
   This = SavedThis;
 }
 
+bool Executor::chargeStatCost(Runtime::StackManager &StackMgr,
+                              uint64_t Cost) noexcept {
+  flushStatBatch(StackMgr);
+  auto &Batch = StackMgr.getStatBatch();
+  if (unlikely(!Stat->leaseCost(Cost, Batch.CostRoom))) {
+    return false;
+  }
+  Batch.Cost = Cost;
+  return true;
+}
+
+bool Executor::refundStatBatch(Runtime::StackManager &StackMgr,
+                               uint64_t Cost) noexcept {
+  auto &Batch = StackMgr.getStatBatch();
+  if (Cost <= Batch.Cost) {
+    Batch.Cost -= Cost;
+    Batch.CostRoom += Cost;
+    return true;
+  }
+  flushStatBatch(StackMgr);
+  return Stat->subCost(Cost);
+}
+
+void Executor::flushStatBatch(Runtime::StackManager &StackMgr) noexcept {
+  auto &Batch = StackMgr.getStatBatch();
+  if (Batch.InstrCount > 0) {
+    Stat->getInstrCountRef().fetch_add(Batch.InstrCount,
+                                       std::memory_order_relaxed);
+  }
+  if (Batch.CostRoom > 0) {
+    Stat->returnCost(Batch.CostRoom);
+  }
+  Batch = {};
+}
+
 Expect<AST::InstrView::iterator>
 Executor::enterFunction(Runtime::StackManager &StackMgr,
                         const Runtime::Instance::FunctionInstance &Func,
@@ -51,7 +186,7 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
   // RetIt: the return position when the entered function returns.
 
   // Check if the interruption occurs.
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  if (isInterrupted()) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
@@ -62,10 +197,16 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
   const uint32_t RetsN =
       static_cast<uint32_t>(FuncType.getReturnTypes().size());
 
-  // For the exception handler, remove the inactive handlers caused by the
-  // branches.
-  if (likely(RetIt)) {
-    StackMgr.removeInactiveHandler(RetIt - 1);
+  // In the tiered JIT mode, a hot native wasm function may already be
+  // replaced by its compiled entry.
+  const Runtime::Instance::FunctionInstance::TieredEntry *Tiered = nullptr;
+  if (unlikely(TierUpThreshold) && Func.isWasmFunction()) {
+    Tiered = Func.getTieredEntry();
+  }
+
+  // The host and compiled functions read and charge the statistics directly.
+  if (Stat && (Func.isHostFunction() || Func.isCompiledFunction() || Tiered)) {
+    flushStatBatch(StackMgr);
   }
 
   if (Func.isHostFunction()) {
@@ -79,16 +220,25 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
     if (ModInst == nullptr) {
       ModInst = Func.getModule();
     }
-    Runtime::CallingFrame CallFrame(this, ModInst);
+    Runtime::CallingFrame CallFrame(this, ModInst, Func.getModule());
 
     // Push frame.
     StackMgr.pushFrame(Func.getModule(), // Module instance
                        RetIt,            // Return PC
                        ArgsN,            // Only args, no locals in stack
                        RetsN,            // Returns num
-                       IsTailCall        // For tail-call
+                       IsTailCall,       // For tail-call
+                       &Func             // Function instance
     );
 
+    // Count the call, and the self time until returning to the caller.
+    const bool IsCounting =
+        Stat && Conf.getStatisticsConfigure().isFunctionProfiling();
+    if (IsCounting) {
+      StackMgr.countCall(&Func);
+      StackMgr.switchCountedFunction(&Func);
+    }
+
     // Do the statistics if the statistics turned on.
     if (Stat) {
       // Check host function cost.
@@ -101,21 +251,38 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       Stat->startRecordHost();
     }
 
+    // Time the host function for the metrics if enabled.
+    const bool IsTiming = Metrics::isEnabled();
+    const auto HostStart = IsTiming ? std::chrono::steady_clock::now()
+                                    : std::chrono::steady_clock::time_point();
+
     // Call pre-host-function
     HostFuncHelper.invokePreHostFunc();
 
-    // Run host function.
+    // Run host function. The returns of the common signatures are kept in a
+    // local buffer to avoid the allocation. They cannot be written into the
+    // stack directly, because a re-entering host function may reallocate it.
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
+    std::array<ValVariant, kInlineHostRets> InlineRets;
+    std::vector<ValVariant> HeapRets;
+    Span<ValVariant> Rets(InlineRets.data(), RetsN);
+    if (unlikely(RetsN > kInlineHostRets)) {
+      HeapRets.resize(RetsN);
+      Rets = Span<ValVariant>(HeapRets.data(), RetsN);
+    }
     for (uint32_t I = 0; I < ArgsN; I++) {
       // For the number type cases of the arguments, the unused bits should be
       // erased due to the security issue.
       cleanNumericVal(Args[I], FuncType.getParamTypes()[I]);
     }
-    std::vector<ValVariant> Rets(RetsN);
-    auto Ret = HostFunc.run(CallFrame, std::move(Args), Rets);
+    auto Run = [&]() { return HostFunc.run(CallFrame, Args, Rets); };
+    auto Ret = HostTrace ? HostTrace->call(Func, CallFrame, Rets, Run) : Run();
 
     // Call post-host-function
     HostFuncHelper.invokePostHostFunc();
+    if (IsTiming) {
+      recordHostCall(Func, HostStart);
+    }
 
     // Do the statistics if the statistics turned on.
     if (Stat) {
@@ -133,15 +300,30 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       return Unexpect(Ret);
     }
 
-    // Push returns back to stack.
+    // Check the CPU budget including the time of the host function.
+    if (unlikely(CpuAccounting) && !checkCpuBudget()) {
+      spdlog::error(ErrCode::Value::Interrupted);
+      return Unexpect(ErrCode::Value::Interrupted);
+    }
+
+    // Push returns back to stack. The guarded execution cannot jump over the
+    // returns buffer, so check the room instead of faulting.
+    if (unlikely(!StackMgr.hasValueRoom(RetsN))) {
+      spdlog::error(ErrCode::Value::StackOverflow);
+      return Unexpect(ErrCode::Value::StackOverflow);
+    }
     for (auto &R : Rets) {
       StackMgr.push(std::move(R));
     }
 
     // For host function case, the continuation will be the continuation from
     // the popped frame.
-    return StackMgr.popFrame();
-  } else if (Func.isCompiledFunction()) {
+    auto From = StackMgr.popFrame();
+    if (IsCounting) {
+      StackMgr.switchCountedFunction(StackMgr.getFunction());
+    }
+    return From;
+  } else if (Func.isCompiledFunction() || Tiered) {
     // Compiled function case: Execute the function and jump to the
     // continuation.
 
@@ -150,41 +332,81 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
                        RetIt,            // Return PC
                        ArgsN,            // Only args, no locals in stack
                        RetsN,            // Returns num
-                       IsTailCall        // For tail-call
+                       IsTailCall,       // For tail-call
+                       &Func             // Function instance
     );
 
+    // Count the call. The compiled code counts no instructions, and the self
+    // time includes the callees called without frames.
+    const bool IsCounting =
+        Stat && Conf.getStatisticsConfigure().isFunctionProfiling();
+    if (IsCounting) {
+      StackMgr.countCall(&Func);
+      StackMgr.switchCountedFunction(&Func);
+    }
+
     // Prepare arguments.
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
     std::vector<ValVariant> Rets(RetsN);
     SavedThreadLocal Saved(*this, StackMgr, Func);
 
     ErrCode Err;
-    try {
-      // Get symbol and execute the function.
-      Fault FaultHandler;
-      uint32_t Code = PREPARE_FAULT(FaultHandler);
-      if (Code != 0) {
-        auto InnerStackTrace = FaultHandler.stacktrace();
+    // The faults and the exceptions are caught on the stack running the code.
+    auto RunCompiled = [&]() noexcept {
+      auto OnFault = [&](const Fault &FaultHandler, ErrCode Code) noexcept {
+        auto Inner = FaultHandler.stacktrace();
         {
           std::array<void *, 256> Buffer;
-          auto OuterStackTrace = stackTrace(Buffer);
-          while (!OuterStackTrace.empty() && !InnerStackTrace.empty() &&
-                 InnerStackTrace[InnerStackTrace.size() - 1] ==
-                     OuterStackTrace[OuterStackTrace.size() - 1]) {
-            InnerStackTrace = InnerStackTrace.first(InnerStackTrace.size() - 1);
-            OuterStackTrace = OuterStackTrace.first(OuterStackTrace.size() - 1);
+          auto Outer = stackTrace(Buffer);
+          while (!Outer.empty() && !Inner.empty() &&
+                 Inner[Inner.size() - 1] == Outer[Outer.size() - 1]) {
+            Inner = Inner.first(Inner.size() - 1);
+            Outer = Outer.first(Outer.size() - 1);
           }
         }
-        StackTraceSize =
-            compiledStackTrace(StackMgr, InnerStackTrace, StackTrace).size();
-        Err = ErrCode(static_cast<ErrCategory>(Code >> 24), Code);
-      } else {
-        auto &Wrapper = FuncType.getSymbol();
-        Wrapper(&ExecutionContext, Func.getSymbol().get(), Args.data(),
-                Rets.data());
+        StackTraceSize = compiledStackTrace(StackMgr, Inner, StackTrace).size();
+        Err = Code;
+      };
+      auto Run = [&]() {
+        // Get symbol and execute the function.
+        auto &Wrapper = Tiered ? Tiered->Wrapper : FuncType.getSymbol();
+        auto *Code = Tiered ? Tiered->Code.get() : Func.getSymbol().get();
+        Wrapper(&ExecutionContext, Code, Args.data(), Rets.data());
+        // The exceptions are only propagated between the compiled functions.
+        if (unlikely(CompiledException.Tag)) {
+          CompiledException.Tag = nullptr;
+          Err = ErrCode::Value::UncaughtException;
+        }
+      };
+#if WASMEDGE_FAULT_UNWINDING
+      // The faults are thrown from the compiled code, so the frequent short
+      // calls pay no setjmp.
+      Fault FaultHandler{Fault::Unwinding{}};
+      try {
+        Run();
+      } catch (const ErrCode &E) {
+        OnFault(FaultHandler, E);
       }
-    } catch (const ErrCode &E) {
-      Err = E;
+#else
+      try {
+        Fault FaultHandler;
+        if (uint32_t Code = PREPARE_FAULT(FaultHandler); Code != 0) {
+          OnFault(FaultHandler,
+                  ErrCode(static_cast<ErrCategory>(Code >> 24), Code));
+        } else {
+          Run();
+        }
+      } catch (const ErrCode &E) {
+        Err = E;
+      }
+#endif
+    };
+    // Run on the dedicated stack if configured. The fibers already run on
+    // their own stacks with the guard pages.
+    if (const auto Size = Conf.getRuntimeConfigure().getNativeStackSize();
+        Size == 0 || Fiber::current() ||
+        !NativeStack::run(static_cast<size_t>(Size), RunCompiled)) {
+      RunCompiled();
     }
     if (unlikely(Err)) {
       if (Err != ErrCode::Value::Terminated) {
@@ -197,50 +419,181 @@ Executor::enterFunction(Runtime::StackManager &StackMgr,
       return Unexpect(Err);
     }
 
-    // Push returns back to stack.
+    // Push returns back to stack, checking the room as the host functions.
+    if (unlikely(!StackMgr.hasValueRoom(RetsN))) {
+      spdlog::error(ErrCode::Value::StackOverflow);
+      return Unexpect(ErrCode::Value::StackOverflow);
+    }
     for (uint32_t I = 0; I < Rets.size(); ++I) {
       StackMgr.push(Rets[I]);
     }
 
     // For compiled function case, the continuation will be the continuation
     // from the popped frame.
-    return StackMgr.popFrame();
+    auto From = StackMgr.popFrame();
+    if (IsCounting) {
+      StackMgr.switchCountedFunction(StackMgr.getFunction());
+    }
+    return From;
   } else {
     // Native function case: Jump to the start of the function body.
 
-    // Push local variables into the stack.
-    for (auto &Def : Func.getLocals()) {
-      for (uint32_t I = 0; I < Def.first; I++) {
-        StackMgr.push(ValueFromType(Def.second));
-      }
+    // Decode and validate the deferred body in the lazy loading mode.
+    EXPECTED_TRY(Func.materialize());
+    return enterWasmFunction(StackMgr, Func, RetIt, IsTailCall);
+  }
+}
+
+AST::InstrView::iterator
+Executor::enterWasmFunction(Runtime::StackManager &StackMgr,
+                            const Runtime::Instance::FunctionInstance &Func,
+                            const AST::InstrView::iterator RetIt,
+                            bool IsTailCall) {
+  const auto &FuncType = Func.getFuncType();
+  const uint32_t ArgsN = static_cast<uint32_t>(FuncType.getParamTypes().size());
+  const uint32_t RetsN =
+      static_cast<uint32_t>(FuncType.getReturnTypes().size());
+
+  if (unlikely(Prof)) {
+    Prof->recordCall(Func.getInstrs().begin()->getOffset());
+  }
+  if (Stat && Conf.getStatisticsConfigure().isFunctionProfiling()) {
+    StackMgr.countCall(&Func);
+  }
+
+  // Count the calls for the tiered JIT mode.
+  if (unlikely(TierUpThreshold) &&
+      unlikely(Func.addHotness() == TierUpThreshold)) {
+    TierUpFunc(*Func.getModule());
+  }
+
+  // For the tail call, move the arguments to the base of the reused frame
+  // first, so that the locals are pushed in place instead of moved with
+  // them.
+  if (IsTailCall) {
+    StackMgr.prepareTailCall(ArgsN);
+  }
+
+  // Push local variables into the stack by the groups of the same type.
+  for (auto &Def : Func.getLocals()) {
+    StackMgr.pushN(Def.first, ValueFromType(Def.second));
+  }
+
+  // Push frame.
+  // The PC must -1 here because in the interpreter mode execution, the PC
+  // will increase after the callee return.
+  StackMgr.pushFrame(Func.getModule(),           // Module instance
+                     RetIt - 1,                  // Return PC
+                     ArgsN + Func.getLocalNum(), // Arguments num + local num
+                     RetsN,                      // Returns num
+                     IsTailCall,                 // For tail-call
+                     &Func                       // Function instance
+  );
+
+  // For native function case, the continuation will be the start of the
+  // function body.
+  return Func.getInstrs().begin();
+}
+
+Expect<void>
+Executor::callFastHostFunc(Runtime::StackManager &StackMgr,
+                           const Runtime::Instance::FunctionInstance &Func,
+                           const ValVariant *Args, ValVariant *Rets) {
+  auto &HostFunc = Func.getHostFunc();
+  assuming(HostFunc.getFastCall());
+
+  // Generate CallingFrame from current frame, as enterFunction does.
+  const auto *ModInst = StackMgr.getModule();
+  if (ModInst == nullptr) {
+    ModInst = Func.getModule();
+  }
+  Runtime::CallingFrame CallFrame(this, ModInst, Func.getModule());
+
+  // Do the statistics if the statistics turned on.
+  if (Stat) {
+    flushStatBatch(StackMgr);
+    // Check host function cost.
+    if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
+      spdlog::error(ErrCode::Value::CostLimitExceeded);
+      return Unexpect(ErrCode::Value::CostLimitExceeded);
     }
+    // Start recording time of running host function.
+    Stat->stopRecordWasm();
+    Stat->startRecordHost();
+  }
 
-    // Push frame.
-    // The PC must -1 here because in the interpreter mode execution, the PC
-    // will increase after the callee return.
-    StackMgr.pushFrame(Func.getModule(),           // Module instance
-                       RetIt - 1,                  // Return PC
-                       ArgsN + Func.getLocalNum(), // Arguments num + local num
-                       RetsN,                      // Returns num
-                       IsTailCall                  // For tail-call
-    );
+  // Count the call, and the self time until returning to the caller.
+  const bool IsCounting =
+      Stat && Conf.getStatisticsConfigure().isFunctionProfiling();
+  if (IsCounting) {
+    StackMgr.countCall(&Func);
+    StackMgr.switchCountedFunction(&Func);
+  }
+
+  // Run host function between the pre- and post-host-functions. The compiled
+  // code only reads the used bits of the arguments, so no cleaning is needed.
+  const bool IsTiming = Metrics::isEnabled();
+  const auto HostStart = IsTiming ? std::chrono::steady_clock::now()
+                                  : std::chrono::steady_clock::time_point();
+  const auto RetsN = Func.getFuncType().getReturnTypes().size();
+  HostFuncHelper.invokePreHostFunc();
+  auto Run = [&]() {
+    return HostFunc.getFastCall()(HostFunc, CallFrame, Args, Rets);
+  };
+  auto Ret = HostTrace ? HostTrace->call(Func, CallFrame,
+                                         Span<ValVariant>(Rets, RetsN), Run)
+                       : Run();
+  HostFuncHelper.invokePostHostFunc();
+  if (IsTiming) {
+    recordHostCall(Func, HostStart);
+  }
 
-    // For native function case, the continuation will be the start of the
-    // function body.
-    return Func.getInstrs().begin();
+  if (IsCounting) {
+    StackMgr.switchCountedFunction(StackMgr.getFunction());
   }
+
+  // Do the statistics if the statistics turned on.
+  if (Stat) {
+    // Stop recording time of running host function.
+    Stat->stopRecordHost();
+    Stat->startRecordWasm();
+  }
+
+  // Check the host function execution status.
+  if (!Ret) {
+    if (Ret.error() == ErrCode::Value::HostFuncError ||
+        Ret.error().getCategory() != ErrCategory::WASM) {
+      spdlog::error(Ret.error());
+    }
+    return Unexpect(Ret);
+  }
+
+  // Check the CPU budget including the time of the host function.
+  if (unlikely(CpuAccounting) && !checkCpuBudget()) {
+    spdlog::error(ErrCode::Value::Interrupted);
+    return Unexpect(ErrCode::Value::Interrupted);
+  }
+  return {};
 }
 
 Expect<void>
 Executor::branchToLabel(Runtime::StackManager &StackMgr,
                         const AST::Instruction::JumpDescriptor &JumpDesc,
                         AST::InstrView::iterator &PC) noexcept {
-  // Check the stop token.
-  if (unlikely(StopToken.exchange(0, std::memory_order_relaxed))) {
+  // Check the stop token and the epoch deadline.
+  if (isInterrupted()) {
     spdlog::error(ErrCode::Value::Interrupted);
     return Unexpect(ErrCode::Value::Interrupted);
   }
 
+  // Count the loop back-edges for the tiered JIT mode.
+  if (unlikely(TierUpThreshold) && JumpDesc.PCOffset <= 0) {
+    if (const auto *Func = StackMgr.getFunction();
+        Func && unlikely(Func->addHotness() == TierUpThreshold)) {
+      TierUpFunc(*Func->getModule());
+    }
+  }
+
   StackMgr.eraseValueStack(JumpDesc.StackEraseBegin, JumpDesc.StackEraseEnd);
   // PC need to -1 here because the PC will increase in the next iteration.
   PC += (JumpDesc.PCOffset - 1);
@@ -250,38 +603,330 @@ Executor::branchToLabel(Runtime::StackManager &StackMgr,
 Expect<void> Executor::throwException(Runtime::StackManager &StackMgr,
                                       Runtime::Instance::TagInstance &TagInst,
                                       AST::InstrView::iterator &PC) noexcept {
-  StackMgr.removeInactiveHandler(PC);
+  // No handler is kept while running. The validator records the distance
+  // back to the innermost enclosing try_table of the throwing and calling
+  // instructions and of the try_table instructions, so the handlers are
+  // looked up by the position in every frame only when throwing.
   auto AssocValSize = TagInst.getTagType().getAssocValSize();
+  AST::InstrView::iterator Pos = PC;
   while (true) {
-    // Pop the top handler.
-    auto Handler = StackMgr.popTopHandler(AssocValSize);
-    if (!Handler.has_value()) {
+    for (uint32_t Offset = Pos ? Pos->getTryOffset() : 0; Offset != 0;
+         Offset = Pos->getTryCatch().TryOffset) {
+      Pos -= Offset;
+      const auto &TryDesc = Pos->getTryCatch();
+      // Checking through the catch clause.
+      for (const auto &C : TryDesc.Catch) {
+        if (!C.IsAll && getTagInstByIdx(StackMgr, C.TagIndex) != &TagInst) {
+          // For catching a specific tag, should check the equivalence of tag
+          // address.
+          continue;
+        }
+        StackMgr.unwindValues(TryDesc.StackHeight, AssocValSize);
+        if (C.IsRef) {
+          // For catching a exception reference, push the reference value
+          // onto stack.
+          StackMgr.push(
+              RefVariant(ValType(TypeCode::Ref, TypeCode::ExnRef), &TagInst));
+        }
+        // When being here, an exception is caught. Move the PC to the try
+        // block and branch to the label.
+        PC = Pos;
+        return branchToLabel(StackMgr, C.Jump, PC);
+      }
+    }
+    // Not caught in this frame. Continue from the calling instruction of the
+    // caller, which only has handlers if running in the interpreter.
+    const auto From = StackMgr.unwindFrame();
+    if (StackMgr.getFramesSpan().empty()) {
       break;
     }
-    // Checking through the catch clause.
-    for (const auto &C : Handler->CatchClause) {
-      if (!C.IsAll && getTagInstByIdx(StackMgr, C.TagIndex) != &TagInst) {
-        // For catching a specific tag, should check the equivalence of tag
-        // address.
-        continue;
+    Pos = AST::InstrView::iterator();
+    if (const auto *Func = StackMgr.getFunction();
+        Func && Func->isWasmFunction()) {
+      const auto Instrs = Func->getInstrs();
+      if (Instrs.begin() < From && From < Instrs.end()) {
+        Pos = From - 1;
       }
-      if (C.IsRef) {
-        // For catching a exception reference, push the reference value onto
-        // stack.
-        StackMgr.push(
-            RefVariant(ValType(TypeCode::Ref, TypeCode::ExnRef), &TagInst));
-      }
-      // When being here, an exception is caught. Move the PC to the try block
-      // and branch to the label.
-
-      PC = Handler->Try;
-      return branchToLabel(StackMgr, C.Jump, PC);
     }
   }
+  // The exception escaping a continuation is thrown again at its resumption.
+  if (CurrentCont && &StackMgr == &CurrentCont->Stack) {
+    CurrentCont->Ev = ContState::Event::Throw;
+    CurrentCont->Tag = &TagInst;
+    return Unexpect(ErrCode::Value::UncaughtException);
+  }
   spdlog::error(ErrCode::Value::UncaughtException);
   return Unexpect(ErrCode::Value::UncaughtException);
 }
 
+Expect<std::unique_ptr<Executor::ContState>>
+Executor::takeContState(const RefVariant &Ref,
+                        const AST::Instruction &Instr) const noexcept {
+  if (Ref.isNull()) {
+    spdlog::error(ErrCode::Value::AccessNullCont);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::AccessNullCont);
+  }
+  // The continuations are resumed at most once.
+  auto *ContInst = Ref.getPtr<Runtime::Instance::ContInstance>();
+  std::unique_ptr<ContState> State(
+      static_cast<ContState *>(ContInst->take().release()));
+  if (!State) {
+    spdlog::error(ErrCode::Value::ContinuationResumed);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::ContinuationResumed);
+  }
+  return State;
+}
+
+Expect<RefVariant>
+Executor::contNew(const Runtime::Instance::ModuleInstance &ModInst,
+                  const uint32_t TypeIdx, std::unique_ptr<ContState> State,
+                  const AST::Instruction &Instr) const noexcept {
+  auto &Mod = const_cast<Runtime::Instance::ModuleInstance &>(ModInst);
+  if (!Mod.getMemoryBudget().charge(sizeof(Runtime::Instance::ContInstance),
+                                    false)) {
+    spdlog::error(ErrCode::Value::MemoryBudgetExceeded);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::MemoryBudgetExceeded);
+  }
+  auto *ContInst = Mod.newCont(TypeIdx, std::move(State));
+  return RefVariant(ContInst->getDefType(), ContInst);
+}
+
+void Executor::runContinuation(ContState &State) noexcept {
+  // The fiber starts with the cleared thread local states.
+  This = this;
+  CurrentCont = &State;
+  ActiveStackScope StackScope(State.Stack);
+
+  // Push a dummy frame and the arguments, and run the function as
+  // `runFunction`.
+  const auto &Func = *std::exchange(State.Func, nullptr);
+  auto &StackMgr = State.Stack;
+  StackMgr.pushFrame(nullptr, AST::InstrView::iterator(), 0, 0);
+  if (unlikely(!StackMgr.hasValueRoom(
+          static_cast<uint32_t>(State.Values.size())))) {
+    spdlog::error(ErrCode::Value::StackOverflow);
+    State.Values.clear();
+    State.Ev = ContState::Event::Trap;
+    State.Err = ErrCode::Value::StackOverflow;
+    return;
+  }
+  for (const auto &Val : State.Values) {
+    StackMgr.push(Val);
+  }
+  State.Values.clear();
+  Expect<void> Res =
+      Func.materialize()
+          .and_then([&]() {
+            return enterFunction(StackMgr, Func, Func.getInstrs().end());
+          })
+          .and_then([&](AST::InstrView::iterator StartIt) {
+            if (StackMgr.isFixedValueStack() || GuardRegion) {
+              return executeGuarded(StackMgr, StartIt, Func.getInstrs().end());
+            }
+            return execute(StackMgr, StartIt, Func.getInstrs().end());
+          });
+
+  if (Res) {
+    State.Ev = ContState::Event::Return;
+    State.Values = StackMgr.pop(
+        static_cast<uint32_t>(Func.getFuncType().getReturnTypes().size()));
+  } else if (Res.error() == ErrCode::Value::UncaughtException &&
+             State.Ev == ContState::Event::Throw) {
+    // The values of the exception are left on the stack.
+    State.Values = StackMgr.pop(State.Tag->getTagType().getAssocValSize());
+  } else {
+    State.Ev = ContState::Event::Trap;
+    State.Err = Res.error();
+  }
+}
+
+Expect<void> Executor::resumeContinuation(
+    Runtime::StackManager &StackMgr, std::unique_ptr<ContState> State,
+    const AST::Instruction &Instr, AST::InstrView::iterator &PC) noexcept {
+  const auto *ModInst = StackMgr.getModule();
+  // Push the returned values to the resumer after releasing the finished
+  // state, checking the room as the returns of the host functions.
+  auto PushValues = [&]() -> Expect<void> {
+    const auto Values = std::exchange(State->Values, {});
+    State.reset();
+    if (unlikely(
+            !StackMgr.hasValueRoom(static_cast<uint32_t>(Values.size())))) {
+      spdlog::error(ErrCode::Value::StackOverflow);
+      spdlog::error(
+          ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+      return Unexpect(ErrCode::Value::StackOverflow);
+    }
+    for (const auto &Val : Values) {
+      StackMgr.push(Val);
+    }
+    return {};
+  };
+  while (true) {
+    // The suspensions are handled by this resumer until the fiber returns.
+    auto &S = *State;
+    S.Parent = CurrentCont;
+    S.ResumerStack = ActiveStack;
+    S.HandlerModule = ModInst;
+    S.Handler = &Instr;
+    if (!S.Fib) {
+      S.Fib = Fiber::create([this, &S]() { runContinuation(S); });
+      if (unlikely(!S.Fib)) {
+        spdlog::error(ErrCode::Value::StackOverflow);
+        spdlog::error(
+            ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+        return Unexpect(ErrCode::Value::StackOverflow);
+      }
+    }
+    if (CurrentCont) {
+      CurrentCont->Child = &S;
+    }
+    S.Fib->resume();
+    if (CurrentCont && (S.Ev == ContState::Event::Return ||
+                        S.Ev == ContState::Event::Throw ||
+                        S.Ev == ContState::Event::Trap || S.Target == &S)) {
+      CurrentCont->Child = nullptr;
+    }
+
+    switch (S.Ev) {
+    case ContState::Event::Return:
+      return PushValues();
+    case ContState::Event::Throw: {
+      auto *Tag = S.Tag;
+      EXPECTED_TRY(PushValues());
+      return throwException(StackMgr, *Tag, PC);
+    }
+    case ContState::Event::Trap:
+      return Unexpect(S.Err);
+    default:
+      break;
+    }
+
+    if (S.Target != &S) {
+      // Handled by an outer resumer. Suspend this continuation as well, and
+      // pass the resumption back to the inner one.
+      auto &Self = *CurrentCont;
+      Self.Ev = S.Ev;
+      Self.Tag = S.Tag;
+      Self.Target = S.Target;
+      Self.HandlerIdx = S.HandlerIdx;
+      Self.SwitchTo = std::move(S.SwitchTo);
+      Self.SwitchModule = S.SwitchModule;
+      Self.SwitchTypeIdx = S.SwitchTypeIdx;
+      Self.Values = std::move(S.Values);
+      Fiber::suspend();
+      if (unlikely(Self.Cancelled)) {
+        // Dropped while suspended, and the inner one is dropped as well.
+        return Unexpect(ErrCode::Value::Terminated);
+      }
+      S.ThrowTag = std::exchange(Self.ThrowTag, nullptr);
+      S.Values = std::move(Self.Values);
+      Self.Values.clear();
+      continue;
+    }
+
+    if (S.Ev == ContState::Event::Suspend) {
+      // Branch to the label with the tag arguments and the continuation.
+      const auto &Handler = Instr.getResume().Handlers[S.HandlerIdx];
+      if (unlikely(!StackMgr.hasValueRoom(
+              static_cast<uint32_t>(S.Values.size()) + 1))) {
+        spdlog::error(ErrCode::Value::StackOverflow);
+        spdlog::error(
+            ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+        return Unexpect(ErrCode::Value::StackOverflow);
+      }
+      const auto Values = std::exchange(S.Values, {});
+      EXPECTED_TRY(auto Ref, contNew(*ModInst, Handler.ContTypeIndex,
+                                     std::move(State), Instr));
+      for (const auto &Val : Values) {
+        StackMgr.push(Val);
+      }
+      StackMgr.push(Ref);
+      return branchToLabel(StackMgr, Handler.Jump, PC);
+    }
+
+    // Switch to the target, which takes the arguments and the switching
+    // continuation after its bound arguments, and is resumed in place.
+    auto Target = std::move(S.SwitchTo);
+    Target->ThrowTag = nullptr;
+    Target->Values.insert(Target->Values.end(), S.Values.begin(),
+                          S.Values.end());
+    S.Values.clear();
+    const auto *SwitchModule = S.SwitchModule;
+    const uint32_t SwitchTypeIdx = S.SwitchTypeIdx;
+    EXPECTED_TRY(auto Ref, contNew(*SwitchModule, SwitchTypeIdx,
+                                   std::move(State), Instr));
+    Target->Values.push_back(Ref);
+    State = std::move(Target);
+  }
+}
+
+Expect<void> Executor::suspendContinuation(
+    Runtime::StackManager &StackMgr, Runtime::Instance::TagInstance &TagInst,
+    std::vector<ValVariant> Values, std::unique_ptr<ContState> SwitchTo,
+    const uint32_t SwitchTypeIdx, const AST::Instruction &Instr,
+    AST::InstrView::iterator &PC) noexcept {
+  // Find the innermost handler of the tag in the resumers.
+  const bool IsSwitch = static_cast<bool>(SwitchTo);
+  ContState *Target = nullptr;
+  uint32_t HandlerIdx = 0;
+  for (auto *S = CurrentCont; S && !Target; S = S->Parent) {
+    const auto &Handlers = S->Handler->getResume().Handlers;
+    for (uint32_t I = 0; I < Handlers.size(); ++I) {
+      if (Handlers[I].IsSwitch == IsSwitch &&
+          S->HandlerModule->unsafeGetTag(Handlers[I].TagIndex) == &TagInst) {
+        Target = S;
+        HandlerIdx = I;
+        break;
+      }
+    }
+  }
+  if (unlikely(!Target)) {
+    spdlog::error(ErrCode::Value::UnhandledTag);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    return Unexpect(ErrCode::Value::UnhandledTag);
+  }
+
+  auto &Self = *CurrentCont;
+  Self.Ev = IsSwitch ? ContState::Event::Switch : ContState::Event::Suspend;
+  Self.Tag = &TagInst;
+  Self.Target = Target;
+  Self.HandlerIdx = HandlerIdx;
+  Self.SwitchTo = std::move(SwitchTo);
+  Self.SwitchModule = StackMgr.getModule();
+  Self.SwitchTypeIdx = SwitchTypeIdx;
+  Self.Values = std::move(Values);
+  Fiber::suspend();
+
+  // Resumed with the arguments, or with an exception by resume_throw. The
+  // dropped continuation fails here to unwind its fiber.
+  if (unlikely(Self.Cancelled)) {
+    return Unexpect(ErrCode::Value::Terminated);
+  }
+  if (unlikely(!StackMgr.hasValueRoom(
+          static_cast<uint32_t>(Self.Values.size())))) {
+    spdlog::error(ErrCode::Value::StackOverflow);
+    spdlog::error(
+        ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset()));
+    Self.Values.clear();
+    return Unexpect(ErrCode::Value::StackOverflow);
+  }
+  for (const auto &Val : Self.Values) {
+    StackMgr.push(Val);
+  }
+  Self.Values.clear();
+  if (auto *ThrowTag = std::exchange(Self.ThrowTag, nullptr)) {
+    return throwException(StackMgr, *ThrowTag, PC);
+  }
+  return {};
+}
+
 const AST::SubType *Executor::getDefTypeByIdx(Runtime::StackManager &StackMgr,
                                               const uint32_t Idx) const {
   const auto *ModInst = StackMgr.getModule();
@@ -319,6 +964,16 @@ Executor::getArrayStorageTypeByIdx(Runtime::StackManager &StackMgr,
   return CompType.getFieldTypes()[0].getStorageType();
 }
 
+const AST::FunctionType &
+Executor::getContFuncTypeByIdx(Runtime::StackManager &StackMgr,
+                               const uint32_t Idx) const noexcept {
+  const auto &CompType = getCompositeTypeByIdx(StackMgr, Idx);
+  assuming(CompType.isCont());
+  auto *DefType = getDefTypeByIdx(StackMgr, CompType.getContTypeIndex());
+  assuming(DefType);
+  return DefType->getCompositeType().getFuncType();
+}
+
 Runtime::Instance::FunctionInstance *
 Executor::getFuncInstByIdx(Runtime::StackManager &StackMgr,
                            const uint32_t Idx) const {
@@ -344,12 +999,9 @@ Executor::getTabInstByIdx(Runtime::StackManager &StackMgr,
 Runtime::Instance::MemoryInstance *
 Executor::getMemInstByIdx(Runtime::StackManager &StackMgr,
                           const uint32_t Idx) const {
-  const auto *ModInst = StackMgr.getModule();
-  // When top frame is dummy frame, cannot find instance.
-  if (unlikely(ModInst == nullptr)) {
-    return nullptr;
-  }
-  return ModInst->unsafeGetMemory(Idx);
+  // The memory instances are cached in the frame. When top frame is dummy
+  // frame, cannot find instance.
+  return StackMgr.getMemory(Idx);
 }
 
 Runtime::Instance::TagInstance *
@@ -396,6 +1048,110 @@ Executor::getDataInstByIdx(Runtime::StackManager &StackMgr,
   return ModInst->unsafeGetData(Idx);
 }
 
+Expect<const Runtime::Instance::FunctionInstance *>
+Executor::getIndirectCallFunc(Runtime::StackManager &StackMgr,
+                              const Runtime::Instance::TableInstance &TabInst,
+                              const uint32_t TypeIdx,
+                              const uint32_t Idx) const noexcept {
+  const auto *ModInst = StackMgr.getModule();
+  assuming(ModInst);
+
+  // Fast path: the table slot is unchanged since the last passed check.
+  const uint64_t Generation = TabInst.getGeneration();
+  auto &Entry = StackMgr.getIndirectCallEntry(Generation, Idx, TypeIdx);
+  if (likely(Entry.Generation == Generation &&
+             Entry.ModuleId == ModInst->getId() && Entry.Slot == Idx &&
+             Entry.TypeIdx == TypeIdx)) {
+    return Entry.Func;
+  }
+
+  // Get function address. The bound is guaranteed.
+  RefVariant Ref = *TabInst.getRefAddr(Idx);
+  if (Ref.isNull()) {
+    return Unexpect(ErrCode::Value::UninitializedElement);
+  }
+
+  // Check function type.
+  const auto &ExpDefType = **ModInst->getType(TypeIdx);
+  const auto *FuncInst = retrieveFuncRef(Ref);
+  bool IsMatch = false;
+  if (FuncInst->getModule()) {
+    IsMatch = matchDefinedType(*ModInst, *ExpDefType.getTypeIndex(),
+                               *FuncInst->getModule(),
+                               FuncInst->getTypeIndex());
+  } else {
+    // Independent host module instance case. Matching the composite type
+    // directly.
+    IsMatch = AST::TypeMatcher::matchType(
+        ModInst->getTypeList(), ExpDefType.getCompositeType(),
+        FuncInst->getHostFunc().getDefinedType().getCompositeType());
+  }
+  if (!IsMatch) {
+    return Unexpect(ErrCode::Value::IndirectCallTypeMismatch);
+  }
+
+  Entry = {Generation, ModInst->getId(), Idx, TypeIdx, FuncInst};
+  return FuncInst;
+}
+
+Span<const Runtime::CanonicalType *const> Executor::getCanonicalTypes(
+    const Runtime::Instance::ModuleInstance &ModInst) noexcept {
+  try {
+    std::call_once(ModInst.CanonTypesFlag, [&ModInst]() {
+      std::shared_lock Lock(ModInst.Mutex);
+      ModInst.CanonTypes =
+          Runtime::TypeRegistry::getDefault().canonicalize(ModInst.Types);
+    });
+  } catch (std::bad_alloc &) {
+    // Fall back to the structural matching.
+    return {};
+  }
+  return ModInst.CanonTypes;
+}
+
+bool Executor::matchDefinedType(
+    const Runtime::Instance::ModuleInstance &ExpModInst, uint32_t ExpIdx,
+    const Runtime::Instance::ModuleInstance &GotModInst,
+    uint32_t GotIdx) noexcept {
+  const auto ExpTypes = getCanonicalTypes(ExpModInst);
+  const auto GotTypes = getCanonicalTypes(GotModInst);
+  if (likely(ExpIdx < ExpTypes.size() && GotIdx < GotTypes.size())) {
+    return GotTypes[GotIdx]->isSubTypeOf(*ExpTypes[ExpIdx]);
+  }
+  return AST::TypeMatcher::matchType(ExpModInst.getTypeList(), ExpIdx,
+                                     GotModInst.getTypeList(), GotIdx);
+}
+
+bool Executor::matchRefType(const Runtime::Instance::ModuleInstance &ModInst,
+                            const ValType &Exp,
+                            const RefVariant &Ref) noexcept {
+  ValType VT = Ref.getType();
+  if (VT.isExternalized()) {
+    // An externalized reference must appear as an 'externref' to the matcher.
+    // We preserve the nullability (Ref vs RefNull).
+    VT = ValType(VT.isNullableRefType() ? TypeCode::RefNull : TypeCode::Ref,
+                 TypeCode::ExternRef);
+  }
+  if (VT.isAbsHeapType()) {
+    return AST::TypeMatcher::matchType(ModInst.getTypeList(), Exp,
+                                       ModInst.getTypeList(), VT);
+  }
+
+  // Reference must not be nullptr here because the null references are typed
+  // with the least abstract heap type.
+  const auto *Inst = Ref.getPtr<Runtime::Instance::CompositeBase>();
+  const auto &GotModInst = Inst->getModule() ? *Inst->getModule() : ModInst;
+  if (!Exp.isAbsHeapType()) {
+    if (!Exp.isNullableRefType() && VT.isNullableRefType()) {
+      return false;
+    }
+    return matchDefinedType(ModInst, Exp.getTypeIndex(), GotModInst,
+                            VT.getTypeIndex());
+  }
+  return AST::TypeMatcher::matchType(ModInst.getTypeList(), Exp,
+                                     GotModInst.getTypeList(), VT);
+}
+
 TypeCode Executor::toBottomType(Runtime::StackManager &StackMgr,
                                 const ValType &Type) const {
   if (Type.isRefType()) {
@@ -426,6 +1182,8 @@ TypeCode Executor::toBottomType(Runtime::StackManager &StackMgr,
               ->getCompositeType();
       if (CompType.isFunc()) {
         return TypeCode::NullFuncRef;
+      } else if (CompType.isCont()) {
+        return TypeCode::NullContRef;
       } else {
         return TypeCode::NullRef;
       }
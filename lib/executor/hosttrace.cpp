@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "executor/hosttrace.h"
+
+#include "common/spdlog.h"
+#include "runtime/instance/module.h"
+#include "system/fiber.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+/// Magic and version of the trace file. The records follow in the call order:
+///   u32 name size, name, u32 error code (0 for success),
+///   u32 return count, 16 bytes per return value,
+///   u32 memory count, per memory:
+///     u32 memory index, u32 page count, u32 chunk count, per chunk:
+///       u64 offset, u64 size, written bytes.
+/// The integers are in the byte order of the host.
+static inline constexpr std::string_view kMagic = "WEHTRC\x00\x01"sv;
+/// Granularity to compare the memories with their copies.
+static inline constexpr uint64_t kBlockSize = UINT64_C(256);
+
+template <typename T> void put(std::string &Buffer, const T &Value) noexcept {
+  Buffer.append(reinterpret_cast<const char *>(&Value), sizeof(Value));
+}
+} // namespace
+
+thread_local uint32_t HostCallTrace::Depth = 0;
+
+void HostCallTrace::swapFiberLocal(void *Storage) noexcept {
+  std::swap(*static_cast<uint32_t *>(Storage), Depth);
+}
+
+const bool HostCallTrace::FiberLocalRegistered =
+    Fiber::registerLocal(sizeof(uint32_t), &swapFiberLocal);
+
+std::unique_ptr<HostCallTrace>
+HostCallTrace::open(const std::filesystem::path &Path, Mode M) noexcept {
+  std::unique_ptr<HostCallTrace> Trace(new HostCallTrace(M));
+  if (M == Mode::Record) {
+    Trace->Output.open(Path, std::ios::binary | std::ios::trunc);
+    if (!Trace->Output ||
+        !Trace->Output.write(kMagic.data(),
+                             static_cast<std::streamsize>(kMagic.size()))) {
+      spdlog::error("Host call trace: failed to create {}."sv, Path.u8string());
+      return nullptr;
+    }
+    return Trace;
+  }
+  std::ifstream File(Path, std::ios::binary);
+  Trace->Input.assign(std::istreambuf_iterator<char>(File),
+                      std::istreambuf_iterator<char>());
+  if (!File || Trace->Input.size() < kMagic.size() ||
+      std::memcmp(Trace->Input.data(), kMagic.data(), kMagic.size()) != 0) {
+    spdlog::error("Host call trace: failed to read {}."sv, Path.u8string());
+    return nullptr;
+  }
+  Trace->Cursor = kMagic.size();
+  return Trace;
+}
+
+void HostCallTrace::snapshot(const Runtime::CallingFrame &Frame) noexcept {
+  std::unique_lock Lock(Mutex);
+  for (uint32_t I = 0; const auto *MemInst = Frame.getMemoryByIndex(I); ++I) {
+    const uint64_t Size = static_cast<uint64_t>(MemInst->getPageSize()) *
+                          Runtime::Instance::MemoryInstance::kPageSize;
+    const uint8_t *Data = MemInst->getDataPtr();
+    auto &Copy = Copies[MemInst];
+    Copy.resize(Size);
+    // Only the blocks written since the last call are copied.
+    for (uint64_t Offset = 0; Offset < Size; Offset += kBlockSize) {
+      const uint64_t Length = std::min(kBlockSize, Size - Offset);
+      if (std::memcmp(Copy.data() + Offset, Data + Offset, Length) != 0) {
+        std::memcpy(Copy.data() + Offset, Data + Offset, Length);
+      }
+    }
+  }
+}
+
+void HostCallTrace::record(const Runtime::Instance::FunctionInstance &Func,
+                           const Runtime::CallingFrame &Frame,
+                           Span<const ValVariant> Rets,
+                           const Expect<void> &Res) noexcept {
+  std::unique_lock Lock(Mutex);
+  std::string Buffer;
+  const auto &Name = getName(Func);
+  put(Buffer, static_cast<uint32_t>(Name.size()));
+  Buffer.append(Name);
+  put(Buffer, Res ? UINT32_C(0) : static_cast<uint32_t>(Res.error()));
+  put(Buffer, static_cast<uint32_t>(Rets.size()));
+  for (const auto &Ret : Rets) {
+    put(Buffer, Ret.get<uint128_t>());
+  }
+
+  // The count of the changed memories is filled after comparing them.
+  const size_t CountPos = Buffer.size();
+  uint32_t Count = 0;
+  put(Buffer, Count);
+  for (uint32_t I = 0; const auto *MemInst = Frame.getMemoryByIndex(I); ++I) {
+    const uint32_t Pages = MemInst->getPageSize();
+    const uint64_t Size = static_cast<uint64_t>(Pages) *
+                          Runtime::Instance::MemoryInstance::kPageSize;
+    const uint8_t *Data = MemInst->getDataPtr();
+    auto &Copy = Copies[MemInst];
+    const bool Resized = Copy.size() != Size;
+    // The grown pages are compared with zeros.
+    Copy.resize(Size);
+
+    std::string Chunks;
+    uint32_t ChunkCount = 0;
+    uint64_t Offset = 0;
+    while (Offset < Size) {
+      const uint64_t Length = std::min(kBlockSize, Size - Offset);
+      if (std::memcmp(Copy.data() + Offset, Data + Offset, Length) == 0) {
+        Offset += Length;
+        continue;
+      }
+      // Merge the adjacent written blocks into a chunk.
+      uint64_t End = Offset + Length;
+      while (End < Size) {
+        const uint64_t Next = std::min(kBlockSize, Size - End);
+        if (std::memcmp(Copy.data() + End, Data + End, Next) == 0) {
+          break;
+        }
+        End += Next;
+      }
+      put(Chunks, Offset);
+      put(Chunks, End - Offset);
+      Chunks.append(reinterpret_cast<const char *>(Data + Offset),
+                    static_cast<size_t>(End - Offset));
+      std::memcpy(Copy.data() + Offset, Data + Offset, End - Offset);
+      ++ChunkCount;
+      Offset = End;
+    }
+    if (ChunkCount > 0 || Resized) {
+      put(Buffer, I);
+      put(Buffer, Pages);
+      put(Buffer, ChunkCount);
+      Buffer.append(Chunks);
+      ++Count;
+    }
+  }
+  std::memcpy(Buffer.data() + CountPos, &Count, sizeof(Count));
+
+  if (!Output.write(Buffer.data(),
+                    static_cast<std::streamsize>(Buffer.size()))) {
+    spdlog::error("Host call trace: failed to write the call of {}."sv, Name);
+  }
+}
+
+Expect<void>
+HostCallTrace::replay(const Runtime::Instance::FunctionInstance &Func,
+                      const Runtime::CallingFrame &Frame,
+                      Span<ValVariant> Rets) noexcept {
+  std::unique_lock Lock(Mutex);
+  const auto &Name = getName(Func);
+  auto Get = [this](auto &Value) noexcept {
+    if (Input.size() - Cursor < sizeof(Value)) {
+      return false;
+    }
+    std::memcpy(&Value, Input.data() + Cursor, sizeof(Value));
+    Cursor += sizeof(Value);
+    return true;
+  };
+  auto Fail = [&](std::string_view Reason) noexcept {
+    spdlog::error(ErrCode::Value::HostFuncError);
+    spdlog::error("    Host call trace: {} at the call of {}."sv, Reason,
+                  Name);
+    // The later calls fail too.
+    Cursor = Input.size();
+    return Unexpect(ErrCode::Value::HostFuncError);
+  };
+
+  uint32_t NameSize = 0;
+  if (!Get(NameSize) || Input.size() - Cursor < NameSize) {
+    return Fail("no more calls recorded"sv);
+  }
+  if (std::string_view(reinterpret_cast<const char *>(Input.data() + Cursor),
+                       NameSize) != Name) {
+    return Fail("another function recorded"sv);
+  }
+  Cursor += NameSize;
+
+  uint32_t Code = 0, RetsN = 0;
+  if (!Get(Code) || !Get(RetsN) || RetsN != Rets.size()) {
+    return Fail("mismatched returns"sv);
+  }
+  for (auto &Ret : Rets) {
+    uint128_t Value;
+    if (!Get(Value)) {
+      return Fail("mismatched returns"sv);
+    }
+    Ret.emplace<uint128_t>(Value);
+  }
+
+  uint32_t Count = 0;
+  if (!Get(Count)) {
+    return Fail("truncated memory writes"sv);
+  }
+  for (uint32_t I = 0; I < Count; ++I) {
+    uint32_t Index = 0, Pages = 0, ChunkCount = 0;
+    if (!Get(Index) || !Get(Pages) || !Get(ChunkCount)) {
+      return Fail("truncated memory writes"sv);
+    }
+    auto *MemInst = Frame.getMemoryByIndex(Index);
+    if (MemInst == nullptr) {
+      return Fail("mismatched memories"sv);
+    }
+    if (const uint32_t Current = MemInst->getPageSize();
+        Pages > Current && !MemInst->growPage(Pages - Current)) {
+      return Fail("failed to grow the memory"sv);
+    }
+    const uint64_t Size = static_cast<uint64_t>(MemInst->getPageSize()) *
+                          Runtime::Instance::MemoryInstance::kPageSize;
+    for (uint32_t J = 0; J < ChunkCount; ++J) {
+      uint64_t Offset = 0, Length = 0;
+      if (!Get(Offset) || !Get(Length) || Offset > Size ||
+          Length > Size - Offset || Input.size() - Cursor < Length) {
+        return Fail("truncated memory writes"sv);
+      }
+      std::memcpy(MemInst->getDataPtr() + Offset, Input.data() + Cursor,
+                  static_cast<size_t>(Length));
+      Cursor += static_cast<size_t>(Length);
+    }
+  }
+
+  if (Code != 0) {
+    return Unexpect(static_cast<ErrCategory>(Code >> 24), Code);
+  }
+  return {};
+}
+
+const std::string &HostCallTrace::getName(
+    const Runtime::Instance::FunctionInstance &Func) noexcept {
+  auto [It, Added] = Names.try_emplace(&Func);
+  if (Added) {
+    // The export name prefixed by the module name.
+    if (const auto *ModInst = Func.getModule()) {
+      It->second = fmt::format(
+          "{}::{}"sv, ModInst->getModuleName(),
+          ModInst->getFuncExports([&](const auto &Exports) {
+            for (const auto &[ExportName, ExportFunc] : Exports) {
+              if (ExportFunc == &Func) {
+                return std::string(ExportName);
+              }
+            }
+            return std::string();
+          }));
+    }
+  }
+  return It->second;
+}
+
+} // namespace Executor
+} // namespace WasmEdge
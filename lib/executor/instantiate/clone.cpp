@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "executor/executor.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+#include "system/memimage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+/// Map the instances owned by the source module instance to the cloned ones.
+/// The imported instances are shared and not in the map.
+class CloneMap {
+public:
+  void add(const void *Src, const void *Dst) { Map.emplace(Src, Dst); }
+
+  template <typename T> T *get(T *Src) const noexcept {
+    if (auto It = Map.find(Src); It != Map.end()) {
+      return const_cast<T *>(static_cast<const T *>(It->second));
+    }
+    return Src;
+  }
+  RefVariant get(const RefVariant &Ref) const noexcept {
+    if (auto It = Map.find(Ref.getPtr<void>()); It != Map.end()) {
+      return RefVariant(Ref.getType(), It->second);
+    }
+    return Ref;
+  }
+  ValVariant get(const ValType &Type, const ValVariant &Val) const noexcept {
+    if (Type.isRefType()) {
+      return get(Val.get<RefVariant>());
+    }
+    return Val;
+  }
+  std::vector<RefVariant> get(Span<const RefVariant> Refs) const {
+    std::vector<RefVariant> Result;
+    Result.reserve(Refs.size());
+    for (const auto &Ref : Refs) {
+      Result.push_back(get(Ref));
+    }
+    return Result;
+  }
+
+private:
+  std::unordered_map<const void *, const void *> Map;
+};
+
+Unexpected<ErrCode> logNotClonable(std::string_view Reason) noexcept {
+  using namespace std::literals;
+  spdlog::error(ErrCode::Value::RuntimeError);
+  spdlog::error("    Module instance cannot be cloned: {}"sv, Reason);
+  return Unexpect(ErrCode::Value::RuntimeError);
+}
+} // namespace
+
+// Clone the module instance. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
+Executor::cloneModule(const Runtime::Instance::ModuleInstance &Src) {
+  using namespace std::literals;
+  std::shared_lock Lock(Src.Mutex);
+
+  // Only the module instances instantiated from the AST modules can be
+  // cloned. The host functions and the GC objects are not copyable.
+  if (Src.Types.size() != Src.OwnedTypes.size() ||
+      std::any_of(Src.OwnedFuncInsts.begin(), Src.OwnedFuncInsts.end(),
+                  [](const auto &Func) { return Func->isHostFunction(); })) {
+    return logNotClonable("owns host functions"sv);
+  }
+  if (!Src.OwnedArrayInsts.empty() || !Src.OwnedStructInsts.empty() ||
+      !Src.OwnedContInsts.empty()) {
+    return logNotClonable("owns GC objects"sv);
+  }
+
+  auto ModInst = std::make_unique<Runtime::Instance::ModuleInstance>("");
+  CloneMap Map;
+
+  // Copy the defined types.
+  for (const auto *SubType : Src.Types) {
+    ModInst->addDefinedType(*SubType);
+  }
+
+  // The imported instances are always in front of the owned ones.
+
+  // Share the function bodies.
+  const auto ImpFuncNum = Src.FuncInsts.size() - Src.OwnedFuncInsts.size();
+  for (size_t I = 0; I < Src.FuncInsts.size(); ++I) {
+    auto *Func = Src.FuncInsts[I];
+    if (I < ImpFuncNum) {
+      ModInst->importFunction(Func);
+      continue;
+    }
+    ModInst->addFunc(ModInst->Types[Func->getTypeIndex()]
+                         ->getCompositeType()
+                         .getFuncType(),
+                     *Func);
+    Map.add(Func, ModInst->FuncInsts.back());
+  }
+
+  // Copy the tables by value.
+  const auto ImpTabNum = Src.TabInsts.size() - Src.OwnedTabInsts.size();
+  for (size_t I = 0; I < Src.TabInsts.size(); ++I) {
+    auto *Tab = Src.TabInsts[I];
+    if (I < ImpTabNum) {
+      ModInst->importTable(Tab);
+      continue;
+    }
+    ModInst->addTable(Tab->getTableType(), Map.get(Tab->getInitValue()));
+    auto *NewTab = ModInst->TabInsts.back();
+    const auto Refs = Map.get(*Tab->getRefs(0, Tab->getSize()));
+    NewTab->setRefs(Refs, 0, 0, static_cast<uint32_t>(Refs.size()));
+    Map.add(Tab, NewTab);
+  }
+
+  // Record the memory images at the first clone.
+  const auto ImpMemNum = Src.MemInsts.size() - Src.OwnedMemInsts.size();
+  std::call_once(Src.CloneImagesFlag, [&Src, ImpMemNum]() {
+    Src.CloneImages.resize(Src.OwnedMemInsts.size());
+    for (size_t I = 0; I < Src.OwnedMemInsts.size(); ++I) {
+      const auto *Mem = Src.MemInsts[ImpMemNum + I];
+      if (Mem->getPageSize() > 0) {
+        Src.CloneImages[I] = MemoryImage::create(Span<const uint8_t>(
+            Mem->getDataPtr(),
+            Mem->getPageSize() *
+                Runtime::Instance::MemoryInstance::kPageSize));
+      }
+    }
+  });
+
+  // Map the memories copy-on-write, or copy them if not supported.
+  ModInst->MemoryPtrs.resize(Src.MemInsts.size());
+  ModInst->MemorySizePtrs.resize(Src.MemInsts.size());
+  for (size_t I = 0; I < Src.MemInsts.size(); ++I) {
+    auto *Mem = Src.MemInsts[I];
+    if (I < ImpMemNum) {
+      ModInst->importMemory(Mem);
+    } else {
+      ModInst->addMemory(Mem->getMemoryType(),
+                         Conf.getRuntimeConfigure().getMaxMemoryPage());
+      auto *NewMem = ModInst->MemInsts.back();
+      if (unlikely(NewMem->getPageSize() != Mem->getPageSize())) {
+        return logNotClonable("memory allocation failed"sv);
+      }
+      const auto &Image = Src.CloneImages[I - ImpMemNum];
+      if (!Image || !NewMem->mapImage(*Image)) {
+        std::copy_n(Mem->getDataPtr(),
+                    Mem->getPageSize() *
+                        Runtime::Instance::MemoryInstance::kPageSize,
+                    NewMem->getDataPtr());
+      }
+      Map.add(Mem, NewMem);
+    }
+#if WASMEDGE_ALLOCATOR_IS_STABLE
+    ModInst->MemoryPtrs[I] = ModInst->MemInsts[I]->getDataPtr();
+#else
+    ModInst->MemoryPtrs[I] = &ModInst->MemInsts[I]->getDataPtr();
+#endif
+    ModInst->MemorySizePtrs[I] = &ModInst->MemInsts[I]->getDataSize();
+  }
+
+  // Copy the tags with the cloned types.
+  const auto ImpTagNum = Src.TagInsts.size() - Src.OwnedTagInsts.size();
+  for (size_t I = 0; I < Src.TagInsts.size(); ++I) {
+    auto *Tag = Src.TagInsts[I];
+    if (I < ImpTagNum) {
+      ModInst->importTag(Tag);
+      continue;
+    }
+    ModInst->addTag(Tag->getTagType(),
+                    ModInst->Types[Tag->getTagType().getTypeIdx()]);
+    Map.add(Tag, ModInst->TagInsts.back());
+  }
+
+  // Copy the globals by value.
+  const auto ImpGlobNum = Src.GlobInsts.size() - Src.OwnedGlobInsts.size();
+  ModInst->GlobalPtrs.resize(Src.GlobInsts.size());
+  ModInst->GlobalValues =
+      std::make_unique<ValVariant[]>(Src.OwnedGlobInsts.size());
+  for (size_t I = 0; I < Src.GlobInsts.size(); ++I) {
+    auto *Glob = Src.GlobInsts[I];
+    if (I < ImpGlobNum) {
+      ModInst->importGlobal(Glob);
+    } else {
+      const auto &GlobType = Glob->getGlobalType();
+      ModInst->addGlobal(GlobType,
+                         Map.get(GlobType.getValType(), Glob->getValue()));
+      ModInst->GlobInsts.back()->bindSlot(
+          &ModInst->GlobalValues[I - ImpGlobNum]);
+      Map.add(Glob, ModInst->GlobInsts.back());
+    }
+    ModInst->GlobalPtrs[I] = &ModInst->GlobInsts[I]->getValue();
+  }
+
+  // Copy the element and data instances, which are dropped if active.
+  for (const auto *Elem : Src.ElemInsts) {
+    const auto Refs = Map.get(Elem->getRefs());
+    ModInst->addElem(Elem->getOffset(), Elem->getRefType(),
+                     Span<const RefVariant>(Refs));
+  }
+  for (const auto *Data : Src.DataInsts) {
+    ModInst->addData(*Data);
+  }
+
+  // Export the cloned instances with the same names.
+  for (const auto &[Name, Inst] : Src.ExpFuncs) {
+    ModInst->ExpFuncs.emplace(Name, Map.get(Inst));
+  }
+  for (const auto &[Name, Inst] : Src.ExpTables) {
+    ModInst->ExpTables.emplace(Name, Map.get(Inst));
+  }
+  for (const auto &[Name, Inst] : Src.ExpMems) {
+    ModInst->ExpMems.emplace(Name, Map.get(Inst));
+  }
+  for (const auto &[Name, Inst] : Src.ExpTags) {
+    ModInst->ExpTags.emplace(Name, Map.get(Inst));
+  }
+  for (const auto &[Name, Inst] : Src.ExpGlobals) {
+    ModInst->ExpGlobals.emplace(Name, Map.get(Inst));
+  }
+
+  ModInst->StartFunc = Map.get(Src.StartFunc);
+  ModInst->WASIModInst = Src.WASIModInst;
+  ModInst->buildExportIndices();
+  return ModInst;
+}
+
+} // namespace Executor
+} // namespace WasmEdge
@@ -5,85 +5,1314 @@
 
 #include "common/errinfo.h"
 #include "common/spdlog.h"
+#include "runtime/hostfunc.h"
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace WasmEdge {
 namespace Executor {
 
 using namespace std::literals;
 
-std::vector<ValVariant> Executor::convValsToCoreWASM(
-    Span<const ComponentValVariant> Vals, Span<const ComponentValType> ValTypes,
-    Runtime::Instance::FunctionInstance *RFuncInst,
-    Runtime::Instance::MemoryInstance *MemInst) noexcept {
-  uint32_t I = 0;
-  std::vector<ValVariant> CoreVals;
-  for (const auto &Type : ValTypes) {
-    switch (Type.getCode()) {
-    case ComponentTypeCode::String: {
-      assuming(RFuncInst != nullptr);
-      assuming(MemInst != nullptr);
-      std::string_view Str = std::get<std::string>(Vals[I++]);
-      uint32_t StrSize = static_cast<uint32_t>(Str.size());
-      std::vector<ValVariant> ReallocArgs{ValVariant(0), ValVariant(0),
-                                          ValVariant(0), ValVariant(StrSize)};
-      std::vector<ValType> ReallocTypes =
-          RFuncInst->getFuncType().getParamTypes();
-      auto AllocRes = invoke(RFuncInst, ReallocArgs, ReallocTypes);
-      if (AllocRes) {
-        ValVariant PtrInMem = (*AllocRes)[0].first;
-        MemInst->setBytes(std::vector<Byte>{Str.begin(), Str.end()},
-                          PtrInMem.get<uint32_t>(), 0,
-                          static_cast<uint32_t>(Str.size()));
-        CoreVals.push_back(PtrInMem);
-        CoreVals.push_back(StrSize);
-      } else {
-        CoreVals.push_back(0);
-        CoreVals.push_back(0);
+namespace {
+
+using CanonAdapter = Runtime::Instance::Component::CanonAdapter;
+using Kind = CanonAdapter::Kind;
+
+uint32_t alignTo(uint32_t Ptr, uint32_t Align) noexcept {
+  return (Ptr + Align - 1) / Align * Align;
+}
+
+bool isWideKind(Kind K) noexcept {
+  return K == Kind::S64 || K == Kind::U64 || K == Kind::F64;
+}
+
+bool isCharValid(uint64_t C) noexcept {
+  return C < 0xD800U || (C >= 0xE000U && C < 0x110000U);
+}
+
+/// Check the bytes are well-formed UTF-8, without the overlong encodings and
+/// the surrogates.
+bool isUTF8Valid(Span<const Byte> Bytes) noexcept {
+  size_t I = 0;
+  while (I < Bytes.size()) {
+    const uint32_t B = Bytes[I];
+    uint32_t N;
+    uint32_t C;
+    if (B < 0x80U) {
+      ++I;
+      continue;
+    } else if ((B & 0xE0U) == 0xC0U) {
+      N = 1;
+      C = B & 0x1FU;
+    } else if ((B & 0xF0U) == 0xE0U) {
+      N = 2;
+      C = B & 0x0FU;
+    } else if ((B & 0xF8U) == 0xF0U) {
+      N = 3;
+      C = B & 0x07U;
+    } else {
+      return false;
+    }
+    if (Bytes.size() - I <= N) {
+      return false;
+    }
+    for (uint32_t J = 1; J <= N; ++J) {
+      if ((Bytes[I + J] & 0xC0U) != 0x80U) {
+        return false;
       }
-      break;
+      C = (C << 6) | (Bytes[I + J] & 0x3FU);
+    }
+    // The minimal code points encoded by 2, 3, and 4 bytes.
+    static constexpr uint32_t MinCode[] = {0, 0x80U, 0x800U, 0x10000U};
+    if (C < MinCode[N] || !isCharValid(C)) {
+      return false;
+    }
+    I += N + 1;
+  }
+  return true;
+}
+
+/// Join the flattened types of the variant cases.
+ValType joinFlat(const ValType &A, const ValType &B) noexcept {
+  if (A == B) {
+    return A;
+  }
+  if ((A.getCode() == TypeCode::I32 && B.getCode() == TypeCode::F32) ||
+      (A.getCode() == TypeCode::F32 && B.getCode() == TypeCode::I32)) {
+    return TypeCode::I32;
+  }
+  return TypeCode::I64;
+}
+
+/// Compiler of the canonical ABI adapter from the component types.
+class AdapterCompiler {
+public:
+  AdapterCompiler(const Runtime::Instance::ComponentInstance &C,
+                  CanonAdapter &A) noexcept
+      : CompInst(C), Adapter(A) {}
+
+  /// Compile the value type and return the index of its layout.
+  Expect<uint32_t> compile(const ComponentValType &Type) {
+    if (Type.isPrimValType()) {
+      return compilePrim(Type.getCode());
+    }
+    const uint32_t Idx = Type.getTypeIndex();
+    if (auto It = TypeCache.find(Idx); It != TypeCache.end()) {
+      return It->second;
+    }
+    const auto *DType = CompInst.getType(Idx);
+    if (DType == nullptr || !DType->isDefValType()) {
+      return unsupported();
+    }
+    EXPECTED_TRY(uint32_t L, compile(DType->getDefValType()));
+    TypeCache.emplace(Idx, L);
+    return L;
+  }
+
+  /// Make the record layout of the fields.
+  uint32_t makeRecord(const std::vector<uint32_t> &Fields) {
+    CanonAdapter::Layout L;
+    L.Code = Kind::Record;
+    L.Children = Fields;
+    uint32_t Size = 0;
+    for (auto F : Fields) {
+      const auto &Field = Adapter.Layouts[F];
+      L.Align = std::max(L.Align, Field.Align);
+      Size = alignTo(Size, Field.Align);
+      L.Offsets.push_back(Size);
+      L.UsesMemory |= Field.UsesMemory;
+      Size += Field.Size;
+      L.Flat.insert(L.Flat.end(), Field.Flat.begin(), Field.Flat.end());
     }
-    case ComponentTypeCode::TypeIndex: {
-      // TODO: COMPONENT - Not implemented.
+    L.Size = alignTo(Size, L.Align);
+    return add(std::move(L));
+  }
+
+private:
+  Unexpected<ErrCode> unsupported() const noexcept {
+    spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
+    spdlog::error("    Canonical ABI of the value type is not implemented."sv);
+    return Unexpect(ErrCode::Value::ComponentNotImplInstantiate);
+  }
+
+  uint32_t add(CanonAdapter::Layout &&L) {
+    Adapter.Layouts.push_back(std::move(L));
+    return static_cast<uint32_t>(Adapter.Layouts.size() - 1);
+  }
+
+  Expect<uint32_t> compilePrim(ComponentTypeCode Code) {
+    Kind K;
+    uint32_t Size;
+    switch (Code) {
+    case ComponentTypeCode::Bool:
+      K = Kind::Bool;
+      Size = 1;
+      break;
+    case ComponentTypeCode::S8:
+      K = Kind::S8;
+      Size = 1;
+      break;
+    case ComponentTypeCode::U8:
+      K = Kind::U8;
+      Size = 1;
+      break;
+    case ComponentTypeCode::S16:
+      K = Kind::S16;
+      Size = 2;
+      break;
+    case ComponentTypeCode::U16:
+      K = Kind::U16;
+      Size = 2;
+      break;
+    case ComponentTypeCode::S32:
+      K = Kind::S32;
+      Size = 4;
+      break;
+    case ComponentTypeCode::U32:
+      K = Kind::U32;
+      Size = 4;
+      break;
+    case ComponentTypeCode::S64:
+      K = Kind::S64;
+      Size = 8;
       break;
+    case ComponentTypeCode::U64:
+      K = Kind::U64;
+      Size = 8;
+      break;
+    case ComponentTypeCode::F32:
+      K = Kind::F32;
+      Size = 4;
+      break;
+    case ComponentTypeCode::F64:
+      K = Kind::F64;
+      Size = 8;
+      break;
+    case ComponentTypeCode::Char:
+      K = Kind::Char;
+      Size = 4;
+      break;
+    case ComponentTypeCode::String:
+      K = Kind::String;
+      Size = 8;
+      break;
+    default:
+      return unsupported();
     }
-    default: {
-      // Other types don't need conversion
-      const ValVariant &Val = std::get<ValVariant>(Vals[I++]);
-      CoreVals.push_back(Val);
+    if (auto It = PrimCache.find(K); It != PrimCache.end()) {
+      return It->second;
+    }
+    CanonAdapter::Layout L;
+    L.Code = K;
+    L.Size = Size;
+    // The strings are the pairs of the pointer and the length.
+    L.Align = K == Kind::String ? 4 : Size;
+    switch (K) {
+    case Kind::S64:
+    case Kind::U64:
+      L.Flat = {TypeCode::I64};
+      break;
+    case Kind::F32:
+      L.Flat = {TypeCode::F32};
+      break;
+    case Kind::F64:
+      L.Flat = {TypeCode::F64};
       break;
+    case Kind::String:
+      L.Flat = {TypeCode::I32, TypeCode::I32};
+      L.UsesMemory = true;
+      break;
+    default:
+      L.Flat = {TypeCode::I32};
+      break;
+    }
+    const uint32_t Idx = add(std::move(L));
+    PrimCache.emplace(K, Idx);
+    return Idx;
+  }
+
+  Expect<uint32_t> compile(const AST::Component::DefValType &DType) {
+    if (DType.isPrimValType()) {
+      return compilePrim(
+          static_cast<ComponentTypeCode>(DType.getPrimValType()));
     }
+    if (DType.isRecord()) {
+      std::vector<uint32_t> Fields;
+      for (const auto &Field : DType.getRecord().LabelTypes) {
+        EXPECTED_TRY(uint32_t F, compile(Field.getValType()));
+        Fields.push_back(F);
+      }
+      return makeRecord(Fields);
     }
+    if (DType.isTuple()) {
+      std::vector<uint32_t> Fields;
+      for (const auto &Type : DType.getTuple().Types) {
+        EXPECTED_TRY(uint32_t F, compile(Type));
+        Fields.push_back(F);
+      }
+      return makeRecord(Fields);
+    }
+    if (DType.isList()) {
+      if (DType.getList().Len.value_or(0) != 0) {
+        // Fixed-length lists are not supported yet. The loader sets the
+        // length 0 for the lists without the fixed length.
+        return unsupported();
+      }
+      EXPECTED_TRY(uint32_t E, compile(DType.getList().ValTy));
+      CanonAdapter::Layout L;
+      L.Code = Kind::List;
+      L.Size = 8;
+      L.Align = 4;
+      L.Children = {E};
+      L.UsesMemory = true;
+      L.Flat = {TypeCode::I32, TypeCode::I32};
+      return add(std::move(L));
+    }
+    if (DType.isVariant()) {
+      std::vector<uint32_t> Cases;
+      for (const auto &Case : DType.getVariant().Cases) {
+        EXPECTED_TRY(uint32_t C, compileOptional(Case.second));
+        Cases.push_back(C);
+      }
+      return makeVariant(Cases);
+    }
+    if (DType.isEnum()) {
+      return makeVariant(std::vector<uint32_t>(DType.getEnum().Labels.size(),
+                                               CanonAdapter::NoPayload));
+    }
+    if (DType.isOption()) {
+      EXPECTED_TRY(uint32_t Some, compile(DType.getOption().ValTy));
+      return makeVariant({CanonAdapter::NoPayload, Some});
+    }
+    if (DType.isResult()) {
+      EXPECTED_TRY(uint32_t Ok, compileOptional(DType.getResult().ValTy));
+      EXPECTED_TRY(uint32_t Err, compileOptional(DType.getResult().ErrTy));
+      return makeVariant({Ok, Err});
+    }
+    if (DType.isFlags()) {
+      const auto N = static_cast<uint32_t>(DType.getFlags().Labels.size());
+      if (N == 0 || N > 32) {
+        return unsupported();
+      }
+      const uint32_t Size = N <= 8 ? 1 : (N <= 16 ? 2 : 4);
+      CanonAdapter::Layout L;
+      L.Code = Kind::Flags;
+      L.Size = Size;
+      L.Align = Size;
+      L.Labels = N;
+      L.Flat = {TypeCode::I32};
+      return add(std::move(L));
+    }
+    // Resources, streams, and futures.
+    return unsupported();
+  }
+
+  Expect<uint32_t>
+  compileOptional(const std::optional<ComponentValType> &Type) {
+    if (!Type.has_value()) {
+      return CanonAdapter::NoPayload;
+    }
+    return compile(*Type);
+  }
+
+  uint32_t makeVariant(const std::vector<uint32_t> &Cases) {
+    CanonAdapter::Layout L;
+    L.Code = Kind::Variant;
+    L.Children = Cases;
+    L.DiscSize =
+        Cases.size() <= 0x100U ? 1 : (Cases.size() <= 0x10000U ? 2 : 4);
+    uint32_t CaseAlign = 1, CaseSize = 0;
+    std::vector<ValType> Joined;
+    for (auto C : Cases) {
+      if (C == CanonAdapter::NoPayload) {
+        continue;
+      }
+      const auto &Payload = Adapter.Layouts[C];
+      CaseAlign = std::max(CaseAlign, Payload.Align);
+      CaseSize = std::max(CaseSize, Payload.Size);
+      L.UsesMemory |= Payload.UsesMemory;
+      for (size_t I = 0; I < Payload.Flat.size(); ++I) {
+        if (I < Joined.size()) {
+          Joined[I] = joinFlat(Joined[I], Payload.Flat[I]);
+        } else {
+          Joined.push_back(Payload.Flat[I]);
+        }
+      }
+    }
+    L.Align = std::max(L.DiscSize, CaseAlign);
+    L.PayloadOffset = alignTo(L.DiscSize, CaseAlign);
+    L.Size = alignTo(L.PayloadOffset + CaseSize, L.Align);
+    L.Flat.push_back(TypeCode::I32);
+    L.Flat.insert(L.Flat.end(), Joined.begin(), Joined.end());
+    return add(std::move(L));
+  }
+
+  const Runtime::Instance::ComponentInstance &CompInst;
+  CanonAdapter &Adapter;
+  std::unordered_map<uint32_t, uint32_t> TypeCache;
+  std::unordered_map<Kind, uint32_t> PrimCache;
+};
+
+/// Compile the canonical ABI adapter of the lifted function type.
+Expect<std::unique_ptr<CanonAdapter>>
+compileAdapter(const Runtime::Instance::ComponentInstance &CompInst,
+               const AST::Component::FuncType &FuncType) {
+  auto Adapter = std::make_unique<CanonAdapter>();
+  AdapterCompiler Compiler(CompInst, *Adapter);
+  for (const auto &Param : FuncType.getParamList()) {
+    EXPECTED_TRY(uint32_t L, Compiler.compile(Param.getValType()));
+    Adapter->ParamTypes.push_back(Param.getValType());
+    Adapter->Params.push_back(L);
+  }
+  for (const auto &Result : FuncType.getResultList()) {
+    EXPECTED_TRY(uint32_t L, Compiler.compile(Result.getValType()));
+    Adapter->ResultTypes.push_back(Result.getValType());
+    Adapter->Results.push_back(L);
+  }
+  Adapter->ParamTuple = Compiler.makeRecord(Adapter->Params);
+  Adapter->ResultTuple = Compiler.makeRecord(Adapter->Results);
+
+  // The flattened types over the limits are passed by a pointer instead.
+  Adapter->CoreParams = Adapter->Layouts[Adapter->ParamTuple].Flat;
+  if (Adapter->CoreParams.size() > CanonAdapter::MaxFlatParams) {
+    Adapter->ParamsInMemory = true;
+    Adapter->CoreParams = {TypeCode::I32};
+  }
+  Adapter->CoreResults = Adapter->Layouts[Adapter->ResultTuple].Flat;
+  if (Adapter->CoreResults.size() > CanonAdapter::MaxFlatResults) {
+    Adapter->ResultsInMemory = true;
+    Adapter->CoreResults = {TypeCode::I32};
   }
-  return CoreVals;
+  Adapter->NeedRealloc = Adapter->ParamsInMemory ||
+                         Adapter->Layouts[Adapter->ParamTuple].UsesMemory;
+  Adapter->NeedMemory = Adapter->NeedRealloc || Adapter->ResultsInMemory ||
+                        Adapter->Layouts[Adapter->ResultTuple].UsesMemory;
+  return Adapter;
 }
 
-std::vector<std::pair<ComponentValVariant, ComponentValType>>
-Executor::convValsToComponent(
-    Span<const std::pair<ValVariant, ValType>> CoreVals,
-    Span<const ComponentValType> ValTypes,
-    Runtime::Instance::MemoryInstance *MemInst) noexcept {
-  uint32_t I = 0;
-  std::vector<std::pair<ComponentValVariant, ComponentValType>> Vals;
-  for (const auto &Type : ValTypes) {
-    switch (Type.getCode()) {
-    case ComponentTypeCode::String: {
-      auto Off = CoreVals[I++].first.get<uint32_t>();
-      auto Size = CoreVals[I++].first.get<uint32_t>();
-      auto Str = MemInst->getStringView(Off, Size);
-      Vals.emplace_back(std::string(Str), Type);
-      break;
+/// Check the range is aligned and in the linear memory.
+Expect<void> checkCanonRange(const Runtime::Instance::MemoryInstance &MemInst,
+                             uint64_t Addr, uint32_t Align, uint64_t Size) {
+  if (unlikely(Addr % Align != 0)) {
+    spdlog::error(ErrCode::Value::InvalidCanonValue);
+    spdlog::error("    Unaligned pointer {} of alignment {}."sv, Addr, Align);
+    return Unexpect(ErrCode::Value::InvalidCanonValue);
+  }
+  if (unlikely(Addr + Size > UINT32_MAX ||
+               !MemInst.checkAccessBound(static_cast<uint32_t>(Addr),
+                                         static_cast<uint32_t>(Size)))) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  return {};
+}
+
+/// Allocate in the linear memory by the realloc function.
+Expect<uint32_t>
+allocateCanon(Executor &Exec, const Runtime::Instance::FunctionInstance &Realloc,
+              const Runtime::Instance::MemoryInstance &MemInst, uint32_t Align,
+              uint64_t Size) {
+  if (unlikely(Size > UINT32_MAX)) {
+    spdlog::error(ErrCode::Value::MemoryOutOfBounds);
+    return Unexpect(ErrCode::Value::MemoryOutOfBounds);
+  }
+  const std::array<ValVariant, 4> Args = {
+      ValVariant(UINT32_C(0)), ValVariant(UINT32_C(0)), ValVariant(Align),
+      ValVariant(static_cast<uint32_t>(Size))};
+  std::array<ValVariant, 1> Rets;
+  EXPECTED_TRY(Exec.invokeUnchecked(Realloc, Args, Rets));
+  const uint32_t Ptr = Rets[0].get<uint32_t>();
+  EXPECTED_TRY(checkCanonRange(MemInst, Ptr, Align, Size));
+  return Ptr;
+}
+
+/// Marshaler of the values by the compiled canonical ABI adapter.
+class CanonMarshaler {
+public:
+  CanonMarshaler(
+      Executor &E,
+      const Runtime::Instance::Component::FunctionInstance &Func) noexcept
+      : Exec(E), Adapter(Func.getAdapter()), MemInst(Func.getMemoryInstance()),
+        Realloc(Func.getAllocFunction()) {}
+
+  /// Allocate in the linear memory by the realloc function.
+  Expect<uint32_t> allocate(uint32_t Align, uint64_t Size) {
+    return allocateCanon(Exec, *Realloc, *MemInst, Align, Size);
+  }
+
+  /// Lower the value into the flattened core values.
+  Expect<void> lowerFlat(uint32_t Idx, const ComponentValVariant &Val,
+                         std::vector<ValVariant> &Out) {
+    const auto &L = Adapter.Layouts[Idx];
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      EXPECTED_TRY(auto Range, storeRange(L, Val));
+      Out.emplace_back(Range.first);
+      Out.emplace_back(Range.second);
+      return {};
+    }
+    case Kind::Record: {
+      EXPECTED_TRY(const auto *C, getComposite(Val, L.Children.size()));
+      for (size_t I = 0; I < L.Children.size(); ++I) {
+        EXPECTED_TRY(lowerFlat(L.Children[I], C->Values[I], Out));
+      }
+      return {};
+    }
+    case Kind::Variant: {
+      EXPECTED_TRY(const auto *C, getCase(L, Val));
+      Out.emplace_back(C->Discriminant);
+      const size_t Begin = Out.size();
+      if (const auto P = L.Children[C->Discriminant];
+          P != CanonAdapter::NoPayload) {
+        EXPECTED_TRY(lowerFlat(P, C->Values[0], Out));
+        // Coerce the payload into the joined types.
+        const auto &Flat = Adapter.Layouts[P].Flat;
+        for (size_t I = 0; I < Flat.size(); ++I) {
+          if (L.Flat[I + 1].getCode() == TypeCode::I64 &&
+              (Flat[I].getCode() == TypeCode::I32 ||
+               Flat[I].getCode() == TypeCode::F32)) {
+            Out[Begin + I] =
+                static_cast<uint64_t>(Out[Begin + I].get<uint32_t>());
+          }
+        }
+      }
+      // Fill the rest of the joined types with zeros.
+      for (size_t I = Out.size() - Begin + 1; I < L.Flat.size(); ++I) {
+        if (L.Flat[I].getCode() == TypeCode::I64 ||
+            L.Flat[I].getCode() == TypeCode::F64) {
+          Out.emplace_back(UINT64_C(0));
+        } else {
+          Out.emplace_back(UINT32_C(0));
+        }
+      }
+      return {};
+    }
+    case Kind::Flags: {
+      EXPECTED_TRY(const auto *C, getComposite(Val, 0));
+      Out.emplace_back(C->Discriminant);
+      return {};
+    }
+    default: {
+      EXPECTED_TRY(uint64_t Bits, lowerScalar(L.Code, Val));
+      if (isWideKind(L.Code)) {
+        Out.emplace_back(Bits);
+      } else {
+        Out.emplace_back(static_cast<uint32_t>(Bits));
+      }
+      return {};
+    }
+    }
+  }
+
+  /// Store the value into the linear memory.
+  Expect<void> store(uint32_t Idx, const ComponentValVariant &Val,
+                     uint64_t Addr) {
+    const auto &L = Adapter.Layouts[Idx];
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      EXPECTED_TRY(auto Range, storeRange(L, Val));
+      EXPECTED_TRY(storeInt(Range.first, Addr, 4));
+      return storeInt(Range.second, Addr + 4, 4);
+    }
+    case Kind::Record: {
+      EXPECTED_TRY(const auto *C, getComposite(Val, L.Children.size()));
+      for (size_t I = 0; I < L.Children.size(); ++I) {
+        EXPECTED_TRY(store(L.Children[I], C->Values[I], Addr + L.Offsets[I]));
+      }
+      return {};
+    }
+    case Kind::Variant: {
+      EXPECTED_TRY(const auto *C, getCase(L, Val));
+      EXPECTED_TRY(storeInt(C->Discriminant, Addr, L.DiscSize));
+      if (const auto P = L.Children[C->Discriminant];
+          P != CanonAdapter::NoPayload) {
+        return store(P, C->Values[0], Addr + L.PayloadOffset);
+      }
+      return {};
+    }
+    case Kind::Flags: {
+      EXPECTED_TRY(const auto *C, getComposite(Val, 0));
+      return storeInt(C->Discriminant, Addr, L.Size);
+    }
+    default: {
+      EXPECTED_TRY(uint64_t Bits, lowerScalar(L.Code, Val));
+      return storeInt(Bits, Addr, L.Size);
+    }
+    }
+  }
+
+  /// Lift the value from the flattened core values.
+  Expect<ComponentValVariant> liftFlat(uint32_t Idx, Span<const ValVariant> In,
+                                       size_t &Pos) {
+    const auto &L = Adapter.Layouts[Idx];
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      const uint32_t Ptr = In[Pos++].get<uint32_t>();
+      const uint32_t Len = In[Pos++].get<uint32_t>();
+      return loadRange(L, Ptr, Len);
+    }
+    case Kind::Record: {
+      auto C = std::make_shared<ComponentValComposite>();
+      C->Values.reserve(L.Children.size());
+      for (auto F : L.Children) {
+        EXPECTED_TRY(auto V, liftFlat(F, In, Pos));
+        C->Values.push_back(std::move(V));
+      }
+      return C;
+    }
+    case Kind::Variant: {
+      auto C = std::make_shared<ComponentValComposite>();
+      C->Discriminant = In[Pos++].get<uint32_t>();
+      EXPECTED_TRY(checkCase(L, C->Discriminant));
+      const size_t Begin = Pos;
+      if (const auto P = L.Children[C->Discriminant];
+          P != CanonAdapter::NoPayload) {
+        // Coerce the joined types back into the payload types.
+        const auto &Flat = Adapter.Layouts[P].Flat;
+        std::vector<ValVariant> Payload(In.begin() + Begin,
+                                        In.begin() + Begin + Flat.size());
+        for (size_t I = 0; I < Flat.size(); ++I) {
+          if (L.Flat[I + 1].getCode() == TypeCode::I64 &&
+              (Flat[I].getCode() == TypeCode::I32 ||
+               Flat[I].getCode() == TypeCode::F32)) {
+            Payload[I] = static_cast<uint32_t>(Payload[I].get<uint64_t>());
+          }
+        }
+        size_t PayloadPos = 0;
+        EXPECTED_TRY(auto V, liftFlat(P, Payload, PayloadPos));
+        C->Values.push_back(std::move(V));
+      }
+      Pos = Begin + L.Flat.size() - 1;
+      return C;
+    }
+    case Kind::Flags: {
+      auto C = std::make_shared<ComponentValComposite>();
+      C->Discriminant = maskFlags(L, In[Pos++].get<uint32_t>());
+      return C;
+    }
+    default: {
+      const auto &Val = In[Pos++];
+      return liftScalar(L.Code, isWideKind(L.Code) ? Val.get<uint64_t>()
+                                                   : Val.get<uint32_t>());
+    }
+    }
+  }
+
+  /// Load the value from the linear memory.
+  Expect<ComponentValVariant> load(uint32_t Idx, uint64_t Addr) {
+    const auto &L = Adapter.Layouts[Idx];
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      EXPECTED_TRY(uint64_t Ptr, loadInt(Addr, 4));
+      EXPECTED_TRY(uint64_t Len, loadInt(Addr + 4, 4));
+      return loadRange(L, static_cast<uint32_t>(Ptr),
+                       static_cast<uint32_t>(Len));
+    }
+    case Kind::Record: {
+      auto C = std::make_shared<ComponentValComposite>();
+      C->Values.reserve(L.Children.size());
+      for (size_t I = 0; I < L.Children.size(); ++I) {
+        EXPECTED_TRY(auto V, load(L.Children[I], Addr + L.Offsets[I]));
+        C->Values.push_back(std::move(V));
+      }
+      return C;
+    }
+    case Kind::Variant: {
+      auto C = std::make_shared<ComponentValComposite>();
+      EXPECTED_TRY(uint64_t Disc, loadInt(Addr, L.DiscSize));
+      C->Discriminant = static_cast<uint32_t>(Disc);
+      EXPECTED_TRY(checkCase(L, C->Discriminant));
+      if (const auto P = L.Children[C->Discriminant];
+          P != CanonAdapter::NoPayload) {
+        EXPECTED_TRY(auto V, load(P, Addr + L.PayloadOffset));
+        C->Values.push_back(std::move(V));
+      }
+      return C;
+    }
+    case Kind::Flags: {
+      auto C = std::make_shared<ComponentValComposite>();
+      EXPECTED_TRY(uint64_t Bits, loadInt(Addr, L.Size));
+      C->Discriminant = maskFlags(L, static_cast<uint32_t>(Bits));
+      return C;
+    }
+    default: {
+      EXPECTED_TRY(uint64_t Bits, loadInt(Addr, L.Size));
+      return liftScalar(L.Code, Bits);
+    }
+    }
+  }
+
+  /// Check the range is aligned and in the linear memory.
+  Expect<void> checkRange(uint64_t Addr, uint32_t Align, uint64_t Size) {
+    return checkCanonRange(*MemInst, Addr, Align, Size);
+  }
+
+private:
+  static Unexpected<ErrCode> mismatch() noexcept {
+    spdlog::error(ErrCode::Value::FuncSigMismatch);
+    spdlog::error("    Cannot lower the value into the component type."sv);
+    return Unexpect(ErrCode::Value::FuncSigMismatch);
+  }
+
+  static Expect<const ComponentValComposite *>
+  getComposite(const ComponentValVariant &Val, size_t Count) noexcept {
+    const auto *C = std::get_if<std::shared_ptr<ComponentValComposite>>(&Val);
+    if (unlikely(C == nullptr || *C == nullptr ||
+                 (*C)->Values.size() != Count)) {
+      return mismatch();
+    }
+    return C->get();
+  }
+
+  static Expect<const ComponentValComposite *>
+  getCase(const CanonAdapter::Layout &L,
+          const ComponentValVariant &Val) noexcept {
+    const auto *C = std::get_if<std::shared_ptr<ComponentValComposite>>(&Val);
+    if (unlikely(C == nullptr || *C == nullptr ||
+                 (*C)->Discriminant >= L.Children.size())) {
+      return mismatch();
+    }
+    const bool HasPayload =
+        L.Children[(*C)->Discriminant] != CanonAdapter::NoPayload;
+    if (unlikely((*C)->Values.size() != (HasPayload ? 1U : 0U))) {
+      return mismatch();
+    }
+    return C->get();
+  }
+
+  static Expect<void> checkCase(const CanonAdapter::Layout &L,
+                                uint32_t Disc) noexcept {
+    if (unlikely(Disc >= L.Children.size())) {
+      spdlog::error(ErrCode::Value::InvalidCanonValue);
+      spdlog::error("    Invalid case {} of variant."sv, Disc);
+      return Unexpect(ErrCode::Value::InvalidCanonValue);
     }
-    case ComponentTypeCode::TypeIndex: {
-      // TODO: COMPONENT - Not implemented.
+    return {};
+  }
+
+  static uint32_t maskFlags(const CanonAdapter::Layout &L,
+                            uint32_t Bits) noexcept {
+    return L.Labels < 32 ? Bits & ((UINT32_C(1) << L.Labels) - 1) : Bits;
+  }
+
+  /// Get the bits of the scalar value in the core value type of the kind.
+  static Expect<uint64_t> lowerScalar(Kind K,
+                                      const ComponentValVariant &Val) noexcept {
+    uint64_t Bits = 0;
+    if (const auto *V = std::get_if<ValVariant>(&Val)) {
+      Bits = isWideKind(K) ? V->get<uint64_t>() : V->get<uint32_t>();
+    } else if (K == Kind::F32 || K == Kind::F64) {
+      double D;
+      if (const auto *F = std::get_if<float>(&Val)) {
+        D = *F;
+      } else if (const auto *F64 = std::get_if<double>(&Val)) {
+        D = *F64;
+      } else {
+        return mismatch();
+      }
+      Bits = K == Kind::F32 ? ValVariant(static_cast<float>(D)).get<uint32_t>()
+                            : ValVariant(D).get<uint64_t>();
+    } else {
+      auto Int = std::visit(
+          [](const auto &X) -> std::optional<uint64_t> {
+            using T = std::decay_t<decltype(X)>;
+            if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+              return static_cast<uint64_t>(static_cast<int64_t>(X));
+            } else if constexpr (std::is_integral_v<T>) {
+              return static_cast<uint64_t>(X);
+            } else {
+              return std::nullopt;
+            }
+          },
+          Val);
+      if (!Int.has_value()) {
+        return mismatch();
+      }
+      Bits = *Int;
+    }
+
+    switch (K) {
+    case Kind::Bool:
+      return Bits != 0 ? 1 : 0;
+    case Kind::S8:
+      return static_cast<uint32_t>(static_cast<int8_t>(Bits));
+    case Kind::U8:
+      return static_cast<uint8_t>(Bits);
+    case Kind::S16:
+      return static_cast<uint32_t>(static_cast<int16_t>(Bits));
+    case Kind::U16:
+      return static_cast<uint16_t>(Bits);
+    case Kind::Char:
+      if (unlikely(!isCharValid(Bits))) {
+        spdlog::error(ErrCode::Value::InvalidCanonValue);
+        spdlog::error("    Invalid char {}."sv, Bits);
+        return Unexpect(ErrCode::Value::InvalidCanonValue);
+      }
+      return Bits;
+    default:
+      return isWideKind(K) ? Bits : static_cast<uint32_t>(Bits);
+    }
+  }
+
+  /// Get the host value from the bits of the scalar in the core value type.
+  static Expect<ComponentValVariant> liftScalar(Kind K,
+                                                uint64_t Bits) noexcept {
+    switch (K) {
+    case Kind::Bool:
+      return ValVariant(static_cast<uint32_t>(Bits != 0));
+    case Kind::S8:
+      return ValVariant(static_cast<int32_t>(static_cast<int8_t>(Bits)));
+    case Kind::U8:
+      return ValVariant(static_cast<uint32_t>(static_cast<uint8_t>(Bits)));
+    case Kind::S16:
+      return ValVariant(static_cast<int32_t>(static_cast<int16_t>(Bits)));
+    case Kind::U16:
+      return ValVariant(static_cast<uint32_t>(static_cast<uint16_t>(Bits)));
+    case Kind::Char:
+      if (unlikely(!isCharValid(Bits))) {
+        spdlog::error(ErrCode::Value::InvalidCanonValue);
+        spdlog::error("    Invalid char {}."sv, Bits);
+        return Unexpect(ErrCode::Value::InvalidCanonValue);
+      }
+      return ValVariant(static_cast<uint32_t>(Bits));
+    case Kind::F32:
+      return ValVariant(
+          ValVariant(static_cast<uint32_t>(Bits)).get<float>());
+    case Kind::F64:
+      return ValVariant(ValVariant(Bits).get<double>());
+    case Kind::S64:
+    case Kind::U64:
+      return ValVariant(Bits);
+    default:
+      return ValVariant(static_cast<uint32_t>(Bits));
+    }
+  }
+
+  /// Store the string or the list into the allocated range, and return the
+  /// pointer and the length.
+  Expect<std::pair<uint32_t, uint32_t>>
+  storeRange(const CanonAdapter::Layout &L, const ComponentValVariant &Val) {
+    if (L.Code == Kind::String) {
+      const auto *Str = std::get_if<std::string>(&Val);
+      if (unlikely(Str == nullptr)) {
+        return mismatch();
+      }
+      EXPECTED_TRY(uint32_t Ptr, allocate(1, Str->size()));
+      EXPECTED_TRY(auto Bytes, MemInst->getBytes(
+                                   Ptr, static_cast<uint32_t>(Str->size())));
+      std::copy(Str->begin(), Str->end(), Bytes.begin());
+      return std::make_pair(Ptr, static_cast<uint32_t>(Str->size()));
+    }
+    const auto *C = std::get_if<std::shared_ptr<ComponentValComposite>>(&Val);
+    if (unlikely(C == nullptr || *C == nullptr)) {
+      return mismatch();
+    }
+    const auto &Elem = Adapter.Layouts[L.Children[0]];
+    const auto &Values = (*C)->Values;
+    EXPECTED_TRY(uint32_t Ptr, allocate(Elem.Align, static_cast<uint64_t>(
+                                                        Values.size()) *
+                                                        Elem.Size));
+    for (size_t I = 0; I < Values.size(); ++I) {
+      EXPECTED_TRY(store(L.Children[0], Values[I],
+                         Ptr + static_cast<uint64_t>(I) * Elem.Size));
+    }
+    return std::make_pair(Ptr, static_cast<uint32_t>(Values.size()));
+  }
+
+  /// Load the string or the list from the range.
+  Expect<ComponentValVariant> loadRange(const CanonAdapter::Layout &L,
+                                        uint32_t Ptr, uint32_t Len) {
+    if (L.Code == Kind::String) {
+      EXPECTED_TRY(auto Bytes, MemInst->getBytes(Ptr, Len));
+      if (unlikely(!isUTF8Valid(Bytes))) {
+        spdlog::error(ErrCode::Value::InvalidCanonValue);
+        spdlog::error("    Invalid UTF-8 string at {}."sv, Ptr);
+        return Unexpect(ErrCode::Value::InvalidCanonValue);
+      }
+      return std::string(Bytes.begin(), Bytes.end());
+    }
+    const auto &Elem = Adapter.Layouts[L.Children[0]];
+    EXPECTED_TRY(
+        checkRange(Ptr, Elem.Align, static_cast<uint64_t>(Len) * Elem.Size));
+    auto C = std::make_shared<ComponentValComposite>();
+    C->Values.reserve(Len);
+    for (uint32_t I = 0; I < Len; ++I) {
+      EXPECTED_TRY(auto V, load(L.Children[0],
+                                Ptr + static_cast<uint64_t>(I) * Elem.Size));
+      C->Values.push_back(std::move(V));
+    }
+    return C;
+  }
+
+  Expect<uint64_t> loadInt(uint64_t Addr, uint32_t Size) {
+    EXPECTED_TRY(checkRange(Addr, 1, Size));
+    const auto Ptr = static_cast<uint32_t>(Addr);
+    uint64_t Val = 0;
+    Expect<void> Res;
+    switch (Size) {
+    case 1:
+      Res = MemInst->loadValue<uint64_t, 1>(Val, Ptr);
       break;
+    case 2:
+      Res = MemInst->loadValue<uint64_t, 2>(Val, Ptr);
+      break;
+    case 4:
+      Res = MemInst->loadValue<uint64_t, 4>(Val, Ptr);
+      break;
+    default:
+      Res = MemInst->loadValue<uint64_t, 8>(Val, Ptr);
+      break;
+    }
+    EXPECTED_TRY(Res);
+    return Val;
+  }
+
+  Expect<void> storeInt(uint64_t Val, uint64_t Addr, uint32_t Size) {
+    EXPECTED_TRY(checkRange(Addr, 1, Size));
+    const auto Ptr = static_cast<uint32_t>(Addr);
+    switch (Size) {
+    case 1:
+      return MemInst->storeValue<uint64_t, 1>(Val, Ptr);
+    case 2:
+      return MemInst->storeValue<uint64_t, 2>(Val, Ptr);
+    case 4:
+      return MemInst->storeValue<uint64_t, 4>(Val, Ptr);
+    default:
+      return MemInst->storeValue<uint64_t, 8>(Val, Ptr);
+    }
+  }
+
+  Executor &Exec;
+  const CanonAdapter &Adapter;
+  Runtime::Instance::MemoryInstance *MemInst;
+  Runtime::Instance::FunctionInstance *Realloc;
+};
+
+/// Relocator of the values between the linear memories by the compiled
+/// canonical ABI adapter. The strings and the lists are copied by a realloc
+/// call and a memcpy each, without lifting them into the host values. Nothing
+/// is copied if the source and the destination share the memory.
+class CanonRelocator {
+public:
+  CanonRelocator(Executor &E, const CanonAdapter &A,
+                 const Runtime::Instance::MemoryInstance &S,
+                 Runtime::Instance::MemoryInstance &D,
+                 const Runtime::Instance::FunctionInstance *R) noexcept
+      : Exec(E), Adapter(A), Src(S), Dst(D), Realloc(R) {}
+
+  /// Relocate the flattened value in place.
+  Expect<void> copyFlat(uint32_t Idx, Span<ValVariant> Vals, size_t &Pos) {
+    const auto &L = Adapter.Layouts[Idx];
+    if (!L.UsesMemory || &Src == &Dst) {
+      Pos += L.Flat.size();
+      return {};
+    }
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      EXPECTED_TRY(uint32_t Ptr, copyRange(L, Vals[Pos].get<uint32_t>(),
+                                           Vals[Pos + 1].get<uint32_t>()));
+      Vals[Pos] = Ptr;
+      Pos += 2;
+      return {};
+    }
+    case Kind::Record:
+      for (auto F : L.Children) {
+        EXPECTED_TRY(copyFlat(F, Vals, Pos));
+      }
+      return {};
+    case Kind::Variant: {
+      const uint32_t Disc = Vals[Pos].get<uint32_t>();
+      EXPECTED_TRY(checkCase(L, Disc));
+      const size_t Begin = Pos + 1;
+      Pos = Begin + L.Flat.size() - 1;
+      const auto P = L.Children[Disc];
+      if (P == CanonAdapter::NoPayload || !Adapter.Layouts[P].UsesMemory) {
+        return {};
+      }
+      // The pointers are zero-extended if the payload is joined into i64.
+      const auto &Flat = Adapter.Layouts[P].Flat;
+      std::vector<ValVariant> Payload(Flat.size());
+      for (size_t I = 0; I < Flat.size(); ++I) {
+        Payload[I] = isWidened(L, Flat, I)
+                         ? ValVariant(static_cast<uint32_t>(
+                               Vals[Begin + I].get<uint64_t>()))
+                         : Vals[Begin + I];
+      }
+      size_t PayloadPos = 0;
+      EXPECTED_TRY(copyFlat(P, Payload, PayloadPos));
+      for (size_t I = 0; I < Flat.size(); ++I) {
+        Vals[Begin + I] =
+            isWidened(L, Flat, I)
+                ? ValVariant(static_cast<uint64_t>(Payload[I].get<uint32_t>()))
+                : Payload[I];
+      }
+      return {};
+    }
+    default:
+      Pos += L.Flat.size();
+      return {};
+    }
+  }
+
+  /// Copy the value block into a new allocation, and return the pointer.
+  Expect<uint32_t> copyBlock(uint32_t Idx, uint32_t SrcPtr) {
+    const auto &L = Adapter.Layouts[Idx];
+    if (&Src == &Dst) {
+      EXPECTED_TRY(checkCanonRange(Src, SrcPtr, L.Align, L.Size));
+      return SrcPtr;
+    }
+    EXPECTED_TRY(uint32_t DstPtr,
+                 allocateCanon(Exec, *Realloc, Dst, L.Align, L.Size));
+    EXPECTED_TRY(copyBlockTo(Idx, SrcPtr, DstPtr));
+    return DstPtr;
+  }
+
+  /// Copy the value block into the given range.
+  Expect<void> copyBlockTo(uint32_t Idx, uint32_t SrcPtr, uint32_t DstPtr) {
+    const auto &L = Adapter.Layouts[Idx];
+    EXPECTED_TRY(checkCanonRange(Src, SrcPtr, L.Align, L.Size));
+    EXPECTED_TRY(checkCanonRange(Dst, DstPtr, L.Align, L.Size));
+    EXPECTED_TRY(copyBytes(SrcPtr, DstPtr, L.Size));
+    if (L.UsesMemory && &Src != &Dst) {
+      return relocate(Idx, DstPtr);
+    }
+    return {};
+  }
+
+private:
+  static bool isWidened(const CanonAdapter::Layout &L,
+                        const std::vector<ValType> &Flat, size_t I) noexcept {
+    return L.Flat[I + 1].getCode() == TypeCode::I64 &&
+           (Flat[I].getCode() == TypeCode::I32 ||
+            Flat[I].getCode() == TypeCode::F32);
+  }
+
+  static Expect<void> checkCase(const CanonAdapter::Layout &L,
+                                uint32_t Disc) noexcept {
+    if (unlikely(Disc >= L.Children.size())) {
+      spdlog::error(ErrCode::Value::InvalidCanonValue);
+      spdlog::error("    Invalid case {} of variant."sv, Disc);
+      return Unexpect(ErrCode::Value::InvalidCanonValue);
+    }
+    return {};
+  }
+
+  Expect<void> copyBytes(uint32_t SrcPtr, uint32_t DstPtr, uint32_t Size) {
+    EXPECTED_TRY(auto Bytes, Src.getBytes(SrcPtr, Size));
+    return Dst.setBytes(Bytes, DstPtr, 0, Size);
+  }
+
+  /// Copy the string or the list into a new allocation, and return the
+  /// pointer.
+  Expect<uint32_t> copyRange(const CanonAdapter::Layout &L, uint32_t SrcPtr,
+                             uint32_t Len) {
+    const CanonAdapter::Layout *Elem = nullptr;
+    uint32_t Align = 1;
+    uint64_t Size = Len;
+    if (L.Code == Kind::List) {
+      Elem = &Adapter.Layouts[L.Children[0]];
+      Align = Elem->Align;
+      Size *= Elem->Size;
+    }
+    EXPECTED_TRY(checkCanonRange(Src, SrcPtr, Align, Size));
+    EXPECTED_TRY(uint32_t DstPtr,
+                 allocateCanon(Exec, *Realloc, Dst, Align, Size));
+    EXPECTED_TRY(copyBytes(SrcPtr, DstPtr, static_cast<uint32_t>(Size)));
+    if (Elem != nullptr && Elem->UsesMemory) {
+      for (uint32_t I = 0; I < Len; ++I) {
+        EXPECTED_TRY(relocate(L.Children[0], DstPtr + I * Elem->Size));
+      }
+    }
+    return DstPtr;
+  }
+
+  /// Relocate the pointers in the copied value block.
+  Expect<void> relocate(uint32_t Idx, uint32_t Addr) {
+    const auto &L = Adapter.Layouts[Idx];
+    switch (L.Code) {
+    case Kind::String:
+    case Kind::List: {
+      uint32_t Ptr = 0, Len = 0;
+      EXPECTED_TRY(Dst.loadValue(Ptr, Addr));
+      EXPECTED_TRY(Dst.loadValue(Len, Addr + 4));
+      EXPECTED_TRY(uint32_t NewPtr, copyRange(L, Ptr, Len));
+      return Dst.storeValue(NewPtr, Addr);
+    }
+    case Kind::Record:
+      for (size_t I = 0; I < L.Children.size(); ++I) {
+        if (Adapter.Layouts[L.Children[I]].UsesMemory) {
+          EXPECTED_TRY(relocate(L.Children[I], Addr + L.Offsets[I]));
+        }
+      }
+      return {};
+    case Kind::Variant: {
+      uint32_t Disc = 0;
+      switch (L.DiscSize) {
+      case 1:
+        EXPECTED_TRY((Dst.loadValue<uint32_t, 1>(Disc, Addr)));
+        break;
+      case 2:
+        EXPECTED_TRY((Dst.loadValue<uint32_t, 2>(Disc, Addr)));
+        break;
+      default:
+        EXPECTED_TRY(Dst.loadValue(Disc, Addr));
+        break;
+      }
+      EXPECTED_TRY(checkCase(L, Disc));
+      const auto P = L.Children[Disc];
+      if (P != CanonAdapter::NoPayload && Adapter.Layouts[P].UsesMemory) {
+        return relocate(P, Addr + L.PayloadOffset);
+      }
+      return {};
+    }
+    default:
+      return {};
+    }
+  }
+
+  Executor &Exec;
+  const CanonAdapter &Adapter;
+  const Runtime::Instance::MemoryInstance &Src;
+  Runtime::Instance::MemoryInstance &Dst;
+  const Runtime::Instance::FunctionInstance *Realloc;
+};
+
+/// Core function of a lifted function lowered into a component with another
+/// memory. The values are relocated between the memories of the caller and
+/// the callee directly, instead of going through the host values.
+class FusedAdapter : public Runtime::HostFunctionBase {
+public:
+  FusedAdapter(const Runtime::Instance::Component::FunctionInstance &F,
+               Runtime::Instance::MemoryInstance &M,
+               const Runtime::Instance::FunctionInstance *R)
+      : HostFunctionBase(0), Callee(F), Adapter(F.getAdapter()), MemInst(M),
+        Realloc(R) {
+    // The results over the limit are stored to the pointer from the caller.
+    auto &FuncType = DefType.getCompositeType().getFuncType();
+    FuncType.getParamTypes() = Adapter.CoreParams;
+    if (Adapter.ResultsInMemory) {
+      FuncType.getParamTypes().emplace_back(TypeCode::I32);
+    } else {
+      FuncType.getReturnTypes() = Adapter.CoreResults;
+    }
+  }
+
+  Expect<void> run(const Runtime::CallingFrame &CallFrame,
+                   Span<const ValVariant> Args,
+                   Span<ValVariant> Rets) override {
+    auto &Exec = *CallFrame.getExecutor();
+    auto &CalleeMem = *Callee.getMemoryInstance();
+
+    // Relocate the parameters into the memory of the callee.
+    CanonRelocator ToCallee(Exec, Adapter, MemInst, CalleeMem,
+                            Callee.getAllocFunction());
+    std::vector<ValVariant> CoreArgs(
+        Args.begin(), Args.begin() + Adapter.CoreParams.size());
+    if (Adapter.ParamsInMemory) {
+      const uint32_t SrcPtr = CoreArgs[0].get<uint32_t>();
+      EXPECTED_TRY(uint32_t Ptr, ToCallee.copyBlock(Adapter.ParamTuple, SrcPtr));
+      CoreArgs[0] = Ptr;
+    } else {
+      size_t Pos = 0;
+      for (auto P : Adapter.Params) {
+        EXPECTED_TRY(ToCallee.copyFlat(P, CoreArgs, Pos));
+      }
+    }
+
+    std::vector<ValVariant> CoreRets(Adapter.CoreResults.size());
+    EXPECTED_TRY(
+        Exec.invokeUnchecked(*Callee.getLowerFunction(), CoreArgs, CoreRets));
+    if (!Adapter.ResultsInMemory) {
+      // A single flattened result never points into the memory.
+      std::copy(CoreRets.begin(), CoreRets.end(), Rets.begin());
+      return {};
+    }
+
+    // Relocate the results into the memory of the caller.
+    CanonRelocator ToCaller(Exec, Adapter, CalleeMem, MemInst, Realloc);
+    return ToCaller.copyBlockTo(Adapter.ResultTuple,
+                                CoreRets[0].get<uint32_t>(),
+                                Args.back().get<uint32_t>());
+  }
+
+private:
+  const Runtime::Instance::Component::FunctionInstance &Callee;
+  const CanonAdapter &Adapter;
+  Runtime::Instance::MemoryInstance &MemInst;
+  const Runtime::Instance::FunctionInstance *Realloc;
+};
+
+/// Core function of the canonical built-ins of a resource type, operating on
+/// the resource table of the component instance defining the type.
+class ResourceBuiltin : public Runtime::HostFunctionBase {
+public:
+  using OpCode = AST::Component::Canonical::OpCode;
+
+  ResourceBuiltin(OpCode C, Runtime::Instance::ComponentInstance &I,
+                  const AST::Component::DefType &T,
+                  const Runtime::Instance::FunctionInstance *D)
+      : HostFunctionBase(0), Code(C), Table(I.getResourceTable()), Type(T),
+        Dtor(D) {
+    auto &FuncType = DefType.getCompositeType().getFuncType();
+    FuncType.getParamTypes() = {TypeCode::I32};
+    if (Code != OpCode::Resource__drop) {
+      FuncType.getReturnTypes() = {TypeCode::I32};
+    }
+  }
+
+  Expect<void> run(const Runtime::CallingFrame &CallFrame,
+                   Span<const ValVariant> Args,
+                   Span<ValVariant> Rets) override {
+    const uint32_t Arg = Args[0].get<uint32_t>();
+    switch (Code) {
+    case OpCode::Resource__new: {
+      EXPECTED_TRY(uint32_t Handle, Table.addOwn(&Type, Arg));
+      Rets[0] = Handle;
+      return {};
+    }
+    case OpCode::Resource__rep: {
+      EXPECTED_TRY(const auto *E, Table.get(Arg, &Type));
+      Rets[0] = E->Rep;
+      return {};
     }
     default: {
-      Vals.emplace_back(CoreVals[I++].first, Type);
+      EXPECTED_TRY(const auto E, Table.remove(Arg, &Type));
+      if (E.isOwn() && Dtor != nullptr) {
+        // The slot is already reusable when the destructor runs.
+        const std::array<ValVariant, 1> DtorArgs = {E.Rep};
+        return CallFrame.getExecutor()->invokeUnchecked(*Dtor, DtorArgs, {});
+      }
+      return {};
+    }
+    }
+  }
+
+private:
+  const OpCode Code;
+  Runtime::Instance::Component::ResourceTable &Table;
+  const AST::Component::DefType &Type;
+  const Runtime::Instance::FunctionInstance *Dtor;
+};
+
+/// Resolve the memory and the realloc options.
+Expect<void>
+getCanonOptions(const Runtime::Instance::ComponentInstance &CompInst,
+                Span<const AST::Component::CanonOpt> Opts,
+                Runtime::Instance::MemoryInstance *&MemInst,
+                Runtime::Instance::FunctionInstance *&ReallocFunc) {
+  for (auto &Opt : Opts) {
+    switch (Opt.getCode()) {
+    case AST::Component::CanonOpt::OptCode::Encode_UTF8:
+      // UTF-8 is the default string encoding.
       break;
+    case AST::Component::CanonOpt::OptCode::Encode_UTF16:
+    case AST::Component::CanonOpt::OptCode::Encode_Latin1:
+      spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
+      spdlog::error("    incomplete canonincal options"sv);
+      return Unexpect(ErrCode::Value::ComponentNotImplInstantiate);
+    case AST::Component::CanonOpt::OptCode::Memory:
+      MemInst = CompInst.getCoreMemory(Opt.getIndex());
+      break;
+    case AST::Component::CanonOpt::OptCode::Realloc:
+      ReallocFunc = CompInst.getCoreFunction(Opt.getIndex());
+      break;
+    case AST::Component::CanonOpt::OptCode::PostReturn:
+    case AST::Component::CanonOpt::OptCode::Async:
+      // TODO: support the post-return and async options.
+      spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
+      spdlog::error("    incomplete canonincal options"sv);
+      return Unexpect(ErrCode::Value::ComponentNotImplInstantiate);
+    default:
+      assumingUnreachable();
+    }
+  }
+  return {};
+}
+
+/// Check the realloc option exists and is typed (i32 i32 i32 i32) -> i32.
+Expect<void>
+checkRealloc(const Runtime::Instance::FunctionInstance *ReallocFunc) {
+  if (unlikely(ReallocFunc == nullptr)) {
+    spdlog::error(ErrCode::Value::InvalidCanonOption);
+    spdlog::error("    Missing the realloc option"sv);
+    return Unexpect(ErrCode::Value::InvalidCanonOption);
+  }
+  const auto &RType = ReallocFunc->getFuncType();
+  const std::vector<ValType> RParams(4, TypeCode::I32);
+  if (unlikely(RType.getParamTypes() != RParams ||
+               RType.getReturnTypes() != std::vector<ValType>{TypeCode::I32})) {
+    spdlog::error(ErrCode::Value::InvalidCanonOption);
+    spdlog::error("    Invalid function type of realloc"sv);
+    return Unexpect(ErrCode::Value::InvalidCanonOption);
+  }
+  return {};
+}
+
+} // namespace
+
+Expect<void> Executor::lowerCanonValues(
+    const Runtime::Instance::Component::FunctionInstance &Func,
+    Span<const ComponentValVariant> Vals, std::vector<ValVariant> &CoreArgs) {
+  const auto &Adapter = Func.getAdapter();
+  CanonMarshaler Marshaler(*this, Func);
+  CoreArgs.clear();
+  CoreArgs.reserve(Adapter.CoreParams.size());
+  if (!Adapter.ParamsInMemory) {
+    for (size_t I = 0; I < Vals.size(); ++I) {
+      EXPECTED_TRY(Marshaler.lowerFlat(Adapter.Params[I], Vals[I], CoreArgs));
     }
+    return {};
+  }
+  // Store the parameter tuple and pass the pointer.
+  const auto &Tuple = Adapter.Layouts[Adapter.ParamTuple];
+  EXPECTED_TRY(uint32_t Ptr, Marshaler.allocate(Tuple.Align, Tuple.Size));
+  for (size_t I = 0; I < Vals.size(); ++I) {
+    const uint64_t Addr = static_cast<uint64_t>(Ptr) + Tuple.Offsets[I];
+    EXPECTED_TRY(Marshaler.store(Adapter.Params[I], Vals[I], Addr));
+  }
+  CoreArgs.emplace_back(Ptr);
+  return {};
+}
+
+Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
+Executor::liftCanonValues(
+    const Runtime::Instance::Component::FunctionInstance &Func,
+    Span<const ValVariant> CoreRets) {
+  const auto &Adapter = Func.getAdapter();
+  CanonMarshaler Marshaler(*this, Func);
+  std::vector<std::pair<ComponentValVariant, ComponentValType>> Vals;
+  Vals.reserve(Adapter.Results.size());
+  if (!Adapter.ResultsInMemory) {
+    size_t Pos = 0;
+    for (size_t I = 0; I < Adapter.Results.size(); ++I) {
+      EXPECTED_TRY(auto V,
+                   Marshaler.liftFlat(Adapter.Results[I], CoreRets, Pos));
+      Vals.emplace_back(std::move(V), Adapter.ResultTypes[I]);
     }
+    return Vals;
+  }
+  // Load the result tuple from the returned pointer.
+  const auto &Tuple = Adapter.Layouts[Adapter.ResultTuple];
+  const uint32_t Ptr = CoreRets[0].get<uint32_t>();
+  EXPECTED_TRY(Marshaler.checkRange(Ptr, Tuple.Align, Tuple.Size));
+  for (size_t I = 0; I < Adapter.Results.size(); ++I) {
+    EXPECTED_TRY(auto V, Marshaler.load(Adapter.Results[I],
+                                        static_cast<uint64_t>(Ptr) +
+                                            Tuple.Offsets[I]));
+    Vals.emplace_back(std::move(V), Adapter.ResultTypes[I]);
   }
   return Vals;
 }
@@ -96,30 +1325,10 @@ Executor::instantiate(Runtime::Instance::ComponentInstance &CompInst,
     case AST::Component::Canonical::OpCode::Lift: {
       // lift wrap a core wasm function to a component function, with proper
       // modification about canonical ABI.
-      const auto &Opts = Canon.getOptions();
       Runtime::Instance::MemoryInstance *MemInst = nullptr;
       Runtime::Instance::FunctionInstance *ReallocFunc = nullptr;
-      for (auto &Opt : Opts) {
-        switch (Opt.getCode()) {
-        case AST::Component::CanonOpt::OptCode::Encode_UTF8:
-        case AST::Component::CanonOpt::OptCode::Encode_UTF16:
-        case AST::Component::CanonOpt::OptCode::Encode_Latin1:
-          spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
-          spdlog::error("    incomplete canonincal options"sv);
-          return Unexpect(ErrCode::Value::ComponentNotImplInstantiate);
-        case AST::Component::CanonOpt::OptCode::Memory:
-          MemInst = CompInst.getCoreMemory(Opt.getIndex());
-          break;
-        case AST::Component::CanonOpt::OptCode::Realloc:
-          ReallocFunc = CompInst.getCoreFunction(Opt.getIndex());
-          break;
-        case AST::Component::CanonOpt::OptCode::PostReturn:
-        case AST::Component::CanonOpt::OptCode::Async:
-          // TODO: incomplete validation of these cases.
-        default:
-          assumingUnreachable();
-        }
-      }
+      EXPECTED_TRY(
+          getCanonOptions(CompInst, Canon.getOptions(), MemInst, ReallocFunc));
 
       const auto *DType = CompInst.getType(Canon.getTargetIndex());
       if (unlikely(!DType->isFuncType())) {
@@ -130,9 +1339,29 @@ Executor::instantiate(Runtime::Instance::ComponentInstance &CompInst,
         return Unexpect(ErrCode::Value::InvalidCanonOption);
       }
       auto *FuncInst = CompInst.getCoreFunction(Canon.getIndex());
+
+      // Compile the adapter once here instead of resolving the types per call.
+      EXPECTED_TRY(auto Adapter,
+                   compileAdapter(CompInst, DType->getFuncType()));
+      if (unlikely(Adapter->NeedMemory && MemInst == nullptr)) {
+        spdlog::error(ErrCode::Value::InvalidCanonOption);
+        spdlog::error("    Missing the memory option"sv);
+        return Unexpect(ErrCode::Value::InvalidCanonOption);
+      }
+      if (Adapter->NeedRealloc) {
+        EXPECTED_TRY(checkRealloc(ReallocFunc));
+      }
+      const auto &CoreType = FuncInst->getFuncType();
+      if (unlikely(CoreType.getParamTypes() != Adapter->CoreParams ||
+                   CoreType.getReturnTypes() != Adapter->CoreResults)) {
+        spdlog::error(ErrCode::Value::InvalidCanonOption);
+        spdlog::error("    Core function type mismatched with the lifting"sv);
+        return Unexpect(ErrCode::Value::InvalidCanonOption);
+      }
       CompInst.addFunction(
           std::make_unique<Runtime::Instance::Component::FunctionInstance>(
-              DType->getFuncType(), FuncInst, MemInst, ReallocFunc));
+              DType->getFuncType(), FuncInst, MemInst, ReallocFunc,
+              std::move(Adapter)));
       break;
     }
     case AST::Component::Canonical::OpCode::Lower: {
@@ -143,41 +1372,59 @@ Executor::instantiate(Runtime::Instance::ComponentInstance &CompInst,
       // therefore there is a core function instance under the component
       // function instance. Maybe this implementation should be fixed in the
       // future.
-      /*
-      const auto &Opts = Canon.getOptions();
       Runtime::Instance::MemoryInstance *MemInst = nullptr;
       Runtime::Instance::FunctionInstance *ReallocFunc = nullptr;
-      for (auto &Opt : Opts) {
-        switch (Opt.getCode()) {
-        case AST::Component::CanonOpt::OptCode::Encode_UTF8:
-        case AST::Component::CanonOpt::OptCode::Encode_UTF16:
-        case AST::Component::CanonOpt::OptCode::Encode_Latin1:
-          spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
-          spdlog::error("    incomplete canonincal options"sv);
-          return Unexpect(ErrCode::Value::ComponentNotImplInstantiate);
-        case AST::Component::CanonOpt::OptCode::Memory:
-          MemInst = CompInst.getCoreMemory(Opt.getIndex());
-          break;
-        case AST::Component::CanonOpt::OptCode::Realloc:
-          ReallocFunc = CompInst.getCoreFunction(Opt.getIndex());
-          break;
-        case AST::Component::CanonOpt::OptCode::PostReturn:
-        case AST::Component::CanonOpt::OptCode::Async:
-          // TODO: incomplete validation of these cases.
-        default:
-          assumingUnreachable();
-        }
-      }
-      */
+      EXPECTED_TRY(
+          getCanonOptions(CompInst, Canon.getOptions(), MemInst, ReallocFunc));
 
       auto *FuncInst = CompInst.getFunction(Canon.getIndex());
+      const auto &Adapter = FuncInst->getAdapter();
       auto *CoreFuncInst = FuncInst->getLowerFunction();
-      CompInst.addCoreFunction(CoreFuncInst);
+      if (!Adapter.NeedMemory ||
+          (MemInst == FuncInst->getMemoryInstance() &&
+           !Adapter.ResultsInMemory)) {
+        // The core values are passed as is if nothing points into a memory,
+        // or if the caller and the callee share the memory.
+        CompInst.addCoreFunction(CoreFuncInst);
+        break;
+      }
+
+      // Fuse the lowering with the lifting into a core function relocating
+      // the values between the memories.
+      if (unlikely(MemInst == nullptr)) {
+        spdlog::error(ErrCode::Value::InvalidCanonOption);
+        spdlog::error("    Missing the memory option"sv);
+        return Unexpect(ErrCode::Value::InvalidCanonOption);
+      }
+      if (MemInst != FuncInst->getMemoryInstance() &&
+          Adapter.Layouts[Adapter.ResultTuple].UsesMemory) {
+        EXPECTED_TRY(checkRealloc(ReallocFunc));
+      }
+      CompInst.addCoreFunction(
+          std::make_unique<Runtime::Instance::FunctionInstance>(
+              std::make_unique<FusedAdapter>(*FuncInst, *MemInst,
+                                             ReallocFunc)));
       break;
     }
     case AST::Component::Canonical::OpCode::Resource__new:
     case AST::Component::Canonical::OpCode::Resource__drop:
-    case AST::Component::Canonical::OpCode::Resource__rep:
+    case AST::Component::Canonical::OpCode::Resource__rep: {
+      const auto *DType = CompInst.getType(Canon.getIndex());
+      if (unlikely(DType == nullptr || !DType->isResourceType())) {
+        spdlog::error(ErrCode::Value::InvalidCanonOption);
+        spdlog::error("    Not a resource type {}"sv, Canon.getIndex());
+        return Unexpect(ErrCode::Value::InvalidCanonOption);
+      }
+      const Runtime::Instance::FunctionInstance *Dtor = nullptr;
+      if (const auto DtorIdx = DType->getResourceType().getDestructor()) {
+        Dtor = CompInst.getCoreFunction(*DtorIdx);
+      }
+      CompInst.addCoreFunction(
+          std::make_unique<Runtime::Instance::FunctionInstance>(
+              std::make_unique<ResourceBuiltin>(Canon.getOpCode(), CompInst,
+                                                *DType, Dtor)));
+      break;
+    }
     default:
       spdlog::error(ErrCode::Value::ComponentNotImplInstantiate);
       spdlog::error("    incomplete canonincal"sv);
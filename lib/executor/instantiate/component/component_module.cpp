@@ -31,12 +31,17 @@ Executor::instantiate(Runtime::Instance::ComponentImportManager &ImportMgr,
   // Create the module instance.
   std::unique_ptr<Runtime::Instance::ModuleInstance> ModInst =
       std::make_unique<Runtime::Instance::ModuleInstance>("");
+  ModInst->getMemoryBudget().setLimits(
+      Conf.getRuntimeConfigure().getMemoryBudgetSoftLimit(),
+      Conf.getRuntimeConfigure().getMemoryBudgetHardLimit());
 
   // Instantiate Function Types in Module Instance. (TypeSec)
   for (auto &SubType : Mod.getTypeSection().getContent()) {
     // Copy defined types to module instance.
     ModInst->addDefinedType(SubType);
   }
+  // Assign the canonical types for the constant-time casts.
+  getCanonicalTypes(*ModInst);
 
   auto ReportError = [](ASTNodeAttr Attr) {
     return [Attr](auto E) {
@@ -85,6 +90,13 @@ Executor::instantiate(Runtime::Instance::ComponentImportManager &ImportMgr,
   EXPECTED_TRY(instantiate(StackMgr, *ModInst, TabSec)
                    .map_error(ReportError(ASTNodeAttr::Sec_Table)));
 
+  // Check the memory budget after creating the memories and tables.
+  if (ModInst->getMemoryBudget().isExceeded()) {
+    spdlog::error(ErrCode::Value::MemoryBudgetExceeded);
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::MemoryBudgetExceeded);
+  }
+
   // Instantiate ExportSection (ExportSec)
   const AST::ExportSection &ExportSec = Mod.getExportSection();
   // This function will always success.
@@ -104,9 +116,16 @@ Executor::instantiate(Runtime::Instance::ComponentImportManager &ImportMgr,
   EXPECTED_TRY(initTable(StackMgr, ElemSec)
                    .map_error(ReportError(ASTNodeAttr::Sec_Element)));
 
-  // Initialize memory instances
-  EXPECTED_TRY(initMemory(StackMgr, DataSec)
-                   .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  // Initialize memory instances. The memory images recorded in the module at
+  // the first instantiation are mapped by the later instantiations of the
+  // component.
+  if (Conf.getRuntimeConfigure().isEnableMemoryImage()) {
+    EXPECTED_TRY(initMemoryImage(StackMgr, *ModInst, Mod)
+                     .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  } else {
+    EXPECTED_TRY(initMemory(StackMgr, DataSec)
+                     .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  }
 
   // Instantiate StartSection (StartSec)
   const AST::StartSection &StartSec = Mod.getStartSection();
@@ -127,6 +146,9 @@ Executor::instantiate(Runtime::Instance::ComponentImportManager &ImportMgr,
   // Pop Frame.
   StackMgr.popFrame();
 
+  // The exports are complete, so build their hash indices before any lookup.
+  ModInst->buildExportIndices();
+
   return ModInst;
 }
 
@@ -5,12 +5,82 @@
 
 #include "common/errinfo.h"
 #include "common/spdlog.h"
+#include "system/memimage.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <optional>
 
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Get the offset of an active data segment initialized by a constant.
+std::optional<uint64_t>
+getConstOffset(const AST::DataSegment &DataSeg) noexcept {
+  const auto &Instrs = DataSeg.getExpr().getInstrs();
+  if (Instrs.size() != 2) {
+    return std::nullopt;
+  }
+  switch (Instrs[0].getOpCode()) {
+  case OpCode::I32__const:
+    return Instrs[0].getNum().get<uint32_t>();
+  case OpCode::I64__const:
+    return Instrs[0].getNum().get<uint64_t>();
+  default:
+    return std::nullopt;
+  }
+}
+
+/// Get the bytes of the defined memories to record after initializing them.
+/// Returns an empty list if the memory contents depend on the instantiation,
+/// which are the data segments with non-constant offsets or into the
+/// imported memories.
+AST::Module::MemoryImageList recordMemoryImages(
+    Span<const Runtime::Instance::MemoryInstance *const> MemInsts,
+    uint32_t ImportedNum, const AST::Module &Mod) noexcept {
+  const uint32_t DefinedNum = static_cast<uint32_t>(MemInsts.size());
+  if (DefinedNum == 0 || !MemoryImage::supported()) {
+    return {};
+  }
+
+  // Collect the end of the initialized bytes in each defined memory.
+  std::vector<uint64_t> Ends(DefinedNum, 0);
+  for (const auto &DataSeg : Mod.getDataSection().getContent()) {
+    if (DataSeg.getMode() != AST::DataSegment::DataMode::Active) {
+      continue;
+    }
+    const auto Offset = getConstOffset(DataSeg);
+    if (DataSeg.getIdx() < ImportedNum || !Offset) {
+      return {};
+    }
+    auto &End = Ends[DataSeg.getIdx() - ImportedNum];
+    End = std::max(End, *Offset + DataSeg.getData().size());
+  }
+
+  AST::Module::MemoryImageList Images(DefinedNum);
+  for (uint32_t I = 0; I < DefinedNum; ++I) {
+    if (Ends[I] == 0) {
+      continue;
+    }
+    const auto *MemInst = MemInsts[I];
+    // Round up to the wasm page, which is aligned to the host pages.
+    const uint64_t Size =
+        (Ends[I] + Runtime::Instance::MemoryInstance::kPageSize - 1) /
+        Runtime::Instance::MemoryInstance::kPageSize *
+        Runtime::Instance::MemoryInstance::kPageSize;
+    auto Image = MemoryImage::create(
+        Span<const uint8_t>(MemInst->getDataPtr(), Size));
+    if (!Image) {
+      return {};
+    }
+    Images[I] = std::move(Image);
+  }
+  return Images;
+}
+} // namespace
+
 // Instantiate data instance. See "include/executor/executor.h".
 Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::ModuleInstance &ModInst,
@@ -19,7 +89,7 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
 
   // Iterate through the data segments to instantiate data instances.
   for (const auto &DataSeg : DataSec.getContent()) {
-    uint32_t Offset = 0;
+    uint64_t Offset = 0;
     // Initialize memory if the data mode is active.
     if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
       // Run initialize expression.
@@ -30,18 +100,17 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
                          spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
                          return E;
                        }));
-      Offset = StackMgr.pop().get<uint32_t>();
+      auto *MemInst = getMemInstByIdx(StackMgr, DataSeg.getIdx());
+      assuming(MemInst);
+      Offset = getAddress(StackMgr.pop(), *MemInst);
 
       // Check boundary unless ReferenceTypes or BulkMemoryOperations proposal
       // enabled.
       if (unlikely(!Conf.hasProposal(Proposal::ReferenceTypes) &&
                    !Conf.hasProposal(Proposal::BulkMemoryOperations))) {
         // Memory index should be 0. Checked in validation phase.
-        auto *MemInst = getMemInstByIdx(StackMgr, DataSeg.getIdx());
         // Check data fits.
-        assuming(MemInst);
-        if (!MemInst->checkAccessBound(
-                Offset, static_cast<uint32_t>(DataSeg.getData().size()))) {
+        if (!MemInst->checkAccessBound(Offset, DataSeg.getData().size())) {
           spdlog::error(ErrCode::Value::DataSegDoesNotFit);
           spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
           return Unexpect(ErrCode::Value::DataSegDoesNotFit);
@@ -50,7 +119,18 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
     }
 
     // Create and add the data instance into the module instance.
-    ModInst.addData(Offset, DataSeg.getData());
+    if (DataSeg.getMode() == AST::DataSegment::DataMode::Active &&
+        !DataSeg.getDataHolder()) {
+      // The active data instances are dropped by the memory initialization
+      // within this instantiation, so reference the data in the AST module
+      // without copying it. The data not dropped is copied by `ownData()` if
+      // the instantiation fails.
+      ModInst.addData(Offset, DataSeg.getData(),
+                      std::shared_ptr<const void>(std::shared_ptr<const void>(),
+                                                  DataSeg.getData().data()));
+    } else {
+      ModInst.addData(Offset, DataSeg.getData(), DataSeg.getDataHolder());
+    }
   }
   return {};
 }
@@ -69,13 +149,13 @@ Expect<void> Executor::initMemory(Runtime::StackManager &StackMgr,
 
       auto *DataInst = getDataInstByIdx(StackMgr, Idx);
       assuming(DataInst);
-      const uint32_t Off = DataInst->getOffset();
+      const uint64_t Off = DataInst->getOffset();
 
       // Replace mem[Off : Off + n] with data[0 : n].
       EXPECTED_TRY(
           MemInst
               ->setBytes(DataInst->getData(), Off, 0,
-                         static_cast<uint32_t>(DataInst->getData().size()))
+                         DataInst->getData().size())
               .map_error([](auto E) {
                 spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Data));
                 return E;
@@ -96,5 +176,77 @@ Expect<void> Executor::initMemory(Runtime::StackManager &StackMgr,
   return {};
 }
 
+// Initialize memory from the memory images. See
+// "include/executor/executor.h".
+Expect<void>
+Executor::initMemoryImage(Runtime::StackManager &StackMgr,
+                          const Runtime::Instance::ModuleInstance &ModInst,
+                          const AST::Module &Mod) {
+  const AST::DataSection &DataSec = Mod.getDataSection();
+  const uint32_t DefinedNum =
+      static_cast<uint32_t>(Mod.getMemorySection().getContent().size());
+  const uint32_t ImportedNum = ModInst.getMemoryNum() - DefinedNum;
+  std::vector<Runtime::Instance::MemoryInstance *> MemInsts(DefinedNum);
+  for (uint32_t I = 0; I < DefinedNum; ++I) {
+    MemInsts[I] = *ModInst.getMemory(ImportedNum + I);
+  }
+
+  const auto Images = Mod.getMemoryImages();
+  if (!Images) {
+    // First instantiation. Initialize by the data segments and record the
+    // memories before running the start function.
+    EXPECTED_TRY(initMemory(StackMgr, DataSec));
+    auto Recorded = std::make_shared<const AST::Module::MemoryImageList>(
+        recordMemoryImages(MemInsts, ImportedNum, Mod));
+    Mod.setMemoryImages(Recorded);
+
+    // Map the images over the copied data as well, so that the untouched
+    // pages of the first instance are shared with the later ones too.
+    for (uint32_t I = 0; I < Recorded->size(); ++I) {
+      if (const auto &Image = (*Recorded)[I];
+          Image && unlikely(!MemInsts[I]->mapImage(*Image))) {
+        // The failed mapping leaves zeroed pages. Copy the data segments
+        // again, whose offsets are all constants if recorded.
+        for (const auto &DataSeg : DataSec.getContent()) {
+          if (DataSeg.getMode() == AST::DataSegment::DataMode::Active &&
+              DataSeg.getIdx() == ImportedNum + I) {
+            const auto Data = DataSeg.getData();
+            std::copy(Data.begin(), Data.end(),
+                      MemInsts[I]->getDataPtr() + *getConstOffset(DataSeg));
+          }
+        }
+      }
+    }
+    return {};
+  }
+  if (Images->empty()) {
+    return initMemory(StackMgr, DataSec);
+  }
+
+  assuming(Images->size() == DefinedNum);
+  for (uint32_t I = 0; I < DefinedNum; ++I) {
+    if (const auto &Image = (*Images)[I]) {
+      auto *MemInst = MemInsts[I];
+      if (unlikely(!MemInst->mapImage(*Image))) {
+        // Copying the data segments again overwrites the mapped images with
+        // the same contents.
+        return initMemory(StackMgr, DataSec);
+      }
+    }
+  }
+
+  // Drop the active data instances as initMemory does.
+  uint32_t Idx = 0;
+  for (const auto &DataSeg : DataSec.getContent()) {
+    if (DataSeg.getMode() == AST::DataSegment::DataMode::Active) {
+      auto *DataInst = getDataInstByIdx(StackMgr, Idx);
+      assuming(DataInst);
+      DataInst->clear();
+    }
+    Idx++;
+  }
+  return {};
+}
+
 } // namespace Executor
 } // namespace WasmEdge
@@ -7,11 +7,53 @@
 #include "common/spdlog.h"
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace WasmEdge {
 namespace Executor {
 
+namespace {
+/// Get the function indices of the element segment whose initialization
+/// expressions are all a single `ref.func`, or an empty list if not.
+std::shared_ptr<const std::vector<uint32_t>>
+getFuncIdxs(const AST::ElementSegment &ElemSeg) {
+  if (auto Idxs = ElemSeg.getFuncIdxs()) {
+    return Idxs;
+  }
+  auto Idxs = std::make_shared<std::vector<uint32_t>>();
+  Idxs->reserve(ElemSeg.getInitExprs().size());
+  for (const auto &Expr : ElemSeg.getInitExprs()) {
+    const auto Instrs = Expr.getInstrs();
+    if (Instrs.size() != 2 || Instrs[0].getOpCode() != OpCode::Ref__func ||
+        Instrs[1].getOpCode() != OpCode::End) {
+      Idxs->clear();
+      break;
+    }
+    Idxs->push_back(Instrs[0].getTargetIndex());
+  }
+  ElemSeg.setFuncIdxs(Idxs);
+  return Idxs;
+}
+
+/// Get the function reference of the function instance.
+RefVariant
+getFuncRef(const Runtime::Instance::FunctionInstance *FuncInst) noexcept {
+  return RefVariant(FuncInst->getDefType(), FuncInst);
+}
+} // namespace
+
+bool Executor::isLazyElemSeg(const Runtime::Instance::ModuleInstance &ModInst,
+                             const AST::ElementSegment &ElemSeg) const {
+  // Only the tables owned by the module are initialized lazily, for the
+  // resolvers refer to the functions of the module.
+  return Conf.getRuntimeConfigure().isEnableLazyTable() &&
+         ElemSeg.getMode() == AST::ElementSegment::ElemMode::Active &&
+         ElemSeg.getIdx() >= ModInst.TabInsts.size() -
+                                 ModInst.OwnedTabInsts.size() &&
+         !getFuncIdxs(ElemSeg)->empty();
+}
+
 // Instantiate element instance. See "include/executor/executor.h".
 Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
                                    Runtime::Instance::ModuleInstance &ModInst,
@@ -21,16 +63,28 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
   // Iterate through the element segments to instantiate element instances.
   for (const auto &ElemSeg : ElemSec.getContent()) {
     std::vector<RefVariant> InitVals;
-    for (const auto &Expr : ElemSeg.getInitExprs()) {
-      // Run init expr of every elements and get the result reference.
-      EXPECTED_TRY(
-          runExpression(StackMgr, Expr.getInstrs()).map_error([](auto E) {
-            spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
-            spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
-            return E;
-          }));
-      // Pop result from stack.
-      InitVals.push_back(StackMgr.pop().get<RefVariant>());
+    const auto FuncIdxs = getFuncIdxs(ElemSeg);
+    if (isLazyElemSeg(ModInst, ElemSeg)) {
+      // The references are resolved from the segment when accessed in the
+      // table, and the element instance is dropped after initializing tables.
+    } else if (!FuncIdxs->empty()) {
+      // Resolve the function references without running the expressions.
+      InitVals.reserve(FuncIdxs->size());
+      for (const auto Idx : *FuncIdxs) {
+        InitVals.push_back(getFuncRef(ModInst.unsafeGetFunction(Idx)));
+      }
+    } else {
+      for (const auto &Expr : ElemSeg.getInitExprs()) {
+        // Run init expr of every elements and get the result reference.
+        EXPECTED_TRY(
+            runExpression(StackMgr, Expr.getInstrs()).map_error([](auto E) {
+              spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+              spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
+              return E;
+            }));
+        // Pop result from stack.
+        InitVals.push_back(StackMgr.pop().get<RefVariant>());
+      }
     }
 
     uint32_t Offset = 0;
@@ -54,7 +108,8 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
         // Check elements fits.
         assuming(TabInst);
         if (!TabInst->checkAccessBound(
-                Offset, static_cast<uint32_t>(InitVals.size()))) {
+                Offset,
+                static_cast<uint32_t>(ElemSeg.getInitExprs().size()))) {
           spdlog::error(ErrCode::Value::ElemSegDoesNotFit);
           spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
           return Unexpect(ErrCode::Value::ElemSegDoesNotFit);
@@ -82,6 +137,29 @@ Expect<void> Executor::initTable(Runtime::StackManager &StackMgr,
       assuming(TabInst);
       const uint32_t Off = ElemInst->getOffset();
 
+      // Defer resolving the references to their first access.
+      if (const auto *ModInst = StackMgr.getModule();
+          isLazyElemSeg(*ModInst, ElemSeg)) {
+        auto FuncIdxs = getFuncIdxs(ElemSeg);
+        const auto Len = static_cast<uint32_t>(FuncIdxs->size());
+        const Span<Runtime::Instance::FunctionInstance *const> Funcs =
+            ModInst->FuncInsts;
+        EXPECTED_TRY(
+            TabInst
+                ->setLazyRefs(Off, Len,
+                              [Funcs, FuncIdxs = std::move(FuncIdxs)](
+                                  uint32_t I) noexcept {
+                                return getFuncRef(Funcs[(*FuncIdxs)[I]]);
+                              })
+                .map_error([](auto E) {
+                  spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Element));
+                  return E;
+                }));
+        ElemInst->clear();
+        Idx++;
+        continue;
+      }
+
       // Replace table[Off : Off + n] with elem[0 : n].
       EXPECTED_TRY(
           TabInst
@@ -17,6 +17,9 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
   // Prepare pointers for compiled functions.
   ModInst.GlobalPtrs.resize(ModInst.getGlobalNum() +
                             GlobSec.getContent().size());
+  const uint32_t ImpGlobNum = ModInst.getGlobalNum();
+  ModInst.GlobalValues =
+      std::make_unique<ValVariant[]>(GlobSec.getContent().size());
 
   // Set the global pointers of imported globals.
   for (uint32_t I = 0; I < ModInst.getGlobalNum(); ++I) {
@@ -41,7 +44,9 @@ Expect<void> Executor::instantiate(Runtime::StackManager &StackMgr,
     const auto Index = ModInst.getGlobalNum() - 1;
     Runtime::Instance::GlobalInstance *GlobInst = *ModInst.getGlobal(Index);
 
-    // Set the global pointers of instantiated globals.
+    // Set the global pointers of instantiated globals, whose values are
+    // stored contiguously for the compiled functions.
+    GlobInst->bindSlot(&ModInst.GlobalValues[Index - ImpGlobNum]);
     ModInst.GlobalPtrs[Index] = &(GlobInst->getValue());
   }
   return {};
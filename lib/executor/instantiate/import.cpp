@@ -34,8 +34,41 @@ auto logUnknownError(std::string_view ModName, std::string_view ExtName,
   return Unexpect(ErrCode::Value::UnknownImport);
 }
 
+/// Match the imported function against the expected type. The functions
+/// re-exported by the inline instances of the components keep the type indices
+/// in the type list of their defining modules, and the adapters of the
+/// canonical ABI have no defining module.
+bool matchFunction(Span<const AST::SubType *const> TypeList, uint32_t TypeIdx,
+                   Span<const AST::SubType *const> ImpTypeList,
+                   const Runtime::Instance::FunctionInstance &ImpInst) {
+  if (ImpInst.getModule() != nullptr) {
+    return AST::TypeMatcher::matchType(TypeList, TypeIdx, ImpTypeList,
+                                       ImpInst.getTypeIndex());
+  }
+  const auto &ExpType = TypeList[TypeIdx]->getCompositeType();
+  if (!ExpType.isFunc()) {
+    return false;
+  }
+  const auto &Exp = ExpType.getFuncType();
+  const auto &Got = ImpInst.getFuncType();
+  auto MatchTypes = [&TypeList](Span<const ValType> E, Span<const ValType> G) {
+    if (E.size() != G.size()) {
+      return false;
+    }
+    for (size_t I = 0; I < E.size(); ++I) {
+      if (!AST::TypeMatcher::matchType(TypeList, E[I], {}, G[I]) ||
+          !AST::TypeMatcher::matchType({}, G[I], TypeList, E[I])) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return MatchTypes(Exp.getParamTypes(), Got.getParamTypes()) &&
+         MatchTypes(Exp.getReturnTypes(), Got.getReturnTypes());
+}
+
 bool matchLimit(const AST::Limit &Exp, const AST::Limit &Got) {
-  if (Exp.isShared() != Got.isShared()) {
+  if (Exp.isShared() != Got.isShared() || Exp.is64() != Got.is64()) {
     return false;
   }
   if ((Got.getMin() < Exp.getMin()) || (Exp.hasMax() && !Got.hasMax())) {
@@ -112,7 +145,22 @@ Expect<void> Executor::instantiate(
         ModuleFinder,
     Runtime::Instance::ModuleInstance &ModInst,
     const AST::ImportSection &ImportSec) {
-  // Iterate and instantiate import descriptions.
+  Runtime::Instance::ModulePrelink Prelink;
+  EXPECTED_TRY(resolveImports(std::move(ModuleFinder), ModInst.getTypeList(),
+                              ImportSec, Prelink));
+  bindImports(ModInst, Prelink);
+  return {};
+}
+
+// Resolve imports. See "include/executor/executor.h".
+Expect<void> Executor::resolveImports(
+    std::function<const Runtime::Instance::ModuleInstance *(std::string_view)>
+        ModuleFinder,
+    Span<const AST::SubType *const> TypeList,
+    const AST::ImportSection &ImportSec,
+    Runtime::Instance::ModulePrelink &Prelink) {
+  Prelink.Imports.reserve(ImportSec.getContent().size());
+  // Iterate and resolve import descriptions.
   for (const auto &ImpDesc : ImportSec.getContent()) {
     // Get data from import description and find import module.
     auto ExtType = ImpDesc.getExternalType();
@@ -156,10 +204,13 @@ Expect<void> Executor::instantiate(
       // External function type should match the import function type in
       // description.
 
-      if (!AST::TypeMatcher::matchType(ModInst.getTypeList(), TypeIdx,
-                                       ImpModInst->getTypeList(),
-                                       ImpInst->getTypeIndex())) {
-        const auto &ExpDefType = **ModInst.getType(TypeIdx);
+      const auto *ImpDefMod = ImpInst->getModule();
+      Span<const AST::SubType *const> ImpTypeList;
+      if (ImpDefMod != nullptr) {
+        ImpTypeList = ImpDefMod->getTypeList();
+      }
+      if (!matchFunction(TypeList, TypeIdx, ImpTypeList, *ImpInst)) {
+        const auto &ExpDefType = *TypeList[TypeIdx];
         bool IsMatchV2 = false;
         const auto &ExpFuncType = ExpDefType.getCompositeType().getFuncType();
         const auto &ImpFuncType = ImpInst->getFuncType();
@@ -189,7 +240,7 @@ Expect<void> Executor::instantiate(
               auto *ImpInstV2 =
                   ImpModInst->findFuncExports(std::string(*Iter) + "_v2");
               if (!AST::TypeMatcher::matchType(
-                      ModInst.getTypeList(), *ExpDefType.getTypeIndex(),
+                      TypeList, *ExpDefType.getTypeIndex(),
                       ImpModInst->getTypeList(), ImpInst->getTypeIndex())) {
                 // Try to match the new version
                 ImpInst = ImpInstV2;
@@ -206,12 +257,12 @@ Expect<void> Executor::instantiate(
               ImpFuncType.getReturnTypes());
         }
       }
-      // Set the matched function address to module instance.
-      ModInst.importFunction(ImpInst);
+      // Record the matched function address.
+      Prelink.Imports.emplace_back(ImpInst);
 
       // If the imported function is a WASI function, mark in the module.
-      if (!ModInst.getWASIModule() && ModName == "wasi_snapshot_preview1"sv) {
-        ModInst.setWASIModule(ImpModInst);
+      if (!Prelink.WASIModule && ModName == "wasi_snapshot_preview1"sv) {
+        Prelink.WASIModule = ImpModInst;
       }
       break;
     }
@@ -226,20 +277,20 @@ Expect<void> Executor::instantiate(
       const auto &ImpLim = ImpType.getLimit();
       // External table reference type should match the import table reference
       // type in description, and vice versa.
-      if (!AST::TypeMatcher::matchType(
-              ModInst.getTypeList(), TabType.getRefType(),
-              ImpModInst->getTypeList(), ImpType.getRefType()) ||
-          !AST::TypeMatcher::matchType(
-              ImpModInst->getTypeList(), ImpType.getRefType(),
-              ModInst.getTypeList(), TabType.getRefType()) ||
+      if (!AST::TypeMatcher::matchType(TypeList, TabType.getRefType(),
+                                       ImpModInst->getTypeList(),
+                                       ImpType.getRefType()) ||
+          !AST::TypeMatcher::matchType(ImpModInst->getTypeList(),
+                                       ImpType.getRefType(), TypeList,
+                                       TabType.getRefType()) ||
           !matchLimit(TabLim, ImpLim)) {
         return logMatchError(ModName, ExtName, ExtType, TabType.getRefType(),
                              TabLim.hasMax(), TabLim.getMin(), TabLim.getMax(),
                              ImpType.getRefType(), ImpLim.hasMax(),
                              ImpLim.getMin(), ImpLim.getMax());
       }
-      // Set the matched table address to module instance.
-      ModInst.importTable(ImpInst);
+      // Record the matched table address.
+      Prelink.Imports.emplace_back(ImpInst);
       break;
     }
     case ExternalType::Memory: {
@@ -249,14 +300,15 @@ Expect<void> Executor::instantiate(
       // Import matching. External memory type should match the one in import
       // description.
       auto *ImpInst = ImpModInst->findMemoryExports(ExtName);
-      const auto &ImpLim = ImpInst->getMemoryType().getLimit();
+      const auto ImpType = ImpInst->getMemoryType();
+      const auto &ImpLim = ImpType.getLimit();
       if (!matchLimit(MemLim, ImpLim)) {
         return logMatchError(ModName, ExtName, ExtType, MemLim.hasMax(),
                              MemLim.getMin(), MemLim.getMax(), ImpLim.hasMax(),
                              ImpLim.getMin(), ImpLim.getMax());
       }
-      // Set the matched memory address to module instance.
-      ModInst.importMemory(ImpInst);
+      // Record the matched memory address.
+      Prelink.Imports.emplace_back(ImpInst);
       break;
     }
     case ExternalType::Tag: {
@@ -264,9 +316,9 @@ Expect<void> Executor::instantiate(
       const auto &TagType = ImpDesc.getExternalTagType();
       // Import matching.
       auto *ImpInst = ImpModInst->findTagExports(ExtName);
-      if (!AST::TypeMatcher::matchType(
-              ModInst.getTypeList(), TagType.getTypeIdx(),
-              ImpModInst->getTypeList(), ImpInst->getTagType().getTypeIdx())) {
+      if (!AST::TypeMatcher::matchType(TypeList, TagType.getTypeIdx(),
+                                       ImpModInst->getTypeList(),
+                                       ImpInst->getTagType().getTypeIdx())) {
         const auto &ExpFuncType =
             TagType.getDefType().getCompositeType().getFuncType();
         const auto &ImpFuncType =
@@ -276,7 +328,7 @@ Expect<void> Executor::instantiate(
             ExpFuncType.getReturnTypes(), ImpFuncType.getParamTypes(),
             ImpFuncType.getReturnTypes());
       }
-      ModInst.importTag(ImpInst);
+      Prelink.Imports.emplace_back(ImpInst);
       break;
     }
     case ExternalType::Global: {
@@ -291,14 +343,14 @@ Expect<void> Executor::instantiate(
         // For both const or both var: external global value type should match
         // the import global value type in description.
         IsMatch = AST::TypeMatcher::matchType(
-            ModInst.getTypeList(), GlobType.getValType(),
-            ImpModInst->getTypeList(), ImpType.getValType());
+            TypeList, GlobType.getValType(), ImpModInst->getTypeList(),
+            ImpType.getValType());
         if (ImpType.getValMut() == ValMut::Var) {
           // If both var: import global value type in description should also
           // match the external global value type.
           IsMatch &= AST::TypeMatcher::matchType(
-              ImpModInst->getTypeList(), ImpType.getValType(),
-              ModInst.getTypeList(), GlobType.getValType());
+              ImpModInst->getTypeList(), ImpType.getValType(), TypeList,
+              GlobType.getValType());
         }
       }
       if (!IsMatch) {
@@ -306,8 +358,8 @@ Expect<void> Executor::instantiate(
                              GlobType.getValMut(), ImpType.getValType(),
                              ImpType.getValMut());
       }
-      // Set the matched global address to module instance.
-      ModInst.importGlobal(ImpInst);
+      // Record the matched global address.
+      Prelink.Imports.emplace_back(ImpInst);
       break;
     }
     default:
@@ -317,5 +369,71 @@ Expect<void> Executor::instantiate(
   return {};
 }
 
+// Bind imports. See "include/executor/executor.h".
+void Executor::bindImports(Runtime::Instance::ModuleInstance &ModInst,
+                           const Runtime::Instance::ModulePrelink &Prelink) {
+  for (const auto &Import : Prelink.Imports) {
+    switch (Import.index()) {
+    case 0:
+      ModInst.importFunction(std::get<0>(Import));
+      break;
+    case 1:
+      ModInst.importTable(std::get<1>(Import));
+      break;
+    case 2:
+      ModInst.importMemory(std::get<2>(Import));
+      break;
+    case 3:
+      ModInst.importTag(std::get<3>(Import));
+      break;
+    case 4:
+      ModInst.importGlobal(std::get<4>(Import));
+      break;
+    default:
+      assumingUnreachable();
+    }
+  }
+  if (Prelink.WASIModule) {
+    ModInst.setWASIModule(Prelink.WASIModule);
+  }
+}
+
+// Pre-link module. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModulePrelink>>
+Executor::prelinkModule(const Runtime::StoreManager &StoreMgr,
+                        const AST::Module &Mod) {
+  // Check the module is validated.
+  if (unlikely(!Mod.getIsValidated())) {
+    spdlog::error(ErrCode::Value::NotValidated);
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::NotValidated);
+  }
+
+  auto Prelink = std::make_unique<Runtime::Instance::ModulePrelink>();
+  Prelink->Module = &Mod;
+  Prelink->Store = &StoreMgr;
+  // Take the generation first for the modules registered during resolving.
+  Prelink->Generation = StoreMgr.getGeneration();
+
+  // The types are matched as the ones copied into the module instances.
+  std::vector<const AST::SubType *> TypeList;
+  TypeList.reserve(Mod.getTypeSection().getContent().size());
+  for (const auto &SubType : Mod.getTypeSection().getContent()) {
+    TypeList.push_back(&SubType);
+  }
+  EXPECTED_TRY(resolveImports(
+                   [&StoreMgr](std::string_view ModName)
+                       -> const WasmEdge::Runtime::Instance::ModuleInstance * {
+                     return StoreMgr.findModule(ModName);
+                   },
+                   TypeList, Mod.getImportSection(), *Prelink)
+                   .map_error([](auto E) {
+                     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Import));
+                     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+                     return E;
+                   }));
+  return Prelink;
+}
+
 } // namespace Executor
 } // namespace WasmEdge
@@ -14,6 +14,7 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
   // Prepare pointers vector for compiled functions.
   ModInst.MemoryPtrs.resize(ModInst.getMemoryNum() +
                             MemSec.getContent().size());
+  ModInst.MemorySizePtrs.resize(ModInst.MemoryPtrs.size());
 
   // Set the memory pointers of imported memories.
   for (uint32_t I = 0; I < ModInst.getMemoryNum(); ++I) {
@@ -22,6 +23,7 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
 #else
     ModInst.MemoryPtrs[I] = &(*ModInst.getMemory(I))->getDataPtr();
 #endif
+    ModInst.MemorySizePtrs[I] = &(*ModInst.getMemory(I))->getDataSize();
   }
 
   // Iterate through the memory types to instantiate memory instances.
@@ -30,12 +32,17 @@ Expect<void> Executor::instantiate(Runtime::Instance::ModuleInstance &ModInst,
     ModInst.addMemory(MemType, Conf.getRuntimeConfigure().getMaxMemoryPage());
     const auto Index = ModInst.getMemoryNum() - 1;
     Runtime::Instance::MemoryInstance *MemInst = *ModInst.getMemory(Index);
+    // The placement is best effort, and the memory is usable anyway.
+    if (const auto Node = Conf.getRuntimeConfigure().getNumaNode(); Node >= 0) {
+      MemInst->bindNumaNode(static_cast<uint32_t>(Node));
+    }
     // Set the memory pointers of instantiated memories.
 #if WASMEDGE_ALLOCATOR_IS_STABLE
     ModInst.MemoryPtrs[Index] = MemInst->getDataPtr();
 #else
     ModInst.MemoryPtrs[Index] = &MemInst->getDataPtr();
 #endif
+    ModInst.MemorySizePtrs[Index] = &MemInst->getDataSize();
   }
   return {};
 }
@@ -5,17 +5,22 @@
 
 #include "common/errinfo.h"
 #include "common/spdlog.h"
+#include "common/trace.h"
+#include "system/sampler.h"
 
 #include <cstdint>
 #include <string_view>
 
+using namespace std::literals;
+
 namespace WasmEdge {
 namespace Executor {
 
 // Instantiate module instance. See "include/executor/Executor.h".
 Expect<std::unique_ptr<Runtime::Instance::ModuleInstance>>
 Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
-                      std::optional<std::string_view> Name) {
+                      std::optional<std::string_view> Name,
+                      const Runtime::Instance::ModulePrelink *Prelink) {
   // Check the module is validated.
   if (unlikely(!Mod.getIsValidated())) {
     spdlog::error(ErrCode::Value::NotValidated);
@@ -43,37 +48,59 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   } else {
     ModInst = std::make_unique<Runtime::Instance::ModuleInstance>("");
   }
+  ModInst->getMemoryBudget().setLimits(
+      Conf.getRuntimeConfigure().getMemoryBudgetSoftLimit(),
+      Conf.getRuntimeConfigure().getMemoryBudgetHardLimit());
 
   // Instantiate Function Types in Module Instance. (TypeSec)
   for (auto &SubType : Mod.getTypeSection().getContent()) {
     // Copy defined types to module instance.
     ModInst->addDefinedType(SubType);
   }
+  // Assign the canonical types for the constant-time casts.
+  getCanonicalTypes(*ModInst);
+
+  auto Recycle = [&StoreMgr, &ModInst]() {
+    // The active data instances not dropped yet borrow the data of the AST
+    // module, which may be released before the failed module instance.
+    for (auto *DataInst : ModInst->DataInsts) {
+      DataInst->ownData();
+    }
+    StoreMgr.recycleModule(std::move(ModInst));
+  };
 
-  auto ReportModuleError = [&StoreMgr, &ModInst](auto E) {
+  auto ReportModuleError = [&Recycle](auto E) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    StoreMgr.recycleModule(std::move(ModInst));
+    Recycle();
     return E;
   };
 
-  auto ReportError = [&StoreMgr, &ModInst](ASTNodeAttr Attr) {
-    return [Attr, &StoreMgr, &ModInst](auto E) {
+  auto ReportError = [&Recycle](ASTNodeAttr Attr) {
+    return [Attr, &Recycle](auto E) {
       spdlog::error(ErrInfo::InfoAST(Attr));
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-      StoreMgr.recycleModule(std::move(ModInst));
+      Recycle();
       return E;
     };
   };
 
   // Instantiate ImportSection and do import matching. (ImportSec)
   const AST::ImportSection &ImportSec = Mod.getImportSection();
-  EXPECTED_TRY(instantiate(
-                   [&StoreMgr](std::string_view ModName)
-                       -> const WasmEdge::Runtime::Instance::ModuleInstance * {
-                     return StoreMgr.findModule(ModName);
-                   },
-                   *ModInst, ImportSec)
-                   .map_error(ReportError(ASTNodeAttr::Sec_Import)));
+  if (Prelink && Prelink->Store == &StoreMgr &&
+      Prelink->Generation == StoreMgr.getGeneration()) {
+    // The registered modules are unchanged since the pre-linking, so bind the
+    // resolved imports by index.
+    bindImports(*ModInst, *Prelink);
+  } else {
+    EXPECTED_TRY(
+        instantiate(
+            [&StoreMgr](std::string_view ModName)
+                -> const WasmEdge::Runtime::Instance::ModuleInstance * {
+              return StoreMgr.findModule(ModName);
+            },
+            *ModInst, ImportSec)
+            .map_error(ReportError(ASTNodeAttr::Sec_Import)));
+  }
 
   // Instantiate Functions in module. (FunctionSec, CodeSec)
   const AST::FunctionSection &FuncSec = Mod.getFunctionSection();
@@ -104,6 +131,12 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   EXPECTED_TRY(instantiate(StackMgr, *ModInst, TabSec)
                    .map_error(ReportError(ASTNodeAttr::Sec_Table)));
 
+  // Check the memory budget after creating the memories and tables.
+  if (ModInst->getMemoryBudget().isExceeded()) {
+    spdlog::error(ErrCode::Value::MemoryBudgetExceeded);
+    return Unexpect(ReportModuleError(ErrCode::Value::MemoryBudgetExceeded));
+  }
+
   // Instantiate ExportSection (ExportSec)
   const AST::ExportSection &ExportSec = Mod.getExportSection();
   // This function will always success.
@@ -124,8 +157,18 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
                    .map_error(ReportError(ASTNodeAttr::Sec_Element)));
 
   // Initialize memory instances
-  EXPECTED_TRY(initMemory(StackMgr, DataSec)
-                   .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  if (Conf.getRuntimeConfigure().isEnableMemoryImage()) {
+    EXPECTED_TRY(initMemoryImage(StackMgr, *ModInst, Mod)
+                     .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  } else {
+    EXPECTED_TRY(initMemory(StackMgr, DataSec)
+                     .map_error(ReportError(ASTNodeAttr::Sec_Data)));
+  }
+
+  // Name the functions in the sampled stacks before running any of them.
+  if (Sampler::isActive()) {
+    Sampler::registerModule(*ModInst, Mod);
+  }
 
   // Instantiate StartSection (StartSec)
   const AST::StartSection &StartSec = Mod.getStartSection();
@@ -137,6 +180,7 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
     const auto *FuncInst = ModInst->getStartFunc();
 
     // Execute instruction.
+    Trace::Scope StartScope("executor"sv, "start function"sv);
     EXPECTED_TRY(
         runFunction(StackMgr, *FuncInst, {}).map_error(ReportModuleError));
   }
@@ -144,6 +188,9 @@ Executor::instantiate(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
   // Pop Frame.
   StackMgr.popFrame();
 
+  // The exports are complete, so build their hash indices before any lookup.
+  ModInst->buildExportIndices();
+
   // For the named modules, register it into the store.
   if (Name.has_value()) {
     StoreMgr.registerModule(ModInst.get());
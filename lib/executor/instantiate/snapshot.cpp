@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "executor/executor.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+#include "system/memimage.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace WasmEdge {
+namespace Executor {
+
+namespace {
+Unexpected<ErrCode> logSnapshotError(std::string_view Reason) noexcept {
+  using namespace std::literals;
+  spdlog::error(ErrCode::Value::RuntimeError);
+  spdlog::error("    Module instance snapshot: {}"sv, Reason);
+  return Unexpect(ErrCode::Value::RuntimeError);
+}
+} // namespace
+
+// Take the snapshot of the module instance. See "include/executor/executor.h".
+Expect<std::unique_ptr<Runtime::Instance::ModuleSnapshot>>
+Executor::snapshotModule(const Runtime::Instance::ModuleInstance &ModInst) {
+  using namespace std::literals;
+  std::shared_lock Lock(ModInst.Mutex);
+
+  // The GC objects are not copyable.
+  if (!ModInst.OwnedArrayInsts.empty() || !ModInst.OwnedStructInsts.empty() ||
+      !ModInst.OwnedContInsts.empty()) {
+    return logSnapshotError("owns GC objects"sv);
+  }
+
+  auto Snapshot = std::make_unique<Runtime::Instance::ModuleSnapshot>();
+  Snapshot->Source = &ModInst;
+
+  // Record the memories as images, or copy them if not supported. The zero
+  // pages do not occupy the images.
+  Snapshot->Memories.reserve(ModInst.OwnedMemInsts.size());
+  for (const auto &Mem : ModInst.OwnedMemInsts) {
+    auto &Record = Snapshot->Memories.emplace_back();
+    Record.Pages = Mem->getPageSize();
+    const Span<const uint8_t> Data(
+        Mem->getDataPtr(),
+        Record.Pages * Runtime::Instance::MemoryInstance::kPageSize);
+    if (!Data.empty()) {
+      Record.Image = MemoryImage::create(Data);
+      if (!Record.Image) {
+        Record.Data.assign(Data.begin(), Data.end());
+      }
+    }
+  }
+
+  // Copy the tables and globals by value.
+  Snapshot->Tables.reserve(ModInst.OwnedTabInsts.size());
+  for (const auto &Tab : ModInst.OwnedTabInsts) {
+    const auto Refs = *Tab->getRefs(0, Tab->getSize());
+    Snapshot->Tables.emplace_back(Refs.begin(), Refs.end());
+  }
+  Snapshot->Globals.reserve(ModInst.OwnedGlobInsts.size());
+  for (const auto &Glob : ModInst.OwnedGlobInsts) {
+    Snapshot->Globals.push_back(Glob->getValue());
+  }
+  return Snapshot;
+}
+
+// Restore the module instance. See "include/executor/executor.h".
+Expect<void>
+Executor::restoreModule(Runtime::Instance::ModuleInstance &ModInst,
+                        const Runtime::Instance::ModuleSnapshot &Snapshot) {
+  using namespace std::literals;
+  std::shared_lock Lock(ModInst.Mutex);
+
+  if (Snapshot.Source != &ModInst ||
+      Snapshot.Memories.size() != ModInst.OwnedMemInsts.size() ||
+      Snapshot.Tables.size() != ModInst.OwnedTabInsts.size() ||
+      Snapshot.Globals.size() != ModInst.OwnedGlobInsts.size()) {
+    return logSnapshotError("taken from another module instance"sv);
+  }
+  if (!ModInst.OwnedArrayInsts.empty() || !ModInst.OwnedStructInsts.empty() ||
+      !ModInst.OwnedContInsts.empty()) {
+    return logSnapshotError("owns GC objects"sv);
+  }
+
+  // Map the images again, which drops the pages touched after the snapshot.
+  for (size_t I = 0; I < Snapshot.Memories.size(); ++I) {
+    const auto &Record = Snapshot.Memories[I];
+    auto &Mem = *ModInst.OwnedMemInsts[I];
+    if (!Mem.resetPages(Record.Pages)) {
+      return logSnapshotError("memory resizing failed"sv);
+    }
+    if (Record.Image) {
+      if (!Mem.restoreImage(*Record.Image)) {
+        return logSnapshotError("memory image mapping failed"sv);
+      }
+    } else if (!Record.Data.empty()) {
+      std::copy(Record.Data.begin(), Record.Data.end(), Mem.getDataPtr());
+    }
+  }
+
+  // The indirect call caches are invalidated by the renewed table
+  // generations.
+  for (size_t I = 0; I < Snapshot.Tables.size(); ++I) {
+    ModInst.OwnedTabInsts[I]->restoreRefs(Snapshot.Tables[I]);
+  }
+  for (size_t I = 0; I < Snapshot.Globals.size(); ++I) {
+    ModInst.OwnedGlobInsts[I]->setValue(Snapshot.Globals[I]);
+  }
+  return {};
+}
+
+} // namespace Executor
+} // namespace WasmEdge
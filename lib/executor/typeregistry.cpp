@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "runtime/typeregistry.h"
+
+#include "common/hash.h"
+
+namespace WasmEdge {
+namespace Runtime {
+
+TypeRegistry &TypeRegistry::getDefault() noexcept {
+  static TypeRegistry Default;
+  return Default;
+}
+
+size_t TypeRegistry::KeyHash::operator()(
+    const std::vector<uint64_t> &Key) const noexcept {
+  return static_cast<size_t>(
+      Hash::Hash::rapidHash(cxx20::as_bytes(Span<const uint64_t>(Key))));
+}
+
+bool TypeRegistry::encode(Span<const AST::SubType *const> TypeList,
+                          uint32_t Start, uint32_t Size,
+                          Span<const CanonicalType *const> Known,
+                          std::vector<uint64_t> &Key) {
+  // The indices in the group are relative, and the others are canonical.
+  auto EncodeIndex = [&](uint32_t Idx) {
+    if (Idx >= Start && Idx - Start < Size) {
+      Key.push_back(Idx - Start);
+      return true;
+    }
+    if (Idx < Known.size()) {
+      Key.push_back((uint64_t(1) << 32) | Known[Idx]->Id);
+      return true;
+    }
+    return false;
+  };
+  auto EncodeValType = [&](const ValType &VType) {
+    Key.push_back((static_cast<uint64_t>(VType.getCode()) << 8) |
+                  static_cast<uint64_t>(VType.getHeapTypeCode()));
+    if (VType.getHeapTypeCode() == TypeCode::TypeIndex) {
+      return EncodeIndex(VType.getTypeIndex());
+    }
+    return true;
+  };
+
+  Key.push_back(Size);
+  for (uint32_t I = Start; I < Start + Size; ++I) {
+    const auto &SType = *TypeList[I];
+    Key.push_back(SType.isFinal());
+    Key.push_back(SType.getSuperTypeIndices().size());
+    for (const auto Idx : SType.getSuperTypeIndices()) {
+      if (!EncodeIndex(Idx)) {
+        return false;
+      }
+    }
+    const auto &CType = SType.getCompositeType();
+    Key.push_back(static_cast<uint64_t>(CType.getContentTypeCode()));
+    if (CType.isFunc()) {
+      const auto &FType = CType.getFuncType();
+      Key.push_back(FType.getParamTypes().size());
+      for (const auto &VType : FType.getParamTypes()) {
+        if (!EncodeValType(VType)) {
+          return false;
+        }
+      }
+      Key.push_back(FType.getReturnTypes().size());
+      for (const auto &VType : FType.getReturnTypes()) {
+        if (!EncodeValType(VType)) {
+          return false;
+        }
+      }
+    } else if (CType.isCont()) {
+      if (!EncodeIndex(CType.getContTypeIndex())) {
+        return false;
+      }
+    } else {
+      Key.push_back(CType.getFieldTypes().size());
+      for (const auto &Field : CType.getFieldTypes()) {
+        Key.push_back(static_cast<uint64_t>(Field.getValMut()));
+        if (!EncodeValType(Field.getStorageType())) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<const CanonicalType *>
+TypeRegistry::canonicalize(Span<const AST::SubType *const> TypeList) {
+  std::vector<const CanonicalType *> Result;
+  Result.reserve(TypeList.size());
+  std::vector<uint64_t> Key;
+  std::unique_lock Lock(Mutex);
+  while (Result.size() < TypeList.size()) {
+    const auto Start = static_cast<uint32_t>(Result.size());
+    const auto RecInfo = TypeList[Start]->getRecursiveInfo();
+    const uint32_t Size = RecInfo ? RecInfo->RecTypeSize : 1U;
+    if ((RecInfo && RecInfo->Index != 0) || Size > TypeList.size() - Start) {
+      break;
+    }
+    Key.clear();
+    if (!encode(TypeList, Start, Size, Result, Key)) {
+      break;
+    }
+
+    const auto [It, Added] =
+        Groups.try_emplace(Key, static_cast<uint32_t>(Types.size()));
+    const uint32_t First = It->second;
+    if (Added) {
+      for (uint32_t I = 0; I < Size; ++I) {
+        auto &Type = Types.emplace_back();
+        Type.Id = First + I;
+        // The supertypes are declared before in the valid modules, and only
+        // the first one is allowed.
+        const auto Supers = TypeList[Start + I]->getSuperTypeIndices();
+        if (!Supers.empty() && Supers[0] < Start + I) {
+          const uint32_t Idx = Supers[0];
+          const auto &Super =
+              Idx >= Start ? Types[First + Idx - Start] : *Result[Idx];
+          Type.Display = Super.Display;
+        }
+        Type.Display.push_back(Type.Id);
+      }
+    }
+    for (uint32_t I = 0; I < Size; ++I) {
+      Result.push_back(&Types[First + I]);
+    }
+  }
+  return Result;
+}
+
+} // namespace Runtime
+} // namespace WasmEdge
@@ -0,0 +1,528 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "host/wasi/archive.h"
+#include "common/defines.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+namespace {
+
+inline constexpr const uint64_t kBlockSize = 512;
+
+/// Parse the octal, or the base-256 if the high bit is set, numeric field.
+std::optional<uint64_t> parseNumber(Span<const uint8_t> Field) noexcept {
+  uint64_t Value = 0;
+  if (!Field.empty() && (Field[0] & 0x80)) {
+    Value = Field[0] & 0x7F;
+    for (size_t I = 1; I < Field.size(); ++I) {
+      if (Value >> 56) {
+        return std::nullopt;
+      }
+      Value = (Value << 8) | Field[I];
+    }
+    return Value;
+  }
+  size_t I = 0;
+  while (I < Field.size() && Field[I] == ' ') {
+    ++I;
+  }
+  for (; I < Field.size() && Field[I] >= '0' && Field[I] <= '7'; ++I) {
+    if (Value >> 61) {
+      return std::nullopt;
+    }
+    Value = Value * 8 + (Field[I] - '0');
+  }
+  return Value;
+}
+
+/// The NUL-terminated string field.
+std::string_view parseString(Span<const uint8_t> Field) noexcept {
+  const auto *Begin = reinterpret_cast<const char *>(Field.data());
+  const auto End = std::find(Field.begin(), Field.end(), 0);
+  return std::string_view(Begin, End - Field.begin());
+}
+
+/// Parse the "<length> <key>=<value>\n" records of the pax header.
+void parsePax(std::string_view Records, std::string &Path, std::string &Link,
+              std::optional<uint64_t> &Size) noexcept {
+  while (!Records.empty()) {
+    uint64_t Length = 0;
+    size_t I = 0;
+    for (; I < Records.size() && Length <= Records.size() &&
+           Records[I] >= '0' && Records[I] <= '9';
+         ++I) {
+      Length = Length * 10 + static_cast<uint64_t>(Records[I] - '0');
+    }
+    if (I >= Records.size() || Records[I] != ' ' || Length <= I + 1 ||
+        Length > Records.size()) {
+      return;
+    }
+    auto Record = Records.substr(I + 1, Length - I - 2);
+    Records = Records.substr(Length);
+    const auto Equal = Record.find('=');
+    if (Equal == std::string_view::npos) {
+      continue;
+    }
+    const auto Key = Record.substr(0, Equal);
+    const auto Value = Record.substr(Equal + 1);
+    if (Key == "path"sv) {
+      Path = Value;
+    } else if (Key == "linkpath"sv) {
+      Link = Value;
+    } else if (Key == "size"sv) {
+      uint64_t Decimal = 0;
+      for (char C : Value) {
+        if (C < '0' || C > '9' || Decimal > UINT64_MAX / 10 - 1) {
+          return;
+        }
+        Decimal = Decimal * 10 + static_cast<uint64_t>(C - '0');
+      }
+      Size = Decimal;
+    }
+  }
+}
+
+} // namespace
+
+WasiExpect<std::shared_ptr<const Archive>>
+Archive::open(const std::filesystem::path &Path) noexcept {
+  if (!MMap::supported()) {
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+  }
+  std::error_code Error;
+  const auto Size = std::filesystem::file_size(Path, Error);
+  if (Error) {
+    return WasiUnexpect(__WASI_ERRNO_NOENT);
+  }
+  std::shared_ptr<Archive> Result(new Archive());
+  if (Size > 0) {
+    Result->Map = std::make_unique<MMap>(Path);
+    if (unlikely(!Result->Map->address())) {
+      return WasiUnexpect(__WASI_ERRNO_IO);
+    }
+    Result->Image = Span<const uint8_t>(
+        static_cast<const uint8_t *>(Result->Map->address()), Size);
+  }
+  EXPECTED_TRY(Result->parse());
+  return Result;
+}
+
+WasiExpect<std::shared_ptr<const Archive>>
+Archive::fromImage(Span<const uint8_t> Image) noexcept {
+  std::shared_ptr<Archive> Result(new Archive());
+  Result->Image = Image;
+  EXPECTED_TRY(Result->parse());
+  return Result;
+}
+
+int64_t Archive::find(uint32_t Dir, std::string_view Name) const noexcept {
+  const auto &Children = Entries[Dir].Children;
+  auto It = std::lower_bound(
+      Children.begin(), Children.end(), Name,
+      [](const auto &Child, std::string_view N) { return Child.first < N; });
+  if (It == Children.end() || It->first != Name) {
+    return -1;
+  }
+  return It->second;
+}
+
+int64_t Archive::resolve(std::string_view Path) const noexcept {
+  int64_t Current = 0;
+  while (!Path.empty() && Current >= 0) {
+    const auto Slash = Path.find('/');
+    const auto Part = Path.substr(0, Slash);
+    Path = Slash == std::string_view::npos ? ""sv : Path.substr(Slash + 1);
+    if (Part.empty() || Part == "."sv) {
+      continue;
+    }
+    Current = find(static_cast<uint32_t>(Current), Part);
+  }
+  return Current;
+}
+
+WasiExpect<uint32_t> Archive::emplace(std::string_view Path,
+                                      __wasi_filetype_t Type) noexcept {
+  uint32_t Current = 0;
+  while (!Path.empty()) {
+    const auto Slash = Path.find('/');
+    const auto Part = Path.substr(0, Slash);
+    Path = Slash == std::string_view::npos ? ""sv : Path.substr(Slash + 1);
+    if (Part.empty() || Part == "."sv) {
+      continue;
+    }
+    if (Part == ".."sv) {
+      return WasiUnexpect(__WASI_ERRNO_PERM);
+    }
+    const bool Last = Path.find_first_not_of('/') == std::string_view::npos;
+    if (Entries[Current].Type != __WASI_FILETYPE_DIRECTORY) {
+      return WasiUnexpect(__WASI_ERRNO_NOTDIR);
+    }
+    auto &Children = Entries[Current].Children;
+    auto It = std::lower_bound(
+        Children.begin(), Children.end(), Part,
+        [](const auto &Child, std::string_view N) { return Child.first < N; });
+    if (It != Children.end() && It->first == Part) {
+      Current = It->second;
+      continue;
+    }
+    const auto Next = static_cast<uint32_t>(Entries.size());
+    Children.emplace(It, std::string(Part), Next);
+    auto &New = Entries.emplace_back();
+    New.Type = Last ? Type : __WASI_FILETYPE_DIRECTORY;
+    New.Parent = Current;
+    Current = Next;
+  }
+  return Current;
+}
+
+WasiExpect<void> Archive::parse() noexcept {
+  Entries.emplace_back();
+  std::string LongName, LongLink;
+  std::optional<uint64_t> PaxSize;
+  uint64_t Pos = 0;
+  while (Image.size() - Pos >= kBlockSize) {
+    const auto Block = Image.subspan(Pos, kBlockSize);
+    if (std::all_of(Block.begin(), Block.end(),
+                    [](uint8_t B) { return B == 0; })) {
+      break;
+    }
+    auto Size = parseNumber(Block.subspan(124, 12));
+    const auto MTime = parseNumber(Block.subspan(136, 12));
+    const char Flag = static_cast<char>(Block[156]);
+    if (PaxSize && Flag != 'x' && Flag != 'g') {
+      Size = PaxSize;
+    }
+    const uint64_t Data = Pos + kBlockSize;
+    if (unlikely(!Size || !MTime || *Size > Image.size() - Data)) {
+      return WasiUnexpect(__WASI_ERRNO_ILSEQ);
+    }
+    const auto Content = Image.subspan(Data, *Size);
+    Pos = Data + (*Size + kBlockSize - 1) / kBlockSize * kBlockSize;
+    if (Pos > Image.size()) {
+      Pos = Image.size();
+    }
+
+    switch (Flag) {
+    case 'L':
+      LongName = parseString(Content);
+      continue;
+    case 'K':
+      LongLink = parseString(Content);
+      continue;
+    case 'x':
+      parsePax(std::string_view(reinterpret_cast<const char *>(Content.data()),
+                                Content.size()),
+               LongName, LongLink, PaxSize);
+      continue;
+    default:
+      break;
+    }
+
+    std::string Name = std::move(LongName);
+    std::string Link = std::move(LongLink);
+    LongName.clear();
+    LongLink.clear();
+    PaxSize.reset();
+    if (Name.empty()) {
+      Name = parseString(Block.subspan(0, 100));
+      if (const auto Prefix = parseString(Block.subspan(345, 155));
+          parseString(Block.subspan(257, 6)) == "ustar"sv && !Prefix.empty()) {
+        Name = std::string(Prefix) + '/' + Name;
+      }
+    }
+    if (Link.empty()) {
+      Link = parseString(Block.subspan(157, 100));
+    }
+
+    __wasi_filetype_t Type;
+    const Entry *Target = nullptr;
+    switch (Flag) {
+    case '0':
+    case '\0':
+    case '7':
+      Type = __WASI_FILETYPE_REGULAR_FILE;
+      break;
+    case '1':
+      // Hard links share the content of the earlier entry.
+      if (const auto I = resolve(Link); I > 0) {
+        Target = &Entries[static_cast<size_t>(I)];
+      }
+      if (!Target || Target->Type != __WASI_FILETYPE_REGULAR_FILE) {
+        continue;
+      }
+      Type = __WASI_FILETYPE_REGULAR_FILE;
+      break;
+    case '2':
+      Type = __WASI_FILETYPE_SYMBOLIC_LINK;
+      break;
+    case '5':
+      Type = __WASI_FILETYPE_DIRECTORY;
+      break;
+    default:
+      // Devices, FIFOs and the global pax headers are not served.
+      continue;
+    }
+
+    const uint64_t TargetOffset = Target ? Target->Offset : Data;
+    const uint64_t TargetSize = Target ? Target->Size : *Size;
+    // Entries escaping the root are skipped.
+    auto Index = emplace(Name, Type);
+    if (!Index) {
+      continue;
+    }
+    auto &E = Entries[*Index];
+    E.Type = Type;
+    E.MTime = *MTime * UINT64_C(1000000000);
+    if (Type == __WASI_FILETYPE_REGULAR_FILE) {
+      E.Offset = TargetOffset;
+      E.Size = TargetSize;
+    } else if (Type == __WASI_FILETYPE_SYMBOLIC_LINK) {
+      E.Link = std::move(Link);
+      E.Size = E.Link.size();
+    }
+  }
+  return {};
+}
+
+WasiExpect<void>
+ArchiveNode::fdFdstatGet(__wasi_fdstat_t &FdStat) const noexcept {
+  FdStat.fs_filetype = EndianValue(entry().Type).le();
+  FdStat.fs_flags = static_cast<__wasi_fdflags_t>(0);
+  return {};
+}
+
+void ArchiveNode::stat(uint32_t I, __wasi_filestat_t &Filestat) const noexcept {
+  const auto &E = Image->entry(I);
+  Filestat.dev = 0;
+  Filestat.ino = EndianValue(static_cast<__wasi_inode_t>(I) + 1).le();
+  Filestat.filetype = EndianValue(E.Type).le();
+  Filestat.nlink = EndianValue(static_cast<__wasi_linkcount_t>(1)).le();
+  Filestat.size = EndianValue(static_cast<__wasi_filesize_t>(E.Size)).le();
+  Filestat.atim = EndianValue(E.MTime).le();
+  Filestat.mtim = EndianValue(E.MTime).le();
+  Filestat.ctim = EndianValue(E.MTime).le();
+}
+
+WasiExpect<void>
+ArchiveNode::fdFilestatGet(__wasi_filestat_t &Filestat) const noexcept {
+  stat(Index, Filestat);
+  return {};
+}
+
+__wasi_size_t ArchiveNode::copy(Span<Span<uint8_t>> IOVs,
+                                __wasi_filesize_t Offset) const noexcept {
+  const auto Content = Image->content(entry());
+  if (Offset >= Content.size()) {
+    return 0;
+  }
+  auto Remain = Content.subspan(Offset);
+  __wasi_size_t Copied = 0;
+  for (auto &IOV : IOVs) {
+    const auto Size = std::min<uint64_t>(
+        {IOV.size(), Remain.size(),
+         std::numeric_limits<__wasi_size_t>::max() - Copied});
+    std::copy_n(Remain.begin(), Size, IOV.begin());
+    Remain = Remain.subspan(Size);
+    Copied += static_cast<__wasi_size_t>(Size);
+    if (Remain.empty()) {
+      break;
+    }
+  }
+  return Copied;
+}
+
+WasiExpect<void> ArchiveNode::fdPread(Span<Span<uint8_t>> IOVs,
+                                      __wasi_filesize_t Offset,
+                                      __wasi_size_t &NRead) const noexcept {
+  if (isDirectory()) {
+    return WasiUnexpect(__WASI_ERRNO_ISDIR);
+  }
+  NRead = EndianValue(copy(IOVs, Offset)).le();
+  return {};
+}
+
+WasiExpect<void> ArchiveNode::fdRead(Span<Span<uint8_t>> IOVs,
+                                     __wasi_size_t &NRead) noexcept {
+  if (isDirectory()) {
+    return WasiUnexpect(__WASI_ERRNO_ISDIR);
+  }
+  const auto Pos = Offset.load(std::memory_order_relaxed);
+  const auto Copied = copy(IOVs, Pos);
+  Offset.store(Pos + Copied, std::memory_order_relaxed);
+  NRead = EndianValue(Copied).le();
+  return {};
+}
+
+WasiExpect<void> ArchiveNode::fdReaddir(Span<uint8_t> Buffer,
+                                        __wasi_dircookie_t Cookie,
+                                        __wasi_size_t &Size) const noexcept {
+  const auto &E = entry();
+  if (!isDirectory()) {
+    return WasiUnexpect(__WASI_ERRNO_NOTDIR);
+  }
+  // The cookies 0 and 1 are "." and "..", followed by the children.
+  const uint64_t Count = E.Children.size() + 2;
+  Size = 0;
+  for (uint64_t I = Cookie; I < Count && !Buffer.empty(); ++I) {
+    std::string_view Name;
+    uint32_t Target;
+    if (I == 0) {
+      Name = "."sv;
+      Target = Index;
+    } else if (I == 1) {
+      Name = ".."sv;
+      Target = E.Parent;
+    } else {
+      Name = E.Children[I - 2].first;
+      Target = E.Children[I - 2].second;
+    }
+    __wasi_dirent_t Dirent{};
+    Dirent.d_next = EndianValue(static_cast<__wasi_dircookie_t>(I + 1)).le();
+    Dirent.d_ino = EndianValue(static_cast<__wasi_inode_t>(Target) + 1).le();
+    Dirent.d_namlen =
+        EndianValue(static_cast<__wasi_dirnamlen_t>(Name.size())).le();
+    Dirent.d_type = EndianValue(Image->entry(Target).Type).le();
+    // Truncate the last entry if the buffer is full.
+    const auto *Header = reinterpret_cast<const uint8_t *>(&Dirent);
+    const auto HeaderSize = std::min<size_t>(sizeof(Dirent), Buffer.size());
+    std::copy_n(Header, HeaderSize, Buffer.begin());
+    Buffer = Buffer.subspan(HeaderSize);
+    const auto NameSize = std::min<size_t>(Name.size(), Buffer.size());
+    std::copy_n(Name.begin(), NameSize, Buffer.begin());
+    Buffer = Buffer.subspan(NameSize);
+    Size += static_cast<__wasi_size_t>(HeaderSize + NameSize);
+  }
+  Size = EndianValue(Size).le();
+  return {};
+}
+
+WasiExpect<void> ArchiveNode::fdSeek(__wasi_filedelta_t Delta,
+                                     __wasi_whence_t Whence,
+                                     __wasi_filesize_t &Size) noexcept {
+  int64_t Base;
+  switch (Whence) {
+  case __WASI_WHENCE_SET:
+    Base = 0;
+    break;
+  case __WASI_WHENCE_CUR:
+    Base = static_cast<int64_t>(Offset.load(std::memory_order_relaxed));
+    break;
+  case __WASI_WHENCE_END:
+    Base = static_cast<int64_t>(entry().Size);
+    break;
+  default:
+    return WasiUnexpect(__WASI_ERRNO_INVAL);
+  }
+  if ((Delta < 0 && Base + Delta < 0) ||
+      (Delta > 0 && Base > std::numeric_limits<int64_t>::max() - Delta)) {
+    return WasiUnexpect(__WASI_ERRNO_INVAL);
+  }
+  const auto Pos = static_cast<__wasi_filesize_t>(Base + Delta);
+  Offset.store(Pos, std::memory_order_relaxed);
+  Size = EndianValue(Pos).le();
+  return {};
+}
+
+WasiExpect<void> ArchiveNode::fdTell(__wasi_filesize_t &Size) const noexcept {
+  Size = EndianValue(Offset.load(std::memory_order_relaxed)).le();
+  return {};
+}
+
+WasiExpect<void> ArchiveNode::fdSendfile(const INode &Out,
+                                         __wasi_filesize_t Count,
+                                         __wasi_filesize_t &NWritten) noexcept {
+  if (isDirectory()) {
+    return WasiUnexpect(__WASI_ERRNO_ISDIR);
+  }
+  const auto Content = Image->content(entry());
+  const auto Pos = Offset.load(std::memory_order_relaxed);
+  NWritten = 0;
+  if (Pos >= Content.size()) {
+    return {};
+  }
+  const auto Size =
+      std::min<uint64_t>({Count, Content.size() - Pos, UINT64_C(1) << 30});
+  Span<const uint8_t> IOV = Content.subspan(Pos, Size);
+  __wasi_size_t Written;
+  EXPECTED_TRY(Out.fdWrite(Span<Span<const uint8_t>>(&IOV, 1), Written));
+  Written = EndianValue(Written).le();
+  Offset.store(Pos + Written, std::memory_order_relaxed);
+  NWritten = EndianValue(static_cast<__wasi_filesize_t>(Written)).le();
+  return {};
+}
+
+WasiExpect<uint32_t>
+ArchiveNode::lookup(std::string_view Path) const noexcept {
+  if (Path == "."sv) {
+    return Index;
+  }
+  if (!isDirectory()) {
+    return WasiUnexpect(__WASI_ERRNO_NOTDIR);
+  }
+  if (const auto I = Image->find(Index, Path); I >= 0) {
+    return static_cast<uint32_t>(I);
+  }
+  return WasiUnexpect(__WASI_ERRNO_NOENT);
+}
+
+WasiExpect<void>
+ArchiveNode::pathFilestatGet(std::string_view Path,
+                             __wasi_filestat_t &Filestat) const noexcept {
+  EXPECTED_TRY(auto I, lookup(Path));
+  stat(I, Filestat);
+  return {};
+}
+
+WasiExpect<ArchiveNode>
+ArchiveNode::pathOpen(std::string_view Path,
+                      __wasi_oflags_t OpenFlags) const noexcept {
+  auto I = lookup(Path);
+  if (!I) {
+    if (I.error() == __WASI_ERRNO_NOENT && (OpenFlags & __WASI_OFLAGS_CREAT)) {
+      return WasiUnexpect(__WASI_ERRNO_ROFS);
+    }
+    return WasiUnexpect(I);
+  }
+  if ((OpenFlags & __WASI_OFLAGS_CREAT) && (OpenFlags & __WASI_OFLAGS_EXCL)) {
+    return WasiUnexpect(__WASI_ERRNO_EXIST);
+  }
+  if (OpenFlags & __WASI_OFLAGS_TRUNC) {
+    return WasiUnexpect(__WASI_ERRNO_ROFS);
+  }
+  const auto Type = Image->entry(*I).Type;
+  if (Type == __WASI_FILETYPE_SYMBOLIC_LINK) {
+    return WasiUnexpect(__WASI_ERRNO_LOOP);
+  }
+  if ((OpenFlags & __WASI_OFLAGS_DIRECTORY) &&
+      Type != __WASI_FILETYPE_DIRECTORY) {
+    return WasiUnexpect(__WASI_ERRNO_NOTDIR);
+  }
+  return ArchiveNode(Image, *I);
+}
+
+WasiExpect<void>
+ArchiveNode::pathReadlink(std::string_view Path, Span<char> Buffer,
+                          __wasi_size_t &NRead) const noexcept {
+  EXPECTED_TRY(auto I, lookup(Path));
+  const auto &E = Image->entry(I);
+  if (E.Type != __WASI_FILETYPE_SYMBOLIC_LINK) {
+    return WasiUnexpect(__WASI_ERRNO_INVAL);
+  }
+  const auto Size = std::min<size_t>(E.Link.size(), Buffer.size());
+  std::copy_n(E.Link.begin(), Size, Buffer.begin());
+  NRead = EndianValue(static_cast<__wasi_size_t>(Size)).le();
+  return {};
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
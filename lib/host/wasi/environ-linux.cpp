@@ -118,6 +118,10 @@ WasiExpect<void> Environ::procRaise(__wasi_signal_t Signal) const noexcept {
 }
 
 WasiExpect<void> Environ::schedYield() const noexcept {
+  if (auto *Loop = EventLoop::current(); Loop) {
+    Loop->yield();
+    return {};
+  }
   ::sched_yield();
   return {};
 }
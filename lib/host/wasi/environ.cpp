@@ -30,6 +30,15 @@ static inline constexpr const __wasi_rights_t kPreOpenInheritingRightsReadOnly =
     __WASI_RIGHTS_FD_FILESTAT_GET | __WASI_RIGHTS_FD_FILESTAT_SET_TIMES |
     __WASI_RIGHTS_PATH_SYMLINK | __WASI_RIGHTS_PATH_REMOVE_DIRECTORY |
     __WASI_RIGHTS_PATH_UNLINK_FILE | __WASI_RIGHTS_POLL_FD_READWRITE;
+static inline constexpr const __wasi_rights_t kArchiveBaseRights =
+    __WASI_RIGHTS_PATH_OPEN | __WASI_RIGHTS_FD_READDIR |
+    __WASI_RIGHTS_PATH_READLINK | __WASI_RIGHTS_PATH_FILESTAT_GET |
+    __WASI_RIGHTS_FD_FILESTAT_GET;
+static inline constexpr const __wasi_rights_t kArchiveInheritingRights =
+    __WASI_RIGHTS_FD_READ | __WASI_RIGHTS_FD_SEEK | __WASI_RIGHTS_FD_TELL |
+    __WASI_RIGHTS_FD_ADVISE | __WASI_RIGHTS_PATH_OPEN |
+    __WASI_RIGHTS_FD_READDIR | __WASI_RIGHTS_PATH_READLINK |
+    __WASI_RIGHTS_PATH_FILESTAT_GET | __WASI_RIGHTS_FD_FILESTAT_GET;
 static inline constexpr const __wasi_rights_t kPreOpenBaseRights =
     __WASI_RIGHTS_PATH_CREATE_DIRECTORY | __WASI_RIGHTS_PATH_CREATE_FILE |
     __WASI_RIGHTS_PATH_LINK_SOURCE | __WASI_RIGHTS_PATH_LINK_TARGET |
@@ -67,6 +76,7 @@ static inline constexpr const __wasi_rights_t kStdErrDefaultRights =
 static inline constexpr const __wasi_rights_t kNoInheritingRights =
     static_cast<__wasi_rights_t>(0);
 static inline constexpr const auto kReadOnly = "readonly"sv;
+static inline constexpr const auto kArchive = "archive"sv;
 
 } // namespace
 
@@ -82,11 +92,14 @@ void Environ::init(Span<const std::string> Dirs, const std::string &ProgramName,
           (Pos == std::string::npos) ? Dir : Dir.substr(Pos + 1);
       // Handle the readonly flag
       bool ReadOnly = false;
+      bool IsArchive = false;
       if (const auto ROPos = HostDir.find(':'); ROPos != std::string::npos) {
         const auto Mode = HostDir.substr(ROPos + 1);
         HostDir = HostDir.substr(0, ROPos);
         if (kReadOnly == Mode) {
           ReadOnly = true;
+        } else if (kArchive == Mode) {
+          IsArchive = true;
         }
       }
       std::string GuestDir = VINode::canonicalGuest(
@@ -99,25 +112,33 @@ void Environ::init(Span<const std::string> Dirs, const std::string &ProgramName,
           ReadOnly ? kPreOpenBaseRightsReadOnly : kPreOpenBaseRights;
       const auto InheritingRights = ReadOnly ? kPreOpenInheritingRightsReadOnly
                                              : kPreOpenInheritingRights;
-      if (auto Res = VINode::bind(BaseRights, InheritingRights,
-                                  std::move(GuestDir), std::move(HostDir));
+      if (auto Res = IsArchive ? VINode::bindArchive(
+                                     kArchiveBaseRights,
+                                     kArchiveInheritingRights,
+                                     std::move(GuestDir), std::move(HostDir))
+                               : VINode::bind(BaseRights, InheritingRights,
+                                              std::move(GuestDir),
+                                              std::move(HostDir));
           unlikely(!Res)) {
         spdlog::error("Bind guest directory failed:{}"sv, Res.error());
         continue;
       } else {
+        if (EnablePathCache) {
+          (*Res)->enablePathCache();
+        }
         PreopenedDirs.emplace_back(std::move(*Res));
       }
     }
 
     std::sort(PreopenedDirs.begin(), PreopenedDirs.end());
 
-    FdMap.emplace(0, VINode::stdIn(kStdInDefaultRights, kNoInheritingRights));
-    FdMap.emplace(1, VINode::stdOut(kStdOutDefaultRights, kNoInheritingRights));
-    FdMap.emplace(2, VINode::stdErr(kStdErrDefaultRights, kNoInheritingRights));
+    Fds.emplace(0, VINode::stdIn(kStdInDefaultRights, kNoInheritingRights));
+    Fds.emplace(1, VINode::stdOut(kStdOutDefaultRights, kNoInheritingRights));
+    Fds.emplace(2, VINode::stdErr(kStdErrDefaultRights, kNoInheritingRights));
 
     int NewFd = 3;
     for (auto &PreopenedDir : PreopenedDirs) {
-      FdMap.emplace(NewFd++, std::move(PreopenedDir));
+      Fds.emplace(NewFd++, std::move(PreopenedDir));
     }
   }
 
@@ -143,19 +164,19 @@ Environ::initWithFds(Span<const std::string> Dirs, std::string ProgramName,
     if (!StdInVNode) {
       return WasiUnexpect(StdInVNode.error());
     }
-    FdMap.emplace(0, std::move(*StdInVNode));
+    Fds.emplace(0, std::move(*StdInVNode));
     auto StdOutVNode =
         VINode::fromFd(StdOutFd, kStdOutDefaultRights, kNoInheritingRights);
     if (!StdOutVNode) {
       return WasiUnexpect(StdOutVNode.error());
     }
-    FdMap.emplace(1, std::move(*StdOutVNode));
+    Fds.emplace(1, std::move(*StdOutVNode));
     auto StdErrVNode =
         VINode::fromFd(StdErrFd, kStdErrDefaultRights, kNoInheritingRights);
     if (!StdErrVNode) {
       return WasiUnexpect(StdErrVNode.error());
     }
-    FdMap.emplace(2, std::move(*StdErrVNode));
+    Fds.emplace(2, std::move(*StdErrVNode));
 
     // Open dir for WASI environment.
     std::vector<std::shared_ptr<VINode>> PreopenedDirs;
@@ -166,11 +187,14 @@ Environ::initWithFds(Span<const std::string> Dirs, std::string ProgramName,
           (Pos == std::string::npos) ? Dir : Dir.substr(Pos + 1);
       // Handle the readonly flag
       bool ReadOnly = false;
+      bool IsArchive = false;
       if (const auto ROPos = HostDir.find(':'); ROPos != std::string::npos) {
         const auto Mode = HostDir.substr(ROPos + 1);
         HostDir = HostDir.substr(0, ROPos);
         if (kReadOnly == Mode) {
           ReadOnly = true;
+        } else if (kArchive == Mode) {
+          IsArchive = true;
         }
       }
       std::string GuestDir = VINode::canonicalGuest(
@@ -183,12 +207,20 @@ Environ::initWithFds(Span<const std::string> Dirs, std::string ProgramName,
           ReadOnly ? kPreOpenBaseRightsReadOnly : kPreOpenBaseRights;
       const auto InheritingRights = ReadOnly ? kPreOpenInheritingRightsReadOnly
                                              : kPreOpenInheritingRights;
-      if (auto Res = VINode::bind(BaseRights, InheritingRights,
-                                  std::move(GuestDir), std::move(HostDir));
+      if (auto Res = IsArchive ? VINode::bindArchive(
+                                     kArchiveBaseRights,
+                                     kArchiveInheritingRights,
+                                     std::move(GuestDir), std::move(HostDir))
+                               : VINode::bind(BaseRights, InheritingRights,
+                                              std::move(GuestDir),
+                                              std::move(HostDir));
           unlikely(!Res)) {
         spdlog::error("Bind guest directory failed:{}"sv, Res.error());
         continue;
       } else {
+        if (EnablePathCache) {
+          (*Res)->enablePathCache();
+        }
         PreopenedDirs.emplace_back(std::move(*Res));
       }
     }
@@ -197,7 +229,7 @@ Environ::initWithFds(Span<const std::string> Dirs, std::string ProgramName,
 
     int NewFd = 3;
     for (auto &PreopenedDir : PreopenedDirs) {
-      FdMap.emplace(NewFd++, std::move(PreopenedDir));
+      Fds.emplace(NewFd++, std::move(PreopenedDir));
     }
   }
 
@@ -217,7 +249,7 @@ Environ::initWithFds(Span<const std::string> Dirs, std::string ProgramName,
 void Environ::fini() noexcept {
   EnvironVariables.clear();
   Arguments.clear();
-  FdMap.clear();
+  Fds.clear();
 }
 
 Environ::~Environ() noexcept { fini(); }
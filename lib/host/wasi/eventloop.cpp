@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "host/wasi/eventloop.h"
+#include "common/config.h"
+#include "common/defines.h"
+
+#include <cstdint>
+#include <new>
+#include <unordered_map>
+#include <utility>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+namespace {
+thread_local EventLoop *CurrentLoop = nullptr;
+} // namespace
+
+EventLoop::EventLoop(size_t S) noexcept : StackSize(S), Poller(*this) {}
+
+WasiExpect<void> EventLoop::spawn(std::function<void()> Func) noexcept {
+  auto Context = Fiber::create(std::move(Func), StackSize);
+  if (unlikely(!Context)) {
+#if WASMEDGE_OS_WINDOWS
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+#else
+    return WasiUnexpect(__WASI_ERRNO_NOMEM);
+#endif
+  }
+  try {
+    auto NewTask = std::make_unique<Task>();
+    NewTask->Context = std::move(Context);
+    Ready.push_back(std::move(NewTask));
+  } catch (std::bad_alloc &) {
+    return WasiUnexpect(__WASI_ERRNO_NOMEM);
+  }
+  return {};
+}
+
+WasiExpect<void> EventLoop::run() noexcept {
+  std::vector<std::unique_ptr<Task>> Batch;
+  while (!Ready.empty() || !Parked.empty()) {
+    Batch.swap(Ready);
+    for (auto &T : Batch) {
+      EventLoop *const Saved = std::exchange(CurrentLoop, this);
+      Running = T.get();
+      T->Context->resume();
+      Running = nullptr;
+      CurrentLoop = Saved;
+      if (T->Context->done()) {
+        continue;
+      }
+      try {
+        if (T->Node) {
+          Parked.push_back(std::move(T));
+        } else {
+          Ready.push_back(std::move(T));
+        }
+      } catch (std::bad_alloc &) {
+        return WasiUnexpect(__WASI_ERRNO_NOMEM);
+      }
+    }
+    Batch.clear();
+    if (!Parked.empty()) {
+      EXPECTED_TRY(poll());
+    }
+  }
+  return {};
+}
+
+EventLoop *EventLoop::current() noexcept { return CurrentLoop; }
+
+WasiExpect<void> EventLoop::wait(VINode &Node,
+                                 __wasi_eventtype_t Type) noexcept {
+  assuming(Running);
+  Task &Self = *Running;
+  bool Checked = false;
+  while (true) {
+    EXPECTED_TRY(const bool IsReady, Node.isReady(Type));
+    if (IsReady) {
+      return {};
+    }
+    if (!Checked) {
+      // Let the call on a non-blocking node fail with AGAIN as usual.
+      __wasi_fdstat_t FdStat;
+      EXPECTED_TRY(Node.fdFdstatGet(FdStat));
+      if (EndianValue(FdStat.fs_flags).le() & __WASI_FDFLAGS_NONBLOCK) {
+        return {};
+      }
+      Checked = true;
+    }
+    Self.Node = Node.shared_from_this();
+    Self.Type = Type;
+    Fiber::suspend();
+    Self.Node.reset();
+  }
+}
+
+void EventLoop::yield() noexcept {
+  assuming(Running);
+  Fiber::suspend();
+}
+
+WasiExpect<void> EventLoop::poll() noexcept {
+  const size_t Count = Parked.size();
+  try {
+    Subscribers.resize(Count);
+    // The poller accepts one subscription per event of a node, so the tasks
+    // waiting for the same event share it.
+    std::unordered_map<const VINode *, std::pair<size_t, size_t>> Subscribed;
+    size_t NSubscriptions = 0;
+    for (size_t I = 0; I < Count; ++I) {
+      auto &[Read, Write] =
+          Subscribed.try_emplace(Parked[I]->Node.get(), SIZE_MAX, SIZE_MAX)
+              .first->second;
+      auto &First = Parked[I]->Type == __WASI_EVENTTYPE_FD_WRITE ? Write : Read;
+      if (First == SIZE_MAX) {
+        First = I;
+        ++NSubscriptions;
+      }
+      Subscribers[I] = First;
+    }
+    if (!Ready.empty()) {
+      ++NSubscriptions;
+    }
+
+    Events.resize(NSubscriptions);
+    EXPECTED_TRY(Poller.prepare(Events));
+    for (size_t I = 0; I < Count; ++I) {
+      if (Subscribers[I] != I) {
+        continue;
+      }
+      if (Parked[I]->Type == __WASI_EVENTTYPE_FD_WRITE) {
+        Poller.write(Parked[I]->Node, TriggerType::Level, I);
+      } else {
+        Poller.read(Parked[I]->Node, TriggerType::Level, I);
+      }
+    }
+    if (!Ready.empty()) {
+      // Only collect the ready events without blocking the ready tasks.
+      Poller.clock(__WASI_CLOCKID_MONOTONIC, 1, 0,
+                   static_cast<__wasi_subclockflags_t>(0), Count);
+    }
+    Poller.wait();
+    const __wasi_size_t NEvents = Poller.result();
+    Poller.reset();
+
+    std::vector<bool> Woken(Count, false);
+    for (__wasi_size_t I = 0; I < NEvents; ++I) {
+      if (const auto Index = Events[I].userdata; Index < Count) {
+        Woken[Index] = true;
+      }
+    }
+    size_t Kept = 0;
+    for (size_t I = 0; I < Count; ++I) {
+      if (Woken[Subscribers[I]]) {
+        Ready.push_back(std::move(Parked[I]));
+      } else {
+        Parked[Kept++] = std::move(Parked[I]);
+      }
+    }
+    Parked.resize(Kept);
+  } catch (std::bad_alloc &) {
+    return WasiUnexpect(__WASI_ERRNO_NOMEM);
+  }
+  return {};
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
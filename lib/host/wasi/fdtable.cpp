@@ -0,0 +1,285 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "host/wasi/fdtable.h"
+#include "common/defines.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+namespace {
+
+/// Hazard slots of a thread. The records are never freed, and are reused by
+/// the later threads after the owner thread exits.
+struct HazardRecord {
+  static inline constexpr const uint32_t kSlots = 4;
+  std::array<std::atomic<const void *>, kSlots> Slots{};
+  std::atomic<bool> Active = false;
+  HazardRecord *Next = nullptr;
+  /// Bitmask of the used slots, only accessed by the owner thread.
+  uint32_t Used = 0;
+};
+
+std::atomic<HazardRecord *> Records = nullptr;
+
+HazardRecord *acquireRecord() noexcept {
+  for (auto *R = Records.load(std::memory_order_acquire); R; R = R->Next) {
+    bool Expected = false;
+    if (!R->Active.load(std::memory_order_relaxed) &&
+        R->Active.compare_exchange_strong(Expected, true,
+                                          std::memory_order_acq_rel)) {
+      return R;
+    }
+  }
+  auto *R = new HazardRecord;
+  R->Active.store(true, std::memory_order_relaxed);
+  R->Next = Records.load(std::memory_order_relaxed);
+  while (!Records.compare_exchange_weak(R->Next, R, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+  return R;
+}
+
+struct ThreadHazards {
+  HazardRecord *Record = acquireRecord();
+  ~ThreadHazards() noexcept {
+    Record->Active.store(false, std::memory_order_release);
+  }
+};
+
+thread_local ThreadHazards LocalHazards;
+
+} // namespace
+
+std::atomic<const void *> *FdTable::acquireHazard() noexcept {
+  auto &Record = *LocalHazards.Record;
+  for (uint32_t I = 0; I < HazardRecord::kSlots; ++I) {
+    if (!(Record.Used & (1U << I))) {
+      Record.Used |= 1U << I;
+      return &Record.Slots[I];
+    }
+  }
+  return nullptr;
+}
+
+void FdTable::releaseHazard(std::atomic<const void *> *Slot) noexcept {
+  auto &Record = *LocalHazards.Record;
+  Slot->store(nullptr, std::memory_order_seq_cst);
+  Record.Used &= ~(1U << static_cast<uint32_t>(Slot - Record.Slots.data()));
+}
+
+FdTable::~FdTable() noexcept {
+  for (auto &Seg : Segments) {
+    if (auto *S = Seg.load(std::memory_order_relaxed)) {
+      for (auto &Slot : S->Slots) {
+        delete Slot.load(std::memory_order_relaxed);
+      }
+      delete S;
+    }
+  }
+}
+
+std::atomic<const FdTable::Entry *> *
+FdTable::slot(__wasi_fd_t Fd, bool Create) const noexcept {
+  if (unlikely(Fd < 0 || static_cast<uint32_t>(Fd) >= kMaxFds)) {
+    return nullptr;
+  }
+  const uint32_t Index = static_cast<uint32_t>(Fd);
+  auto &Seg = Segments[Index >> kSegmentBits];
+  auto *S = Seg.load(std::memory_order_acquire);
+  if (!S) {
+    if (!Create) {
+      return nullptr;
+    }
+    S = new Segment;
+    Seg.store(S, std::memory_order_release);
+  }
+  return &S->Slots[Index & (kSegmentSize - 1)];
+}
+
+FdTable::Ref FdTable::find(__wasi_fd_t Fd) const noexcept {
+  Ref Result;
+  auto *Slot = slot(Fd, false);
+  if (!Slot) {
+    return Result;
+  }
+  const Entry *E = Slot->load(std::memory_order_acquire);
+  if (!E) {
+    return Result;
+  }
+  auto *Hazard = acquireHazard();
+  if (unlikely(!Hazard)) {
+    std::unique_lock Lock(Mutex);
+    if (const Entry *Locked = Slot->load(std::memory_order_relaxed)) {
+      Result.Owner = Locked->Node;
+    }
+    return Result;
+  }
+  // Publish the entry, and check it is still in the table afterward, so that
+  // the writers removing it later must see the hazard.
+  while (true) {
+    Hazard->store(E, std::memory_order_seq_cst);
+    const Entry *Current = Slot->load(std::memory_order_seq_cst);
+    if (Current == E) {
+      break;
+    }
+    if (!Current) {
+      releaseHazard(Hazard);
+      return Result;
+    }
+    E = Current;
+  }
+  Result.Table = this;
+  Result.Slot = Hazard;
+  Result.Found = E;
+  return Result;
+}
+
+void FdTable::reserve(__wasi_fd_t Fd) noexcept {
+  if (Fd >= NextFd) {
+    for (__wasi_fd_t I = NextFd; I < Fd; ++I) {
+      FreeFds.push_back(I);
+      std::push_heap(FreeFds.begin(), FreeFds.end(), std::greater<>());
+    }
+    NextFd = Fd + 1;
+  } else if (auto It = std::find(FreeFds.begin(), FreeFds.end(), Fd);
+             It != FreeFds.end()) {
+    FreeFds.erase(It);
+    std::make_heap(FreeFds.begin(), FreeFds.end(), std::greater<>());
+  }
+}
+
+void FdTable::emplace(__wasi_fd_t Fd, std::shared_ptr<VINode> Node) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto *Slot = slot(Fd, true);
+  if (unlikely(!Slot)) {
+    return;
+  }
+  reserve(Fd);
+  if (const Entry *Old = Slot->exchange(new Entry(std::move(Node)),
+                                        std::memory_order_seq_cst)) {
+    retire(Old);
+  }
+}
+
+WasiExpect<__wasi_fd_t>
+FdTable::insert(std::shared_ptr<VINode> Node) noexcept {
+  std::unique_lock Lock(Mutex);
+  __wasi_fd_t Fd;
+  if (!FreeFds.empty()) {
+    std::pop_heap(FreeFds.begin(), FreeFds.end(), std::greater<>());
+    Fd = FreeFds.back();
+    FreeFds.pop_back();
+  } else if (unlikely(static_cast<uint32_t>(NextFd) >= kMaxFds)) {
+    return WasiUnexpect(__WASI_ERRNO_MFILE);
+  } else {
+    Fd = NextFd++;
+  }
+  slot(Fd, true)->store(new Entry(std::move(Node)), std::memory_order_release);
+  return Fd;
+}
+
+std::shared_ptr<VINode> FdTable::erase(__wasi_fd_t Fd) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto *Slot = slot(Fd, false);
+  if (!Slot) {
+    return {};
+  }
+  const Entry *Old = Slot->exchange(nullptr, std::memory_order_seq_cst);
+  if (!Old) {
+    return {};
+  }
+  auto Node = Old->Node;
+  FreeFds.push_back(Fd);
+  std::push_heap(FreeFds.begin(), FreeFds.end(), std::greater<>());
+  retire(Old);
+  return Node;
+}
+
+bool FdTable::renumber(__wasi_fd_t Fd, __wasi_fd_t To) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto *From = slot(Fd, false);
+  auto *Target = slot(To, false);
+  if (!From || !Target) {
+    return false;
+  }
+  const Entry *E = From->load(std::memory_order_relaxed);
+  const Entry *Old = Target->load(std::memory_order_relaxed);
+  if (!E || !Old) {
+    return false;
+  }
+  if (Fd == To) {
+    return true;
+  }
+  Target->store(E, std::memory_order_seq_cst);
+  From->store(nullptr, std::memory_order_seq_cst);
+  FreeFds.push_back(Fd);
+  std::push_heap(FreeFds.begin(), FreeFds.end(), std::greater<>());
+  retire(Old);
+  return true;
+}
+
+void FdTable::clear() noexcept {
+  std::unique_lock Lock(Mutex);
+  for (auto &Seg : Segments) {
+    if (auto *S = Seg.load(std::memory_order_relaxed)) {
+      for (auto &Slot : S->Slots) {
+        if (const Entry *Old =
+                Slot.exchange(nullptr, std::memory_order_seq_cst)) {
+          Retired.emplace_back(Old);
+        }
+      }
+    }
+  }
+  FreeFds.clear();
+  NextFd = 0;
+  retire(nullptr);
+}
+
+void FdTable::retire(const Entry *E) noexcept {
+  if (E) {
+    Retired.emplace_back(E);
+  }
+  if (Retired.empty()) {
+    return;
+  }
+  // Announce the retired entries before scanning the hazards, so that the
+  // readers releasing the hazards after the scan will reclaim them.
+  Pending.store(true, std::memory_order_seq_cst);
+  scan();
+}
+
+void FdTable::reclaim() const noexcept {
+  std::unique_lock Lock(Mutex);
+  scan();
+}
+
+void FdTable::scan() const noexcept {
+  std::vector<const void *> Hazards;
+  for (auto *R = Records.load(std::memory_order_acquire); R; R = R->Next) {
+    for (auto &Slot : R->Slots) {
+      if (const void *P = Slot.load(std::memory_order_seq_cst)) {
+        Hazards.push_back(P);
+      }
+    }
+  }
+  std::sort(Hazards.begin(), Hazards.end());
+  Retired.erase(std::remove_if(Retired.begin(), Retired.end(),
+                               [&Hazards](const auto &R) noexcept {
+                                 return !std::binary_search(Hazards.begin(),
+                                                            Hazards.end(),
+                                                            R.get());
+                               }),
+                Retired.end());
+  if (Retired.empty()) {
+    Pending.store(false, std::memory_order_seq_cst);
+  }
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
@@ -12,6 +12,7 @@
 #include "host/wasi/vfs.h"
 #include "linux.h"
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -134,6 +135,59 @@ createNullTerminatedString(std::string_view View) noexcept {
   return {CStr, std::move(Buffer)};
 }
 
+void fromStat(const struct stat &SysFStat,
+              __wasi_filestat_t &Filestat) noexcept {
+  Filestat.dev = EndianValue(SysFStat.st_dev).le();
+  Filestat.ino = EndianValue(SysFStat.st_ino).le();
+  Filestat.filetype = fromFileType(SysFStat.st_mode);
+  Filestat.nlink = EndianValue(SysFStat.st_nlink).le();
+  Filestat.size = EndianValue(SysFStat.st_size).le();
+  Filestat.atim = fromTimespec(SysFStat.st_atim).le();
+  Filestat.mtim = fromTimespec(SysFStat.st_mtim).le();
+  Filestat.ctim = fromTimespec(SysFStat.st_ctim).le();
+}
+
+/// Open the path with every component resolved beneath the directory by the
+/// kernel. The NOSYS error means the caller should resolve the path itself.
+WasiExpect<int> openBeneath(int Fd, const std::string &Path,
+                            int Flags) noexcept {
+#if WASMEDGE_WASI_HAS_OPENAT2
+  static std::atomic<bool> Unsupported = false;
+  if (unlikely(Unsupported.load(std::memory_order_relaxed))) {
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+  }
+  open_how How = {};
+  How.flags = static_cast<uint32_t>(Flags);
+  // The mode is rejected without creating.
+  How.mode = (Flags & O_CREAT) ? 0644 : 0;
+  How.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+  if (auto NewFd = ::syscall(__NR_openat2, Fd, Path.c_str(), &How, sizeof(How));
+      likely(NewFd >= 0)) {
+    return static_cast<int>(NewFd);
+  }
+  switch (errno) {
+  case ENOSYS:
+    Unsupported.store(true, std::memory_order_relaxed);
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+  case EPERM:
+    // Some seccomp filters reject the unknown syscalls in this way.
+  case EINVAL:
+    // The flags ignored by `openat` are rejected, e.g. with `O_PATH`.
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+  case EXDEV:
+    // The path escapes from the directory.
+    return WasiUnexpect(__WASI_ERRNO_PERM);
+  default:
+    return WasiUnexpect(fromErrNo(errno));
+  }
+#else
+  static_cast<void>(Fd);
+  static_cast<void>(Path);
+  static_cast<void>(Flags);
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+#endif
+}
+
 } // namespace
 
 void FdHolder::reset() noexcept {
@@ -160,6 +214,171 @@ void DirHolder::reset() noexcept {
   }
 }
 
+#if WASMEDGE_WASI_HAS_URING
+WasiExpect<void> UringHolder::create(uint32_t Entries) noexcept {
+  struct io_uring_params Params;
+  std::memset(&Params, 0, sizeof(Params));
+  const int NewFd =
+      static_cast<int>(::syscall(__NR_io_uring_setup, Entries, &Params));
+  if (unlikely(NewFd < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  emplace(NewFd);
+
+  auto Map = [this](size_t Size, off_t Offset) noexcept -> void * {
+    void *Ptr = ::mmap(nullptr, Size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, Fd, Offset);
+    return Ptr == MAP_FAILED ? nullptr : Ptr;
+  };
+  QueueData Q;
+  Q.SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(uint32_t);
+  Q.CqRingSize =
+      Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool SingleMap = Params.features & IORING_FEAT_SINGLE_MMAP;
+  if (SingleMap) {
+    Q.SqRingSize = Q.CqRingSize = std::max(Q.SqRingSize, Q.CqRingSize);
+  }
+  Q.SqesSize = Params.sq_entries * sizeof(struct io_uring_sqe);
+  Q.SqRing = Map(Q.SqRingSize, IORING_OFF_SQ_RING);
+  Q.CqRing = SingleMap ? Q.SqRing : Map(Q.CqRingSize, IORING_OFF_CQ_RING);
+  Q.Sqes = Map(Q.SqesSize, IORING_OFF_SQES);
+  Queues = Q;
+  if (unlikely(!Q.SqRing || !Q.CqRing || !Q.Sqes)) {
+    const auto Error = fromErrNo(errno);
+    unmap();
+    FdHolder::reset();
+    return WasiUnexpect(Error);
+  }
+
+  auto *SqBase = static_cast<uint8_t *>(Q.SqRing);
+  auto *CqBase = static_cast<uint8_t *>(Q.CqRing);
+  Queues.SqHead = reinterpret_cast<uint32_t *>(SqBase + Params.sq_off.head);
+  Queues.SqTail = reinterpret_cast<uint32_t *>(SqBase + Params.sq_off.tail);
+  Queues.SqArray = reinterpret_cast<uint32_t *>(SqBase + Params.sq_off.array);
+  Queues.SqMask =
+      *reinterpret_cast<uint32_t *>(SqBase + Params.sq_off.ring_mask);
+  Queues.SqEntries = Params.sq_entries;
+  Queues.CqHead = reinterpret_cast<uint32_t *>(CqBase + Params.cq_off.head);
+  Queues.CqTail = reinterpret_cast<uint32_t *>(CqBase + Params.cq_off.tail);
+  Queues.Cqes = CqBase + Params.cq_off.cqes;
+  Queues.CqMask =
+      *reinterpret_cast<uint32_t *>(CqBase + Params.cq_off.ring_mask);
+  return {};
+}
+
+namespace {
+/// Get the next submission queue entry, submitting the queued entries first if
+/// the submission queue is full.
+WasiExpect<struct io_uring_sqe *> nextSqe(UringHolder &Ring) noexcept {
+  auto &Q = Ring.Queues;
+  const uint32_t Tail = *Q.SqTail;
+  if (Tail - __atomic_load_n(Q.SqHead, __ATOMIC_ACQUIRE) == Q.SqEntries) {
+    if (auto Res = Ring.submit(0); unlikely(!Res)) {
+      return WasiUnexpect(Res);
+    }
+  }
+  const uint32_t Index = Tail & Q.SqMask;
+  auto *Sqe = static_cast<struct io_uring_sqe *>(Q.Sqes) + Index;
+  std::memset(Sqe, 0, sizeof(*Sqe));
+  Q.SqArray[Index] = Index;
+  return Sqe;
+}
+
+/// Publish the entry got from `nextSqe`.
+void queueSqe(UringHolder &Ring) noexcept {
+  auto &Q = Ring.Queues;
+  __atomic_store_n(Q.SqTail, *Q.SqTail + 1, __ATOMIC_RELEASE);
+  ++Q.Queued;
+}
+} // namespace
+
+WasiExpect<void> UringHolder::pollAdd(int PollFd, uint32_t Events,
+                                      uint64_t UserData) noexcept {
+  auto Res = nextSqe(*this);
+  if (unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  auto *Sqe = *Res;
+  Sqe->opcode = IORING_OP_POLL_ADD;
+  Sqe->fd = PollFd;
+  // The 16-bit field is compatible with the kernels reading the 32-bit one.
+  Sqe->poll_events = static_cast<uint16_t>(Events);
+  Sqe->user_data = UserData;
+  queueSqe(*this);
+  return {};
+}
+
+WasiExpect<void> UringHolder::pollRemove(uint64_t UserData) noexcept {
+  auto Res = nextSqe(*this);
+  if (unlikely(!Res)) {
+    return WasiUnexpect(Res);
+  }
+  auto *Sqe = *Res;
+  Sqe->opcode = IORING_OP_POLL_REMOVE;
+  Sqe->fd = -1;
+  Sqe->addr = UserData;
+  Sqe->user_data = UINT64_MAX;
+  queueSqe(*this);
+  return {};
+}
+
+WasiExpect<void> UringHolder::submit(uint32_t WaitNr) noexcept {
+  while (true) {
+    const long Res =
+        ::syscall(__NR_io_uring_enter, Fd, Queues.Queued, WaitNr,
+                  WaitNr > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+    if (likely(Res >= 0)) {
+      Queues.Queued -= static_cast<uint32_t>(Res);
+      return {};
+    }
+    if (errno != EINTR) {
+      return WasiUnexpect(fromErrNo(errno));
+    }
+  }
+}
+
+bool UringHolder::pop(uint64_t &UserData, int32_t &Result) noexcept {
+  const uint32_t Head = *Queues.CqHead;
+  if (Head == __atomic_load_n(Queues.CqTail, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  const auto &Cqe =
+      static_cast<struct io_uring_cqe *>(Queues.Cqes)[Head & Queues.CqMask];
+  UserData = Cqe.user_data;
+  Result = Cqe.res;
+  __atomic_store_n(Queues.CqHead, Head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+void UringHolder::unmap() noexcept {
+  if (Queues.Sqes) {
+    ::munmap(Queues.Sqes, Queues.SqesSize);
+  }
+  if (Queues.CqRing && Queues.CqRing != Queues.SqRing) {
+    ::munmap(Queues.CqRing, Queues.CqRingSize);
+  }
+  if (Queues.SqRing) {
+    ::munmap(Queues.SqRing, Queues.SqRingSize);
+  }
+  Queues = {};
+}
+#else
+WasiExpect<void> UringHolder::create(uint32_t) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+WasiExpect<void> UringHolder::pollAdd(int, uint32_t, uint64_t) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+WasiExpect<void> UringHolder::pollRemove(uint64_t) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+WasiExpect<void> UringHolder::submit(uint32_t) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+bool UringHolder::pop(uint64_t &, int32_t &) noexcept { return false; }
+void UringHolder::unmap() noexcept {}
+#endif
+
 namespace {
 WasiExpect<INode> createStdNode(int32_t Fd) {
   if (Fd < 0) {
@@ -606,6 +825,83 @@ WasiExpect<void> INode::fdWrite(Span<Span<const uint8_t>> IOVs,
   return {};
 }
 
+WasiExpect<void> INode::fdSendfile(const INode &In, __wasi_filesize_t Count,
+                                   __wasi_filesize_t &NWritten) const noexcept {
+  // Linux transfers at most 0x7ffff000 bytes per call.
+  const size_t Size =
+      static_cast<size_t>(std::min<__wasi_filesize_t>(Count, 0x7ffff000));
+  auto Done = [&NWritten](ssize_t Res) noexcept -> WasiExpect<void> {
+    NWritten = EndianValue(static_cast<__wasi_filesize_t>(Res)).le();
+    return {};
+  };
+
+  // `sendfile` covers the file to socket case, and fails with EINVAL when the
+  // input cannot be mapped, such as sockets and pipes.
+  if (auto Res = ::sendfile(Fd, In.Fd, nullptr, Size); Res >= 0) {
+    return Done(Res);
+  } else if (errno != EINVAL && errno != ENOSYS) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+
+  // `splice` moves pages when any side is a pipe.
+  if (auto Res = ::splice(In.Fd, nullptr, Fd, nullptr, Size, SPLICE_F_MOVE);
+      Res >= 0) {
+    return Done(Res);
+  } else if (errno != EINVAL) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+
+  // Bounce through a host buffer, which still skips the guest memory. The
+  // input is read at its offset or peeked, and only the bytes written are
+  // consumed afterward, so nothing is lost when the output takes less.
+  std::array<uint8_t, 16384> Buffer;
+  const size_t Want = std::min(Size, Buffer.size());
+  const off_t Offset = ::lseek(In.Fd, 0, SEEK_CUR);
+  bool Peeked = false;
+  ssize_t Read;
+  if (Offset >= 0) {
+    Read = ::pread(In.Fd, Buffer.data(), Want, Offset);
+  } else if (Read = ::recv(In.Fd, Buffer.data(), Want, MSG_PEEK);
+             Read >= 0 || errno != ENOTSOCK) {
+    Peeked = true;
+  } else {
+    Read = ::read(In.Fd, Buffer.data(), Want);
+  }
+  if (unlikely(Read < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  // The bytes read from the other inputs, such as terminals, cannot be put
+  // back, and are written even if the output is non-blocking.
+  const bool Consumed = Offset < 0 && !Peeked;
+  ssize_t Written = 0;
+  while (Written < Read) {
+    if (auto Res = ::write(Fd, Buffer.data() + Written, Read - Written);
+        Res >= 0) {
+      Written += Res;
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (Consumed && errno == EAGAIN) {
+      struct pollfd Out = {Fd, POLLOUT, 0};
+      if (::poll(&Out, 1, -1) >= 0 || errno == EINTR) {
+        continue;
+      }
+    }
+    if (Written == 0) {
+      return WasiUnexpect(fromErrNo(errno));
+    }
+    break;
+  }
+  if (Offset >= 0) {
+    ::lseek(In.Fd, Offset + Written, SEEK_SET);
+  } else if (Peeked && Written > 0) {
+    ::recv(In.Fd, Buffer.data(), static_cast<size_t>(Written), MSG_DONTWAIT);
+  }
+  return Done(Written);
+}
+
 WasiExpect<uint64_t> INode::getNativeHandler() const noexcept {
   return static_cast<uint64_t>(Fd);
 }
@@ -627,15 +923,27 @@ INode::pathFilestatGet(std::string Path,
     return WasiUnexpect(fromErrNo(errno));
   }
 
-  Filestat.dev = EndianValue(SysFStat.st_dev).le();
-  Filestat.ino = EndianValue(SysFStat.st_ino).le();
-  Filestat.filetype = fromFileType(SysFStat.st_mode);
-  Filestat.nlink = EndianValue(SysFStat.st_nlink).le();
-  Filestat.size = EndianValue(SysFStat.st_size).le();
-  Filestat.atim = fromTimespec(SysFStat.st_atim).le();
-  Filestat.mtim = fromTimespec(SysFStat.st_mtim).le();
-  Filestat.ctim = fromTimespec(SysFStat.st_ctim).le();
+  fromStat(SysFStat, Filestat);
+  return {};
+}
 
+WasiExpect<void>
+INode::pathFilestatGetBeneath(std::string Path, bool Follow,
+                              __wasi_filestat_t &Filestat) const noexcept {
+  // `statx` has no resolving flags, so the path is opened for the `fstat`.
+  int Flags = O_PATH | O_CLOEXEC;
+  if (!Follow) {
+    Flags |= O_NOFOLLOW;
+  }
+  EXPECTED_TRY(auto NewFd, openBeneath(Fd, Path, Flags));
+  FdHolder Holder(NewFd);
+
+  struct stat SysFStat;
+  if (int Res = ::fstat(NewFd, &SysFStat); unlikely(Res != 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+
+  fromStat(SysFStat, Filestat);
   return {};
 }
 
@@ -763,6 +1071,19 @@ WasiExpect<INode> INode::pathOpen(std::string Path, __wasi_oflags_t OpenFlags,
   }
 }
 
+WasiExpect<INode>
+INode::pathOpenBeneath(std::string Path, __wasi_oflags_t OpenFlags,
+                       __wasi_fdflags_t FdFlags, VFS::Flags VFSFlags,
+                       bool Follow) const noexcept {
+  int Flags = openFlags(OpenFlags, FdFlags, VFSFlags);
+  if (Follow) {
+    Flags &= ~O_NOFOLLOW;
+  }
+
+  EXPECTED_TRY(auto NewFd, openBeneath(Fd, Path, Flags));
+  return INode(NewFd);
+}
+
 WasiExpect<void> INode::pathReadlink(std::string Path, Span<char> Buffer,
                                      __wasi_size_t &NRead) const noexcept {
   if (auto Res = ::readlinkat(Fd, Path.c_str(), Buffer.data(), Buffer.size());
@@ -1001,6 +1322,16 @@ WasiExpect<void> INode::sockBind(__wasi_address_family_t AddressFamily,
   return {};
 }
 
+WasiExpect<void> INode::sockSetReusePort() noexcept {
+  const int Enable = 1;
+  if (auto Res = ::setsockopt(Fd, SOL_SOCKET, SO_REUSEPORT, &Enable,
+                              sizeof(Enable));
+      unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  return {};
+}
+
 WasiExpect<void> INode::sockListen(int32_t Backlog) noexcept {
   if (auto Res = ::listen(Fd, Backlog); unlikely(Res < 0)) {
     return WasiUnexpect(fromErrNo(errno));
@@ -1048,6 +1379,63 @@ WasiExpect<void> INode::sockRecv(Span<Span<uint8_t>> RiData,
   return sockRecvFrom(RiData, RiFlags, nullptr, {}, nullptr, NRead, RoFlags);
 }
 
+// Convert the peer address of the received message.
+static WasiExpect<void> fromSockAddr(const sockaddr_storage &SockAddr,
+                                     __wasi_address_family_t *AddressFamilyPtr,
+                                     Span<uint8_t> Address,
+                                     uint16_t *PortPtr) noexcept {
+  switch (SockAddr.ss_family) {
+  case AF_UNSPEC: {
+    spdlog::warn("remote address unavailable"sv);
+    // if ss_family is AF_UNSPEC, the access of the other members are
+    // undefined.
+    break;
+  }
+  case AF_INET: {
+    const auto &SockAddr4 = reinterpret_cast<const sockaddr_in &>(SockAddr);
+    if (AddressFamilyPtr) {
+      *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_INET4;
+    }
+    if (Address.size() >= sizeof(in_addr)) {
+      std::memcpy(Address.data(), &SockAddr4.sin_addr, sizeof(in_addr));
+    }
+    if (PortPtr != nullptr) {
+      *PortPtr = SockAddr4.sin_port;
+    }
+    break;
+  }
+  case AF_INET6: {
+    const auto &SockAddr6 = reinterpret_cast<const sockaddr_in6 &>(SockAddr);
+    if (AddressFamilyPtr) {
+      *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_INET6;
+    }
+    if (Address.size() >= sizeof(in6_addr)) {
+      std::memcpy(Address.data(), &SockAddr6.sin6_addr, sizeof(in6_addr));
+    }
+    if (PortPtr != nullptr) {
+      *PortPtr = SockAddr6.sin6_port;
+    }
+    break;
+  }
+  case AF_UNIX: {
+    const auto &SockAddrUN = reinterpret_cast<const sockaddr_un &>(SockAddr);
+    if (AddressFamilyPtr) {
+      *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_AF_UNIX;
+    }
+    if (Address.size() >= sizeof(sockaddr_un::sun_path)) {
+      std::memcpy(Address.data(), &SockAddrUN.sun_path,
+                  sizeof(sockaddr_un::sun_path));
+    } else {
+      return WasiUnexpect(__WASI_ERRNO_INVAL);
+    }
+    break;
+  }
+  default:
+    return WasiUnexpect(__WASI_ERRNO_NOSYS);
+  }
+  return {};
+}
+
 WasiExpect<void> INode::sockRecvFrom(Span<Span<uint8_t>> RiData,
                                      __wasi_riflags_t RiFlags,
                                      __wasi_address_family_t *AddressFamilyPtr,
@@ -1095,54 +1483,9 @@ WasiExpect<void> INode::sockRecvFrom(Span<Span<uint8_t>> RiData,
   }
 
   if (NeedAddress) {
-    switch (SockAddr.ss_family) {
-    case AF_UNSPEC: {
-      spdlog::warn("remote address unavailable"sv);
-      // if ss_family is AF_UNSPEC, the access of the other members are
-      // undefined.
-      break;
-    }
-    case AF_INET: {
-      const auto &SockAddr4 = reinterpret_cast<sockaddr_in &>(SockAddr);
-      if (AddressFamilyPtr) {
-        *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_INET4;
-      }
-      if (Address.size() >= sizeof(in_addr)) {
-        std::memcpy(Address.data(), &SockAddr4.sin_addr, sizeof(in_addr));
-      }
-      if (PortPtr != nullptr) {
-        *PortPtr = SockAddr4.sin_port;
-      }
-      break;
-    }
-    case AF_INET6: {
-      const auto &SockAddr6 = reinterpret_cast<sockaddr_in6 &>(SockAddr);
-      if (AddressFamilyPtr) {
-        *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_INET6;
-      }
-      if (Address.size() >= sizeof(in6_addr)) {
-        std::memcpy(Address.data(), &SockAddr6.sin6_addr, sizeof(in6_addr));
-      }
-      if (PortPtr != nullptr) {
-        *PortPtr = SockAddr6.sin6_port;
-      }
-      break;
-    }
-    case AF_UNIX: {
-      const auto &SockAddrUN = reinterpret_cast<sockaddr_un &>(SockAddr);
-      if (AddressFamilyPtr) {
-        *AddressFamilyPtr = __WASI_ADDRESS_FAMILY_AF_UNIX;
-      }
-      if (Address.size() >= sizeof(sockaddr_un::sun_path)) {
-        std::memcpy(Address.data(), &SockAddrUN.sun_path,
-                    sizeof(sockaddr_un::sun_path));
-      } else {
-        return WasiUnexpect(__WASI_ERRNO_INVAL);
-      }
-      break;
-    }
-    default:
-      return WasiUnexpect(__WASI_ERRNO_NOSYS);
+    if (auto Res = fromSockAddr(SockAddr, AddressFamilyPtr, Address, PortPtr);
+        unlikely(!Res)) {
+      return WasiUnexpect(Res);
     }
   }
 
@@ -1204,6 +1547,120 @@ WasiExpect<void> INode::sockSendTo(Span<Span<const uint8_t>> SiData,
   return {};
 }
 
+WasiExpect<void> INode::sockRecvMmsg(Span<RecvMessage> Msgs,
+                                     __wasi_riflags_t RiFlags,
+                                     __wasi_size_t &NMsgs) const noexcept {
+  assuming(Msgs.size() <= kMmsgMax);
+  int SysRiFlags = MSG_WAITFORONE;
+  if (RiFlags & __WASI_RIFLAGS_RECV_PEEK) {
+    SysRiFlags |= MSG_PEEK;
+  }
+  if (RiFlags & __WASI_RIFLAGS_RECV_WAITALL) {
+    SysRiFlags |= MSG_WAITALL;
+  }
+
+  iovec SysIOVs[kIOVMax];
+  size_t SysIOVsSize = 0;
+  mmsghdr SysMsgs[kMmsgMax];
+  sockaddr_storage SockAddrs[kMmsgMax];
+  for (size_t I = 0; I < Msgs.size(); ++I) {
+    auto &Msg = Msgs[I];
+    auto &SysMsgHdr = SysMsgs[I].msg_hdr;
+    assuming(SysIOVsSize + Msg.Data.size() <= kIOVMax);
+    SysMsgHdr.msg_iov = SysIOVs + SysIOVsSize;
+    SysMsgHdr.msg_iovlen = Msg.Data.size();
+    for (auto &IOV : Msg.Data) {
+      SysIOVs[SysIOVsSize].iov_base = IOV.data();
+      SysIOVs[SysIOVsSize].iov_len = IOV.size();
+      ++SysIOVsSize;
+    }
+    if (!Msg.Address.empty()) {
+      SockAddrs[I] = {};
+      SysMsgHdr.msg_name = &SockAddrs[I];
+      SysMsgHdr.msg_namelen = sizeof(SockAddrs[I]);
+    } else {
+      SysMsgHdr.msg_name = nullptr;
+      SysMsgHdr.msg_namelen = 0;
+    }
+    SysMsgHdr.msg_control = nullptr;
+    SysMsgHdr.msg_controllen = 0;
+    SysMsgHdr.msg_flags = 0;
+    SysMsgs[I].msg_len = 0;
+  }
+
+  const int Res = ::recvmmsg(Fd, SysMsgs, static_cast<unsigned>(Msgs.size()),
+                             SysRiFlags, nullptr);
+  if (unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  for (int I = 0; I < Res; ++I) {
+    auto &Msg = Msgs[I];
+    Msg.Size = static_cast<__wasi_size_t>(SysMsgs[I].msg_len);
+    Msg.RoFlags = static_cast<__wasi_roflags_t>(0);
+    if (SysMsgs[I].msg_hdr.msg_flags & MSG_TRUNC) {
+      Msg.RoFlags |= __WASI_ROFLAGS_RECV_DATA_TRUNCATED;
+    }
+    // The datagrams are already consumed, so an address which cannot be
+    // converted is reported as unspecified instead of failing the batch.
+    if (!Msg.Address.empty()) {
+      if (auto Ret = fromSockAddr(SockAddrs[I], &Msg.AddressFamily,
+                                  Msg.Address, &Msg.Port);
+          unlikely(!Ret)) {
+        Msg.AddressFamily = __WASI_ADDRESS_FAMILY_UNSPEC;
+        Msg.Port = 0;
+        std::fill(Msg.Address.begin(), Msg.Address.end(), uint8_t(0));
+      }
+    }
+  }
+  NMsgs = static_cast<__wasi_size_t>(Res);
+  return {};
+}
+
+WasiExpect<void> INode::sockSendMmsg(Span<SendMessage> Msgs,
+                                     __wasi_siflags_t,
+                                     __wasi_size_t &NMsgs) const noexcept {
+  assuming(Msgs.size() <= kMmsgMax);
+  iovec SysIOVs[kIOVMax];
+  size_t SysIOVsSize = 0;
+  mmsghdr SysMsgs[kMmsgMax];
+  VarAddrT AddressBuffers[kMmsgMax];
+  for (size_t I = 0; I < Msgs.size(); ++I) {
+    auto &Msg = Msgs[I];
+    auto &SysMsgHdr = SysMsgs[I].msg_hdr;
+    assuming(SysIOVsSize + Msg.Data.size() <= kIOVMax);
+    SysMsgHdr.msg_iov = SysIOVs + SysIOVsSize;
+    SysMsgHdr.msg_iovlen = Msg.Data.size();
+    for (auto &IOV : Msg.Data) {
+      SysIOVs[SysIOVsSize].iov_base = const_cast<uint8_t *>(IOV.data());
+      SysIOVs[SysIOVsSize].iov_len = IOV.size();
+      ++SysIOVsSize;
+    }
+    SysMsgHdr.msg_name = nullptr;
+    SysMsgHdr.msg_namelen = 0;
+    if (!Msg.Address.empty()) {
+      AddressBuffers[I] =
+          sockAddressAssignHelper(Msg.AddressFamily, Msg.Address, Msg.Port);
+      SysMsgHdr.msg_name = std::visit(VarAddrBuf(), AddressBuffers[I]);
+      SysMsgHdr.msg_namelen = std::visit(VarAddrSize(), AddressBuffers[I]);
+    }
+    SysMsgHdr.msg_control = nullptr;
+    SysMsgHdr.msg_controllen = 0;
+    SysMsgHdr.msg_flags = 0;
+    SysMsgs[I].msg_len = 0;
+  }
+
+  const int Res = ::sendmmsg(Fd, SysMsgs, static_cast<unsigned>(Msgs.size()),
+                             MSG_NOSIGNAL);
+  if (unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  for (int I = 0; I < Res; ++I) {
+    Msgs[I].Size = static_cast<__wasi_size_t>(SysMsgs[I].msg_len);
+  }
+  NMsgs = static_cast<__wasi_size_t>(Res);
+  return {};
+}
+
 WasiExpect<void> INode::sockShutdown(__wasi_sdflags_t SdFlags) const noexcept {
   int SysFlags = 0;
   if (SdFlags == __WASI_SDFLAGS_RD) {
@@ -1431,6 +1888,19 @@ bool INode::canBrowse() const noexcept {
   return ::faccessat(Fd, ".", X_OK, 0) == 0;
 }
 
+WasiExpect<bool> INode::isReady(__wasi_eventtype_t Type) const noexcept {
+  struct pollfd PollFd;
+  PollFd.fd = Fd;
+  PollFd.events = Type == __WASI_EVENTTYPE_FD_WRITE ? POLLOUT : POLLIN;
+  PollFd.revents = 0;
+  if (auto Res = ::poll(&PollFd, 1, 0); unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    // Errors and hangups are also reported by the blocking calls at once.
+    return Res > 0;
+  }
+}
+
 WasiExpect<void> INode::updateStat() const noexcept {
   Stat.emplace();
   if (unlikely(::fstat(Fd, &*Stat) != 0)) {
@@ -1646,6 +2116,9 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
 
     Iter->second.ReadEvent = &Event;
     assuming(Added);
+    if (UseUring) {
+      return;
+    }
 
     epoll_event EPollEvent;
     EPollEvent.events = EPOLLIN;
@@ -1676,7 +2149,16 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
 
 void Poller::close(const INode &Node) noexcept {
   FdDatas.erase(Node.Fd);
-  OldFdDatas.erase(Node.Fd);
+  Registered.erase(Node.Fd);
+}
+
+void Poller::useUring(bool Enable) noexcept {
+  if (Enable && !Ring.ok()) {
+    // Enough entries for most of the polls to be submitted in a batch. Keep
+    // using epoll if failed.
+    [[maybe_unused]] auto Res = Ring.create(64);
+  }
+  UseUring = Enable && Ring.ok();
 }
 
 void Poller::read(const INode &Node, TriggerType Trigger,
@@ -1690,45 +2172,14 @@ void Poller::read(const INode &Node, TriggerType Trigger,
   assuming(Node.Fd != Fd);
   try {
     auto [Iter, Added] = FdDatas.try_emplace(Node.Fd);
-    const bool New = OldFdDatas.find(Node.Fd) == OldFdDatas.end();
-
     if (unlikely(!Added && Iter->second.ReadEvent != nullptr)) {
       Event.Valid = true;
       Event.error = __WASI_ERRNO_EXIST;
       return;
     }
     Iter->second.ReadEvent = &Event;
-
-    epoll_event EPollEvent;
-    EPollEvent.events = EPOLLIN;
-    if (!Added) {
-      assuming(Iter->second.WriteEvent != nullptr);
-      EPollEvent.events |= EPOLLOUT;
-    }
-    if (Trigger == TriggerType::Edge) {
-      EPollEvent.events |= EPOLLET;
-    }
-#if defined(EPOLLRDHUP)
-    EPollEvent.events |= EPOLLRDHUP;
-#endif
-    EPollEvent.data.fd = Node.Fd;
-
-    if (likely(Added) && New) {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_ADD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        FdDatas.erase(Iter);
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    } else {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_MOD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    }
+    Iter->second.Node = &Node;
+    Iter->second.Edge = Trigger == TriggerType::Edge;
   } catch (std::bad_alloc &) {
     Event.Valid = true;
     Event.error = __WASI_ERRNO_NOMEM;
@@ -1747,45 +2198,14 @@ void Poller::write(const INode &Node, TriggerType Trigger,
   assuming(Node.Fd != Fd);
   try {
     auto [Iter, Added] = FdDatas.try_emplace(Node.Fd);
-    const bool New = OldFdDatas.find(Node.Fd) == OldFdDatas.end();
-
     if (unlikely(!Added && Iter->second.WriteEvent != nullptr)) {
       Event.Valid = true;
       Event.error = __WASI_ERRNO_EXIST;
       return;
     }
     Iter->second.WriteEvent = &Event;
-
-    epoll_event EPollEvent;
-    EPollEvent.events = EPOLLOUT;
-    if (!Added) {
-      assuming(Iter->second.ReadEvent != nullptr);
-      EPollEvent.events |= EPOLLIN;
-    }
-    if (Trigger == TriggerType::Edge) {
-      EPollEvent.events |= EPOLLET;
-    }
-#if defined(EPOLLRDHUP)
-    EPollEvent.events |= EPOLLRDHUP;
-#endif
-    EPollEvent.data.fd = Node.Fd;
-
-    if (likely(Added) && New) {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_ADD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        FdDatas.erase(Iter);
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    } else {
-      if (auto Res = ::epoll_ctl(Fd, EPOLL_CTL_MOD, Node.Fd, &EPollEvent);
-          unlikely(Res < 0)) {
-        Event.Valid = true;
-        Event.error = fromErrNo(errno);
-        return;
-      }
-    }
+    Iter->second.Node = &Node;
+    Iter->second.Edge = Trigger == TriggerType::Edge;
   } catch (std::bad_alloc &) {
     Event.Valid = true;
     Event.error = __WASI_ERRNO_NOMEM;
@@ -1794,13 +2214,26 @@ void Poller::write(const INode &Node, TriggerType Trigger,
 }
 
 void Poller::wait() noexcept {
-  for (const auto &[NodeFd, FdData] : OldFdDatas) {
-    if (auto Iter = FdDatas.find(NodeFd); Iter == FdDatas.end()) {
+  if (UseUring) {
+    waitUring();
+    return;
+  }
+
+  for (auto Iter = Registered.begin(); Iter != Registered.end();) {
+    if (FdDatas.find(Iter->first) == FdDatas.end()) {
       // Remove unused event, ignore failed.
       // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
       // `this` as the dummy parameter.
-      ::epoll_ctl(Fd, EPOLL_CTL_DEL, NodeFd,
+      ::epoll_ctl(Fd, EPOLL_CTL_DEL, Iter->first,
                   reinterpret_cast<struct epoll_event *>(this));
+      Iter = Registered.erase(Iter);
+    } else {
+      ++Iter;
+    }
+  }
+  for (const auto &[NodeFd, FdData] : FdDatas) {
+    if (FdData.Node) {
+      update(NodeFd, FdData);
     }
   }
 
@@ -1816,6 +2249,87 @@ void Poller::wait() noexcept {
     return;
   }
 
+  for (int I = 0; I < Count; ++I) {
+    dispatch(EPollEvents[I]);
+    if (auto Iter = Registered.find(EPollEvents[I].data.fd);
+        Iter != Registered.end() && (Iter->second.Events & EPOLLET)) {
+      Iter->second.Rearm = true;
+    }
+  }
+  for (auto &Timer : Timers) {
+    // Remove unused timer event, ignore failed.
+    // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
+    // `this` as the dummy parameter.
+    ::epoll_ctl(Fd, EPOLL_CTL_DEL, Timer.Fd,
+                reinterpret_cast<struct epoll_event *>(this));
+    Registered.erase(Timer.Fd);
+    Ctx->releaseTimer(std::move(Timer));
+  }
+
+  FdDatas.clear();
+  Timers.clear();
+  EPollEvents.clear();
+}
+
+void Poller::update(int NodeFd, const FdData &Data) noexcept {
+  uint32_t Mask = 0;
+  if (Data.ReadEvent) {
+    Mask |= EPOLLIN;
+  }
+  if (Data.WriteEvent) {
+    Mask |= EPOLLOUT;
+  }
+  if (Data.Edge) {
+    Mask |= EPOLLET;
+  }
+#if defined(EPOLLRDHUP)
+  Mask |= EPOLLRDHUP;
+#endif
+
+  auto Fail = [&Data](__wasi_errno_t Error) noexcept {
+    for (auto *Event : {Data.ReadEvent, Data.WriteEvent}) {
+      if (Event) {
+        Event->Valid = true;
+        Event->error = Error;
+      }
+    }
+  };
+  decltype(Registered)::iterator Iter;
+  bool Added;
+  try {
+    std::tie(Iter, Added) = Registered.try_emplace(NodeFd);
+  } catch (std::bad_alloc &) {
+    Fail(__WASI_ERRNO_NOMEM);
+    return;
+  }
+  auto &Reg = Iter->second;
+  if (!Added && Reg.Serial == Data.Node->Serial && Reg.Events == Mask &&
+      !Reg.Rearm) {
+    return;
+  }
+
+  epoll_event EPollEvent;
+  EPollEvent.events = Mask;
+  EPollEvent.data.fd = NodeFd;
+  // The registration may be stale if the fd was closed and reused behind the
+  // poller, so retry with the other operation.
+  const int Op = Added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  auto Res = ::epoll_ctl(Fd, Op, NodeFd, &EPollEvent);
+  if (Res < 0 && errno == (Added ? EEXIST : ENOENT)) {
+    Res = ::epoll_ctl(Fd, Added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, NodeFd,
+                      &EPollEvent);
+  }
+  if (unlikely(Res < 0)) {
+    Fail(fromErrNo(errno));
+    Registered.erase(Iter);
+    return;
+  }
+  Reg.Serial = Data.Node->Serial;
+  Reg.Events = Mask;
+  Reg.Rearm = false;
+}
+
+void Poller::dispatch(const struct epoll_event &EPollEvent) noexcept {
   auto ProcessEvent = [](const struct epoll_event &EPollEvent,
                          OptionalEvent &Event) noexcept {
     Event.Valid = true;
@@ -1869,39 +2383,122 @@ void Poller::wait() noexcept {
     }
   };
 
-  for (int I = 0; I < Count; ++I) {
-    const auto &EPollEvent = EPollEvents[I];
-    const auto Iter = FdDatas.find(EPollEvent.data.fd);
-    assuming(Iter != FdDatas.end());
+  const auto Iter = FdDatas.find(EPollEvent.data.fd);
+  assuming(Iter != FdDatas.end());
+
+  const bool NoInOut = !(EPollEvent.events & (EPOLLIN | EPOLLOUT));
+  if ((EPollEvent.events & EPOLLIN) ||
+      (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.ReadEvent)) {
+    assuming(Iter->second.ReadEvent);
+    assuming(Iter->second.ReadEvent->type == __WASI_EVENTTYPE_CLOCK ||
+             Iter->second.ReadEvent->type == __WASI_EVENTTYPE_FD_READ);
+    ProcessEvent(EPollEvent, *Iter->second.ReadEvent);
+  }
+  if (EPollEvent.events & EPOLLOUT ||
+      (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.WriteEvent)) {
+    assuming(Iter->second.WriteEvent);
+    assuming(Iter->second.WriteEvent->type == __WASI_EVENTTYPE_FD_WRITE);
+    ProcessEvent(EPollEvent, *Iter->second.WriteEvent);
+  }
+}
+
+void Poller::waitUring() noexcept {
+  // Drop the fds registered in epoll by the previous waits.
+  for (const auto &[NodeFd, Reg] : Registered) {
+    ::epoll_ctl(Fd, EPOLL_CTL_DEL, NodeFd,
+                reinterpret_cast<struct epoll_event *>(this));
+  }
+  Registered.clear();
+
+  // Submit the one-shot polls of all the fds in a batch.
+  uint32_t Pending = 0;
+  __wasi_errno_t Error = __WASI_ERRNO_SUCCESS;
+  for (const auto &[NodeFd, FdData] : FdDatas) {
+    uint32_t Mask = 0;
+    if (FdData.ReadEvent) {
+      Mask |= EPOLLIN;
+#if defined(EPOLLRDHUP)
+      Mask |= EPOLLRDHUP;
+#endif
+    }
+    if (FdData.WriteEvent) {
+      Mask |= EPOLLOUT;
+    }
+    if (auto Res = Ring.pollAdd(NodeFd, Mask, static_cast<uint64_t>(NodeFd));
+        unlikely(!Res)) {
+      Error = Res.error();
+      break;
+    }
+    ++Pending;
+  }
+  if (Pending > 0) {
+    if (auto Res = Ring.submit(Error == __WASI_ERRNO_SUCCESS ? 1 : 0);
+        unlikely(!Res)) {
+      Error = Res.error();
+    }
+  }
 
-    const bool NoInOut = !(EPollEvent.events & (EPOLLIN | EPOLLOUT));
-    if ((EPollEvent.events & EPOLLIN) ||
-        (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.ReadEvent)) {
-      assuming(Iter->second.ReadEvent);
-      assuming(Iter->second.ReadEvent->type == __WASI_EVENTTYPE_CLOCK ||
-               Iter->second.ReadEvent->type == __WASI_EVENTTYPE_FD_READ);
-      ProcessEvent(EPollEvent, *Iter->second.ReadEvent);
+  auto Reap = [this, &Pending]() noexcept {
+    uint64_t UserData;
+    int32_t Result;
+    while (Ring.pop(UserData, Result)) {
+      if (UserData == UINT64_MAX) {
+        // Completion of the poll removal.
+        continue;
+      }
+      --Pending;
+      if (Result >= 0) {
+        struct epoll_event EPollEvent;
+        EPollEvent.events = static_cast<uint32_t>(Result);
+        EPollEvent.data.fd = static_cast<int>(UserData);
+        dispatch(EPollEvent);
+      } else if (Result != -ECANCELED) {
+        const auto Iter = FdDatas.find(static_cast<int>(UserData));
+        assuming(Iter != FdDatas.end());
+        for (auto *Event : {Iter->second.ReadEvent, Iter->second.WriteEvent}) {
+          if (Event) {
+            Event->Valid = true;
+            Event->error = fromErrNo(-Result);
+          }
+        }
+      }
+    }
+  };
+  Reap();
+
+  if (unlikely(Error != __WASI_ERRNO_SUCCESS)) {
+    for (auto &Event : Events) {
+      if (!Event.Valid) {
+        Event.Valid = true;
+        Event.error = Error;
+      }
+    }
+  }
+
+  // Cancel the polls not triggered, and wait for all of them to complete so
+  // that no stale completion is left in the ring.
+  if (Pending > 0) {
+    for (const auto &[NodeFd, FdData] : FdDatas) {
+      // Failures are handled by the following submission.
+      [[maybe_unused]] auto Res =
+          Ring.pollRemove(static_cast<uint64_t>(NodeFd));
     }
-    if (EPollEvent.events & EPOLLOUT ||
-        (NoInOut && EPollEvent.events & EPOLLHUP && Iter->second.WriteEvent)) {
-      assuming(Iter->second.WriteEvent);
-      assuming(Iter->second.WriteEvent->type == __WASI_EVENTTYPE_FD_WRITE);
-      ProcessEvent(EPollEvent, *Iter->second.WriteEvent);
+    while (Pending > 0) {
+      if (auto Res = Ring.submit(1); unlikely(!Res)) {
+        // The ring is unusable. Fall back to epoll for the next waits.
+        Ring = UringHolder();
+        UseUring = false;
+        break;
+      }
+      Reap();
     }
   }
+
   for (auto &Timer : Timers) {
-    // Remove unused timer event, ignore failed.
-    // In kernel before 2.6.9, EPOLL_CTL_DEL required a non-null pointer. Use
-    // `this` as the dummy parameter.
-    ::epoll_ctl(Fd, EPOLL_CTL_DEL, Timer.Fd,
-                reinterpret_cast<struct epoll_event *>(this));
     Ctx->releaseTimer(std::move(Timer));
   }
-
-  std::swap(FdDatas, OldFdDatas);
   FdDatas.clear();
   Timers.clear();
-  EPollEvents.clear();
 }
 
 void Poller::reset() noexcept {
@@ -1911,6 +2508,62 @@ void Poller::reset() noexcept {
 
 bool Poller::ok() noexcept { return FdHolder::ok(); }
 
+WasiExpect<Watcher> Watcher::create() noexcept {
+  if (auto NewFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      unlikely(NewFd < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    return Watcher(NewFd);
+  }
+}
+
+WasiExpect<int32_t> Watcher::add(const INode &Dir) noexcept {
+  // inotify only watches paths, so watch the directory through procfs.
+  const std::string Path = "/proc/self/fd/" + std::to_string(Dir.Fd);
+  if (auto Id = ::inotify_add_watch(Fd, Path.c_str(),
+                                    IN_ATTRIB | IN_DELETE | IN_DELETE_SELF |
+                                        IN_MOVE_SELF | IN_MOVED_FROM |
+                                        IN_MOVED_TO | IN_ONLYDIR);
+      unlikely(Id < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    return Id;
+  }
+}
+
+void Watcher::remove(int32_t Id) noexcept { ::inotify_rm_watch(Fd, Id); }
+
+WasiExpect<void> Watcher::read(std::vector<Event> &Events) noexcept {
+  alignas(struct inotify_event) std::array<char, 4096> Buffer;
+  while (true) {
+    const auto Size = ::read(Fd, Buffer.data(), Buffer.size());
+    if (Size < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return {};
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      return WasiUnexpect(fromErrNo(errno));
+    }
+    for (ssize_t Offset = 0; Offset < Size;) {
+      const auto &E =
+          *reinterpret_cast<const struct inotify_event *>(&Buffer[Offset]);
+      Offset += sizeof(struct inotify_event) + E.len;
+      if (E.mask & IN_Q_OVERFLOW) {
+        Events.push_back({-1, {}});
+      } else if (E.mask & IN_IGNORED) {
+        // The watch is removed, and the directory changes are reported by the
+        // preceding events.
+      } else if (E.len == 0) {
+        Events.push_back({E.wd, {}});
+      } else {
+        Events.push_back({E.wd, std::string(E.name)});
+      }
+    }
+  }
+}
+
 } // namespace WASI
 } // namespace Host
 } // namespace WasmEdge
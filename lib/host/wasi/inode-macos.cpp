@@ -569,6 +569,11 @@ WasiExpect<void> INode::fdWrite(Span<Span<const uint8_t>> IOVs,
   return {};
 }
 
+WasiExpect<void> INode::fdSendfile(const INode &, __wasi_filesize_t,
+                                   __wasi_filesize_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<uint64_t> INode::getNativeHandler() const noexcept {
   return static_cast<uint64_t>(Fd);
 }
@@ -602,6 +607,12 @@ INode::pathFilestatGet(std::string Path,
   return {};
 }
 
+WasiExpect<void>
+INode::pathFilestatGetBeneath(std::string, bool,
+                              __wasi_filestat_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void>
 INode::pathFilestatSetTimes(std::string Path, __wasi_timestamp_t ATim,
                             __wasi_timestamp_t MTim,
@@ -715,6 +726,12 @@ WasiExpect<INode> INode::pathOpen(std::string Path, __wasi_oflags_t OpenFlags,
   }
 }
 
+WasiExpect<INode> INode::pathOpenBeneath(std::string, __wasi_oflags_t,
+                                         __wasi_fdflags_t, VFS::Flags,
+                                         bool) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void> INode::pathReadlink(std::string Path, Span<char> Buffer,
                                      __wasi_size_t &NRead) const noexcept {
   if (auto Res = ::readlinkat(Fd, Path.c_str(), Buffer.data(), Buffer.size());
@@ -953,6 +970,16 @@ WasiExpect<void> INode::sockBind(__wasi_address_family_t AddressFamily,
   return {};
 }
 
+WasiExpect<void> INode::sockSetReusePort() noexcept {
+  const int Enable = 1;
+  if (auto Res = ::setsockopt(Fd, SOL_SOCKET, SO_REUSEPORT, &Enable,
+                              sizeof(Enable));
+      unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  }
+  return {};
+}
+
 WasiExpect<void> INode::sockListen(int32_t Backlog) noexcept {
   if (auto Res = ::listen(Fd, Backlog); unlikely(Res < 0)) {
     return WasiUnexpect(fromErrNo(errno));
@@ -1158,6 +1185,16 @@ WasiExpect<void> INode::sockSendTo(Span<Span<const uint8_t>> SiData,
   return {};
 }
 
+WasiExpect<void> INode::sockRecvMmsg(Span<RecvMessage>, __wasi_riflags_t,
+                                     __wasi_size_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+WasiExpect<void> INode::sockSendMmsg(Span<SendMessage>, __wasi_siflags_t,
+                                     __wasi_size_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void> INode::sockShutdown(__wasi_sdflags_t SdFlags) const noexcept {
   int SysFlags = 0;
   if (SdFlags == __WASI_SDFLAGS_RD) {
@@ -1384,6 +1421,19 @@ bool INode::canBrowse() const noexcept {
   return ::faccessat(Fd, ".", X_OK, 0) == 0;
 }
 
+WasiExpect<bool> INode::isReady(__wasi_eventtype_t Type) const noexcept {
+  struct pollfd PollFd;
+  PollFd.fd = Fd;
+  PollFd.events = Type == __WASI_EVENTTYPE_FD_WRITE ? POLLOUT : POLLIN;
+  PollFd.revents = 0;
+  if (auto Res = ::poll(&PollFd, 1, 0); unlikely(Res < 0)) {
+    return WasiUnexpect(fromErrNo(errno));
+  } else {
+    // Errors and hangups are also reported by the blocking calls at once.
+    return Res > 0;
+  }
+}
+
 WasiExpect<void> INode::updateStat() const noexcept {
   Stat.emplace();
   if (unlikely(::fstat(Fd, &*Stat) != 0)) {
@@ -1470,6 +1520,8 @@ void Poller::clock(__wasi_clockid_t ClockId, __wasi_timestamp_t Timeout,
 
 void Poller::close(const INode &) noexcept {}
 
+void Poller::useUring(bool) noexcept {}
+
 void Poller::read(const INode &Node, TriggerType Trigger,
                   __wasi_userdata_t UserData) noexcept {
   assuming(Events.size() < WasiEvents.size());
@@ -1679,6 +1731,20 @@ void Poller::reset() noexcept {
 
 bool Poller::ok() noexcept { return FdHolder::ok(); }
 
+WasiExpect<Watcher> Watcher::create() noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+WasiExpect<int32_t> Watcher::add(const INode &) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+void Watcher::remove(int32_t) noexcept {}
+
+WasiExpect<void> Watcher::read(std::vector<Event> &) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 } // namespace WASI
 } // namespace Host
 } // namespace WasmEdge
@@ -12,7 +12,9 @@
 #include "host/wasi/vfs.h"
 #include "win.h"
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <limits>
 #include <new>
 #include <numeric>
 #include <vector>
@@ -1215,6 +1217,11 @@ WasiExpect<void> INode::fdWrite(Span<Span<const uint8_t>> IOVs,
   return Result;
 }
 
+WasiExpect<void> INode::fdSendfile(const INode &, __wasi_filesize_t,
+                                   __wasi_filesize_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<uint64_t> INode::getNativeHandler() const noexcept {
   return reinterpret_cast<uint64_t>(Handle);
 }
@@ -1244,6 +1251,12 @@ INode::pathFilestatGet(std::string Path,
   return File.filestatGet(FileStat);
 }
 
+WasiExpect<void>
+INode::pathFilestatGetBeneath(std::string, bool,
+                              __wasi_filestat_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void>
 INode::pathFilestatSetTimes(std::string Path, __wasi_timestamp_t ATim,
                             __wasi_timestamp_t MTim,
@@ -1341,6 +1354,12 @@ WasiExpect<INode> INode::pathOpen(std::string Path, __wasi_oflags_t OpenFlags,
   return Result;
 }
 
+WasiExpect<INode> INode::pathOpenBeneath(std::string, __wasi_oflags_t,
+                                         __wasi_fdflags_t, VFS::Flags,
+                                         bool) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void> INode::pathReadlink(std::string Path, Span<char> Buffer,
                                      __wasi_size_t &NRead) const noexcept {
   EXPECTED_TRY(auto FullPath, getRelativePath(Handle, Path));
@@ -1640,6 +1659,11 @@ WasiExpect<void> INode::sockBind(__wasi_address_family_t AddressFamily,
   return {};
 }
 
+WasiExpect<void> INode::sockSetReusePort() noexcept {
+  // The worker processes are not supported on Windows.
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void> INode::sockListen(int32_t Backlog) noexcept {
   EXPECTED_TRY(detail::ensureWSAStartup());
 
@@ -1924,6 +1948,16 @@ WasiExpect<void> INode::sockSendTo(Span<Span<const uint8_t>> SiData,
   return {};
 }
 
+WasiExpect<void> INode::sockRecvMmsg(Span<RecvMessage>, __wasi_riflags_t,
+                                     __wasi_size_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+WasiExpect<void> INode::sockSendMmsg(Span<SendMessage>, __wasi_siflags_t,
+                                     __wasi_size_t &) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 WasiExpect<void> INode::sockShutdown(__wasi_sdflags_t SdFlags) const noexcept {
   EXPECTED_TRY(detail::ensureWSAStartup());
 
@@ -2179,12 +2213,17 @@ WasiExpect<__wasi_filesize_t> INode::filesize() const noexcept {
 
 bool INode::canBrowse() const noexcept { return SavedVFSFlags & VFS::Read; }
 
+WasiExpect<bool> INode::isReady(__wasi_eventtype_t) const noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 Poller::Poller(PollerContext &C) noexcept : Ctx(&C) {}
 
 WasiExpect<void> Poller::prepare(Span<__wasi_event_t> E) noexcept {
   WasiEvents = E;
   try {
     Events.reserve(E.size());
+    PollFds.reserve(E.size());
   } catch (std::bad_alloc &) {
     return WasiUnexpect(__WASI_ERRNO_NOMEM);
   }
@@ -2234,10 +2273,12 @@ void Poller::clock(__wasi_clockid_t Clock, __wasi_timestamp_t Timeout,
 
 void Poller::close(const INode &) noexcept {}
 
+void Poller::useUring(bool) noexcept {}
+
 void Poller::read(const INode &Node, TriggerType Trigger,
                   __wasi_userdata_t UserData) noexcept {
   if (Node.Type == HandleHolder::HandleType::StdHandle) {
-    if (ReadFds.fd_count > 0 || WriteFds.fd_count > 0) {
+    if (!PollFds.empty()) {
       // Cannot wait on socket and console at the same time
       error(UserData, __WASI_ERRNO_NOSYS, __WASI_EVENTTYPE_FD_READ);
       return;
@@ -2273,45 +2314,19 @@ void Poller::read(const INode &Node, TriggerType Trigger,
     error(UserData, __WASI_ERRNO_NOSYS, __WASI_EVENTTYPE_FD_READ);
     return;
   }
-  if (ReadFds.fd_count == FD_SETSIZE_) {
-    error(UserData, __WASI_ERRNO_NOMEM, __WASI_EVENTTYPE_FD_READ);
-    return;
-  }
 
   assuming(Events.size() < WasiEvents.size());
   auto &Event = Events.emplace_back();
   Event.Valid = false;
   Event.userdata = UserData;
   Event.type = __WASI_EVENTTYPE_FD_READ;
-
-  if (ReadFds.fd_count == FD_SETSIZE_) {
-    Event.Valid = true;
-    Event.error = __WASI_ERRNO_NOMEM;
-    return;
-  }
-
-  try {
-    auto [Iter, Added] = SocketDatas.try_emplace(Node.Socket);
-
-    if (unlikely(!Added && Iter->second.ReadEvent != nullptr)) {
-      Event.Valid = true;
-      Event.error = __WASI_ERRNO_EXIST;
-      return;
-    }
-
-    Iter->second.ReadEvent = &Event;
-    ReadFds.fd_array[ReadFds.fd_count++] = Node.Socket;
-  } catch (std::bad_alloc &) {
-    Event.Valid = true;
-    Event.error = __WASI_ERRNO_NOMEM;
-    return;
-  }
+  subscribe(Node.Socket, Event, POLLRDNORM);
 }
 
 void Poller::write(const INode &Node, TriggerType Trigger,
                    __wasi_userdata_t UserData) noexcept {
   if (Node.Type == HandleHolder::HandleType::StdHandle) {
-    if (ReadFds.fd_count > 0 || WriteFds.fd_count > 0) {
+    if (!PollFds.empty()) {
       // Cannot wait on socket and console at the same time
       error(UserData, __WASI_ERRNO_NOSYS, __WASI_EVENTTYPE_FD_WRITE);
       return;
@@ -2346,28 +2361,33 @@ void Poller::write(const INode &Node, TriggerType Trigger,
     error(UserData, __WASI_ERRNO_NOSYS, __WASI_EVENTTYPE_FD_WRITE);
     return;
   }
-  if (WriteFds.fd_count == FD_SETSIZE_) {
-    error(UserData, __WASI_ERRNO_NOMEM, __WASI_EVENTTYPE_FD_WRITE);
-    return;
-  }
 
   assuming(Events.size() < WasiEvents.size());
   auto &Event = Events.emplace_back();
   Event.Valid = false;
   Event.userdata = UserData;
   Event.type = __WASI_EVENTTYPE_FD_WRITE;
+  subscribe(Node.Socket, Event, POLLWRNORM);
+}
 
+void Poller::subscribe(SOCKET_ Socket, OptionalEvent &Event,
+                       SHORT_ Flags) noexcept {
   try {
-    auto [Iter, Added] = SocketDatas.try_emplace(Node.Socket);
-
-    if (unlikely(!Added && Iter->second.WriteEvent != nullptr)) {
+    auto [Iter, Added] = SocketDatas.try_emplace(Socket);
+    auto &Slot = Flags == POLLRDNORM ? Iter->second.ReadEvent
+                                     : Iter->second.WriteEvent;
+    if (unlikely(!Added && Slot != nullptr)) {
       Event.Valid = true;
       Event.error = __WASI_ERRNO_EXIST;
       return;
     }
-
-    Iter->second.WriteEvent = &Event;
-    WriteFds.fd_array[WriteFds.fd_count++] = Node.Socket;
+    if (Added) {
+      // Never reallocates, as reserved for all the events in `prepare`.
+      Iter->second.Index = PollFds.size();
+      PollFds.push_back({Socket, 0, 0});
+    }
+    Slot = &Event;
+    PollFds[Iter->second.Index].events |= Flags;
   } catch (std::bad_alloc &) {
     Event.Valid = true;
     Event.error = __WASI_ERRNO_NOMEM;
@@ -2377,7 +2397,7 @@ void Poller::write(const INode &Node, TriggerType Trigger,
 
 void Poller::wait() noexcept {
   if (!ConsoleWriteEvent.empty()) {
-    assuming(ReadFds.fd_count == 0 && WriteFds.fd_count == 0);
+    assuming(PollFds.empty());
     // Console can always write
     for (const auto &[NodeHandle, Event] : ConsoleWriteEvent) {
       Event->Valid = true;
@@ -2389,7 +2409,7 @@ void Poller::wait() noexcept {
     return;
   }
   if (!ConsoleReadEvent.empty()) {
-    assuming(ReadFds.fd_count == 0 && WriteFds.fd_count == 0);
+    assuming(PollFds.empty());
     DWORD_ Timeout = INFINITE_;
     if (TimeoutEvent != nullptr) {
       const std::chrono::microseconds MicroSecs =
@@ -2436,52 +2456,84 @@ void Poller::wait() noexcept {
     TimeoutEvent = nullptr;
     return;
   }
-  if (const int Count =
-          select(0, &ReadFds, &WriteFds, nullptr,
-                 TimeoutEvent != nullptr ? &MinimumTimeout : nullptr);
-      Count == 0) {
+
+  INT_ Timeout = -1;
+  if (TimeoutEvent != nullptr) {
+    const auto MilliSecs =
+        std::chrono::ceil<std::chrono::milliseconds>(
+            std::chrono::seconds(MinimumTimeout.tv_sec) +
+            std::chrono::microseconds(MinimumTimeout.tv_usec))
+            .count();
+    Timeout = static_cast<INT_>(
+        std::min<int64_t>(MilliSecs, std::numeric_limits<INT_>::max()));
+  }
+  if (PollFds.empty()) {
+    // `WSAPoll` rejects an empty set.
     if (TimeoutEvent) {
+      Sleep(static_cast<DWORD_>(Timeout));
       TimeoutEvent->Valid = true;
       TimeoutEvent->error = __WASI_ERRNO_SUCCESS;
     }
+  } else if (const int Count = WSAPoll(
+                 PollFds.data(), static_cast<ULONG_>(PollFds.size()), Timeout);
+             Count == 0) {
+    if (TimeoutEvent) {
+      TimeoutEvent->Valid = true;
+      TimeoutEvent->error = __WASI_ERRNO_SUCCESS;
+    }
+  } else if (unlikely(Count < 0)) {
+    const auto Error = detail::fromWSALastError();
+    for (const auto &[Socket, Data] : SocketDatas) {
+      for (auto *Event : {Data.ReadEvent, Data.WriteEvent}) {
+        if (Event) {
+          Event->Valid = true;
+          Event->error = Error;
+        }
+      }
+    }
   } else {
-    for (const auto Socket :
-         Span<const SOCKET_>(ReadFds.fd_array, ReadFds.fd_count)) {
-      const auto Iter = SocketDatas.find(Socket);
+    for (const auto &PollFd : PollFds) {
+      if (PollFd.revents == 0) {
+        continue;
+      }
+      const auto Iter = SocketDatas.find(PollFd.fd);
       assuming(Iter != SocketDatas.end());
-      assuming(Iter->second.ReadEvent);
-      auto &Event = *Iter->second.ReadEvent;
-      assuming(Event.type == __WASI_EVENTTYPE_FD_READ);
-      Event.Valid = true;
-      Event.error = __WASI_ERRNO_SUCCESS;
-
-      bool UnknownNBytes = false;
-      u_long ReadBufUsed = 0;
-      if (auto Res = ioctlsocket(Socket, FIONREAD, &ReadBufUsed);
-          unlikely(Res == 0)) {
-        UnknownNBytes = true;
+      // The errors and the hang-ups are reported to both of the events, as
+      // the following calls fail at once.
+      const SHORT_ Failed = POLLERR | POLLHUP | POLLNVAL;
+      if (auto *Event = Iter->second.ReadEvent;
+          Event && (PollFd.revents & (POLLRDNORM | Failed))) {
+        assuming(Event->type == __WASI_EVENTTYPE_FD_READ);
+        Event->Valid = true;
+        Event->error = __WASI_ERRNO_SUCCESS;
+
+        u_long ReadBufUsed = 0;
+        if (auto Res = ioctlsocket(PollFd.fd, FIONREAD, &ReadBufUsed);
+            unlikely(Res != 0) || ReadBufUsed == 0) {
+          Event->fd_readwrite.nbytes = 1;
+        } else {
+          Event->fd_readwrite.nbytes = ReadBufUsed;
+        }
+        Event->fd_readwrite.flags = static_cast<__wasi_eventrwflags_t>(0);
+        if (PollFd.revents & POLLHUP) {
+          Event->fd_readwrite.flags |= __WASI_EVENTRWFLAGS_FD_READWRITE_HANGUP;
+        }
       }
-      if (UnknownNBytes) {
-        Event.fd_readwrite.nbytes = 1;
-      } else {
-        Event.fd_readwrite.nbytes = ReadBufUsed;
+      if (auto *Event = Iter->second.WriteEvent;
+          Event && (PollFd.revents & (POLLWRNORM | Failed))) {
+        assuming(Event->type == __WASI_EVENTTYPE_FD_WRITE);
+        Event->Valid = true;
+        Event->error = __WASI_ERRNO_SUCCESS;
+        Event->fd_readwrite.nbytes = 1;
+        Event->fd_readwrite.flags = static_cast<__wasi_eventrwflags_t>(0);
+        if (PollFd.revents & POLLHUP) {
+          Event->fd_readwrite.flags |= __WASI_EVENTRWFLAGS_FD_READWRITE_HANGUP;
+        }
       }
     }
-    for (const auto Socket :
-         Span<const SOCKET_>(WriteFds.fd_array, WriteFds.fd_count)) {
-      const auto Iter = SocketDatas.find(Socket);
-      assuming(Iter != SocketDatas.end());
-      assuming(Iter->second.WriteEvent);
-      auto &Event = *Iter->second.WriteEvent;
-      assuming(Event.type == __WASI_EVENTTYPE_FD_WRITE);
-      Event.Valid = true;
-      Event.error = __WASI_ERRNO_SUCCESS;
-      Event.fd_readwrite.nbytes = 1;
-    }
   }
   SocketDatas.clear();
-  ReadFds.fd_count = 0;
-  WriteFds.fd_count = 0;
+  PollFds.clear();
   TimeoutEvent = nullptr;
 }
 
@@ -2492,6 +2544,20 @@ void Poller::reset() noexcept {
 
 bool Poller::ok() noexcept { return true; }
 
+WasiExpect<Watcher> Watcher::create() noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+WasiExpect<int32_t> Watcher::add(const INode &) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
+void Watcher::remove(int32_t) noexcept {}
+
+WasiExpect<void> Watcher::read(std::vector<Event> &) noexcept {
+  return WasiUnexpect(__WASI_ERRNO_NOSYS);
+}
+
 } // namespace WASI
 } // namespace Host
 } // namespace WasmEdge
@@ -20,9 +20,14 @@
 #include <ctime>
 #include <dirent.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <sched.h>
 #include <sys/epoll.h>
+#include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -55,6 +60,20 @@
 #include <sys/timerfd.h>
 #endif
 
+#if defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define WASMEDGE_WASI_HAS_URING 1
+#else
+#define WASMEDGE_WASI_HAS_URING 0
+#endif
+
+#if defined(__NR_openat2) && __has_include(<linux/openat2.h>)
+#include <linux/openat2.h>
+#define WASMEDGE_WASI_HAS_OPENAT2 1
+#else
+#define WASMEDGE_WASI_HAS_OPENAT2 0
+#endif
+
 namespace WasmEdge {
 namespace Host {
 namespace WASI {
@@ -18,6 +18,7 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <poll.h>
 #include <sys/event.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
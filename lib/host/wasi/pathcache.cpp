@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "host/wasi/pathcache.h"
+#include "common/defines.h"
+#include "host/wasi/vinode.h"
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+PathCache::PathCache(Watcher &&W, const VINode &R, int32_t WatchId) noexcept
+    : Watch(std::move(W)), Root(&R) {
+  Dirs.emplace(Root, Dir{nullptr, WatchId, nullptr, {}, {}});
+  Watches.emplace(WatchId, Root);
+}
+
+std::shared_ptr<PathCache> PathCache::create(const VINode &Root) noexcept {
+  auto W = Watcher::create();
+  if (unlikely(!W)) {
+    return nullptr;
+  }
+  auto WatchId = W->add(Root.Node);
+  if (unlikely(!WatchId)) {
+    return nullptr;
+  }
+  return std::shared_ptr<PathCache>(
+      new PathCache(std::move(*W), Root, *WatchId));
+}
+
+void PathCache::sync() noexcept {
+  std::unique_lock Lock(Mutex);
+  Events.clear();
+  if (auto Res = Watch.read(Events); unlikely(!Res)) {
+    erase(Root);
+    return;
+  }
+  std::vector<const VINode *> Changed;
+  for (const auto &Event : Events) {
+    if (Event.Id < 0) {
+      erase(Root);
+      return;
+    }
+    Changed.clear();
+    auto [Begin, End] = Watches.equal_range(Event.Id);
+    for (auto It = Begin; It != End; ++It) {
+      if (Event.Name.empty()) {
+        Changed.push_back(It->second);
+        continue;
+      }
+      const auto &Children = Dirs.at(It->second).Children;
+      if (auto Child = Children.find(Event.Name); Child != Children.end()) {
+        Changed.push_back(Child->second);
+      }
+    }
+    for (const VINode *Node : Changed) {
+      erase(Node);
+    }
+  }
+}
+
+std::shared_ptr<VINode> PathCache::find(const VINode &Parent,
+                                        std::string_view Name) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Dirs.find(&Parent); It != Dirs.end()) {
+    const auto &Children = It->second.Children;
+    if (auto Child = Children.find(Name); Child != Children.end()) {
+      return Dirs.at(Child->second).Node;
+    }
+  }
+  return nullptr;
+}
+
+void PathCache::insert(const VINode &Parent, std::string_view Name,
+                       std::shared_ptr<VINode> Child) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Dirs.find(&Parent);
+  if (It == Dirs.end() || Dirs.size() > kMaxDirs ||
+      It->second.Children.find(Name) != It->second.Children.end()) {
+    return;
+  }
+  // The entry replaced after opening is reported by the watch of the parent,
+  // and dropped by the next `sync`.
+  auto WatchId = Watch.add(Child->Node);
+  if (unlikely(!WatchId)) {
+    return;
+  }
+  const VINode *Node = Child.get();
+  It->second.Children.emplace(Name, Node);
+  Watches.emplace(*WatchId, Node);
+  Dirs.emplace(Node,
+               Dir{std::move(Child), *WatchId, &Parent, std::string(Name), {}});
+}
+
+void PathCache::erase(const VINode *Node) noexcept {
+  auto It = Dirs.find(Node);
+  if (It == Dirs.end()) {
+    return;
+  }
+  auto &D = It->second;
+  while (!D.Children.empty()) {
+    erase(D.Children.begin()->second);
+  }
+  if (Node == Root) {
+    return;
+  }
+  Dirs.at(D.Parent).Children.erase(D.Name);
+  bool Shared = false;
+  auto [Begin, End] = Watches.equal_range(D.WatchId);
+  for (auto W = Begin; W != End;) {
+    if (W->second == Node) {
+      W = Watches.erase(W);
+    } else {
+      Shared = true;
+      ++W;
+    }
+  }
+  // The same directory may be cached through multiple paths, such as bind
+  // mounts, which share the watch.
+  if (!Shared) {
+    Watch.remove(D.WatchId);
+  }
+  Dirs.erase(It);
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "host/wasi/resolver.h"
+#include "common/config.h"
+#include "common/defines.h"
+#include "host/wasi/eventloop.h"
+#include "host/wasi/inode.h"
+#include "host/wasi/vinode.h"
+
+#include <new>
+#include <system_error>
+#include <thread>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+namespace Host {
+namespace WASI {
+
+namespace {
+
+/// Maximum results kept of a lookup.
+static inline constexpr const uint32_t kMaxResults = 32;
+/// Size of the canonical name buffer, as `NI_MAXHOST`.
+static inline constexpr const size_t kCanonNameSize = 1025;
+
+std::string makeKey(std::string_view Node, std::string_view Service,
+                    const __wasi_addrinfo_t &Hint) {
+  std::string Key;
+  Key.reserve(Node.size() + Service.size() + 6);
+  Key.append(Node);
+  Key.push_back('\0');
+  Key.append(Service);
+  Key.push_back('\0');
+  Key.push_back(static_cast<char>(Hint.ai_flags));
+  Key.push_back(static_cast<char>(Hint.ai_flags >> 8));
+  Key.push_back(static_cast<char>(Hint.ai_family));
+  Key.push_back(static_cast<char>(Hint.ai_socktype));
+  Key.push_back(static_cast<char>(Hint.ai_protocol));
+  return Key;
+}
+
+/// Look up the addresses by the system resolver, which blocks the thread.
+WasiExpect<Resolver::Result> lookup(std::string_view Node,
+                                    std::string_view Service,
+                                    const __wasi_addrinfo_t &Hint) noexcept {
+  try {
+    std::vector<__wasi_addrinfo_t> Infos(kMaxResults);
+    std::vector<__wasi_sockaddr_t> Addrs(kMaxResults);
+    std::vector<std::array<char, Resolver::kSaDataSize>> SaData(kMaxResults);
+    std::vector<char> CanonNames(kMaxResults * kCanonNameSize);
+    std::vector<__wasi_addrinfo_t *> InfoPtrs(kMaxResults);
+    std::vector<__wasi_sockaddr_t *> AddrPtrs(kMaxResults);
+    std::vector<char *> SaDataPtrs(kMaxResults);
+    std::vector<char *> CanonNamePtrs(kMaxResults);
+    for (uint32_t I = 0; I < kMaxResults; ++I) {
+      InfoPtrs[I] = &Infos[I];
+      AddrPtrs[I] = &Addrs[I];
+      SaDataPtrs[I] = SaData[I].data();
+      CanonNamePtrs[I] = &CanonNames[I * kCanonNameSize];
+    }
+
+    __wasi_size_t Length = 0;
+    EXPECTED_TRY(INode::getAddrinfo(Node, Service, Hint, kMaxResults,
+                                    InfoPtrs, AddrPtrs, SaDataPtrs,
+                                    CanonNamePtrs, Length));
+
+    auto Res = std::make_shared<std::vector<Resolver::Addrinfo>>(Length);
+    for (uint32_t I = 0; I < Length; ++I) {
+      auto &Item = (*Res)[I];
+      Item.Info = Infos[I];
+      if (Infos[I].ai_addrlen > 0) {
+        Item.SaFamily = Addrs[I].sa_family;
+        Item.SaDataLen = Addrs[I].sa_data_len;
+        Item.SaData = SaData[I];
+      } else {
+        Item.SaFamily = __WASI_ADDRESS_FAMILY_UNSPEC;
+        Item.SaDataLen = 0;
+      }
+      Item.CanonName.assign(CanonNamePtrs[I], Infos[I].ai_canonname_len);
+    }
+    return Res;
+  } catch (std::bad_alloc &) {
+    return WasiUnexpect(__WASI_ERRNO_AIMEMORY);
+  }
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Look up the addresses on a background thread, and park the calling task
+/// until the thread signals the pipe.
+WasiExpect<Resolver::Result> lookupParked(EventLoop &Loop,
+                                          std::string_view Node,
+                                          std::string_view Service,
+                                          const __wasi_addrinfo_t &Hint) {
+  struct Pending {
+    std::string Node;
+    std::string Service;
+    __wasi_addrinfo_t Hint;
+    WasiExpect<Resolver::Result> Res;
+    int WriteFd;
+  };
+
+  int Fds[2];
+  if (unlikely(::pipe(Fds) != 0)) {
+    return lookup(Node, Service, Hint);
+  }
+  ::fcntl(Fds[0], F_SETFD, FD_CLOEXEC);
+  ::fcntl(Fds[1], F_SETFD, FD_CLOEXEC);
+  const auto Rights = static_cast<__wasi_rights_t>(~UINT64_C(0));
+  auto Reader = VINode::fromFd(Fds[0], Rights, Rights);
+  auto State = std::make_shared<Pending>(
+      Pending{std::string(Node), std::string(Service), Hint, {}, Fds[1]});
+  try {
+    std::thread([State]() noexcept {
+      State->Res = lookup(State->Node, State->Service, State->Hint);
+      const char Done = 0;
+      [[maybe_unused]] auto Written = ::write(State->WriteFd, &Done, 1);
+      ::close(State->WriteFd);
+    }).detach();
+  } catch (std::system_error &) {
+    ::close(Fds[0]);
+    ::close(Fds[1]);
+    return lookup(Node, Service, Hint);
+  }
+
+  if (Reader) {
+    // Fall back to the blocking read below if the task cannot be parked.
+    [[maybe_unused]] auto Waited =
+        Loop.wait(**Reader, __WASI_EVENTTYPE_FD_READ);
+  }
+  char Done;
+  [[maybe_unused]] auto Read = ::read(Fds[0], &Done, 1);
+  ::close(Fds[0]);
+  return std::move(State->Res);
+}
+#endif
+
+} // namespace
+
+Resolver &Resolver::getDefault() noexcept {
+  static Resolver Default;
+  return Default;
+}
+
+void Resolver::setTTL(std::chrono::nanoseconds NewTTL) noexcept {
+  std::unique_lock Lock(Mutex);
+  TTL = NewTTL;
+  if (TTL.count() <= 0) {
+    Cache.clear();
+  }
+}
+
+WasiExpect<Resolver::Result>
+Resolver::resolve(std::string_view Node, std::string_view Service,
+                  const __wasi_addrinfo_t &Hint) noexcept {
+  try {
+    std::string Key = makeKey(Node, Service, Hint);
+    {
+      std::unique_lock Lock(Mutex);
+      if (auto It = Cache.find(Key); It != Cache.end()) {
+        if (It->second.Expiry > std::chrono::steady_clock::now()) {
+          return It->second.Value;
+        }
+        Cache.erase(It);
+      }
+    }
+
+    WasiExpect<Result> Res;
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+    if (auto *Loop = EventLoop::current(); Loop) {
+      Res = lookupParked(*Loop, Node, Service, Hint);
+    } else {
+      Res = lookup(Node, Service, Hint);
+    }
+#else
+    Res = lookup(Node, Service, Hint);
+#endif
+    if (!Res) {
+      return Res;
+    }
+
+    std::unique_lock Lock(Mutex);
+    if (TTL.count() > 0) {
+      const auto Now = std::chrono::steady_clock::now();
+      if (Cache.size() >= kMaxEntries) {
+        for (auto It = Cache.begin(); It != Cache.end();) {
+          if (It->second.Expiry <= Now) {
+            It = Cache.erase(It);
+          } else {
+            ++It;
+          }
+        }
+        if (Cache.size() >= kMaxEntries) {
+          Cache.clear();
+        }
+      }
+      Cache.insert_or_assign(std::move(Key), Entry{*Res, Now + TTL});
+    }
+    return Res;
+  } catch (std::bad_alloc &) {
+    return WasiUnexpect(__WASI_ERRNO_AIMEMORY);
+  }
+}
+
+void Resolver::clear() noexcept {
+  std::unique_lock Lock(Mutex);
+  Cache.clear();
+}
+
+} // namespace WASI
+} // namespace Host
+} // namespace WasmEdge
@@ -5,9 +5,11 @@
 #include "common/errcode.h"
 #include "common/spdlog.h"
 #include "host/wasi/environ.h"
+#include "host/wasi/resolver.h"
 #include "host/wasi/vfs.h"
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <numeric>
 #include <string>
 
@@ -28,6 +30,11 @@ VINode::VINode(INode Node, __wasi_rights_t FRB, __wasi_rights_t FRI,
     : Node(std::move(Node)), FsRightsBase(FRB), FsRightsInheriting(FRI),
       Name(std::move(N)) {}
 
+VINode::VINode(ArchiveNode Node, __wasi_rights_t FRB, __wasi_rights_t FRI,
+               std::string N)
+    : FsRightsBase(FRB), FsRightsInheriting(FRI), Name(std::move(N)),
+      Archived(std::make_unique<ArchiveNode>(std::move(Node))) {}
+
 std::shared_ptr<VINode> VINode::stdIn(__wasi_rights_t FRB,
                                       __wasi_rights_t FRI) {
   return std::make_shared<VINode>(INode::stdIn(), FRB, FRI);
@@ -105,6 +112,15 @@ WasiExpect<std::shared_ptr<VINode>> VINode::bind(__wasi_rights_t FRB,
   return std::make_shared<VINode>(std::move(Node), FRB, FRI, std::move(Name));
 }
 
+WasiExpect<std::shared_ptr<VINode>>
+VINode::bindArchive(__wasi_rights_t FRB, __wasi_rights_t FRI, std::string Name,
+                    std::string SystemPath) {
+  EXPECTED_TRY(auto Image,
+               Archive::open(std::filesystem::u8path(std::move(SystemPath))));
+  return std::make_shared<VINode>(ArchiveNode(std::move(Image), 0), FRB, FRI,
+                                  std::move(Name));
+}
+
 WasiExpect<void> VINode::pathCreateDirectory(std::shared_ptr<VINode> Fd,
                                              std::string_view Path) {
   if (!Fd->can(__WASI_RIGHTS_PATH_CREATE_DIRECTORY)) {
@@ -121,7 +137,18 @@ WasiExpect<void> VINode::pathFilestatGet(std::shared_ptr<VINode> Fd,
   if (!Fd->can(__WASI_RIGHTS_PATH_FILESTAT_GET)) {
     return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
   }
+  if (Fd->canResolveBeneath(Path)) {
+    const bool Follow = Flags & __WASI_LOOKUPFLAGS_SYMLINK_FOLLOW;
+    if (auto Res = Fd->Node.pathFilestatGetBeneath(std::string(Path), Follow,
+                                                   Filestat);
+        Res || Res.error() != __WASI_ERRNO_NOSYS) {
+      return Res;
+    }
+  }
   EXPECTED_TRY(auto Buffer, resolvePath(Fd, Path, Flags));
+  if (Fd->Archived) {
+    return Fd->Archived->pathFilestatGet(Path, Filestat);
+  }
   return Fd->Node.pathFilestatGet(std::string(Path), Filestat);
 }
 
@@ -196,7 +223,6 @@ VINode::pathOpen(std::shared_ptr<VINode> Fd, std::string_view Path,
   if (!Fd->can(RequiredRights, RequiredInheritingRights)) {
     return WasiUnexpect(__WASI_ERRNO_NOTCAPABLE);
   }
-  EXPECTED_TRY(auto Buffer, resolvePath(Fd, Path, LookupFlags));
   VFS::Flags VFSFlags = static_cast<VFS::Flags>(0);
   if (Read) {
     VFSFlags |= VFS::Read;
@@ -204,6 +230,19 @@ VINode::pathOpen(std::shared_ptr<VINode> Fd, std::string_view Path,
   if (Write) {
     VFSFlags |= VFS::Write;
   }
+  const bool Follow = LookupFlags & __WASI_LOOKUPFLAGS_SYMLINK_FOLLOW;
+  // The exclusive creating never follows the last link in the kernel.
+  if (Fd->canResolveBeneath(Path) &&
+      !(Follow && (OpenFlags & __WASI_OFLAGS_EXCL))) {
+    if (auto Res = Fd->Node.pathOpenBeneath(std::string(Path), OpenFlags,
+                                            FdFlags, VFSFlags, Follow);
+        Res || Res.error() != __WASI_ERRNO_NOSYS) {
+      EXPECTED_TRY(auto NewNode, std::move(Res));
+      return std::make_shared<VINode>(std::move(NewNode), FsRightsBase,
+                                      FsRightsInheriting);
+    }
+  }
+  EXPECTED_TRY(auto Buffer, resolvePath(Fd, Path, LookupFlags));
   return Fd->directOpen(Path, OpenFlags, FdFlags, VFSFlags, FsRightsBase,
                         FsRightsInheriting);
 }
@@ -217,6 +256,9 @@ WasiExpect<void> VINode::pathReadlink(std::shared_ptr<VINode> Fd,
   EXPECTED_TRY(auto PathBuffer,
                resolvePath(Fd, Path, static_cast<__wasi_lookupflags_t>(0)));
 
+  if (Fd->Archived) {
+    return Fd->Archived->pathReadlink(Path, Buffer, NRead);
+  }
   return Fd->Node.pathReadlink(std::string(Path), Buffer, NRead);
 }
 
@@ -280,9 +322,31 @@ VINode::getAddrinfo(std::string_view Node, std::string_view Service,
                     Span<char *> AiAddrSaDataArray,
                     Span<char *> AiCanonnameArray,
                     /*Out*/ __wasi_size_t &ResLength) noexcept {
-  return INode::getAddrinfo(Node, Service, Hint, MaxResLength,
-                            WasiAddrinfoArray, WasiSockaddrArray,
-                            AiAddrSaDataArray, AiCanonnameArray, ResLength);
+  EXPECTED_TRY(auto Res, Resolver::getDefault().resolve(Node, Service, Hint));
+  ResLength = static_cast<__wasi_size_t>(
+      std::min<size_t>(Res->size(), MaxResLength));
+  for (uint32_t Idx = 0; Idx < ResLength; Idx++) {
+    const auto &Item = (*Res)[Idx];
+    auto &CurAddrinfo = *WasiAddrinfoArray[Idx];
+    CurAddrinfo.ai_flags = Item.Info.ai_flags;
+    CurAddrinfo.ai_socktype = Item.Info.ai_socktype;
+    CurAddrinfo.ai_protocol = Item.Info.ai_protocol;
+    CurAddrinfo.ai_family = Item.Info.ai_family;
+    CurAddrinfo.ai_addrlen = Item.Info.ai_addrlen;
+    CurAddrinfo.ai_canonname_len =
+        static_cast<__wasi_size_t>(Item.CanonName.size());
+    if (!Item.CanonName.empty()) {
+      std::memcpy(AiCanonnameArray[Idx], Item.CanonName.c_str(),
+                  Item.CanonName.size() + 1);
+    }
+    if (Item.Info.ai_addrlen > 0) {
+      auto &CurSockaddr = *WasiSockaddrArray[Idx];
+      CurSockaddr.sa_family = Item.SaFamily;
+      std::memcpy(AiAddrSaDataArray[Idx], Item.SaData.data(), Item.SaDataLen);
+      CurSockaddr.sa_data_len = Item.SaDataLen;
+    }
+  }
+  return {};
 }
 
 WasiExpect<std::shared_ptr<VINode>>
@@ -317,6 +381,11 @@ VINode::directOpen(std::string_view Path, __wasi_oflags_t OpenFlags,
                    __wasi_fdflags_t FdFlags, VFS::Flags VFSFlags,
                    __wasi_rights_t RightsBase,
                    __wasi_rights_t RightsInheriting) {
+  if (Archived) {
+    EXPECTED_TRY(auto NewNode, Archived->pathOpen(Path, OpenFlags));
+    return std::make_shared<VINode>(std::move(NewNode), RightsBase,
+                                    RightsInheriting);
+  }
   std::string PathStr(Path);
 
   EXPECTED_TRY(auto NewNode,
@@ -331,6 +400,10 @@ VINode::resolvePath(std::shared_ptr<VINode> &Fd, std::string_view &Path,
                     uint8_t LinkCount, bool FollowTrailingSlashes) {
   std::vector<std::shared_ptr<VINode>> PartFds;
   std::vector<char> Buffer;
+  std::shared_ptr<PathCache> Cache = Fd ? Fd->Cache : nullptr;
+  if (Cache) {
+    Cache->sync();
+  }
   do {
     // check empty path
     if (Path.empty() && (VFSFlags & VFS::AllowEmpty) == 0) {
@@ -393,8 +466,23 @@ VINode::resolvePath(std::shared_ptr<VINode> &Fd, std::string_view &Path,
         return Buffer;
       }
 
+      if (Cache && !LastPart) {
+        if (auto Child = Cache->find(*Fd, Part)) {
+          PartFds.push_back(std::exchange(Fd, std::move(Child)));
+          Path = Remain;
+          if (Path.empty()) {
+            Path = "."sv;
+            return {};
+          }
+          continue;
+        }
+      }
+
       __wasi_filestat_t Filestat;
-      if (auto Res = Fd->Node.pathFilestatGet(std::string(Part), Filestat);
+      if (auto Res =
+              Fd->Archived
+                  ? Fd->Archived->pathFilestatGet(Part, Filestat)
+                  : Fd->Node.pathFilestatGet(std::string(Part), Filestat);
           unlikely(!Res)) {
         if (LastPart) {
           Path = Part;
@@ -411,7 +499,9 @@ VINode::resolvePath(std::shared_ptr<VINode> &Fd, std::string_view &Path,
         std::vector<char> NewBuffer(16384);
         __wasi_size_t NRead;
         EXPECTED_TRY(
-            Fd->Node.pathReadlink(std::string(Part), NewBuffer, NRead));
+            Fd->Archived
+                ? Fd->Archived->pathReadlink(Part, NewBuffer, NRead)
+                : Fd->Node.pathReadlink(std::string(Part), NewBuffer, NRead));
         NewBuffer.resize(NRead);
         // Don't drop Buffer now because Path may referencing it.
         if (!Remain.empty()) {
@@ -435,13 +525,26 @@ VINode::resolvePath(std::shared_ptr<VINode> &Fd, std::string_view &Path,
         return WasiUnexpect(__WASI_ERRNO_NOTDIR);
       }
 
-      EXPECTED_TRY(auto Child, Fd->Node.pathOpen(
-                                   std::string(Part), __WASI_OFLAGS_DIRECTORY,
-                                   static_cast<__wasi_fdflags_t>(0), VFSFlags));
+      std::shared_ptr<VINode> ChildFd;
+      if (Fd->Archived) {
+        EXPECTED_TRY(auto Child,
+                     Fd->Archived->pathOpen(Part, __WASI_OFLAGS_DIRECTORY));
+        ChildFd = std::make_shared<VINode>(std::move(Child), Fd->FsRightsBase,
+                                           Fd->FsRightsInheriting);
+      } else {
+        EXPECTED_TRY(auto Child,
+                     Fd->Node.pathOpen(std::string(Part),
+                                       __WASI_OFLAGS_DIRECTORY,
+                                       static_cast<__wasi_fdflags_t>(0),
+                                       VFSFlags));
+        ChildFd = std::make_shared<VINode>(std::move(Child), Fd->FsRightsBase,
+                                           Fd->FsRightsInheriting);
+      }
+      if (Cache) {
+        Cache->insert(*Fd, Part, ChildFd);
+      }
       // fast retry
-      PartFds.push_back(std::exchange(
-          Fd, std::make_shared<VINode>(std::move(Child), Fd->FsRightsBase,
-                                       Fd->FsRightsInheriting)));
+      PartFds.push_back(std::exchange(Fd, std::move(ChildFd)));
       Path = Remain;
       if (Path.empty()) {
         Path = "."sv;
@@ -378,6 +378,7 @@ template <typename T> inline bool isMisaligned(uint32_t Ptr) noexcept {
 
 Expect<uint32_t> WasiArgsGet::body(const Runtime::CallingFrame &Frame,
                                    uint32_t ArgvPtr, uint32_t ArgvBufPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<uint8_t_ptr>(ArgvPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -419,6 +420,7 @@ Expect<uint32_t> WasiArgsGet::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiArgsSizesGet::body(const Runtime::CallingFrame &Frame,
                                         uint32_t /* Out */ ArgcPtr,
                                         uint32_t /* Out */ ArgvBufSizePtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_size_t>(ArgcPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -452,6 +454,7 @@ Expect<uint32_t> WasiArgsSizesGet::body(const Runtime::CallingFrame &Frame,
 
 Expect<uint32_t> WasiEnvironGet::body(const Runtime::CallingFrame &Frame,
                                       uint32_t EnvPtr, uint32_t EnvBufPtr) {
+  auto &Env = this->getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<uint8_t_ptr>(EnvPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -483,7 +486,7 @@ Expect<uint32_t> WasiEnvironGet::body(const Runtime::CallingFrame &Frame,
     EnvSpan[0] = EnvBufPtr;
   }
 
-  if (auto Res = this->Env.environGet(EnvSpan, EnvBuf); unlikely(!Res)) {
+  if (auto Res = Env.environGet(EnvSpan, EnvBuf); unlikely(!Res)) {
     return Res.error();
   }
 
@@ -493,6 +496,7 @@ Expect<uint32_t> WasiEnvironGet::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiEnvironSizesGet::body(const Runtime::CallingFrame &Frame,
                                            uint32_t /* Out */ EnvCntPtr,
                                            uint32_t /* Out */ EnvBufSizePtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_size_t>(EnvCntPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -528,6 +532,7 @@ Expect<uint32_t> WasiEnvironSizesGet::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiClockResGet::body(const Runtime::CallingFrame &Frame,
                                        uint32_t ClockId,
                                        uint32_t /* Out */ ResolutionPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_timestamp_t>(ResolutionPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -561,6 +566,7 @@ Expect<uint32_t> WasiClockResGet::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiClockTimeGet::body(const Runtime::CallingFrame &Frame,
                                         uint32_t ClockId, uint64_t Precision,
                                         uint32_t /* Out */ TimePtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_timestamp_t>(TimePtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -593,9 +599,10 @@ Expect<uint32_t> WasiClockTimeGet::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdAdvise::body(const Runtime::CallingFrame &, int32_t Fd,
-                                    uint64_t Offset, uint64_t Len,
+Expect<uint32_t> WasiFdAdvise::body(const Runtime::CallingFrame &Frame,
+                                    int32_t Fd, uint64_t Offset, uint64_t Len,
                                     uint32_t Advice) {
+  auto &Env = getEnv(Frame);
   __wasi_advice_t WasiAdvice;
   if (auto Res = cast<__wasi_advice_t>(Advice); unlikely(!Res)) {
     return Res.error();
@@ -614,8 +621,10 @@ Expect<uint32_t> WasiFdAdvise::body(const Runtime::CallingFrame &, int32_t Fd,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdAllocate::body(const Runtime::CallingFrame &, int32_t Fd,
-                                      uint64_t Offset, uint64_t Len) {
+Expect<uint32_t> WasiFdAllocate::body(const Runtime::CallingFrame &Frame,
+                                      int32_t Fd, uint64_t Offset,
+                                      uint64_t Len) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_filesize_t WasiOffset = Offset;
   const __wasi_filesize_t WasiLen = Len;
@@ -626,7 +635,9 @@ Expect<uint32_t> WasiFdAllocate::body(const Runtime::CallingFrame &, int32_t Fd,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdClose::body(const Runtime::CallingFrame &, int32_t Fd) {
+Expect<uint32_t> WasiFdClose::body(const Runtime::CallingFrame &Frame,
+                                   int32_t Fd) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
 
   if (auto Res = Env.fdClose(WasiFd); unlikely(!Res)) {
@@ -635,8 +646,9 @@ Expect<uint32_t> WasiFdClose::body(const Runtime::CallingFrame &, int32_t Fd) {
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdDatasync::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiFdDatasync::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
 
   if (auto Res = Env.fdDatasync(WasiFd); unlikely(!Res)) {
@@ -648,6 +660,7 @@ Expect<uint32_t> WasiFdDatasync::body(const Runtime::CallingFrame &,
 Expect<uint32_t> WasiFdFdstatGet::body(const Runtime::CallingFrame &Frame,
                                        int32_t Fd,
                                        uint32_t /* Out */ FdStatPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fdstat_t>(FdStatPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -672,8 +685,9 @@ Expect<uint32_t> WasiFdFdstatGet::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdFdstatSetFlags::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiFdFdstatSetFlags::body(const Runtime::CallingFrame &Frame,
                                             int32_t Fd, uint32_t FsFlags) {
+  auto &Env = getEnv(Frame);
   __wasi_fdflags_t WasiFdFlags;
   if (auto Res = cast<__wasi_fdflags_t>(FsFlags); unlikely(!Res)) {
     return Res.error();
@@ -689,9 +703,10 @@ Expect<uint32_t> WasiFdFdstatSetFlags::body(const Runtime::CallingFrame &,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdFdstatSetRights::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiFdFdstatSetRights::body(const Runtime::CallingFrame &Frame,
                                              int32_t Fd, uint64_t FsRightsBase,
                                              uint64_t FsRightsInheriting) {
+  auto &Env = getEnv(Frame);
   __wasi_rights_t WasiFsRightsBase;
   if (auto Res = cast<__wasi_rights_t>(FsRightsBase); unlikely(!Res)) {
     return Res.error();
@@ -719,6 +734,7 @@ Expect<uint32_t> WasiFdFdstatSetRights::body(const Runtime::CallingFrame &,
 Expect<uint32_t> WasiFdFilestatGet::body(const Runtime::CallingFrame &Frame,
                                          int32_t Fd,
                                          uint32_t /* Out */ FilestatPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_filestat_t>(FilestatPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -743,8 +759,9 @@ Expect<uint32_t> WasiFdFilestatGet::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdFilestatSetSize::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiFdFilestatSetSize::body(const Runtime::CallingFrame &Frame,
                                              int32_t Fd, uint64_t Size) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_filesize_t WasiSize = Size;
 
@@ -754,10 +771,10 @@ Expect<uint32_t> WasiFdFilestatSetSize::body(const Runtime::CallingFrame &,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdFilestatSetTimes::body(const Runtime::CallingFrame &,
-                                              int32_t Fd, uint64_t ATim,
-                                              uint64_t MTim,
-                                              uint32_t FstFlags) {
+Expect<uint32_t>
+WasiFdFilestatSetTimes::body(const Runtime::CallingFrame &Frame, int32_t Fd,
+                             uint64_t ATim, uint64_t MTim, uint32_t FstFlags) {
+  auto &Env = getEnv(Frame);
   __wasi_fstflags_t WasiFstFlags;
   if (auto Res = cast<__wasi_fstflags_t>(FstFlags); unlikely(!Res)) {
     return Res.error();
@@ -781,6 +798,7 @@ Expect<uint32_t> WasiFdPread::body(const Runtime::CallingFrame &Frame,
                                    int32_t Fd, uint32_t IOVsPtr,
                                    uint32_t IOVsLen, uint64_t Offset,
                                    uint32_t /* Out */ NReadPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_iovec_t>(IOVsPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -846,6 +864,7 @@ Expect<uint32_t> WasiFdPread::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiFdPrestatDirName::body(const Runtime::CallingFrame &Frame,
                                             int32_t Fd, uint32_t PathBufPtr,
                                             uint32_t PathLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // PathBufPtr should be aligned to at least 1 byte (which is always true)
 
@@ -871,6 +890,7 @@ Expect<uint32_t> WasiFdPrestatDirName::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiFdPrestatGet::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd,
                                         uint32_t /* Out */ PreStatPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_prestat_t>(PreStatPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -900,6 +920,7 @@ Expect<uint32_t> WasiFdPwrite::body(const Runtime::CallingFrame &Frame,
                                     int32_t Fd, uint32_t IOVsPtr,
                                     uint32_t IOVsLen, uint64_t Offset,
                                     uint32_t /* Out */ NWrittenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_ciovec_t>(IOVsPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -922,7 +943,7 @@ Expect<uint32_t> WasiFdPwrite::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto IOVsArray =
-      MemInst->getSpan<__wasi_ciovec_t>(IOVsPtr, WasiIOVsLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(IOVsPtr, WasiIOVsLen);
   if (unlikely(IOVsArray.size() != WasiIOVsLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -969,6 +990,7 @@ Expect<uint32_t> WasiFdRead::body(const Runtime::CallingFrame &Frame,
                                   int32_t Fd, uint32_t IOVsPtr,
                                   uint32_t IOVsLen,
                                   uint32_t /* Out */ NReadPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_iovec_t>(IOVsPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1033,6 +1055,7 @@ Expect<uint32_t> WasiFdReadDir::body(const Runtime::CallingFrame &Frame,
                                      int32_t Fd, uint32_t BufPtr,
                                      uint32_t BufLen, uint64_t Cookie,
                                      uint32_t /* Out */ NReadPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_size_t>(NReadPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1068,8 +1091,9 @@ Expect<uint32_t> WasiFdReadDir::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdRenumber::body(const Runtime::CallingFrame &, int32_t Fd,
-                                      int32_t ToFd) {
+Expect<uint32_t> WasiFdRenumber::body(const Runtime::CallingFrame &Frame,
+                                      int32_t Fd, int32_t ToFd) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
   const __wasi_fd_t WasiToFd = ToFd;
 
@@ -1082,6 +1106,7 @@ Expect<uint32_t> WasiFdRenumber::body(const Runtime::CallingFrame &, int32_t Fd,
 Expect<int32_t> WasiFdSeek::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                                  int64_t Offset, uint32_t Whence,
                                  uint32_t /* Out */ NewOffsetPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_filesize_t>(NewOffsetPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1116,7 +1141,9 @@ Expect<int32_t> WasiFdSeek::body(const Runtime::CallingFrame &Frame, int32_t Fd,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiFdSync::body(const Runtime::CallingFrame &, int32_t Fd) {
+Expect<uint32_t> WasiFdSync::body(const Runtime::CallingFrame &Frame,
+                                  int32_t Fd) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
 
   if (auto Res = Env.fdSync(WasiFd); unlikely(!Res)) {
@@ -1127,6 +1154,7 @@ Expect<uint32_t> WasiFdSync::body(const Runtime::CallingFrame &, int32_t Fd) {
 
 Expect<uint32_t> WasiFdTell::body(const Runtime::CallingFrame &Frame,
                                   int32_t Fd, uint32_t /* Out */ OffsetPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_filesize_t>(OffsetPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1157,6 +1185,7 @@ Expect<uint32_t> WasiFdWrite::body(const Runtime::CallingFrame &Frame,
                                    int32_t Fd, uint32_t IOVsPtr,
                                    uint32_t IOVsLen,
                                    uint32_t /* Out */ NWrittenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_ciovec_t>(IOVsPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1179,7 +1208,7 @@ Expect<uint32_t> WasiFdWrite::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto IOVsArray =
-      MemInst->getSpan<__wasi_ciovec_t>(IOVsPtr, WasiIOVsLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(IOVsPtr, WasiIOVsLen);
   if (unlikely(IOVsArray.size() != WasiIOVsLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -1219,9 +1248,43 @@ Expect<uint32_t> WasiFdWrite::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
+Expect<uint32_t> WasiFdSendfile::body(const Runtime::CallingFrame &Frame,
+                                      int32_t Fd, int32_t InFd, uint64_t Count,
+                                      uint32_t /* Out */ NWrittenPtr) {
+  auto &Env = getEnv(Frame);
+  // Alignment checks
+  if (unlikely(isMisaligned<__wasi_filesize_t>(NWrittenPtr))) {
+    return __WASI_ERRNO_ADDRNOTAVAIL;
+  }
+
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  // Check for invalid address.
+  __wasi_filesize_t *NWritten =
+      MemInst->getPointer<__wasi_filesize_t *>(NWrittenPtr);
+  if (unlikely(NWritten == nullptr)) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  const __wasi_fd_t WasiFd = Fd;
+  const __wasi_fd_t WasiInFd = InFd;
+  const __wasi_filesize_t WasiCount = Count;
+
+  if (auto Res = Env.fdSendfile(WasiFd, WasiInFd, WasiCount, *NWritten);
+      unlikely(!Res)) {
+    return Res.error();
+  }
+  return __WASI_ERRNO_SUCCESS;
+}
+
 Expect<uint32_t>
 WasiPathCreateDirectory::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                               uint32_t PathPtr, uint32_t PathLen) {
+  auto &Env = getEnv(Frame);
   // PathPtr should be aligned to at least 1 byte (which is always true)
   // Check memory instance from module.
   auto *MemInst = Frame.getMemoryByIndex(0);
@@ -1247,6 +1310,7 @@ Expect<uint32_t> WasiPathFilestatGet::body(const Runtime::CallingFrame &Frame,
                                            int32_t Fd, uint32_t Flags,
                                            uint32_t PathPtr, uint32_t PathLen,
                                            uint32_t /* Out */ FilestatPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_filestat_t>(FilestatPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1291,6 +1355,7 @@ WasiPathFilestatSetTimes::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                                uint32_t Flags, uint32_t PathPtr,
                                uint32_t PathLen, uint64_t ATim, uint64_t MTim,
                                uint32_t FstFlags) {
+  auto &Env = getEnv(Frame);
   // PathPtr should be aligned to at least 1 byte (which is always true)
 
   // Check memory instance from module.
@@ -1336,6 +1401,7 @@ Expect<uint32_t> WasiPathLink::body(const Runtime::CallingFrame &Frame,
                                     uint32_t OldPathPtr, uint32_t OldPathLen,
                                     int32_t NewFd, uint32_t NewPathPtr,
                                     uint32_t NewPathLen) {
+  auto &Env = getEnv(Frame);
   // OldPathPtr and NewPathPtr should be aligned to at least 1 byte (which is
   // always true)
 
@@ -1379,6 +1445,7 @@ Expect<uint32_t> WasiPathOpen::body(
     const Runtime::CallingFrame &Frame, int32_t DirFd, uint32_t DirFlags,
     uint32_t PathPtr, uint32_t PathLen, uint32_t OFlags, uint64_t FsRightsBase,
     uint64_t FsRightsInheriting, uint32_t FsFlags, uint32_t /* Out */ FdPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fd_t>(FdPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1462,6 +1529,7 @@ Expect<uint32_t> WasiPathReadLink::body(const Runtime::CallingFrame &Frame,
                                         uint32_t PathLen, uint32_t BufPtr,
                                         uint32_t BufLen,
                                         uint32_t /* Out */ NReadPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_size_t>(NReadPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1504,6 +1572,7 @@ Expect<uint32_t> WasiPathReadLink::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t>
 WasiPathRemoveDirectory::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                               uint32_t PathPtr, uint32_t PathLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // PathPtr should be aligned to at least 1 byte (which is always true)
 
@@ -1532,6 +1601,7 @@ Expect<uint32_t> WasiPathRename::body(const Runtime::CallingFrame &Frame,
                                       uint32_t OldPathLen, int32_t NewFd,
                                       uint32_t NewPathPtr,
                                       uint32_t NewPathLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // OldPathPtr and NewPathPtr should be aligned to at least 1 byte (which is
   // always true).
@@ -1568,6 +1638,7 @@ Expect<uint32_t> WasiPathSymlink::body(const Runtime::CallingFrame &Frame,
                                        uint32_t OldPathPtr, uint32_t OldPathLen,
                                        int32_t Fd, uint32_t NewPathPtr,
                                        uint32_t NewPathLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // OldPathPtr and NewPathPtr should be aligned to at least 1 byte (which is
   // always true)
@@ -1605,6 +1676,7 @@ Expect<uint32_t> WasiPathSymlink::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiPathUnlinkFile::body(const Runtime::CallingFrame &Frame,
                                           int32_t Fd, uint32_t PathPtr,
                                           uint32_t PathLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // PathPtr should be aligned to at least 1 byte (which is always true)
 
@@ -1631,6 +1703,7 @@ template <WASI::TriggerType Trigger>
 Expect<uint32_t> WasiPollOneoff<Trigger>::body(
     const Runtime::CallingFrame &Frame, uint32_t InPtr, uint32_t OutPtr,
     uint32_t NSubscriptions, uint32_t /* Out */ NEventsPtr) {
+  auto &Env = this->getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_subscription_t>(InPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1666,7 +1739,7 @@ Expect<uint32_t> WasiPollOneoff<Trigger>::body(
   }
 
   // Validate contents
-  if (auto Poll = this->Env.acquirePoller(Events); unlikely(!Poll)) {
+  if (auto Poll = Env.acquirePoller(Events); unlikely(!Poll)) {
     for (__wasi_size_t I = 0; I < WasiNSub.raw(); ++I) {
       Events[I].userdata = Subs[I].userdata;
       Events[I].error = Poll.error();
@@ -1676,6 +1749,10 @@ Expect<uint32_t> WasiPollOneoff<Trigger>::body(
     return Poll.error();
   } else {
     auto &Poller = *Poll;
+    if (const auto *Executor = Frame.getExecutor()) {
+      Poller.useUring(
+          Executor->getConfigure().getRuntimeConfigure().isEnableIoUring());
+    }
     for (auto &Sub : Subs) {
       const EndianValue<__wasi_userdata_t> WasiUserData = Sub.userdata;
 
@@ -1734,9 +1811,10 @@ Expect<uint32_t> WasiPollOneoff<Trigger>::body(
       }
     }
     Poller.wait();
+    Env.getIOStatistics().addPollWakeup();
     *NEvents = EndianValue<__wasi_size_t>(Poller.result()).le();
     Poller.reset();
-    this->Env.releasePoller(std::move(Poller));
+    Env.releasePoller(std::move(Poller));
   }
 
   return __WASI_ERRNO_SUCCESS;
@@ -1745,14 +1823,16 @@ Expect<uint32_t> WasiPollOneoff<Trigger>::body(
 template class WasiPollOneoff<WASI::TriggerType::Level>;
 template class WasiPollOneoff<WASI::TriggerType::Edge>;
 
-Expect<void> WasiProcExit::body(const Runtime::CallingFrame &,
+Expect<void> WasiProcExit::body(const Runtime::CallingFrame &Frame,
                                 uint32_t ExitCode) {
+  auto &Env = getEnv(Frame);
   Env.procExit(ExitCode);
   return Unexpect(ErrCode::Value::Terminated);
 }
 
-Expect<uint32_t> WasiProcRaise::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiProcRaise::body(const Runtime::CallingFrame &Frame,
                                      uint32_t Signal) {
+  auto &Env = getEnv(Frame);
   __wasi_signal_t WasiSignal;
   if (auto Res = cast<__wasi_signal_t>(Signal); unlikely(!Res)) {
     return Res.error();
@@ -1766,7 +1846,8 @@ Expect<uint32_t> WasiProcRaise::body(const Runtime::CallingFrame &,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiSchedYield::body(const Runtime::CallingFrame &) {
+Expect<uint32_t> WasiSchedYield::body(const Runtime::CallingFrame &Frame) {
+  auto &Env = getEnv(Frame);
   if (auto Res = Env.schedYield(); unlikely(!Res)) {
     return Res.error();
   }
@@ -1775,6 +1856,7 @@ Expect<uint32_t> WasiSchedYield::body(const Runtime::CallingFrame &) {
 
 Expect<uint32_t> WasiRandomGet::body(const Runtime::CallingFrame &Frame,
                                      uint32_t BufPtr, uint32_t BufLen) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // BufPtr should be aligned to at least 1 byte (which is always true)
 
@@ -1800,6 +1882,7 @@ Expect<uint32_t> WasiRandomGet::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockOpenV1::body(const Runtime::CallingFrame &Frame,
                                       uint32_t AddressFamily, uint32_t SockType,
                                       uint32_t /* Out */ RoFdPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fd_t>(RoFdPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1847,6 +1930,7 @@ Expect<uint32_t> WasiSockOpenV1::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockBindV1::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t AddressPtr,
                                       uint32_t Port) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1891,8 +1975,9 @@ Expect<uint32_t> WasiSockBindV1::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiSockListenV1::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiSockListenV1::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd, int32_t Backlog) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
   if (auto Res = Env.sockListen(WasiFd, Backlog); unlikely(!Res)) {
     return Res.error();
@@ -1903,6 +1988,7 @@ Expect<uint32_t> WasiSockListenV1::body(const Runtime::CallingFrame &,
 Expect<uint32_t> WasiSockAcceptV1::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd,
                                         uint32_t /* Out */ RoFdPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fd_t>(RoFdPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1931,6 +2017,7 @@ Expect<uint32_t> WasiSockAcceptV1::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockAcceptV2::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd, uint32_t FsFlags,
                                         uint32_t /* Out */ RoFdPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fd_t>(RoFdPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -1966,6 +2053,7 @@ Expect<uint32_t> WasiSockAcceptV2::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockConnectV1::body(const Runtime::CallingFrame &Frame,
                                          int32_t Fd, uint32_t AddressPtr,
                                          uint32_t Port) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2015,6 +2103,7 @@ Expect<uint32_t> WasiSockRecvV1::body(const Runtime::CallingFrame &Frame,
                                       uint32_t RiDataLen, uint32_t RiFlags,
                                       uint32_t /* Out */ RoDataLenPtr,
                                       uint32_t /* Out */ RoFlagsPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_iovec_t>(RiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2101,6 +2190,7 @@ Expect<uint32_t> WasiSockRecvFromV1::body(const Runtime::CallingFrame &Frame,
                                           uint32_t AddressPtr, uint32_t RiFlags,
                                           uint32_t /* Out */ RoDataLenPtr,
                                           uint32_t /* Out */ RoFlagsPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2199,6 +2289,7 @@ Expect<uint32_t> WasiSockSendV1::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t SiDataPtr,
                                       uint32_t SiDataLen, uint32_t SiFlags,
                                       uint32_t /* Out */ SoDataLenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_ciovec_t>(SiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2228,7 +2319,7 @@ Expect<uint32_t> WasiSockSendV1::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto SiDataArray =
-      MemInst->getSpan<__wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
   if (unlikely(SiDataArray.size() != WasiSiDataLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -2273,6 +2364,7 @@ Expect<uint32_t> WasiSockSendToV1::body(const Runtime::CallingFrame &Frame,
                                         uint32_t SiDataLen, uint32_t AddressPtr,
                                         int32_t Port, uint32_t SiFlags,
                                         uint32_t /* Out */ SoDataLenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2330,7 +2422,7 @@ Expect<uint32_t> WasiSockSendToV1::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto SiDataArray =
-      MemInst->getSpan<__wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
   if (unlikely(SiDataArray.size() != WasiSiDataLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -2373,8 +2465,9 @@ Expect<uint32_t> WasiSockSendToV1::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiSockShutdown::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiSockShutdown::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd, uint32_t SdFlags) {
+  auto &Env = getEnv(Frame);
   __wasi_sdflags_t WasiSdFlags;
   if (auto Res = cast<__wasi_sdflags_t>(SdFlags); unlikely(!Res)) {
     return Res.error();
@@ -2390,10 +2483,240 @@ Expect<uint32_t> WasiSockShutdown::body(const Runtime::CallingFrame &,
   return __WASI_ERRNO_SUCCESS;
 }
 
+Expect<uint32_t> WasiSockRecvMmsg::body(const Runtime::CallingFrame &Frame,
+                                        int32_t Fd, uint32_t MsgsPtr,
+                                        uint32_t MsgsLen, uint32_t RiFlags,
+                                        uint32_t /* Out */ NMsgsPtr) {
+  auto &Env = getEnv(Frame);
+  // Alignment checks
+  if (unlikely(isMisaligned<WASI::WasiMmsgHdr>(MsgsPtr))) {
+    return __WASI_ERRNO_ADDRNOTAVAIL;
+  }
+
+  if (unlikely(isMisaligned<__wasi_size_t>(NMsgsPtr))) {
+    return __WASI_ERRNO_ADDRNOTAVAIL;
+  }
+
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  __wasi_riflags_t WasiRiFlags;
+  if (auto Res = cast<__wasi_riflags_t>(RiFlags); unlikely(!Res)) {
+    return Res.error();
+  } else {
+    WasiRiFlags = *Res;
+  }
+
+  const __wasi_size_t WasiMsgsLen = MsgsLen;
+  if (unlikely(WasiMsgsLen > WASI::kMmsgMax)) {
+    return __WASI_ERRNO_INVAL;
+  }
+
+  // Check for invalid address.
+  const auto Hdrs = MemInst->getSpan<WASI::WasiMmsgHdr>(MsgsPtr, WasiMsgsLen);
+  if (unlikely(Hdrs.size() != WasiMsgsLen)) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  auto *const NMsgs = MemInst->getPointer<__wasi_size_t *>(NMsgsPtr);
+  if (unlikely(NMsgs == nullptr)) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  // All the scatter/gather vectors of the batch share the capacity.
+  StaticVector<Span<uint8_t>, WASI::kIOVMax> WasiIOVs;
+  std::array<WASI::RecvMessage, WASI::kMmsgMax> Msgs;
+  std::array<WASI::WasiAddrStorage *, WASI::kMmsgMax> Storages = {};
+  for (__wasi_size_t I = 0; I < WasiMsgsLen; ++I) {
+    const auto &Hdr = Hdrs[I];
+    const __wasi_size_t IOVsLen = EndianValue(Hdr.IOVsLen).le();
+    if (unlikely(IOVsLen > WASI::kIOVMax - WasiIOVs.size())) {
+      return __WASI_ERRNO_INVAL;
+    }
+    const auto IOVsArray = MemInst->getSpan<__wasi_iovec_t>(
+        EndianValue(Hdr.IOVs).le(), IOVsLen);
+    if (unlikely(IOVsArray.size() != IOVsLen)) {
+      return __WASI_ERRNO_FAULT;
+    }
+
+    const size_t Begin = WasiIOVs.size();
+    __wasi_size_t TotalSize = 0;
+    for (auto &IOV : IOVsArray) {
+      // Capping total size.
+      const __wasi_size_t Space =
+          std::numeric_limits<__wasi_size_t>::max() - TotalSize;
+      const uint32_t IOVBufLen = EndianValue(IOV.buf_len).le();
+      const __wasi_size_t BufLen =
+          unlikely(IOVBufLen > Space) ? Space : IOVBufLen;
+      TotalSize += BufLen;
+
+      // Check for invalid address.
+      const auto IOVArr =
+          MemInst->getSpan<uint8_t>(EndianValue(IOV.buf).le(), BufLen);
+      if (unlikely(IOVArr.size() != BufLen)) {
+        return __WASI_ERRNO_FAULT;
+      }
+      WasiIOVs.emplace_back_unchecked(IOVArr);
+    }
+    Msgs[I].Data = Span<Span<uint8_t>>(WasiIOVs.data() + Begin, IOVsLen);
+
+    if (const uint32_t AddressPtr = EndianValue(Hdr.Address).le();
+        AddressPtr != 0) {
+      if (unlikely(isMisaligned<WASI::WasiAddrStorage>(AddressPtr))) {
+        return __WASI_ERRNO_ADDRNOTAVAIL;
+      }
+      auto *Storage =
+          MemInst->getPointer<WASI::WasiAddrStorage *>(AddressPtr);
+      if (unlikely(Storage == nullptr)) {
+        return __WASI_ERRNO_FAULT;
+      }
+      Storages[I] = Storage;
+      Msgs[I].Address = Storage->getAddress();
+    }
+  }
+
+  const __wasi_fd_t WasiFd = Fd;
+
+  __wasi_size_t Count = 0;
+  if (auto Res = Env.sockRecvMmsg(
+          WasiFd, Span<WASI::RecvMessage>(Msgs.data(), WasiMsgsLen),
+          WasiRiFlags, Count);
+      unlikely(!Res)) {
+    return Res.error();
+  }
+  for (__wasi_size_t I = 0; I < Count; ++I) {
+    auto &Hdr = Hdrs[I];
+    Hdr.DataLen = EndianValue(Msgs[I].Size).le();
+    Hdr.Port = Msgs[I].Port;
+    Hdr.RoFlags = EndianValue(static_cast<uint16_t>(Msgs[I].RoFlags)).le();
+    if (Storages[I]) {
+      Storages[I]->setAddressFamily(Msgs[I].AddressFamily);
+    }
+  }
+  *NMsgs = EndianValue(Count).le();
+  return __WASI_ERRNO_SUCCESS;
+}
+
+Expect<uint32_t> WasiSockSendMmsg::body(const Runtime::CallingFrame &Frame,
+                                        int32_t Fd, uint32_t MsgsPtr,
+                                        uint32_t MsgsLen, uint32_t SiFlags,
+                                        uint32_t /* Out */ NMsgsPtr) {
+  auto &Env = getEnv(Frame);
+  // Alignment checks
+  if (unlikely(isMisaligned<WASI::WasiMmsgHdr>(MsgsPtr))) {
+    return __WASI_ERRNO_ADDRNOTAVAIL;
+  }
+
+  if (unlikely(isMisaligned<__wasi_size_t>(NMsgsPtr))) {
+    return __WASI_ERRNO_ADDRNOTAVAIL;
+  }
+
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  __wasi_siflags_t WasiSiFlags;
+  if (auto Res = cast<__wasi_siflags_t>(SiFlags); unlikely(!Res)) {
+    return Res.error();
+  } else {
+    WasiSiFlags = *Res;
+  }
+
+  const __wasi_size_t WasiMsgsLen = MsgsLen;
+  if (unlikely(WasiMsgsLen > WASI::kMmsgMax)) {
+    return __WASI_ERRNO_INVAL;
+  }
+
+  // Check for invalid address.
+  const auto Hdrs = MemInst->getSpan<WASI::WasiMmsgHdr>(MsgsPtr, WasiMsgsLen);
+  if (unlikely(Hdrs.size() != WasiMsgsLen)) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  auto *const NMsgs = MemInst->getPointer<__wasi_size_t *>(NMsgsPtr);
+  if (unlikely(NMsgs == nullptr)) {
+    return __WASI_ERRNO_FAULT;
+  }
+
+  // All the scatter/gather vectors of the batch share the capacity.
+  StaticVector<Span<const uint8_t>, WASI::kIOVMax> WasiIOVs;
+  std::array<WASI::SendMessage, WASI::kMmsgMax> Msgs;
+  for (__wasi_size_t I = 0; I < WasiMsgsLen; ++I) {
+    const auto &Hdr = Hdrs[I];
+    const __wasi_size_t IOVsLen = EndianValue(Hdr.IOVsLen).le();
+    if (unlikely(IOVsLen > WASI::kIOVMax - WasiIOVs.size())) {
+      return __WASI_ERRNO_INVAL;
+    }
+    const auto IOVsArray = MemInst->getSpan<const __wasi_ciovec_t>(
+        EndianValue(Hdr.IOVs).le(), IOVsLen);
+    if (unlikely(IOVsArray.size() != IOVsLen)) {
+      return __WASI_ERRNO_FAULT;
+    }
+
+    const size_t Begin = WasiIOVs.size();
+    __wasi_size_t TotalSize = 0;
+    for (auto &IOV : IOVsArray) {
+      // Capping total size.
+      const __wasi_size_t Space =
+          std::numeric_limits<__wasi_size_t>::max() - TotalSize;
+      const uint32_t IOVBufLen = EndianValue(IOV.buf_len).le();
+      const __wasi_size_t BufLen =
+          unlikely(IOVBufLen > Space) ? Space : IOVBufLen;
+      TotalSize += BufLen;
+
+      // Check for invalid address.
+      const auto IOVArr =
+          MemInst->getSpan<const uint8_t>(EndianValue(IOV.buf).le(), BufLen);
+      if (unlikely(IOVArr.size() != BufLen)) {
+        return __WASI_ERRNO_FAULT;
+      }
+      WasiIOVs.emplace_back_unchecked(IOVArr);
+    }
+    Msgs[I].Data = Span<Span<const uint8_t>>(WasiIOVs.data() + Begin, IOVsLen);
+
+    if (const uint32_t AddressPtr = EndianValue(Hdr.Address).le();
+        AddressPtr != 0) {
+      if (unlikely(isMisaligned<WASI::WasiAddrStorage>(AddressPtr))) {
+        return __WASI_ERRNO_ADDRNOTAVAIL;
+      }
+      auto *Storage =
+          MemInst->getPointer<const WASI::WasiAddrStorage *>(AddressPtr);
+      if (unlikely(Storage == nullptr)) {
+        return __WASI_ERRNO_FAULT;
+      }
+      Msgs[I].AddressFamily = Storage->getAddressFamily();
+      Msgs[I].Address = Storage->getAddress();
+      Msgs[I].Port = EndianValue(Hdr.Port).le();
+    }
+  }
+
+  const __wasi_fd_t WasiFd = Fd;
+
+  __wasi_size_t Count = 0;
+  if (auto Res = Env.sockSendMmsg(
+          WasiFd, Span<WASI::SendMessage>(Msgs.data(), WasiMsgsLen),
+          WasiSiFlags, Count);
+      unlikely(!Res)) {
+    return Res.error();
+  }
+  for (__wasi_size_t I = 0; I < Count; ++I) {
+    auto &Hdr = Hdrs[I];
+    Hdr.DataLen = EndianValue(Msgs[I].Size).le();
+  }
+  *NMsgs = EndianValue(Count).le();
+  return __WASI_ERRNO_SUCCESS;
+}
+
 Expect<uint32_t> WasiSockSetOpt::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t SockOptLevel,
                                       uint32_t SockOptName, uint32_t FlagPtr,
                                       uint32_t FlagSize) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // FlagPtr should be aligned to at least 1 byte (which is always true)
 
@@ -2436,6 +2759,7 @@ Expect<uint32_t> WasiSockGetAddrinfo::body(
     const Runtime::CallingFrame &Frame, uint32_t NodePtr, uint32_t NodeLen,
     uint32_t ServicePtr, uint32_t ServiceLen, uint32_t HintsPtr,
     uint32_t ResPtr, uint32_t MaxResLength, uint32_t ResLengthPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // NodePtr, ServicePtr should be aligned to at least 1 byte (which is always
   // true)
@@ -2616,6 +2940,7 @@ Expect<uint32_t>
 WasiSockGetLocalAddrV1::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                              uint32_t AddressPtr, uint32_t AddressTypePtr,
                              uint32_t PortPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2696,6 +3021,7 @@ Expect<uint32_t> WasiSockGetPeerAddrV1::body(const Runtime::CallingFrame &Frame,
                                              int32_t Fd, uint32_t AddressPtr,
                                              uint32_t AddressTypePtr,
                                              uint32_t PortPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2776,6 +3102,7 @@ Expect<uint32_t> WasiSockGetPeerAddrV1::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockOpenV2::body(const Runtime::CallingFrame &Frame,
                                       uint32_t AddressFamily, uint32_t SockType,
                                       uint32_t /* Out */ RoFdPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_fd_t>(RoFdPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2823,6 +3150,7 @@ Expect<uint32_t> WasiSockOpenV2::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t> WasiSockBindV2::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t AddressPtr,
                                       uint32_t Port) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2874,8 +3202,9 @@ Expect<uint32_t> WasiSockBindV2::body(const Runtime::CallingFrame &Frame,
   return __WASI_ERRNO_SUCCESS;
 }
 
-Expect<uint32_t> WasiSockListenV2::body(const Runtime::CallingFrame &,
+Expect<uint32_t> WasiSockListenV2::body(const Runtime::CallingFrame &Frame,
                                         int32_t Fd, int32_t Backlog) {
+  auto &Env = getEnv(Frame);
   const __wasi_fd_t WasiFd = Fd;
   if (auto Res = Env.sockListen(WasiFd, Backlog); unlikely(!Res)) {
     return Res.error();
@@ -2886,6 +3215,7 @@ Expect<uint32_t> WasiSockListenV2::body(const Runtime::CallingFrame &,
 Expect<uint32_t> WasiSockConnectV2::body(const Runtime::CallingFrame &Frame,
                                          int32_t Fd, uint32_t AddressPtr,
                                          uint32_t Port) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -2943,6 +3273,7 @@ Expect<uint32_t> WasiSockRecvV2::body(const Runtime::CallingFrame &Frame,
                                       uint32_t RiDataLen, uint32_t RiFlags,
                                       uint32_t /* Out */ RoDataLenPtr,
                                       uint32_t /* Out */ RoFlagsPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_iovec_t>(RiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -3028,6 +3359,7 @@ Expect<uint32_t> WasiSockRecvFromV2::body(const Runtime::CallingFrame &Frame,
                                           uint32_t /* Out */ PortPtr,
                                           uint32_t /* Out */ RoDataLenPtr,
                                           uint32_t /* Out */ RoFlagsPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_iovec_t>(RiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -3154,6 +3486,7 @@ Expect<uint32_t> WasiSockSendV2::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t SiDataPtr,
                                       uint32_t SiDataLen, uint32_t SiFlags,
                                       uint32_t /* Out */ SoDataLenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_ciovec_t>(SiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -3183,7 +3516,7 @@ Expect<uint32_t> WasiSockSendV2::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto SiDataArray =
-      MemInst->getSpan<__wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
   if (unlikely(SiDataArray.size() != WasiSiDataLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -3228,6 +3561,7 @@ Expect<uint32_t> WasiSockSendToV2::body(const Runtime::CallingFrame &Frame,
                                         uint32_t SiDataLen, uint32_t AddressPtr,
                                         int32_t Port, uint32_t SiFlags,
                                         uint32_t /* Out */ SoDataLenPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_ciovec_t>(SiDataPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -3293,7 +3627,7 @@ Expect<uint32_t> WasiSockSendToV2::body(const Runtime::CallingFrame &Frame,
 
   // Check for invalid address.
   const auto SiDataArray =
-      MemInst->getSpan<__wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
+      MemInst->getSpan<const __wasi_ciovec_t>(SiDataPtr, WasiSiDataLen);
   if (unlikely(SiDataArray.size() != WasiSiDataLen)) {
     return __WASI_ERRNO_FAULT;
   }
@@ -3339,6 +3673,7 @@ Expect<uint32_t> WasiSockGetOpt::body(const Runtime::CallingFrame &Frame,
                                       int32_t Fd, uint32_t SockOptLevel,
                                       uint32_t SockOptName, uint32_t FlagPtr,
                                       uint32_t FlagSizePtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   // no alignment requirement for FlagPtr as it's a byte array
 
@@ -3390,6 +3725,7 @@ Expect<uint32_t> WasiSockGetOpt::body(const Runtime::CallingFrame &Frame,
 Expect<uint32_t>
 WasiSockGetLocalAddrV2::body(const Runtime::CallingFrame &Frame, int32_t Fd,
                              uint32_t AddressPtr, uint32_t PortPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -3446,6 +3782,7 @@ WasiSockGetLocalAddrV2::body(const Runtime::CallingFrame &Frame, int32_t Fd,
 Expect<uint32_t> WasiSockGetPeerAddrV2::body(const Runtime::CallingFrame &Frame,
                                              int32_t Fd, uint32_t AddressPtr,
                                              uint32_t PortPtr) {
+  auto &Env = getEnv(Frame);
   // Alignment checks
   if (unlikely(isMisaligned<__wasi_address_t>(AddressPtr))) {
     return __WASI_ERRNO_ADDRNOTAVAIL;
@@ -5,103 +5,127 @@
 #include "host/wasi/wasifunc.h"
 
 #include <memory>
+#include <string_view>
+#include <vector>
+
+using namespace std::literals;
 
 namespace WasmEdge {
 namespace Host {
 
+namespace {
+/// The functions shared by all the WASI modules, which use the environment of
+/// the called module.
+struct WasiDefinition {
+  WasiDefinition() {
+    add<WasiArgsGet>("args_get"sv);
+    add<WasiArgsSizesGet>("args_sizes_get"sv);
+    add<WasiEnvironGet>("environ_get"sv);
+    add<WasiEnvironSizesGet>("environ_sizes_get"sv);
+    add<WasiClockResGet>("clock_res_get"sv);
+    add<WasiClockTimeGet>("clock_time_get"sv);
+    add<WasiFdAdvise>("fd_advise"sv);
+    add<WasiFdAllocate>("fd_allocate"sv);
+    add<WasiFdClose>("fd_close"sv);
+    add<WasiFdDatasync>("fd_datasync"sv);
+    add<WasiFdFdstatGet>("fd_fdstat_get"sv);
+    add<WasiFdFdstatSetFlags>("fd_fdstat_set_flags"sv);
+    add<WasiFdFdstatSetRights>("fd_fdstat_set_rights"sv);
+    add<WasiFdFilestatGet>("fd_filestat_get"sv);
+    add<WasiFdFilestatSetSize>("fd_filestat_set_size"sv);
+    add<WasiFdFilestatSetTimes>("fd_filestat_set_times"sv);
+    add<WasiFdPread>("fd_pread"sv);
+    add<WasiFdPrestatGet>("fd_prestat_get"sv);
+    add<WasiFdPrestatDirName>("fd_prestat_dir_name"sv);
+    add<WasiFdPwrite>("fd_pwrite"sv);
+    add<WasiFdRead>("fd_read"sv);
+    add<WasiFdReadDir>("fd_readdir"sv);
+    add<WasiFdRenumber>("fd_renumber"sv);
+    add<WasiFdSeek>("fd_seek"sv);
+    add<WasiFdSync>("fd_sync"sv);
+    add<WasiFdTell>("fd_tell"sv);
+    add<WasiFdWrite>("fd_write"sv);
+    add<WasiFdSendfile>("fd_sendfile"sv);
+    add<WasiPathCreateDirectory>("path_create_directory"sv);
+    add<WasiPathFilestatGet>("path_filestat_get"sv);
+    add<WasiPathFilestatSetTimes>("path_filestat_set_times"sv);
+    add<WasiPathLink>("path_link"sv);
+    add<WasiPathOpen>("path_open"sv);
+    add<WasiPathReadLink>("path_readlink"sv);
+    add<WasiPathRemoveDirectory>("path_remove_directory"sv);
+    add<WasiPathRename>("path_rename"sv);
+    add<WasiPathSymlink>("path_symlink"sv);
+    add<WasiPathUnlinkFile>("path_unlink_file"sv);
+    add<WasiPollOneoff<WASI::TriggerType::Level>>("poll_oneoff"sv);
+    add<WasiPollOneoff<WASI::TriggerType::Edge>>("epoll_oneoff"sv);
+    add<WasiProcExit>("proc_exit"sv);
+    add<WasiProcRaise>("proc_raise"sv);
+    add<WasiSchedYield>("sched_yield"sv);
+    add<WasiRandomGet>("random_get"sv);
+    // To make the socket API compatible with the old one,
+    // we will duplicate all the API to V1 and V2.
+    // The V1 presents the original behavior before 0.12 release.
+    // On the other hand, the V2 presents the new behavior including
+    // the sock_accept is following the WASI spec, some of the API
+    // use a larger size for handling complex address type, e.g.
+    // AF_UNIX.
+    // By default, we will register V1 first, if the signatures are
+    // not the same as the wasm application imported, then V2 will
+    // replace instead.
+    add<WasiSockOpenV1>("sock_open"sv);
+    add<WasiSockBindV1>("sock_bind"sv);
+    add<WasiSockConnectV1>("sock_connect"sv);
+    add<WasiSockListenV1>("sock_listen"sv);
+    add<WasiSockAcceptV1>("sock_accept"sv);
+    add<WasiSockRecvV1>("sock_recv"sv);
+    add<WasiSockRecvFromV1>("sock_recv_from"sv);
+    add<WasiSockSendV1>("sock_send"sv);
+    add<WasiSockSendToV1>("sock_send_to"sv);
+    add<WasiSockAcceptV2>("sock_accept_v2"sv);
+    add<WasiSockOpenV2>("sock_open_v2"sv);
+    add<WasiSockBindV2>("sock_bind_v2"sv);
+    add<WasiSockConnectV2>("sock_connect_v2"sv);
+    add<WasiSockListenV2>("sock_listen_v2"sv);
+    add<WasiSockRecvV2>("sock_recv_v2"sv);
+    add<WasiSockRecvFromV2>("sock_recv_from_v2"sv);
+    add<WasiSockSendV2>("sock_send_v2"sv);
+    add<WasiSockSendToV2>("sock_send_to_v2"sv);
+    add<WasiSockShutdown>("sock_shutdown"sv);
+    add<WasiSockRecvMmsg>("sock_recv_mmsg"sv);
+    add<WasiSockSendMmsg>("sock_send_mmsg"sv);
+    add<WasiSockGetOpt>("sock_getsockopt"sv);
+    add<WasiSockSetOpt>("sock_setsockopt"sv);
+    add<WasiSockGetLocalAddrV1>("sock_getlocaladdr"sv);
+    add<WasiSockGetPeerAddrV1>("sock_getpeeraddr"sv);
+    add<WasiSockGetLocalAddrV2>("sock_getlocaladdr_v2"sv);
+    add<WasiSockGetPeerAddrV2>("sock_getpeeraddr_v2"sv);
+    add<WasiSockGetAddrinfo>("sock_getaddrinfo"sv);
+  }
+
+  template <typename T> void add(std::string_view Name) {
+    auto Func = std::make_unique<T>();
+    Func->setLatencyIndex(static_cast<uint32_t>(Funcs.size()));
+    Names.push_back(Name);
+    Funcs.push_back(std::move(Func));
+  }
+
+  std::vector<std::string_view> Names;
+  std::vector<std::unique_ptr<Runtime::HostFunctionBase>> Funcs;
+};
+
+const WasiDefinition &getDefinition() {
+  // Leaked for the WASI modules destroyed at exit.
+  static const WasiDefinition *Def = new WasiDefinition();
+  return *Def;
+}
+} // namespace
+
 WasiModule::WasiModule() : ModuleInstance("wasi_snapshot_preview1") {
-  addHostFunc("args_get", std::make_unique<WasiArgsGet>(Env));
-  addHostFunc("args_sizes_get", std::make_unique<WasiArgsSizesGet>(Env));
-  addHostFunc("environ_get", std::make_unique<WasiEnvironGet>(Env));
-  addHostFunc("environ_sizes_get", std::make_unique<WasiEnvironSizesGet>(Env));
-  addHostFunc("clock_res_get", std::make_unique<WasiClockResGet>(Env));
-  addHostFunc("clock_time_get", std::make_unique<WasiClockTimeGet>(Env));
-  addHostFunc("fd_advise", std::make_unique<WasiFdAdvise>(Env));
-  addHostFunc("fd_allocate", std::make_unique<WasiFdAllocate>(Env));
-  addHostFunc("fd_close", std::make_unique<WasiFdClose>(Env));
-  addHostFunc("fd_datasync", std::make_unique<WasiFdDatasync>(Env));
-  addHostFunc("fd_fdstat_get", std::make_unique<WasiFdFdstatGet>(Env));
-  addHostFunc("fd_fdstat_set_flags",
-              std::make_unique<WasiFdFdstatSetFlags>(Env));
-  addHostFunc("fd_fdstat_set_rights",
-              std::make_unique<WasiFdFdstatSetRights>(Env));
-  addHostFunc("fd_filestat_get", std::make_unique<WasiFdFilestatGet>(Env));
-  addHostFunc("fd_filestat_set_size",
-              std::make_unique<WasiFdFilestatSetSize>(Env));
-  addHostFunc("fd_filestat_set_times",
-              std::make_unique<WasiFdFilestatSetTimes>(Env));
-  addHostFunc("fd_pread", std::make_unique<WasiFdPread>(Env));
-  addHostFunc("fd_prestat_get", std::make_unique<WasiFdPrestatGet>(Env));
-  addHostFunc("fd_prestat_dir_name",
-              std::make_unique<WasiFdPrestatDirName>(Env));
-  addHostFunc("fd_pwrite", std::make_unique<WasiFdPwrite>(Env));
-  addHostFunc("fd_read", std::make_unique<WasiFdRead>(Env));
-  addHostFunc("fd_readdir", std::make_unique<WasiFdReadDir>(Env));
-  addHostFunc("fd_renumber", std::make_unique<WasiFdRenumber>(Env));
-  addHostFunc("fd_seek", std::make_unique<WasiFdSeek>(Env));
-  addHostFunc("fd_sync", std::make_unique<WasiFdSync>(Env));
-  addHostFunc("fd_tell", std::make_unique<WasiFdTell>(Env));
-  addHostFunc("fd_write", std::make_unique<WasiFdWrite>(Env));
-  addHostFunc("path_create_directory",
-              std::make_unique<WasiPathCreateDirectory>(Env));
-  addHostFunc("path_filestat_get", std::make_unique<WasiPathFilestatGet>(Env));
-  addHostFunc("path_filestat_set_times",
-              std::make_unique<WasiPathFilestatSetTimes>(Env));
-  addHostFunc("path_link", std::make_unique<WasiPathLink>(Env));
-  addHostFunc("path_open", std::make_unique<WasiPathOpen>(Env));
-  addHostFunc("path_readlink", std::make_unique<WasiPathReadLink>(Env));
-  addHostFunc("path_remove_directory",
-              std::make_unique<WasiPathRemoveDirectory>(Env));
-  addHostFunc("path_rename", std::make_unique<WasiPathRename>(Env));
-  addHostFunc("path_symlink", std::make_unique<WasiPathSymlink>(Env));
-  addHostFunc("path_unlink_file", std::make_unique<WasiPathUnlinkFile>(Env));
-  addHostFunc("poll_oneoff",
-              std::make_unique<WasiPollOneoff<WASI::TriggerType::Level>>(Env));
-  addHostFunc("epoll_oneoff",
-              std::make_unique<WasiPollOneoff<WASI::TriggerType::Edge>>(Env));
-  addHostFunc("proc_exit", std::make_unique<WasiProcExit>(Env));
-  addHostFunc("proc_raise", std::make_unique<WasiProcRaise>(Env));
-  addHostFunc("sched_yield", std::make_unique<WasiSchedYield>(Env));
-  addHostFunc("random_get", std::make_unique<WasiRandomGet>(Env));
-  // To make the socket API compatible with the old one,
-  // we will duplicate all the API to V1 and V2.
-  // The V1 presents the original behavior before 0.12 release.
-  // On the other hand, the V2 presents the new behavior including
-  // the sock_accept is following the WASI spec, some of the API
-  // use a larger size for handling complex address type, e.g.
-  // AF_UNIX.
-  // By default, we will register V1 first, if the signatures are
-  // not the same as the wasm application imported, then V2 will
-  // replace instead.
-  addHostFunc("sock_open", std::make_unique<WasiSockOpenV1>(Env));
-  addHostFunc("sock_bind", std::make_unique<WasiSockBindV1>(Env));
-  addHostFunc("sock_connect", std::make_unique<WasiSockConnectV1>(Env));
-  addHostFunc("sock_listen", std::make_unique<WasiSockListenV1>(Env));
-  addHostFunc("sock_accept", std::make_unique<WasiSockAcceptV1>(Env));
-  addHostFunc("sock_recv", std::make_unique<WasiSockRecvV1>(Env));
-  addHostFunc("sock_recv_from", std::make_unique<WasiSockRecvFromV1>(Env));
-  addHostFunc("sock_send", std::make_unique<WasiSockSendV1>(Env));
-  addHostFunc("sock_send_to", std::make_unique<WasiSockSendToV1>(Env));
-  addHostFunc("sock_accept_v2", std::make_unique<WasiSockAcceptV2>(Env));
-  addHostFunc("sock_open_v2", std::make_unique<WasiSockOpenV2>(Env));
-  addHostFunc("sock_bind_v2", std::make_unique<WasiSockBindV2>(Env));
-  addHostFunc("sock_connect_v2", std::make_unique<WasiSockConnectV2>(Env));
-  addHostFunc("sock_listen_v2", std::make_unique<WasiSockListenV2>(Env));
-  addHostFunc("sock_recv_v2", std::make_unique<WasiSockRecvV2>(Env));
-  addHostFunc("sock_recv_from_v2", std::make_unique<WasiSockRecvFromV2>(Env));
-  addHostFunc("sock_send_v2", std::make_unique<WasiSockSendV2>(Env));
-  addHostFunc("sock_send_to_v2", std::make_unique<WasiSockSendToV2>(Env));
-  addHostFunc("sock_shutdown", std::make_unique<WasiSockShutdown>(Env));
-  addHostFunc("sock_getsockopt", std::make_unique<WasiSockGetOpt>(Env));
-  addHostFunc("sock_setsockopt", std::make_unique<WasiSockSetOpt>(Env));
-  addHostFunc("sock_getlocaladdr",
-              std::make_unique<WasiSockGetLocalAddrV1>(Env));
-  addHostFunc("sock_getpeeraddr", std::make_unique<WasiSockGetPeerAddrV1>(Env));
-  addHostFunc("sock_getlocaladdr_v2",
-              std::make_unique<WasiSockGetLocalAddrV2>(Env));
-  addHostFunc("sock_getpeeraddr_v2",
-              std::make_unique<WasiSockGetPeerAddrV2>(Env));
-  addHostFunc("sock_getaddrinfo", std::make_unique<WasiSockGetAddrinfo>(Env));
+  const auto &Def = getDefinition();
+  Env.getIOStatistics().setFunctions(Def.Names);
+  for (size_t I = 0; I < Def.Funcs.size(); ++I) {
+    addHostFunc(Def.Names[I], *Def.Funcs[I]);
+  }
 }
 
 } // namespace Host
@@ -3,17 +3,22 @@
 
 #include "llvm/codegen.h"
 
+#include "aot/blake3.h"
 #include "aot/version.h"
 #include "common/defines.h"
 #include "common/hash.h"
 #include "data.h"
 #include "llvm.h"
 
+#include <algorithm>
+#include <array>
 #include <charconv>
+#include <chrono>
 #include <fstream>
 #include <lld/Common/Driver.h>
 #include <random>
 #include <sstream>
+#include <thread>
 
 #if LLVM_VERSION_MAJOR >= 14
 #include <lld/Common/CommonLinkerContext.h>
@@ -51,6 +56,10 @@ namespace {
 
 using namespace WasmEdge;
 
+/// Alignment of the text contents in the universal wasm file, the largest page
+/// size of the supported hosts.
+inline constexpr uint64_t kTextAlignment = UINT64_C(16384);
+
 #if WASMEDGE_OS_MACOS
 // Get current OS version
 std::string getOSVersion() noexcept {
@@ -122,6 +131,16 @@ Expect<void> WriteU32(std::ostream &OS, uint32_t Data) noexcept {
   return {};
 }
 
+// Write the unsigned int in fixed 5 bytes, so the size is known ahead.
+Expect<void> WritePaddedU32(std::ostream &OS, uint32_t Data) noexcept {
+  for (int I = 0; I < 4; ++I) {
+    WriteByte(OS, static_cast<uint8_t>((Data & UINT32_C(0x7f)) | 0x80));
+    Data >>= 7;
+  }
+  WriteByte(OS, static_cast<uint8_t>(Data));
+  return {};
+}
+
 Expect<void> WriteU64(std::ostream &OS, uint64_t Data) noexcept {
   do {
     uint8_t Byte = static_cast<uint8_t>(Data & UINT64_C(0x7f));
@@ -176,11 +195,13 @@ std::filesystem::path createTemp(const std::filesystem::path Model) noexcept {
 }
 
 // Write output object and link
-Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
-                                 const LLVM::MemoryBuffer &OSVec) noexcept {
+Expect<void>
+outputNativeLibrary(const std::filesystem::path &OutputPath,
+                    Span<const LLVM::MemoryBuffer> OSVecs) noexcept {
   spdlog::info("output start"sv);
-  std::filesystem::path ObjectName;
-  {
+  std::vector<std::string> ObjectNames;
+  ObjectNames.reserve(OSVecs.size());
+  for (const auto &OSVec : OSVecs) {
     // tempfile
     std::filesystem::path OPath(OutputPath);
 #if WASMEDGE_OS_WINDOWS
@@ -188,7 +209,7 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 #else
     OPath.replace_extension("%%%%%%%%%%.o"sv);
 #endif
-    ObjectName = createTemp(OPath);
+    auto ObjectName = createTemp(OPath);
     if (ObjectName.empty()) {
       // TODO:return error
       spdlog::error("so file creation failed:{}"sv, OPath.u8string());
@@ -197,55 +218,62 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
     std::ofstream OS(ObjectName, std::ios_base::binary);
     OS.write(OSVec.data(), static_cast<std::streamsize>(OSVec.size()));
     OS.close();
+    ObjectNames.push_back(ObjectName.u8string());
   }
+  const auto OutputName = OutputPath.u8string();
 
   // link
-  bool LinkResult = false;
+  std::vector<const char *> Args;
 #if WASMEDGE_OS_MACOS
   const auto OSVersion = getOSVersion();
   const auto SDKVersion = getSDKVersion();
-#if LLVM_VERSION_MAJOR >= 14
-  // LLVM 14 replaces the older mach_o lld implementation with the new one.
-  // So we need to change the namespace after LLVM 14.x released.
-  // Reference: https://reviews.llvm.org/D114842
-  LinkResult = lld::macho::link(
-#else
-  LinkResult = lld::mach_o::link(
-#endif
-      std::initializer_list<const char *>{
-          "lld", "-arch",
+  Args = {
+      "lld", "-arch",
 #if defined(__x86_64__)
-          "x86_64",
+      "x86_64",
 #elif defined(__aarch64__)
-          "arm64",
+      "arm64",
 #else
 #error Unsupported architecture on the MacOS!
 #endif
 #if LLVM_VERSION_MAJOR >= 14
-          // LLVM 14 replaces the older mach_o lld implementation with the new
-          // one. And it require -arch and -platform_version to always be
-          // specified. Reference: https://reviews.llvm.org/D97799
-          "-platform_version", "macos", OSVersion.c_str(), SDKVersion.c_str(),
+      // LLVM 14 replaces the older mach_o lld implementation with the new
+      // one. And it require -arch and -platform_version to always be
+      // specified. Reference: https://reviews.llvm.org/D97799
+      "-platform_version", "macos", OSVersion.c_str(), SDKVersion.c_str(),
+#else
+      "-sdk_version", SDKVersion.c_str(),
+#endif
+      "-dylib", "-demangle", "-macosx_version_min", OSVersion.c_str(),
+      "-syslibroot", "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
+      "-o", OutputName.c_str()};
+#elif WASMEDGE_OS_LINUX
+  Args = {"ld.lld",        "--eh-frame-hdr", "--shared", "--gc-sections",
+          "--discard-all", "-o",             OutputName.c_str()};
+#elif WASMEDGE_OS_WINDOWS
+  const auto OutArg = "-out:" + OutputName;
+  Args = {"lld-link", "-dll", "-base:0", "-nologo", OutArg.c_str()};
+#endif
+  for (const auto &ObjectName : ObjectNames) {
+    Args.push_back(ObjectName.c_str());
+  }
+
+  bool LinkResult = false;
+#if WASMEDGE_OS_MACOS
+#if LLVM_VERSION_MAJOR >= 14
+  // LLVM 14 replaces the older mach_o lld implementation with the new one.
+  // So we need to change the namespace after LLVM 14.x released.
+  // Reference: https://reviews.llvm.org/D114842
+  LinkResult = lld::macho::link(
 #else
-          "-sdk_version", SDKVersion.c_str(),
+  LinkResult = lld::mach_o::link(
 #endif
-          "-dylib", "-demangle", "-macosx_version_min", OSVersion.c_str(),
-          "-syslibroot", "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
-          ObjectName.u8string().c_str(), "-o", OutputPath.u8string().c_str()},
 #elif WASMEDGE_OS_LINUX
   LinkResult = lld::elf::link(
-      std::initializer_list<const char *>{"ld.lld", "--eh-frame-hdr",
-                                          "--shared", "--gc-sections",
-                                          "--discard-all", ObjectName.c_str(),
-                                          "-o", OutputPath.u8string().c_str()},
 #elif WASMEDGE_OS_WINDOWS
   LinkResult = lld::coff::link(
-      std::initializer_list<const char *>{
-          "lld-link", "-dll", "-base:0", "-nologo",
-          ObjectName.u8string().c_str(),
-          ("-out:" + OutputPath.u8string()).c_str()},
 #endif
-
+      Args,
 #if LLVM_VERSION_MAJOR >= 14
       llvm::outs(), llvm::errs(), false, false
 #elif LLVM_VERSION_MAJOR >= 10
@@ -261,7 +289,9 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
 
   if (LinkResult) {
     std::error_code Error;
-    std::filesystem::remove(ObjectName, Error);
+    for (const auto &ObjectName : ObjectNames) {
+      std::filesystem::remove(std::filesystem::u8path(ObjectName), Error);
+    }
 #if WASMEDGE_OS_WINDOWS
     std::filesystem::path LibPath(OutputPath);
     LibPath.replace_extension(".lib"sv);
@@ -296,10 +326,38 @@ Expect<void> outputNativeLibrary(const std::filesystem::path &OutputPath,
   return {};
 }
 
+void storeCachedObject(LLVM::Data::DataContext &Part,
+                       LLVM::MemoryBuffer &Object) noexcept {
+  const Span<const Byte> Data(reinterpret_cast<const Byte *>(Object.data()),
+                              Object.size());
+  AOT::Cache::publish(Part.CachePath, Data);
+  // Let the processes waiting for the function load it.
+  Part.CacheLock = {};
+  AOT::Cache::upload(Part.CachePath, Part.CacheTarget, Data);
+}
+
+// Record the sizes of the function symbols in the object.
+void recordCodeSizes(LLVM::CompileReport &Report, LLVM::Context LLContext,
+                     LLVM::MemoryBuffer &Object) noexcept {
+  auto [ObjFile, ErrorMessage] = LLVM::Binary::create(Object, LLContext);
+  if (unlikely(ErrorMessage)) {
+    return;
+  }
+  for (auto Symbol = ObjFile.symbols(); Symbol && !ObjFile.isSymbolEnd(Symbol);
+       Symbol.next()) {
+    std::string_view Name = Symbol.getName();
+    if (startsWith(Name, SYMBOL(""sv))) {
+      Name.remove_prefix(SYMBOL(""sv).size());
+      Report.recordCodeSize(Name, Symbol.getSize());
+    }
+  }
+}
+
 Expect<void> outputWasmLibrary(LLVM::Context LLContext,
                                const std::filesystem::path &OutputPath,
                                Span<const Byte> Data,
-                               const LLVM::MemoryBuffer &OSVec) noexcept {
+                               Span<const LLVM::MemoryBuffer> OSVecs,
+                               [[maybe_unused]] uint8_t TargetLevel) noexcept {
   std::filesystem::path SharedObjectName;
   {
     // tempfile
@@ -311,12 +369,9 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
       spdlog::error("so file creation failed:{}"sv, SOPath.u8string());
       return Unexpect(ErrCode::Value::IllegalPath);
     }
-    std::ofstream OS(SharedObjectName, std::ios_base::binary);
-    OS.write(OSVec.data(), static_cast<std::streamsize>(OSVec.size()));
-    OS.close();
   }
 
-  EXPECTED_TRY(outputNativeLibrary(SharedObjectName, OSVec));
+  EXPECTED_TRY(outputNativeLibrary(SharedObjectName, OSVecs));
 
   LLVM::MemoryBuffer SOFile;
   if (auto [Res, ErrorMessage] =
@@ -367,6 +422,19 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
 #error Unsupported hardware architecture!
 #endif
 
+#if defined(__x86_64__)
+    WriteByte(OS, TargetLevel);
+#else
+    WriteByte(OS, UINT8_C(0));
+#endif
+
+    // Hash of the module bytes before the section, checked by the trusted AOT
+    // loading mode.
+    std::array<Byte, 32> ModuleHash;
+    AOT::Blake3::hash(Data, ModuleHash);
+    OS.write(reinterpret_cast<const char *>(ModuleHash.data()),
+             static_cast<std::streamsize>(ModuleHash.size()));
+
     std::vector<std::pair<std::string, uint64_t>> SymbolTable;
 #if !WASMEDGE_OS_WINDOWS
     for (auto Symbol = ObjFile.symbols();
@@ -444,6 +512,10 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
         continue;
       }
       ++SectionCount;
+      if (Section.isText()) {
+        // The padding before the text content.
+        ++SectionCount;
+      }
     }
     WriteU32(OS, SectionCount);
 
@@ -463,6 +535,25 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
       if (Section.isEHFrame() || Section.isPData()) {
         WriteByte(OS, UINT8_C(4));
       } else if (Section.isText()) {
+        // Pad the content to the same offset in the file as in the memory
+        // modulo the page size, so the loader can map the file pages directly.
+        // Before the content are the custom section id and padded size, the
+        // padding header, and the section header.
+        std::ostringstream Header;
+        WriteByte(Header, UINT8_C(1));
+        WriteU64(Header, Section.getAddress());
+        WriteU64(Header, Content.size());
+        WriteU32(Header, static_cast<uint32_t>(Content.size()));
+        const uint64_t ContentOffset = Data.size() + 6 +
+                                       static_cast<uint64_t>(OS.tellp()) + 8 +
+                                       Header.str().size();
+        const auto Padding = static_cast<uint32_t>(
+            (Section.getAddress() - ContentOffset) & (kTextAlignment - 1));
+        WriteByte(OS, UINT8_C(0));
+        WriteU64(OS, UINT64_C(0));
+        WriteU64(OS, UINT64_C(0));
+        WritePaddedU32(OS, Padding);
+        OS << std::string(Padding, '\0');
         WriteByte(OS, UINT8_C(1));
       } else if (Section.isData()) {
         WriteByte(OS, UINT8_C(2));
@@ -490,7 +581,9 @@ Expect<void> outputWasmLibrary(LLVM::Context LLContext,
            static_cast<std::streamsize>(Data.size()));
   // Custom section id
   WriteByte(OS, UINT8_C(0x00));
-  WriteName(OS, std::string_view(OSCustomSecVec.data(), OSCustomSecVec.size()));
+  WritePaddedU32(OS, static_cast<uint32_t>(OSCustomSecVec.size()));
+  OS.write(OSCustomSecVec.data(),
+           static_cast<std::streamsize>(OSCustomSecVec.size()));
 
   std::error_code Error;
   std::filesystem::remove(SharedObjectName, Error);
@@ -507,7 +600,6 @@ Expect<void> CodeGen::codegen(Span<const Byte> WasmData, Data D,
                               std::filesystem::path OutputPath) noexcept {
   auto LLContext = D.extract().getLLContext();
   auto &LLModule = D.extract().LLModule;
-  auto &TM = D.extract().TM;
   std::filesystem::path LLPath(OutputPath);
   LLPath.replace_extension("ll"sv);
 
@@ -537,16 +629,23 @@ Expect<void> CodeGen::codegen(Span<const Byte> WasmData, Data D,
     A.setDSOLocal(true);
   }
 #endif
+  std::vector<Data::DataContext *> Parts = {&D.extract()};
+  for (auto &Part : D.extract().Partitions) {
+    Parts.push_back(Part.get());
+  }
+
 #if WASMEDGE_OS_MACOS
-  {
+  for (auto *Part : Parts) {
     const auto [Major, Minor] = getSDKVersionPair();
-    LLModule.addFlag(LLVMModuleFlagBehaviorError, "SDK Version"sv,
-                     LLVM::Value::getConstVector32(LLContext, {Major, Minor}));
+    Part->LLModule.addFlag(
+        LLVMModuleFlagBehaviorError, "SDK Version"sv,
+        LLVM::Value::getConstVector32(Part->getLLContext(), {Major, Minor}));
   }
 #endif
 
-  if (Conf.getCompilerConfigure().getOutputFormat() !=
-      CompilerConfigure::OutputFormat::Wasm) {
+  const bool IsWasmFormat = Conf.getCompilerConfigure().getOutputFormat() ==
+                            CompilerConfigure::OutputFormat::Wasm;
+  if (!IsWasmFormat) {
     // create wasm.code and wasm.size
     auto Int32Ty = LLContext.getInt32Ty();
     auto Content = LLVM::Value::getConstString(
@@ -558,65 +657,134 @@ Expect<void> CodeGen::codegen(Span<const Byte> WasmData, Data D,
     LLModule.addGlobal(Int32Ty, true, LLVMExternalLinkage,
                        LLVM::Value::getConstInt(Int32Ty, WasmData.size()),
                        "wasm.size");
-    for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
-      if (Fn.getLinkage() == LLVMInternalLinkage) {
-        Fn.setLinkage(LLVMExternalLinkage);
-        Fn.setVisibility(LLVMProtectedVisibility);
-        Fn.setDSOLocal(true);
-        Fn.setDLLStorageClass(LLVMDLLExportStorageClass);
+  }
+
+  for (size_t I = 0; I < Parts.size(); ++I) {
+    auto &PartModule = Parts[I]->LLModule;
+    if (!IsWasmFormat) {
+      for (auto Fn = PartModule.getFirstFunction(); Fn;
+           Fn = Fn.getNextFunction()) {
+        if (Fn.getLinkage() == LLVMInternalLinkage) {
+          Fn.setLinkage(LLVMExternalLinkage);
+          Fn.setVisibility(LLVMProtectedVisibility);
+          Fn.setDSOLocal(true);
+          Fn.setDLLStorageClass(LLVMDLLExportStorageClass);
+        }
       }
-    }
-  } else {
-    for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
-      if (Fn.getLinkage() == LLVMInternalLinkage) {
-        Fn.setLinkage(LLVMPrivateLinkage);
-        Fn.setDSOLocal(true);
-        Fn.setDLLStorageClass(LLVMDefaultStorageClass);
+    } else {
+      for (auto Fn = PartModule.getFirstFunction(); Fn;
+           Fn = Fn.getNextFunction()) {
+        if (Fn.getLinkage() == LLVMInternalLinkage) {
+          Fn.setLinkage(LLVMPrivateLinkage);
+          Fn.setDSOLocal(true);
+          Fn.setDLLStorageClass(LLVMDefaultStorageClass);
+        }
       }
     }
-  }
 
-  // set dllexport
-  for (auto GV = LLModule.getFirstGlobal(); GV; GV = GV.getNextGlobal()) {
-    if (GV.getLinkage() == LLVMExternalLinkage) {
-      GV.setVisibility(LLVMProtectedVisibility);
-      GV.setDSOLocal(true);
-      GV.setDLLStorageClass(LLVMDLLExportStorageClass);
+    // set dllexport
+    for (auto GV = PartModule.getFirstGlobal(); GV; GV = GV.getNextGlobal()) {
+      if (GV.getLinkage() == LLVMExternalLinkage) {
+        GV.setVisibility(LLVMProtectedVisibility);
+        GV.setDSOLocal(true);
+        GV.setDLLStorageClass(LLVMDLLExportStorageClass);
+      }
     }
-  }
 
-  if (Conf.getCompilerConfigure().isDumpIR()) {
-    if (auto ErrorMessage = LLModule.printModuleToFile("wasm.ll");
-        unlikely(ErrorMessage)) {
-      spdlog::error("wasm.ll open error:{}"sv, ErrorMessage.string_view());
-      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalPath);
+    if (Conf.getCompilerConfigure().isDumpIR()) {
+      const auto Name =
+          I == 0 ? "wasm.ll"s : fmt::format("wasm.{}.ll"sv, I);
+      if (auto ErrorMessage = PartModule.printModuleToFile(Name.c_str());
+          unlikely(ErrorMessage)) {
+        spdlog::error("{} open error:{}"sv, Name, ErrorMessage.string_view());
+        return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalPath);
+      }
     }
   }
 
   spdlog::info("codegen start"sv);
+  const auto CodegenStart = std::chrono::steady_clock::now();
   // codegen
   {
     if (Conf.getCompilerConfigure().isDumpIR()) {
-      if (auto ErrorMessage = LLModule.printModuleToFile("wasm-opt.ll")) {
-        // TODO:return error
-        spdlog::error("printModuleToFile failed"sv);
-        return Unexpect(ErrCode::Value::IllegalPath);
+      for (size_t I = 0; I < Parts.size(); ++I) {
+        const auto Name =
+            I == 0 ? "wasm-opt.ll"s : fmt::format("wasm-opt.{}.ll"sv, I);
+        if (auto ErrorMessage =
+                Parts[I]->LLModule.printModuleToFile(Name.c_str())) {
+          // TODO:return error
+          spdlog::error("printModuleToFile failed"sv);
+          return Unexpect(ErrCode::Value::IllegalPath);
+        }
       }
     }
 
-    auto [OSVec, ErrorMessage] =
-        TM.emitToMemoryBuffer(LLModule, LLVMObjectFile);
-    if (ErrorMessage) {
+    // Each partition has its own context and target machine, so the objects
+    // can be emitted in parallel and linked together afterwards.
+    std::vector<LLVM::MemoryBuffer> OSVecs(Parts.size());
+    std::vector<char> Failed(Parts.size(), false);
+    parallelFor(Parts.size(), [&](size_t I) noexcept {
+      const auto Start = std::chrono::steady_clock::now();
+      auto [OSVec, ErrorMessage] = Parts[I]->TM.emitToMemoryBuffer(
+          Parts[I]->LLModule, LLVMObjectFile);
+      if (ErrorMessage) {
+        Failed[I] = true;
+      } else {
+        OSVecs[I] = std::move(OSVec);
+        if (Report) {
+          std::vector<std::string> Names;
+          for (auto Fn = Parts[I]->LLModule.getFirstFunction(); Fn;
+               Fn = Fn.getNextFunction()) {
+            if (!Fn.isDeclaration()) {
+              Names.emplace_back(Fn.getName());
+            }
+          }
+          Report->recordCodegen(Names,
+                                std::chrono::steady_clock::now() - Start);
+        }
+      }
+    });
+    if (std::any_of(Failed.begin(), Failed.end(),
+                    [](char F) { return F; })) {
       // TODO:return error
       spdlog::error("addPassesToEmitFile failed"sv);
       return Unexpect(ErrCode::Value::IllegalPath);
     }
 
-    if (Conf.getCompilerConfigure().getOutputFormat() ==
-        CompilerConfigure::OutputFormat::Wasm) {
-      EXPECTED_TRY(outputWasmLibrary(LLContext, OutputPath, WasmData, OSVec));
+    // Store the newly compiled functions into the function cache, a failure
+    // only costs a recompilation next time.
+    std::filesystem::path CacheDir;
+    for (size_t I = 0; I < Parts.size(); ++I) {
+      if (!Parts[I]->CachePath.empty()) {
+        storeCachedObject(*Parts[I], OSVecs[I]);
+        CacheDir = Parts[I]->CachePath.parent_path();
+      }
+    }
+    if (!CacheDir.empty()) {
+      AOT::Cache::evict(CacheDir);
+    }
+    for (auto &Object : D.extract().CachedObjects) {
+      OSVecs.push_back(std::move(Object));
+    }
+    if (Report) {
+      Report->recordPhase("codegen"sv,
+                          std::chrono::steady_clock::now() - CodegenStart);
+      for (auto &Object : OSVecs) {
+        recordCodeSizes(*Report, LLContext, Object);
+      }
+    }
+    const auto LinkStart = std::chrono::steady_clock::now();
+
+    if (IsWasmFormat) {
+      EXPECTED_TRY(
+          outputWasmLibrary(LLContext, OutputPath, WasmData, OSVecs,
+                            Conf.getCompilerConfigure().getTargetLevel()));
     } else {
-      EXPECTED_TRY(outputNativeLibrary(OutputPath, OSVec));
+      EXPECTED_TRY(outputNativeLibrary(OutputPath, OSVecs));
+    }
+    if (Report) {
+      Report->recordPhase("link"sv,
+                          std::chrono::steady_clock::now() - LinkStart);
     }
   }
 
@@ -3,9 +3,11 @@
 
 #include "llvm/compiler.h"
 
+#include "aot/cache.h"
 #include "aot/version.h"
 #include "common/defines.h"
 #include "common/filesystem.h"
+#include "common/metrics.h"
 #include "common/spdlog.h"
 #include "data.h"
 #include "llvm.h"
@@ -13,15 +15,20 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cinttypes>
 #include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
 
 namespace LLVM = WasmEdge::LLVM;
 using namespace std::literals;
@@ -58,6 +65,56 @@ static inline constexpr const bool kForceDivCheck = true;
 // Size of a ValVariant
 static inline constexpr const uint32_t kValSize = sizeof(WasmEdge::ValVariant);
 
+// Size of a memory page
+static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
+
+/// Whether the instruction never branches or traps, so that its instruction
+/// count and cost can be added together with the following instructions.
+static inline bool isStraightLine(WasmEdge::OpCode Code) noexcept {
+  using WasmEdge::OpCode;
+  switch (Code) {
+  case OpCode::Nop:
+  case OpCode::Drop:
+  case OpCode::Select:
+  case OpCode::Select_t:
+  case OpCode::Local__get:
+  case OpCode::Local__set:
+  case OpCode::Local__tee:
+  case OpCode::Global__get:
+  case OpCode::Global__set:
+    return true;
+  // Division and truncation trap on the invalid operands.
+  case OpCode::I32__div_s:
+  case OpCode::I32__div_u:
+  case OpCode::I32__rem_s:
+  case OpCode::I32__rem_u:
+  case OpCode::I64__div_s:
+  case OpCode::I64__div_u:
+  case OpCode::I64__rem_s:
+  case OpCode::I64__rem_u:
+  case OpCode::I32__trunc_f32_s:
+  case OpCode::I32__trunc_f32_u:
+  case OpCode::I32__trunc_f64_s:
+  case OpCode::I32__trunc_f64_u:
+  case OpCode::I64__trunc_f32_s:
+  case OpCode::I64__trunc_f32_u:
+  case OpCode::I64__trunc_f64_s:
+  case OpCode::I64__trunc_f64_u:
+    return false;
+  default:
+    // The other numeric instructions.
+    return Code >= OpCode::I32__const && Code <= OpCode::I64__extend32_s;
+  }
+}
+
+// Limits of dispatching the `call_indirect` instruction on a static table by a
+// switch of direct calls
+static inline constexpr const uint32_t kMaxStaticTableSize = 4096;
+static inline constexpr const size_t kMaxStaticCallTargets = 16;
+// Time to wait for another process compiling the same function, after which
+// the function is compiled again
+static inline constexpr const std::chrono::seconds kFunctionCacheWait{60};
+
 // Translate Compiler::OptimizationLevel to llvm::PassBuilder version
 #if LLVM_VERSION_MAJOR >= 13
 static inline const char *
@@ -123,11 +180,54 @@ static inline LLVMCodeGenOptLevel toLLVMCodeGenLevel(
     assumingUnreachable();
   }
 }
+
+// LLVM features added by the x86-64 micro-architecture levels 2 to 4 over the
+// previous level.
+static inline constexpr const std::array<std::string_view, 3>
+    kX86LevelFeatures = {
+        "+cx16,+sahf,+popcnt,+sse3,+sse4.1,+sse4.2,+ssse3"sv,
+        "+avx,+avx2,+bmi,+bmi2,+f16c,+fma,+lzcnt,+movbe,+xsave"sv,
+        "+avx512f,+avx512bw,+avx512cd,+avx512dq,+avx512vl"sv,
+};
+
+/// Target CPU name and features of the generated code.
+struct TargetCPU {
+  std::string Name;
+  std::string Features;
+};
+
+TargetCPU getTargetCPU(const WasmEdge::CompilerConfigure &Conf) noexcept {
+  TargetCPU Target;
+#if defined(__x86_64__)
+  if (const auto Level = Conf.getTargetLevel(); Level > 0) {
+    Target.Name = Level == 1 ? "x86-64"s : fmt::format("x86-64-v{}"sv, Level);
+    for (uint8_t I = 2; I <= Level; ++I) {
+      if (!Target.Features.empty()) {
+        Target.Features += ',';
+      }
+      Target.Features += kX86LevelFeatures[I - 2];
+    }
+    return Target;
+  }
+#endif
+#if defined(__riscv) && __riscv_xlen == 64
+  Target.Name = "generic-rv64"s;
+#else
+  if (!Conf.isGenericBinary()) {
+    Target.Name = LLVM::getHostCPUName().string_view();
+  } else {
+    Target.Name = "generic"s;
+  }
+#endif
+  Target.Features = LLVM::getHostCPUFeatures().string_view();
+  return Target;
+}
 } // namespace
 
 struct LLVM::Compiler::CompileContext {
   LLVM::Context LLContext;
   LLVM::Module &LLModule;
+  LLVM::Attribute AlwaysInline;
   LLVM::Attribute Cold;
   LLVM::Attribute NoAlias;
   LLVM::Attribute NoInline;
@@ -136,6 +236,7 @@ struct LLVM::Compiler::CompileContext {
   LLVM::Attribute StrictFP;
   LLVM::Attribute UWTable;
   LLVM::Attribute NoStackArgProbe;
+  LLVM::Attribute ProbeStack;
   LLVM::Type VoidTy;
   LLVM::Type Int8Ty;
   LLVM::Type Int16Ty;
@@ -156,11 +257,12 @@ struct LLVM::Compiler::CompileContext {
   LLVM::Type Int64PtrTy;
   LLVM::Type Int128PtrTy;
   LLVM::Type Int8PtrPtrTy;
+  LLVM::Type NativeEntryTy;
+  LLVM::Type NativeTableTy;
   LLVM::Type ExecCtxTy;
   LLVM::Type ExecCtxPtrTy;
   LLVM::Type IntrinsicsTableTy;
   LLVM::Type IntrinsicsTablePtrTy;
-  LLVM::Message SubtargetFeatures;
 
 #if defined(__x86_64__)
 #if defined(__XOP__)
@@ -186,6 +288,18 @@ struct LLVM::Compiler::CompileContext {
 #else
   bool SupportSSE2 = false;
 #endif
+
+#if defined(__FMA__)
+  bool SupportFMA = true;
+#else
+  bool SupportFMA = false;
+#endif
+
+#if defined(__AVXVNNI__) || (defined(__AVX512VNNI__) && defined(__AVX512VL__))
+  bool SupportVNNI = true;
+#else
+  bool SupportVNNI = false;
+#endif
 #endif
 
 #if defined(__aarch64__)
@@ -194,6 +308,12 @@ struct LLVM::Compiler::CompileContext {
 #else
   bool SupportNEON = false;
 #endif
+
+#if defined(__ARM_FEATURE_DOTPROD)
+  bool SupportDotProd = true;
+#else
+  bool SupportDotProd = false;
+#endif
 #endif
 
   std::vector<const AST::CompositeType *> CompositeTypes;
@@ -201,12 +321,32 @@ struct LLVM::Compiler::CompileContext {
   std::vector<std::tuple<uint32_t, LLVM::FunctionCallee,
                          const WasmEdge::AST::CodeSegment *>>
       Functions;
+  /// Types of the globals, and the count of the imported globals. The
+  /// defined globals are stored contiguously after the imported ones.
   std::vector<LLVM::Type> Globals;
+  uint32_t ImportGlobalNum = 0;
+  /// Minimum sizes in bytes of the memories. The memories never shrink while
+  /// running, so the accesses under them need no bounds checks.
+  std::vector<uint64_t> MemorySizes;
+  /// Function types of the tags, and the count of the imported tags. The
+  /// calls check the pending exception only if the module has tags.
+  std::vector<const AST::FunctionType *> Tags;
+  uint32_t ImportTagNum = 0;
   LLVM::Value IntrinsicsTable;
   LLVM::FunctionCallee Trap;
+  /// Execution profile guiding the optimizations, or nullptr.
+  const Statistics::Profile *Prof = nullptr;
+  /// Function indices keyed by the offsets of their bodies, for the indirect
+  /// call targets in the profile.
+  std::unordered_map<uint32_t, uint32_t> FunctionOffsets;
+  /// Function indices in the static tables, with UINT32_MAX for the null
+  /// references, or std::nullopt for the other tables.
+  std::vector<std::optional<std::vector<uint32_t>>> StaticTables;
   CompileContext(LLVM::Context C, LLVM::Module &M,
-                 bool IsGenericBinary) noexcept
+                 std::string_view Features) noexcept
       : LLContext(C), LLModule(M),
+        AlwaysInline(
+            LLVM::Attribute::createEnum(C, LLVM::Core::AlwaysInline, 0)),
         Cold(LLVM::Attribute::createEnum(C, LLVM::Core::Cold, 0)),
         NoAlias(LLVM::Attribute::createEnum(C, LLVM::Core::NoAlias, 0)),
         NoInline(LLVM::Attribute::createEnum(C, LLVM::Core::NoInline, 0)),
@@ -217,6 +357,8 @@ struct LLVM::Compiler::CompileContext {
                                             LLVM::Core::UWTableDefault)),
         NoStackArgProbe(
             LLVM::Attribute::createString(C, "no-stack-arg-probe"sv, {})),
+        ProbeStack(LLVM::Attribute::createString(C, "probe-stack"sv,
+                                                 "inline-asm"sv)),
         VoidTy(LLContext.getVoidTy()), Int8Ty(LLContext.getInt8Ty()),
         Int16Ty(LLContext.getInt16Ty()), Int32Ty(LLContext.getInt32Ty()),
         Int64Ty(LLContext.getInt64Ty()), Int128Ty(LLContext.getInt128Ty()),
@@ -232,6 +374,11 @@ struct LLVM::Compiler::CompileContext {
         Int64PtrTy(Int64Ty.getPointerTo()),
         Int128PtrTy(Int128Ty.getPointerTo()),
         Int8PtrPtrTy(Int8PtrTy.getPointerTo()),
+        NativeEntryTy(LLVM::Type::getStructType(
+            std::initializer_list<LLVM::Type>{Int64Ty, Int8PtrTy})),
+        NativeTableTy(LLVM::Type::getStructType(
+            std::initializer_list<LLVM::Type>{NativeEntryTy.getPointerTo(),
+                                              Int64Ty})),
         ExecCtxTy(LLVM::Type::getStructType(
             "ExecCtx",
             std::initializer_list<LLVM::Type>{
@@ -250,6 +397,24 @@ struct LLVM::Compiler::CompileContext {
                 Int64Ty,
                 // StopToken
                 Int32PtrTy,
+                // Epoch
+                Int64PtrTy,
+                // EpochDeadline
+                Int64PtrTy,
+                // Tags
+                Int8PtrPtrTy,
+                // ExceptionTag
+                Int8PtrPtrTy,
+                // ExceptionValues
+                Int128PtrTy,
+                // Tables
+                NativeTableTy.getPointerTo().getPointerTo(),
+                // TypeIds
+                Int64PtrTy,
+                // GlobalValues
+                Int128PtrTy,
+                // MemorySizes
+                Int64PtrTy.getPointerTo(),
             })),
         ExecCtxPtrTy(ExecCtxTy.getPointerTo()),
         IntrinsicsTableTy(LLVM::Type::getArrayType(
@@ -273,42 +438,63 @@ struct LLVM::Compiler::CompileContext {
                        LLVM::Value::getConstInt(Int32Ty, AOT::kBinaryVersion),
                        "version");
 
-    if (!IsGenericBinary) {
-      SubtargetFeatures = LLVM::getHostCPUFeatures();
-      auto Features = SubtargetFeatures.string_view();
-      while (!Features.empty()) {
-        std::string_view Feature;
-        if (auto Pos = Features.find(','); Pos != std::string_view::npos) {
-          Feature = Features.substr(0, Pos);
-          Features = Features.substr(Pos + 1);
-        } else {
-          Feature = std::exchange(Features, std::string_view());
-        }
-        if (Feature[0] != '+') {
-          continue;
-        }
-        Feature = Feature.substr(1);
+#if defined(__x86_64__)
+    bool SupportAVX512VNNI = false;
+    bool SupportAVX512VL = false;
+#endif
+    while (!Features.empty()) {
+      std::string_view Feature;
+      if (auto Pos = Features.find(','); Pos != std::string_view::npos) {
+        Feature = Features.substr(0, Pos);
+        Features = Features.substr(Pos + 1);
+      } else {
+        Feature = std::exchange(Features, std::string_view());
+      }
+      if (Feature[0] != '+') {
+        continue;
+      }
+      Feature = Feature.substr(1);
 
 #if defined(__x86_64__)
-        if (!SupportXOP && Feature == "xop"sv) {
-          SupportXOP = true;
-        }
-        if (!SupportSSE4_1 && Feature == "sse4.1"sv) {
-          SupportSSE4_1 = true;
-        }
-        if (!SupportSSSE3 && Feature == "ssse3"sv) {
-          SupportSSSE3 = true;
-        }
-        if (!SupportSSE2 && Feature == "sse2"sv) {
-          SupportSSE2 = true;
-        }
+      if (!SupportXOP && Feature == "xop"sv) {
+        SupportXOP = true;
+      }
+      if (!SupportSSE4_1 && Feature == "sse4.1"sv) {
+        SupportSSE4_1 = true;
+      }
+      if (!SupportSSSE3 && Feature == "ssse3"sv) {
+        SupportSSSE3 = true;
+      }
+      if (!SupportSSE2 && Feature == "sse2"sv) {
+        SupportSSE2 = true;
+      }
+      if (!SupportFMA && Feature == "fma"sv) {
+        SupportFMA = true;
+      }
+      if (!SupportVNNI && Feature == "avxvnni"sv) {
+        SupportVNNI = true;
+      }
+      if (Feature == "avx512vnni"sv) {
+        SupportAVX512VNNI = true;
+      }
+      if (Feature == "avx512vl"sv) {
+        SupportAVX512VL = true;
+      }
 #elif defined(__aarch64__)
-        if (!SupportNEON && Feature == "neon"sv) {
-          SupportNEON = true;
-        }
-#endif
+      if (!SupportNEON && Feature == "neon"sv) {
+        SupportNEON = true;
+      }
+      if (!SupportDotProd && Feature == "dotprod"sv) {
+        SupportDotProd = true;
       }
+#endif
+    }
+#if defined(__x86_64__)
+    // The 128-bit forms of the AVX-512 VNNI instructions need AVX-512 VL.
+    if (SupportAVX512VNNI && SupportAVX512VL) {
+      SupportVNNI = true;
     }
+#endif
 
     {
       // create trap
@@ -344,10 +530,27 @@ struct LLVM::Compiler::CompileContext {
 #endif
     return Builder.createBitCast(VPtr, Int8PtrTy);
   }
+  LLVM::Value getMemorySize(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                            uint32_t Index) noexcept {
+    auto Array = Builder.createExtractValue(ExecCtx, 15);
+    auto SizePtr = Builder.createLoad(
+        Int64PtrTy, Builder.createInBoundsGEP1(Int64PtrTy, Array,
+                                               LLContext.getInt64(Index)));
+    SizePtr.setMetadata(LLContext, LLVM::Core::InvariantGroup,
+                        LLVM::Metadata(LLContext, {}));
+    return Builder.createLoad(Int64Ty, SizePtr);
+  }
   std::pair<LLVM::Type, LLVM::Value> getGlobal(LLVM::Builder &Builder,
                                                LLVM::Value ExecCtx,
                                                uint32_t Index) noexcept {
     auto Ty = Globals[Index];
+    if (Index >= ImportGlobalNum) {
+      // The defined globals are at the fixed offsets of the values.
+      auto Values = Builder.createExtractValue(ExecCtx, 14);
+      auto VPtr = Builder.createConstInBoundsGEP1_64(Int128Ty, Values,
+                                                     Index - ImportGlobalNum);
+      return {Ty, Builder.createBitCast(VPtr, Ty.getPointerTo())};
+    }
     auto Array = Builder.createExtractValue(ExecCtx, 1);
     auto VPtr = Builder.createLoad(
         Int128PtrTy, Builder.createInBoundsGEP1(Int8PtrTy, Array,
@@ -376,6 +579,55 @@ struct LLVM::Compiler::CompileContext {
                            LLVM::Value ExecCtx) noexcept {
     return Builder.createExtractValue(ExecCtx, 6);
   }
+  LLVM::Value getEpoch(LLVM::Builder &Builder, LLVM::Value ExecCtx) noexcept {
+    return Builder.createExtractValue(ExecCtx, 7);
+  }
+  LLVM::Value getEpochDeadline(LLVM::Builder &Builder,
+                               LLVM::Value ExecCtx) noexcept {
+    return Builder.createExtractValue(ExecCtx, 8);
+  }
+  LLVM::Value getTag(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                     uint32_t Index) noexcept {
+    auto Array = Builder.createExtractValue(ExecCtx, 9);
+    auto VPtr = Builder.createLoad(
+        Int8PtrTy, Builder.createInBoundsGEP1(Int8PtrTy, Array,
+                                              LLContext.getInt64(Index)));
+    VPtr.setMetadata(LLContext, LLVM::Core::InvariantGroup,
+                     LLVM::Metadata(LLContext, {}));
+    return VPtr;
+  }
+  LLVM::Value getExceptionTag(LLVM::Builder &Builder,
+                              LLVM::Value ExecCtx) noexcept {
+    return Builder.createExtractValue(ExecCtx, 10);
+  }
+  LLVM::Value getExceptionValue(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                                uint32_t Index, LLVM::Type Ty) noexcept {
+    auto Array = Builder.createExtractValue(ExecCtx, 11);
+    auto VPtr = Builder.createInBoundsGEP1(Int128Ty, Array,
+                                           LLContext.getInt64(Index));
+    return Builder.createBitCast(VPtr, Ty.getPointerTo());
+  }
+  LLVM::Value getNativeTable(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                             uint32_t Index) noexcept {
+    auto PtrTy = NativeTableTy.getPointerTo();
+    auto Array = Builder.createExtractValue(ExecCtx, 12);
+    auto VPtr = Builder.createLoad(
+        PtrTy,
+        Builder.createInBoundsGEP1(PtrTy, Array, LLContext.getInt64(Index)));
+    VPtr.setMetadata(LLContext, LLVM::Core::InvariantGroup,
+                     LLVM::Metadata(LLContext, {}));
+    return VPtr;
+  }
+  LLVM::Value getNativeTypeId(LLVM::Builder &Builder, LLVM::Value ExecCtx,
+                              uint32_t Index) noexcept {
+    auto Array = Builder.createExtractValue(ExecCtx, 13);
+    auto Id = Builder.createLoad(
+        Int64Ty,
+        Builder.createInBoundsGEP1(Int64Ty, Array, LLContext.getInt64(Index)));
+    Id.setMetadata(LLContext, LLVM::Core::InvariantGroup,
+                   LLVM::Metadata(LLContext, {}));
+    return Id;
+  }
   LLVM::FunctionCallee getIntrinsic(LLVM::Builder &Builder,
                                     Executable::Intrinsics Index,
                                     LLVM::Type Ty) noexcept {
@@ -515,9 +767,10 @@ public:
   FunctionCompiler(LLVM::Compiler::CompileContext &Context,
                    LLVM::FunctionCallee F, Span<const ValType> Locals,
                    bool Interruptible, bool InstructionCounting,
-                   bool GasMeasuring) noexcept
+                   bool GasMeasuring, bool CoarseGasCheck) noexcept
       : Context(Context), LLContext(Context.LLContext),
-        Interruptible(Interruptible), F(F), Builder(LLContext) {
+        Interruptible(Interruptible), CoarseGasCheck(CoarseGasCheck), F(F),
+        Builder(LLContext) {
     if (F.Fn) {
       Builder.positionAtEnd(LLVM::BasicBlock::create(LLContext, F.Fn, "entry"));
       ExecCtx = Builder.createLoad(Context.ExecCtxTy, F.Fn.getFirstParam());
@@ -558,13 +811,75 @@ public:
     return BB;
   }
 
+  void setBranchWeights(LLVM::Value Br, uint64_t Taken,
+                        uint64_t NotTaken) noexcept {
+    // The weights are 32-bit, so scale down the large counts.
+    const uint64_t Scale =
+        std::max(Taken, NotTaken) / std::numeric_limits<uint32_t>::max() + 1;
+    LLVM::Metadata Weights[] = {
+        LLVM::Metadata::getString(LLContext, "branch_weights"sv),
+        LLContext.getInt32(static_cast<uint32_t>(Taken / Scale)),
+        LLContext.getInt32(static_cast<uint32_t>(NotTaken / Scale))};
+    Br.setMetadata(LLContext, LLVM::Core::Prof,
+                   LLVM::Metadata(LLContext, Weights));
+  }
+
+  /// Attach the recorded weights of the `if` or `br_if` instruction.
+  void setBranchWeights(LLVM::Value Br, uint32_t Offset) noexcept {
+    if (!Context.Prof) {
+      return;
+    }
+    if (const auto *Branch = Context.Prof->getBranch(Offset)) {
+      setBranchWeights(Br, Branch->Taken, Branch->NotTaken);
+    }
+  }
+
+  /// Dominant target of a `call_indirect` instruction in the profile.
+  struct HotTarget {
+    uint32_t FuncIndex;
+    uint64_t Count;
+    uint64_t OtherCount;
+  };
+
+  /// The dominant target of the `call_indirect` instruction, for promoting it
+  /// to a direct call.
+  std::optional<HotTarget>
+  getHotIndirectTarget(uint32_t Offset, uint32_t FuncTypeIndex) noexcept {
+    if (!Context.Prof) {
+      return std::nullopt;
+    }
+    const auto *Targets = Context.Prof->getIndirectCall(Offset);
+    if (!Targets) {
+      return std::nullopt;
+    }
+    uint64_t Total = 0;
+    auto Hot = Targets->begin();
+    for (auto It = Targets->begin(); It != Targets->end(); ++It) {
+      Total += It->second;
+      if (It->second > Hot->second) {
+        Hot = It;
+      }
+    }
+    // Only promote the target taking most of the calls.
+    if (Hot->second * 4 < Total * 3) {
+      return std::nullopt;
+    }
+    const auto FuncIt = Context.FunctionOffsets.find(Hot->first);
+    if (FuncIt == Context.FunctionOffsets.end() ||
+        std::get<0>(Context.Functions[FuncIt->second]) != FuncTypeIndex) {
+      return std::nullopt;
+    }
+    return HotTarget{FuncIt->second, Hot->second, Total - Hot->second};
+  }
+
   Expect<void>
   compile(const AST::CodeSegment &Code,
           std::pair<std::vector<ValType>, std::vector<ValType>> Type) noexcept {
     auto RetBB = LLVM::BasicBlock::create(LLContext, F.Fn, "ret");
     Type.first.clear();
     enterBlock(RetBB, {}, {}, {}, std::move(Type));
-    EXPECTED_TRY(compile(Code.getExpr().getInstrs()));
+    EXPECTED_TRY(auto Instrs, Code.getBodyInstrs());
+    EXPECTED_TRY(compile(Instrs));
     assuming(ControlStack.empty());
     compileReturn();
 
@@ -606,7 +921,9 @@ public:
         }
         enterBlock(EndBlock, {}, {}, std::move(Args), std::move(Type));
         checkStop();
-        updateGas();
+        if (!CoarseGasCheck) {
+          updateGas();
+        }
         return {};
       }
       case OpCode::Loop: {
@@ -651,7 +968,8 @@ public:
         } else {
           Cond = Builder.createICmpNE(stackPop(), LLContext.getInt32(0));
         }
-        Builder.createCondBr(Cond, Then, Else);
+        setBranchWeights(Builder.createCondBr(Cond, Then, Else),
+                         Instr.getOffset());
 
         Builder.positionAtEnd(Then);
         auto Type = Context.resolveBlockType(Instr.getBlockType());
@@ -671,9 +989,36 @@ public:
         enterBlock(EndIf, {}, Else, std::move(Args), std::move(Type));
         return {};
       }
-      case OpCode::Try_table:
-        // TODO: EXCEPTION - implement the AOT.
-        return Unexpect(ErrCode::Value::AOTNotImpl);
+      case OpCode::Try_table: {
+        const auto &TryDesc = Instr.getTryCatch();
+        for (const auto &C : TryDesc.Catch) {
+          if (!C.IsAll && !isPropagatableTag(C.TagIndex)) {
+            return Unexpect(ErrCode::Value::AOTNotImpl);
+          }
+        }
+        auto Block = LLVM::BasicBlock::create(LLContext, F.Fn, "try");
+        auto EndBlock = LLVM::BasicBlock::create(LLContext, F.Fn, "try.end");
+        Builder.createBr(Block);
+
+        Builder.positionAtEnd(Block);
+        auto Type = Context.resolveBlockType(TryDesc.ResType);
+        const auto Arity = Type.first.size();
+        std::vector<LLVM::Value> Args(Arity);
+        if (isUnreachable()) {
+          for (size_t I = 0; I < Arity; ++I) {
+            auto Ty = toLLVMType(LLContext, Type.first[I]);
+            Args[I] = LLVM::Value::getUndef(Ty);
+          }
+        } else {
+          for (size_t I = 0; I < Arity; ++I) {
+            const size_t J = Arity - 1 - I;
+            Args[J] = stackPop();
+          }
+        }
+        enterBlock(EndBlock, {}, {}, std::move(Args), std::move(Type));
+        ControlStack.back().Try = &TryDesc;
+        return {};
+      }
       case OpCode::End: {
         auto Entry = leaveBlock();
         if (Entry.ElseBlock) {
@@ -711,9 +1056,49 @@ public:
         break;
       case OpCode::Nop:
         break;
-      case OpCode::Throw:
-      case OpCode::Throw_ref:
-        // TODO: EXCEPTION - implement the AOT.
+      case OpCode::Throw: {
+        const auto TagIndex = Instr.getTargetIndex();
+        if (!isPropagatableTag(TagIndex)) {
+          return Unexpect(ErrCode::Value::AOTNotImpl);
+        }
+        const auto Size = Context.Tags[TagIndex]->getParamTypes().size();
+        std::vector<LLVM::Value> Values(Size);
+        for (size_t I = 0; I < Size; ++I) {
+          const size_t J = Size - 1 - I;
+          Values[J] = stackPop();
+        }
+        compileThrow(TagIndex, Context.getTag(Builder, ExecCtx, TagIndex),
+                     Values, false);
+        setUnreachable();
+        Builder.positionAtEnd(
+            LLVM::BasicBlock::create(LLContext, F.Fn, "throw.end"));
+        break;
+      }
+      case OpCode::Throw_ref: {
+        auto Tag = Builder.createIntToPtr(
+            Builder.createExtractElement(
+                Builder.createBitCast(stackPop(), Context.Int64x2Ty),
+                LLContext.getInt64(1)),
+            Context.Int8PtrTy);
+        auto NotNullBB =
+            LLVM::BasicBlock::create(LLContext, F.Fn, "throw_ref.not_null");
+        Builder.createCondBr(
+            Builder.createLikely(Builder.createIsNotNull(Tag)), NotNullBB,
+            getTrapBB(ErrCode::Value::AccessNullException));
+        Builder.positionAtEnd(NotNullBB);
+        compileThrow(std::nullopt, Tag, {}, false);
+        setUnreachable();
+        Builder.positionAtEnd(
+            LLVM::BasicBlock::create(LLContext, F.Fn, "throw_ref.end"));
+        break;
+      }
+      case OpCode::Cont__new:
+      case OpCode::Cont__bind:
+      case OpCode::Suspend:
+      case OpCode::Resume:
+      case OpCode::Resume_throw:
+      case OpCode::Switch:
+        // The continuations run on the fibers of the interpreter only.
         return Unexpect(ErrCode::Value::AOTNotImpl);
       case OpCode::Br: {
         const auto Label = Instr.getJump().TargetIndex;
@@ -729,7 +1114,8 @@ public:
         auto Cond = Builder.createICmpNE(stackPop(), LLContext.getInt32(0));
         setLableJumpPHI(Label);
         auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "br_if.end");
-        Builder.createCondBr(Cond, getLabel(Label), Next);
+        setBranchWeights(Builder.createCondBr(Cond, getLabel(Label), Next),
+                         Instr.getOffset());
         Builder.positionAtEnd(Next);
         break;
       }
@@ -819,11 +1205,15 @@ public:
         updateInstrCount();
         updateGas();
         compileCallOp(Instr.getTargetIndex());
+        checkException();
         break;
       case OpCode::Call_indirect:
         updateInstrCount();
         updateGas();
-        compileIndirectCallOp(Instr.getSourceIndex(), Instr.getTargetIndex());
+        compileIndirectCallOp(Instr.getSourceIndex(), Instr.getTargetIndex(),
+                              getHotIndirectTarget(Instr.getOffset(),
+                                                   Instr.getTargetIndex()));
+        checkException();
         break;
       case OpCode::Return_call:
         updateInstrCount();
@@ -846,6 +1236,7 @@ public:
         updateInstrCount();
         updateGas();
         compileCallRefOp(Instr.getTargetIndex());
+        checkException();
         break;
       case OpCode::Return_call_ref:
         updateInstrCount();
@@ -855,9 +1246,6 @@ public:
         Builder.positionAtEnd(
             LLVM::BasicBlock::create(LLContext, F.Fn, "ret_call_ref.end"));
         break;
-      case OpCode::Try_table:
-        // TODO: EXCEPTION - implement the AOT.
-        return Unexpect(ErrCode::Value::AOTNotImpl);
 
       // Reference Instructions
       case OpCode::Ref__null: {
@@ -1399,46 +1787,32 @@ public:
         std::copy_n(VT.getRawData().cbegin(), 8, RawRef.begin());
         auto Ref = Builder.createBitCast(
             LLVM::Value::getConstVector8(LLContext, RawRef), Context.Int64x2Ty);
+        // The value is unboxed in the pointer with the lowest bit tagged.
         auto Val = Builder.createZExt(
             Builder.createOr(
-                Builder.createAnd(stackPop(), LLContext.getInt32(0x7FFFFFFFU)),
-                LLContext.getInt32(0x80000000U)),
+                Builder.createShl(stackPop(), LLContext.getInt32(1)),
+                LLContext.getInt32(1)),
             Context.Int64Ty);
         stackPush(Builder.createInsertElement(Ref, Val, LLContext.getInt64(1)));
         break;
       }
-      case OpCode::I31__get_s: {
-        auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "i31.get.ok");
-        auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
-        auto Val = Builder.createTrunc(
-            Builder.createExtractElement(Ref, LLContext.getInt64(1)),
-            Context.Int32Ty);
-        auto IsNotNull = Builder.createLikely(Builder.createICmpNE(
-            Builder.createAnd(Val, LLContext.getInt32(0x80000000U)),
-            LLContext.getInt32(0)));
-        Builder.createCondBr(IsNotNull, Next,
-                             getTrapBB(ErrCode::Value::AccessNullI31));
-        Builder.positionAtEnd(Next);
-        Val = Builder.createAnd(Val, LLContext.getInt32(0x7FFFFFFFU));
-        stackPush(Builder.createOr(
-            Val, Builder.createShl(
-                     Builder.createAnd(Val, LLContext.getInt32(0x40000000U)),
-                     LLContext.getInt32(1))));
-        break;
-      }
+      case OpCode::I31__get_s:
       case OpCode::I31__get_u: {
         auto Next = LLVM::BasicBlock::create(LLContext, F.Fn, "i31.get.ok");
         auto Ref = Builder.createBitCast(stackPop(), Context.Int64x2Ty);
         auto Val = Builder.createTrunc(
             Builder.createExtractElement(Ref, LLContext.getInt64(1)),
             Context.Int32Ty);
-        auto IsNotNull = Builder.createLikely(Builder.createICmpNE(
-            Builder.createAnd(Val, LLContext.getInt32(0x80000000U)),
-            LLContext.getInt32(0)));
+        auto IsNotNull = Builder.createLikely(
+            Builder.createICmpNE(Val, LLContext.getInt32(0)));
         Builder.createCondBr(IsNotNull, Next,
                              getTrapBB(ErrCode::Value::AccessNullI31));
         Builder.positionAtEnd(Next);
-        stackPush(Builder.createAnd(Val, LLContext.getInt32(0x7FFFFFFFU)));
+        if (Instr.getOpCode() == OpCode::I31__get_s) {
+          stackPush(Builder.createAShr(Val, LLContext.getInt32(1)));
+        } else {
+          stackPush(Builder.createLShr(Val, LLContext.getInt32(1)));
+        }
         break;
       }
 
@@ -3290,7 +3664,7 @@ public:
 
       // Relaxed SIMD Instructions
       case OpCode::I8x16__relaxed_swizzle:
-        compileVectorSwizzle();
+        compileVectorRelaxedSwizzle();
         break;
       case OpCode::I32x4__relaxed_trunc_f32x4_s:
         compileVectorTruncSatS32(Context.Floatx4Ty, false);
@@ -3687,31 +4061,62 @@ public:
     };
 
     for (const auto &Instr : Instrs) {
-      // Update instruction count
-      if (LocalInstrCount) {
-        Builder.createStore(
-            Builder.createAdd(
-                Builder.createLoad(Context.Int64Ty, LocalInstrCount),
-                LLContext.getInt64(1)),
-            LocalInstrCount);
-      }
-      if (LocalGas) {
-        auto NewGas = Builder.createAdd(
-            Builder.createLoad(Context.Int64Ty, LocalGas),
-            Builder.createLoad(
-                Context.Int64Ty,
-                Builder.createConstInBoundsGEP2_64(
-                    LLVM::Type::getArrayType(Context.Int64Ty, UINT16_MAX + 1),
-                    Context.getCostTable(Builder, ExecCtx), 0,
-                    uint16_t(Instr.getOpCode()))));
-        Builder.createStore(NewGas, LocalGas);
+      // Update instruction count and cost. The straight-line instructions are
+      // summed up, and added before the next instruction which may branch or
+      // trap, so the counters are still exact wherever they are read.
+      addPendingCost(Instr.getOpCode());
+      if (!isStraightLine(Instr.getOpCode())) {
+        flushPendingCost();
       }
 
       // Make the instruction node according to Code.
       EXPECTED_TRY(Dispatch(Instr));
     }
+    flushPendingCost();
     return {};
   }
+
+  void addPendingCost(OpCode Code) noexcept {
+    ++PendingInstrCount;
+    if (LocalGas) {
+      auto It = std::find_if(
+          PendingCosts.begin(), PendingCosts.end(),
+          [Code](const auto &Pending) { return Pending.first == Code; });
+      if (It != PendingCosts.end()) {
+        ++It->second;
+      } else {
+        PendingCosts.emplace_back(Code, 1);
+      }
+    }
+  }
+
+  void flushPendingCost() noexcept {
+    if (LocalInstrCount && PendingInstrCount > 0) {
+      Builder.createStore(
+          Builder.createAdd(
+              Builder.createLoad(Context.Int64Ty, LocalInstrCount),
+              LLContext.getInt64(PendingInstrCount)),
+          LocalInstrCount);
+    }
+    if (LocalGas && !PendingCosts.empty()) {
+      auto CostTable = Context.getCostTable(Builder, ExecCtx);
+      auto NewGas = Builder.createLoad(Context.Int64Ty, LocalGas);
+      for (const auto &[Code, Count] : PendingCosts) {
+        LLVM::Value Cost = Builder.createLoad(
+            Context.Int64Ty,
+            Builder.createConstInBoundsGEP2_64(
+                LLVM::Type::getArrayType(Context.Int64Ty, UINT16_MAX + 1),
+                CostTable, 0, static_cast<uint16_t>(Code)));
+        if (Count > 1) {
+          Cost = Builder.createMul(Cost, LLContext.getInt64(Count));
+        }
+        NewGas = Builder.createAdd(NewGas, Cost);
+      }
+      Builder.createStore(NewGas, LocalGas);
+    }
+    PendingInstrCount = 0;
+    PendingCosts.clear();
+  }
   void compileSignedTrunc(LLVM::Type IntType) noexcept {
     auto NormBB = LLVM::BasicBlock::create(LLContext, F.Fn, "strunc.norm");
     auto NotMinBB = LLVM::BasicBlock::create(LLContext, F.Fn, "strunc.notmin");
@@ -3939,7 +4344,7 @@ public:
     Builder.createFence(LLVMAtomicOrderingSequentiallyConsistent);
   }
   void compileAtomicNotify(unsigned MemoryIndex,
-                           unsigned MemoryOffset) noexcept {
+                           uint64_t MemoryOffset) noexcept {
     auto Count = stackPop();
     auto Addr = Builder.createZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
@@ -3956,7 +4361,7 @@ public:
                 {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
         {LLContext.getInt32(MemoryIndex), Offset, Count}));
   }
-  void compileAtomicWait(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicWait(unsigned MemoryIndex, uint64_t MemoryOffset,
                          LLVM::Type TargetType, uint32_t BitWidth) noexcept {
     auto Timeout = stackPop();
     auto ExpectedValue = Builder.createZExtOrTrunc(stackPop(), Context.Int64Ty);
@@ -3978,10 +4383,11 @@ public:
         {LLContext.getInt32(MemoryIndex), Offset, ExpectedValue, Timeout,
          LLContext.getInt32(BitWidth)}));
   }
-  void compileAtomicLoad(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicLoad(unsigned MemoryIndex, uint64_t MemoryOffset,
                          unsigned Alignment, LLVM::Type IntType,
                          LLVM::Type TargetType, bool Signed = false) noexcept {
-
+    compileMemoryBoundCheck(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
       Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
@@ -4002,7 +4408,7 @@ public:
       Stack.back() = Builder.createZExt(Load, IntType);
     }
   }
-  void compileAtomicStore(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicStore(unsigned MemoryIndex, uint64_t MemoryOffset,
                           unsigned Alignment, LLVM::Type, LLVM::Type TargetType,
                           bool Signed = false) noexcept {
     auto V = stackPop();
@@ -4013,6 +4419,8 @@ public:
       V = Builder.createZExtOrTrunc(V, TargetType);
     }
     V = switchEndian(V);
+    compileMemoryBoundCheck(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
       Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
@@ -4027,11 +4435,13 @@ public:
     Store.setOrdering(LLVMAtomicOrderingSequentiallyConsistent);
   }
 
-  void compileAtomicRMWOp(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicRMWOp(unsigned MemoryIndex, uint64_t MemoryOffset,
                           [[maybe_unused]] unsigned Alignment,
                           LLVMAtomicRMWBinOp BinOp, LLVM::Type IntType,
                           LLVM::Type TargetType, bool Signed = false) noexcept {
     auto Value = Builder.createSExtOrTrunc(stackPop(), TargetType);
+    compileMemoryBoundCheck(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
       Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
@@ -4091,13 +4501,15 @@ public:
       Stack.back() = Builder.createZExt(Ret, IntType);
     }
   }
-  void compileAtomicCompareExchange(unsigned MemoryIndex, unsigned MemoryOffset,
+  void compileAtomicCompareExchange(unsigned MemoryIndex, uint64_t MemoryOffset,
                                     [[maybe_unused]] unsigned Alignment,
                                     LLVM::Type IntType, LLVM::Type TargetType,
                                     bool Signed = false) noexcept {
 
     auto Replacement = Builder.createSExtOrTrunc(stackPop(), TargetType);
     auto Expected = Builder.createSExtOrTrunc(stackPop(), TargetType);
+    compileMemoryBoundCheck(MemoryIndex, Stack.back(), MemoryOffset,
+                            TargetType.getPrimitiveSizeInBits() / 8);
     auto Offset = Builder.createZExt(Stack.back(), Context.Int64Ty);
     if (MemoryOffset != 0) {
       Offset = Builder.createAdd(Offset, LLContext.getInt64(MemoryOffset));
@@ -4240,12 +4652,139 @@ private:
     }
   }
 
-  void compileIndirectCallOp(const uint32_t TableIndex,
-                             const uint32_t FuncTypeIndex) noexcept {
-    auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.not_null");
-    auto IsNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.is_null");
+  /// Dispatch the `call_indirect` instruction on a static table by a switch of
+  /// direct calls, trapping on the other slots as the runtime check does.
+  /// Return std::nullopt if the table is not static or has too many matched
+  /// functions, otherwise the return value, which is null for no returns.
+  std::optional<LLVM::Value>
+  compileStaticIndirectCall(uint32_t TableIndex, uint32_t FuncTypeIndex,
+                            LLVM::Value FuncIndex, LLVM::Type RTy,
+                            Span<LLVM::Value> Args) noexcept {
+    if (TableIndex >= Context.StaticTables.size() ||
+        !Context.StaticTables[TableIndex]) {
+      return std::nullopt;
+    }
+    const auto &Slots = *Context.StaticTables[TableIndex];
+    const auto *ExpType = Context.CompositeTypes[FuncTypeIndex];
+    auto IsMatched = [&](uint32_t Slot) noexcept {
+      return Slot != UINT32_MAX &&
+             Context.CompositeTypes[std::get<0>(Context.Functions[Slot])] ==
+                 ExpType;
+    };
+    std::vector<uint32_t> Targets;
+    for (const auto Slot : Slots) {
+      if (IsMatched(Slot) &&
+          std::find(Targets.begin(), Targets.end(), Slot) == Targets.end()) {
+        Targets.push_back(Slot);
+      }
+    }
+    if (Targets.size() > kMaxStaticCallTargets) {
+      return std::nullopt;
+    }
+
     auto EndBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.end");
+    auto Switch = Builder.createSwitch(
+        FuncIndex, getTrapBB(ErrCode::Value::UndefinedElement),
+        static_cast<unsigned int>(Slots.size()));
+    std::vector<LLVM::BasicBlock> TargetBBs;
+    std::vector<LLVM::Value> Rets;
+    for (const auto Target : Targets) {
+      TargetBBs.push_back(
+          LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.direct"));
+      Builder.positionAtEnd(TargetBBs.back());
+      Rets.push_back(
+          Builder.createCall(std::get<1>(Context.Functions[Target]), Args));
+      Builder.createBr(EndBB);
+    }
+    for (uint32_t I = 0; I < Slots.size(); ++I) {
+      LLVM::BasicBlock Dest;
+      if (Slots[I] == UINT32_MAX) {
+        Dest = getTrapBB(ErrCode::Value::UninitializedElement);
+      } else if (!IsMatched(Slots[I])) {
+        Dest = getTrapBB(ErrCode::Value::IndirectCallTypeMismatch);
+      } else {
+        Dest = TargetBBs[static_cast<size_t>(
+            std::find(Targets.begin(), Targets.end(), Slots[I]) -
+            Targets.begin())];
+      }
+      Switch.addCase(LLContext.getInt32(I), Dest);
+    }
+
+    Builder.positionAtEnd(EndBB);
+    if (RTy.isVoidTy()) {
+      return LLVM::Value();
+    }
+    auto Ret = Builder.createPHI(RTy);
+    for (size_t I = 0; I < Targets.size(); ++I) {
+      Ret.addIncoming(Rets[I], TargetBBs[I]);
+    }
+    return Ret;
+  }
+
+  /// Get the symbol of the table slot for the `call_indirect` instruction.
+  /// The entry of the native dispatch table is used if it has passed the type
+  /// check of the same type before, otherwise the runtime checks the slot and
+  /// caches it. Return null if the function is not compiled.
+  LLVM::Value compileTableGetFuncSymbol(uint32_t TableIndex,
+                                        uint32_t FuncTypeIndex,
+                                        LLVM::Value FuncIndex,
+                                        LLVM::Type FTy) noexcept {
+    auto CheckBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.check");
+    auto NativeBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.native");
+    auto SlowBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.slow");
+    auto SymbolBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.symbol");
+
+    auto Table = Context.getNativeTable(Builder, ExecCtx, TableIndex);
+    auto Index = Builder.createZExt(FuncIndex, Context.Int64Ty);
+    auto Size = Builder.createLoad(
+        Context.Int64Ty,
+        Builder.createConstInBoundsGEP2_64(Context.NativeTableTy, Table, 0, 1));
+    Builder.createCondBr(
+        Builder.createLikely(Builder.createICmpULT(Index, Size)), CheckBB,
+        SlowBB);
+
+    Builder.positionAtEnd(CheckBB);
+    auto Entries = Builder.createLoad(
+        Context.NativeEntryTy.getPointerTo(),
+        Builder.createConstInBoundsGEP2_64(Context.NativeTableTy, Table, 0, 0));
+    auto Entry =
+        Builder.createInBoundsGEP1(Context.NativeEntryTy, Entries, Index);
+    auto TypeId = Builder.createLoad(
+        Context.Int64Ty,
+        Builder.createConstInBoundsGEP2_64(Context.NativeEntryTy, Entry, 0, 0));
+    auto IsMatched = Builder.createICmpEQ(
+        TypeId, Context.getNativeTypeId(Builder, ExecCtx, FuncTypeIndex));
+    Builder.createCondBr(Builder.createLikely(IsMatched), NativeBB, SlowBB);
+
+    Builder.positionAtEnd(NativeBB);
+    auto Symbol = Builder.createBitCast(
+        Builder.createLoad(Context.Int8PtrTy,
+                           Builder.createConstInBoundsGEP2_64(
+                               Context.NativeEntryTy, Entry, 0, 1)),
+        FTy.getPointerTo());
+    Builder.createBr(SymbolBB);
+
+    Builder.positionAtEnd(SlowBB);
+    auto FPtr = Builder.createCall(
+        Context.getIntrinsic(
+            Builder, Executable::Intrinsics::kTableGetFuncSymbol,
+            LLVM::Type::getFunctionType(
+                FTy.getPointerTo(),
+                {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
+        {LLContext.getInt32(TableIndex), LLContext.getInt32(FuncTypeIndex),
+         FuncIndex});
+    Builder.createBr(SymbolBB);
 
+    Builder.positionAtEnd(SymbolBB);
+    auto Ret = Builder.createPHI(FTy.getPointerTo());
+    Ret.addIncoming(Symbol, NativeBB);
+    Ret.addIncoming(FPtr, SlowBB);
+    return Ret;
+  }
+
+  void compileIndirectCallOp(
+      const uint32_t TableIndex, const uint32_t FuncTypeIndex,
+      std::optional<HotTarget> Hot = std::nullopt) noexcept {
     LLVM::Value FuncIndex = stackPop();
     const auto &FuncType = Context.CompositeTypes[FuncTypeIndex]->getFuncType();
     auto FTy = toLLVMType(Context.LLContext, Context.ExecCtxPtrTy, FuncType);
@@ -4261,24 +4800,62 @@ private:
       ArgsVec[J] = stackPop();
     }
 
+    if (auto Ret = compileStaticIndirectCall(TableIndex, FuncTypeIndex,
+                                             FuncIndex, RTy, ArgsVec)) {
+      if (RetSize == 0) {
+        // nothing to do
+      } else if (RetSize == 1) {
+        stackPush(*Ret);
+      } else {
+        for (auto Val : unpackStruct(Builder, *Ret)) {
+          stackPush(Val);
+        }
+      }
+      return;
+    }
+
+    auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.not_null");
+    auto IsNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.is_null");
+    auto EndBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.end");
     std::vector<LLVM::Value> FPtrRetsVec;
     FPtrRetsVec.reserve(RetSize);
     {
-      auto FPtr = Builder.createCall(
-          Context.getIntrinsic(
-              Builder, Executable::Intrinsics::kTableGetFuncSymbol,
-              LLVM::Type::getFunctionType(
-                  FTy.getPointerTo(),
-                  {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
-          {LLContext.getInt32(TableIndex), LLContext.getInt32(FuncTypeIndex),
-           FuncIndex});
+      auto FPtr =
+          compileTableGetFuncSymbol(TableIndex, FuncTypeIndex, FuncIndex, FTy);
       Builder.createCondBr(
           Builder.createLikely(Builder.createNot(Builder.createIsNull(FPtr))),
           NotNullBB, IsNullBB);
       Builder.positionAtEnd(NotNullBB);
 
-      auto FPtrRet =
-          Builder.createCall(LLVM::FunctionCallee{FTy, FPtr}, ArgsVec);
+      LLVM::Value FPtrRet;
+      if (Hot) {
+        // Call the dominant target in the profile directly, so that it can be
+        // inlined. The other targets still go through the function pointer.
+        auto &Target = std::get<1>(Context.Functions[Hot->FuncIndex]);
+        auto DirectBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.hot");
+        auto IndirectBB =
+            LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.indirect");
+        auto MergeBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.merge");
+        auto IsHot = Builder.createICmpEQ(
+            FPtr, Builder.createBitCast(Target.Fn, FPtr.getType()));
+        setBranchWeights(Builder.createCondBr(IsHot, DirectBB, IndirectBB),
+                         Hot->Count, Hot->OtherCount);
+        Builder.positionAtEnd(DirectBB);
+        auto DirectRet = Builder.createCall(Target, ArgsVec);
+        Builder.createBr(MergeBB);
+        Builder.positionAtEnd(IndirectBB);
+        auto IndirectRet =
+            Builder.createCall(LLVM::FunctionCallee{FTy, FPtr}, ArgsVec);
+        Builder.createBr(MergeBB);
+        Builder.positionAtEnd(MergeBB);
+        if (!RTy.isVoidTy()) {
+          FPtrRet = Builder.createPHI(RTy);
+          FPtrRet.addIncoming(DirectRet, DirectBB);
+          FPtrRet.addIncoming(IndirectRet, IndirectBB);
+        }
+      } else {
+        FPtrRet = Builder.createCall(LLVM::FunctionCallee{FTy, FPtr}, ArgsVec);
+      }
       if (RetSize == 0) {
         // nothing to do
       } else if (RetSize == 1) {
@@ -4290,6 +4867,8 @@ private:
       }
     }
 
+    // The promoted call ends in another block.
+    auto NotNullEndBB = Builder.getInsertBlock();
     Builder.createBr(EndBB);
     Builder.positionAtEnd(IsNullBB);
 
@@ -4327,7 +4906,7 @@ private:
 
     for (unsigned I = 0; I < RetSize; ++I) {
       auto PHIRet = Builder.createPHI(FPtrRetsVec[I].getType());
-      PHIRet.addIncoming(FPtrRetsVec[I], NotNullBB);
+      PHIRet.addIncoming(FPtrRetsVec[I], NotNullEndBB);
       PHIRet.addIncoming(RetsVec[I], IsNullBB);
       stackPush(PHIRet);
     }
@@ -4358,9 +4937,6 @@ private:
 
   void compileReturnIndirectCallOp(const uint32_t TableIndex,
                                    const uint32_t FuncTypeIndex) noexcept {
-    auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.not_null");
-    auto IsNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.is_null");
-
     LLVM::Value FuncIndex = stackPop();
     const auto &FuncType = Context.CompositeTypes[FuncTypeIndex]->getFuncType();
     auto FTy = toLLVMType(Context.LLContext, Context.ExecCtxPtrTy, FuncType);
@@ -4376,15 +4952,21 @@ private:
       ArgsVec[J] = stackPop();
     }
 
+    if (auto Ret = compileStaticIndirectCall(TableIndex, FuncTypeIndex,
+                                             FuncIndex, RTy, ArgsVec)) {
+      if (RetSize == 0) {
+        Builder.createRetVoid();
+      } else {
+        Builder.createRet(*Ret);
+      }
+      return;
+    }
+
+    auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.not_null");
+    auto IsNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_i.is_null");
     {
-      auto FPtr = Builder.createCall(
-          Context.getIntrinsic(
-              Builder, Executable::Intrinsics::kTableGetFuncSymbol,
-              LLVM::Type::getFunctionType(
-                  FTy.getPointerTo(),
-                  {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
-          {LLContext.getInt32(TableIndex), LLContext.getInt32(FuncTypeIndex),
-           FuncIndex});
+      auto FPtr =
+          compileTableGetFuncSymbol(TableIndex, FuncTypeIndex, FuncIndex, FTy);
       Builder.createCondBr(
           Builder.createLikely(Builder.createNot(Builder.createIsNull(FPtr))),
           NotNullBB, IsNullBB);
@@ -4431,6 +5013,20 @@ private:
     }
   }
 
+  /// Load the compiled entry of the function instance in the non-null
+  /// function reference, which is null for the non-compiled functions.
+  LLVM::Value createRefFuncEntry(LLVM::Value Ref, LLVM::Type FTy) noexcept {
+    auto FuncInst = Builder.createIntToPtr(
+        Builder.createExtractElement(Ref, LLContext.getInt64(1)),
+        Context.Int8PtrTy);
+    auto EntryPtr = Builder.createBitCast(
+        Builder.createConstInBoundsGEP1_64(Context.Int8Ty, FuncInst,
+                                           Executable::kFuncEntryOffset),
+        Context.Int8PtrPtrTy);
+    return Builder.createBitCast(
+        Builder.createLoad(Context.Int8PtrTy, EntryPtr), FTy.getPointerTo());
+  }
+
   void compileCallRefOp(const unsigned int TypeIndex) noexcept {
     auto NotNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_r.not_null");
     auto IsNullBB = LLVM::BasicBlock::create(LLContext, F.Fn, "c_r.is_null");
@@ -4462,12 +5058,7 @@ private:
     std::vector<LLVM::Value> FPtrRetsVec;
     FPtrRetsVec.reserve(RetSize);
     {
-      auto FPtr = Builder.createCall(
-          Context.getIntrinsic(
-              Builder, Executable::Intrinsics::kRefGetFuncSymbol,
-              LLVM::Type::getFunctionType(FTy.getPointerTo(),
-                                          {Context.Int64x2Ty}, false)),
-          {Ref});
+      auto FPtr = createRefFuncEntry(Ref, FTy);
       Builder.createCondBr(
           Builder.createLikely(Builder.createNot(Builder.createIsNull(FPtr))),
           NotNullBB, IsNullBB);
@@ -4555,12 +5146,7 @@ private:
     }
 
     {
-      auto FPtr = Builder.createCall(
-          Context.getIntrinsic(
-              Builder, Executable::Intrinsics::kRefGetFuncSymbol,
-              LLVM::Type::getFunctionType(FTy.getPointerTo(),
-                                          {Context.Int64x2Ty}, false)),
-          {Ref});
+      auto FPtr = createRefFuncEntry(Ref, FTy);
       Builder.createCondBr(
           Builder.createLikely(Builder.createNot(Builder.createIsNull(FPtr))),
           NotNullBB, IsNullBB);
@@ -4605,12 +5191,81 @@ private:
     }
   }
 
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  /// Upper bound of the 32-bit address by the range analysis of the masks,
+  /// the remainders, and the shifts with the constants.
+  static uint64_t getAddressBound(LLVM::Value Addr,
+                                  unsigned Depth = 0) noexcept {
+    if (Addr.isAConstantInt()) {
+      return Addr.getZExtValue();
+    }
+    if (Depth >= 4 || !Addr.isABinaryOperator()) {
+      return UINT32_MAX;
+    }
+    auto LHS = Addr.getOperand(0);
+    auto RHS = Addr.getOperand(1);
+    switch (Addr.getInstructionOpcode()) {
+    case LLVMAnd:
+      return std::min(getAddressBound(LHS, Depth + 1),
+                      getAddressBound(RHS, Depth + 1));
+    case LLVMURem:
+      if (RHS.isAConstantInt() && RHS.getZExtValue() > 0) {
+        return std::min(getAddressBound(LHS, Depth + 1),
+                        RHS.getZExtValue() - 1);
+      }
+      break;
+    case LLVMLShr:
+      if (RHS.isAConstantInt() && RHS.getZExtValue() < 32) {
+        return getAddressBound(LHS, Depth + 1) >> RHS.getZExtValue();
+      }
+      break;
+    default:
+      break;
+    }
+    return UINT32_MAX;
+  }
+  /// Check the bytes [Addr + Offset, Addr + Offset + Size) are in the memory,
+  /// which is only needed without the guard regions. The accesses proven
+  /// under the minimum size of the memory are not checked, and the accesses
+  /// of the same address in a basic block share the check of the largest end.
+  void compileMemoryBoundCheck(unsigned MemoryIndex, LLVM::Value Addr,
+                               uint64_t Offset, uint64_t Size) noexcept {
+    if constexpr (WASMEDGE_ALLOCATOR_IS_STABLE) {
+      return;
+    }
+    const uint64_t End = Offset + Size;
+    if (getAddressBound(Addr) + End <= Context.MemorySizes[MemoryIndex]) {
+      return;
+    }
+    if (auto BB = Builder.getInsertBlock().unwrap(); BB != CheckedBlock) {
+      CheckedBounds.clear();
+      CheckedBlock = BB;
+    }
+    auto &Checked = CheckedBounds[{MemoryIndex, Addr.unwrap()}];
+    if (End <= Checked) {
+      return;
+    }
+    Checked = End;
+
+    auto Bound = Builder.createAdd(Builder.createZExt(Addr, Context.Int64Ty),
+                                   LLContext.getInt64(End));
+    auto InBounds = Builder.createLikely(Builder.createICmpULE(
+        Bound, Context.getMemorySize(Builder, ExecCtx, MemoryIndex)));
+    auto OkBB = LLVM::BasicBlock::create(LLContext, F.Fn, "mem.ok");
+    Builder.createCondBr(InBounds, OkBB,
+                         getTrapBB(ErrCode::Value::MemoryOutOfBounds));
+    Builder.positionAtEnd(OkBB);
+    CheckedBlock = OkBB.unwrap();
+  }
+
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                      LLVM::Type LoadTy) noexcept {
     if constexpr (kForceUnalignment) {
       Alignment = 0;
     }
-    auto Off = Builder.createZExt(stackPop(), Context.Int64Ty);
+    auto Addr = stackPop();
+    compileMemoryBoundCheck(MemoryIndex, Addr, Offset,
+                            LoadTy.getPrimitiveSizeInBits() / 8);
+    auto Off = Builder.createZExt(Addr, Context.Int64Ty);
     if (Offset != 0) {
       Off = Builder.createAdd(Off, LLContext.getInt64(Offset));
     }
@@ -4622,7 +5277,7 @@ private:
     LoadInst.setAlignment(1 << Alignment);
     stackPush(switchEndian(LoadInst));
   }
-  void compileLoadOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileLoadOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                      LLVM::Type LoadTy, LLVM::Type ExtendTy,
                      bool Signed) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
@@ -4632,24 +5287,24 @@ private:
       Stack.back() = Builder.createZExt(Stack.back(), ExtendTy);
     }
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, LLVM::Type LoadTy) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     Stack.back() = Builder.createBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileVectorLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileVectorLoadOp(unsigned MemoryIndex, uint64_t Offset,
                            unsigned Alignment, LLVM::Type LoadTy,
                            LLVM::Type ExtendTy, bool Signed) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy, ExtendTy, Signed);
     Stack.back() = Builder.createBitCast(Stack.back(), Context.Int64x2Ty);
   }
-  void compileSplatLoadOp(unsigned MemoryIndex, unsigned Offset,
+  void compileSplatLoadOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, LLVM::Type LoadTy,
                           LLVM::Type VectorTy) noexcept {
     compileLoadOp(MemoryIndex, Offset, Alignment, LoadTy);
     compileSplatOp(VectorTy);
   }
-  void compileLoadLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileLoadLaneOp(unsigned MemoryIndex, uint64_t Offset,
                          unsigned Alignment, unsigned Index, LLVM::Type LoadTy,
                          LLVM::Type VectorTy) noexcept {
     auto Vector = stackPop();
@@ -4663,14 +5318,17 @@ private:
                                     Value, LLContext.getInt64(Index)),
         Context.Int64x2Ty);
   }
-  void compileStoreOp(unsigned MemoryIndex, unsigned Offset, unsigned Alignment,
+  void compileStoreOp(unsigned MemoryIndex, uint64_t Offset, unsigned Alignment,
                       LLVM::Type LoadTy, bool Trunc = false,
                       bool BitCast = false) noexcept {
     if constexpr (kForceUnalignment) {
       Alignment = 0;
     }
     auto V = stackPop();
-    auto Off = Builder.createZExt(stackPop(), Context.Int64Ty);
+    auto Addr = stackPop();
+    compileMemoryBoundCheck(MemoryIndex, Addr, Offset,
+                            LoadTy.getPrimitiveSizeInBits() / 8);
+    auto Off = Builder.createZExt(Addr, Context.Int64Ty);
     if (Offset != 0) {
       Off = Builder.createAdd(Off, LLContext.getInt64(Offset));
     }
@@ -4688,7 +5346,7 @@ private:
     auto StoreInst = Builder.createStore(V, Ptr, true);
     StoreInst.setAlignment(1 << Alignment);
   }
-  void compileStoreLaneOp(unsigned MemoryIndex, unsigned Offset,
+  void compileStoreLaneOp(unsigned MemoryIndex, uint64_t Offset,
                           unsigned Alignment, unsigned Index, LLVM::Type LoadTy,
                           LLVM::Type VectorTy) noexcept {
     auto Vector = Stack.back();
@@ -4874,6 +5532,26 @@ private:
       return Builder.createMul(LHS, RHS);
     });
   }
+  void compileVectorRelaxedSwizzle() noexcept {
+#if defined(__x86_64__)
+    if (Context.SupportSSSE3) {
+      // The `pshufb` selects the lane of the low 4 bits for the indices less
+      // than 128 and zeroes the others, which the spec allows for the indices
+      // out of range.
+      auto Index = Builder.createBitCast(stackPop(), Context.Int8x16Ty);
+      auto Vector = Builder.createBitCast(stackPop(), Context.Int8x16Ty);
+      assuming(LLVM::Core::X86SSSE3PShufB128 != LLVM::Core::NotIntrinsic);
+      stackPush(Builder.createBitCast(
+          Builder.createIntrinsic(LLVM::Core::X86SSSE3PShufB128, {},
+                                  {Vector, Index}),
+          Context.Int64x2Ty));
+      return;
+    }
+#endif
+    // The `tbl` on AArch64 zeroes the indices out of range as the strict one.
+    compileVectorSwizzle();
+  }
+
   void compileVectorSwizzle() noexcept {
     auto Index = Builder.createBitCast(stackPop(), Context.Int8x16Ty);
     auto Vector = Builder.createBitCast(stackPop(), Context.Int8x16Ty);
@@ -5510,13 +6188,31 @@ private:
     });
   }
 
+  /// Fused multiply-add on the targets with the FMA instructions, which the
+  /// relaxed SIMD allows as well as the separated rounding.
+  LLVM::Value createRelaxedMAdd(LLVM::Value LHS, LLVM::Value RHS,
+                                LLVM::Value C) noexcept {
+#if defined(__x86_64__)
+    const bool SupportFMA = Context.SupportFMA;
+#elif defined(__aarch64__)
+    const bool SupportFMA = Context.SupportNEON;
+#else
+    const bool SupportFMA = false;
+#endif
+    if (SupportFMA) {
+      assuming(LLVM::Core::Fma != LLVM::Core::NotIntrinsic);
+      return Builder.createIntrinsic(LLVM::Core::Fma, {LHS.getType()},
+                                     {LHS, RHS, C});
+    }
+    return Builder.createFAdd(Builder.createFMul(LHS, RHS), C);
+  }
+
   void compileVectorVectorMAdd(LLVM::Type VectorTy) noexcept {
     auto C = Builder.createBitCast(stackPop(), VectorTy);
     auto RHS = Builder.createBitCast(stackPop(), VectorTy);
     auto LHS = Builder.createBitCast(stackPop(), VectorTy);
-    stackPush(Builder.createBitCast(
-        Builder.createFAdd(Builder.createFMul(LHS, RHS), C),
-        Context.Int64x2Ty));
+    stackPush(Builder.createBitCast(createRelaxedMAdd(LHS, RHS, C),
+                                    Context.Int64x2Ty));
   }
 
   void compileVectorVectorNMAdd(LLVM::Type VectorTy) noexcept {
@@ -5524,8 +6220,7 @@ private:
     auto RHS = Builder.createBitCast(stackPop(), VectorTy);
     auto LHS = Builder.createBitCast(stackPop(), VectorTy);
     stackPush(Builder.createBitCast(
-        Builder.createFAdd(Builder.createFMul(Builder.createFNeg(LHS), RHS), C),
-        Context.Int64x2Ty));
+        createRelaxedMAdd(Builder.createFNeg(LHS), RHS, C), Context.Int64x2Ty));
   }
 
   void compileVectorRelaxedIntegerDotProduct() noexcept {
@@ -5569,6 +6264,28 @@ private:
     auto VC = Builder.createBitCast(stackPop(), FinTy);
     auto RHS = Builder.createBitCast(stackPop(), OriTy);
     auto LHS = Builder.createBitCast(stackPop(), OriTy);
+#if defined(__x86_64__)
+    if (Context.SupportVNNI) {
+      assuming(LLVM::Core::X86AVX512VPDPBUSD128 != LLVM::Core::NotIntrinsic);
+      // The `vpdpbusd` sums the 4 products of unsigned(RHS) * signed(LHS)
+      // without the intermediate saturation, which the spec allows for the
+      // 7-bit RHS.
+      return stackPush(Builder.createBitCast(
+          Builder.createIntrinsic(LLVM::Core::X86AVX512VPDPBUSD128, {},
+                                  {VC, Builder.createBitCast(RHS, FinTy),
+                                   Builder.createBitCast(LHS, FinTy)}),
+          Context.Int64x2Ty));
+    }
+#endif
+#if defined(__aarch64__)
+    if (Context.SupportDotProd) {
+      assuming(LLVM::Core::AArch64NeonSDot != LLVM::Core::NotIntrinsic);
+      return stackPush(Builder.createBitCast(
+          Builder.createIntrinsic(LLVM::Core::AArch64NeonSDot, {FinTy, OriTy},
+                                  {VC, LHS, RHS}),
+          Context.Int64x2Ty));
+    }
+#endif
     LLVM::Value IM;
 #if defined(__x86_64__)
     if (Context.SupportSSSE3) {
@@ -5648,21 +6365,171 @@ private:
     return Entry;
   }
 
+  /// The values of the exceptions propagated between the functions are passed
+  /// in a fixed buffer of the execution context.
+  bool isPropagatableTag(uint32_t TagIndex) const noexcept {
+    return Context.Tags[TagIndex]->getParamTypes().size() <=
+           Executable::kMaxExceptionValues;
+  }
+
+  /// Branch to the innermost matched catch clause of the enclosing try_table
+  /// blocks in this function, or return with the pending exception to the
+  /// caller. The thrown values are `Values` of the static `TagIndex`, or in
+  /// the pending exception for the dynamic tags. `IsPending` is set if the
+  /// exception is already pending, which should be cleared when caught.
+  void compileThrow(std::optional<uint32_t> TagIndex, LLVM::Value Tag,
+                    Span<const LLVM::Value> Values, bool IsPending) noexcept {
+    auto ExnTag = Context.getExceptionTag(Builder, ExecCtx);
+    auto StoreValues = [&]() {
+      for (uint32_t I = 0; I < Values.size(); ++I) {
+        Builder.createStore(Values[I],
+                            Context.getExceptionValue(Builder, ExecCtx, I,
+                                                      Values[I].getType()));
+      }
+    };
+
+    for (size_t Depth = 0; Depth < ControlStack.size(); ++Depth) {
+      const auto *Try = (ControlStack.rbegin() + Depth)->Try;
+      if (!Try) {
+        continue;
+      }
+      for (const auto &C : Try->Catch) {
+        LLVM::BasicBlock NextBB;
+        if (!C.IsAll && (!TagIndex || *TagIndex != C.TagIndex)) {
+          // The tags defined in the module never match the other tags, and
+          // the imported tags should be compared by the instances.
+          if (TagIndex && (*TagIndex >= Context.ImportTagNum ||
+                           C.TagIndex >= Context.ImportTagNum)) {
+            continue;
+          }
+          auto CatchBB = LLVM::BasicBlock::create(LLContext, F.Fn, "catch");
+          NextBB = LLVM::BasicBlock::create(LLContext, F.Fn, "catch.next");
+          Builder.createCondBr(
+              Builder.createICmpEQ(
+                  Tag, Context.getTag(Builder, ExecCtx, C.TagIndex)),
+              CatchBB, NextBB);
+          Builder.positionAtEnd(CatchBB);
+        }
+
+        if (IsPending) {
+          Builder.createStore(
+              LLVM::Value::getConstPointerNull(Context.Int8PtrTy), ExnTag);
+        }
+        std::vector<LLVM::Value> Args;
+        if (!C.IsAll) {
+          if (TagIndex) {
+            Args.assign(Values.begin(), Values.end());
+          } else {
+            const auto &Types = Context.Tags[C.TagIndex]->getParamTypes();
+            for (uint32_t I = 0; I < Types.size(); ++I) {
+              auto Ty = toLLVMType(LLContext, Types[I]);
+              Args.push_back(Builder.createLoad(
+                  Ty, Context.getExceptionValue(Builder, ExecCtx, I, Ty)));
+            }
+          }
+        }
+        if (C.IsRef) {
+          // The exception references keep the tag instance, and the values
+          // are kept in the pending exception for rethrowing.
+          if (TagIndex) {
+            StoreValues();
+          }
+          std::array<uint8_t, 16> Buf = {0};
+          std::copy_n(ValType(TypeCode::Ref, TypeCode::ExnRef)
+                          .getRawData()
+                          .cbegin(),
+                      8, Buf.begin());
+          Args.push_back(Builder.createInsertElement(
+              Builder.createBitCast(
+                  LLVM::Value::getConstVector8(LLContext, Buf),
+                  Context.Int64x2Ty),
+              Builder.createPtrToInt(Tag, Context.Int64Ty),
+              LLContext.getInt64(1)));
+        }
+
+        // The labels of the catch clauses are outside the try_table block.
+        const auto Label = static_cast<unsigned int>(Depth + 1 + C.LabelIndex);
+        for (auto &Arg : Args) {
+          stackPush(Arg);
+        }
+        setLableJumpPHI(Label);
+        Builder.createBr(getLabel(Label));
+        Stack.erase(Stack.end() - static_cast<int64_t>(Args.size()),
+                    Stack.end());
+        if (!NextBB) {
+          return;
+        }
+        Builder.positionAtEnd(NextBB);
+      }
+    }
+
+    // Not caught in this function.
+    if (TagIndex) {
+      StoreValues();
+    }
+    if (!IsPending) {
+      Builder.createStore(Tag, ExnTag);
+    }
+    updateInstrCount();
+    updateGas();
+    auto Ty = F.Ty.getReturnType();
+    if (Ty.isVoidTy()) {
+      Builder.createRetVoid();
+    } else {
+      Builder.createRet(LLVM::Value::getUndef(Ty));
+    }
+  }
+
+  /// Dispatch the exception which the callee returns with.
+  void checkException() noexcept {
+    if (Context.Tags.empty()) {
+      return;
+    }
+    auto Tag = Builder.createLoad(Context.Int8PtrTy,
+                                  Context.getExceptionTag(Builder, ExecCtx));
+    auto NormalBB = LLVM::BasicBlock::create(LLContext, F.Fn, "call.normal");
+    auto ThrowBB = LLVM::BasicBlock::create(LLContext, F.Fn, "call.throw");
+    Builder.createCondBr(Builder.createLikely(Builder.createIsNull(Tag)),
+                         NormalBB, ThrowBB);
+    Builder.positionAtEnd(ThrowBB);
+    compileThrow(std::nullopt, Tag, {}, true);
+    Builder.positionAtEnd(NormalBB);
+  }
+
   void checkStop() noexcept {
     if (!Interruptible) {
       return;
     }
     auto NotStopBB = LLVM::BasicBlock::create(LLContext, F.Fn, "NotStop");
-    auto StopToken = Builder.createAtomicRMW(
-        LLVMAtomicRMWBinOpXchg, Context.getStopToken(Builder, ExecCtx),
-        LLContext.getInt32(0), LLVMAtomicOrderingMonotonic);
+    auto StopBB = LLVM::BasicBlock::create(LLContext, F.Fn, "Stop");
+    // Only load the stop token and the epoch here, and leave the exchange of
+    // the stop token to the cold path.
+    auto StopTokenPtr = Context.getStopToken(Builder, ExecCtx);
+    auto StopToken = Builder.createLoad(Context.Int32Ty, StopTokenPtr);
+    StopToken.setAlignment(4);
+    StopToken.setOrdering(LLVMAtomicOrderingMonotonic);
+    auto Epoch =
+        Builder.createLoad(Context.Int64Ty, Context.getEpoch(Builder, ExecCtx));
+    Epoch.setAlignment(8);
+    Epoch.setOrdering(LLVMAtomicOrderingMonotonic);
+    auto Deadline = Builder.createLoad(
+        Context.Int64Ty, Context.getEpochDeadline(Builder, ExecCtx));
+    Deadline.setAlignment(8);
+    Deadline.setOrdering(LLVMAtomicOrderingMonotonic);
+    auto NotStop = Builder.createLikely(Builder.createAnd(
+        Builder.createICmpEQ(StopToken, LLContext.getInt32(0)),
+        Builder.createICmpULT(Epoch, Deadline)));
+    Builder.createCondBr(NotStop, NotStopBB, StopBB);
+
+    Builder.positionAtEnd(StopBB);
+    auto Exchange [[maybe_unused]] =
+        Builder.createAtomicRMW(LLVMAtomicRMWBinOpXchg, StopTokenPtr,
+                                LLContext.getInt32(0),
+                                LLVMAtomicOrderingMonotonic);
 #if LLVM_VERSION_MAJOR >= 13
-    StopToken.setAlignment(32);
+    Exchange.setAlignment(32);
 #endif
-    auto NotStop = Builder.createLikely(
-        Builder.createICmpEQ(StopToken, LLContext.getInt32(0)));
-    Builder.createCondBr(NotStop, NotStopBB,
-                         getTrapBB(ErrCode::Value::Interrupted));
+    Builder.createBr(getTrapBB(ErrCode::Value::Interrupted));
 
     Builder.positionAtEnd(NotStopBB);
   }
@@ -5789,8 +6656,16 @@ private:
   LLVM::Value LocalInstrCount = nullptr;
   LLVM::Value LocalGas = nullptr;
   std::unordered_map<ErrCode::Value, LLVM::BasicBlock> TrapBB;
+  /// Largest checked end offsets of the addresses in the current basic block.
+  std::map<std::pair<unsigned, LLVMValueRef>, uint64_t> CheckedBounds;
+  LLVMBasicBlockRef CheckedBlock = nullptr;
   bool IsUnreachable = false;
   bool Interruptible = false;
+  bool CoarseGasCheck = false;
+  /// Instruction count and costs of the instructions not yet added to the
+  /// local counters, as the pairs of the opcode and the count.
+  uint64_t PendingInstrCount = 0;
+  std::vector<std::pair<OpCode, uint64_t>> PendingCosts;
   struct Control {
     size_t StackSize;
     bool Unreachable;
@@ -5801,6 +6676,8 @@ private:
     std::pair<std::vector<ValType>, std::vector<ValType>> Type;
     std::vector<std::tuple<std::vector<LLVM::Value>, LLVM::BasicBlock>>
         ReturnPHI;
+    /// Catch clauses of the try_table block, or nullptr for the other blocks.
+    const AST::Instruction::TryDescriptor *Try = nullptr;
     Control(size_t S, bool U, LLVM::BasicBlock J, LLVM::BasicBlock N,
             LLVM::BasicBlock E, std::vector<LLVM::Value> A,
             std::pair<std::vector<ValType>, std::vector<ValType>> T,
@@ -5831,24 +6708,397 @@ std::vector<LLVM::Value> unpackStruct(LLVM::Builder &Builder,
   return Ret;
 }
 
+/// Give local symbols names which can't be mistaken for the exported type and
+/// function symbols, since splitting the module externalizes the ones that
+/// are referenced across partitions.
+void renameLocals(LLVM::Module &LLModule) noexcept {
+  uint32_t Index = 0;
+  auto Rename = [&Index](LLVM::Value V) {
+    const auto Linkage = V.getLinkage();
+    if (Linkage == LLVMInternalLinkage || Linkage == LLVMPrivateLinkage) {
+      if (const auto Name = V.getName(); Name.empty() || Name[0] != 'f') {
+        V.setName(fmt::format("l{}"sv, Index++));
+      }
+    }
+  };
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    Rename(Fn);
+  }
+  for (auto GV = LLModule.getFirstGlobal(); GV; GV = GV.getNextGlobal()) {
+    Rename(GV);
+  }
+}
+
+/// Record the IR instruction counts of the defined functions.
+void recordInstructions(LLVM::CompileReport &Report, LLVM::Module &LLModule,
+                        bool IsOptimized) noexcept {
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    if (!Fn.isDeclaration()) {
+      Report.recordInstructions(Fn.getName(), Fn.countInstructions(),
+                                IsOptimized);
+    }
+  }
+}
+
+/// Create the target machine of one module and run the optimization passes on
+/// it.
+WasmEdge::Expect<void> optimize(LLVM::Module &LLModule, LLVM::TargetMachine &TM,
+                                const WasmEdge::CompilerConfigure &Conf,
+                                LLVM::CompileReport *Report) noexcept {
+  auto Triple = LLModule.getTarget();
+  auto [TheTarget, ErrorMessage] = LLVM::Target::getFromTriple(Triple);
+  if (ErrorMessage) {
+    spdlog::error("getFromTriple failed:{}"sv, ErrorMessage.string_view());
+    return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalPath);
+  }
+
+  const auto Target = getTargetCPU(Conf);
+  TM = LLVM::TargetMachine::create(
+      TheTarget, Triple, Target.Name.c_str(), Target.Features.c_str(),
+      toLLVMCodeGenLevel(Conf.getOptimizationLevel()), LLVMRelocPIC,
+      LLVMCodeModelDefault);
+
+#if LLVM_VERSION_MAJOR >= 13
+  if (Report) {
+    // Time every pass run without the nested pass runs, and collect the
+    // records of this partition before merging them into the report.
+    struct PassRun {
+      std::string Pass;
+      std::string Function;
+      std::chrono::steady_clock::time_point Start;
+      std::chrono::steady_clock::duration Nested{0};
+    };
+    std::vector<PassRun> Runs;
+    LLVM::CompileReport Local;
+    auto Before = [&Runs](std::string_view Pass, std::string_view Function) {
+      Runs.push_back({std::string(Pass), std::string(Function),
+                      std::chrono::steady_clock::now()});
+    };
+    auto After = [&Runs, &Local]() {
+      if (Runs.empty()) {
+        return;
+      }
+      auto Run = std::move(Runs.back());
+      Runs.pop_back();
+      const auto Elapsed = std::chrono::steady_clock::now() - Run.Start;
+      if (!Runs.empty()) {
+        Runs.back().Nested += Elapsed;
+      }
+      Local.recordPass(Run.Pass, Run.Function,
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           Elapsed - Run.Nested));
+    };
+    if (auto Error = LLModule.runPasses(
+            toLLVMLevel(Conf.getOptimizationLevel()), TM, Before, After)) {
+      spdlog::error("{}"sv, Error.message().string_view());
+    }
+    Report->merge(Local);
+  } else {
+    auto PBO = LLVM::PassBuilderOptions::create();
+    if (auto Error = PBO.runPasses(
+            LLModule, toLLVMLevel(Conf.getOptimizationLevel()), TM)) {
+      spdlog::error("{}"sv, Error.message().string_view());
+    }
+  }
+#else
+  auto FP = LLVM::PassManager::createForModule(LLModule);
+  auto MP = LLVM::PassManager::create();
+
+  TM.addAnalysisPasses(MP);
+  TM.addAnalysisPasses(FP);
+  {
+    auto PMB = LLVM::PassManagerBuilder::create();
+    auto [OptLevel, SizeLevel] = toLLVMLevel(Conf.getOptimizationLevel());
+    PMB.setOptLevel(OptLevel);
+    PMB.setSizeLevel(SizeLevel);
+    PMB.populateFunctionPassManager(FP);
+    PMB.populateModulePassManager(MP);
+  }
+  switch (Conf.getOptimizationLevel()) {
+  case WasmEdge::CompilerConfigure::OptimizationLevel::O0:
+  case WasmEdge::CompilerConfigure::OptimizationLevel::O1:
+    FP.addTailCallEliminationPass();
+    break;
+  default:
+    break;
+  }
+
+  FP.initializeFunctionPassManager();
+  for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
+    FP.runFunctionPassManager(Fn);
+  }
+  FP.finalizeFunctionPassManager();
+  MP.runPassManager(LLModule);
+#endif
+  if (Report) {
+    recordInstructions(*Report, LLModule, true);
+  }
+  return {};
+}
+
+WasmEdge::Expect<void> optimize(LLVM::Data::DataContext &Part,
+                                const WasmEdge::CompilerConfigure &Conf,
+                                LLVM::CompileReport *Report) noexcept {
+  return optimize(Part.LLModule, Part.TM, Conf, Report);
+}
+
+/// Move every defined function into a deferred partition of its own, which
+/// the JIT optimizes and compiles at the first call of the function.
+WasmEdge::Expect<void> deferFunctions(LLVM::Data::DataContext &Main) noexcept {
+  std::vector<LLVM::Value> Functions;
+  for (auto Fn = Main.LLModule.getFirstFunction(); Fn;
+       Fn = Fn.getNextFunction()) {
+    if (!Fn.isDeclaration() && Fn.getLinkage() == LLVMExternalLinkage &&
+        Fn.getName().substr(0, 1) == "f"sv) {
+      Functions.push_back(Fn);
+    }
+  }
+  for (auto &Fn : Functions) {
+    auto Part = std::make_unique<LLVM::Data::DataContext>();
+    Part->LLModule = LLVM::Module::parseBitcode(
+        Part->getLLContext(), Main.LLModule.extractFunction(Fn));
+    if (unlikely(!Part->LLModule)) {
+      spdlog::error("parse function {} failed"sv, Fn.getName());
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalPath);
+    }
+    Fn.deleteBody();
+    Part->Deferred = true;
+    Main.Partitions.push_back(std::move(Part));
+  }
+  spdlog::info("{} functions deferred to the first calls"sv, Functions.size());
+  return {};
+}
+
+/// Move every defined function into a partition of its own, keyed in the
+/// function cache by the hash of its IR and the code generation options.
+/// Functions already in the cache are left as declarations and their objects
+/// are linked instead. The missed functions are locked until their objects
+/// are stored, and the functions locked by other processes are waited for.
+WasmEdge::Expect<void> useFunctionCache(LLVM::Data::DataContext &Main,
+                                        const WasmEdge::Configure &Conf) noexcept {
+  using WasmEdge::AOT::Cache;
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const auto Target = getTargetCPU(CompilerConf);
+  const auto Triple = LLVM::getDefaultTargetTriple();
+  const auto Options =
+      fmt::format("\n{} {} {} {}"sv, LLVM_VERSION_STRING, Triple.string_view(),
+                  Target.Name, Target.Features);
+  // The remote entries are grouped by the target of their objects.
+  const auto RemoteTarget =
+      fmt::format("{}/{}"sv, Triple.string_view(), Target.Name);
+  auto LoadCached = [&Main](const std::filesystem::path &Path) noexcept {
+    std::error_code Error;
+    if (!std::filesystem::is_regular_file(Path, Error)) {
+      return false;
+    }
+    auto [Object, ErrorMessage] =
+        LLVM::MemoryBuffer::getFile(Path.u8string().c_str());
+    if (ErrorMessage) {
+      return false;
+    }
+    Main.CachedObjects.push_back(std::move(Object));
+    Cache::touch(Path);
+    return true;
+  };
+
+  std::vector<LLVM::Value> Functions;
+  for (auto Fn = Main.LLModule.getFirstFunction(); Fn;
+       Fn = Fn.getNextFunction()) {
+    if (!Fn.isDeclaration() && Fn.getLinkage() == LLVMExternalLinkage &&
+        Fn.getName().substr(0, 1) == "f"sv) {
+      Functions.push_back(Fn);
+    }
+  }
+
+  size_t Hits = 0;
+  std::vector<std::unique_ptr<LLVM::Data::DataContext>> Busy;
+  for (auto &Fn : Functions) {
+    auto Part = std::make_unique<LLVM::Data::DataContext>();
+    Part->LLModule = LLVM::Module::parseBitcode(
+        Part->getLLContext(), Main.LLModule.extractFunction(Fn));
+    if (unlikely(!Part->LLModule)) {
+      spdlog::error("parse function {} failed"sv, Fn.getName());
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::IllegalPath);
+    }
+    std::string Key(Part->LLModule.printModuleToString().string_view());
+    Key += Options;
+    if (auto Res = Cache::getPath(
+            WasmEdge::Span<const WasmEdge::Byte>(
+                reinterpret_cast<const WasmEdge::Byte *>(Key.data()),
+                Key.size()),
+            Conf, Cache::StorageScope::Local, "functions"sv);
+        unlikely(!Res)) {
+      return WasmEdge::Unexpect(Res);
+    } else {
+      Part->CachePath = std::move(*Res);
+    }
+    Fn.deleteBody();
+
+    if (LoadCached(Part->CachePath)) {
+      ++Hits;
+      continue;
+    }
+    Part->CacheLock = Cache::Lock::acquire(Part->CachePath,
+                                           std::chrono::milliseconds(0));
+    if (!Part->CacheLock.owns()) {
+      Busy.push_back(std::move(Part));
+      continue;
+    }
+    // Stored by another process between the lookup and the lock.
+    if (LoadCached(Part->CachePath) ||
+        (Cache::fetch(Part->CachePath, RemoteTarget) &&
+         LoadCached(Part->CachePath))) {
+      Part->CacheLock = {};
+      ++Hits;
+      continue;
+    }
+    Part->CacheTarget = RemoteTarget;
+    Main.Partitions.push_back(std::move(Part));
+  }
+  // The functions compiled by other processes are waited for after locking
+  // the rest, and compiled here if not stored in time.
+  const auto Deadline = std::chrono::steady_clock::now() + kFunctionCacheWait;
+  for (auto &Part : Busy) {
+    const auto Now = std::chrono::steady_clock::now();
+    Part->CacheLock = Cache::Lock::acquire(
+        Part->CachePath,
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::max(Deadline - Now, std::chrono::steady_clock::duration{})));
+    if (LoadCached(Part->CachePath)) {
+      Part->CacheLock = {};
+      ++Hits;
+      continue;
+    }
+    Part->CacheTarget = RemoteTarget;
+    Main.Partitions.push_back(std::move(Part));
+  }
+  spdlog::info("function cache: {} hits, {} misses"sv, Hits,
+               Functions.size() - Hits);
+  if (WasmEdge::Metrics::isEnabled()) {
+    WasmEdge::Metrics::recordCacheLookup("functions"sv, Hits,
+                                         Functions.size() - Hits);
+  }
+  return {};
+}
+
+/// Find the tables never changed after the instantiation: the defined and not
+/// exported tables, which are only written by the active element segments with
+/// constant offsets. Return their function indices, with UINT32_MAX for the
+/// null references, and std::nullopt for the other tables.
+std::vector<std::optional<std::vector<uint32_t>>>
+findStaticTables(const AST::Module &Module) noexcept {
+  uint32_t ImportedTables = 0;
+  for (const auto &Desc : Module.getImportSection().getContent()) {
+    if (Desc.getExternalType() == ExternalType::Table) {
+      ++ImportedTables;
+    }
+  }
+  const auto TableSegs = Module.getTableSection().getContent();
+  std::vector<std::optional<std::vector<uint32_t>>> Tables(ImportedTables +
+                                                           TableSegs.size());
+
+  // The call sites compare the deduplicated function types, which only matches
+  // the runtime type check without the subtypes and the recursive types.
+  for (const auto &SubType : Module.getTypeSection().getContent()) {
+    if (!SubType.isFinal() || !SubType.getSuperTypeIndices().empty() ||
+        SubType.getRecursiveInfo()) {
+      return Tables;
+    }
+  }
+
+  for (size_t I = 0; I < TableSegs.size(); ++I) {
+    const auto Min = TableSegs[I].getTableType().getLimit().getMin();
+    const auto InitInstrs = TableSegs[I].getExpr().getInstrs();
+    if (Min > kMaxStaticTableSize ||
+        (!InitInstrs.empty() &&
+         InitInstrs.front().getOpCode() != OpCode::Ref__null)) {
+      continue;
+    }
+    Tables[ImportedTables + I].emplace(Min, UINT32_MAX);
+  }
+  for (const auto &Desc : Module.getExportSection().getContent()) {
+    if (Desc.getExternalType() == ExternalType::Table &&
+        Desc.getExternalIndex() < Tables.size()) {
+      Tables[Desc.getExternalIndex()].reset();
+    }
+  }
+
+  for (const auto &Seg : Module.getElementSection().getContent()) {
+    if (Seg.getMode() != AST::ElementSegment::ElemMode::Active ||
+        Seg.getIdx() >= Tables.size() || !Tables[Seg.getIdx()]) {
+      continue;
+    }
+    auto &Table = Tables[Seg.getIdx()];
+    const auto OffsetInstrs = Seg.getExpr().getInstrs();
+    const auto InitExprs = Seg.getInitExprs();
+    if (OffsetInstrs.empty() ||
+        OffsetInstrs.front().getOpCode() != OpCode::I32__const) {
+      Table.reset();
+      continue;
+    }
+    const uint64_t Offset = OffsetInstrs.front().getNum().get<uint32_t>();
+    if (Offset + InitExprs.size() > Table->size()) {
+      Table.reset();
+      continue;
+    }
+    for (size_t I = 0; I < InitExprs.size() && Table; ++I) {
+      const auto Instrs = InitExprs[I].getInstrs();
+      if (Instrs.empty()) {
+        Table.reset();
+      } else if (Instrs.front().getOpCode() == OpCode::Ref__func) {
+        (*Table)[Offset + I] = Instrs.front().getTargetIndex();
+      } else if (Instrs.front().getOpCode() == OpCode::Ref__null) {
+        (*Table)[Offset + I] = UINT32_MAX;
+      } else {
+        Table.reset();
+      }
+    }
+  }
+
+  for (const auto &Code : Module.getCodeSection().getContent()) {
+    auto Instrs = Code.getBodyInstrs();
+    if (!Instrs) {
+      return decltype(Tables)(Tables.size());
+    }
+    for (const auto &Instr : *Instrs) {
+      switch (Instr.getOpCode()) {
+      case OpCode::Table__set:
+      case OpCode::Table__grow:
+      case OpCode::Table__fill:
+      case OpCode::Table__copy:
+      case OpCode::Table__init:
+        if (Instr.getTargetIndex() < Tables.size()) {
+          Tables[Instr.getTargetIndex()].reset();
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+  return Tables;
+}
+
 } // namespace
 
 namespace WasmEdge {
 namespace LLVM {
 
+Expect<void> optimizeDeferred(LLVM::Module &LLModule,
+                              const CompilerConfigure &Conf) noexcept {
+  LLVM::TargetMachine TM;
+  return optimize(LLModule, TM, Conf, nullptr);
+}
+
 Expect<void> Compiler::checkConfigure() noexcept {
-  // Note: Although the exception handling proposal and memory64 proposal is not
-  // implemented in AOT yet, we should not trap here because the default
-  // configuration becomes WASM 3.0 which contains these proposals.
-  if (Conf.hasProposal(Proposal::ExceptionHandling)) {
-    spdlog::warn("Proposal Exception Handling is not yet supported in WasmEdge "
-                 "AOT/JIT. The compilation will be trapped when related data "
-                 "structure or instructions found in WASM.");
-  }
+  // Note: Although the memory64 proposal is not implemented in AOT yet, we
+  // should not trap here because the default configuration becomes WASM 3.0
+  // which contains this proposal. The modules with 64-bit memories are
+  // rejected in compilation, and the other modules are compiled as usual.
   if (Conf.hasProposal(Proposal::Memory64)) {
     spdlog::warn("Proposal Memory64 is not yet supported in WasmEdge AOT/JIT. "
-                 "The compilation will be trapped when related data "
-                 "structure or instructions found in WASM.");
+                 "The compilation will be trapped when 64-bit memories are "
+                 "found in WASM.");
   }
   if (Conf.hasProposal(Proposal::Annotations)) {
     spdlog::error(ErrCode::Value::InvalidAOTConfigure);
@@ -5856,6 +7106,11 @@ Expect<void> Compiler::checkConfigure() noexcept {
                   "in WasmEdge AOT/JIT.");
     return Unexpect(ErrCode::Value::InvalidAOTConfigure);
   }
+  if (Conf.getCompilerConfigure().getTargetLevel() > 4) {
+    spdlog::error(ErrCode::Value::InvalidAOTConfigure);
+    spdlog::error("    The x86-64 micro-architecture level must be 0 to 4.");
+    return Unexpect(ErrCode::Value::InvalidAOTConfigure);
+  }
   return {};
 }
 
@@ -5866,8 +7121,27 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
     return Unexpect(ErrCode::Value::NotValidated);
   }
 
+  // The 64-bit memories are only supported by the interpreter.
+  auto Is64 = [](const AST::MemoryType &MemType) {
+    return MemType.getLimit().is64();
+  };
+  const auto &Imports = Module.getImportSection().getContent();
+  const auto &Mems = Module.getMemorySection().getContent();
+  if (std::any_of(Imports.begin(), Imports.end(),
+                  [&Is64](const AST::ImportDesc &Desc) {
+                    return Desc.getExternalType() == ExternalType::Memory &&
+                           Is64(Desc.getExternalMemoryType());
+                  }) ||
+      std::any_of(Mems.begin(), Mems.end(), Is64)) {
+    spdlog::error(ErrCode::Value::InvalidAOTConfigure);
+    spdlog::error("    64-bit memories are not yet supported in WasmEdge "
+                  "AOT/JIT."sv);
+    return Unexpect(ErrCode::Value::InvalidAOTConfigure);
+  }
+
   std::unique_lock Lock(Mutex);
   spdlog::info("compile start"sv);
+  const auto CompileStart = std::chrono::steady_clock::now();
 
   LLVM::Core::init();
 
@@ -5877,8 +7151,16 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
   LLModule.setTarget(LLVM::getDefaultTargetTriple().unwrap());
   LLModule.addFlag(LLVMModuleFlagBehaviorError, "PIC Level"sv, 2);
 
+  // The generic binary selects the instructions by the baseline features,
+  // unless a micro-architecture level is set.
+  const auto Target = getTargetCPU(Conf.getCompilerConfigure());
   CompileContext NewContext(LLContext, LLModule,
-                            Conf.getCompilerConfigure().isGenericBinary());
+                            Target.Name == "generic"sv ? ""sv
+                                                       : Target.Features);
+  if (Prof && !Prof->empty()) {
+    NewContext.Prof = Prof;
+  }
+  NewContext.StaticTables = findStaticTables(Module);
   struct RAIICleanup {
     RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
         : Context(Context) {
@@ -5893,6 +7175,8 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
   compile(Module.getTypeSection());
   // Compile ImportSection
   compile(Module.getImportSection());
+  // Compile TagSection
+  compile(Module.getTagSection());
   // Compile GlobalSection
   compile(Module.getGlobalSection());
   // Compile MemorySection (MemorySec, DataSec)
@@ -5907,74 +7191,61 @@ Expect<Data> Compiler::compile(const AST::Module &Module) noexcept {
 
   spdlog::info("verify start"sv);
   LLModule.verify(LLVMPrintMessageAction);
-
-  spdlog::info("optimize start"sv);
-  auto &TM = D.extract().TM;
-  {
-    auto Triple = LLModule.getTarget();
-    auto [TheTarget, ErrorMessage] = LLVM::Target::getFromTriple(Triple);
-    if (ErrorMessage) {
-      spdlog::error("getFromTriple failed:{}"sv, ErrorMessage.string_view());
+  if (Report) {
+    recordInstructions(*Report, LLModule, false);
+    Report->recordPhase("translate"sv,
+                        std::chrono::steady_clock::now() - CompileStart);
+  }
+
+  const auto PartitionCount =
+      std::max(Conf.getCompilerConfigure().getPartitionCount(), UINT32_C(1));
+  if (Conf.getCompilerConfigure().isFunctionCache()) {
+    EXPECTED_TRY(useFunctionCache(D.extract(), Conf));
+  } else if (LazyFunctions) {
+    EXPECTED_TRY(deferFunctions(D.extract()));
+  } else if (PartitionCount > 1) {
+    spdlog::info("split start"sv);
+    renameLocals(LLModule);
+    auto Buffers = LLModule.split(PartitionCount);
+    LLModule = LLVM::Module::parseBitcode(LLContext, Buffers[0]);
+    if (unlikely(!LLModule)) {
+      spdlog::error("parse partition 0 failed"sv);
       return Unexpect(ErrCode::Value::IllegalPath);
-    } else {
-      std::string CPUName;
-#if defined(__riscv) && __riscv_xlen == 64
-      CPUName = "generic-rv64"s;
-#else
-      if (!Conf.getCompilerConfigure().isGenericBinary()) {
-        CPUName = LLVM::getHostCPUName().string_view();
-      } else {
-        CPUName = "generic"s;
-      }
-#endif
-
-      TM = LLVM::TargetMachine::create(
-          TheTarget, Triple, CPUName.c_str(),
-          LLVM::getHostCPUFeatures().unwrap(),
-          toLLVMCodeGenLevel(
-              Conf.getCompilerConfigure().getOptimizationLevel()),
-          LLVMRelocPIC, LLVMCodeModelDefault);
     }
-
-#if LLVM_VERSION_MAJOR >= 13
-    auto PBO = LLVM::PassBuilderOptions::create();
-    if (auto Error = PBO.runPasses(
-            LLModule,
-            toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel()),
-            TM)) {
-      spdlog::error("{}"sv, Error.message().string_view());
+    for (size_t I = 1; I < Buffers.size(); ++I) {
+      auto &Part = D.extract().Partitions.emplace_back(
+          std::make_unique<LLVM::Data::DataContext>());
+      Part->LLModule =
+          LLVM::Module::parseBitcode(Part->getLLContext(), Buffers[I]);
+      if (unlikely(!Part->LLModule)) {
+        spdlog::error("parse partition {} failed"sv, I);
+        return Unexpect(ErrCode::Value::IllegalPath);
+      }
     }
-#else
-    auto FP = LLVM::PassManager::createForModule(LLModule);
-    auto MP = LLVM::PassManager::create();
+  }
 
-    TM.addAnalysisPasses(MP);
-    TM.addAnalysisPasses(FP);
-    {
-      auto PMB = LLVM::PassManagerBuilder::create();
-      auto [OptLevel, SizeLevel] =
-          toLLVMLevel(Conf.getCompilerConfigure().getOptimizationLevel());
-      PMB.setOptLevel(OptLevel);
-      PMB.setSizeLevel(SizeLevel);
-      PMB.populateFunctionPassManager(FP);
-      PMB.populateModulePassManager(MP);
-    }
-    switch (Conf.getCompilerConfigure().getOptimizationLevel()) {
-    case CompilerConfigure::OptimizationLevel::O0:
-    case CompilerConfigure::OptimizationLevel::O1:
-      FP.addTailCallEliminationPass();
-      break;
-    default:
-      break;
+  spdlog::info("optimize start"sv);
+  const auto OptimizeStart = std::chrono::steady_clock::now();
+  {
+    // Every partition lives in its own context, so they can be optimized
+    // independently on worker threads.
+    std::vector<LLVM::Data::DataContext *> Parts = {&D.extract()};
+    for (auto &Part : D.extract().Partitions) {
+      if (!Part->Deferred) {
+        Parts.push_back(Part.get());
+      }
     }
-
-    FP.initializeFunctionPassManager();
-    for (auto Fn = LLModule.getFirstFunction(); Fn; Fn = Fn.getNextFunction()) {
-      FP.runFunctionPassManager(Fn);
+    std::vector<Expect<void>> Results(Parts.size());
+    parallelFor(Parts.size(), [&](size_t I) noexcept {
+      Results[I] = optimize(*Parts[I], Conf.getCompilerConfigure(), Report);
+    });
+    for (auto &Result : Results) {
+      EXPECTED_TRY(Result);
     }
-    FP.finalizeFunctionPassManager();
-    MP.runPassManager(LLModule);
-#endif
+  }
+  if (Report) {
+    Report->recordPhase("optimize"sv,
+                        std::chrono::steady_clock::now() - OptimizeStart);
   }
 
   // Set initializer for constant value
@@ -6152,6 +7423,10 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
       F.Fn.addFnAttr(Context->UWTable);
       F.Fn.addParamAttr(0, Context->ReadOnly);
       F.Fn.addParamAttr(0, Context->NoAlias);
+      if (Conf.getCompilerConfigure().getInlineBudget() > 0) {
+        // The host function trampoline only forwards to the intrinsic.
+        F.Fn.addFnAttr(Context->AlwaysInline);
+      }
 
       LLVM::Builder Builder(Context->LLContext);
       Builder.positionAtEnd(
@@ -6199,7 +7474,9 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
     }
     case ExternalType::Memory: // Memory type
     {
-      // Nothing to do.
+      // The imported memory is at least the size of the import type.
+      const auto &MemType = ImpDesc.getExternalMemoryType();
+      Context->MemorySizes.push_back(MemType.getLimit().getMin() * kPageSize);
       break;
     }
     case ExternalType::Global: // Global type
@@ -6209,11 +7486,16 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
       const auto &ValType = GlobType.getValType();
       auto Type = toLLVMType(Context->LLContext, ValType);
       Context->Globals.push_back(Type);
+      Context->ImportGlobalNum++;
       break;
     }
     case ExternalType::Tag: // Tag type
     {
-      // TODO: EXCEPTION - implement the AOT.
+      const auto TypeIdx = ImpDesc.getExternalTagType().getTypeIdx();
+      assuming(TypeIdx < Context->CompositeTypes.size());
+      Context->Tags.push_back(
+          &Context->CompositeTypes[TypeIdx]->getFuncType());
+      Context->ImportTagNum++;
       break;
     }
     default:
@@ -6224,6 +7506,14 @@ void Compiler::compile(const AST::ImportSection &ImportSec) noexcept {
 
 void Compiler::compile(const AST::ExportSection &) noexcept {}
 
+void Compiler::compile(const AST::TagSection &TagSec) noexcept {
+  for (const auto &TgType : TagSec.getContent()) {
+    const auto TypeIdx = TgType.getTypeIdx();
+    assuming(TypeIdx < Context->CompositeTypes.size());
+    Context->Tags.push_back(&Context->CompositeTypes[TypeIdx]->getFuncType());
+  }
+}
+
 void Compiler::compile(const AST::GlobalSection &GlobalSec) noexcept {
   for (const auto &GlobalSeg : GlobalSec.getContent()) {
     const auto &ValType = GlobalSeg.getGlobalType().getValType();
@@ -6232,8 +7522,12 @@ void Compiler::compile(const AST::GlobalSection &GlobalSec) noexcept {
   }
 }
 
-void Compiler::compile(const AST::MemorySection &,
-                       const AST::DataSection &) noexcept {}
+void Compiler::compile(const AST::MemorySection &MemorySec,
+                       const AST::DataSection &) noexcept {
+  for (const auto &MemType : MemorySec.getContent()) {
+    Context->MemorySizes.push_back(MemType.getLimit().getMin() * kPageSize);
+  }
+}
 
 void Compiler::compile(const AST::TableSection &,
                        const AST::ElementSection &) noexcept {}
@@ -6243,6 +7537,9 @@ Expect<void> Compiler::compile(const AST::FunctionSection &FuncSec,
   const auto &TypeIdxs = FuncSec.getContent();
   const auto &CodeSegs = CodeSec.getContent();
   assuming(TypeIdxs.size() == CodeSegs.size());
+  // Inline the functions within the budget of instructions into every caller
+  // in the same partition, regardless of the LLVM inliner cost model.
+  const uint32_t InlineBudget = Conf.getCompilerConfigure().getInlineBudget();
 
   for (size_t I = 0; I < CodeSegs.size(); ++I) {
     const auto &TypeIdx = TypeIdxs[I];
@@ -6259,14 +7556,60 @@ Expect<void> Compiler::compile(const AST::FunctionSection &FuncSec,
     F.Fn.setDSOLocal(true);
     F.Fn.setDLLStorageClass(LLVMDLLExportStorageClass);
     F.Fn.addFnAttr(Context->NoStackArgProbe);
+    // Touch every page of the large frames, so that the overflows always hit
+    // the guard page of the stack.
+    F.Fn.addFnAttr(Context->ProbeStack);
     F.Fn.addFnAttr(Context->StrictFP);
     F.Fn.addFnAttr(Context->UWTable);
     F.Fn.addParamAttr(0, Context->ReadOnly);
     F.Fn.addParamAttr(0, Context->NoAlias);
+    if (InlineBudget > 0) {
+      if (auto Instrs = Code.getBodyInstrs();
+          Instrs && Instrs->size() <= InlineBudget) {
+        F.Fn.addFnAttr(Context->AlwaysInline);
+      }
+    }
 
     Context->Functions.emplace_back(TypeIdx, F, &Code);
   }
 
+  if (Context->Prof) {
+    // Set the entry counts in the profile, and mark the functions never
+    // called as cold and the ones taking at least 1% of the calls as hot.
+    std::vector<std::pair<LLVM::Value, uint64_t>> Counts;
+    uint64_t Total = 0;
+    for (size_t I = 0; I < Context->Functions.size(); ++I) {
+      const auto *Code = std::get<2>(Context->Functions[I]);
+      if (!Code) {
+        continue;
+      }
+      auto Instrs = Code->getBodyInstrs();
+      if (!Instrs || Instrs->empty()) {
+        continue;
+      }
+      const uint32_t Offset = Instrs->begin()->getOffset();
+      Context->FunctionOffsets.emplace(Offset, static_cast<uint32_t>(I));
+      const uint64_t Count = Context->Prof->getCallCount(Offset);
+      Counts.emplace_back(std::get<1>(Context->Functions[I]).Fn, Count);
+      Total += Count;
+    }
+    LLVM::Attribute Hot =
+        LLVM::Attribute::createEnum(Context->LLContext, LLVM::Core::Hot, 0);
+    for (auto &[Fn, Count] : Counts) {
+      LLVM::Metadata EntryCount[] = {
+          LLVM::Metadata::getString(Context->LLContext,
+                                    "function_entry_count"sv),
+          Context->LLContext.getInt64(Count)};
+      Fn.setGlobalMetadata(LLVM::Core::Prof,
+                           LLVM::Metadata(Context->LLContext, EntryCount));
+      if (Count == 0) {
+        Fn.addFnAttr(Context->Cold);
+      } else if (LLVM::Core::Hot != 0 && Count * 100 >= Total) {
+        Fn.addFnAttr(Hot);
+      }
+    }
+  }
+
   for (auto [T, F, Code] : Context->Functions) {
     if (!Code) {
       continue;
@@ -6281,7 +7624,8 @@ Expect<void> Compiler::compile(const AST::FunctionSection &FuncSec,
     FunctionCompiler FC(*Context, F, Locals,
                         Conf.getCompilerConfigure().isInterruptible(),
                         Conf.getStatisticsConfigure().isInstructionCounting(),
-                        Conf.getStatisticsConfigure().isCostMeasuring());
+                        Conf.getStatisticsConfigure().isCostMeasuring(),
+                        Conf.getCompilerConfigure().isCoarseGasCheck());
     auto Type = Context->resolveBlockType(T);
     EXPECTED_TRY(FC.compile(*Code, std::move(Type)));
     F.Fn.eliminateUnreachableBlocks();
@@ -2,9 +2,19 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 #pragma once
 
+#include "aot/cache.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
 #include "llvm.h"
 #include "llvm/data.h"
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 struct WasmEdge::LLVM::Data::DataContext {
 #if LLVM_VERSION_MAJOR >= 21
   LLVM::Context LLContext = LLVM::Context::create();
@@ -21,5 +31,50 @@ struct WasmEdge::LLVM::Data::DataContext {
 #endif
   LLVM::Module LLModule;
   LLVM::TargetMachine TM;
+  /// Extra partitions of the module, each owning its own context, when the
+  /// compiler splits the functions for parallel code generation.
+  std::vector<std::unique_ptr<DataContext>> Partitions;
+  /// Function cache entry the object of this partition is stored to, empty if
+  /// the partition is not cached.
+  std::filesystem::path CachePath;
+  /// Lock of the function cache entry held until the object is stored.
+  WasmEdge::AOT::Cache::Lock CacheLock;
+  /// Target the cached object is shared under in the remote cache.
+  std::string CacheTarget;
+  /// Objects of the functions found in the function cache.
+  std::vector<LLVM::MemoryBuffer> CachedObjects;
+  /// The function of this partition is not optimized yet, and is compiled by
+  /// the JIT at its first call.
+  bool Deferred = false;
   DataContext() noexcept : LLModule(getLLContext(), "wasm") {}
 };
+
+namespace WasmEdge::LLVM {
+
+/// Run the optimization passes on the module of a deferred partition.
+Expect<void> optimizeDeferred(LLVM::Module &LLModule,
+                              const CompilerConfigure &Conf) noexcept;
+
+/// Run Fn on every index in [0, Count), using at most one thread per hardware
+/// thread including the calling one.
+template <typename FnT> void parallelFor(size_t Count, FnT &&Fn) noexcept {
+  std::atomic<size_t> Next = 0;
+  auto Worker = [&]() noexcept {
+    for (size_t I; (I = Next.fetch_add(1, std::memory_order_relaxed)) < Count;) {
+      Fn(I);
+    }
+  };
+  const size_t ThreadCount = std::min<size_t>(
+      Count, std::max(std::thread::hardware_concurrency(), 1u));
+  std::vector<std::thread> Workers;
+  Workers.reserve(ThreadCount > 0 ? ThreadCount - 1 : 0);
+  for (size_t I = 1; I < ThreadCount; ++I) {
+    Workers.emplace_back(Worker);
+  }
+  Worker();
+  for (auto &W : Workers) {
+    W.join();
+  }
+}
+
+} // namespace WasmEdge::LLVM
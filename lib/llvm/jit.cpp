@@ -2,7 +2,20 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
 #include "llvm/jit.h"
+#include "aot/blake3.h"
 #include "common/spdlog.h"
+#include "common/threadpool.h"
+#include "system/fault.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
 
 #include "data.h"
 #include "llvm.h"
@@ -12,10 +25,153 @@ using namespace std::literals;
 
 namespace WasmEdge::LLVM {
 
-JITLibrary::JITLibrary(OrcLLJIT JIT) noexcept
-    : J(std::make_unique<OrcLLJIT>(std::move(JIT)).release()) {}
+namespace {
+/// Suffix of the bodies of the lazy functions, whose plain names are their
+/// stubs.
+static inline constexpr const std::string_view kImplSuffix = ".impl"sv;
+
+bool isFunctionName(std::string_view Name) noexcept {
+  return Name.size() > 1 && Name[0] == 'f' &&
+         std::all_of(Name.begin() + 1, Name.end(),
+                     [](char C) { return C >= '0' && C <= '9'; });
+}
+
+#if LLVM_VERSION_MAJOR >= 13
+/// Called by the stubs instead of the functions failed to compile. The fault
+/// may be thrown to the unwinding handler.
+[[noreturn]] void lazyCompileFailed() {
+  Fault::emitFault(ErrCode::Value::HostFuncError);
+}
+#endif
+} // namespace
+
+struct JITLibrary::LazyContext {
+#if LLVM_VERSION_MAJOR >= 13
+  LazyContext(const CompilerConfigure &Conf, bool Speculate) noexcept
+      : Conf(Conf), Speculate(Speculate) {
+    Pool.setMaxThreads(1);
+  }
+  ~LazyContext() noexcept { stop(); }
+
+  /// Optimize the module of a lazy function when its stub is first called.
+  static LLVMErrorRef
+  transform(void *Ctx, LLVMOrcThreadSafeModuleRef *ModInOut,
+            LLVMOrcMaterializationResponsibilityRef) noexcept {
+    return LLVMOrcThreadSafeModuleWithModuleDo(
+        *ModInOut,
+        [](void *Ctx, LLVMModuleRef Ref) noexcept -> LLVMErrorRef {
+          static_cast<LazyContext *>(Ctx)->optimize(Ref);
+          return nullptr;
+        },
+        Ctx);
+  }
+
+  void optimize(LLVMModuleRef Ref) noexcept {
+    LLVM::Module LLModule(Ref);
+    bool IsLazy = false;
+    for (auto Fn = LLModule.getFirstFunction(); Fn && !IsLazy;
+         Fn = Fn.getNextFunction()) {
+      const auto Name = Fn.getName();
+      IsLazy = !Fn.isDeclaration() && Name.size() > kImplSuffix.size() &&
+               Name.substr(Name.size() - kImplSuffix.size()) == kImplSuffix;
+    }
+    if (IsLazy) {
+      // The errors are logged, and the function is compiled unoptimized.
+      [[maybe_unused]] auto Res = optimizeDeferred(LLModule, Conf);
+      if (Speculate) {
+        // Compile the functions still called after the inlining in the
+        // background, before their stubs are reached.
+        std::vector<std::string> Callees;
+        for (auto Fn = LLModule.getFirstFunction(); Fn;
+             Fn = Fn.getNextFunction()) {
+          if (Fn.isDeclaration() && isFunctionName(Fn.getName())) {
+            Callees.push_back(std::string(Fn.getName()) +
+                              std::string(kImplSuffix));
+          }
+        }
+        // The stubs compile the functions not speculated.
+        [[maybe_unused]] auto SpecRes = speculate(std::move(Callees));
+      }
+    }
+    LLModule.release();
+  }
+
+  /// Queue the functions to compile in the background. The speculation runs
+  /// on the thread pool, as this library is built without the exceptions to
+  /// catch the failures of starting a thread.
+  Expect<void> speculate(std::vector<std::string> Names) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (Stop) {
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    for (auto &Name : Names) {
+      if (Requested.insert(Name).second) {
+        Queue.push_back(std::move(Name));
+      }
+    }
+    if (Running || Queue.empty()) {
+      return {};
+    }
+    Running = true;
+    Lock.unlock();
+    Pool.submit([this, Caller = std::this_thread::get_id()]() noexcept {
+      run(Caller);
+    });
+    return {};
+  }
+
+  void run(std::thread::id Caller) noexcept {
+    std::unique_lock Lock(Mutex);
+    // The pool runs the task on the caller if no worker can be started, where
+    // looking up would wait for the materialization in progress.
+    while (!Stop && !Queue.empty() && std::this_thread::get_id() != Caller) {
+      const auto Name = std::move(Queue.front());
+      Queue.pop_front();
+      Lock.unlock();
+      LLVMOrcJITTargetAddress Addr;
+      LLVM::Error Err = LLVMOrcLLJITLookup(JIT, &Addr, Name.c_str());
+      Lock.lock();
+    }
+    // Leave the rest to the stubs.
+    Queue.clear();
+    Running = false;
+    Cond.notify_all();
+  }
+
+  /// Stop the speculation, which must be done before disposing the JIT.
+  void stop() noexcept {
+    std::unique_lock Lock(Mutex);
+    Stop = true;
+    Cond.wait(Lock, [this]() { return !Running; });
+  }
+
+  const CompilerConfigure Conf;
+  const bool Speculate;
+  LLVMOrcLLJITRef JIT = nullptr;
+  OrcIndirectStubsManager ISM;
+  OrcLazyCallThroughManager LCTM;
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::deque<std::string> Queue;
+  std::unordered_set<std::string> Requested;
+  bool Stop = false;
+  bool Running = false;
+  ThreadPool Pool;
+#endif
+};
+
+JITLibrary::JITLibrary(OrcLLJIT JIT, std::unique_ptr<LazyContext> L) noexcept
+    : J(std::make_unique<OrcLLJIT>(std::move(JIT)).release()),
+      Lazy(std::move(L)) {}
 
 JITLibrary::~JITLibrary() noexcept {
+#if LLVM_VERSION_MAJOR >= 13
+  if (Lazy) {
+    Lazy->stop();
+  }
+#endif
+  // The stubs are released after the JIT.
   std::unique_ptr<OrcLLJIT> JIT(std::exchange(J, nullptr));
 }
 
@@ -64,6 +220,7 @@ std::vector<Symbol<void>> JITLibrary::getCodes(size_t Offset,
 }
 
 Expect<std::shared_ptr<Executable>> JIT::load(Data D) noexcept {
+  std::unique_ptr<JITLibrary::LazyContext> Lazy;
   OrcLLJIT J;
   if (auto Res = OrcLLJIT::create(); !Res) {
     spdlog::error("{}"sv, Res.error().message().string_view());
@@ -72,22 +229,178 @@ Expect<std::shared_ptr<Executable>> JIT::load(Data D) noexcept {
     J = std::move(*Res);
   }
 
-  auto &LLModule = D.extract().LLModule;
-  auto TSContext = D.extract().getTSContext();
+  auto MainJD = J.getMainJITDylib();
+  const auto &Partitions = D.extract().Partitions;
+  if (std::any_of(Partitions.begin(), Partitions.end(),
+                  [](const auto &Part) { return Part->Deferred; })) {
+#if LLVM_VERSION_MAJOR >= 13
+    const auto &RuntimeConf = Conf.getRuntimeConfigure();
+    auto NewLazy = std::make_unique<JITLibrary::LazyContext>(
+        Conf.getCompilerConfigure(), RuntimeConf.isEnableJITSpeculation());
+    NewLazy->JIT = J.unwrap();
+    NewLazy->ISM = OrcIndirectStubsManager::create(J.getTripleString());
+    if (auto Res = OrcLazyCallThroughManager::create(
+            J.getTripleString(), J.getExecutionSession(), &lazyCompileFailed);
+        !Res) {
+      spdlog::warn("{}"sv, Res.error().message().string_view());
+    } else if (NewLazy->ISM) {
+      NewLazy->LCTM = std::move(*Res);
+      J.getIRTransformLayer().setTransform(&JITLibrary::LazyContext::transform,
+                                           NewLazy.get());
+      Lazy = std::move(NewLazy);
+    }
+#endif
+    if (!Lazy) {
+      spdlog::warn("lazy JIT unavailable, compile all functions at once"sv);
+    }
+  }
+
+  std::vector<std::string> LazyNames;
+  auto AddModule = [&](Data::DataContext &Part,
+                       const char *DumpName) -> Expect<void> {
+    auto &LLModule = Part.LLModule;
+    auto TSContext = Part.getTSContext();
+
+    if (Part.Deferred && Lazy) {
+      // The body is renamed, and the plain name becomes its stub.
+      for (auto Fn = LLModule.getFirstFunction(); Fn;
+           Fn = Fn.getNextFunction()) {
+        if (!Fn.isDeclaration() && Fn.getLinkage() == LLVMExternalLinkage &&
+            isFunctionName(Fn.getName())) {
+          std::string Name(Fn.getName());
+          Fn.setName(Name + std::string(kImplSuffix));
+          LazyNames.push_back(std::move(Name));
+        }
+      }
+    } else if (Part.Deferred) {
+      EXPECTED_TRY(optimizeDeferred(LLModule, Conf.getCompilerConfigure()));
+    }
+
+    if (Conf.getCompilerConfigure().isDumpIR()) {
+      if (auto ErrorMessage = LLModule.printModuleToFile(DumpName)) {
+        spdlog::error("printModuleToFile failed"sv);
+      }
+    }
 
-  if (Conf.getCompilerConfigure().isDumpIR()) {
-    if (auto ErrorMessage = LLModule.printModuleToFile("wasm-jit.ll")) {
-      spdlog::error("printModuleToFile failed"sv);
+    if (auto Err = J.addLLVMIRModule(
+            MainJD, OrcThreadSafeModule(LLModule.release(), TSContext))) {
+      spdlog::error("{}"sv, Err.message().string_view());
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    return {};
+  };
+
+  EXPECTED_TRY(AddModule(D.extract(), "wasm-jit.ll"));
+  for (size_t I = 0; I < D.extract().Partitions.size(); ++I) {
+    // The JIT does not store the functions, so the other processes waiting
+    // for them are released at once.
+    D.extract().Partitions[I]->CacheLock = {};
+    const auto DumpName = fmt::format("wasm-jit.{}.ll"sv, I + 1);
+    EXPECTED_TRY(AddModule(*D.extract().Partitions[I], DumpName.c_str()));
+  }
+  for (auto &Object : D.extract().CachedObjects) {
+    if (auto Err = J.addObjectFile(MainJD, std::move(Object))) {
+      spdlog::error("{}"sv, Err.message().string_view());
+      return Unexpect(ErrCode::Value::HostFuncError);
     }
   }
+#if LLVM_VERSION_MAJOR >= 13
+  if (Lazy) {
+    std::vector<LLVMOrcCSymbolAliasMapPair> Aliases;
+    Aliases.reserve(LazyNames.size());
+    const LLVMJITSymbolFlags Flags = {
+        LLVMJITSymbolGenericFlagsExported | LLVMJITSymbolGenericFlagsCallable,
+        0};
+    for (const auto &Name : LazyNames) {
+      const auto Impl = Name + std::string(kImplSuffix);
+      Aliases.push_back({J.mangleAndIntern(Name.c_str()),
+                         {J.mangleAndIntern(Impl.c_str()), Flags}});
+    }
+    if (auto Err = Lazy->LCTM.reexport(Lazy->ISM, MainJD, Aliases)) {
+      spdlog::error("{}"sv, Err.message().string_view());
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    spdlog::info("{} functions compiled at their first calls"sv,
+                 LazyNames.size());
+  }
+#endif
 
-  auto MainJD = J.getMainJITDylib();
-  if (auto Err = J.addLLVMIRModule(
-          MainJD, OrcThreadSafeModule(LLModule.release(), TSContext))) {
-    spdlog::error("{}"sv, Err.message().string_view());
-    return Unexpect(ErrCode::Value::HostFuncError);
+  return std::make_shared<JITLibrary>(std::move(J), std::move(Lazy));
+}
+
+namespace {
+using CacheKey = std::array<Byte, 32>;
+
+/// Cached executable of one key. The mutex serializes the loads of the key.
+struct CacheEntry {
+  std::mutex Mutex;
+  std::weak_ptr<Executable> Exec;
+};
+
+std::mutex CacheMutex;
+std::map<CacheKey, std::shared_ptr<CacheEntry>> Cache;
+
+CacheKey getCacheKey(Span<const Byte> Code, const Configure &Conf) noexcept {
+  const auto &CompilerConf = Conf.getCompilerConfigure();
+  const auto &StatConf = Conf.getStatisticsConfigure();
+  std::vector<Byte> Options = {
+      static_cast<Byte>(CompilerConf.getOptimizationLevel()),
+      static_cast<Byte>(CompilerConf.isGenericBinary()),
+      static_cast<Byte>(CompilerConf.isInterruptible()),
+      static_cast<Byte>(CompilerConf.isCoarseGasCheck()),
+      CompilerConf.getTargetLevel(),
+      static_cast<Byte>(StatConf.isInstructionCounting()),
+      static_cast<Byte>(StatConf.isCostMeasuring()),
+  };
+  const uint32_t InlineBudget = CompilerConf.getInlineBudget();
+  for (uint32_t Shift = 0; Shift < 32; Shift += 8) {
+    Options.push_back(static_cast<Byte>(InlineBudget >> Shift));
+  }
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    Options.push_back(
+        static_cast<Byte>(Conf.hasProposal(static_cast<Proposal>(I))));
   }
 
-  return std::make_shared<JITLibrary>(std::move(J));
+  AOT::Blake3 Hasher;
+  Hasher.update(Code);
+  Hasher.update(Options);
+  CacheKey Key;
+  Hasher.finalize(Key);
+  return Key;
 }
+} // namespace
+
+Expect<std::shared_ptr<Executable>> JITCache::getOrLoad(
+    Span<const Byte> Code, const Configure &Conf,
+    const std::function<Expect<std::shared_ptr<Executable>>()> &Load) noexcept {
+  const auto Key = getCacheKey(Code, Conf);
+  std::shared_ptr<CacheEntry> Entry;
+  {
+    std::unique_lock Lock(CacheMutex);
+    // Drop the entries whose executables are all released.
+    for (auto It = Cache.begin(); It != Cache.end();) {
+      if (It->first != Key && It->second->Exec.expired() &&
+          It->second.use_count() == 1) {
+        It = Cache.erase(It);
+      } else {
+        ++It;
+      }
+    }
+    auto &Slot = Cache[Key];
+    if (!Slot) {
+      Slot = std::make_shared<CacheEntry>();
+    }
+    Entry = Slot;
+  }
+
+  std::unique_lock Lock(Entry->Mutex);
+  if (auto Exec = Entry->Exec.lock()) {
+    spdlog::debug("JIT cache hit, share the loaded executable."sv);
+    return Exec;
+  }
+  EXPECTED_TRY(auto Exec, Load());
+  Entry->Exec = Exec;
+  return Exec;
+}
+
 } // namespace WasmEdge::LLVM
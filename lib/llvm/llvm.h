@@ -12,6 +12,8 @@
 #include "common/errcode.h"
 #include "common/span.h"
 #include <llvm-c/Analysis.h>
+#include <llvm-c/BitReader.h>
+#include <llvm-c/BitWriter.h>
 #include <llvm-c/Core.h>
 #include <llvm-c/Error.h>
 #include <llvm-c/Object.h>
@@ -19,6 +21,7 @@
 #include <llvm-c/Target.h>
 #include <llvm-c/TargetMachine.h>
 #include <llvm-c/Types.h>
+#include <functional>
 #include <mutex>
 #include <string_view>
 #include <utility>
@@ -92,6 +95,7 @@ public:
   static inline unsigned int ExperimentalConstrainedFSub = 0;
   static inline unsigned int Fabs = 0;
   static inline unsigned int Floor = 0;
+  static inline unsigned int Fma = 0;
   static inline unsigned int FShl = 0;
   static inline unsigned int FShr = 0;
   static inline unsigned int MaxNum = 0;
@@ -106,6 +110,7 @@ public:
   static inline unsigned int USubSat = 0;
   static inline unsigned int Bswap = 0;
 #if defined(__x86_64__)
+  static inline unsigned int X86AVX512VPDPBUSD128 = 0;
   static inline unsigned int X86SSE2PAvgB = 0;
   static inline unsigned int X86SSE2PAvgW = 0;
   static inline unsigned int X86SSE2PMAddWd = 0;
@@ -124,6 +129,7 @@ public:
 #if defined(__aarch64__)
   static inline unsigned int AArch64NeonFRIntN = 0;
   static inline unsigned int AArch64NeonSAddLP = 0;
+  static inline unsigned int AArch64NeonSDot = 0;
   static inline unsigned int AArch64NeonSQRDMulH = 0;
   static inline unsigned int AArch64NeonTbl1 = 0;
   static inline unsigned int AArch64NeonUAddLP = 0;
@@ -133,7 +139,9 @@ public:
   static inline unsigned int S390VPerm = 0;
 #endif
 
+  static inline unsigned int AlwaysInline = 0;
   static inline unsigned int Cold = 0;
+  static inline unsigned int Hot = 0;
   static inline unsigned int NoAlias = 0;
   static inline unsigned int NoInline = 0;
   static inline unsigned int NoReturn = 0;
@@ -147,6 +155,7 @@ public:
 #endif
 
   static inline unsigned int InvariantGroup = 0;
+  static inline unsigned int Prof = 0;
 
 private:
   static inline std::once_flag Once;
@@ -178,6 +187,7 @@ private:
         getIntrinsicID("llvm.experimental.constrained.fsub"sv);
     Fabs = getIntrinsicID("llvm.fabs"sv);
     Floor = getIntrinsicID("llvm.floor"sv);
+    Fma = getIntrinsicID("llvm.fma"sv);
     FShl = getIntrinsicID("llvm.fshl"sv);
     FShr = getIntrinsicID("llvm.fshr"sv);
     MaxNum = getIntrinsicID("llvm.maxnum"sv);
@@ -193,6 +203,7 @@ private:
     Bswap = getIntrinsicID("llvm.bswap"sv);
 
 #if defined(__x86_64__)
+    X86AVX512VPDPBUSD128 = getIntrinsicID("llvm.x86.avx512.vpdpbusd.128"sv);
     X86SSE2PAvgB = getIntrinsicID("llvm.x86.sse2.pavg.b"sv);
     X86SSE2PAvgW = getIntrinsicID("llvm.x86.sse2.pavg.w"sv);
     X86SSE2PMAddWd = getIntrinsicID("llvm.x86.sse2.pmadd.wd"sv);
@@ -211,6 +222,7 @@ private:
 #if defined(__aarch64__)
     AArch64NeonFRIntN = getIntrinsicID("llvm.aarch64.neon.frintn"sv);
     AArch64NeonSAddLP = getIntrinsicID("llvm.aarch64.neon.saddlp"sv);
+    AArch64NeonSDot = getIntrinsicID("llvm.aarch64.neon.sdot"sv);
     AArch64NeonSQRDMulH = getIntrinsicID("llvm.aarch64.neon.sqrdmulh"sv);
     AArch64NeonTbl1 = getIntrinsicID("llvm.aarch64.neon.tbl1"sv);
     AArch64NeonUAddLP = getIntrinsicID("llvm.aarch64.neon.uaddlp"sv);
@@ -220,7 +232,9 @@ private:
     S390VPerm = getIntrinsicID("llvm.s390.vperm"sv);
 #endif
 
+    AlwaysInline = getEnumAttributeKind("alwaysinline"sv);
     Cold = getEnumAttributeKind("cold"sv);
+    Hot = getEnumAttributeKind("hot"sv);
     NoAlias = getEnumAttributeKind("noalias"sv);
     NoInline = getEnumAttributeKind("noinline"sv);
     NoReturn = getEnumAttributeKind("noreturn"sv);
@@ -229,6 +243,7 @@ private:
     UWTable = getEnumAttributeKind("uwtable"sv);
 
     InvariantGroup = getMetadataKind("invariant.group"sv);
+    Prof = getMetadataKind("prof"sv);
   }
 
   template <typename... ArgsT>
@@ -252,13 +267,16 @@ private:
 };
 
 class Attribute;
+class Error;
 class Message;
+class MemoryBuffer;
 class Metadata;
 class PassManager;
 class Type;
 class Value;
 class Builder;
 class BasicBlock;
+class TargetMachine;
 
 class Context {
 public:
@@ -337,6 +355,21 @@ public:
   inline Value getNamedFunction(const char *Name) noexcept;
   inline Message printModuleToFile(const char *File) noexcept;
   inline Message verify(LLVMVerifierFailureAction Action) noexcept;
+  inline std::vector<MemoryBuffer> split(unsigned int Count) noexcept;
+  inline MemoryBuffer extractFunction(Value F) noexcept;
+#if LLVM_VERSION_MAJOR >= 13
+  /// Run the passes like PassBuilderOptions::runPasses, and call Before and
+  /// After around every pass run. Before gets the pass name and the function
+  /// it runs on, which is empty for the passes on the module.
+  inline Error
+  runPasses(const char *Passes, const TargetMachine &TM,
+            const std::function<void(std::string_view, std::string_view)>
+                &Before,
+            const std::function<void()> &After) noexcept;
+#endif
+  inline Message printModuleToString() noexcept;
+  static inline Module parseBitcode(const Context &C,
+                                    const MemoryBuffer &Buffer) noexcept;
 
   constexpr operator bool() const noexcept { return Ref != nullptr; }
   constexpr auto &unwrap() const noexcept { return Ref; }
@@ -468,6 +501,7 @@ public:
   }
   const char *data() const noexcept { return LLVMGetBufferStart(Ref); }
   size_t size() const noexcept { return LLVMGetBufferSize(Ref); }
+  LLVMMemoryBufferRef release() noexcept { return std::exchange(Ref, nullptr); }
 
 private:
   LLVMMemoryBufferRef Ref = nullptr;
@@ -781,14 +815,27 @@ public:
   inline void addCallSiteAttribute(const Attribute &A) noexcept;
   inline void setMetadata(Context &C, unsigned int KindID,
                           Metadata Node) noexcept;
+  inline void setGlobalMetadata(unsigned int KindID, Metadata Node) noexcept;
 
   Value getFirstParam() noexcept { return LLVMGetFirstParam(Ref); }
   Value getNextParam() noexcept { return LLVMGetNextParam(Ref); }
   Value getNextGlobal() noexcept { return LLVMGetNextGlobal(Ref); }
   Value getNextFunction() noexcept { return LLVMGetNextFunction(Ref); }
   unsigned int countBasicBlocks() noexcept { return LLVMCountBasicBlocks(Ref); }
+  inline uint64_t countInstructions() noexcept;
+  bool isDeclaration() noexcept { return LLVMIsDeclaration(Ref); }
+  inline void deleteBody() noexcept;
 
   Type getType() const noexcept { return LLVMTypeOf(Ref); }
+  uint64_t getZExtValue() const noexcept {
+    return LLVMConstIntGetZExtValue(Ref);
+  }
+  LLVMOpcode getInstructionOpcode() const noexcept {
+    return LLVMGetInstructionOpcode(Ref);
+  }
+  Value getOperand(unsigned int Index) const noexcept {
+    return LLVMGetOperand(Ref, Index);
+  }
   Value getInitializer() noexcept { return LLVMGetInitializer(Ref); }
   void setInitializer(Value ConstantVal) noexcept {
     LLVMSetInitializer(Ref, ConstantVal.unwrap());
@@ -826,6 +873,9 @@ public:
     auto Data = LLVMGetValueName2(Ref, &Length);
     return {Data, Length};
   }
+  void setName(std::string_view Name) noexcept {
+    LLVMSetValueName2(Ref, Name.data(), Name.size());
+  }
 
   inline void addCase(Value OnVal, BasicBlock Dest) noexcept;
   inline void addDestination(BasicBlock Dest) noexcept;
@@ -863,6 +913,9 @@ public:
     Ref = LLVMMDNodeInContext2(C.unwrap(), Data, Size);
   }
   Metadata(Value V) noexcept : Ref(LLVMValueAsMetadata(V.unwrap())) {}
+  static Metadata getString(Context &C, std::string_view Str) noexcept {
+    return LLVMMDStringInContext2(C.unwrap(), Str.data(), Str.size());
+  }
 
   constexpr operator bool() const noexcept { return Ref != nullptr; }
   constexpr auto &unwrap() const noexcept { return Ref; }
@@ -974,12 +1027,25 @@ Message Module::printModuleToFile(const char *Filename) noexcept {
   return M;
 }
 
+Message Module::printModuleToString() noexcept {
+  return LLVMPrintModuleToString(Ref);
+}
+
 Message Module::verify(LLVMVerifierFailureAction Action) noexcept {
   Message M;
   LLVMVerifyModule(Ref, Action, &M.unwrap());
   return M;
 }
 
+Module Module::parseBitcode(const Context &C,
+                            const MemoryBuffer &Buffer) noexcept {
+  Module M;
+  if (LLVMParseBitcodeInContext2(C.unwrap(), Buffer.unwrap(), &M.unwrap())) {
+    return {};
+  }
+  return M;
+}
+
 Type Context::getVoidTy() noexcept { return LLVMVoidTypeInContext(Ref); }
 Type Context::getInt1Ty() noexcept { return LLVMInt1TypeInContext(Ref); }
 Type Context::getInt8Ty() noexcept { return LLVMInt8TypeInContext(Ref); }
@@ -1031,6 +1097,9 @@ void Value::setMetadata(Context &C, unsigned int KindID,
                         Metadata Node) noexcept {
   LLVMSetMetadata(Ref, KindID, LLVMMetadataAsValue(C.unwrap(), Node.unwrap()));
 }
+void Value::setGlobalMetadata(unsigned int KindID, Metadata Node) noexcept {
+  LLVMGlobalSetMetadata(Ref, KindID, Node.unwrap());
+}
 
 static inline Message getDefaultTargetTriple() noexcept {
   return LLVMGetDefaultTargetTriple();
@@ -2191,6 +2260,109 @@ private:
   LLVMOrcIRTransformLayerRef Ref = nullptr;
 };
 
+#if LLVM_VERSION_MAJOR >= 13
+class OrcIndirectStubsManager {
+public:
+  constexpr OrcIndirectStubsManager() noexcept = default;
+  constexpr OrcIndirectStubsManager(LLVMOrcIndirectStubsManagerRef R) noexcept
+      : Ref(R) {}
+  OrcIndirectStubsManager(const OrcIndirectStubsManager &) = delete;
+  OrcIndirectStubsManager &operator=(const OrcIndirectStubsManager &) = delete;
+  OrcIndirectStubsManager(OrcIndirectStubsManager &&B) noexcept
+      : OrcIndirectStubsManager() {
+    swap(*this, B);
+  }
+  OrcIndirectStubsManager &operator=(OrcIndirectStubsManager &&B) noexcept {
+    swap(*this, B);
+    return *this;
+  }
+
+  ~OrcIndirectStubsManager() noexcept {
+    LLVMOrcDisposeIndirectStubsManager(Ref);
+  }
+
+  static OrcIndirectStubsManager create(const char *Triple) noexcept {
+    return LLVMOrcCreateLocalIndirectStubsManager(Triple);
+  }
+
+  constexpr operator bool() const noexcept { return Ref != nullptr; }
+  constexpr auto &unwrap() const noexcept { return Ref; }
+  constexpr auto &unwrap() noexcept { return Ref; }
+  friend void swap(OrcIndirectStubsManager &LHS,
+                   OrcIndirectStubsManager &RHS) noexcept {
+    using std::swap;
+    swap(LHS.Ref, RHS.Ref);
+  }
+
+private:
+  LLVMOrcIndirectStubsManagerRef Ref = nullptr;
+};
+
+class OrcLazyCallThroughManager {
+public:
+  constexpr OrcLazyCallThroughManager() noexcept = default;
+  constexpr OrcLazyCallThroughManager(
+      LLVMOrcLazyCallThroughManagerRef R) noexcept
+      : Ref(R) {}
+  OrcLazyCallThroughManager(const OrcLazyCallThroughManager &) = delete;
+  OrcLazyCallThroughManager &
+  operator=(const OrcLazyCallThroughManager &) = delete;
+  OrcLazyCallThroughManager(OrcLazyCallThroughManager &&B) noexcept
+      : OrcLazyCallThroughManager() {
+    swap(*this, B);
+  }
+  OrcLazyCallThroughManager &operator=(OrcLazyCallThroughManager &&B) noexcept {
+    swap(*this, B);
+    return *this;
+  }
+
+  ~OrcLazyCallThroughManager() noexcept {
+    LLVMOrcDisposeLazyCallThroughManager(Ref);
+  }
+
+  /// Create the manager of the trampolines, which jump to ErrorHandler if
+  /// the target of a call cannot be materialized.
+  static cxx20::expected<OrcLazyCallThroughManager, Error>
+  create(const char *Triple, LLVMOrcExecutionSessionRef ES,
+         void (*ErrorHandler)()) noexcept {
+    OrcLazyCallThroughManager Result;
+    if (auto Err = LLVMOrcCreateLocalLazyCallThroughManager(
+            Triple, ES,
+            static_cast<LLVMOrcJITTargetAddress>(
+                reinterpret_cast<uintptr_t>(ErrorHandler)),
+            &Result.Ref)) {
+      return cxx20::unexpected(Err);
+    }
+    return Result;
+  }
+
+  /// Define the Aliases in JD as the stubs compiling their targets at the
+  /// first calls. The names in the Aliases are consumed.
+  Error reexport(OrcIndirectStubsManager &ISM, const OrcJITDylib &JD,
+                 Span<LLVMOrcCSymbolAliasMapPair> Aliases) noexcept {
+    auto MU = LLVMOrcLazyReexports(Ref, ISM.unwrap(), JD.unwrap(),
+                                   Aliases.data(), Aliases.size());
+    if (auto Err = LLVMOrcJITDylibDefine(JD.unwrap(), MU)) {
+      LLVMOrcDisposeMaterializationUnit(MU);
+      return Err;
+    }
+    return {};
+  }
+
+  constexpr operator bool() const noexcept { return Ref != nullptr; }
+  constexpr auto &unwrap() const noexcept { return Ref; }
+  constexpr auto &unwrap() noexcept { return Ref; }
+  friend void swap(OrcLazyCallThroughManager &LHS,
+                   OrcLazyCallThroughManager &RHS) noexcept {
+    using std::swap;
+    swap(LHS.Ref, RHS.Ref);
+  }
+
+private:
+  LLVMOrcLazyCallThroughManagerRef Ref = nullptr;
+};
+#endif
+
 class OrcLLJIT {
 public:
   constexpr OrcLLJIT() noexcept = default;
@@ -2230,6 +2402,10 @@ public:
     return LLVMOrcLLJITAddLLVMIRModule(Ref, L.unwrap(), M.release());
   }
 
+  Error addObjectFile(const OrcJITDylib &L, MemoryBuffer ObjBuffer) noexcept {
+    return LLVMOrcLLJITAddObjectFile(Ref, L.unwrap(), ObjBuffer.release());
+  }
+
   template <typename T>
   cxx20::expected<T *, Error> lookup(const char *Name) noexcept {
     LLVMOrcJITTargetAddress Addr;
@@ -2243,6 +2419,22 @@ public:
     return LLVMOrcLLJITGetIRTransformLayer(Ref);
   }
 
+#if LLVM_VERSION_MAJOR >= 13
+  const char *getTripleString() noexcept {
+    return LLVMOrcLLJITGetTripleString(Ref);
+  }
+
+  LLVMOrcExecutionSessionRef getExecutionSession() noexcept {
+    return LLVMOrcLLJITGetExecutionSession(Ref);
+  }
+
+  /// Get the mangled name of Name in the symbol pool, which must be released
+  /// unless consumed.
+  LLVMOrcSymbolStringPoolEntryRef mangleAndIntern(const char *Name) noexcept {
+    return LLVMOrcLLJITMangleAndIntern(Ref, Name);
+  }
+#endif
+
 private:
   LLVMOrcLLJITRef Ref = nullptr;
 
@@ -2252,8 +2444,17 @@ private:
 } // namespace WasmEdge::LLVM
 
 #include <llvm/IR/GlobalValue.h>
+#include <llvm/IR/Module.h>
 #include <llvm/Object/ObjectFile.h>
+#if LLVM_VERSION_MAJOR >= 13
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/PassInstrumentation.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Target/TargetMachine.h>
+#endif
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 #if LLVM_VERSION_MAJOR < 12 || WASMEDGE_OS_WINDOWS
 #include <llvm/ExecutionEngine/Orc/Core.h>
 #endif
@@ -2297,6 +2498,189 @@ void Value::setDSOLocal(bool Local) noexcept {
       ->setDSOLocal(Local);
 }
 
+std::vector<MemoryBuffer> Module::split(unsigned int Count) noexcept {
+  std::vector<MemoryBuffer> Result;
+  Result.reserve(Count);
+  llvm::SplitModule(
+      *llvm::unwrap(Ref), Count,
+      [&Result](std::unique_ptr<llvm::Module> Part) {
+        Result.emplace_back(LLVMWriteBitcodeToMemoryBuffer(llvm::wrap(Part.get())));
+      },
+      false);
+  return Result;
+}
+
+namespace detail {
+/// Create the global values used by an extracted function in its new module.
+/// Local definitions are cloned, since they are not visible from the other
+/// modules, and everything else is only declared.
+class FunctionExtractor final : public llvm::ValueMaterializer {
+public:
+  FunctionExtractor(llvm::Module &Dst) noexcept : Dst(Dst) {}
+
+  llvm::Function *declare(const llvm::Function *F) {
+    auto *NewF = llvm::Function::Create(F->getFunctionType(), F->getLinkage(),
+                                        F->getAddressSpace(), F->getName(),
+                                        &Dst);
+    NewF->copyAttributesFrom(F);
+    return NewF;
+  }
+
+  llvm::Value *materialize(llvm::Value *V) override {
+    auto *GV = llvm::dyn_cast<llvm::GlobalValue>(V);
+    if (!GV) {
+      return nullptr;
+    }
+    llvm::GlobalValue *NewGV = nullptr;
+    if (auto *F = llvm::dyn_cast<llvm::Function>(GV)) {
+      NewGV = declare(F);
+    } else if (auto *Var = llvm::dyn_cast<llvm::GlobalVariable>(GV)) {
+      auto *NewVar = new llvm::GlobalVariable(
+          Dst, Var->getValueType(), Var->isConstant(), Var->getLinkage(),
+          nullptr, Var->getName(), nullptr, Var->getThreadLocalMode(),
+          Var->getType()->getAddressSpace());
+      NewVar->copyAttributesFrom(Var);
+      NewGV = NewVar;
+    } else {
+      // An alias cannot be declared, reference the symbol by its value type.
+      if (auto *FTy = llvm::dyn_cast<llvm::FunctionType>(GV->getValueType())) {
+        NewGV = llvm::Function::Create(FTy, llvm::GlobalValue::ExternalLinkage,
+                                       GV->getAddressSpace(), GV->getName(),
+                                       &Dst);
+      } else {
+        NewGV = new llvm::GlobalVariable(
+            Dst, GV->getValueType(), false, llvm::GlobalValue::ExternalLinkage,
+            nullptr, GV->getName(), nullptr, GV->getThreadLocalMode(),
+            GV->getAddressSpace());
+      }
+      NewGV->setVisibility(GV->getVisibility());
+      NewGV->setDSOLocal(GV->isDSOLocal());
+      return NewGV;
+    }
+    if (GV->hasLocalLinkage()) {
+      Pending.push_back(GV);
+    } else {
+      NewGV->setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+    return NewGV;
+  }
+
+  /// Local definitions whose bodies or initializers are not cloned yet.
+  std::vector<const llvm::GlobalValue *> Pending;
+
+private:
+  llvm::Module &Dst;
+};
+} // namespace detail
+
+MemoryBuffer Module::extractFunction(Value F) noexcept {
+  const auto &Src = *llvm::unwrap(Ref);
+  auto *Fn =
+      llvm::cast<llvm::Function>(reinterpret_cast<llvm::Value *>(F.unwrap()));
+  llvm::Module Part(Src.getModuleIdentifier(), Src.getContext());
+  Part.setSourceFileName(Src.getSourceFileName());
+  Part.setDataLayout(Src.getDataLayout());
+  Part.setTargetTriple(Src.getTargetTriple());
+  llvm::SmallVector<llvm::Module::ModuleFlagEntry, 4> Flags;
+  Src.getModuleFlagsMetadata(Flags);
+  for (const auto &Flag : Flags) {
+    Part.addModuleFlag(Flag.Behavior, Flag.Key->getString(), Flag.Val);
+  }
+
+  llvm::ValueToValueMapTy VMap;
+  detail::FunctionExtractor Extractor(Part);
+  VMap[Fn] = Extractor.declare(Fn);
+  Extractor.Pending.push_back(Fn);
+  while (!Extractor.Pending.empty()) {
+    const auto *GV = Extractor.Pending.back();
+    Extractor.Pending.pop_back();
+    if (const auto *SrcF = llvm::dyn_cast<llvm::Function>(GV)) {
+      auto *DstF = llvm::cast<llvm::Function>(VMap[SrcF]);
+      auto DstArg = DstF->arg_begin();
+      for (const auto &Arg : SrcF->args()) {
+        DstArg->setName(Arg.getName());
+        VMap[&Arg] = &*DstArg++;
+      }
+      llvm::SmallVector<llvm::ReturnInst *, 8> Returns;
+      llvm::CloneFunctionInto(DstF, SrcF, VMap,
+#if LLVM_VERSION_MAJOR >= 13
+                              llvm::CloneFunctionChangeType::DifferentModule,
+#else
+                              true,
+#endif
+                              Returns, "", nullptr, nullptr, &Extractor);
+    } else if (const auto *SrcVar = llvm::dyn_cast<llvm::GlobalVariable>(GV);
+               SrcVar && SrcVar->hasInitializer()) {
+      llvm::cast<llvm::GlobalVariable>(VMap[SrcVar])
+          ->setInitializer(llvm::MapValue(SrcVar->getInitializer(), VMap,
+                                          llvm::RF_None, nullptr, &Extractor));
+    }
+  }
+
+  // Every module gets its own copy of the local symbols, keep them out of the
+  // symbol table of the linked library.
+  for (auto &GV : Part.global_values()) {
+    if (GV.hasLocalLinkage()) {
+      GV.setLinkage(llvm::GlobalValue::PrivateLinkage);
+    }
+  }
+  return LLVMWriteBitcodeToMemoryBuffer(llvm::wrap(&Part));
+}
+
+#if LLVM_VERSION_MAJOR >= 13
+Error Module::runPasses(
+    const char *Passes, const TargetMachine &TM,
+    const std::function<void(std::string_view, std::string_view)> &Before,
+    const std::function<void()> &After) noexcept {
+  llvm::PassInstrumentationCallbacks PIC;
+  PIC.registerBeforeNonSkippedPassCallback(
+      [&Before](llvm::StringRef Pass, llvm::Any IR) {
+        llvm::StringRef Function;
+        if (const auto *F = llvm::any_cast<const llvm::Function *>(&IR)) {
+          Function = (*F)->getName();
+        } else if (const auto *L = llvm::any_cast<const llvm::Loop *>(&IR)) {
+          Function = (*L)->getHeader()->getParent()->getName();
+        }
+        Before({Pass.data(), Pass.size()}, {Function.data(), Function.size()});
+      });
+  PIC.registerAfterPassCallback(
+      [&After](llvm::StringRef, llvm::Any, const llvm::PreservedAnalyses &) {
+        After();
+      });
+  PIC.registerAfterPassInvalidatedCallback(
+      [&After](llvm::StringRef, const llvm::PreservedAnalyses &) { After(); });
+
+  llvm::PassBuilder PB(reinterpret_cast<llvm::TargetMachine *>(TM.unwrap()),
+                       llvm::PipelineTuningOptions(), {}, &PIC);
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM;
+  if (auto Err = PB.parsePassPipeline(MPM, Passes)) {
+    return llvm::wrap(std::move(Err));
+  }
+  MPM.run(*llvm::unwrap(Ref), MAM);
+  return Error();
+}
+#endif
+
+uint64_t Value::countInstructions() noexcept {
+  return llvm::cast<llvm::Function>(reinterpret_cast<llvm::Value *>(Ref))
+      ->getInstructionCount();
+}
+
+void Value::deleteBody() noexcept {
+  llvm::cast<llvm::Function>(reinterpret_cast<llvm::Value *>(Ref))
+      ->deleteBody();
+}
+
 void Value::eliminateUnreachableBlocks() noexcept {
   llvm::EliminateUnreachableBlocks(
       *llvm::cast<llvm::Function>(reinterpret_cast<llvm::Value *>(Ref)));
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "llvm/report.h"
+
+#include "common/errinfo.h"
+#include "common/spdlog.h"
+
+#include <fstream>
+
+using namespace std::literals;
+
+namespace WasmEdge::LLVM {
+
+namespace {
+/// Write the string as a JSON string.
+void writeString(std::ostream &OS, std::string_view S) {
+  OS << '"';
+  for (const char C : S) {
+    if (C == '"' || C == '\\') {
+      OS << '\\' << C;
+    } else if (static_cast<unsigned char>(C) < 0x20) {
+      OS << ' ';
+    } else {
+      OS << C;
+    }
+  }
+  OS << '"';
+}
+} // namespace
+
+void CompileReport::recordInstructions(std::string_view Name, uint64_t Count,
+                                       bool IsOptimized) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Functions.try_emplace(std::string(Name)).first;
+  (IsOptimized ? It->second.OptimizedInstructions : It->second.Instructions) =
+      Count;
+}
+
+void CompileReport::recordPass(std::string_view Name,
+                               std::string_view Function,
+                               std::chrono::nanoseconds Time) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto PassIt = Passes.find(Name);
+  if (PassIt == Passes.end()) {
+    PassIt = Passes.try_emplace(std::string(Name)).first;
+  }
+  ++PassIt->second.Runs;
+  PassIt->second.Time += Time;
+  if (!Function.empty()) {
+    auto FuncIt = Functions.find(Function);
+    if (FuncIt == Functions.end()) {
+      FuncIt = Functions.try_emplace(std::string(Function)).first;
+    }
+    FuncIt->second.OptimizeTime += Time;
+  }
+}
+
+void CompileReport::recordCodegen(Span<const std::string> Names,
+                                  std::chrono::nanoseconds Time) noexcept {
+  std::unique_lock Lock(Mutex);
+  Objects.emplace_back(Names.size(), Time);
+  if (Names.size() == 1) {
+    Functions[Names[0]].CodegenTime += Time;
+  }
+}
+
+void CompileReport::recordCodeSize(std::string_view Name,
+                                   uint64_t Size) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Functions.find(Name); It != Functions.end()) {
+    It->second.CodeSize = Size;
+  }
+}
+
+void CompileReport::recordPhase(std::string_view Name,
+                                std::chrono::nanoseconds Time) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Phases.find(Name);
+  if (It == Phases.end()) {
+    It = Phases.try_emplace(std::string(Name), 0).first;
+  }
+  It->second += Time;
+}
+
+void CompileReport::merge(const CompileReport &Other) noexcept {
+  std::unique_lock OtherLock(Other.Mutex);
+  std::unique_lock Lock(Mutex);
+  for (const auto &[Name, F] : Other.Functions) {
+    auto &Merged = Functions[Name];
+    if (F.Instructions) {
+      Merged.Instructions = F.Instructions;
+    }
+    if (F.OptimizedInstructions) {
+      Merged.OptimizedInstructions = F.OptimizedInstructions;
+    }
+    Merged.OptimizeTime += F.OptimizeTime;
+    Merged.CodegenTime += F.CodegenTime;
+    if (F.CodeSize) {
+      Merged.CodeSize = F.CodeSize;
+    }
+  }
+  for (const auto &[Name, P] : Other.Passes) {
+    auto &Merged = Passes[Name];
+    Merged.Runs += P.Runs;
+    Merged.Time += P.Time;
+  }
+  for (const auto &[Name, Time] : Other.Phases) {
+    Phases[Name] += Time;
+  }
+  Objects.insert(Objects.end(), Other.Objects.begin(), Other.Objects.end());
+}
+
+const CompileReport::Function *
+CompileReport::getFunction(std::string_view Name) const noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Functions.find(Name); It != Functions.end()) {
+    return &It->second;
+  }
+  return nullptr;
+}
+
+const CompileReport::Pass *
+CompileReport::getPass(std::string_view Name) const noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Passes.find(Name); It != Passes.end()) {
+    return &It->second;
+  }
+  return nullptr;
+}
+
+bool CompileReport::empty() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Functions.empty() && Passes.empty() && Phases.empty() &&
+         Objects.empty();
+}
+
+Expect<void> CompileReport::save(const std::filesystem::path &Path) const
+    noexcept {
+  std::unique_lock Lock(Mutex);
+  std::ofstream OS(Path, std::ios::out | std::ios::trunc);
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+
+  // The times are in nanoseconds.
+  OS << "{\n  \"phases\": {";
+  const char *Sep = "\n";
+  for (const auto &[Name, Time] : Phases) {
+    OS << Sep << "    ";
+    writeString(OS, Name);
+    OS << ": " << Time.count();
+    Sep = ",\n";
+  }
+  OS << "\n  },\n  \"functions\": [";
+  Sep = "\n";
+  Function Total;
+  for (const auto &[Name, F] : Functions) {
+    OS << Sep << "    {\"name\": ";
+    writeString(OS, Name);
+    OS << ", \"instructions\": " << F.Instructions
+       << ", \"optimized_instructions\": " << F.OptimizedInstructions
+       << ", \"optimize_time\": " << F.OptimizeTime.count()
+       << ", \"codegen_time\": " << F.CodegenTime.count()
+       << ", \"code_size\": " << F.CodeSize << '}';
+    Sep = ",\n";
+    Total.Instructions += F.Instructions;
+    Total.OptimizedInstructions += F.OptimizedInstructions;
+    Total.CodeSize += F.CodeSize;
+  }
+  OS << "\n  ],\n  \"passes\": [";
+  Sep = "\n";
+  for (const auto &[Name, P] : Passes) {
+    OS << Sep << "    {\"name\": ";
+    writeString(OS, Name);
+    OS << ", \"runs\": " << P.Runs << ", \"time\": " << P.Time.count() << '}';
+    Sep = ",\n";
+  }
+  OS << "\n  ],\n  \"objects\": [";
+  Sep = "\n";
+  for (const auto &[Count, Time] : Objects) {
+    OS << Sep << "    {\"functions\": " << Count
+       << ", \"codegen_time\": " << Time.count() << '}';
+    Sep = ",\n";
+  }
+  OS << "\n  ],\n  \"totals\": {\"instructions\": " << Total.Instructions
+     << ", \"optimized_instructions\": " << Total.OptimizedInstructions
+     << ", \"code_size\": " << Total.CodeSize << "}\n}\n";
+
+  OS.flush();
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+} // namespace WasmEdge::LLVM
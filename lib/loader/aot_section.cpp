@@ -35,7 +35,8 @@ inline constexpr uint64_t roundUpPageBoundary(const uint64_t Value) {
 
 namespace WasmEdge::Loader {
 
-Expect<void> AOTSection::load(const AST::AOTSection &AOTSec) noexcept {
+Expect<void> AOTSection::load(const AST::AOTSection &AOTSec,
+                              bool HugePages) noexcept {
   BinarySize = 0;
   for (const auto &Section : AOTSec.getSections()) {
     const auto Offset = std::get<1>(Section);
@@ -44,14 +45,33 @@ Expect<void> AOTSection::load(const AST::AOTSection &AOTSec) noexcept {
   }
   BinarySize = roundUpPageBoundary(BinarySize);
 
-  Binary = Allocator::allocate_chunk(BinarySize);
+  Binary = Allocator::allocate_chunk(BinarySize, HugePages);
   if (unlikely(!Binary)) {
     spdlog::error(ErrCode::Value::MemoryOutOfBounds);
     return Unexpect(ErrCode::Value::MemoryOutOfBounds);
   }
 
+  const auto &Sections = AOTSec.getSections();
+  const auto &FileOffsets = AOTSec.getFileOffsets();
+  const auto &File = AOTSec.getSourceFile();
+  // Check that no other section shares the pages of the section.
+  auto OwnsPages = [&Sections](size_t Index, uint64_t Begin, uint64_t End) {
+    for (size_t I = 0; I < Sections.size(); ++I) {
+      const auto Offset = std::get<1>(Sections[I]);
+      if (I != Index && std::get<0>(Sections[I]) != 0 && Offset < End &&
+          Begin < Offset + std::get<2>(Sections[I])) {
+        return false;
+      }
+    }
+    return true;
+  };
+
   std::vector<std::pair<uint8_t *, uint64_t>> ExecutableRanges;
-  for (const auto &Section : AOTSec.getSections()) {
+  for (size_t I = 0; I < Sections.size(); ++I) {
+    const auto &Section = Sections[I];
+    if (std::get<0>(Section) == 0) { // Padding
+      continue;
+    }
     const auto Offset = std::get<1>(Section);
     const auto Size = std::get<2>(Section);
     const auto &Content = std::get<3>(Section);
@@ -59,7 +79,26 @@ Expect<void> AOTSection::load(const AST::AOTSection &AOTSec) noexcept {
         Offset + Size > BinarySize || Content.size() > Size) {
       return Unexpect(ErrCode::Value::IntegerTooLarge);
     }
-    std::copy(Content.begin(), Content.end(), Binary + Offset);
+    const auto FileOffset = I < FileOffsets.size() ? FileOffsets[I] : 0;
+    if (FileOffset != 0 && File) {
+      // The text content is left in the file. Map its pages from the file
+      // to share them across processes, or copy it if the pages are not
+      // aligned the same or shared with the other sections.
+      const auto O = roundDownPageBoundary(Offset);
+      const auto S = roundUpPageBoundary(Size + (Offset - O));
+      if (!HugePages && FileOffset >= Offset - O &&
+          roundDownPageBoundary(FileOffset - (Offset - O)) ==
+              FileOffset - (Offset - O) &&
+          OwnsPages(I, O, O + S) &&
+          File->mapExecutable(Binary + O, FileOffset - (Offset - O), S)) {
+        continue;
+      }
+      const auto *Source =
+          reinterpret_cast<const Byte *>(File->address()) + FileOffset;
+      std::copy(Source, Source + Size, Binary + Offset);
+    } else {
+      std::copy(Content.begin(), Content.end(), Binary + Offset);
+    }
     switch (std::get<0>(Section)) {
     case 1: { // Text
       const auto O = roundDownPageBoundary(Offset);
@@ -16,10 +16,27 @@ Expect<void> Loader::loadExpression(AST::Expression &Expr,
         return E;
       })
       .and_then([&](auto Instrs) {
-        Expr.getInstrs() = Instrs;
+        Expr.getInstrs() = std::move(Instrs);
         return Expect<void>{};
       });
 }
 
+// Load a deferred function body. See "include/loader/loader.h".
+Expect<void> Loader::loadLazyExpression(const LazyContext &Ctx,
+                                        Span<const Byte> Body,
+                                        AST::Expression &Expr) {
+  // Decode in the whole input to keep the instruction offsets.
+  Loader Load(Ctx.Conf);
+  Load.HasDataSection = Ctx.HasDataSection;
+  Load.FMgr.setCode(Ctx.Code);
+  const auto Begin = static_cast<uint64_t>(Body.data() - Ctx.Code.data());
+  Load.FMgr.seek(Begin);
+  return Load.loadExpression(Expr, Begin + Body.size())
+      .map_error([](auto E) {
+        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+        return E;
+      });
+}
+
 } // namespace Loader
 } // namespace WasmEdge
@@ -124,7 +124,10 @@ Expect<OpCode> Loader::loadOpCode() {
 
 // Load instruction sequence. See "include/loader/loader.h".
 Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
-  AST::InstrVec Instrs;
+  // Decode into the reused buffer, and move the instructions into the arena
+  // at once with the exact size.
+  AST::InstrVec &Instrs = InstrBuffer;
+  Instrs.clear();
   std::vector<std::pair<OpCode, uint32_t>> BlockStack;
   uint32_t Cnt = 0;
   bool IsReachEnd = false;
@@ -224,7 +227,19 @@ Expect<AST::InstrVec> Loader::loadInstrSeq(std::optional<uint64_t> SizeBound) {
                           ASTNodeAttr::Instruction);
     }
   }
-  return Instrs;
+  AST::InstrVec Result{AST::InstrVec::allocator_type(NodeArena)};
+  {
+    // Only the allocation is serialized if the arena is shared.
+    std::unique_lock<std::mutex> Lock;
+    if (ArenaMutex) {
+      Lock = std::unique_lock(*ArenaMutex);
+    }
+    Result.reserve(Instrs.size());
+  }
+  Result.assign(std::make_move_iterator(Instrs.begin()),
+                std::make_move_iterator(Instrs.end()));
+  Instrs.clear();
+  return Result;
 }
 
 // Load instruction node. See "include/loader/loader.h".
@@ -265,12 +280,15 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
                           FMgr.getLastOffset(), ASTNodeAttr::Instruction);
     }
     if (Conf.hasProposal(Proposal::Memory64)) {
-      // TODO: MEMORY64 - fully support implementation.
+      // The range of the offset is checked by the index type of the memory
+      // in validation.
       uint64_t Offset;
       EXPECTED_TRY(readU64(Offset));
-      Instr.getMemoryOffset() = static_cast<uint32_t>(Offset);
+      Instr.setMemoryOffset(Offset);
     } else {
-      EXPECTED_TRY(readU32(Instr.getMemoryOffset()));
+      uint32_t Offset;
+      EXPECTED_TRY(readU32(Offset));
+      Instr.setMemoryOffset(Offset);
     }
     return {};
   };
@@ -355,6 +373,44 @@ Expect<void> Loader::loadInstruction(AST::Instruction &Instr) {
   case OpCode::Throw:
     return readU32(Instr.getTargetIndex());
 
+  // Stack switching instructions.
+  case OpCode::Cont__new:
+  case OpCode::Suspend:
+    return readU32(Instr.getTargetIndex());
+
+  case OpCode::Cont__bind:
+  case OpCode::Switch:
+    // Read the continuation type index, and the type or tag index.
+    EXPECTED_TRY(readU32(Instr.getTargetIndex()));
+    return readU32(Instr.getSourceIndex());
+
+  case OpCode::Resume:
+  case OpCode::Resume_throw: {
+    Instr.setResume();
+    auto &Desc = Instr.getResume();
+    EXPECTED_TRY(readU32(Desc.ContTypeIndex));
+    if (Instr.getOpCode() == OpCode::Resume_throw) {
+      EXPECTED_TRY(readU32(Desc.TagIndex));
+    }
+    EXPECTED_TRY(uint32_t VecCnt, loadVecCnt().map_error(ReportError));
+    Desc.Handlers.resize(VecCnt);
+    for (auto &Handler : Desc.Handlers) {
+      // Read the handler flag: 0x00 for (on tag label), 0x01 for (on tag
+      // switch).
+      EXPECTED_TRY(uint8_t Flag, FMgr.readByte().map_error(ReportError));
+      if (unlikely(Flag > 0x01U)) {
+        return logLoadError(ErrCode::Value::IllegalGrammar,
+                            FMgr.getLastOffset(), ASTNodeAttr::Instruction);
+      }
+      Handler.IsSwitch = Flag == 0x01U;
+      EXPECTED_TRY(readU32(Handler.TagIndex));
+      if (!Handler.IsSwitch) {
+        EXPECTED_TRY(readU32(Handler.LabelIndex));
+      }
+    }
+    return {};
+  }
+
   case OpCode::Br:
   case OpCode::Br_if:
   case OpCode::Br_on_null:
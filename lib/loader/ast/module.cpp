@@ -5,6 +5,12 @@
 #include "loader/loader.h"
 #include "loader/shared_library.h"
 
+#include "experimental/scope.hpp"
+
+#include <blake3.h>
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -18,6 +24,20 @@ using namespace std::literals;
 namespace WasmEdge {
 namespace Loader {
 
+namespace {
+/// Check the AOT section is compiled from the module bytes before it.
+bool checkModuleHash(Span<const Byte> Module,
+                     const AST::AOTSection &AOTSection) noexcept {
+  std::array<Byte, BLAKE3_OUT_LEN> Hash;
+  blake3_hasher Hasher;
+  blake3_hasher_init(&Hasher);
+  blake3_hasher_update(&Hasher, Module.data(), Module.size());
+  blake3_hasher_finalize(&Hasher, Hash.data(), Hash.size());
+  return std::equal(Hash.begin(), Hash.end(),
+                    AOTSection.getModuleHash().begin());
+}
+} // namespace
+
 // Load binary to construct Module node. See "include/loader/loader.h".
 Expect<void> Loader::loadModule(AST::Module &Mod,
                                 std::optional<uint64_t> Bound) {
@@ -26,6 +46,9 @@ Expect<void> Loader::loadModule(AST::Module &Mod,
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return E;
   };
+  // Allocate the nodes from the arena of the module during loading.
+  NodeArena = Mod.getArena();
+  cxx20::scope_exit ResetArena([this]() noexcept { NodeArena = nullptr; });
 
   // Variables to record the loaded section types.
   HasDataSection = false;
@@ -94,9 +117,24 @@ Expect<void> Loader::loadModule(AST::Module &Mod,
     case 0x09:
       EXPECTED_TRY(loadSection(Mod.getElementSection()).map_error(ReportError));
       break;
-    case 0x0A:
+    case 0x0A: {
+      // In the fused mode, validate the function bodies when decoded in the
+      // interpreter mode, instead of traversing them again in the validator.
+      if (FusedValidator.Begin &&
+          Conf.getRuntimeConfigure().isEnableFusedValidation() &&
+          (Conf.getRuntimeConfigure().isForceInterpreter() ||
+           WASMType == InputType::WASM)) {
+        setTagFunctionType(Mod.getTagSection(), Mod.getImportSection(),
+                           Mod.getTypeSection());
+        EXPECTED_TRY(FusedValidator.Begin(Mod));
+        ValidateBodies = true;
+      }
+      cxx20::scope_exit ResetFused([this]() noexcept {
+        ValidateBodies = false;
+      });
       EXPECTED_TRY(loadSection(Mod.getCodeSection()).map_error(ReportError));
       break;
+    }
     case 0x0B:
       EXPECTED_TRY(loadSection(Mod.getDataSection()).map_error(ReportError));
       break;
@@ -214,7 +252,10 @@ Expect<void> Loader::loadExecutable(AST::Module &Mod,
 Expect<void> Loader::loadUniversalWASM(AST::Module &Mod) {
   if (!Conf.getRuntimeConfigure().isForceInterpreter()) {
     auto Exec = std::make_shared<AOTSection>();
-    if (auto Res = Exec->load(Mod.getAOTSection()); unlikely(!Res)) {
+    if (auto Res =
+            Exec->load(Mod.getAOTSection(),
+                       Conf.getRuntimeConfigure().isEnableHugePageCode());
+        unlikely(!Res)) {
       spdlog::error("    AOT section -- library load failed:{} , use "
                     "interpreter mode instead.",
                     Res.error());
@@ -228,6 +269,8 @@ Expect<void> Loader::loadUniversalWASM(AST::Module &Mod) {
   // Fallback to the interpreter mode case: Re-read the code section.
   WASMType = InputType::WASM;
   FMgr.seek(Mod.getCodeSection().getStartOffset());
+  NodeArena = Mod.getArena();
+  cxx20::scope_exit ResetArena([this]() noexcept { NodeArena = nullptr; });
   return loadSection(Mod.getCodeSection()).map_error([](auto E) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return E;
@@ -242,6 +285,7 @@ Expect<void> Loader::loadModuleAOT(AST::AOTSection &AOTSection) {
     // This loop only overview the custom sections and read the AOT section.
     // For the other general errors, break and handle in the sequentially
     // parsing below.
+    const auto SectionOffset = FMgr.getOffset();
     uint8_t NewSectionId = 0x00;
     if (auto Res = FMgr.readByte()) {
       NewSectionId = *Res;
@@ -278,10 +322,11 @@ Expect<void> Loader::loadModuleAOT(AST::AOTSection &AOTSection) {
 
       if (Name == "wasmedge") {
         // Found the AOT section in universal WASM. Load the AOT code.
-        // Read the content.
-        std::vector<uint8_t> Content;
-        if (auto Res = FMgr.readBytes(ContentSize - ReadSize)) {
-          Content = std::move(*Res);
+        // View the content without copying.
+        const auto ContentOffset = FMgr.getOffset();
+        Span<const Byte> Content;
+        if (auto Res = FMgr.readSpan(ContentSize - ReadSize)) {
+          Content = *Res;
         } else {
           break;
         }
@@ -289,8 +334,24 @@ Expect<void> Loader::loadModuleAOT(AST::AOTSection &AOTSection) {
         // Load the AOT section.
         FileMgr VecMgr;
         AST::AOTSection NewAOTSection;
+        if (auto File = FMgr.getFileMap()) {
+          NewAOTSection.setSourceFile(std::move(File), ContentOffset);
+        }
         VecMgr.setCode(Content);
-        if (auto Res = loadSection(VecMgr, NewAOTSection)) {
+        auto Res = loadSection(VecMgr, NewAOTSection);
+        if (Res && Conf.getRuntimeConfigure().isEnableTrustedAOT() &&
+            !checkModuleHash(
+                FMgr.getData().first(static_cast<size_t>(SectionOffset)),
+                NewAOTSection)) {
+          // Never trust the code compiled from the other module bytes.
+          spdlog::error("    AOT section module hash unmatched."sv);
+          Res = Unexpect(ErrCode::Value::MalformedSection);
+        }
+        if (Res && WASMType == InputType::UniversalWASM &&
+            NewAOTSection.getTargetLevel() < AOTSection.getTargetLevel()) {
+          // Keep the previous AOT section for a higher x86-64 level.
+          spdlog::info("    Skip the AOT section for a lower target level.");
+        } else if (Res) {
           // Also handle the duplicated AOT sections case.
           // If the new AOT section discovered, use the new one.
           WASMType = InputType::UniversalWASM;
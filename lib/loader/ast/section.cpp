@@ -5,6 +5,10 @@
 #include "common/defines.h"
 #include "loader/loader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <tuple>
 #include <utility>
 
@@ -31,10 +35,16 @@ Expect<void> Loader::loadSection(AST::CustomSection &Sec) {
       return logLoadError(ErrCode::Value::UnexpectedEnd, FMgr.getLastOffset(),
                           ASTNodeAttr::Sec_Custom);
     }
-    EXPECTED_TRY(
-        std::vector<uint8_t> Bytes,
-        FMgr.readBytes(Sec.getContentSize() - ReadSize).map_error(ReportError));
-    Sec.getContent().insert(Sec.getContent().end(), Bytes.begin(), Bytes.end());
+    const auto ContentSize = Sec.getContentSize() - ReadSize;
+    if (auto Holder = FMgr.getDataHolder();
+        Holder && Conf.getRuntimeConfigure().isEnableZeroCopyLoad()) {
+      EXPECTED_TRY(auto View,
+                   FMgr.readSpan(ContentSize).map_error(ReportError));
+      Sec.setContent(View, std::move(Holder));
+    } else {
+      EXPECTED_TRY(Sec.getContent(),
+                   FMgr.readBytes(ContentSize).map_error(ReportError));
+    }
     return {};
   });
 }
@@ -167,11 +177,96 @@ Expect<void> Loader::loadSection(AST::ElementSection &Sec) {
 
 // Load vector of code section. See "include/loader/loader.h".
 Expect<void> Loader::loadSection(AST::CodeSection &Sec) {
-  return loadSectionContent(Sec, [this, &Sec]() {
+  // In the lazy loading mode, the function bodies are kept as the ranges in
+  // the input and decoded at first use. Reference the input only in the
+  // zero-copy mode or for a stream, which owns the bytes and has not received
+  // all of them yet, copy it once otherwise.
+  if (Conf.getRuntimeConfigure().isEnableLazyFunctionBody() &&
+      (Conf.getRuntimeConfigure().isForceInterpreter() ||
+       WASMType == InputType::WASM)) {
+    auto Code = FMgr.getData();
+    auto Holder = FMgr.getDataHolder();
+    if (!Holder || (!Conf.getRuntimeConfigure().isEnableZeroCopyLoad() &&
+                    !FMgr.isStreaming())) {
+      auto Copy = std::make_shared<std::vector<Byte>>(Code.begin(), Code.end());
+      Code = *Copy;
+      Holder = std::move(Copy);
+    }
+    LazyCtx = std::make_shared<const LazyContext>(
+        LazyContext{Conf, HasDataSection, Code, std::move(Holder)});
+  }
+  // In the parallel loading mode, the function bodies are skipped in a pass
+  // over their boundaries, and decoded by the workers after.
+  uint32_t ThreadCount = Conf.getRuntimeConfigure().getLoadingThreadCount();
+  if (ThreadCount == 0) {
+    ThreadCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  // The fused validation needs the bodies decoded in order.
+  ParallelLoad = !LazyCtx && !ValidateBodies && ThreadCount > 1 &&
+                 !FMgr.isStreaming() &&
+                 (Conf.getRuntimeConfigure().isForceInterpreter() ||
+                  WASMType == InputType::WASM);
+  auto Res = loadSectionContent(Sec, [this, &Sec]() {
     return loadSectionContentVec(Sec, [this](AST::CodeSegment &CodeSeg) {
       return loadSegment(CodeSeg);
     });
   });
+  LazyCtx.reset();
+  ParallelLoad = false;
+  if (Res && !ParallelBodies.empty()) {
+    Res = loadParallelBodies(ThreadCount);
+  }
+  ParallelBodies.clear();
+  return Res;
+}
+
+// Decode the skipped function bodies. See "include/loader/loader.h".
+Expect<void> Loader::loadParallelBodies(uint32_t ThreadCount) {
+  // Each worker decodes the claimed bodies in the whole input with its own
+  // loader to keep the instruction offsets. After a failure, the workers stop
+  // claiming and the failure of the smallest function index is reported.
+  const auto Code = FMgr.getData();
+  const size_t Count = ParallelBodies.size();
+  std::atomic<size_t> Next = 0;
+  std::atomic<size_t> FailedIdx = Count;
+  std::vector<ErrCode> Errors(Count);
+  std::mutex Mutex;
+  auto Worker = [&]() {
+    Loader Load(Conf);
+    Load.HasDataSection = HasDataSection;
+    Load.NodeArena = NodeArena;
+    Load.ArenaMutex = &Mutex;
+    Load.FMgr.setCode(Code);
+    for (size_t I; (I = Next.fetch_add(1, std::memory_order_relaxed)) < Count &&
+                   I < FailedIdx.load(std::memory_order_relaxed);) {
+      auto &[CodeSeg, Body] = ParallelBodies[I];
+      const auto Begin = static_cast<uint64_t>(Body.data() - Code.data());
+      Load.FMgr.seek(Begin);
+      auto Res = Load.loadExpression(CodeSeg->getExpr(), Begin + Body.size());
+      if (unlikely(!Res)) {
+        Errors[I] = Res.error();
+        size_t Prev = FailedIdx.load(std::memory_order_relaxed);
+        while (I < Prev && !FailedIdx.compare_exchange_weak(
+                               Prev, I, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  };
+  std::vector<std::thread> Workers;
+  const size_t WorkerCount = std::min<size_t>(ThreadCount, Count);
+  Workers.reserve(WorkerCount - 1);
+  for (size_t I = 1; I < WorkerCount; ++I) {
+    Workers.emplace_back(Worker);
+  }
+  Worker();
+  for (auto &W : Workers) {
+    W.join();
+  }
+  if (const size_t I = FailedIdx.load(std::memory_order_relaxed); I < Count) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+    return Unexpect(Errors[I]);
+  }
+  return {};
 }
 
 // Load vector of data section. See "include/loader/loader.h".
@@ -239,6 +334,37 @@ inline constexpr uint8_t HostArchType() noexcept {
 #endif
 }
 
+/// The highest x86-64 micro-architecture level supported by the running CPU.
+/// The CPUs with the checked features of a level have the others as well.
+uint8_t HostTargetLevel() noexcept {
+#if defined(__x86_64__)
+  static const uint8_t Level = []() noexcept -> uint8_t {
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("popcnt") || !__builtin_cpu_supports("sse3") ||
+        !__builtin_cpu_supports("ssse3") || !__builtin_cpu_supports("sse4.1") ||
+        !__builtin_cpu_supports("sse4.2")) {
+      return 1;
+    }
+    if (!__builtin_cpu_supports("avx") || !__builtin_cpu_supports("avx2") ||
+        !__builtin_cpu_supports("bmi") || !__builtin_cpu_supports("bmi2") ||
+        !__builtin_cpu_supports("fma")) {
+      return 2;
+    }
+    if (!__builtin_cpu_supports("avx512f") ||
+        !__builtin_cpu_supports("avx512bw") ||
+        !__builtin_cpu_supports("avx512cd") ||
+        !__builtin_cpu_supports("avx512dq") ||
+        !__builtin_cpu_supports("avx512vl")) {
+      return 3;
+    }
+    return 4;
+  }();
+  return Level;
+#else
+  return 0;
+#endif
+}
+
 } // namespace
 
 // If there is any loader error occurs in the loadSection, then fallback
@@ -280,6 +406,28 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     return Unexpect(ErrCode::Value::MalformedSection);
   }
 
+  EXPECTED_TRY(auto TargetLevel, VecMgr.readByte().map_error([](auto E) {
+    spdlog::error(E);
+    spdlog::error("    AOT target level read error:{}"sv, E);
+    return E;
+  }));
+  Sec.setTargetLevel(TargetLevel);
+  if (Sec.getTargetLevel() > HostTargetLevel()) {
+    // Not an error in a universal wasm file with the code of several levels.
+    spdlog::info("    AOT target level x86-64-v{} unsupported by the CPU."sv,
+                 Sec.getTargetLevel());
+    return Unexpect(ErrCode::Value::MalformedSection);
+  }
+
+  EXPECTED_TRY(auto ModuleHash,
+               VecMgr.readSpan(Sec.getModuleHash().size())
+                   .map_error([](auto E) {
+                     spdlog::error(E);
+                     spdlog::error("    AOT module hash read error:{}"sv, E);
+                     return E;
+                   }));
+  std::copy(ModuleHash.begin(), ModuleHash.end(), Sec.getModuleHash().begin());
+
   EXPECTED_TRY(auto VersionAddress, VecMgr.readU64().map_error([](auto E) {
     spdlog::error(E);
     spdlog::error("    AOT version address read error:{}"sv, E);
@@ -347,8 +495,10 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
     return Unexpect(ErrCode::Value::IntegerTooLong);
   }
   Sec.getSections().resize(SectionsSize);
+  Sec.getFileOffsets().assign(SectionsSize, 0);
 
-  for (auto &Section : Sec.getSections()) {
+  for (size_t I = 0; I < Sec.getSections().size(); ++I) {
+    auto &Section = Sec.getSections()[I];
     EXPECTED_TRY(std::get<0>(Section), VecMgr.readByte().map_error([](auto E) {
       spdlog::error(E);
       spdlog::error("    AOT section type read error:{}"sv, E);
@@ -374,11 +524,23 @@ Expect<void> Loader::loadSection(FileMgr &VecMgr, AST::AOTSection &Sec) {
       spdlog::error("    AOT section data size is too large"sv);
       return Unexpect(ErrCode::Value::IntegerTooLong);
     }
+    if (std::get<0>(Section) == 0) {
+      // Padding to align the next section content in the file.
+      VecMgr.seek(VecMgr.getOffset() + Size);
+      continue;
+    }
     if (std::get<2>(Section) < Size) {
       spdlog::error(ErrCode::Value::IntegerTooLong);
       spdlog::error("    AOT section data size is larger then section size"sv);
       return Unexpect(ErrCode::Value::IntegerTooLong);
     }
+    if (std::get<0>(Section) == 1 && std::get<2>(Section) == Size &&
+        Sec.getSourceFile()) {
+      // Leave the text content in the file to map it directly.
+      Sec.getFileOffsets()[I] = Sec.getSourceOffset() + VecMgr.getOffset();
+      VecMgr.seek(VecMgr.getOffset() + Size);
+      continue;
+    }
     EXPECTED_TRY(auto Data, VecMgr.readBytes(Size).map_error([](auto E) {
       spdlog::error(E);
       spdlog::error("    AOT section data read error:{}"sv, E);
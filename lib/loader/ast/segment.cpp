@@ -243,6 +243,13 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
     CodeSeg.setSegSize(S);
   }));
   auto ExprSizeBound = FMgr.getOffset() + CodeSeg.getSegSize();
+  if (TrustedAOT) {
+    // For the trusted AOT compiled code, skip the locals and the function
+    // body, which were validated by the compiler.
+    FMgr.seek(ExprSizeBound);
+    CodeSeg.setValidated();
+    return {};
+  }
 
   // Read the vector of local variable counts and types.
   EXPECTED_TRY(uint32_t VecCnt, loadVecCnt().map_error(ReportError));
@@ -268,6 +275,43 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
     // For the AOT mode and not force interpreter in configure, skip the
     // function body.
     FMgr.seek(ExprSizeBound);
+  } else if (NextCachedBody < CachedBodies.size()) {
+    // For the hit of the validated code cache, skip the function body and
+    // take the restored one.
+    if (unlikely(FMgr.getOffset() > ExprSizeBound)) {
+      return logLoadError(ErrCode::Value::SectionSizeMismatch,
+                          FMgr.getOffset(), ASTNodeAttr::Seg_Code);
+    }
+    FMgr.seek(ExprSizeBound);
+    CodeSeg.getExpr().getInstrs() = std::move(CachedBodies[NextCachedBody++]);
+    CodeSeg.setValidated();
+  } else if (LazyCtx) {
+    // For the lazy loading mode, keep the range of the function body.
+    const uint64_t Begin = FMgr.getOffset();
+    if (unlikely(Begin > ExprSizeBound)) {
+      return logLoadError(ErrCode::Value::SectionSizeMismatch, Begin,
+                          ASTNodeAttr::Seg_Code);
+    }
+    const auto Size = static_cast<size_t>(ExprSizeBound - Begin);
+    EXPECTED_TRY(FMgr.readSpan(Size).map_error(ReportError));
+    auto Body = std::make_shared<AST::LazyFunctionBody>(
+        LazyCtx->Code.subspan(static_cast<size_t>(Begin), Size), LazyCtx);
+    Body->setDecoder([Ctx = LazyCtx](Span<const Byte> Code,
+                                     AST::Expression &Expr) {
+      return loadLazyExpression(*Ctx, Code, Expr);
+    });
+    CodeSeg.setLazyBody(std::move(Body));
+  } else if (ParallelLoad) {
+    // For the parallel loading mode, keep the range of the function body to
+    // be decoded by the workers after the code section.
+    const uint64_t Begin = FMgr.getOffset();
+    if (unlikely(Begin > ExprSizeBound)) {
+      return logLoadError(ErrCode::Value::SectionSizeMismatch, Begin,
+                          ASTNodeAttr::Seg_Code);
+    }
+    const auto Size = static_cast<size_t>(ExprSizeBound - Begin);
+    EXPECTED_TRY(auto Body, FMgr.readSpan(Size).map_error(ReportError));
+    ParallelBodies.emplace_back(&CodeSeg, Body);
   } else {
     // Read function body with expected expression size.
     EXPECTED_TRY(
@@ -275,6 +319,10 @@ Expect<void> Loader::loadSegment(AST::CodeSegment &CodeSeg) {
           spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
           return E;
         }));
+    // In the fused mode, validate the body while it is still hot in cache.
+    if (ValidateBodies) {
+      EXPECTED_TRY(FusedValidator.Body(CodeSeg));
+    }
   }
 
   return {};
@@ -332,9 +380,14 @@ Expect<void> Loader::loadSegment(AST::DataSegment &DataSeg) {
   {
     // Read initialization data.
     EXPECTED_TRY(uint32_t VecCnt, loadVecCnt().map_error(ReportError));
-    EXPECTED_TRY(FMgr.readBytes(VecCnt).map_error(ReportError).map([&](auto V) {
-      DataSeg.getData() = std::move(V);
-    }));
+    if (auto Holder = FMgr.getDataHolder();
+        Holder && Conf.getRuntimeConfigure().isEnableZeroCopyLoad()) {
+      EXPECTED_TRY(auto View, FMgr.readSpan(VecCnt).map_error(ReportError));
+      DataSeg.setData(View, std::move(Holder));
+    } else {
+      EXPECTED_TRY(FMgr.readBytes(VecCnt).map_error(ReportError).map(
+          [&](auto V) { DataSeg.getData() = std::move(V); }));
+    }
     break;
   }
   default:
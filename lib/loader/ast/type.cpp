@@ -3,6 +3,8 @@
 
 #include "loader/loader.h"
 
+#include <algorithm>
+
 namespace WasmEdge {
 namespace Loader {
 
@@ -65,6 +67,14 @@ Expect<ValType> Loader::loadHeapType(TypeCode TC, ASTNodeAttr From) {
                                FMgr.getLastOffset(), From);
       }
       return ValType(TC, HTCode);
+    case TypeCode::NullContRef:
+    case TypeCode::ContRef:
+      if (!Conf.hasProposal(Proposal::StackSwitching)) {
+        return logNeedProposal(ErrCode::Value::MalformedValType,
+                               Proposal::StackSwitching, FMgr.getLastOffset(),
+                               From);
+      }
+      return ValType(TC, HTCode);
     default:
       return logLoadError(FailCode, FMgr.getLastOffset(), From);
     }
@@ -214,6 +224,18 @@ Expect<void> Loader::loadCompositeType(AST::CompositeType &CType) {
     CType.setFunctionType(std::move(FuncType));
     return {};
   }
+  case TypeCode::Cont: {
+    if (!Conf.hasProposal(Proposal::StackSwitching)) {
+      return logNeedProposal(ErrCode::Value::IntegerTooLong,
+                             Proposal::StackSwitching, FMgr.getLastOffset(),
+                             ASTNodeAttr::Type_Rec);
+    }
+    EXPECTED_TRY(uint32_t Idx, FMgr.readU32().map_error([this](auto E) {
+      return logLoadError(E, FMgr.getLastOffset(), ASTNodeAttr::Type_Rec);
+    }));
+    CType.setContType(Idx);
+    return {};
+  }
   default:
     return logLoadError(ErrCode::Value::IntegerTooLong, FMgr.getLastOffset(),
                         ASTNodeAttr::Type_Rec);
@@ -240,10 +262,23 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
   case AST::Limit::LimitType::HasMinMax:
     Lim.setType(static_cast<AST::Limit::LimitType>(B));
     break;
+  case AST::Limit::LimitType::I64SharedNoMax:
+  case AST::Limit::LimitType::I64Shared:
+    if (Conf.hasProposal(Proposal::Memory64) &&
+        !Conf.hasProposal(Proposal::Threads)) {
+      return logLoadError(ErrCode::Value::MalformedLimitFlags,
+                          FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
+    }
+    [[fallthrough]];
+  case AST::Limit::LimitType::I64HasMin:
+  case AST::Limit::LimitType::I64HasMinMax:
+    if (Conf.hasProposal(Proposal::Memory64)) {
+      Lim.setType(static_cast<AST::Limit::LimitType>(B));
+      break;
+    }
+    [[fallthrough]];
   default:
     if (Conf.hasProposal(Proposal::Memory64)) {
-      // TODO: MEMORY64 - fully support implementation.
-      // Currently add this for passing binary parsing in spec tests.
       return logLoadError(ErrCode::Value::MalformedLimitFlags,
                           FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
     } else {
@@ -259,20 +294,24 @@ Expect<void> Loader::loadLimit(AST::Limit &Lim) {
   }
 
   // Read the min and max number.
-  if (Conf.hasProposal(Proposal::Memory64)) {
-    // TODO: MEMORY64 - fully support implementation.
-    // Currently add this for passing binary parsing in spec tests.
+  if (Lim.is64()) {
+    // The page counts beyond 32 bits cannot be allocated on the host, so they
+    // are saturated and fail in the instantiation or the growing.
+    auto Saturate = [](uint64_t Val) {
+      return static_cast<uint32_t>(
+          std::min(Val, static_cast<uint64_t>(UINT32_MAX)));
+    };
     EXPECTED_TRY(uint64_t MinVal, FMgr.readU64().map_error([this](auto E) {
       return logLoadError(E, FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
     }));
-    Lim.setMin(static_cast<uint32_t>(MinVal));
+    Lim.setMin(Saturate(MinVal));
     if (Lim.hasMax()) {
       EXPECTED_TRY(uint64_t MaxVal, FMgr.readU64().map_error([this](auto E) {
         return logLoadError(E, FMgr.getLastOffset(), ASTNodeAttr::Type_Limit);
       }));
-      Lim.setMax(static_cast<uint32_t>(MaxVal));
+      Lim.setMax(Saturate(MaxVal));
     } else {
-      Lim.setMax(static_cast<uint32_t>(MinVal));
+      Lim.setMax(Saturate(MinVal));
     }
   } else {
     EXPECTED_TRY(uint32_t MinVal, FMgr.readU32().map_error([this](auto E) {
@@ -363,10 +402,16 @@ Expect<void> Loader::loadType(AST::TableType &TabType) {
   TabType.setRefType(Type);
 
   // Read limit.
-  return loadLimit(TabType.getLimit()).map_error([](auto E) {
+  EXPECTED_TRY(loadLimit(TabType.getLimit()).map_error([](auto E) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Type_Table));
     return E;
-  });
+  }));
+  // The 64-bit index type of tables is not supported yet.
+  if (unlikely(TabType.getLimit().is64())) {
+    return logLoadError(ErrCode::Value::MalformedLimitFlags,
+                        FMgr.getLastOffset(), ASTNodeAttr::Type_Table);
+  }
+  return {};
 }
 
 // Load binary to construct GlobalType node. See "include/loader/loader.h".
@@ -0,0 +1,358 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "loader/loader.h"
+
+#include "common/spdlog.h"
+#include "common/version.h"
+#include "system/mmap.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Loader {
+
+namespace {
+
+// The side tables are stored in the host layout.
+static_assert(std::is_trivially_copyable_v<ValType>);
+static_assert(std::is_trivially_copyable_v<BlockType>);
+static_assert(std::is_trivially_copyable_v<AST::Instruction::JumpDescriptor>);
+static_assert(
+    std::is_trivially_copyable_v<AST::Instruction::BrCastDescriptor>);
+static_assert(static_cast<uint8_t>(Proposal::Max) <= 64);
+
+/// Format version of the code cache files.
+static inline constexpr const uint32_t kCodeCacheVersion = 2;
+static inline constexpr const std::array<Byte, 4> kCodeCacheMagic = {
+    0x00, 'w', 'v', 'c'};
+
+/// Writer of the values in the host byte order.
+class CacheWriter {
+public:
+  template <typename T> void write(const T &V) {
+    const auto *Ptr = reinterpret_cast<const Byte *>(&V);
+    Buffer.insert(Buffer.end(), Ptr, Ptr + sizeof(T));
+  }
+  void writeBytes(Span<const Byte> Bytes) {
+    Buffer.insert(Buffer.end(), Bytes.begin(), Bytes.end());
+  }
+  std::vector<Byte> &getBuffer() noexcept { return Buffer; }
+
+private:
+  std::vector<Byte> Buffer;
+};
+
+/// Reader of the values in the host byte order, which fails at the end of
+/// the data.
+class CacheReader {
+public:
+  explicit CacheReader(Span<const Byte> D) noexcept : Data(D) {}
+  template <typename T> bool read(T &V) noexcept {
+    if (getRemainSize() < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&V, Data.data() + Pos, sizeof(T));
+    Pos += sizeof(T);
+    return true;
+  }
+  bool readBytes(size_t Size, Span<const Byte> &Bytes) noexcept {
+    if (getRemainSize() < Size) {
+      return false;
+    }
+    Bytes = Data.subspan(Pos, Size);
+    Pos += Size;
+    return true;
+  }
+  size_t getRemainSize() const noexcept { return Data.size() - Pos; }
+
+private:
+  Span<const Byte> Data;
+  size_t Pos = 0;
+};
+
+/// Header of the code cache files, which identifies the runtime and the
+/// configurations changing the validated bodies.
+std::vector<Byte> makeHeader(const Configure &Conf) {
+  CacheWriter Writer;
+  Writer.writeBytes(kCodeCacheMagic);
+  Writer.write(kCodeCacheVersion);
+  Writer.write(static_cast<uint32_t>(kVersionString.size()));
+  Writer.writeBytes(
+      Span<const Byte>(reinterpret_cast<const Byte *>(kVersionString.data()),
+                       kVersionString.size()));
+  uint64_t Proposals = 0;
+  for (uint8_t I = 0; I < static_cast<uint8_t>(Proposal::Max); ++I) {
+    if (Conf.hasProposal(static_cast<Proposal>(I))) {
+      Proposals |= UINT64_C(1) << I;
+    }
+  }
+  Writer.write(Proposals);
+  Writer.write(static_cast<uint8_t>(
+      Conf.getRuntimeConfigure().isEnableSuperInstructions()));
+  Writer.write(static_cast<uint32_t>(sizeof(AST::Instruction)));
+  return std::move(Writer.getBuffer());
+}
+
+void writeInstr(CacheWriter &Writer, const AST::Instruction &Instr) {
+  Writer.write(static_cast<uint16_t>(Instr.getOpCode()));
+  Writer.write(Instr.getSuperInstr());
+  Writer.write(Instr.getOffset());
+  switch (Instr.getOpCode()) {
+  case OpCode::Br_table:
+    Writer.write(static_cast<uint32_t>(Instr.getLabelList().size()));
+    for (const auto &Label : Instr.getLabelList()) {
+      Writer.write(Label);
+    }
+    break;
+  case OpCode::Select_t:
+    Writer.write(static_cast<uint32_t>(Instr.getValTypeList().size()));
+    for (const auto &Type : Instr.getValTypeList()) {
+      Writer.write(Type);
+    }
+    break;
+  case OpCode::Br_on_cast:
+  case OpCode::Br_on_cast_fail:
+    Writer.write(Instr.getBrCast());
+    break;
+  case OpCode::Try_table: {
+    const auto &Try = Instr.getTryCatch();
+    Writer.write(Try.ResType);
+    Writer.write(Try.StackHeight);
+    Writer.write(Try.TryOffset);
+    Writer.write(Try.JumpEnd);
+    Writer.write(static_cast<uint32_t>(Try.Catch.size()));
+    for (const auto &Catch : Try.Catch) {
+      Writer.write(static_cast<uint8_t>((Catch.IsRef ? 0x01U : 0x00U) |
+                                        (Catch.IsAll ? 0x02U : 0x00U)));
+      Writer.write(Catch.TagIndex);
+      Writer.write(Catch.LabelIndex);
+      Writer.write(Catch.Jump);
+    }
+    break;
+  }
+  case OpCode::Resume:
+  case OpCode::Resume_throw: {
+    const auto &Desc = Instr.getResume();
+    Writer.write(Desc.ContTypeIndex);
+    Writer.write(Desc.TagIndex);
+    Writer.write(Instr.getTryOffset());
+    Writer.write(static_cast<uint32_t>(Desc.Handlers.size()));
+    for (const auto &Handler : Desc.Handlers) {
+      Writer.write(static_cast<uint8_t>(Handler.IsSwitch ? 0x01U : 0x00U));
+      Writer.write(Handler.TagIndex);
+      Writer.write(Handler.LabelIndex);
+      Writer.write(Handler.ContTypeIndex);
+      Writer.write(Handler.Jump);
+    }
+    break;
+  }
+  default:
+    Writer.writeBytes(Instr.getRawContent());
+    break;
+  }
+}
+
+bool readInstr(CacheReader &Reader, AST::InstrVec &Instrs) {
+  uint16_t Code;
+  AST::Instruction::SuperInstr Super;
+  uint32_t Offset;
+  if (!Reader.read(Code) || !Reader.read(Super) || !Reader.read(Offset)) {
+    return false;
+  }
+  auto &Instr = Instrs.emplace_back(static_cast<OpCode>(Code), Offset);
+  Instr.setSuperInstr(Super);
+  // Check the sizes of the side tables before allocating them.
+  auto ReadSize = [&Reader](uint32_t &Size, size_t ElemSize) {
+    return Reader.read(Size) && Size <= Reader.getRemainSize() / ElemSize;
+  };
+  uint32_t Size;
+  switch (Instr.getOpCode()) {
+  case OpCode::Br_table:
+    if (!ReadSize(Size, sizeof(AST::Instruction::JumpDescriptor))) {
+      return false;
+    }
+    Instr.setLabelListSize(Size);
+    for (auto &Label : Instr.getLabelList()) {
+      Reader.read(Label);
+    }
+    return true;
+  case OpCode::Select_t:
+    if (!ReadSize(Size, sizeof(ValType))) {
+      return false;
+    }
+    Instr.setValTypeListSize(Size);
+    for (auto &Type : Instr.getValTypeList()) {
+      Reader.read(Type);
+    }
+    return true;
+  case OpCode::Br_on_cast:
+  case OpCode::Br_on_cast_fail:
+    Instr.setBrCast(0);
+    return Reader.read(Instr.getBrCast());
+  case OpCode::Try_table: {
+    Instr.setTryCatch();
+    auto &Try = Instr.getTryCatch();
+    if (!Reader.read(Try.ResType) || !Reader.read(Try.StackHeight) ||
+        !Reader.read(Try.TryOffset) || !Reader.read(Try.JumpEnd) ||
+        !ReadSize(Size, 1)) {
+      return false;
+    }
+    Try.Catch.resize(Size);
+    for (auto &Catch : Try.Catch) {
+      uint8_t Flag;
+      if (!Reader.read(Flag) || !Reader.read(Catch.TagIndex) ||
+          !Reader.read(Catch.LabelIndex) || !Reader.read(Catch.Jump)) {
+        return false;
+      }
+      Catch.IsRef = (Flag & 0x01U) ? true : false;
+      Catch.IsAll = (Flag & 0x02U) ? true : false;
+    }
+    return true;
+  }
+  case OpCode::Resume:
+  case OpCode::Resume_throw: {
+    Instr.setResume();
+    auto &Desc = Instr.getResume();
+    if (!Reader.read(Desc.ContTypeIndex) || !Reader.read(Desc.TagIndex) ||
+        !Reader.read(Instr.getTryOffset()) || !ReadSize(Size, 1)) {
+      return false;
+    }
+    Desc.Handlers.resize(Size);
+    for (auto &Handler : Desc.Handlers) {
+      uint8_t Flag;
+      if (!Reader.read(Flag) || !Reader.read(Handler.TagIndex) ||
+          !Reader.read(Handler.LabelIndex) ||
+          !Reader.read(Handler.ContTypeIndex) || !Reader.read(Handler.Jump)) {
+        return false;
+      }
+      Handler.IsSwitch = (Flag & 0x01U) ? true : false;
+    }
+    return true;
+  }
+  default: {
+    Span<const Byte> Raw;
+    if (!Reader.readBytes(Instr.getRawContent().size(), Raw)) {
+      return false;
+    }
+    Instr.setRawContent(Raw);
+    return true;
+  }
+  }
+}
+
+} // namespace
+
+// Load the validated function bodies. See "include/loader/loader.h".
+bool Loader::loadCodeCache(const std::filesystem::path &Path,
+                           Arena *BodyArena) {
+  std::error_code Error;
+  const auto Size = std::filesystem::file_size(Path, Error);
+  if (Error || Size == 0 || !MMap::supported()) {
+    return false;
+  }
+  MMap Map(Path);
+  if (!Map.address()) {
+    return false;
+  }
+  CacheReader Reader(
+      Span<const Byte>(reinterpret_cast<const Byte *>(Map.address()),
+                       static_cast<size_t>(Size)));
+
+  const auto Header = makeHeader(Conf);
+  Span<const Byte> FileHeader;
+  uint32_t Count;
+  if (!Reader.readBytes(Header.size(), FileHeader) ||
+      !std::equal(Header.begin(), Header.end(), FileHeader.begin()) ||
+      !Reader.read(Count)) {
+    return false;
+  }
+  std::vector<AST::InstrVec> Bodies;
+  Bodies.reserve(std::min<size_t>(Count, Reader.getRemainSize()));
+  for (uint32_t I = 0; I < Count; ++I) {
+    uint32_t InstrCount;
+    if (!Reader.read(InstrCount) || InstrCount > Reader.getRemainSize()) {
+      return false;
+    }
+    auto &Instrs = Bodies.emplace_back(
+        ArenaAllocator<AST::Instruction>(BodyArena));
+    Instrs.reserve(InstrCount);
+    for (uint32_t J = 0; J < InstrCount; ++J) {
+      if (!readInstr(Reader, Instrs)) {
+        return false;
+      }
+    }
+  }
+  if (Reader.getRemainSize() != 0) {
+    return false;
+  }
+  CachedBodies = std::move(Bodies);
+  NextCachedBody = 0;
+  return true;
+}
+
+// Save the validated function bodies. See "include/loader/loader.h".
+Expect<void> Loader::saveCodeCache(const AST::Module &Mod) {
+  const auto &Path = Mod.getCodeCachePath();
+  if (Path.empty()) {
+    return {};
+  }
+  CacheWriter Writer;
+  Writer.writeBytes(makeHeader(Conf));
+  const auto &Codes = Mod.getCodeSection().getContent();
+  Writer.write(static_cast<uint32_t>(Codes.size()));
+  for (const auto &CodeSeg : Codes) {
+    // The deferred bodies are not validated yet, so the module is not cached
+    // until they are materialized.
+    if (const auto &Body = CodeSeg.getLazyBody();
+        Body && !Body->isMaterialized()) {
+      return {};
+    }
+    EXPECTED_TRY(auto Instrs, CodeSeg.getBodyInstrs());
+    Writer.write(static_cast<uint32_t>(Instrs.size()));
+    for (const auto &Instr : Instrs) {
+      writeInstr(Writer, Instr);
+    }
+  }
+
+  // Write into a temporary file and rename it, so that the concurrent loads
+  // never see a partial cache file.
+  std::error_code Error;
+  std::filesystem::create_directories(Path.parent_path(), Error);
+  auto TempPath = Path;
+  TempPath += "."s + std::to_string(std::random_device()()) + ".tmp"s;
+  {
+    std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+    const auto &Buffer = Writer.getBuffer();
+    File.write(reinterpret_cast<const char *>(Buffer.data()),
+               static_cast<std::streamsize>(Buffer.size()));
+    if (!File.good()) {
+      File.close();
+      std::filesystem::remove(TempPath, Error);
+      spdlog::error(ErrCode::Value::IllegalPath);
+      spdlog::error("    Failed to write the code cache {}."sv,
+                    TempPath.u8string());
+      return Unexpect(ErrCode::Value::IllegalPath);
+    }
+  }
+  std::filesystem::rename(TempPath, Path, Error);
+  if (Error) {
+    std::filesystem::remove(TempPath, Error);
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error("    Failed to write the code cache {}."sv, Path.u8string());
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  return {};
+}
+
+} // namespace Loader
+} // namespace WasmEdge
@@ -3,13 +3,151 @@
 
 #include "loader/filemgr.h"
 
+#include "common/spdlog.h"
+
 #include <algorithm>
+#include <cstring>
 #include <iterator>
+#include <utility>
+
+#ifdef WASMEDGE_USE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std::literals;
 
 // Error logging of file manager need to be handled in caller.
 
 namespace WasmEdge {
 
+namespace {
+
+/// Decode the LEB128 integer at the beginning of the little-endian word.
+/// Returns the count of its bytes and the gathered 7-bit groups, or 0 bytes if
+/// the integer does not end in the word.
+std::pair<uint32_t, uint64_t> decodeLEBWord(uint64_t Word) noexcept {
+  const uint64_t Ends = ~Word & UINT64_C(0x8080808080808080);
+  if (Ends == 0) {
+    return {0, 0};
+  }
+  // Keep the bytes up to the first one without the continuation bit.
+  const uint64_t Mask = Ends ^ (Ends - 1);
+  const auto Len = static_cast<uint32_t>(
+      ((Mask & UINT64_C(0x0101010101010101)) * UINT64_C(0x0101010101010101)) >>
+      56);
+  // Gather the 7-bit groups into 14, 28, and then 56 bits.
+  Word &= Mask & UINT64_C(0x7F7F7F7F7F7F7F7F);
+  Word = (Word & UINT64_C(0x007F007F007F007F)) |
+         ((Word & UINT64_C(0x7F007F007F007F00)) >> 1);
+  Word = (Word & UINT64_C(0x00003FFF00003FFF)) |
+         ((Word & UINT64_C(0x3FFF00003FFF0000)) >> 2);
+  Word = (Word & UINT64_C(0x000000000FFFFFFF)) |
+         ((Word & UINT64_C(0x0FFFFFFF00000000)) >> 4);
+  return {Len, Word};
+}
+
+/// Check the data starts with the magic number of a zstd frame.
+bool isZstdFrame(const Byte *Data [[maybe_unused]],
+                 uint64_t Size [[maybe_unused]]) noexcept {
+#ifdef WASMEDGE_USE_ZSTD
+  const Byte ZstdMagic[] = {0x28, 0xB5, 0x2F, 0xFD};
+  return Size >= 4 && std::equal(ZstdMagic, ZstdMagic + 4, Data);
+#else
+  return false;
+#endif
+}
+
+#ifdef WASMEDGE_USE_ZSTD
+/// Decompress the zstd frames in In[0 : InSize) into the sink by chunks. The
+/// bytes of the source stream are waited for if set. Returns false if the
+/// data is malformed, the source ends early, or the sink refuses a chunk.
+template <typename SinkT>
+bool decompress(const Byte *In, uint64_t InSize, CodeStream *InStream,
+                SinkT &&Sink) noexcept {
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> Ctx(ZSTD_createDCtx(),
+                                                           ZSTD_freeDCtx);
+  if (!Ctx) {
+    return false;
+  }
+  std::vector<Byte> Chunk(ZSTD_DStreamOutSize());
+  uint64_t Consumed = 0;
+  uint64_t Avail = InStream ? 0 : InSize;
+  // Result of the last call, which is 0 at the end of a frame.
+  size_t Hint = 1;
+  bool Flush = false;
+  while (true) {
+    if (Consumed == Avail && !Flush) {
+      if (Avail == InSize) {
+        break;
+      }
+      // Wait for the next bytes of the source stream.
+      Avail = InStream->wait(Avail + 1);
+      if (Avail == Consumed) {
+        break;
+      }
+    }
+    ZSTD_inBuffer InBuf = {In + Consumed, static_cast<size_t>(Avail - Consumed),
+                           0};
+    ZSTD_outBuffer OutBuf = {Chunk.data(), Chunk.size(), 0};
+    Hint = ZSTD_decompressStream(Ctx.get(), &OutBuf, &InBuf);
+    if (ZSTD_isError(Hint)) {
+      spdlog::error("zstd decompression failed: {}"sv,
+                    ZSTD_getErrorName(Hint));
+      return false;
+    }
+    Consumed += InBuf.pos;
+    // The output may be pending while the output buffer is full.
+    Flush = OutBuf.pos == OutBuf.size;
+    if (OutBuf.pos > 0 && !Sink(Span<const Byte>(Chunk.data(), OutBuf.pos))) {
+      return false;
+    }
+  }
+  return Consumed == InSize && Hint == 0;
+}
+#endif
+
+/// Check the 8 bytes are all ASCII characters.
+bool isASCIIWord(const char *Ptr) noexcept {
+  uint64_t Word;
+  std::memcpy(&Word, Ptr, sizeof(Word));
+  return (Word & UINT64_C(0x8080808080808080)) == 0;
+}
+
+} // namespace
+
+// Append a chunk to the stream. See "include/loader/filemgr.h".
+bool CodeStream::append(Span<const Byte> Chunk) noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    if (Closed || Chunk.size() > Buffer->size() - Filled) {
+      return false;
+    }
+    std::copy(Chunk.begin(), Chunk.end(),
+              Buffer->begin() + static_cast<std::ptrdiff_t>(Filled));
+    Filled += Chunk.size();
+  }
+  Cond.notify_all();
+  return true;
+}
+
+// Close the stream. See "include/loader/filemgr.h".
+void CodeStream::close() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Closed = true;
+  }
+  Cond.notify_all();
+}
+
+// Wait for the bytes of the stream. See "include/loader/filemgr.h".
+uint64_t CodeStream::wait(uint64_t End) noexcept {
+  std::unique_lock Lock(Mutex);
+  Cond.wait(Lock, [&]() noexcept {
+    return Closed || Filled >= std::min<uint64_t>(End, Buffer->size());
+  });
+  return Filled;
+}
+
 // Set path to file manager. See "include/loader/filemgr.h".
 Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
   reset();
@@ -21,9 +159,14 @@ Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
       Status = ErrCode::Value::IllegalPath;
       return Unexpect(Status);
     }
-    FileMap.emplace(FilePath);
+    FileMap = std::make_shared<MMap>(FilePath);
     if (auto *Pointer = FileMap->address(); likely(Pointer)) {
       Data = reinterpret_cast<const Byte *>(Pointer);
+      if (isZstdFrame(Data, Size)) {
+        auto InHolder = std::move(FileMap);
+        return setCompressed(Data, Size, nullptr, std::move(InHolder));
+      }
+      MappedPath = FilePath;
       Status = ErrCode::Value::Success;
     } else {
       // File size is 0, mmap failed.
@@ -40,6 +183,9 @@ Expect<void> FileMgr::setPath(const std::filesystem::path &FilePath) {
 // Set code data. See "include/loader/filemgr.h".
 Expect<void> FileMgr::setCode(Span<const Byte> CodeData) {
   reset();
+  if (isZstdFrame(CodeData.data(), CodeData.size())) {
+    return setCompressed(CodeData.data(), CodeData.size(), nullptr, nullptr);
+  }
   Data = CodeData.data();
   Size = CodeData.size();
   Status = ErrCode::Value::Success;
@@ -54,13 +200,112 @@ Expect<void> FileMgr::setCode(std::vector<Byte> CodeData) {
   // which is reported by GCC 14 with `maybe-uninitialized`
   assuming(!DataHolder);
 
-  DataHolder.emplace(std::move(CodeData));
+  DataHolder = std::make_shared<std::vector<Byte>>(std::move(CodeData));
+  if (isZstdFrame(DataHolder->data(), DataHolder->size())) {
+    const Byte *In = DataHolder->data();
+    const uint64_t InSize = DataHolder->size();
+    return setCompressed(In, InSize, nullptr, std::move(DataHolder));
+  }
+  Data = DataHolder->data();
+  Size = DataHolder->size();
+  Status = ErrCode::Value::Success;
+  return {};
+}
+
+// Set code data from stream. See "include/loader/filemgr.h".
+Expect<void> FileMgr::setCode(std::shared_ptr<CodeStream> CodeData) {
+  reset();
+  assuming(!DataHolder);
+
+  DataHolder = CodeData->Buffer;
   Data = DataHolder->data();
   Size = DataHolder->size();
+  Stream = std::move(CodeData);
   Status = ErrCode::Value::Success;
   return {};
 }
 
+// Set the decompressed data. See "include/loader/filemgr.h".
+Expect<void> FileMgr::setCompressed(const Byte *In [[maybe_unused]],
+                                    uint64_t InSize [[maybe_unused]],
+                                    std::shared_ptr<CodeStream> InStream
+                                    [[maybe_unused]],
+                                    std::shared_ptr<const void> InHolder
+                                    [[maybe_unused]]) {
+#ifdef WASMEDGE_USE_ZSTD
+  // The decompressed size is in the frame header if the compressor knew it.
+  // Only the single frame data is streamed, and the frames after the first
+  // one of a stream end it early.
+  uint64_t OutSize = ZSTD_CONTENTSIZE_UNKNOWN;
+  if (InStream) {
+    // Maximum frame header size, which is not in the stable API.
+    constexpr uint64_t kMaxFrameHeaderSize = 18;
+    OutSize = ZSTD_getFrameContentSize(
+        In, static_cast<size_t>(InStream->wait(kMaxFrameHeaderSize)));
+  } else if (ZSTD_findFrameCompressedSize(In, static_cast<size_t>(InSize)) ==
+             InSize) {
+    OutSize = ZSTD_getFrameContentSize(In, static_cast<size_t>(InSize));
+  }
+  if (OutSize == ZSTD_CONTENTSIZE_ERROR ||
+      OutSize == ZSTD_CONTENTSIZE_UNKNOWN || OutSize > SIZE_MAX) {
+    // Decompress all bytes first without the size.
+    std::vector<Byte> Code;
+    const bool Done = decompress(In, InSize, InStream.get(),
+                                 [&Code](Span<const Byte> Chunk) noexcept {
+                                   Code.insert(Code.end(), Chunk.begin(),
+                                               Chunk.end());
+                                   return true;
+                                 });
+    reset();
+    if (!Done) {
+      // Will get 'UnexpectedEnd' error while the first reading.
+      Size = 0;
+      return {};
+    }
+    DataHolder = std::make_shared<std::vector<Byte>>(std::move(Code));
+    Data = DataHolder->data();
+    Size = DataHolder->size();
+    Status = ErrCode::Value::Success;
+    Compressed = true;
+    return {};
+  }
+
+  // Decompress by the worker thread into the stream read by the loader. The
+  // stream ends early if the decompression fails or is cancelled.
+  auto Out = std::make_shared<CodeStream>(static_cast<size_t>(OutSize));
+  Decompressor = std::thread([In, InSize, InStream, InHolder, Out]() noexcept {
+    decompress(In, InSize, InStream.get(), [&Out](Span<const Byte> Chunk) {
+      return Out->append(Chunk);
+    });
+    Out->close();
+  });
+  DataHolder = Out->Buffer;
+  Data = DataHolder->data();
+  Size = DataHolder->size();
+  Stream = std::move(Out);
+  Arrived = 0;
+  Source = std::move(InStream);
+  Status = ErrCode::Value::Success;
+  Compressed = true;
+  return {};
+#else
+  assumingUnreachable();
+#endif
+}
+
+// Stop the decompression. See "include/loader/filemgr.h".
+void FileMgr::stopDecompression() noexcept {
+  if (!Decompressor.joinable()) {
+    return;
+  }
+  Stream->close();
+  if (Source) {
+    Source->close();
+  }
+  Decompressor.join();
+  Source.reset();
+}
+
 // Read one byte. See "include/loader/filemgr.h".
 Expect<Byte> FileMgr::readByte() {
   if (unlikely(Status != ErrCode::Value::Success)) {
@@ -83,6 +328,20 @@ Expect<std::vector<Byte>> FileMgr::readBytes(size_t SizeToRead) {
   return Buf;
 }
 
+// Read number of bytes as a view. See "include/loader/filemgr.h".
+Expect<Span<const Byte>> FileMgr::readSpan(size_t SizeToRead) {
+  if (unlikely(Status != ErrCode::Value::Success)) {
+    return Unexpect(Status);
+  }
+  // Set the flag to the start offset.
+  LastPos = Pos;
+  // Check if exceed the data boundary.
+  EXPECTED_TRY(testRead(SizeToRead));
+  Span<const Byte> View(Data + Pos, SizeToRead);
+  Pos += SizeToRead;
+  return View;
+}
+
 // Decode and read an unsigned int. See "include/loader/filemgr.h".
 Expect<uint32_t> FileMgr::readU32() {
   if (unlikely(Status != ErrCode::Value::Success)) {
@@ -91,6 +350,17 @@ Expect<uint32_t> FileMgr::readU32() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Decode in one word if the bytes are ready. The integers too long or too
+  // large fall back to the byte-wise decoding for the errors.
+  if (uint64_t Word; likely(peekWord(Word))) {
+    const auto [Len, Payload] = decodeLEBWord(Word);
+    if (likely(Len != 0 && Len < 5) ||
+        (Len == 5 && ((Word >> 32) & UINT64_C(0x70)) == 0)) {
+      Pos += Len;
+      return static_cast<uint32_t>(Payload);
+    }
+  }
+
   // Read and decode U32.
   uint32_t Result = 0;
   uint32_t Offset = 0;
@@ -120,6 +390,15 @@ Expect<uint64_t> FileMgr::readU64() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Decode in one word if the bytes are ready. The integers longer than 8
+  // bytes fall back to the byte-wise decoding.
+  if (uint64_t Word; likely(peekWord(Word))) {
+    if (const auto [Len, Payload] = decodeLEBWord(Word); likely(Len != 0)) {
+      Pos += Len;
+      return Payload;
+    }
+  }
+
   // Read and decode U64.
   uint64_t Result = 0;
   uint64_t Offset = 0;
@@ -154,6 +433,18 @@ template <typename RetType, size_t N> Expect<RetType> FileMgr::readSN() {
   // Set the flag to the start offset.
   LastPos = Pos;
 
+  // Decode in one word if the bytes are ready and the payload bits fit in N
+  // bits, which cannot be too large. Sign-extend from the highest payload bit.
+  if (uint64_t Word; likely(peekWord(Word))) {
+    const auto [Len, Payload] = decodeLEBWord(Word);
+    if (likely(Len != 0 && Len * 7 <= N)) {
+      const uint32_t Shift = 64 - Len * 7;
+      Pos += Len;
+      return static_cast<RetType>(static_cast<int64_t>(Payload << Shift) >>
+                                  Shift);
+    }
+  }
+
   // Read and decode S_N.
   RetType Result = 0;
   size_t Offset = 0;
@@ -291,6 +582,13 @@ Expect<std::string> FileMgr::readName() {
   // UTF-8 validation.
   bool Valid = true;
   for (uint32_t I = 0; I < Str.size() && Valid; ++I) {
+    // Skip the words of ASCII characters at once.
+    while (I + 8 <= Str.size() && isASCIIWord(Str.data() + I)) {
+      I += 8;
+    }
+    if (I >= Str.size()) {
+      break;
+    }
     char C = Str.data()[I];
     uint32_t N = 0;
     if ((C & '\x80') == 0) {
@@ -360,7 +658,20 @@ Expect<Byte> FileMgr::peekByte() {
 
 // Get the file header type. See "include/loader/filemgr.h".
 FileMgr::FileHeader FileMgr::getHeaderType() {
-  if (Size >= 4) {
+  // Only the arrived bytes of a stream are known.
+  if (Stream && Arrived < 4) {
+    Arrived = Stream->wait(4);
+    // The compressed stream is detected after the first bytes arrived, and
+    // the header is read from the decompressed stream instead.
+    if (!Compressed && isZstdFrame(Data, Arrived)) {
+      if (!setCompressed(Data, Size, Stream, DataHolder)) {
+        return FileMgr::FileHeader::Unknown;
+      }
+      return getHeaderType();
+    }
+  }
+  const uint64_t Known = Stream ? std::min(Arrived, Size) : Size;
+  if (Known >= 4) {
     Byte WASMMagic[] = {0x00, 0x61, 0x73, 0x6D};
     Byte ELFMagic[] = {0x7F, 0x45, 0x4C, 0x46};
     Byte MAC32agic[] = {0xCE, 0xFA, 0xED, 0xFE};
@@ -375,7 +686,7 @@ FileMgr::FileHeader FileMgr::getHeaderType() {
       return FileMgr::FileHeader::MachO_64;
     }
   }
-  if (Size >= 2) {
+  if (Known >= 2) {
     Byte DLLMagic[] = {0x4D, 0x5A};
     if (std::equal(DLLMagic, DLLMagic + 2, Data)) {
       return FileMgr::FileHeader::DLL;
@@ -424,7 +735,31 @@ Expect<void> FileMgr::testRead(uint64_t Read) {
     Status = ErrCode::Value::UnexpectedEnd;
     return Unexpect(Status);
   }
+  // Wait for the bytes of the stream, which may end early.
+  if (unlikely(Stream && Pos + Read > Arrived)) {
+    Arrived = Stream->wait(Pos + Read);
+    if (unlikely(Pos + Read > Arrived)) {
+      Pos = Arrived;
+      LastPos = Pos;
+      Status = ErrCode::Value::UnexpectedEnd;
+      return Unexpect(Status);
+    }
+  }
   return {};
 }
 
+bool FileMgr::peekWord(uint64_t &Word) const noexcept {
+  const uint64_t End = Stream ? Arrived : Size;
+  if (Pos > End || End - Pos < 8) {
+    return false;
+  }
+  // Assembled byte by byte for any host byte order, which is a single load on
+  // the little-endian hosts.
+  Word = 0;
+  for (uint32_t I = 0; I < 8; ++I) {
+    Word |= static_cast<uint64_t>(Data[Pos + I]) << (I * 8);
+  }
+  return true;
+}
+
 } // namespace WasmEdge
@@ -4,6 +4,9 @@
 #include "loader/loader.h"
 
 #include "aot/version.h"
+#include "common/metrics.h"
+#include "common/trace.h"
+#include "experimental/scope.hpp"
 
 #include <algorithm>
 #include <cstddef>
@@ -68,6 +71,7 @@ Expect<std::variant<std::unique_ptr<AST::Component::Component>,
                     std::unique_ptr<AST::Module>>>
 Loader::parseWasmUnit(const std::filesystem::path &FilePath) {
   std::lock_guard Lock(Mutex);
+  Trace::Scope TraceScope("loader"sv, "parse"sv, FilePath.u8string());
 
   // Set path and check the header.
   EXPECTED_TRY(FMgr.setPath(FilePath).map_error([&FilePath](auto E) {
@@ -88,11 +92,24 @@ Loader::parseWasmUnit(const std::filesystem::path &FilePath) {
   case FileMgr::FileHeader::DLL:
   case FileMgr::FileHeader::MachO_32:
   case FileMgr::FileHeader::MachO_64: {
+    if (FMgr.isCompressed()) {
+      FMgr.reset();
+      spdlog::error(ErrCode::Value::MalformedMagic);
+      spdlog::error(
+          "    The compressed AOT compiled WASM shared library is not "
+          "supported. Please decompress it or use the universal WASM "
+          "binary."sv);
+      spdlog::error(ErrInfo::InfoFile(FilePath));
+      return Unexpect(ErrCode::Value::MalformedMagic);
+    }
     // AOT compiled shared-library-WASM cases. Use ldmgr to load the module.
     WASMType = InputType::SharedLibrary;
     FMgr.reset();
     std::shared_ptr<SharedLibrary> Library = std::make_shared<SharedLibrary>();
-    EXPECTED_TRY(Library->load(FilePath).map_error(ReportError));
+    {
+      Trace::Scope LibraryScope("aot"sv, "load shared library"sv);
+      EXPECTED_TRY(Library->load(FilePath).map_error(ReportError));
+    }
     EXPECTED_TRY(auto Version, Library->getVersion().map_error(ReportError));
     if (Version != AOT::kBinaryVersion) {
       spdlog::error(ErrInfo::InfoMismatch(AOT::kBinaryVersion, Version));
@@ -110,6 +127,7 @@ Loader::parseWasmUnit(const std::filesystem::path &FilePath) {
       if (!Conf.getRuntimeConfigure().isForceInterpreter()) {
         // If the configure is set to force interpreter mode, not to load the
         // AOT related data.
+        Trace::Scope ExecutableScope("aot"sv, "load executable"sv);
         EXPECTED_TRY(loadExecutable(**Ptr, Library).map_error(ReportError));
       }
     } else {
@@ -143,6 +161,7 @@ Expect<std::variant<std::unique_ptr<AST::Component::Component>,
                     std::unique_ptr<AST::Module>>>
 Loader::parseWasmUnit(Span<const uint8_t> Code) {
   std::lock_guard Lock(Mutex);
+  Trace::Scope TraceScope("loader"sv, "parse"sv);
   EXPECTED_TRY(FMgr.setCode(Code));
   switch (FMgr.getHeaderType()) {
   // Filter out the Windows .dll, MacOS .dylib, or Linux .so AOT compiled
@@ -163,7 +182,45 @@ Loader::parseWasmUnit(Span<const uint8_t> Code) {
   }
   // For malformed header checking, handle in the module loading.
   WASMType = InputType::WASM;
-  return loadUnit();
+  auto Res = loadUnit();
+  // Stop decompressing the code, which is not kept after the parsing.
+  if (FMgr.isCompressed()) {
+    FMgr.reset();
+  }
+  return Res;
+}
+
+// Parse module or component from stream. See "include/loader/loader.h".
+Expect<std::variant<std::unique_ptr<AST::Component::Component>,
+                    std::unique_ptr<AST::Module>>>
+Loader::parseWasmUnit(std::shared_ptr<CodeStream> Code) {
+  std::lock_guard Lock(Mutex);
+  Trace::Scope TraceScope("loader"sv, "parse stream"sv);
+  EXPECTED_TRY(FMgr.setCode(std::move(Code)));
+  switch (FMgr.getHeaderType()) {
+  // Filter out the Windows .dll, MacOS .dylib, or Linux .so AOT compiled
+  // shared-library-WASM.
+  case FileMgr::FileHeader::ELF:
+  case FileMgr::FileHeader::DLL:
+  case FileMgr::FileHeader::MachO_32:
+  case FileMgr::FileHeader::MachO_64:
+    spdlog::error("Might an invalid wasm file"sv);
+    spdlog::error(ErrCode::Value::MalformedMagic);
+    spdlog::error(
+        "    The AOT compiled WASM shared library is not supported for loading "
+        "from stream. Please use the universal WASM binary or pure WASM, or "
+        "load the AOT compiled WASM shared library from file."sv);
+    FMgr.reset();
+    return Unexpect(ErrCode::Value::MalformedMagic);
+  default:
+    break;
+  }
+  // For malformed header checking, handle in the module loading.
+  WASMType = InputType::WASM;
+  auto Res = loadUnit();
+  // Release the stream, which the module keeps only for the lazy bodies.
+  FMgr.reset();
+  return Res;
 }
 
 // Parse module from file path. See "include/loader/loader.h".
@@ -186,6 +243,16 @@ Loader::parseModule(Span<const uint8_t> Code) {
   return Unexpect(ErrCode::Value::MalformedVersion);
 }
 
+// Parse module from stream. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::parseModule(std::shared_ptr<CodeStream> Code) {
+  EXPECTED_TRY(auto ComponentOrModule, parseWasmUnit(std::move(Code)));
+  if (auto M = std::get_if<std::unique_ptr<AST::Module>>(&ComponentOrModule)) {
+    return std::move(*M);
+  }
+  return Unexpect(ErrCode::Value::MalformedVersion);
+}
+
 // Load module or component unit. See "include/loader/loader.h".
 Expect<std::variant<std::unique_ptr<AST::Component::Component>,
                     std::unique_ptr<AST::Module>>>
@@ -196,17 +263,61 @@ Loader::loadUnit() {
     auto Mod = std::make_unique<AST::Module>();
     Mod->getMagic() = WasmMagic;
     Mod->getVersion() = Ver;
-    if (!Conf.getRuntimeConfigure().isForceInterpreter()) {
+    // The AOT sections are usually at the end. For a stream, find them after
+    // decoding the module instead of waiting for all bytes first.
+    const bool ScanAOTFirst =
+        !Conf.getRuntimeConfigure().isForceInterpreter() &&
+        !FMgr.isStreaming();
+    TrustedAOT = false;
+    if (ScanAOTFirst) {
+      Trace::Scope AOTScope("aot"sv, "scan sections"sv);
       EXPECTED_TRY(loadModuleAOT(Mod->getAOTSection()));
+      // The shared library is native code loaded by the user, and the AOT
+      // section of the universal WASM is checked against the module hash.
+      TrustedAOT = Conf.getRuntimeConfigure().isEnableTrustedAOT() &&
+                   WASMType != InputType::WASM;
+    }
+    cxx20::scope_exit ResetTrusted([this]() noexcept { TrustedAOT = false; });
+    // Restore the validated function bodies for the interpreter from the code
+    // cache. On a miss, the path is kept for saving the bodies after the
+    // validation.
+    cxx20::scope_exit ResetCache([this]() noexcept {
+      CachedBodies.clear();
+      NextCachedBody = 0;
+    });
+    if (CodeCacheKey && Conf.getRuntimeConfigure().isEnableCodeCache() &&
+        !FMgr.isStreaming() &&
+        (Conf.getRuntimeConfigure().isForceInterpreter() ||
+         WASMType == InputType::WASM)) {
+      Trace::Scope CacheScope("loader"sv, "code cache lookup"sv);
+      if (auto Path = CodeCacheKey(FMgr.getData(), FMgr.getFilePath());
+          Path) {
+        const bool Hit = loadCodeCache(*Path, Mod->getArena());
+        if (!Hit) {
+          Mod->setCodeCachePath(std::move(*Path));
+        }
+        if (Metrics::isEnabled()) {
+          Metrics::recordCacheLookup("validated"sv, Hit ? 1 : 0, Hit ? 0 : 1);
+        }
+      }
     }
     // Seek to the position after the binary header.
     FMgr.seek(8);
-    EXPECTED_TRY(loadModule(*Mod));
+    {
+      Trace::Scope DecodeScope("loader"sv, "decode"sv);
+      EXPECTED_TRY(loadModule(*Mod));
+    }
+    if (!Conf.getRuntimeConfigure().isForceInterpreter() && !ScanAOTFirst) {
+      Trace::Scope AOTScope("aot"sv, "scan sections"sv);
+      FMgr.seek(8);
+      EXPECTED_TRY(loadModuleAOT(Mod->getAOTSection()));
+    }
 
     // Load library from AOT Section for the universal WASM case.
     // For the force interpreter mode, skip this.
     if (!Conf.getRuntimeConfigure().isForceInterpreter() &&
         WASMType == InputType::UniversalWASM) {
+      Trace::Scope AOTScope("aot"sv, "load universal wasm"sv);
       EXPECTED_TRY(loadUniversalWASM(*Mod));
     }
     return Mod;
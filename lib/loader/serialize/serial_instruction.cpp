@@ -18,7 +18,11 @@ Serializer::serializeInstruction(const AST::Instruction &Instr,
     } else {
       serializeU32(Instr.getMemoryAlign(), OutVec);
     }
-    serializeU32(Instr.getMemoryOffset(), OutVec);
+    if (Conf.hasProposal(Proposal::Memory64)) {
+      serializeU64(Instr.getMemoryOffset(), OutVec);
+    } else {
+      serializeU32(static_cast<uint32_t>(Instr.getMemoryOffset()), OutVec);
+    }
     return {};
   };
 
@@ -139,6 +143,36 @@ Serializer::serializeInstruction(const AST::Instruction &Instr,
     serializeU32(Instr.getTargetIndex(), OutVec);
     return {};
 
+  // Stack switching instructions.
+  case OpCode::Cont__new:
+  case OpCode::Suspend:
+    serializeU32(Instr.getTargetIndex(), OutVec);
+    return {};
+
+  case OpCode::Cont__bind:
+  case OpCode::Switch:
+    serializeU32(Instr.getTargetIndex(), OutVec);
+    serializeU32(Instr.getSourceIndex(), OutVec);
+    return {};
+
+  case OpCode::Resume:
+  case OpCode::Resume_throw: {
+    const auto &Desc = Instr.getResume();
+    serializeU32(Desc.ContTypeIndex, OutVec);
+    if (Instr.getOpCode() == OpCode::Resume_throw) {
+      serializeU32(Desc.TagIndex, OutVec);
+    }
+    serializeU32(static_cast<uint32_t>(Desc.Handlers.size()), OutVec);
+    for (const auto &Handler : Desc.Handlers) {
+      OutVec.push_back(Handler.IsSwitch ? 0x01U : 0x00U);
+      serializeU32(Handler.TagIndex, OutVec);
+      if (!Handler.IsSwitch) {
+        serializeU32(Handler.LabelIndex, OutVec);
+      }
+    }
+    return {};
+  }
+
   case OpCode::Br:
   case OpCode::Br_if:
   case OpCode::Br_on_null:
@@ -145,7 +145,13 @@ Serializer::serializeSegment(const AST::CodeSegment &Seg,
     EXPECTED_TRY(
         serializeValType(Locals.second, ASTNodeAttr::Seg_Code, OutVec));
   }
-  EXPECTED_TRY(serializeExpression(Seg.getExpr(), OutVec).map_error([](auto E) {
+  const AST::Expression *Expr = &Seg.getExpr();
+  if (const auto &Body = Seg.getLazyBody()) {
+    // Materialize the deferred body in the lazy loading mode.
+    EXPECTED_TRY(Body->materialize());
+    Expr = &Body->getExpr();
+  }
+  EXPECTED_TRY(serializeExpression(*Expr, OutVec).map_error([](auto E) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
     return E;
   }));
@@ -50,6 +50,14 @@ Serializer::serializeHeapType(const ValType &Type, ASTNodeAttr From,
     }
     OutVec.push_back(static_cast<uint8_t>(Code));
     return {};
+  case TypeCode::NullContRef:
+  case TypeCode::ContRef:
+    if (unlikely(!Conf.hasProposal(Proposal::StackSwitching))) {
+      return logNeedProposal(ErrCode::Value::MalformedRefType,
+                             Proposal::StackSwitching, From);
+    }
+    OutVec.push_back(static_cast<uint8_t>(Code));
+    return {};
   default:
     if (likely(Conf.hasProposal(Proposal::ReferenceTypes))) {
       return logSerializeError(ErrCode::Value::MalformedRefType, From);
@@ -129,15 +137,22 @@ Serializer::serializeLimit(const AST::Limit &Lim,
   //       |0x01 + min:u32 + max:u32
   //       |0x02 + min:u32 (shared, invalid)
   //       |0x03 + min:u32 + max:u32 (shared)
+  //       |0x04 ~ 0x07 + min:u64 (+ max:u64) (64-bit)
   uint8_t Flag = 0;
+  if (Lim.is64()) {
+    if (!Conf.hasProposal(Proposal::Memory64)) {
+      return logNeedProposal(ErrCode::Value::MalformedLimitFlags,
+                             Proposal::Memory64, ASTNodeAttr::Type_Limit);
+    }
+    Flag |= 0x04U;
+  }
   if (Lim.isShared()) {
     Flag |= 0x02U;
   }
   if (Lim.hasMax()) {
     Flag |= 0x01U;
   }
-  if (static_cast<AST::Limit::LimitType>(Flag) >=
-      AST::Limit::LimitType::SharedNoMax) {
+  if (Lim.isShared()) {
     if (Conf.hasProposal(Proposal::Threads)) {
       if (unlikely(!Lim.hasMax())) {
         return logSerializeError(ErrCode::Value::SharedMemoryNoMax,
@@ -149,9 +164,16 @@ Serializer::serializeLimit(const AST::Limit &Lim,
     }
   }
   OutVec.push_back(Flag);
-  serializeU32(Lim.getMin(), OutVec);
-  if (Lim.hasMax()) {
-    serializeU32(Lim.getMax(), OutVec);
+  if (Lim.is64()) {
+    serializeU64(Lim.getMin(), OutVec);
+    if (Lim.hasMax()) {
+      serializeU64(Lim.getMax(), OutVec);
+    }
+  } else {
+    serializeU32(Lim.getMin(), OutVec);
+    if (Lim.hasMax()) {
+      serializeU32(Lim.getMax(), OutVec);
+    }
   }
   return {};
 }
@@ -177,7 +199,7 @@ Serializer::serializeType(const AST::SubType &SType,
       serializeU32(Idx, OutVec);
     }
   }
-  // Composite type: array | struct | func
+  // Composite type: array | struct | func | cont
   TypeCode CTypeCode = SType.getCompositeType().getContentTypeCode();
   OutVec.push_back(static_cast<uint8_t>(CTypeCode));
   switch (CTypeCode) {
@@ -205,6 +227,14 @@ Serializer::serializeType(const AST::SubType &SType,
       EXPECTED_TRY(serializeType(FType, OutVec));
     }
     break;
+  case TypeCode::Cont:
+    // Continuation type: typeidx
+    if (!Conf.hasProposal(Proposal::StackSwitching)) {
+      return logNeedProposal(ErrCode::Value::MalformedValType,
+                             Proposal::StackSwitching, ASTNodeAttr::Type_Rec);
+    }
+    serializeU32(SType.getCompositeType().getContTypeIndex(), OutVec);
+    break;
   default:
     return logSerializeError(ErrCode::Value::MalformedValType,
                              ASTNodeAttr::Type_Rec);
@@ -3,12 +3,18 @@
 
 #include "plugin/plugin.h"
 #include "common/errcode.h"
+#include "common/spdlog.h"
+#include "common/trace.h"
 #include "common/version.h"
+#include "system/path.h"
 #include "wasmedge/wasmedge.h"
 
 // BUILTIN-PLUGIN: Headers for built-in plug-ins.
 #include "plugin/wasi_logging/module.h"
 
+#include <fstream>
+#include <random>
+#include <sstream>
 #include <type_traits>
 #include <variant>
 
@@ -169,10 +175,10 @@ public:
         break;
       }
     }
-
-    Result = Plugin::registerPlugin(&Descriptor);
   }
-  bool result() const noexcept { return Result; }
+  const Plugin::PluginDescriptor &descriptor() const noexcept {
+    return Descriptor;
+  }
 
 private:
   static Runtime::Instance::ModuleInstance *
@@ -216,8 +222,6 @@ private:
   static std::unordered_map<const PluginModule::ModuleDescriptor *,
                             const WasmEdge_ModuleDescriptor *>
       DescriptionLookup;
-
-  bool Result = false;
 };
 std::unordered_map<const PluginModule::ModuleDescriptor *,
                    const WasmEdge_ModuleDescriptor *>
@@ -225,6 +229,63 @@ std::unordered_map<const PluginModule::ModuleDescriptor *,
 
 std::vector<std::unique_ptr<CAPIPluginRegister>> CAPIPluginRegisters;
 
+using namespace std::literals;
+
+/// Format version of the plugin manifests.
+static inline constexpr const uint32_t kManifestVersion = 1;
+
+/// Path of the manifest of the plugin library in the cache.
+std::filesystem::path getManifestPath(const std::filesystem::path &Path) {
+  const auto Home = WasmEdge::Path::home();
+  if (Home.empty()) {
+    return {};
+  }
+  std::error_code Error;
+  auto Canonical = std::filesystem::weakly_canonical(Path, Error);
+  if (Error) {
+    Canonical = Path;
+  }
+  const auto Str = Canonical.u8string();
+  const auto Hash = Hash::Hash::rapidHash(cxx20::as_bytes(
+      Span<const char>(reinterpret_cast<const char *>(Str.data()),
+                       Str.size())));
+  return Home / "cache"sv / "plugin"sv /
+         std::filesystem::u8path(fmt::format("{:016x}"sv, Hash));
+}
+
+/// Stamp of the plugin library, which invalidates the manifest when the
+/// library is replaced.
+std::string getLibraryStamp(const std::filesystem::path &Path) {
+  std::error_code Error;
+  const auto Size = std::filesystem::file_size(Path, Error);
+  if (Error) {
+    return {};
+  }
+  const auto Time = std::filesystem::last_write_time(Path, Error);
+  if (Error) {
+    return {};
+  }
+  return fmt::format("{} {} {}"sv, kPluginCurrentAPIVersion, Size,
+                     static_cast<int64_t>(Time.time_since_epoch().count()));
+}
+
+/// Names of the options added by the plugin.
+std::vector<std::string>
+getOptionNames(const Plugin::PluginDescriptor *Desc) noexcept {
+  if (!Desc->AddOptions) {
+    return {};
+  }
+  PO::ArgumentParser Parser;
+  PO::SubCommand SubCommand;
+  Parser.begin_subcommand(SubCommand, "plugin"sv);
+  Desc->AddOptions(Desc, Parser);
+  std::vector<std::string> Names;
+  for (const auto Name : Parser.option_names()) {
+    Names.emplace_back(Name);
+  }
+  return Names;
+}
+
 } // namespace
 
 std::mutex WasmEdge::Plugin::Plugin::Mutex;
@@ -377,11 +438,36 @@ bool Plugin::registerPlugin(const PluginDescriptor *Desc) noexcept {
   return true;
 }
 
-void Plugin::addPluginOptions(PO::ArgumentParser &Parser) noexcept {
+void Plugin::addPluginOptions(PO::ArgumentParser &Parser,
+                              Span<const char *const> Args) noexcept {
+  // The names of the options and the help option in the arguments.
+  std::vector<std::string_view> Names;
+  for (const char *Arg : Args) {
+    std::string_view Name(Arg);
+    if (Name.size() < 2 || Name[0] != '-') {
+      continue;
+    }
+    Name.remove_prefix(Name[1] == '-' ? 2 : 1);
+    Names.push_back(Name.substr(0, Name.find('=')));
+  }
+  const bool IsHelp =
+      std::find_if(Names.begin(), Names.end(), [](std::string_view Name) {
+        return Name == "h"sv || Name == "help"sv;
+      }) != Names.end();
+
   for (const auto &Plugin : PluginRegistry) {
-    if (Plugin.Desc->AddOptions) {
-      Plugin.Desc->AddOptions(Plugin.Desc, Parser);
+    if (Plugin.Info && !Args.empty() && !IsHelp) {
+      const auto &Options = Plugin.Info->Options;
+      if (std::find_first_of(Options.begin(), Options.end(), Names.begin(),
+                             Names.end()) == Options.end()) {
+        // The deferred plugin is loaded later if its contents are used.
+        continue;
+      }
+    }
+    if (Plugin.Info && Plugin.Info->Options.empty()) {
+      continue;
     }
+    Plugin.registerOptions(Parser);
   }
 }
 
@@ -396,41 +482,188 @@ Span<const Plugin> Plugin::plugins() noexcept { return PluginRegistry; }
 
 bool Plugin::loadFile(const std::filesystem::path &Path) noexcept {
   std::unique_lock Lock(Mutex);
-  bool Result = false;
-  auto Lib = std::make_shared<Loader::SharedLibrary>();
-  if (auto Res = Lib->load(Path); unlikely(!Res)) {
+  Trace::Scope TraceScope("plugin"sv, "load"sv, Path.u8string());
+  // Register the plugin from the manifest without loading the library.
+  if (auto Info = readManifest(Path)) {
+    if (PluginNameLookup.find(Info->Name) != PluginNameLookup.end()) {
+      spdlog::debug("Plugin: {} has already loaded."sv, Info->Name);
+      return false;
+    }
+    Plugin Deferred;
+    Deferred.Path = Path;
+    Deferred.Info = std::move(Info);
+    const auto Index = PluginRegistry.size();
+    PluginRegistry.push_back(std::move(Deferred));
+    PluginNameLookup.emplace(PluginRegistry.back().Info->Name, Index);
+    return true;
+  }
+
+  std::shared_ptr<Loader::SharedLibrary> Lib;
+  const auto *Desc = loadLibrary(Path, Lib);
+  if (!Desc || !registerPlugin(Desc)) {
     return false;
   }
+  auto &Plugin = PluginRegistry.back();
+  Plugin.Path = Path;
+  Plugin.Lib = std::move(Lib);
+  writeManifest(Plugin);
+  return true;
+}
+
+const Plugin::PluginDescriptor *
+Plugin::loadLibrary(const std::filesystem::path &Path,
+                    std::shared_ptr<Loader::SharedLibrary> &Lib) noexcept {
+  Lib = std::make_shared<Loader::SharedLibrary>();
+  if (auto Res = Lib->load(Path); unlikely(!Res)) {
+    return nullptr;
+  }
 
   if (auto GetDescriptor =
           Lib->get<Plugin::PluginDescriptor const *()>("GetDescriptor")) {
-    Result = Plugin::registerPlugin(GetDescriptor());
+    return GetDescriptor();
   }
 
-  if (!Result) {
-    // Check C interface
-    if (auto GetDescriptor = Lib->get<decltype(WasmEdge_Plugin_GetDescriptor)>(
-            "WasmEdge_Plugin_GetDescriptor");
-        unlikely(!GetDescriptor)) {
-      return false;
-    } else if (const auto *Descriptor = GetDescriptor();
-               unlikely(!Descriptor)) {
-      return false;
+  // Check C interface
+  if (auto GetDescriptor = Lib->get<decltype(WasmEdge_Plugin_GetDescriptor)>(
+          "WasmEdge_Plugin_GetDescriptor");
+      unlikely(!GetDescriptor)) {
+    return nullptr;
+  } else if (const auto *Descriptor = GetDescriptor(); unlikely(!Descriptor)) {
+    return nullptr;
+  } else {
+    return &CAPIPluginRegisters
+                .emplace_back(std::make_unique<CAPIPluginRegister>(Descriptor))
+                ->descriptor();
+  }
+}
+
+std::unique_ptr<Plugin::Manifest>
+Plugin::readManifest(const std::filesystem::path &Path) noexcept {
+  const auto ManifestPath = getManifestPath(Path);
+  if (ManifestPath.empty()) {
+    return {};
+  }
+  std::ifstream File(ManifestPath);
+  std::string Line;
+  // The header records the format, the library path, and the stamp.
+  if (!std::getline(File, Line) ||
+      Line != fmt::format("wasmedge-plugin-manifest {}"sv, kManifestVersion) ||
+      !std::getline(File, Line) || Line != Path.u8string() ||
+      !std::getline(File, Line) || Line != getLibraryStamp(Path)) {
+    return {};
+  }
+  auto Info = std::make_unique<Manifest>();
+  bool HasVersion = false;
+  while (std::getline(File, Line)) {
+    const auto Sep = Line.find(' ');
+    if (Sep == std::string::npos) {
+      return {};
+    }
+    const std::string_view Key = std::string_view(Line).substr(0, Sep);
+    std::string Value = Line.substr(Sep + 1);
+    if (Key == "name"sv) {
+      Info->Name = std::move(Value);
+    } else if (Key == "version"sv) {
+      std::istringstream Stream(Value);
+      HasVersion = static_cast<bool>(
+          Stream >> Info->Version.Major >> Info->Version.Minor >>
+          Info->Version.Patch >> Info->Version.Build);
+    } else if (Key == "option"sv) {
+      Info->Options.push_back(std::move(Value));
+    } else if (Key == "module"sv) {
+      Info->Modules.push_back(std::move(Value));
+    } else if (Key == "component"sv) {
+      Info->Components.push_back(std::move(Value));
     } else {
-      Result =
-          CAPIPluginRegisters
-              .emplace_back(std::make_unique<CAPIPluginRegister>(Descriptor))
-              ->result();
+      return {};
     }
   }
+  if (Info->Name.empty() || !HasVersion) {
+    return {};
+  }
+  return Info;
+}
 
-  if (!Result) {
-    return false;
+void Plugin::writeManifest(const Plugin &P) noexcept {
+  const auto ManifestPath = getManifestPath(P.Path);
+  const auto Stamp = getLibraryStamp(P.Path);
+  if (ManifestPath.empty() || Stamp.empty()) {
+    return;
+  }
+  std::string Content =
+      fmt::format("wasmedge-plugin-manifest {}\n{}\n{}\nname {}\n"
+                  "version {} {} {} {}\n"sv,
+                  kManifestVersion, P.Path.u8string(), Stamp, P.Desc->Name,
+                  P.Desc->Version.Major, P.Desc->Version.Minor,
+                  P.Desc->Version.Patch, P.Desc->Version.Build);
+  for (const auto &Name : getOptionNames(P.Desc)) {
+    Content += fmt::format("option {}\n"sv, Name);
+  }
+  for (const auto &Module : P.ModuleRegistry) {
+    Content += fmt::format("module {}\n"sv, Module.name());
+  }
+  for (const auto &Component : P.ComponentRegistry) {
+    Content += fmt::format("component {}\n"sv, Component.name());
   }
 
-  auto &Plugin = PluginRegistry.back();
-  Plugin.Path = Path;
-  Plugin.Lib = std::move(Lib);
+  // Write into a temporary file and rename it, so that the concurrent loads
+  // never see a partial manifest.
+  std::error_code Error;
+  std::filesystem::create_directories(ManifestPath.parent_path(), Error);
+  auto TempPath = ManifestPath;
+  TempPath += "."s + std::to_string(std::random_device()()) + ".tmp"s;
+  {
+    std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+    File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+    if (!File.good()) {
+      File.close();
+      std::filesystem::remove(TempPath, Error);
+      spdlog::debug("Plugin: failed to write the manifest of {}."sv,
+                    P.Path.u8string());
+      return;
+    }
+  }
+  std::filesystem::rename(TempPath, ManifestPath, Error);
+  if (Error) {
+    std::filesystem::remove(TempPath, Error);
+  }
+}
+
+bool Plugin::isLoaded() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Desc != nullptr;
+}
+
+bool Plugin::hasModule(std::string_view Name) const noexcept {
+  if (Info) {
+    return std::find(Info->Modules.begin(), Info->Modules.end(), Name) !=
+           Info->Modules.end();
+  }
+  return ModuleNameLookup.find(Name) != ModuleNameLookup.end();
+}
+
+bool Plugin::ensureLoaded() const noexcept {
+  if (!Info) {
+    return Desc != nullptr;
+  }
+  std::unique_lock Lock(Mutex);
+  if (Desc || LoadFailed) {
+    return Desc != nullptr;
+  }
+  // The plugins are stored in the non-const registry.
+  auto &Self = const_cast<Plugin &>(*this);
+  Trace::Scope TraceScope("plugin"sv, "load deferred"sv, Info->Name);
+  std::shared_ptr<Loader::SharedLibrary> Library;
+  const auto *D = loadLibrary(Path, Library);
+  if (!D || D->APIVersion != CurrentAPIVersion || Info->Name != D->Name) {
+    spdlog::error("Plugin: failed to load the deferred plugin {} from {}."sv,
+                  Info->Name, Path.u8string());
+    Self.LoadFailed = true;
+    return false;
+  }
+  spdlog::debug("Plugin: load the deferred plugin {}."sv, Info->Name);
+  Self.Lib = std::move(Library);
+  Self.setDescriptor(D);
   return true;
 }
 
@@ -440,7 +673,10 @@ void Plugin::registerBuiltInPlugins() noexcept {
   registerPlugin(&Host::WasiLoggingModule::PluginDescriptor);
 }
 
-Plugin::Plugin(const PluginDescriptor *D) noexcept : Desc(D) {
+Plugin::Plugin(const PluginDescriptor *D) noexcept { setDescriptor(D); }
+
+void Plugin::setDescriptor(const PluginDescriptor *D) noexcept {
+  Desc = D;
   for (const auto &ModuleDesc : Span<const PluginModule::ModuleDescriptor>(
            D->ModuleDescriptions, D->ModuleCount)) {
     const auto Index = ModuleRegistry.size();
@@ -458,6 +694,7 @@ Plugin::Plugin(const PluginDescriptor *D) noexcept : Desc(D) {
 
 WASMEDGE_EXPORT const PluginModule *
 Plugin::findModule(std::string_view Name) const noexcept {
+  ensureLoaded();
   if (auto Iter = ModuleNameLookup.find(Name); Iter != ModuleNameLookup.end()) {
     return std::addressof(ModuleRegistry[Iter->second]);
   }
@@ -466,6 +703,7 @@ Plugin::findModule(std::string_view Name) const noexcept {
 
 WASMEDGE_EXPORT const PluginComponent *
 Plugin::findComponent(std::string_view Name) const noexcept {
+  ensureLoaded();
   if (auto Iter = ComponentNameLookup.find(Name);
       Iter != ComponentNameLookup.end()) {
     return std::addressof(ComponentRegistry[Iter->second]);
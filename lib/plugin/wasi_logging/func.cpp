@@ -5,6 +5,7 @@
 // the new plugin architecture ready in 0.15.0.
 
 #include "plugin/wasi_logging/func.h"
+#include "plugin/wasi_logging/queue.h"
 
 #include <string_view>
 
@@ -57,25 +58,26 @@ Expect<void> Log::body(const Runtime::CallingFrame &Frame, uint32_t Level,
     Logger = Env.FileLogger;
   }
 
-  // Print Message by Logging Level
+  // Get the Logging Level
+  spdlog::level::level_enum SpdLevel;
   switch (static_cast<LogLevel>(Level)) {
   case LogLevel::Trace:
-    Logger->trace(MsgSV);
+    SpdLevel = spdlog::level::trace;
     break;
   case LogLevel::Debug:
-    Logger->debug(MsgSV);
+    SpdLevel = spdlog::level::debug;
     break;
   case LogLevel::Info:
-    Logger->info(MsgSV);
+    SpdLevel = spdlog::level::info;
     break;
   case LogLevel::Warn:
-    Logger->warn(MsgSV);
+    SpdLevel = spdlog::level::warn;
     break;
   case LogLevel::Error:
-    Logger->error(MsgSV);
+    SpdLevel = spdlog::level::err;
     break;
   case LogLevel::Critical:
-    Logger->critical(MsgSV);
+    SpdLevel = spdlog::level::critical;
     break;
   default:
     spdlog::error("[WasiLogging] Unrecognized Logging Level: {}"sv, Level);
@@ -93,6 +95,16 @@ Expect<void> Log::body(const Runtime::CallingFrame &Frame, uint32_t Level,
                   static_cast<uint32_t>(LogLevel::Critical));
     return Unexpect(ErrCode::Value::HostFuncError);
   }
+
+  // Print Message, or copy it into the queue in the asynchronous mode. The
+  // dropped messages are reported by the queue.
+  if (Env.isAsync()) {
+    if (Logger->should_log(SpdLevel)) {
+      LogQueue::getDefault().push(std::move(Logger), SpdLevel, MsgSV);
+    }
+  } else {
+    Logger->log(SpdLevel, MsgSV);
+  }
   return {};
 }
 
@@ -13,19 +13,26 @@
 namespace WasmEdge {
 namespace Host {
 
+using namespace std::literals;
+
 namespace {
+void addOptions(const Plugin::Plugin::PluginDescriptor *,
+                PO::ArgumentParser &Parser) noexcept {
+  Parser.add_option("wasi-logging-async"sv, WASILogging::LogEnv::AsyncMode);
+}
+
 Runtime::Instance::ModuleInstance *
 create(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
   return new WasiLoggingModule;
 }
 } // namespace
 
-using namespace std::literals;
-
 const std::string WASILogging::LogEnv::DefFormat =
     "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v";
 std::mutex WASILogging::LogEnv::Mutex;
 std::unordered_set<uint64_t> WASILogging::LogEnv::RegisteredID;
+PO::Option<PO::Toggle> WASILogging::LogEnv::AsyncMode(PO::Description(
+    "Write the wasi-logging messages on a background thread in batches. The messages are dropped when the queue is full."sv));
 
 WasiLoggingModule::WasiLoggingModule()
     : ModuleInstance("wasi:logging/logging"sv) {
@@ -49,7 +56,7 @@ Plugin::Plugin::PluginDescriptor WasiLoggingModule::PluginDescriptor{
     /* ModuleDescriptions */ ModuleDescriptor,
     /* ComponentCount */ 0,
     /* ComponentDescriptions */ nullptr,
-    /* AddOptions */ nullptr,
+    /* AddOptions */ addOptions,
 };
 
 } // namespace Host
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+// BUILTIN-PLUGIN: Temporary move the wasi-logging plugin sources here until
+// the new plugin architecture ready in 0.15.0.
+
+#include "plugin/wasi_logging/queue.h"
+
+#include "common/errcode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WASILogging {
+
+namespace {
+/// Time between the batches when the ring is not filling up.
+static inline constexpr const std::chrono::milliseconds kInterval{10};
+} // namespace
+
+using namespace std::literals;
+
+LogQueue::LogQueue() : Slots(std::make_unique<Slot[]>(kCapacity)) {
+  static_assert((kCapacity & (kCapacity - 1)) == 0);
+  for (size_t I = 0; I < kCapacity; ++I) {
+    Slots[I].Sequence.store(I, std::memory_order_relaxed);
+  }
+  Flusher = std::thread([this]() noexcept { run(); });
+}
+
+LogQueue::~LogQueue() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stop = true;
+  }
+  Wakeup.notify_one();
+  Flusher.join();
+}
+
+LogQueue &LogQueue::getDefault() noexcept {
+  static LogQueue Default;
+  return Default;
+}
+
+bool LogQueue::push(std::shared_ptr<spdlog::logger> Logger,
+                    spdlog::level::level_enum Level,
+                    std::string_view Message) noexcept {
+  size_t Pos = Head.load(std::memory_order_relaxed);
+  Slot *S;
+  while (true) {
+    S = &Slots[Pos & (kCapacity - 1)];
+    const size_t Seq = S->Sequence.load(std::memory_order_acquire);
+    if (Seq == Pos) {
+      if (Head.compare_exchange_weak(Pos, Pos + 1,
+                                     std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (static_cast<ptrdiff_t>(Seq - Pos) < 0) {
+      // The slot is not written yet since the last round.
+      Dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      Pos = Head.load(std::memory_order_relaxed);
+    }
+  }
+
+  S->Logger = std::move(Logger);
+  S->Level = Level;
+  S->Time = spdlog::log_clock::now();
+  bool Copied = true;
+  try {
+    S->Message.assign(Message);
+  } catch (std::bad_alloc &) {
+    // The empty slot is skipped by the background thread.
+    S->Logger.reset();
+    Dropped.fetch_add(1, std::memory_order_relaxed);
+    Copied = false;
+  }
+  S->Sequence.store(Pos + 1, std::memory_order_release);
+  if (unlikely((Pos & (kCapacity / 4 - 1)) == kCapacity / 4 - 1)) {
+    // Write a batch earlier when the ring is filling up.
+    Wakeup.notify_one();
+  }
+  return Copied;
+}
+
+void LogQueue::flush() noexcept {
+  const size_t Target = Head.load(std::memory_order_acquire);
+  std::unique_lock Lock(Mutex);
+  Wakeup.notify_one();
+  Done.wait(Lock, [&]() {
+    return Written.load(std::memory_order_acquire) >= Target;
+  });
+}
+
+void LogQueue::drain() noexcept {
+  std::vector<std::shared_ptr<spdlog::logger>> Touched;
+  while (true) {
+    Slot &S = Slots[Tail & (kCapacity - 1)];
+    if (S.Sequence.load(std::memory_order_acquire) != Tail + 1) {
+      break;
+    }
+    if (S.Logger) {
+      try {
+        S.Logger->log(S.Time, spdlog::source_loc{}, S.Level, S.Message);
+        if (std::find(Touched.begin(), Touched.end(), S.Logger) ==
+            Touched.end()) {
+          Touched.push_back(S.Logger);
+        }
+      } catch (...) {
+      }
+      // Release the replaced file loggers.
+      S.Logger.reset();
+    }
+    S.Sequence.store(Tail + kCapacity, std::memory_order_release);
+    ++Tail;
+  }
+  for (const auto &Logger : Touched) {
+    Logger->flush();
+  }
+}
+
+void LogQueue::run() noexcept {
+  std::unique_lock Lock(Mutex);
+  while (true) {
+    Lock.unlock();
+    drain();
+    if (const auto Count = Dropped.load(std::memory_order_relaxed);
+        Count != ReportedDropped) {
+      spdlog::warn("[WasiLogging] Dropped {} messages of the full queue"sv,
+                   Count - ReportedDropped);
+      ReportedDropped = Count;
+    }
+    Lock.lock();
+    Written.store(Tail, std::memory_order_release);
+    Done.notify_all();
+    if (Stop && Slots[Tail & (kCapacity - 1)].Sequence.load(
+                    std::memory_order_acquire) != Tail + 1) {
+      break;
+    }
+    Wakeup.wait_for(Lock, kInterval);
+  }
+}
+
+} // namespace WASILogging
+} // namespace Host
+} // namespace WasmEdge
@@ -13,6 +13,12 @@
     defined(__arm__) || (defined(__riscv) && __riscv_xlen == 64) ||            \
     defined(__s390x__)
 #include <sys/mman.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #else
 #include <cctype>
 #include <cstdlib>
@@ -33,6 +39,274 @@ static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
 static inline constexpr const uint64_t k12G = UINT64_C(0x300000000);
 #endif
 
+#if !WASMEDGE_OS_WINDOWS &&                                                    \
+    (defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||      \
+     (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__))
+#define WASMEDGE_ALLOCATOR_HAS_POOL 1
+/// Released 12G reservations kept for reuse. The accessible pages are
+/// discarded and made inaccessible before a reservation is kept.
+class ReservationPool {
+public:
+  void setCapacity(uint32_t Count) noexcept {
+    std::unique_lock Lock(Mutex);
+    Capacity.store(Count, std::memory_order_relaxed);
+    while (Reserved.size() > Count) {
+      munmap(Reserved.back(), k12G);
+      Reserved.pop_back();
+    }
+  }
+  uint32_t getCapacity() const noexcept {
+    return Capacity.load(std::memory_order_relaxed);
+  }
+  uint8_t *acquire() noexcept {
+    if (getCapacity() == 0) {
+      return nullptr;
+    }
+    std::unique_lock Lock(Mutex);
+    if (Reserved.empty()) {
+      return nullptr;
+    }
+    auto *Pointer = Reserved.back();
+    Reserved.pop_back();
+    return Pointer;
+  }
+  /// Reset the reservation and keep it. Return false if it is not kept.
+  bool recycle(uint8_t *Pointer, uint64_t Size) noexcept {
+    if (getCapacity() == 0) {
+      return false;
+    }
+#if defined(__linux__)
+    // Anonymous private pages are zero-filled on the next access after
+    // MADV_DONTNEED. MADV_FREE may keep the old contents, so it is not used.
+    if (Size > 0 && (madvise(Pointer + k4G, Size, MADV_DONTNEED) != 0 ||
+                     mprotect(Pointer + k4G, Size, PROT_NONE) != 0)) {
+      return false;
+    }
+#else
+    // Replace the pages by a new inaccessible mapping.
+    if (Size > 0 && mmap(Pointer + k4G, Size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE |
+                             MAP_FIXED,
+                         -1, 0) == MAP_FAILED) {
+      return false;
+    }
+#endif
+    std::unique_lock Lock(Mutex);
+    if (Reserved.size() >= getCapacity()) {
+      return false;
+    }
+    Reserved.push_back(Pointer);
+    return true;
+  }
+
+private:
+  std::mutex Mutex;
+  std::atomic<uint32_t> Capacity = 0;
+  std::vector<uint8_t *> Reserved;
+};
+
+ReservationPool &getPool() noexcept {
+  // Never destroyed, for the memory instances released at exit.
+  static ReservationPool *Pool = new ReservationPool();
+  return *Pool;
+}
+#else
+#define WASMEDGE_ALLOCATOR_HAS_POOL 0
+#endif
+
+#if WASMEDGE_ALLOCATOR_HAS_POOL && defined(__linux__) && defined(MADV_HUGEPAGE)
+#define WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES 1
+static inline constexpr const uint64_t k2M = UINT64_C(0x200000);
+
+/// Back the linear memories with the transparent huge pages.
+std::atomic<bool> EnableHugePages = false;
+
+/// Map Size bytes at a huge page boundary, so that the transparent huge pages
+/// can back the whole range. The extra head and tail are unmapped, so the
+/// result can be released by munmap with the same size.
+uint8_t *mapHugePageAligned(uint64_t Size, int Prot, int Flags) noexcept {
+  auto *Pointer = reinterpret_cast<uint8_t *>(
+      mmap(nullptr, Size + k2M, Prot, Flags, -1, 0));
+  if (Pointer == MAP_FAILED) {
+    return nullptr;
+  }
+  auto *Aligned = reinterpret_cast<uint8_t *>(
+      (reinterpret_cast<uintptr_t>(Pointer) + k2M - 1) & ~(k2M - 1));
+  if (Aligned != Pointer) {
+    munmap(Pointer, static_cast<size_t>(Aligned - Pointer));
+  }
+  if (auto *End = Pointer + Size + k2M; Aligned + Size != End) {
+    munmap(Aligned + Size, static_cast<size_t>(End - (Aligned + Size)));
+  }
+  return Aligned;
+}
+#else
+#define WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES 0
+#endif
+
+#if WASMEDGE_ALLOCATOR_HAS_POOL && defined(__linux__) &&                       \
+    defined(__x86_64__) && defined(PKEY_DISABLE_ACCESS)
+#define WASMEDGE_ALLOCATOR_HAS_PKEYS 1
+static inline constexpr const uint64_t k8G = UINT64_C(0x200000000);
+/// Address space of the striped memories, which is halved until reserved.
+static inline constexpr const uint64_t kStripedSize = UINT64_C(0x80000000000);
+
+/// Read the rights of the protection keys of this thread by RDPKRU. The key K
+/// denies the accesses by the bit 2K, and the writes by the bit 2K+1.
+uint32_t readRights() noexcept {
+  uint32_t Eax, Edx;
+  asm volatile(".byte 0x0f, 0x01, 0xee" : "=a"(Eax), "=d"(Edx) : "c"(0));
+  return Eax;
+}
+
+/// Write the rights of the protection keys of this thread by WRPKRU.
+void writeRights(uint32_t Rights) noexcept {
+  asm volatile(".byte 0x0f, 0x01, 0xef"
+               :
+               : "a"(Rights), "c"(0), "d"(0)
+               : "memory");
+}
+
+/// Linear memories striped in one reservation, which is laid out as the 4G
+/// guard, the slots, and the 8G guard. The slot I is tagged with the key
+/// Keys[I % KeyCount], where KeyCount slots cover the 8G reach of the compiled
+/// code, so that the other slots in the reach of a memory have the other keys.
+class StripedRegion {
+public:
+  bool enable(uint32_t Pages) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (isEnabled()) {
+      return true;
+    }
+    // The key 0 is the default key of the other pages.
+    uint32_t Count = 0;
+    while (Count < Keys.size()) {
+      if (const int Key = pkey_alloc(0, 0); Key > 0) {
+        Keys[Count++] = Key;
+      } else {
+        break;
+      }
+    }
+    // Enlarge the slots until the keys cover the reach. A slot of the 32-bit
+    // memories is at most 4G, which needs 2 keys.
+    constexpr uint32_t kReachPages = k8G / kPageSize;
+    uint32_t Needed = 0;
+    uint8_t *Pointer = nullptr;
+    uint64_t Size = kStripedSize;
+    if (Count >= 2) {
+      Pages = std::clamp(Pages, (kReachPages + Count - 1) / Count,
+                         kReachPages / 2);
+      Needed = (kReachPages + Pages - 1) / Pages;
+      for (; Size >= k12G + Pages * kPageSize; Size /= 2) {
+        if (auto *P = mmap(nullptr, Size, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            P != MAP_FAILED) {
+          Pointer = reinterpret_cast<uint8_t *>(P);
+          break;
+        }
+      }
+    }
+    if (Pointer == nullptr) {
+      Needed = 0;
+    }
+    while (Count > Needed) {
+      pkey_free(Keys[--Count]);
+    }
+    if (Pointer == nullptr) {
+      return false;
+    }
+    Begin = reinterpret_cast<uintptr_t>(Pointer) + k4G;
+    SlotSize = Pages * kPageSize;
+    SlotCount = static_cast<uint32_t>((Size - k12G) / SlotSize);
+    KeyCount = Count;
+    for (uint32_t I = 0; I < KeyCount; ++I) {
+      KeyMask |= UINT32_C(3) << (2 * Keys[I]);
+    }
+    Enabled.store(true, std::memory_order_release);
+    return true;
+  }
+  bool isEnabled() const noexcept {
+    return Enabled.load(std::memory_order_acquire);
+  }
+  uint32_t getSlotPages() const noexcept {
+    return isEnabled() ? static_cast<uint32_t>(SlotSize / kPageSize) : 0;
+  }
+  uint8_t *acquire() noexcept {
+    if (!isEnabled()) {
+      return nullptr;
+    }
+    std::unique_lock Lock(Mutex);
+    uint32_t Slot;
+    if (!Free.empty()) {
+      Slot = Free.back();
+      Free.pop_back();
+    } else if (Next < SlotCount) {
+      Slot = Next++;
+    } else {
+      return nullptr;
+    }
+    return reinterpret_cast<uint8_t *>(Begin + Slot * SlotSize);
+  }
+  /// Reset the slot and keep it for reuse. Return false if not striped.
+  bool release(uint8_t *Pointer, uint64_t Size) noexcept {
+    const int64_t Slot = getSlot(Pointer);
+    if (Slot < 0) {
+      return false;
+    }
+    // Replace the pages by a new inaccessible mapping, which is zeroed. The
+    // slot is leaked on failure instead of being reused with the data.
+    if (Size > 0 && mmap(Pointer, Size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE |
+                             MAP_FIXED,
+                         -1, 0) == MAP_FAILED) {
+      return true;
+    }
+    std::unique_lock Lock(Mutex);
+    Free.push_back(static_cast<uint32_t>(Slot));
+    return true;
+  }
+  /// Get the key of the striped memory, or -1 for the other memories.
+  int getKey(const uint8_t *Pointer) const noexcept {
+    const int64_t Slot = getSlot(Pointer);
+    return Slot < 0 ? -1 : Keys[static_cast<uint64_t>(Slot) % KeyCount];
+  }
+  /// Get the rights denying the accesses to all the slots.
+  uint32_t getDenied() const noexcept { return KeyMask & UINT32_C(0x55555555); }
+  uint32_t getKeyMask() const noexcept { return KeyMask; }
+
+private:
+  int64_t getSlot(const uint8_t *Pointer) const noexcept {
+    const auto Address = reinterpret_cast<uintptr_t>(Pointer);
+    if (!isEnabled() || Address < Begin ||
+        Address >= Begin + SlotCount * SlotSize) {
+      return -1;
+    }
+    return static_cast<int64_t>((Address - Begin) / SlotSize);
+  }
+
+  std::mutex Mutex;
+  std::atomic<bool> Enabled = false;
+  /// Layout set once before enabled.
+  uintptr_t Begin = 0;
+  uint64_t SlotSize = 0;
+  uint32_t SlotCount = 0;
+  std::array<int, 15> Keys;
+  uint32_t KeyCount = 0;
+  uint32_t KeyMask = 0;
+  /// Start of the never used slots, and the released slots.
+  uint32_t Next = 0;
+  std::vector<uint32_t> Free;
+};
+
+StripedRegion &getStripedRegion() noexcept {
+  // Never destroyed, for the memory instances released at exit.
+  static StripedRegion *Region = new StripedRegion();
+  return *Region;
+}
+#else
+#define WASMEDGE_ALLOCATOR_HAS_PKEYS 0
+#endif
+
 } // namespace
 
 WASMEDGE_EXPORT uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
@@ -52,11 +326,20 @@ WASMEDGE_EXPORT uint8_t *Allocator::allocate(uint32_t PageCount) noexcept {
   return Pointer;
 #elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
     (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
-  auto Reserved = reinterpret_cast<uint8_t *>(
-      mmap(nullptr, k12G, PROT_NONE,
-           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
-  if (Reserved == MAP_FAILED) {
-    return nullptr;
+  auto Reserved = getPool().acquire();
+#if WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES
+  if (Reserved == nullptr && EnableHugePages.load(std::memory_order_relaxed)) {
+    Reserved = mapHugePageAligned(k12G, PROT_NONE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE);
+  }
+#endif
+  if (Reserved == nullptr) {
+    Reserved = reinterpret_cast<uint8_t *>(
+        mmap(nullptr, k12G, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+    if (Reserved == MAP_FAILED) {
+      return nullptr;
+    }
   }
   if (PageCount == 0) {
     return Reserved + k4G;
@@ -91,11 +374,31 @@ WASMEDGE_EXPORT uint8_t *Allocator::resize(uint8_t *Pointer,
 #elif defined(HAVE_MMAP) && (defined(__x86_64__) || defined(__aarch64__) ||    \
                              (defined(__riscv) && __riscv_xlen == 64)) ||      \
     defined(__s390x__)
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  // The inaccessible pages of a slot are tagged and made accessible at once,
+  // so they are never accessible with the default key.
+  if (const int Key = getStripedRegion().getKey(Pointer); Key >= 0) {
+    if (pkey_mprotect(Pointer + OldPageCount * kPageSize,
+                      (NewPageCount - OldPageCount) * kPageSize,
+                      PROT_READ | PROT_WRITE, Key) != 0) {
+      return nullptr;
+    }
+    return Pointer;
+  }
+#endif
   if (mmap(Pointer + OldPageCount * kPageSize,
            (NewPageCount - OldPageCount) * kPageSize, PROT_READ | PROT_WRITE,
            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
     return nullptr;
   }
+#if WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES
+  if (EnableHugePages.load(std::memory_order_relaxed)) {
+    // Only a hint. The normal pages are used if the transparent huge pages
+    // are disabled in the kernel.
+    madvise(Pointer + OldPageCount * kPageSize,
+            (NewPageCount - OldPageCount) * kPageSize, MADV_HUGEPAGE);
+  }
+#endif
   return Pointer;
 #else
   auto Result = reinterpret_cast<uint8_t *>(
@@ -109,7 +412,9 @@ WASMEDGE_EXPORT uint8_t *Allocator::resize(uint8_t *Pointer,
 #endif
 }
 
-WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer, uint32_t) noexcept {
+WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer,
+                                        uint32_t PageCount
+                                        [[maybe_unused]]) noexcept {
 #if WASMEDGE_OS_WINDOWS
   winapi::VirtualFree(Pointer - k4G, 0, winapi::MEM_RELEASE_);
 #elif defined(HAVE_MMAP) && (defined(__x86_64__) || defined(__aarch64__) ||    \
@@ -118,13 +423,246 @@ WASMEDGE_EXPORT void Allocator::release(uint8_t *Pointer, uint32_t) noexcept {
   if (Pointer == nullptr) {
     return;
   }
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  if (getStripedRegion().release(Pointer, PageCount * kPageSize)) {
+    return;
+  }
+#endif
+  if (getPool().recycle(Pointer - k4G, PageCount * kPageSize)) {
+    return;
+  }
   munmap(Pointer - k4G, k12G);
 #else
   return std::free(Pointer);
 #endif
 }
 
-uint8_t *Allocator::allocate_chunk(uint64_t Size) noexcept {
+WASMEDGE_EXPORT bool Allocator::shrink(uint8_t *Pointer [[maybe_unused]],
+                                       uint32_t OldPageCount [[maybe_unused]],
+                                       uint32_t NewPageCount
+                                       [[maybe_unused]]) noexcept {
+  assuming(NewPageCount < OldPageCount);
+#if WASMEDGE_OS_WINDOWS
+  return winapi::VirtualFree(Pointer + NewPageCount * kPageSize,
+                             (OldPageCount - NewPageCount) * kPageSize,
+                             winapi::MEM_DECOMMIT_) != 0;
+#elif defined(HAVE_MMAP) && (defined(__x86_64__) || defined(__aarch64__) ||    \
+                             (defined(__riscv) && __riscv_xlen == 64)) ||      \
+    defined(__s390x__)
+  // Replace the pages by a new inaccessible mapping in the reservation.
+  return mmap(Pointer + NewPageCount * kPageSize,
+              (OldPageCount - NewPageCount) * kPageSize, PROT_NONE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1,
+              0) != MAP_FAILED;
+#else
+  // The reallocated memory may move.
+  return false;
+#endif
+}
+
+WASMEDGE_EXPORT uint8_t *
+Allocator::allocate64(uint32_t PageCount,
+                      uint32_t ReservedPageCount [[maybe_unused]]) noexcept {
+#if WASMEDGE_OS_WINDOWS
+  const uint64_t Size = ReservedPageCount * kPageSize + k4G;
+  auto Reserved = reinterpret_cast<uint8_t *>(winapi::VirtualAlloc(
+      nullptr, Size, winapi::MEM_RESERVE_, winapi::PAGE_NOACCESS_));
+  if (Reserved == nullptr) {
+    return nullptr;
+  }
+  if (PageCount > 0 && resize(Reserved, 0, PageCount) == nullptr) {
+    release64(Reserved, ReservedPageCount);
+    return nullptr;
+  }
+  return Reserved;
+#elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
+    (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
+  // The reservations of other sizes are not kept by the pool.
+  const uint64_t Size = ReservedPageCount * kPageSize + k4G;
+  auto Reserved = reinterpret_cast<uint8_t *>(
+      mmap(nullptr, Size, PROT_NONE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+  if (Reserved == MAP_FAILED) {
+    return nullptr;
+  }
+  if (PageCount > 0 && resize(Reserved, 0, PageCount) == nullptr) {
+    release64(Reserved, ReservedPageCount);
+    return nullptr;
+  }
+  return Reserved;
+#else
+  return allocate(PageCount);
+#endif
+}
+
+WASMEDGE_EXPORT void
+Allocator::release64(uint8_t *Pointer,
+                     uint32_t ReservedPageCount [[maybe_unused]]) noexcept {
+#if WASMEDGE_OS_WINDOWS
+  winapi::VirtualFree(Pointer, 0, winapi::MEM_RELEASE_);
+#elif defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||     \
+    (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__)
+  if (Pointer == nullptr) {
+    return;
+  }
+  munmap(Pointer, ReservedPageCount * kPageSize + k4G);
+#else
+  std::free(Pointer);
+#endif
+}
+
+WASMEDGE_EXPORT bool Allocator::discard(uint8_t *Pointer [[maybe_unused]],
+                                        uint64_t Size
+                                        [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_POOL && defined(__linux__)
+  // Anonymous private pages are zero-filled on the next access after
+  // MADV_DONTNEED. Other systems may keep the contents.
+  return madvise(Pointer, Size, MADV_DONTNEED) == 0;
+#else
+  return false;
+#endif
+}
+
+WASMEDGE_EXPORT void
+Allocator::setPoolCapacity(uint32_t Count [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_POOL
+  getPool().setCapacity(Count);
+#endif
+}
+
+WASMEDGE_EXPORT uint32_t Allocator::getPoolCapacity() noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_POOL
+  return getPool().getCapacity();
+#else
+  return 0;
+#endif
+}
+
+WASMEDGE_EXPORT void
+Allocator::setHugePages(bool IsEnable [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES
+  EnableHugePages.store(IsEnable, std::memory_order_relaxed);
+#endif
+}
+
+WASMEDGE_EXPORT bool Allocator::isHugePages() noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES
+  return EnableHugePages.load(std::memory_order_relaxed);
+#else
+  return false;
+#endif
+}
+
+WASMEDGE_EXPORT bool
+Allocator::enableStriping(uint32_t SlotPages [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  return getStripedRegion().enable(SlotPages);
+#else
+  return false;
+#endif
+}
+
+WASMEDGE_EXPORT uint32_t Allocator::getStripedSlotPages() noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  return getStripedRegion().getSlotPages();
+#else
+  return 0;
+#endif
+}
+
+WASMEDGE_EXPORT uint8_t *
+Allocator::allocateStriped(uint32_t PageCount [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  auto &Region = getStripedRegion();
+  if (PageCount > Region.getSlotPages()) {
+    return nullptr;
+  }
+  auto *Pointer = Region.acquire();
+  if (Pointer == nullptr || PageCount == 0) {
+    return Pointer;
+  }
+  if (resize(Pointer, 0, PageCount) == nullptr) {
+    Region.release(Pointer, 0);
+    return nullptr;
+  }
+  return Pointer;
+#else
+  return nullptr;
+#endif
+}
+
+WASMEDGE_EXPORT bool
+Allocator::tagStripedPages(uint8_t *Pointer [[maybe_unused]],
+                           uint64_t Size [[maybe_unused]],
+                           bool Writable [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  if (const int Key = getStripedRegion().getKey(Pointer); Key >= 0) {
+    return pkey_mprotect(Pointer, Size,
+                         Writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         Key) == 0;
+  }
+#endif
+  return true;
+}
+
+WASMEDGE_EXPORT uint32_t Allocator::restrictProtectionKeys(
+    Span<uint8_t *const> Memories [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  const auto &Region = getStripedRegion();
+  if (!Region.isEnabled()) {
+    return 0;
+  }
+  const uint32_t Saved = readRights();
+  uint32_t Rights = (Saved & ~Region.getKeyMask()) | Region.getDenied();
+  for (const auto *Pointer : Memories) {
+    if (const int Key = Region.getKey(Pointer); Key >= 0) {
+      Rights &= ~(UINT32_C(3) << (2 * Key));
+    }
+  }
+  if (Rights != Saved) {
+    writeRights(Rights);
+  }
+  return Saved;
+#else
+  return 0;
+#endif
+}
+
+WASMEDGE_EXPORT uint32_t Allocator::allowProtectionKeys() noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  const auto &Region = getStripedRegion();
+  if (!Region.isEnabled()) {
+    return 0;
+  }
+  const uint32_t Saved = readRights();
+  if (const uint32_t Rights = Saved & ~Region.getKeyMask(); Rights != Saved) {
+    writeRights(Rights);
+  }
+  return Saved;
+#else
+  return 0;
+#endif
+}
+
+WASMEDGE_EXPORT void
+Allocator::restoreProtectionKeys(uint32_t Rights [[maybe_unused]]) noexcept {
+#if WASMEDGE_ALLOCATOR_HAS_PKEYS
+  const auto &Region = getStripedRegion();
+  if (!Region.isEnabled()) {
+    return;
+  }
+  // Only the rights of the keys of the slots are restored.
+  const uint32_t Current = readRights();
+  if (const uint32_t Restored = (Current & ~Region.getKeyMask()) |
+                                (Rights & Region.getKeyMask());
+      Restored != Current) {
+    writeRights(Restored);
+  }
+#endif
+}
+
+uint8_t *Allocator::allocate_chunk(uint64_t Size,
+                                   bool HugePages [[maybe_unused]]) noexcept {
 #if WASMEDGE_OS_WINDOWS
   if (auto Pointer = winapi::VirtualAlloc(nullptr, Size, winapi::MEM_COMMIT_,
                                           winapi::PAGE_READWRITE_);
@@ -134,6 +672,16 @@ uint8_t *Allocator::allocate_chunk(uint64_t Size) noexcept {
     return reinterpret_cast<uint8_t *>(Pointer);
   }
 #elif defined(HAVE_MMAP)
+#if WASMEDGE_ALLOCATOR_HAS_HUGE_PAGES
+  // Smaller chunks cannot contain a whole huge page.
+  if (HugePages && Size >= k2M) {
+    if (auto Pointer = mapHugePageAligned(Size, PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS)) {
+      madvise(Pointer, Size, MADV_HUGEPAGE);
+      return Pointer;
+    }
+  }
+#endif
   if (auto Pointer = mmap(nullptr, Size, PROT_READ | PROT_WRITE,
                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
       unlikely(Pointer == MAP_FAILED)) {
@@ -194,4 +742,18 @@ bool Allocator::set_chunk_readable_writable(uint8_t *Pointer,
 #endif
 }
 
+bool Allocator::set_chunk_inaccessible(uint8_t *Pointer,
+                                       uint64_t Size) noexcept {
+#if WASMEDGE_OS_WINDOWS
+  winapi::DWORD_ OldPerm;
+  return winapi::VirtualProtect(Pointer, Size, winapi::PAGE_NOACCESS_,
+                                &OldPerm) != 0;
+#elif defined(HAVE_MMAP)
+  return mprotect(Pointer, Size, PROT_NONE) == 0;
+#else
+  // Guard regions are not supported without memory protection.
+  return false;
+#endif
+}
+
 } // namespace WasmEdge
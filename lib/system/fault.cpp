@@ -6,9 +6,11 @@
 #include "common/config.h"
 #include "common/defines.h"
 #include "common/spdlog.h"
+#include "system/fiber.h"
+#include "system/nativestack.h"
 #include "system/stacktrace.h"
 
-#include <atomic>
+#include <array>
 #include <csetjmp>
 #include <csignal>
 #include <cstdint>
@@ -18,15 +20,113 @@
 #include "system/winapi.h"
 #endif
 
+#if WASMEDGE_FAULT_UNWINDING
+#include <ucontext.h>
+
+// Stub entered by the faulting thread instead of the faulting instruction,
+// with the address of the instruction at [rsp] and the stack pointer of its
+// frame at [rsp + 8]. The CFI describes the faulting frame as the caller, for
+// unwinding from the faulting instruction. It calls the function in %rax with
+// the code in %edi, both caller-saved and dead in the unwound frames.
+asm(R"(
+  .text
+  .p2align 4
+  .globl wasmedge_fault_trap_stub
+  .hidden wasmedge_fault_trap_stub
+  .type wasmedge_fault_trap_stub, @function
+wasmedge_fault_trap_stub:
+  .cfi_startproc
+  .cfi_signal_frame
+  .cfi_escape 0x0f, 0x03, 0x77, 0x08, 0x06
+  .cfi_escape 0x10, 0x10, 0x02, 0x77, 0x00
+  call *%rax
+  ud2
+  .cfi_endproc
+  .size wasmedge_fault_trap_stub, . - wasmedge_fault_trap_stub
+)");
+extern "C" void wasmedge_fault_trap_stub();
+#endif
+
 namespace WasmEdge {
 
 namespace {
 
-std::atomic_uint handlerCount = 0;
 thread_local Fault *localHandler = nullptr;
 
+/// Keep the handler chain per fiber, for the executions suspended in the host
+/// functions.
+[[maybe_unused]] const bool LocalRegistered = Fiber::registerLocal(
+    sizeof(Fault *), [](void *Storage) noexcept {
+      std::swap(localHandler, *static_cast<Fault **>(Storage));
+    });
+
 #if defined(SA_SIGINFO)
-void signalHandler(int Signal, siginfo_t *Siginfo, void *) {
+/// The actions replaced by the handler, for the faults outside of the
+/// handlers.
+std::array<struct sigaction, 3> PrevActions;
+
+struct sigaction &prevAction(int Signal) noexcept {
+  switch (Signal) {
+  case SIGFPE:
+    return PrevActions[0];
+  case SIGBUS:
+    return PrevActions[1];
+  default:
+    return PrevActions[2];
+  }
+}
+
+void forwardSignal(int Signal, siginfo_t *Siginfo, void *Context) noexcept {
+  const auto &Prev = prevAction(Signal);
+  if (Prev.sa_flags & SA_SIGINFO) {
+    Prev.sa_sigaction(Signal, Siginfo, Context);
+  } else if (Prev.sa_handler != SIG_DFL && Prev.sa_handler != SIG_IGN) {
+    Prev.sa_handler(Signal);
+  } else {
+    // The faulting instruction runs again with the default action.
+    std::signal(Signal, SIG_DFL);
+  }
+}
+
+#if WASMEDGE_FAULT_UNWINDING
+/// The red zone below the stack pointer of the faulting frame is skipped.
+static inline constexpr const uintptr_t kRedZoneSize = 128;
+
+[[noreturn]] void raiseFault(uint32_t Code) {
+  Fault::emitFault(static_cast<ErrCode::Value>(Code));
+}
+
+/// Make the faulting thread enter the stub when the handler returns. The
+/// frame of the stub is put on the alternate signal stack if the handler runs
+/// on it, since the stack of the thread may be overflowed.
+void redirectFault(void *Context, ErrCode::Value Code) noexcept {
+  auto &Registers = static_cast<ucontext_t *>(Context)->uc_mcontext.gregs;
+  const auto SP = static_cast<uintptr_t>(Registers[REG_RSP]);
+  uintptr_t Frame = SP - kRedZoneSize;
+  if (stack_t Stack; ::sigaltstack(nullptr, &Stack) == 0 &&
+                     (Stack.ss_flags & SS_ONSTACK)) {
+    const auto Base = reinterpret_cast<uintptr_t>(Stack.ss_sp);
+    // Not for the faults of the code already run on the signal stack.
+    if (SP < Base || SP >= Base + Stack.ss_size) {
+      Frame = Base + Stack.ss_size;
+    }
+  }
+  Frame = (Frame - 2 * sizeof(uintptr_t)) & ~uintptr_t(15);
+  auto *Slots = reinterpret_cast<uintptr_t *>(Frame);
+  Slots[0] = static_cast<uintptr_t>(Registers[REG_RIP]);
+  Slots[1] = SP;
+  Registers[REG_RSP] = static_cast<greg_t>(Frame);
+  Registers[REG_RIP] = reinterpret_cast<greg_t>(&wasmedge_fault_trap_stub);
+  Registers[REG_RAX] = reinterpret_cast<greg_t>(&raiseFault);
+  Registers[REG_RDI] = static_cast<greg_t>(Code);
+}
+#endif
+
+void signalHandler(int Signal, siginfo_t *Siginfo, void *Context) {
+  if (unlikely(localHandler == nullptr)) {
+    forwardSignal(Signal, Siginfo, Context);
+    return;
+  }
   {
     // Unblock current signal
     sigset_t Set;
@@ -34,37 +134,48 @@ void signalHandler(int Signal, siginfo_t *Siginfo, void *) {
     sigaddset(&Set, Signal);
     pthread_sigmask(SIG_UNBLOCK, &Set, nullptr);
   }
+  ErrCode::Value Code;
   switch (Signal) {
   case SIGBUS:
   case SIGSEGV:
-    Fault::emitFault(ErrCode::Value::MemoryOutOfBounds);
+    Code = NativeStack::isGuardAddress(Siginfo->si_addr)
+               ? ErrCode::Value::StackOverflow
+               : ErrCode::Value::MemoryOutOfBounds;
+    break;
   case SIGFPE:
     assuming(Siginfo->si_code == FPE_INTDIV);
-    Fault::emitFault(ErrCode::Value::DivideByZero);
+    Code = ErrCode::Value::DivideByZero;
+    break;
   default:
     assumingUnreachable();
   }
+#if WASMEDGE_FAULT_UNWINDING
+  if (localHandler->isUnwinding()) {
+    redirectFault(Context, Code);
+    return;
+  }
+#endif
+  Fault::emitFault(Code);
 }
 
 void enableHandler() noexcept {
   struct sigaction Action {};
   Action.sa_sigaction = &signalHandler;
-  Action.sa_flags = SA_SIGINFO;
-  sigaction(SIGFPE, &Action, nullptr);
-  sigaction(SIGBUS, &Action, nullptr);
-  sigaction(SIGSEGV, &Action, nullptr);
-}
-
-void disableHandler() noexcept {
-  std::signal(SIGFPE, SIG_DFL);
-  std::signal(SIGBUS, SIG_DFL);
-  std::signal(SIGSEGV, SIG_DFL);
+  // Run on the alternate signal stack if the thread has one, for handling the
+  // overflows of the native stacks.
+  Action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigaction(SIGFPE, &Action, &prevAction(SIGFPE));
+  sigaction(SIGBUS, &Action, &prevAction(SIGBUS));
+  sigaction(SIGSEGV, &Action, &prevAction(SIGSEGV));
 }
 
 #elif WASMEDGE_OS_WINDOWS
 
 winapi::LONG_ WASMEDGE_WINAPI_WINAPI_CC
 vectoredExceptionHandler(winapi::PEXCEPTION_POINTERS_ ExceptionInfo) {
+  if (localHandler == nullptr) {
+    return winapi::EXCEPTION_CONTINUE_SEARCH_;
+  }
   const winapi::DWORD_ Code = ExceptionInfo->ExceptionRecord->ExceptionCode;
   switch (Code) {
   case winapi::EXCEPTION_INT_DIVIDE_BY_ZERO_:
@@ -77,47 +188,40 @@ vectoredExceptionHandler(winapi::PEXCEPTION_POINTERS_ ExceptionInfo) {
   return winapi::EXCEPTION_CONTINUE_EXECUTION_;
 }
 
-void *HandlerHandle = nullptr;
-
 void enableHandler() noexcept {
-  HandlerHandle =
-      winapi::AddVectoredExceptionHandler(1, &vectoredExceptionHandler);
-}
-
-void disableHandler() noexcept {
-  winapi::RemoveVectoredExceptionHandler(HandlerHandle);
+  winapi::AddVectoredExceptionHandler(1, &vectoredExceptionHandler);
 }
 
 #endif
 
-void increaseHandler() noexcept {
-  if (handlerCount++ == 0) {
-    enableHandler();
-  }
-}
-
-void decreaseHandler() noexcept {
-  if (--handlerCount == 0) {
-    disableHandler();
-  }
+/// The handler is installed at the first use and kept, so that entering the
+/// handlers costs no system calls. The faults outside of the handlers are
+/// passed on.
+void installHandler() noexcept {
+  [[maybe_unused]] static const bool Installed = (enableHandler(), true);
 }
 
 } // namespace
 
 Fault::Fault() {
   Prev = std::exchange(localHandler, this);
-  increaseHandler();
+  installHandler();
 }
 
-Fault::~Fault() noexcept {
-  decreaseHandler();
-  localHandler = std::exchange(Prev, nullptr);
+Fault::Fault(Unwinding) noexcept : Unwind(true) {
+  Prev = std::exchange(localHandler, this);
+  installHandler();
 }
 
+Fault::~Fault() noexcept { localHandler = std::exchange(Prev, nullptr); }
+
 [[noreturn]] void Fault::emitFault(ErrCode Error) {
   assuming(localHandler != nullptr);
   auto Buffer = stackTrace(localHandler->StackTraceBuffer);
   localHandler->StackTraceSize = Buffer.size();
+  if (localHandler->Unwind) {
+    throw Error;
+  }
   longjmp(localHandler->Buffer, static_cast<int>(Error.operator uint32_t()));
 }
 
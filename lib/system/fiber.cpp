@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+// The ucontext functions are only declared for the XSI conformance on macOS.
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "system/fiber.h"
+
+#include "common/config.h"
+#include "common/defines.h"
+#include "common/errcode.h"
+
+#include <new>
+#include <utility>
+#include <vector>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+
+namespace {
+
+struct LocalEntry {
+  size_t Offset;
+  Fiber::SwapLocalFunc Swap;
+};
+
+struct LocalRegistry {
+  std::vector<LocalEntry> Entries;
+  size_t Size = 0;
+};
+
+LocalRegistry &registry() noexcept {
+  static LocalRegistry Registry;
+  return Registry;
+}
+
+thread_local Fiber *Running = nullptr;
+
+} // namespace
+
+struct Fiber::Context {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  ucontext_t Caller;
+  ucontext_t Self;
+#endif
+};
+
+bool Fiber::registerLocal(size_t Size, SwapLocalFunc Swap) noexcept {
+  auto &Registry = registry();
+  Registry.Entries.push_back({Registry.Size, Swap});
+  constexpr const size_t Unit = sizeof(std::max_align_t);
+  Registry.Size += (Size + Unit - 1) / Unit * Unit;
+  return true;
+}
+
+Fiber::Fiber() noexcept = default;
+
+Fiber::~Fiber() noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (Stack) {
+    ::munmap(Stack, StackSize);
+  }
+#endif
+}
+
+std::unique_ptr<Fiber> Fiber::create(std::function<void()> Func,
+                                     size_t StackSize) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  std::unique_ptr<Fiber> Result(new (std::nothrow) Fiber());
+  if (unlikely(!Result)) {
+    return nullptr;
+  }
+  try {
+    Result->Ctx = std::make_unique<Context>();
+    Result->Locals.reset(
+        new std::max_align_t[registry().Size / sizeof(std::max_align_t)]());
+  } catch (std::bad_alloc &) {
+    return nullptr;
+  }
+
+  // Keep a guard page below the stack, for catching the overflows.
+  const size_t PageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  StackSize = (StackSize + PageSize - 1) / PageSize * PageSize;
+  void *Stack = ::mmap(nullptr, StackSize + PageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (unlikely(Stack == MAP_FAILED)) {
+    return nullptr;
+  }
+  Result->Stack = Stack;
+  Result->StackSize = StackSize + PageSize;
+  if (unlikely(::mprotect(Stack, PageSize, PROT_NONE) != 0)) {
+    return nullptr;
+  }
+
+  auto &Ctx = *Result->Ctx;
+  if (unlikely(::getcontext(&Ctx.Self) != 0)) {
+    return nullptr;
+  }
+  Ctx.Self.uc_stack.ss_sp = static_cast<char *>(Stack) + PageSize;
+  Ctx.Self.uc_stack.ss_size = StackSize;
+  Ctx.Self.uc_link = &Ctx.Caller;
+  ::makecontext(&Ctx.Self, &Fiber::entry, 0);
+  Result->Func = std::move(Func);
+  return Result;
+#else
+  static_cast<void>(Func);
+  static_cast<void>(StackSize);
+  return nullptr;
+#endif
+}
+
+void Fiber::resume() noexcept {
+  assuming(!Finished);
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  Prev = std::exchange(Running, this);
+  swapLocals();
+  ::swapcontext(&Ctx->Caller, &Ctx->Self);
+  swapLocals();
+  Running = std::exchange(Prev, nullptr);
+#endif
+}
+
+void Fiber::suspend() noexcept {
+  Fiber *Self = Running;
+  assuming(Self);
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  ::swapcontext(&Self->Ctx->Self, &Self->Ctx->Caller);
+#endif
+}
+
+Fiber *Fiber::current() noexcept { return Running; }
+
+void Fiber::entry() noexcept {
+  Fiber *Self = Running;
+  Self->Func();
+  Self->Finished = true;
+  // Return to the caller of `resume` through `uc_link`.
+}
+
+void Fiber::swapLocals() noexcept {
+  auto *Storage = reinterpret_cast<std::byte *>(Locals.get());
+  for (const auto &Entry : registry().Entries) {
+    Entry.Swap(Storage + Entry.Offset);
+  }
+}
+
+} // namespace WasmEdge
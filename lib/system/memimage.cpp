@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "system/memimage.h"
+
+#include "common/config.h"
+#include "common/defines.h"
+#include "system/allocator.h"
+
+#if !WASMEDGE_OS_WINDOWS &&                                                    \
+    (defined(HAVE_MMAP) && defined(__x86_64__) || defined(__aarch64__) ||      \
+     (defined(__riscv) && __riscv_xlen == 64) || defined(__s390x__))
+// Only on the platforms which the allocator reserves the linear memory by
+// mmap.
+#define WASMEDGE_MEMORY_IMAGE_SUPPORTED 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+
+#include "common/filesystem.h"
+#else
+#define WASMEDGE_MEMORY_IMAGE_SUPPORTED 0
+#endif
+
+namespace WasmEdge {
+
+namespace {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+/// Granularity to skip the zero bytes when writing the image.
+static inline constexpr const uint64_t kBlockSize = UINT64_C(4096);
+
+int createAnonymousFile() noexcept {
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+  if (const int File = memfd_create("wasmedge-memory-image", MFD_CLOEXEC);
+      File >= 0) {
+    return File;
+  }
+#endif
+  std::error_code Error;
+  auto Path = std::filesystem::temp_directory_path(Error);
+  if (Error) {
+    return -1;
+  }
+  std::string Template = (Path / "wasmedge-memory-image-XXXXXX").string();
+  const int File = mkstemp(Template.data());
+  if (File < 0) {
+    return -1;
+  }
+  unlink(Template.c_str());
+  return File;
+}
+
+bool writeAll(int File, const uint8_t *Data, uint64_t Size,
+              uint64_t Offset) noexcept {
+  while (Size > 0) {
+    const auto Written = pwrite(File, Data, Size, static_cast<off_t>(Offset));
+    if (Written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    Data += Written;
+    Size -= static_cast<uint64_t>(Written);
+    Offset += static_cast<uint64_t>(Written);
+  }
+  return true;
+}
+
+bool isZeroBlock(const uint8_t *Begin, const uint8_t *End) noexcept {
+  return std::all_of(Begin, End, [](uint8_t B) { return B == 0; });
+}
+#endif
+} // namespace
+
+MemoryImage::~MemoryImage() noexcept {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+  close(File);
+#endif
+}
+
+std::unique_ptr<MemoryImage>
+MemoryImage::create(Span<const uint8_t> Data [[maybe_unused]]) noexcept {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+  if (Data.empty() || Data.size() % kBlockSize != 0) {
+    return nullptr;
+  }
+  const int File = createAnonymousFile();
+  if (File < 0) {
+    return nullptr;
+  }
+  std::unique_ptr<MemoryImage> Image(new MemoryImage(File, Data.size()));
+  if (ftruncate(File, static_cast<off_t>(Data.size())) != 0) {
+    return nullptr;
+  }
+  // Write the non-zero blocks only. The holes are read as zeros and do not
+  // occupy the page cache.
+  uint64_t Begin = 0;
+  while (Begin < Data.size()) {
+    if (isZeroBlock(Data.data() + Begin, Data.data() + Begin + kBlockSize)) {
+      Begin += kBlockSize;
+      continue;
+    }
+    uint64_t End = Begin + kBlockSize;
+    while (End < Data.size() &&
+           !isZeroBlock(Data.data() + End, Data.data() + End + kBlockSize)) {
+      End += kBlockSize;
+    }
+    if (!writeAll(File, Data.data() + Begin, End - Begin, Begin)) {
+      return nullptr;
+    }
+    Begin = End;
+  }
+  return Image;
+#else
+  return nullptr;
+#endif
+}
+
+bool MemoryImage::map(uint8_t *Pointer [[maybe_unused]]) const noexcept {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+  // The new mappings in the striped memories should have their keys again.
+  return mmap(Pointer, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+              File, 0) != MAP_FAILED &&
+         Allocator::tagStripedPages(Pointer, Size, true);
+#else
+  return false;
+#endif
+}
+
+bool MemoryImage::unmap(uint8_t *Pointer [[maybe_unused]],
+                        uint64_t Size [[maybe_unused]]) noexcept {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+  return mmap(Pointer, Size, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED &&
+         Allocator::tagStripedPages(Pointer, Size, true);
+#else
+  return false;
+#endif
+}
+
+bool MemoryImage::mapShared(int File [[maybe_unused]],
+                            uint8_t *Pointer [[maybe_unused]],
+                            uint64_t Size [[maybe_unused]],
+                            bool Writable [[maybe_unused]]) noexcept {
+#if WASMEDGE_MEMORY_IMAGE_SUPPORTED
+  // Accessing the pages beyond the end of the file raises SIGBUS.
+  struct stat Stat;
+  if (fstat(File, &Stat) != 0 || Stat.st_size < 0 ||
+      static_cast<uint64_t>(Stat.st_size) < Size) {
+    return false;
+  }
+  const int Prot = Writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  return mmap(Pointer, Size, Prot, MAP_SHARED | MAP_FIXED, File, 0) !=
+             MAP_FAILED &&
+         Allocator::tagStripedPages(Pointer, Size, Writable);
+#else
+  return false;
+#endif
+}
+
+bool MemoryImage::supported() noexcept {
+  return WASMEDGE_MEMORY_IMAGE_SUPPORTED;
+}
+
+} // namespace WasmEdge
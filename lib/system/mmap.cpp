@@ -53,6 +53,14 @@ struct Implement {
     }
   }
   bool ok() const noexcept { return Address != MAP_FAILED; }
+  bool mapExecutable(void *Target, uint64_t Offset,
+                     uint64_t Length) const noexcept {
+    if (Offset > Size || Length > Size - Offset) {
+      return false;
+    }
+    return mmap(Target, Length, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_FIXED,
+                File, static_cast<off_t>(Offset)) != MAP_FAILED;
+  }
 };
 #elif WASMEDGE_OS_WINDOWS
 static inline bool kSupported = true;
@@ -122,12 +130,19 @@ struct Implement {
     }
   }
   bool ok() const noexcept { return Address != nullptr; }
+  bool mapExecutable(void *, uint64_t, uint64_t) const noexcept {
+    // A view cannot be placed over the pages of an existing allocation.
+    return false;
+  }
 };
 #else
 static inline bool kSupported = false;
 struct Implement {
   Implement(const std::filesystem::path &Path) noexcept = default;
   bool ok() const noexcept { return false; }
+  bool mapExecutable(void *, uint64_t, uint64_t) const noexcept {
+    return false;
+  }
 }
 #endif
 } // namespace
@@ -157,6 +172,15 @@ void *MMap::address() const noexcept {
   return reinterpret_cast<const Implement *>(Handle)->Address;
 }
 
+bool MMap::mapExecutable(void *Address, uint64_t Offset,
+                         uint64_t Size) const noexcept {
+  if (!Handle) {
+    return false;
+  }
+  return reinterpret_cast<const Implement *>(Handle)->mapExecutable(
+      Address, Offset, Size);
+}
+
 bool MMap::supported() noexcept { return kSupported; }
 
 } // namespace WasmEdge
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+// The ucontext functions are only declared for the XSI conformance on macOS.
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "system/nativestack.h"
+
+#include "common/config.h"
+#include "common/defines.h"
+#include "common/errcode.h"
+
+#include <cstdint>
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <csignal>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+namespace WasmEdge {
+
+namespace {
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Size of the alternate signal stack, where the fault handler runs when the
+/// stack overflows.
+static inline constexpr const size_t kSignalStackSize = 64 * 1024;
+
+struct ThreadStack {
+  /// Mapping of the guard page and the stack.
+  void *Base = nullptr;
+  size_t MapSize = 0;
+  size_t PageSize = 0;
+  void *SignalStack = nullptr;
+  ucontext_t Caller;
+  ucontext_t Self;
+  NativeStack::Func F = nullptr;
+  void *Data = nullptr;
+  bool Running = false;
+
+  ~ThreadStack() noexcept {
+    if (SignalStack) {
+      stack_t Stack = {};
+      Stack.ss_flags = SS_DISABLE;
+      ::sigaltstack(&Stack, nullptr);
+      ::munmap(SignalStack, kSignalStackSize);
+    }
+    if (Base) {
+      ::munmap(Base, MapSize);
+    }
+  }
+
+  bool map(size_t Size) noexcept {
+    if (PageSize == 0) {
+      PageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+    Size = (Size + PageSize - 1) / PageSize * PageSize;
+    if (Base && MapSize == Size + PageSize) {
+      return true;
+    }
+    if (Base) {
+      ::munmap(Base, MapSize);
+      Base = nullptr;
+    }
+    void *Ptr = ::mmap(nullptr, Size + PageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (unlikely(Ptr == MAP_FAILED)) {
+      return false;
+    }
+    if (unlikely(::mprotect(Ptr, PageSize, PROT_NONE) != 0)) {
+      ::munmap(Ptr, Size + PageSize);
+      return false;
+    }
+    Base = Ptr;
+    MapSize = Size + PageSize;
+    return true;
+  }
+
+  /// The fault handler cannot run on the overflowed stack, so the thread
+  /// needs an alternate signal stack if it has none.
+  bool mapSignalStack() noexcept {
+    if (SignalStack) {
+      return true;
+    }
+    stack_t Old = {};
+    if (::sigaltstack(nullptr, &Old) == 0 && !(Old.ss_flags & SS_DISABLE)) {
+      return true;
+    }
+    void *Ptr = ::mmap(nullptr, kSignalStackSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (unlikely(Ptr == MAP_FAILED)) {
+      return false;
+    }
+    stack_t Stack = {};
+    Stack.ss_sp = Ptr;
+    Stack.ss_size = kSignalStackSize;
+    if (unlikely(::sigaltstack(&Stack, nullptr) != 0)) {
+      ::munmap(Ptr, kSignalStackSize);
+      return false;
+    }
+    SignalStack = Ptr;
+    return true;
+  }
+};
+
+thread_local ThreadStack Local;
+
+void entry() noexcept {
+  Local.F(Local.Data);
+  // Return to the caller of `run` through `uc_link`.
+}
+#endif
+
+} // namespace
+
+bool NativeStack::run(size_t Size, Func F, void *Data) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (Local.Running) {
+    F(Data);
+    return true;
+  }
+  if (unlikely(!Local.mapSignalStack() || !Local.map(Size))) {
+    return false;
+  }
+  if (unlikely(::getcontext(&Local.Self) != 0)) {
+    return false;
+  }
+  Local.Self.uc_stack.ss_sp = static_cast<char *>(Local.Base) + Local.PageSize;
+  Local.Self.uc_stack.ss_size = Local.MapSize - Local.PageSize;
+  Local.Self.uc_link = &Local.Caller;
+  ::makecontext(&Local.Self, &entry, 0);
+  Local.F = F;
+  Local.Data = Data;
+  Local.Running = true;
+  ::swapcontext(&Local.Caller, &Local.Self);
+  Local.Running = false;
+  return true;
+#else
+  static_cast<void>(Size);
+  static_cast<void>(F);
+  static_cast<void>(Data);
+  return false;
+#endif
+}
+
+bool NativeStack::isGuardAddress(const void *Addr) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (!Local.Running) {
+    return false;
+  }
+  const auto Ptr = reinterpret_cast<uintptr_t>(Addr);
+  const auto Guard = reinterpret_cast<uintptr_t>(Local.Base);
+  return Ptr >= Guard && Ptr < Guard + Local.PageSize;
+#else
+  static_cast<void>(Addr);
+  return false;
+#endif
+}
+
+} // namespace WasmEdge
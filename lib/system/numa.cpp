@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "system/numa.h"
+
+#include "common/defines.h"
+
+#if WASMEDGE_OS_LINUX
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "common/filesystem.h"
+#endif
+
+namespace WasmEdge {
+
+#if WASMEDGE_OS_LINUX
+namespace {
+/// Maximum count of the nodes in the memory policy masks.
+static inline constexpr const uint32_t kMaxNodes = 1024;
+static inline constexpr const uint32_t kBitsPerLong = sizeof(unsigned long) * 8;
+
+const std::filesystem::path &getNodeRoot() noexcept {
+  static const std::filesystem::path Root = "/sys/devices/system/node";
+  return Root;
+}
+
+/// Parse the CPU list like "0-3,8,10-11".
+std::vector<uint32_t> parseCPUList(const std::string &List) noexcept {
+  std::vector<uint32_t> CPUs;
+  size_t Pos = 0;
+  while (Pos < List.size()) {
+    size_t End = List.find(',', Pos);
+    if (End == std::string::npos) {
+      End = List.size();
+    }
+    const auto Range = List.substr(Pos, End - Pos);
+    const auto Dash = Range.find('-');
+    try {
+      const auto First = std::stoul(Range.substr(0, Dash));
+      const auto Last = Dash == std::string::npos
+                            ? First
+                            : std::stoul(Range.substr(Dash + 1));
+      for (auto CPU = First; CPU <= Last && CPU < CPU_SETSIZE; ++CPU) {
+        CPUs.push_back(static_cast<uint32_t>(CPU));
+      }
+    } catch (...) {
+      return {};
+    }
+    Pos = End + 1;
+  }
+  return CPUs;
+}
+} // namespace
+#endif
+
+uint32_t Numa::getNodeCount() noexcept {
+#if WASMEDGE_OS_LINUX
+  static const uint32_t Count = []() noexcept {
+    uint32_t N = 0;
+    std::error_code Error;
+    while (N < kMaxNodes &&
+           std::filesystem::exists(
+               getNodeRoot() / ("node" + std::to_string(N)), Error)) {
+      ++N;
+    }
+    return N;
+  }();
+  return Count;
+#else
+  return 0;
+#endif
+}
+
+std::vector<uint32_t> Numa::getNodeCPUs(uint32_t Node
+                                        [[maybe_unused]]) noexcept {
+#if WASMEDGE_OS_LINUX
+  if (Node >= getNodeCount()) {
+    return {};
+  }
+  std::ifstream File(getNodeRoot() / ("node" + std::to_string(Node)) /
+                     "cpulist");
+  std::string List;
+  if (!std::getline(File, List)) {
+    return {};
+  }
+  return parseCPUList(List);
+#else
+  return {};
+#endif
+}
+
+bool Numa::bindMemory(void *Pointer [[maybe_unused]],
+                      uint64_t Size [[maybe_unused]],
+                      uint32_t Node [[maybe_unused]]) noexcept {
+#if WASMEDGE_OS_LINUX && defined(SYS_mbind)
+  if (Node >= getNodeCount()) {
+    return false;
+  }
+  unsigned long Mask[kMaxNodes / kBitsPerLong] = {};
+  Mask[Node / kBitsPerLong] = 1UL << (Node % kBitsPerLong);
+  // The preferred policy falls back to the other nodes instead of failing the
+  // page faults when the node is full.
+  return syscall(SYS_mbind, Pointer, Size, MPOL_PREFERRED, Mask,
+                 kMaxNodes + 1, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+bool Numa::bindThread(uint32_t Node [[maybe_unused]]) noexcept {
+#if WASMEDGE_OS_LINUX
+  const auto CPUs = getNodeCPUs(Node);
+  if (CPUs.empty()) {
+    return false;
+  }
+  cpu_set_t Set;
+  CPU_ZERO(&Set);
+  for (const auto CPU : CPUs) {
+    CPU_SET(CPU, &Set);
+  }
+  return sched_setaffinity(0, sizeof(Set), &Set) == 0;
+#else
+  return false;
+#endif
+}
+
+} // namespace WasmEdge
@@ -0,0 +1,484 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "system/sampler.h"
+
+#include "common/defines.h"
+#include "common/spdlog.h"
+#include "system/fiber.h"
+#include "system/stacktrace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#if WASMEDGE_OS_LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+namespace WasmEdge {
+
+namespace {
+
+using namespace std::literals;
+
+/// Limits of a recorded stack, and of the distinct recorded stacks.
+inline constexpr size_t kMaxFuncs = 32;
+inline constexpr size_t kMaxIPs = 64;
+inline constexpr size_t kTableSize = 4096;
+inline constexpr size_t kMaxProbes = 64;
+
+struct Entry {
+  std::atomic<uint64_t> Hash;
+  std::atomic<uint64_t> Count;
+  std::atomic<bool> Ready;
+  uint32_t FuncNum;
+  uint32_t IPNum;
+  /// The function instances of the interpreter frames from the root, and the
+  /// return addresses of the native stack from the leaf.
+  std::array<const void *, kMaxFuncs> Funcs;
+  std::array<void *, kMaxIPs> IPs;
+};
+
+std::atomic_bool Active = false;
+std::atomic_uint32_t Frequency = 99;
+std::atomic_uint32_t Busy = 0;
+std::atomic_uint64_t Samples = 0;
+std::atomic_uint64_t Dropped = 0;
+std::unique_ptr<Entry[]> Table;
+
+thread_local const Runtime::StackManager *LocalStack = nullptr;
+[[maybe_unused]] thread_local uint32_t LocalDepth = 0;
+
+/// Keep the sampled stack manager per fiber, for the executions suspended in
+/// the host functions.
+[[maybe_unused]] const bool LocalRegistered = Fiber::registerLocal(
+    sizeof(const Runtime::StackManager *), [](void *Storage) noexcept {
+      std::swap(LocalStack,
+                *static_cast<const Runtime::StackManager **>(Storage));
+    });
+
+/// Names of the registered functions, by the function instances and by the
+/// addresses of the compiled functions. An empty name marks the end of a
+/// compiled function.
+struct Registry {
+  std::mutex Mutex;
+  std::unordered_map<const void *, std::string> Funcs;
+  std::map<uintptr_t, std::string> Symbols;
+};
+Registry &getRegistry() noexcept {
+  static Registry R;
+  return R;
+}
+
+uint64_t hashStack(Span<const void *const> Funcs,
+                   Span<void *const> IPs) noexcept {
+  uint64_t Hash = UINT64_C(14695981039346656037);
+  const auto Mix = [&Hash](uintptr_t V) noexcept {
+    for (size_t I = 0; I < sizeof(V); ++I) {
+      Hash ^= (V >> (I * 8)) & 0xFF;
+      Hash *= UINT64_C(1099511628211);
+    }
+  };
+  for (auto F : Funcs) {
+    Mix(reinterpret_cast<uintptr_t>(F));
+  }
+  Mix(0);
+  for (auto IP : IPs) {
+    Mix(reinterpret_cast<uintptr_t>(IP));
+  }
+  return Hash == 0 ? 1 : Hash;
+}
+
+/// Count the stack into the table without any allocation or lock.
+void record(Span<const void *const> Funcs, Span<void *const> IPs) noexcept {
+  const uint64_t Hash = hashStack(Funcs, IPs);
+  for (size_t Probe = 0; Probe < kMaxProbes; ++Probe) {
+    auto &E = Table[(Hash + Probe) % kTableSize];
+    uint64_t Current = E.Hash.load(std::memory_order_acquire);
+    if (Current == 0) {
+      if (E.Hash.compare_exchange_strong(Current, Hash,
+                                         std::memory_order_acq_rel)) {
+        E.FuncNum = static_cast<uint32_t>(Funcs.size());
+        E.IPNum = static_cast<uint32_t>(IPs.size());
+        std::copy(Funcs.begin(), Funcs.end(), E.Funcs.begin());
+        std::copy(IPs.begin(), IPs.end(), E.IPs.begin());
+        E.Count.fetch_add(1, std::memory_order_relaxed);
+        E.Ready.store(true, std::memory_order_release);
+        Samples.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    if (Current == Hash && E.Ready.load(std::memory_order_acquire) &&
+        E.FuncNum == Funcs.size() && E.IPNum == IPs.size() &&
+        std::equal(Funcs.begin(), Funcs.end(), E.Funcs.begin()) &&
+        std::equal(IPs.begin(), IPs.end(), E.IPs.begin())) {
+      E.Count.fetch_add(1, std::memory_order_relaxed);
+      Samples.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  Dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if WASMEDGE_OS_LINUX
+thread_local timer_t LocalTimer;
+thread_local bool LocalTimerSet = false;
+
+void signalHandler(int, siginfo_t *, void *) {
+  const int SavedErrno = errno;
+  Busy.fetch_add(1, std::memory_order_acquire);
+  if (Active.load(std::memory_order_acquire) && LocalStack) {
+    // The frames are read in the interrupted thread, as the fault handler
+    // does when unwinding.
+    std::array<const void *, kMaxFuncs> Funcs;
+    size_t FuncNum = 0;
+    const auto Frames = LocalStack->getFramesSpan();
+    const size_t First =
+        Frames.size() > kMaxFuncs * 2 ? Frames.size() - kMaxFuncs * 2 : 0;
+    for (size_t I = First; I < Frames.size(); ++I) {
+      if (Frames[I].Func) {
+        if (FuncNum == kMaxFuncs) {
+          std::move(Funcs.begin() + 1, Funcs.end(), Funcs.begin());
+          --FuncNum;
+        }
+        Funcs[FuncNum++] = Frames[I].Func;
+      }
+    }
+    std::array<void *, kMaxIPs> IPs;
+    const auto Stack = stackTrace(IPs);
+    record(Span<const void *const>(Funcs.data(), FuncNum), Stack);
+  }
+  Busy.fetch_sub(1, std::memory_order_release);
+  errno = SavedErrno;
+}
+
+bool enableHandler() noexcept {
+  static const bool Enabled = []() noexcept {
+    struct sigaction Action {};
+    Action.sa_sigaction = &signalHandler;
+    Action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&Action.sa_mask);
+    return sigaction(SIGPROF, &Action, nullptr) == 0;
+  }();
+  return Enabled;
+}
+
+void startTimer() noexcept {
+  struct sigevent Event {};
+  Event.sigev_notify = SIGEV_THREAD_ID;
+  Event.sigev_signo = SIGPROF;
+  Event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &Event, &LocalTimer) != 0) {
+    spdlog::warn("Failed to create the sampling timer: errno {}"sv, errno);
+    return;
+  }
+  LocalTimerSet = true;
+  const long Interval = 1000000000L / std::max(Frequency.load(), UINT32_C(1));
+  struct itimerspec Spec {};
+  Spec.it_interval.tv_sec = Interval / 1000000000L;
+  Spec.it_interval.tv_nsec = Interval % 1000000000L;
+  Spec.it_value = Spec.it_interval;
+  timer_settime(LocalTimer, 0, &Spec, nullptr);
+}
+
+void stopTimer() noexcept {
+  if (std::exchange(LocalTimerSet, false)) {
+    timer_delete(LocalTimer);
+  }
+}
+#endif
+
+/// Reader of the LEB128 numbers and names in the name section.
+struct NameReader {
+  Span<const Byte> Data;
+  size_t Pos = 0;
+
+  bool readU32(uint32_t &Value) noexcept {
+    Value = 0;
+    for (uint32_t Shift = 0; Shift < 35; Shift += 7) {
+      if (Pos >= Data.size()) {
+        return false;
+      }
+      const Byte B = Data[Pos++];
+      Value |= static_cast<uint32_t>(B & 0x7F) << Shift;
+      if ((B & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  bool readName(std::string_view &Name) noexcept {
+    uint32_t Size;
+    if (!readU32(Size) || Size > Data.size() - Pos) {
+      return false;
+    }
+    Name = std::string_view(reinterpret_cast<const char *>(&Data[Pos]), Size);
+    Pos += Size;
+    return true;
+  }
+};
+
+/// Collect the function names subsection of the name section.
+std::map<uint32_t, std::string> readFunctionNames(const AST::Module &Mod) {
+  std::map<uint32_t, std::string> Names;
+  for (const auto &Sec : Mod.getCustomSections()) {
+    if (Sec.getName() != "name"sv) {
+      continue;
+    }
+    NameReader Reader{Sec.getContent()};
+    while (Reader.Pos < Reader.Data.size()) {
+      const Byte Id = Reader.Data[Reader.Pos++];
+      uint32_t Size;
+      if (!Reader.readU32(Size) || Size > Reader.Data.size() - Reader.Pos) {
+        break;
+      }
+      if (Id != 1) {
+        Reader.Pos += Size;
+        continue;
+      }
+      NameReader Sub{Reader.Data.subspan(Reader.Pos, Size)};
+      Reader.Pos += Size;
+      uint32_t Num;
+      if (!Sub.readU32(Num)) {
+        break;
+      }
+      for (uint32_t I = 0; I < Num; ++I) {
+        uint32_t Idx;
+        std::string_view Name;
+        if (!Sub.readU32(Idx) || !Sub.readName(Name)) {
+          break;
+        }
+        Names.insert_or_assign(Idx, std::string(Name));
+      }
+    }
+  }
+  return Names;
+}
+
+} // namespace
+
+bool Sampler::start(uint32_t Freq) noexcept {
+#if WASMEDGE_OS_LINUX
+  if (Active.load() || Freq == 0 || !enableHandler()) {
+    return false;
+  }
+  if (!Table) {
+    Table.reset(new (std::nothrow) Entry[kTableSize]);
+    if (!Table) {
+      return false;
+    }
+  }
+  for (size_t I = 0; I < kTableSize; ++I) {
+    Table[I].Ready.store(false, std::memory_order_relaxed);
+    Table[I].Count.store(0, std::memory_order_relaxed);
+    Table[I].Hash.store(0, std::memory_order_relaxed);
+  }
+  Samples.store(0);
+  Dropped.store(0);
+  Frequency.store(Freq);
+  Active.store(true, std::memory_order_release);
+  return true;
+#else
+  static_cast<void>(Freq);
+  return false;
+#endif
+}
+
+void Sampler::stop() noexcept {
+  Active.store(false, std::memory_order_release);
+  // Wait for the signal handlers still recording.
+  while (Busy.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+}
+
+bool Sampler::isActive() noexcept {
+  return Active.load(std::memory_order_relaxed);
+}
+
+uint64_t Sampler::getSampleCount() noexcept { return Samples.load(); }
+
+uint64_t Sampler::getDroppedCount() noexcept { return Dropped.load(); }
+
+void Sampler::registerModule(const Runtime::Instance::ModuleInstance &ModInst,
+                             const AST::Module &Mod) noexcept {
+  const auto Names = readFunctionNames(Mod);
+  std::map<const Runtime::Instance::FunctionInstance *, std::string_view>
+      Exports;
+  ModInst.getFuncExports([&](const auto &Funcs) {
+    for (const auto &[Name, Func] : Funcs) {
+      Exports.emplace(Func, Name);
+    }
+  });
+
+  const auto ModName = ModInst.getModuleName();
+  const auto FuncInsts = ModInst.getFunctionInstances();
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  // Name the imported functions by the import names, unless named by their
+  // own modules already.
+  uint32_t ImportNum = 0;
+  for (const auto &Desc : Mod.getImportSection().getContent()) {
+    if (Desc.getExternalType() != ExternalType::Function) {
+      continue;
+    }
+    if (ImportNum < FuncInsts.size() && FuncInsts[ImportNum]) {
+      std::string Label = fmt::format("{}::{}"sv, Desc.getModuleName(),
+                                      Desc.getExternalName());
+      std::replace(Label.begin(), Label.end(), ';', ':');
+      R.Funcs.try_emplace(FuncInsts[ImportNum], std::move(Label));
+    }
+    ++ImportNum;
+  }
+  for (uint32_t I = ImportNum; I < FuncInsts.size(); ++I) {
+    const auto *Func = FuncInsts[I];
+    if (!Func) {
+      continue;
+    }
+    std::string Label;
+    if (auto It = Names.find(I); It != Names.end()) {
+      Label = It->second;
+    } else if (auto It = Exports.find(Func); It != Exports.end()) {
+      Label = It->second;
+    } else {
+      Label = fmt::format("func[{}]"sv, I);
+    }
+    // The `;` separates the frames in the collapsed stacks.
+    std::replace(Label.begin(), Label.end(), ';', ':');
+    if (!ModName.empty()) {
+      Label = fmt::format("{}::{}"sv, ModName, Label);
+    }
+    if (Func->isCompiledFunction()) {
+      R.Symbols.emplace(
+          reinterpret_cast<uintptr_t>(Func->getFuncType().getSymbol().get()),
+          std::string());
+      R.Symbols.insert_or_assign(
+          reinterpret_cast<uintptr_t>(Func->getSymbol().get()), Label);
+    }
+    R.Funcs.insert_or_assign(Func, std::move(Label));
+  }
+}
+
+Expect<void>
+Sampler::saveCollapsed(const std::filesystem::path &Path) noexcept {
+  std::ofstream OS(Path, std::ios::out | std::ios::trunc);
+  if (!OS) {
+    spdlog::error(ErrCode::Value::IllegalPath);
+    spdlog::error(ErrInfo::InfoFile(Path));
+    return Unexpect(ErrCode::Value::IllegalPath);
+  }
+  if (!Table) {
+    return {};
+  }
+
+  auto &R = getRegistry();
+  std::unique_lock Lock(R.Mutex);
+  // Find the compiled function containing the return address.
+  const auto Resolve = [&R](void *IP) noexcept -> const std::string * {
+    auto It = R.Symbols.upper_bound(reinterpret_cast<uintptr_t>(IP) - 1);
+    if (It == R.Symbols.begin()) {
+      return nullptr;
+    }
+    --It;
+    return It->second.empty() ? nullptr : &It->second;
+  };
+
+  std::map<std::string, uint64_t> Stacks;
+  for (size_t I = 0; I < kTableSize; ++I) {
+    const auto &E = Table[I];
+    if (!E.Ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    std::vector<std::string_view> Entered;
+    for (uint32_t J = 0; J < E.FuncNum; ++J) {
+      if (auto It = R.Funcs.find(E.Funcs[J]); It != R.Funcs.end()) {
+        Entered.push_back(It->second);
+      } else {
+        Entered.push_back("[unknown]"sv);
+      }
+    }
+    // The compiled functions on the native stack from the root, including the
+    // ones called directly by the compiled code without a frame.
+    std::vector<std::string_view> Compiled;
+    for (uint32_t J = 0; J < E.IPNum; ++J) {
+      if (const auto *Label = Resolve(E.IPs[J])) {
+        Compiled.push_back(*Label);
+      }
+    }
+    std::reverse(Compiled.begin(), Compiled.end());
+
+    // Merge the two stacks. A frame found on the native stack follows the
+    // compiled functions before it, and the other frames follow the compiled
+    // functions before the next found frame.
+    std::vector<std::string_view> Frames;
+    auto Pos = Compiled.begin();
+    for (auto It = Entered.begin(); It != Entered.end(); ++It) {
+      auto Found = std::find(Pos, Compiled.end(), *It);
+      if (Found == Compiled.end()) {
+        for (auto Next = It + 1;
+             Next != Entered.end() && Found == Compiled.end(); ++Next) {
+          Found = std::find(Pos, Compiled.end(), *Next);
+        }
+        Frames.insert(Frames.end(), Pos, Found);
+        Pos = Found;
+      } else {
+        Frames.insert(Frames.end(), Pos, Found);
+        Pos = Found + 1;
+      }
+      Frames.push_back(*It);
+    }
+    Frames.insert(Frames.end(), Pos, Compiled.end());
+    if (Frames.empty()) {
+      Frames.push_back("[native]"sv);
+    }
+
+    std::string Line;
+    for (const auto &Frame : Frames) {
+      if (!Line.empty()) {
+        Line += ';';
+      }
+      Line += Frame;
+    }
+    Stacks[std::move(Line)] += E.Count.load(std::memory_order_relaxed);
+  }
+  for (const auto &[Line, Count] : Stacks) {
+    OS << Line << ' ' << Count << '\n';
+  }
+  return {};
+}
+
+Sampler::Scope::Scope(const Runtime::StackManager &StackMgr) noexcept
+    : Prev(std::exchange(LocalStack, &StackMgr)) {
+#if WASMEDGE_OS_LINUX
+  if (LocalDepth++ == 0 && Active.load(std::memory_order_relaxed)) {
+    startTimer();
+  }
+#endif
+}
+
+Sampler::Scope::~Scope() noexcept {
+#if WASMEDGE_OS_LINUX
+  if (--LocalDepth == 0) {
+    stopTimer();
+  }
+#endif
+  LocalStack = std::exchange(Prev, nullptr);
+}
+
+} // namespace WasmEdge
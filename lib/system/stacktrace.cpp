@@ -79,26 +79,11 @@ interpreterStackTrace(const Runtime::StackManager &StackMgr,
                       Span<uint32_t> Buffer) noexcept {
   size_t Index = 0;
   if (auto Module = StackMgr.getModule()) {
-    const auto FuncInsts = Module->getFunctionInstances();
-    std::map<AST::InstrView::iterator, int64_t> Funcs;
-    for (size_t I = 0; I < FuncInsts.size(); ++I) {
-      const auto &Func = FuncInsts[I];
-      if (Func && Func->isWasmFunction()) {
-        const auto &Instrs = Func->getInstrs();
-        Funcs.emplace(Instrs.end(), INT64_C(-1));
-        Funcs.emplace(Instrs.begin(), I);
-      }
-    }
+    const auto Map = Module->getCodeMap();
     for (const auto &Frame : StackMgr.getFramesSpan()) {
-      auto Entry = Frame.From;
-      auto Iter = Funcs.lower_bound(Entry);
-      if ((Iter == Funcs.end() || Iter->first > Entry) &&
-          Iter != Funcs.begin()) {
-        --Iter;
-      }
-      if (Iter != Funcs.end() && Iter->first < Entry &&
-          Iter->second >= INT64_C(0) && Index < Buffer.size()) {
-        Buffer[Index++] = static_cast<uint32_t>(Iter->second);
+      if (auto Func = Map->findInstruction(Frame.From);
+          Func && Index < Buffer.size()) {
+        Buffer[Index++] = *Func;
       }
     }
   }
@@ -114,28 +99,12 @@ Span<const uint32_t> compiledStackTrace(const Runtime::StackManager &StackMgr,
 Span<const uint32_t> compiledStackTrace(const Runtime::StackManager &StackMgr,
                                         Span<void *const> Stack,
                                         Span<uint32_t> Buffer) noexcept {
-  std::map<void *, int64_t> Funcs;
   size_t Index = 0;
   if (auto Module = StackMgr.getModule()) {
-    const auto FuncInsts = Module->getFunctionInstances();
-    for (size_t I = 0; I < FuncInsts.size(); ++I) {
-      const auto &Func = FuncInsts[I];
-      if (Func && Func->isCompiledFunction()) {
-        Funcs.emplace(
-            reinterpret_cast<void *>(Func->getFuncType().getSymbol().get()),
-            INT64_C(-1));
-        Funcs.emplace(Func->getSymbol().get(), I);
-      }
-    }
+    const auto Map = Module->getCodeMap();
     for (auto Entry : Stack) {
-      auto Iter = Funcs.lower_bound(Entry);
-      if ((Iter == Funcs.end() || Iter->first > Entry) &&
-          Iter != Funcs.begin()) {
-        --Iter;
-      }
-      if (Iter != Funcs.end() && Iter->first < Entry &&
-          Iter->second >= INT64_C(0) && Index < Buffer.size()) {
-        Buffer[Index++] = static_cast<uint32_t>(Iter->second);
+      if (auto Func = Map->findNative(Entry); Func && Index < Buffer.size()) {
+        Buffer[Index++] = *Func;
       }
     }
   }
@@ -5,7 +5,11 @@
 #include "common/spdlog.h"
 #include "validator/validator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <variant>
+#include <vector>
 
 namespace WasmEdge {
 namespace Validator {
@@ -16,6 +20,11 @@ Expect<void>
 Validator::validate(const AST::Component::Component &Comp) noexcept {
   spdlog::warn("Component Model Validation is in active development."sv);
   CompCtx.reset();
+  EXPECTED_TRY(validateCoreModules(Comp).map_error([](auto E) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Comp_Sec_CoreMod));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Component));
+    return E;
+  }));
   return validateComponent(Comp).and_then([&]() {
     const_cast<AST::Component::Component &>(Comp).setIsValidated();
     return Expect<void>{};
@@ -46,12 +55,84 @@ Validator::validateComponent(const AST::Component::Component &Comp) noexcept {
   return {};
 }
 
+Expect<void> Validator::validateCoreModules(
+    const AST::Component::Component &Comp) noexcept {
+  // The core modules do not depend on the component context, so that they
+  // are validated ahead by the workers, each with its own validator.
+  std::vector<const AST::Module *> Mods;
+  auto Collect = [&Mods](const AST::Component::Component &C,
+                         auto &Self) -> void {
+    for (const auto &Sec : C.getSections()) {
+      if (const auto *ModSec =
+              std::get_if<AST::Component::CoreModuleSection>(&Sec)) {
+        if (!ModSec->getContent().getIsValidated()) {
+          Mods.push_back(&ModSec->getContent());
+        }
+      } else if (const auto *CompSec =
+                     std::get_if<AST::Component::ComponentSection>(&Sec)) {
+        Self(CompSec->getContent(), Self);
+      }
+    }
+  };
+  Collect(Comp, Collect);
+
+  uint32_t ThreadCount = Conf.getRuntimeConfigure().getValidationThreadCount();
+  if (ThreadCount == 0) {
+    ThreadCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  const size_t Count = Mods.size();
+  if (ThreadCount <= 1 || Count <= 1) {
+    // Validated in order with the component sections.
+    return {};
+  }
+
+  // The threads are shared by the modules and their function bodies. After a
+  // failure, the workers stop claiming and the failure of the first module is
+  // reported.
+  const size_t WorkerCount = std::min<size_t>(ThreadCount, Count);
+  Configure WorkerConf(Conf);
+  WorkerConf.getRuntimeConfigure().setValidationThreadCount(
+      std::max<uint32_t>(ThreadCount / static_cast<uint32_t>(WorkerCount), 1U));
+  std::atomic<size_t> Next = 0;
+  std::atomic<size_t> FailedIdx = Count;
+  std::vector<ErrCode> Errors(Count);
+  auto Worker = [&]() {
+    Validator ModValidator(WorkerConf);
+    for (size_t I; (I = Next.fetch_add(1, std::memory_order_relaxed)) < Count &&
+                   I < FailedIdx.load(std::memory_order_relaxed);) {
+      auto Res = ModValidator.validate(*Mods[I]);
+      if (unlikely(!Res)) {
+        Errors[I] = Res.error();
+        size_t Prev = FailedIdx.load(std::memory_order_relaxed);
+        while (I < Prev && !FailedIdx.compare_exchange_weak(
+                               Prev, I, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  };
+  std::vector<std::thread> Workers;
+  Workers.reserve(WorkerCount - 1);
+  for (size_t I = 1; I < WorkerCount; ++I) {
+    Workers.emplace_back(Worker);
+  }
+  Worker();
+  for (auto &W : Workers) {
+    W.join();
+  }
+  if (const size_t I = FailedIdx.load(std::memory_order_relaxed); I < Count) {
+    return Unexpect(Errors[I]);
+  }
+  return {};
+}
+
 Expect<void>
 Validator::validate(const AST::Component::CoreModuleSection &ModSec) noexcept {
-  EXPECTED_TRY(validate(ModSec.getContent()).map_error([](auto E) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Comp_Sec_CoreMod));
-    return E;
-  }));
+  if (!ModSec.getContent().getIsValidated()) {
+    EXPECTED_TRY(validate(ModSec.getContent()).map_error([](auto E) {
+      spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Comp_Sec_CoreMod));
+      return E;
+    }));
+  }
   CompCtx.incCoreSortIndexSize(AST::Component::Sort::CoreSortType::Module);
   const_cast<AST::Module &>(ModSec.getContent()).setIsValidated();
   CompCtx.addCoreModule(ModSec.getContent());
@@ -5,6 +5,7 @@
 
 #include "common/errinfo.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <tuple>
@@ -24,19 +25,38 @@ auto logOutOfRange(ErrCode Code, ErrInfo::IndexCategory Cate, uint32_t Idx,
   return Unexpect(Code);
 }
 
+// Helper function for the size of the values moved by the variable
+// instructions. 0 for the values moved in the whole slots.
+uint32_t getValueSize(const ValType &VT) noexcept {
+  switch (VT.getCode()) {
+  case TypeCode::I32:
+  case TypeCode::F32:
+    return 4;
+  case TypeCode::I64:
+  case TypeCode::F64:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
 } // namespace
 
 void FormChecker::reset(bool CleanGlobal) {
   ValStack.clear();
   CtrlStack.clear();
+  TryStack.clear();
   Locals.clear();
+  LocalNum = 0;
+  LocalInitFlags.clear();
+  LocalInits.clear();
   Returns.clear();
 
   if (CleanGlobal) {
     Types.clear();
     Funcs.clear();
     Tables.clear();
-    Mems = 0;
+    Mems.clear();
     Globals.clear();
     Datas.clear();
     Elems.clear();
@@ -84,7 +104,10 @@ void FormChecker::addTable(const AST::TableType &Tab) {
   Tables.push_back(Tab.getRefType());
 }
 
-void FormChecker::addMemory(const AST::MemoryType &) { Mems++; }
+void FormChecker::addMemory(const AST::MemoryType &Mem) {
+  Mems.push_back(
+      ValType(Mem.getLimit().is64() ? TypeCode::I64 : TypeCode::I32));
+}
 
 void FormChecker::addGlobal(const AST::GlobalType &Glob, const bool IsImport) {
   // Type in global is confirmed in loading phase.
@@ -104,12 +127,33 @@ void FormChecker::addElem(const AST::ElementSegment &Elem) {
 
 void FormChecker::addRef(const uint32_t FuncIdx) { Refs.emplace(FuncIdx); }
 
-void FormChecker::addLocal(const ValType &V, bool Initialized) {
-  Locals.emplace_back(V);
-  if (Initialized || V.isDefaultable()) {
-    LocalInits.push_back(static_cast<uint32_t>(Locals.size() - 1));
-    Locals.back().IsInit = true;
+void FormChecker::addLocals(uint32_t Count, const ValType &V,
+                            bool Initialized) {
+  if (Count == 0) {
+    return;
   }
+  const bool AlwaysInit = Initialized || V.isDefaultable();
+  // The flags of the last group are at the end, so the locals of the same
+  // kind extend the last group.
+  if (!Locals.empty() && Locals.back().VType == V &&
+      (Locals.back().InitOffset == kInitialized) == AlwaysInit) {
+    Locals.back().End += Count;
+  } else {
+    const uint32_t InitOffset =
+        AlwaysInit ? kInitialized : static_cast<uint32_t>(LocalInitFlags.size());
+    Locals.push_back({LocalNum, LocalNum + Count, InitOffset, V});
+  }
+  if (!AlwaysInit) {
+    LocalInitFlags.resize(LocalInitFlags.size() + Count, false);
+  }
+  LocalNum += Count;
+}
+
+const FormChecker::LocalGroup &
+FormChecker::getLocalGroup(uint32_t Idx) const noexcept {
+  return *std::upper_bound(
+      Locals.begin(), Locals.end(), Idx,
+      [](uint32_t I, const LocalGroup &Group) { return I < Group.End; });
 }
 
 void FormChecker::addTag(const uint32_t TypeIdx) { Tags.push_back(TypeIdx); }
@@ -163,6 +207,25 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     }
   };
 
+  // Helper lambda for checking the tag index and getting its function type.
+  auto checkTagType =
+      [this](uint32_t Idx) -> Expect<const AST::FunctionType *> {
+    if (unlikely(Idx >= Tags.size())) {
+      return logOutOfRange(ErrCode::Value::InvalidTagIdx,
+                           ErrInfo::IndexCategory::Tag, Idx,
+                           static_cast<uint32_t>(Tags.size()));
+    }
+    // The type is checked as a function type in the tag section.
+    return &Types[Tags[Idx]]->getCompositeType().getFuncType();
+  };
+
+  // Helper lambda for getting the function type of a continuation type.
+  auto getContFuncType =
+      [this](const AST::CompositeType &CompType) -> const AST::FunctionType & {
+    // The type is checked as a function type in the type section.
+    return Types[CompType.getContTypeIndex()]->getCompositeType().getFuncType();
+  };
+
   // Helper lambda for checking and resolve the block type.
   auto checkBlockType = [this, checkDefinedType](std::vector<ValType> &Buffer,
                                                  const BlockType &BType)
@@ -198,18 +261,32 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return static_cast<uint32_t>(CtrlStack.size()) - UINT32_C(1) - N;
   };
 
+  // Helper lambda for checking memory index.
+  auto checkMemIdx = [this](uint32_t Idx) -> Expect<void> {
+    if (Idx >= Mems.size()) {
+      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
+                           ErrInfo::IndexCategory::Memory, Idx,
+                           static_cast<uint32_t>(Mems.size()));
+    }
+    return {};
+  };
+
   // Helper lambda for checking memory index and perform transformation.
-  auto checkMemAndTrans = [this,
+  auto checkMemAndTrans = [this, checkMemIdx,
                            &Instr](Span<const ValType> Take,
                                    Span<const ValType> Put) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
-      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
-    }
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
     return StackTrans(Take, Put);
   };
 
+  // Helper lambda for replacing the address operand, which is the first one
+  // taken, with the address type of the memory.
+  auto withAddrType = [this, &Instr](Span<const ValType> Take) {
+    std::vector<ValType> Result(Take.begin(), Take.end());
+    Result[0] = Mems[Instr.getTargetIndex()];
+    return Result;
+  };
+
   // Helper lambda for checking lane index and perform transformation.
   auto checkLaneAndTrans = [this,
                             &Instr](uint32_t N, Span<const ValType> Take,
@@ -223,14 +300,16 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   };
 
   // Helper lambda for checking memory alignment and perform transformation.
-  auto checkAlignAndTrans = [this, checkLaneAndTrans,
+  auto checkAlignAndTrans = [this, checkMemIdx, checkLaneAndTrans,
+                             withAddrType,
                              &Instr](uint32_t N, Span<const ValType> Take,
                                      Span<const ValType> Put,
                                      bool CheckLane = false) -> Expect<void> {
-    if (Instr.getTargetIndex() >= Mems) {
-      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
+    const bool Is64 = Mems[Instr.getTargetIndex()].getCode() == TypeCode::I64;
+    if (!Is64 && Instr.getMemoryOffset() > UINT32_MAX) {
+      spdlog::error(ErrCode::Value::InvalidMemOffset);
+      return Unexpect(ErrCode::Value::InvalidMemOffset);
     }
     auto IsAtomic = Instr.getOpCode() >= OpCode::Memory__atomic__notify &&
                     Instr.getOpCode() <= OpCode::I64__atomic__rmw32__cmpxchg_u;
@@ -249,6 +328,13 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                                           Instr.getMemoryAlign()));
       return Unexpect(ErrCode::Value::InvalidAlignment);
     }
+    if (Is64) {
+      const auto AddrTake = withAddrType(Take);
+      if (CheckLane) {
+        return checkLaneAndTrans(128 / N, AddrTake, Put);
+      }
+      return StackTrans(AddrTake, Put);
+    }
     if (CheckLane) {
       return checkLaneAndTrans(128 / N, Take, Put);
     }
@@ -278,6 +364,14 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     Jump.PCOffset = static_cast<int32_t>(CtrlStack[D].Jump - &Instr);
   };
 
+  // Helper lambda for getting the distance back to the innermost enclosing
+  // try_table instruction. The exception handlers are found by this distance
+  // from the throwing and calling instructions only when throwing.
+  auto getTryOffset = [this, &Instr]() -> uint32_t {
+    return TryStack.empty() ? 0
+                            : static_cast<uint32_t>(&Instr - TryStack.back());
+  };
+
   // Helper lambda for unpacking a value type.
   auto unpackType = [](const ValType &T) -> ValType {
     if (T.isPackType()) {
@@ -300,6 +394,9 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       case TypeCode::NullExnRef:
       case TypeCode::ExnRef:
         return TypeCode::ExnRef;
+      case TypeCode::NullContRef:
+      case TypeCode::ContRef:
+        return TypeCode::ContRef;
       case TypeCode::NullRef:
       case TypeCode::AnyRef:
       case TypeCode::EqRef:
@@ -314,6 +411,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       const auto &CompType = Types[T.getTypeIndex()]->getCompositeType();
       if (CompType.isFunc()) {
         return TypeCode::FuncRef;
+      } else if (CompType.isCont()) {
+        return TypeCode::ContRef;
       } else {
         return TypeCode::AnyRef;
       }
@@ -346,19 +445,19 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     EXPECTED_TRY(popTypes(T1));
     // For the try_table instruction, validate the handlers.
     if (Instr.getOpCode() == OpCode::Try_table) {
-      const auto &TryDesc = Instr.getTryCatch();
-      const_cast<AST::Instruction::TryDescriptor &>(TryDesc).BlockParamNum =
-          static_cast<uint32_t>(T1.size());
+      auto &TryDesc =
+          const_cast<AST::Instruction::TryDescriptor &>(Instr.getTryCatch());
+      TryDesc.StackHeight = static_cast<uint32_t>(ValStack.size());
+      TryDesc.TryOffset = getTryOffset();
       // Validate catch clause.
       for (const auto &C : TryDesc.Catch) {
         if (!C.IsAll) {
-          // Check tag index.
-          if (unlikely(C.TagIndex >= Tags.size())) {
-            return logOutOfRange(ErrCode::Value::InvalidTagIdx,
-                                 ErrInfo::IndexCategory::Tag, C.TagIndex,
-                                 static_cast<uint32_t>(Tags.size()));
+          // Check tag index. The exception tags have no results.
+          EXPECTED_TRY(auto TagFType, checkTagType(C.TagIndex));
+          if (unlikely(!TagFType->getReturnTypes().empty())) {
+            spdlog::error(ErrCode::Value::InvalidTagResultType);
+            return Unexpect(ErrCode::Value::InvalidTagResultType);
           }
-          // Result type of tag index are checked in tag section.
         }
         EXPECTED_TRY(auto D, checkCtrlStackDepth(C.LabelIndex));
         pushCtrl({}, getLabelTypes(CtrlStack[D]), &Instr + TryDesc.JumpEnd,
@@ -385,6 +484,9 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                                        ? &Instr
                                        : &Instr + Instr.getJumpEnd();
     pushCtrl(T1, T2, From, Instr.getOpCode());
+    if (Instr.getOpCode() == OpCode::Try_table) {
+      TryStack.push_back(&Instr);
+    }
     if (Instr.getOpCode() == OpCode::If &&
         Instr.getJumpElse() == Instr.getJumpEnd()) {
       // No else case in if-else statement.
@@ -400,24 +502,26 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   }
 
   case OpCode::Throw: {
-    if (unlikely(Instr.getTargetIndex() >= Tags.size())) {
-      return logOutOfRange(ErrCode::Value::InvalidTagIdx,
-                           ErrInfo::IndexCategory::Tag, Instr.getTargetIndex(),
-                           static_cast<uint32_t>(Tags.size()));
+    EXPECTED_TRY(auto TagFType, checkTagType(Instr.getTargetIndex()));
+    if (unlikely(!TagFType->getReturnTypes().empty())) {
+      spdlog::error(ErrCode::Value::InvalidTagResultType);
+      return Unexpect(ErrCode::Value::InvalidTagResultType);
     }
-    EXPECTED_TRY(auto CompType, checkDefinedType(Tags[Instr.getTargetIndex()],
-                                                 TypeCode::Func));
-    std::vector<ValType> Input = CompType->getFuncType().getParamTypes();
-    EXPECTED_TRY(popTypes(Input));
+    EXPECTED_TRY(popTypes(TagFType->getParamTypes()));
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
     return unreachable();
   }
 
   case OpCode::Throw_ref:
     EXPECTED_TRY(popType(TypeCode::ExnRef));
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
     return unreachable();
 
   case OpCode::End: {
     EXPECTED_TRY(auto Ctrl, popCtrl());
+    if (Ctrl.Code == OpCode::Try_table) {
+      TryStack.pop_back();
+    }
     pushTypes(Ctrl.EndTypes);
     return {};
   }
@@ -544,6 +648,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     // Due to validation when adding functions, Type[Funcs[N]] must be a
     // function type.
     auto &FuncType = Types[Funcs[N]]->getCompositeType().getFuncType();
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
     return StackTrans(FuncType.getParamTypes(), FuncType.getReturnTypes());
   }
   case OpCode::Call_indirect: {
@@ -564,6 +669,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     EXPECTED_TRY(auto CompType, checkDefinedType(N, TypeCode::Func));
     EXPECTED_TRY(popType(TypeCode::I32));
     const auto &FType = CompType->getFuncType();
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
     return StackTrans(FType.getParamTypes(), FType.getReturnTypes());
   }
   case OpCode::Return_call: {
@@ -611,6 +717,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     const auto &FType = CompType->getFuncType();
     std::vector<ValType> Input = FType.getParamTypes();
     Input.push_back(ValType(TypeCode::RefNull, Instr.getTargetIndex()));
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
     return StackTrans(Input, FType.getReturnTypes());
   }
   case OpCode::Return_call_ref: {
@@ -623,6 +730,131 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return unreachable();
   }
 
+  // Stack switching instructions.
+  case OpCode::Cont__new: {
+    EXPECTED_TRY(auto CompType,
+                 checkDefinedType(Instr.getTargetIndex(), TypeCode::Cont));
+    return StackTrans(
+        {ValType(TypeCode::RefNull, CompType->getContTypeIndex())},
+        {ValType(TypeCode::Ref, Instr.getTargetIndex())});
+  }
+  case OpCode::Cont__bind: {
+    EXPECTED_TRY(auto CompType1,
+                 checkDefinedType(Instr.getTargetIndex(), TypeCode::Cont));
+    EXPECTED_TRY(auto CompType2,
+                 checkDefinedType(Instr.getSourceIndex(), TypeCode::Cont));
+    // ct1 = [t1* t3*] -> [t2*] binds t1* into ct2 = [t3'*] -> [t2'*].
+    const auto &FType1 = getContFuncType(*CompType1);
+    const auto &FType2 = getContFuncType(*CompType2);
+    Span<const ValType> Params = FType1.getParamTypes();
+    if (unlikely(Params.size() < FType2.getParamTypes().size())) {
+      spdlog::error(ErrCode::Value::TypeCheckFailed);
+      spdlog::error(ErrInfo::InfoMismatch(FType1.getParamTypes(),
+                                          FType2.getParamTypes()));
+      return Unexpect(ErrCode::Value::TypeCheckFailed);
+    }
+    const auto Bound = Params.size() - FType2.getParamTypes().size();
+    EXPECTED_TRY(checkTypesMatching(Params.subspan(Bound),
+                                    FType2.getParamTypes()));
+    EXPECTED_TRY(checkTypesMatching(FType2.getReturnTypes(),
+                                    FType1.getReturnTypes()));
+    std::vector<ValType> Input(Params.begin(), Params.begin() + Bound);
+    Input.push_back(ValType(TypeCode::RefNull, Instr.getTargetIndex()));
+    return StackTrans(Input, {ValType(TypeCode::Ref, Instr.getSourceIndex())});
+  }
+  case OpCode::Suspend: {
+    EXPECTED_TRY(auto TagFType, checkTagType(Instr.getTargetIndex()));
+    // The exception of resume_throw is thrown at the suspension.
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
+    return StackTrans(TagFType->getParamTypes(), TagFType->getReturnTypes());
+  }
+  case OpCode::Resume:
+  case OpCode::Resume_throw: {
+    auto &Desc =
+        const_cast<AST::Instruction::ResumeDescriptor &>(Instr.getResume());
+    EXPECTED_TRY(auto CompType,
+                 checkDefinedType(Desc.ContTypeIndex, TypeCode::Cont));
+    const auto &FType = getContFuncType(*CompType);
+    // Pop the continuation, and the arguments or the exception.
+    EXPECTED_TRY(popType(ValType(TypeCode::RefNull, Desc.ContTypeIndex)));
+    if (Instr.getOpCode() == OpCode::Resume_throw) {
+      EXPECTED_TRY(auto TagFType, checkTagType(Desc.TagIndex));
+      if (unlikely(!TagFType->getReturnTypes().empty())) {
+        spdlog::error(ErrCode::Value::InvalidTagResultType);
+        return Unexpect(ErrCode::Value::InvalidTagResultType);
+      }
+      EXPECTED_TRY(popTypes(TagFType->getParamTypes()));
+    } else {
+      EXPECTED_TRY(popTypes(FType.getParamTypes()));
+    }
+    // Validate the handlers.
+    for (auto &Handler : Desc.Handlers) {
+      EXPECTED_TRY(auto TagFType, checkTagType(Handler.TagIndex));
+      if (Handler.IsSwitch) {
+        // The switch tag [] -> [t*] returns the results of the continuation.
+        if (unlikely(!TagFType->getParamTypes().empty())) {
+          spdlog::error(ErrCode::Value::TypeCheckFailed);
+          spdlog::error(ErrInfo::InfoMismatch({}, TagFType->getParamTypes()));
+          return Unexpect(ErrCode::Value::TypeCheckFailed);
+        }
+        EXPECTED_TRY(checkTypesMatching(FType.getReturnTypes(),
+                                        TagFType->getReturnTypes()));
+        continue;
+      }
+      // The label takes the tag parameters and the suspended continuation,
+      // which takes the tag results back and returns the same results.
+      EXPECTED_TRY(auto D, checkCtrlStackDepth(Handler.LabelIndex));
+      const auto LabelTypes = getLabelTypes(CtrlStack[D]);
+      if (unlikely(LabelTypes.empty() || !LabelTypes.back().isRefType() ||
+                   LabelTypes.back().isAbsHeapType())) {
+        spdlog::error(ErrCode::Value::TypeCheckFailed);
+        spdlog::error("    Label of the handler takes no continuation."sv);
+        return Unexpect(ErrCode::Value::TypeCheckFailed);
+      }
+      Handler.ContTypeIndex = LabelTypes.back().getTypeIndex();
+      EXPECTED_TRY(auto LabelCompType,
+                   checkDefinedType(Handler.ContTypeIndex, TypeCode::Cont));
+      const auto &LabelFType = getContFuncType(*LabelCompType);
+      EXPECTED_TRY(checkTypesMatching(LabelTypes.first(LabelTypes.size() - 1),
+                                      TagFType->getParamTypes()));
+      EXPECTED_TRY(checkTypesMatching(LabelFType.getParamTypes(),
+                                      TagFType->getReturnTypes()));
+      EXPECTED_TRY(checkTypesMatching(LabelFType.getReturnTypes(),
+                                      FType.getReturnTypes()));
+      recordJump(Handler.Jump, static_cast<uint32_t>(LabelTypes.size()), D);
+    }
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
+    pushTypes(FType.getReturnTypes());
+    return {};
+  }
+  case OpCode::Switch: {
+    EXPECTED_TRY(auto CompType1,
+                 checkDefinedType(Instr.getTargetIndex(), TypeCode::Cont));
+    EXPECTED_TRY(auto TagFType, checkTagType(Instr.getSourceIndex()));
+    // ct1 = [t1* (ref ct2)] -> [t*] takes the switching continuation of
+    // ct2 = [t2*] -> [t*], for the switch tag [] -> [t*].
+    const auto &FType1 = getContFuncType(*CompType1);
+    Span<const ValType> Params = FType1.getParamTypes();
+    if (unlikely(!TagFType->getParamTypes().empty() || Params.empty() ||
+                 !Params.back().isRefType() ||
+                 Params.back().isAbsHeapType())) {
+      spdlog::error(ErrCode::Value::TypeCheckFailed);
+      spdlog::error("    Continuation takes no switching continuation."sv);
+      return Unexpect(ErrCode::Value::TypeCheckFailed);
+    }
+    EXPECTED_TRY(auto CompType2, checkDefinedType(Params.back().getTypeIndex(),
+                                                  TypeCode::Cont));
+    const auto &FType2 = getContFuncType(*CompType2);
+    EXPECTED_TRY(checkTypesMatching(TagFType->getReturnTypes(),
+                                    FType1.getReturnTypes()));
+    EXPECTED_TRY(checkTypesMatching(FType2.getReturnTypes(),
+                                    TagFType->getReturnTypes()));
+    std::vector<ValType> Input(Params.begin(), Params.end() - 1);
+    Input.push_back(ValType(TypeCode::RefNull, Instr.getTargetIndex()));
+    const_cast<AST::Instruction &>(Instr).getTryOffset() = getTryOffset();
+    return StackTrans(Input, FType2.getParamTypes());
+  }
+
   // Reference Instructions.
   case OpCode::Ref__null: {
     EXPECTED_TRY(validate(Instr.getValType()));
@@ -1021,31 +1253,36 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Local__get:
   case OpCode::Local__set:
   case OpCode::Local__tee: {
-    if (Instr.getTargetIndex() >= Locals.size()) {
-      return logOutOfRange(
-          ErrCode::Value::InvalidLocalIdx, ErrInfo::IndexCategory::Local,
-          Instr.getTargetIndex(), static_cast<uint32_t>(Locals.size()));
+    const uint32_t Idx = Instr.getTargetIndex();
+    if (Idx >= LocalNum) {
+      return logOutOfRange(ErrCode::Value::InvalidLocalIdx,
+                           ErrInfo::IndexCategory::Local, Idx, LocalNum);
     }
-    auto &TExpect = Locals[Instr.getTargetIndex()];
+    const auto &TExpect = getLocalGroup(Idx);
     const_cast<AST::Instruction &>(Instr).getStackOffset() =
-        static_cast<uint32_t>(ValStack.size() +
-                              (Locals.size() - Instr.getTargetIndex()));
+        static_cast<uint32_t>(ValStack.size() + (LocalNum - Idx));
+    const_cast<AST::Instruction &>(Instr).getValueSize() =
+        getValueSize(TExpect.VType);
+    const uint32_t InitIdx = TExpect.InitOffset == kInitialized
+                                 ? kInitialized
+                                 : TExpect.InitOffset + (Idx - TExpect.Begin);
+    const bool IsInit = InitIdx == kInitialized || LocalInitFlags[InitIdx];
     if (Instr.getOpCode() == OpCode::Local__get) {
-      if (!TExpect.IsInit) {
+      if (!IsInit) {
         spdlog::error(ErrCode::Value::InvalidUninitLocal);
         return Unexpect(ErrCode::Value::InvalidUninitLocal);
       }
       return StackTrans({}, {TExpect.VType});
     } else if (Instr.getOpCode() == OpCode::Local__set) {
-      if (!TExpect.IsInit) {
-        TExpect.IsInit = true;
-        LocalInits.push_back(Instr.getTargetIndex());
+      if (!IsInit) {
+        LocalInitFlags[InitIdx] = true;
+        LocalInits.push_back(InitIdx);
       }
       return StackTrans({TExpect.VType}, {});
     } else if (Instr.getOpCode() == OpCode::Local__tee) {
-      if (!TExpect.IsInit) {
-        TExpect.IsInit = true;
-        LocalInits.push_back(Instr.getTargetIndex());
+      if (!IsInit) {
+        LocalInitFlags[InitIdx] = true;
+        LocalInits.push_back(InitIdx);
       }
       return StackTrans({TExpect.VType}, {TExpect.VType});
     } else {
@@ -1068,6 +1305,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
           Instr.getTargetIndex(), static_cast<uint32_t>(Globals.size()));
     }
     ValType ExpT = Globals[Instr.getTargetIndex()].first;
+    const_cast<AST::Instruction &>(Instr).getValueSize() = getValueSize(ExpT);
     if (Instr.getOpCode() == OpCode::Global__set) {
       return StackTrans({ExpT}, {});
     } else {
@@ -1212,37 +1450,44 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     return checkAlignAndTrans(
         32, {ValType(TypeCode::I32), ValType(TypeCode::I64)}, {});
   case OpCode::Memory__size:
-    return checkMemAndTrans({}, {ValType(TypeCode::I32)});
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
+    return StackTrans({}, {Mems[Instr.getTargetIndex()]});
   case OpCode::Memory__grow:
-    return checkMemAndTrans({ValType(TypeCode::I32)}, {ValType(TypeCode::I32)});
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
+    return StackTrans({Mems[Instr.getTargetIndex()]},
+                      {Mems[Instr.getTargetIndex()]});
   case OpCode::Memory__init:
     // Check the target memory index. Memory index should be checked first.
-    if (Instr.getTargetIndex() >= Mems) {
-      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getTargetIndex(), Mems);
-    }
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
     // Check the source data index.
     if (Instr.getSourceIndex() >= Datas.size()) {
       return logOutOfRange(ErrCode::Value::InvalidDataIdx,
                            ErrInfo::IndexCategory::Data, Instr.getSourceIndex(),
                            static_cast<uint32_t>(Datas.size()));
     }
-    return StackTrans({ValType(TypeCode::I32), ValType(TypeCode::I32),
+    return StackTrans({Mems[Instr.getTargetIndex()], ValType(TypeCode::I32),
                        ValType(TypeCode::I32)},
                       {});
-  case OpCode::Memory__copy:
+  case OpCode::Memory__copy: {
     /// Check the source memory index.
-    if (Instr.getSourceIndex() >= Mems) {
-      return logOutOfRange(ErrCode::Value::InvalidMemoryIdx,
-                           ErrInfo::IndexCategory::Memory,
-                           Instr.getSourceIndex(), Mems);
-    }
-    [[fallthrough]];
+    EXPECTED_TRY(checkMemIdx(Instr.getSourceIndex()));
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
+    // The length is 64-bit only if both memories are 64-bit.
+    const ValType &DstType = Mems[Instr.getTargetIndex()];
+    const ValType &SrcType = Mems[Instr.getSourceIndex()];
+    return StackTrans(
+        {DstType, SrcType,
+         DstType.getCode() == TypeCode::I64 &&
+                 SrcType.getCode() == TypeCode::I64
+             ? ValType(TypeCode::I64)
+             : ValType(TypeCode::I32)},
+        {});
+  }
   case OpCode::Memory__fill:
-    return checkMemAndTrans({ValType(TypeCode::I32), ValType(TypeCode::I32),
-                             ValType(TypeCode::I32)},
-                            {});
+    EXPECTED_TRY(checkMemIdx(Instr.getTargetIndex()));
+    return StackTrans({Mems[Instr.getTargetIndex()], ValType(TypeCode::I32),
+                       Mems[Instr.getTargetIndex()]},
+                      {});
   case OpCode::Data__drop:
     // Check the target data index.
     if (Instr.getTargetIndex() >= Datas.size()) {
@@ -2163,7 +2408,7 @@ Expect<FormChecker::CtrlFrame> FormChecker::popCtrl() {
   }
   // When popping a frame, reset the inited locals during this frame.
   for (size_t I = CtrlStack.back().InitedLocal; I < LocalInits.size(); I++) {
-    Locals[LocalInits[I]].IsInit = false;
+    LocalInitFlags[LocalInits[I]] = false;
   }
   LocalInits.erase(LocalInits.begin() +
                        static_cast<uint32_t>(CtrlStack.back().InitedLocal),
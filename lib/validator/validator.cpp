@@ -6,9 +6,13 @@
 #include "ast/section.h"
 #include "common/errinfo.h"
 #include "common/hash.h"
+#include "common/trace.h"
 
+#include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 using namespace std::literals;
@@ -63,11 +67,200 @@ checkSubtypeDepth(const uint32_t BaseIdx, uint32_t TestIdx,
   return {};
 }
 
+// Binary operators which never trap and can be the body of a super-instruction.
+bool isSuperInstrBinOp(OpCode Code) noexcept {
+  switch (Code) {
+  case OpCode::I32__eq:
+  case OpCode::I32__ne:
+  case OpCode::I32__lt_s:
+  case OpCode::I32__lt_u:
+  case OpCode::I32__gt_s:
+  case OpCode::I32__gt_u:
+  case OpCode::I32__le_s:
+  case OpCode::I32__le_u:
+  case OpCode::I32__ge_s:
+  case OpCode::I32__ge_u:
+  case OpCode::I32__add:
+  case OpCode::I32__sub:
+  case OpCode::I32__mul:
+  case OpCode::I32__and:
+  case OpCode::I32__or:
+  case OpCode::I32__xor:
+  case OpCode::I32__shl:
+  case OpCode::I32__shr_s:
+  case OpCode::I32__shr_u:
+  case OpCode::I64__add:
+  case OpCode::I64__sub:
+  case OpCode::I64__mul:
+  case OpCode::I64__and:
+  case OpCode::I64__or:
+  case OpCode::I64__xor:
+  case OpCode::I64__shl:
+  case OpCode::I64__shr_s:
+  case OpCode::I64__shr_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Annotate the heads of the fusible instruction sequences. The sequences only
+// contain straight-line instructions, so no branch can target the middle of
+// them and the jump offsets recorded in the instructions stay valid.
+void fuseSuperInstrs(AST::InstrView Instrs) noexcept {
+  using SuperInstr = AST::Instruction::SuperInstr;
+  size_t I = 0;
+  while (I + 2 < Instrs.size()) {
+    auto &Head = const_cast<AST::Instruction &>(Instrs[I]);
+    const auto &Second = Instrs[I + 1];
+    const auto &Third = Instrs[I + 2];
+    Head.setSuperInstr(SuperInstr::None);
+    if (Head.getOpCode() != OpCode::Local__get ||
+        !isSuperInstrBinOp(Third.getOpCode())) {
+      I++;
+      continue;
+    }
+    const bool WithSet = I + 3 < Instrs.size() &&
+                         Instrs[I + 3].getOpCode() == OpCode::Local__set;
+    if (Second.getOpCode() == OpCode::Local__get) {
+      Head.setSuperInstr(WithSet ? SuperInstr::LocalLocalBinOpSet
+                                 : SuperInstr::LocalLocalBinOp);
+    } else if (Second.getOpCode() == OpCode::I32__const ||
+               Second.getOpCode() == OpCode::I64__const) {
+      Head.setSuperInstr(WithSet ? SuperInstr::LocalConstBinOpSet
+                                 : SuperInstr::LocalConstBinOp);
+    } else {
+      I++;
+      continue;
+    }
+    I += WithSet ? 4 : 3;
+  }
+}
+
+// Validate a function body with the module context in the checker.
+Expect<void>
+validateFunctionBody(FormChecker &Checker, const uint32_t TypeIdx,
+                     Span<const std::pair<uint32_t, ValType>> Locals,
+                     AST::InstrView Instrs, bool FuseSuperInstrs) {
+  // Due to the validation of the function section, the type of index bust be a
+  // function type.
+  const auto &FuncType =
+      Checker.getTypes()[TypeIdx]->getCompositeType().getFuncType();
+  // Reset stack in FormChecker.
+  Checker.reset();
+  // Add parameters into this frame.
+  for (auto &Type : FuncType.getParamTypes()) {
+    // Local passed by function parameters must have been initialized.
+    Checker.addLocal(Type, true);
+  }
+  // Add locals into this frame by the groups of the same type.
+  for (auto Val : Locals) {
+    if (Val.first == 0) {
+      continue;
+    }
+    // The local value type should be valid.
+    EXPECTED_TRY(Checker.validate(Val.second));
+    Checker.addLocals(Val.first, Val.second, false);
+  }
+  // Validate function body expression.
+  EXPECTED_TRY(Checker.validate(Instrs, FuncType.getReturnTypes())
+                   .map_error([](auto E) {
+                     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
+                     return E;
+                   }));
+  // Lower the validated function body for the interpreter.
+  if (FuseSuperInstrs) {
+    fuseSuperInstrs(Instrs);
+  }
+  return {};
+}
+
 } // namespace
 
 // Validate Module. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Module &Mod) {
   // https://webassembly.github.io/spec/core/valid/modules.html
+  Trace::Scope TraceScope("validator"sv, "validate"sv);
+  EXPECTED_TRY(validateContexts(Mod));
+
+  // Validate data section which initialize memories.
+  EXPECTED_TRY(validate(Mod.getDataSection()).map_error([](auto E) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Data));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return E;
+  }));
+
+  // Validate code section and expressions.
+  EXPECTED_TRY(validate(Mod.getCodeSection()).map_error([](auto E) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return E;
+  }));
+
+  // Multiple tables is for the ReferenceTypes proposal.
+  if (Checker.getTables().size() > 1 &&
+      !Conf.hasProposal(Proposal::ReferenceTypes)) {
+    spdlog::error(ErrCode::Value::MultiTables);
+    spdlog::error(ErrInfo::InfoProposal(Proposal::ReferenceTypes));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::MultiTables);
+  }
+
+  // Multiple memories is for the MultiMemories proposal.
+  if (Checker.getMemories().size() > 1 &&
+      !Conf.hasProposal(Proposal::MultiMemories)) {
+    spdlog::error(ErrCode::Value::MultiMemories);
+    spdlog::error(ErrInfo::InfoProposal(Proposal::MultiMemories));
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
+    return Unexpect(ErrCode::Value::MultiMemories);
+  }
+
+  // Set the validated flag.
+  const_cast<AST::Module &>(Mod).setIsValidated();
+  return {};
+}
+
+// Validate the sections before the code section. See
+// "include/validator/validator.h".
+Expect<void> Validator::validateBeforeCode(const AST::Module &Mod) {
+  EXPECTED_TRY(validateContexts(Mod));
+  // The data segments are after the code section, so only their count is
+  // registered for the function bodies.
+  if (const auto &Count = Mod.getDataCountSection().getContent()) {
+    const AST::DataSegment Placeholder;
+    for (uint32_t I = 0; I < *Count; ++I) {
+      Checker.addData(Placeholder);
+    }
+  }
+  NextBody = 0;
+  return {};
+}
+
+// Validate the decoded function body. See "include/validator/validator.h".
+Expect<void> Validator::validateNextBody(AST::CodeSegment &CodeSeg) {
+  const auto &FuncVec = Checker.getFunctions();
+  const uint32_t TId =
+      NextBody++ + static_cast<uint32_t>(Checker.getNumImportFuncs());
+  if (TId >= static_cast<uint32_t>(FuncVec.size())) {
+    // The mismatched function and code sections are malformed, which is
+    // reported by the loader after the code section.
+    return {};
+  }
+  EXPECTED_TRY(validateFunctionBody(
+                   Checker, FuncVec[TId], CodeSeg.getLocals(),
+                   CodeSeg.getExpr().getInstrs(),
+                   Conf.getRuntimeConfigure().isEnableSuperInstructions())
+                   .map_error([](auto E) {
+                     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+                     return E;
+                   }));
+  CodeSeg.setValidated();
+  return {};
+}
+
+// Validate and register the sections before the code section. See
+// "include/validator/validator.h".
+Expect<void> Validator::validateContexts(const AST::Module &Mod) {
   Checker.reset(true);
 
   // Validate and register type section.
@@ -139,40 +332,6 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
     return E;
   }));
-
-  // Validate data section which initialize memories.
-  EXPECTED_TRY(validate(Mod.getDataSection()).map_error([](auto E) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Data));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return E;
-  }));
-
-  // Validate code section and expressions.
-  EXPECTED_TRY(validate(Mod.getCodeSection()).map_error([](auto E) {
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Sec_Code));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return E;
-  }));
-
-  // Multiple tables is for the ReferenceTypes proposal.
-  if (Checker.getTables().size() > 1 &&
-      !Conf.hasProposal(Proposal::ReferenceTypes)) {
-    spdlog::error(ErrCode::Value::MultiTables);
-    spdlog::error(ErrInfo::InfoProposal(Proposal::ReferenceTypes));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(ErrCode::Value::MultiTables);
-  }
-
-  // Multiple memories is for the MultiMemories proposal.
-  if (Checker.getMemories() > 1 && !Conf.hasProposal(Proposal::MultiMemories)) {
-    spdlog::error(ErrCode::Value::MultiMemories);
-    spdlog::error(ErrInfo::InfoProposal(Proposal::MultiMemories));
-    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Module));
-    return Unexpect(ErrCode::Value::MultiMemories);
-  }
-
-  // Set the validated flag.
-  const_cast<AST::Module &>(Mod).setIsValidated();
   return {};
 }
 
@@ -203,6 +362,21 @@ Expect<void> Validator::validate(const AST::SubType &Type) {
         return E;
       }));
     }
+  } else if (CompType.isCont()) {
+    // The continuation type refers to a function type.
+    const auto TId = CompType.getContTypeIndex();
+    if (unlikely(TId >= TypeVec.size())) {
+      spdlog::error(ErrCode::Value::InvalidFuncTypeIdx);
+      spdlog::error(
+          ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::FunctionType, TId,
+                                   static_cast<uint32_t>(TypeVec.size())));
+      return Unexpect(ErrCode::Value::InvalidFuncTypeIdx);
+    }
+    if (unlikely(!TypeVec[TId]->getCompositeType().isFunc())) {
+      spdlog::error(ErrCode::Value::InvalidFuncTypeIdx);
+      spdlog::error("    Defined type index {} is not a function type."sv, TId);
+      return Unexpect(ErrCode::Value::InvalidFuncTypeIdx);
+    }
   } else {
     const auto &FTypes = CompType.getFieldTypes();
     for (auto &FieldType : FTypes) {
@@ -284,15 +458,13 @@ Expect<void> Validator::validate(const AST::MemoryType &Mem) {
     spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Type_Limit));
     return E;
   }));
-  if (Lim.getMin() > LIMIT_MEMORYTYPE ||
-      (Lim.hasMax() && Lim.getMax() > LIMIT_MEMORYTYPE)) {
-    // TODO: MEMORY64 - fully support implementation.
-    ErrCode::Value FailCode = Conf.hasProposal(Proposal::Memory64)
-                                  ? ErrCode::Value::InvalidMemPages64
-                                  : ErrCode::Value::InvalidMemPages;
-    spdlog::error(FailCode);
+  // The page counts of the 64-bit memories are saturated to 32 bits in
+  // loading, which are under the limit of 2^48 pages.
+  if (!Lim.is64() && (Lim.getMin() > LIMIT_MEMORYTYPE ||
+                      (Lim.hasMax() && Lim.getMax() > LIMIT_MEMORYTYPE))) {
+    spdlog::error(ErrCode::Value::InvalidMemPages);
     spdlog::error(ErrInfo::InfoLimit(Lim.hasMax(), Lim.getMin(), Lim.getMax()));
-    return Unexpect(FailCode);
+    return Unexpect(ErrCode::Value::InvalidMemPages);
   }
   return {};
 }
@@ -405,32 +577,39 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 // Validate Code segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
-  // Due to the validation of the function section, the type of index bust be a
-  // function type.
-  const auto &FuncType =
-      Checker.getTypes()[TypeIdx]->getCompositeType().getFuncType();
-  // Reset stack in FormChecker.
-  Checker.reset();
-  // Add parameters into this frame.
-  for (auto &Type : FuncType.getParamTypes()) {
-    // Local passed by function parameters must have been initialized.
-    Checker.addLocal(Type, true);
-  }
-  // Add locals into this frame.
-  for (auto Val : CodeSeg.getLocals()) {
-    for (uint32_t Cnt = 0; Cnt < Val.first; ++Cnt) {
-      // The local value type should be valid.
-      EXPECTED_TRY(Checker.validate(Val.second));
-      Checker.addLocal(Val.second, false);
+  const bool FuseSuperInstrs =
+      Conf.getRuntimeConfigure().isEnableSuperInstructions();
+  if (const auto &Body = CodeSeg.getLazyBody();
+      Body && !Body->isMaterialized()) {
+    // For the lazy loading mode, validate the function body at first use with
+    // a snapshot of the module context.
+    if (!LazyCtx) {
+      LazyCtx = std::make_shared<LazyContext>(Checker);
+      std::vector<const AST::SubType *> Types;
+      Types.reserve(Checker.getTypes().size());
+      for (const auto *Type : Checker.getTypes()) {
+        LazyCtx->Types.push_back(std::make_unique<const AST::SubType>(*Type));
+        Types.push_back(LazyCtx->Types.back().get());
+      }
+      LazyCtx->Checker.setTypes(std::move(Types));
     }
+    Body->setValidator(
+        [Ctx = LazyCtx, TypeIdx, FuseSuperInstrs,
+         Locals = std::vector<std::pair<uint32_t, ValType>>(
+             CodeSeg.getLocals().begin(), CodeSeg.getLocals().end())](
+            Span<const Byte>, AST::Expression &Expr) -> Expect<void> {
+          std::unique_lock Lock(Ctx->Mutex);
+          return validateFunctionBody(Ctx->Checker, TypeIdx, Locals,
+                                      Expr.getInstrs(), FuseSuperInstrs)
+              .map_error([](auto E) {
+                spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+                return E;
+              });
+        });
+    return {};
   }
-  // Validate function body expression.
-  return Checker
-      .validate(CodeSeg.getExpr().getInstrs(), FuncType.getReturnTypes())
-      .map_error([](auto E) {
-        spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
-        return E;
-      });
+  return validateFunctionBody(Checker, TypeIdx, CodeSeg.getLocals(),
+                              CodeSeg.getExpr().getInstrs(), FuseSuperInstrs);
 }
 
 // Validate Data segment. See "include/validator/validator.h".
@@ -438,16 +617,17 @@ Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
   switch (DataSeg.getMode()) {
   case AST::DataSegment::DataMode::Active: {
     // Check memory index in context.
-    const auto &MemNum = Checker.getMemories();
-    if (DataSeg.getIdx() >= MemNum) {
+    const auto &Mems = Checker.getMemories();
+    if (DataSeg.getIdx() >= Mems.size()) {
       spdlog::error(ErrCode::Value::InvalidMemoryIdx);
-      spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory,
-                                             DataSeg.getIdx(), MemNum));
+      spdlog::error(ErrInfo::InfoForbidIndex(
+          ErrInfo::IndexCategory::Memory, DataSeg.getIdx(),
+          static_cast<uint32_t>(Mems.size())));
       return Unexpect(ErrCode::Value::InvalidMemoryIdx);
     }
-    // Check memory initialization is a const expression.
+    // Check memory initialization is a const expression of the address type.
     return validateConstExpr(DataSeg.getExpr().getInstrs(),
-                             {ValType(TypeCode::I32)})
+                             {Mems[DataSeg.getIdx()]})
         .map_error([](auto E) {
           spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Expression));
           return E;
@@ -524,7 +704,10 @@ Expect<void> Validator::validate(const AST::ImportDesc &ImpDesc) {
                     TagTypeIdx);
       return Unexpect(ErrCode::Value::InvalidTagIdx);
     }
-    if (!CompType.getFuncType().getReturnTypes().empty()) {
+    // The tags of the stack switching may have results, which are checked at
+    // the throwing instructions instead.
+    if (!Conf.hasProposal(Proposal::StackSwitching) &&
+        !CompType.getFuncType().getReturnTypes().empty()) {
       spdlog::error(ErrCode::Value::InvalidTagResultType);
       return Unexpect(ErrCode::Value::InvalidTagResultType);
     }
@@ -570,10 +753,11 @@ Expect<void> Validator::validate(const AST::ExportDesc &ExpDesc) {
     }
     return {};
   case ExternalType::Memory:
-    if (Id >= Checker.getMemories()) {
+    if (Id >= Checker.getMemories().size()) {
       spdlog::error(ErrCode::Value::InvalidMemoryIdx);
-      spdlog::error(ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Memory, Id,
-                                             Checker.getMemories()));
+      spdlog::error(ErrInfo::InfoForbidIndex(
+          ErrInfo::IndexCategory::Memory, Id,
+          static_cast<uint32_t>(Checker.getMemories().size())));
       return Unexpect(ErrCode::Value::InvalidMemoryIdx);
     }
     return {};
@@ -726,7 +910,15 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
   const auto &CodeVec = CodeSec.getContent();
   const auto &FuncVec = Checker.getFunctions();
 
-  // Validate function body.
+  uint32_t ThreadCount = Conf.getRuntimeConfigure().getValidationThreadCount();
+  if (ThreadCount == 0) {
+    ThreadCount = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  // Validate function body. In the multithreaded mode, the eagerly loaded
+  // bodies are collected and validated by the workers later.
+  std::vector<uint32_t> ParallelIds;
+  LazyCtx.reset();
   for (uint32_t Id = 0; Id < static_cast<uint32_t>(CodeVec.size()); ++Id) {
     // Added functions contains imported functions.
     uint32_t TId = Id + static_cast<uint32_t>(Checker.getNumImportFuncs());
@@ -737,11 +929,67 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
                                    static_cast<uint32_t>(FuncVec.size())));
       return Unexpect(ErrCode::Value::InvalidFuncIdx);
     }
+    if (CodeVec[Id].isValidated()) {
+      // The body restored from the validated code cache, or validated when
+      // decoded in the fused mode.
+      continue;
+    }
+    if (ThreadCount > 1 && !CodeVec[Id].getLazyBody()) {
+      ParallelIds.push_back(Id);
+      continue;
+    }
     EXPECTED_TRY(validate(CodeVec[Id], FuncVec[TId]).map_error([](auto E) {
       spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
       return E;
     }));
   }
+  LazyCtx.reset();
+  if (ParallelIds.empty()) {
+    return {};
+  }
+
+  // Each worker validates the claimed bodies with its own copy of the checker.
+  // The module contexts in the checker are read-only here. After a failure,
+  // the workers stop claiming and the failure of the smallest function index
+  // is reported.
+  const bool FuseSuperInstrs =
+      Conf.getRuntimeConfigure().isEnableSuperInstructions();
+  const size_t Count = ParallelIds.size();
+  std::atomic<size_t> Next = 0;
+  std::atomic<size_t> FailedIdx = Count;
+  std::vector<ErrCode> Errors(Count);
+  auto Worker = [&](FormChecker LocalChecker) {
+    for (size_t I; (I = Next.fetch_add(1, std::memory_order_relaxed)) < Count &&
+                   I < FailedIdx.load(std::memory_order_relaxed);) {
+      const uint32_t Id = ParallelIds[I];
+      const uint32_t TId =
+          Id + static_cast<uint32_t>(Checker.getNumImportFuncs());
+      auto Res = validateFunctionBody(
+          LocalChecker, FuncVec[TId], CodeVec[Id].getLocals(),
+          CodeVec[Id].getExpr().getInstrs(), FuseSuperInstrs);
+      if (unlikely(!Res)) {
+        Errors[I] = Res.error();
+        size_t Prev = FailedIdx.load(std::memory_order_relaxed);
+        while (I < Prev && !FailedIdx.compare_exchange_weak(
+                               Prev, I, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  };
+  std::vector<std::thread> Workers;
+  const size_t WorkerCount = std::min<size_t>(ThreadCount, Count);
+  Workers.reserve(WorkerCount - 1);
+  for (size_t I = 1; I < WorkerCount; ++I) {
+    Workers.emplace_back(Worker, Checker);
+  }
+  Worker(Checker);
+  for (auto &W : Workers) {
+    W.join();
+  }
+  if (const size_t I = FailedIdx.load(std::memory_order_relaxed); I < Count) {
+    spdlog::error(ErrInfo::InfoAST(ASTNodeAttr::Seg_Code));
+    return Unexpect(Errors[I]);
+  }
   return {};
 }
 
@@ -828,7 +1076,8 @@ Expect<void> Validator::validate(const AST::TagSection &TagSec) {
                     TagTypeIdx);
       return Unexpect(ErrCode::Value::InvalidTagIdx);
     }
-    if (!CompType.getFuncType().getReturnTypes().empty()) {
+    if (!Conf.hasProposal(Proposal::StackSwitching) &&
+        !CompType.getFuncType().getReturnTypes().empty()) {
       spdlog::error(ErrCode::Value::InvalidTagResultType);
       return Unexpect(ErrCode::Value::InvalidTagResultType);
     }
@@ -3,11 +3,19 @@
 
 #include "vm/vm.h"
 
+#include "aot/cache.h"
+#include "aot/version.h"
 #include "ast/module.h"
+#include "common/defines.h"
 #include "common/errcode.h"
+#include "common/hash.h"
+#include "common/reclaimer.h"
 #include "common/types.h"
 #include "host/wasi/wasimodule.h"
+#include "loader/serialize.h"
+#include "loader/shared_library.h"
 #include "plugin/plugin.h"
+#include "llvm/codegen.h"
 #include "llvm/compiler.h"
 #include "llvm/jit.h"
 
@@ -20,7 +28,10 @@
 #include "host/mock/wasmedge_tensorflow_module.h"
 #include "host/mock/wasmedge_tensorflowlite_module.h"
 #include "validator/validator.h"
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <variant>
 
 namespace WasmEdge {
@@ -50,6 +61,10 @@ std::unique_ptr<Runtime::Instance::ModuleInstance>
 createPluginModule(std::string_view PName, std::string_view MName) {
   using namespace std::literals::string_view_literals;
   if (const auto *Plugin = Plugin::Plugin::find(PName)) {
+    if (!Plugin->isLoaded() && Plugin->hasModule(MName)) {
+      // The deferred plugin is loaded when the module is imported.
+      return nullptr;
+    }
     if (const auto *Module = Plugin->findModule(MName)) {
       return Module->create();
     }
@@ -58,6 +73,147 @@ createPluginModule(std::string_view PName, std::string_view MName) {
                 PName, MName);
   return std::make_unique<T>();
 }
+
+#ifdef WASMEDGE_USE_LLVM
+/// Time waited for another process compiling the same module into the JIT
+/// cache.
+static inline constexpr const std::chrono::seconds kJITCacheWait{60};
+
+/// Load the shared library of the module compiled by an earlier run from the
+/// AOT cache, or compile it into the cache and load it. Return nullptr when
+/// the module should be compiled in memory instead.
+std::shared_ptr<Executable> loadJITCache(const Configure &Conf,
+                                         const AST::Module &Mod,
+                                         Span<const Byte> Code) noexcept {
+  using namespace std::literals::string_view_literals;
+  using AOT::Cache;
+  auto Path = Cache::getPath(Code, Conf, Cache::StorageScope::Local, "jit"sv);
+  if (!Path) {
+    return nullptr;
+  }
+  // Keep the extension, which some loaders append when missing.
+  *Path += WASMEDGE_LIB_EXTENSION;
+  auto LoadCached = [&Path]() -> std::shared_ptr<Executable> {
+    std::error_code Error;
+    if (!std::filesystem::is_regular_file(*Path, Error)) {
+      return nullptr;
+    }
+    auto Library = std::make_shared<Loader::SharedLibrary>();
+    if (!Library->load(*Path)) {
+      return nullptr;
+    }
+    if (auto Version = Library->getVersion();
+        !Version || *Version != AOT::kBinaryVersion) {
+      return nullptr;
+    }
+    Cache::touch(*Path);
+    return Library;
+  };
+
+  if (auto Library = LoadCached()) {
+    spdlog::info("JIT cache hit, load the compiled module."sv);
+    return Library;
+  }
+  auto Lock = Cache::Lock::acquire(*Path, kJITCacheWait);
+  if (auto Library = LoadCached()) {
+    return Library;
+  }
+  if (!Lock.owns()) {
+    return nullptr;
+  }
+
+  // Compile the shared library like wasmedgec, written through a temporary
+  // file so that the other processes never load a partial one.
+  Configure CodeConf(Conf);
+  CodeConf.getCompilerConfigure().setOutputFormat(
+      CompilerConfigure::OutputFormat::Native);
+  auto TempPath = *Path;
+  TempPath += fmt::format(".{:016x}.tmp"sv, Hash::RandEngine());
+  LLVM::Compiler Compiler(CodeConf);
+  auto Res = Compiler.checkConfigure()
+                 .and_then([&]() { return Compiler.compile(Mod); })
+                 .and_then([&](auto Data) {
+                   LLVM::CodeGen CodeGen(CodeConf);
+                   return CodeGen.codegen(Code, std::move(Data), TempPath);
+                 });
+  std::error_code Error;
+  if (Res) {
+    std::filesystem::rename(TempPath, *Path, Error);
+  }
+  if (!Res || Error) {
+    std::filesystem::remove(TempPath, Error);
+    spdlog::warn("Failed to store the JIT cache, compile in memory."sv);
+    return nullptr;
+  }
+  Cache::evict(Path->parent_path());
+  return LoadCached();
+}
+
+/// JIT compile the module and install the compiled entries into the native
+/// wasm functions of its module instance.
+void tierUp(const Configure &Conf, const AST::Module &Mod,
+            const Runtime::Instance::ModuleInstance &ModInst) {
+  using namespace std::literals::string_view_literals;
+  std::shared_ptr<Executable> Exec;
+  if (Conf.getRuntimeConfigure().isEnableJITCache()) {
+    if (auto Code = Loader::Serializer(Conf).serializeModule(Mod)) {
+      Exec = loadJITCache(Conf, Mod, *Code);
+    }
+  }
+  if (!Exec) {
+    LLVM::Compiler Compiler(Conf);
+    auto Res =
+        Compiler.checkConfigure()
+            .and_then([&]() { return Compiler.compile(Mod); })
+            .and_then([&](auto LLModule) {
+              LLVM::JIT JIT(Conf);
+              return JIT.load(std::move(LLModule));
+            });
+    if (!Res) {
+      spdlog::warn("Tiered JIT failed. Error code: {}, keep running in "
+                   "interpreter mode."sv,
+                   Res.error());
+      return;
+    }
+    Exec = std::move(*Res);
+  }
+
+  uint32_t ImportFuncNum = 0;
+  for (const auto &ImpDesc : Mod.getImportSection().getContent()) {
+    if (ImpDesc.getExternalType() == ExternalType::Function) {
+      ++ImportFuncNum;
+    }
+  }
+  const auto CodeNum = Mod.getCodeSection().getContent().size();
+  auto Types = Exec->getTypes(Mod.getTypeSection().getContent().size());
+  auto Codes = Exec->getCodes(ImportFuncNum, CodeNum);
+  auto Intrinsics = Exec->getIntrinsics();
+  if (unlikely(!Intrinsics)) {
+    spdlog::warn("Tiered JIT failed. Intrinsics table symbol not found, keep "
+                 "running in interpreter mode."sv);
+    return;
+  }
+  // The intrinsics must be set before any compiled entry is published.
+  *Intrinsics = &Executor::Executor::Intrinsics;
+
+  auto Funcs = ModInst.getFunctionInstances();
+  uint32_t Promoted = 0;
+  for (size_t I = 0; I < CodeNum && ImportFuncNum + I < Funcs.size(); ++I) {
+    const auto *Func = Funcs[ImportFuncNum + I];
+    const auto TypeIdx = Func->getTypeIndex();
+    if (!Func->isWasmFunction() || Func->getModule() != &ModInst ||
+        !Codes[I] || TypeIdx >= Types.size() || !Types[TypeIdx]) {
+      continue;
+    }
+    Func->setTieredEntry(
+        std::make_unique<Runtime::Instance::FunctionInstance::TieredEntry>(
+            Runtime::Instance::FunctionInstance::TieredEntry{
+                Types[TypeIdx], std::move(Codes[I])}));
+    ++Promoted;
+  }
+  spdlog::info("Tiered JIT: {} functions promoted."sv, Promoted);
+}
+#endif
 } // namespace
 
 VM::VM(const Configure &Conf)
@@ -75,6 +231,8 @@ VM::VM(const Configure &Conf, Runtime::StoreManager &S)
   unsafeInitVM();
 }
 
+VM::~VM() { unsafeStopTierUp(); }
+
 void VM::unsafeInitVM() {
   // Load the built-in modules and the plug-ins.
   unsafeLoadBuiltInHosts();
@@ -83,6 +241,34 @@ void VM::unsafeInitVM() {
   // Register all module instances.
   unsafeRegisterBuiltInHosts();
   unsafeRegisterPlugInHosts();
+
+  // The loaded modules are validated by the same VM, so the loader can
+  // validate the function bodies when decoded in the fused mode.
+  LoaderEngine.setFusedValidator(
+      {[this](const AST::Module &Mod) {
+         return ValidatorEngine.validateBeforeCode(Mod);
+       },
+       [this](AST::CodeSegment &CodeSeg) {
+         return ValidatorEngine.validateNextBody(CodeSeg);
+       }});
+
+#ifdef WASMEDGE_USE_LLVM
+  ExecutorEngine.registerTierUpFunction(
+      [this](const Runtime::Instance::ModuleInstance &ModInst) {
+        requestTierUp(ModInst);
+      });
+  // The validated code cache is keyed by the BLAKE3 hash like the AOT cache.
+  LoaderEngine.setCodeCacheKey([this](Span<const Byte> Code,
+                                      const std::filesystem::path &File) {
+    auto Path = AOT::Cache::getPath(Code, File, Conf,
+                                    AOT::Cache::StorageScope::Local,
+                                    "validated"sv);
+    if (Path) {
+      AOT::Cache::touch(*Path);
+    }
+    return Path;
+  });
+#endif
 }
 
 void VM::unsafeLoadBuiltInHosts() {
@@ -90,8 +276,11 @@ void VM::unsafeLoadBuiltInHosts() {
   // TODO: This will be extended for the versionlized WASI in the future.
   BuiltInModInsts.clear();
   if (Conf.hasHostRegistration(HostRegistration::Wasi)) {
-    std::unique_ptr<Runtime::Instance::ModuleInstance> WasiMod =
-        std::make_unique<Host::WasiModule>();
+    auto WasiMod = std::make_unique<Host::WasiModule>();
+    WasiMod->setEnablePathCache(
+        Conf.getRuntimeConfigure().isEnableWasiPathCache());
+    WasiMod->setEnableIOStatistics(
+        Conf.getStatisticsConfigure().isIOMeasuring());
     BuiltInModInsts.insert({HostRegistration::Wasi, std::move(WasiMod)});
   }
 }
@@ -131,6 +320,9 @@ void VM::unsafeLoadPlugInHosts() {
   PlugInModInsts.push_back(
       createPluginModule<Host::WasmEdgeStableDiffusionModuleMock>(
           "wasmedge_stablediffusion"sv, "wasmedge_stablediffusion"sv));
+  PlugInModInsts.erase(
+      std::remove(PlugInModInsts.begin(), PlugInModInsts.end(), nullptr),
+      PlugInModInsts.end());
 
   // Load the other non-official plugins.
   for (const auto &Plugin : Plugin::Plugin::plugins()) {
@@ -148,6 +340,11 @@ void VM::unsafeLoadPlugInHosts() {
         Plugin.name() == "wasmedge_stablediffusion"sv) {
       continue;
     }
+    // The deferred plugins are loaded when their modules are imported. The
+    // components are not resolved lazily.
+    if (!Plugin.isLoaded() && !Plugin.hasComponents()) {
+      continue;
+    }
     for (const auto &Module : Plugin.modules()) {
       PlugInModInsts.push_back(Module.create());
     }
@@ -174,6 +371,31 @@ void VM::unsafeRegisterPlugInHosts() {
   }
 }
 
+Expect<void> VM::unsafeLoadDeferredPlugInHosts(const AST::Module &Module) {
+  for (const auto &ImpDesc : Module.getImportSection().getContent()) {
+    const auto ModName = ImpDesc.getModuleName();
+    if (StoreRef.findModule(ModName)) {
+      continue;
+    }
+    for (const auto &Plugin : Plugin::Plugin::plugins()) {
+      if (!Plugin.hasModule(ModName) ||
+          Conf.isForbiddenPlugins(Plugin.name())) {
+        continue;
+      }
+      if (const auto *PMod = Plugin.findModule(ModName)) {
+        auto &ModInst = PlugInModInsts.emplace_back(PMod->create());
+        if (ModInst) {
+          EXPECTED_TRY(ExecutorEngine.registerModule(StoreRef, *ModInst));
+        } else {
+          PlugInModInsts.pop_back();
+        }
+      }
+      break;
+    }
+  }
+  return {};
+}
+
 Expect<void> VM::unsafeRegisterModule(std::string_view Name,
                                       const std::filesystem::path &Path) {
   if (Stage == VMStage::Instantiated) {
@@ -207,6 +429,7 @@ Expect<void> VM::unsafeRegisterModule(std::string_view Name,
   }
   // Validate module.
   EXPECTED_TRY(ValidatorEngine.validate(Module));
+  EXPECTED_TRY(unsafeLoadDeferredPlugInHosts(Module));
   // Instantiate and register module.
   EXPECTED_TRY(auto ModInst,
                ExecutorEngine.registerModule(StoreRef, Module, Name));
@@ -296,8 +519,10 @@ VM::unsafeRunWasmFile(const AST::Module &Module, std::string_view Func,
     Stage = VMStage::Validated;
   }
   EXPECTED_TRY(ValidatorEngine.validate(Module));
+  unsafeStopTierUp();
   EXPECTED_TRY(ActiveModInst,
                ExecutorEngine.instantiateModule(StoreRef, Module));
+  TierUpMod = (&Module == Mod.get()) ? Mod.get() : nullptr;
 
   // Get module instance.
   if (ActiveModInst) {
@@ -361,6 +586,7 @@ Expect<void> VM::unsafeLoadWasm(const std::filesystem::path &Path) {
   std::visit(VisitUnit<void>([&](auto &M) -> void { Mod = std::move(M); },
                              [&](auto &C) -> void { Comp = std::move(C); }),
              ComponentOrModule);
+  TierUpMod = nullptr;
   Stage = VMStage::Loaded;
   return {};
 }
@@ -372,12 +598,27 @@ Expect<void> VM::unsafeLoadWasm(Span<const Byte> Code) {
   std::visit(VisitUnit<void>([&](auto &M) -> void { Mod = std::move(M); },
                              [&](auto &C) -> void { Comp = std::move(C); }),
              ComponentOrModule);
+  TierUpMod = nullptr;
+  Stage = VMStage::Loaded;
+  return {};
+}
+
+Expect<void> VM::unsafeLoadWasm(std::shared_ptr<CodeStream> Code) {
+  // If not load successfully, the previous status will be reserved.
+  EXPECTED_TRY(auto ComponentOrModule,
+               LoaderEngine.parseWasmUnit(std::move(Code)));
+
+  std::visit(VisitUnit<void>([&](auto &M) -> void { Mod = std::move(M); },
+                             [&](auto &C) -> void { Comp = std::move(C); }),
+             ComponentOrModule);
+  TierUpMod = nullptr;
   Stage = VMStage::Loaded;
   return {};
 }
 
 Expect<void> VM::unsafeLoadWasm(const AST::Module &Module) {
   Mod = std::make_unique<AST::Module>(Module);
+  TierUpMod = nullptr;
   Stage = VMStage::Loaded;
   return {};
 }
@@ -406,6 +647,16 @@ Expect<void> VM::unsafeValidate() {
 
   if (Mod) {
     EXPECTED_TRY(ValidatorEngine.validate(*Mod.get()));
+    if (!Mod->getCodeCachePath().empty()) {
+      if (auto Res = LoaderEngine.saveCodeCache(*Mod); !Res) {
+        spdlog::warn("Failed to save the code cache. Error code: {}"sv,
+                     Res.error());
+      }
+#ifdef WASMEDGE_USE_LLVM
+      AOT::Cache::evict(Mod->getCodeCachePath().parent_path());
+#endif
+      Mod->setCodeCachePath({});
+    }
   } else if (Comp) {
     EXPECTED_TRY(ValidatorEngine.validate(*Comp.get()));
   } else {
@@ -426,37 +677,51 @@ Expect<void> VM::unsafeInstantiate() {
   if (Mod) {
     if (Conf.getRuntimeConfigure().isEnableJIT() && !Mod->getSymbol()) {
 #ifdef WASMEDGE_USE_LLVM
-      LLVM::Compiler Compiler(Conf);
-      Compiler.checkConfigure()
-          .map_error([](uint32_t Err) {
-            if (Err != ErrCode::Value::Success) {
-              spdlog::error("Compiler Configure failed. Error code: {}, use "
-                            "interpreter mode instead."sv,
-                            Err);
-            }
-            return ErrCode::Value::Success;
-          })
-          .and_then([&]() { return Compiler.compile(*Mod); })
-          .map_error([](uint32_t Err) {
-            if (Err != ErrCode::Value::Success) {
-              spdlog::error("Compilation failed. Error code: {}, use "
-                            "interpreter mode instead."sv,
-                            Err);
-            }
-            return ErrCode::Value::Success;
-          })
-          .and_then([&](auto LLModule) {
-            LLVM::JIT JIT(Conf);
-            return JIT.load(std::move(LLModule));
-          })
-          .map_error([](uint32_t Err) {
-            if (Err != ErrCode::Value::Success) {
-              spdlog::warn(
-                  "JIT failed. Error code: {}, use interpreter mode instead."sv,
-                  Err);
-            }
-            return ErrCode::Value::Success;
-          })
+      // Share the executable with the other VMs which load the same module.
+      // The module is serialized to key the cache, and compiled without the
+      // cache when it cannot be serialized. With the JIT cache enabled, the
+      // shared library stored by an earlier run is loaded instead.
+      auto Code = LoaderEngine.serializeModule(*Mod);
+      auto Load = [&]() -> Expect<std::shared_ptr<Executable>> {
+        if (Code && Conf.getRuntimeConfigure().isEnableJITCache()) {
+          if (auto Library = loadJITCache(Conf, *Mod, *Code)) {
+            return Library;
+          }
+        }
+        LLVM::Compiler Compiler(Conf);
+        Compiler.setLazyFunctions(Conf.getRuntimeConfigure().isEnableLazyJIT());
+        return Compiler.checkConfigure()
+            .map_error([](uint32_t Err) {
+              if (Err != ErrCode::Value::Success) {
+                spdlog::error("Compiler Configure failed. Error code: {}, use "
+                              "interpreter mode instead."sv,
+                              Err);
+              }
+              return ErrCode::Value::Success;
+            })
+            .and_then([&]() { return Compiler.compile(*Mod); })
+            .map_error([](uint32_t Err) {
+              if (Err != ErrCode::Value::Success) {
+                spdlog::error("Compilation failed. Error code: {}, use "
+                              "interpreter mode instead."sv,
+                              Err);
+              }
+              return ErrCode::Value::Success;
+            })
+            .and_then([&](auto LLModule) {
+              LLVM::JIT JIT(Conf);
+              return JIT.load(std::move(LLModule));
+            })
+            .map_error([](uint32_t Err) {
+              if (Err != ErrCode::Value::Success) {
+                spdlog::warn("JIT failed. Error code: {}, use interpreter "
+                             "mode instead."sv,
+                             Err);
+              }
+              return ErrCode::Value::Success;
+            });
+      };
+      (Code ? LLVM::JITCache::getOrLoad(*Code, Conf, Load) : Load())
           .and_then([&](auto Module) {
             return LoaderEngine.loadExecutable(*Mod, std::move(Module));
           })
@@ -472,9 +737,18 @@ Expect<void> VM::unsafeInstantiate() {
       spdlog::error("LLVM disabled, JIT is unsupported!"sv);
 #endif
     }
+#ifndef WASMEDGE_USE_LLVM
+    if (Conf.getRuntimeConfigure().isEnableTieredJIT()) {
+      spdlog::error("LLVM disabled, tiered JIT is unsupported!"sv);
+    }
+#endif
 
+    unsafeStopTierUp();
+    SnapshotModInst.reset();
+    EXPECTED_TRY(unsafeLoadDeferredPlugInHosts(*Mod));
     EXPECTED_TRY(ActiveModInst,
                  ExecutorEngine.instantiateModule(StoreRef, *Mod));
+    TierUpMod = Mod.get();
     Stage = VMStage::Instantiated;
     return {};
   } else if (Comp) {
@@ -488,6 +762,55 @@ Expect<void> VM::unsafeInstantiate() {
   }
 }
 
+Expect<void> VM::unsafeSnapshot() {
+  if (Stage < VMStage::Instantiated || !ActiveModInst) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  unsafeStopTierUp();
+  EXPECTED_TRY(auto Clone, ExecutorEngine.cloneModule(*ActiveModInst));
+  SnapshotModInst = std::move(ActiveModInst);
+  ActiveModInst = std::move(Clone);
+  return {};
+}
+
+Expect<void> VM::unsafeRestore() {
+  if (!SnapshotModInst) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  unsafeStopTierUp();
+  EXPECTED_TRY(ActiveModInst, ExecutorEngine.cloneModule(*SnapshotModInst));
+  return {};
+}
+
+void VM::requestTierUp(const Runtime::Instance::ModuleInstance &ModInst) {
+  // Invoked on the executing thread with the shared lock held, so the active
+  // module instance and the AST module are stable here.
+#ifdef WASMEDGE_USE_LLVM
+  std::unique_lock Lock(TierUpMutex);
+  if (&ModInst != ActiveModInst.get() || !TierUpMod ||
+      TierUpThread.joinable()) {
+    return;
+  }
+  // Compile a copy of the AST module, so that loading another module does not
+  // wait for the background compilation.
+  TierUpThread = std::thread(
+      [this, Module = std::make_unique<AST::Module>(*TierUpMod), &ModInst]() {
+        tierUp(Conf, *Module, ModInst);
+      });
+#else
+  static_cast<void>(ModInst);
+#endif
+}
+
+void VM::unsafeStopTierUp() {
+  std::unique_lock Lock(TierUpMutex);
+  if (TierUpThread.joinable()) {
+    TierUpThread.join();
+  }
+}
+
 Expect<std::vector<std::pair<ValVariant, ValType>>>
 VM::unsafeExecute(std::string_view Func, Span<const ValVariant> Params,
                   Span<const ValType> ParamTypes) {
@@ -560,6 +883,29 @@ VM::unsafeExecute(const Runtime::Instance::ModuleInstance *ModInst,
       });
 }
 
+Expect<void> VM::unsafeExecuteBatch(std::string_view Func,
+                                    Span<const ValType> ParamTypes,
+                                    Span<const void *const> Params,
+                                    Span<void *const> Returns, uint32_t Rows,
+                                    uint32_t Threads) {
+  if (unlikely(!ActiveModInst)) {
+    spdlog::error(ErrCode::Value::WrongInstanceAddress);
+    spdlog::error(ErrInfo::InfoExecuting("When invoking"sv, Func));
+    return Unexpect(ErrCode::Value::WrongInstanceAddress);
+  }
+  // Find the exported function once for the whole batch.
+  const auto *FuncInst = ActiveModInst->findFuncExports(Func);
+  return ExecutorEngine
+      .invokeBatch(FuncInst, ParamTypes, Params, Returns, Rows, Threads)
+      .map_error([this, &Func](auto E) {
+        if (E != ErrCode::Value::Terminated) {
+          spdlog::error(
+              ErrInfo::InfoExecuting(ActiveModInst->getModuleName(), Func));
+        }
+        return E;
+      });
+}
+
 Expect<std::vector<std::pair<ComponentValVariant, ComponentValType>>>
 VM::unsafeExecuteComponent(const Runtime::Instance::ComponentInstance *CompInst,
                            std::string_view Func,
@@ -635,19 +981,30 @@ VM::asyncExecuteComponent(std::string_view CompName, std::string_view Func,
 }
 
 void VM::unsafeCleanup() {
-  if (Mod) {
-    Mod.reset();
-  }
+  unsafeStopTierUp();
+  TierUpMod = nullptr;
+  // The AST module and the module instances are destroyed in the background
+  // if the background reclamation is enabled.
+  Reclaimer::release(std::move(Mod));
   if (Comp) {
     Comp.reset();
   }
   if (ActiveModInst) {
-    ActiveModInst.reset();
+    ActiveModInst->unlinkStores();
+    Reclaimer::release(std::move(ActiveModInst));
+  }
+  if (SnapshotModInst) {
+    SnapshotModInst->unlinkStores();
+    Reclaimer::release(std::move(SnapshotModInst));
   }
   if (ActiveCompInst) {
     ActiveCompInst.reset();
   }
   StoreRef.reset();
+  for (auto &ModInst : RegModInsts) {
+    ModInst->unlinkStores();
+    Reclaimer::release(std::move(ModInst));
+  }
   RegModInsts.clear();
   Stat.clear();
   unsafeLoadBuiltInHosts();
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "vm/vmpool.h"
+
+#include "common/spdlog.h"
+#include "system/numa.h"
+
+#include <algorithm>
+#include <string>
+
+namespace WasmEdge {
+namespace VM {
+
+VMPool::VMPool(const Configure &Conf, uint32_t Size, ResetStrategy S,
+               bool SpreadNumaNodes)
+    : Strategy(S), NeedReset(Size, false), Leased(Size, false) {
+  const uint32_t Nodes = SpreadNumaNodes ? Numa::getNodeCount() : 0;
+  VMs.reserve(Size);
+  for (uint32_t I = 0; I < Size; ++I) {
+    if (Nodes > 1) {
+      // The memories and the executing threads of every VM stay on its node.
+      Configure NodeConf(Conf);
+      NodeConf.getRuntimeConfigure().setNumaNode(
+          static_cast<int32_t>(I % Nodes));
+      VMs.push_back(std::make_unique<VM>(NodeConf));
+    } else {
+      VMs.push_back(std::make_unique<VM>(Conf));
+    }
+  }
+}
+
+Expect<void> VMPool::instantiate(const AST::Module &Mod) {
+  std::unique_lock Lock(Mutex);
+  if (Instantiated || VMs.empty()) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  for (auto &VM : VMs) {
+    EXPECTED_TRY(VM->loadWasm(Mod));
+    EXPECTED_TRY(VM->validate());
+    EXPECTED_TRY(VM->instantiate());
+    if (Strategy == ResetStrategy::Snapshot) {
+      EXPECTED_TRY(VM->snapshot());
+    }
+  }
+  // Lease the VMs from the lowest index.
+  Free.resize(VMs.size());
+  for (uint32_t I = 0; I < Free.size(); ++I) {
+    Free[I] = static_cast<uint32_t>(Free.size()) - I - 1;
+  }
+  Instantiated = true;
+  return {};
+}
+
+Expect<VMPool::Lease> VMPool::lease() {
+  std::unique_lock Lock(Mutex);
+  if (!Instantiated) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  if (!Free.empty()) {
+    ++Stat.Hits;
+  } else {
+    ++Stat.Misses;
+    const auto Start = std::chrono::steady_clock::now();
+    Cond.wait(Lock, [this]() { return !Free.empty(); });
+    const auto Wait = std::chrono::steady_clock::now() - Start;
+    Stat.WaitTime += Wait;
+    Stat.MaxWaitTime = std::max<std::chrono::nanoseconds>(Stat.MaxWaitTime,
+                                                          Wait);
+  }
+  return unsafeTake(Lock);
+}
+
+Expect<std::optional<VMPool::Lease>> VMPool::tryLease() {
+  std::unique_lock Lock(Mutex);
+  if (!Instantiated) {
+    spdlog::error(ErrCode::Value::WrongVMWorkflow);
+    return Unexpect(ErrCode::Value::WrongVMWorkflow);
+  }
+  if (Free.empty()) {
+    ++Stat.Misses;
+    return std::nullopt;
+  }
+  ++Stat.Hits;
+  EXPECTED_TRY(auto L, unsafeTake(Lock));
+  return std::make_optional(std::move(L));
+}
+
+VMPool::Metrics VMPool::getMetrics() const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Stat;
+}
+
+Expect<VMPool::Lease> VMPool::unsafeTake(std::unique_lock<std::mutex> &Lock) {
+  const uint32_t Index = Free.back();
+  Free.pop_back();
+  ++Stat.InUse;
+  if (NeedReset[Index]) {
+    // Retry the failed reset before leasing the VM again.
+    Lock.unlock();
+    auto Res = reset(Index);
+    Lock.lock();
+    if (!Res) {
+      ++Stat.ResetFailures;
+      --Stat.InUse;
+      Free.push_back(Index);
+      Cond.notify_one();
+      return Unexpect(Res);
+    }
+    NeedReset[Index] = false;
+  }
+  ++Stat.Leases;
+  Leased[Index] = true;
+  return Lease(*this, Index);
+}
+
+void VMPool::giveBack(uint32_t Index) noexcept {
+  const auto Start = std::chrono::steady_clock::now();
+  auto Res = reset(Index);
+  const auto ResetTime = std::chrono::steady_clock::now() - Start;
+  std::unique_lock Lock(Mutex);
+  Stat.ResetTime += ResetTime;
+  if (!Res) {
+    ++Stat.ResetFailures;
+    NeedReset[Index] = true;
+  }
+  --Stat.InUse;
+  Leased[Index] = false;
+  Free.push_back(Index);
+  Cond.notify_one();
+}
+
+Expect<std::vector<std::pair<ValVariant, ValType>>>
+VMPool::execute(std::string_view Func, Span<const ValVariant> Params,
+                Span<const ValType> ParamTypes) {
+  EXPECTED_TRY(auto L, lease());
+  return L->execute(Func, Params, ParamTypes);
+}
+
+Async<Expect<std::vector<std::pair<ValVariant, ValType>>>>
+VMPool::asyncExecute(std::string_view Func, Span<const ValVariant> Params,
+                     Span<const ValType> ParamTypes) {
+  Expect<std::vector<std::pair<ValVariant, ValType>>> (VMPool::*FPtr)(
+      std::string_view, Span<const ValVariant>, Span<const ValType>) =
+      &VMPool::execute;
+  return {FPtr, *this, std::string(Func),
+          std::vector(Params.begin(), Params.end()),
+          std::vector(ParamTypes.begin(), ParamTypes.end())};
+}
+
+void VMPool::stop() noexcept {
+  std::unique_lock Lock(Mutex);
+  for (uint32_t I = 0; I < VMs.size(); ++I) {
+    if (Leased[I]) {
+      VMs[I]->stop();
+    }
+  }
+}
+
+Expect<void> VMPool::reset(uint32_t Index) {
+  switch (Strategy) {
+  case ResetStrategy::Reinstantiate:
+    return VMs[Index]->instantiate();
+  case ResetStrategy::Snapshot:
+    return VMs[Index]->restore();
+  case ResetStrategy::Reuse:
+  default:
+    return {};
+  }
+}
+
+} // namespace VM
+} // namespace WasmEdge
@@ -161,6 +161,11 @@ public:
   symmetricStateSqueeze(__wasi_symmetric_state_t StateHandle,
                         Span<uint8_t> Out) noexcept;
 
+  WasiCryptoExpect<void>
+  symmetricHashBatch(Symmetric::Algorithm Alg,
+                     Span<const Span<const uint8_t>> Inputs,
+                     Span<uint8_t> Out) noexcept;
+
   WasiCryptoExpect<__wasi_symmetric_tag_t>
   symmetricStateSqueezeTag(__wasi_symmetric_state_t StateHandle) noexcept;
 
@@ -330,6 +335,14 @@ public:
   WasiCryptoExpect<void> signatureVerificationStateClose(
       __wasi_signature_verification_state_t StateHandle) noexcept;
 
+  /// Verify every signature of the message with the public key at the same
+  /// index, and write the result of every item. Returns the first failure.
+  WasiCryptoExpect<void>
+  signatureBatchVerify(Span<const __wasi_signature_publickey_t> PkHandles,
+                       Span<const Span<const uint8_t>> Msgs,
+                       Span<const __wasi_signature_t> SigHandles,
+                       Span<__wasi_crypto_errno_e_t> Results) noexcept;
+
 private:
   Context() noexcept {}
 
@@ -124,6 +124,51 @@ WasiCryptoExpect<void> Context::signatureVerificationStateClose(
   return VerificationStateManager.close(VerificationHandle);
 }
 
+WasiCryptoExpect<void> Context::signatureBatchVerify(
+    Span<const __wasi_signature_publickey_t> PkHandles,
+    Span<const Span<const uint8_t>> Msgs,
+    Span<const __wasi_signature_t> SigHandles,
+    Span<__wasi_crypto_errno_e_t> Results) noexcept {
+  ensureOrReturn(PkHandles.size() == Msgs.size() &&
+                     PkHandles.size() == SigHandles.size() &&
+                     PkHandles.size() == Results.size(),
+                 __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
+
+  // The verification states are not registered, as they never leave the call.
+  __wasi_crypto_errno_e_t FirstError = __WASI_CRYPTO_ERRNO_SUCCESS;
+  for (size_t I = 0; I < PkHandles.size(); ++I) {
+    auto Res =
+        PublicKeyManager.getAs<Signatures::PkVariant>(PkHandles[I])
+            .and_then([](auto &&PkVariant) noexcept {
+              return Signatures::verificationStateOpen(PkVariant);
+            })
+            .and_then([this, &Msgs, &SigHandles,
+                       I](auto &&VerificationStateVariant) noexcept
+                      -> WasiCryptoExpect<void> {
+              if (auto UpdateRes = Signatures::verificationStateUpdate(
+                      VerificationStateVariant, Msgs[I]);
+                  !UpdateRes) {
+                return UpdateRes;
+              }
+              auto Sig = SignatureManager.get(SigHandles[I]);
+              if (!Sig) {
+                return WasiCryptoUnexpect(Sig);
+              }
+              return Signatures::verificationStateVerify(
+                  VerificationStateVariant, *Sig);
+            });
+    Results[I] = Res ? __WASI_CRYPTO_ERRNO_SUCCESS : Res.error();
+    if (!Res && FirstError == __WASI_CRYPTO_ERRNO_SUCCESS) {
+      FirstError = Res.error();
+    }
+  }
+
+  if (FirstError != __WASI_CRYPTO_ERRNO_SUCCESS) {
+    return WasiCryptoUnexpect(FirstError);
+  }
+  return {};
+}
+
 } // namespace WasiCrypto
 } // namespace Host
 } // namespace WasmEdge
@@ -212,6 +212,40 @@ Expect<uint32_t> VerificationStateClose::body(const Runtime::CallingFrame &,
   return __WASI_CRYPTO_ERRNO_SUCCESS;
 }
 
+Expect<uint32_t> BatchVerify::body(const Runtime::CallingFrame &Frame,
+                                   uint32_t PkHandlesPtr, uint32_t MsgsPtr,
+                                   uint32_t SigHandlesPtr, uint32_t Count,
+                                   uint32_t /* Out */ ResultsPtr) {
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  checkExist(MemInst);
+
+  const __wasi_size_t WasiCount = Count;
+  const auto PkHandles = MemInst->getSpan<const __wasi_signature_publickey_t>(
+      PkHandlesPtr, WasiCount);
+  checkRangeExist(PkHandles, WasiCount);
+
+  auto Msgs = getBufferList(*MemInst, MsgsPtr, Count);
+  if (unlikely(!Msgs)) {
+    return Msgs.error();
+  }
+
+  const auto SigHandles =
+      MemInst->getSpan<const __wasi_signature_t>(SigHandlesPtr, WasiCount);
+  checkRangeExist(SigHandles, WasiCount);
+
+  const auto Results =
+      MemInst->getSpan<__wasi_crypto_errno_e_t>(ResultsPtr, WasiCount);
+  checkRangeExist(Results, WasiCount);
+
+  if (auto Res =
+          Ctx.signatureBatchVerify(PkHandles, *Msgs, SigHandles, Results);
+      unlikely(!Res)) {
+    return Res.error();
+  }
+
+  return __WASI_CRYPTO_ERRNO_SUCCESS;
+}
+
 Expect<uint32_t> Close::body(const Runtime::CallingFrame &, int32_t SigHandle) {
   if (auto Res = Ctx.signatureClose(SigHandle); unlikely(!Res)) {
     return Res.error();
@@ -99,6 +99,15 @@ public:
                         int32_t VerificationStateHandle);
 };
 
+class BatchVerify : public HostFunction<BatchVerify> {
+public:
+  using HostFunction::HostFunction;
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
+                        uint32_t PkHandlesPtr, uint32_t MsgsPtr,
+                        uint32_t SigHandlesPtr, uint32_t Count,
+                        uint32_t /* Out */ ResultsPtr);
+};
+
 class Close : public HostFunction<Close> {
 public:
   using HostFunction::HostFunction;
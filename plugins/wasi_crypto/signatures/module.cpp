@@ -36,6 +36,8 @@ WasiCryptoSignaturesModule::WasiCryptoSignaturesModule(
               std::make_unique<Signatures::VerificationStateVerify>(*Ctx));
   addHostFunc("signature_verification_state_close",
               std::make_unique<Signatures::VerificationStateClose>(*Ctx));
+  addHostFunc("signature_batch_verify",
+              std::make_unique<Signatures::BatchVerify>(*Ctx));
   addHostFunc("signature_close", std::make_unique<Signatures::Close>(*Ctx));
 }
 
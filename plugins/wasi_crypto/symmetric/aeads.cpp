@@ -18,6 +18,22 @@ namespace WasiCrypto {
 namespace Symmetric {
 using namespace std::literals;
 
+namespace {
+/// Maximum size of the additional data kept for replaying by clone(), where
+/// the context duplication is not implemented.
+constexpr size_t kMaxReplayedAad = 65536;
+
+/// In place operations are fine, other overlaps are not.
+bool isPartialOverlap(Span<const uint8_t> Out,
+                      Span<const uint8_t> Data) noexcept {
+  if (Out.data() == Data.data() || Out.empty() || Data.empty()) {
+    return false;
+  }
+  return Out.data() < Data.data() + Data.size() &&
+         Data.data() < Out.data() + Out.size();
+}
+} // namespace
+
 template <int CipherNid>
 constexpr size_t Cipher<CipherNid>::getKeySize() noexcept {
   static_assert(CipherNid == NID_aes_128_gcm || CipherNid == NID_aes_256_gcm ||
@@ -55,6 +71,47 @@ Cipher<CipherNid>::Key::import(Span<const uint8_t> Raw) noexcept {
   return SecretVec{Raw};
 }
 
+template <int CipherNid>
+WasiCryptoExpect<EvpCipherCtxPtr> Cipher<CipherNid>::ContextCache::acquire(
+    const SecretVec &Key,
+    const std::array<uint8_t, NonceSize> &Nonce) noexcept {
+  EvpCipherCtxPtr Ctx;
+  {
+    std::scoped_lock Lock{Mutex};
+    if (!Contexts.empty()) {
+      Ctx = std::move(Contexts.back());
+      Contexts.pop_back();
+    }
+  }
+
+  if (Ctx) {
+    // The key schedule is kept, setting the nonce resets the rest.
+    opensslCheck(EVP_CipherInit_ex(Ctx.get(), nullptr, nullptr, nullptr,
+                                   Nonce.data(), Mode::Unchanged));
+    return Ctx;
+  }
+
+  Ctx.reset(EVP_CIPHER_CTX_new());
+  opensslCheck(EVP_CipherInit_ex(Ctx.get(), EVP_get_cipherbynid(CipherNid),
+                                 nullptr, Key.data(), Nonce.data(),
+                                 Mode::Unchanged));
+  return Ctx;
+}
+
+template <int CipherNid>
+void Cipher<CipherNid>::ContextCache::release(EvpCipherCtxPtr Ctx) noexcept {
+  std::scoped_lock Lock{Mutex};
+  if (Contexts.size() < MaxCached) {
+    Contexts.push_back(std::move(Ctx));
+  }
+}
+
+template <int CipherNid> Cipher<CipherNid>::State::Inner::~Inner() noexcept {
+  if (RawCtx) {
+    SecretKey.cache()->release(std::move(RawCtx));
+  }
+}
+
 template <int CipherNid>
 WasiCryptoExpect<typename Cipher<CipherNid>::State>
 Cipher<CipherNid>::State::open(const Key &Key,
@@ -71,12 +128,10 @@ Cipher<CipherNid>::State::open(const Key &Key,
   ensureOrReturn(getKeySize() == Key.ref().size(),
                  __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
 
-  EvpCipherCtxPtr Ctx{EVP_CIPHER_CTX_new()};
-  opensslCheck(EVP_CipherInit_ex(Ctx.get(), EVP_get_cipherbynid(CipherNid),
-                                 nullptr, Key.ref().data(), Nonce.data(),
-                                 Mode::Unchanged));
-
-  return State{std::move(Ctx), Nonce};
+  return Key.cache()->acquire(Key.ref(), Nonce).map(
+      [&Nonce, &Key](EvpCipherCtxPtr Ctx) noexcept {
+        return State{std::move(Ctx), Nonce, Key};
+      });
 }
 
 template <int CipherNid>
@@ -104,6 +159,15 @@ Cipher<CipherNid>::State::absorb(Span<const uint8_t> Data) noexcept {
     std::scoped_lock Lock{Ctx->Mutex};
     opensslCheck(EVP_CipherUpdate(Ctx->RawCtx.get(), nullptr, &ActualAbsorbSize,
                                   Data.data(), DataSize));
+    if (!Ctx->AadDropped) {
+      if (Data.size() <= kMaxReplayedAad - Ctx->Aad.size()) {
+        Ctx->Aad.insert(Ctx->Aad.end(), Data.begin(), Data.end());
+      } else {
+        Ctx->Aad.clear();
+        Ctx->Aad.shrink_to_fit();
+        Ctx->AadDropped = true;
+      }
+    }
   }
   ensureOrReturn(ActualAbsorbSize == DataSize,
                  __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
@@ -137,8 +201,11 @@ Cipher<CipherNid>::State::encryptImpl(Span<uint8_t> Out, Span<uint8_t> Tag,
                      static_cast<size_t>(std::numeric_limits<int>::max()),
                  __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
   int DataSize = static_cast<int>(Data.size());
+  ensureOrReturn(!isPartialOverlap(Out, Data),
+                 __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
 
   std::scoped_lock Lock{Ctx->Mutex};
+  Ctx->Finished = true;
   opensslCheck(EVP_CipherInit_ex(Ctx->RawCtx.get(), nullptr, nullptr, nullptr,
                                  nullptr, Mode::Encrypt));
 
@@ -185,8 +252,11 @@ Cipher<CipherNid>::State::decryptImpl(Span<uint8_t> Out,
                      static_cast<size_t>(std::numeric_limits<int>::max()),
                  __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
   int DataSize = static_cast<int>(Data.size());
+  ensureOrReturn(!isPartialOverlap(Out, Data),
+                 __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
 
   std::scoped_lock Lock{Ctx->Mutex};
+  Ctx->Finished = true;
   opensslCheck(EVP_CipherInit_ex(Ctx->RawCtx.get(), nullptr, nullptr, nullptr,
                                  nullptr, Mode::Decrypt));
   int ActualUpdateSize;
@@ -211,21 +281,43 @@ Cipher<CipherNid>::State::decryptImpl(Span<uint8_t> Out,
 template <int CipherNid>
 WasiCryptoExpect<typename Cipher<CipherNid>::State>
 Cipher<CipherNid>::State::clone() const noexcept {
-  // XXX: These cipher didn't implement context duplication from OpenSSL 3.0.0
-  // https://github.com/openssl/openssl/issues/20978
-  if (0x30000000 <= OPENSSL_VERSION_NUMBER &&
-      (CipherNid == NID_aes_128_gcm || CipherNid == NID_aes_256_gcm ||
-       CipherNid == NID_chacha20_poly1305)) {
-    return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_NOT_IMPLEMENTED);
-  }
-
-  EvpCipherCtxPtr CloneCtx{EVP_CIPHER_CTX_new()};
+  // Some releases of OpenSSL 3.0 didn't implement context duplication for
+  // these ciphers (https://github.com/openssl/openssl/issues/20978), so open a
+  // new state and replay the additional data kept instead.
+  EvpCipherCtxPtr CopiedCtx{EVP_CIPHER_CTX_new()};
+  std::vector<uint8_t> Aad;
+  bool AadDropped;
   {
     std::scoped_lock Lock{Ctx->Mutex};
-    opensslCheck(EVP_CIPHER_CTX_copy(CloneCtx.get(), Ctx->RawCtx.get()));
+    ensureOrReturn(!Ctx->Finished, __WASI_CRYPTO_ERRNO_INVALID_OPERATION);
+    if (!CopiedCtx ||
+        !EVP_CIPHER_CTX_copy(CopiedCtx.get(), Ctx->RawCtx.get())) {
+      CopiedCtx.reset();
+      ensureOrReturn(!Ctx->AadDropped, __WASI_CRYPTO_ERRNO_UNSUPPORTED_FEATURE);
+    }
+    Aad = Ctx->Aad;
+    AadDropped = Ctx->AadDropped;
   }
 
-  return State{std::move(CloneCtx), Ctx->Nonce};
+  if (CopiedCtx) {
+    State Clone{std::move(CopiedCtx), Ctx->Nonce, Ctx->SecretKey};
+    Clone.Ctx->Aad = std::move(Aad);
+    Clone.Ctx->AadDropped = AadDropped;
+    return Clone;
+  }
+
+  auto CloneCtx = Ctx->SecretKey.cache()->acquire(Ctx->SecretKey.ref(),
+                                                     Ctx->Nonce);
+  if (!CloneCtx) {
+    return WasiCryptoUnexpect(CloneCtx);
+  }
+  State Clone{std::move(*CloneCtx), Ctx->Nonce, Ctx->SecretKey};
+  if (!Aad.empty()) {
+    if (auto Res = Clone.absorb(Aad); !Res) {
+      return WasiCryptoUnexpect(Res);
+    }
+  }
+  return Clone;
 }
 
 template class Cipher<NID_aes_128_gcm>;
@@ -21,6 +21,11 @@
 #include "utils/optional.h"
 #include "utils/secret_vec.h"
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace WasmEdge {
 namespace Host {
 namespace WasiCrypto {
@@ -56,10 +61,28 @@ public:
 template <int CipherNid> class Cipher {
   static inline constexpr size_t NonceSize = 12;
 
+  /// The contexts with the expanded key schedule, released by the closed
+  /// states of the key. Opening a state from a cached context only sets the
+  /// nonce.
+  class ContextCache {
+  public:
+    WasiCryptoExpect<EvpCipherCtxPtr>
+    acquire(const SecretVec &Key,
+            const std::array<uint8_t, NonceSize> &Nonce) noexcept;
+
+    void release(EvpCipherCtxPtr Ctx) noexcept;
+
+  private:
+    static inline constexpr size_t MaxCached = 8;
+    std::mutex Mutex;
+    std::vector<EvpCipherCtxPtr> Contexts;
+  };
+
 public:
   class Key {
   public:
-    Key(SecretVec Data) noexcept : Data(std::move(Data)) {}
+    Key(SecretVec Data) noexcept
+        : Data(std::move(Data)), Cache(std::make_shared<ContextCache>()) {}
 
     static WasiCryptoExpect<Key> import(Span<const uint8_t> Data) noexcept;
 
@@ -70,8 +93,14 @@ public:
 
     const SecretVec &ref() const noexcept { return Data; }
 
+    /// Shared by the copies of the key.
+    const std::shared_ptr<ContextCache> &cache() const noexcept {
+      return Cache;
+    }
+
   private:
     SecretVec Data;
+    std::shared_ptr<ContextCache> Cache;
   };
 
   class State : public AEADsState<Key> {
@@ -82,8 +111,10 @@ public:
     static WasiCryptoExpect<State>
     open(const Key &Key, OptionalRef<const Options> OptOption) noexcept;
 
-    State(EvpCipherCtxPtr Ctx, std::array<uint8_t, NonceSize> Nonce) noexcept
-        : Ctx(std::make_shared<Inner>(std::move(Ctx), Nonce)) {}
+    State(EvpCipherCtxPtr Ctx, std::array<uint8_t, NonceSize> Nonce,
+          Key Key) noexcept
+        : Ctx(std::make_shared<Inner>(std::move(Ctx), Nonce, std::move(Key))) {
+    }
 
     WasiCryptoExpect<size_t> optionsGet(std::string_view Name,
                                         Span<uint8_t> Value) const noexcept;
@@ -106,7 +137,9 @@ public:
     WasiCryptoExpect<size_t> maxTagLen() const noexcept;
 
     /// Check Out.size() == Data.size() + maxTagLen(), then call
-    /// encryptUnchecked(Out, Data) or return error if not equal.
+    /// encryptUnchecked(Out, Data) or return error if not equal. The
+    /// encryption and the decryption can be in place, with Out starting at
+    /// Data, but the buffers must not overlap otherwise.
     ///
     /// @param Out The encrypted data text
     /// @param Data The data to be encrypted
@@ -146,6 +179,10 @@ public:
     decryptDetached(Span<uint8_t> Out, Span<const uint8_t> Data,
                     Span<const uint8_t> RawTag) noexcept;
 
+    /// Duplicate the context of the state, or open a state from a cached
+    /// context of the key and absorb the same additional data if the
+    /// duplication is not implemented. The state must not have encrypted or
+    /// decrypted.
     WasiCryptoExpect<State> clone() const noexcept;
 
   private:
@@ -156,11 +193,19 @@ public:
                                          Span<const uint8_t> Data,
                                          Span<const uint8_t> RawTag) noexcept;
     struct Inner {
-      Inner(EvpCipherCtxPtr RawCtx,
-            std::array<uint8_t, NonceSize> Nonce) noexcept
-          : RawCtx(std::move(RawCtx)), Nonce(Nonce) {}
+      Inner(EvpCipherCtxPtr RawCtx, std::array<uint8_t, NonceSize> Nonce,
+            Cipher::Key SecretKey) noexcept
+          : RawCtx(std::move(RawCtx)), Nonce(Nonce),
+            SecretKey(std::move(SecretKey)) {}
+      ~Inner() noexcept;
       EvpCipherCtxPtr RawCtx;
       const std::array<uint8_t, NonceSize> Nonce;
+      const Cipher::Key SecretKey;
+      /// The absorbed additional data, replayed by clone() without the context
+      /// duplication. Dropped if larger than the bound.
+      std::vector<uint8_t> Aad;
+      bool AadDropped = false;
+      bool Finished = false;
       std::mutex Mutex;
     };
     std::shared_ptr<Inner> Ctx;
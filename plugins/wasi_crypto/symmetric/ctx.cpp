@@ -97,6 +97,13 @@ Context::symmetricStateSqueeze(__wasi_symmetric_state_t StateHandle,
       });
 }
 
+WasiCryptoExpect<void>
+Context::symmetricHashBatch(Symmetric::Algorithm Alg,
+                            Span<const Span<const uint8_t>> Inputs,
+                            Span<uint8_t> Out) noexcept {
+  return Symmetric::hashBatch(Alg, Inputs, Out);
+}
+
 WasiCryptoExpect<__wasi_symmetric_tag_t> Context::symmetricStateSqueezeTag(
     __wasi_symmetric_state_t StateHandle) noexcept {
   return SymmetricStateManager.get(StateHandle)
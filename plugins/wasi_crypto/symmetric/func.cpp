@@ -408,6 +408,40 @@ Expect<uint32_t> StateSqueeze::body(const Runtime::CallingFrame &Frame,
   return __WASI_CRYPTO_ERRNO_SUCCESS;
 }
 
+Expect<uint32_t> HashBatch::body(const Runtime::CallingFrame &Frame,
+                                 uint32_t AlgPtr, uint32_t AlgLen,
+                                 uint32_t InputsPtr, uint32_t InputsCount,
+                                 uint32_t OutPtr, uint32_t OutLen) {
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  checkExist(MemInst);
+
+  const __wasi_size_t WasiAlgLen = AlgLen;
+  const auto Alg = MemInst->getStringView(AlgPtr, WasiAlgLen);
+  checkRangeExist(Alg, WasiAlgLen);
+  Algorithm WasiAlg;
+  if (auto Res = tryFrom<Algorithm>(Alg); !Res) {
+    return Res.error();
+  } else {
+    WasiAlg = *Res;
+  }
+
+  auto Inputs = getBufferList(*MemInst, InputsPtr, InputsCount);
+  if (unlikely(!Inputs)) {
+    return Inputs.error();
+  }
+
+  const __wasi_size_t WasiOutLen = OutLen;
+  const auto Out = MemInst->getSpan<uint8_t>(OutPtr, WasiOutLen);
+  checkRangeExist(Out, WasiOutLen);
+
+  if (auto Res = Ctx.symmetricHashBatch(WasiAlg, *Inputs, Out);
+      unlikely(!Res)) {
+    return Res.error();
+  }
+
+  return __WASI_CRYPTO_ERRNO_SUCCESS;
+}
+
 Expect<uint32_t> StateSqueezeTag::body(const Runtime::CallingFrame &Frame,
                                        int32_t StateHandle,
                                        uint32_t /* Out */ TagHandlePtr) {
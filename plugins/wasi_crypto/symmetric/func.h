@@ -146,6 +146,15 @@ public:
                         uint32_t OutPtr, uint32_t OutLen);
 };
 
+class HashBatch : public HostFunction<HashBatch> {
+public:
+  using HostFunction::HostFunction;
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t AlgPtr,
+                        uint32_t AlgLen, uint32_t InputsPtr,
+                        uint32_t InputsCount, uint32_t OutPtr,
+                        uint32_t OutLen);
+};
+
 class StateSqueezeTag : public HostFunction<StateSqueezeTag> {
 public:
   using HostFunction::HostFunction;
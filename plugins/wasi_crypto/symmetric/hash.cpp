@@ -84,6 +84,38 @@ Sha2<ShaNid>::State::clone() const noexcept {
   return CloneCtx;
 }
 
+template <int ShaNid>
+WasiCryptoExpect<void>
+Sha2<ShaNid>::hashBatch(Span<const Span<const uint8_t>> Inputs,
+                        Span<uint8_t> Out) noexcept {
+  if (Inputs.empty()) {
+    ensureOrReturn(Out.empty(), __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
+    return {};
+  }
+  const size_t OutLen = Out.size() / Inputs.size();
+  ensureOrReturn(OutLen > 0 && OutLen <= getDigestSize() &&
+                     OutLen * Inputs.size() == Out.size(),
+                 __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
+
+  EvpMdCtxPtr InitCtx{EVP_MD_CTX_new()};
+  opensslCheck(EVP_DigestInit_ex(InitCtx.get(), EVP_get_digestbynid(ShaNid),
+                                 nullptr));
+  EvpMdCtxPtr Ctx{EVP_MD_CTX_new()};
+  std::array<uint8_t, getDigestSize()> Cache;
+  for (size_t I = 0; I < Inputs.size(); ++I) {
+    opensslCheck(EVP_MD_CTX_copy_ex(Ctx.get(), InitCtx.get()));
+    opensslCheck(
+        EVP_DigestUpdate(Ctx.get(), Inputs[I].data(), Inputs[I].size()));
+    unsigned int Size;
+    opensslCheck(EVP_DigestFinal_ex(Ctx.get(), Cache.data(), &Size));
+    ensureOrReturn(Size == getDigestSize(),
+                   __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
+    std::copy(Cache.begin(), Cache.begin() + static_cast<ptrdiff_t>(OutLen),
+              Out.data() + I * OutLen);
+  }
+  return {};
+}
+
 template class Sha2<NID_sha256>;
 template class Sha2<NID_sha512>;
 template class Sha2<NID_sha512_256>;
@@ -124,6 +124,13 @@ public:
     std::shared_ptr<Inner> Ctx;
   };
 
+  /// Hash every input into the consecutive slices of the output, which all
+  /// have the size of the output divided by the number of inputs. The digest
+  /// context is initialized once and copied for every input.
+  static WasiCryptoExpect<void>
+  hashBatch(Span<const Span<const uint8_t>> Inputs,
+            Span<uint8_t> Out) noexcept;
+
 private:
   /// Return the sha digest size.
   constexpr static size_t getDigestSize() noexcept;
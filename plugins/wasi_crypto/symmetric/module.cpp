@@ -59,6 +59,8 @@ WasiCryptoSymmetricModule::WasiCryptoSymmetricModule(
               std::make_unique<Symmetric::StateDecrypt>(*Ctx));
   addHostFunc("symmetric_state_decrypt_detached",
               std::make_unique<Symmetric::StateDecryptDetached>(*Ctx));
+  addHostFunc("symmetric_hash_batch",
+              std::make_unique<Symmetric::HashBatch>(*Ctx));
   addHostFunc("symmetric_state_ratchet",
               std::make_unique<Symmetric::StateRatchet>(*Ctx));
   addHostFunc("symmetric_tag_len", std::make_unique<Symmetric::TagLen>(*Ctx));
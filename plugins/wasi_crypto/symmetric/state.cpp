@@ -226,6 +226,23 @@ stateClone(const StateVariant &ClonedStateVariant) noexcept {
       ClonedStateVariant);
 }
 
+WasiCryptoExpect<void> hashBatch(Algorithm Alg,
+                                 Span<const Span<const uint8_t>> Inputs,
+                                 Span<uint8_t> Out) noexcept {
+  return std::visit(
+      [Inputs, Out](auto Factory) noexcept -> WasiCryptoExpect<void> {
+        using FactoryType = decltype(Factory);
+        if constexpr (std::is_same_v<FactoryType, Sha256> ||
+                      std::is_same_v<FactoryType, Sha512> ||
+                      std::is_same_v<FactoryType, Sha512_256>) {
+          return FactoryType::hashBatch(Inputs, Out);
+        } else {
+          return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_OPERATION);
+        }
+      },
+      Alg);
+}
+
 } // namespace Symmetric
 } // namespace WasiCrypto
 } // namespace Host
@@ -95,6 +95,12 @@ WasiCryptoExpect<void> stateRatchet(StateVariant &StateVariant) noexcept;
 WasiCryptoExpect<StateVariant>
 stateClone(const StateVariant &ClonedStateVariant) noexcept;
 
+/// Hash every input without opening a state for each of them. Only the hash
+/// functions are supported.
+WasiCryptoExpect<void> hashBatch(Algorithm Alg,
+                                 Span<const Span<const uint8_t>> Inputs,
+                                 Span<uint8_t> Out) noexcept;
+
 } // namespace Symmetric
 } // namespace WasiCrypto
 } // namespace Host
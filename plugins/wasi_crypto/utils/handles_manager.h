@@ -17,13 +17,17 @@
 
 #include "utils/error.h"
 
-#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
-#include <limits>
-#include <shared_mutex>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
+#include <variant>
+#include <vector>
 
 namespace WasmEdge {
 namespace Host {
@@ -36,7 +40,20 @@ namespace detail {
 /// long`.
 /// @tparam ManagerType The managed content type.
 ///
-/// HandlesManager uses handle as index to represent the managed contents.
+/// HandlesManager keeps the managed contents in a slab of slots, allocated in
+/// chunks which are never moved or freed before the manager. A handle is the
+/// slot index tagged with the generation of the slot, so that a closed handle
+/// is not valid again after its slot is reused.
+///
+/// The lookups are lock-free: a reader pins the slot by increasing its reader
+/// count only if the slot is still open with the same generation. Closing a
+/// slot marks it closed first, then waits for the pinned readers before
+/// destroying the content and putting the slot into the free list.
+///
+/// The handle keeps 8 bits for the type, 8 bits for the generation, and 16
+/// bits for the slot index, so a manager holds at most `MaxHandles` (65536)
+/// live handles, and returns `__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES` beyond.
+/// A closed handle is rejected until its slot is reused 255 times.
 ///
 /// Referenced from:
 /// https://github.com/WebAssembly/wasi-crypto/blob/main/implementations/hostcalls/rust/src/handles.rs
@@ -48,79 +65,166 @@ public:
   BaseHandlesManager &operator=(BaseHandlesManager &&) noexcept = delete;
 
   /// @param TypeID A unique number
-  explicit BaseHandlesManager(uint8_t TypeID) noexcept
-      : LastHandle{TypeID, 0} {}
+  explicit BaseHandlesManager(uint8_t TypeID) noexcept : TypeID(TypeID) {}
 
-  WasiCryptoExpect<void> close(HandleType Handle) noexcept {
-    std::unique_lock<std::shared_mutex> Lock{Mutex};
+  ~BaseHandlesManager() noexcept {
+    for (auto &Chunk : Chunks) {
+      Slot *Slots = Chunk.load(std::memory_order_relaxed);
+      if (Slots == nullptr) {
+        continue;
+      }
+      for (uint32_t I = 0; I < ChunkSize; ++I) {
+        if (Slots[I].State.load(std::memory_order_relaxed) & OpenBit) {
+          Slots[I].value().~ManagerType();
+        }
+      }
+      delete[] Slots;
+    }
+  }
 
-    if (!Map.erase(HandleWrapper(Handle)))
+  WasiCryptoExpect<void> close(HandleType Handle) noexcept {
+    Slot *S = findSlot(Handle);
+    if (S == nullptr) {
       return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_CLOSED);
+    }
 
+    // Mark the slot closed, so that no reader can pin it any more.
+    const uint64_t Open = stateOf(generationOf(Handle)) | OpenBit;
+    uint64_t State = S->State.load(std::memory_order_acquire);
+    do {
+      if ((State & ~ReadersMask) != Open) {
+        return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_CLOSED);
+      }
+    } while (!S->State.compare_exchange_weak(State, State & ~OpenBit,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire));
+
+    // Wait for the readers still copying the content.
+    while (S->State.load(std::memory_order_acquire) & ReadersMask) {
+      std::this_thread::yield();
+    }
+    S->value().~ManagerType();
+    S->State.store(stateOf(nextGeneration(generationOf(Handle))),
+                   std::memory_order_release);
+
+    std::unique_lock<std::mutex> Lock{Mutex};
+    FreeSlots.push_back(indexOf(Handle));
     return {};
   }
 
   /// Constructor a new manager.
   template <typename... Args>
   WasiCryptoExpect<HandleType> registerManager(Args &&...Manager) noexcept {
-    std::unique_lock<std::shared_mutex> Lock{Mutex};
-
-    // Find a handle that can be used and emplace.
-    // Assume that LastHandle is 0x01000000, NextHandle is 0x01000001.
-    auto NextHandle = LastHandle.nextHandle();
-    while (true) {
-      // Try to emplace NextHandle.
-      if (Map.try_emplace(NextHandle, std::forward<Args>(Manager)...).second) {
-        // If success, emplace which indicate the NextHandle not exists in the
-        // managed content. Update the last handle and return it.
-        LastHandle = NextHandle;
-        return LastHandle.Handle;
-      }
-      // Otherwise, the NextHandle Map already exists a content, call NextHandle
-      // and loop.
-      NextHandle = NextHandle.nextHandle();
-
-      // If after looping `many times(2^24 - 1)`, we get 0x01000000 again.
-      if (NextHandle == LastHandle) {
-        // It indicates the hashmap is full.
-        return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
+    std::unique_lock<std::mutex> Lock{Mutex};
+
+    // Reuse a closed slot, or take the next one of the slab.
+    uint32_t Index;
+    if (!FreeSlots.empty()) {
+      Index = FreeSlots.back();
+      FreeSlots.pop_back();
+    } else if (NextIndex < MaxHandles) {
+      Index = NextIndex++;
+      auto &Chunk = Chunks[Index / ChunkSize];
+      if (Chunk.load(std::memory_order_relaxed) == nullptr) {
+        Chunk.store(new Slot[ChunkSize], std::memory_order_release);
       }
+    } else {
+      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
     }
+
+    Slot &S = Chunks[Index / ChunkSize].load(
+        std::memory_order_relaxed)[Index % ChunkSize];
+    const uint64_t State = S.State.load(std::memory_order_relaxed);
+    new (S.Storage) ManagerType(std::forward<Args>(Manager)...);
+    // Publish the content.
+    S.State.store(State | OpenBit, std::memory_order_release);
+    return static_cast<HandleType>(
+        (static_cast<uint32_t>(TypeID) << 24) |
+        (static_cast<uint32_t>(State >> GenerationShift) << IndexBits) |
+        Index);
   }
 
 protected:
-  /// The handle internal representation as [-TypeID-|------CurrentNumber------]
-  union HandleWrapper {
-    static_assert(sizeof(HandleType) == 4, "HandleType must be 4 byte");
-    HandleWrapper(uint8_t TypeID, uint32_t CurrentNumber) noexcept
-        : TypeID(TypeID), CurrentNumber(CurrentNumber) {}
-    explicit HandleWrapper(HandleType Handle) : Handle(Handle) {}
-
-    HandleWrapper nextHandle() noexcept {
-      return {TypeID, static_cast<uint32_t>(CurrentNumber + 1)};
+  /// The handle internal representation as
+  /// [-TypeID-|-Generation-|------Index------].
+  static constexpr uint32_t IndexBits = 16;
+  static constexpr uint32_t ChunkSize = 256;
+  static constexpr uint32_t ChunkCount = (1U << IndexBits) / ChunkSize;
+
+public:
+  /// Maximum count of the live handles.
+  static constexpr uint32_t MaxHandles = ChunkCount * ChunkSize;
+
+protected:
+  /// The slot state as [-Generation-|-Open-|------Readers------].
+  static constexpr uint32_t GenerationShift = 56;
+  static constexpr uint64_t OpenBit = uint64_t(1) << 55;
+  static constexpr uint64_t ReadersMask = OpenBit - 1;
+
+  static_assert(sizeof(HandleType) == 4, "HandleType must be 4 byte");
+
+  struct Slot {
+    /// The generations start from 1, so no handle is 0.
+    std::atomic<uint64_t> State{stateOf(1)};
+    alignas(ManagerType) std::byte Storage[sizeof(ManagerType)];
+
+    ManagerType &value() noexcept {
+      return *std::launder(reinterpret_cast<ManagerType *>(Storage));
     }
+  };
 
-    struct Hash {
-      size_t operator()(const HandleWrapper &Wrapper) const noexcept {
-        return static_cast<size_t>(Wrapper.Handle);
-      }
-    };
+  static constexpr uint64_t stateOf(uint8_t Generation) noexcept {
+    return static_cast<uint64_t>(Generation) << GenerationShift;
+  }
+  static constexpr uint8_t nextGeneration(uint8_t Generation) noexcept {
+    return Generation == UINT8_MAX ? 1 : Generation + 1;
+  }
+  static constexpr uint8_t generationOf(HandleType Handle) noexcept {
+    return static_cast<uint8_t>(static_cast<uint32_t>(Handle) >> IndexBits);
+  }
+  static constexpr uint32_t indexOf(HandleType Handle) noexcept {
+    return static_cast<uint32_t>(Handle) & ((1U << IndexBits) - 1);
+  }
 
-    bool operator==(const HandleWrapper &Wrapper) const noexcept {
-      return Wrapper.Handle == this->Handle;
+  /// Get the slot of the handle, or nullptr if never allocated.
+  Slot *findSlot(HandleType Handle) const noexcept {
+    if ((static_cast<uint32_t>(Handle) >> 24) != TypeID) {
+      return nullptr;
     }
+    const uint32_t Index = indexOf(Handle);
+    Slot *Slots = Chunks[Index / ChunkSize].load(std::memory_order_acquire);
+    return Slots == nullptr ? nullptr : &Slots[Index % ChunkSize];
+  }
 
-    struct {
-      uint8_t TypeID : 8;
-      uint32_t CurrentNumber : 24;
-    };
-    HandleType Handle;
-  };
+  /// Pin the slot of the handle if it is open, and call the function with the
+  /// content before unpinning it.
+  template <typename FuncT>
+  auto withValue(HandleType Handle, FuncT &&Func) noexcept
+      -> std::invoke_result_t<FuncT, ManagerType &> {
+    Slot *S = findSlot(Handle);
+    if (S == nullptr) {
+      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+    }
+    const uint64_t Open = stateOf(generationOf(Handle)) | OpenBit;
+    uint64_t State = S->State.load(std::memory_order_acquire);
+    do {
+      if ((State & ~ReadersMask) != Open) {
+        return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+      }
+    } while (!S->State.compare_exchange_weak(State, State + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire));
+    auto Result = Func(S->value());
+    S->State.fetch_sub(1, std::memory_order_release);
+    return Result;
+  }
 
-  std::shared_mutex Mutex;
-  HandleWrapper LastHandle;
-  std::unordered_map<HandleWrapper, ManagerType, typename HandleWrapper::Hash>
-      Map;
+  const uint8_t TypeID;
+  std::array<std::atomic<Slot *>, ChunkCount> Chunks{};
+  /// The writers are serialized.
+  std::mutex Mutex;
+  uint32_t NextIndex = 0;
+  std::vector<uint32_t> FreeSlots;
 };
 
 template <typename T, typename VariantType> struct IsVariantMember;
@@ -136,45 +240,38 @@ template <typename HandleType, typename ManagerType,
               false>
 class RcHandlesManager
     : public detail::BaseHandlesManager<HandleType, ManagerType> {
-  using HandleWrapper =
-      typename detail::BaseHandlesManager<HandleType,
-                                          ManagerType>::HandleWrapper;
-
 public:
   using detail::BaseHandlesManager<HandleType, ManagerType>::BaseHandlesManager;
 
   /// Get the return copy.
   WasiCryptoExpect<ManagerType> get(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
-
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
-      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
-    }
-    return HandleValue->second;
+    return this->withValue(Handle,
+                           [](ManagerType &Value) noexcept
+                           -> WasiCryptoExpect<ManagerType> { return Value; });
   }
 
   /// Get as different variant type.
   template <typename RequiredVariantType>
   WasiCryptoExpect<RequiredVariantType> getAs(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
-
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
-      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
-    }
-    return std::visit(
-        [](auto &&Value) noexcept -> WasiCryptoExpect<RequiredVariantType> {
-          using T = std::decay_t<decltype(Value)>;
-          if constexpr (detail::IsVariantMember<T,
-                                                RequiredVariantType>::value) {
-
-            return Value;
-          } else {
-            return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
-          }
-        },
-        HandleValue->second);
+    return this->withValue(
+        Handle,
+        [](ManagerType &Variant) noexcept
+        -> WasiCryptoExpect<RequiredVariantType> {
+          return std::visit(
+              [](auto &&Value) noexcept
+              -> WasiCryptoExpect<RequiredVariantType> {
+                using T = std::decay_t<decltype(Value)>;
+                if constexpr (detail::IsVariantMember<
+                                  T, RequiredVariantType>::value) {
+
+                  return Value;
+                } else {
+                  return WasiCryptoUnexpect(
+                      __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+                }
+              },
+              Variant);
+        });
   }
 };
 
@@ -182,23 +279,18 @@ public:
 template <typename HandleType, typename ManagerType>
 class RefHandlesManager
     : public detail::BaseHandlesManager<HandleType, ManagerType> {
-  using HandleWrapper =
-      typename detail::BaseHandlesManager<HandleType,
-                                          ManagerType>::HandleWrapper;
-
 public:
   using detail::BaseHandlesManager<HandleType, ManagerType>::BaseHandlesManager;
 
-  /// Get the return reference.
+  /// Get the return reference. It is valid until the handle is closed.
   WasiCryptoExpect<std::reference_wrapper<ManagerType>>
   get(HandleType Handle) noexcept {
-    std::shared_lock<std::shared_mutex> Lock{this->Mutex};
-
-    auto HandleValue = this->Map.find(HandleWrapper(Handle));
-    if (HandleValue == this->Map.end()) {
-      return WasiCryptoUnexpect(__WASI_CRYPTO_ERRNO_INVALID_HANDLE);
-    }
-    return HandleValue->second;
+    return this->withValue(
+        Handle,
+        [](ManagerType &Value) noexcept
+        -> WasiCryptoExpect<std::reference_wrapper<ManagerType>> {
+          return Value;
+        });
   }
 };
 
@@ -22,6 +22,8 @@
 #include "runtime/callingframe.h"
 #include "runtime/hostfunc.h"
 
+#include <vector>
+
 namespace WasmEdge {
 namespace Host {
 namespace WasiCrypto {
@@ -133,6 +135,25 @@ constexpr WasiCryptoExpect<__wasi_size_t> toWasiSize(size_t Size) noexcept {
   return static_cast<__wasi_size_t>(Size);
 }
 
+/// Get the buffers of the array of (pointer, length) pairs in the memory.
+inline WasiCryptoExpect<std::vector<Span<const uint8_t>>>
+getBufferList(const Runtime::Instance::MemoryInstance &MemInst, uint32_t Ptr,
+              uint32_t Count) noexcept {
+  const auto Pairs =
+      MemInst.getSpan<const uint32_t>(Ptr, static_cast<uint64_t>(Count) * 2);
+  ensureOrReturn(Pairs.size() == static_cast<uint64_t>(Count) * 2,
+                 __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
+  std::vector<Span<const uint8_t>> Buffers;
+  Buffers.reserve(Count);
+  for (uint32_t I = 0; I < Count; ++I) {
+    const __wasi_size_t Len = Pairs[I * 2 + 1];
+    Buffers.push_back(MemInst.getSpan<const uint8_t>(Pairs[I * 2], Len));
+    ensureOrReturn(Buffers.back().size() == Len,
+                   __WASI_CRYPTO_ERRNO_ALGORITHM_FAILURE);
+  }
+  return Buffers;
+}
+
 /// Convert string_view to inner Alg representation.
 template <typename T> WasiCryptoExpect<T> tryFrom(std::string_view) noexcept;
 
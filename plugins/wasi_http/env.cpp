@@ -4,11 +4,273 @@
 #include "env.h"
 #include "module.h"
 
+#include "common/spdlog.h"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace std::literals;
+
 namespace WasmEdge {
 namespace Host {
 
+namespace {
+
+/// Workers sending the requests of an environment.
+constexpr size_t WorkerCount = 4;
+/// Idle sessions kept for every host.
+constexpr size_t MaxIdleSessions = 8;
+
+/// Idle sessions of every scheme, host and port, shared by all the
+/// environments. A session keeps its connections alive, so the next request
+/// to the host skips the TCP and TLS handshakes.
+std::mutex SessionMutex;
+std::map<std::string, std::vector<std::unique_ptr<cpr::Session>>, std::less<>>
+    Sessions;
+
+/// The scheme, host and port part of the URI.
+std::string_view getOrigin(std::string_view URI) noexcept {
+  auto Start = URI.find("://"sv);
+  Start = (Start == std::string_view::npos) ? 0 : Start + 3;
+  return URI.substr(0, URI.find_first_of("/?#"sv, Start));
+}
+
+std::unique_ptr<cpr::Session> acquireSession(std::string_view Origin) {
+  {
+    std::unique_lock Lock(SessionMutex);
+    if (auto It = Sessions.find(Origin);
+        It != Sessions.end() && !It->second.empty()) {
+      auto Session = std::move(It->second.back());
+      It->second.pop_back();
+      return Session;
+    }
+  }
+  auto Session = std::make_unique<cpr::Session>();
+  // Negotiate HTTP/2 over TLS, falling back to HTTP/1.1.
+  Session->SetHttpVersion(
+      cpr::HttpVersion{cpr::HttpVersionCode::VERSION_2_0_TLS});
+  return Session;
+}
+
+void releaseSession(std::string_view Origin,
+                    std::unique_ptr<cpr::Session> Session) {
+  std::unique_lock Lock(SessionMutex);
+  auto It = Sessions.find(Origin);
+  if (It == Sessions.end()) {
+    It = Sessions.try_emplace(std::string(Origin)).first;
+  }
+  if (It->second.size() < MaxIdleSessions) {
+    It->second.push_back(std::move(Session));
+  }
+}
+
+} // namespace
+
 WasiHttpEnvironment::WasiHttpEnvironment() noexcept {}
 
+WasiHttpEnvironment::~WasiHttpEnvironment() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopping = true;
+    for (auto &[Handle, Req] : Requests) {
+      Req->Closed = true;
+    }
+  }
+  Cond.notify_all();
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+}
+
+uint32_t WasiHttpEnvironment::send(std::string Method, std::string URI,
+                                   std::string Body) noexcept {
+  std::transform(Method.begin(), Method.end(), Method.begin(),
+                 [](unsigned char C) { return std::toupper(C); });
+  if (Method != "GET"sv && Method != "POST"sv && Method != "PUT"sv &&
+      Method != "DELETE"sv && Method != "HEAD"sv && Method != "PATCH"sv &&
+      Method != "OPTIONS"sv) {
+    spdlog::error("[WASI-HTTP] unsupported method: {}"sv, Method);
+    return 0;
+  }
+  auto Req = std::make_shared<Request>();
+  Req->Method = std::move(Method);
+  Req->URI = std::move(URI);
+  Req->Body = std::move(Body);
+
+  std::unique_lock Lock(Mutex);
+  // Start the workers on the first request.
+  while (Workers.size() < WorkerCount) {
+    Workers.emplace_back([this]() { run(); });
+  }
+  const uint32_t Handle = NextHandle++;
+  if (NextHandle == 0) {
+    NextHandle = 1;
+  }
+  Requests.emplace(Handle, Req);
+  Queue.push_back(std::move(Req));
+  Lock.unlock();
+  Cond.notify_all();
+  return Handle;
+}
+
+WasiHttpEnvironment::RequestState
+WasiHttpEnvironment::getState(uint32_t Handle) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Requests.find(Handle); It != Requests.end()) {
+    return It->second->State;
+  }
+  spdlog::error("[WASI-HTTP] unknown request: {}"sv, Handle);
+  return RequestState::Failed;
+}
+
+uint32_t WasiHttpEnvironment::getStatus(uint32_t Handle) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Requests.find(Handle); It != Requests.end()) {
+    return It->second->Status;
+  }
+  spdlog::error("[WASI-HTTP] unknown request: {}"sv, Handle);
+  return 0;
+}
+
+std::string WasiHttpEnvironment::read(uint32_t Handle,
+                                      uint32_t Size) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Requests.find(Handle);
+  if (It == Requests.end()) {
+    spdlog::error("[WASI-HTTP] unknown request: {}"sv, Handle);
+    return {};
+  }
+  auto &Req = *It->second;
+  std::string Data;
+  while (!Req.Chunks.empty() && Data.size() < Size) {
+    auto &Chunk = Req.Chunks.front();
+    const size_t N = std::min<size_t>(Chunk.size() - Req.Offset,
+                                      Size - Data.size());
+    if (Req.Offset + N < Chunk.size()) {
+      Data.append(Chunk, Req.Offset, N);
+      Req.Offset += N;
+      break;
+    }
+    if (Data.empty() && Req.Offset == 0) {
+      // Move the whole chunk without copying.
+      Data = std::move(Chunk);
+    } else {
+      Data.append(Chunk, Req.Offset, N);
+    }
+    Req.Chunks.pop_front();
+    Req.Offset = 0;
+  }
+  return Data;
+}
+
+WasiHttpEnvironment::RequestState
+WasiHttpEnvironment::wait(uint32_t Handle) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Requests.find(Handle);
+  if (It == Requests.end()) {
+    spdlog::error("[WASI-HTTP] unknown request: {}"sv, Handle);
+    return RequestState::Failed;
+  }
+  auto Req = It->second;
+  Cond.wait(Lock, [&Req]() { return Req->State != RequestState::Running; });
+  return Req->State;
+}
+
+void WasiHttpEnvironment::close(uint32_t Handle) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = Requests.find(Handle);
+  if (It == Requests.end()) {
+    spdlog::error("[WASI-HTTP] unknown request: {}"sv, Handle);
+    return;
+  }
+  // The running transfer is aborted in its write callback.
+  It->second->Closed = true;
+  Queue.erase(std::remove(Queue.begin(), Queue.end(), It->second),
+              Queue.end());
+  Requests.erase(It);
+}
+
+void WasiHttpEnvironment::perform(Request &Req) noexcept {
+  const auto Origin = getOrigin(Req.URI);
+  auto Session = acquireSession(Origin);
+  Session->SetUrl(cpr::Url{Req.URI});
+  Session->SetBody(cpr::Body{Req.Body});
+  Session->SetHeaderCallback(
+      cpr::HeaderCallback{[this, &Req](auto Header, intptr_t) {
+        // The status line of every response, including the interim ones.
+        std::string_view Line(Header);
+        if (Line.substr(0, 5) == "HTTP/"sv) {
+          const auto Pos = Line.find(' ');
+          uint32_t Status = 0;
+          for (size_t I = Pos + 1; Pos != std::string_view::npos &&
+                                   I < Line.size() && std::isdigit(Line[I]);
+               I++) {
+            Status = Status * 10 + static_cast<uint32_t>(Line[I] - '0');
+          }
+          std::unique_lock Lock(Mutex);
+          Req.Status = Status;
+        }
+        return true;
+      }});
+  // Buffer the body chunks as they arrive, to be read by the guest.
+  Session->SetWriteCallback(
+      cpr::WriteCallback{[this, &Req](auto Data, intptr_t) {
+        std::unique_lock Lock(Mutex);
+        if (Req.Closed) {
+          return false;
+        }
+        Req.Chunks.emplace_back(Data);
+        return true;
+      }});
+
+  cpr::Response Res;
+  if (Req.Method == "GET"sv) {
+    Res = Session->Get();
+  } else if (Req.Method == "POST"sv) {
+    Res = Session->Post();
+  } else if (Req.Method == "PUT"sv) {
+    Res = Session->Put();
+  } else if (Req.Method == "DELETE"sv) {
+    Res = Session->Delete();
+  } else if (Req.Method == "HEAD"sv) {
+    Res = Session->Head();
+  } else if (Req.Method == "PATCH"sv) {
+    Res = Session->Patch();
+  } else {
+    Res = Session->Options();
+  }
+
+  const bool Failed = Res.error.code != cpr::ErrorCode::OK;
+  if (Failed) {
+    spdlog::error("[WASI-HTTP] {} {} failed: {}"sv, Req.Method, Req.URI,
+                  Res.error.message);
+  } else {
+    // Keep the connections alive for the next request to the host.
+    releaseSession(Origin, std::move(Session));
+  }
+  {
+    std::unique_lock Lock(Mutex);
+    Req.Status = static_cast<uint32_t>(Res.status_code);
+    Req.State = Failed ? RequestState::Failed : RequestState::Done;
+  }
+  Cond.notify_all();
+}
+
+void WasiHttpEnvironment::run() noexcept {
+  std::unique_lock Lock(Mutex);
+  while (true) {
+    Cond.wait(Lock, [this]() { return Stopping || !Queue.empty(); });
+    if (Stopping) {
+      return;
+    }
+    auto Req = std::move(Queue.front());
+    Queue.pop_front();
+    Lock.unlock();
+    perform(*Req);
+    Lock.lock();
+  }
+}
+
 namespace {
 
 Runtime::Instance::ComponentInstance *
@@ -4,7 +4,15 @@
 
 #include "plugin/plugin.h"
 
+#include <condition_variable>
+#include <cpr/cpr.h>
 #include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace WasmEdge {
@@ -13,6 +21,52 @@ namespace Host {
 class WasiHttpEnvironment {
 public:
   WasiHttpEnvironment() noexcept;
+  ~WasiHttpEnvironment() noexcept;
+
+  enum class RequestState : uint32_t { Running = 0, Done = 1, Failed = 2 };
+
+  /// Send the request in the background. Returns the handle of the request,
+  /// or 0 if the method is not supported.
+  uint32_t send(std::string Method, std::string URI, std::string Body) noexcept;
+
+  /// Getter of the state and the status code of the request. The status code
+  /// is 0 until the response headers are received.
+  RequestState getState(uint32_t Handle) noexcept;
+  uint32_t getStatus(uint32_t Handle) noexcept;
+
+  /// Take at most the size of the received response body. Returns an empty
+  /// string if nothing is received since the last read.
+  std::string read(uint32_t Handle, uint32_t Size) noexcept;
+
+  /// Wait for the request to end.
+  RequestState wait(uint32_t Handle) noexcept;
+
+  /// Forget the request, and abort it if still running.
+  void close(uint32_t Handle) noexcept;
+
+private:
+  struct Request {
+    std::string Method;
+    std::string URI;
+    std::string Body;
+    uint32_t Status = 0;
+    RequestState State = RequestState::Running;
+    /// Received body chunks not read yet, and the read bytes of the first one.
+    std::deque<std::string> Chunks;
+    size_t Offset = 0;
+    bool Closed = false;
+  };
+
+  void perform(Request &Req) noexcept;
+  void run() noexcept;
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::map<uint32_t, std::shared_ptr<Request>> Requests;
+  std::deque<std::shared_ptr<Request>> Queue;
+  std::vector<std::thread> Workers;
+  uint32_t NextHandle = 1;
+  bool Stopping = false;
 };
 
 } // namespace Host
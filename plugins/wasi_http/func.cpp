@@ -22,11 +22,39 @@ Expect<void> WasiHttpPrint::body(std::string S) {
 
 Expect<std::string> WasiHttpGet::body(std::string URI) {
   spdlog::info("[WASI-HTTP] URI: {}"sv, URI);
-  cpr::Response Res = cpr::Get(
-      cpr::Url{URI}, cpr::Authentication{"user", "pass", cpr::AuthMode::BASIC});
-  spdlog::info("[WASI-HTTP] status: {}"sv, Res.status_code);
+  const uint32_t Handle = Env.send("GET", std::move(URI), {});
+  Env.wait(Handle);
+  spdlog::info("[WASI-HTTP] status: {}"sv, Env.getStatus(Handle));
+
+  std::string Text;
+  for (auto Chunk = Env.read(Handle, UINT32_MAX); !Chunk.empty();
+       Chunk = Env.read(Handle, UINT32_MAX)) {
+    Text += Chunk;
+  }
+  Env.close(Handle);
+  return Text;
+}
+
+Expect<uint32_t> WasiHttpSend::body(std::string Method, std::string URI,
+                                    std::string Body) {
+  return Env.send(std::move(Method), std::move(URI), std::move(Body));
+}
+
+Expect<uint32_t> WasiHttpPoll::body(uint32_t Handle) {
+  return static_cast<uint32_t>(Env.getState(Handle));
+}
 
-  return std::move(Res.text);
+Expect<uint32_t> WasiHttpStatus::body(uint32_t Handle) {
+  return Env.getStatus(Handle);
+}
+
+Expect<std::string> WasiHttpRead::body(uint32_t Handle, uint32_t Size) {
+  return Env.read(Handle, Size);
+}
+
+Expect<void> WasiHttpClose::body(uint32_t Handle) {
+  Env.close(Handle);
+  return {};
 }
 
 } // namespace Host
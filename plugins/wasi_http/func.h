@@ -21,5 +21,35 @@ public:
   Expect<std::string> body(std::string URI);
 };
 
+class WasiHttpSend : public WasiHttp<WasiHttpSend> {
+public:
+  WasiHttpSend(WasiHttpEnvironment &HostEnv) : WasiHttp(HostEnv) {}
+  Expect<uint32_t> body(std::string Method, std::string URI, std::string Body);
+};
+
+class WasiHttpPoll : public WasiHttp<WasiHttpPoll> {
+public:
+  WasiHttpPoll(WasiHttpEnvironment &HostEnv) : WasiHttp(HostEnv) {}
+  Expect<uint32_t> body(uint32_t Handle);
+};
+
+class WasiHttpStatus : public WasiHttp<WasiHttpStatus> {
+public:
+  WasiHttpStatus(WasiHttpEnvironment &HostEnv) : WasiHttp(HostEnv) {}
+  Expect<uint32_t> body(uint32_t Handle);
+};
+
+class WasiHttpRead : public WasiHttp<WasiHttpRead> {
+public:
+  WasiHttpRead(WasiHttpEnvironment &HostEnv) : WasiHttp(HostEnv) {}
+  Expect<std::string> body(uint32_t Handle, uint32_t Size);
+};
+
+class WasiHttpClose : public WasiHttp<WasiHttpClose> {
+public:
+  WasiHttpClose(WasiHttpEnvironment &HostEnv) : WasiHttp(HostEnv) {}
+  Expect<void> body(uint32_t Handle);
+};
+
 } // namespace Host
 } // namespace WasmEdge
@@ -12,6 +12,11 @@ namespace Host {
 WasiHttpModule::WasiHttpModule() : ComponentInstance("wasi:http/test") {
   addHostFunc("http-get", std::make_unique<WasiHttpGet>(Env));
   addHostFunc("print", std::make_unique<WasiHttpPrint>(Env));
+  addHostFunc("http-send", std::make_unique<WasiHttpSend>(Env));
+  addHostFunc("http-poll", std::make_unique<WasiHttpPoll>(Env));
+  addHostFunc("http-status", std::make_unique<WasiHttpStatus>(Env));
+  addHostFunc("http-read", std::make_unique<WasiHttpRead>(Env));
+  addHostFunc("http-close", std::make_unique<WasiHttpClose>(Env));
 }
 
 } // namespace Host
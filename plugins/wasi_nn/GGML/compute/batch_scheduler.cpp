@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "batch_scheduler.h"
+#include "GGML/utils.h"
+
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
+#include <algorithm>
+#endif
+
+namespace WasmEdge::Host::WASINN::GGML {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
+
+BatchScheduler::BatchScheduler(uint32_t NSeqMax) noexcept
+    : SeqUsers(std::max(NSeqMax, UINT32_C(1)), 0),
+      SeqTokens(SeqUsers.size()),
+      Batch(allocBatch(static_cast<int64_t>(SeqUsers.size()))) {}
+
+BatchScheduler::~BatchScheduler() noexcept { llama_batch_free(Batch); }
+
+llama_seq_id BatchScheduler::acquireSequence() noexcept {
+  std::unique_lock Lock(Mutex);
+  auto It = std::min_element(SeqUsers.begin(), SeqUsers.end());
+  ++*It;
+  return static_cast<llama_seq_id>(It - SeqUsers.begin());
+}
+
+void BatchScheduler::releaseSequence(llama_seq_id SeqId) noexcept {
+  std::unique_lock Lock(Mutex);
+  assuming(static_cast<size_t>(SeqId) < SeqUsers.size());
+  assuming(SeqUsers[SeqId] > 0);
+  --SeqUsers[SeqId];
+}
+
+ErrNo BatchScheduler::decode(llama_context *LlamaContext,
+                             DecodeStep &Step) noexcept {
+  assuming(static_cast<size_t>(Step.SeqId) < SeqUsers.size());
+  std::unique_lock Lock(Mutex);
+  Pending.push_back(&Step);
+  while (true) {
+    // Wait for a decode with this step, or lead the next one.
+    Cond.wait(Lock, [&]() { return Step.Done || !Busy; });
+    if (Step.Done) {
+      return Step.Status;
+    }
+    Busy = true;
+
+    // Take the pending steps in order, one per sequence. The steps of
+    // contexts sharing a sequence are left to the next decode.
+    std::vector<DecodeStep *> Steps;
+    std::vector<DecodeStep *> Deferred;
+    std::vector<bool> Taken(SeqUsers.size(), false);
+    for (auto *S : Pending) {
+      if (Taken[S->SeqId]) {
+        Deferred.push_back(S);
+      } else {
+        Taken[S->SeqId] = true;
+        Steps.push_back(S);
+      }
+    }
+    Pending = std::move(Deferred);
+    Lock.unlock();
+
+    Batch.n_tokens = static_cast<int32_t>(Steps.size());
+    for (size_t I = 0; I < Steps.size(); I++) {
+      Batch.token[I] = Steps[I]->Token;
+      Batch.pos[I] = Steps[I]->Pos;
+      Batch.n_seq_id[I] = 1;
+      Batch.seq_id[I][0] = Steps[I]->SeqId;
+      Batch.logits[I] = true;
+    }
+    ErrNo Status = ErrNo::Success;
+    if (auto Res = llama_decode(LlamaContext, Batch); Res == 1) {
+      LOG_ERROR(
+          "decode: failed to llama_decode: try reducing the number of "sv
+          "parallel sequences or increasing the size of context."sv)
+      Status = ErrNo::RuntimeError;
+    } else if (Res < 0) {
+      LOG_ERROR(
+          "decode: failed to llama_decode: fatal error. Please open an "sv
+          "issue on GitHub."sv)
+      Status = ErrNo::RuntimeError;
+    }
+    for (size_t I = 0; I < Steps.size(); I++) {
+      Steps[I]->Status = Status;
+      if (Status != ErrNo::Success) {
+        continue;
+      }
+      auto &Cached = SeqTokens[Steps[I]->SeqId];
+      if (Cached.size() >= static_cast<size_t>(Steps[I]->Pos)) {
+        Cached.resize(Steps[I]->Pos);
+        Cached.push_back(Steps[I]->Token);
+      }
+      if (Steps[I]->OnDecoded) {
+        Steps[I]->OnDecoded(static_cast<int32_t>(I));
+      }
+    }
+
+    Lock.lock();
+    for (auto *S : Steps) {
+      S->Done = true;
+    }
+    Busy = false;
+    Cond.notify_all();
+  }
+}
+
+uint32_t BatchScheduler::reusePrefix(llama_context *LlamaContext,
+                                     llama_seq_id SeqId,
+                                     Span<const llama_token> Tokens) noexcept {
+  assuming(static_cast<size_t>(SeqId) < SeqTokens.size());
+  auto *Memory = llama_get_memory(LlamaContext);
+  const auto *Model = llama_get_model(LlamaContext);
+  llama_seq_id Source = SeqId;
+  size_t Len = 0;
+  // The recurrent states cannot be cut at a position.
+  if (!Tokens.empty() && !llama_model_is_recurrent(Model) &&
+      !llama_model_is_hybrid(Model)) {
+    const size_t MaxLen = Tokens.size() - 1;
+    for (size_t Seq = 0; Seq < SeqTokens.size(); Seq++) {
+      const auto &Cached = SeqTokens[Seq];
+      const auto SeqIdx = static_cast<llama_seq_id>(Seq);
+      // Skip the sequences whose first cells are evicted by the sliding
+      // window.
+      if (Cached.empty() || llama_memory_seq_pos_min(Memory, SeqIdx) != 0) {
+        continue;
+      }
+      const auto End = Cached.begin() + std::min(Cached.size(), MaxLen);
+      const auto N = static_cast<size_t>(
+          std::mismatch(Cached.begin(), End, Tokens.begin()).first -
+          Cached.begin());
+      // Prefer the own sequence which needs no copy.
+      if (N > Len || (N == Len && SeqIdx == SeqId)) {
+        Len = N;
+        Source = SeqIdx;
+      }
+    }
+  }
+
+  if (Source == SeqId) {
+    if (!llama_memory_seq_rm(Memory, SeqId, static_cast<llama_pos>(Len),
+                             -1)) {
+      llama_memory_seq_rm(Memory, SeqId, -1, -1);
+      Len = 0;
+    }
+  } else {
+    llama_memory_seq_rm(Memory, SeqId, -1, -1);
+    llama_memory_seq_cp(Memory, Source, SeqId, 0, static_cast<llama_pos>(Len));
+  }
+  SeqTokens[SeqId].assign(Tokens.begin(), Tokens.begin() + Len);
+  return static_cast<uint32_t>(Len);
+}
+
+void BatchScheduler::appendTokens(llama_seq_id SeqId,
+                                  Span<const llama_token> Tokens) noexcept {
+  assuming(static_cast<size_t>(SeqId) < SeqTokens.size());
+  SeqTokens[SeqId].insert(SeqTokens[SeqId].end(), Tokens.begin(),
+                          Tokens.end());
+}
+
+void BatchScheduler::clearSequence(llama_context *LlamaContext,
+                                   llama_seq_id SeqId) noexcept {
+  assuming(static_cast<size_t>(SeqId) < SeqTokens.size());
+  llama_memory_seq_rm(llama_get_memory(LlamaContext), SeqId, -1, -1);
+  SeqTokens[SeqId].clear();
+}
+
+void BatchScheduler::resetSequences() noexcept {
+  for (auto &Cached : SeqTokens) {
+    Cached.clear();
+  }
+}
+
+void BatchScheduler::finish() noexcept {
+  std::unique_lock Lock(Mutex);
+  Busy = false;
+  Cond.notify_all();
+}
+
+#endif
+} // namespace WasmEdge::Host::WASINN::GGML
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+#include "GGML/core/ggml_core.h"
+
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#endif
+
+namespace WasmEdge::Host::WASINN::GGML {
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
+// A single token decode step of a context.
+struct DecodeStep {
+  llama_token Token;
+  llama_seq_id SeqId;
+  llama_pos Pos;
+  // Called by the decoding thread with the logits index of the token, before
+  // the next decode overwrites the logits.
+  std::function<void(int32_t)> OnDecoded;
+  ErrNo Status = ErrNo::Success;
+  bool Done = false;
+};
+
+// Continuous batching of the contexts sharing a graph. The single token
+// decode steps submitted while a decode is running are merged into one
+// llama_decode over their sequence ids. The prompt evaluations use the whole
+// llama context and run exclusively between the merged decodes.
+//
+// The scheduler also records the tokens in the KV cache of every sequence,
+// so that a prompt can start from the longest cached prefix of any sequence.
+class BatchScheduler {
+public:
+  BatchScheduler(uint32_t NSeqMax) noexcept;
+  ~BatchScheduler() noexcept;
+  BatchScheduler(const BatchScheduler &) = delete;
+  BatchScheduler &operator=(const BatchScheduler &) = delete;
+
+  // Get a sequence id for a new context. The least used one is shared if
+  // there are more contexts than sequences.
+  llama_seq_id acquireSequence() noexcept;
+  void releaseSequence(llama_seq_id SeqId) noexcept;
+
+  // Decode the step together with the pending steps of other contexts.
+  ErrNo decode(llama_context *LlamaContext, DecodeStep &Step) noexcept;
+
+  // The following functions must run in exclusive().
+
+  // Keep or copy the longest cached prefix of the tokens into the sequence,
+  // and remove the rest of the sequence. Returns the prefix length, which is
+  // shorter than the tokens to leave the last one for the logits.
+  uint32_t reusePrefix(llama_context *LlamaContext, llama_seq_id SeqId,
+                       Span<const llama_token> Tokens) noexcept;
+  // Record the tokens decoded after the prefix of the sequence.
+  void appendTokens(llama_seq_id SeqId,
+                    Span<const llama_token> Tokens) noexcept;
+  // Remove the whole sequence.
+  void clearSequence(llama_context *LlamaContext,
+                     llama_seq_id SeqId) noexcept;
+  // Forget all the records when the llama context is recreated.
+  void resetSequences() noexcept;
+
+  // Run the function without any decode in flight.
+  template <typename FuncT> auto exclusive(FuncT &&Func) noexcept {
+    std::unique_lock Lock(Mutex);
+    Cond.wait(Lock, [this]() { return !Busy; });
+    Busy = true;
+    Lock.unlock();
+    if constexpr (std::is_void_v<std::invoke_result_t<FuncT>>) {
+      Func();
+      finish();
+    } else {
+      auto Result = Func();
+      finish();
+      return Result;
+    }
+  }
+
+private:
+  void finish() noexcept;
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::vector<DecodeStep *> Pending;
+  bool Busy = false;
+  // Contexts using every sequence id.
+  std::vector<uint32_t> SeqUsers;
+  // Tokens in the KV cache of every sequence, from position 0. Empty if the
+  // sequence is unknown, e.g. after a multimodal prompt.
+  std::vector<std::vector<llama_token>> SeqTokens;
+  // One token for every sequence.
+  llama_batch Batch;
+};
+#endif
+} // namespace WasmEdge::Host::WASINN::GGML
@@ -5,11 +5,6 @@
 #include "GGML/tts/tts_core.h"
 #include "inference_manager.h"
 
-#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
-#include <mtmd-helper.h>
-#include <mtmd.h>
-#endif
-
 namespace WasmEdge::Host::WASINN::GGML {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
 
@@ -26,26 +21,9 @@ Expect<ErrNo> compute(WasiNNEnvironment &Env, uint32_t ContextId) noexcept {
   }
 
   // Evaluate the input tokens.
-  ErrNo ReturnCode = ErrNo::Success;
-  if (GraphRef.VisionContext == nullptr) {
-    // Text only prompt.
-    ReturnCode = evaluateInput(GraphRef, CxtRef, "compute"sv);
-    if (ReturnCode != ErrNo::Success) {
-      return ReturnCode;
-    }
-  } else {
-    // Multimodal prompt.
-    llama_pos NewNPos;
-    int32_t Res = mtmd_helper_eval_chunks(
-        GraphRef.VisionContext.get(), GraphRef.LlamaContext.get(),
-        GraphRef.VisionInputChunks.get(), CxtRef.NPos,
-        /* seq_id */ 0, static_cast<int32_t>(CxtRef.CurrentBatchSize),
-        /* logits_last */ true, &NewNPos);
-    CxtRef.NPos = NewNPos;
-    if (Res != 0) {
-      RET_ERROR(ErrNo::InvalidArgument,
-                "compute: unable to eval the mtmd prompt."sv)
-    }
+  ErrNo ReturnCode = evaluatePrompt(GraphRef, CxtRef, "compute"sv);
+  if (ReturnCode != ErrNo::Success) {
+    return ReturnCode;
   }
 
   // Main prediction loop.
@@ -103,25 +81,9 @@ Expect<ErrNo> computeSingle(WasiNNEnvironment &Env,
     clearContext(GraphRef, CxtRef);
 
     // Evaluate the input tokens.
-    if (GraphRef.VisionContext == nullptr) {
-      // Text only prompt.
-      ReturnCode = evaluateInput(GraphRef, CxtRef, "compute"sv);
-      if (ReturnCode != ErrNo::Success) {
-        return ReturnCode;
-      }
-    } else {
-      // Multimodal prompt.
-      llama_pos NewNPos;
-      int32_t Res = mtmd_helper_eval_chunks(
-          GraphRef.VisionContext.get(), GraphRef.LlamaContext.get(),
-          GraphRef.VisionInputChunks.get(), CxtRef.NPos,
-          /* seq_id */ 0, static_cast<int32_t>(CxtRef.CurrentBatchSize),
-          /* logits_last */ true, &NewNPos);
-      CxtRef.NPos = NewNPos;
-      if (Res != 0) {
-        RET_ERROR(ErrNo::InvalidArgument,
-                  "compute: unable to eval the mtmd prompt."sv)
-      }
+    ReturnCode = evaluatePrompt(GraphRef, CxtRef, "compute"sv);
+    if (ReturnCode != ErrNo::Success) {
+      return ReturnCode;
     }
   }
 
@@ -140,5 +102,65 @@ Expect<ErrNo> computeSingle(WasiNNEnvironment &Env,
   return ReturnCode;
 }
 
+Expect<ErrNo> computeStream(WasiNNEnvironment &Env, uint32_t ContextId,
+                            Span<uint8_t> Ring,
+                            StreamHeader &Header) noexcept {
+  auto &CxtRef = Env.NNContext[ContextId].get<Context>();
+  auto &GraphRef = Env.NNGraph[CxtRef.GraphId].get<Graph>();
+  LOG_DEBUG(GraphRef.EnableDebugLog, "computeStream"sv)
+
+  // Write the pending bytes into the free space of the ring buffer, which may
+  // be read by other guest threads at the same time. Returns true if all the
+  // pending bytes are written.
+  auto Flush = [&]() noexcept {
+    const uint32_t Written = Header.Written.load(std::memory_order_relaxed);
+    const uint32_t Used =
+        Written - Header.Read.load(std::memory_order_acquire);
+    const size_t Free = Used < Ring.size() ? Ring.size() - Used : 0;
+    const size_t N = std::min(Free, CxtRef.StreamPending.size());
+    for (size_t I = 0; I < N;) {
+      const size_t Pos = (Written + I) % Ring.size();
+      const size_t Len = std::min(N - I, Ring.size() - Pos);
+      std::copy_n(CxtRef.StreamPending.data() + I, Len, Ring.data() + Pos);
+      I += Len;
+    }
+    CxtRef.StreamPending.erase(0, N);
+    Header.Written.store(Written + static_cast<uint32_t>(N),
+                         std::memory_order_release);
+    return CxtRef.StreamPending.empty();
+  };
+
+  // Generate tokens until the ring buffer is full, so that the guest gets
+  // many tokens in one call.
+  const uint64_t NPredict = CxtRef.Conf.NPredict < 0
+                                ? UINT64_MAX
+                                : static_cast<uint64_t>(CxtRef.Conf.NPredict);
+  while (Flush()) {
+    if (CxtRef.StreamEnd.has_value()) {
+      const ErrNo ReturnCode = *CxtRef.StreamEnd;
+      CxtRef.StreamEnd.reset();
+      Header.Done.store(1, std::memory_order_release);
+      LOG_DEBUG(GraphRef.EnableDebugLog, "computeStream...Done"sv)
+      return ReturnCode;
+    }
+    if (CxtRef.ComputeSingleStarted &&
+        CxtRef.LlamaOutputTokens.size() >= NPredict) {
+      CxtRef.StreamEnd = ErrNo::Success;
+      continue;
+    }
+    auto Res = computeSingle(Env, ContextId);
+    if (!Res) {
+      return Unexpect(Res);
+    }
+    if (*Res != ErrNo::Success) {
+      CxtRef.StreamEnd = *Res == ErrNo::EndOfSequence ? ErrNo::Success : *Res;
+      continue;
+    }
+    CxtRef.StreamPending += common_token_to_piece(
+        GraphRef.LlamaContext.get(), CxtRef.LlamaOutputTokens.back());
+  }
+  return ErrNo::Success;
+}
+
 #endif
 } // namespace WasmEdge::Host::WASINN::GGML
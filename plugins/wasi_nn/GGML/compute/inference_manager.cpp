@@ -3,9 +3,15 @@
 
 #include "inference_manager.h"
 #include "GGML/core/ggml_core.h"
+#include "batch_scheduler.h"
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
 #include <fmt/ranges.h>
+#include <mtmd-helper.h>
+#include <mtmd.h>
+#include <speculative.h>
+
+#include <algorithm>
 #endif
 
 namespace WasmEdge::Host::WASINN::GGML {
@@ -14,7 +20,8 @@ namespace {
 
 // Fill tokens (smaller than batch size) into a batch with position data.
 void fillBatch(Span<const llama_token> Tokens, Graph &GraphRef,
-               llama_batch &Batch, int &NPos, bool IsLogit = false) {
+               llama_batch &Batch, int &NPos, llama_seq_id SeqId,
+               bool IsLogit = false) {
   assuming(GraphRef.Params.n_batch >= static_cast<int64_t>(Tokens.size()));
   assuming(Batch.token != nullptr);
   assuming(Batch.pos != nullptr);
@@ -24,6 +31,8 @@ void fillBatch(Span<const llama_token> Tokens, Graph &GraphRef,
   for (uint32_t I = 0; I < Tokens.size(); I++) {
     Batch.token[I] = Tokens[I];
     Batch.pos[I] = NPos + I;
+    Batch.n_seq_id[I] = 1;
+    Batch.seq_id[I][0] = SeqId;
     Batch.logits[I] = false;
   }
 
@@ -36,20 +45,29 @@ void fillBatch(Span<const llama_token> Tokens, Graph &GraphRef,
   NPos += static_cast<int>(Tokens.size());
 }
 
-// Evaluate tokens. Construct the tokens into batch and decode.
-ErrNo evaluateTokens(Span<const llama_token> Tokens, Graph &GraphRef,
-                     llama_batch &Batch, int &NPos,
-                     bool IsLogits = false) noexcept {
+// Check if the tokens fit in the rest of the context.
+ErrNo checkContextSize(Graph &GraphRef, int NPos, size_t NTokens) noexcept {
   // End the inference if the context is full.
   uint32_t NCtx = llama_n_ctx(GraphRef.LlamaContext.get());
-  if (NPos + static_cast<uint32_t>(Tokens.size()) > NCtx) {
+  if (NPos + static_cast<uint32_t>(NTokens) > NCtx) {
     LOG_INFO(
         GraphRef.EnableLog,
         "evaluateTokens: the context if full ({} / {} tokens). Please increase your "sv
         "context size."sv,
-        NPos + static_cast<uint32_t>(Tokens.size()), NCtx)
+        NPos + static_cast<uint32_t>(NTokens), NCtx)
     return ErrNo::ContextFull;
   }
+  return ErrNo::Success;
+}
+
+// Evaluate tokens. Construct the tokens into batch and decode.
+ErrNo evaluateTokens(Span<const llama_token> Tokens, Graph &GraphRef,
+                     llama_batch &Batch, int &NPos, llama_seq_id SeqId,
+                     bool IsLogits = false) noexcept {
+  if (auto Res = checkContextSize(GraphRef, NPos, Tokens.size());
+      Res != ErrNo::Success) {
+    return Res;
+  }
 
   // Loop for decode batch. Split tokens into batch size length.
   for (int I = 0; I < static_cast<int>(Tokens.size());
@@ -61,7 +79,7 @@ ErrNo evaluateTokens(Span<const llama_token> Tokens, Graph &GraphRef,
 
     // Fill the batch with pos information.
     fillBatch(Span<const llama_token>(Tokens.begin() + I, NEval), GraphRef,
-              Batch, NPos,
+              Batch, NPos, SeqId,
               IsLogits && I + NEval >= static_cast<int>(Tokens.size()));
 
     // Decode the batch.
@@ -101,6 +119,115 @@ void buildOutputEmbedding(std::string &Embedding, int32_t NEmbd,
                   R"("embedding": [{:.10}]}})"sv,
                   NEmbd, fmt::join(Embeddings, Embeddings + NEmbd, ","sv));
 }
+
+void buildOutputEmbeddings(std::string &Embedding, int32_t NEmbd,
+                           size_t NSeq, const float *Embeddings) noexcept {
+  // Embedding matrix format
+  // | Content                                  |
+  // | ---------------------------------------- |
+  // | '{"n_embedding": '                       |
+  // | n_embedding                              |
+  // | ', "n_sequence": '                       |
+  // | n_sequence                               |
+  // | ', "embedding": ['                       |
+  // | n_sequence*('[' embedding values ']')    |
+  // | (n_sequence-1)*(',')                     |
+  // | ']}'                                     |
+  Embedding = fmt::format(R"({{"n_embedding": {}, "n_sequence": {}, )"
+                          R"("embedding": [)"sv,
+                          NEmbd, NSeq);
+  for (size_t I = 0; I < NSeq; ++I) {
+    const float *Row = Embeddings + I * NEmbd;
+    fmt::format_to(std::back_inserter(Embedding), "{}[{:.10}]"sv,
+                   I > 0 ? ","sv : ""sv, fmt::join(Row, Row + NEmbd, ","sv));
+  }
+  Embedding += "]}"sv;
+}
+
+// Sample the next output token from the logits of the last decode.
+void sampleNext(Graph &GraphRef, Context &CxtRef, int32_t Idx) noexcept {
+  CxtRef.NextToken = common_sampler_sample(
+      CxtRef.LlamaSampler, GraphRef.LlamaContext.get(), Idx);
+  common_sampler_accept(CxtRef.LlamaSampler, CxtRef.NextToken,
+                        /* accept_grammar */ true);
+}
+
+// Decode the output token with the tokens drafted after it, and sample the
+// next token and the accepted draft tokens from their logits. Returns nullopt
+// if there is no draft to verify.
+std::optional<ErrNo> decodeDraft(Graph &GraphRef, Context &CxtRef,
+                                 llama_token Id) noexcept {
+  const auto &SpecParams = GraphRef.Params.speculative;
+  // Leave the room of the output token in the batch and the context.
+  const int32_t NCtx =
+      static_cast<int32_t>(llama_n_ctx(GraphRef.LlamaContext.get()));
+  const int32_t NDraft = std::min(
+      {static_cast<int32_t>(SpecParams.n_max),
+       static_cast<int32_t>(GraphRef.Params.n_batch) - 1,
+       NCtx - CxtRef.NPos - 1});
+  if (NDraft < std::max(static_cast<int32_t>(SpecParams.n_min), 1)) {
+    return std::nullopt;
+  }
+
+  // The draft context is shared by the contexts of the graph, so the draft
+  // runs without any decode in flight as the prompts.
+  return GraphRef.Scheduler->exclusive(
+      [&]() noexcept -> std::optional<ErrNo> {
+        // The tokens in the KV cache of the sequence before the output token.
+        llama_tokens Prompt = CxtRef.LlamaInputs;
+        Prompt.insert(Prompt.end(), CxtRef.LlamaOutputTokens.begin(),
+                      CxtRef.LlamaOutputTokens.end() - 1);
+        if (Prompt.size() != static_cast<size_t>(CxtRef.NPos)) {
+          return std::nullopt;
+        }
+        if (GraphRef.Speculative == nullptr) {
+          GraphRef.Speculative = common_speculative_init(
+              GraphRef.LlamaContext.get(), GraphRef.DraftContext.get());
+        }
+        common_speculative_params Params;
+        Params.n_draft = NDraft;
+        Params.p_min = SpecParams.p_min;
+        llama_tokens Draft = common_speculative_gen_draft(
+            GraphRef.Speculative, Params, Prompt, Id);
+        if (Draft.size() > static_cast<size_t>(NDraft)) {
+          Draft.resize(NDraft);
+        }
+        if (Draft.empty() ||
+            Draft.size() < static_cast<size_t>(SpecParams.n_min)) {
+          return std::nullopt;
+        }
+
+        // Decode the output token and the draft with all their logits.
+        llama_tokens Tokens{Id};
+        Tokens.insert(Tokens.end(), Draft.begin(), Draft.end());
+        int32_t NPos = CxtRef.NPos;
+        fillBatch(Tokens, GraphRef, CxtRef.LlamaBatch, NPos, CxtRef.SeqId);
+        std::fill_n(CxtRef.LlamaBatch.logits, CxtRef.LlamaBatch.n_tokens,
+                    true);
+        if (llama_decode(GraphRef.LlamaContext.get(), CxtRef.LlamaBatch) !=
+            0) {
+          RET_ERROR(ErrNo::RuntimeError,
+                    "sampleOutput: failed to llama_decode the draft."sv)
+        }
+
+        // The accepted draft tokens followed by the next sampled token. Keep
+        // the output token and the accepted draft tokens in the KV cache.
+        const auto Accepted = common_sampler_sample_and_accept_n(
+            CxtRef.LlamaSampler, GraphRef.LlamaContext.get(), Draft);
+        const auto NKept = static_cast<int32_t>(Accepted.size());
+        llama_memory_seq_rm(llama_get_memory(GraphRef.LlamaContext.get()),
+                            CxtRef.SeqId, CxtRef.NPos + NKept, -1);
+        GraphRef.Scheduler->appendTokens(
+            CxtRef.SeqId, Span<const llama_token>(Tokens).first(NKept));
+        CxtRef.NPos += NKept;
+        LOG_DEBUG(GraphRef.EnableDebugLog,
+                  "sampleOutput: accepted {} of {} draft tokens"sv, NKept - 1,
+                  Draft.size())
+        CxtRef.NextToken = Accepted.front();
+        CxtRef.Speculated.assign(Accepted.begin() + 1, Accepted.end());
+        return ErrNo::Success;
+      });
+}
 } // namespace
 
 // Evaluate the input tokens. Clean all inputs if succeeded.
@@ -127,32 +254,189 @@ ErrNo evaluateInput(Graph &GraphRef, Context &CxtRef,
               LogPrefix, CxtRef.LlamaInputs.size(), MaxTokensListSize)
   }
 
-  // Evaluate input tokens.
-  ReturnCode =
-      evaluateTokens(Span<const llama_token>(CxtRef.LlamaInputs.begin(),
-                                             CxtRef.LlamaInputs.size()),
-                     GraphRef, CxtRef.LlamaBatch, CxtRef.NPos, true);
+  // Evaluate input tokens after the reused prefix.
+  assuming(static_cast<size_t>(CxtRef.NPos) < CxtRef.LlamaInputs.size());
+  const auto Tokens =
+      Span<const llama_token>(CxtRef.LlamaInputs).subspan(CxtRef.NPos);
+  ReturnCode = evaluateTokens(Tokens, GraphRef, CxtRef.LlamaBatch, CxtRef.NPos,
+                              CxtRef.SeqId, true);
   if (ReturnCode != ErrNo::Success) {
     RET_ERROR(ReturnCode, "{}: failed to evaluate input tokens."sv, LogPrefix)
   }
+  GraphRef.Scheduler->appendTokens(CxtRef.SeqId, Tokens);
 
   return ErrNo::Success;
 }
 
-// Clear the context and reset the sampler.
+// Evaluate the text or multimodal prompt and sample the first output token.
+ErrNo evaluatePrompt(Graph &GraphRef, Context &CxtRef,
+                     std::string_view LogPrefix) noexcept {
+  // The prompt uses the whole batch, so it is not merged with the decode
+  // steps of other contexts.
+  return GraphRef.Scheduler->exclusive([&]() noexcept {
+    if (GraphRef.VisionContext == nullptr) {
+      // Text only prompt. Start from the longest prefix in the KV cache.
+      CxtRef.NPos = static_cast<int32_t>(GraphRef.Scheduler->reusePrefix(
+          GraphRef.LlamaContext.get(), CxtRef.SeqId, CxtRef.LlamaInputs));
+      LOG_DEBUG(GraphRef.EnableDebugLog, "{}: reuse {} cached tokens"sv,
+                LogPrefix, CxtRef.NPos)
+      auto ReturnCode = evaluateInput(GraphRef, CxtRef, LogPrefix);
+      if (ReturnCode != ErrNo::Success) {
+        return ReturnCode;
+      }
+    } else {
+      // Multimodal prompt.
+      GraphRef.Scheduler->clearSequence(GraphRef.LlamaContext.get(),
+                                        CxtRef.SeqId);
+      llama_pos NewNPos;
+      int32_t Res = mtmd_helper_eval_chunks(
+          GraphRef.VisionContext.get(), GraphRef.LlamaContext.get(),
+          GraphRef.VisionInputChunks.get(), CxtRef.NPos, CxtRef.SeqId,
+          static_cast<int32_t>(CxtRef.CurrentBatchSize),
+          /* logits_last */ true, &NewNPos);
+      CxtRef.NPos = NewNPos;
+      if (Res != 0) {
+        RET_ERROR(ErrNo::InvalidArgument,
+                  "{}: unable to eval the mtmd prompt."sv, LogPrefix)
+      }
+    }
+    // Use idx = -1 to sample from the last logits of the prompt.
+    sampleNext(GraphRef, CxtRef, -1);
+    return ErrNo::Success;
+  });
+}
+
+// Clear the context and reset the sampler. The sequence in the KV cache is
+// kept for the prefix reuse of the next prompt.
 void clearContext(Graph &GraphRef, Context &CxtRef) noexcept {
   LOG_DEBUG(GraphRef.EnableDebugLog, "{}: clearContext"sv)
-  llama_memory_clear(llama_get_memory(GraphRef.LlamaContext.get()), true);
   common_sampler_reset(CxtRef.LlamaSampler);
   CxtRef.NPos = 0;
+  CxtRef.NextToken = LLAMA_TOKEN_NULL;
+  CxtRef.Speculated.clear();
   CxtRef.LlamaOutputs.clear();
   CxtRef.LlamaOutputTokens.clear();
   LOG_DEBUG(GraphRef.EnableDebugLog, "{}: clearContext...Done"sv)
 }
 
+// Embed the sequences of the context. As many sequences as fit in a ubatch
+// are decoded together, each in its own sequence id, and the pooled
+// embedding of every sequence is a row of the output matrix.
+Expect<ErrNo> getBatchEmbedding(Graph &GraphRef, Context &CxtRef) noexcept {
+  LOG_DEBUG(GraphRef.EnableDebugLog, "getBatchEmbedding"sv)
+  llama_context *LlamaContext = GraphRef.LlamaContext.get();
+
+  if (CxtRef.EmbdInputs.empty()) {
+    RET_ERROR(ErrNo::InvalidArgument,
+              "getBatchEmbedding: llama input is not set!"sv)
+  }
+  if (llama_pooling_type(LlamaContext) == LLAMA_POOLING_TYPE_NONE) {
+    RET_ERROR(
+        ErrNo::InvalidArgument,
+        "getBatchEmbedding: the batched embedding needs a pooling-type other than none."sv)
+  }
+
+  // The sequences of a decode must fit in one ubatch, since the pooled
+  // embeddings need all the tokens of the sequence.
+  const uint32_t NMaxTokens =
+      std::min(llama_n_batch(LlamaContext), llama_n_ubatch(LlamaContext));
+  const llama_seq_id NSeqMax =
+      static_cast<llama_seq_id>(llama_n_seq_max(LlamaContext));
+  const size_t NSeq = CxtRef.EmbdInputs.size();
+  for (size_t I = 0; I < CxtRef.EmbdInputs.size(); ++I) {
+    if (CxtRef.EmbdInputs[I].empty()) {
+      RET_ERROR(ErrNo::InvalidArgument,
+                "getBatchEmbedding: the sequence {} is empty."sv, I)
+    }
+    if (CxtRef.EmbdInputs[I].size() > NMaxTokens) {
+      RET_ERROR(
+          ErrNo::PromptTooLong,
+          "getBatchEmbedding: the sequence {} has {} tokens exceeds batch "sv
+          "size {}. Please reduce the input size or increase your batch-size "sv
+          "and ubatch-size."sv,
+          I, CxtRef.EmbdInputs[I].size(), NMaxTokens)
+    }
+  }
+
+  // The sequence ids of the other contexts are borrowed. They hold no prefix
+  // worth reusing in an embedding graph, since every embedding clears them.
+  const int32_t NEmbd = llama_model_n_embd(GraphRef.LlamaModel.get());
+  std::vector<float> Embeddings(NSeq * NEmbd);
+  auto ReturnCode = GraphRef.Scheduler->exclusive([&]() noexcept {
+    const llama_seq_id NUsed =
+        static_cast<llama_seq_id>(std::min<size_t>(NSeqMax, NSeq));
+    size_t Next = 0;
+    auto Res = ErrNo::Success;
+    while (Next < NSeq && Res == ErrNo::Success) {
+      // Pack the next sequences into the batch.
+      const size_t First = Next;
+      common_batch_clear(CxtRef.LlamaBatch);
+      for (llama_seq_id SeqId = 0; Next < NSeq && SeqId < NSeqMax;
+           ++SeqId, ++Next) {
+        const auto &Tokens = CxtRef.EmbdInputs[Next];
+        if (CxtRef.LlamaBatch.n_tokens + Tokens.size() > NMaxTokens) {
+          break;
+        }
+        GraphRef.Scheduler->clearSequence(LlamaContext, SeqId);
+        for (size_t I = 0; I < Tokens.size(); ++I) {
+          common_batch_add(CxtRef.LlamaBatch, Tokens[I],
+                           static_cast<llama_pos>(I), {SeqId}, true);
+        }
+      }
+
+      if (llama_decode(LlamaContext, CxtRef.LlamaBatch) != 0) {
+        LOG_ERROR("getBatchEmbedding: failed to decode the sequences {} to "sv
+                  "{}."sv,
+                  First, Next - 1)
+        Res = ErrNo::RuntimeError;
+        break;
+      }
+
+      // Normalize the pooled embeddings into the rows of the sequences.
+      for (size_t I = First; I < Next; ++I) {
+        const auto *Embd = llama_get_embeddings_seq(
+            LlamaContext, static_cast<llama_seq_id>(I - First));
+        if (Embd == nullptr) {
+          LOG_ERROR("getBatchEmbedding: failed to get embeddings for the "sv
+                    "sequence {}."sv,
+                    I)
+          Res = ErrNo::RuntimeError;
+          break;
+        }
+        common_embd_normalize(Embd, Embeddings.data() + I * NEmbd, NEmbd,
+                              static_cast<int32_t>(CxtRef.Conf.EmbdNormalize));
+      }
+    }
+
+    // Free the borrowed sequences for the next prompts.
+    for (llama_seq_id SeqId = 0; SeqId < NUsed; ++SeqId) {
+      GraphRef.Scheduler->clearSequence(LlamaContext, SeqId);
+    }
+    return Res;
+  });
+  if (ReturnCode != ErrNo::Success) {
+    return ReturnCode;
+  }
+
+  std::string EmbeddingString;
+  buildOutputEmbeddings(EmbeddingString, NEmbd, NSeq, Embeddings.data());
+  CxtRef.LlamaOutputs =
+      std::vector<uint8_t>(EmbeddingString.begin(), EmbeddingString.end());
+
+  if (GraphRef.EnableLog) {
+    common_perf_print(LlamaContext, /* Sampler */ nullptr);
+  }
+
+  LOG_DEBUG(GraphRef.EnableDebugLog, "getBatchEmbedding...Done"sv)
+  return ErrNo::Success;
+}
+
 // TODO: Merge into compute.
 Expect<ErrNo> getEmbedding(Graph &GraphRef, Context &CxtRef) noexcept {
   LOG_DEBUG(GraphRef.EnableDebugLog, "getEmbedding"sv)
+  if (CxtRef.Conf.EmbdBatch) {
+    return getBatchEmbedding(GraphRef, CxtRef);
+  }
 
   const llama_vocab *Vocab = llama_model_get_vocab(GraphRef.LlamaModel.get());
   // Add SEP if not present.
@@ -174,35 +458,44 @@ Expect<ErrNo> getEmbedding(Graph &GraphRef, Context &CxtRef) noexcept {
         CxtRef.LlamaInputs.size(), GraphRef.Params.n_batch)
   }
 
-  // Evaluate the input tokens.
-  auto ReturnCode = evaluateInput(GraphRef, CxtRef, "getEmbedding"sv);
-  if (ReturnCode != ErrNo::Success) {
-    return ReturnCode;
-  }
-
-  // Main prediction loop.
+  // Evaluate the input tokens and read the embeddings before other contexts
+  // decode.
   const int32_t NEmbd = llama_model_n_embd(GraphRef.LlamaModel.get());
   std::vector<float> Embeddings(NEmbd);
-
-  for (int I = 0; I < CxtRef.LlamaBatch.n_tokens; I++) {
-    if (!CxtRef.LlamaBatch.logits[I]) {
-      continue;
+  auto ReturnCode = GraphRef.Scheduler->exclusive([&]() noexcept {
+    // The pooled embeddings need all the tokens in the batch.
+    GraphRef.Scheduler->clearSequence(GraphRef.LlamaContext.get(),
+                                      CxtRef.SeqId);
+    auto Res = evaluateInput(GraphRef, CxtRef, "getEmbedding"sv);
+    if (Res != ErrNo::Success) {
+      return Res;
     }
 
-    // Try to get sequence embeddings.
-    auto *Embd = llama_get_embeddings_seq(GraphRef.LlamaContext.get(),
-                                          CxtRef.LlamaBatch.seq_id[I][0]);
-    if (Embd == nullptr) {
-      Embd = llama_get_embeddings_ith(GraphRef.LlamaContext.get(), I);
-      if (Embd == nullptr) {
-        LOG_ERROR("getEmbedding: failed to get embeddings for token {}"sv, I);
+    for (int I = 0; I < CxtRef.LlamaBatch.n_tokens; I++) {
+      if (!CxtRef.LlamaBatch.logits[I]) {
         continue;
       }
-    }
 
-    // Normalize the embeddings.
-    common_embd_normalize(Embd, Embeddings.data(), NEmbd,
-                          static_cast<int32_t>(CxtRef.Conf.EmbdNormalize));
+      // Try to get sequence embeddings.
+      auto *Embd = llama_get_embeddings_seq(GraphRef.LlamaContext.get(),
+                                            CxtRef.LlamaBatch.seq_id[I][0]);
+      if (Embd == nullptr) {
+        Embd = llama_get_embeddings_ith(GraphRef.LlamaContext.get(), I);
+        if (Embd == nullptr) {
+          LOG_ERROR("getEmbedding: failed to get embeddings for token {}"sv,
+                    I);
+          continue;
+        }
+      }
+
+      // Normalize the embeddings.
+      common_embd_normalize(Embd, Embeddings.data(), NEmbd,
+                            static_cast<int32_t>(CxtRef.Conf.EmbdNormalize));
+    }
+    return ErrNo::Success;
+  });
+  if (ReturnCode != ErrNo::Success) {
+    return ReturnCode;
   }
 
   std::string EmbeddingString;
@@ -218,13 +511,10 @@ Expect<ErrNo> getEmbedding(Graph &GraphRef, Context &CxtRef) noexcept {
   return ErrNo::Success;
 }
 
-// Sample and get the output token.
+// Get the output token sampled after the last decode, then decode it.
 ErrNo sampleOutput(Graph &GraphRef, Context &CxtRef,
                    bool IsSingleTokenMode) noexcept {
-  // Use idx = -1 to sample the next token.
-  const llama_token Id = common_sampler_sample(
-      CxtRef.LlamaSampler, GraphRef.LlamaContext.get(), /* idx */ -1);
-  common_sampler_accept(CxtRef.LlamaSampler, Id, /* accept_grammar */ true);
+  const llama_token Id = CxtRef.NextToken;
 
   // Save the output token.
   CxtRef.LlamaOutputTokens.emplace_back(Id);
@@ -252,13 +542,38 @@ ErrNo sampleOutput(Graph &GraphRef, Context &CxtRef,
   const llama_vocab *Vocab = llama_model_get_vocab(GraphRef.LlamaModel.get());
   // Only stop on EOS if GraphRef.Params.sampling.ignore_eos is false.
   if (!GraphRef.Params.sampling.ignore_eos &&
-      llama_vocab_is_eog(Vocab, common_sampler_last(CxtRef.LlamaSampler))) {
+      llama_vocab_is_eog(Vocab, Id)) {
     LOG_INFO(GraphRef.EnableLog, "sampleOutput: EOS token found."sv)
     return ErrNo::EndOfSequence;
   }
-  // Evaluate the output token.
-  return evaluateTokens(Span<const llama_token>(&Id, 1), GraphRef,
-                        CxtRef.OutputBatch, CxtRef.NPos, true);
+  // Output the draft tokens accepted in the last decode without decoding.
+  if (!CxtRef.Speculated.empty()) {
+    CxtRef.NextToken = CxtRef.Speculated.front();
+    CxtRef.Speculated.pop_front();
+    return ErrNo::Success;
+  }
+  // Verify the tokens drafted after the output token in one decode. The
+  // multimodal prompts are not known by the draft model.
+  if (GraphRef.DraftContext != nullptr && GraphRef.VisionContext == nullptr) {
+    if (auto Res = decodeDraft(GraphRef, CxtRef, Id)) {
+      return *Res;
+    }
+  }
+  // Evaluate the output token together with the other contexts of the graph,
+  // and sample the next token from its logits.
+  if (auto Res = checkContextSize(GraphRef, CxtRef.NPos, 1);
+      Res != ErrNo::Success) {
+    return Res;
+  }
+  DecodeStep Step{Id, CxtRef.SeqId, CxtRef.NPos, [&](int32_t Idx) noexcept {
+                    sampleNext(GraphRef, CxtRef, Idx);
+                  }};
+  auto ReturnCode =
+      GraphRef.Scheduler->decode(GraphRef.LlamaContext.get(), Step);
+  if (ReturnCode == ErrNo::Success) {
+    CxtRef.NPos++;
+  }
+  return ReturnCode;
 }
 
 #endif
@@ -8,8 +8,11 @@ namespace WasmEdge::Host::WASINN::GGML {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
 void clearContext(Graph &GraphRef, Context &CxtRef) noexcept;
 Expect<ErrNo> getEmbedding(Graph &GraphRef, Context &CxtRef) noexcept;
+Expect<ErrNo> getBatchEmbedding(Graph &GraphRef, Context &CxtRef) noexcept;
 ErrNo evaluateInput(Graph &GraphRef, Context &CxtRef,
                     std::string_view LogPrefix) noexcept;
+ErrNo evaluatePrompt(Graph &GraphRef, Context &CxtRef,
+                     std::string_view LogPrefix) noexcept;
 ErrNo sampleOutput(Graph &GraphRef, Context &CxtRef,
                    bool IsSingleTokenMode = false) noexcept;
 #endif
@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
 #include "ggml_core.h"
+#include "GGML/compute/batch_scheduler.h"
 #include "GGML/utils.h"
 #include "common/types.h"
 #include "host/wasi/vfs_io.h"
@@ -20,6 +21,7 @@
 #include <mtmd-helper.h>
 #include <mtmd.h>
 #include <sampling.h>
+#include <speculative.h>
 
 #include <filesystem>
 #include <math.h>
@@ -53,6 +55,25 @@ void llamaLogCallback(ggml_log_level LogLevel, const char *LogText,
     spdlog::debug("[WASI-NN] llama.cpp: {}"sv, Text);
   }
 }
+
+// Models loaded from the preload paths, shared by the graphs of all the VMs.
+SharedRegistry<llama_model> SharedModels;
+
+// Load the model, or share the one loaded by another graph with the same
+// parameters. Returns nullptr if failed.
+std::shared_ptr<llama_model> loadSharedModel(common_params &Params) noexcept {
+  const std::string Key = fmt::format(
+      "{}|{}|{}|{}|{}|{}|{}"sv, Params.model.path, Params.n_gpu_layers,
+      Params.main_gpu, static_cast<int>(Params.split_mode), Params.use_mmap,
+      Params.use_mlock,
+      fmt::join(std::begin(Params.tensor_split), std::end(Params.tensor_split),
+                ","sv));
+  return SharedModels.get(Key, [&Params]() {
+    return std::shared_ptr<llama_model>(
+        llama_model_ptr(llama_model_load_from_file(
+            Params.model.path.c_str(), common_model_params_to_llama(Params))));
+  });
+}
 } // namespace
 
 Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
@@ -87,6 +108,7 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
   GraphRef.Conf.StreamStdout = false;
   GraphRef.Conf.EmbdNormalize =
       static_cast<EmbdNormalizeType>(CommonParamsDefault.embd_normalize);
+  GraphRef.Conf.EmbdBatch = false;
   GraphRef.Conf.NPredict = GraphRef.Params.n_ctx;
   GraphRef.Conf.ReversePrompt = ""sv;
   GraphRef.Conf.ImagePath = ""sv;
@@ -116,7 +138,8 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
   auto Weight = Builders[0];
   const std::string_view BinModel(reinterpret_cast<char *>(Weight.data()),
                                   Weight.size());
-  if (BinModel.substr(0, 8) == "preload:"sv) {
+  const bool IsPreload = BinModel.substr(0, 8) == "preload:"sv;
+  if (IsPreload) {
     GraphRef.Params.model.path = BinModel.substr(8);
   } else {
     LOG_DEBUG(GraphRef.EnableDebugLog,
@@ -163,10 +186,21 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
   llama_backend_init();
   llama_numa_init(Params.numa);
 
-  // Initialize the llama model and context.
-  common_init_result LlamaInit = common_init_from_params(Params);
-  GraphRef.LlamaModel = std::move(LlamaInit.model);
-  GraphRef.LlamaContext = std::move(LlamaInit.context);
+  // Initialize the llama model and context. The preloaded model is shared
+  // with the other graphs unless it needs per-graph adapters or overrides.
+  if (IsPreload && Params.lora_adapters.empty() &&
+      Params.control_vectors.empty() && Params.kv_overrides.empty() &&
+      Params.tensor_buft_overrides.empty() && Params.devices.empty()) {
+    GraphRef.LlamaModel = loadSharedModel(Params);
+    if (GraphRef.LlamaModel != nullptr) {
+      GraphRef.LlamaContext = llama_context_ptr(llama_init_from_model(
+          GraphRef.LlamaModel.get(), common_context_params_to_llama(Params)));
+    }
+  } else {
+    common_init_result LlamaInit = common_init_from_params(Params);
+    GraphRef.LlamaModel = std::move(LlamaInit.model);
+    GraphRef.LlamaContext = std::move(LlamaInit.context);
+  }
   if (GraphRef.LlamaModel == nullptr) {
     Env.deleteGraph(GId.raw());
     RET_ERROR(ErrNo::InvalidArgument, "load: unable to init model."sv)
@@ -175,9 +209,41 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
     Env.deleteGraph(GId.raw());
     RET_ERROR(ErrNo::InvalidArgument, "load: unable to init context."sv)
   }
+  GraphRef.Scheduler = std::make_shared<BatchScheduler>(
+      llama_n_seq_max(GraphRef.LlamaContext.get()));
   LOG_DEBUG(GraphRef.EnableDebugLog,
             "load: initialize ggml model with given parameters...Done"sv)
 
+  // Initialize the draft model and context of the speculative decoding.
+  if (!GraphRef.Params.speculative.model.path.empty()) {
+    LOG_DEBUG(GraphRef.EnableDebugLog, "load: initialize draft model."sv)
+    common_params DraftParams = Params;
+    DraftParams.model = GraphRef.Params.speculative.model;
+    DraftParams.devices = GraphRef.Params.speculative.devices;
+    DraftParams.n_gpu_layers = GraphRef.Params.speculative.n_gpu_layers;
+    if (GraphRef.Params.speculative.n_ctx > 0) {
+      DraftParams.n_ctx = GraphRef.Params.speculative.n_ctx;
+    }
+    // The draft context is shared by the contexts of the graph in turn.
+    DraftParams.n_parallel = 1;
+    DraftParams.lora_adapters.clear();
+    DraftParams.control_vectors.clear();
+    common_init_result DraftInit = common_init_from_params(DraftParams);
+    GraphRef.DraftModel = std::move(DraftInit.model);
+    GraphRef.DraftContext = std::move(DraftInit.context);
+    if (GraphRef.DraftModel == nullptr || GraphRef.DraftContext == nullptr) {
+      Env.deleteGraph(GId.raw());
+      RET_ERROR(ErrNo::InvalidArgument, "load: unable to init draft model."sv)
+    }
+    if (!common_speculative_are_compatible(GraphRef.LlamaContext.get(),
+                                           GraphRef.DraftContext.get())) {
+      Env.deleteGraph(GId.raw());
+      RET_ERROR(ErrNo::InvalidArgument,
+                "load: the draft model is not compatible with the model."sv)
+    }
+    LOG_DEBUG(GraphRef.EnableDebugLog, "load: initialize draft model...Done"sv)
+  }
+
   // Initialize the TTS related model and context.
   if (GraphRef.TextToSpeech) {
     LOG_DEBUG(GraphRef.EnableDebugLog, "load: initialize TTS model."sv)
@@ -218,8 +284,9 @@ Expect<ErrNo> initExecCtx(WasiNNEnvironment &Env, uint32_t GraphId,
   CxtRef.LlamaBatch = allocBatch(GraphRef.Params.n_batch);
   CxtRef.CurrentBatchSize = GraphRef.Params.n_batch;
 
-  // Allocate the batch for output sampling. The batch size is always 1.
-  CxtRef.OutputBatch = allocBatch(1);
+  // Get a sequence id. The output tokens are decoded together with the other
+  // contexts of the graph.
+  CxtRef.SeqId = GraphRef.Scheduler->acquireSequence();
 
   // Allocate sampler.
   CxtRef.LlamaSampler =
@@ -253,6 +320,9 @@ Expect<ErrNo> finiSingle(WasiNNEnvironment &Env, uint32_t ContextId) noexcept {
   common_sampler_reset(CxtRef.LlamaSampler);
   CxtRef.ComputeSingleStarted = false;
   CxtRef.NPos = 0;
+  CxtRef.Speculated.clear();
+  CxtRef.StreamPending.clear();
+  CxtRef.StreamEnd.reset();
 
   LOG_DEBUG(GraphRef.EnableDebugLog, "finiSingle...Done"sv)
   return ErrNo::Success;
@@ -274,6 +344,11 @@ Expect<ErrNo> unload(WasiNNEnvironment &Env, uint32_t GraphId) noexcept {
     GraphRef.LlamaContext.reset();
     LOG_DEBUG(IsDebugLog, "unload: free llama context...Done"sv)
   }
+  if (GraphRef.Scheduler != nullptr) {
+    LOG_DEBUG(IsDebugLog, "unload: free batch scheduler"sv)
+    GraphRef.Scheduler.reset();
+    LOG_DEBUG(IsDebugLog, "unload: free batch scheduler...Done"sv)
+  }
   if (GraphRef.VisionContext != nullptr) {
     LOG_DEBUG(IsDebugLog, "unload: free mtmd context"sv)
     GraphRef.VisionContext.reset();
@@ -284,6 +359,22 @@ Expect<ErrNo> unload(WasiNNEnvironment &Env, uint32_t GraphId) noexcept {
     GraphRef.VisionInputChunks.reset();
     LOG_DEBUG(IsDebugLog, "unload: free mtmd chunks...Done"sv)
   }
+  if (GraphRef.Speculative != nullptr) {
+    LOG_DEBUG(IsDebugLog, "unload: free speculative decoding"sv)
+    common_speculative_free(GraphRef.Speculative);
+    GraphRef.Speculative = nullptr;
+    LOG_DEBUG(IsDebugLog, "unload: free speculative decoding...Done"sv)
+  }
+  if (GraphRef.DraftContext != nullptr) {
+    LOG_DEBUG(IsDebugLog, "unload: free draft context"sv)
+    GraphRef.DraftContext.reset();
+    LOG_DEBUG(IsDebugLog, "unload: free draft context...Done"sv)
+  }
+  if (GraphRef.DraftModel != nullptr) {
+    LOG_DEBUG(IsDebugLog, "unload: free draft model"sv)
+    GraphRef.DraftModel.reset();
+    LOG_DEBUG(IsDebugLog, "unload: free draft model...Done"sv)
+  }
   if (GraphRef.TTSModel != nullptr) {
     LOG_DEBUG(IsDebugLog, "unload: free TTS model"sv)
     GraphRef.TTSModel.reset();
@@ -322,7 +413,7 @@ Expect<ErrNo> finalizeExecCtx(WasiNNEnvironment &Env,
         "finalize_execution_context: free compute_single sampler...Done"sv)
   }
   llama_batch_free(CxtRef.LlamaBatch);
-  llama_batch_free(CxtRef.OutputBatch);
+  GraphRef.Scheduler->releaseSequence(CxtRef.SeqId);
   Env.deleteContext(ContextId);
 
   LOG_DEBUG(GraphRef.EnableDebugLog, "finalize_execution_context...Done"sv)
@@ -363,6 +454,10 @@ Expect<ErrNo> getOutputSingle(WasiNNEnvironment &, uint32_t, uint32_t,
 Expect<ErrNo> computeSingle(WasiNNEnvironment &, uint32_t) noexcept {
   return reportBackendNotSupported();
 }
+Expect<ErrNo> computeStream(WasiNNEnvironment &, uint32_t, Span<uint8_t>,
+                            StreamHeader &) noexcept {
+  return reportBackendNotSupported();
+}
 Expect<ErrNo> finiSingle(WasiNNEnvironment &, uint32_t) noexcept {
   return reportBackendNotSupported();
 }
@@ -39,6 +39,9 @@ Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
                               uint32_t ContextId) noexcept;
 Expect<WASINN::ErrNo> computeSingle(WASINN::WasiNNEnvironment &Env,
                                     uint32_t ContextId) noexcept;
+Expect<WASINN::ErrNo> computeStream(WASINN::WasiNNEnvironment &Env,
+                                    uint32_t ContextId, Span<uint8_t> Ring,
+                                    WASINN::StreamHeader &Header) noexcept;
 Expect<WASINN::ErrNo> unload(WASINN::WasiNNEnvironment &Env,
                              uint32_t GraphId) noexcept;
 Expect<WASINN::ErrNo> finalizeExecCtx(WASINN::WasiNNEnvironment &Env,
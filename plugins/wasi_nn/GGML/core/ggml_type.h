@@ -8,11 +8,14 @@
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
 #include "wasinntypes.h"
+#include <deque>
 #include <ggml.h>
 #include <list>
 #include <llama-cpp.h>
 #include <llama.h>
+#include <memory>
 #include <mtmd.h>
+#include <optional>
 #include <sampling.h>
 
 #endif
@@ -37,12 +40,16 @@ struct LocalConfig {
   // when parsing metadata in set_input.
   bool StreamStdout = false;
   EmbdNormalizeType EmbdNormalize = EmbdNormalizeType::Euclidean;
+  // Embed every part of the prompt split by the embd-sep in one compute.
+  bool EmbdBatch = false;
   int64_t NPredict;
   std::string ReversePrompt;
   std::string ImagePath;
   bool AlwaysRegenerateImageEmbd = false;
 };
 
+class BatchScheduler;
+
 struct Graph {
   // Plugin parameters:
   bool EnableLog = false;
@@ -50,11 +57,19 @@ struct Graph {
   common_params Params;
   std::list<std::string> TensorBuftOverrides;
   // Model context:
-  llama_model_ptr LlamaModel = nullptr;
+  // The preloaded models are shared by the graphs of all the VMs.
+  std::shared_ptr<llama_model> LlamaModel = nullptr;
   llama_context_ptr LlamaContext = nullptr;
+  // Decode steps of the contexts merged over their sequence ids.
+  std::shared_ptr<BatchScheduler> Scheduler = nullptr;
   // Multimodal context:
   mtmd::context_ptr VisionContext = nullptr;
   mtmd::input_chunks_ptr VisionInputChunks = nullptr;
+  // Speculative decoding:
+  // The draft model proposes the tokens verified in one decode of the model.
+  llama_model_ptr DraftModel = nullptr;
+  llama_context_ptr DraftContext = nullptr;
+  struct common_speculative *Speculative = nullptr;
   // Text-to-speech:
   bool TextToSpeech = false;
   std::string TTSOutputFilePath = "output.wav";
@@ -63,6 +78,8 @@ struct Graph {
   llama_context_ptr TTSContext = nullptr;
   // Configs.
   LocalConfig Conf;
+  // Count of the metadata applied to the parameters by set_input.
+  uint64_t MetadataVersion = 0;
 };
 
 struct Context {
@@ -72,6 +89,8 @@ public:
   // Llama inputs:
   std::vector<llama_token> LlamaInputs;
   uint64_t LlamaNInputs = 0;
+  // Tokens of every sequence in the batched embedding mode.
+  std::vector<std::vector<llama_token>> EmbdInputs;
   // Llama outputs:
   std::vector<uint8_t> LlamaOutputs;
   std::vector<llama_token> LlamaOutputTokens;
@@ -81,12 +100,27 @@ public:
   // Handle the batch in the context to prevent from reallocation in every
   // computing.
   struct llama_batch LlamaBatch;
-  struct llama_batch OutputBatch;
   int64_t CurrentBatchSize = 0;
   size_t ImagePosition = 0;
   int32_t NPos = 0;
+  // Sequence id in the llama context shared with other contexts of the graph.
+  llama_seq_id SeqId = 0;
+  // Token sampled after the last decode, to be output next.
+  llama_token NextToken = LLAMA_TOKEN_NULL;
+  // Draft tokens accepted in the last decode, to be output after the next
+  // token.
+  std::deque<llama_token> Speculated;
+  // Output bytes of compute_stream not fit in the ring buffer yet, and the
+  // result of the generation once ended.
+  std::string StreamPending;
+  std::optional<ErrNo> StreamEnd;
   // Configs:
   LocalConfig Conf;
+  // Metadata applied last by set_input, and the metadata version of the graph
+  // after applying it. The same metadata is not applied again if the graph is
+  // not changed by the other contexts since then.
+  std::string Metadata;
+  uint64_t MetadataVersion = 0;
 };
 #else
 struct Graph {};
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
+#include "GGML/compute/batch_scheduler.h"
 #include "GGML/metadata/metadata_parser.h"
 #include "GGML/tts/tts_core.h"
 #include "GGML/utils.h"
@@ -9,6 +10,7 @@
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
 #include <mtmd-helper.h>
 #include <mtmd.h>
+#include <speculative.h>
 #endif
 
 namespace WasmEdge::Host::WASINN::GGML {
@@ -28,6 +30,16 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
     bool IsSamplerParamsUpdated = false;
     const std::string Metadata(reinterpret_cast<char *>(Tensor.Tensor.data()),
                                Tensor.Tensor.size());
+    if (!CxtRef.Metadata.empty() && Metadata == CxtRef.Metadata &&
+        CxtRef.MetadataVersion == GraphRef.MetadataVersion &&
+        Env.NNGraph[CxtRef.GraphId].isReady() &&
+        CxtRef.LlamaSampler != nullptr) {
+      LOG_DEBUG(GraphRef.EnableDebugLog,
+                "setInput: found Metadata, already applied"sv)
+      return ErrNo::Success;
+    }
+    CxtRef.Metadata.clear();
+    ++GraphRef.MetadataVersion;
     auto Res =
         parseMetadata(GraphRef, CxtRef.Conf, Metadata, &IsModelParamsUpdated,
                       &IsContextParamsUpdated, &IsSamplerParamsUpdated);
@@ -83,6 +95,17 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
         Env.NNGraph[CxtRef.GraphId].setInvalid();
         RET_ERROR(ErrNo::InvalidArgument, "setInput: unable to init context."sv)
       }
+      GraphRef.Scheduler->resetSequences();
+      // The speculative decoding is created again with the new context.
+      if (GraphRef.Speculative != nullptr) {
+        common_speculative_free(GraphRef.Speculative);
+        GraphRef.Speculative = nullptr;
+      }
+    } else {
+      // The thread counts are set to the context without rebuilding it.
+      const auto CParams = common_context_params_to_llama(GraphRef.Params);
+      llama_set_n_threads(GraphRef.LlamaContext.get(), CParams.n_threads,
+                          CParams.n_threads_batch);
     }
 
     // Some changes of sampling parameters will require the sampler to be
@@ -109,6 +132,8 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
     }
 
     Env.NNGraph[CxtRef.GraphId].setReady();
+    CxtRef.Metadata = Metadata;
+    CxtRef.MetadataVersion = GraphRef.MetadataVersion;
     LOG_DEBUG(GraphRef.EnableDebugLog,
               "setInput: found Metadata, processing...Done"sv)
     return ErrNo::Success;
@@ -122,10 +147,8 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
         "in set_input or unload graph."sv)
   }
 
-  // Clear the llama context.
-  LOG_DEBUG(GraphRef.EnableDebugLog, "setInput: clear llama context"sv)
-  llama_memory_clear(llama_get_memory(GraphRef.LlamaContext.get()), true);
-  LOG_DEBUG(GraphRef.EnableDebugLog, "setInput: clear llama context...Done"sv)
+  // The sequence of this context in the llama context is kept, and the next
+  // prompt is evaluated after its longest cached prefix.
 
   // Set the input.
   const bool AddSpecial = true;
@@ -133,6 +156,7 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
   std::string Prompt(reinterpret_cast<char *>(Tensor.Tensor.data()),
                      Tensor.Tensor.size());
   CxtRef.LlamaInputs.clear();
+  CxtRef.EmbdInputs.clear();
 
   auto Base64ImagePos = findBase64ImagePayload(Prompt);
 
@@ -264,6 +288,31 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
 
     // Get the number of input tokens (for the metadata).
     CxtRef.LlamaNInputs = CxtRef.LlamaInputs.size();
+  } else if (GraphRef.Params.embedding && CxtRef.Conf.EmbdBatch) {
+    // Sequences of the batched embedding.
+    LOG_DEBUG(GraphRef.EnableDebugLog, "setInput: tokenize embedding batch"sv)
+    const std::string &Sep = GraphRef.Params.embd_sep;
+    CxtRef.LlamaNInputs = 0;
+    size_t Start = 0;
+    while (true) {
+      const size_t End =
+          Sep.empty() ? std::string::npos : Prompt.find(Sep, Start);
+      CxtRef.EmbdInputs.push_back(common_tokenize(
+          GraphRef.LlamaContext.get(), Prompt.substr(Start, End - Start),
+          AddSpecial, ParseSpecial));
+      CxtRef.LlamaNInputs += CxtRef.EmbdInputs.back().size();
+      if (End == std::string::npos) {
+        break;
+      }
+      Start = End + Sep.size();
+      // A trailing separator does not start another sequence.
+      if (Start == Prompt.size()) {
+        break;
+      }
+    }
+    LOG_DEBUG(GraphRef.EnableDebugLog,
+              "setInput: tokenize embedding batch...Done, {} sequences"sv,
+              CxtRef.EmbdInputs.size())
   } else {
     // Text only prompt.
     LOG_DEBUG(GraphRef.EnableDebugLog, "setInput: tokenize text prompt"sv)
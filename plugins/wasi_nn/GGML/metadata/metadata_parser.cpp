@@ -8,6 +8,8 @@
 #include <fmt/ranges.h>
 #include <json-partial.h>
 #include <json-schema-to-grammar.h>
+
+#include <tuple>
 #endif
 
 namespace WasmEdge::Host::WASINN::GGML {
@@ -26,15 +28,22 @@ ErrNo parseMetadata(Graph &GraphRef, LocalConfig &ConfRef,
 
   // Get the current llama parameters.
   int64_t PrevNGPULayers = GraphRef.Params.n_gpu_layers;
-  bool PrevEmbedding = GraphRef.Params.embedding;
+  // Get the current context parameters. The thread counts are not included,
+  // as they are set to the context without rebuilding it.
+  auto ContextParams = [](const common_params &Params) {
+    return std::make_tuple(Params.n_ctx, Params.n_batch, Params.n_ubatch,
+                           Params.embedding, Params.pooling_type,
+                           Params.attention_type, Params.flash_attn_type,
+                           Params.cache_type_k, Params.cache_type_v,
+                           Params.no_kv_offload);
+  };
+  const auto PrevContextParams = ContextParams(GraphRef.Params);
   // Get the current sampler parameters.
-  double PrevTemp = GraphRef.Params.sampling.temp;
-  double PrevTopP = GraphRef.Params.sampling.top_p;
-  double PrevRepeatPenalty = GraphRef.Params.sampling.penalty_repeat;
-  double PrevPresencePenalty = GraphRef.Params.sampling.penalty_present;
-  double PrevFrequencyPenalty = GraphRef.Params.sampling.penalty_freq;
-  std::string PrevGrammar = GraphRef.Params.sampling.grammar;
-  uint32_t PrevSeed = GraphRef.Params.sampling.seed;
+  auto PrintSampling = [](const common_params_sampling &Sampling) {
+    return fmt::format("{}|{}|{}"sv, Sampling.print(), Sampling.grammar,
+                       Sampling.seed);
+  };
+  const std::string PrevSampling = PrintSampling(GraphRef.Params.sampling);
 
   try {
     parseJsonAuto(Doc, "enable-log", GraphRef.EnableLog);
@@ -271,6 +280,8 @@ ErrNo parseMetadata(Graph &GraphRef, LocalConfig &ConfRef,
     parseJsonWithCastAuto<int64_t>(Doc, "seed", GraphRef.Params.sampling.seed);
 
     // The speculative parameters.
+    parseJsonWithCastAuto<std::string_view>(
+        Doc, "model-draft", GraphRef.Params.speculative.model.path);
     parseJsonWithCastAuto<int64_t>(Doc, "n-ctx-speculative",
                                    GraphRef.Params.speculative.n_ctx);
     parseJsonWithCastAuto<int64_t>(Doc, "n-max-speculative",
@@ -393,8 +404,13 @@ ErrNo parseMetadata(Graph &GraphRef, LocalConfig &ConfRef,
     parseJsonWithCastAuto<int64_t>(Doc, "cache-type-v",
                                    GraphRef.Params.cache_type_v);
 
-    parseJsonWithCastAuto<int64_t>(Doc, "embd-normalize",
-                                   GraphRef.Params.embd_normalize);
+    parseJsonWithProcessorAuto<int64_t>(
+        Doc, "embd-normalize", [&](const int64_t &Normalize) -> bool {
+          GraphRef.Params.embd_normalize = static_cast<int32_t>(Normalize);
+          ConfRef.EmbdNormalize = static_cast<EmbdNormalizeType>(Normalize);
+          return true;
+        });
+    parseJsonAuto<bool>(Doc, "embd-batch", ConfRef.EmbdBatch);
     parseJsonWithCastAuto<std::string_view>(Doc, "embd-out",
                                             GraphRef.Params.embd_out);
 
@@ -529,19 +545,14 @@ ErrNo parseMetadata(Graph &GraphRef, LocalConfig &ConfRef,
   }
 
   // Check if the context parameters are updated.
-  if (IsContextUpdated && PrevEmbedding != GraphRef.Params.embedding) {
+  if (IsContextUpdated &&
+      PrevContextParams != ContextParams(GraphRef.Params)) {
     *IsContextUpdated = true;
   }
 
   // Check if the sampler parameters are updated.
   if (IsSamplerUpdated &&
-      (PrevTemp != GraphRef.Params.sampling.temp ||
-       PrevTopP != GraphRef.Params.sampling.top_p ||
-       PrevRepeatPenalty != GraphRef.Params.sampling.penalty_repeat ||
-       PrevPresencePenalty != GraphRef.Params.sampling.penalty_present ||
-       PrevFrequencyPenalty != GraphRef.Params.sampling.penalty_freq ||
-       PrevGrammar != GraphRef.Params.sampling.grammar ||
-       PrevSeed != GraphRef.Params.sampling.seed)) {
+      PrevSampling != PrintSampling(GraphRef.Params.sampling)) {
     *IsSamplerUpdated = true;
   }
 
@@ -7,6 +7,7 @@
 #include "mlx/embedding.h"
 #include "mlx/linear.h"
 #include "transformer.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdio>
 #include <memory>
@@ -133,7 +134,13 @@ Transformer::embed(
   }
   std::optional<mx::array> Mask;
   if (H.shape()[1] > 1) {
-    Mask = nn::MultiHeadAttention::createAdditiveCausalMask(H.shape()[1]);
+    const int L = H.shape()[1];
+    Mask = nn::MultiHeadAttention::createAdditiveCausalMask(L);
+    if (KVCachePar && !KVCachePar->empty()) {
+      // The new tokens attend to all of the cached ones.
+      const int Offset = std::get<0>((*KVCachePar)[0]).shape(2);
+      Mask = mx::concatenate({mx::zeros({L, Offset}, Mask->dtype()), *Mask}, 1);
+    }
     Mask = astype(*Mask, H.dtype());
   }
   std::vector<std::tuple<mx::array, mx::array>> KVCache;
@@ -179,11 +186,13 @@ Transformer::forward(
 
 std::tuple<mx::array,
            std::optional<std::vector<std::tuple<mx::array, mx::array>>>>
-Transformer::stepGenerate(mx::array Input, std::optional<float> Temp) {
+Transformer::stepGenerate(
+    mx::array Input, std::optional<float> Temp,
+    std::optional<std::vector<std::tuple<mx::array, mx::array>>> KVCachePar) {
   // Reshape Input to input[:, None]
   std::vector<int> ReshapeDim = Input.shape();
   ReshapeDim.insert(ReshapeDim.begin(), 1);
-  auto [Logits, KVCache] = forward(reshape(Input, ReshapeDim));
+  auto [Logits, KVCache] = forward(reshape(Input, ReshapeDim), KVCachePar);
   const int H = Logits.shape()[1] - 1;
   // take logits[:, -1, :]
   Logits = take(Logits, mx::array({H}), 1);
@@ -239,15 +248,41 @@ AnserSataus answerSataus(std::string Text, std::string End) {
 Transformer::LLMOutput
 Transformer::generate(const std::string &Prompt, const BasePrompt &ModelPrompt,
                       const int MaxToken, const bool Verbose,
-                      const std::unique_ptr<tokenizers::Tokenizer> &Tok) {
+                      const std::unique_ptr<tokenizers::Tokenizer> &Tok,
+                      PromptCache *Cache) {
   const std::vector<int> Ids = Tok->Encode(Prompt);
-  mx::array Token =
-      mx::array(Ids.data(), {static_cast<int>(Ids.size())}, mx::int32);
+  // Reuse the KV cache of the common prefix with the previous generation, and
+  // keep at least one token to feed.
+  size_t Reused = 0;
+  std::optional<std::vector<std::tuple<mx::array, mx::array>>> Prefix;
+  if (Cache != nullptr && Cache->KVCache && !Ids.empty()) {
+    const size_t Limit = std::min(Cache->Tokens.size(), Ids.size() - 1);
+    while (Reused < Limit && Cache->Tokens[Reused] == Ids[Reused]) {
+      Reused++;
+    }
+    if (Reused > 0) {
+      Prefix.emplace();
+      Prefix->reserve(Cache->KVCache->size());
+      for (const auto &[Keys, Values] : *Cache->KVCache) {
+        auto KeyStop = Keys.shape();
+        auto ValueStop = Values.shape();
+        KeyStop[2] = ValueStop[2] = static_cast<int>(Reused);
+        Prefix->emplace_back(mx::slice(Keys, {0, 0, 0, 0}, KeyStop),
+                             mx::slice(Values, {0, 0, 0, 0}, ValueStop));
+      }
+    }
+    if (Verbose) {
+      spdlog::info("[WASI-NN] MLX backend: Reuse {} cached tokens."sv, Reused);
+    }
+  }
+  mx::array Token = mx::array(
+      Ids.data() + Reused, {static_cast<int>(Ids.size() - Reused)}, mx::int32);
+  std::vector<int> Fed(Ids);
   std::vector<int32_t> TokenList;
   int TokenCount = 0;
   int Skip = 0;
   std::string Answer;
-  auto [Y, KVCache] = this->stepGenerate(Token, 0.1);
+  auto [Y, KVCache] = this->stepGenerate(Token, 0.1, std::move(Prefix));
   while (true) {
     TokenCount++;
     if (TokenCount > MaxToken) {
@@ -272,9 +307,14 @@ Transformer::generate(const std::string &Prompt, const BasePrompt &ModelPrompt,
       }
       Skip = Answer.size();
     }
+    Fed.insert(Fed.end(), Tokens.begin(), Tokens.end());
     auto [NY, NKVCache] = this->nextStepGenerate(Y, 0.1, KVCache);
     Y = NY, KVCache = NKVCache;
   }
+  if (Cache != nullptr) {
+    Cache->Tokens = std::move(Fed);
+    Cache->KVCache = std::move(KVCache);
+  }
   return {Answer, TokenList};
 }
 
@@ -204,6 +204,12 @@ public:
     std::string Answer;
     std::vector<int32_t> TokenList;
   };
+  /// KV cache kept across the generations of a context.
+  struct PromptCache {
+    /// The tokens already fed into the KV cache.
+    std::vector<int> Tokens;
+    std::optional<std::vector<std::tuple<mx::array, mx::array>>> KVCache;
+  };
   std::tuple<mx::array,
              std::optional<std::vector<std::tuple<mx::array, mx::array>>>>
   embed(mx::array Input,
@@ -217,7 +223,9 @@ public:
               KVCachePar = {});
   std::tuple<mx::array,
              std::optional<std::vector<std::tuple<mx::array, mx::array>>>>
-  stepGenerate(mx::array Input, std::optional<float> Temp = 0.0);
+  stepGenerate(mx::array Input, std::optional<float> Temp = 0.0,
+               std::optional<std::vector<std::tuple<mx::array, mx::array>>>
+                   KVCachePar = {});
   std::tuple<mx::array,
              std::optional<std::vector<std::tuple<mx::array, mx::array>>>>
   nextStepGenerate(mx::array Y, std::optional<float> Temp = 0.0,
@@ -225,7 +233,8 @@ public:
                        KVCachePar = {});
   LLMOutput generate(const std::string &Prompt, const BasePrompt &ModelPrompt,
                      const int MaxToken, const bool Verbose,
-                     const std::unique_ptr<tokenizers::Tokenizer> &Tok);
+                     const std::unique_ptr<tokenizers::Tokenizer> &Tok,
+                     PromptCache *Cache = nullptr);
 };
 } // namespace llm
 } // namespace WasmEdge::Host::WASINN::MLX
@@ -378,6 +378,28 @@ ErrNo parseMetadata(Graph &GraphRef, LocalConfig &ConfRef,
                 "Unable to retrieve the mask-valid option."sv)
     }
   }
+  if (Doc.at_key("cpu-range").error() == simdjson::SUCCESS) {
+    std::string_view CpuRange;
+    auto Err = Doc["cpu-range"].get<std::string_view>().get(CpuRange);
+    auto &Mask = GraphRef.Params.cpuparams.cpumask;
+    std::fill(std::begin(Mask), std::end(Mask), false);
+    if (Err || !parse_cpu_range(std::string(CpuRange), Mask)) {
+      RET_ERROR(ErrNo::InvalidArgument,
+                "Unable to retrieve the cpu-range option."sv)
+    }
+    GraphRef.Params.cpuparams.mask_valid = true;
+  }
+  if (Doc.at_key("cpu-range-batch").error() == simdjson::SUCCESS) {
+    std::string_view CpuRange;
+    auto Err = Doc["cpu-range-batch"].get<std::string_view>().get(CpuRange);
+    auto &Mask = GraphRef.Params.cpuparams_batch.cpumask;
+    std::fill(std::begin(Mask), std::end(Mask), false);
+    if (Err || !parse_cpu_range(std::string(CpuRange), Mask)) {
+      RET_ERROR(ErrNo::InvalidArgument,
+                "Unable to retrieve the cpu-range-batch option."sv)
+    }
+    GraphRef.Params.cpuparams_batch.mask_valid = true;
+  }
   if (Doc.at_key("priority").error() == simdjson::SUCCESS) {
     int64_t Priority;
     auto Err = Doc["priority"].get<int64_t>().get(Priority);
@@ -1671,7 +1693,18 @@ ErrNo evaluateTokens(Span<const llama_token> Tokens, Graph &GraphRef,
               Batch, NPos,
               IsLogits && I + NEval >= static_cast<int>(Tokens.size()));
 
-    // Decode the batch.
+    // Decode the batch on the shared thread pools.
+    std::unique_lock<std::mutex> Lock, LockBatch;
+    if (GraphRef.Threads) {
+      Lock = std::unique_lock(GraphRef.Threads->Mutex, std::defer_lock);
+      if (GraphRef.ThreadsBatch != GraphRef.Threads) {
+        LockBatch =
+            std::unique_lock(GraphRef.ThreadsBatch->Mutex, std::defer_lock);
+        std::lock(Lock, LockBatch);
+      } else {
+        Lock.lock();
+      }
+    }
     auto Status = llama_decode(GraphRef.LlamaContext.get(), Batch);
     if (Status == 1) {
       RET_ERROR(
@@ -1690,6 +1723,20 @@ ErrNo evaluateTokens(Span<const llama_token> Tokens, Graph &GraphRef,
   return ErrNo::Success;
 }
 
+// Attach the shared thread pools of the CPU parameters to the context.
+bool attachThreadPools(Graph &GraphRef) noexcept {
+  auto Threads = ThreadPool::get(GraphRef.Params.cpuparams);
+  auto ThreadsBatch = ThreadPool::get(GraphRef.Params.cpuparams_batch);
+  if (!Threads || !ThreadsBatch) {
+    return false;
+  }
+  llama_attach_threadpool(GraphRef.LlamaContext.get(), Threads->Pool,
+                          ThreadsBatch->Pool);
+  GraphRef.Threads = std::move(Threads);
+  GraphRef.ThreadsBatch = std::move(ThreadsBatch);
+  return true;
+}
+
 // Clear the context and reset the sampler.
 void clearContext(Graph &GraphRef, Context &CxtRef) noexcept {
   LOG_DEBUG(GraphRef.EnableDebugLog, "{}: clearContext"sv)
@@ -1857,6 +1904,45 @@ Expect<ErrNo> getEmbedding(Graph &GraphRef, Context &CxtRef) noexcept {
 
 } // namespace
 
+ThreadPool::~ThreadPool() noexcept {
+  if (Pool) {
+    ggml_threadpool_free(Pool);
+  }
+}
+
+std::shared_ptr<ThreadPool>
+ThreadPool::get(const cpu_params &CpuParams) noexcept {
+  static std::mutex Mutex;
+  static std::vector<std::weak_ptr<ThreadPool>> Pools;
+  try {
+    auto Params = ggml_threadpool_params_from_cpu_params(CpuParams);
+    std::unique_lock Lock(Mutex);
+    Pools.erase(std::remove_if(Pools.begin(), Pools.end(),
+                               [](const std::weak_ptr<ThreadPool> &Weak) {
+                                 return Weak.expired();
+                               }),
+                Pools.end());
+    for (const auto &Weak : Pools) {
+      if (auto Shared = Weak.lock();
+          Shared && ggml_threadpool_params_match(&Shared->Params, &Params)) {
+        return Shared;
+      }
+    }
+    auto Shared = std::make_shared<ThreadPool>();
+    Shared->Params = Params;
+    Shared->Pool = ggml_threadpool_new(&Shared->Params);
+    if (Shared->Pool == nullptr) {
+      LOG_ERROR("failed to create the thread pool of {} threads."sv,
+                Params.n_threads)
+      return nullptr;
+    }
+    Pools.push_back(Shared);
+    return Shared;
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
 Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
                    [[maybe_unused]] Device Device, uint32_t &GraphId) noexcept {
   if (Builders.empty()) {
@@ -1998,6 +2084,10 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
     Env.deleteGraph(GId);
     RET_ERROR(ErrNo::InvalidArgument, "load: Unable to init context."sv)
   }
+  if (!attachThreadPools(GraphRef)) {
+    Env.deleteGraph(GId);
+    RET_ERROR(ErrNo::RuntimeError, "load: Unable to create the thread pool."sv)
+  }
 
   LOG_DEBUG(GraphRef.EnableDebugLog,
             "load: initialize model with given parameters...Done"sv)
@@ -2107,6 +2197,12 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
         RET_ERROR(ErrNo::InvalidArgument, "setInput: unable to init context."sv)
       }
     }
+    // The CPU parameters may be changed without reloading the context.
+    if (!attachThreadPools(GraphRef)) {
+      Env.NNGraph[CxtRef.GraphId].setInvalid();
+      RET_ERROR(ErrNo::RuntimeError,
+                "setInput: unable to create the thread pool."sv)
+    }
 
     // Re-initialize sampler if its parameters changed OR if it was cleared.
     if (IsSamplerUpdated || CxtRef.LlamaSampler == nullptr) {
@@ -8,6 +8,7 @@
 #include <common.h>
 #include <llama.h>
 #include <memory>
+#include <mutex>
 #include <sampling.h>
 #endif
 
@@ -61,10 +62,26 @@ struct LocalConfig {
   EmbdNormalizeType EmbdNormalize = EmbdNormalizeType::Euclidean;
 };
 
+// A ggml thread pool shared by the graphs of the same CPU parameters, so that
+// the graphs take turns on the cores instead of oversubscribing them.
+struct ThreadPool {
+  ~ThreadPool() noexcept;
+  // Get the thread pool of the parameters, or create it.
+  static std::shared_ptr<ThreadPool> get(const cpu_params &CpuParams) noexcept;
+
+  ggml_threadpool_params Params;
+  ggml_threadpool *Pool = nullptr;
+  // A thread pool computes one graph at a time.
+  std::mutex Mutex;
+};
+
 struct Graph {
   bool EnableLog = false;
   bool EnableDebugLog = false;
   common_params Params;
+  // The thread pools outlive the context.
+  std::shared_ptr<ThreadPool> Threads;
+  std::shared_ptr<ThreadPool> ThreadsBatch;
   LlamaModelPtr LlamaModel = nullptr;
   LlamaContextPtr LlamaContext = nullptr;
   LocalConfig Conf;
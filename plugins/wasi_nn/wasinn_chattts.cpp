@@ -9,9 +9,24 @@
 
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
     !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
 #endif
+#include <atomic>
 #include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string_view>
 #include <time.h>
 #endif
 
@@ -23,6 +38,311 @@ HINSTANCE SharedLib = LoadLibrary(PYTHON_LIB_PATH);
 #else
 void *SharedLib = dlopen(PYTHON_LIB_PATH, RTLD_GLOBAL | RTLD_NOW);
 #endif
+
+namespace {
+// The worker serves the computes on the socket of the argv[1] fd, and returns
+// the audio in the shared memory of the argv[2] fd.
+constexpr std::string_view kWorkerScript = R"PY(
+import json, mmap, socket, struct, sys
+import ChatTTS
+
+conn = socket.socket(fileno=int(sys.argv[1]))
+shm = mmap.mmap(int(sys.argv[2]), int(sys.argv[3]))
+chat = ChatTTS.Chat()
+chat.load()
+
+
+def recv(size):
+    buf = bytearray()
+    while len(buf) < size:
+        chunk = conn.recv(size - len(buf))
+        if not chunk:
+            sys.exit(0)
+        buf += chunk
+    return bytes(buf)
+
+
+def params(metadata):
+    kwargs = {}
+    if not metadata:
+        return kwargs
+    doc = json.loads(metadata)
+    if "prompt" in doc:
+        prompt = doc["prompt"]
+        kwargs["params_refine_text"] = chat.RefineTextParams(prompt=prompt)
+    infer = {k: doc[k] for k in ("temperature", "top_K", "top_P") if k in doc}
+    if "spk_emb" in doc:
+        spk = doc["spk_emb"]
+        if spk == "random":
+            spk = chat.sample_random_speaker()
+        infer["spk_emb"] = spk
+    if infer:
+        kwargs["params_infer_code"] = chat.InferCodeParams(**infer)
+    return kwargs
+
+
+while True:
+    text = recv(struct.unpack("<I", recv(4))[0]).decode()
+    metadata = recv(struct.unpack("<I", recv(4))[0]).decode()
+    try:
+        wav = chat.infer(text, **params(metadata))[0].tobytes()
+    except Exception as e:
+        print(f"[WASI-NN] ChatTTS worker: {e}", file=sys.stderr)
+        conn.sendall(struct.pack("<IQ", 1, 0))
+        continue
+    if len(wav) <= len(shm):
+        shm[: len(wav)] = wav
+        conn.sendall(struct.pack("<IQ", 0, len(wav)))
+    else:
+        conn.sendall(struct.pack("<IQ", 2, len(wav)) + wav)
+)PY";
+
+// Size of the shared memory of a worker, about 10 minutes of audio. The
+// longer audio is sent on the socket.
+constexpr size_t kSharedSize = 64 * 1024 * 1024;
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool sendAll(int Fd, const void *Data, size_t Size) noexcept {
+  const auto *Ptr = static_cast<const char *>(Data);
+  while (Size > 0) {
+    const auto Sent = ::send(Fd, Ptr, Size, kSendFlags);
+    if (Sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    Ptr += Sent;
+    Size -= static_cast<size_t>(Sent);
+  }
+  return true;
+}
+
+bool recvAll(int Fd, void *Data, size_t Size) noexcept {
+  auto *Ptr = static_cast<char *>(Data);
+  while (Size > 0) {
+    const auto Received = ::recv(Fd, Ptr, Size, 0);
+    if (Received <= 0) {
+      if (Received < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    Ptr += Received;
+    Size -= static_cast<size_t>(Received);
+  }
+  return true;
+}
+
+// Create the shared memory as an unlinked file, on tmpfs if possible.
+int createSharedFile() noexcept {
+  std::error_code Error;
+  std::filesystem::path Dir = "/dev/shm";
+  if (!std::filesystem::is_directory(Dir, Error)) {
+    Dir = std::filesystem::temp_directory_path(Error);
+  }
+  std::string Path = (Dir / "wasmedge-chattts-XXXXXX").string();
+  const int Fd = ::mkstemp(Path.data());
+  if (Fd < 0) {
+    return -1;
+  }
+  ::unlink(Path.c_str());
+  if (::ftruncate(Fd, kSharedSize) != 0) {
+    ::close(Fd);
+    return -1;
+  }
+  return Fd;
+}
+#endif
+} // namespace
+
+class WorkerPool {
+public:
+  WorkerPool() noexcept = default;
+  ~WorkerPool() noexcept {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+    for (auto &W : Workers) {
+      ::kill(W->Pid, SIGTERM);
+      ::close(W->Socket);
+      ::munmap(W->Shared, kSharedSize);
+      int Status;
+      ::waitpid(W->Pid, &Status, 0);
+    }
+#endif
+  }
+
+  static std::shared_ptr<WorkerPool> create(uint32_t Count) noexcept {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+    try {
+      auto Pool = std::make_shared<WorkerPool>();
+      for (uint32_t I = 0; I < Count; ++I) {
+        auto W = std::make_unique<Worker>();
+        if (!spawn(*W)) {
+          spdlog::error(
+              "[WASI-NN] ChatTTS backend: Can not start the Python worker."sv);
+          return nullptr;
+        }
+        Pool->Workers.push_back(std::move(W));
+      }
+      return Pool;
+    } catch (const std::exception &EX) {
+      spdlog::error("[WASI-NN] ChatTTS backend: {}"sv, EX.what());
+      return nullptr;
+    }
+#else
+    static_cast<void>(Count);
+    spdlog::error(
+        "[WASI-NN] ChatTTS backend: Python workers are not supported on this platform."sv);
+    return nullptr;
+#endif
+  }
+
+  // Round robin the preferred workers of the contexts.
+  uint32_t assign() noexcept {
+    return Next.fetch_add(1, std::memory_order_relaxed) %
+           static_cast<uint32_t>(Workers.size());
+  }
+
+  WASINN::ErrNo infer(uint32_t Preferred, const std::string &Text,
+                      const std::string &Metadata,
+                      std::vector<uint8_t> &Output) noexcept {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+    // Take an idle worker, or wait for the preferred one.
+    Worker *W = nullptr;
+    std::unique_lock<std::mutex> Lock;
+    for (size_t I = 0; I < Workers.size(); ++I) {
+      auto &Candidate = *Workers[(Preferred + I) % Workers.size()];
+      Lock = std::unique_lock(Candidate.Mutex, std::try_to_lock);
+      if (Lock.owns_lock()) {
+        W = &Candidate;
+        break;
+      }
+    }
+    if (W == nullptr) {
+      W = Workers[Preferred % Workers.size()].get();
+      Lock = std::unique_lock(W->Mutex);
+    }
+
+    const uint32_t TextSize = static_cast<uint32_t>(Text.size());
+    const uint32_t MetadataSize = static_cast<uint32_t>(Metadata.size());
+    uint32_t Status;
+    uint64_t Size;
+    if (!sendAll(W->Socket, &TextSize, sizeof(TextSize)) ||
+        !sendAll(W->Socket, Text.data(), TextSize) ||
+        !sendAll(W->Socket, &MetadataSize, sizeof(MetadataSize)) ||
+        !sendAll(W->Socket, Metadata.data(), MetadataSize) ||
+        !recvAll(W->Socket, &Status, sizeof(Status)) ||
+        !recvAll(W->Socket, &Size, sizeof(Size))) {
+      spdlog::error("[WASI-NN] ChatTTS backend: The Python worker exited."sv);
+      return WASINN::ErrNo::RuntimeError;
+    }
+    if (Status == 1 || (Status == 0 && Size > kSharedSize)) {
+      spdlog::error(
+          "[WASI-NN] ChatTTS backend: Can not get output from infer method."sv);
+      return WASINN::ErrNo::RuntimeError;
+    }
+    try {
+      if (Status == 0) {
+        const auto *Data = static_cast<const uint8_t *>(W->Shared);
+        Output.assign(Data, Data + Size);
+      } else {
+        Output.resize(Size);
+        if (!recvAll(W->Socket, Output.data(), Size)) {
+          spdlog::error(
+              "[WASI-NN] ChatTTS backend: The Python worker exited."sv);
+          return WASINN::ErrNo::RuntimeError;
+        }
+      }
+    } catch (const std::bad_alloc &) {
+      spdlog::error("[WASI-NN] ChatTTS backend: Out of memory."sv);
+      return WASINN::ErrNo::RuntimeError;
+    }
+    return WASINN::ErrNo::Success;
+#else
+    static_cast<void>(Preferred);
+    static_cast<void>(Text);
+    static_cast<void>(Metadata);
+    static_cast<void>(Output);
+    return WASINN::ErrNo::RuntimeError;
+#endif
+  }
+
+private:
+  struct Worker {
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+    pid_t Pid = -1;
+    int Socket = -1;
+    void *Shared = nullptr;
+#endif
+    // A worker runs one compute at a time.
+    std::mutex Mutex;
+  };
+
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(__WIN32__) &&             \
+    !defined(__TOS_WIN__) && !defined(__WINDOWS__)
+  static bool spawn(Worker &W) noexcept {
+    int Fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, Fds) != 0) {
+      return false;
+    }
+    ::fcntl(Fds[0], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int One = 1;
+    ::setsockopt(Fds[0], SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+#endif
+    const int SharedFd = createSharedFile();
+    void *Shared = SharedFd < 0 ? MAP_FAILED
+                                : ::mmap(nullptr, kSharedSize, PROT_READ,
+                                         MAP_SHARED, SharedFd, 0);
+    if (Shared == MAP_FAILED) {
+      if (SharedFd >= 0) {
+        ::close(SharedFd);
+      }
+      ::close(Fds[0]);
+      ::close(Fds[1]);
+      return false;
+    }
+
+    // The worker inherits its end of the socket and the shared memory.
+    std::string Executable = PYTHON_EXECUTABLE;
+    std::string Flag = "-c";
+    std::string Script(kWorkerScript);
+    std::string SocketArg = std::to_string(Fds[1]);
+    std::string SharedArg = std::to_string(SharedFd);
+    std::string SizeArg = std::to_string(kSharedSize);
+    char *Argv[] = {Executable.data(), Flag.data(),      Script.data(),
+                    SocketArg.data(),  SharedArg.data(), SizeArg.data(),
+                    nullptr};
+    const int Err = ::posix_spawn(&W.Pid, Executable.c_str(), nullptr,
+                                  nullptr, Argv, environ);
+    ::close(Fds[1]);
+    ::close(SharedFd);
+    if (Err != 0) {
+      ::munmap(Shared, kSharedSize);
+      ::close(Fds[0]);
+      return false;
+    }
+    W.Socket = Fds[0];
+    W.Shared = Shared;
+    return true;
+  }
+#endif
+
+  std::vector<std::unique_ptr<Worker>> Workers;
+  std::atomic<uint32_t> Next = 0;
+};
+
 Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
                            Span<const Span<uint8_t>>, WASINN::Device,
                            uint32_t &GraphId) noexcept {
@@ -34,6 +354,19 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
     spdlog::info("[WASI-NN] ChatTTS backend: Load."sv);
   }
 
+  // Each worker process loads its own model.
+  if (const uint32_t Count = WasiNNEnvironment::NNChatTTSWorkers.value();
+      Count > 0) {
+    GraphRef.Workers = WorkerPool::create(Count);
+    if (!GraphRef.Workers) {
+      Env.deleteGraph(GId);
+      return WASINN::ErrNo::RuntimeError;
+    }
+    GraphId = GId;
+    Env.NNGraph[GId].setReady();
+    return WASINN::ErrNo::Success;
+  }
+
   // Create Model class
   if (!Py_IsInitialized()) {
     Py_Initialize();
@@ -92,6 +425,11 @@ Expect<WASINN::ErrNo> initExecCtx(WasiNNEnvironment &Env, uint32_t GraphId,
     return WASINN::ErrNo::RuntimeError;
   }
   ContextId = Env.newContext(GraphId, Env.NNGraph[GraphId]);
+  auto &GraphRef = Env.NNGraph[GraphId].get<Graph>();
+  if (GraphRef.Workers) {
+    Env.NNContext[ContextId].get<Context>().Worker =
+        GraphRef.Workers->assign();
+  }
   Env.NNContext[ContextId].setReady();
   return ErrNo::Success;
 }
@@ -127,6 +465,11 @@ Expect<WASINN::ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
       spdlog::error("[WASI-NN] ChatTTS backend: Parse metadata error"sv);
       return ErrNo::InvalidEncoding;
     }
+    if (GraphRef.Workers) {
+      // The worker builds the parameters of the context at each compute.
+      CxtRef.Metadata = std::move(Metadata);
+      return WASINN::ErrNo::Success;
+    }
     GIL Lock;
     // Handle Refine Text Params
     PyObject *PromptObj = nullptr;
@@ -259,6 +602,10 @@ Expect<WASINN::ErrNo> compute(WasiNNEnvironment &Env,
     spdlog::error("[WASI-NN] ChatTTS backend: Input is not set!"sv);
     return ErrNo::InvalidArgument;
   }
+  if (GraphRef.Workers) {
+    return GraphRef.Workers->infer(CxtRef.Worker, CxtRef.Inputs,
+                                   CxtRef.Metadata, CxtRef.Outputs);
+  }
   GIL Lock;
   PyObject *InputStr = PyUnicode_FromString(CxtRef.Inputs.c_str());
   PyObject *InferMethod = PyObject_GetAttrString(GraphRef.Chat, "infer");
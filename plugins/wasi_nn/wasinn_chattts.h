@@ -9,6 +9,10 @@
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_CHATTTS
 #include <Python.h>
+
+#include <memory>
+#include <string>
+#include <vector>
 #endif
 
 namespace WasmEdge::Host::WASINN {
@@ -27,6 +31,8 @@ public:
   GIL(const GIL &) = delete;
   GIL &operator=(const GIL &) = delete;
 };
+// Python worker processes of a model, see `--nn-chattts-workers`.
+class WorkerPool;
 struct Graph {
   bool EnableDebugLog = false;
   Graph() noexcept {
@@ -48,12 +54,18 @@ struct Graph {
   PyObject *ChatTTSModule = nullptr;
   PyObject *ParamsRefineText = nullptr;
   PyObject *ParamsInferCode = nullptr;
+  // Runs the model out of the process if not null.
+  std::shared_ptr<WorkerPool> Workers;
 };
 struct Context {
   Context(uint32_t Gid, Graph &) noexcept : GraphId(Gid) {}
   uint32_t GraphId;
   std::string Inputs;
   std::vector<uint8_t> Outputs;
+  // The metadata of the context, sent with each compute to the workers.
+  std::string Metadata;
+  // The worker preferred by the context.
+  uint32_t Worker = 0;
 };
 #else
 struct Graph {};
@@ -26,7 +26,7 @@
 namespace WasmEdge::Host::WASINN::MLX {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_MLX
 
-mx::array fromBytes(const Span<uint8_t> &Bytes) {
+mx::array fromBytes(const Span<uint8_t> &Bytes, bool ZeroCopy = false) {
   if (Bytes.size() < 9) {
     spdlog::error(
         "[WASI-NN] MLX backend: Tensor data must be at least 9 bytes long, current size: {}."sv,
@@ -56,25 +56,32 @@ mx::array fromBytes(const Span<uint8_t> &Bytes) {
   Offset += 4;
 
   const void *DataPtr = &Bytes[Offset];
+  const auto Wrap = [&](const auto *Ptr, mx::Dtype Type) {
+    if (ZeroCopy) {
+      // Alias the wasm memory in the unified memory. MLX falls back to copy
+      // if the buffer cannot be wrapped.
+      return mx::array(const_cast<void *>(DataPtr), Shape, Type, [](void *) {});
+    }
+    return mx::array(Ptr, Shape, Type);
+  };
   switch (RtypeValue) {
   case 0: { // F16
-    return mx::array(static_cast<const uint16_t *>(DataPtr), Shape,
-                     mx::float16);
+    return Wrap(static_cast<const uint16_t *>(DataPtr), mx::float16);
   }
   case 1: { // F32
-    return mx::array(static_cast<const float *>(DataPtr), Shape, mx::float32);
+    return Wrap(static_cast<const float *>(DataPtr), mx::float32);
   }
   case 2: { // F64
-    return mx::array(static_cast<const double *>(DataPtr), Shape, mx::float64);
+    return Wrap(static_cast<const double *>(DataPtr), mx::float64);
   }
   case 3: { // U8
-    return mx::array(static_cast<const uint8_t *>(DataPtr), Shape, mx::uint8);
+    return Wrap(static_cast<const uint8_t *>(DataPtr), mx::uint8);
   }
   case 4: { // I32
-    return mx::array(static_cast<const int32_t *>(DataPtr), Shape, mx::int32);
+    return Wrap(static_cast<const int32_t *>(DataPtr), mx::int32);
   }
   case 5: { // I64
-    return mx::array(static_cast<const int64_t *>(DataPtr), Shape, mx::int64);
+    return Wrap(static_cast<const int64_t *>(DataPtr), mx::int64);
   }
   default:
     spdlog::error("[WASI-NN] MLX backend: Unsupported rtype: {}", RtypeValue);
@@ -517,12 +524,16 @@ Expect<WASINN::ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
         std::string(reinterpret_cast<const char *>(Tensor.Tensor.data()),
                     Tensor.Tensor.size());
   } else if (GraphRef.ModelArch == "vlm") {
+    const bool ZeroCopy = WasiNNEnvironment::NNZeroCopy.value();
     if (Index == 0) {
-      std::get<VLMInput>(CxtRef.Inputs).Prompt = fromBytes(Tensor.Tensor);
+      std::get<VLMInput>(CxtRef.Inputs).Prompt =
+          fromBytes(Tensor.Tensor, ZeroCopy);
     } else if (Index == 1) {
-      std::get<VLMInput>(CxtRef.Inputs).Pixel = fromBytes(Tensor.Tensor);
+      std::get<VLMInput>(CxtRef.Inputs).Pixel =
+          fromBytes(Tensor.Tensor, ZeroCopy);
     } else if (Index == 2) {
-      std::get<VLMInput>(CxtRef.Inputs).Mask = fromBytes(Tensor.Tensor);
+      std::get<VLMInput>(CxtRef.Inputs).Mask =
+          fromBytes(Tensor.Tensor, ZeroCopy);
     } else {
       spdlog::error("[WASI-NN] MLX backend: Index out of range."sv);
       return ErrNo::InvalidArgument;
@@ -607,7 +618,8 @@ Expect<WASINN::ErrNo> compute(WasiNNEnvironment &Env,
     auto Result =
         std::dynamic_pointer_cast<llm::Transformer>(GraphRef.Model)
             ->generate(std::get<LLMInput>(CxtRef.Inputs).Prompt,
-                       GraphRef.Prmopt, GraphRef.MaxToken, false, GraphRef.Tok);
+                       GraphRef.Prmopt, GraphRef.MaxToken, false, GraphRef.Tok,
+                       &CxtRef.Cache);
     CxtRef.Outputs = LLMOutput({Result.Answer});
     TokenListSize = Result.TokenList.size();
   } else if (GraphRef.ModelArch == "vlm") {
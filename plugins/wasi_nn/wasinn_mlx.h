@@ -61,6 +61,8 @@ struct Context {
   uint32_t GraphId;
   std::variant<LLMInput, VLMInput, WhisperInput> Inputs;
   std::variant<LLMOutput, VLMOutput, whisper::TranscribeResult> Outputs;
+  /// The KV cache of the previous prompt, reused by the next compute.
+  llm::Transformer::PromptCache Cache;
 };
 #else
 struct Graph {};
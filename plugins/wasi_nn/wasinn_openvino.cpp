@@ -5,6 +5,12 @@
 #include "wasinnenv.h"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
 
 using namespace std::literals;
 
@@ -29,6 +35,162 @@ GetDeviceString(WASINN::Device TargetDevice,
   return WASINN::ErrNo::Success;
 }
 
+// Dynamic batching of the computes of a model. The computes which arrive
+// within the window and have the same input shapes run as one inference, with
+// the inputs concatenated along the first dimension. The outputs are split
+// along the first dimension again.
+class Batcher {
+public:
+  Batcher(std::shared_ptr<ov::Model> M, std::string D)
+      : Model(std::move(M)), Device(std::move(D)) {}
+
+  WASINN::ErrNo compute(const std::vector<ov::Tensor> &Inputs,
+                        std::vector<ov::Tensor> &Outputs) noexcept {
+    Request Req{&Inputs, &Outputs, shapeKey(Inputs)};
+    const auto Window =
+        std::chrono::microseconds(WasiNNEnvironment::NNBatchWindow.value());
+    const size_t MaxSize =
+        std::max(WasiNNEnvironment::NNBatchSize.value(), UINT32_C(1));
+    std::unique_lock Lock(Mutex);
+    Queue.push_back(&Req);
+    Cond.notify_all();
+    while (!Req.Done) {
+      if (Leading) {
+        Cond.wait(Lock);
+        continue;
+      }
+      // Lead the next batch, which waits the window for the other computes.
+      Leading = true;
+      Cond.wait_for(Lock, Window, [&]() { return Queue.size() >= MaxSize; });
+      std::vector<Request *> Batch;
+      const std::string &Key = Queue.front()->Key;
+      for (auto It = Queue.begin();
+           It != Queue.end() && Batch.size() < MaxSize;) {
+        if ((*It)->Key == Key) {
+          Batch.push_back(*It);
+          It = Queue.erase(It);
+        } else {
+          ++It;
+        }
+      }
+      Lock.unlock();
+      const auto Status = run(Batch);
+      Lock.lock();
+      for (auto *R : Batch) {
+        R->Status = Status;
+        R->Done = true;
+      }
+      Leading = false;
+      Cond.notify_all();
+    }
+    return Req.Status;
+  }
+
+private:
+  struct Request {
+    const std::vector<ov::Tensor> *Inputs;
+    std::vector<ov::Tensor> *Outputs;
+    std::string Key;
+    WASINN::ErrNo Status = WASINN::ErrNo::Success;
+    bool Done = false;
+  };
+
+  static std::string shapeKey(const std::vector<ov::Tensor> &Inputs) {
+    std::string Key;
+    for (const auto &Input : Inputs) {
+      for (const auto Dim : Input.get_shape()) {
+        Key += std::to_string(Dim);
+        Key += ',';
+      }
+      Key += ';';
+    }
+    return Key;
+  }
+
+  WASINN::ErrNo run(const std::vector<Request *> &Batch) noexcept {
+    const size_t N = Batch.size();
+    const auto &First = *Batch.front()->Inputs;
+    try {
+      // The model reshaped to the batch is compiled once for every batch
+      // size and input shapes.
+      auto It = Requests.find(std::to_string(N) + ':' + Batch.front()->Key);
+      if (It == Requests.end()) {
+        auto BatchModel = Model->clone();
+        std::map<size_t, ov::PartialShape> Shapes;
+        for (size_t I = 0; I < First.size(); ++I) {
+          auto Shape = First[I].get_shape();
+          if (Shape.empty()) {
+            spdlog::error("[WASI-NN] Cannot batch the scalar input {}."sv, I);
+            return WASINN::ErrNo::InvalidArgument;
+          }
+          Shape[0] *= N;
+          Shapes.emplace(I, Shape);
+        }
+        BatchModel->reshape(Shapes);
+        It = Requests
+                 .emplace(std::to_string(N) + ':' + Batch.front()->Key,
+                          Core.compile_model(BatchModel, Device)
+                              .create_infer_request())
+                 .first;
+      }
+      auto &InferRequest = It->second;
+      for (size_t I = 0; I < First.size(); ++I) {
+        auto Shape = First[I].get_shape();
+        Shape[0] *= N;
+        ov::Tensor Input(First[I].get_element_type(), Shape);
+        const size_t Size = First[I].get_byte_size();
+        for (size_t K = 0; K < N; ++K) {
+          std::memcpy(static_cast<uint8_t *>(Input.data()) + K * Size,
+                      (*Batch[K]->Inputs)[I].data(), Size);
+        }
+        InferRequest.set_input_tensor(I, Input);
+      }
+      InferRequest.infer();
+      const size_t OutCnt = Model->outputs().size();
+      for (auto *R : Batch) {
+        R->Outputs->resize(OutCnt);
+      }
+      for (size_t O = 0; O < OutCnt; ++O) {
+        const ov::Tensor Output = InferRequest.get_output_tensor(O);
+        auto Shape = Output.get_shape();
+        if (Shape.empty() || Shape[0] % N != 0) {
+          spdlog::error("[WASI-NN] Cannot split the output {} of the batch."sv,
+                        O);
+          return WASINN::ErrNo::RuntimeError;
+        }
+        Shape[0] /= N;
+        const size_t Size = Output.get_byte_size() / N;
+        for (size_t K = 0; K < N; ++K) {
+          ov::Tensor Slice(Output.get_element_type(), Shape);
+          std::memcpy(Slice.data(),
+                      static_cast<const uint8_t *>(Output.data()) + K * Size,
+                      Size);
+          (*Batch[K]->Outputs)[O] = std::move(Slice);
+        }
+      }
+    } catch (const std::exception &EX) {
+      spdlog::error("[WASI-NN] Batched Infer Exception: {}"sv, EX.what());
+      return WASINN::ErrNo::RuntimeError;
+    }
+    return WASINN::ErrNo::Success;
+  }
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  std::deque<Request *> Queue;
+  bool Leading = false;
+  ov::Core Core;
+  std::shared_ptr<ov::Model> Model;
+  std::string Device;
+  // Infer requests of the batch sizes and input shapes, used by the leader.
+  std::map<std::string, ov::InferRequest> Requests;
+};
+
+namespace {
+// The batchers of the preloaded models, shared by all the VMs.
+SharedRegistry<Batcher> Batchers;
+} // namespace
+
 Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
                            Span<const Span<uint8_t>> Builders,
                            WASINN::Device Device, uint32_t &GraphId) noexcept {
@@ -66,6 +228,37 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
     Env.deleteGraph(GId);
     return WASINN::ErrNo::RuntimeError;
   }
+
+  if (WasiNNEnvironment::NNBatchWindow.value() > 0) {
+    std::string DeviceString;
+    if (*GetDeviceString(Device, DeviceString) != WASINN::ErrNo::Success) {
+      Env.deleteGraph(GId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    // The weights of a preloaded model are shared by all the VMs, so that
+    // the graphs of the model in all the VMs share the batcher.
+    bool IsPreload = false;
+    for (const auto &[Name, Md] : Env.RawMdMap) {
+      const auto &Files = std::get<0>(Md);
+      IsPreload |= Files.size() == 2 && Files[1]->data() == Weight.data();
+    }
+    auto Create = [&]() {
+      return std::make_shared<Batcher>(GraphRef.OpenVINOModel, DeviceString);
+    };
+    try {
+      if (IsPreload) {
+        const auto Key = fmt::format(
+            "{}:{}"sv, static_cast<const void *>(Weight.data()), DeviceString);
+        GraphRef.Batch = Batchers.get(Key, Create);
+      } else {
+        GraphRef.Batch = Create();
+      }
+    } catch (const std::exception &EX) {
+      spdlog::error("[WASI-NN] Batcher Exception: {}"sv, EX.what());
+      Env.deleteGraph(GId);
+      return WASINN::ErrNo::RuntimeError;
+    }
+  }
   // Store the loaded graph.
   GraphId = GId;
   Env.NNGraph[GId].setReady();
@@ -124,15 +317,24 @@ Expect<WASINN::ErrNo> setInput(WASINN::WasiNNEnvironment &Env,
                          Tensor.Dimension.data() + Tensor.Dimension.size());
     ov::Tensor InputTensor =
         ov::Tensor(InputType, InputShape, Tensor.Tensor.data());
-    std::string Device;
-    if (!GetDeviceString(GraphRef.TargetDevice, Device)) {
-      spdlog::error("[WASI-NN] Failed to get device string for OpenVINO."sv);
-      return WASINN::ErrNo::InvalidArgument;
+    if (GraphRef.Batch) {
+      CxtRef.Inputs.resize(GraphRef.OpenVINOModel->inputs().size());
+      CxtRef.Inputs[Index] = InputTensor;
+      return WASINN::ErrNo::Success;
+    }
+    if (!GraphRef.OpenVINOCompiledModel) {
+      std::string Device;
+      if (!GetDeviceString(GraphRef.TargetDevice, Device)) {
+        spdlog::error("[WASI-NN] Failed to get device string for OpenVINO."sv);
+        return WASINN::ErrNo::InvalidArgument;
+      }
+      GraphRef.OpenVINOCompiledModel =
+          Env.OpenVINOCore.compile_model(GraphRef.OpenVINOModel, Device);
+    }
+    if (!CxtRef.OpenVINOInferRequest) {
+      CxtRef.OpenVINOInferRequest =
+          GraphRef.OpenVINOCompiledModel.create_infer_request();
     }
-
-    ov::CompiledModel CompiledModel =
-        Env.OpenVINOCore.compile_model(GraphRef.OpenVINOModel, Device);
-    CxtRef.OpenVINOInferRequest = CompiledModel.create_infer_request();
     CxtRef.OpenVINOInferRequest.set_input_tensor(Index, InputTensor);
   } catch (const std::exception &EX) {
     spdlog::error("[WASI-NN] Set Input Exception: {}"sv, EX.what());
@@ -158,7 +360,9 @@ Expect<WASINN::ErrNo> getOutput(WASINN::WasiNNEnvironment &Env,
 
   try {
     const ov::Tensor &OutputTensor =
-        CxtRef.OpenVINOInferRequest.get_output_tensor(Index);
+        CxtRef.Outputs.empty()
+            ? CxtRef.OpenVINOInferRequest.get_output_tensor(Index)
+            : CxtRef.Outputs[Index];
     BytesWritten = OutputTensor.get_byte_size();
     std::copy_n(static_cast<const uint8_t *>(OutputTensor.data()), BytesWritten,
                 OutBuffer.data());
@@ -172,6 +376,16 @@ Expect<WASINN::ErrNo> getOutput(WASINN::WasiNNEnvironment &Env,
 Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
                               uint32_t ContextId) noexcept {
   auto &CxtRef = Env.NNContext[ContextId].get<Context>();
+  auto &GraphRef = Env.NNGraph[CxtRef.GraphId].get<Graph>();
+  if (GraphRef.Batch) {
+    if (CxtRef.Inputs.empty() ||
+        std::any_of(CxtRef.Inputs.begin(), CxtRef.Inputs.end(),
+                    [](const ov::Tensor &Input) { return !Input; })) {
+      spdlog::error("[WASI-NN] All the inputs must be set before compute."sv);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    return GraphRef.Batch->compute(CxtRef.Inputs, CxtRef.Outputs);
+  }
   try {
     CxtRef.OpenVINOInferRequest.infer();
   } catch (const std::exception &EX) {
@@ -9,6 +9,9 @@
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
 #include "openvino/openvino.hpp"
+
+#include <memory>
+#include <vector>
 #endif
 
 namespace WasmEdge::Host::WASINN {
@@ -17,11 +20,18 @@ struct WasiNNEnvironment;
 
 namespace WasmEdge::Host::WASINN::OpenVINO {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
+class Batcher;
+
 struct Graph {
   ~Graph() noexcept {}
   ov::Tensor OpenVINOIWeightTensor;
   std::shared_ptr<ov::Model> OpenVINOModel;
+  // Compiled once for all the contexts.
+  ov::CompiledModel OpenVINOCompiledModel;
   Device TargetDevice = Device::AUTO;
+  // Dynamic batching of the computes, shared by the graphs of the same
+  // preloaded model. nullptr if disabled.
+  std::shared_ptr<Batcher> Batch;
 };
 
 struct Context {
@@ -29,6 +39,9 @@ struct Context {
   ~Context() noexcept {}
   uint32_t GraphId;
   ov::InferRequest OpenVINOInferRequest;
+  // Inputs and outputs of the batched computes.
+  std::vector<ov::Tensor> Inputs;
+  std::vector<ov::Tensor> Outputs;
 };
 
 struct Environ {
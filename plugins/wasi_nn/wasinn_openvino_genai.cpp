@@ -5,6 +5,7 @@
 #include "wasinnenv.h"
 
 #include <algorithm>
+#include <simdjson.h>
 
 using namespace std::literals;
 
@@ -44,10 +45,8 @@ Expect<WASINN::ErrNo> isStringTensor(const TensorData &Tensor) noexcept {
   return WASINN::ErrNo::Success;
 }
 
-Expect<WASINN::ErrNo>
-LLMPipelineBackend::SetContextInput(Context &CxtRef, uint32_t Index,
-                                    const TensorData &Tensor) {
-
+Expect<WASINN::ErrNo> setStringInput(Context &CxtRef, uint32_t Index,
+                                     const TensorData &Tensor) noexcept {
   if (Index != 0) {
     spdlog::error("[WASI-NN] The input index {} is out of range."sv, Index);
     return WASINN::ErrNo::InvalidArgument;
@@ -68,6 +67,31 @@ LLMPipelineBackend::SetContextInput(Context &CxtRef, uint32_t Index,
   return WASINN::ErrNo::Success;
 }
 
+Expect<WASINN::ErrNo> getStringOutput(Context &CxtRef, uint32_t Index,
+                                      Span<uint8_t> OutBuffer,
+                                      uint32_t &BytesWritten) noexcept {
+  if (Index != 0) {
+    spdlog::error("[WASI-NN] The output index {} is out of range."sv, Index);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  try {
+    BytesWritten = CxtRef.StringOutput.size();
+    std::copy_n(reinterpret_cast<const uint8_t *>(CxtRef.StringOutput.data()),
+                BytesWritten, OutBuffer.data());
+  } catch (const std::exception &EX) {
+    spdlog::error("[WASI-NN] Get Output Exception: {}"sv, EX.what());
+    return WASINN::ErrNo::RuntimeError;
+  }
+  return WASINN::ErrNo::Success;
+}
+
+Expect<WASINN::ErrNo>
+LLMPipelineBackend::SetContextInput(Context &CxtRef, uint32_t Index,
+                                    const TensorData &Tensor) {
+  return setStringInput(CxtRef, Index, Tensor);
+}
+
 Expect<WASINN::ErrNo> LLMPipelineBackend::Generate(Context &CxtRef) {
   try {
     // TODO: let the user to set the generation config.
@@ -87,22 +111,103 @@ Expect<WASINN::ErrNo>
 LLMPipelineBackend::GetContextOutput(Context &CxtRef, uint32_t Index,
                                      Span<uint8_t> OutBuffer,
                                      uint32_t &BytesWritten) {
-  if (Index != 0) {
-    spdlog::error("[WASI-NN] The output index {} is out of range."sv, Index);
-    return WASINN::ErrNo::InvalidArgument;
-  }
+  return getStringOutput(CxtRef, Index, OutBuffer, BytesWritten);
+}
 
+Expect<WASINN::ErrNo>
+ContinuousBatchingBackend::SetContextInput(Context &CxtRef, uint32_t Index,
+                                           const TensorData &Tensor) {
+  return setStringInput(CxtRef, Index, Tensor);
+}
+
+Expect<WASINN::ErrNo> ContinuousBatchingBackend::Generate(Context &CxtRef) {
   try {
-    BytesWritten = CxtRef.StringOutput.size();
-    std::copy_n(reinterpret_cast<const uint8_t *>(CxtRef.StringOutput.data()),
-                BytesWritten, OutBuffer.data());
+    ov::genai::GenerationConfig Config = Model->get_config();
+    Config.max_new_tokens = MaxNewTokens;
+    auto Handle = Model->add_request(NextRequestId.fetch_add(1),
+                                     CxtRef.StringInput, Config);
+    // Whichever context holds the lock steps the batch of all the running
+    // requests, so the other contexts only wait for their own to finish.
+    while (Handle->get_status() == ov::genai::GenerationStatus::RUNNING) {
+      std::unique_lock Lock(StepMutex);
+      if (Handle->get_status() != ov::genai::GenerationStatus::RUNNING) {
+        break;
+      }
+      Model->step();
+    }
+    if (Handle->get_status() != ov::genai::GenerationStatus::FINISHED) {
+      spdlog::error("[WASI-NN] The request is dropped by the pipeline."sv);
+      return WASINN::ErrNo::RuntimeError;
+    }
+    auto Outputs = Handle->read_all();
+    if (Outputs.empty()) {
+      CxtRef.StringOutput.clear();
+    } else {
+      CxtRef.StringOutput =
+          Model->get_tokenizer().decode(Outputs.front().generated_ids);
+    }
   } catch (const std::exception &EX) {
-    spdlog::error("[WASI-NN] Get Output Exception: {}"sv, EX.what());
+    spdlog::error("[WASI-NN] Generate Exception: {}"sv, EX.what());
     return WASINN::ErrNo::RuntimeError;
   }
   return WASINN::ErrNo::Success;
 }
 
+Expect<WASINN::ErrNo>
+ContinuousBatchingBackend::GetContextOutput(Context &CxtRef, uint32_t Index,
+                                            Span<uint8_t> OutBuffer,
+                                            uint32_t &BytesWritten) {
+  return getStringOutput(CxtRef, Index, OutBuffer, BytesWritten);
+}
+
+// Parse the scheduler config and the generation limit of the continuous
+// batching pipeline from the JSON metadata.
+Expect<WASINN::ErrNo> parseSchedulerConfig(const std::string &Metadata,
+                                           ov::genai::SchedulerConfig &Config,
+                                           size_t &MaxNewTokens) noexcept {
+  if (Metadata.empty()) {
+    return WASINN::ErrNo::Success;
+  }
+  simdjson::dom::parser Parser;
+  simdjson::dom::element Doc;
+  if (Parser.parse(Metadata).get(Doc)) {
+    spdlog::error("[WASI-NN] Parse metadata error"sv);
+    return WASINN::ErrNo::InvalidEncoding;
+  }
+  const auto GetSize = [&](std::string_view Key, size_t &Value) {
+    if (Doc.at_key(Key).error() != simdjson::SUCCESS) {
+      return true;
+    }
+    uint64_t Number;
+    if (Doc[Key].get<uint64_t>().get(Number)) {
+      spdlog::error("[WASI-NN] Unable to retrieve the {} option."sv, Key);
+      return false;
+    }
+    Value = static_cast<size_t>(Number);
+    return true;
+  };
+  const auto GetBool = [&](std::string_view Key, bool &Value) {
+    if (Doc.at_key(Key).error() != simdjson::SUCCESS) {
+      return true;
+    }
+    if (Doc[Key].get<bool>().get(Value)) {
+      spdlog::error("[WASI-NN] Unable to retrieve the {} option."sv, Key);
+      return false;
+    }
+    return true;
+  };
+  if (!GetSize("max_num_batched_tokens"sv, Config.max_num_batched_tokens) ||
+      !GetSize("num_kv_blocks"sv, Config.num_kv_blocks) ||
+      !GetSize("cache_size"sv, Config.cache_size) ||
+      !GetSize("max_num_seqs"sv, Config.max_num_seqs) ||
+      !GetBool("dynamic_split_fuse"sv, Config.dynamic_split_fuse) ||
+      !GetBool("enable_prefix_caching"sv, Config.enable_prefix_caching) ||
+      !GetSize("max_new_tokens"sv, MaxNewTokens)) {
+    return WASINN::ErrNo::InvalidArgument;
+  }
+  return WASINN::ErrNo::Success;
+}
+
 Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
                            Span<const Span<uint8_t>> Builders,
                            WASINN::Device Device, uint32_t &GraphId) noexcept {
@@ -114,9 +219,10 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
   }
 
   // Get the XML and Weight raw buffer.
-  //   Builder-0: Reserved, the string "LLMPipeline"
+  //   Builder-0: The pipeline, "LLMPipeline" or "ContinuousBatchingPipeline"
   //   Builder-1: Path to the dir model xml/bin files
-  //   Builder-2: Empty for now (reserved for future use)
+  //   Builder-2: The JSON scheduler config of "ContinuousBatchingPipeline",
+  //              or empty
 
   // There are 4 types (text or img) x (text or img), we assume the input is 0
   // for now.
@@ -124,8 +230,7 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
       reinterpret_cast<const char *>(Builders[0].data()), Builders[0].size());
   auto ModelPath = std::string(
       reinterpret_cast<const char *>(Builders[1].data()), Builders[1].size());
-  // TODO: Support extra model information. (ex. enable kv cache)
-  [[maybe_unused]] auto ModelExtra = std::string(
+  auto ModelExtra = std::string(
       reinterpret_cast<const char *>(Builders[2].data()), Builders[2].size());
 
   // Add a new graph.
@@ -142,10 +247,19 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
 
   try {
     // Create the OpenVINO GenAI Backend.
-    // Currently, we only support LLMPipeline.
     if (ModelType == "LLMPipeline") {
       GraphRef.OpenVINOGenAI =
           std::make_shared<LLMPipelineBackend>(ModelPath, DeviceString);
+    } else if (ModelType == "ContinuousBatchingPipeline") {
+      ov::genai::SchedulerConfig Scheduler;
+      size_t MaxNewTokens = 100;
+      if (auto Err = parseSchedulerConfig(ModelExtra, Scheduler, MaxNewTokens);
+          Err != WASINN::ErrNo::Success) {
+        Env.deleteGraph(GId);
+        return Err;
+      }
+      GraphRef.OpenVINOGenAI = std::make_shared<ContinuousBatchingBackend>(
+          ModelPath, DeviceString, Scheduler, MaxNewTokens);
     } else {
       spdlog::error("[WASI-NN] Unsupported model type: {}"sv, ModelType);
       return WASINN::ErrNo::InvalidArgument;
@@ -212,7 +326,7 @@ Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
   auto &CxtRef = Env.NNContext[ContextId].get<Context>();
   auto &GraphRef = Env.NNGraph[CxtRef.GraphId].get<Graph>();
   try {
-    GraphRef.OpenVINOGenAI->Generate(CxtRef);
+    return GraphRef.OpenVINOGenAI->Generate(CxtRef);
   } catch (const std::exception &EX) {
     spdlog::error("[WASI-NN] Infer Request Exception: {}"sv, EX.what());
     return WASINN::ErrNo::RuntimeError;
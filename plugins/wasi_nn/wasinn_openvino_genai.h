@@ -9,10 +9,14 @@
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINOGENAI
 #include "openvino/openvino.hpp"
+#include <openvino/genai/continuous_batching_pipeline.hpp>
 #include <openvino/genai/llm_pipeline.hpp>
 #include <openvino/genai/visual_language/pipeline.hpp>
 #endif
 
+#include <atomic>
+#include <mutex>
+
 namespace WasmEdge::Host::WASINN {
 struct WasiNNEnvironment;
 }
@@ -51,6 +55,33 @@ private:
   std::shared_ptr<ov::genai::LLMPipeline> Model;
 };
 
+/// Pipeline with the paged attention, where the computes of the concurrent
+/// contexts are the sequences of the same batches.
+class ContinuousBatchingBackend : public OpenVINOGenAIBackend {
+public:
+  ContinuousBatchingBackend(std::string Path, std::string Device,
+                            const ov::genai::SchedulerConfig &Scheduler,
+                            size_t MaxNewTokens)
+      : MaxNewTokens(MaxNewTokens) {
+    Model = std::make_shared<ov::genai::ContinuousBatchingPipeline>(
+        Path, Scheduler, Device);
+  }
+  ~ContinuousBatchingBackend() noexcept {}
+  Expect<WASINN::ErrNo> SetContextInput(Context &CxtRef, uint32_t Index,
+                                        const TensorData &Tensor) override;
+  Expect<WASINN::ErrNo> Generate(Context &CxtRef) override;
+  Expect<WASINN::ErrNo> GetContextOutput(Context &CxtRef, uint32_t Index,
+                                         Span<uint8_t> OutBuffer,
+                                         uint32_t &BytesWritten) override;
+
+private:
+  std::shared_ptr<ov::genai::ContinuousBatchingPipeline> Model;
+  size_t MaxNewTokens;
+  std::atomic<uint64_t> NextRequestId = 0;
+  // The pipeline is stepped by one context at a time.
+  std::mutex StepMutex;
+};
+
 struct Graph {
   ~Graph() noexcept {}
   std::shared_ptr<OpenVINOGenAIBackend> OpenVINOGenAI;
@@ -8,6 +8,7 @@
 #include "simdjson.h"
 
 #include <cstring>
+#include <exception>
 #include <filesystem>
 #include <functional>
 #include <ios>
@@ -477,6 +478,21 @@ Expect<WASINN::ErrNo> getOutput(WASINN::WasiNNEnvironment &Env,
   return WASINN::ErrNo::Success;
 }
 
+namespace {
+// Thrown from the audio callback to stop the synthesis of a cancelled stream.
+struct StreamCancelled {};
+
+void cancelStream(Context &CxtRef) noexcept {
+  if (CxtRef.Stream) {
+    {
+      std::unique_lock Lock(CxtRef.Stream->Mutex);
+      CxtRef.Stream->Cancelled = true;
+    }
+    CxtRef.Stream.reset();
+  }
+}
+} // namespace
+
 Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
                               uint32_t ContextId) noexcept {
   auto &CxtRef = Env.NNContext[ContextId].get<Context>();
@@ -486,6 +502,8 @@ Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
     spdlog::error("[WASI-NN] Piper backend: Input is not set."sv);
     return WASINN::ErrNo::InvalidArgument;
   }
+  // The voice is not shared with a running stream.
+  cancelStream(CxtRef);
 
   auto OutputType = SynthesisConfigOutputType::OUTPUT_WAV;
   if (GraphRef.Config->DefaultSynthesisConfig.OutputType) {
@@ -525,6 +543,110 @@ Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
                         GraphRef.Voice->synthesisConfig, true);
   return WASINN::ErrNo::Success;
 }
+
+AudioStream::~AudioStream() noexcept {
+  if (Worker.joinable()) {
+    Worker.join();
+  }
+}
+
+Expect<WASINN::ErrNo> getOutputSingle(WASINN::WasiNNEnvironment &Env,
+                                      uint32_t ContextId, uint32_t Index,
+                                      Span<uint8_t> OutBuffer,
+                                      uint32_t &BytesWritten) noexcept {
+  return getOutput(Env, ContextId, Index, OutBuffer, BytesWritten);
+}
+
+Expect<WASINN::ErrNo> computeSingle(WASINN::WasiNNEnvironment &Env,
+                                    uint32_t ContextId) noexcept {
+  auto &CxtRef = Env.NNContext[ContextId].get<Context>();
+  auto &GraphRef = Env.NNGraph[CxtRef.GraphId].get<Graph>();
+
+  if (!CxtRef.Stream) {
+    if (!CxtRef.Line) {
+      spdlog::error("[WASI-NN] Piper backend: Input is not set."sv);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    // Override config, which is restored when the stream ends.
+    if (CxtRef.JsonInputSynthesisConfig &&
+        CxtRef.JsonInputSynthesisConfig->has_value()) {
+      updateSynthesisConfig(CxtRef.JsonInputSynthesisConfig->value(),
+                            GraphRef.Voice->synthesisConfig, false);
+    }
+    // The sentences are streamed as the raw samples whatever the output type,
+    // since the header of a WAV file needs the length of the whole audio.
+    try {
+      auto Stream = std::make_unique<AudioStream>();
+      Stream->Worker = std::thread(
+          [S = Stream.get(), &GraphRef, Line = *CxtRef.Line]() noexcept {
+            bool Failed = false;
+            try {
+              auto AudioBuffer = std::vector<int16_t>{};
+              auto Result = piper::SynthesisResult{};
+              piper::textToAudio(
+                  *GraphRef.PiperConfig, *GraphRef.Voice, Line, AudioBuffer,
+                  Result, [S, &AudioBuffer]() {
+                    // Piper clears the buffer after each sentence.
+                    auto Chunk = std::vector<uint8_t>(
+                        sizeof(int16_t) * AudioBuffer.size());
+                    std::memcpy(Chunk.data(), AudioBuffer.data(),
+                                Chunk.size());
+                    std::unique_lock Lock(S->Mutex);
+                    if (S->Cancelled) {
+                      throw StreamCancelled{};
+                    }
+                    S->Chunks.push_back(std::move(Chunk));
+                    S->Ready.notify_one();
+                  });
+            } catch (const StreamCancelled &) {
+            } catch (const std::exception &EX) {
+              spdlog::error("[WASI-NN] Piper backend: Synthesis failed: {}"sv,
+                            EX.what());
+              Failed = true;
+            } catch (...) {
+              Failed = true;
+            }
+            // Restore config (json_input)
+            updateSynthesisConfig(GraphRef.Config->DefaultSynthesisConfig,
+                                  GraphRef.Voice->synthesisConfig, true);
+            std::unique_lock Lock(S->Mutex);
+            S->Done = true;
+            S->Failed = Failed;
+            S->Ready.notify_one();
+          });
+      CxtRef.Stream = std::move(Stream);
+    } catch (const std::exception &EX) {
+      spdlog::error("[WASI-NN] Piper backend: Failed to start the stream: {}"sv,
+                    EX.what());
+      updateSynthesisConfig(GraphRef.Config->DefaultSynthesisConfig,
+                            GraphRef.Voice->synthesisConfig, true);
+      return WASINN::ErrNo::RuntimeError;
+    }
+  }
+
+  auto &Stream = *CxtRef.Stream;
+  std::unique_lock Lock(Stream.Mutex);
+  Stream.Ready.wait(
+      Lock, [&Stream]() { return !Stream.Chunks.empty() || Stream.Done; });
+  if (!Stream.Chunks.empty()) {
+    CxtRef.Output = std::move(Stream.Chunks.front());
+    Stream.Chunks.pop_front();
+    return WASINN::ErrNo::Success;
+  }
+  const bool Failed = Stream.Failed;
+  Lock.unlock();
+  CxtRef.Stream.reset();
+  CxtRef.Output.reset();
+  return Failed ? WASINN::ErrNo::RuntimeError : WASINN::ErrNo::EndOfSequence;
+}
+
+Expect<WASINN::ErrNo> finiSingle(WASINN::WasiNNEnvironment &Env,
+                                 uint32_t ContextId) noexcept {
+  auto &CxtRef = Env.NNContext[ContextId].get<Context>();
+  cancelStream(CxtRef);
+  CxtRef.Output.reset();
+  return WASINN::ErrNo::Success;
+}
 #else
 namespace {
 Expect<WASINN::ErrNo> reportBackendNotSupported() noexcept {
@@ -553,5 +675,18 @@ Expect<WASINN::ErrNo> getOutput(WASINN::WasiNNEnvironment &, uint32_t, uint32_t,
 Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &, uint32_t) noexcept {
   return reportBackendNotSupported();
 }
+Expect<WASINN::ErrNo> getOutputSingle(WASINN::WasiNNEnvironment &, uint32_t,
+                                      uint32_t, Span<uint8_t>,
+                                      uint32_t &) noexcept {
+  return reportBackendNotSupported();
+}
+Expect<WASINN::ErrNo> computeSingle(WASINN::WasiNNEnvironment &,
+                                    uint32_t) noexcept {
+  return reportBackendNotSupported();
+}
+Expect<WASINN::ErrNo> finiSingle(WASINN::WasiNNEnvironment &,
+                                 uint32_t) noexcept {
+  return reportBackendNotSupported();
+}
 #endif
 } // namespace WasmEdge::Host::WASINN::Piper
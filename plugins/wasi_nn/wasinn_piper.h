@@ -10,10 +10,14 @@
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_PIPER
 #include <piper.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 #endif
 
@@ -77,12 +81,26 @@ struct Graph {
   std::unique_ptr<piper::PiperConfig> PiperConfig;
   std::unique_ptr<piper::Voice> Voice;
 };
+// The audio of compute_single, synthesized sentence by sentence on a
+// background thread with the ONNX session of the voice.
+struct AudioStream {
+  ~AudioStream() noexcept;
+  std::thread Worker;
+  std::mutex Mutex;
+  std::condition_variable Ready;
+  // Raw samples of the synthesized sentences not fetched yet.
+  std::deque<std::vector<uint8_t>> Chunks;
+  bool Done = false;
+  bool Failed = false;
+  bool Cancelled = false;
+};
 struct Context {
   Context(uint32_t GId, Graph &) noexcept : GraphId(GId) {}
   uint32_t GraphId;
   std::optional<std::string> Line;
   std::unique_ptr<std::optional<SynthesisConfig>> JsonInputSynthesisConfig;
   std::optional<std::vector<uint8_t>> Output;
+  std::unique_ptr<AudioStream> Stream;
 };
 #else
 struct Graph {};
@@ -108,4 +126,12 @@ Expect<WASINN::ErrNo> getOutput(WASINN::WasiNNEnvironment &Env,
                                 uint32_t &BytesWritten) noexcept;
 Expect<WASINN::ErrNo> compute(WASINN::WasiNNEnvironment &Env,
                               uint32_t ContextId) noexcept;
+Expect<WASINN::ErrNo> getOutputSingle(WASINN::WasiNNEnvironment &Env,
+                                      uint32_t ContextId, uint32_t Index,
+                                      Span<uint8_t> OutBuffer,
+                                      uint32_t &BytesWritten) noexcept;
+Expect<WASINN::ErrNo> computeSingle(WASINN::WasiNNEnvironment &Env,
+                                    uint32_t ContextId) noexcept;
+Expect<WASINN::ErrNo> finiSingle(WASINN::WasiNNEnvironment &Env,
+                                 uint32_t ContextId) noexcept;
 } // namespace WasmEdge::Host::WASINN::Piper
@@ -5,6 +5,7 @@
 #include "wasinnenv.h"
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TFLITE
+#include "tensorflow/lite/c/c_api_experimental.h"
 #include "tensorflow/lite/c/common.h"
 #endif
 
@@ -68,6 +69,9 @@ Expect<WASINN::ErrNo> initExecCtx(WASINN::WasiNNEnvironment &Env,
     return WASINN::ErrNo::Busy;
   }
   TfLiteInterpreterAllocateTensors(CxtRef.TFLiteInterp);
+  const auto InCnt = TfLiteInterpreterGetInputTensorCount(CxtRef.TFLiteInterp);
+  CxtRef.InputData.resize(InCnt, nullptr);
+  CxtRef.InputBuffers.resize(InCnt);
 
   ContextId = CId;
   Env.NNContext[ContextId].setReady();
@@ -137,6 +141,45 @@ Expect<WASINN::ErrNo> setInput(WASINN::WasiNNEnvironment &Env,
                   Tensor.RType);
     return WASINN::ErrNo::InvalidArgument;
   }
+
+  // In the zero-copy mode, the input tensor wraps the guest memory if it is
+  // aligned as the TFLite tensors. Once wrapped, a copied input goes to an
+  // own buffer instead of the guest memory wrapped before.
+  constexpr uintptr_t TensorAlignment = 64;
+  const bool ZeroCopy =
+      WasiNNEnvironment::NNZeroCopy.value() &&
+      reinterpret_cast<uintptr_t>(Tensor.Tensor.data()) % TensorAlignment == 0;
+  uint8_t *Data = nullptr;
+  if (ZeroCopy) {
+    Data = Tensor.Tensor.data();
+  } else if (CxtRef.InputData[Index] != nullptr) {
+    auto &Buffer = CxtRef.InputBuffers[Index];
+    if (Buffer.empty()) {
+      Buffer.resize(HoldTensorByteSize + TensorAlignment);
+    }
+    const auto Addr = reinterpret_cast<uintptr_t>(Buffer.data());
+    Data = Buffer.data() + (TensorAlignment - Addr % TensorAlignment) %
+                               TensorAlignment;
+  }
+  if (Data != nullptr && Data != CxtRef.InputData[Index]) {
+    const TfLiteCustomAllocation Allocation{Data, HoldTensorByteSize};
+    const int TensorIndex =
+        TfLiteInterpreterInputTensorIndices(CxtRef.TFLiteInterp)[Index];
+    if (unlikely(TfLiteInterpreterSetCustomAllocationForTensor(
+                     CxtRef.TFLiteInterp, TensorIndex, &Allocation,
+                     kTfLiteCustomAllocationFlagsNone) !=
+                     TfLiteStatus::kTfLiteOk ||
+                 TfLiteInterpreterAllocateTensors(CxtRef.TFLiteInterp) !=
+                     TfLiteStatus::kTfLiteOk)) {
+      spdlog::error("[WASI-NN] Set tensor memory failed"sv);
+      return WASINN::ErrNo::Busy;
+    }
+    CxtRef.InputData[Index] = Data;
+  }
+  if (ZeroCopy) {
+    return WASINN::ErrNo::Success;
+  }
+
   TfLiteStatus Stat = TfLiteTensorCopyFromBuffer(
       HoldTensor, Tensor.Tensor.data(), Tensor.Tensor.size());
   if (unlikely(Stat != TfLiteStatus::kTfLiteOk)) {
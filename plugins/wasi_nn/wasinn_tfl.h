@@ -39,6 +39,11 @@ public:
   }
   uint32_t GraphId;
   TfLiteInterpreter *TFLiteInterp = nullptr;
+  // Custom allocations of the input tensors, which are the guest memory in
+  // the zero-copy mode, or nullptr for the interpreter arena.
+  std::vector<uint8_t *> InputData;
+  // Own memory of the inputs which wrapped the guest memory before.
+  std::vector<std::vector<uint8_t>> InputBuffers;
 };
 #else
 struct Graph {};
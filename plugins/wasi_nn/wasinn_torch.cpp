@@ -6,11 +6,80 @@
 
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
 #include <torch/torch.h>
+#ifdef WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+#endif
+
+#include <istream>
+#include <streambuf>
 #endif
 
 namespace WasmEdge::Host::WASINN::PyTorch {
 #ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
 
+namespace {
+/// Read-only stream buffer over the model bytes, so that the model is parsed
+/// from the builder or the preloaded buffer without copying it.
+class SpanStreamBuf : public std::streambuf {
+public:
+  SpanStreamBuf(Span<uint8_t> Data) noexcept {
+    auto *Begin = reinterpret_cast<char *>(Data.data());
+    setg(Begin, Begin, Begin + Data.size());
+  }
+
+protected:
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override {
+    if (!(Which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    off_type Base = 0;
+    if (Dir == std::ios_base::cur) {
+      Base = gptr() - eback();
+    } else if (Dir == std::ios_base::end) {
+      Base = egptr() - eback();
+    }
+    const off_type Pos = Base + Off;
+    if (Pos < 0 || Pos > egptr() - eback()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + Pos, egptr());
+    return pos_type(Pos);
+  }
+
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override {
+    return seekoff(off_type(Pos), std::ios_base::beg, Which);
+  }
+};
+
+/// Collect the output tensors of a TorchScript forward.
+Expect<ErrNo> collectOutputs(const torch::jit::IValue &RawOutput,
+                             std::vector<at::Tensor> &Out, bool Clone) {
+  auto Push = [&](const at::Tensor &Tensor) {
+    Out.push_back(Clone ? Tensor.clone() : Tensor);
+  };
+  if (RawOutput.isTensorList()) {
+    for (auto &OneOf : RawOutput.toTensorVector()) {
+      Push(OneOf);
+    }
+  } else if (RawOutput.isTuple()) {
+    for (auto &OneOf : RawOutput.toTuple()->elements()) {
+      Push(OneOf.toTensor());
+    }
+  } else if (RawOutput.isTensor()) {
+    Push(RawOutput.toTensor());
+  } else {
+    spdlog::error(
+        "[WASI-NN] Torch: The output can only be one of the following tensor "
+        "types: a tensor, a list of tensors, or a tuple of tensors."sv);
+    return ErrNo::InvalidArgument;
+  }
+  return ErrNo::Success;
+}
+} // namespace
+
 Expect<ErrNo> TorchScript::setDevice(Device Device) {
   if (Device == Device::CPU) {
     TorchDevice = at::kCPU;
@@ -34,7 +103,9 @@ Expect<ErrNo> TorchScript::loadFromBinary(std::istream &In, Device Device) {
   if (auto Err = setDevice(Device); Err != ErrNo::Success) {
     return Err;
   }
-  TorchModel = torch::jit::load(In);
+  // Place the parameters on the target device at the load time.
+  TorchModel = torch::jit::load(In, torch::Device(TorchDevice));
+  TorchModel.eval();
   return ErrNo::Success;
 }
 
@@ -43,39 +114,93 @@ Expect<ErrNo> TorchScript::loadFromPath(const std::string &Path,
   if (auto Err = setDevice(Device); Err != ErrNo::Success) {
     return Err;
   }
-  TorchModel = torch::jit::load(Path);
+  TorchModel = torch::jit::load(Path, torch::Device(TorchDevice));
+  TorchModel.eval();
   return ErrNo::Success;
 }
 
 Expect<ErrNo> TorchScript::run(std::vector<at::Tensor> In,
                                std::vector<at::Tensor> &Out) {
-  std::vector<torch::jit::IValue> Inputs;
-  std::vector<at::Tensor> Outputs;
-  for (auto &OneOf : In) {
-    Inputs.push_back(OneOf);
+  Out.clear();
+#ifdef WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA
+  if (TorchDevice == at::kCUDA && WasiNNEnvironment::NNTorchCudaGraph.value()) {
+    return runGraph(In, Out);
   }
-  auto RawOutput = TorchModel.forward(Inputs);
-  if (RawOutput.isTensorList()) {
-    auto OutTensors = RawOutput.toTensorVector();
-    for (auto &OneOf : OutTensors) {
-      Out.push_back(OneOf.clone());
+#endif
+  torch::NoGradGuard NoGrad;
+  std::vector<torch::jit::IValue> Inputs(In.begin(), In.end());
+  // The outputs may alias the input tensors, which are reused by the context.
+  return collectOutputs(TorchModel.forward(Inputs), Out, true);
+}
+
+#ifdef WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA
+Expect<ErrNo> TorchScript::runGraph(const std::vector<at::Tensor> &In,
+                                    std::vector<at::Tensor> &Out) {
+  std::unique_lock Lock(GraphMutex);
+  torch::NoGradGuard NoGrad;
+  bool SameShapes = CudaGraph && StaticInputs.size() == In.size();
+  for (size_t I = 0; SameShapes && I < In.size(); ++I) {
+    SameShapes = StaticInputs[I].sizes() == In[I].sizes();
+  }
+
+  if (!SameShapes && !Uncapturable) {
+    CudaGraph.reset();
+    StaticOutputs.clear();
+    StaticInputs.clear();
+    for (const auto &Tensor : In) {
+      StaticInputs.push_back(Tensor.clone());
     }
-  } else if (RawOutput.isTuple()) {
-    auto OutTensorsTuple = RawOutput.toTuple()->elements();
-    for (auto &OneOf : OutTensorsTuple) {
-      Out.push_back(OneOf.toTensor().clone());
+    std::vector<torch::jit::IValue> Inputs(StaticInputs.begin(),
+                                           StaticInputs.end());
+    try {
+      // Warm up on a side stream before capturing, as CUDA graphs require.
+      auto Stream = c10::cuda::getStreamFromPool();
+      at::cuda::CUDAEvent Ready;
+      Ready.record(c10::cuda::getCurrentCUDAStream());
+      Ready.block(Stream);
+      {
+        c10::cuda::CUDAStreamGuard Guard(Stream);
+        TorchModel.forward(Inputs);
+        auto Graph = std::make_unique<at::cuda::CUDAGraph>();
+        Graph->capture_begin();
+        auto RawOutput = TorchModel.forward(Inputs);
+        Graph->capture_end();
+        if (auto Res = collectOutputs(RawOutput, StaticOutputs, false);
+            *Res != ErrNo::Success) {
+          return Res;
+        }
+        CudaGraph = std::move(Graph);
+      }
+      at::cuda::CUDAEvent Captured;
+      Captured.record(Stream);
+      Captured.block(c10::cuda::getCurrentCUDAStream());
+      spdlog::debug("[WASI-NN] Torch: Captured the CUDA graph."sv);
+    } catch (const c10::Error &E) {
+      spdlog::warn("[WASI-NN] Torch: The model can not be captured into a "
+                   "CUDA graph, run it eagerly: {}"sv,
+                   E.what_without_backtrace());
+      CudaGraph.reset();
+      StaticInputs.clear();
+      StaticOutputs.clear();
+      Uncapturable = true;
     }
-  } else if (RawOutput.isTensor()) {
-    auto OutTensor = RawOutput.toTensor();
-    Out.push_back(OutTensor.clone());
-  } else {
-    spdlog::error(
-        "[WASI-NN] Torch: The output can only be one of the following tensor "
-        "types: a tensor, a list of tensors, or a tuple of tensors."sv);
-    return ErrNo::InvalidArgument;
+  }
+
+  if (!CudaGraph) {
+    std::vector<torch::jit::IValue> Inputs(In.begin(), In.end());
+    return collectOutputs(TorchModel.forward(Inputs), Out, true);
+  }
+  for (size_t I = 0; I < In.size(); ++I) {
+    StaticInputs[I].copy_(In[I], true);
+  }
+  CudaGraph->replay();
+  // The static outputs are overwritten by the next replay.
+  for (const auto &Tensor : StaticOutputs) {
+    Out.push_back(Tensor.clone());
   }
   return ErrNo::Success;
 }
+#endif
 
 AOTInductor::AOTInductor() : TorchModel(nullptr) {
 #if defined(_GLIBCXX_USE_CXX11_ABI) && _GLIBCXX_USE_CXX11_ABI == 1
@@ -140,6 +265,7 @@ Expect<ErrNo> AOTInductor::run(std::vector<at::Tensor> In,
                                std::vector<at::Tensor> &Out) {
   std::vector<at::Tensor> RawOutput = TorchModel->run(In);
 
+  Out.clear();
   for (auto &OneOf : RawOutput) {
     Out.push_back(OneOf.clone());
   }
@@ -196,16 +322,25 @@ Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
       return ErrNo::InvalidArgument;
     }
 
+    Expect<ErrNo> Res = ErrNo::Success;
     if (BinModel.substr(0, 8) == "preload:"sv) {
       const std::string ModelFilePath(BinModel.substr(8));
-      GraphRef.Model->loadFromPath(ModelFilePath, Device);
+      Res = GraphRef.Model->loadFromPath(ModelFilePath, Device);
     } else {
-      std::istringstream BinRead{std::string(BinModel)};
-      // std::istringstream BinRead(BinModel); // Need C++26...
-      GraphRef.Model->loadFromBinary(BinRead, Device);
+      // Parse the model in place, which may be the preloaded buffer shared by
+      // the VMs.
+      SpanStreamBuf Buf(Weight);
+      std::istream BinRead(&Buf);
+      Res = GraphRef.Model->loadFromBinary(BinRead, Device);
+    }
+    if (!Res || *Res != ErrNo::Success) {
+      delete GraphRef.Model;
+      Env.NNGraph.pop_back();
+      return Res;
     }
   } catch (const c10::Error &e) {
     spdlog::error("[WASI-NN] Torch: Failed when load the TorchScript model."sv);
+    delete GraphRef.Model;
     Env.NNGraph.pop_back();
     return ErrNo::InvalidArgument;
   }
@@ -240,12 +375,30 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
     Dims.push_back(static_cast<int64_t>(Tensor.Dimension[I]));
   }
   auto &GraphRef = Env.NNGraph[CxtRef.GraphId].get<Graph>();
-  torch::Tensor InTensor =
-      torch::from_blob(reinterpret_cast<float *>(Tensor.Tensor.data()), Dims,
-                       Options)
-          .to(GraphRef.Model->getDevice());
-
-  CxtRef.TorchInputs[Index] = InTensor.clone();
+  const auto Device = GraphRef.Model->getDevice();
+  torch::Tensor Blob = torch::from_blob(
+      reinterpret_cast<float *>(Tensor.Tensor.data()), Dims, Options);
+  auto &Input = CxtRef.TorchInputs[Index];
+  if (Device == at::kCPU && WasiNNEnvironment::NNZeroCopy.value()) {
+    // Read the guest memory in place until the next input.
+    Input = Blob;
+    return ErrNo::Success;
+  }
+  // Reuse the input tensor of the previous compute of the same shape.
+  if (!Input.defined() || Input.device().type() != Device ||
+      Input.sizes() != Blob.sizes() || Input.data_ptr() == Blob.data_ptr()) {
+    Input = torch::empty(Dims, Options.device(Device));
+  }
+  if (Device == at::kCUDA) {
+    // Stage the data in the pinned memory, so that the transfer does not
+    // block. The caching host allocator keeps the staging buffer until the
+    // transfer completes.
+    auto Staging = torch::empty(Dims, Options.pinned_memory(true));
+    Staging.copy_(Blob);
+    Input.copy_(Staging, true);
+  } else {
+    Input.copy_(Blob);
+  }
   return ErrNo::Success;
 }
 
@@ -260,7 +413,15 @@ Expect<ErrNo> getOutput(WasiNNEnvironment &Env, uint32_t ContextId,
     return ErrNo::InvalidArgument;
   }
   torch::Tensor OutTensor =
-      CxtRef.TorchOutputs[Index].to(at::kCPU).toType(torch::kFloat32);
+      CxtRef.TorchOutputs[Index].toType(torch::kFloat32).contiguous();
+  if (OutTensor.is_cuda()) {
+    // Read back through the pinned memory instead of the pageable memory.
+    auto Staging = torch::empty(
+        OutTensor.sizes(),
+        torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
+    Staging.copy_(OutTensor);
+    OutTensor = Staging;
+  }
   float *TensorBuffer = OutTensor.data_ptr<float>();
 
   size_t BlobSize = 1;
@@ -14,6 +14,11 @@
 #include <torch/csrc/inductor/aoti_runner/model_container_runner_cuda.h>
 #endif
 #include <torch/script.h>
+#ifdef WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA
+#include <ATen/cuda/CUDAGraph.h>
+#endif
+#include <memory>
+#include <mutex>
 #include <vector>
 #endif
 
@@ -51,6 +56,23 @@ public:
                     std::vector<at::Tensor> &Out) override;
 
   torch::jit::Module TorchModel;
+
+#ifdef WASMEDGE_PLUGIN_WASI_NN_TORCH_CUDA
+private:
+  /// Replay the captured graph if the input shapes are the captured ones, or
+  /// capture a new graph of the shapes.
+  Expect<ErrNo> runGraph(const std::vector<at::Tensor> &In,
+                         std::vector<at::Tensor> &Out);
+
+  /// The graph is bound to the static tensors, so the computes of the
+  /// contexts replay it one at a time.
+  std::mutex GraphMutex;
+  std::unique_ptr<at::cuda::CUDAGraph> CudaGraph;
+  std::vector<at::Tensor> StaticInputs;
+  std::vector<at::Tensor> StaticOutputs;
+  /// The model cannot be captured, such as running the host synchronizations.
+  bool Uncapturable = false;
+#endif
 };
 
 class AOTInductor : public PyBaseModule {
@@ -551,6 +551,9 @@ Expect<ErrNo> parseMetadata(Config &ConfigRef,
   //   detect-language: bool
   //   temperature: float
   //   prompt: string
+  //   stream: bool
+  //   stream-length-ms: uint32_t
+  //   stream-keep-ms: uint32_t
 
   // The plugin parameters.
   if (Doc.at_key("enable-log").error() == simdjson::SUCCESS) {
@@ -804,6 +807,37 @@ Expect<ErrNo> parseMetadata(Config &ConfigRef,
     }
     PrintParsedOption("offset-n"sv, ConfigRef.OffsetN);
   }
+  if (Doc.at_key("stream").error() == simdjson::SUCCESS) {
+    auto Err = Doc["stream"].get<bool>().get(ConfigRef.Stream);
+    if (Err) {
+      spdlog::error("[WASI-NN] Whisper backend: Unable to retrieve the stream "
+                    "option."sv);
+      return ErrNo::InvalidArgument;
+    }
+    PrintParsedOption("stream"sv, ConfigRef.Stream);
+  }
+  if (Doc.at_key("stream-length-ms").error() == simdjson::SUCCESS) {
+    auto Err =
+        Doc["stream-length-ms"].get<uint64_t>().get(ConfigRef.StreamLengthMS);
+    if (Err) {
+      spdlog::error(
+          "[WASI-NN] Whisper backend: Unable to retrieve the stream-length-ms "
+          "option."sv);
+      return ErrNo::InvalidArgument;
+    }
+    PrintParsedOption("stream-length-ms"sv, ConfigRef.StreamLengthMS);
+  }
+  if (Doc.at_key("stream-keep-ms").error() == simdjson::SUCCESS) {
+    auto Err =
+        Doc["stream-keep-ms"].get<uint64_t>().get(ConfigRef.StreamKeepMS);
+    if (Err) {
+      spdlog::error(
+          "[WASI-NN] Whisper backend: Unable to retrieve the stream-keep-ms "
+          "option."sv);
+      return ErrNo::InvalidArgument;
+    }
+    PrintParsedOption("stream-keep-ms"sv, ConfigRef.StreamKeepMS);
+  }
 
   return ErrNo::Success;
 }
@@ -838,6 +872,81 @@ Expect<ErrNo> handleTranslationConfig(whisper_context *WhisperCtx,
   return ErrNo::Success;
 }
 
+// Transcribe the sliding window of the stream with the new PCM chunks. The
+// output is the transcript of the window, which is final and ends with a
+// newline once the window reaches the stream length. The next window starts
+// from the last kept milliseconds with the tokens of this one as the prompt.
+Expect<ErrNo> computeStream(Graph &GraphRef, Context &CxtRef) noexcept {
+  const auto &ConfigRef = CxtRef.WhisperConfig;
+  const size_t NLength = ConfigRef.StreamLengthMS * WHISPER_SAMPLE_RATE / 1000;
+  const size_t NKeep = ConfigRef.StreamKeepMS * WHISPER_SAMPLE_RATE / 1000;
+
+  // Slide the window if the last one is completed.
+  if (CxtRef.StreamWindow.size() >= NLength) {
+    CxtRef.StreamWindow.erase(
+        CxtRef.StreamWindow.begin(),
+        CxtRef.StreamWindow.end() -
+            std::min(NKeep, CxtRef.StreamWindow.size()));
+  }
+  CxtRef.StreamWindow.insert(CxtRef.StreamWindow.end(),
+                             CxtRef.StreamPCM.begin(), CxtRef.StreamPCM.end());
+  CxtRef.StreamPCM.clear();
+  CxtRef.Outputs.clear();
+  // Whisper needs at least one second of audio.
+  if (CxtRef.StreamWindow.size() < WHISPER_SAMPLE_RATE) {
+    return ErrNo::Success;
+  }
+
+  // The state keeps the buffers of the encoder and decoder across the calls.
+  if (CxtRef.StreamState == nullptr) {
+    CxtRef.StreamState = whisper_init_state(GraphRef.WhisperCtx);
+    if (CxtRef.StreamState == nullptr) {
+      spdlog::error(
+          "[WASI-NN] Whisper backend: Error: failed to init stream state."sv);
+      return ErrNo::RuntimeError;
+    }
+  }
+  whisper_full_params Params = CxtRef.WhisperParams;
+  Params.new_segment_callback = nullptr;
+  Params.new_segment_callback_user_data = nullptr;
+  Params.offset_ms = 0;
+  Params.duration_ms = 0;
+  Params.single_segment = true;
+  Params.no_timestamps = true;
+  Params.print_timestamps = false;
+  Params.no_context = true;
+  Params.prompt_tokens =
+      CxtRef.StreamPrompt.empty() ? nullptr : CxtRef.StreamPrompt.data();
+  Params.prompt_n_tokens = static_cast<int>(CxtRef.StreamPrompt.size());
+  if (whisper_full_with_state(GraphRef.WhisperCtx, CxtRef.StreamState, Params,
+                              CxtRef.StreamWindow.data(),
+                              static_cast<int>(CxtRef.StreamWindow.size())) !=
+      0) {
+    spdlog::error(
+        "[WASI-NN] Whisper backend: Error: failed to process audio."sv);
+    return ErrNo::RuntimeError;
+  }
+
+  const int SegN = whisper_full_n_segments_from_state(CxtRef.StreamState);
+  for (int I = 0; I < SegN; I++) {
+    CxtRef.Outputs +=
+        whisper_full_get_segment_text_from_state(CxtRef.StreamState, I);
+  }
+  if (CxtRef.StreamWindow.size() >= NLength) {
+    CxtRef.Outputs += "\n";
+    CxtRef.StreamPrompt.clear();
+    for (int I = 0; I < SegN; I++) {
+      const int TokenN =
+          whisper_full_n_tokens_from_state(CxtRef.StreamState, I);
+      for (int J = 0; J < TokenN; J++) {
+        CxtRef.StreamPrompt.push_back(
+            whisper_full_get_token_id_from_state(CxtRef.StreamState, I, J));
+      }
+    }
+  }
+  return ErrNo::Success;
+}
+
 } // Namespace
 
 Expect<ErrNo> load(WasiNNEnvironment &Env, Span<const Span<uint8_t>> Builders,
@@ -972,6 +1081,10 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
       return Res;
     }
     setWhisperParams(CxtRef);
+    // Setting the metadata starts a new stream.
+    CxtRef.StreamPCM.clear();
+    CxtRef.StreamWindow.clear();
+    CxtRef.StreamPrompt.clear();
     if (CxtRef.WhisperConfig.EnableDebugLog) {
       spdlog::info("[WASI-NN][Debug] Whisper backend: found Metadata, "
                    "processing...Done"sv);
@@ -990,6 +1103,18 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
     return WASINN::ErrNo::InvalidArgument;
   }
 
+  // In the stream mode, the F32 tensor is a chunk of mono-channel PCM
+  // samples, appended to the stream.
+  if (CxtRef.WhisperConfig.Stream && Tensor.RType == TensorType::F32) {
+    const auto *Samples = reinterpret_cast<const float *>(Tensor.Tensor.data());
+    CxtRef.StreamPCM.insert(CxtRef.StreamPCM.end(), Samples,
+                            Samples + Tensor.Tensor.size() / sizeof(float));
+    if (CxtRef.WhisperConfig.EnableDebugLog) {
+      spdlog::info("[WASI-NN][Debug] Whisper backend: setInput...Done"sv);
+    }
+    return ErrNo::Success;
+  }
+
   // Tensor type not used here. Not to check this.
 
   // Check the input audio file format and load. Currently WAV supported.
@@ -1004,6 +1129,10 @@ Expect<ErrNo> setInput(WasiNNEnvironment &Env, uint32_t ContextId,
                CxtRef.WhisperConfig.Diarize)) {
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (CxtRef.WhisperConfig.Stream) {
+    CxtRef.StreamPCM.insert(CxtRef.StreamPCM.end(), CxtRef.InputPCM.begin(),
+                            CxtRef.InputPCM.end());
+  }
 
   if (CxtRef.WhisperConfig.EnableDebugLog) {
     spdlog::info("[WASI-NN][Debug] Whisper backend: setInput...Done"sv);
@@ -1064,6 +1193,10 @@ Expect<ErrNo> compute(WasiNNEnvironment &Env, uint32_t ContextId) noexcept {
     spdlog::info("[WASI-NN][Debug] Whisper backend: compute"sv);
   }
 
+  if (CxtRef.WhisperConfig.Stream) {
+    return computeStream(GraphRef, CxtRef);
+  }
+
   CxtRef.Outputs.clear();
   if (whisper_full_parallel(GraphRef.WhisperCtx, CxtRef.WhisperParams,
                             CxtRef.InputPCM.data(), CxtRef.InputPCM.size(),
@@ -1114,6 +1247,10 @@ Expect<ErrNo> finalizeExecCtx(WasiNNEnvironment &Env,
         "[WASI-NN][Debug] Whisper backend: finalize_execution_context"sv);
   }
   // TODO: Free resources
+  if (CxtRef.StreamState != nullptr) {
+    whisper_free_state(CxtRef.StreamState);
+    CxtRef.StreamState = nullptr;
+  }
   Env.deleteContext(ContextId);
   if (IsDebugLog) {
     spdlog::info(
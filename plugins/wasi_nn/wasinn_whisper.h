@@ -53,6 +53,10 @@ struct Config {
   bool OutputJsonFull = false;
   bool NoTimestamps = false;
   uint64_t AudioCtx = 0;
+  // Streaming parameters:
+  bool Stream = false;
+  uint64_t StreamLengthMS = 10000;
+  uint64_t StreamKeepMS = 200;
   // Sampling parameters:
   float WordThreshold = 0.01f;
   float EntropyThreshold = 2.40f;
@@ -86,6 +90,14 @@ public:
   whisper_full_params WhisperParams;
   // Recognition outputs.
   std::string Outputs;
+  // Streaming transcription:
+  // The PCM chunks set after the last compute, and the sliding window of the
+  // audio transcribed again in every compute.
+  std::vector<float> StreamPCM;
+  std::vector<float> StreamWindow;
+  // Tokens of the last completed window, as the prompt of the next one.
+  std::vector<whisper_token> StreamPrompt;
+  whisper_state *StreamState = nullptr;
 };
 #else
 struct Graph {};
@@ -5,6 +5,7 @@
 #include "wasinnmodule.h"
 #include "wasinntypes.h"
 
+#include <algorithm>
 #include <sstream>
 
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
@@ -46,6 +47,9 @@ std::map<std::string_view, Device> DeviceMap = {{"cpu"sv, Device::CPU},
                                                 {"tpu"sv, Device::TPU},
                                                 {"auto"sv, Device::AUTO}};
 
+// Preloaded model files, read once for all the VMs.
+SharedRegistry<std::vector<uint8_t>> ModelFiles;
+
 bool load(const std::filesystem::path &Path, std::vector<uint8_t> &Data) {
   std::ifstream File(Path, std::ios::binary);
   if (!File.is_open()) {
@@ -73,7 +77,15 @@ WasiNNEnvironment::WasiNNEnvironment() noexcept {
         spdlog::warn("[WASI-NN] Expected \"unix://...\", got \"{}\""sv, URI);
       }
       auto Cred = grpc::InsecureChannelCredentials(); // safe for unix://...
-      NNRPCChannel = grpc::CreateChannel(URI, Cred);
+      // A local subchannel pool gives every channel its own connection.
+      const uint32_t Count = std::max(NNRPCChannelCount.value(), UINT32_C(1));
+      for (uint32_t I = 0; I < Count; ++I) {
+        grpc::ChannelArguments Args;
+        Args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+        NNRPCChannelPool.push_back(
+            grpc::CreateCustomChannel(URI, Cred, Args));
+      }
+      NNRPCChannel = NNRPCChannelPool.front();
       if (NNModels.value().size() > 0) {
         spdlog::warn(
             "[WASI-NN] nn-preload has to be specified on the RPC server side, not on the client side"sv);
@@ -97,7 +109,7 @@ WasiNNEnvironment::WasiNNEnvironment() noexcept {
     while (std::getline(ISS, Path, Delimiter)) {
       Paths.push_back(Path);
     }
-    std::vector<std::vector<uint8_t>> Models;
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> Models;
     Models.reserve(Paths.size());
     std::transform(Encode.begin(), Encode.end(), Encode.begin(),
                    [](unsigned char C) {
@@ -127,12 +139,18 @@ WasiNNEnvironment::WasiNNEnvironment() noexcept {
         // We write model path to model data to avoid file IO in
         // llama.cpp.
         std::string ModelPath = "preload:" + P;
-        std::vector<uint8_t> ModelPathData(ModelPath.begin(), ModelPath.end());
-        Models.push_back(std::move(ModelPathData));
+        Models.push_back(std::make_shared<std::vector<uint8_t>>(
+            ModelPath.begin(), ModelPath.end()));
       } else {
         for (const std::string &P : Paths) {
-          std::vector<uint8_t> Model;
-          if (load(std::filesystem::u8path(P), Model)) {
+          auto Model = ModelFiles.get(P, [&P]() {
+            auto Data = std::make_shared<std::vector<uint8_t>>();
+            if (!load(std::filesystem::u8path(P), *Data)) {
+              Data.reset();
+            }
+            return Data;
+          });
+          if (Model != nullptr) {
             Models.push_back(std::move(Model));
           }
         }
@@ -148,25 +166,133 @@ WasiNNEnvironment::WasiNNEnvironment() noexcept {
   NNContext.reserve(16U);
 }
 
+ComputeWorkers::~ComputeWorkers() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    Stopping = true;
+  }
+  Cond.notify_all();
+  for (auto &[BE, W] : Workers) {
+    W.Thread.join();
+  }
+}
+
+bool ComputeWorkers::submit(Backend BE, uint32_t ContextId,
+                            Job Compute) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (!Tasks.try_emplace(ContextId, Task{std::move(Compute), std::nullopt})
+           .second) {
+    return false;
+  }
+  auto [It, Added] = Workers.try_emplace(BE);
+  It->second.Queue.push_back(ContextId);
+  if (Added) {
+    It->second.Thread = std::thread([this, &W = It->second]() { run(W); });
+  }
+  Lock.unlock();
+  Cond.notify_all();
+  return true;
+}
+
+bool ComputeWorkers::isBusy(uint32_t ContextId) const noexcept {
+  std::unique_lock Lock(Mutex);
+  return Tasks.find(ContextId) != Tasks.end();
+}
+
+std::optional<Expect<ErrNo>>
+ComputeWorkers::poll(uint32_t ContextId,
+                     std::chrono::nanoseconds Timeout) noexcept {
+  std::unique_lock Lock(Mutex);
+  auto Finished = [&]() {
+    auto It = Tasks.find(ContextId);
+    return It == Tasks.end() || It->second.Result.has_value();
+  };
+  Cond.wait_for(Lock, Timeout, Finished);
+  auto It = Tasks.find(ContextId);
+  if (It == Tasks.end()) {
+    spdlog::error("[WASI-NN] Context ID {} has no asynchronous compute."sv,
+                  ContextId);
+    return ErrNo::InvalidArgument;
+  }
+  if (!It->second.Result.has_value()) {
+    return std::nullopt;
+  }
+  auto Result = std::move(*It->second.Result);
+  Tasks.erase(It);
+  return Result;
+}
+
+void ComputeWorkers::run(Worker &W) noexcept {
+  std::unique_lock Lock(Mutex);
+  while (true) {
+    Cond.wait(Lock, [&]() { return Stopping || !W.Queue.empty(); });
+    if (Stopping) {
+      return;
+    }
+    const uint32_t ContextId = W.Queue.front();
+    W.Queue.pop_front();
+    // The task is not erased before its result is set.
+    Job Compute = std::move(Tasks[ContextId].Compute);
+    Lock.unlock();
+    auto Result = Compute();
+    Lock.lock();
+    Tasks[ContextId].Result = std::move(Result);
+    Cond.notify_all();
+  }
+}
+
 PO::List<std::string> WasiNNEnvironment::NNModels(
     PO::Description(
         "Allow preload models from wasinn plugin. Each NN model can be specified as --nn-preload `COMMAND`."sv),
     PO::MetaVar("COMMANDS"sv));
 
+PO::Option<PO::Toggle> WasiNNEnvironment::NNZeroCopy(PO::Description(
+    "Let the NN backends read the input tensors from the wasm memory without copying. The input data must not be changed before compute."sv));
+
+PO::Option<uint32_t> WasiNNEnvironment::NNBatchWindow(
+    PO::Description(
+        "Batch the concurrent computes of the same model which arrive within the window, in microseconds. Supported by the OpenVINO backend. 0 to disable."sv),
+    PO::MetaVar("MICROSECONDS"sv), PO::DefaultValue<uint32_t>(0));
+
+PO::Option<uint32_t> WasiNNEnvironment::NNBatchSize(
+    PO::Description("Maximum number of the computes in a batch."sv),
+    PO::MetaVar("SIZE"sv), PO::DefaultValue<uint32_t>(8));
+
+PO::Option<PO::Toggle> WasiNNEnvironment::NNTorchCudaGraph(PO::Description(
+    "Capture the computes of the PyTorch models on CUDA into CUDA graphs, and replay them while the input shapes stay the same."sv));
+
+PO::Option<uint32_t> WasiNNEnvironment::NNChatTTSWorkers(
+    PO::Description(
+        "Run each ChatTTS model in the given number of Python worker processes, so that the computes are not serialized by the GIL. 0 to run in the process."sv),
+    PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(0));
+
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
 PO::Option<std::string> WasiNNEnvironment::NNRPCURI(
     PO::Description("Specify NN RPC URI to connect (\"unix://...\")"sv),
     PO::MetaVar("URI"sv), PO::DefaultValue(std::string("")));
+PO::Option<uint32_t> WasiNNEnvironment::NNRPCChannelCount(
+    PO::Description(
+        "Specify the number of connections to the NN RPC server. The contexts are spread over the connections."sv),
+    PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(1));
 #endif
 
 namespace {
 void addOptions(const Plugin::Plugin::PluginDescriptor *,
                 PO::ArgumentParser &Parser) noexcept {
   Parser.add_option("nn-preload"sv, WasiNNEnvironment::NNModels);
+  Parser.add_option("nn-zero-copy"sv, WasiNNEnvironment::NNZeroCopy);
+  Parser.add_option("nn-batch-window"sv, WasiNNEnvironment::NNBatchWindow);
+  Parser.add_option("nn-batch-size"sv, WasiNNEnvironment::NNBatchSize);
+  Parser.add_option("nn-torch-cuda-graph"sv,
+                    WasiNNEnvironment::NNTorchCudaGraph);
+  Parser.add_option("nn-chattts-workers"sv,
+                    WasiNNEnvironment::NNChatTTSWorkers);
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (getenv("_WASI_NN_RPCSERVER") == nullptr) {
     // RPC client mode
     Parser.add_option("nn-rpc-uri"sv, WasiNNEnvironment::NNRPCURI);
+    Parser.add_option("nn-rpc-channels"sv,
+                      WasiNNEnvironment::NNRPCChannelCount);
   }
 #endif
 }
@@ -25,13 +25,22 @@
 #include "plugin/plugin.h"
 #include "runtime/callingframe.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
+#include "wasi_ephemeral_nn.grpc.pb.h"
+
 #include <grpc/grpc.h>
 #include <grpcpp/create_channel.h>
 #endif
@@ -223,6 +232,46 @@ private:
   uint32_t GraphId;
 };
 
+// Worker threads of the asynchronous computes. Every backend has its own
+// worker, so the computes of a backend run in the order of submission and the
+// guest thread is free to work or to compute on another backend.
+class ComputeWorkers {
+public:
+  using Job = std::function<Expect<WASINN::ErrNo>()>;
+
+  ComputeWorkers() noexcept = default;
+  ~ComputeWorkers() noexcept;
+  ComputeWorkers(const ComputeWorkers &) = delete;
+  ComputeWorkers &operator=(const ComputeWorkers &) = delete;
+
+  // Queue the compute of the context on the worker of the backend. Returns
+  // false if the context already has a compute which is not polled.
+  bool submit(Backend BE, uint32_t ContextId, Job Compute) noexcept;
+  // Whether the context has a compute which is not polled.
+  bool isBusy(uint32_t ContextId) const noexcept;
+  // Wait for the compute of the context up to the timeout. Returns the result
+  // and forgets the compute if it is finished, or std::nullopt if not.
+  std::optional<Expect<WASINN::ErrNo>>
+  poll(uint32_t ContextId, std::chrono::nanoseconds Timeout) noexcept;
+
+private:
+  struct Task {
+    Job Compute;
+    std::optional<Expect<WASINN::ErrNo>> Result;
+  };
+  struct Worker {
+    std::thread Thread;
+    std::deque<uint32_t> Queue;
+  };
+  void run(Worker &W) noexcept;
+
+  mutable std::mutex Mutex;
+  std::condition_variable Cond;
+  std::unordered_map<uint32_t, Task> Tasks;
+  std::map<Backend, Worker> Workers;
+  bool Stopping = false;
+};
+
 struct WasiNNEnvironment :
 #define EACH(B) B::Environ,
     FOR_EACH_BACKEND(EACH)
@@ -261,11 +310,11 @@ struct WasiNNEnvironment :
     std::unique_lock Lock(MdMutex);
     auto It = RawMdMap.find(Name);
     if (It != RawMdMap.end()) {
-      auto RawMd = std::get<0>(It->second);
+      const auto &RawMd = std::get<0>(It->second);
       std::vector<Span<uint8_t>> Builders;
-      Builders.reserve(RawMd.size());
+      Builders.reserve(RawMd.size() + 1);
       for (auto &Builder : RawMd) {
-        Builders.emplace_back(Builder);
+        Builders.emplace_back(*Builder);
       }
       // Add config to the end of Builders if exists.
       if (Config.size() > 0) {
@@ -356,8 +405,11 @@ struct WasiNNEnvironment :
 
   // Md storage
   mutable std::shared_mutex MdMutex;
-  std::unordered_map<std::string, std::tuple<std::vector<std::vector<uint8_t>>,
-                                             Backend, Device>>
+  // The model files are shared by the environments of all the VMs.
+  std::unordered_map<
+      std::string,
+      std::tuple<std::vector<std::shared_ptr<std::vector<uint8_t>>>, Backend,
+                 Device>>
       RawMdMap;
   std::unordered_map<std::string, uint32_t> MdMap;
 
@@ -367,12 +419,59 @@ struct WasiNNEnvironment :
   std::vector<Graph> NNGraph;
   std::unordered_set<uint32_t> NNContextRecycle;
   std::vector<Context> NNContext;
+  // Asynchronous computes, stopped before the graphs and contexts are
+  // destroyed.
+  ComputeWorkers Workers;
 
   // Preload model list
   static PO::List<std::string> NNModels;
+  // Let the backends wrap the guest memory of the input tensors.
+  static PO::Option<PO::Toggle> NNZeroCopy;
+  // Dynamic batching window in microseconds, 0 to disable, and the maximum
+  // batch size.
+  static PO::Option<uint32_t> NNBatchWindow;
+  static PO::Option<uint32_t> NNBatchSize;
+  // Replay the computes of the PyTorch models on CUDA as CUDA graphs.
+  static PO::Option<PO::Toggle> NNTorchCudaGraph;
+  // Python worker processes of each ChatTTS model, 0 to run in the process.
+  static PO::Option<uint32_t> NNChatTTSWorkers;
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   static PO::Option<std::string> NNRPCURI; // For RPC client mode
+  static PO::Option<uint32_t> NNRPCChannelCount;
   std::shared_ptr<grpc::Channel> NNRPCChannel;
+  // Connections for the contexts, so that the requests of the contexts do
+  // not queue behind each other. NNRPCChannel is the first one.
+  std::vector<std::shared_ptr<grpc::Channel>> NNRPCChannelPool;
+
+  // Client side state of a context in RPC mode.
+  struct RPCContext {
+    // Inputs sent together with the next compute.
+    std::vector<wasi_ephemeral_nn::SetInputRequest> Inputs;
+    // Outputs received with the last compute.
+    std::map<uint32_t, std::string> Outputs;
+    // Output stream of compute_single, and its last output.
+    std::unique_ptr<grpc::ClientContext> StreamContext;
+    std::unique_ptr<grpc::ClientReader<wasi_ephemeral_nn::GetOutputResult>>
+        Stream;
+    std::string StreamOutput;
+  };
+  std::mutex NNRPCMutex;
+  std::unordered_map<uint32_t, RPCContext> NNRPCContexts;
+
+  const std::shared_ptr<grpc::Channel> &
+  getRPCChannel(uint32_t ContextId) const noexcept {
+    return NNRPCChannelPool[ContextId % NNRPCChannelPool.size()];
+  }
+  // The contexts initialized by this client, or nullptr.
+  RPCContext *findRPCContext(uint32_t ContextId) noexcept {
+    std::unique_lock Lock(NNRPCMutex);
+    auto It = NNRPCContexts.find(ContextId);
+    return It != NNRPCContexts.end() ? &It->second : nullptr;
+  }
+  void addRPCContext(uint32_t ContextId) noexcept {
+    std::unique_lock Lock(NNRPCMutex);
+    NNRPCContexts.insert_or_assign(ContextId, RPCContext{});
+  }
 #endif
 
   const Host::WASI::Environ *getEnv() const noexcept { return Environ; }
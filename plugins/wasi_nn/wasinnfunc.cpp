@@ -6,6 +6,9 @@
 
 #include "common/spdlog.h"
 
+#include <algorithm>
+#include <chrono>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 
@@ -22,6 +25,17 @@ namespace {
 inline void reportUnknownBackend(WASINN::Backend B) noexcept {
   spdlog::error("[WASI-NN] Unknown backend {}."sv, static_cast<uint32_t>(B));
 }
+// The context must not be used before its asynchronous compute is polled.
+inline bool isComputing(const WASINN::WasiNNEnvironment &Env,
+                        uint32_t ContextId) noexcept {
+  if (Env.Workers.isBusy(ContextId)) {
+    spdlog::error("[WASI-NN] Context ID {} has an asynchronous compute in "sv
+                  "flight."sv,
+                  ContextId);
+    return true;
+  }
+  return false;
+}
 Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
                            Span<const Span<uint8_t>> Builders,
                            WASINN::Backend Backend, WASINN::Device Device,
@@ -37,6 +51,19 @@ Expect<WASINN::ErrNo> load(WASINN::WasiNNEnvironment &Env,
     return WASINN::ErrNo::InvalidEncoding;
   }
 }
+Expect<WASINN::ErrNo> runCompute(WASINN::WasiNNEnvironment &Env,
+                                 uint32_t ContextId) {
+  switch (const auto Backend = Env.NNContext[ContextId].getBackend()) {
+#define EACH(B)                                                                \
+  case WASINN::Backend::B:                                                     \
+    return WASINN::B::compute(Env, ContextId);
+    FOR_EACH_BACKEND(EACH)
+#undef EACH
+  default:
+    reportUnknownBackend(Backend);
+    return WASINN::ErrNo::InvalidEncoding;
+  }
+}
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
 WASINN::ErrNo metadataToErrNo(
     const std::multimap<grpc::string_ref, grpc::string_ref> &Metadata) {
@@ -46,6 +73,20 @@ WASINN::ErrNo metadataToErrNo(
   }
   return WASINN::ErrNo::Success;
 }
+// Cancel the compute_single stream of the context, e.g. before the next
+// inputs. The server may have computed ahead of the outputs read.
+void cancelStream(WASINN::WasiNNEnvironment::RPCContext &RPCCtx) {
+  if (RPCCtx.Stream) {
+    RPCCtx.StreamContext->TryCancel();
+    RPCCtx.Stream->Finish();
+    RPCCtx.Stream.reset();
+    RPCCtx.StreamContext.reset();
+  }
+}
+inline void reportUnknownRPCContext(uint32_t ContextId) noexcept {
+  spdlog::error("[WASI-NN] Context ID {} is not initialized by this client."sv,
+                ContextId);
+}
 #endif // #ifdef WASMEDGE_BUILD_WASI_NN_RPC
 } // namespace
 
@@ -259,6 +300,7 @@ WasiNNInitExecCtx::bodyImpl(const Runtime::CallingFrame &Frame,
       return metadataToErrNo(Metadata);
     }
     *Context = Res.ctx_handle();
+    Env.addRPCContext(Res.ctx_handle());
     return WASINN::ErrNo::Success;
   }
 #endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
@@ -346,25 +388,29 @@ WasiNNSetInput::bodyImpl(const Runtime::CallingFrame &Frame, uint32_t ContextId,
 
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
-    auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
-    grpc::ClientContext ClientContext;
-    wasi_ephemeral_nn::SetInputRequest Req;
+    // The inputs are sent with the next compute to save the round trips, so
+    // the errors of the inputs are returned by the compute.
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    cancelStream(*RPCCtx);
+    RPCCtx->Outputs.clear();
+    auto It = std::find_if(
+        RPCCtx->Inputs.begin(), RPCCtx->Inputs.end(),
+        [Index](const auto &Input) { return Input.index() == Index; });
+    auto &Req =
+        It != RPCCtx->Inputs.end() ? *It : RPCCtx->Inputs.emplace_back();
     Req.set_resource_handle(ContextId);
     Req.set_index(Index);
     wasi_ephemeral_nn::Tensor RPCTensor;
     RPCTensor.mutable_dimensions()->Add(Tensor.Dimension.begin(),
                                         Tensor.Dimension.end());
     RPCTensor.set_ty(wasi_ephemeral_nn::TensorType(Tensor.RType));
-    RPCTensor.set_data(MemInst->getPointer<char *>(WasiTensor->TensorPtr),
-                       WasiTensor->TensorLen);
-    *Req.mutable_tensor() = RPCTensor;
-    google::protobuf::Empty Res;
-    auto Status = Stub->SetInput(&ClientContext, Req, &Res);
-    if (!Status.ok()) {
-      auto Metadata = ClientContext.GetServerTrailingMetadata();
-      return metadataToErrNo(Metadata);
-    }
+    RPCTensor.set_data(reinterpret_cast<const char *>(Tensor.Tensor.data()),
+                       Tensor.Tensor.size());
+    *Req.mutable_tensor() = std::move(RPCTensor);
     return WASINN::ErrNo::Success;
   }
 #endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
@@ -375,6 +421,9 @@ WasiNNSetInput::bodyImpl(const Runtime::CallingFrame &Frame, uint32_t ContextId,
                   ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   switch (const auto Backend = Env.NNContext[ContextId].getBackend()) {
 #define EACH(B)                                                                \
@@ -414,8 +463,20 @@ WasiNNGetOutput::bodyImpl(const Runtime::CallingFrame &Frame,
 
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    if (auto It = RPCCtx->Outputs.find(Index); It != RPCCtx->Outputs.end()) {
+      uint32_t BytesWrittenVal =
+          std::min(static_cast<uint32_t>(It->second.size()), OutBufferMaxSize);
+      std::copy_n(It->second.begin(), BytesWrittenVal, OutBuffer.begin());
+      *BytesWritten = BytesWrittenVal;
+      return WASINN::ErrNo::Success;
+    }
     auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
+        Env.getRPCChannel(ContextId));
     grpc::ClientContext ClientContext;
     wasi_ephemeral_nn::GetOutputRequest Req;
     Req.set_resource_handle(ContextId);
@@ -440,6 +501,9 @@ WasiNNGetOutput::bodyImpl(const Runtime::CallingFrame &Frame,
                   ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   switch (const auto Backend = Env.NNContext[ContextId].getBackend()) {
 #define EACH(B)                                                                \
@@ -479,8 +543,22 @@ Expect<WASINN::ErrNo> WasiNNGetOutputSingle::bodyImpl(
 
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    if (RPCCtx->Stream) {
+      uint32_t BytesWrittenVal =
+          std::min(static_cast<uint32_t>(RPCCtx->StreamOutput.size()),
+                   OutBufferMaxSize);
+      std::copy_n(RPCCtx->StreamOutput.begin(), BytesWrittenVal,
+                  OutBuffer.begin());
+      *BytesWritten = BytesWrittenVal;
+      return WASINN::ErrNo::Success;
+    }
     auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
+        Env.getRPCChannel(ContextId));
     grpc::ClientContext ClientContext;
     wasi_ephemeral_nn::GetOutputRequest Req;
     Req.set_resource_handle(ContextId);
@@ -506,6 +584,9 @@ Expect<WASINN::ErrNo> WasiNNGetOutputSingle::bodyImpl(
         ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   switch (Env.NNContext[ContextId].getBackend()) {
   case WASINN::Backend::GGML:
@@ -514,10 +595,13 @@ Expect<WASINN::ErrNo> WasiNNGetOutputSingle::bodyImpl(
   case WASINN::Backend::BitNet:
     return WASINN::BitNet::getOutputSingle(Env, ContextId, Index, OutBuffer,
                                            *BytesWritten);
+  case WASINN::Backend::Piper:
+    return WASINN::Piper::getOutputSingle(Env, ContextId, Index, OutBuffer,
+                                          *BytesWritten);
   default:
     spdlog::error(
-        "[WASI-NN] get_output_single: Only GGML and BitNet backend supports "sv
-        "get_output_single."sv);
+        "[WASI-NN] get_output_single: Only GGML, BitNet and Piper backends "sv
+        "support get_output_single."sv);
     return WASINN::ErrNo::InvalidArgument;
   }
 }
@@ -528,17 +612,33 @@ WasiNNCompute::bodyImpl(const Runtime::CallingFrame &Frame,
   Env.setEnviron(&Frame);
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
+    // Send the inputs and prefetch the first output in the same round trip.
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    cancelStream(*RPCCtx);
+    RPCCtx->Outputs.clear();
     auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
+        Env.getRPCChannel(ContextId));
     grpc::ClientContext ClientContext;
-    wasi_ephemeral_nn::ComputeRequest Req;
+    wasi_ephemeral_nn::ComputeWithIORequest Req;
     Req.set_resource_handle(ContextId);
-    google::protobuf::Empty Res;
-    auto Status = Stub->Compute(&ClientContext, Req, &Res);
+    for (auto &Input : RPCCtx->Inputs) {
+      *Req.add_inputs() = std::move(Input);
+    }
+    RPCCtx->Inputs.clear();
+    Req.add_output_indices(0);
+    wasi_ephemeral_nn::ComputeWithIOResult Res;
+    auto Status = Stub->ComputeWithIO(&ClientContext, Req, &Res);
     if (!Status.ok()) {
       auto Metadata = ClientContext.GetServerTrailingMetadata();
       return metadataToErrNo(Metadata);
     }
+    for (auto &Output : *Res.mutable_outputs()) {
+      RPCCtx->Outputs[Output.index()] = std::move(*Output.mutable_data());
+    }
     return WASINN::ErrNo::Success;
   }
 #endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
@@ -553,6 +653,9 @@ WasiNNCompute::bodyImpl(const Runtime::CallingFrame &Frame,
                   ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   auto GraphId = Env.NNContext[ContextId].getGraphId();
   assuming(Env.NNGraph.size() > GraphId);
@@ -563,16 +666,7 @@ WasiNNCompute::bodyImpl(const Runtime::CallingFrame &Frame,
     return WASINN::ErrNo::InvalidArgument;
   }
 
-  switch (const auto Backend = Env.NNContext[ContextId].getBackend()) {
-#define EACH(B)                                                                \
-  case WASINN::Backend::B:                                                     \
-    return WASINN::B::compute(Env, ContextId);
-    FOR_EACH_BACKEND(EACH)
-#undef EACH
-  default:
-    reportUnknownBackend(Backend);
-    return WASINN::ErrNo::InvalidEncoding;
-  }
+  return runCompute(Env, ContextId);
 }
 
 Expect<WASINN::ErrNo>
@@ -581,17 +675,36 @@ WasiNNComputeSingle::bodyImpl(const Runtime::CallingFrame &Frame,
   Env.setEnviron(&Frame);
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
-    auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
-    grpc::ClientContext ClientContext;
-    wasi_ephemeral_nn::ComputeRequest Req;
-    Req.set_resource_handle(ContextId);
-    google::protobuf::Empty Res;
-    auto Status = Stub->ComputeSingle(&ClientContext, Req, &Res);
-    if (!Status.ok()) {
-      auto Metadata = ClientContext.GetServerTrailingMetadata();
-      return metadataToErrNo(Metadata);
+    // The first compute_single sends the inputs and opens a stream, which
+    // delivers the output of every following compute_single.
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    if (!RPCCtx->Stream) {
+      auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
+          Env.getRPCChannel(ContextId));
+      wasi_ephemeral_nn::ComputeWithIORequest Req;
+      Req.set_resource_handle(ContextId);
+      for (auto &Input : RPCCtx->Inputs) {
+        *Req.add_inputs() = std::move(Input);
+      }
+      RPCCtx->Inputs.clear();
+      RPCCtx->StreamContext = std::make_unique<grpc::ClientContext>();
+      RPCCtx->Stream =
+          Stub->ComputeSingleStream(RPCCtx->StreamContext.get(), Req);
     }
+    wasi_ephemeral_nn::GetOutputResult Res;
+    if (!RPCCtx->Stream->Read(&Res)) {
+      // The stream ends with the errno, e.g. the end of sequence.
+      auto Status = RPCCtx->Stream->Finish();
+      auto Metadata = RPCCtx->StreamContext->GetServerTrailingMetadata();
+      RPCCtx->Stream.reset();
+      RPCCtx->StreamContext.reset();
+      return Status.ok() ? WASINN::ErrNo::Success : metadataToErrNo(Metadata);
+    }
+    RPCCtx->StreamOutput = std::move(*Res.mutable_data());
     return WASINN::ErrNo::Success;
   }
 #endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
@@ -606,6 +719,9 @@ WasiNNComputeSingle::bodyImpl(const Runtime::CallingFrame &Frame,
                   ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   auto GraphId = Env.NNContext[ContextId].getGraphId();
   assuming(Env.NNGraph.size() > GraphId);
@@ -621,10 +737,151 @@ WasiNNComputeSingle::bodyImpl(const Runtime::CallingFrame &Frame,
     return WASINN::GGML::computeSingle(Env, ContextId);
   case WASINN::Backend::BitNet:
     return WASINN::BitNet::computeSingle(Env, ContextId);
+  case WASINN::Backend::Piper:
+    return WASINN::Piper::computeSingle(Env, ContextId);
   default:
     spdlog::error(
-        "[WASI-NN] compute_single: Only GGML and BitNet backend supports "sv
-        "compute_single."sv);
+        "[WASI-NN] compute_single: Only GGML, BitNet and Piper backends "sv
+        "support compute_single."sv);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+}
+
+Expect<WASINN::ErrNo>
+WasiNNComputeAsync::bodyImpl(const Runtime::CallingFrame &Frame,
+                             uint32_t ContextId) {
+  Env.setEnviron(&Frame);
+#ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  if (Env.NNRPCChannel != nullptr) {
+    spdlog::error("[WASI-NN] compute_async: Not supported in RPC mode."sv);
+    return WASINN::ErrNo::UnsupportedOperation;
+  }
+#endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  if (Env.NNContext.size() <= ContextId ||
+      !Env.NNContext[ContextId].isReady()) {
+    spdlog::error("[WASI-NN] compute_async: Context ID {} does not exist."sv,
+                  ContextId);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  auto GraphId = Env.NNContext[ContextId].getGraphId();
+  assuming(Env.NNGraph.size() > GraphId);
+  if (!Env.NNGraph[GraphId].isReady()) {
+    spdlog::error("[WASI-NN] compute_async: Graph ID {} for context ID {} "sv
+                  "does not exist or has released."sv,
+                  GraphId, ContextId);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  // The worker holds the graph lock, so the graphs and contexts are not
+  // moved by the loads and the initializations until the compute finishes.
+  auto &Environ = Env;
+  if (!Env.Workers.submit(Env.NNContext[ContextId].getBackend(), ContextId,
+                          [&Environ, ContextId]() {
+                            std::shared_lock Lock(Environ.GraphMutex);
+                            return runCompute(Environ, ContextId);
+                          })) {
+    isComputing(Env, ContextId);
+    return WASINN::ErrNo::Busy;
+  }
+  return WASINN::ErrNo::Success;
+}
+
+Expect<WASINN::ErrNo>
+WasiNNComputePoll::bodyImpl(const Runtime::CallingFrame &Frame,
+                            uint32_t ContextId, uint64_t TimeoutNs,
+                            uint32_t DonePtr) {
+  Env.setEnviron(&Frame);
+#ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  if (Env.NNRPCChannel != nullptr) {
+    spdlog::error("[WASI-NN] compute_poll: Not supported in RPC mode."sv);
+    return WASINN::ErrNo::UnsupportedOperation;
+  }
+#endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  auto *Done = MemInst->getPointer<uint32_t *>(DonePtr);
+  if (unlikely(Done == nullptr)) {
+    spdlog::error("[WASI-NN] Failed when accessing the Done memory."sv);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  // Cap the timeout to keep the deadline of the wait from overflowing. The
+  // guest polls again if the compute takes longer.
+  const auto Timeout = std::chrono::nanoseconds(std::min<uint64_t>(
+      TimeoutNs, std::chrono::nanoseconds(std::chrono::hours(1)).count()));
+  auto Result = Env.Workers.poll(ContextId, Timeout);
+  if (!Result.has_value()) {
+    *Done = 0;
+    return WASINN::ErrNo::Success;
+  }
+  *Done = 1;
+  return *Result;
+}
+
+Expect<WASINN::ErrNo>
+WasiNNComputeStream::bodyImpl(const Runtime::CallingFrame &Frame,
+                              uint32_t ContextId, uint32_t RingPtr,
+                              uint32_t RingSize, uint32_t HeaderPtr) {
+  Env.setEnviron(&Frame);
+#ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  if (Env.NNRPCChannel != nullptr) {
+    spdlog::error("[WASI-NN] compute_stream: Not supported in RPC mode."sv);
+    return WASINN::ErrNo::UnsupportedOperation;
+  }
+#endif // ifdef WASMEDGE_BUILD_WASI_NN_RPC
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  const auto Ring = MemInst->getSpan<uint8_t>(RingPtr, RingSize);
+  if (unlikely(RingSize == 0 || Ring.size() != RingSize)) {
+    spdlog::error("[WASI-NN] Failed when accessing the Ring Buffer memory."sv);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+  auto *Header = MemInst->getPointer<WASINN::StreamHeader *>(HeaderPtr);
+  if (unlikely(Header == nullptr ||
+               HeaderPtr % alignof(WASINN::StreamHeader) != 0)) {
+    spdlog::error(
+        "[WASI-NN] Failed when accessing the Stream Header memory."sv);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  if (Env.NNContext.size() <= ContextId ||
+      !Env.NNContext[ContextId].isReady()) {
+    spdlog::error("[WASI-NN] compute_stream: Context ID {} does not exist."sv,
+                  ContextId);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
+
+  auto GraphId = Env.NNContext[ContextId].getGraphId();
+  assuming(Env.NNGraph.size() > GraphId);
+  if (!Env.NNGraph[GraphId].isReady()) {
+    spdlog::error("[WASI-NN] compute_stream: Graph ID {} for context ID {} "sv
+                  "does not exist or has released."sv,
+                  GraphId, ContextId);
+    return WASINN::ErrNo::InvalidArgument;
+  }
+
+  switch (Env.NNContext[ContextId].getBackend()) {
+  case WASINN::Backend::GGML:
+    return WASINN::GGML::computeStream(Env, ContextId, Ring, *Header);
+  default:
+    spdlog::error(
+        "[WASI-NN] compute_stream: Only GGML backend supports "sv
+        "compute_stream."sv);
     return WASINN::ErrNo::InvalidArgument;
   }
 }
@@ -635,8 +892,14 @@ WasiNNFiniSingle::bodyImpl(const Runtime::CallingFrame &Frame,
   Env.setEnviron(&Frame);
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
   if (Env.NNRPCChannel != nullptr) {
+    auto *RPCCtx = Env.findRPCContext(ContextId);
+    if (RPCCtx == nullptr) {
+      reportUnknownRPCContext(ContextId);
+      return WASINN::ErrNo::InvalidArgument;
+    }
+    cancelStream(*RPCCtx);
     auto Stub = wasi_ephemeral_nn::GraphExecutionContextResource::NewStub(
-        Env.NNRPCChannel);
+        Env.getRPCChannel(ContextId));
     grpc::ClientContext ClientContext;
     wasi_ephemeral_nn::FiniSingleRequest Req;
     Req.set_resource_handle(ContextId);
@@ -660,15 +923,20 @@ WasiNNFiniSingle::bodyImpl(const Runtime::CallingFrame &Frame,
                   ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   switch (Env.NNContext[ContextId].getBackend()) {
   case WASINN::Backend::GGML:
     return WASINN::GGML::finiSingle(Env, ContextId);
   case WASINN::Backend::BitNet:
     return WASINN::BitNet::finiSingle(Env, ContextId);
+  case WASINN::Backend::Piper:
+    return WASINN::Piper::finiSingle(Env, ContextId);
   default:
     spdlog::error(
-        "[WASI-NN] fini_single: Only GGML and BitNet backend supports fini_single."sv);
+        "[WASI-NN] fini_single: Only GGML, BitNet and Piper backends support fini_single."sv);
     return WASINN::ErrNo::InvalidArgument;
   }
 }
@@ -692,6 +960,13 @@ Expect<WASINN::ErrNo> WasiNNUnload::bodyImpl(const Runtime::CallingFrame &Frame,
     spdlog::error("[WASI-NN] unload: GraphId {} does not exist."sv, GraphId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  for (uint32_t ContextId = 0; ContextId < Env.NNContext.size(); ++ContextId) {
+    if (Env.NNContext[ContextId].isReady() &&
+        Env.NNContext[ContextId].getGraphId() == GraphId &&
+        isComputing(Env, ContextId)) {
+      return WASINN::ErrNo::Busy;
+    }
+  }
 
   switch (Env.NNGraph[GraphId].getBackend()) {
   case WASINN::Backend::GGML:
@@ -732,6 +1007,9 @@ WasiNNFinalizeExecCtx::bodyImpl(const Runtime::CallingFrame &Frame,
         ContextId);
     return WASINN::ErrNo::InvalidArgument;
   }
+  if (isComputing(Env, ContextId)) {
+    return WASINN::ErrNo::Busy;
+  }
 
   switch (Env.NNContext[ContextId].getBackend()) {
   case WASINN::Backend::GGML:
@@ -150,6 +150,48 @@ private:
                                  uint32_t Context);
 };
 
+class WasiNNComputeAsync : public WasiNN<WasiNNComputeAsync> {
+public:
+  WasiNNComputeAsync(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Context) {
+    return bodyImpl(Frame, Context).map(castErrNo);
+  }
+
+private:
+  Expect<WASINN::ErrNo> bodyImpl(const Runtime::CallingFrame &Frame,
+                                 uint32_t Context);
+};
+
+class WasiNNComputePoll : public WasiNN<WasiNNComputePoll> {
+public:
+  WasiNNComputePoll(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Context,
+                        uint64_t TimeoutNs, uint32_t DonePtr) {
+    return bodyImpl(Frame, Context, TimeoutNs, DonePtr).map(castErrNo);
+  }
+
+private:
+  Expect<WASINN::ErrNo> bodyImpl(const Runtime::CallingFrame &Frame,
+                                 uint32_t Context, uint64_t TimeoutNs,
+                                 uint32_t DonePtr);
+};
+
+class WasiNNComputeStream : public WasiNN<WasiNNComputeStream> {
+public:
+  WasiNNComputeStream(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Context,
+                        uint32_t RingPtr, uint32_t RingSize,
+                        uint32_t HeaderPtr) {
+    return bodyImpl(Frame, Context, RingPtr, RingSize, HeaderPtr)
+        .map(castErrNo);
+  }
+
+private:
+  Expect<WASINN::ErrNo> bodyImpl(const Runtime::CallingFrame &Frame,
+                                 uint32_t Context, uint32_t RingPtr,
+                                 uint32_t RingSize, uint32_t HeaderPtr);
+};
+
 class WasiNNFiniSingle : public WasiNN<WasiNNFiniSingle> {
 public:
   WasiNNFiniSingle(WASINN::WasiNNEnvironment &HostEnv) : WasiNN(HostEnv) {}
@@ -20,6 +20,9 @@ WasiNNModule::WasiNNModule() : ModuleInstance("wasi_ephemeral_nn") {
               std::make_unique<WasiNNGetOutputSingle>(Env));
   addHostFunc("compute", std::make_unique<WasiNNCompute>(Env));
   addHostFunc("compute_single", std::make_unique<WasiNNComputeSingle>(Env));
+  addHostFunc("compute_async", std::make_unique<WasiNNComputeAsync>(Env));
+  addHostFunc("compute_poll", std::make_unique<WasiNNComputePoll>(Env));
+  addHostFunc("compute_stream", std::make_unique<WasiNNComputeStream>(Env));
   addHostFunc("fini_single", std::make_unique<WasiNNFiniSingle>(Env));
   addHostFunc("unload", std::make_unique<WasiNNUnload>(Env));
   addHostFunc("finalize_execution_context",
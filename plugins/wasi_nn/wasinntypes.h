@@ -6,7 +6,12 @@
 #include "common/span.h"
 #include "common/spdlog.h"
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace WasmEdge::Host::WASINN {
 
@@ -75,6 +80,47 @@ struct TensorData {
   Span<uint8_t> Tensor;
 };
 
+// Header of the ring buffer in the guest memory for compute_stream. The
+// counters are the total bytes written by the host and read by the guest.
+struct StreamHeader {
+  std::atomic<uint32_t> Written;
+  std::atomic<uint32_t> Read;
+  // Set to 1 when the generation ended and all the bytes are written.
+  std::atomic<uint32_t> Done;
+};
+static_assert(sizeof(StreamHeader) == 12);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Process-wide registry of the objects shared by the graphs of all the VMs,
+// such as the model weights. An object lives as long as any user holds it.
+template <typename T> class SharedRegistry {
+public:
+  // Get the object of the key, or create it if no one holds it. Returns
+  // nullptr if the creation failed.
+  template <typename FuncT>
+  std::shared_ptr<T> get(const std::string &Key, FuncT &&Create) noexcept {
+    std::unique_lock Lock(Mutex);
+    if (auto It = Objects.find(Key); It != Objects.end()) {
+      if (auto Object = It->second.lock()) {
+        return Object;
+      }
+    }
+    std::shared_ptr<T> Object = Create();
+    if (Object != nullptr) {
+      // Drop the released objects.
+      for (auto It = Objects.begin(); It != Objects.end();) {
+        It = It->second.expired() ? Objects.erase(It) : std::next(It);
+      }
+      Objects[Key] = Object;
+    }
+    return Object;
+  }
+
+private:
+  std::mutex Mutex;
+  std::unordered_map<std::string, std::weak_ptr<T>> Objects;
+};
+
 } // namespace WasmEdge::Host::WASINN
 
 template <>
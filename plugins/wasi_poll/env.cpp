@@ -4,13 +4,120 @@
 #include "env.h"
 #include "module.h"
 
+#include "common/errcode.h"
+
+#include <new>
+#include <utility>
+
 namespace WasmEdge {
 namespace Host {
 
+Pollable WasiPollEnvironment::addPollable() {
+  PollableMap.emplace(NextPollable, Entry{});
+  return NextPollable++;
+}
+
+Pollable WasiPollEnvironment::addPollable(std::shared_ptr<WASI::VINode> Node,
+                                          __wasi_eventtype_t Type) {
+  PollableMap.emplace(NextPollable, Entry{std::move(Node), Type});
+  return NextPollable++;
+}
+
 bool WasiPollEnvironment::isPollable(Pollable P) noexcept {
-  return PollableMap.at(P);
+  return PollableMap.count(P) != 0;
 }
-void WasiPollEnvironment::dropPollable(Pollable P) { PollableMap.erase(P); }
+
+void WasiPollEnvironment::dropPollable(Pollable P) {
+  if (auto It = PollableMap.find(P); It != PollableMap.end()) {
+    if (It->second.Node) {
+      // Unregister the node from the poller, which keeps it across the polls.
+      Poller.close(It->second.Node);
+    }
+    PollableMap.erase(It);
+  }
+}
+
+WASI::WasiExpect<void>
+WasiPollEnvironment::poll(Span<const Pollable> In,
+                          std::vector<bool> &Res) noexcept {
+  const size_t Count = In.size();
+  try {
+    Res.assign(Count, false);
+    Subscribers.resize(Count);
+    // The poller accepts one subscription per event of a node, so the
+    // pollables of the same event share it.
+    std::unordered_map<const WASI::VINode *, std::pair<size_t, size_t>>
+        Subscribed;
+    size_t NSubscriptions = 0;
+    bool AnyReady = false;
+    for (size_t I = 0; I < Count; ++I) {
+      auto It = PollableMap.find(In[I]);
+      if (unlikely(It == PollableMap.end())) {
+        return WASI::WasiUnexpect(__WASI_ERRNO_BADF);
+      }
+      const auto &E = It->second;
+      if (!E.Node) {
+        Res[I] = true;
+        AnyReady = true;
+        Subscribers[I] = SIZE_MAX;
+        continue;
+      }
+      auto &[Read, Write] =
+          Subscribed.try_emplace(E.Node.get(), SIZE_MAX, SIZE_MAX)
+              .first->second;
+      auto &First = E.Type == __WASI_EVENTTYPE_FD_WRITE ? Write : Read;
+      if (First == SIZE_MAX) {
+        First = I;
+        ++NSubscriptions;
+      }
+      Subscribers[I] = First;
+    }
+    if (NSubscriptions == 0) {
+      return {};
+    }
+    if (AnyReady) {
+      ++NSubscriptions;
+    }
+
+    Events.resize(NSubscriptions);
+    EXPECTED_TRY(Poller.prepare(Events));
+    for (size_t I = 0; I < Count; ++I) {
+      if (Subscribers[I] != I) {
+        continue;
+      }
+      const auto &E = PollableMap.find(In[I])->second;
+      if (E.Type == __WASI_EVENTTYPE_FD_WRITE) {
+        Poller.write(E.Node, WASI::TriggerType::Level, I);
+      } else {
+        Poller.read(E.Node, WASI::TriggerType::Level, I);
+      }
+    }
+    if (AnyReady) {
+      // Only collect the ready events without blocking.
+      Poller.clock(__WASI_CLOCKID_MONOTONIC, 1, 0,
+                   static_cast<__wasi_subclockflags_t>(0), Count);
+    }
+    Poller.wait();
+    const __wasi_size_t NEvents = Poller.result();
+    Poller.reset();
+
+    std::vector<bool> Woken(Count, false);
+    for (__wasi_size_t I = 0; I < NEvents; ++I) {
+      if (const auto Index = Events[I].userdata; Index < Count) {
+        Woken[Index] = true;
+      }
+    }
+    for (size_t I = 0; I < Count; ++I) {
+      if (Subscribers[I] != SIZE_MAX && Woken[Subscribers[I]]) {
+        Res[I] = true;
+      }
+    }
+    return {};
+  } catch (std::bad_alloc &) {
+    return WASI::WasiUnexpect(__WASI_ERRNO_NOMEM);
+  }
+}
+
 namespace {
 
 Runtime::Instance::ComponentInstance *
@@ -2,9 +2,12 @@
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 #pragma once
 
+#include "host/wasi/vinode.h"
 #include "plugin/plugin.h"
 
 #include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace WasmEdge {
@@ -12,13 +15,50 @@ namespace Host {
 
 using Pollable = uint32_t;
 
-class WasiPollEnvironment {
+/// The pollables of the component instance.
+///
+/// A pollable waits for the read or write readiness of a node, or is ready at
+/// once if it has no node. The nodes stay registered in the poller across the
+/// polls, so a poll only costs the kernel the ready nodes and the changed
+/// subscriptions instead of all the registered ones.
+class WasiPollEnvironment : public WASI::PollerContext {
 public:
+  WasiPollEnvironment() noexcept : Poller(*this) {}
+
+  /// Add a pollable which is ready at once.
+  Pollable addPollable();
+
+  /// Add a pollable of the readiness of the node.
+  ///
+  /// @param[in] Node The node to wait for.
+  /// @param[in] Type `__WASI_EVENTTYPE_FD_READ` or `__WASI_EVENTTYPE_FD_WRITE`.
+  Pollable addPollable(std::shared_ptr<WASI::VINode> Node,
+                       __wasi_eventtype_t Type);
+
   bool isPollable(Pollable P) noexcept;
   void dropPollable(Pollable P);
 
+  /// Wait until any of the pollables is ready.
+  ///
+  /// @param[in] In The pollables to wait for.
+  /// @param[out] Res Whether each of the pollables is ready.
+  /// @return Nothing, or WASI error if a pollable is unknown or the polling
+  /// failed.
+  WASI::WasiExpect<void> poll(Span<const Pollable> In,
+                              std::vector<bool> &Res) noexcept;
+
 private:
-  std::unordered_map<Pollable, bool> PollableMap;
+  struct Entry {
+    std::shared_ptr<WASI::VINode> Node;
+    __wasi_eventtype_t Type = __WASI_EVENTTYPE_FD_READ;
+  };
+
+  std::unordered_map<Pollable, Entry> PollableMap;
+  Pollable NextPollable = 0;
+  WASI::VPoller Poller;
+  std::vector<__wasi_event_t> Events;
+  /// Index of the pollable subscribing the event for each polled pollable.
+  std::vector<size_t> Subscribers;
 };
 
 } // namespace Host
@@ -4,6 +4,9 @@
 #include "func.h"
 #include "common/defines.h"
 #include "common/errcode.h"
+#include "common/spdlog.h"
+
+using namespace std::literals;
 
 namespace WasmEdge {
 namespace Host {
@@ -15,8 +18,10 @@ Expect<void> Drop::body(Pollable P) {
 
 Expect<List<bool>> PollOneoff::body(List<Pollable> In) {
   std::vector<bool> Res;
-  for (auto P : In.collection()) {
-    Res.push_back(Env.isPollable(P));
+  if (auto Polled = Env.poll(In.collection(), Res); unlikely(!Polled)) {
+    spdlog::error("[WASI-Poll] Failed to poll the pollables: {}"sv,
+                  Polled.error());
+    return Unexpect(ErrCode::Value::HostFuncError);
   }
   return List<bool>(std::move(Res));
 }
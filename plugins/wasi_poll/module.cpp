@@ -11,6 +11,7 @@ namespace Host {
 
 WasiPollModule::WasiPollModule() : ComponentInstance("wasi:poll/poll") {
   addHostFunc("drop-pollable", std::make_unique<Drop>(Env));
+  addHostFunc("poll-oneoff", std::make_unique<PollOneoff>(Env));
 }
 
 } // namespace Host
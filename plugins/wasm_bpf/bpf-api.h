@@ -7,6 +7,8 @@
 #include "runtime/instance/module.h"
 #include "wasmedge/wasmedge.h"
 
+#include <vector>
+
 #pragma GCC diagnostic push
 #ifdef __clang__
 // Allow compilation using clang
@@ -24,6 +26,9 @@ extern "C" {
 #define PERF_BUFFER_PAGES 64
 #define DEBUG_LIBBPF_RUNTIME 0
 #define DEBUG_PRINT_BUFFER_SIZE 1024
+/// Size of the header {u32 size; u32 reserved} before every sample packed by
+/// the batch polling. The records are padded to 8 bytes.
+#define BATCH_RECORD_HEADER_SIZE 8
 
 namespace WasmEdge {
 namespace Host {
@@ -45,14 +50,24 @@ protected:
   void *poll_data;
   size_t max_poll_size;
   uint32_t wasm_buf_ptr;
+  /// the sample function resolved by is_valid
+  const WasmEdge_FunctionInstanceContext *wasm_sample_func_ref = nullptr;
+  /// pack the samples into poll_data instead of calling the wasm handler
+  bool batch_mode = false;
+  size_t batch_used = 0;
+  /// packed samples not fitting in poll_data, served by the next batch poll
+  std::vector<char> batch_pending;
+
+  /// sample callback which packs the sample into the data buffer
+  int32_t bpf_buffer_batch_sample(void *data, size_t size);
 
 public:
   /// sample callback which calls the wasm handler indirectly
   int32_t bpf_buffer_sample(void *data, size_t size);
-  /// Check if the bpf buffer is valid
+  /// Check if the bpf buffer is valid, and resolve the sample function
   ///
   /// a valid module instance should have only one table and a sample function
-  bool is_valid() const;
+  bool is_valid();
   /// set the wasm callback parameters
   void
   set_callback_params(WasmEdge_ExecutorContext *executor,
@@ -61,6 +76,9 @@ public:
                       uint32_t ctx, uint32_t buf_ptr);
   /// polling the bpf buffer
   virtual int32_t bpf_buffer__poll(int32_t timeout_ms) = 0;
+  /// polling the bpf buffer, and packing the samples into the data buffer
+  int32_t bpf_buffer_poll_batch(void *data, size_t max_size,
+                                int32_t timeout_ms);
   /// open the bpf buffer map
   virtual int32_t bpf_buffer__open(int32_t fd, bpf_buffer_sample_fn sample_cb,
                                    void *ctx) = 0;
@@ -75,6 +93,9 @@ class wasm_bpf_program {
   std::unordered_set<std::unique_ptr<bpf_link, int32_t (*)(bpf_link *obj)>>
       links;
 
+  /// Create and open the bpf buffer of the map if not created yet
+  int32_t open_bpf_buffer(int32_t fd);
+
 public:
   /// Find a bpf map fd by name
   int32_t bpf_map_fd_by_name(const char *name);
@@ -88,6 +109,10 @@ public:
                           int32_t fd, int32_t sample_func, uint32_t ctx,
                           void *buffer_data, size_t max_size,
                           int32_t timeout_ms, uint32_t wasm_buf_ptr);
+  /// Poll the bpf buffer and pack all the samples into the data buffer,
+  /// without calling back into wasm for every sample
+  int32_t bpf_buffer_poll_batch(int32_t fd, void *buffer_data,
+                                size_t max_size, int32_t timeout_ms);
   /// Get the bpf map pointer by fd
   bpf_map *map_ptr_by_fd(int32_t fd);
 };
@@ -3,6 +3,8 @@
 
 #include "func-bpf-buffer-poll.h"
 #include "wasmedge/wasmedge.h"
+#include <algorithm>
+#include <climits>
 #include <shared_mutex>
 
 namespace WasmEdge {
@@ -46,5 +48,28 @@ Expect<int32_t> BpfBufferPoll::body(const Runtime::CallingFrame &Frame,
                                               max_size, timeout_ms, data);
 }
 
+Expect<int32_t> BpfBufferPollBatch::body(const Runtime::CallingFrame &Frame,
+                                         handle_t program, int32_t fd,
+                                         uint32_t data, uint32_t max_size,
+                                         int32_t timeout_ms) {
+  auto *memory = Frame.getMemoryByIndex(0);
+  if (unlikely(!memory)) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  // The returned size must fit in the result.
+  max_size = std::min<uint32_t>(max_size, INT32_MAX);
+  std::shared_lock lock(state->lock);
+  auto program_ptr = state->handles.find(program);
+  if (program_ptr == state->handles.end()) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  auto data_buf = memory->getSpan<char>(data, max_size);
+  if (data_buf.size() != max_size) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  return program_ptr->second->bpf_buffer_poll_batch(fd, data_buf.data(),
+                                                    max_size, timeout_ms);
+}
+
 } // namespace Host
 } // namespace WasmEdge
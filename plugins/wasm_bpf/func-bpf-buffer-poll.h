@@ -37,5 +37,30 @@ private:
   state_t state;
 };
 
+/// Perform a bpf buffer poll, and pack all the polled samples into the data
+/// buffer instead of calling back for every sample. Every sample is a record
+/// of the header {u32 size; u32 reserved} and the data padded to 8 bytes. The
+/// samples not fitting in the data buffer are kept for the next poll, so no
+/// sample is dropped by the host.
+///
+/// \param fd the map fd for bpf buffer.
+/// \param data data buffer that will be used to store the records.
+/// \param max_size How many bytes can be put at data, at least 16.
+/// \param timeout_ms how many milliseconds can be waited.
+///
+/// \return On success, return the bytes of the records. On error, return
+/// error code.
+class BpfBufferPollBatch
+    : public WasmEdge::Runtime::HostFunction<BpfBufferPollBatch> {
+public:
+  BpfBufferPollBatch(state_t state) : state(state) {}
+  WasmEdge::Expect<int32_t> body(const WasmEdge::Runtime::CallingFrame &Frame,
+                                 handle_t program, int32_t fd, uint32_t data,
+                                 uint32_t max_size, int32_t timeout_ms);
+
+private:
+  state_t state;
+};
+
 } // namespace Host
 } // namespace WasmEdge
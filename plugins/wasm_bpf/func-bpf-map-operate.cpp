@@ -4,6 +4,8 @@
 #include "func-bpf-map-operate.h"
 #include "bpf-api.h"
 
+#include <algorithm>
+
 extern "C" {
 #include <bpf/libbpf.h>
 }
@@ -68,5 +70,76 @@ BpfMapOperate::body(const WasmEdge::Runtime::CallingFrame &Frame, int32_t fd,
   }
 }
 
+Expect<int32_t> BpfMapOperateBatch::body(
+    const WasmEdge::Runtime::CallingFrame &Frame, int32_t fd, int32_t cmd,
+    uint32_t in_batch, uint32_t out_batch, uint32_t keys, uint32_t values,
+    uint32_t count, uint64_t elem_flags, uint64_t flags) {
+
+  auto *memory = Frame.getMemoryByIndex(0);
+  if (unlikely(!memory)) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  auto *count_ptr = memory->getPointer<uint32_t *>(count);
+  if (unlikely(!count_ptr)) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  std::shared_lock guard(this->state->lock);
+  bpf_map_info map_info;
+  memset(&map_info, 0, sizeof(map_info));
+  uint32_t info_len = sizeof(map_info);
+  int32_t err;
+  if ((err = bpf_map_get_info_by_fd(fd, &map_info, &info_len)) != 0) {
+    spdlog::debug("[WasmEdge Wasm_bpf] Invalid map fd found: fd={},err={}"sv,
+                  fd, err);
+    // Invalid map fd
+    return err;
+  }
+  // The batch position of the hash maps is the u32 bucket index.
+  auto batch_size = std::max<uint32_t>(map_info.key_size, sizeof(uint32_t));
+  auto keys_size = static_cast<uint64_t>(*count_ptr) * map_info.key_size;
+  auto values_size = static_cast<uint64_t>(*count_ptr) * map_info.value_size;
+  if (keys_size > UINT32_MAX || values_size > UINT32_MAX) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  bpf_map_batch_opts opts;
+  memset(&opts, 0, sizeof(opts));
+  opts.sz = sizeof(opts);
+  opts.elem_flags = elem_flags;
+  opts.flags = flags;
+
+  switch ((bpf_cmd)cmd) {
+  case BPF_MAP_LOOKUP_BATCH:
+  case BPF_MAP_LOOKUP_AND_DELETE_BATCH: {
+    char *in_batch_ptr = nullptr;
+    if (in_batch != 0) {
+      ensure_memory_size(in_ptr, in_batch, batch_size);
+      in_batch_ptr = in_ptr;
+    }
+    ensure_memory_size(out_batch_ptr, out_batch, batch_size);
+    ensure_memory_size(keys_ptr, keys, keys_size);
+    ensure_memory_size(values_ptr, values, values_size);
+    if ((bpf_cmd)cmd == BPF_MAP_LOOKUP_BATCH) {
+      return bpf_map_lookup_batch(fd, in_batch_ptr, out_batch_ptr, keys_ptr,
+                                  values_ptr, count_ptr, &opts);
+    }
+    return bpf_map_lookup_and_delete_batch(fd, in_batch_ptr, out_batch_ptr,
+                                           keys_ptr, values_ptr, count_ptr,
+                                           &opts);
+  }
+  case BPF_MAP_UPDATE_BATCH: {
+    ensure_memory_size(keys_ptr, keys, keys_size);
+    ensure_memory_size(values_ptr, values, values_size);
+    return bpf_map_update_batch(fd, keys_ptr, values_ptr, count_ptr, &opts);
+  }
+  case BPF_MAP_DELETE_BATCH: {
+    ensure_memory_size(keys_ptr, keys, keys_size);
+    return bpf_map_delete_batch(fd, keys_ptr, count_ptr, &opts);
+  }
+  default:
+    spdlog::debug("[WasmEdge Wasm_bpf] Invalid map batch operation {}"sv, cmd);
+    return -EINVAL;
+  }
+}
+
 } // namespace Host
 } // namespace WasmEdge
@@ -26,5 +26,34 @@ private:
   state_t state;
 };
 
+/// Perform the batch operations on a specified bpf map through map fd. The
+/// cmd is one of BPF_MAP_LOOKUP_BATCH, BPF_MAP_LOOKUP_AND_DELETE_BATCH,
+/// BPF_MAP_UPDATE_BATCH and BPF_MAP_DELETE_BATCH.
+///
+/// \param in_batch the position to start the lookup at, of the key size. 0 to
+/// start at the beginning.
+/// \param out_batch the position to continue the next lookup at, of the key
+/// size. Only used by the lookups.
+/// \param keys the array of the keys.
+/// \param values the array of the values. Not used by the deletion.
+/// \param count the u32 of the capacity of the arrays in elements, set to the
+/// processed elements.
+///
+/// Return zero if succeed, -ENOENT if the lookup reaches the end, others if
+/// error
+class BpfMapOperateBatch
+    : public WasmEdge::Runtime::HostFunction<BpfMapOperateBatch> {
+public:
+  BpfMapOperateBatch(state_t state) : state(state) {}
+  WasmEdge::Expect<int32_t> body(const WasmEdge::Runtime::CallingFrame &Frame,
+                                 int32_t fd, int32_t cmd, uint32_t in_batch,
+                                 uint32_t out_batch, uint32_t keys,
+                                 uint32_t values, uint32_t count,
+                                 uint64_t elem_flags, uint64_t flags);
+
+private:
+  state_t state;
+};
+
 } // namespace Host
 } // namespace WasmEdge
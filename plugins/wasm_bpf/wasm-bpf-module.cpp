@@ -29,6 +29,10 @@ WasmBpfModule::WasmBpfModule() : ModuleInstance("wasm_bpf") {
   addHostFunc("wasm_bpf_map_fd_by_name",
               std::make_unique<BpfMapFdByName>(state));
   addHostFunc("wasm_bpf_map_operate", std::make_unique<BpfMapOperate>(state));
+  addHostFunc("wasm_bpf_buffer_poll_batch",
+              std::make_unique<BpfBufferPollBatch>(state));
+  addHostFunc("wasm_bpf_map_operate_batch",
+              std::make_unique<BpfMapOperateBatch>(state));
 }
 
 Runtime::Instance::ModuleInstance *
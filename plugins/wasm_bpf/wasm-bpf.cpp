@@ -1,7 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 // SPDX-FileCopyrightText: 2019-2024 Second State INC
 
+#include <algorithm>
 #include <asm/unistd.h>
+#include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <string>
@@ -103,7 +105,8 @@ void bpf_buffer::set_callback_params(
   wasm_buf_ptr = buf_ptr;
 }
 
-bool bpf_buffer::is_valid() const {
+bool bpf_buffer::is_valid() {
+  wasm_sample_func_ref = nullptr;
   auto module_inst = wasm_module_instance;
   WasmEdge_String names;
   uint32_t exported_table_len =
@@ -118,29 +121,26 @@ bool bpf_buffer::is_valid() const {
   WasmEdge_Value value;
   auto get_data_result =
       WasmEdge_TableInstanceGetData(table_inst, &value, wasm_sample_function);
-  return WasmEdge_ResultOK(get_data_result);
+  if (!WasmEdge_ResultOK(get_data_result) ||
+      value.Type != WasmEdge_ValType::WasmEdge_ValType_FuncRef) {
+    return false;
+  }
+  // Resolve the function once per poll instead of once per sample.
+  wasm_sample_func_ref = WasmEdge_ValueGetFuncRef(value);
+  return wasm_sample_func_ref != nullptr;
 }
 
 int32_t bpf_buffer::bpf_buffer_sample(void *data, size_t size) {
+  if (batch_mode) {
+    return bpf_buffer_batch_sample(data, size);
+  }
   size_t sample_size = size;
   if (max_poll_size < size) {
     sample_size = max_poll_size;
   }
   memcpy(poll_data, data, sample_size);
-  auto module_inst = wasm_module_instance;
-  WasmEdge_String names[1];
-  /// a valid module instance should have only one table
-  uint32_t exported_table_len =
-      WasmEdge_ModuleInstanceListTable(module_inst, names, std::size(names));
-  assuming(exported_table_len == 1);
-  auto table_inst = WasmEdge_ModuleInstanceFindTable(module_inst, names[0]);
-  assuming(table_inst);
-  WasmEdge_Value value;
-  auto get_data_result =
-      WasmEdge_TableInstanceGetData(table_inst, &value, wasm_sample_function);
-  assuming(WasmEdge_ResultOK(get_data_result));
-  assert(value.Type == WasmEdge_ValType::WasmEdge_ValType_FuncRef);
-  auto func_ref = WasmEdge_ValueGetFuncRef(value);
+  auto func_ref = wasm_sample_func_ref;
+  assuming(func_ref);
 
   WasmEdge_Value invoke_func_params[3] = {
       WasmEdge_ValueGenI32(wasm_ctx),
@@ -156,6 +156,88 @@ int32_t bpf_buffer::bpf_buffer_sample(void *data, size_t size) {
   return WasmEdge_ValueGetI32(invoke_func_result);
 }
 
+/// Size of the packed record of a sample with the given size.
+static size_t batch_record_size(size_t size) {
+  return BATCH_RECORD_HEADER_SIZE + ((size + 7) & ~static_cast<size_t>(7));
+}
+
+/// Write the packed record of a sample, which is truncated to the size.
+static void write_batch_record(char *dest, const void *data, uint32_t size) {
+  const uint32_t header[2] = {size, 0};
+  memcpy(dest, header, sizeof(header));
+  memcpy(dest + BATCH_RECORD_HEADER_SIZE, data, size);
+  const size_t padded = batch_record_size(size) - BATCH_RECORD_HEADER_SIZE;
+  memset(dest + BATCH_RECORD_HEADER_SIZE + size, 0, padded - size);
+}
+
+int32_t bpf_buffer::bpf_buffer_batch_sample(void *data, size_t size) {
+  // Truncate the samples which never fit, like the callback mode does.
+  size = std::min(size, (max_poll_size - BATCH_RECORD_HEADER_SIZE) &
+                            ~static_cast<size_t>(7));
+  const size_t record_size = batch_record_size(size);
+  char *dest;
+  if (batch_pending.empty() && batch_used + record_size <= max_poll_size) {
+    dest = static_cast<char *>(poll_data) + batch_used;
+    batch_used += record_size;
+  } else {
+    // Keep the order of the samples after the data buffer is full.
+    const size_t offset = batch_pending.size();
+    batch_pending.resize(offset + record_size);
+    dest = batch_pending.data() + offset;
+  }
+  write_batch_record(dest, data, static_cast<uint32_t>(size));
+  return 0;
+}
+
+int32_t bpf_buffer::bpf_buffer_poll_batch(void *data, size_t max_size,
+                                          int32_t timeout_ms) {
+  if (max_size < 2 * BATCH_RECORD_HEADER_SIZE) {
+    return -EINVAL;
+  }
+  poll_data = data;
+  max_poll_size = max_size;
+  batch_used = 0;
+
+  // Serve the samples left by the last poll first.
+  size_t offset = 0;
+  while (offset < batch_pending.size()) {
+    uint32_t size;
+    memcpy(&size, batch_pending.data() + offset, sizeof(size));
+    const size_t record_size = batch_record_size(size);
+    if (batch_used + record_size > max_size) {
+      if (batch_used > 0) {
+        break;
+      }
+      // The data buffer shrinks since the last poll.
+      const auto truncated = static_cast<uint32_t>(
+          (max_size - BATCH_RECORD_HEADER_SIZE) & ~static_cast<size_t>(7));
+      write_batch_record(static_cast<char *>(poll_data),
+                         batch_pending.data() + offset +
+                             BATCH_RECORD_HEADER_SIZE,
+                         truncated);
+      batch_used = batch_record_size(truncated);
+    } else {
+      memcpy(static_cast<char *>(poll_data) + batch_used,
+             batch_pending.data() + offset, record_size);
+      batch_used += record_size;
+    }
+    offset += record_size;
+  }
+  batch_pending.erase(batch_pending.begin(),
+                      batch_pending.begin() + static_cast<ptrdiff_t>(offset));
+
+  if (batch_pending.empty()) {
+    // Don't wait if there is already something to return.
+    batch_mode = true;
+    int32_t res = bpf_buffer__poll(batch_used > 0 ? 0 : timeout_ms);
+    batch_mode = false;
+    if (res < 0 && batch_used == 0) {
+      return res;
+    }
+  }
+  return static_cast<int32_t>(batch_used);
+}
+
 /// \brief create a bpf buffer based on the object map type
 std::unique_ptr<bpf_buffer> bpf_buffer__new(bpf_map *events) {
   bpf_map_type map_type = bpf_map__type(events);
@@ -233,18 +315,8 @@ int32_t wasm_bpf_program::bpf_buffer_poll(
     const WasmEdge_ModuleInstanceContext *module_instance, int32_t fd,
     int32_t sample_func, uint32_t ctx, void *data, size_t max_size,
     int32_t timeout_ms, uint32_t wasm_buf_ptr) {
-  int32_t res;
-  if (!buffer.get()) {
-    // create buffer
-    auto map = map_ptr_by_fd(fd);
-    buffer = bpf_buffer__new(map);
-    if (!buffer) {
-      return -1;
-    }
-    res = buffer->bpf_buffer__open(fd, bpf_buffer_sample, buffer.get());
-    if (res < 0) {
-      return res;
-    }
+  if (int32_t res = open_bpf_buffer(fd); res < 0) {
+    return res;
   }
   buffer->set_callback_params(executor, module_instance,
                               static_cast<uint32_t>(sample_func), data,
@@ -256,5 +328,37 @@ int32_t wasm_bpf_program::bpf_buffer_poll(
   return buffer->bpf_buffer__poll(timeout_ms);
 }
 
+/// polling the buffer in the batch mode, if the buffer is not created, create
+/// it.
+int32_t wasm_bpf_program::bpf_buffer_poll_batch(int32_t fd, void *data,
+                                                size_t max_size,
+                                                int32_t timeout_ms) {
+  if (int32_t res = open_bpf_buffer(fd); res < 0) {
+    return res;
+  }
+  return buffer->bpf_buffer_poll_batch(data, max_size, timeout_ms);
+}
+
+int32_t wasm_bpf_program::open_bpf_buffer(int32_t fd) {
+  if (buffer.get()) {
+    return 0;
+  }
+  // create buffer
+  auto map = map_ptr_by_fd(fd);
+  if (!map) {
+    return -EINVAL;
+  }
+  buffer = bpf_buffer__new(map);
+  if (!buffer) {
+    return -1;
+  }
+  int32_t res = buffer->bpf_buffer__open(fd, bpf_buffer_sample, buffer.get());
+  if (res < 0) {
+    buffer.reset();
+    return res;
+  }
+  return 0;
+}
+
 } // namespace Host
 } // namespace WasmEdge
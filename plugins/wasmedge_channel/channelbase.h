@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "channelenv.h"
+
+#include "common/errcode.h"
+#include "runtime/hostfunc.h"
+
+namespace WasmEdge {
+namespace Host {
+
+template <typename T> class WasmEdgeChannel : public Runtime::HostFunction<T> {
+public:
+  WasmEdgeChannel(WasmEdgeChannelEnvironment &HostEnv)
+      : Runtime::HostFunction<T>(0), Env(HostEnv) {}
+
+protected:
+  WasmEdgeChannelEnvironment &Env;
+};
+
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "channelenv.h"
+#include "channelmodule.h"
+
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace WasmEdge {
+namespace Host {
+namespace Channel {
+
+ChannelHub::ChannelHub(uint32_t Pages) noexcept
+    : Mem(AST::MemoryType(Pages, Pages, true), Pages) {}
+
+std::shared_ptr<ChannelHub> ChannelHub::acquire() noexcept {
+  static std::mutex Mutex;
+  static std::weak_ptr<ChannelHub> Current;
+  std::unique_lock Lock(Mutex);
+  auto Hub = Current.lock();
+  if (!Hub) {
+    Hub = std::make_shared<ChannelHub>(
+        WasmEdgeChannelEnvironment::MemoryPages.value());
+    Current = Hub;
+  }
+  return Hub;
+}
+
+ErrNo ChannelHub::open(std::string_view Name, uint32_t Capacity, uint32_t &Id,
+                       uint32_t &Offset) noexcept {
+  if (Name.empty() || Capacity > Layout::kMaxCapacity) {
+    return ErrNo::InvalidArgument;
+  }
+  std::unique_lock Lock(Mutex);
+  if (auto It = Names.find(std::string(Name)); It != Names.end()) {
+    auto &Ch = *Channels[It->second];
+    ++Ch.Refs;
+    Id = It->second;
+    Offset = Ch.Offset;
+    return ErrNo::Success;
+  }
+
+  Capacity = std::max(Capacity, Layout::kMinCapacity);
+  if ((Capacity & (Capacity - 1)) != 0) {
+    Capacity = UINT32_C(1) << (32 - clz(Capacity));
+  }
+  uint32_t Region;
+  if (auto It = FreeRegions.find(Capacity);
+      It != FreeRegions.end() && !It->second.empty()) {
+    Region = It->second.back();
+    It->second.pop_back();
+  } else {
+    const uint64_t Size =
+        static_cast<uint64_t>(Mem.getPageSize()) *
+        Runtime::Instance::MemoryInstance::kPageSize;
+    if (Layout::kHeaderSize + static_cast<uint64_t>(Capacity) > Size - Top) {
+      spdlog::error("[WasmEdge-Channel] No space for the channel {}."sv, Name);
+      return ErrNo::NoSpace;
+    }
+    Region = static_cast<uint32_t>(Top);
+    Top += Layout::kHeaderSize + Capacity;
+  }
+
+  auto Ch = std::make_shared<Entry>();
+  Ch->Name = Name;
+  Ch->Offset = Region;
+  Ch->Capacity = Capacity;
+  Ch->Refs = 1;
+  word(*Ch, Layout::kHeadOffset).store(0);
+  word(*Ch, Layout::kTailOffset).store(0);
+  word(*Ch, Layout::kClosedOffset).store(0);
+  word(*Ch, Layout::kCapacityOffset).store(Capacity);
+  Id = NextId++;
+  Offset = Region;
+  Names.emplace(Ch->Name, Id);
+  Channels.emplace(Id, std::move(Ch));
+  return ErrNo::Success;
+}
+
+ErrNo ChannelHub::close(uint32_t Id) noexcept {
+  std::shared_ptr<Entry> Ch;
+  {
+    std::unique_lock Lock(Mutex);
+    auto It = Channels.find(Id);
+    if (It == Channels.end()) {
+      return ErrNo::NotFound;
+    }
+    Ch = It->second;
+    word(*Ch, Layout::kClosedOffset).store(1);
+    if (--Ch->Refs == 0) {
+      Names.erase(Ch->Name);
+      FreeRegions[Ch->Capacity].push_back(Ch->Offset);
+      Channels.erase(It);
+    }
+  }
+  std::unique_lock Lock(Ch->Mutex);
+  Ch->Cond.notify_all();
+  return ErrNo::Success;
+}
+
+ErrNo ChannelHub::wait(uint32_t Id, uint32_t Word, uint32_t Expected,
+                       std::chrono::nanoseconds Timeout) noexcept {
+  if (Word > 1) {
+    return ErrNo::InvalidArgument;
+  }
+  auto Ch = find(Id);
+  if (!Ch) {
+    return ErrNo::NotFound;
+  }
+  auto &Counter =
+      word(*Ch, Word == 0 ? Layout::kHeadOffset : Layout::kTailOffset);
+  auto &Closed = word(*Ch, Layout::kClosedOffset);
+  const auto Until = std::chrono::steady_clock::now() + Timeout;
+  std::unique_lock Lock(Ch->Mutex);
+  Ch->Waiters.fetch_add(1);
+  const bool Woken = Ch->Cond.wait_until(Lock, Until, [&]() noexcept {
+    return Counter.load() != Expected || Closed.load() != 0;
+  });
+  Ch->Waiters.fetch_sub(1);
+  return Woken ? ErrNo::Success : ErrNo::TimedOut;
+}
+
+ErrNo ChannelHub::notify(uint32_t Id) noexcept {
+  auto Ch = find(Id);
+  if (!Ch) {
+    return ErrNo::NotFound;
+  }
+  // The counter is changed before, so a waiter not counted yet will see it.
+  if (Ch->Waiters.load() != 0) {
+    std::unique_lock Lock(Ch->Mutex);
+    Ch->Cond.notify_all();
+  }
+  return ErrNo::Success;
+}
+
+std::shared_ptr<ChannelHub::Entry> ChannelHub::find(uint32_t Id) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (auto It = Channels.find(Id); It != Channels.end()) {
+    return It->second;
+  }
+  return {};
+}
+
+} // namespace Channel
+
+WasmEdgeChannelEnvironment::~WasmEdgeChannelEnvironment() noexcept {
+  for (const auto &[Id, Count] : Opened) {
+    for (uint32_t I = 0; I < Count; ++I) {
+      Hub->close(Id);
+    }
+  }
+}
+
+Channel::ErrNo
+WasmEdgeChannelEnvironment::open(std::string_view Name, uint32_t Capacity,
+                                 uint32_t &Id, uint32_t &Offset) noexcept {
+  const auto Err = Hub->open(Name, Capacity, Id, Offset);
+  if (Err == Channel::ErrNo::Success) {
+    std::unique_lock Lock(Mutex);
+    ++Opened[Id];
+  }
+  return Err;
+}
+
+Channel::ErrNo
+WasmEdgeChannelEnvironment::close(uint32_t Id) noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    auto It = Opened.find(Id);
+    if (It == Opened.end()) {
+      return Channel::ErrNo::NotFound;
+    }
+    if (--It->second == 0) {
+      Opened.erase(It);
+    }
+  }
+  return Hub->close(Id);
+}
+
+bool WasmEdgeChannelEnvironment::isOpened(uint32_t Id) noexcept {
+  std::unique_lock Lock(Mutex);
+  return Opened.count(Id) != 0;
+}
+
+PO::Option<uint32_t> WasmEdgeChannelEnvironment::MemoryPages(
+    PO::Description(
+        "Pages of the channel memory shared by the module instances in the process."sv),
+    PO::MetaVar("PAGES"sv), PO::DefaultValue<uint32_t>(1024));
+
+namespace {
+
+void addOptions(const Plugin::Plugin::PluginDescriptor *,
+                PO::ArgumentParser &Parser) noexcept {
+  Parser.add_option("channel-memory-pages"sv,
+                    WasmEdgeChannelEnvironment::MemoryPages);
+}
+
+Runtime::Instance::ModuleInstance *
+create(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
+  return new WasmEdgeChannelModule;
+}
+
+Plugin::Plugin::PluginDescriptor Descriptor{
+    .Name = "wasmedge_channel",
+    .Description = "Zero-copy channels between the instances in a process.",
+    .APIVersion = Plugin::Plugin::CurrentAPIVersion,
+    .Version = {0, 1, 0, 0},
+    .ModuleCount = 1,
+    .ModuleDescriptions =
+        (Plugin::PluginModule::ModuleDescriptor[]){
+            {
+                .Name = "wasmedge_channel",
+                .Description = "",
+                .Create = create,
+            },
+        },
+    .AddOptions = addOptions,
+};
+
+EXPORT_GET_DESCRIPTOR(Descriptor)
+
+} // namespace
+} // namespace Host
+} // namespace WasmEdge
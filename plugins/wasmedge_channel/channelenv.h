@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "plugin/plugin.h"
+#include "po/option.h"
+#include "runtime/instance/memory.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace Channel {
+
+enum class ErrNo : uint32_t {
+  Success = 0,         // No error occurred.
+  InvalidArgument = 1, // Caller module passed an invalid argument.
+  NotFound = 2,        // Channel not found or not opened by the caller.
+  NoSpace = 3,         // Channel memory exhausted.
+  TimedOut = 4,        // Wait timed out.
+};
+
+/// Layout of a channel in the channel memory, which is shared by all the
+/// module instances in the process. The channel is a single-producer and
+/// single-consumer ring buffer of bytes, so that the stages write and read
+/// the data in place without copies.
+///
+/// The counters of the written and read bytes wrap around 2^32, and the byte
+/// of the counter C is at `Offset + kHeaderSize + (C & (Capacity - 1))`. The
+/// producer writes the data and then advances `Head` by an atomic store, and
+/// the consumer reads the data and then advances `Tail`. The counters are on
+/// separated cache lines.
+struct Layout {
+  static inline constexpr uint32_t kHeadOffset = 0;
+  static inline constexpr uint32_t kCapacityOffset = 4;
+  static inline constexpr uint32_t kClosedOffset = 8;
+  static inline constexpr uint32_t kTailOffset = 64;
+  static inline constexpr uint32_t kHeaderSize = 128;
+  static inline constexpr uint32_t kMinCapacity = 64;
+  static inline constexpr uint32_t kMaxCapacity = UINT32_C(1) << 30;
+};
+
+/// Channels of the process. The channel memory is allocated at the full
+/// size once, so that it is never grown or moved, and exported by every
+/// `wasmedge_channel` module instance as the same memory instance.
+class ChannelHub {
+public:
+  ChannelHub(uint32_t Pages) noexcept;
+
+  /// Get the hub of the process, which is created at the first use and
+  /// released with the last module instance.
+  static std::shared_ptr<ChannelHub> acquire() noexcept;
+
+  Runtime::Instance::MemoryInstance &getMemory() noexcept { return Mem; }
+
+  /// Open the channel of the name, or create it with the capacity rounded up
+  /// to a power of two.
+  ErrNo open(std::string_view Name, uint32_t Capacity, uint32_t &Id,
+             uint32_t &Offset) noexcept;
+  /// Drop a reference of the channel. The peer is notified that the channel
+  /// is closed, and the region is reused after the last reference dropped.
+  ErrNo close(uint32_t Id) noexcept;
+  /// Wait until the counter of the channel is changed from the expected
+  /// value, the channel is closed, or timed out.
+  ErrNo wait(uint32_t Id, uint32_t Word, uint32_t Expected,
+             std::chrono::nanoseconds Timeout) noexcept;
+  /// Wake up the waiters of the channel.
+  ErrNo notify(uint32_t Id) noexcept;
+
+private:
+  struct Entry {
+    std::string Name;
+    uint32_t Offset = 0;
+    uint32_t Capacity = 0;
+    uint32_t Refs = 0;
+    /// Count of the waiters, which is increased before checking the counter,
+    /// so the notifies are skipped without waiters.
+    std::atomic<uint32_t> Waiters = 0;
+    std::mutex Mutex;
+    std::condition_variable Cond;
+  };
+
+  std::shared_ptr<Entry> find(uint32_t Id) noexcept;
+  std::atomic<uint32_t> &word(const Entry &Ch, uint32_t Offset) noexcept {
+    return *Mem.getPointer<std::atomic<uint32_t> *>(Ch.Offset + Offset);
+  }
+
+  std::mutex Mutex;
+  Runtime::Instance::MemoryInstance Mem;
+  /// Start of the never allocated region.
+  uint64_t Top = 0;
+  /// Released regions by the capacities.
+  std::map<uint32_t, std::vector<uint32_t>> FreeRegions;
+  std::unordered_map<std::string, uint32_t> Names;
+  std::unordered_map<uint32_t, std::shared_ptr<Entry>> Channels;
+  uint32_t NextId = 1;
+};
+
+} // namespace Channel
+
+class WasmEdgeChannelEnvironment {
+public:
+  WasmEdgeChannelEnvironment() noexcept
+      : Hub(Channel::ChannelHub::acquire()) {}
+  ~WasmEdgeChannelEnvironment() noexcept;
+
+  Channel::ChannelHub &getHub() noexcept { return *Hub; }
+
+  /// Open the channel and track it for closing with the module instance.
+  Channel::ErrNo open(std::string_view Name, uint32_t Capacity,
+                              uint32_t &Id, uint32_t &Offset) noexcept;
+  /// Close the channel opened by this module instance.
+  Channel::ErrNo close(uint32_t Id) noexcept;
+  /// Check the channel is opened by this module instance.
+  bool isOpened(uint32_t Id) noexcept;
+
+  /// Pages of the channel memory.
+  static PO::Option<uint32_t> MemoryPages;
+
+private:
+  std::shared_ptr<Channel::ChannelHub> Hub;
+  std::mutex Mutex;
+  /// Counts of the opens of the channels by this module instance.
+  std::unordered_map<uint32_t, uint32_t> Opened;
+};
+
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "channelfunc.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace WasmEdge {
+namespace Host {
+
+Expect<uint32_t> WasmEdgeChannelOpen::body(const Runtime::CallingFrame &Frame,
+                                           uint32_t NamePtr, uint32_t NameLen,
+                                           uint32_t Capacity, uint32_t IdPtr,
+                                           uint32_t OffsetPtr) {
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  const auto Name = MemInst->getStringView(NamePtr, NameLen);
+  auto *Id = MemInst->getPointer<uint32_t *>(IdPtr);
+  auto *Offset = MemInst->getPointer<uint32_t *>(OffsetPtr);
+  if (Name.size() != NameLen || Id == nullptr || Offset == nullptr) {
+    return static_cast<uint32_t>(Channel::ErrNo::InvalidArgument);
+  }
+  uint32_t NewId = 0, NewOffset = 0;
+  const auto Err = Env.open(Name, Capacity, NewId, NewOffset);
+  if (Err == Channel::ErrNo::Success) {
+    *Id = NewId;
+    *Offset = NewOffset;
+  }
+  return static_cast<uint32_t>(Err);
+}
+
+Expect<uint32_t> WasmEdgeChannelWait::body(const Runtime::CallingFrame &,
+                                           uint32_t Id, uint32_t Word,
+                                           uint32_t Expected,
+                                           uint64_t TimeoutNs) {
+  if (!Env.isOpened(Id)) {
+    return static_cast<uint32_t>(Channel::ErrNo::NotFound);
+  }
+  // Cap the timeout to keep the deadline of the wait from overflowing. The
+  // guest waits again if the peer takes longer.
+  const auto Timeout = std::chrono::nanoseconds(std::min<uint64_t>(
+      TimeoutNs, std::chrono::nanoseconds(std::chrono::hours(1)).count()));
+  return static_cast<uint32_t>(Env.getHub().wait(Id, Word, Expected, Timeout));
+}
+
+Expect<uint32_t> WasmEdgeChannelNotify::body(const Runtime::CallingFrame &,
+                                             uint32_t Id) {
+  if (!Env.isOpened(Id)) {
+    return static_cast<uint32_t>(Channel::ErrNo::NotFound);
+  }
+  return static_cast<uint32_t>(Env.getHub().notify(Id));
+}
+
+Expect<uint32_t> WasmEdgeChannelClose::body(const Runtime::CallingFrame &,
+                                            uint32_t Id) {
+  return static_cast<uint32_t>(Env.close(Id));
+}
+
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "channelbase.h"
+
+#include "runtime/callingframe.h"
+
+#include <cstdint>
+
+namespace WasmEdge {
+namespace Host {
+
+/// Open or create the channel of the name, and write the channel ID and the
+/// offset of the channel in the channel memory.
+class WasmEdgeChannelOpen : public WasmEdgeChannel<WasmEdgeChannelOpen> {
+public:
+  WasmEdgeChannelOpen(WasmEdgeChannelEnvironment &HostEnv)
+      : WasmEdgeChannel(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t NamePtr,
+                        uint32_t NameLen, uint32_t Capacity, uint32_t IdPtr,
+                        uint32_t OffsetPtr);
+};
+
+/// Wait until the head (0) or the tail (1) counter of the channel is changed
+/// from the expected value or the channel is closed. The timeout is capped to
+/// an hour.
+class WasmEdgeChannelWait : public WasmEdgeChannel<WasmEdgeChannelWait> {
+public:
+  WasmEdgeChannelWait(WasmEdgeChannelEnvironment &HostEnv)
+      : WasmEdgeChannel(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Id,
+                        uint32_t Word, uint32_t Expected, uint64_t TimeoutNs);
+};
+
+/// Wake up the waiters of the channel after advancing a counter.
+class WasmEdgeChannelNotify : public WasmEdgeChannel<WasmEdgeChannelNotify> {
+public:
+  WasmEdgeChannelNotify(WasmEdgeChannelEnvironment &HostEnv)
+      : WasmEdgeChannel(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Id);
+};
+
+/// Close the channel opened by the module instance.
+class WasmEdgeChannelClose : public WasmEdgeChannel<WasmEdgeChannelClose> {
+public:
+  WasmEdgeChannelClose(WasmEdgeChannelEnvironment &HostEnv)
+      : WasmEdgeChannel(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t Id);
+};
+
+} // namespace Host
+} // namespace WasmEdge
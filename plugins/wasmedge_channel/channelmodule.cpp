@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "channelmodule.h"
+#include "channelfunc.h"
+
+#include <memory>
+
+namespace WasmEdge {
+namespace Host {
+
+WasmEdgeChannelModule::WasmEdgeChannelModule()
+    : ModuleInstance("wasmedge_channel") {
+  // The channel memory is owned by the hub of the process, which outlives
+  // this module instance.
+  importMemory(&Env.getHub().getMemory());
+  exportMemory("memory", 0);
+  addHostFunc("wasmedge_channel_open",
+              std::make_unique<WasmEdgeChannelOpen>(Env));
+  addHostFunc("wasmedge_channel_wait",
+              std::make_unique<WasmEdgeChannelWait>(Env));
+  addHostFunc("wasmedge_channel_notify",
+              std::make_unique<WasmEdgeChannelNotify>(Env));
+  addHostFunc("wasmedge_channel_close",
+              std::make_unique<WasmEdgeChannelClose>(Env));
+}
+
+} // namespace Host
+} // namespace WasmEdge
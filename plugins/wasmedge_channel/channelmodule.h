@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "channelenv.h"
+
+#include "runtime/instance/module.h"
+
+namespace WasmEdge {
+namespace Host {
+
+/// Module of the channels between the instances in a process. The channel
+/// memory is exported as `memory`, and imported by the stages as a shared
+/// memory, mostly besides their own memory with the multi-memory proposal.
+/// The stages in the same VM can also wait on the counters with the
+/// `memory.atomic.wait32` and `memory.atomic.notify` instructions instead.
+class WasmEdgeChannelModule : public Runtime::Instance::ModuleInstance {
+public:
+  WasmEdgeChannelModule();
+
+  WasmEdgeChannelEnvironment &getEnv() { return Env; }
+
+private:
+  WasmEdgeChannelEnvironment Env;
+};
+
+} // namespace Host
+} // namespace WasmEdge
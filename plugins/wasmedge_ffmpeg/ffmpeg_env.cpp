@@ -6,6 +6,7 @@
 #include "avfilter/module.h"
 #include "avformat/module.h"
 #include "avutil/module.h"
+#include "pipeline/module.h"
 #include "swresample/module.h"
 #include "swscale/module.h"
 
@@ -57,12 +58,18 @@ createSWScale(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
       WasmEdgeFFmpeg::WasmEdgeFFmpegEnv::getInstance());
 }
 
+Runtime::Instance::ModuleInstance *
+createPipeline(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
+  return new WasmEdgeFFmpeg::Pipeline::WasmEdgeFFmpegPipelineModule(
+      WasmEdgeFFmpeg::WasmEdgeFFmpegEnv::getInstance());
+}
+
 Plugin::Plugin::PluginDescriptor Descriptor{
     .Name = "wasmedge_ffmpeg",
     .Description = "",
     .APIVersion = Plugin::Plugin::CurrentAPIVersion,
     .Version = {0, 0, 0, 1},
-    .ModuleCount = 7,
+    .ModuleCount = 8,
     .ModuleDescriptions =
         (Plugin::PluginModule::ModuleDescriptor[]){
             {
@@ -99,6 +106,11 @@ Plugin::Plugin::PluginDescriptor Descriptor{
                 .Name = "wasmedge_ffmpeg_swscale",
                 .Description = "color conversion and scaling library",
                 .Create = createSWScale,
+            },
+            {
+                .Name = "wasmedge_ffmpeg_pipeline",
+                .Description = "host-side transcoding pipelines",
+                .Create = createPipeline,
             }},
     .AddOptions = nullptr,
 };
@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "framePipeline.h"
+
+extern "C" {
+#include "libavutil/hwcontext.h"
+}
+
+#include <string>
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+FramePipeline::FramePipeline(AVCodecContext *Decoder, int32_t Width,
+                             int32_t Height, AVPixelFormat Format,
+                             AVCodecContext *Encoder) noexcept
+    : Decoder(Decoder), Encoder(Encoder), Width(Width), Height(Height),
+      Format(Format), Decoded(av_frame_alloc()), Software(av_frame_alloc()) {}
+
+FramePipeline::~FramePipeline() noexcept {
+  for (AVFrame *Frame : Frames) {
+    av_frame_free(&Frame);
+  }
+  for (AVPacket *Packet : Packets) {
+    av_packet_free(&Packet);
+  }
+  av_frame_free(&Decoded);
+  av_frame_free(&Software);
+  sws_freeContext(Scaler);
+}
+
+int32_t FramePipeline::sendPacket(const AVPacket *Packet) noexcept {
+  int32_t Res = avcodec_send_packet(Decoder, Packet);
+  if (Res < 0) {
+    return Res;
+  }
+  while (true) {
+    Res = avcodec_receive_frame(Decoder, Decoded);
+    if (Res == AVERROR(EAGAIN)) {
+      return 0;
+    }
+    if (Res == AVERROR_EOF) {
+      Flushed = true;
+      return Encoder ? encode(nullptr) : 0;
+    }
+    if (Res < 0) {
+      return Res;
+    }
+    Res = process(Decoded);
+    av_frame_unref(Decoded);
+    if (Res < 0) {
+      return Res;
+    }
+  }
+}
+
+int32_t FramePipeline::receivePacket(AVPacket *Packet) noexcept {
+  if (Packets.empty()) {
+    return Flushed ? AVERROR_EOF : AVERROR(EAGAIN);
+  }
+  AVPacket *Front = Packets.front();
+  Packets.pop_front();
+  av_packet_unref(Packet);
+  av_packet_move_ref(Packet, Front);
+  av_packet_free(&Front);
+  return 0;
+}
+
+int32_t FramePipeline::receiveFrame(AVFrame *Frame) noexcept {
+  if (Frames.empty()) {
+    return Flushed ? AVERROR_EOF : AVERROR(EAGAIN);
+  }
+  AVFrame *Front = Frames.front();
+  Frames.pop_front();
+  av_frame_unref(Frame);
+  av_frame_move_ref(Frame, Front);
+  av_frame_free(&Front);
+  return 0;
+}
+
+int32_t FramePipeline::process(AVFrame *Frame) noexcept {
+  AVFrame *Out = av_frame_alloc();
+  if (Out == nullptr) {
+    return AVERROR(ENOMEM);
+  }
+  int32_t Res = convert(Frame, Out);
+  if (Res >= 0 && Encoder == nullptr) {
+    Frames.push_back(Out);
+    return 0;
+  }
+  if (Res >= 0) {
+    if (Out->pts != AV_NOPTS_VALUE && Decoder->pkt_timebase.num != 0 &&
+        Encoder->time_base.num != 0) {
+      Out->pts =
+          av_rescale_q(Out->pts, Decoder->pkt_timebase, Encoder->time_base);
+    }
+    // Let the encoder choose the picture types.
+    Out->pict_type = AV_PICTURE_TYPE_NONE;
+    Res = encode(Out);
+  }
+  av_frame_free(&Out);
+  return Res;
+}
+
+int32_t FramePipeline::convert(AVFrame *Frame, AVFrame *Out) noexcept {
+  const bool Scale = Width > 0 && Height > 0;
+  AVFrame *Src = Frame;
+  int32_t Res = 0;
+
+  // Hardware frames stay on the device if the encoder takes them as is.
+  if (Frame->hw_frames_ctx != nullptr &&
+      (Scale || (Encoder != nullptr && Encoder->pix_fmt != Frame->format))) {
+    if ((Res = av_hwframe_transfer_data(Software, Frame, 0)) < 0 ||
+        (Res = av_frame_copy_props(Software, Frame)) < 0) {
+      av_frame_unref(Software);
+      return Res;
+    }
+    Src = Software;
+  }
+
+  if (Scale) {
+    Scaler = sws_getCachedContext(
+        Scaler, Src->width, Src->height,
+        static_cast<AVPixelFormat>(Src->format), Width, Height, Format,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    Out->width = Width;
+    Out->height = Height;
+    Out->format = Format;
+    if (Scaler == nullptr) {
+      Res = AVERROR(EINVAL);
+    } else if ((Res = av_frame_get_buffer(Out, 0)) >= 0 &&
+               (Res = av_frame_copy_props(Out, Src)) >= 0) {
+      Res = sws_scale(Scaler, Src->data, Src->linesize, 0, Src->height,
+                      Out->data, Out->linesize);
+    }
+  } else {
+    Res = av_frame_ref(Out, Src);
+  }
+  av_frame_unref(Software);
+  if (Res < 0) {
+    return Res;
+  }
+
+  // Upload to the hardware frames of the encoder.
+  if (Encoder != nullptr && Encoder->hw_frames_ctx != nullptr &&
+      Out->hw_frames_ctx == nullptr) {
+    AVFrame *Hardware = av_frame_alloc();
+    if (Hardware == nullptr) {
+      return AVERROR(ENOMEM);
+    }
+    if ((Res = av_hwframe_get_buffer(Encoder->hw_frames_ctx, Hardware, 0)) >=
+            0 &&
+        (Res = av_hwframe_transfer_data(Hardware, Out, 0)) >= 0 &&
+        (Res = av_frame_copy_props(Hardware, Out)) >= 0) {
+      av_frame_unref(Out);
+      av_frame_move_ref(Out, Hardware);
+    }
+    av_frame_free(&Hardware);
+  }
+  return Res < 0 ? Res : 0;
+}
+
+int32_t FramePipeline::encode(AVFrame *Frame) noexcept {
+  int32_t Res = avcodec_send_frame(Encoder, Frame);
+  if (Res < 0) {
+    return Res;
+  }
+  while (true) {
+    AVPacket *Packet = av_packet_alloc();
+    if (Packet == nullptr) {
+      return AVERROR(ENOMEM);
+    }
+    Res = avcodec_receive_packet(Encoder, Packet);
+    if (Res < 0) {
+      av_packet_free(&Packet);
+      return (Res == AVERROR(EAGAIN) || Res == AVERROR_EOF) ? 0 : Res;
+    }
+    Packets.push_back(Packet);
+  }
+}
+
+int32_t createHWDevice(AVCodecContext *CodecCtx,
+                       std::string_view DeviceType) noexcept {
+  const AVHWDeviceType Type =
+      av_hwdevice_find_type_by_name(std::string(DeviceType).c_str());
+  if (Type == AV_HWDEVICE_TYPE_NONE) {
+    return AVERROR(ENOSYS);
+  }
+  AVBufferRef *Device = nullptr;
+  if (int32_t Res = av_hwdevice_ctx_create(&Device, Type, nullptr, nullptr, 0);
+      Res < 0) {
+    return Res;
+  }
+  av_buffer_unref(&CodecCtx->hw_device_ctx);
+  CodecCtx->hw_device_ctx = Device;
+  return 0;
+}
+
+int32_t createHWFrames(AVCodecContext *Encoder, AVPixelFormat SoftwareFormat,
+                       int32_t PoolSize) noexcept {
+  if (Encoder->hw_device_ctx == nullptr) {
+    return AVERROR(EINVAL);
+  }
+
+  AVHWFramesConstraints *Constraints =
+      av_hwdevice_get_hwframe_constraints(Encoder->hw_device_ctx, nullptr);
+  if (Constraints == nullptr || Constraints->valid_hw_formats == nullptr) {
+    av_hwframe_constraints_free(&Constraints);
+    return AVERROR(ENOSYS);
+  }
+  const AVPixelFormat HardwareFormat = Constraints->valid_hw_formats[0];
+  av_hwframe_constraints_free(&Constraints);
+
+  AVBufferRef *Frames = av_hwframe_ctx_alloc(Encoder->hw_device_ctx);
+  if (Frames == nullptr) {
+    return AVERROR(ENOMEM);
+  }
+  auto *FramesCtx = reinterpret_cast<AVHWFramesContext *>(Frames->data);
+  FramesCtx->format = HardwareFormat;
+  FramesCtx->sw_format = SoftwareFormat;
+  FramesCtx->width = Encoder->width;
+  FramesCtx->height = Encoder->height;
+  FramesCtx->initial_pool_size = PoolSize;
+  if (int32_t Res = av_hwframe_ctx_init(Frames); Res < 0) {
+    av_buffer_unref(&Frames);
+    return Res;
+  }
+  av_buffer_unref(&Encoder->hw_frames_ctx);
+  Encoder->hw_frames_ctx = Frames;
+  Encoder->pix_fmt = HardwareFormat;
+  return 0;
+}
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
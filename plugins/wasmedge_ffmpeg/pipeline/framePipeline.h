@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "ffmpeg_env.h"
+
+extern "C" {
+#include "libswscale/swscale.h"
+}
+
+#include <deque>
+#include <string_view>
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+// A decode -> scale/convert -> encode chain running on the host, so the
+// frames never go through the guest memory. The codec contexts are opened by
+// the guest and must outlive the pipeline.
+class FramePipeline {
+public:
+  // Scale the decoded frames to Width x Height in Format if Width and Height
+  // are not zero. Without an encoder the pipeline outputs frames.
+  FramePipeline(AVCodecContext *Decoder, int32_t Width, int32_t Height,
+                AVPixelFormat Format, AVCodecContext *Encoder) noexcept;
+  ~FramePipeline() noexcept;
+  FramePipeline(const FramePipeline &) = delete;
+  FramePipeline &operator=(const FramePipeline &) = delete;
+
+  // Decode the packet and push the decoded frames through the chain. A null
+  // packet flushes the decoder and then the encoder.
+  int32_t sendPacket(const AVPacket *Packet) noexcept;
+
+  // Take the next output. Returns AVERROR(EAGAIN) if more packets are needed,
+  // or AVERROR_EOF after the flush.
+  int32_t receivePacket(AVPacket *Packet) noexcept;
+  int32_t receiveFrame(AVFrame *Frame) noexcept;
+
+private:
+  int32_t process(AVFrame *Frame) noexcept;
+  int32_t convert(AVFrame *Frame, AVFrame *Out) noexcept;
+  int32_t encode(AVFrame *Frame) noexcept;
+
+  AVCodecContext *Decoder;
+  AVCodecContext *Encoder;
+  const int32_t Width;
+  const int32_t Height;
+  const AVPixelFormat Format;
+  SwsContext *Scaler = nullptr;
+  AVFrame *Decoded;
+  // Hardware frames downloaded for scaling or for a software encoder.
+  AVFrame *Software;
+  std::deque<AVFrame *> Frames;
+  std::deque<AVPacket *> Packets;
+  bool Flushed = false;
+};
+
+// Create a hardware device of the type (e.g. "vaapi", "cuda",
+// "videotoolbox") for the codec context, before it is opened. Decoders then
+// output hardware frames.
+int32_t createHWDevice(AVCodecContext *CodecCtx,
+                       std::string_view DeviceType) noexcept;
+
+// Create the hardware frames of an encoder with a hardware device, before it
+// is opened. The encoder takes the hardware pixel format of the device, and
+// the pipeline uploads the frames in the software format.
+int32_t createHWFrames(AVCodecContext *Encoder, AVPixelFormat SoftwareFormat,
+                       int32_t PoolSize) noexcept;
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "module.h"
+#include "pipeline_func.h"
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+WasmEdgeFFmpegPipelineModule::WasmEdgeFFmpegPipelineModule(
+    std::shared_ptr<WasmEdgeFFmpegEnv> Env)
+    : ModuleInstance("wasmedge_ffmpeg_pipeline") {
+  // Pipeline
+  addHostFunc("wasmedge_ffmpeg_pipeline_pipeline_new",
+              std::make_unique<PipelineNew>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_pipeline_send_packet",
+              std::make_unique<PipelineSendPacket>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_pipeline_receive_packet",
+              std::make_unique<PipelineReceivePacket>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_pipeline_receive_frame",
+              std::make_unique<PipelineReceiveFrame>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_pipeline_free",
+              std::make_unique<PipelineFree>(Env));
+
+  // Hardware acceleration
+  addHostFunc("wasmedge_ffmpeg_pipeline_av_hwdevice_ctx_create",
+              std::make_unique<AVHWDeviceCtxCreate>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_av_hwframe_ctx_create",
+              std::make_unique<AVHWFrameCtxCreate>(Env));
+  addHostFunc("wasmedge_ffmpeg_pipeline_av_hwframe_transfer_data",
+              std::make_unique<AVHWFrameTransferData>(Env));
+}
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
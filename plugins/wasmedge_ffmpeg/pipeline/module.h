@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "ffmpeg_env.h"
+
+#include "runtime/instance/module.h"
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+class WasmEdgeFFmpegPipelineModule : public Runtime::Instance::ModuleInstance {
+public:
+  WasmEdgeFFmpegPipelineModule(std::shared_ptr<WasmEdgeFFmpegEnv> Env);
+};
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "pipeline_func.h"
+#include "framePipeline.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavutil/hwcontext.h"
+}
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+Expect<int32_t> PipelineNew::body(const Runtime::CallingFrame &Frame,
+                                  uint32_t PipelinePtr, uint32_t DecoderCtxId,
+                                  int32_t Width, int32_t Height,
+                                  uint32_t PixFormatId,
+                                  uint32_t EncoderCtxId) {
+  MEMINST_CHECK(MemInst, Frame, 0);
+  MEM_PTR_CHECK(PipelineId, MemInst, uint32_t, PipelinePtr,
+                "Failed when accessing the return Pipeline Memory"sv);
+
+  FFMPEG_PTR_FETCH(DecoderCtx, DecoderCtxId, AVCodecContext);
+  FFMPEG_PTR_FETCH(EncoderCtx, EncoderCtxId, AVCodecContext);
+  if (DecoderCtx == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+
+  AVPixelFormat const PixFormat =
+      FFmpegUtils::PixFmt::intoAVPixFmt(PixFormatId);
+  auto *Pipeline =
+      new FramePipeline(DecoderCtx, Width, Height, PixFormat, EncoderCtx);
+  FFMPEG_PTR_STORE(Pipeline, PipelineId);
+  return static_cast<int32_t>(ErrNo::Success);
+}
+
+Expect<int32_t> PipelineSendPacket::body(const Runtime::CallingFrame &,
+                                         uint32_t PipelineId,
+                                         uint32_t PacketId) {
+  FFMPEG_PTR_FETCH(Pipeline, PipelineId, FramePipeline);
+  FFMPEG_PTR_FETCH(Packet, PacketId, AVPacket);
+  if (Pipeline == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  return Pipeline->sendPacket(Packet);
+}
+
+Expect<int32_t> PipelineReceivePacket::body(const Runtime::CallingFrame &,
+                                            uint32_t PipelineId,
+                                            uint32_t PacketId) {
+  FFMPEG_PTR_FETCH(Pipeline, PipelineId, FramePipeline);
+  FFMPEG_PTR_FETCH(Packet, PacketId, AVPacket);
+  if (Pipeline == nullptr || Packet == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  return Pipeline->receivePacket(Packet);
+}
+
+Expect<int32_t> PipelineReceiveFrame::body(const Runtime::CallingFrame &,
+                                           uint32_t PipelineId,
+                                           uint32_t FrameId) {
+  FFMPEG_PTR_FETCH(Pipeline, PipelineId, FramePipeline);
+  FFMPEG_PTR_FETCH(AvFrame, FrameId, AVFrame);
+  if (Pipeline == nullptr || AvFrame == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  return Pipeline->receiveFrame(AvFrame);
+}
+
+Expect<int32_t> PipelineFree::body(const Runtime::CallingFrame &,
+                                   uint32_t PipelineId) {
+  FFMPEG_PTR_FETCH(Pipeline, PipelineId, FramePipeline);
+  delete Pipeline;
+  FFMPEG_PTR_DELETE(PipelineId);
+  return static_cast<int32_t>(ErrNo::Success);
+}
+
+Expect<int32_t> AVHWDeviceCtxCreate::body(const Runtime::CallingFrame &Frame,
+                                          uint32_t AVCodecCtxId,
+                                          uint32_t TypePtr, uint32_t TypeLen) {
+  MEMINST_CHECK(MemInst, Frame, 0);
+  MEM_SPAN_CHECK(TypeBuf, MemInst, char, TypePtr, TypeLen, "");
+
+  FFMPEG_PTR_FETCH(AvCodecCtx, AVCodecCtxId, AVCodecContext);
+  if (AvCodecCtx == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  return createHWDevice(AvCodecCtx,
+                        std::string_view(TypeBuf.data(), TypeBuf.size()));
+}
+
+Expect<int32_t> AVHWFrameCtxCreate::body(const Runtime::CallingFrame &,
+                                         uint32_t AVCodecCtxId,
+                                         uint32_t SwPixFormatId,
+                                         int32_t PoolSize) {
+  FFMPEG_PTR_FETCH(AvCodecCtx, AVCodecCtxId, AVCodecContext);
+  if (AvCodecCtx == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  AVPixelFormat const SwPixFormat =
+      FFmpegUtils::PixFmt::intoAVPixFmt(SwPixFormatId);
+  return createHWFrames(AvCodecCtx, SwPixFormat, PoolSize);
+}
+
+Expect<int32_t> AVHWFrameTransferData::body(const Runtime::CallingFrame &,
+                                            uint32_t DstFrameId,
+                                            uint32_t SrcFrameId) {
+  FFMPEG_PTR_FETCH(DstFrame, DstFrameId, AVFrame);
+  FFMPEG_PTR_FETCH(SrcFrame, SrcFrameId, AVFrame);
+  if (DstFrame == nullptr || SrcFrame == nullptr) {
+    return static_cast<int32_t>(ErrNo::NullStructId);
+  }
+  if (int32_t Res = av_hwframe_transfer_data(DstFrame, SrcFrame, 0); Res < 0) {
+    return Res;
+  }
+  return av_frame_copy_props(DstFrame, SrcFrame);
+}
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#pragma once
+
+#include "ffmpeg_base.h"
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+namespace Pipeline {
+
+class PipelineNew : public HostFunction<PipelineNew> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t PipelinePtr,
+                       uint32_t DecoderCtxId, int32_t Width, int32_t Height,
+                       uint32_t PixFormatId, uint32_t EncoderCtxId);
+};
+
+class PipelineSendPacket : public HostFunction<PipelineSendPacket> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t PipelineId,
+                       uint32_t PacketId);
+};
+
+class PipelineReceivePacket : public HostFunction<PipelineReceivePacket> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t PipelineId,
+                       uint32_t PacketId);
+};
+
+class PipelineReceiveFrame : public HostFunction<PipelineReceiveFrame> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t PipelineId,
+                       uint32_t FrameId);
+};
+
+class PipelineFree : public HostFunction<PipelineFree> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t PipelineId);
+};
+
+class AVHWDeviceCtxCreate : public HostFunction<AVHWDeviceCtxCreate> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame,
+                       uint32_t AVCodecCtxId, uint32_t TypePtr,
+                       uint32_t TypeLen);
+};
+
+class AVHWFrameCtxCreate : public HostFunction<AVHWFrameCtxCreate> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame,
+                       uint32_t AVCodecCtxId, uint32_t SwPixFormatId,
+                       int32_t PoolSize);
+};
+
+class AVHWFrameTransferData : public HostFunction<AVHWFrameTransferData> {
+public:
+  using HostFunction::HostFunction;
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t DstFrameId,
+                       uint32_t SrcFrameId);
+};
+
+} // namespace Pipeline
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
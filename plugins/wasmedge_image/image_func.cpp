@@ -11,6 +11,14 @@
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include <stb_image_resize2.h>
 
+#ifdef WASMEDGE_PLUGIN_IMAGE_LIBJPEG
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+#include <jpeglib.h>
+#endif
+
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -21,6 +29,72 @@ namespace WasmEdgeImage {
 
 namespace {
 
+#ifdef WASMEDGE_PLUGIN_IMAGE_LIBJPEG
+struct JPEGErrorManager {
+  jpeg_error_mgr Pub;
+  std::jmp_buf Jump;
+};
+
+[[noreturn]] void jpegErrorExit(j_common_ptr Info) {
+  std::longjmp(reinterpret_cast<JPEGErrorManager *>(Info->err)->Jump, 1);
+}
+
+void jpegOutputMessage(j_common_ptr) {}
+
+// Decode the JPEG image into RGB with the largest DCT-domain downscaling
+// (1/2, 1/4 or 1/8) that keeps it at least W x H, so that the resizing works
+// on the smaller image. Returns nullptr if the image is not downscaled, and
+// the caller decodes it as usual. The result must be released by std::free.
+uint8_t *decodeJPEGScaled(Span<const uint8_t> Buf, uint32_t W, uint32_t H,
+                          int &IW, int &IH) noexcept {
+  jpeg_decompress_struct Info;
+  JPEGErrorManager Err;
+  uint8_t *volatile Pixels = nullptr;
+  Info.err = jpeg_std_error(&Err.Pub);
+  Err.Pub.error_exit = jpegErrorExit;
+  Err.Pub.output_message = jpegOutputMessage;
+  if (setjmp(Err.Jump)) {
+    jpeg_destroy_decompress(&Info);
+    std::free(Pixels);
+    return nullptr;
+  }
+  jpeg_create_decompress(&Info);
+  jpeg_mem_src(&Info, const_cast<uint8_t *>(Buf.data()),
+               static_cast<unsigned long>(Buf.size()));
+  jpeg_read_header(&Info, TRUE);
+
+  uint32_t Denom = 8;
+  while (Denom > 1 &&
+         (Info.image_width / Denom < W || Info.image_height / Denom < H)) {
+    Denom /= 2;
+  }
+  if (Denom == 1) {
+    jpeg_destroy_decompress(&Info);
+    return nullptr;
+  }
+  Info.scale_num = 1;
+  Info.scale_denom = Denom;
+  Info.out_color_space = JCS_RGB;
+  jpeg_start_decompress(&Info);
+
+  const size_t Stride = static_cast<size_t>(Info.output_width) * 3;
+  Pixels = static_cast<uint8_t *>(std::malloc(Stride * Info.output_height));
+  if (Pixels == nullptr) {
+    jpeg_destroy_decompress(&Info);
+    return nullptr;
+  }
+  while (Info.output_scanline < Info.output_height) {
+    JSAMPROW Row = Pixels + Info.output_scanline * Stride;
+    jpeg_read_scanlines(&Info, &Row, 1);
+  }
+  IW = static_cast<int>(Info.output_width);
+  IH = static_cast<int>(Info.output_height);
+  jpeg_finish_decompress(&Info);
+  jpeg_destroy_decompress(&Info);
+  return Pixels;
+}
+#endif
+
 bool decodeImgToSize(Span<const uint8_t> Buf, uint32_t W, uint32_t H,
                      DataType OutType, Span<uint8_t> DstBuf) noexcept {
   // Specify the target data format.
@@ -50,7 +124,19 @@ bool decodeImgToSize(Span<const uint8_t> Buf, uint32_t W, uint32_t H,
   RawImagePtr RawImg;
   RawImg.U8 = nullptr;
   int IW, IH, IC;
-  if (IsU8) {
+  bool IsScaledJPEG = false;
+#ifdef WASMEDGE_PLUGIN_IMAGE_LIBJPEG
+  // The JPEG SOI marker. Only the u8 outputs, as stbi_loadf applies its own
+  // gamma to the decoded samples.
+  if (IsU8 && Buf.size() > 3 && Buf[0] == 0xFF && Buf[1] == 0xD8 &&
+      Buf[2] == 0xFF) {
+    RawImg.U8 = decodeJPEGScaled(Buf, W, H, IW, IH);
+    IsScaledJPEG = RawImg.U8 != nullptr;
+  }
+#endif
+  if (IsScaledJPEG) {
+    // Already decoded in the smaller size.
+  } else if (IsU8) {
     RawImg.U8 = stbi_load_from_memory(Buf.data(), Buf.size(), &IW, &IH, &IC, 3);
   } else {
     RawImg.F32 =
@@ -61,16 +147,28 @@ bool decodeImgToSize(Span<const uint8_t> Buf, uint32_t W, uint32_t H,
     return false;
   }
 
+  auto FreeRawImg = [&]() {
+    if (IsScaledJPEG) {
+      std::free(RawImg.U8);
+    } else {
+      stbi_image_free(RawImg.U8);
+    }
+  };
+
   // Resize.
-  if (unlikely(DstBuf.size() <
-               W * H * 3 * (IsU8 ? sizeof(uint8_t) : sizeof(float)))) {
+  const size_t Size =
+      size_t(W) * H * 3 * (IsU8 ? sizeof(uint8_t) : sizeof(float));
+  if (unlikely(DstBuf.size() < Size)) {
     spdlog::error("[WasmEdge-Image] Output buffer size {} not enough. "sv
                   "At least need {} bytes."sv,
-                  DstBuf.size(),
-                  W * H * 3 * (IsU8 ? sizeof(uint8_t) : sizeof(float)));
+                  DstBuf.size(), Size);
+    FreeRawImg();
     return false;
   }
-  if (IsU8) {
+  if (static_cast<uint32_t>(IW) == W && static_cast<uint32_t>(IH) == H) {
+    // Already in the target size.
+    std::copy_n(RawImg.U8, Size, DstBuf.data());
+  } else if (IsU8) {
     stbir_resize_uint8_linear(RawImg.U8, IW, IH, 0, DstBuf.data(),
                               static_cast<int>(W), static_cast<int>(H), 0,
                               STBIR_RGB);
@@ -94,7 +192,7 @@ bool decodeImgToSize(Span<const uint8_t> Buf, uint32_t W, uint32_t H,
       }
     }
   }
-  stbi_image_free(RawImg.U8);
+  FreeRawImg();
   return true;
 }
 
@@ -183,6 +281,50 @@ Expect<uint32_t> LoadImage::body(const Runtime::CallingFrame &Frame,
   return static_cast<uint32_t>(ErrNo::Success);
 }
 
+Expect<uint32_t> LoadImageBatch::body(const Runtime::CallingFrame &Frame,
+                                      uint32_t InImgListPtr,
+                                      uint32_t InImgCount, uint32_t OutImgW,
+                                      uint32_t OutImgH, uint32_t OutType,
+                                      uint32_t OutBufPtr, uint32_t OutBufLen) {
+  // Check memory instance from module.
+  MEMINST_CHECK(MemInst, Frame, 0)
+
+  // Check the input image buffer list.
+  if (unlikely(InImgCount > UINT32_MAX / 2)) {
+    spdlog::error("[WasmEdge-Image] Too many input images."sv);
+    return static_cast<uint32_t>(ErrNo::Fail);
+  }
+  MEM_SPAN_CHECK(ImgListSpan, MemInst, uint32_t, InImgListPtr, InImgCount * 2,
+                 "Failed when accessing the input image list memory."sv)
+
+  // Check the output decoded image buffer.
+  MEM_SPAN_CHECK(OutBufSpan, MemInst, uint8_t, OutBufPtr, OutBufLen,
+                 "Failed when accessing the output image data buffer memory."sv)
+
+  const DataType Type = static_cast<DataType>(OutType);
+  const size_t ImgSize =
+      size_t(OutImgW) * OutImgH * 3 *
+      ((Type == DataType::RGB8 || Type == DataType::BGR8) ? sizeof(uint8_t)
+                                                          : sizeof(float));
+  if (unlikely(ImgSize > 0 && OutBufSpan.size() / ImgSize < InImgCount)) {
+    spdlog::error("[WasmEdge-Image] Output buffer size {} not enough. "sv
+                  "At least need {} bytes."sv,
+                  OutBufSpan.size(), ImgSize * InImgCount);
+    return static_cast<uint32_t>(ErrNo::Fail);
+  }
+
+  for (uint32_t I = 0; I < InImgCount; ++I) {
+    const uint32_t ImgBufLen = ImgListSpan[I * 2 + 1];
+    MEM_SPAN_CHECK(ImgBufSpan, MemInst, uint8_t, ImgListSpan[I * 2], ImgBufLen,
+                   "Failed when accessing the input image buffer memory."sv)
+    if (unlikely(!decodeImgToSize(ImgBufSpan, OutImgW, OutImgH, Type,
+                                  OutBufSpan.subspan(I * ImgSize, ImgSize)))) {
+      return static_cast<uint32_t>(ErrNo::Fail);
+    }
+  }
+  return static_cast<uint32_t>(ErrNo::Success);
+}
+
 } // namespace WasmEdgeImage
 } // namespace Host
 } // namespace WasmEdge
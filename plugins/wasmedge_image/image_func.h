@@ -38,6 +38,17 @@ public:
                         uint32_t OutBufPtr, uint32_t OutBufLen);
 };
 
+// Load the images in the list of {u32 ptr, u32 len} input buffers. The output
+// images are written one after another into the output buffer.
+class LoadImageBatch : public Func<LoadImageBatch> {
+public:
+  LoadImageBatch(ImgEnv &HostEnv) : Func(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame,
+                        uint32_t InImgListPtr, uint32_t InImgCount,
+                        uint32_t OutImgW, uint32_t OutImgH, uint32_t OutType,
+                        uint32_t OutBufPtr, uint32_t OutBufLen);
+};
+
 } // namespace WasmEdgeImage
 } // namespace Host
 } // namespace WasmEdge
@@ -5,10 +5,26 @@
 #include "llmc_fwd.h"
 #include "llmc_module.h"
 
+#include "common/config.h"
+
+#include <system_error>
+
+#if WASMEDGE_OS_LINUX
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+#endif
+
 namespace WasmEdge {
 namespace Host {
 namespace WasmEdgeLLMC {
 
+using namespace std::literals::string_view_literals;
+
+PO::Option<int32_t> LLMCEnv::NumThreads(
+    PO::Description("Threads of the CPU training, 0 for the OpenMP default."sv),
+    PO::MetaVar("THREADS"sv), PO::DefaultValue<int32_t>(0));
+
 uint32_t LLMCEnv::addModel(GPT2 *M) noexcept {
   Models.push_back(M);
   return Models.size() - 1;
@@ -39,7 +55,35 @@ DataLoader *LLMCEnv::getDataLoader(uint32_t Id) noexcept {
   return DataLoaders[Id];
 }
 
+void LLMCEnv::prefetch(std::string Pattern) noexcept {
+#if WASMEDGE_OS_LINUX
+  try {
+    Prefetchers.emplace_back([Pattern = std::move(Pattern)]() noexcept {
+      glob_t Files;
+      if (::glob(Pattern.c_str(), 0, nullptr, &Files) != 0) {
+        return;
+      }
+      for (size_t I = 0; I < Files.gl_pathc; ++I) {
+        if (int Fd = ::open(Files.gl_pathv[I], O_RDONLY | O_CLOEXEC);
+            Fd >= 0) {
+          ::posix_fadvise(Fd, 0, 0, POSIX_FADV_WILLNEED);
+          ::close(Fd);
+        }
+      }
+      ::globfree(&Files);
+    });
+  } catch (std::exception &) {
+    // The data files are read on demand by the data loader.
+  }
+#else
+  static_cast<void>(Pattern);
+#endif
+}
+
 LLMCEnv::~LLMCEnv() {
+  for (auto &Thread : Prefetchers) {
+    Thread.join();
+  }
   for (GPT2 *M : Models) {
     gpt2_destroy(M);
   }
@@ -52,6 +96,11 @@ LLMCEnv::~LLMCEnv() {
 }
 
 namespace {
+void addOptions(const Plugin::Plugin::PluginDescriptor *,
+                PO::ArgumentParser &Parser) noexcept {
+  Parser.add_option("llmc-threads"sv, LLMCEnv::NumThreads);
+}
+
 Runtime::Instance::ModuleInstance *
 create(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
   return new WasmEdgeLLMCModule;
@@ -74,7 +123,7 @@ Plugin::Plugin::PluginDescriptor Descriptor{
     /* ModuleDescriptions */ MD,
     /* ComponentCount */ 0,
     /* ComponentDescriptions */ nullptr,
-    /*AddOptions*/ nullptr,
+    /*AddOptions*/ addOptions,
 };
 } // namespace
 
@@ -4,9 +4,12 @@
 #pragma once
 
 #include "plugin/plugin.h"
+#include "po/option.h"
 
 #include <cstdint>
 #include <functional>
+#include <string>
+#include <thread>
 #include <vector>
 
 extern "C" {
@@ -29,8 +32,12 @@ class LLMCEnv {
   std::vector<GPT2 *> Models;
   std::vector<Tokenizer *> Tokenizers;
   std::vector<DataLoader *> DataLoaders;
+  std::vector<std::thread> Prefetchers;
 
 public:
+  /// Threads of the CPU training, or zero for the OpenMP default.
+  static PO::Option<int32_t> NumThreads;
+
   uint32_t addModel(GPT2 *M) noexcept;
 
   GPT2 *getModel(uint32_t Id) noexcept;
@@ -49,6 +56,10 @@ public:
 
   size_t getDataLoaderSize() const noexcept { return DataLoaders.size(); }
 
+  /// Read ahead the data files of the pattern into the page cache in the
+  /// background, so that the training steps do not wait for the disk.
+  void prefetch(std::string Pattern) noexcept;
+
   ~LLMCEnv();
 };
 
@@ -10,6 +10,10 @@
 #include <string>
 #include <string_view>
 
+#ifdef WASMEDGE_PLUGIN_LLMC_OPENMP
+#include <omp.h>
+#endif
+
 namespace WasmEdge {
 namespace Host {
 namespace WasmEdgeLLMC {
@@ -73,6 +77,7 @@ Expect<ErrNo> DataLoaderCreate::bodyImpl(
   DataLoader *D = dataloader_create(DataPathStr.data(), B, T, ProcessRank,
                                     NumProcesses, ShouldShuffle);
   *DataLoaderId = Env.addDataLoader(D);
+  Env.prefetch(std::move(DataPathStr));
   return ErrNo::Success;
 }
 
@@ -118,6 +123,11 @@ Expect<ErrNo> ModelTrain::bodyImpl(const Runtime::CallingFrame &Frame,
   DataLoader *TrainDataLoader = Env.getDataLoader(TrainDataLoaderId);
   DataLoader *ValDataLoader = Env.getDataLoader(ValDataLoaderId);
   Tokenizer *Tokenizer = Env.getTokenizer(TokenizerId);
+#ifdef WASMEDGE_PLUGIN_LLMC_OPENMP
+  if (const int32_t Threads = LLMCEnv::NumThreads.value(); Threads > 0) {
+    omp_set_num_threads(Threads);
+  }
+#endif
   gpt2_train(Model, TrainDataLoader, ValDataLoader, Tokenizer, B, T, Lr, Epoch);
   return ErrNo::Success;
 }
@@ -4,6 +4,8 @@
 #include "ocr_env.h"
 #include "ocr_module.h"
 
+#include <new>
+
 namespace WasmEdge {
 namespace Host {
 namespace {
@@ -36,5 +38,59 @@ Plugin::Plugin::PluginDescriptor Descriptor{
 EXPORT_GET_DESCRIPTOR(Descriptor)
 
 } // namespace
+
+namespace WasmEdgeOCR {
+
+EnginePool &EnginePool::getDefault() noexcept {
+  static EnginePool Default;
+  return Default;
+}
+
+EnginePool::Engine EnginePool::acquire(const std::string &Language,
+                                       const std::string &Config) noexcept {
+  try {
+    {
+      std::unique_lock Lock(Mutex);
+      if (auto It = Idle.find({Language, Config});
+          It != Idle.end() && !It->second.empty()) {
+        Engine API = std::move(It->second.back());
+        It->second.pop_back();
+        return API;
+      }
+    }
+
+    // Initialize the engine without specifying the tessdata path.
+    auto API = std::make_unique<tesseract::TessBaseAPI>();
+    std::string ConfigName = Config;
+    char *Configs[] = {ConfigName.data()};
+    if (API->Init(nullptr, Language.c_str(), tesseract::OEM_DEFAULT,
+                  Config.empty() ? nullptr : Configs, Config.empty() ? 0 : 1,
+                  nullptr, nullptr, false)) {
+      spdlog::error(
+          "[WasmEdge-OCR] Error occurred when initializing tesseract with language {}.",
+          Language);
+      return nullptr;
+    }
+    return API;
+  } catch (std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void EnginePool::release(const std::string &Language, const std::string &Config,
+                         Engine API) noexcept {
+  // Drop the image and the results of the last recognition.
+  API->Clear();
+  std::unique_lock Lock(Mutex);
+  try {
+    auto &Engines = Idle[{Language, Config}];
+    if (Engines.size() < kMaxIdle) {
+      Engines.push_back(std::move(API));
+    }
+  } catch (std::bad_alloc &) {
+  }
+}
+
+} // namespace WasmEdgeOCR
 } // namespace Host
 } // namespace WasmEdge
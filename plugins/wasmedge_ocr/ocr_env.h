@@ -10,6 +10,12 @@
 #include <tesseract/baseapi.h>
 
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace WasmEdge {
 namespace Host {
@@ -22,25 +28,42 @@ enum class ErrNo : uint32_t {
   Busy = 3             // Device or resource busy.
 };
 
+/// Pool of the initialized Tesseract engines, shared by the modules of all
+/// the VMs. The engines are kept by the language and the config they are
+/// initialized with, so that a call does not pay for the initialization.
+class EnginePool {
+public:
+  using Engine = std::unique_ptr<tesseract::TessBaseAPI>;
+
+  static EnginePool &getDefault() noexcept;
+
+  /// Take an idle engine of the language and the config, or initialize one.
+  ///
+  /// @param[in] Language The languages of the engine, such as "eng+deu".
+  /// @param[in] Config The name of the config file of the tessdata, or empty.
+  /// @return The engine, or nullptr if the initialization failed.
+  Engine acquire(const std::string &Language,
+                 const std::string &Config) noexcept;
+
+  /// Return the engine to the pool.
+  void release(const std::string &Language, const std::string &Config,
+               Engine API) noexcept;
+
+private:
+  /// Maximum idle engines kept per language and config.
+  static inline constexpr const size_t kMaxIdle = 8;
+
+  std::mutex Mutex;
+  std::map<std::pair<std::string, std::string>, std::vector<Engine>> Idle;
+};
+
 class OCREnv {
 public:
-  OCREnv() noexcept {
-    // check Tesseract API by initializing tesseract-ocr with English, without
-    // specifying tessdata path
-    if (TesseractApi->Init(NULL, "eng")) {
-      spdlog::error(
-          "[WasmEdge-OCR] Error occurred when initializing tesseract.");
-    }
-  }
-  ~OCREnv() noexcept {
-    if (TesseractApi) {
-      TesseractApi->End();
-      ;
-    }
-  }
-  tesseract::TessBaseAPI *TesseractApi = new tesseract::TessBaseAPI();
-
-  static Plugin::PluginRegister Register;
+  /// Languages and config of the engines used by the recognitions.
+  std::string Language = "eng";
+  std::string Config;
+  /// TSV text of the last recognition.
+  std::string Output;
 };
 
 } // namespace WasmEdgeOCR
@@ -6,12 +6,75 @@
 #include "common/spdlog.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 namespace WasmEdge {
 namespace Host {
 namespace WasmEdgeOCR {
 
+namespace {
+
+/// Count of the `uint32_t` fields of a region of the batch.
+static inline constexpr const uint32_t kRegionFields = 6;
+
+struct Region {
+  Span<const uint8_t> Image;
+  uint32_t Left;
+  uint32_t Top;
+  uint32_t Width;
+  uint32_t Height;
+};
+
+/// Engine taken from the pool for the scope.
+class Lease {
+public:
+  Lease(const OCREnv &Env) noexcept
+      : Language(Env.Language), Config(Env.Config),
+        API(EnginePool::getDefault().acquire(Language, Config)) {}
+  ~Lease() noexcept {
+    if (API) {
+      EnginePool::getDefault().release(Language, Config, std::move(API));
+    }
+  }
+  tesseract::TessBaseAPI &operator*() const noexcept { return *API; }
+  explicit operator bool() const noexcept { return API != nullptr; }
+
+private:
+  const std::string &Language;
+  const std::string &Config;
+  EnginePool::Engine API;
+};
+
+/// Recognize the image, and get the TSV text of the words.
+bool recognize(tesseract::TessBaseAPI &API, Pix *Image, const Region &R,
+               std::string &Output) noexcept {
+  API.SetImage(Image);
+  if (R.Width != 0 && R.Height != 0) {
+    API.SetRectangle(static_cast<int>(R.Left), static_cast<int>(R.Top),
+                     static_cast<int>(R.Width), static_cast<int>(R.Height));
+  }
+  if (API.Recognize(nullptr) != 0) {
+    return false;
+  }
+  std::unique_ptr<char[]> Text(API.GetTSVText(0));
+  if (!Text) {
+    return false;
+  }
+  try {
+    Output.assign(Text.get());
+  } catch (std::bad_alloc &) {
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
 Expect<uint32_t> NumOfExtractions::body(const Runtime::CallingFrame &Frame,
                                         uint32_t ImagePathPtr,
                                         uint32_t ImagePathLen) {
@@ -24,22 +87,26 @@ Expect<uint32_t> NumOfExtractions::body(const Runtime::CallingFrame &Frame,
   if (unlikely(ImagePtr.size() != ImagePathLen)) {
     return Unexpect(ErrCode::Value::HostFuncError);
   }
-  Pix *image = pixRead(ImagePtr.data());
-
-  Env.TesseractApi->SetImage(image);
-  Env.TesseractApi->Recognize(0);
-
-  tesseract::PageIteratorLevel level = tesseract::RIL_WORD;
-  const char *outText = Env.TesseractApi->GetTSVText(level);
+  const std::string ImagePath(ImagePtr.begin(), ImagePtr.end());
+  Pix *Image = pixRead(ImagePath.c_str());
+  if (Image == nullptr) {
+    spdlog::error("[WasmEdge-OCR] Failed to read the image {}.", ImagePath);
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
 
-  uint32_t length = strlen(outText);
-  pixDestroy(&image);
-  return static_cast<uint32_t>(length);
+  Lease API(Env);
+  const bool Success =
+      API && recognize(*API, Image, Region{}, Env.Output);
+  pixDestroy(&Image);
+  if (!Success) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  return static_cast<uint32_t>(Env.Output.size());
 }
 
 Expect<uint32_t> GetOutput::body(const Runtime::CallingFrame &Frame,
-                                 uint32_t OutBufferPtr [[maybe_unused]],
-                                 uint32_t OutBufferMaxSize [[maybe_unused]]) {
+                                 uint32_t OutBufferPtr,
+                                 uint32_t OutBufferMaxSize) {
   // Check memory instance from module.
   auto *MemInst = Frame.getMemoryByIndex(0);
   if (MemInst == nullptr) {
@@ -54,16 +121,120 @@ Expect<uint32_t> GetOutput::body(const Runtime::CallingFrame &Frame,
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
 
-  tesseract::PageIteratorLevel level = tesseract::RIL_WORD;
-  std::unique_ptr<const char[]> outText = Env.TesseractApi->GetTSVText(level);
-  std::copy_n(outText, std::min<size_t>(std::strlen(outText.get()), Buf.size()),
+  // The text is kept from the last recognition, which is not run again.
+  std::copy_n(Env.Output.begin(), std::min(Env.Output.size(), Buf.size()),
               Buf.begin());
+  return static_cast<uint32_t>(ErrNo::Success);
+}
 
-  // remaining free and deltee memory stuff
-  Env.TesseractApi->End();
+Expect<uint32_t> SetLanguage::body(const Runtime::CallingFrame &Frame,
+                                   uint32_t LanguagePtr, uint32_t LanguageLen,
+                                   uint32_t ConfigPtr, uint32_t ConfigLen) {
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return static_cast<uint32_t>(ErrNo::MissingMemory);
+  }
+  auto Language = MemInst->getStringView(LanguagePtr, LanguageLen);
+  auto Config = MemInst->getStringView(ConfigPtr, ConfigLen);
+  if (unlikely(Language.size() != LanguageLen || LanguageLen == 0 ||
+               Config.size() != ConfigLen)) {
+    spdlog::error("[WasmEdge-OCR] Failed when accessing the language memory.");
+    return static_cast<uint32_t>(ErrNo::InvalidArgument);
+  }
 
+  // Initialize an engine now, so that the invalid language is reported here.
+  OCREnv Probe;
+  Probe.Language = Language;
+  Probe.Config = Config;
+  if (!Lease(Probe)) {
+    return static_cast<uint32_t>(ErrNo::InvalidArgument);
+  }
+  Env.Language = std::move(Probe.Language);
+  Env.Config = std::move(Probe.Config);
   return static_cast<uint32_t>(ErrNo::Success);
-  // return outText;
+}
+
+Expect<uint32_t>
+NumOfExtractionsBatch::body(const Runtime::CallingFrame &Frame,
+                            uint32_t RegionsPtr, uint32_t RegionsLen) {
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  const uint64_t FieldsLen = uint64_t(RegionsLen) * kRegionFields;
+  auto Fields = MemInst->getSpan<const uint32_t>(
+      RegionsPtr, static_cast<uint32_t>(FieldsLen));
+  if (unlikely(FieldsLen > UINT32_MAX || Fields.size() != FieldsLen)) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  // The images are read from the guest memory in place.
+  std::vector<Region> Regions(RegionsLen);
+  for (uint32_t I = 0; I < RegionsLen; ++I) {
+    const auto *F = &Fields[I * kRegionFields];
+    Regions[I].Image = MemInst->getSpan<const uint8_t>(F[0], F[1]);
+    if (unlikely(Regions[I].Image.size() != F[1] || F[1] == 0)) {
+      return Unexpect(ErrCode::Value::HostFuncError);
+    }
+    Regions[I].Left = F[2];
+    Regions[I].Top = F[3];
+    Regions[I].Width = F[4];
+    Regions[I].Height = F[5];
+  }
+
+  // Fan the regions out across the engines of the pool.
+  std::vector<std::string> Outputs(RegionsLen);
+  std::atomic<uint32_t> Next = 0;
+  std::atomic<bool> Failed = false;
+  auto Worker = [&]() noexcept {
+    Lease API(Env);
+    if (!API) {
+      Failed.store(true, std::memory_order_relaxed);
+      return;
+    }
+    while (!Failed.load(std::memory_order_relaxed)) {
+      const uint32_t I = Next.fetch_add(1, std::memory_order_relaxed);
+      if (I >= RegionsLen) {
+        break;
+      }
+      const auto &R = Regions[I];
+      Pix *Image = pixReadMem(R.Image.data(), R.Image.size());
+      if (Image == nullptr ||
+          !recognize(*API, Image, R, Outputs[I])) {
+        spdlog::error("[WasmEdge-OCR] Failed to recognize the region {}.", I);
+        Failed.store(true, std::memory_order_relaxed);
+      }
+      pixDestroy(&Image);
+    }
+  };
+  const uint32_t Threads = std::clamp<uint32_t>(
+      std::thread::hardware_concurrency(), 1, std::max(RegionsLen, 1U));
+  std::vector<std::thread> Pool;
+  try {
+    for (uint32_t I = 1; I < Threads; ++I) {
+      Pool.emplace_back(Worker);
+    }
+  } catch (std::system_error &) {
+    // Run the rest of the regions on the started threads.
+  }
+  Worker();
+  for (auto &Thread : Pool) {
+    Thread.join();
+  }
+  if (Failed.load(std::memory_order_relaxed)) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  Env.Output.clear();
+  for (uint32_t I = 0; I < RegionsLen; ++I) {
+    if (I > 0) {
+      Env.Output.push_back('\f');
+    }
+    Env.Output += Outputs[I];
+  }
+  return static_cast<uint32_t>(Env.Output.size());
 }
 
 } // namespace WasmEdgeOCR
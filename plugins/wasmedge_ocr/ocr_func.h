@@ -27,6 +27,25 @@ public:
                         uint32_t OutBufferMaxSize);
 };
 
+class SetLanguage : public HostFunction<SetLanguage> {
+public:
+  SetLanguage(OCREnv &HostEnv) : HostFunction(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t LanguagePtr,
+                        uint32_t LanguageLen, uint32_t ConfigPtr,
+                        uint32_t ConfigLen);
+};
+
+/// Recognize the regions of the encoded images in the guest memory in
+/// parallel. The regions are an array of the `(ImagePtr, ImageLen, Left, Top,
+/// Width, Height)` tuples of `uint32_t`, where the zero width means the whole
+/// image. The TSV texts of the regions are separated by the form feeds.
+class NumOfExtractionsBatch : public HostFunction<NumOfExtractionsBatch> {
+public:
+  NumOfExtractionsBatch(OCREnv &HostEnv) : HostFunction(HostEnv) {}
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t RegionsPtr,
+                        uint32_t RegionsLen);
+};
+
 } // namespace WasmEdgeOCR
 } // namespace Host
 } // namespace WasmEdge
@@ -11,6 +11,9 @@ WasmEdgeOCRModule::WasmEdgeOCRModule() : ModuleInstance("wasmedge_ocr") {
   addHostFunc("num_of_extractions",
               std::make_unique<WasmEdgeOCR::NumOfExtractions>(Env));
   addHostFunc("get_output", std::make_unique<WasmEdgeOCR::GetOutput>(Env));
+  addHostFunc("set_language", std::make_unique<WasmEdgeOCR::SetLanguage>(Env));
+  addHostFunc("num_of_extractions_batch",
+              std::make_unique<WasmEdgeOCR::NumOfExtractionsBatch>(Env));
 }
 
 } // namespace Host
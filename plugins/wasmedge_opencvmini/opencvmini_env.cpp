@@ -9,6 +9,37 @@ namespace Host {
 
 WasmEdgeOpenCVMiniEnvironment::WasmEdgeOpenCVMiniEnvironment() noexcept {}
 
+void WasmEdgeOpenCVMiniEnvironment::releaseMat(uint32_t MatKey) noexcept {
+  if (auto It = MatPool.find(MatKey); It != MatPool.end()) {
+    cv::Mat Mat = std::move(It->second);
+    MatPool.erase(It);
+    recycleMat(std::move(Mat));
+  }
+}
+
+cv::Mat WasmEdgeOpenCVMiniEnvironment::takeMat(int Rows, int Cols, int Type) {
+  if (auto It = FreeMats.find({Rows, Cols, Type}); It != FreeMats.end()) {
+    cv::Mat Mat = std::move(It->second);
+    FreeMats.erase(It);
+    return Mat;
+  }
+  return cv::Mat(Rows, Cols, Type);
+}
+
+void WasmEdgeOpenCVMiniEnvironment::recycleMat(cv::Mat &&Mat) noexcept {
+  // Bound the memory held by the released buffers.
+  constexpr size_t MaxFreeMats = 16;
+  // Only the continuous buffers with a single owner, so that the reused
+  // buffer is not visible from other matrices.
+  if (Mat.empty() || Mat.dims != 2 || !Mat.isContinuous() ||
+      Mat.u == nullptr || Mat.u->refcount != 1 ||
+      FreeMats.size() >= MaxFreeMats) {
+    return;
+  }
+  FreeMats.emplace(std::make_tuple(Mat.rows, Mat.cols, Mat.type()),
+                   std::move(Mat));
+}
+
 namespace {
 
 Runtime::Instance::ModuleInstance *
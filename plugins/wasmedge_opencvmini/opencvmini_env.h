@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <map>
 #include <opencv2/opencv.hpp>
+#include <tuple>
 
 namespace WasmEdge {
 namespace Host {
@@ -17,6 +18,9 @@ public:
   WasmEdgeOpenCVMiniEnvironment() noexcept;
 
   std::map<uint32_t, cv::Mat> MatPool;
+  // Released matrices to reuse the buffers, by their rows, cols and type.
+  std::multimap<std::tuple<int, int, int>, cv::Mat> FreeMats;
+  uint32_t NextMatKey = 1;
 
   Expect<cv::Mat> getMat(uint32_t MatKey) {
     if (auto V = this->MatPool.find(MatKey); V != this->MatPool.end()) {
@@ -27,11 +31,20 @@ public:
   }
 
   Expect<uint32_t> insertMat(const cv::Mat &Img) {
-    // cv::Mat::flags contains magic signature & I believe it's a good enough
-    // key for this purpose.
-    this->MatPool[static_cast<uint32_t>(Img.flags)] = Img;
-    return static_cast<uint32_t>(Img.flags);
+    // The keys are never reused, so that a stale key does not refer to
+    // another matrix.
+    const uint32_t MatKey = NextMatKey++;
+    this->MatPool[MatKey] = Img;
+    return MatKey;
   }
+
+  // Forget the matrix, and keep its buffer for reuse if no one else refers
+  // to it.
+  void releaseMat(uint32_t MatKey) noexcept;
+
+  // Get a matrix of the shape, reusing a released buffer if any.
+  cv::Mat takeMat(int Rows, int Cols, int Type);
+  void recycleMat(cv::Mat &&Mat) noexcept;
 };
 
 } // namespace Host
@@ -6,6 +6,7 @@
 #include "common/errcode.h"
 
 #include <cstdint>
+#include <cstring>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/opencv.hpp>
@@ -15,6 +16,87 @@
 namespace WasmEdge {
 namespace Host {
 
+namespace {
+
+// The expected output shape of the operation, to reuse a released buffer.
+std::tuple<int, int, int> outputShape(const MatOp &Op, const cv::Mat &Src) {
+  const auto Depth = [&](uint32_t Ddepth) {
+    const int32_t D = static_cast<int32_t>(Ddepth);
+    return D < 0 ? Src.type() : CV_MAKETYPE(D, Src.channels());
+  };
+  switch (static_cast<MatOpCode>(Op.Code)) {
+  case MatOpCode::BoxFilter:
+  case MatOpCode::Laplacian:
+    return {Src.rows, Src.cols, Depth(Op.Args[0])};
+  case MatOpCode::PyrDown:
+    return {(Src.rows + 1) / 2, (Src.cols + 1) / 2, Src.type()};
+  case MatOpCode::PyrUp:
+    return {Src.rows * 2, Src.cols * 2, Src.type()};
+  case MatOpCode::Normalize:
+    return {Src.rows, Src.cols, CV_MAKETYPE(CV_32F, Src.channels())};
+  case MatOpCode::BilinearSampling:
+    return {static_cast<int>(Op.Args[1]), static_cast<int>(Op.Args[0]),
+            Src.type()};
+  default:
+    return {Src.rows, Src.cols, Src.type()};
+  }
+}
+
+bool runOp(WasmEdgeOpenCVMiniEnvironment &Env, const MatOp &Op,
+           const cv::Mat &Src, cv::Mat &Dst) {
+  const auto KernelSize = [&]() { return cv::Size(Op.Args[0], Op.Args[1]); };
+  const auto Kernel = [&]() {
+    auto Mat = Env.getMat(Op.Args[0]);
+    return Mat ? *Mat : cv::Mat();
+  };
+  switch (static_cast<MatOpCode>(Op.Code)) {
+  case MatOpCode::Blur:
+    cv::blur(Src, Dst, KernelSize());
+    return true;
+  case MatOpCode::BilateralFilter:
+    cv::bilateralFilter(Src, Dst, Op.Args[0], Op.FArgs[0], Op.FArgs[1]);
+    return true;
+  case MatOpCode::BoxFilter:
+    cv::boxFilter(Src, Dst, Op.Args[0], cv::Size(Op.Args[1], Op.Args[2]));
+    return true;
+  case MatOpCode::Dilate:
+    cv::dilate(Src, Dst, Kernel());
+    return true;
+  case MatOpCode::Erode:
+    cv::erode(Src, Dst, Kernel());
+    return true;
+  case MatOpCode::GaussianBlur:
+    cv::GaussianBlur(Src, Dst, KernelSize(), Op.FArgs[0]);
+    return true;
+  case MatOpCode::Laplacian:
+    cv::Laplacian(Src, Dst, Op.Args[0]);
+    return true;
+  case MatOpCode::MedianBlur:
+    cv::medianBlur(Src, Dst, Op.Args[0]);
+    return true;
+  case MatOpCode::PyrDown:
+    cv::pyrDown(Src, Dst, KernelSize());
+    return true;
+  case MatOpCode::PyrUp:
+    cv::pyrUp(Src, Dst, KernelSize());
+    return true;
+  case MatOpCode::Normalize:
+    Src.convertTo(Dst, CV_32F, 1. / 255., 0.);
+    return true;
+  case MatOpCode::BilinearSampling:
+    cv::resize(Src, Dst, KernelSize(), 0, 0, cv::INTER_LINEAR);
+    return true;
+  case MatOpCode::CvtColor:
+    cv::cvtColor(Src, Dst, static_cast<int32_t>(Op.Args[0]),
+                 static_cast<int32_t>(Op.Args[1]));
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
 Expect<uint32_t>
 WasmEdgeOpenCVMiniImdecode::body(const Runtime::CallingFrame &Frame,
                                  uint32_t BufPtr, uint32_t BufLen) {
@@ -287,5 +369,74 @@ Expect<uint32_t> WasmEdgeOpenCVMiniCvtColor::body(const Runtime::CallingFrame &,
   return Env.insertMat(Dst);
 }
 
+Expect<uint32_t> WasmEdgeOpenCVMiniRunOps::body(
+    const Runtime::CallingFrame &Frame, uint32_t SrcMatKey, uint32_t OpsPtr,
+    uint32_t OpsLen) {
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  if (unlikely(OpsLen > UINT32_MAX / sizeof(MatOp))) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  const uint32_t OpsSize = OpsLen * static_cast<uint32_t>(sizeof(MatOp));
+  auto OpsSpan = MemInst->getSpan<const uint8_t>(OpsPtr, OpsSize);
+  if (unlikely(OpsSpan.size() != OpsSize)) {
+    spdlog::error("[WasmEdge-OpenCVMini] "sv
+                  "Failed when accessing the operations memory."sv);
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  auto Src = Env.getMat(SrcMatKey);
+  if (!Src) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  // Every operation reads the previous result and writes into the other
+  // buffer.
+  cv::Mat Buffers[2];
+  cv::Mat Cur = *Src;
+  uint32_t Last = 0;
+  try {
+    for (uint32_t I = 0; I < OpsLen; ++I) {
+      MatOp Op;
+      std::memcpy(&Op, OpsSpan.data() + I * sizeof(MatOp), sizeof(MatOp));
+      cv::Mat &Dst = Buffers[I % 2];
+      const auto [Rows, Cols, Type] = outputShape(Op, Cur);
+      if (Dst.rows != Rows || Dst.cols != Cols || Dst.type() != Type) {
+        Env.recycleMat(std::move(Dst));
+        Dst = Env.takeMat(Rows, Cols, Type);
+      }
+      if (!runOp(Env, Op, Cur, Dst)) {
+        spdlog::error("[WasmEdge-OpenCVMini] Unknown operation {}."sv,
+                      Op.Code);
+        return Unexpect(ErrCode::Value::HostFuncError);
+      }
+      Cur = Dst;
+      Last = I % 2;
+    }
+  } catch (const cv::Exception &E) {
+    spdlog::error("[WasmEdge-OpenCVMini] {}"sv, E.what());
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  auto Res = Env.insertMat(Cur);
+  if (OpsLen > 0) {
+    // Drop the references other than the inserted result first.
+    Cur.release();
+    Buffers[Last].release();
+    Env.recycleMat(std::move(Buffers[1 - Last]));
+  }
+  return Res;
+}
+
+Expect<void> WasmEdgeOpenCVMiniReleaseMat::body(const Runtime::CallingFrame &,
+                                                uint32_t MatKey) {
+  Env.releaseMat(MatKey);
+  return {};
+}
+
 } // namespace Host
 } // namespace WasmEdge
@@ -205,5 +205,54 @@ public:
                         int32_t Code, int32_t DestChannelN);
 };
 
+/// Operations of wasmedge_opencvmini_run_ops, with the same arguments as the
+/// single functions.
+enum class MatOpCode : uint32_t {
+  Blur = 0,              // KernelWidth, KernelHeight
+  BilateralFilter = 1,   // D; SigmaColor, SigmaSpace
+  BoxFilter = 2,         // Ddepth, KernelWidth, KernelHeight
+  Dilate = 3,            // KernelMatKey
+  Erode = 4,             // KernelMatKey
+  GaussianBlur = 5,      // KernelWidth, KernelHeight; SigmaX
+  Laplacian = 6,         // Ddepth
+  MedianBlur = 7,        // Ksize
+  PyrDown = 8,           // Width, Height
+  PyrUp = 9,             // Width, Height
+  Normalize = 10,
+  BilinearSampling = 11, // OutImgW, OutImgH
+  CvtColor = 12,         // Code, DestChannelN
+};
+
+/// An operation in the guest memory, 32 bytes.
+struct MatOp {
+  uint32_t Code;
+  uint32_t Args[3];
+  double FArgs[2];
+};
+static_assert(sizeof(MatOp) == 32);
+
+/// Run the list of operations on the matrix in one call. The intermediate
+/// matrices reuse two buffers and are never inserted, and only the result is
+/// returned as a new matrix.
+class WasmEdgeOpenCVMiniRunOps
+    : public WasmEdgeOpenCVMini<class WasmEdgeOpenCVMiniRunOps> {
+public:
+  WasmEdgeOpenCVMiniRunOps(WasmEdgeOpenCVMiniEnvironment &HostEnv)
+      : WasmEdgeOpenCVMini(HostEnv) {}
+
+  Expect<uint32_t> body(const Runtime::CallingFrame &Frame, uint32_t SrcMatKey,
+                        uint32_t OpsPtr, uint32_t OpsLen);
+};
+
+/// Release the matrix. Its buffer is reused by the later operations.
+class WasmEdgeOpenCVMiniReleaseMat
+    : public WasmEdgeOpenCVMini<class WasmEdgeOpenCVMiniReleaseMat> {
+public:
+  WasmEdgeOpenCVMiniReleaseMat(WasmEdgeOpenCVMiniEnvironment &HostEnv)
+      : WasmEdgeOpenCVMini(HostEnv) {}
+
+  Expect<void> body(const Runtime::CallingFrame &, uint32_t MatKey);
+};
+
 } // namespace Host
 } // namespace WasmEdge
@@ -47,6 +47,10 @@ WasmEdgeOpenCVMiniModule::WasmEdgeOpenCVMiniModule()
               std::make_unique<WasmEdgeOpenCVMiniBilinearSampling>(Env));
   addHostFunc("wasmedge_opencvmini_cvt_color",
               std::make_unique<WasmEdgeOpenCVMiniCvtColor>(Env));
+  addHostFunc("wasmedge_opencvmini_run_ops",
+              std::make_unique<WasmEdgeOpenCVMiniRunOps>(Env));
+  addHostFunc("wasmedge_opencvmini_release_mat",
+              std::make_unique<WasmEdgeOpenCVMiniReleaseMat>(Env));
 
   addHostFunc("wasmedge_opencvmini_rectangle",
               std::make_unique<WasmEdgeOpenCVMiniRectangle>(Env));
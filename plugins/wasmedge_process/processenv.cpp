@@ -4,10 +4,17 @@
 #include "processenv.h"
 #include "processmodule.h"
 
+#include "common/defines.h"
 #include "po/helper.h"
 
 #include <string_view>
 
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace WasmEdge {
 namespace Host {
 
@@ -25,6 +32,46 @@ WasmEdgeProcessEnvironment::WasmEdgeProcessEnvironment() noexcept
     : AllowedCmd(AllowCmd.value().begin(), AllowCmd.value().end()),
       AllowedAll(AllowCmdAll.value()) {}
 
+WasmEdgeProcessEnvironment::~WasmEdgeProcessEnvironment() noexcept {
+  for (auto &[Handle, Proc] : Processes) {
+    releaseProcess(Proc);
+  }
+}
+
+bool WasmEdgeProcessEnvironment::checkExited(Process &Proc) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (!Proc.Exited) {
+    int ChildStat;
+    if (pid_t WPID = waitpid(Proc.PID, &ChildStat, WNOHANG); WPID > 0) {
+      Proc.Exited = true;
+      Proc.ExitCode = WIFEXITED(ChildStat) ? WEXITSTATUS(ChildStat)
+                                           : 128 + WTERMSIG(ChildStat);
+    } else if (WPID == -1) {
+      // Already reaped or not a child.
+      Proc.Exited = true;
+      Proc.ExitCode = -1;
+    }
+  }
+#endif
+  return Proc.Exited;
+}
+
+void WasmEdgeProcessEnvironment::releaseProcess(Process &Proc) noexcept {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  if (!checkExited(Proc)) {
+    kill(Proc.PID, SIGKILL);
+    waitpid(Proc.PID, nullptr, 0);
+    Proc.Exited = true;
+  }
+  for (int *FD : {&Proc.StdIn, &Proc.StdOut, &Proc.StdErr}) {
+    if (*FD != -1) {
+      close(*FD);
+      *FD = -1;
+    }
+  }
+#endif
+}
+
 namespace {
 
 void addOptions(const Plugin::Plugin::PluginDescriptor *,
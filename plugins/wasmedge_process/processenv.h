@@ -21,6 +21,7 @@ namespace Host {
 class WasmEdgeProcessEnvironment {
 public:
   WasmEdgeProcessEnvironment() noexcept;
+  ~WasmEdgeProcessEnvironment() noexcept;
 
   /// Default timeout in milliseconds.
   static inline const uint32_t DEFAULT_TIMEOUT = 10000;
@@ -48,6 +49,24 @@ public:
   /// Results
   uint32_t ExitCode = 0;
 
+  /// Long-lived processes spawned by wasmedge_process_spawn. The pipes are
+  /// non-blocking, and -1 after closed.
+  struct Process {
+    int PID = -1;
+    int StdIn = -1;
+    int StdOut = -1;
+    int StdErr = -1;
+    bool Exited = false;
+    int32_t ExitCode = 0;
+  };
+  std::unordered_map<uint32_t, Process> Processes;
+  uint32_t NextProcess = 1;
+
+  /// Check the process without blocking. Returns true if it has exited.
+  static bool checkExited(Process &Proc) noexcept;
+  /// Kill the process if still running, and close the pipes.
+  static void releaseProcess(Process &Proc) noexcept;
+
   static PO::List<std::string> AllowCmd;
   static PO::Option<PO::Toggle> AllowCmdAll;
 };
@@ -9,7 +9,10 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <poll.h>
+#include <pthread.h>
 #include <signal.h>
+#include <spawn.h>
 #include <sys/select.h>
 #include <sys/stat.h>
 #include <sys/time.h>
@@ -24,6 +27,138 @@ using namespace std::literals;
 namespace WasmEdge {
 namespace Host {
 
+namespace {
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+/// Reset the command inputs for the next command.
+void resetInputs(WasmEdgeProcessEnvironment &Env) noexcept {
+  Env.Name.clear();
+  Env.Args.clear();
+  Env.Envs.clear();
+  Env.StdIn.clear();
+  Env.TimeOut = Env.DEFAULT_TIMEOUT;
+}
+
+/// Check white list of commands. The message is written into the stderr if
+/// the command is not allowed.
+bool checkAllowed(WasmEdgeProcessEnvironment &Env) noexcept {
+  if (Env.AllowedAll || Env.AllowedCmd.find(Env.Name) != Env.AllowedCmd.end()) {
+    return true;
+  }
+  std::string Msg = "Permission denied: Command \"";
+  Msg.append(Env.Name);
+  Msg.append("\" is not in the white list. Please use --allow-command=");
+  Msg.append(Env.Name);
+  Msg.append(" or --allow-command-all to add \"");
+  Msg.append(Env.Name);
+  Msg.append("\" command into the white list.\n");
+  Env.StdErr.reserve(Msg.length());
+  std::copy_n(Msg.c_str(), Msg.length(), std::back_inserter(Env.StdErr));
+  resetInputs(Env);
+  return false;
+}
+
+/// Create a pipe not inherited by other children.
+bool createPipe(int FD[2]) noexcept {
+  if (pipe(FD) == -1) {
+    return false;
+  }
+  fcntl(FD[0], F_SETFD, FD_CLOEXEC);
+  fcntl(FD[1], F_SETFD, FD_CLOEXEC);
+  return true;
+}
+
+void closePipes(std::initializer_list<int *> FDs) noexcept {
+  for (int *FD : FDs) {
+    close(FD[0]);
+    close(FD[1]);
+  }
+}
+
+/// Launch the command with the pipe ends as the standard streams. The
+/// posix_spawn does not copy the page tables of the host as fork does (glibc
+/// and macOS use vfork or clone(CLONE_VM)), which is slow for a host with a
+/// large address space.
+bool spawnCommand(WasmEdgeProcessEnvironment &Env, int StdIn, int StdOut,
+                  int StdErr, pid_t &PID) noexcept {
+  // Prepare arguments and environment variables.
+  std::vector<std::string> EnvStr;
+  for (auto &It : Env.Envs) {
+    EnvStr.push_back(It.first + "=" + It.second);
+  }
+  std::vector<char *> Argv, Envp;
+  Argv.push_back(Env.Name.data());
+  std::transform(Env.Args.begin(), Env.Args.end(), std::back_inserter(Argv),
+                 [](std::string &S) { return S.data(); });
+  std::transform(EnvStr.begin(), EnvStr.end(), std::back_inserter(Envp),
+                 [](std::string &S) { return S.data(); });
+  Argv.push_back(nullptr);
+  Envp.push_back(nullptr);
+
+  // The dup2 actions clear the close-on-exec flags of the standard streams.
+  posix_spawn_file_actions_t Actions;
+  posix_spawn_file_actions_init(&Actions);
+  posix_spawn_file_actions_adddup2(&Actions, StdIn, 0);
+  posix_spawn_file_actions_adddup2(&Actions, StdOut, 1);
+  posix_spawn_file_actions_adddup2(&Actions, StdErr, 2);
+  int Res =
+      posix_spawnp(&PID, Env.Name.c_str(), &Actions, nullptr, &Argv[0],
+                   &Envp[0]);
+  posix_spawn_file_actions_destroy(&Actions);
+  if (Res != 0) {
+    std::string_view Msg;
+    switch (Res) {
+    case EACCES:
+      Msg = "Permission denied.\n"sv;
+      break;
+    case ENOENT:
+      Msg = "Command not found.\n"sv;
+      break;
+    default:
+      Msg = "Unknown error.\n"sv;
+      break;
+    }
+    spdlog::error(Msg.substr(0, Msg.size() - 1));
+    std::copy(Msg.begin(), Msg.end(), std::back_inserter(Env.StdErr));
+    return false;
+  }
+  return true;
+}
+
+int32_t writePipe(int FD, Span<const uint8_t> Buf) noexcept {
+  // Block SIGPIPE while writing, so that the write to an exited child fails
+  // with EPIPE instead of killing the host.
+  sigset_t PipeSet, OldSet;
+  sigemptyset(&PipeSet);
+  sigaddset(&PipeSet, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &PipeSet, &OldSet);
+  const ssize_t WBytes = write(FD, Buf.data(), Buf.size());
+  const int Err = errno;
+  if (WBytes == -1 && Err == EPIPE && !sigismember(&OldSet, SIGPIPE)) {
+    // Consume the pending signal before unblocking it.
+    sigset_t Pending;
+    sigpending(&Pending);
+    if (int Sig; sigismember(&Pending, SIGPIPE)) {
+      sigwait(&PipeSet, &Sig);
+    }
+  }
+  pthread_sigmask(SIG_SETMASK, &OldSet, nullptr);
+  return WBytes >= 0 ? static_cast<int32_t>(WBytes) : -Err;
+}
+
+int32_t readPipe(int FD, Span<uint8_t> Buf) noexcept {
+  if (FD == -1) {
+    return 0;
+  }
+  if (ssize_t RBytes = read(FD, Buf.data(), Buf.size()); RBytes >= 0) {
+    return static_cast<int32_t>(RBytes);
+  }
+  return -errno;
+}
+#endif
+
+} // namespace
+
 Expect<void>
 WasmEdgeProcessSetProgName::body(const Runtime::CallingFrame &Frame,
                                  uint32_t NamePtr, uint32_t NameLen) {
@@ -100,106 +235,33 @@ Expect<uint32_t> WasmEdgeProcessRun::body(const Runtime::CallingFrame &) {
   Env.StdErr.clear();
   Env.ExitCode = static_cast<uint32_t>(-1);
 
-  // Check white list of commands.
-  if (!Env.AllowedAll &&
-      Env.AllowedCmd.find(Env.Name) == Env.AllowedCmd.end()) {
-    std::string Msg = "Permission denied: Command \"";
-    Msg.append(Env.Name);
-    Msg.append("\" is not in the white list. Please use --allow-command=");
-    Msg.append(Env.Name);
-    Msg.append(" or --allow-command-all to add \"");
-    Msg.append(Env.Name);
-    Msg.append("\" command into the white list.\n");
-    Env.Name.clear();
-    Env.Args.clear();
-    Env.Envs.clear();
-    Env.StdIn.clear();
-    Env.StdErr.reserve(Msg.length());
-    std::copy_n(Msg.c_str(), Msg.length(), std::back_inserter(Env.StdErr));
+  if (!checkAllowed(Env)) {
     Env.ExitCode = static_cast<int32_t>(INT8_C(-1));
-    Env.TimeOut = Env.DEFAULT_TIMEOUT;
     return Env.ExitCode;
   }
 
   // Create pipes for stdin, stdout, and stderr.
   int FDStdIn[2], FDStdOut[2], FDStdErr[2];
-  if (pipe(FDStdIn) == -1) {
+  if (!createPipe(FDStdIn)) {
     // Create stdin pipe failed.
     return Env.ExitCode;
   }
-  if (pipe(FDStdOut) == -1) {
+  if (!createPipe(FDStdOut)) {
     // Create stdout pipe failed.
-    close(FDStdIn[0]);
-    close(FDStdIn[1]);
+    closePipes({FDStdIn});
     return Env.ExitCode;
   }
-  if (pipe(FDStdErr) == -1) {
+  if (!createPipe(FDStdErr)) {
     // Create stderr pipe failed.
-    close(FDStdIn[0]);
-    close(FDStdIn[1]);
-    close(FDStdOut[0]);
-    close(FDStdOut[1]);
+    closePipes({FDStdIn, FDStdOut});
     return Env.ExitCode;
   }
 
   // Create a child process for executing command.
-  pid_t PID = fork();
-  if (PID == -1) {
+  pid_t PID;
+  if (!spawnCommand(Env, FDStdIn[0], FDStdOut[1], FDStdErr[1], PID)) {
     // Create process failed.
-    close(FDStdIn[0]);
-    close(FDStdIn[1]);
-    close(FDStdOut[0]);
-    close(FDStdOut[1]);
-    close(FDStdErr[0]);
-    close(FDStdErr[1]);
-    return Env.ExitCode;
-  } else if (PID == 0) {
-    // Child process. Setup pipes.
-    dup2(FDStdIn[0], 0);
-    dup2(FDStdOut[1], 1);
-    dup2(FDStdErr[1], 2);
-    close(FDStdIn[0]);
-    close(FDStdIn[1]);
-    close(FDStdOut[0]);
-    close(FDStdOut[1]);
-    close(FDStdErr[0]);
-    close(FDStdErr[1]);
-
-    // Prepare arguments and environment variables.
-    std::vector<std::string> EnvStr;
-    for (auto &It : Env.Envs) {
-      EnvStr.push_back(It.first + "=" + It.second);
-    }
-    std::vector<char *> Argv, Envp;
-    Argv.push_back(Env.Name.data());
-    std::transform(Env.Args.begin(), Env.Args.end(), std::back_inserter(Argv),
-                   [](std::string &S) { return S.data(); });
-    std::transform(EnvStr.begin(), EnvStr.end(), std::back_inserter(Envp),
-                   [](std::string &S) { return S.data(); });
-    Argv.push_back(nullptr);
-    Envp.push_back(nullptr);
-#if defined(__GLIBC_PREREQ)
-#if __GLIBC_PREREQ(2, 11)
-    if (execvpe(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#else
-    if (execve(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#endif
-#else
-    if (execve(Env.Name.c_str(), &Argv[0], &Envp[0]) == -1) {
-#endif
-      switch (errno) {
-      case EACCES:
-        spdlog::error("Permission denied."sv);
-        break;
-      case ENOENT:
-        spdlog::error("Command not found."sv);
-        break;
-      default:
-        spdlog::error("Unknown error."sv);
-        break;
-      }
-      _exit(-1);
-    }
+    closePipes({FDStdIn, FDStdOut, FDStdErr});
   } else {
     // Parent process. Close unused file descriptors.
     close(FDStdIn[0]);
@@ -292,11 +354,7 @@ Expect<uint32_t> WasmEdgeProcessRun::body(const Runtime::CallingFrame &) {
   }
 
   // Reset inputs.
-  Env.Name.clear();
-  Env.Args.clear();
-  Env.Envs.clear();
-  Env.StdIn.clear();
-  Env.TimeOut = Env.DEFAULT_TIMEOUT;
+  resetInputs(Env);
   return Env.ExitCode;
 #elif WASMEDGE_OS_WINDOWS
   spdlog::error("wasmedge_process doesn't support windows now."sv);
@@ -304,6 +362,212 @@ Expect<uint32_t> WasmEdgeProcessRun::body(const Runtime::CallingFrame &) {
 #endif
 }
 
+Expect<int32_t> WasmEdgeProcessSpawn::body(const Runtime::CallingFrame &) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  Env.StdErr.clear();
+  if (!checkAllowed(Env)) {
+    return -1;
+  }
+
+  int FDStdIn[2], FDStdOut[2], FDStdErr[2];
+  if (!createPipe(FDStdIn)) {
+    return -errno;
+  }
+  if (!createPipe(FDStdOut)) {
+    const int Err = errno;
+    closePipes({FDStdIn});
+    return -Err;
+  }
+  if (!createPipe(FDStdErr)) {
+    const int Err = errno;
+    closePipes({FDStdIn, FDStdOut});
+    return -Err;
+  }
+
+  pid_t PID;
+  const bool Spawned =
+      spawnCommand(Env, FDStdIn[0], FDStdOut[1], FDStdErr[1], PID);
+  resetInputs(Env);
+  if (!Spawned) {
+    closePipes({FDStdIn, FDStdOut, FDStdErr});
+    return -1;
+  }
+  close(FDStdIn[0]);
+  close(FDStdOut[1]);
+  close(FDStdErr[1]);
+
+  WasmEdgeProcessEnvironment::Process Proc;
+  Proc.PID = PID;
+  Proc.StdIn = FDStdIn[1];
+  Proc.StdOut = FDStdOut[0];
+  Proc.StdErr = FDStdErr[0];
+  for (int FD : {Proc.StdIn, Proc.StdOut, Proc.StdErr}) {
+    fcntl(FD, F_SETFL, fcntl(FD, F_GETFL) | O_NONBLOCK);
+  }
+  const uint32_t Handle = Env.NextProcess++;
+  Env.Processes.emplace(Handle, Proc);
+  return static_cast<int32_t>(Handle);
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<int32_t> WasmEdgeProcessPoll::body(const Runtime::CallingFrame &,
+                                          uint32_t Handle, int32_t Timeout) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  auto It = Env.Processes.find(Handle);
+  if (It == Env.Processes.end()) {
+    return -EBADF;
+  }
+  auto &Proc = It->second;
+
+  // The closed pipes are -1 and ignored by poll.
+  struct pollfd FDs[3] = {{Proc.StdOut, POLLIN, 0},
+                          {Proc.StdErr, POLLIN, 0},
+                          {Proc.StdIn, POLLOUT, 0}};
+  if (poll(FDs, 3, Timeout) == -1 && errno != EINTR) {
+    return -errno;
+  }
+  int32_t Events = 0;
+  // The hang-ups are readable for the end of the stream.
+  if (FDs[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+    Events |= static_cast<int32_t>(ProcessEvent::StdOut);
+  }
+  if (FDs[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+    Events |= static_cast<int32_t>(ProcessEvent::StdErr);
+  }
+  if (FDs[2].revents & (POLLOUT | POLLHUP | POLLERR)) {
+    Events |= static_cast<int32_t>(ProcessEvent::StdIn);
+  }
+  if (WasmEdgeProcessEnvironment::checkExited(Proc)) {
+    Events |= static_cast<int32_t>(ProcessEvent::Exited);
+  }
+  return Events;
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<int32_t>
+WasmEdgeProcessWriteStdIn::body(const Runtime::CallingFrame &Frame,
+                                uint32_t Handle, uint32_t BufPtr,
+                                uint32_t BufLen) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  const auto Buf = MemInst->getSpan<const uint8_t>(BufPtr, BufLen);
+  if (Buf.size() != BufLen) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  auto It = Env.Processes.find(Handle);
+  if (It == Env.Processes.end() || It->second.StdIn == -1) {
+    return -EBADF;
+  }
+  return writePipe(It->second.StdIn, Buf);
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<int32_t> WasmEdgeProcessCloseStdIn::body(const Runtime::CallingFrame &,
+                                                uint32_t Handle) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  auto It = Env.Processes.find(Handle);
+  if (It == Env.Processes.end() || It->second.StdIn == -1) {
+    return -EBADF;
+  }
+  close(It->second.StdIn);
+  It->second.StdIn = -1;
+  return 0;
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<int32_t> WasmEdgeProcessRead::body(const Runtime::CallingFrame &Frame,
+                                          uint32_t Handle, uint32_t Stream,
+                                          uint32_t BufPtr, uint32_t BufLen) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  // Check memory instance from module.
+  auto *MemInst = Frame.getMemoryByIndex(0);
+  if (MemInst == nullptr) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+  const auto Buf = MemInst->getSpan<uint8_t>(BufPtr, BufLen);
+  if (Buf.size() != BufLen) {
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  auto It = Env.Processes.find(Handle);
+  if (It == Env.Processes.end()) {
+    return -EBADF;
+  }
+  int *FD;
+  switch (static_cast<ProcessEvent>(Stream)) {
+  case ProcessEvent::StdOut:
+    FD = &It->second.StdOut;
+    break;
+  case ProcessEvent::StdErr:
+    FD = &It->second.StdErr;
+    break;
+  default:
+    return -EINVAL;
+  }
+  if (*FD == -1) {
+    return 0;
+  }
+  const int32_t Res = readPipe(*FD, Buf);
+  if (Res == 0 && BufLen > 0) {
+    // End of the stream.
+    close(*FD);
+    *FD = -1;
+  }
+  return Res;
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<int32_t> WasmEdgeProcessWait::body(const Runtime::CallingFrame &,
+                                          uint32_t Handle, uint32_t Timeout) {
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  auto It = Env.Processes.find(Handle);
+  if (It == Env.Processes.end()) {
+    return -EBADF;
+  }
+  auto &Proc = It->second;
+  for (uint32_t Waited = 0;
+       !WasmEdgeProcessEnvironment::checkExited(Proc); ++Waited) {
+    if (Waited >= Timeout) {
+      return -ETIMEDOUT;
+    }
+    usleep(Env.DEFAULT_POLLTIME * 1000);
+  }
+  return Proc.ExitCode;
+#elif WASMEDGE_OS_WINDOWS
+  spdlog::error("wasmedge_process doesn't support windows now."sv);
+  return Unexpect(ErrCode::Value::HostFuncError);
+#endif
+}
+
+Expect<void> WasmEdgeProcessRelease::body(const Runtime::CallingFrame &,
+                                          uint32_t Handle) {
+  if (auto It = Env.Processes.find(Handle); It != Env.Processes.end()) {
+    WasmEdgeProcessEnvironment::releaseProcess(It->second);
+    Env.Processes.erase(It);
+  }
+  return {};
+}
+
 Expect<uint32_t>
 WasmEdgeProcessGetExitCode::body(const Runtime::CallingFrame &) {
   return Env.ExitCode;
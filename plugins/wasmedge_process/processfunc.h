@@ -62,6 +62,83 @@ public:
   Expect<uint32_t> body(const Runtime::CallingFrame &Frame);
 };
 
+/// Events of wasmedge_process_poll, and the streams of
+/// wasmedge_process_read.
+enum class ProcessEvent : uint32_t {
+  StdOut = 1,
+  StdErr = 2,
+  StdIn = 4,
+  Exited = 8,
+};
+
+/// Spawn the command set by the functions above as a long-lived process.
+/// Returns the handle, or a negative value on failure with the reason in the
+/// stderr buffer.
+class WasmEdgeProcessSpawn : public WasmEdgeProcess<WasmEdgeProcessSpawn> {
+public:
+  WasmEdgeProcessSpawn(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame);
+};
+
+/// Wait at most the timeout in milliseconds (-1 for infinite) for the pipes of
+/// the process. Returns the ready events.
+class WasmEdgeProcessPoll : public WasmEdgeProcess<WasmEdgeProcessPoll> {
+public:
+  WasmEdgeProcessPoll(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t Handle,
+                       int32_t Timeout);
+};
+
+/// Write into the stdin without blocking. Returns the written bytes, or the
+/// negative errno such as -EAGAIN.
+class WasmEdgeProcessWriteStdIn
+    : public WasmEdgeProcess<WasmEdgeProcessWriteStdIn> {
+public:
+  WasmEdgeProcessWriteStdIn(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t Handle,
+                       uint32_t BufPtr, uint32_t BufLen);
+};
+
+class WasmEdgeProcessCloseStdIn
+    : public WasmEdgeProcess<WasmEdgeProcessCloseStdIn> {
+public:
+  WasmEdgeProcessCloseStdIn(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t Handle);
+};
+
+/// Read the stdout or stderr without blocking. Returns the read bytes, 0 at
+/// the end of the stream, or the negative errno such as -EAGAIN.
+class WasmEdgeProcessRead : public WasmEdgeProcess<WasmEdgeProcessRead> {
+public:
+  WasmEdgeProcessRead(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t Handle,
+                       uint32_t Stream, uint32_t BufPtr, uint32_t BufLen);
+};
+
+/// Wait at most the timeout in milliseconds for the process to exit. Returns
+/// the exit code, or -ETIMEDOUT.
+class WasmEdgeProcessWait : public WasmEdgeProcess<WasmEdgeProcessWait> {
+public:
+  WasmEdgeProcessWait(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t Handle,
+                       uint32_t Timeout);
+};
+
+/// Kill the process if still running, and release the handle.
+class WasmEdgeProcessRelease
+    : public WasmEdgeProcess<WasmEdgeProcessRelease> {
+public:
+  WasmEdgeProcessRelease(WasmEdgeProcessEnvironment &HostEnv)
+      : WasmEdgeProcess(HostEnv) {}
+  Expect<void> body(const Runtime::CallingFrame &Frame, uint32_t Handle);
+};
+
 class WasmEdgeProcessGetExitCode
     : public WasmEdgeProcess<WasmEdgeProcessGetExitCode> {
 public:
@@ -33,6 +33,20 @@ WasmEdgeProcessModule::WasmEdgeProcessModule()
               std::make_unique<WasmEdgeProcessGetStdErrLen>(Env));
   addHostFunc("wasmedge_process_get_stderr",
               std::make_unique<WasmEdgeProcessGetStdErr>(Env));
+  addHostFunc("wasmedge_process_spawn",
+              std::make_unique<WasmEdgeProcessSpawn>(Env));
+  addHostFunc("wasmedge_process_poll",
+              std::make_unique<WasmEdgeProcessPoll>(Env));
+  addHostFunc("wasmedge_process_write_stdin",
+              std::make_unique<WasmEdgeProcessWriteStdIn>(Env));
+  addHostFunc("wasmedge_process_close_stdin",
+              std::make_unique<WasmEdgeProcessCloseStdIn>(Env));
+  addHostFunc("wasmedge_process_read",
+              std::make_unique<WasmEdgeProcessRead>(Env));
+  addHostFunc("wasmedge_process_wait",
+              std::make_unique<WasmEdgeProcessWait>(Env));
+  addHostFunc("wasmedge_process_release",
+              std::make_unique<WasmEdgeProcessRelease>(Env));
 }
 
 } // namespace Host
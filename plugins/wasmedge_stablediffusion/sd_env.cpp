@@ -4,6 +4,9 @@
 #include "sd_env.h"
 #include "sd_module.h"
 
+#include <new>
+#include <unordered_map>
+
 using namespace std::literals;
 
 namespace WasmEdge {
@@ -39,23 +42,75 @@ EXPORT_GET_DESCRIPTOR(Descriptor)
 
 namespace StableDiffusion {
 
-uint32_t SDEnviornment::addContext(sd_ctx_t *Ctx, int32_t Nthreads,
-                                   uint32_t Wtype) noexcept {
-  Contexts.push_back({Ctx, Nthreads, Wtype});
+namespace {
+struct ModelCache {
+  /// Held while loading, so that a model is loaded only once.
+  std::mutex Mutex;
+  std::unordered_map<std::string, std::shared_ptr<Model>> Models;
+};
+
+ModelCache &getModelCache() noexcept {
+  static ModelCache Cache;
+  return Cache;
+}
+} // namespace
+
+Model::~Model() noexcept { free_sd_ctx(Context); }
+
+std::shared_ptr<Model>
+Model::get(const std::string &Key,
+           const std::function<sd_ctx_t *()> &Load) noexcept {
+  auto &Cache = getModelCache();
+  std::unique_lock Lock(Cache.Mutex);
+  if (auto It = Cache.Models.find(Key); It != Cache.Models.end()) {
+    spdlog::debug("[WasmEdge-StableDiffusion] Reuse the loaded model."sv);
+    return It->second;
+  }
+
+  sd_ctx_t *Ctx = Load();
+  if (Ctx == nullptr) {
+    return {};
+  }
+  try {
+    std::shared_ptr<Model> Mod(new Model(Ctx));
+    // Unload the models not used by any session, keeping the last ones.
+    size_t Idle = 0;
+    for (const auto &[_, M] : Cache.Models) {
+      Idle += M.use_count() == 1 ? 1 : 0;
+    }
+    for (auto It = Cache.Models.begin();
+         It != Cache.Models.end() && Idle >= kMaxIdle;) {
+      if (It->second.use_count() == 1) {
+        It = Cache.Models.erase(It);
+        --Idle;
+      } else {
+        ++It;
+      }
+    }
+    Cache.Models.emplace(Key, Mod);
+    return Mod;
+  } catch (std::bad_alloc &) {
+    free_sd_ctx(Ctx);
+    return {};
+  }
+}
+
+uint32_t SDEnviornment::addContext(std::shared_ptr<Model> Mod,
+                                   int32_t Nthreads, uint32_t Wtype) noexcept {
+  Contexts.push_back({std::move(Mod), Nthreads, Wtype});
   return Contexts.size() - 1;
 }
 
 void SDEnviornment::freeContext(const uint32_t Id) noexcept {
-  sd_ctx_t *SDCtx = Contexts[Id].Context;
-  free_sd_ctx(SDCtx);
-  Contexts.erase(Contexts.begin() + Id - 1);
+  // Keep the IDs of the other sessions. The model is unloaded by the cache.
+  Contexts[Id].Mod.reset();
 }
 
-sd_ctx_t *SDEnviornment::getContext(const uint32_t Id) noexcept {
+Model *SDEnviornment::getContext(const uint32_t Id) noexcept {
   if (Id >= Contexts.size()) {
     return nullptr;
   }
-  return Contexts[Id].Context;
+  return Contexts[Id].Mod.get();
 }
 
 void SBLog(enum sd_log_level_t Level, const char *Log, void *) {
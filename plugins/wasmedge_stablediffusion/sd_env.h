@@ -6,6 +6,11 @@
 #include "stable-diffusion.h"
 
 #include "plugin/plugin.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace WasmEdge {
@@ -23,8 +28,38 @@ enum class ErrNo : uint32_t {
   RuntimeError = 5,    // Runtime Error.
 };
 
-struct ContextInfo {
+/// Loaded model shared by the sessions of all the VMs created with the same
+/// parameters. The generations on a model are serialized.
+class Model {
+public:
+  Model(const Model &) = delete;
+  Model &operator=(const Model &) = delete;
+  ~Model() noexcept;
+
+  /// Get the loaded model of the parameters in the key, or load it by the
+  /// function at the first time.
+  ///
+  /// @param[in] Key The paths and the options the model is created with.
+  /// @param[in] Load The function to create the model context.
+  /// @return The shared model, or nullptr if the loading failed.
+  static std::shared_ptr<Model>
+  get(const std::string &Key, const std::function<sd_ctx_t *()> &Load) noexcept;
+
+  sd_ctx_t *getContext() const noexcept { return Context; }
+  std::mutex &getMutex() noexcept { return Mutex; }
+
+private:
+  /// Maximum models kept loaded when not used by any session.
+  static inline constexpr const size_t kMaxIdle = 2;
+
+  explicit Model(sd_ctx_t *Ctx) noexcept : Context(Ctx) {}
+
   sd_ctx_t *Context;
+  std::mutex Mutex;
+};
+
+struct ContextInfo {
+  std::shared_ptr<Model> Mod;
   int32_t NThreads;
   uint32_t Wtype;
 };
@@ -36,9 +71,10 @@ public:
       sd_set_log_callback(SBLog, nullptr);
     }
   };
-  uint32_t addContext(sd_ctx_t *Ctx, int32_t Nthreads, uint32_t Wtype) noexcept;
+  uint32_t addContext(std::shared_ptr<Model> Mod, int32_t Nthreads,
+                      uint32_t Wtype) noexcept;
   void freeContext(const uint32_t Id) noexcept;
-  sd_ctx_t *getContext(const uint32_t Id) noexcept;
+  Model *getContext(const uint32_t Id) noexcept;
   size_t getContextSize() noexcept { return Contexts.size(); }
   int32_t getNThreads(const uint32_t Id) noexcept {
     return Contexts[Id].NThreads;
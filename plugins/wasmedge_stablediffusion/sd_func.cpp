@@ -7,6 +7,10 @@
 #include "spdlog/spdlog.h"
 #include "stable-diffusion.h"
 
+#include <fstream>
+#include <mutex>
+#include <string>
+
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
 #include "stb_image.h"
@@ -157,52 +161,61 @@ void upscalerModel(const char *UpscaleModelPath, uint32_t UpscaleRepeats,
   free(UpscalerCtx);
 }
 
+/// Encode the images of the batch once, and write them to the output files
+/// and back to back into the output buffer. Each image in the buffer is a
+/// complete PNG stream, so the guest can split them at the IEND chunks.
 bool saveResults(sd_image_t *Results, uint32_t BatchCount,
-                 std::string OutputPath, uint32_t OutputPathLen,
-                 uint32_t *BytesWritten, uint32_t OutBufferMaxSize,
-                 uint8_t *OutputBufferSpanPtr) {
-  int Len;
-  unsigned char *Png = stbi_write_png_to_mem(
-      reinterpret_cast<const unsigned char *>(Results), 0, Results->width,
-      Results->height, Results->channel, &Len, nullptr);
-  if (OutputPathLen != 0) {
-    size_t Last = OutputPath.find_last_of(".");
-    std::string DummyName = OutputPath;
-    std::string Extension = ".png";
-    if (Last != std::string::npos) {
-      std::string LastStr = OutputPath.substr(Last);
-      if (LastStr == ".png" || LastStr == ".PNG") {
-        DummyName = OutputPath.substr(0, Last);
-        Extension = LastStr;
-      }
+                 const std::string &OutputPath, uint32_t *BytesWritten,
+                 Span<uint8_t> OutputBuffer) {
+  std::string DummyName = OutputPath;
+  std::string Extension = ".png";
+  if (size_t Last = OutputPath.find_last_of("."); Last != std::string::npos) {
+    std::string LastStr = OutputPath.substr(Last);
+    if (LastStr == ".png" || LastStr == ".PNG") {
+      DummyName = OutputPath.substr(0, Last);
+      Extension = LastStr;
     }
-    for (uint32_t I = 0; I < BatchCount; I++) {
-      if (Results[I].data != nullptr) {
-        std::string FinalImagePath;
-        if (I <= 0)
-          FinalImagePath = DummyName + Extension;
-        else
-          FinalImagePath += "_" + std::to_string(I + 1) + Extension;
-        stbi_write_png(FinalImagePath.c_str(), Results[I].width,
-                       Results[I].height, Results[I].channel, Results[I].data,
-                       0, nullptr);
-        spdlog::info("[WasmEdge-StableDiffusion] Save result image to {}."sv,
-                     FinalImagePath.c_str());
-        free(Results[I].data);
-        Results[I].data = nullptr;
+  }
+  uint64_t Total = 0;
+  for (uint32_t I = 0; I < BatchCount; I++) {
+    if (Results[I].data == nullptr) {
+      continue;
+    }
+    int Len = 0;
+    unsigned char *Png =
+        stbi_write_png_to_mem(Results[I].data, 0, Results[I].width,
+                              Results[I].height, Results[I].channel, &Len,
+                              nullptr);
+    free(Results[I].data);
+    Results[I].data = nullptr;
+    if (Png == nullptr) {
+      spdlog::error("[WasmEdge-StableDiffusion] Encode result image failed."sv);
+      continue;
+    }
+    if (!OutputPath.empty()) {
+      std::string FinalImagePath = DummyName;
+      if (I > 0) {
+        FinalImagePath += "_" + std::to_string(I + 1);
       }
+      FinalImagePath += Extension;
+      std::ofstream Fout(FinalImagePath, std::ios::out | std::ios::binary);
+      Fout.write(reinterpret_cast<const char *>(Png), Len);
+      spdlog::info("[WasmEdge-StableDiffusion] Save result image to {}."sv,
+                   FinalImagePath);
     }
+    if (Total + Len <= OutputBuffer.size()) {
+      std::copy_n(Png, Len, OutputBuffer.data() + Total);
+    }
+    Total += Len;
+    free(Png);
   }
-  *BytesWritten = Len;
-  if (OutBufferMaxSize < *BytesWritten) {
+  free(Results);
+  // Report the size needed if the buffer is not enough.
+  *BytesWritten = static_cast<uint32_t>(Total);
+  if (OutputBuffer.size() < Total) {
     spdlog::error("[WasmEdge-StableDiffusion] Output buffer is not enough."sv);
-    free(Png);
-    free(Results);
     return false;
   }
-  std::copy_n(Png, *BytesWritten, OutputBufferSpanPtr);
-  free(Png);
-  free(Results);
   return true;
 }
 
@@ -325,22 +338,42 @@ Expect<uint32_t> SDCreateContext::body(
         "[WasmEdge-StableDiffusion] The following arguments are required: ModelPath / DiffusionModelPath"sv);
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
+  // The sessions created with the same parameters share the loaded model,
+  // also across the VMs.
+  std::string Key;
+  for (const auto *Path :
+       {&ModelPath, &clipLPath, &clipGPath, &t5xxlPath, &diffusionModelPath,
+        &VaePath, &TaesdPath, &ControlNetPath, &LoraModelDir, &EmbedDir,
+        &IdEmbedDir}) {
+    Key += *Path;
+    Key.push_back('\0');
+  }
+  for (const auto Option :
+       {VaeDecodeOnly, VaeTiling, static_cast<uint32_t>(NThreads), Wtype,
+        RngType, Schedule, ClipOnCpu, ControlNetCpu, VaeOnCpu,
+        DiffusionFlashAttn}) {
+    Key += std::to_string(Option);
+    Key.push_back('\0');
+  }
   // Create context and import graph.
-  spdlog::debug("[WasmEdge-StableDiffusion] Create context."sv);
-  sd_ctx_t *Ctx = new_sd_ctx(
-      ModelPath.data(), clipLPath.data(), clipGPath.data(), t5xxlPath.data(),
-      diffusionModelPath.data(), VaePath.data(), TaesdPath.data(),
-      ControlNetPath.data(), LoraModelDir.data(), EmbedDir.data(),
-      IdEmbedDir.data(), static_cast<bool>(VaeDecodeOnly),
-      static_cast<bool>(VaeTiling), false, NThreads,
-      static_cast<sd_type_t>(Wtype), static_cast<rng_type_t>(RngType),
-      static_cast<schedule_t>(Schedule), ClipOnCpu, ControlNetCpu, VaeOnCpu,
-      DiffusionFlashAttn);
-  if (Ctx == nullptr) {
+  auto Mod = Model::get(Key, [&]() {
+    spdlog::debug("[WasmEdge-StableDiffusion] Create context."sv);
+    return new_sd_ctx(
+        ModelPath.data(), clipLPath.data(), clipGPath.data(), t5xxlPath.data(),
+        diffusionModelPath.data(), VaePath.data(), TaesdPath.data(),
+        ControlNetPath.data(), LoraModelDir.data(), EmbedDir.data(),
+        IdEmbedDir.data(), static_cast<bool>(VaeDecodeOnly),
+        static_cast<bool>(VaeTiling), false, NThreads,
+        static_cast<sd_type_t>(Wtype), static_cast<rng_type_t>(RngType),
+        static_cast<schedule_t>(Schedule), ClipOnCpu, ControlNetCpu, VaeOnCpu,
+        DiffusionFlashAttn);
+  });
+  if (Mod == nullptr) {
     spdlog::error("[WasmEdge-StableDiffusion] Failed to create context."sv);
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
-  *SessionId = Env.addContext(Ctx, NThreads, static_cast<sd_type_t>(Wtype));
+  *SessionId = Env.addContext(std::move(Mod), NThreads,
+                              static_cast<sd_type_t>(Wtype));
   return static_cast<uint32_t>(ErrNo::Success);
 }
 
@@ -399,14 +432,19 @@ Expect<uint32_t> SDTextToImage::body(
     ControlImage =
         readControlImage(ControlImageSpan, Width, Height, CannyPreprocess);
   }
-  // Generate images
+  // Generate images. The prompt is encoded once for the whole batch, and the
+  // images of the batch use the successive seeds.
   spdlog::info("[WasmEdge-StableDiffusion] Start to generate image."sv);
-  Results = txt2img(
-      SDCtx, Prompt.data(), NegativePrompt.data(), ClipSkip, CfgScale, Guidance,
-      Width, Height, sample_method_t(SampleMethod), SampleSteps, Seed,
-      BatchCount, ControlImage, ControlStrength, StyleRatio, NormalizeInput,
-      InputIdImagesDir.data(), SkipLayersSpan.data(), SkipLayersSpan.size(),
-      SlgScale, SkipLayerStart, SkipLayerEnd);
+  {
+    std::unique_lock Lock(SDCtx->getMutex());
+    Results = txt2img(SDCtx->getContext(), Prompt.data(), NegativePrompt.data(),
+                      ClipSkip, CfgScale, Guidance, Width, Height,
+                      sample_method_t(SampleMethod), SampleSteps, Seed,
+                      BatchCount, ControlImage, ControlStrength, StyleRatio,
+                      NormalizeInput, InputIdImagesDir.data(),
+                      SkipLayersSpan.data(), SkipLayersSpan.size(), SlgScale,
+                      SkipLayerStart, SkipLayerEnd);
+  }
   free(ControlImage);
   if (Results == nullptr) {
     spdlog::error("[WasmEdge-StableDiffusion] Generate failed."sv);
@@ -424,8 +462,8 @@ Expect<uint32_t> SDTextToImage::body(
                   Env.getNThreads(SessionId), BatchCount, Results);
   }
   // Save results
-  if (!saveResults(Results, BatchCount, OutputPath, OutputPathLen, BytesWritten,
-                   OutBufferMaxSize, OutputBufferSpan.data())) {
+  if (!saveResults(Results, BatchCount, OutputPath, BytesWritten,
+                   OutputBufferSpan)) {
     return static_cast<uint32_t>(ErrNo::RuntimeError);
   }
   return static_cast<uint32_t>(ErrNo::Success);
@@ -554,13 +592,17 @@ Expect<uint32_t> SDImageToImage::body(
   // Generate images
   sd_image_t *Results = nullptr;
   spdlog::info("[WasmEdge-StableDiffusion] Start to generate image."sv);
-  Results =
-      img2img(SDCtx, InputImage, MaskImage, Prompt.data(),
-              NegativePrompt.data(), ClipSkip, CfgScale, Guidance, Width,
-              Height, sample_method_t(SampleMethod), SampleSteps, Strength,
-              Seed, BatchCount, ControlImage, ControlStrength, StyleRatio,
-              NormalizeInput, InputIdImagesDir.data(), SkipLayersSpan.data(),
-              SkipLayersSpan.size(), SlgScale, SkipLayerStart, SkipLayerEnd);
+  {
+    std::unique_lock Lock(SDCtx->getMutex());
+    Results = img2img(SDCtx->getContext(), InputImage, MaskImage,
+                      Prompt.data(), NegativePrompt.data(), ClipSkip, CfgScale,
+                      Guidance, Width, Height, sample_method_t(SampleMethod),
+                      SampleSteps, Strength, Seed, BatchCount, ControlImage,
+                      ControlStrength, StyleRatio, NormalizeInput,
+                      InputIdImagesDir.data(), SkipLayersSpan.data(),
+                      SkipLayersSpan.size(), SlgScale, SkipLayerStart,
+                      SkipLayerEnd);
+  }
   free(ControlImage);
   free(InputImageBuffer);
   if (Results == nullptr) {
@@ -579,8 +621,8 @@ Expect<uint32_t> SDImageToImage::body(
                   Env.getNThreads(SessionId), BatchCount, Results);
   }
   // Save results
-  if (!saveResults(Results, BatchCount, OutputPath, OutputPathLen, BytesWritten,
-                   OutBufferMaxSize, OutputBufferSpan.data())) {
+  if (!saveResults(Results, BatchCount, OutputPath, BytesWritten,
+                   OutputBufferSpan)) {
     return static_cast<uint32_t>(ErrNo::RuntimeError);
   }
   return static_cast<uint32_t>(ErrNo::Success);
@@ -4,10 +4,143 @@
 #include "tensorflow_env.h"
 #include "tensorflow_module.h"
 
+#include "common/spdlog.h"
+
+#include <mutex>
+#include <new>
+
 namespace WasmEdge {
 namespace Host {
 
+using namespace std::literals::string_view_literals;
+
+namespace WasmEdgeTensorflow {
+
+PO::Option<PO::Toggle> TFEnv::ZeroCopyInputs(PO::Description(
+    "Wrap the Tensorflow input tensors over the guest memory instead of copying them. The guest should keep the input buffers unchanged until the session runs."sv));
+
 namespace {
+struct ModelCache {
+  std::mutex Mutex;
+  /// Models by their keys.
+  std::unordered_map<std::string, std::shared_ptr<Model>> Models;
+};
+
+ModelCache &getModelCache() noexcept {
+  static ModelCache Cache;
+  return Cache;
+}
+} // namespace
+
+Model::~Model() noexcept {
+  TF_Status *Stat = TF_NewStatus();
+  if (Session) {
+    TF_CloseSession(Session, Stat);
+    TF_DeleteSession(Session, Stat);
+  }
+  TF_DeleteStatus(Stat);
+  if (SessionOpts) {
+    TF_DeleteSessionOptions(SessionOpts);
+  }
+  if (Graph) {
+    TF_DeleteGraph(Graph);
+  }
+}
+
+template <typename LoaderT>
+std::shared_ptr<Model> Model::getOrLoad(std::string Key,
+                                        LoaderT &&Loader) noexcept {
+  auto &Cache = getModelCache();
+  std::unique_lock Lock(Cache.Mutex);
+  if (auto It = Cache.Models.find(Key); It != Cache.Models.end()) {
+    return It->second;
+  }
+
+  try {
+    std::shared_ptr<Model> Mod(new Model());
+    Mod->Graph = TF_NewGraph();
+    Mod->SessionOpts = TF_NewSessionOptions();
+    TF_Status *Stat = TF_NewStatus();
+    Mod->Session = Loader(*Mod, Stat);
+    if (unlikely(TF_GetCode(Stat) != TF_OK)) {
+      spdlog::error("[WasmEdge-Tensorflow] Unable to create session: {}"sv,
+                    TF_Message(Stat));
+      TF_DeleteStatus(Stat);
+      return {};
+    }
+    TF_DeleteStatus(Stat);
+    // Drop the models not used by any session.
+    if (Cache.Models.size() >= kMaxModels) {
+      for (auto It = Cache.Models.begin(); It != Cache.Models.end();) {
+        if (It->second.use_count() == 1) {
+          It = Cache.Models.erase(It);
+        } else {
+          ++It;
+        }
+      }
+    }
+    Mod->Key = std::move(Key);
+    Cache.Models.emplace(Mod->Key, Mod);
+    return Mod;
+  } catch (std::bad_alloc &) {
+    return {};
+  }
+}
+
+std::shared_ptr<Model> Model::get(Span<const char> Buffer) noexcept {
+  try {
+    std::string Key(1, 'G');
+    Key.append(Buffer.data(), Buffer.size());
+    return getOrLoad(std::move(Key), [&](Model &Mod, TF_Status *Stat) {
+      TF_Buffer *GraphDef =
+          TF_NewBufferFromString(Buffer.data(), Buffer.size());
+      TF_ImportGraphDefOptions *Opts = TF_NewImportGraphDefOptions();
+      TF_GraphImportGraphDef(Mod.Graph, GraphDef, Opts, Stat);
+      TF_DeleteImportGraphDefOptions(Opts);
+      TF_DeleteBuffer(GraphDef);
+      if (unlikely(TF_GetCode(Stat) != TF_OK)) {
+        return static_cast<TF_Session *>(nullptr);
+      }
+      return TF_NewSession(Mod.Graph, Mod.SessionOpts, Stat);
+    });
+  } catch (std::bad_alloc &) {
+    return {};
+  }
+}
+
+std::shared_ptr<Model>
+Model::getSavedModel(std::string_view Path,
+                     Span<const std::string> Tags) noexcept {
+  try {
+    std::string Key(1, 'S');
+    Key.append(Path);
+    std::vector<const char *> TagsArgv;
+    TagsArgv.reserve(Tags.size());
+    for (const auto &Tag : Tags) {
+      Key.push_back('\0');
+      Key.append(Tag);
+      TagsArgv.push_back(Tag.c_str());
+    }
+    const std::string PathStr(Path);
+    return getOrLoad(std::move(Key), [&](Model &Mod, TF_Status *Stat) {
+      return TF_LoadSessionFromSavedModel(
+          Mod.SessionOpts, nullptr, PathStr.c_str(), TagsArgv.data(),
+          static_cast<int>(TagsArgv.size()), Mod.Graph, nullptr, Stat);
+    });
+  } catch (std::bad_alloc &) {
+    return {};
+  }
+}
+
+} // namespace WasmEdgeTensorflow
+
+namespace {
+
+void addOptions(const Plugin::Plugin::PluginDescriptor *,
+                PO::ArgumentParser &Parser) noexcept {
+  Parser.add_option("tf-zero-copy-inputs"sv,
+                    WasmEdgeTensorflow::TFEnv::ZeroCopyInputs);
+}
 
 Runtime::Instance::ModuleInstance *
 create(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
@@ -29,7 +162,7 @@ Plugin::Plugin::PluginDescriptor Descriptor{
                 .Create = create,
             },
         },
-    .AddOptions = nullptr,
+    .AddOptions = addOptions,
 };
 
 EXPORT_GET_DESCRIPTOR(Descriptor)
@@ -3,11 +3,16 @@
 
 #pragma once
 
+#include "common/span.h"
 #include "plugin/plugin.h"
+#include "po/option.h"
 
 #include "tensorflow/c/c_api.h"
 
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -26,6 +31,44 @@ enum class ErrNo : uint32_t {
   RuntimeError = 5,    // Runtime Error.
 };
 
+/// Graph with its session, loaded once and shared by the sessions of the same
+/// model across the VMs. The sessions of TensorFlow can run concurrently.
+class Model {
+public:
+  Model(const Model &) = delete;
+  Model &operator=(const Model &) = delete;
+  ~Model() noexcept;
+
+  /// Get the model of the graph def buffer, which is imported at the first
+  /// time.
+  static std::shared_ptr<Model> get(Span<const char> Buffer) noexcept;
+
+  /// Get the model of the saved model directory with the tags, which is
+  /// loaded at the first time.
+  static std::shared_ptr<Model>
+  getSavedModel(std::string_view Path, Span<const std::string> Tags) noexcept;
+
+  TF_Graph *getGraph() const noexcept { return Graph; }
+  TF_Session *getSession() const noexcept { return Session; }
+
+private:
+  /// Maximum models kept by the cache when not used by any session.
+  static inline constexpr const size_t kMaxModels = 16;
+
+  Model() noexcept = default;
+
+  /// Find the model of the key in the cache, or load and cache it.
+  template <typename LoaderT>
+  static std::shared_ptr<Model> getOrLoad(std::string Key,
+                                          LoaderT &&Loader) noexcept;
+
+  /// The graph def bytes, or the saved model path and tags.
+  std::string Key;
+  TF_Graph *Graph = nullptr;
+  TF_SessionOptions *SessionOpts = nullptr;
+  TF_Session *Session = nullptr;
+};
+
 struct TensorList {
   void reset() noexcept {
     for (uint32_t I = 0; I < DataList.size(); ++I) {
@@ -45,9 +88,14 @@ struct TensorList {
 
 struct Context {
   Context() noexcept { Stat = TF_NewStatus(); }
+  Context(Context &&RHS) noexcept
+      : Stat(std::exchange(RHS.Stat, nullptr)), Mod(std::move(RHS.Mod)),
+        Inputs(std::move(RHS.Inputs)), Outputs(std::move(RHS.Outputs)) {}
   ~Context() noexcept {
     reset();
-    TF_DeleteStatus(Stat);
+    if (Stat) {
+      TF_DeleteStatus(Stat);
+    }
   }
 
   void clearInputs() noexcept { Inputs.reset(); }
@@ -55,42 +103,24 @@ struct Context {
   void clearOutputs() noexcept { Outputs.reset(); }
 
   void reset() noexcept {
-    if (GraphOpts) {
-      TF_DeleteImportGraphDefOptions(GraphOpts);
-      GraphOpts = nullptr;
-    }
-    if (Buffer) {
-      TF_DeleteBuffer(Buffer);
-      Buffer = nullptr;
-    }
-    if (Graph) {
-      TF_DeleteGraph(Graph);
-      Graph = nullptr;
-    }
-    if (SessionOpts) {
-      TF_DeleteSessionOptions(SessionOpts);
-      SessionOpts = nullptr;
-    }
-    if (Session) {
-      TF_CloseSession(Session, Stat);
-      TF_DeleteSession(Session, Stat);
-      Session = nullptr;
-    }
+    Mod.reset();
     clearInputs();
     clearOutputs();
   }
 
+  TF_Graph *getGraph() const noexcept { return Mod->getGraph(); }
+  TF_Session *getSession() const noexcept { return Mod->getSession(); }
+
   TF_Status *Stat;
-  TF_ImportGraphDefOptions *GraphOpts = nullptr;
-  TF_Buffer *Buffer = nullptr;
-  TF_Graph *Graph = nullptr;
-  TF_SessionOptions *SessionOpts = nullptr;
-  TF_Session *Session = nullptr;
+  std::shared_ptr<Model> Mod;
   struct TensorList Inputs;
   struct TensorList Outputs;
 };
 
 struct TFEnv {
+  /// Wrap the input tensors over the guest memory instead of copying them.
+  static PO::Option<PO::Toggle> ZeroCopyInputs;
+
   TFEnv() noexcept { TFContext.reserve(16U); }
 
   Context *getContext(const uint32_t ID) noexcept {
@@ -68,6 +68,25 @@ std::pair<std::string, int> parseIndex(std::string_view Name) {
   return std::make_pair(NameStr, Idx);
 }
 
+/// Check if the tensor can be reused for the input of the same shape.
+bool isReusable(TF_Tensor *Tensor, uint32_t DataType, Span<const int64_t> Dims,
+                uint32_t Len) noexcept {
+  // The buffers shared with the other tensors, such as the outputs of the
+  // last run, cannot be overwritten.
+  if (TF_TensorMaybeMove(Tensor) == nullptr ||
+      TF_TensorType(Tensor) != static_cast<TF_DataType>(DataType) ||
+      TF_TensorByteSize(Tensor) != Len ||
+      TF_NumDims(Tensor) != static_cast<int>(Dims.size())) {
+    return false;
+  }
+  for (size_t I = 0; I < Dims.size(); ++I) {
+    if (TF_Dim(Tensor, static_cast<int>(I)) != Dims[I]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 Expect<uint32_t> CreateSession::body(const Runtime::CallingFrame &Frame,
@@ -84,28 +103,14 @@ Expect<uint32_t> CreateSession::body(const Runtime::CallingFrame &Frame,
   MEM_PTR_CHECK(SessionId, MemInst, uint32_t, SessionIdPtr,
                 "Failed when accessing the return SessionID memory."sv)
 
-  // Create context and import graph.
+  // Create context and get the shared graph and session of the model.
   uint32_t NewID = Env.newContext();
   SESSION_CHECK(Cxt, NewID, "Failed when allocating resources."sv,
                 ErrNo::MissingMemory)
 
-  Cxt->Graph = TF_NewGraph();
-  Cxt->Buffer = TF_NewBufferFromString(ModBufSpan.data(), ModBufLen);
-  Cxt->GraphOpts = TF_NewImportGraphDefOptions();
-  TF_GraphImportGraphDef(Cxt->Graph, Cxt->Buffer, Cxt->GraphOpts, Cxt->Stat);
-  if (unlikely(TF_GetCode(Cxt->Stat) != TF_OK)) {
-    spdlog::error("[WasmEdge-Tensorflow] Cannot import graph from buffer: {}"sv,
-                  TF_Message(Cxt->Stat));
-    Env.deleteContext(NewID);
-    return static_cast<uint32_t>(ErrNo::InvalidArgument);
-  }
-
-  // Create session.
-  Cxt->SessionOpts = TF_NewSessionOptions();
-  Cxt->Session = TF_NewSession(Cxt->Graph, Cxt->SessionOpts, Cxt->Stat);
-  if (unlikely(TF_GetCode(Cxt->Stat) != TF_OK)) {
-    spdlog::error("[WasmEdge-Tensorflow] Unable to create session: {}"sv,
-                  TF_Message(Cxt->Stat));
+  Cxt->Mod = Model::get(ModBufSpan);
+  if (unlikely(!Cxt->Mod)) {
+    spdlog::error("[WasmEdge-Tensorflow] Cannot import graph from buffer."sv);
     Env.deleteContext(NewID);
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
@@ -134,9 +139,7 @@ Expect<uint32_t> CreateSessionSavedModel::body(
 
   // Check the elements of tags.
   std::vector<std::string> Tags;
-  std::vector<const char *> TagsArgv;
   Tags.reserve(TagsBufLen);
-  TagsArgv.reserve(TagsBufLen);
   for (size_t I = 0; I < TagSpan.size(); ++I) {
     // Should use std::string to copy the tag name here to prevent from no
     // null-termination of the tag strings here.
@@ -144,7 +147,6 @@ Expect<uint32_t> CreateSessionSavedModel::body(
     MEM_SV_CHECK(TagNameSV, MemInst, Tag.Ptr, Tag.Len,
                  "Failed when accessing the tag name memory."sv)
     Tags.emplace_back(TagNameSV);
-    TagsArgv.emplace_back(Tags.back().c_str());
   }
 
   // Check the return value: SessionIdPtr should be valid.
@@ -156,16 +158,9 @@ Expect<uint32_t> CreateSessionSavedModel::body(
   SESSION_CHECK(Cxt, NewID, "Failed when allocating resources."sv,
                 ErrNo::MissingMemory)
 
-  // Create session.
-  Cxt->Graph = TF_NewGraph();
-  Cxt->GraphOpts = TF_NewImportGraphDefOptions();
-  Cxt->SessionOpts = TF_NewSessionOptions();
-  Cxt->Session = TF_LoadSessionFromSavedModel(
-      Cxt->SessionOpts, nullptr, std::string(PathSV).c_str(), TagsArgv.data(),
-      TagsArgv.size(), Cxt->Graph, nullptr, Cxt->Stat);
-  if (unlikely(TF_GetCode(Cxt->Stat) != TF_OK)) {
-    spdlog::error("[WasmEdge-Tensorflow] Unable to create session: {}"sv,
-                  TF_Message(Cxt->Stat));
+  // Get the shared graph and session of the saved model.
+  Cxt->Mod = Model::getSavedModel(PathSV, Tags);
+  if (unlikely(!Cxt->Mod)) {
     Env.deleteContext(NewID);
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
@@ -193,7 +188,7 @@ Expect<uint32_t> RunSession::body(const Runtime::CallingFrame &,
   }
 
   // Run session
-  TF_SessionRun(Cxt->Session,
+  TF_SessionRun(Cxt->getSession(),
                 // RunOptions
                 nullptr,
                 // Input tensors
@@ -338,7 +333,7 @@ Expect<uint32_t> AppendInput::body(const Runtime::CallingFrame &Frame,
   // Check the input operation.
   auto OperKeyPair = parseIndex(NameSV);
   TF_Operation *Operation =
-      TF_GraphOperationByName(Cxt->Graph, OperKeyPair.first.c_str());
+      TF_GraphOperationByName(Cxt->getGraph(), OperKeyPair.first.c_str());
   if (unlikely(Operation == nullptr)) {
     spdlog::error("[WasmEdge-Tensorflow] Input operation {} not found."sv,
                   NameSV);
@@ -352,9 +347,26 @@ Expect<uint32_t> AppendInput::body(const Runtime::CallingFrame &Frame,
     TensorId = It->second;
   }
 
-  // Create the tensor and copy data from buffer.
+  // Reuse the old input tensor of the same shape, or wrap the guest memory if
+  // enabled, or create the tensor and copy data from buffer.
   TF_Tensor *Tensor = nullptr;
-  if (DimCnt > 0) {
+  if (!TFEnv::ZeroCopyInputs.value() && It != Cxt->Inputs.NameMap.end() &&
+      isReusable(Cxt->Inputs.DataList[TensorId], DataType, DimBufSpan,
+                 TensorBufLen)) {
+    std::copy_n(TensorBufSpan.begin(), TensorBufLen,
+                static_cast<uint8_t *>(
+                    TF_TensorData(Cxt->Inputs.DataList[TensorId])));
+    return static_cast<uint32_t>(ErrNo::Success);
+  }
+  if (TFEnv::ZeroCopyInputs.value()) {
+    // The guest memory is not owned by the tensor. TensorFlow copies the
+    // buffer itself if it is not aligned.
+    Tensor = TF_NewTensor(
+        static_cast<TF_DataType>(DataType),
+        DimCnt > 0 ? DimBufSpan.data() : nullptr, static_cast<int>(DimCnt),
+        TensorBufSpan.data(), TensorBufLen, [](void *, size_t, void *) {},
+        nullptr);
+  } else if (DimCnt > 0) {
     Tensor = TF_AllocateTensor(static_cast<TF_DataType>(DataType),
                                DimBufSpan.data(), DimCnt, TensorBufLen);
   } else {
@@ -365,8 +377,10 @@ Expect<uint32_t> AppendInput::body(const Runtime::CallingFrame &Frame,
     spdlog::error("[WasmEdge-Tensorflow] Allocate input tensor failed."sv);
     return static_cast<uint32_t>(ErrNo::Busy);
   }
-  std::copy_n(TensorBufSpan.begin(), TensorBufLen,
-              static_cast<uint8_t *>(TF_TensorData(Tensor)));
+  if (!TFEnv::ZeroCopyInputs.value()) {
+    std::copy_n(TensorBufSpan.begin(), TensorBufLen,
+                static_cast<uint8_t *>(TF_TensorData(Tensor)));
+  }
 
   // If the old input tensor exists, delete the old one.
   if (It != Cxt->Inputs.NameMap.end()) {
@@ -396,7 +410,7 @@ Expect<uint32_t> AppendOutput::body(const Runtime::CallingFrame &Frame,
   // Check the output operation.
   auto OperKeyPair = parseIndex(NameSV);
   TF_Operation *Operation =
-      TF_GraphOperationByName(Cxt->Graph, OperKeyPair.first.c_str());
+      TF_GraphOperationByName(Cxt->getGraph(), OperKeyPair.first.c_str());
   if (unlikely(Operation == nullptr)) {
     spdlog::error("[WasmEdge-Tensorflow] Output operation {} not found."sv,
                   NameSV);
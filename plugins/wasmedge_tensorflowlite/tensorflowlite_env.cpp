@@ -4,10 +4,154 @@
 #include "tensorflowlite_env.h"
 #include "tensorflowlite_module.h"
 
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+
+#include <functional>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
 namespace WasmEdge {
 namespace Host {
 
+using namespace std::literals::string_view_literals;
+
+namespace WasmEdgeTensorflowLite {
+
+PO::Option<int32_t> TFLiteEnv::NumThreads(
+    PO::Description("Threads of the TFLite interpreters."sv),
+    PO::MetaVar("THREADS"sv), PO::DefaultValue<int32_t>(2));
+
+PO::Option<PO::Toggle> TFLiteEnv::XNNPack(PO::Description(
+    "Run the TFLite interpreters with the XNNPACK delegate, which uses the same threads."sv));
+
 namespace {
+struct ModelCache {
+  std::mutex Mutex;
+  /// Models by the hashes of the buffers.
+  std::unordered_multimap<size_t, std::shared_ptr<Model>> Models;
+};
+
+ModelCache &getModelCache() noexcept {
+  static ModelCache Cache;
+  return Cache;
+}
+
+void destroy(Interpreter &Interp) noexcept {
+  if (Interp.Interp) {
+    TfLiteInterpreterDelete(Interp.Interp);
+  }
+  if (Interp.Delegate) {
+    TfLiteXNNPackDelegateDelete(Interp.Delegate);
+  }
+  Interp = {};
+}
+} // namespace
+
+Model::~Model() noexcept {
+  for (auto &Interp : Idle) {
+    destroy(Interp);
+  }
+  if (Handle) {
+    TfLiteModelDelete(Handle);
+  }
+}
+
+std::shared_ptr<Model> Model::get(Span<const char> Buffer) noexcept {
+  const std::string_view Bytes(Buffer.data(), Buffer.size());
+  const size_t Hash = std::hash<std::string_view>{}(Bytes);
+  auto &Cache = getModelCache();
+  std::unique_lock Lock(Cache.Mutex);
+  auto [Begin, End] = Cache.Models.equal_range(Hash);
+  for (auto It = Begin; It != End; ++It) {
+    const auto &Data = It->second->Data;
+    if (std::string_view(Data.data(), Data.size()) == Bytes) {
+      return It->second;
+    }
+  }
+
+  try {
+    std::shared_ptr<Model> Mod(new Model());
+    Mod->Data.assign(Bytes.begin(), Bytes.end());
+    Mod->Handle = TfLiteModelCreate(Mod->Data.data(), Mod->Data.size());
+    if (unlikely(Mod->Handle == nullptr)) {
+      return {};
+    }
+    // Drop the models not used by any session.
+    if (Cache.Models.size() >= kMaxModels) {
+      for (auto It = Cache.Models.begin(); It != Cache.Models.end();) {
+        if (It->second.use_count() == 1) {
+          It = Cache.Models.erase(It);
+        } else {
+          ++It;
+        }
+      }
+    }
+    Cache.Models.emplace(Hash, Mod);
+    return Mod;
+  } catch (std::bad_alloc &) {
+    return {};
+  }
+}
+
+Interpreter Model::acquire() noexcept {
+  {
+    std::unique_lock Lock(Mutex);
+    if (!Idle.empty()) {
+      Interpreter Interp = Idle.back();
+      Idle.pop_back();
+      return Interp;
+    }
+  }
+
+  Interpreter Interp;
+  auto *Ops = TfLiteInterpreterOptionsCreate();
+  if (unlikely(Ops == nullptr)) {
+    return Interp;
+  }
+  const int32_t Threads = TFLiteEnv::NumThreads.value();
+  TfLiteInterpreterOptionsSetNumThreads(Ops, Threads);
+  if (TFLiteEnv::XNNPack.value()) {
+    auto DelegateOps = TfLiteXNNPackDelegateOptionsDefault();
+    DelegateOps.num_threads = Threads;
+    Interp.Delegate = TfLiteXNNPackDelegateCreate(&DelegateOps);
+    if (Interp.Delegate) {
+      TfLiteInterpreterOptionsAddDelegate(Ops, Interp.Delegate);
+    }
+  }
+  Interp.Interp = TfLiteInterpreterCreate(Handle, Ops);
+  TfLiteInterpreterOptionsDelete(Ops);
+  if (unlikely(Interp.Interp == nullptr ||
+               TfLiteInterpreterAllocateTensors(Interp.Interp) !=
+                   TfLiteStatus::kTfLiteOk)) {
+    destroy(Interp);
+  }
+  return Interp;
+}
+
+void Model::release(Interpreter Interp) noexcept {
+  std::unique_lock Lock(Mutex);
+  if (Idle.size() < kMaxIdle) {
+    try {
+      Idle.push_back(Interp);
+      return;
+    } catch (std::bad_alloc &) {
+    }
+  }
+  destroy(Interp);
+}
+
+} // namespace WasmEdgeTensorflowLite
+
+namespace {
+
+void addOptions(const Plugin::Plugin::PluginDescriptor *,
+                PO::ArgumentParser &Parser) noexcept {
+  Parser.add_option("tflite-threads"sv,
+                    WasmEdgeTensorflowLite::TFLiteEnv::NumThreads);
+  Parser.add_option("tflite-xnnpack"sv,
+                    WasmEdgeTensorflowLite::TFLiteEnv::XNNPack);
+}
 
 Runtime::Instance::ModuleInstance *
 create(const Plugin::PluginModule::ModuleDescriptor *) noexcept {
@@ -29,7 +173,7 @@ Plugin::Plugin::PluginDescriptor Descriptor{
                 .Create = create,
             },
         },
-    .AddOptions = nullptr,
+    .AddOptions = addOptions,
 };
 
 EXPORT_GET_DESCRIPTOR(Descriptor)
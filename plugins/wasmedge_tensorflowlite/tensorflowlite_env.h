@@ -3,12 +3,17 @@
 
 #pragma once
 
+#include "common/span.h"
 #include "plugin/plugin.h"
+#include "po/option.h"
 
 #include "tensorflow/lite/c/c_api.h"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace WasmEdge {
@@ -24,19 +29,69 @@ enum class ErrNo : uint32_t {
   RuntimeError = 5,    // Runtime Error.
 };
 
+/// Interpreter with the tensors allocated, and its own delegate.
+struct Interpreter {
+  TfLiteInterpreter *Interp = nullptr;
+  TfLiteDelegate *Delegate = nullptr;
+};
+
+/// Model parsed once and shared by the sessions of the same model, with the
+/// pool of the idle interpreters of it.
+class Model {
+public:
+  Model(const Model &) = delete;
+  Model &operator=(const Model &) = delete;
+  ~Model() noexcept;
+
+  /// Get the parsed model of the buffer, which is parsed at the first time.
+  static std::shared_ptr<Model> get(Span<const char> Buffer) noexcept;
+
+  /// Take an idle interpreter, or create one.
+  Interpreter acquire() noexcept;
+
+  /// Return the interpreter to the pool.
+  void release(Interpreter Interp) noexcept;
+
+private:
+  /// Maximum idle interpreters kept per model.
+  static inline constexpr const size_t kMaxIdle = 4;
+  /// Maximum models kept by the cache when not used by any session.
+  static inline constexpr const size_t kMaxModels = 16;
+
+  Model() noexcept = default;
+
+  /// The buffer must outlive the model and its interpreters.
+  std::vector<char> Data;
+  TfLiteModel *Handle = nullptr;
+  std::mutex Mutex;
+  std::vector<Interpreter> Idle;
+};
+
 struct Context {
   Context() = default;
+  Context(Context &&RHS) noexcept
+      : Mod(std::move(RHS.Mod)), Interp(std::exchange(RHS.Interp, nullptr)),
+        Delegate(std::exchange(RHS.Delegate, nullptr)) {}
   ~Context() { reset(); }
   void reset() noexcept {
     if (Interp) {
-      TfLiteInterpreterDelete(Interp);
+      Mod->release({Interp, Delegate});
     }
     Interp = nullptr;
+    Delegate = nullptr;
+    Mod.reset();
   }
+  std::shared_ptr<Model> Mod;
   TfLiteInterpreter *Interp = nullptr;
+  TfLiteDelegate *Delegate = nullptr;
 };
 
 struct TFLiteEnv {
+  /// Threads of the interpreters.
+  static PO::Option<int32_t> NumThreads;
+  /// Run the interpreters with the XNNPACK delegate.
+  static PO::Option<PO::Toggle> XNNPack;
+
   TFLiteEnv() noexcept { TFLiteContext.reserve(16U); }
 
   Context *getContext(const uint32_t ID) noexcept {
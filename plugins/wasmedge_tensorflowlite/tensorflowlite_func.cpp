@@ -73,36 +73,24 @@ Expect<uint32_t> CreateSession::body(const Runtime::CallingFrame &Frame,
   SESSION_CHECK(Cxt, NewID, "Failed when allocating resources."sv,
                 ErrNo::MissingMemory)
 
-  auto *Model = TfLiteModelCreate(ModBufSpan.data(), ModBufLen);
-  if (unlikely(Model == nullptr)) {
+  // The model is parsed once and its interpreters are reused by the sessions,
+  // with the tensors allocated.
+  auto Mod = Model::get(ModBufSpan);
+  if (unlikely(!Mod)) {
     spdlog::error("[WasmEdge-Tensorflow-Lite] Cannot import TFLite model."sv);
     Env.deleteContext(NewID);
     return static_cast<uint32_t>(ErrNo::InvalidArgument);
   }
-  auto *Ops = TfLiteInterpreterOptionsCreate();
-  if (unlikely(Ops == nullptr)) {
-    spdlog::error(
-        "[WasmEdge-Tensorflow-Lite] Cannot create TFLite interpreter options."sv);
-    Env.deleteContext(NewID);
-    TfLiteModelDelete(Model);
-    return static_cast<uint32_t>(ErrNo::Busy);
-  }
-  TfLiteInterpreterOptionsSetNumThreads(Ops, 2);
-  Cxt->Interp = TfLiteInterpreterCreate(Model, Ops);
-  TfLiteInterpreterOptionsDelete(Ops);
-  TfLiteModelDelete(Model);
-  if (unlikely(Cxt->Interp == nullptr)) {
+  const auto Interp = Mod->acquire();
+  if (unlikely(Interp.Interp == nullptr)) {
     spdlog::error(
         "[WasmEdge-Tensorflow-Lite] Cannot create TFLite interpreter."sv);
     Env.deleteContext(NewID);
     return static_cast<uint32_t>(ErrNo::Busy);
   }
-  TfLiteStatus Status = TfLiteInterpreterAllocateTensors(Cxt->Interp);
-  if (unlikely(Status != TfLiteStatus::kTfLiteOk)) {
-    spdlog::error("[WasmEdge-Tensorflow-Lite] Cannot allocate tensors."sv);
-    Env.deleteContext(NewID);
-    return static_cast<uint32_t>(ErrNo::Busy);
-  }
+  Cxt->Mod = std::move(Mod);
+  Cxt->Interp = Interp.Interp;
+  Cxt->Delegate = Interp.Delegate;
 
   *SessionId = NewID;
   return static_cast<uint32_t>(ErrNo::Success);
@@ -7,6 +7,15 @@
 namespace WasmEdge {
 namespace Host {
 
+WasmEdgeZlibEnvironment::~WasmEdgeZlibEnvironment() noexcept {
+  if (BatchDeflate.Stream) {
+    deflateEnd(BatchDeflate.Stream.get());
+  }
+  if (BatchInflate.Stream) {
+    inflateEnd(BatchInflate.Stream.get());
+  }
+}
+
 namespace {
 
 Runtime::Instance::ModuleInstance *
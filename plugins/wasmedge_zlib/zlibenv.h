@@ -75,6 +75,20 @@ struct WasmGZHeader {
 };
 static_assert(sizeof(WasmGZHeader) == 52, "WasmGZHeader should be 52 bytes");
 
+/*
+  A buffer of the batch functions. DestLen is the space at Dest on input and
+  the produced length on output, Result is the zlib return code of the buffer.
+*/
+struct WasmZBatchEntry {
+  uint32_t Source;    /* [Wasm Offset] input buffer */
+  uint32_t SourceLen; /* input length */
+  uint32_t Dest;      /* [Wasm Offset] output buffer */
+  uint32_t DestLen;   /* output space, then output length */
+  int32_t Result;     /* Z_OK, or the error of this buffer */
+};
+static_assert(sizeof(WasmZBatchEntry) == 20,
+              "WasmZBatchEntry should be 20 bytes");
+
 namespace WasmEdge {
 namespace Host {
 
@@ -87,9 +101,21 @@ public:
     std::unique_ptr<gz_header> HostGZHeader;
   };
 
+  /// Host stream of the batch functions, reset for every buffer instead of
+  /// initialized again. Reinitialized only when the parameters change.
+  struct BatchStream {
+    std::unique_ptr<z_stream> Stream;
+    int32_t Level = 0;
+    int32_t WindowBits = 0;
+  };
+
+  ~WasmEdgeZlibEnvironment() noexcept;
+
   std::unordered_map<uint32_t, std::unique_ptr<z_stream>> ZStreamMap;
   std::map<uint32_t, std::unique_ptr<GZFile>, std::greater<uint32_t>> GZFileMap;
   std::unordered_map<uint32_t, GZStore> GZHeaderMap;
+  BatchStream BatchDeflate;
+  BatchStream BatchInflate;
 };
 
 } // namespace Host
@@ -720,6 +720,107 @@ WasmEdgeZlibUncompress2::body(const Runtime::CallingFrame &Frame,
   return ZRes;
 }
 
+/*
+  Run the buffers of the batch through the reset stream with Run, which returns
+  Z_STREAM_END once the buffer is done. Returns Z_OK, or the first error.
+*/
+template <typename T>
+Expect<int32_t> BatchRun(const std::string_view &Msg,
+                         const Runtime::CallingFrame &Frame,
+                         uint32_t EntriesPtr, uint32_t Count,
+                         z_stream *HostZStream, T Run) {
+  MEMINST_CHECK(MemInst, Frame, 0)
+
+  auto Entries = MemInst->getSpan<WasmZBatchEntry>(EntriesPtr, Count);
+  if (unlikely(Entries.size() != Count)) {
+    spdlog::error("[WasmEdge-Zlib] [{}] Invalid EntriesPtr received."sv, Msg);
+    return Unexpect(ErrCode::Value::HostFuncError);
+  }
+
+  int32_t ZRes = Z_OK;
+  for (auto &Entry : Entries) {
+    auto Source = MemInst->getSpan<Bytef>(Entry.Source, Entry.SourceLen);
+    auto Dest = MemInst->getSpan<Bytef>(Entry.Dest, Entry.DestLen);
+    if (unlikely(Source.size() != Entry.SourceLen ||
+                 Dest.size() != Entry.DestLen)) {
+      Entry.Result = Z_STREAM_ERROR;
+    } else {
+      HostZStream->next_in = Source.data();
+      HostZStream->avail_in = Entry.SourceLen;
+      HostZStream->next_out = Dest.data();
+      HostZStream->avail_out = Entry.DestLen;
+      const auto Res = Run(HostZStream);
+      if (Res == Z_STREAM_END) {
+        Entry.DestLen = static_cast<uint32_t>(HostZStream->total_out);
+        Entry.Result = Z_OK;
+      } else if (Res == Z_OK || Res == Z_BUF_ERROR) {
+        // Out of output space, or the input is truncated.
+        Entry.Result =
+            HostZStream->avail_out == 0 ? Z_BUF_ERROR : Z_DATA_ERROR;
+      } else {
+        Entry.Result = Res;
+      }
+    }
+    if (Entry.Result != Z_OK && ZRes == Z_OK) {
+      ZRes = Entry.Result;
+    }
+  }
+  return ZRes;
+}
+
+Expect<int32_t>
+WasmEdgeZlibCompressBatch::body(const Runtime::CallingFrame &Frame,
+                                uint32_t EntriesPtr, uint32_t Count,
+                                int32_t Level, int32_t WindowBits) {
+  auto &Batch = Env.BatchDeflate;
+  if (Batch.Stream &&
+      (Batch.Level != Level || Batch.WindowBits != WindowBits)) {
+    deflateEnd(Batch.Stream.get());
+    Batch.Stream.reset();
+  }
+  if (!Batch.Stream) {
+    auto HostZStream = std::make_unique<z_stream>();
+    const auto ZRes =
+        deflateInit2(HostZStream.get(), Level, Z_DEFLATED, WindowBits,
+                     MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+    if (ZRes != Z_OK) {
+      return ZRes;
+    }
+    Batch = {std::move(HostZStream), Level, WindowBits};
+  }
+
+  return BatchRun("WasmEdgeZlibCompressBatch", Frame, EntriesPtr, Count,
+                  Batch.Stream.get(), [](z_stream *HostZStream) {
+                    deflateReset(HostZStream);
+                    return deflate(HostZStream, Z_FINISH);
+                  });
+}
+
+Expect<int32_t>
+WasmEdgeZlibUncompressBatch::body(const Runtime::CallingFrame &Frame,
+                                  uint32_t EntriesPtr, uint32_t Count,
+                                  int32_t WindowBits) {
+  auto &Batch = Env.BatchInflate;
+  if (Batch.Stream && Batch.WindowBits != WindowBits) {
+    inflateEnd(Batch.Stream.get());
+    Batch.Stream.reset();
+  }
+  if (!Batch.Stream) {
+    auto HostZStream = std::make_unique<z_stream>();
+    const auto ZRes = inflateInit2(HostZStream.get(), WindowBits);
+    if (ZRes != Z_OK) {
+      return ZRes;
+    }
+    Batch = {std::move(HostZStream), 0, WindowBits};
+  }
+
+  return BatchRun("WasmEdgeZlibUncompressBatch", Frame, EntriesPtr, Count,
+                  Batch.Stream.get(), [](z_stream *HostZStream) {
+                    inflateReset(HostZStream);
+                    return inflate(HostZStream, Z_FINISH);
+                  });
+}
+
 Expect<uint32_t> WasmEdgeZlibGZOpen::body(const Runtime::CallingFrame &Frame,
                                           uint32_t PathPtr, uint32_t ModePtr) {
   MEMINST_CHECK(MemInst, Frame, 0)
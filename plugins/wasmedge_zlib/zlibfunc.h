@@ -299,6 +299,24 @@ public:
                        uint32_t SourceLenPtr);
 };
 
+class WasmEdgeZlibCompressBatch
+    : public WasmEdgeZlib<WasmEdgeZlibCompressBatch> {
+public:
+  WasmEdgeZlibCompressBatch(WasmEdgeZlibEnvironment &HostEnv)
+      : WasmEdgeZlib(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t EntriesPtr,
+                       uint32_t Count, int32_t Level, int32_t WindowBits);
+};
+
+class WasmEdgeZlibUncompressBatch
+    : public WasmEdgeZlib<WasmEdgeZlibUncompressBatch> {
+public:
+  WasmEdgeZlibUncompressBatch(WasmEdgeZlibEnvironment &HostEnv)
+      : WasmEdgeZlib(HostEnv) {}
+  Expect<int32_t> body(const Runtime::CallingFrame &Frame, uint32_t EntriesPtr,
+                       uint32_t Count, int32_t WindowBits);
+};
+
 class WasmEdgeZlibGZOpen : public WasmEdgeZlib<WasmEdgeZlibGZOpen> {
 public:
   WasmEdgeZlibGZOpen(WasmEdgeZlibEnvironment &HostEnv)
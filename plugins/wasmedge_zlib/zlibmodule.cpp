@@ -108,6 +108,10 @@ WasmEdgeZlibModule::WasmEdgeZlibModule() : ModuleInstance("wasmedge_zlib") {
               std::make_unique<WasmEdgeZlibInflateResetKeep>(Env));
   addHostFunc("deflateResetKeep",
               std::make_unique<WasmEdgeZlibDeflateResetKeep>(Env));
+  addHostFunc("compressBatch",
+              std::make_unique<WasmEdgeZlibCompressBatch>(Env));
+  addHostFunc("uncompressBatch",
+              std::make_unique<WasmEdgeZlibUncompressBatch>(Env));
 }
 
 } // namespace Host
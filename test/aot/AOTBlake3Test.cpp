@@ -74,6 +74,25 @@ TEST(Blake3Test, Large) {
   }
 }
 
+TEST(Blake3Test, Parallel) {
+  // The sizes of the full chunks, a partial last chunk, and a last chunk of a
+  // single block, over the size hashed on the worker threads.
+  const size_t Base = size_t(4) << 20;
+  for (const size_t Size : {Base, Base + 1, Base + 1000, Base + 1088}) {
+    std::vector<WasmEdge::Byte> Data(Size);
+    for (size_t I = 0; I < Size; ++I) {
+      Data[I] = static_cast<WasmEdge::Byte>(I % 251);
+    }
+    WasmEdge::AOT::Blake3 Blake3;
+    HashArray Expect;
+    Blake3.update(Data);
+    Blake3.finalize(Expect);
+    HashArray Output;
+    WasmEdge::AOT::Blake3::hash(Data, Output);
+    EXPECT_EQ(Output, Expect);
+  }
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -14,10 +14,17 @@
 
 #include "aot/cache.h"
 
+#include "common/configure.h"
+#include "common/defines.h"
 #include "common/filesystem.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 #include <string_view>
 #include <system_error>
 
@@ -99,6 +106,164 @@ TEST(CacheTest, LocalKey) {
   EXPECT_EQ(Part.parent_path().filename().u8string(), "key"s);
 }
 
+TEST(CacheTest, ConfigureKey) {
+  WasmEdge::Configure Conf;
+  const auto Path = WasmEdge::AOT::Cache::getPath(
+      {}, Conf, WasmEdge::AOT::Cache::StorageScope::Local, "key"s);
+  ASSERT_TRUE(Path);
+  EXPECT_EQ(Path->parent_path().filename().u8string(), "key"s);
+  const auto Plain = WasmEdge::AOT::Cache::getPath(
+      {}, WasmEdge::AOT::Cache::StorageScope::Local, "key"s);
+  ASSERT_TRUE(Plain);
+  EXPECT_NE(*Path, *Plain);
+
+  Conf.getCompilerConfigure().setOptimizationLevel(
+      WasmEdge::CompilerConfigure::OptimizationLevel::O0);
+  const auto Other = WasmEdge::AOT::Cache::getPath(
+      {}, Conf, WasmEdge::AOT::Cache::StorageScope::Local, "key"s);
+  ASSERT_TRUE(Other);
+  EXPECT_NE(*Path, *Other);
+}
+
+TEST(CacheTest, FileKey) {
+  const auto File =
+      std::filesystem::temp_directory_path() / "wasmedge-cache-file-test"sv;
+  const std::vector<WasmEdge::Byte> Data(64, 0x5a);
+  std::error_code ErrCode;
+  ASSERT_TRUE(WasmEdge::AOT::Cache::publish(File, Data));
+  std::filesystem::last_write_time(
+      File,
+      std::filesystem::file_time_type::clock::now() - std::chrono::minutes(1),
+      ErrCode);
+
+  WasmEdge::Configure Conf;
+  const auto Expect = WasmEdge::AOT::Cache::getPath(
+      Data, Conf, WasmEdge::AOT::Cache::StorageScope::Local, "key"s);
+  ASSERT_TRUE(Expect);
+  // The second lookup reads the hash from the memo of the first one.
+  for (int I = 0; I < 2; ++I) {
+    const auto Path = WasmEdge::AOT::Cache::getPath(
+        Data, File, Conf, WasmEdge::AOT::Cache::StorageScope::Local, "key"s);
+    ASSERT_TRUE(Path);
+    EXPECT_EQ(*Path, *Expect);
+  }
+
+  std::filesystem::remove(File, ErrCode);
+}
+
+TEST(CacheTest, PublishAndEvict) {
+  const auto Dir =
+      std::filesystem::temp_directory_path() / "wasmedge-cache-test"sv;
+  std::error_code ErrCode;
+  std::filesystem::remove_all(Dir, ErrCode);
+
+  const std::vector<WasmEdge::Byte> Data(1024, 0x5a);
+  const auto Now = std::filesystem::file_time_type::clock::now();
+  for (int I = 0; I < 3; ++I) {
+    const auto Path = Dir / std::to_string(I);
+    ASSERT_TRUE(WasmEdge::AOT::Cache::publish(Path, Data));
+    EXPECT_EQ(std::filesystem::file_size(Path, ErrCode), Data.size());
+    std::filesystem::last_write_time(Path, Now - std::chrono::minutes(3 - I),
+                                     ErrCode);
+  }
+  // The entry 0 is used last, so the entry 1 is the least recently used.
+  WasmEdge::AOT::Cache::touch(Dir / "0"sv);
+
+  const auto MaxSize = WasmEdge::AOT::Cache::getMaxSize();
+  WasmEdge::AOT::Cache::setMaxSize(2 * Data.size());
+  WasmEdge::AOT::Cache::evict(Dir);
+  WasmEdge::AOT::Cache::setMaxSize(MaxSize);
+  EXPECT_TRUE(std::filesystem::exists(Dir / "0"sv, ErrCode));
+  EXPECT_FALSE(std::filesystem::exists(Dir / "1"sv, ErrCode));
+  EXPECT_TRUE(std::filesystem::exists(Dir / "2"sv, ErrCode));
+
+  std::filesystem::remove_all(Dir, ErrCode);
+}
+
+class MemoryBackend final : public WasmEdge::AOT::Cache::RemoteBackend {
+public:
+  std::optional<std::vector<WasmEdge::Byte>>
+  get(std::string_view Name) noexcept override {
+    if (auto It = Entries.find(std::string(Name)); It != Entries.end()) {
+      return It->second;
+    }
+    return std::nullopt;
+  }
+  bool put(std::string_view Name,
+           WasmEdge::Span<const WasmEdge::Byte> Data) noexcept override {
+    Entries[std::string(Name)].assign(Data.begin(), Data.end());
+    return true;
+  }
+  std::map<std::string, std::vector<WasmEdge::Byte>> Entries;
+};
+
+TEST(CacheTest, Remote) {
+  const auto Dir =
+      std::filesystem::temp_directory_path() / "wasmedge-cache-remote-test"sv;
+  std::error_code ErrCode;
+  std::filesystem::remove_all(Dir, ErrCode);
+  const auto Path = Dir / "functions"sv / "entry"sv;
+  EXPECT_EQ(WasmEdge::AOT::Cache::getRemoteName(Path, "x86_64/znver4"sv),
+            "x86_64/znver4/functions/entry"s);
+
+  const std::vector<WasmEdge::Byte> Data(16, 0x5a);
+  auto Remote = std::make_shared<MemoryBackend>();
+  WasmEdge::AOT::Cache::setRemote(Remote, false);
+  WasmEdge::AOT::Cache::upload(Path, "target"sv, Data);
+  EXPECT_TRUE(Remote->Entries.empty());
+  EXPECT_FALSE(WasmEdge::AOT::Cache::fetch(Path, "target"sv));
+
+  WasmEdge::AOT::Cache::setRemote(Remote, true);
+  WasmEdge::AOT::Cache::upload(Path, "target"sv, Data);
+  EXPECT_EQ(Remote->Entries.size(), 1U);
+  EXPECT_TRUE(WasmEdge::AOT::Cache::fetch(Path, "target"sv));
+  EXPECT_EQ(std::filesystem::file_size(Path, ErrCode), Data.size());
+  EXPECT_FALSE(WasmEdge::AOT::Cache::fetch(Path, "other"sv));
+  WasmEdge::AOT::Cache::setRemote({}, false);
+
+  EXPECT_FALSE(WasmEdge::AOT::Cache::createHTTPBackend("https://cache"sv));
+  EXPECT_FALSE(WasmEdge::AOT::Cache::createHTTPBackend("http://:80/"sv));
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+  EXPECT_TRUE(
+      WasmEdge::AOT::Cache::createHTTPBackend("http://[::1]:8080/cache/"sv));
+#endif
+
+  std::filesystem::remove_all(Dir, ErrCode);
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+TEST(CacheTest, Lock) {
+  const auto Dir =
+      std::filesystem::temp_directory_path() / "wasmedge-cache-lock-test"sv;
+  std::error_code ErrCode;
+  std::filesystem::remove_all(Dir, ErrCode);
+  const auto Path = Dir / "entry"sv;
+  const std::vector<WasmEdge::Byte> Data(16, 0x5a);
+  ASSERT_TRUE(WasmEdge::AOT::Cache::publish(Path, Data));
+
+  {
+    auto Lock = WasmEdge::AOT::Cache::Lock::acquire(
+        Path, std::chrono::milliseconds(0));
+    EXPECT_TRUE(Lock.owns());
+    auto Busy = WasmEdge::AOT::Cache::Lock::acquire(
+        Path, std::chrono::milliseconds(50));
+    EXPECT_FALSE(Busy.owns());
+
+    // The locked entry is kept by the eviction.
+    const auto MaxSize = WasmEdge::AOT::Cache::getMaxSize();
+    WasmEdge::AOT::Cache::setMaxSize(1);
+    WasmEdge::AOT::Cache::evict(Dir);
+    WasmEdge::AOT::Cache::setMaxSize(MaxSize);
+    EXPECT_TRUE(std::filesystem::exists(Path, ErrCode));
+  }
+  auto Lock =
+      WasmEdge::AOT::Cache::Lock::acquire(Path, std::chrono::milliseconds(0));
+  EXPECT_TRUE(Lock.owns());
+
+  std::filesystem::remove_all(Dir, ErrCode);
+}
+#endif
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -7,6 +7,8 @@
 #include "wasmedge/wasmedge.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -20,6 +22,10 @@
 #if WASMEDGE_OS_WINDOWS
 #include "system/winapi.h"
 #endif
+#if WASMEDGE_OS_LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 using namespace std::literals;
 
@@ -280,6 +286,21 @@ WasmEdge_Result externFail(void *, const WasmEdge_CallingFrameContext *,
   return WasmEdge_ResultGen(WasmEdge_ErrCategory_UserLevelError, 0x5678);
 }
 
+WasmEdge_Result externSuspend(void *Data,
+                              const WasmEdge_CallingFrameContext *CallFrameCxt,
+                              const WasmEdge_Value *In, WasmEdge_Value *Out) {
+  // {i32} -> {i32}: wait until the slot of the index is filled.
+  auto &Slots = *static_cast<std::array<int32_t, 2> *>(Data);
+  const int32_t Index = WasmEdge_ValueGetI32(In[0]);
+  while (Slots[Index] < 0) {
+    if (!WasmEdge_CallingFrameSuspend(CallFrameCxt)) {
+      return WasmEdge_ResultGen(WasmEdge_ErrCategory_UserLevelError, 1);
+    }
+  }
+  Out[0] = WasmEdge_ValueGenI32(Slots[Index] + 1);
+  return WasmEdge_Result_Success;
+}
+
 WasmEdge_Result externWrap(void *This, void *Data,
                            const WasmEdge_CallingFrameContext *MemCxt,
                            const WasmEdge_Value *In, const uint32_t,
@@ -678,12 +699,120 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureSetMaxMemoryPage(Conf, 1234U);
   EXPECT_NE(WasmEdge_ConfigureGetMaxMemoryPage(ConfNull), 1234U);
   EXPECT_EQ(WasmEdge_ConfigureGetMaxMemoryPage(Conf), 1234U);
+  WasmEdge_ConfigureSetMemoryBudget(ConfNull, 1024U, 4096U);
+  WasmEdge_ConfigureSetMemoryBudget(Conf, 1024U, 4096U);
+  EXPECT_NE(WasmEdge_ConfigureGetMemoryBudgetSoftLimit(ConfNull), 1024U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMemoryBudgetSoftLimit(Conf), 1024U);
+  EXPECT_NE(WasmEdge_ConfigureGetMemoryBudgetHardLimit(ConfNull), 4096U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMemoryBudgetHardLimit(Conf), 4096U);
+  WasmEdge_ConfigureSetGCThreshold(ConfNull, 65536U);
+  WasmEdge_ConfigureSetGCThreshold(Conf, 65536U);
+  EXPECT_NE(WasmEdge_ConfigureGetGCThreshold(ConfNull), 65536U);
+  EXPECT_EQ(WasmEdge_ConfigureGetGCThreshold(Conf), 65536U);
   // Tests for force interpreter.
   WasmEdge_ConfigureSetForceInterpreter(ConfNull, true);
   EXPECT_EQ(WasmEdge_ConfigureIsForceInterpreter(Conf), false);
   WasmEdge_ConfigureSetForceInterpreter(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureIsForceInterpreter(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureIsForceInterpreter(Conf), true);
+  // Tests for super-instructions.
+  WasmEdge_ConfigureSetEnableSuperInstructions(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableSuperInstructions(Conf), false);
+  WasmEdge_ConfigureSetEnableSuperInstructions(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableSuperInstructions(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableSuperInstructions(Conf), true);
+  WasmEdge_ConfigureSetValueStackSize(ConfNull, 4096U);
+  EXPECT_EQ(WasmEdge_ConfigureGetValueStackSize(Conf), 0U);
+  WasmEdge_ConfigureSetValueStackSize(Conf, 4096U);
+  EXPECT_NE(WasmEdge_ConfigureGetValueStackSize(ConfNull), 4096U);
+  EXPECT_EQ(WasmEdge_ConfigureGetValueStackSize(Conf), 4096U);
+  WasmEdge_ConfigureSetEnableZeroCopyLoad(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableZeroCopyLoad(Conf), false);
+  WasmEdge_ConfigureSetEnableZeroCopyLoad(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableZeroCopyLoad(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableZeroCopyLoad(Conf), true);
+  WasmEdge_ConfigureSetEnableLazyFunctionBody(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableLazyFunctionBody(Conf), false);
+  WasmEdge_ConfigureSetEnableLazyFunctionBody(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableLazyFunctionBody(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableLazyFunctionBody(Conf), true);
+  WasmEdge_ConfigureSetEnableTrustedAOT(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableTrustedAOT(Conf), false);
+  WasmEdge_ConfigureSetEnableTrustedAOT(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableTrustedAOT(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableTrustedAOT(Conf), true);
+  WasmEdge_ConfigureSetValidationThreadCount(ConfNull, 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetValidationThreadCount(Conf), 1U);
+  WasmEdge_ConfigureSetValidationThreadCount(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureGetValidationThreadCount(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetValidationThreadCount(Conf), 4U);
+  WasmEdge_ConfigureSetLoadingThreadCount(ConfNull, 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetLoadingThreadCount(Conf), 1U);
+  WasmEdge_ConfigureSetLoadingThreadCount(Conf, 4U);
+  EXPECT_NE(WasmEdge_ConfigureGetLoadingThreadCount(ConfNull), 4U);
+  EXPECT_EQ(WasmEdge_ConfigureGetLoadingThreadCount(Conf), 4U);
+  WasmEdge_ConfigureSetMemoryPoolSize(ConfNull, 8U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMemoryPoolSize(Conf), 0U);
+  WasmEdge_ConfigureSetMemoryPoolSize(Conf, 8U);
+  EXPECT_NE(WasmEdge_ConfigureGetMemoryPoolSize(ConfNull), 8U);
+  EXPECT_EQ(WasmEdge_ConfigureGetMemoryPoolSize(Conf), 8U);
+  WasmEdge_ConfigureSetStripedMemoryPages(ConfNull, 256U);
+  EXPECT_EQ(WasmEdge_ConfigureGetStripedMemoryPages(Conf), 0U);
+  WasmEdge_ConfigureSetStripedMemoryPages(Conf, 256U);
+  EXPECT_NE(WasmEdge_ConfigureGetStripedMemoryPages(ConfNull), 256U);
+  EXPECT_EQ(WasmEdge_ConfigureGetStripedMemoryPages(Conf), 256U);
+  WasmEdge_ConfigureSetEnableMemoryImage(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableMemoryImage(Conf), false);
+  WasmEdge_ConfigureSetEnableMemoryImage(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableMemoryImage(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableMemoryImage(Conf), true);
+  WasmEdge_ConfigureSetEnableHugePages(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableHugePages(Conf), false);
+  WasmEdge_ConfigureSetEnableHugePages(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableHugePages(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableHugePages(Conf), true);
+  WasmEdge_ConfigureSetEnableBackgroundReclamation(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableBackgroundReclamation(Conf), false);
+  WasmEdge_ConfigureSetEnableBackgroundReclamation(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableBackgroundReclamation(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableBackgroundReclamation(Conf), true);
+  WasmEdge_ConfigureSetNumaNode(ConfNull, 1);
+  EXPECT_EQ(WasmEdge_ConfigureGetNumaNode(Conf), -1);
+  WasmEdge_ConfigureSetNumaNode(Conf, 1);
+  EXPECT_EQ(WasmEdge_ConfigureGetNumaNode(ConfNull), -1);
+  EXPECT_EQ(WasmEdge_ConfigureGetNumaNode(Conf), 1);
+  WasmEdge_ConfigureSetNumaNode(Conf, -1);
+  WasmEdge_ConfigureSetNativeStackSize(ConfNull, 65536);
+  EXPECT_EQ(WasmEdge_ConfigureGetNativeStackSize(Conf), 0U);
+  WasmEdge_ConfigureSetNativeStackSize(Conf, 65536);
+  EXPECT_EQ(WasmEdge_ConfigureGetNativeStackSize(ConfNull), 0U);
+  EXPECT_EQ(WasmEdge_ConfigureGetNativeStackSize(Conf), 65536U);
+  WasmEdge_ConfigureSetNativeStackSize(Conf, 0);
+  WasmEdge_ConfigureSetEnableHugePageCode(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableHugePageCode(Conf), false);
+  WasmEdge_ConfigureSetEnableHugePageCode(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableHugePageCode(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableHugePageCode(Conf), true);
+  WasmEdge_ConfigureSetEnableLazyTable(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableLazyTable(Conf), false);
+  WasmEdge_ConfigureSetEnableLazyTable(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableLazyTable(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableLazyTable(Conf), true);
+  WasmEdge_ConfigureSetEnableGuardRegion(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableGuardRegion(Conf), false);
+  WasmEdge_ConfigureSetEnableGuardRegion(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableGuardRegion(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableGuardRegion(Conf), true);
+  WasmEdge_ConfigureSetEnableIoUring(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableIoUring(Conf), false);
+  WasmEdge_ConfigureSetEnableIoUring(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableIoUring(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableIoUring(Conf), true);
+  WasmEdge_ConfigureSetEnableWasiPathCache(ConfNull, true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableWasiPathCache(Conf), false);
+  WasmEdge_ConfigureSetEnableWasiPathCache(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureIsEnableWasiPathCache(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureIsEnableWasiPathCache(Conf), true);
   // Tests for AOT compiler configurations.
   WasmEdge_ConfigureCompilerSetOptimizationLevel(
       ConfNull, WasmEdge_CompilerOptimizationLevel_Os);
@@ -713,6 +842,29 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureCompilerSetInterruptible(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureCompilerIsInterruptible(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureCompilerIsInterruptible(Conf), true);
+  WasmEdge_ConfigureCompilerSetPartitionCount(ConfNull, 8U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetPartitionCount(Conf), 1U);
+  WasmEdge_ConfigureCompilerSetPartitionCount(Conf, 8U);
+  EXPECT_NE(WasmEdge_ConfigureCompilerGetPartitionCount(ConfNull), 8U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetPartitionCount(Conf), 8U);
+  WasmEdge_ConfigureCompilerSetFunctionCache(ConfNull, true);
+  WasmEdge_ConfigureCompilerSetFunctionCache(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureCompilerIsFunctionCache(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerIsFunctionCache(Conf), true);
+  WasmEdge_ConfigureCompilerSetCoarseGasCheck(ConfNull, true);
+  WasmEdge_ConfigureCompilerSetCoarseGasCheck(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureCompilerIsCoarseGasCheck(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerIsCoarseGasCheck(Conf), true);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetTargetLevel(Conf), 0U);
+  WasmEdge_ConfigureCompilerSetTargetLevel(ConfNull, 3U);
+  WasmEdge_ConfigureCompilerSetTargetLevel(Conf, 3U);
+  EXPECT_NE(WasmEdge_ConfigureCompilerGetTargetLevel(ConfNull), 3U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetTargetLevel(Conf), 3U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetInlineBudget(Conf), 0U);
+  WasmEdge_ConfigureCompilerSetInlineBudget(ConfNull, 32U);
+  WasmEdge_ConfigureCompilerSetInlineBudget(Conf, 32U);
+  EXPECT_NE(WasmEdge_ConfigureCompilerGetInlineBudget(ConfNull), 32U);
+  EXPECT_EQ(WasmEdge_ConfigureCompilerGetInlineBudget(Conf), 32U);
   // Tests for Statistics configurations.
   WasmEdge_ConfigureStatisticsSetInstructionCounting(ConfNull, true);
   WasmEdge_ConfigureStatisticsSetInstructionCounting(Conf, true);
@@ -726,6 +878,10 @@ TEST(APICoreTest, Configure) {
   WasmEdge_ConfigureStatisticsSetTimeMeasuring(Conf, true);
   EXPECT_NE(WasmEdge_ConfigureStatisticsIsTimeMeasuring(ConfNull), true);
   EXPECT_EQ(WasmEdge_ConfigureStatisticsIsTimeMeasuring(Conf), true);
+  WasmEdge_ConfigureStatisticsSetIOMeasuring(ConfNull, true);
+  WasmEdge_ConfigureStatisticsSetIOMeasuring(Conf, true);
+  EXPECT_NE(WasmEdge_ConfigureStatisticsIsIOMeasuring(ConfNull), true);
+  EXPECT_EQ(WasmEdge_ConfigureStatisticsIsIOMeasuring(Conf), true);
   // Test to delete nullptr.
   WasmEdge_ConfigureDelete(ConfNull);
   EXPECT_TRUE(true);
@@ -1531,6 +1687,13 @@ TEST(APICoreTest, ExecutorWithStatistics) {
   WasmEdge_ExecutorDelete(nullptr);
   EXPECT_TRUE(true);
 
+  // Executor epoch deadline
+  WasmEdge_ExecutorSetEpochDeadline(nullptr, 1);
+  EXPECT_TRUE(true);
+  const uint64_t Epoch = WasmEdge_EpochGet();
+  WasmEdge_EpochIncrement();
+  EXPECT_GE(WasmEdge_EpochGet(), Epoch + 1);
+
   // Register import object
   WasmEdge_ModuleInstanceContext *HostMod = createExternModule("extern");
   EXPECT_NE(HostMod, nullptr);
@@ -1617,6 +1780,23 @@ TEST(APICoreTest, ExecutorWithStatistics) {
   EXPECT_NE(ModCxt, nullptr);
   WasmEdge_ASTModuleDelete(Mod);
 
+  // Clone module instance
+  WasmEdge_ModuleInstanceContext *CloneCxt = nullptr;
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ExecutorClone(nullptr, &CloneCxt, ModCxt)));
+  EXPECT_EQ(CloneCxt, nullptr);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ExecutorClone(ExecCxt, nullptr, ModCxt)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ExecutorClone(ExecCxt, &CloneCxt, nullptr)));
+  EXPECT_EQ(CloneCxt, nullptr);
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_ExecutorClone(ExecCxt, &CloneCxt, ModCxt)));
+  EXPECT_NE(CloneCxt, nullptr);
+  EXPECT_EQ(WasmEdge_ModuleInstanceListFunctionLength(CloneCxt),
+            WasmEdge_ModuleInstanceListFunctionLength(ModCxt));
+  WasmEdge_ModuleInstanceDelete(CloneCxt);
+
   // Invoke functions
   WasmEdge_String FuncName = WasmEdge_StringCreateByCString("func-mul-2");
   WasmEdge_FunctionInstanceContext *FuncCxt =
@@ -2247,13 +2427,17 @@ TEST(APICoreTest, Instance) {
   // Memory instance get size and grow
   EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 1U);
   EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetGeneration(nullptr), 0U);
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetGeneration(MemCxt), 0U);
   EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
                          WasmEdge_MemoryInstanceGrowPage(nullptr, 1)));
   EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGrowPage(MemCxt, 1)));
   EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 2U);
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetGeneration(MemCxt), 1U);
   EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_MemoryOutOfBounds,
                          WasmEdge_MemoryInstanceGrowPage(MemCxt, 2)));
   EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 2U);
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetGeneration(MemCxt), 1U);
   EXPECT_TRUE(WasmEdge_ResultOK(
       WasmEdge_MemoryInstanceSetData(MemCxt, DataSet.data(), 70000, 10)));
   DataGet.clear();
@@ -2370,6 +2554,128 @@ TEST(APICoreTest, Instance) {
   WasmEdge_GlobalInstanceDelete(GlobVCxt);
 }
 
+#if WASMEDGE_OS_LINUX
+TEST(APICoreTest, MemoryInstanceFromFile) {
+  WasmEdge_MemoryTypeContext *MemType = WasmEdge_MemoryTypeCreate(
+      WasmEdge_Limit{/* HasMax */ true, /* Shared */ false, /* Min */ 1,
+                     /* Max */ 2});
+  const int File = memfd_create("wasmedge-test", 0);
+  ASSERT_GE(File, 0);
+
+  // The file is smaller than the memory.
+  EXPECT_EQ(WasmEdge_MemoryInstanceCreateFromFile(MemType, File, true),
+            nullptr);
+  EXPECT_EQ(WasmEdge_MemoryInstanceCreateFromFile(nullptr, File, true),
+            nullptr);
+  ASSERT_EQ(ftruncate(File, 65536), 0);
+  WasmEdge_MemoryInstanceContext *MemCxt =
+      WasmEdge_MemoryInstanceCreateFromFile(MemType, File, true);
+  WasmEdge_MemoryInstanceContext *ROMemCxt =
+      WasmEdge_MemoryInstanceCreateFromFile(MemType, File, false);
+  WasmEdge_MemoryTypeDelete(MemType);
+  ASSERT_NE(MemCxt, nullptr);
+  ASSERT_NE(ROMemCxt, nullptr);
+  auto *Host = static_cast<uint8_t *>(
+      mmap(nullptr, 65536, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0));
+  close(File);
+  ASSERT_NE(Host, MAP_FAILED);
+
+  // The writes are seen by the host and the other memory without copies.
+  std::vector<uint8_t> DataSet = {'t', 'e', 's', 't', ' ',
+                                  'd', 'a', 't', 'a', '\n'};
+  EXPECT_TRUE(WasmEdge_ResultOK(
+      WasmEdge_MemoryInstanceSetData(MemCxt, DataSet.data(), 100, 10)));
+  EXPECT_TRUE(std::equal(DataSet.cbegin(), DataSet.cend(), Host + 100));
+  EXPECT_TRUE(
+      std::equal(DataSet.cbegin(), DataSet.cend(),
+                 WasmEdge_MemoryInstanceGetPointerConst(ROMemCxt, 100, 10)));
+  Host[200] = 42;
+  EXPECT_EQ(*WasmEdge_MemoryInstanceGetPointerConst(MemCxt, 200, 1), 42);
+
+  // The memory never grows, and the read-only memory is not written.
+  EXPECT_FALSE(WasmEdge_ResultOK(WasmEdge_MemoryInstanceGrowPage(MemCxt, 1)));
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPageSize(MemCxt), 1U);
+  EXPECT_TRUE(isErrMatch(
+      WasmEdge_ErrCode_MemoryOutOfBounds,
+      WasmEdge_MemoryInstanceSetData(ROMemCxt, DataSet.data(), 100, 10)));
+
+  // The data of the file is kept after the memories are deleted.
+  WasmEdge_MemoryInstanceDelete(MemCxt);
+  WasmEdge_MemoryInstanceDelete(ROMemCxt);
+  EXPECT_TRUE(std::equal(DataSet.cbegin(), DataSet.cend(), Host + 100));
+  munmap(Host, 65536);
+}
+
+TEST(APICoreTest, MemoryInstanceFromFileReadOnly) {
+  // (import "env" "mem" (memory 1))
+  // (func (export "store") (i32.store (i32.const 0) (i32.const 42)))
+  // (func (export "fill") (memory.fill (i32.const 0) (i32.const 1)
+  //                                    (i32.const 16)))
+  // (func (export "load") (result i32) (i32.load (i32.const 100)))
+  std::vector<uint8_t> Wasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+      0x00, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x02, 0x0c, 0x01, 0x03, 0x65, 0x6e,
+      0x76, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00, 0x01, 0x03, 0x04, 0x03, 0x00,
+      0x00, 0x01, 0x07, 0x17, 0x03, 0x05, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x00,
+      0x00, 0x04, 0x66, 0x69, 0x6c, 0x6c, 0x00, 0x01, 0x04, 0x6c, 0x6f, 0x61,
+      0x64, 0x00, 0x02, 0x0a, 0x20, 0x03, 0x09, 0x00, 0x41, 0x00, 0x41, 0x2a,
+      0x36, 0x02, 0x00, 0x0b, 0x0b, 0x00, 0x41, 0x00, 0x41, 0x01, 0x41, 0x10,
+      0xfc, 0x0b, 0x00, 0x0b, 0x08, 0x00, 0x41, 0xe4, 0x00, 0x28, 0x02, 0x00,
+      0x0b};
+  WasmEdge_MemoryTypeContext *MemType = WasmEdge_MemoryTypeCreate(
+      WasmEdge_Limit{/* HasMax */ false, /* Shared */ false, /* Min */ 1,
+                     /* Max */ 1});
+  const int File = memfd_create("wasmedge-test", 0);
+  ASSERT_GE(File, 0);
+  ASSERT_EQ(ftruncate(File, 65536), 0);
+  const uint8_t Value = 7;
+  ASSERT_EQ(pwrite(File, &Value, 1, 100), 1);
+  WasmEdge_MemoryInstanceContext *ROMemCxt =
+      WasmEdge_MemoryInstanceCreateFromFile(MemType, File, false);
+  WasmEdge_MemoryTypeDelete(MemType);
+  close(File);
+  ASSERT_NE(ROMemCxt, nullptr);
+
+  // The hosts get no pointers to write into the read-only memory.
+  EXPECT_EQ(WasmEdge_MemoryInstanceGetPointer(ROMemCxt, 0, 4), nullptr);
+  EXPECT_NE(WasmEdge_MemoryInstanceGetPointerConst(ROMemCxt, 0, 4), nullptr);
+
+  WasmEdge_String Name = WasmEdge_StringCreateByCString("env");
+  WasmEdge_ModuleInstanceContext *HostMod = WasmEdge_ModuleInstanceCreate(Name);
+  WasmEdge_StringDelete(Name);
+  Name = WasmEdge_StringCreateByCString("mem");
+  WasmEdge_ModuleInstanceAddMemory(HostMod, Name, ROMemCxt);
+  WasmEdge_StringDelete(Name);
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
+  ASSERT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_VMRegisterModuleFromImport(VM, HostMod)));
+  ASSERT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromBuffer(
+      VM, Wasm.data(), static_cast<uint32_t>(Wasm.size()))));
+  ASSERT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM)));
+  ASSERT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM)));
+
+  // The guest writes trap as out of bounds, and the reads succeed.
+  WasmEdge_Value R;
+  Name = WasmEdge_StringCreateByCString("store");
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_MemoryOutOfBounds,
+                         WasmEdge_VMExecute(VM, Name, nullptr, 0, nullptr, 0)));
+  WasmEdge_StringDelete(Name);
+  Name = WasmEdge_StringCreateByCString("fill");
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_MemoryOutOfBounds,
+                         WasmEdge_VMExecute(VM, Name, nullptr, 0, nullptr, 0)));
+  WasmEdge_StringDelete(Name);
+  Name = WasmEdge_StringCreateByCString("load");
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_VMExecute(VM, Name, nullptr, 0, &R, 1)));
+  EXPECT_EQ(WasmEdge_ValueGetI32(R), 7);
+  WasmEdge_StringDelete(Name);
+  EXPECT_EQ(*WasmEdge_MemoryInstanceGetPointerConst(ROMemCxt, 0, 1), 0);
+
+  WasmEdge_VMDelete(VM);
+  WasmEdge_ModuleInstanceDelete(HostMod);
+}
+#endif
+
 TEST(APICoreTest, ModuleInstance) {
   WasmEdge_String HostName;
   WasmEdge_ConfigureContext *Conf = nullptr;
@@ -2557,6 +2863,27 @@ TEST(APICoreTest, ModuleInstance) {
     EXPECT_EQ(RetStatus, 2);
     EXPECT_EQ(NativeHandler, 100);
   }
+  // Get WASI I/O statistics.
+  {
+    auto Stat = WasmEdge_ModuleInstanceWASIGetIOStatistics(HostMod);
+    EXPECT_EQ(Stat.BytesRead, 0U);
+    EXPECT_EQ(Stat.BytesWritten, 0U);
+    EXPECT_EQ(Stat.Calls, 0U);
+    EXPECT_EQ(Stat.PollWakeups, 0U);
+    Stat = WasmEdge_ModuleInstanceWASIGetIOStatistics(nullptr);
+    EXPECT_EQ(Stat.Calls, 0U);
+    uint64_t Buckets[32];
+    EXPECT_EQ(WasmEdge_ModuleInstanceWASIGetLatencyHistogram(
+                  HostMod, WasmEdge_StringWrap("fd_read", 7), Buckets, 32),
+              32U);
+    EXPECT_EQ(Buckets[0], 0U);
+    EXPECT_EQ(WasmEdge_ModuleInstanceWASIGetLatencyHistogram(
+                  HostMod, WasmEdge_StringWrap("no_such", 7), Buckets, 32),
+              0U);
+    EXPECT_EQ(WasmEdge_ModuleInstanceWASIGetLatencyHistogram(
+                  nullptr, WasmEdge_StringWrap("fd_read", 7), Buckets, 32),
+              0U);
+  }
   // Get WASI exit code.
   EXPECT_EQ(WasmEdge_ModuleInstanceWASIGetExitCode(HostMod), EXIT_SUCCESS);
   EXPECT_EQ(WasmEdge_ModuleInstanceWASIGetExitCode(nullptr), EXIT_FAILURE);
@@ -2637,6 +2964,14 @@ TEST(APICoreTest, Async) {
   EXPECT_TRUE(WasmEdge_ValTypeIsI32(R[0].Type));
   EXPECT_EQ(912, WasmEdge_ValueGetI32(R[1]));
   EXPECT_TRUE(WasmEdge_ValTypeIsI32(R[1].Type));
+  // Completion callback of the finished execution
+  std::atomic_uint32_t CallbackCount = 0;
+  WasmEdge_AsyncSetCallback(
+      Async,
+      [](void *Data) { ++*static_cast<std::atomic_uint32_t *>(Data); },
+      &CallbackCount);
+  EXPECT_EQ(CallbackCount.load(), 1U);
+  WasmEdge_AsyncSetCallback(nullptr, nullptr, nullptr);
   WasmEdge_AsyncDelete(Async);
   // VM nullptr case
   Async = WasmEdge_VMAsyncRunWasmFromFile(nullptr, TPath, FuncName, P, 2);
@@ -3127,6 +3462,81 @@ TEST(APICoreTest, Async) {
   WasmEdge_ExecutorDelete(Exec);
 }
 
+TEST(APICoreTest, Resumable) {
+  std::array<int32_t, 2> Slots = {-1, -1};
+  WasmEdge_ValType Types[1] = {WasmEdge_ValTypeGenI32()};
+  WasmEdge_FunctionTypeContext *FuncType =
+      WasmEdge_FunctionTypeCreate(Types, 1, Types, 1);
+  WasmEdge_FunctionInstanceContext *FuncCxt =
+      WasmEdge_FunctionInstanceCreate(FuncType, externSuspend, &Slots, 0);
+  WasmEdge_FunctionTypeDelete(FuncType);
+  ASSERT_NE(FuncCxt, nullptr);
+  WasmEdge_ExecutorContext *ExecCxt = WasmEdge_ExecutorCreate(nullptr, nullptr);
+  WasmEdge_Value P[2] = {WasmEdge_ValueGenI32(0), WasmEdge_ValueGenI32(1)};
+  WasmEdge_Value R[1];
+
+  // The executions suspended in the host function are resumed in any order.
+  WasmEdge_Resumable *Res1 =
+      WasmEdge_ExecutorResumableInvoke(ExecCxt, FuncCxt, &P[0], 1);
+  WasmEdge_Resumable *Res2 =
+      WasmEdge_ExecutorResumableInvoke(ExecCxt, FuncCxt, &P[1], 1);
+  ASSERT_NE(Res1, nullptr);
+  ASSERT_NE(Res2, nullptr);
+  EXPECT_FALSE(WasmEdge_ResumableResume(Res1));
+  EXPECT_FALSE(WasmEdge_ResumableResume(Res2));
+  EXPECT_EQ(WasmEdge_ResumableGetReturnsLength(Res1), 0U);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ResumableGet(Res1, R, 1)));
+  EXPECT_FALSE(WasmEdge_ResumableResume(Res1));
+  Slots[1] = 20;
+  EXPECT_TRUE(WasmEdge_ResumableResume(Res2));
+  EXPECT_EQ(WasmEdge_ResumableGetReturnsLength(Res2), 1U);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_ResumableGet(Res2, R, 1)));
+  EXPECT_EQ(WasmEdge_ValueGetI32(R[0]), 21);
+  Slots[0] = 10;
+  EXPECT_TRUE(WasmEdge_ResumableResume(Res1));
+  EXPECT_TRUE(WasmEdge_ResumableResume(Res1));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_ResumableGet(Res1, R, 1)));
+  EXPECT_EQ(WasmEdge_ValueGetI32(R[0]), 11);
+  WasmEdge_ResumableDelete(Res1);
+  WasmEdge_ResumableDelete(Res2);
+
+  // The suspensions are refused when deleting the unfinished executions.
+  Slots = {-1, -1};
+  Res1 = WasmEdge_ExecutorResumableInvoke(ExecCxt, FuncCxt, &P[0], 1);
+  ASSERT_NE(Res1, nullptr);
+  EXPECT_FALSE(WasmEdge_ResumableResume(Res1));
+  WasmEdge_ResumableDelete(Res1);
+  Res1 = WasmEdge_ExecutorResumableInvoke(ExecCxt, FuncCxt, &P[0], 1);
+  WasmEdge_ResumableDelete(Res1);
+
+  // The invocations not resumable cannot be suspended.
+  EXPECT_TRUE(
+      isErrMatch(WasmEdge_ErrCategory_UserLevelError, 1U,
+                 WasmEdge_ExecutorInvoke(ExecCxt, FuncCxt, P, 1, R, 1)));
+
+  // The function type is checked at the first resumption.
+  Res1 = WasmEdge_ExecutorResumableInvoke(ExecCxt, FuncCxt, nullptr, 0);
+  ASSERT_NE(Res1, nullptr);
+  EXPECT_TRUE(WasmEdge_ResumableResume(Res1));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_FuncSigMismatch,
+                         WasmEdge_ResumableGet(Res1, R, 1)));
+  WasmEdge_ResumableDelete(Res1);
+
+  // The null cases.
+  EXPECT_EQ(WasmEdge_ExecutorResumableInvoke(nullptr, FuncCxt, P, 1), nullptr);
+  EXPECT_EQ(WasmEdge_ExecutorResumableInvoke(ExecCxt, nullptr, P, 1), nullptr);
+  EXPECT_TRUE(WasmEdge_ResumableResume(nullptr));
+  EXPECT_EQ(WasmEdge_ResumableGetReturnsLength(nullptr), 0U);
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_ResumableGet(nullptr, R, 1)));
+  EXPECT_FALSE(WasmEdge_CallingFrameSuspend(nullptr));
+  WasmEdge_ResumableDelete(nullptr);
+
+  WasmEdge_FunctionInstanceDelete(FuncCxt);
+  WasmEdge_ExecutorDelete(ExecCxt);
+}
+
 TEST(APICoreTest, VM) {
   WasmEdge_ConfigureContext *Conf = WasmEdge_ConfigureCreate();
   WasmEdge_ConfigureAddHostRegistration(Conf, WasmEdge_HostRegistration_Wasi);
@@ -3689,12 +4099,238 @@ TEST(APICoreTest, VM) {
   EXPECT_NE(WasmEdge_VMGetStatisticsContext(VM), nullptr);
   EXPECT_EQ(WasmEdge_VMGetStatisticsContext(nullptr), nullptr);
 
+  // VM set epoch deadline
+  WasmEdge_VMSetEpochDeadline(nullptr, 1);
+  EXPECT_TRUE(true);
+
   WasmEdge_ASTModuleDelete(Mod);
   WasmEdge_ModuleInstanceDelete(HostMod);
   WasmEdge_StoreDelete(Store);
   WasmEdge_VMDelete(VM);
 }
 
+TEST(APICoreTest, VMPool) {
+  // (table 1 1 funcref)
+  // (global $g (mut i32) (i32.const 0))
+  // (elem (i32.const 0) $get)
+  // (start $start)
+  // (func $get (result i32) global.get $g)
+  // (func $start i32.const 5 global.set $g)
+  // (func (export "inc") (result i32)
+  //   global.get $g i32.const 1 i32.add global.set $g
+  //   i32.const 0 call_indirect (result i32))
+  std::array<uint8_t, 90> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+      0x00, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x04, 0x03, 0x00, 0x01, 0x00,
+      0x04, 0x05, 0x01, 0x70, 0x01, 0x01, 0x01, 0x06, 0x06, 0x01, 0x7f, 0x01,
+      0x41, 0x00, 0x0b, 0x07, 0x07, 0x01, 0x03, 0x69, 0x6e, 0x63, 0x00, 0x02,
+      0x08, 0x01, 0x01, 0x09, 0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x00,
+      0x0a, 0x1c, 0x03, 0x04, 0x00, 0x23, 0x00, 0x0b, 0x06, 0x00, 0x41, 0x05,
+      0x24, 0x00, 0x0b, 0x0e, 0x00, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24, 0x00,
+      0x41, 0x00, 0x11, 0x00, 0x00, 0x0b};
+  WasmEdge_LoaderContext *Loader = WasmEdge_LoaderCreate(nullptr);
+  WasmEdge_ASTModuleContext *Mod = nullptr;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_LoaderParseFromBytes(
+      Loader, &Mod,
+      WasmEdge_BytesWrap(Wasm.data(), static_cast<uint32_t>(Wasm.size())))));
+  ASSERT_NE(Mod, nullptr);
+  WasmEdge_String FuncName = WasmEdge_StringCreateByCString("inc");
+  WasmEdge_Value R[1];
+  auto Inc = [&](WasmEdge_VMContext *VM) {
+    EXPECT_TRUE(
+        WasmEdge_ResultOK(WasmEdge_VMExecute(VM, FuncName, nullptr, 0, R, 1)));
+    return WasmEdge_ValueGetI32(R[0]);
+  };
+
+  // Snapshot strategy
+  WasmEdge_VMPoolContext *Pool =
+      WasmEdge_VMPoolCreate(nullptr, 2, WasmEdge_VMPoolReset_Snapshot);
+  ASSERT_NE(Pool, nullptr);
+  EXPECT_EQ(WasmEdge_VMPoolGetSize(Pool), 2U);
+  EXPECT_EQ(WasmEdge_VMPoolGetSize(nullptr), 0U);
+  EXPECT_NE(WasmEdge_VMPoolGetVMContext(Pool, 1), nullptr);
+  EXPECT_EQ(WasmEdge_VMPoolGetVMContext(Pool, 2), nullptr);
+  WasmEdge_VMContext *VM1 = nullptr, *VM2 = nullptr, *VM3 = nullptr;
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMPoolLease(Pool, &VM1)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMPoolInstantiate(Pool, nullptr)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolInstantiate(Pool, Mod)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_VMPoolInstantiate(Pool, Mod)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolLease(Pool, &VM1)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolTryLease(Pool, &VM2)));
+  ASSERT_NE(VM1, nullptr);
+  ASSERT_NE(VM2, nullptr);
+  EXPECT_NE(VM1, VM2);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolTryLease(Pool, &VM3)));
+  EXPECT_EQ(VM3, nullptr);
+  EXPECT_EQ(Inc(VM1), 6);
+  EXPECT_EQ(Inc(VM1), 7);
+  WasmEdge_VMPoolReturn(Pool, VM1);
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolLease(Pool, &VM3)));
+  EXPECT_EQ(VM3, VM1);
+  EXPECT_EQ(Inc(VM3), 6);
+  WasmEdge_VMPoolReturn(Pool, VM2);
+  WasmEdge_VMPoolReturn(Pool, VM3);
+  WasmEdge_VMPoolMetrics Metrics;
+  WasmEdge_VMPoolGetMetrics(Pool, &Metrics);
+  EXPECT_EQ(Metrics.Leases, 3U);
+  EXPECT_EQ(Metrics.Hits, 3U);
+  EXPECT_EQ(Metrics.Misses, 1U);
+  EXPECT_EQ(Metrics.ResetFailures, 0U);
+  EXPECT_EQ(Metrics.InUse, 0U);
+
+  // Asynchronous executions on the leased VMs
+  EXPECT_EQ(WasmEdge_VMPoolAsyncExecute(nullptr, FuncName, nullptr, 0),
+            nullptr);
+  for (uint32_t I = 0; I < 4; ++I) {
+    WasmEdge_Async *Async =
+        WasmEdge_VMPoolAsyncExecute(Pool, FuncName, nullptr, 0);
+    ASSERT_NE(Async, nullptr);
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_AsyncGet(Async, R, 1)));
+    EXPECT_EQ(WasmEdge_ValueGetI32(R[0]), 6);
+    WasmEdge_AsyncDelete(Async);
+  }
+  WasmEdge_VMPoolGetMetrics(Pool, &Metrics);
+  EXPECT_EQ(Metrics.Leases, 7U);
+  EXPECT_EQ(Metrics.InUse, 0U);
+  WasmEdge_VMPoolDelete(Pool);
+
+  // Reuse and reinstantiate strategies
+  for (auto Reset :
+       {WasmEdge_VMPoolReset_Reuse, WasmEdge_VMPoolReset_Reinstantiate}) {
+    Pool = WasmEdge_VMPoolCreate(nullptr, 1, Reset);
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolInstantiate(Pool, Mod)));
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolLease(Pool, &VM1)));
+    EXPECT_EQ(Inc(VM1), 6);
+    WasmEdge_VMPoolReturn(Pool, VM1);
+    EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMPoolLease(Pool, &VM1)));
+    EXPECT_EQ(Inc(VM1), Reset == WasmEdge_VMPoolReset_Reuse ? 7 : 6);
+    WasmEdge_VMPoolReturn(Pool, VM1);
+    WasmEdge_VMPoolDelete(Pool);
+  }
+
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_ASTModuleDelete(Mod);
+  WasmEdge_LoaderDelete(Loader);
+}
+
+TEST(APICoreTest, PreparedCall) {
+  // (func (export "add") (param i32 i32) (result i32)
+  //   local.get 0 local.get 1 i32.add)
+  std::array<uint8_t, 41> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01,
+      0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+      0x00, 0x20, 0x01, 0x6a, 0x0b};
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
+  WasmEdge_Bytes Bytes =
+      WasmEdge_BytesWrap(Wasm.data(), static_cast<uint32_t>(Wasm.size()));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromBytes(VM, Bytes)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM)));
+  WasmEdge_String FuncName = WasmEdge_StringCreateByCString("add");
+  WasmEdge_String FuncName2 = WasmEdge_StringCreateByCString("sub");
+  WasmEdge_ValType Types[2] = {WasmEdge_ValTypeGenI32(),
+                               WasmEdge_ValTypeGenI64()};
+
+  // Prepare with the mismatched parameter types or the unknown function.
+  EXPECT_EQ(WasmEdge_VMPrepareCall(nullptr, FuncName, Types, 2), nullptr);
+  EXPECT_EQ(WasmEdge_VMPrepareCall(VM, FuncName, Types, 2), nullptr);
+  EXPECT_EQ(WasmEdge_VMPrepareCall(VM, FuncName, Types, 1), nullptr);
+  Types[1] = WasmEdge_ValTypeGenI32();
+  EXPECT_EQ(WasmEdge_VMPrepareCall(VM, FuncName2, Types, 2), nullptr);
+
+  // Prepare by the VM.
+  WasmEdge_PreparedCallContext *Call =
+      WasmEdge_VMPrepareCall(VM, FuncName, Types, 2);
+  ASSERT_NE(Call, nullptr);
+  EXPECT_EQ(WasmEdge_PreparedCallGetParamLength(Call), 2U);
+  EXPECT_EQ(WasmEdge_PreparedCallGetReturnLength(Call), 1U);
+  EXPECT_EQ(WasmEdge_PreparedCallGetParamLength(nullptr), 0U);
+  uint128_t P[2], R[1];
+  for (int32_t I = -50; I < 50; ++I) {
+    P[0] = WasmEdge_ValueGenI32(I).Value;
+    P[1] = WasmEdge_ValueGenI32(3 * I).Value;
+    EXPECT_TRUE(
+        WasmEdge_ResultOK(WasmEdge_PreparedCallInvoke(Call, P, 2, R, 1)));
+    EXPECT_EQ(
+        WasmEdge_ValueGetI32(WasmEdge_Value{R[0], WasmEdge_ValTypeGenI32()}),
+        4 * I);
+  }
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_FuncSigMismatch,
+                         WasmEdge_PreparedCallInvoke(Call, P, 1, R, 1)));
+  EXPECT_TRUE(isErrMatch(WasmEdge_ErrCode_WrongVMWorkflow,
+                         WasmEdge_PreparedCallInvoke(nullptr, P, 2, R, 1)));
+  // The return values are filled up to the buffer length.
+  EXPECT_TRUE(
+      WasmEdge_ResultOK(WasmEdge_PreparedCallInvoke(Call, P, 2, nullptr, 0)));
+  WasmEdge_PreparedCallDelete(Call);
+
+  // Prepare by the executor and the function instance.
+  const WasmEdge_ModuleInstanceContext *ModInst =
+      WasmEdge_VMGetActiveModule(VM);
+  const WasmEdge_FunctionInstanceContext *FuncInst =
+      WasmEdge_ModuleInstanceFindFunction(ModInst, FuncName);
+  WasmEdge_ExecutorContext *Exec = WasmEdge_VMGetExecutorContext(VM);
+  EXPECT_EQ(WasmEdge_PreparedCallCreate(Exec, nullptr, Types, 2), nullptr);
+  Call = WasmEdge_PreparedCallCreate(Exec, FuncInst, Types, 2);
+  ASSERT_NE(Call, nullptr);
+  P[0] = WasmEdge_ValueGenI32(INT32_MAX).Value;
+  P[1] = WasmEdge_ValueGenI32(1).Value;
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_PreparedCallInvoke(Call, P, 2, R, 1)));
+  EXPECT_EQ(
+      WasmEdge_ValueGetI32(WasmEdge_Value{R[0], WasmEdge_ValTypeGenI32()}),
+      INT32_MIN);
+  WasmEdge_PreparedCallDelete(Call);
+  WasmEdge_PreparedCallDelete(nullptr);
+
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_StringDelete(FuncName2);
+  WasmEdge_VMDelete(VM);
+}
+
+TEST(APICoreTest, Metrics) {
+  // (func (export "add") (param i32 i32) (result i32)
+  //   local.get 0 local.get 1 i32.add)
+  std::array<uint8_t, 41> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01,
+      0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+      0x00, 0x20, 0x01, 0x6a, 0x0b};
+  WasmEdge_MetricsEnable();
+  WasmEdge_MetricsClear();
+  EXPECT_TRUE(WasmEdge_MetricsIsEnabled());
+
+  WasmEdge_VMContext *VM = WasmEdge_VMCreate(nullptr, nullptr);
+  WasmEdge_Bytes Bytes =
+      WasmEdge_BytesWrap(Wasm.data(), static_cast<uint32_t>(Wasm.size()));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMLoadWasmFromBytes(VM, Bytes)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMValidate(VM)));
+  EXPECT_TRUE(WasmEdge_ResultOK(WasmEdge_VMInstantiate(VM)));
+  WasmEdge_String FuncName = WasmEdge_StringCreateByCString("add");
+  WasmEdge_Value P[2] = {WasmEdge_ValueGenI32(1), WasmEdge_ValueGenI32(2)};
+  WasmEdge_Value R[1];
+  for (uint32_t I = 0; I < 3; ++I) {
+    EXPECT_TRUE(
+        WasmEdge_ResultOK(WasmEdge_VMExecute(VM, FuncName, P, 2, R, 1)));
+  }
+  WasmEdge_StringDelete(FuncName);
+  WasmEdge_VMDelete(VM);
+
+  // The executions are aggregated by the module instance name.
+  WasmEdge_String Text = WasmEdge_MetricsRender();
+  const std::string_view View(Text.Buf, Text.Length);
+  EXPECT_NE(View.find("wasmedge_invocations_total{module=\"\"} 3\n"sv),
+            std::string_view::npos);
+  EXPECT_NE(View.find("wasmedge_memory_pages{module=\"\"} 0\n"sv),
+            std::string_view::npos);
+  EXPECT_EQ(View.substr(View.size() - 6), "# EOF\n"sv);
+  WasmEdge_StringDelete(Text);
+  WasmEdge_MetricsClear();
+}
+
 #if defined(WASMEDGE_BUILD_PLUGINS)
 TEST(APICoreTest, Plugin) {
   WasmEdge_String Names[15];
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/arena.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+using ArenaVec = std::vector<uint64_t, WasmEdge::ArenaAllocator<uint64_t>>;
+
+TEST(ArenaTest, Allocate) {
+  WasmEdge::Arena A;
+  auto *P1 = static_cast<uint8_t *>(A.allocate(3, 1));
+  auto *P2 = static_cast<uint8_t *>(A.allocate(8, 8));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(P2) % 8, 0U);
+  EXPECT_GE(P2, P1 + 3);
+  // The oversized requests get their own blocks.
+  auto *P3 = static_cast<uint8_t *>(A.allocate(16 * 1024 * 1024, 16));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(P3) % 16, 0U);
+  auto *P4 = static_cast<uint8_t *>(A.allocate(8, 8));
+  EXPECT_EQ(P4, P2 + 8);
+}
+
+TEST(ArenaTest, Containers) {
+  WasmEdge::Arena A;
+  ArenaVec V1{WasmEdge::ArenaAllocator<uint64_t>(&A)};
+  for (uint64_t I = 0; I < 1000; ++I) {
+    V1.push_back(I);
+  }
+  EXPECT_GT(A.getAllocatedSize(), 0U);
+  // The copies are allocated from the heap.
+  ArenaVec V2(V1);
+  EXPECT_EQ(V2.get_allocator().getArena(), nullptr);
+  EXPECT_EQ(V1, V2);
+  // The moved containers keep the arena.
+  ArenaVec V3;
+  V3 = std::move(V1);
+  EXPECT_EQ(V3.get_allocator().getArena(), &A);
+  EXPECT_EQ(V3, V2);
+}
+
+} // namespace
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/profile.h"
+
+#include <cstdint>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+using namespace std::literals;
+
+TEST(ProfileTest, SaveAndLoad) {
+  const auto Path =
+      std::filesystem::temp_directory_path() / "wasmedge_profile_test.txt"sv;
+  {
+    WasmEdge::Statistics::Profile Profile;
+    Profile.recordCall(100);
+    Profile.recordCall(100);
+    Profile.recordCall(200);
+    Profile.recordBranch(110, true);
+    Profile.recordBranch(110, true);
+    Profile.recordBranch(110, false);
+    Profile.recordIndirectCall(120, 200);
+    Profile.recordIndirectCall(120, 300);
+    Profile.recordIndirectCall(120, 200);
+    ASSERT_TRUE(Profile.save(Path));
+  }
+
+  WasmEdge::Statistics::Profile Profile;
+  ASSERT_TRUE(Profile.load(Path));
+  EXPECT_EQ(Profile.getCallCount(100), 2U);
+  EXPECT_EQ(Profile.getCallCount(200), 1U);
+  EXPECT_EQ(Profile.getCallCount(300), 0U);
+  const auto *Branch = Profile.getBranch(110);
+  ASSERT_NE(Branch, nullptr);
+  EXPECT_EQ(Branch->Taken, 2U);
+  EXPECT_EQ(Branch->NotTaken, 1U);
+  EXPECT_EQ(Profile.getBranch(100), nullptr);
+  const auto *Targets = Profile.getIndirectCall(120);
+  ASSERT_NE(Targets, nullptr);
+  EXPECT_EQ(Targets->size(), 2U);
+  EXPECT_EQ(Targets->at(200), 2U);
+  EXPECT_EQ(Targets->at(300), 1U);
+
+  // Loading again merges the counts.
+  ASSERT_TRUE(Profile.load(Path));
+  EXPECT_EQ(Profile.getCallCount(100), 4U);
+  EXPECT_EQ(Profile.getBranch(110)->NotTaken, 2U);
+
+  // A malformed file changes nothing.
+  {
+    std::ofstream OS(Path, std::ios::out | std::ios::trunc);
+    OS << "wasmedge-profile 1\ncall 100 1\nbranch 110\n";
+  }
+  EXPECT_FALSE(Profile.load(Path));
+  EXPECT_EQ(Profile.getCallCount(100), 4U);
+
+  Profile.clear();
+  EXPECT_TRUE(Profile.empty());
+  std::filesystem::remove(Path);
+}
+
+} // namespace
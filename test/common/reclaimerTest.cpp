@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/reclaimer.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace {
+
+/// Object recording the thread destroying it.
+struct Probe {
+  Probe(std::thread::id &Id) noexcept : DestroyedOn(&Id) {}
+  ~Probe() { *DestroyedOn = std::this_thread::get_id(); }
+  std::thread::id *DestroyedOn;
+};
+
+TEST(ReclaimerTest, DestroyAtOnce) {
+  ASSERT_FALSE(WasmEdge::Reclaimer::isEnabled());
+  std::thread::id Id;
+  WasmEdge::Reclaimer::release(std::make_unique<Probe>(Id));
+  EXPECT_EQ(Id, std::this_thread::get_id());
+}
+
+TEST(ReclaimerTest, DestroyInBackground) {
+  WasmEdge::Reclaimer::setEnabled(true);
+  EXPECT_TRUE(WasmEdge::Reclaimer::isEnabled());
+  std::thread::id Ids[100];
+  for (auto &Id : Ids) {
+    WasmEdge::Reclaimer::release(std::make_unique<Probe>(Id));
+  }
+  WasmEdge::Reclaimer::drain();
+  EXPECT_EQ(WasmEdge::Reclaimer::getPendingCount(), UINT64_C(0));
+  for (const auto &Id : Ids) {
+    EXPECT_NE(Id, std::thread::id());
+    EXPECT_NE(Id, std::this_thread::get_id());
+  }
+
+  // Disabling waits for the queued objects.
+  std::thread::id Last;
+  WasmEdge::Reclaimer::release(std::make_unique<Probe>(Last));
+  WasmEdge::Reclaimer::setEnabled(false);
+  EXPECT_NE(Last, std::thread::id());
+  EXPECT_EQ(WasmEdge::Reclaimer::getPendingCount(), UINT64_C(0));
+}
+
+} // namespace
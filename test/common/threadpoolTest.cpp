@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/threadpool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+
+namespace {
+using namespace std::literals;
+
+/// Counter to wait for the tasks.
+struct Latch {
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  uint32_t Count = 0;
+
+  void arrive() {
+    std::unique_lock Lock(Mutex);
+    ++Count;
+    Cond.notify_all();
+  }
+  bool wait(uint32_t Expected) {
+    std::unique_lock Lock(Mutex);
+    return Cond.wait_for(Lock, 10s, [&]() { return Count >= Expected; });
+  }
+};
+
+TEST(ThreadPoolTest, RunTasks) {
+  WasmEdge::ThreadPool Pool;
+  Latch Done;
+  for (uint32_t I = 0; I < 1000; ++I) {
+    Pool.submit([&Done]() { Done.arrive(); });
+  }
+  EXPECT_TRUE(Done.wait(1000));
+}
+
+TEST(ThreadPoolTest, SubmitFromWorker) {
+  WasmEdge::ThreadPool Pool;
+  Latch Done;
+  for (uint32_t I = 0; I < 10; ++I) {
+    Pool.submit([&Pool, &Done]() {
+      for (uint32_t J = 0; J < 10; ++J) {
+        Pool.submit([&Done]() { Done.arrive(); });
+      }
+    });
+  }
+  EXPECT_TRUE(Done.wait(100));
+}
+
+TEST(ThreadPoolTest, MaxThreads) {
+  WasmEdge::ThreadPool Pool;
+  Pool.setMaxThreads(2);
+  EXPECT_EQ(Pool.getMaxThreads(), 2U);
+  std::atomic_uint32_t Running = 0;
+  std::atomic_uint32_t MaxRunning = 0;
+  Latch Done;
+  for (uint32_t I = 0; I < 8; ++I) {
+    Pool.submit([&]() {
+      const uint32_t Now = ++Running;
+      uint32_t Max = MaxRunning.load();
+      while (Now > Max && !MaxRunning.compare_exchange_weak(Max, Now)) {
+      }
+      std::this_thread::sleep_for(10ms);
+      --Running;
+      Done.arrive();
+    });
+  }
+  EXPECT_TRUE(Done.wait(8));
+  EXPECT_LE(MaxRunning.load(), 2U);
+  EXPECT_LE(Pool.getThreadCount(), 2U);
+}
+
+} // namespace
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/trace.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+namespace {
+using namespace std::literals;
+
+TEST(TraceTest, RecordAndSave) {
+  {
+    // Nothing is recorded before enabling.
+    WasmEdge::Trace::Scope Scope("test"sv, "disabled"sv);
+  }
+  EXPECT_TRUE(WasmEdge::Trace::getEvents().empty());
+
+  WasmEdge::Trace::enable();
+  ASSERT_TRUE(WasmEdge::Trace::isEnabled());
+  {
+    WasmEdge::Trace::Scope Outer("test"sv, "outer"sv);
+    {
+      WasmEdge::Trace::Scope Inner("test"sv, "inner"sv, "\"quoted\""sv);
+      std::this_thread::sleep_for(1ms);
+    }
+  }
+
+  const auto Events = WasmEdge::Trace::getEvents();
+  ASSERT_EQ(Events.size(), 2U);
+  EXPECT_EQ(Events[0].Name, "outer"sv);
+  EXPECT_EQ(Events[1].Name, "inner \"quoted\""sv);
+  EXPECT_EQ(Events[0].Category, "test"sv);
+  EXPECT_EQ(Events[0].ThreadId, Events[1].ThreadId);
+  EXPECT_LE(Events[0].Start, Events[1].Start);
+  EXPECT_GE(Events[0].Duration, Events[1].Duration);
+  EXPECT_GE(Events[1].Duration, 1ms);
+
+  const auto Path =
+      std::filesystem::temp_directory_path() / "wasmedge_trace_test.json"sv;
+  ASSERT_TRUE(WasmEdge::Trace::saveChromeTrace(Path));
+  std::ifstream IS(Path);
+  std::stringstream SS;
+  SS << IS.rdbuf();
+  const auto Content = SS.str();
+  EXPECT_EQ(Content.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["sv, 0),
+            0U);
+  EXPECT_NE(Content.find("\"name\":\"inner \\\"quoted\\\"\""sv),
+            std::string::npos);
+  EXPECT_NE(Content.find("\"ph\":\"X\""sv), std::string::npos);
+  std::filesystem::remove(Path);
+}
+
+} // namespace
@@ -0,0 +1,500 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "common/configure.h"
+#include "vm/vm.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+using namespace std::literals;
+
+// The identity functions of the value types lifted from a core module with a
+// bump allocator as the realloc:
+//   (type $rec (record (field "x" u8) (field "y" u64) (field "z" f32)))
+//   (type $var (variant (case "a" u32) (case "b" u64) (case "c" f32)
+//                       (case "d")))
+//   (type $flags (flags "f0" ... "f9"))
+//   (type $strs (list string))
+//   (type $enum (enum "a" "b" "c"))
+//   (type $pad (tuple u32 ... u32)) ;; 16 fields
+// The exports "record", "variant", "flags", "strings", "string", and "char"
+// take the flattened parameter and store the result in the memory, or return
+// the single flattened result as is. The exports with the "-mem" suffix take
+// the additional "p" parameter of $pad, which moves the parameters into the
+// memory, and return the pointer of the parameters as the pointer of the
+// result, or load the single flattened result from it. The exports "bad-char"
+// (char), "bad-enum" ($enum), "bad-variant" ($var with the case 9 in the
+// memory), and "bad-string" (string of the bytes 0xC3 0x28) return the invalid
+// values.
+const std::vector<uint8_t> RoundTripWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x0d, 0x00, 0x01, 0x00, 0x01, 0xd4, 0x02, 0x00,
+    0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x25, 0x06, 0x60, 0x04,
+    0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60,
+    0x03, 0x7f, 0x7e, 0x7d, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7e, 0x01, 0x7f,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x0c,
+    0x0b, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x05, 0x05, 0x05, 0x01, 0x01,
+    0x05, 0x03, 0x01, 0x00, 0x01, 0x06, 0x07, 0x01, 0x7f, 0x01, 0x41, 0x80,
+    0x08, 0x0b, 0x07, 0x5c, 0x0c, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00, 0x07,
+    0x72, 0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x00, 0x02, 0x69, 0x64,
+    0x00, 0x01, 0x03, 0x72, 0x65, 0x63, 0x00, 0x02, 0x03, 0x76, 0x61, 0x72,
+    0x00, 0x03, 0x04, 0x70, 0x61, 0x69, 0x72, 0x00, 0x04, 0x08, 0x62, 0x61,
+    0x64, 0x2d, 0x63, 0x68, 0x61, 0x72, 0x00, 0x05, 0x05, 0x73, 0x65, 0x76,
+    0x65, 0x6e, 0x00, 0x06, 0x04, 0x70, 0x31, 0x32, 0x38, 0x00, 0x07, 0x04,
+    0x70, 0x31, 0x33, 0x36, 0x00, 0x08, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x31,
+    0x36, 0x00, 0x09, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x33, 0x32, 0x00, 0x0a,
+    0x0a, 0x88, 0x01, 0x0b, 0x19, 0x00, 0x23, 0x00, 0x20, 0x02, 0x6a, 0x41,
+    0x01, 0x6b, 0x41, 0x00, 0x20, 0x02, 0x6b, 0x71, 0x22, 0x00, 0x20, 0x03,
+    0x6a, 0x24, 0x00, 0x20, 0x00, 0x0b, 0x04, 0x00, 0x20, 0x00, 0x0b, 0x19,
+    0x00, 0x41, 0x00, 0x20, 0x00, 0x3a, 0x00, 0x00, 0x41, 0x00, 0x20, 0x01,
+    0x37, 0x03, 0x08, 0x41, 0x00, 0x20, 0x02, 0x38, 0x02, 0x10, 0x41, 0x00,
+    0x0b, 0x12, 0x00, 0x41, 0x00, 0x20, 0x00, 0x3a, 0x00, 0x00, 0x41, 0x00,
+    0x20, 0x01, 0x37, 0x03, 0x08, 0x41, 0x00, 0x0b, 0x12, 0x00, 0x41, 0x00,
+    0x20, 0x00, 0x36, 0x02, 0x00, 0x41, 0x00, 0x20, 0x01, 0x36, 0x02, 0x04,
+    0x41, 0x00, 0x0b, 0x06, 0x00, 0x41, 0x80, 0xb0, 0x03, 0x0b, 0x04, 0x00,
+    0x41, 0x07, 0x0b, 0x05, 0x00, 0x41, 0x80, 0x01, 0x0b, 0x05, 0x00, 0x41,
+    0x88, 0x01, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x2f, 0x01, 0x00, 0x0b, 0x07,
+    0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x0b, 0x1e, 0x03, 0x00, 0x41,
+    0x80, 0x01, 0x0b, 0x01, 0x09, 0x00, 0x41, 0x88, 0x01, 0x0b, 0x08, 0xa0,
+    0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x41, 0xa0, 0x01, 0x0b,
+    0x02, 0xc3, 0x28, 0x02, 0x04, 0x01, 0x00, 0x00, 0x00, 0x06, 0x74, 0x0c,
+    0x00, 0x02, 0x01, 0x00, 0x03, 0x6d, 0x65, 0x6d, 0x00, 0x00, 0x01, 0x00,
+    0x07, 0x72, 0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x00, 0x01, 0x00,
+    0x02, 0x69, 0x64, 0x00, 0x00, 0x01, 0x00, 0x03, 0x72, 0x65, 0x63, 0x00,
+    0x00, 0x01, 0x00, 0x03, 0x76, 0x61, 0x72, 0x00, 0x00, 0x01, 0x00, 0x04,
+    0x70, 0x61, 0x69, 0x72, 0x00, 0x00, 0x01, 0x00, 0x08, 0x62, 0x61, 0x64,
+    0x2d, 0x63, 0x68, 0x61, 0x72, 0x00, 0x00, 0x01, 0x00, 0x05, 0x73, 0x65,
+    0x76, 0x65, 0x6e, 0x00, 0x00, 0x01, 0x00, 0x04, 0x70, 0x31, 0x32, 0x38,
+    0x00, 0x00, 0x01, 0x00, 0x04, 0x70, 0x31, 0x33, 0x36, 0x00, 0x00, 0x01,
+    0x00, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x31, 0x36, 0x00, 0x00, 0x01, 0x00,
+    0x06, 0x6c, 0x6f, 0x61, 0x64, 0x33, 0x32, 0x07, 0xd3, 0x01, 0x16, 0x72,
+    0x03, 0x01, 0x78, 0x7d, 0x01, 0x79, 0x77, 0x01, 0x7a, 0x76, 0x71, 0x04,
+    0x01, 0x61, 0x01, 0x79, 0x00, 0x01, 0x62, 0x01, 0x77, 0x00, 0x01, 0x63,
+    0x01, 0x76, 0x00, 0x01, 0x64, 0x00, 0x00, 0x6e, 0x0a, 0x02, 0x66, 0x30,
+    0x02, 0x66, 0x31, 0x02, 0x66, 0x32, 0x02, 0x66, 0x33, 0x02, 0x66, 0x34,
+    0x02, 0x66, 0x35, 0x02, 0x66, 0x36, 0x02, 0x66, 0x37, 0x02, 0x66, 0x38,
+    0x02, 0x66, 0x39, 0x70, 0x73, 0x6d, 0x03, 0x01, 0x61, 0x01, 0x62, 0x01,
+    0x63, 0x6f, 0x10, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79,
+    0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x40, 0x01, 0x01, 0x61, 0x00,
+    0x00, 0x00, 0x40, 0x01, 0x01, 0x61, 0x01, 0x00, 0x01, 0x40, 0x01, 0x01,
+    0x61, 0x02, 0x00, 0x02, 0x40, 0x01, 0x01, 0x61, 0x03, 0x00, 0x03, 0x40,
+    0x01, 0x01, 0x61, 0x73, 0x00, 0x73, 0x40, 0x01, 0x01, 0x61, 0x74, 0x00,
+    0x74, 0x40, 0x02, 0x01, 0x61, 0x00, 0x01, 0x70, 0x05, 0x00, 0x00, 0x40,
+    0x02, 0x01, 0x61, 0x01, 0x01, 0x70, 0x05, 0x00, 0x01, 0x40, 0x02, 0x01,
+    0x61, 0x02, 0x01, 0x70, 0x05, 0x00, 0x02, 0x40, 0x02, 0x01, 0x61, 0x03,
+    0x01, 0x70, 0x05, 0x00, 0x03, 0x40, 0x02, 0x01, 0x61, 0x73, 0x01, 0x70,
+    0x05, 0x00, 0x73, 0x40, 0x02, 0x01, 0x61, 0x74, 0x01, 0x70, 0x05, 0x00,
+    0x74, 0x40, 0x00, 0x00, 0x74, 0x40, 0x00, 0x00, 0x04, 0x40, 0x00, 0x00,
+    0x01, 0x40, 0x00, 0x00, 0x73, 0x08, 0x91, 0x01, 0x10, 0x00, 0x00, 0x02,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x06, 0x00, 0x00, 0x03, 0x02, 0x03, 0x00,
+    0x04, 0x00, 0x07, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x08,
+    0x00, 0x00, 0x04, 0x02, 0x03, 0x00, 0x04, 0x00, 0x09, 0x00, 0x00, 0x04,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x0a, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00,
+    0x04, 0x00, 0x0b, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x0c,
+    0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x0d, 0x00, 0x00, 0x09,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x0e, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00,
+    0x04, 0x00, 0x0f, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x10,
+    0x00, 0x00, 0x0a, 0x02, 0x03, 0x00, 0x04, 0x00, 0x11, 0x00, 0x00, 0x05,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x12, 0x00, 0x00, 0x06, 0x02, 0x03, 0x00,
+    0x04, 0x00, 0x13, 0x00, 0x00, 0x07, 0x02, 0x03, 0x00, 0x04, 0x00, 0x14,
+    0x00, 0x00, 0x08, 0x02, 0x03, 0x00, 0x04, 0x00, 0x15, 0x0b, 0xd4, 0x01,
+    0x10, 0x00, 0x06, 0x72, 0x65, 0x63, 0x6f, 0x72, 0x64, 0x01, 0x00, 0x00,
+    0x00, 0x07, 0x76, 0x61, 0x72, 0x69, 0x61, 0x6e, 0x74, 0x01, 0x01, 0x00,
+    0x00, 0x05, 0x66, 0x6c, 0x61, 0x67, 0x73, 0x01, 0x02, 0x00, 0x00, 0x07,
+    0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73, 0x01, 0x03, 0x00, 0x00, 0x06,
+    0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x01, 0x04, 0x00, 0x00, 0x04, 0x63,
+    0x68, 0x61, 0x72, 0x01, 0x05, 0x00, 0x00, 0x0a, 0x72, 0x65, 0x63, 0x6f,
+    0x72, 0x64, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x06, 0x00, 0x00, 0x0b, 0x76,
+    0x61, 0x72, 0x69, 0x61, 0x6e, 0x74, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x07,
+    0x00, 0x00, 0x09, 0x66, 0x6c, 0x61, 0x67, 0x73, 0x2d, 0x6d, 0x65, 0x6d,
+    0x01, 0x08, 0x00, 0x00, 0x0b, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73,
+    0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x09, 0x00, 0x00, 0x0a, 0x73, 0x74, 0x72,
+    0x69, 0x6e, 0x67, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x0a, 0x00, 0x00, 0x08,
+    0x63, 0x68, 0x61, 0x72, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x0b, 0x00, 0x00,
+    0x08, 0x62, 0x61, 0x64, 0x2d, 0x63, 0x68, 0x61, 0x72, 0x01, 0x0c, 0x00,
+    0x00, 0x08, 0x62, 0x61, 0x64, 0x2d, 0x65, 0x6e, 0x75, 0x6d, 0x01, 0x0d,
+    0x00, 0x00, 0x0b, 0x62, 0x61, 0x64, 0x2d, 0x76, 0x61, 0x72, 0x69, 0x61,
+    0x6e, 0x74, 0x01, 0x0e, 0x00, 0x00, 0x0a, 0x62, 0x61, 0x64, 0x2d, 0x73,
+    0x74, 0x72, 0x69, 0x6e, 0x67, 0x01, 0x0f, 0x00,
+};
+
+// The functions of a callee core module lifted with its own memory, and
+// lowered into a caller core module:
+//   (type $strs (list string))
+//   (type $u64s (list u64))
+//   (type $pad (tuple u32 ... u32)) ;; 16 fields
+//   "string": (func (param "a" string) (result string))
+//   "strings": (func (param "a" $strs) (result $strs))
+//   "u64s": (func (param "a" $u64s) (result $u64s))
+//   "strings-mem": (func (param "a" $strs) (param "p" $pad) (result $strs))
+// The callee returns the parameters as the results. The caller passes the
+// parameters through and returns the results from the return pointer. The
+// exports with the "sep-" prefix run the caller with the memory of a separate
+// core module, and the ones with the "same-" prefix run the caller with the
+// memory of the callee.
+const std::vector<uint8_t> FusedWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x0d, 0x00, 0x01, 0x00, 0x01, 0x86, 0x01, 0x00,
+    0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x14, 0x03, 0x60, 0x04,
+    0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x04, 0x03, 0x00, 0x01, 0x02, 0x05,
+    0x03, 0x01, 0x00, 0x01, 0x06, 0x07, 0x01, 0x7f, 0x01, 0x41, 0x80, 0x08,
+    0x0b, 0x07, 0x1d, 0x04, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00, 0x07, 0x72,
+    0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x00, 0x02, 0x69, 0x64, 0x00,
+    0x01, 0x04, 0x70, 0x61, 0x69, 0x72, 0x00, 0x02, 0x0a, 0x33, 0x03, 0x19,
+    0x00, 0x23, 0x00, 0x20, 0x02, 0x6a, 0x41, 0x01, 0x6b, 0x41, 0x00, 0x20,
+    0x02, 0x6b, 0x71, 0x22, 0x00, 0x20, 0x03, 0x6a, 0x24, 0x00, 0x20, 0x00,
+    0x0b, 0x04, 0x00, 0x20, 0x00, 0x0b, 0x12, 0x00, 0x41, 0x00, 0x20, 0x00,
+    0x36, 0x02, 0x00, 0x41, 0x00, 0x20, 0x01, 0x36, 0x02, 0x04, 0x41, 0x00,
+    0x0b, 0x01, 0x55, 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01,
+    0x09, 0x01, 0x60, 0x04, 0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02,
+    0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x06, 0x07, 0x01, 0x7f, 0x01,
+    0x41, 0x80, 0x10, 0x0b, 0x07, 0x11, 0x02, 0x03, 0x6d, 0x65, 0x6d, 0x02,
+    0x00, 0x07, 0x72, 0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x00, 0x0a,
+    0x1b, 0x01, 0x19, 0x00, 0x23, 0x00, 0x20, 0x02, 0x6a, 0x41, 0x01, 0x6b,
+    0x41, 0x00, 0x20, 0x02, 0x6b, 0x71, 0x22, 0x00, 0x20, 0x03, 0x6a, 0x24,
+    0x00, 0x20, 0x00, 0x0b, 0x01, 0xbf, 0x01, 0x00, 0x61, 0x73, 0x6d, 0x01,
+    0x00, 0x00, 0x00, 0x01, 0x17, 0x04, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x00,
+    0x60, 0x02, 0x7f, 0x7f, 0x00, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x31, 0x05, 0x04, 0x6c, 0x69, 0x62, 0x63,
+    0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00, 0x01, 0x04, 0x68, 0x6f, 0x73, 0x74,
+    0x01, 0x73, 0x00, 0x00, 0x04, 0x68, 0x6f, 0x73, 0x74, 0x01, 0x6c, 0x00,
+    0x00, 0x04, 0x68, 0x6f, 0x73, 0x74, 0x01, 0x6e, 0x00, 0x00, 0x04, 0x68,
+    0x6f, 0x73, 0x74, 0x01, 0x6d, 0x00, 0x01, 0x03, 0x05, 0x04, 0x02, 0x02,
+    0x02, 0x03, 0x07, 0x25, 0x04, 0x06, 0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x73,
+    0x00, 0x04, 0x06, 0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x6c, 0x00, 0x05, 0x06,
+    0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x6e, 0x00, 0x06, 0x06, 0x63, 0x61, 0x6c,
+    0x6c, 0x2d, 0x6d, 0x00, 0x07, 0x0a, 0x3b, 0x04, 0x0e, 0x00, 0x20, 0x00,
+    0x20, 0x01, 0x41, 0xc0, 0x00, 0x10, 0x00, 0x41, 0xc0, 0x00, 0x0b, 0x0e,
+    0x00, 0x20, 0x00, 0x20, 0x01, 0x41, 0xc0, 0x00, 0x10, 0x01, 0x41, 0xc0,
+    0x00, 0x0b, 0x0e, 0x00, 0x20, 0x00, 0x20, 0x01, 0x41, 0xc0, 0x00, 0x10,
+    0x02, 0x41, 0xc0, 0x00, 0x0b, 0x0c, 0x00, 0x20, 0x00, 0x41, 0xc0, 0x00,
+    0x10, 0x03, 0x41, 0xc0, 0x00, 0x0b, 0x02, 0x07, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x06, 0x39, 0x06, 0x00, 0x00, 0x01, 0x00, 0x07, 0x72,
+    0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x00, 0x01, 0x00, 0x04, 0x70,
+    0x61, 0x69, 0x72, 0x00, 0x00, 0x01, 0x00, 0x02, 0x69, 0x64, 0x00, 0x00,
+    0x01, 0x01, 0x07, 0x72, 0x65, 0x61, 0x6c, 0x6c, 0x6f, 0x63, 0x00, 0x02,
+    0x01, 0x00, 0x03, 0x6d, 0x65, 0x6d, 0x00, 0x02, 0x01, 0x01, 0x03, 0x6d,
+    0x65, 0x6d, 0x07, 0x36, 0x07, 0x70, 0x73, 0x70, 0x77, 0x6f, 0x10, 0x79,
+    0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79, 0x79,
+    0x79, 0x79, 0x79, 0x40, 0x01, 0x01, 0x61, 0x73, 0x00, 0x73, 0x40, 0x01,
+    0x01, 0x61, 0x00, 0x00, 0x00, 0x40, 0x01, 0x01, 0x61, 0x01, 0x00, 0x01,
+    0x40, 0x02, 0x01, 0x61, 0x00, 0x01, 0x70, 0x02, 0x00, 0x00, 0x08, 0x65,
+    0x0c, 0x00, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x03, 0x00, 0x00,
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00, 0x01, 0x02, 0x03,
+    0x00, 0x04, 0x00, 0x05, 0x00, 0x00, 0x02, 0x02, 0x03, 0x00, 0x04, 0x00,
+    0x06, 0x01, 0x00, 0x00, 0x02, 0x03, 0x01, 0x04, 0x03, 0x01, 0x00, 0x01,
+    0x02, 0x03, 0x01, 0x04, 0x03, 0x01, 0x00, 0x02, 0x02, 0x03, 0x01, 0x04,
+    0x03, 0x01, 0x00, 0x03, 0x02, 0x03, 0x01, 0x04, 0x03, 0x01, 0x00, 0x00,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x01, 0x00, 0x01, 0x02, 0x03, 0x00, 0x04,
+    0x00, 0x01, 0x00, 0x02, 0x02, 0x03, 0x00, 0x04, 0x00, 0x01, 0x00, 0x03,
+    0x02, 0x03, 0x00, 0x04, 0x00, 0x02, 0x47, 0x04, 0x01, 0x04, 0x01, 0x73,
+    0x00, 0x04, 0x01, 0x6c, 0x00, 0x05, 0x01, 0x6e, 0x00, 0x06, 0x01, 0x6d,
+    0x00, 0x07, 0x01, 0x04, 0x01, 0x73, 0x00, 0x08, 0x01, 0x6c, 0x00, 0x09,
+    0x01, 0x6e, 0x00, 0x0a, 0x01, 0x6d, 0x00, 0x0b, 0x00, 0x02, 0x02, 0x04,
+    0x6c, 0x69, 0x62, 0x63, 0x12, 0x01, 0x04, 0x68, 0x6f, 0x73, 0x74, 0x12,
+    0x02, 0x00, 0x02, 0x02, 0x04, 0x6c, 0x69, 0x62, 0x63, 0x12, 0x00, 0x04,
+    0x68, 0x6f, 0x73, 0x74, 0x12, 0x03, 0x06, 0x59, 0x08, 0x00, 0x00, 0x01,
+    0x04, 0x06, 0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x73, 0x00, 0x00, 0x01, 0x04,
+    0x06, 0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x6c, 0x00, 0x00, 0x01, 0x04, 0x06,
+    0x63, 0x61, 0x6c, 0x6c, 0x2d, 0x6e, 0x00, 0x00, 0x01, 0x04, 0x06, 0x63,
+    0x61, 0x6c, 0x6c, 0x2d, 0x6d, 0x00, 0x00, 0x01, 0x05, 0x06, 0x63, 0x61,
+    0x6c, 0x6c, 0x2d, 0x73, 0x00, 0x00, 0x01, 0x05, 0x06, 0x63, 0x61, 0x6c,
+    0x6c, 0x2d, 0x6c, 0x00, 0x00, 0x01, 0x05, 0x06, 0x63, 0x61, 0x6c, 0x6c,
+    0x2d, 0x6e, 0x00, 0x00, 0x01, 0x05, 0x06, 0x63, 0x61, 0x6c, 0x6c, 0x2d,
+    0x6d, 0x08, 0x49, 0x08, 0x00, 0x00, 0x0c, 0x02, 0x03, 0x01, 0x04, 0x03,
+    0x03, 0x00, 0x00, 0x0d, 0x02, 0x03, 0x01, 0x04, 0x03, 0x04, 0x00, 0x00,
+    0x0e, 0x02, 0x03, 0x01, 0x04, 0x03, 0x05, 0x00, 0x00, 0x0f, 0x02, 0x03,
+    0x01, 0x04, 0x03, 0x06, 0x00, 0x00, 0x10, 0x02, 0x03, 0x00, 0x04, 0x00,
+    0x03, 0x00, 0x00, 0x11, 0x02, 0x03, 0x00, 0x04, 0x00, 0x04, 0x00, 0x00,
+    0x12, 0x02, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00, 0x00, 0x13, 0x02, 0x03,
+    0x00, 0x04, 0x00, 0x06, 0x0b, 0x85, 0x01, 0x08, 0x00, 0x0a, 0x73, 0x65,
+    0x70, 0x2d, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x01, 0x04, 0x00, 0x00,
+    0x0b, 0x73, 0x65, 0x70, 0x2d, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x73,
+    0x01, 0x05, 0x00, 0x00, 0x08, 0x73, 0x65, 0x70, 0x2d, 0x75, 0x36, 0x34,
+    0x73, 0x01, 0x06, 0x00, 0x00, 0x0f, 0x73, 0x65, 0x70, 0x2d, 0x73, 0x74,
+    0x72, 0x69, 0x6e, 0x67, 0x73, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x07, 0x00,
+    0x00, 0x0b, 0x73, 0x61, 0x6d, 0x65, 0x2d, 0x73, 0x74, 0x72, 0x69, 0x6e,
+    0x67, 0x01, 0x08, 0x00, 0x00, 0x0c, 0x73, 0x61, 0x6d, 0x65, 0x2d, 0x73,
+    0x74, 0x72, 0x69, 0x6e, 0x67, 0x73, 0x01, 0x09, 0x00, 0x00, 0x09, 0x73,
+    0x61, 0x6d, 0x65, 0x2d, 0x75, 0x36, 0x34, 0x73, 0x01, 0x0a, 0x00, 0x00,
+    0x10, 0x73, 0x61, 0x6d, 0x65, 0x2d, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67,
+    0x73, 0x2d, 0x6d, 0x65, 0x6d, 0x01, 0x0b, 0x00,
+};
+
+using Composite = std::shared_ptr<ComponentValComposite>;
+using Results = std::vector<std::pair<ComponentValVariant, ComponentValType>>;
+
+void instantiate(VM::VM &VM, const std::vector<uint8_t> &Wasm) {
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+}
+
+Composite makeComposite(uint32_t Disc, std::vector<ComponentValVariant> Vals) {
+  auto C = std::make_shared<ComponentValComposite>();
+  C->Discriminant = Disc;
+  C->Values = std::move(Vals);
+  return C;
+}
+
+/// Make the value of the padding tuple.
+Composite makePad() {
+  return makeComposite(0, std::vector<ComponentValVariant>(16, UINT32_C(0)));
+}
+
+/// Run the function, and return the single result.
+Expect<ComponentValVariant> run(VM::VM &VM, std::string_view Name,
+                                std::vector<ComponentValVariant> Args,
+                                std::vector<ComponentValType> Types) {
+  EXPECTED_TRY(Results Res, VM.executeComponent(Name, Args, Types));
+  EXPECT_EQ(Res.size(), 1U);
+  return std::move(Res[0].first);
+}
+
+/// Call the identity function of the round trip component.
+Expect<ComponentValVariant> call(VM::VM &VM, std::string_view Func,
+                                 ComponentValVariant Arg, ComponentValType Ty,
+                                 bool InMemory) {
+  if (InMemory) {
+    return run(VM, std::string(Func) + "-mem", {std::move(Arg), makePad()},
+               {Ty, UINT32_C(5)});
+  }
+  return run(VM, Func, {std::move(Arg)}, {Ty});
+}
+
+uint32_t getU32(const ComponentValVariant &V) {
+  return std::get<ValVariant>(V).get<uint32_t>();
+}
+
+uint64_t getU64(const ComponentValVariant &V) {
+  return std::get<ValVariant>(V).get<uint64_t>();
+}
+
+const ComponentValComposite &getComposite(const ComponentValVariant &V) {
+  return *std::get<Composite>(V);
+}
+
+void expectStrings(const ComponentValVariant &V,
+                   const std::vector<std::string> &Expected) {
+  const auto &C = getComposite(V);
+  ASSERT_EQ(C.Values.size(), Expected.size());
+  for (size_t I = 0; I < Expected.size(); ++I) {
+    EXPECT_EQ(std::get<std::string>(C.Values[I]), Expected[I]);
+  }
+}
+
+Composite makeStrings(const std::vector<std::string> &Strs) {
+  std::vector<ComponentValVariant> Vals(Strs.begin(), Strs.end());
+  return makeComposite(0, std::move(Vals));
+}
+
+TEST(ComponentCanon, RoundTripRecord) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  for (bool InMemory : {false, true}) {
+    auto Res = call(VM, "record"sv,
+                    makeComposite(0, {uint8_t(0xAB),
+                                      UINT64_C(0x0123456789ABCDEF), 1.5f}),
+                    UINT32_C(0), InMemory);
+    ASSERT_TRUE(Res);
+    const auto &C = getComposite(*Res);
+    ASSERT_EQ(C.Values.size(), 3U);
+    EXPECT_EQ(getU32(C.Values[0]), 0xABU);
+    EXPECT_EQ(getU64(C.Values[1]), UINT64_C(0x0123456789ABCDEF));
+    EXPECT_EQ(std::get<ValVariant>(C.Values[2]).get<float>(), 1.5f);
+  }
+}
+
+TEST(ComponentCanon, RoundTripVariant) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  // The payloads of u32 and f32 are joined into the i64 of u64 when
+  // flattened.
+  for (bool InMemory : {false, true}) {
+    auto A = call(VM, "variant"sv, makeComposite(0, {UINT32_C(0xFFFFFFFF)}),
+                  UINT32_C(1), InMemory);
+    ASSERT_TRUE(A);
+    EXPECT_EQ(getComposite(*A).Discriminant, 0U);
+    EXPECT_EQ(getU32(getComposite(*A).Values.at(0)), 0xFFFFFFFFU);
+
+    auto B = call(VM, "variant"sv,
+                  makeComposite(1, {UINT64_C(0xFEDCBA9876543210)}),
+                  UINT32_C(1), InMemory);
+    ASSERT_TRUE(B);
+    EXPECT_EQ(getComposite(*B).Discriminant, 1U);
+    EXPECT_EQ(getU64(getComposite(*B).Values.at(0)),
+              UINT64_C(0xFEDCBA9876543210));
+
+    auto C = call(VM, "variant"sv, makeComposite(2, {-2.5f}), UINT32_C(1),
+                  InMemory);
+    ASSERT_TRUE(C);
+    EXPECT_EQ(getComposite(*C).Discriminant, 2U);
+    EXPECT_EQ(std::get<ValVariant>(getComposite(*C).Values.at(0)).get<float>(),
+              -2.5f);
+
+    auto D = call(VM, "variant"sv, makeComposite(3, {}), UINT32_C(1),
+                  InMemory);
+    ASSERT_TRUE(D);
+    EXPECT_EQ(getComposite(*D).Discriminant, 3U);
+    EXPECT_TRUE(getComposite(*D).Values.empty());
+  }
+}
+
+TEST(ComponentCanon, RoundTripFlags) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  // The 10 flags are stored in 2 bytes.
+  for (bool InMemory : {false, true}) {
+    auto Res =
+        call(VM, "flags"sv, makeComposite(0x2A5, {}), UINT32_C(2), InMemory);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(getComposite(*Res).Discriminant, 0x2A5U);
+  }
+}
+
+TEST(ComponentCanon, RoundTripStringAndList) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  const std::vector<std::string> Strs = {"a", "", "\xE4\xB8\x96\xE7\x95\x8C",
+                                         "\xF0\x9F\x98\x80"};
+  for (bool InMemory : {false, true}) {
+    for (const auto &Str : Strs) {
+      auto Res = call(VM, "string"sv, Str, ComponentTypeCode::String,
+                      InMemory);
+      ASSERT_TRUE(Res);
+      EXPECT_EQ(std::get<std::string>(*Res), Str);
+    }
+
+    auto List =
+        call(VM, "strings"sv, makeStrings(Strs), UINT32_C(3), InMemory);
+    ASSERT_TRUE(List);
+    expectStrings(*List, Strs);
+
+    auto Empty = call(VM, "strings"sv, makeStrings({}), UINT32_C(3), InMemory);
+    ASSERT_TRUE(Empty);
+    expectStrings(*Empty, {});
+  }
+}
+
+TEST(ComponentCanon, RoundTripChar) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  for (bool InMemory : {false, true}) {
+    auto Res = call(VM, "char"sv, UINT32_C(0x1F600), ComponentTypeCode::Char,
+                    InMemory);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(getU32(*Res), 0x1F600U);
+
+    // The surrogates are not the unicode scalar values.
+    auto Bad = call(VM, "char"sv, UINT32_C(0xD800), ComponentTypeCode::Char,
+                    InMemory);
+    ASSERT_FALSE(Bad);
+    EXPECT_EQ(Bad.error(), ErrCode::Value::InvalidCanonValue);
+  }
+}
+
+TEST(ComponentCanon, RejectInvalidValues) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, RoundTripWasm);
+
+  for (auto Name : {"bad-char"sv, "bad-enum"sv, "bad-variant"sv,
+                    "bad-string"sv}) {
+    auto Res = run(VM, Name, {}, {});
+    ASSERT_FALSE(Res) << Name;
+    EXPECT_EQ(Res.error(), ErrCode::Value::InvalidCanonValue) << Name;
+  }
+
+  // The case out of the variant is rejected before calling.
+  auto Res = call(VM, "variant"sv, makeComposite(9, {}), UINT32_C(1), false);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), ErrCode::Value::FuncSigMismatch);
+}
+
+TEST(ComponentCanon, FusedAdapter) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+  instantiate(VM, FusedWasm);
+
+  const std::vector<std::string> Strs = {"first", "",
+                                         "\xE4\xB8\x96\xE7\x95\x8C"};
+  for (auto Prefix : {"sep-"s, "same-"s}) {
+    auto Str = run(VM, Prefix + "string", {"hello"s},
+                   {ComponentTypeCode::String});
+    ASSERT_TRUE(Str) << Prefix;
+    EXPECT_EQ(std::get<std::string>(*Str), "hello");
+
+    // The strings in the list are relocated in the nested ranges.
+    auto List =
+        run(VM, Prefix + "strings", {makeStrings(Strs)}, {UINT32_C(0)});
+    ASSERT_TRUE(List) << Prefix;
+    expectStrings(*List, Strs);
+
+    auto Ints = run(
+        VM, Prefix + "u64s",
+        {makeComposite(0, {UINT64_C(1), UINT64_C(0xFFFFFFFFFFFFFFFF)})},
+        {UINT32_C(1)});
+    ASSERT_TRUE(Ints) << Prefix;
+    const auto &C = getComposite(*Ints);
+    ASSERT_EQ(C.Values.size(), 2U);
+    EXPECT_EQ(getU64(C.Values[0]), 1U);
+    EXPECT_EQ(getU64(C.Values[1]), UINT64_C(0xFFFFFFFFFFFFFFFF));
+
+    // The parameters are passed by the pointer into the memory.
+    auto Mem = run(VM, Prefix + "strings-mem", {makeStrings(Strs), makePad()},
+                   {UINT32_C(0), UINT32_C(2)});
+    ASSERT_TRUE(Mem) << Prefix;
+    expectStrings(*Mem, Strs);
+  }
+}
+
+TEST(ComponentCanon, LowerAsyncNotImplemented) {
+  Configure Conf;
+  Conf.addProposal(Proposal::Component);
+  VM::VM VM(Conf);
+
+  // (canon lower (func 0) async (core func)) of a lifted identity of u32.
+  std::vector<uint8_t> Vec = {
+      0x00, 0x61, 0x73, 0x6d, 0x0d, 0x00, 0x01, 0x00, 0x01, 0x24, 0x00, 0x61,
+      0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60, 0x01, 0x7f,
+      0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x01, 0x02, 0x69, 0x64,
+      0x00, 0x00, 0x0a, 0x06, 0x01, 0x04, 0x00, 0x20, 0x00, 0x0b, 0x02, 0x04,
+      0x01, 0x00, 0x00, 0x00, 0x06, 0x08, 0x01, 0x00, 0x00, 0x01, 0x00, 0x02,
+      0x69, 0x64, 0x07, 0x08, 0x01, 0x40, 0x01, 0x01, 0x61, 0x79, 0x00, 0x79,
+      0x08, 0x0b, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01,
+      0x06,
+  };
+  ASSERT_TRUE(VM.loadWasm(Vec));
+  ASSERT_TRUE(VM.validate());
+  auto Res = VM.instantiate();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), ErrCode::Value::ComponentNotImplInstantiate);
+}
+
+} // namespace
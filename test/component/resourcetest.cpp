@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "runtime/instance/component/resource.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+using Runtime::Instance::Component::BorrowScope;
+using Runtime::Instance::Component::ResourceTable;
+
+// Identities of the resource types.
+const int TypeA = 0;
+const int TypeB = 0;
+
+TEST(ResourceTable, AddGetRemove) {
+  ResourceTable Table;
+  auto Own1 = Table.addOwn(&TypeA, 42);
+  auto Own2 = Table.addOwn(&TypeB, 43);
+  ASSERT_TRUE(Own1 && Own2);
+  EXPECT_NE(*Own1, 0U);
+  EXPECT_NE(*Own1, *Own2);
+
+  auto E = Table.get(*Own1, &TypeA);
+  ASSERT_TRUE(E);
+  EXPECT_EQ((*E)->Rep, 42U);
+  EXPECT_TRUE((*E)->isOwn());
+  // The handle is checked against the resource type.
+  EXPECT_EQ(Table.get(*Own1, &TypeB).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  EXPECT_EQ(Table.get(0, &TypeA).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  EXPECT_EQ(Table.get(12345, &TypeA).error(),
+            ErrCode::Value::InvalidResourceHandle);
+
+  auto Removed = Table.remove(*Own1, &TypeA);
+  ASSERT_TRUE(Removed);
+  EXPECT_EQ(Removed->Rep, 42U);
+  EXPECT_FALSE(Table.get(*Own1, &TypeA));
+  EXPECT_FALSE(Table.remove(*Own1, &TypeA));
+  EXPECT_EQ((*Table.get(*Own2, &TypeB))->Rep, 43U);
+
+  // Many handles are added and removed across the slabs.
+  std::vector<uint32_t> Handles;
+  for (uint32_t I = 0; I < 1000; ++I) {
+    auto Handle = Table.addOwn(&TypeA, I);
+    ASSERT_TRUE(Handle);
+    Handles.push_back(*Handle);
+  }
+  for (uint32_t I = 0; I < 1000; ++I) {
+    auto Entry = Table.remove(Handles[I], &TypeA);
+    ASSERT_TRUE(Entry);
+    EXPECT_EQ(Entry->Rep, I);
+  }
+}
+
+TEST(ResourceTable, StaleGeneration) {
+  ResourceTable Table;
+  auto Stale = Table.addOwn(&TypeA, 1);
+  ASSERT_TRUE(Stale);
+  ASSERT_TRUE(Table.remove(*Stale, &TypeA));
+
+  // The slot is reused with the next generation, and the stale handle to it
+  // is rejected.
+  auto Reused = Table.addOwn(&TypeA, 2);
+  ASSERT_TRUE(Reused);
+  EXPECT_EQ(*Reused & 0xFFFFFFU, *Stale & 0xFFFFFFU);
+  EXPECT_NE(*Reused, *Stale);
+  EXPECT_EQ(Table.get(*Stale, &TypeA).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  EXPECT_EQ(Table.remove(*Stale, &TypeA).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  EXPECT_EQ((*Table.get(*Reused, &TypeA))->Rep, 2U);
+}
+
+TEST(ResourceTable, LendBlocksDrop) {
+  ResourceTable Table;
+  auto Own = Table.addOwn(&TypeA, 7);
+  ASSERT_TRUE(Own);
+
+  // The own handle lent into two calls cannot be dropped until both return.
+  auto Lent1 = Table.lend(*Own, &TypeA);
+  auto Lent2 = Table.lend(*Own, &TypeA);
+  ASSERT_TRUE(Lent1 && Lent2);
+  EXPECT_EQ((*Lent1)->LendCount, 2U);
+  EXPECT_EQ(Table.remove(*Own, &TypeA).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  ResourceTable::unlend(**Lent1);
+  EXPECT_FALSE(Table.remove(*Own, &TypeA));
+  ResourceTable::unlend(**Lent2);
+  auto Removed = Table.remove(*Own, &TypeA);
+  ASSERT_TRUE(Removed);
+  EXPECT_EQ(Removed->Rep, 7U);
+  EXPECT_EQ(Removed->LendCount, 0U);
+}
+
+TEST(ResourceTable, CheckScope) {
+  ResourceTable Table;
+  BorrowScope Scope;
+  EXPECT_TRUE(ResourceTable::checkScope(Scope));
+
+  auto Borrow1 = Table.addBorrow(&TypeA, 1, Scope);
+  auto Borrow2 = Table.addBorrow(&TypeA, 2, Scope);
+  ASSERT_TRUE(Borrow1 && Borrow2);
+  EXPECT_FALSE((*Table.get(*Borrow1, &TypeA))->isOwn());
+  EXPECT_EQ(Scope.NumBorrows, 2U);
+
+  // The call cannot exit with the borrows not dropped.
+  EXPECT_EQ(ResourceTable::checkScope(Scope).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  ASSERT_TRUE(Table.remove(*Borrow1, &TypeA));
+  EXPECT_EQ(ResourceTable::checkScope(Scope).error(),
+            ErrCode::Value::InvalidResourceHandle);
+  // The borrow handles are not counted as lent, and the lend of a borrow
+  // handle is not counted either.
+  auto Lent = Table.lend(*Borrow2, &TypeA);
+  ASSERT_TRUE(Lent);
+  EXPECT_EQ((*Lent)->LendCount, 0U);
+  ResourceTable::unlend(**Lent);
+  ASSERT_TRUE(Table.remove(*Borrow2, &TypeA));
+  EXPECT_EQ(Scope.NumBorrows, 0U);
+  EXPECT_TRUE(ResourceTable::checkScope(Scope));
+}
+
+} // namespace
@@ -15,20 +15,29 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/spdlog.h"
+#include "executor/coredump.h"
+#include "runtime/typeregistry.h"
+#include "system/fault.h"
+#include "system/nativestack.h"
+#include "system/numa.h"
+#include "system/sampler.h"
 #include "vm/vm.h"
 
 #include "../spec/hostfunc.h"
 #include "../spec/spectest.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <gtest/gtest.h>
 #include <map>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -220,6 +229,70 @@ TEST(AsyncInvoke, InterruptTest) {
   }
 }
 
+TEST(EpochDeadline, InterruptTest) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(AsyncWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  {
+    // The reached deadline interrupts at once.
+    VM.getExecutor().setEpochDeadline(0);
+    auto Result = VM.execute("_start");
+    EXPECT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Interrupted);
+  }
+  {
+    // The timer advances the epoch to the deadline.
+    WasmEdge::Epoch::startTimer(std::chrono::milliseconds(1));
+    VM.getExecutor().setEpochDeadline(2);
+    auto Result = VM.execute("_start");
+    WasmEdge::Epoch::stopTimer();
+    EXPECT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Interrupted);
+  }
+  VM.getExecutor().setEpochDeadline(UINT64_MAX);
+}
+
+TEST(CpuBudget, InterruptTest) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableCpuAccounting(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(AsyncWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto &Budget = VM.getActiveModule()->getCpuBudget();
+  Budget.setLimit(std::chrono::nanoseconds(std::chrono::milliseconds(5))
+                      .count());
+
+  // The CPU time is sampled at the epoch ticks.
+  WasmEdge::Epoch::startTimer(std::chrono::milliseconds(1));
+  {
+    // The instance over its budget is interrupted without the scheduler.
+    auto Result = VM.execute("_start");
+    EXPECT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Interrupted);
+    EXPECT_TRUE(Budget.isExceeded());
+  }
+  {
+    // The scheduler lets the instance run until it returns false.
+    Budget.reset();
+    uint32_t Calls = 0;
+    VM.getExecutor().registerCpuSchedulerFunction(
+        [&](const WasmEdge::Runtime::Instance::ModuleInstance &ModInst,
+            uint64_t Usage) {
+          EXPECT_EQ(&ModInst, VM.getActiveModule());
+          EXPECT_GT(Usage, Budget.getLimit());
+          return ++Calls < 3;
+        });
+    auto Result = VM.execute("_start");
+    EXPECT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Interrupted);
+    EXPECT_EQ(Calls, 3U);
+  }
+  WasmEdge::Epoch::stopTimer();
+}
+
 TEST(VM, MultipleVM) {
   WasmEdge::Configure Conf;
   WasmEdge::VM::VM VM1(Conf);
@@ -240,6 +313,1419 @@ TEST(VM, MultipleVM) {
   EXPECT_TRUE(Result2);
 }
 
+TEST(SuperInstructions, FusedLocalBinOp) {
+  // (func (export "calc") (param i32 i32) (result i32) (local i32)
+  //   local.get 0 local.get 1 i32.add local.set 2
+  //   local.get 2 i32.const 3 i32.mul)
+  std::array<WasmEdge::Byte, 51> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01,
+      0x04, 0x63, 0x61, 0x6c, 0x63, 0x00, 0x00, 0x0a, 0x12, 0x01, 0x10, 0x01,
+      0x01, 0x7f, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x02, 0x41,
+      0x03, 0x6c, 0x0b};
+  using SuperInstr = WasmEdge::AST::Instruction::SuperInstr;
+  std::vector<WasmEdge::ValVariant> Params = {uint32_t(2), uint32_t(5)};
+  std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableSuperInstructions(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto Func = VM.getActiveModule()->findFuncExports("calc");
+  ASSERT_NE(Func, nullptr);
+  auto Instrs = Func->getInstrs();
+  ASSERT_EQ(Instrs.size(), 8U);
+  EXPECT_EQ(Instrs[0].getSuperInstr(), SuperInstr::LocalLocalBinOpSet);
+  EXPECT_EQ(Instrs[1].getSuperInstr(), SuperInstr::None);
+  EXPECT_EQ(Instrs[4].getSuperInstr(), SuperInstr::LocalConstBinOp);
+  auto Result = VM.execute("calc", Params, ParamTypes);
+  ASSERT_TRUE(Result);
+  ASSERT_EQ(Result->size(), 1U);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 21U);
+
+  // The fused instructions fall back to the original sequence when the
+  // statistics are enabled.
+  Conf.getStatisticsConfigure().setInstructionCounting(true);
+  WasmEdge::VM::VM StatVM(Conf);
+  ASSERT_TRUE(StatVM.loadWasm(Wasm));
+  ASSERT_TRUE(StatVM.validate());
+  ASSERT_TRUE(StatVM.instantiate());
+  Result = StatVM.execute("calc", Params, ParamTypes);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 21U);
+  EXPECT_EQ(StatVM.getStatistics().getInstrCount(), 8U);
+}
+
+TEST(TailCall, ReuseFrame) {
+  // (func (export "sum") (param i64 i64) (result i64) (local i64)
+  //   i32.const 7
+  //   local.get 0 i64.eqz if local.get 1 return end
+  //   local.get 0 i64.const 1 i64.sub
+  //   local.get 1 local.get 0 i64.add local.set 2 local.get 2
+  //   return_call 0)
+  // The locals and the operands below the arguments are dropped when the
+  // frame is reused.
+  std::array<WasmEdge::Byte, 65> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01,
+      0x60, 0x02, 0x7e, 0x7e, 0x01, 0x7e, 0x03, 0x02, 0x01, 0x00, 0x07,
+      0x07, 0x01, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x00, 0x0a, 0x21, 0x01,
+      0x1f, 0x01, 0x01, 0x7e, 0x41, 0x07, 0x20, 0x00, 0x50, 0x04, 0x40,
+      0x20, 0x01, 0x0f, 0x0b, 0x20, 0x00, 0x42, 0x01, 0x7d, 0x20, 0x01,
+      0x20, 0x00, 0x7c, 0x21, 0x02, 0x20, 0x02, 0x12, 0x00, 0x0b};
+  std::vector<WasmEdge::ValVariant> Params = {uint64_t(1000000), uint64_t(0)};
+  std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I64),
+      WasmEdge::ValType(WasmEdge::TypeCode::I64)};
+
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::TailCall);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto Result = VM.execute("sum", Params, ParamTypes);
+  ASSERT_TRUE(Result);
+  ASSERT_EQ(Result->size(), 1U);
+  EXPECT_EQ((*Result)[0].first.get<uint64_t>(), UINT64_C(500000500000));
+}
+
+TEST(ValueStack, FixedCapacityOverflow) {
+  // (func $f (export "f") (param i32) (result i32)
+  //   local.get 0
+  //   if (result i32)
+  //     local.get 0 i32.const 1 i32.sub call $f i32.const 1 i32.add
+  //   else
+  //     i32.const 0
+  //   end)
+  std::array<WasmEdge::Byte, 51> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+      0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x05, 0x01, 0x01,
+      0x66, 0x00, 0x00, 0x0a, 0x16, 0x01, 0x14, 0x00, 0x20, 0x00, 0x04, 0x7f,
+      0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x05, 0x41,
+      0x00, 0x0b, 0x0b};
+  std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setValueStackSize(4096U);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  std::vector<WasmEdge::ValVariant> Params = {uint32_t(1000)};
+  auto Result = VM.execute("f", Params, ParamTypes);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 1000U);
+
+  // Exhausting the value stack is reported instead of growing it.
+  Params = {uint32_t(100000)};
+  Result = VM.execute("f", Params, ParamTypes);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::StackOverflow);
+
+  // The stack is usable again for the following invocations.
+  Params = {uint32_t(10)};
+  Result = VM.execute("f", Params, ParamTypes);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 10U);
+}
+
+/// Host function returning more values than the fixed value stack holds.
+class HostManyReturns : public WasmEdge::Runtime::HostFunctionBase {
+public:
+  HostManyReturns(uint32_t N) : HostFunctionBase(0) {
+    DefType.getCompositeType().getFuncType().getReturnTypes().assign(
+        N, WasmEdge::ValType(WasmEdge::TypeCode::I32));
+  }
+  WasmEdge::Expect<void> run(const WasmEdge::Runtime::CallingFrame &,
+                             WasmEdge::Span<const WasmEdge::ValVariant>,
+                             WasmEdge::Span<WasmEdge::ValVariant>) override {
+    return {};
+  }
+};
+
+TEST(ValueStack, FixedCapacityHostReturns) {
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setValueStackSize(4096U);
+  WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+  Env.addHostFunc("many"sv, std::make_unique<HostManyReturns>(8192U));
+  WasmEdge::Executor::Executor Exec(Conf);
+  // The returns are checked against the room instead of faulting on the
+  // guard region, which no handler covers.
+  auto Result = Exec.invoke(Env.findFuncExports("many"), {}, {});
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::StackOverflow);
+}
+
+TEST(MemoryImage, CopyOnWriteInstances) {
+  // (memory (export "mem") 2)
+  // (data (i32.const 65540) "\2a")
+  std::array<WasmEdge::Byte, 33> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x05, 0x03, 0x01,
+      0x00, 0x02, 0x07, 0x07, 0x01, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00,
+      0x0b, 0x09, 0x01, 0x00, 0x41, 0x84, 0x80, 0x04, 0x0b, 0x01, 0x2a};
+
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableMemoryImage(true);
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto Mod = Load.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Valid.validate(**Mod));
+  WasmEdge::Runtime::StoreManager Store;
+
+  auto Inst1 = Exec.instantiateModule(Store, **Mod);
+  ASSERT_TRUE(Inst1);
+  auto Images = (*Mod)->getMemoryImages();
+  ASSERT_TRUE(Images);
+  if (WasmEdge::MemoryImage::supported()) {
+    ASSERT_EQ(Images->size(), 1U);
+    ASSERT_TRUE((*Images)[0]);
+    EXPECT_EQ((*Images)[0]->size(), 131072U);
+  }
+  auto *Mem1 = (*Inst1)->findMemoryExports("mem");
+  ASSERT_NE(Mem1, nullptr);
+  EXPECT_EQ(*Mem1->getPointer<uint8_t *>(65540), 0x2aU);
+  *Mem1->getPointer<uint8_t *>(65540) = 0x07U;
+
+  // The later instances start from the recorded image, not the modified
+  // memory, and do not share their writes.
+  for (int I = 0; I < 2; ++I) {
+    auto Inst2 = Exec.instantiateModule(Store, **Mod);
+    ASSERT_TRUE(Inst2);
+    auto *Mem2 = (*Inst2)->findMemoryExports("mem");
+    ASSERT_NE(Mem2, nullptr);
+    EXPECT_EQ(*Mem2->getPointer<uint8_t *>(65540), 0x2aU);
+    EXPECT_EQ(*Mem2->getPointer<uint8_t *>(0), 0x00U);
+    EXPECT_EQ(*Mem2->getPointer<uint8_t *>(131071), 0x00U);
+    *Mem2->getPointer<uint8_t *>(65540) = 0x09U;
+    ASSERT_TRUE(Mem2->growPage(1));
+    EXPECT_EQ(*Mem2->getPointer<uint8_t *>(131072), 0x00U);
+    EXPECT_EQ(*Mem1->getPointer<uint8_t *>(65540), 0x07U);
+  }
+}
+
+TEST(Numa, NodePlacement) {
+  // (memory (export "mem") 2)
+  // (data (i32.const 65540) "\2a")
+  std::array<WasmEdge::Byte, 33> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x05, 0x03, 0x01,
+      0x00, 0x02, 0x07, 0x07, 0x01, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00,
+      0x0b, 0x09, 0x01, 0x00, 0x41, 0x84, 0x80, 0x04, 0x0b, 0x01, 0x2a};
+
+  // The placement is best effort, and the instances work on any host.
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setNumaNode(0);
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto Mod = Load.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Valid.validate(**Mod));
+  WasmEdge::Runtime::StoreManager Store;
+  auto Inst = Exec.instantiateModule(Store, **Mod);
+  ASSERT_TRUE(Inst);
+  auto *Mem = (*Inst)->findMemoryExports("mem");
+  ASSERT_NE(Mem, nullptr);
+  EXPECT_EQ(*Mem->getPointer<uint8_t *>(65540), 0x2aU);
+  ASSERT_TRUE(Mem->growPage(1));
+  *Mem->getPointer<uint8_t *>(131072) = 0x07U;
+  EXPECT_EQ(*Mem->getPointer<uint8_t *>(131072), 0x07U);
+
+  if (WasmEdge::Numa::getNodeCount() > 0) {
+    EXPECT_FALSE(WasmEdge::Numa::getNodeCPUs(0).empty());
+  }
+  EXPECT_TRUE(
+      WasmEdge::Numa::getNodeCPUs(WasmEdge::Numa::getNodeCount()).empty());
+}
+
+#if WASMEDGE_OS_LINUX || WASMEDGE_OS_MACOS
+[[gnu::noinline]] uint32_t recurseOnStack(uint32_t Depth) {
+  volatile uint8_t Frame[512];
+  Frame[0] = static_cast<uint8_t>(Depth);
+  return Depth == 0 ? 0 : recurseOnStack(Depth - 1) + Frame[0];
+}
+
+TEST(NativeStack, OverflowTrap) {
+  // The runs reuse the stack of the thread.
+  uint32_t Result = 0;
+  auto Shallow = [&Result]() noexcept { Result = recurseOnStack(16); };
+  ASSERT_TRUE(WasmEdge::NativeStack::run(64 * 1024, Shallow));
+  EXPECT_EQ(Result, 136U);
+  Result = 0;
+  ASSERT_TRUE(WasmEdge::NativeStack::run(64 * 1024, Shallow));
+  EXPECT_EQ(Result, 136U);
+
+  // The overflow hits the guard page, and traps on the alternate signal
+  // stack.
+  WasmEdge::ErrCode Err;
+  auto Deep = [&Err]() noexcept {
+    WasmEdge::Fault FaultHandler;
+    if (const uint32_t Code = PREPARE_FAULT(FaultHandler); Code != 0) {
+      Err = WasmEdge::ErrCode(static_cast<WasmEdge::ErrCategory>(Code >> 24),
+                              Code);
+    } else {
+      recurseOnStack(UINT32_C(1) << 20);
+    }
+  };
+  ASSERT_TRUE(WasmEdge::NativeStack::run(64 * 1024, Deep));
+  EXPECT_EQ(Err, WasmEdge::ErrCode::Value::StackOverflow);
+  EXPECT_FALSE(WasmEdge::NativeStack::isGuardAddress(&Err));
+}
+#endif
+
+TEST(ModuleClone, IndependentInstances) {
+  // (table (export "tab") 1 1 funcref)
+  // (memory (export "mem") 1)
+  // (global $g (export "g") (mut i32) (i32.const 0))
+  // (elem (i32.const 0) $get)
+  // (start $start)
+  // (func $get (result i32) global.get $g)
+  // (func $start i32.const 0 i32.const 1 i32.store8 i32.const 5 global.set $g)
+  // (func (export "inc") (result i32)
+  //   global.get $g i32.const 1 i32.add global.set $g
+  //   i32.const 0 call_indirect (result i32))
+  std::array<WasmEdge::Byte, 118> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+      0x00, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x04, 0x03, 0x00, 0x01, 0x00,
+      0x04, 0x05, 0x01, 0x70, 0x01, 0x01, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+      0x06, 0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x17, 0x04, 0x03,
+      0x6d, 0x65, 0x6d, 0x02, 0x00, 0x01, 0x67, 0x03, 0x00, 0x03, 0x74, 0x61,
+      0x62, 0x01, 0x00, 0x03, 0x69, 0x6e, 0x63, 0x00, 0x02, 0x08, 0x01, 0x01,
+      0x09, 0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x00, 0x0a, 0x23, 0x03,
+      0x04, 0x00, 0x23, 0x00, 0x0b, 0x0d, 0x00, 0x41, 0x00, 0x41, 0x01, 0x3a,
+      0x00, 0x00, 0x41, 0x05, 0x24, 0x00, 0x0b, 0x0e, 0x00, 0x23, 0x00, 0x41,
+      0x01, 0x6a, 0x24, 0x00, 0x41, 0x00, 0x11, 0x00, 0x00, 0x0b};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto Mod = Load.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Valid.validate(**Mod));
+  WasmEdge::Runtime::StoreManager Store;
+  auto Template = Exec.instantiateModule(Store, **Mod);
+  ASSERT_TRUE(Template);
+
+  // The clones start from the state after the start function and do not
+  // share their writes with the template or each other.
+  auto Clone1 = Exec.cloneModule(**Template);
+  ASSERT_TRUE(Clone1);
+  auto Clone2 = Exec.cloneModule(**Template);
+  ASSERT_TRUE(Clone2);
+  for (const auto *Inst : {Clone1->get(), Clone2->get()}) {
+    EXPECT_EQ(Inst->findGlobalExports("g")->getValue().get<uint32_t>(), 5U);
+    EXPECT_EQ(*Inst->findMemoryExports("mem")->getPointer<uint8_t *>(0), 1U);
+  }
+
+  auto Result = Exec.invoke((*Clone1)->findFuncExports("inc"), {}, {});
+  ASSERT_TRUE(Result);
+  ASSERT_EQ(Result->size(), 1U);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 6U);
+  EXPECT_EQ((*Template)->findGlobalExports("g")->getValue().get<uint32_t>(),
+            5U);
+  EXPECT_EQ((*Clone2)->findGlobalExports("g")->getValue().get<uint32_t>(), 5U);
+
+  // The table references are remapped to the functions of the clone.
+  auto Ref = (*Clone1)->findTableExports("tab")->getRefAddr(0);
+  ASSERT_TRUE(Ref);
+  EXPECT_EQ(Ref->getPtr<WasmEdge::Runtime::Instance::FunctionInstance>()
+                ->getModule(),
+            Clone1->get());
+
+  *(*Clone1)->findMemoryExports("mem")->getPointer<uint8_t *>(0) = 7U;
+  EXPECT_EQ(*(*Clone2)->findMemoryExports("mem")->getPointer<uint8_t *>(0),
+            1U);
+  EXPECT_EQ(*(*Template)->findMemoryExports("mem")->getPointer<uint8_t *>(0),
+            1U);
+}
+
+TEST(ModuleSnapshot, RestoreState) {
+  // (table (export "tab") 1 1 funcref)
+  // (memory (export "mem") 1)
+  // (global $g (export "g") (mut i32) (i32.const 0))
+  // (elem (i32.const 0) $get)
+  // (start $start)
+  // (func $get (result i32) global.get $g)
+  // (func $start i32.const 0 i32.const 1 i32.store8 i32.const 5 global.set $g)
+  // (func (export "inc") (result i32)
+  //   global.get $g i32.const 1 i32.add global.set $g
+  //   i32.const 0 call_indirect (result i32))
+  std::array<WasmEdge::Byte, 118> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+      0x00, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x04, 0x03, 0x00, 0x01, 0x00,
+      0x04, 0x05, 0x01, 0x70, 0x01, 0x01, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+      0x06, 0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x17, 0x04, 0x03,
+      0x6d, 0x65, 0x6d, 0x02, 0x00, 0x01, 0x67, 0x03, 0x00, 0x03, 0x74, 0x61,
+      0x62, 0x01, 0x00, 0x03, 0x69, 0x6e, 0x63, 0x00, 0x02, 0x08, 0x01, 0x01,
+      0x09, 0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x00, 0x0a, 0x23, 0x03,
+      0x04, 0x00, 0x23, 0x00, 0x0b, 0x0d, 0x00, 0x41, 0x00, 0x41, 0x01, 0x3a,
+      0x00, 0x00, 0x41, 0x05, 0x24, 0x00, 0x0b, 0x0e, 0x00, 0x23, 0x00, 0x41,
+      0x01, 0x6a, 0x24, 0x00, 0x41, 0x00, 0x11, 0x00, 0x00, 0x0b};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto Mod = Load.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Valid.validate(**Mod));
+  WasmEdge::Runtime::StoreManager Store;
+  auto Inst = Exec.instantiateModule(Store, **Mod);
+  ASSERT_TRUE(Inst);
+  auto Snapshot = Exec.snapshotModule(**Inst);
+  ASSERT_TRUE(Snapshot);
+
+  // Change the global, the memory data and size, and the table.
+  auto *Mem = (*Inst)->findMemoryExports("mem");
+  auto *Tab = (*Inst)->findTableExports("tab");
+  const auto Ref = Tab->getRefAddr(0);
+  ASSERT_TRUE(Ref);
+  for (uint32_t Round = 0; Round < 2; ++Round) {
+    auto Result = Exec.invoke((*Inst)->findFuncExports("inc"), {}, {});
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 6U);
+    *Mem->getPointer<uint8_t *>(0) = 7U;
+    *Mem->getPointer<uint8_t *>(4096) = 8U;
+    ASSERT_TRUE(Mem->growPage(2));
+    *Mem->getPointer<uint8_t *>(70000) = 9U;
+    ASSERT_TRUE(Tab->setRefAddr(
+        0, WasmEdge::RefVariant(WasmEdge::TypeCode::FuncRef)));
+
+    // The restored instance runs from the state of the snapshot again.
+    ASSERT_TRUE(Exec.restoreModule(**Inst, **Snapshot));
+    EXPECT_EQ((*Inst)->findGlobalExports("g")->getValue().get<uint32_t>(), 5U);
+    EXPECT_EQ(Mem->getPageSize(), 1U);
+    EXPECT_EQ(*Mem->getPointer<uint8_t *>(0), 1U);
+    EXPECT_EQ(*Mem->getPointer<uint8_t *>(4096), 0U);
+    auto Restored = Tab->getRefAddr(0);
+    ASSERT_TRUE(Restored);
+    EXPECT_EQ(Restored->getPtr<void>(), Ref->getPtr<void>());
+  }
+
+  // The memory regrown after restoring is zeroed.
+  ASSERT_TRUE(Mem->growPage(2));
+  EXPECT_EQ(*Mem->getPointer<uint8_t *>(70000), 0U);
+
+  // The snapshot is only restored to its module instance.
+  auto Other = Exec.instantiateModule(Store, **Mod);
+  ASSERT_TRUE(Other);
+  EXPECT_FALSE(Exec.restoreModule(**Other, **Snapshot));
+}
+
+TEST(ModulePrelink, BindImportsByIndex) {
+  // (module (func (export "f") (result i32) i32.const 42))
+  std::array<WasmEdge::Byte, 34> Exporter{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+      0x00, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x05, 0x01, 0x01, 0x66,
+      0x00, 0x00, 0x0a, 0x06, 0x01, 0x04, 0x00, 0x41, 0x2a, 0x0b};
+  // (module (import "m" "f" (func (result i32)))
+  //   (func (export "g") (result i32) call 0))
+  std::array<WasmEdge::Byte, 43> Importer{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01,
+      0x60, 0x00, 0x01, 0x7f, 0x02, 0x07, 0x01, 0x01, 0x6d, 0x01, 0x66,
+      0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x05, 0x01, 0x01, 0x67,
+      0x00, 0x01, 0x0a, 0x06, 0x01, 0x04, 0x00, 0x10, 0x00, 0x0b};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto ExpMod = Load.parseModule(Exporter);
+  ASSERT_TRUE(ExpMod);
+  ASSERT_TRUE(Valid.validate(**ExpMod));
+  auto ImpMod = Load.parseModule(Importer);
+  ASSERT_TRUE(ImpMod);
+  ASSERT_TRUE(Valid.validate(**ImpMod));
+  WasmEdge::Runtime::StoreManager Store;
+  auto Target = Exec.registerModule(Store, **ExpMod, "m");
+  ASSERT_TRUE(Target);
+  auto Prelink = Exec.prelinkModule(Store, **ImpMod);
+  ASSERT_TRUE(Prelink);
+  EXPECT_EQ((*Prelink)->Imports.size(), 1U);
+
+  auto Call = [&]() -> uint32_t {
+    auto Inst = Exec.instantiateModule(Store, **Prelink);
+    EXPECT_TRUE(Inst);
+    if (!Inst) {
+      return 0;
+    }
+    auto Result = Exec.invoke((*Inst)->findFuncExports("g"), {}, {});
+    EXPECT_TRUE(Result);
+    return Result ? (*Result)[0].first.get<uint32_t>() : 0;
+  };
+  EXPECT_EQ(Call(), 42U);
+  EXPECT_EQ(Call(), 42U);
+
+  // The imports are resolved again after the registered modules changed.
+  Target->reset();
+  EXPECT_FALSE(Exec.instantiateModule(Store, **Prelink));
+  Exporter[32] = 0x07;
+  ExpMod = Load.parseModule(Exporter);
+  ASSERT_TRUE(ExpMod);
+  ASSERT_TRUE(Valid.validate(**ExpMod));
+  Target = Exec.registerModule(Store, **ExpMod, "m");
+  ASSERT_TRUE(Target);
+  EXPECT_EQ(Call(), 7U);
+}
+
+TEST(DataInstance, OutliveFailedInstantiation) {
+  // (module (table (export "t") 2 funcref))
+  std::array<WasmEdge::Byte, 21> Exporter{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x04, 0x04, 0x01,
+      0x70, 0x00, 0x02, 0x07, 0x05, 0x01, 0x01, 0x74, 0x01, 0x00};
+  // (module (import "m" "t" (table 2 funcref)) (memory 1)
+  //   (func (export "f") (result i32)
+  //     (memory.init 0 (i32.const 0) (i32.const 0) (i32.const 4))
+  //     (i32.load (i32.const 0)))
+  //   (elem (i32.const 0) func 0) (elem (i32.const 10) func 0)
+  //   (data (i32.const 0) "abcd"))
+  std::array<WasmEdge::Byte, 93> Importer{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+      0x00, 0x01, 0x7f, 0x02, 0x09, 0x01, 0x01, 0x6d, 0x01, 0x74, 0x01, 0x70,
+      0x00, 0x02, 0x03, 0x02, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07,
+      0x05, 0x01, 0x01, 0x66, 0x00, 0x00, 0x09, 0x0d, 0x02, 0x00, 0x41, 0x00,
+      0x0b, 0x01, 0x00, 0x00, 0x41, 0x0a, 0x0b, 0x01, 0x00, 0x0c, 0x01, 0x01,
+      0x0a, 0x13, 0x01, 0x11, 0x00, 0x41, 0x00, 0x41, 0x00, 0x41, 0x04, 0xfc,
+      0x08, 0x00, 0x00, 0x41, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x0b, 0x0a, 0x01,
+      0x00, 0x41, 0x00, 0x0b, 0x04, 0x61, 0x62, 0x63, 0x64};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::Loader::Loader Load(Conf);
+  WasmEdge::Validator::Validator Valid(Conf);
+  WasmEdge::Executor::Executor Exec(Conf);
+  auto ExpMod = Load.parseModule(Exporter);
+  ASSERT_TRUE(ExpMod);
+  ASSERT_TRUE(Valid.validate(**ExpMod));
+  auto ImpMod = Load.parseModule(Importer);
+  ASSERT_TRUE(ImpMod);
+  ASSERT_TRUE(Valid.validate(**ImpMod));
+  WasmEdge::Runtime::StoreManager Store;
+  auto Target = Exec.registerModule(Store, **ExpMod, "m");
+  ASSERT_TRUE(Target);
+
+  // The second element segment is out of bounds after the first one put the
+  // function into the imported table, so the active data segment is neither
+  // copied into the memory nor dropped.
+  EXPECT_FALSE(Exec.instantiateModule(Store, **ImpMod));
+  ImpMod->reset();
+  auto *Tab = (*Target)->findTableExports("t");
+  ASSERT_NE(Tab, nullptr);
+  auto Ref = Tab->getRefAddr(0);
+  ASSERT_TRUE(Ref);
+  const auto *Func =
+      Ref->getPtr<WasmEdge::Runtime::Instance::FunctionInstance>();
+  ASSERT_NE(Func, nullptr);
+  auto Result = Exec.invoke(Func, {}, {});
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), UINT32_C(0x64636261));
+}
+
+TEST(TypeRegistry, CanonicalSubTypes) {
+  using WasmEdge::AST::FieldType;
+  using WasmEdge::AST::SubType;
+  // (type $base (sub (struct)))
+  // (type $sub (sub $base (struct (field i32))))
+  auto MakeTypes = []() {
+    std::vector<SubType> Types(2);
+    Types[0].setFinal(false);
+    Types[0].getCompositeType().setStructType({});
+    Types[1].setFinal(false);
+    Types[1].getSuperTypeIndices().push_back(0);
+    Types[1].getCompositeType().setStructType(
+        {FieldType(WasmEdge::TypeCode::I32, WasmEdge::ValMut::Const)});
+    return Types;
+  };
+  auto Types1 = MakeTypes();
+  auto Types2 = MakeTypes();
+  // The same types in a recursive type group are not equivalent to them.
+  auto Types3 = MakeTypes();
+  Types3[0].setRecursiveInfo(0, 2);
+  Types3[1].setRecursiveInfo(1, 2);
+  auto Canonicalize = [](const std::vector<SubType> &Types) {
+    std::vector<const SubType *> List;
+    for (const auto &Type : Types) {
+      List.push_back(&Type);
+    }
+    return WasmEdge::Runtime::TypeRegistry::getDefault().canonicalize(List);
+  };
+
+  const auto Canon1 = Canonicalize(Types1);
+  const auto Canon2 = Canonicalize(Types2);
+  const auto Canon3 = Canonicalize(Types3);
+  ASSERT_EQ(Canon1.size(), 2U);
+  ASSERT_EQ(Canon2.size(), 2U);
+  ASSERT_EQ(Canon3.size(), 2U);
+  EXPECT_EQ(Canon1[0], Canon2[0]);
+  EXPECT_EQ(Canon1[1], Canon2[1]);
+  EXPECT_NE(Canon1[0], Canon3[0]);
+  EXPECT_NE(Canon1[1], Canon3[1]);
+  EXPECT_TRUE(Canon1[1]->isSubTypeOf(*Canon2[0]));
+  EXPECT_TRUE(Canon1[1]->isSubTypeOf(*Canon2[1]));
+  EXPECT_FALSE(Canon1[0]->isSubTypeOf(*Canon2[1]));
+  EXPECT_FALSE(Canon3[1]->isSubTypeOf(*Canon1[0]));
+  EXPECT_TRUE(Canon3[1]->isSubTypeOf(*Canon3[0]));
+}
+
+TEST(LazyTable, ResolveOnAccess) {
+  // (type $r (func (result i32)))
+  // (table (export "tab") 4 funcref)
+  // (elem (i32.const 0) $a $b $c)
+  // (func $a (result i32) i32.const 1)
+  // (func $b (result i32) i32.const 2)
+  // (func $c (result i32) i32.const 3)
+  // (func (export "call") (param i32) (result i32)
+  //   local.get 0 call_indirect (type $r))
+  // (func (export "copy") (table.copy (i32.const 3) (i32.const 0)
+  //   (i32.const 1)))
+  std::array<WasmEdge::Byte, 110> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0d, 0x03, 0x60,
+      0x00, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03,
+      0x06, 0x05, 0x00, 0x00, 0x00, 0x01, 0x02, 0x04, 0x04, 0x01, 0x70, 0x00,
+      0x04, 0x07, 0x15, 0x03, 0x03, 0x74, 0x61, 0x62, 0x01, 0x00, 0x04, 0x63,
+      0x61, 0x6c, 0x6c, 0x00, 0x03, 0x04, 0x63, 0x6f, 0x70, 0x79, 0x00, 0x04,
+      0x09, 0x09, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x03, 0x00, 0x01, 0x02, 0x0a,
+      0x25, 0x05, 0x04, 0x00, 0x41, 0x01, 0x0b, 0x04, 0x00, 0x41, 0x02, 0x0b,
+      0x04, 0x00, 0x41, 0x03, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x11, 0x00, 0x00,
+      0x0b, 0x0c, 0x00, 0x41, 0x03, 0x41, 0x00, 0x41, 0x01, 0xfc, 0x0e, 0x00,
+      0x00, 0x0b};
+  const std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  // The lazy and eager tables behave the same.
+  for (const bool IsLazy : {false, true}) {
+    WasmEdge::Configure Conf;
+    Conf.getRuntimeConfigure().setEnableLazyTable(IsLazy);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Wasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    const auto *ModInst = VM.getActiveModule();
+    auto *Tab = ModInst->findTableExports("tab");
+    ASSERT_NE(Tab, nullptr);
+
+    auto Result = VM.execute("call", std::vector<WasmEdge::ValVariant>{2U},
+                             ParamTypes);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 3U);
+    auto Ref = Tab->getRefAddr(1);
+    ASSERT_TRUE(Ref);
+    ASSERT_FALSE(Ref->isNull());
+    EXPECT_EQ(Ref->getPtr<WasmEdge::Runtime::Instance::FunctionInstance>()
+                  ->getModule(),
+              ModInst);
+
+    // The copied and overwritten entries do not resolve from the segment.
+    ASSERT_TRUE(VM.execute("copy"));
+    ASSERT_TRUE(Tab->setRefAddr(0, WasmEdge::RefVariant(
+                                       WasmEdge::TypeCode::FuncRef)));
+    EXPECT_FALSE(VM.execute("call", std::vector<WasmEdge::ValVariant>{0U},
+                            ParamTypes));
+    Result =
+        VM.execute("call", std::vector<WasmEdge::ValVariant>{3U}, ParamTypes);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 1U);
+  }
+}
+
+TEST(IndirectCallCache, InvalidateOnTableChange) {
+  // (type $r (func (result i32)))
+  // (type $p (func (param i32) (result i32)))
+  // (table (export "tab") 3 funcref)
+  // (elem (i32.const 0) $a $b $c)
+  // (func $a (type $r) i32.const 1)
+  // (func $b (type $p) local.get 0)
+  // (func $c (type $r) i32.const 3)
+  // (func (export "call") (type $p) local.get 0 call_indirect (type $r))
+  std::array<WasmEdge::Byte, 86> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0a, 0x02, 0x60,
+      0x00, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00,
+      0x01, 0x00, 0x01, 0x04, 0x04, 0x01, 0x70, 0x00, 0x03, 0x07, 0x0e, 0x02,
+      0x03, 0x74, 0x61, 0x62, 0x01, 0x00, 0x04, 0x63, 0x61, 0x6c, 0x6c, 0x00,
+      0x03, 0x09, 0x09, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x03, 0x00, 0x01, 0x02,
+      0x0a, 0x18, 0x04, 0x04, 0x00, 0x41, 0x01, 0x0b, 0x04, 0x00, 0x20, 0x00,
+      0x0b, 0x04, 0x00, 0x41, 0x03, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x11, 0x00,
+      0x00, 0x0b};
+  const std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto *Tab = VM.getActiveModule()->findTableExports("tab");
+  ASSERT_NE(Tab, nullptr);
+
+  // Repeated calls hit the cached entry.
+  for (uint32_t I = 0; I < 2; ++I) {
+    auto Result = VM.execute("call", std::vector<WasmEdge::ValVariant>{0U},
+                             ParamTypes);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 1U);
+  }
+  auto Result =
+      VM.execute("call", std::vector<WasmEdge::ValVariant>{1U}, ParamTypes);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::IndirectCallTypeMismatch);
+
+  // Replacing the cached slot invalidates the entry.
+  ASSERT_TRUE(Tab->setRefAddr(0, *Tab->getRefAddr(1)));
+  Result =
+      VM.execute("call", std::vector<WasmEdge::ValVariant>{0U}, ParamTypes);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::IndirectCallTypeMismatch);
+  ASSERT_TRUE(Tab->setRefAddr(0, *Tab->getRefAddr(2)));
+  Result =
+      VM.execute("call", std::vector<WasmEdge::ValVariant>{0U}, ParamTypes);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 3U);
+  ASSERT_TRUE(Tab->setRefAddr(
+      0, WasmEdge::RefVariant(WasmEdge::TypeCode::FuncRef)));
+  Result =
+      VM.execute("call", std::vector<WasmEdge::ValVariant>{0U}, ParamTypes);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::UninitializedElement);
+}
+
+TEST(GuardRegion, MemoryOutOfBounds) {
+  // (memory 1)
+  // (func (export "load") (param i32) (result i32) local.get 0 i32.load)
+  // (func (export "store") (param i32 i64) local.get 0 local.get 1 i64.store)
+  // (func (export "far") (param i32) (result i32)
+  //   local.get 0 i32.load offset=0xFFFFFFFF)
+  std::array<WasmEdge::Byte, 89> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x02, 0x60,
+      0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7e, 0x00, 0x03, 0x04, 0x03,
+      0x00, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x16, 0x03, 0x04,
+      0x6c, 0x6f, 0x61, 0x64, 0x00, 0x00, 0x05, 0x73, 0x74, 0x6f, 0x72, 0x65,
+      0x00, 0x01, 0x03, 0x66, 0x61, 0x72, 0x00, 0x02, 0x0a, 0x1f, 0x03, 0x07,
+      0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x20,
+      0x01, 0x37, 0x03, 0x00, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x28, 0x02, 0xff,
+      0xff, 0xff, 0xff, 0x0f, 0x0b};
+  const std::vector<WasmEdge::ValType> LoadTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  const std::vector<WasmEdge::ValType> StoreTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I64)};
+
+  // The guarded and checked accesses behave the same.
+  for (const bool IsGuarded : {false, true}) {
+    WasmEdge::Configure Conf;
+    Conf.getRuntimeConfigure().setEnableGuardRegion(IsGuarded);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Wasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+
+    ASSERT_TRUE(VM.execute(
+        "store",
+        std::vector<WasmEdge::ValVariant>{65528U, UINT64_C(0x0000000500000004)},
+        StoreTypes));
+    auto Result = VM.execute(
+        "load", std::vector<WasmEdge::ValVariant>{65532U}, LoadTypes);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 5U);
+
+    for (const uint32_t Addr : {65533U, 0x80000000U, 0xFFFFFFFFU}) {
+      Result = VM.execute("load", std::vector<WasmEdge::ValVariant>{Addr},
+                          LoadTypes);
+      ASSERT_FALSE(Result);
+      EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+    }
+    EXPECT_FALSE(VM.execute(
+        "store", std::vector<WasmEdge::ValVariant>{65529U, UINT64_C(0)},
+        StoreTypes));
+    Result = VM.execute("far", std::vector<WasmEdge::ValVariant>{0U},
+                        LoadTypes);
+    ASSERT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+  }
+}
+
+TEST(Memory64, AccessAndGrow) {
+  // (memory i64 1)
+  // (func (export "load") (param i64) (result i32) local.get 0 i32.load)
+  // (func (export "store") (param i64 i32) local.get 0 local.get 1 i32.store)
+  // (func (export "size") (result i64) memory.size)
+  // (func (export "grow") (param i64) (result i64) local.get 0 memory.grow)
+  std::array<WasmEdge::Byte, 107> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x14, 0x04, 0x60,
+      0x01, 0x7e, 0x01, 0x7f, 0x60, 0x02, 0x7e, 0x7f, 0x00, 0x60, 0x00, 0x01,
+      0x7e, 0x60, 0x01, 0x7e, 0x01, 0x7e, 0x03, 0x05, 0x04, 0x00, 0x01, 0x02,
+      0x03, 0x05, 0x03, 0x01, 0x04, 0x01, 0x07, 0x1e, 0x04, 0x04, 0x6c, 0x6f,
+      0x61, 0x64, 0x00, 0x00, 0x05, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x00, 0x01,
+      0x04, 0x73, 0x69, 0x7a, 0x65, 0x00, 0x02, 0x04, 0x67, 0x72, 0x6f, 0x77,
+      0x00, 0x03, 0x0a, 0x1f, 0x04, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00,
+      0x0b, 0x09, 0x00, 0x20, 0x00, 0x20, 0x01, 0x36, 0x02, 0x00, 0x0b, 0x04,
+      0x00, 0x3f, 0x00, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x40, 0x00, 0x0b};
+  const std::vector<WasmEdge::ValType> I64Types = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I64)};
+  const std::vector<WasmEdge::ValType> StoreTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I64),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  // The 64-bit memories are rejected without the proposal.
+  WasmEdge::Configure Conf;
+  {
+    WasmEdge::VM::VM VM(Conf);
+    EXPECT_FALSE(VM.loadWasm(Wasm));
+  }
+
+  Conf.addProposal(WasmEdge::Proposal::Memory64);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  ASSERT_TRUE(VM.execute(
+      "store", std::vector<WasmEdge::ValVariant>{UINT64_C(65532), 7U},
+      StoreTypes));
+  auto Result = VM.execute(
+      "load", std::vector<WasmEdge::ValVariant>{UINT64_C(65532)}, I64Types);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 7U);
+
+  // The addresses beyond 4 GiB trap instead of wrapping around.
+  for (const uint64_t Addr :
+       {UINT64_C(65533), UINT64_C(0x100000000), UINT64_C(0x10000FFFC),
+        UINT64_MAX}) {
+    Result = VM.execute("load", std::vector<WasmEdge::ValVariant>{Addr},
+                        I64Types);
+    ASSERT_FALSE(Result);
+    EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::MemoryOutOfBounds);
+  }
+
+  // The page counts are i64 values.
+  Result = VM.execute("grow", std::vector<WasmEdge::ValVariant>{UINT64_C(1)},
+                      I64Types);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint64_t>(), UINT64_C(1));
+  Result = VM.execute("grow",
+                      std::vector<WasmEdge::ValVariant>{UINT64_C(1) << 40},
+                      I64Types);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint64_t>(), UINT64_MAX);
+  Result = VM.execute("size");
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint64_t>(), UINT64_C(2));
+  Result = VM.execute(
+      "load", std::vector<WasmEdge::ValVariant>{UINT64_C(131068)}, I64Types);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 0U);
+}
+
+TEST(MemoryBudget, GrowAndAllocate) {
+  // (type $a (array (mut i32)))
+  // (table 1 funcref)
+  // (memory 1)
+  // (func (export "grow_mem") (param i32) (result i32)
+  //   local.get 0 memory.grow)
+  // (func (export "grow_tab") (param i32) (result i32)
+  //   ref.null func local.get 0 table.grow 0)
+  // (func (export "new_arr") (param i32) (result i32)
+  //   local.get 0 array.new_default $a array.len)
+  std::array<WasmEdge::Byte, 101> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x5e,
+      0x7f, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x04, 0x03, 0x01, 0x01,
+      0x01, 0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+      0x07, 0x21, 0x03, 0x08, 0x67, 0x72, 0x6f, 0x77, 0x5f, 0x6d, 0x65, 0x6d,
+      0x00, 0x00, 0x08, 0x67, 0x72, 0x6f, 0x77, 0x5f, 0x74, 0x61, 0x62, 0x00,
+      0x01, 0x07, 0x6e, 0x65, 0x77, 0x5f, 0x61, 0x72, 0x72, 0x00, 0x02, 0x0a,
+      0x1c, 0x03, 0x06, 0x00, 0x20, 0x00, 0x40, 0x00, 0x0b, 0x09, 0x00, 0xd0,
+      0x70, 0x20, 0x00, 0xfc, 0x0f, 0x00, 0x0b, 0x09, 0x00, 0x20, 0x00, 0xfb,
+      0x07, 0x00, 0xfb, 0x0f, 0x0b};
+  const std::vector<WasmEdge::ValType> Types = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  constexpr uint64_t PageSize = UINT64_C(65536);
+  constexpr uint64_t RefSize = sizeof(WasmEdge::RefVariant);
+  auto Call = [&](WasmEdge::VM::VM &VM, std::string_view Name, uint32_t Arg) {
+    return VM.execute(Name, std::vector<WasmEdge::ValVariant>{Arg}, Types);
+  };
+
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setMemoryBudget(2 * PageSize + 64 * RefSize,
+                                             4 * PageSize);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const auto &Budget = VM.getActiveModule()->getMemoryBudget();
+  EXPECT_EQ(Budget.getUsage(), PageSize + RefSize);
+
+  // The growing fails when exceeding the soft limit.
+  auto Result = Call(VM, "grow_mem", 1U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<int32_t>(), 1);
+  Result = Call(VM, "grow_mem", 1U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<int32_t>(), -1);
+  Result = Call(VM, "grow_tab", 10U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<int32_t>(), 1);
+  Result = Call(VM, "grow_tab", 1000U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<int32_t>(), -1);
+  EXPECT_EQ(Budget.getUsage(), 2 * PageSize + 11 * RefSize);
+
+  // The GC allocations trap when exceeding the hard limit.
+  Result = Call(VM, "new_arr", 10U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 10U);
+  Result = Call(VM, "new_arr", 100000U);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::MemoryBudgetExceeded);
+  EXPECT_EQ(Budget.getUsage(),
+            2 * PageSize + 11 * RefSize +
+                sizeof(WasmEdge::Runtime::Instance::ArrayInstance) +
+                10 * sizeof(uint32_t));
+  EXPECT_EQ(Budget.getPeak(), Budget.getUsage());
+
+  // The instantiation fails when exceeding the hard limit.
+  Conf.getRuntimeConfigure().setMemoryBudget(0, PageSize);
+  WasmEdge::VM::VM VM2(Conf);
+  ASSERT_TRUE(VM2.loadWasm(Wasm));
+  ASSERT_TRUE(VM2.validate());
+  auto Res = VM2.instantiate();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::MemoryBudgetExceeded);
+}
+
+/// Continuations used by the stack switching tests.
+// (type $f (func (result i32)))               ;; 0
+// (type $cf (cont $f))                        ;; 1
+// (type $g (func (param i32) (result i32)))   ;; 2
+// (type $cg (cont $g))                        ;; 3
+// (type $h (func (result i32 (ref null $cg))))
+// (type $b (func (param i32 (ref null $cf)) (result i32)))
+// (type $cb (cont $b))                        ;; 6
+// (tag $yield (param i32) (result i32))
+// (tag $exn (param i32))
+// (tag $sw (result i32))
+// (func $body (param i32) (result i32)
+//   local.get 0 suspend $yield i32.const 1 i32.add)
+// (func $inc (param i32) (result i32) local.get 0 i32.const 1 i32.add)
+// (func $trap (result i32) unreachable)
+// (func $rec (param i32) (result i32) ;; as in the fixed value stack test
+// (func $a (param i32) (result i32)
+//   local.get 0 ref.func $b cont.new $cb switch $cb $sw i32.const -1)
+// (func $b (param i32 (ref null $cf)) (result i32)
+//   local.get 0 i32.const 2 i32.mul)
+// (func (export "resume") (param i32) (result i32) (local (ref null $cg))
+//   (block $h (type $h)
+//     local.get 0 ref.func $body cont.new $cg resume $cg (on $yield $h)
+//     return)
+//   local.set 1 i32.const 10 i32.add local.get 1 resume $cg)
+// (func (export "bind") (param i32) (result i32)
+//   local.get 0 ref.func $inc cont.new $cg cont.bind $cg $cf resume $cf)
+// (func (export "throw") (param i32) (result i32) (local (ref null $cg))
+//   (block $h (type $h)
+//     local.get 0 ref.func $body cont.new $cg resume $cg (on $yield $h)
+//     return)
+//   local.set 1 drop
+//   (block $c (result i32)
+//     (try_table (result i32) (catch $exn $c)
+//       local.get 0 i32.const 100 i32.add local.get 1 resume_throw $cg $exn)
+//     return))
+// (func (export "throw_new") (param i32) (result i32)
+//   (block $c (result i32)
+//     (try_table (result i32) (catch $exn $c)
+//       local.get 0 ref.func $body cont.new $cg resume_throw $cg $exn)
+//     return))
+// (func (export "switch") (param i32) (result i32)
+//   local.get 0 ref.func $a cont.new $cg resume $cg (on $sw switch))
+// (func (export "trap") (param i32) (result i32)
+//   ref.func $trap cont.new $cf resume $cf)
+// (func (export "unhandled") (param i32) (result i32)
+//   local.get 0 ref.func $body cont.new $cg resume $cg)
+// (func (export "suspend") (param i32) (result i32)
+//   local.get 0 suspend $yield)
+// (func (export "deep") (param i32) (result i32)
+//   local.get 0 ref.func $rec cont.new $cg resume $cg)
+// (func (export "drop") (param i32) (result i32) (local i32)
+//   (loop $l
+//     (block $h (type $h)
+//       local.get 1 ref.func $body cont.new $cg resume $cg (on $yield $h)
+//       unreachable)
+//     drop drop
+//     local.get 1 i32.const 1 i32.add local.tee 1 local.get 0 i32.lt_u
+//     br_if $l)
+//   local.get 1)
+const std::array<WasmEdge::Byte, 457> ContWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x21, 0x08, 0x60,
+    0x00, 0x01, 0x7f, 0x5d, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x5d, 0x02,
+    0x60, 0x00, 0x02, 0x7f, 0x63, 0x03, 0x60, 0x02, 0x7f, 0x63, 0x01, 0x01,
+    0x7f, 0x5d, 0x05, 0x60, 0x01, 0x7f, 0x00, 0x03, 0x11, 0x10, 0x02, 0x02,
+    0x00, 0x02, 0x02, 0x05, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x0d, 0x07, 0x03, 0x00, 0x02, 0x00, 0x07, 0x00, 0x00, 0x07,
+    0x59, 0x0a, 0x06, 0x72, 0x65, 0x73, 0x75, 0x6d, 0x65, 0x00, 0x06, 0x04,
+    0x62, 0x69, 0x6e, 0x64, 0x00, 0x07, 0x05, 0x74, 0x68, 0x72, 0x6f, 0x77,
+    0x00, 0x08, 0x09, 0x74, 0x68, 0x72, 0x6f, 0x77, 0x5f, 0x6e, 0x65, 0x77,
+    0x00, 0x09, 0x06, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x00, 0x0a, 0x04,
+    0x74, 0x72, 0x61, 0x70, 0x00, 0x0b, 0x09, 0x75, 0x6e, 0x68, 0x61, 0x6e,
+    0x64, 0x6c, 0x65, 0x64, 0x00, 0x0c, 0x07, 0x73, 0x75, 0x73, 0x70, 0x65,
+    0x6e, 0x64, 0x00, 0x0d, 0x04, 0x64, 0x65, 0x65, 0x70, 0x00, 0x0e, 0x04,
+    0x64, 0x72, 0x6f, 0x70, 0x00, 0x0f, 0x09, 0x0a, 0x01, 0x03, 0x00, 0x06,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x0a, 0x98, 0x02, 0x10, 0x09, 0x00,
+    0x20, 0x00, 0xe2, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00,
+    0x41, 0x01, 0x6a, 0x0b, 0x03, 0x00, 0x00, 0x0b, 0x14, 0x00, 0x20, 0x00,
+    0x04, 0x7f, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x03, 0x41, 0x01, 0x6a,
+    0x05, 0x41, 0x00, 0x0b, 0x0b, 0x0d, 0x00, 0x20, 0x00, 0xd2, 0x05, 0xe0,
+    0x06, 0xe5, 0x06, 0x02, 0x41, 0x7f, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41,
+    0x02, 0x6c, 0x0b, 0x1f, 0x01, 0x01, 0x63, 0x03, 0x02, 0x04, 0x20, 0x00,
+    0xd2, 0x00, 0xe0, 0x03, 0xe3, 0x03, 0x01, 0x00, 0x00, 0x00, 0x0f, 0x0b,
+    0x21, 0x01, 0x41, 0x0a, 0x6a, 0x20, 0x01, 0xe3, 0x03, 0x00, 0x0b, 0x0e,
+    0x00, 0x20, 0x00, 0xd2, 0x01, 0xe0, 0x03, 0xe1, 0x03, 0x01, 0xe3, 0x01,
+    0x00, 0x0b, 0x2f, 0x01, 0x01, 0x63, 0x03, 0x02, 0x04, 0x20, 0x00, 0xd2,
+    0x00, 0xe0, 0x03, 0xe3, 0x03, 0x01, 0x00, 0x00, 0x00, 0x0f, 0x0b, 0x21,
+    0x01, 0x1a, 0x02, 0x7f, 0x1f, 0x7f, 0x01, 0x00, 0x01, 0x00, 0x20, 0x00,
+    0x41, 0xe4, 0x00, 0x6a, 0x20, 0x01, 0xe4, 0x03, 0x01, 0x00, 0x0b, 0x0f,
+    0x0b, 0x0b, 0x17, 0x00, 0x02, 0x7f, 0x1f, 0x7f, 0x01, 0x00, 0x01, 0x00,
+    0x20, 0x00, 0xd2, 0x00, 0xe0, 0x03, 0xe4, 0x03, 0x01, 0x00, 0x0b, 0x0f,
+    0x0b, 0x0b, 0x0d, 0x00, 0x20, 0x00, 0xd2, 0x04, 0xe0, 0x03, 0xe3, 0x03,
+    0x01, 0x01, 0x02, 0x0b, 0x09, 0x00, 0xd2, 0x02, 0xe0, 0x01, 0xe3, 0x01,
+    0x00, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0xd2, 0x00, 0xe0, 0x03, 0xe3, 0x03,
+    0x00, 0x0b, 0x06, 0x00, 0x20, 0x00, 0xe2, 0x00, 0x0b, 0x0b, 0x00, 0x20,
+    0x00, 0xd2, 0x03, 0xe0, 0x03, 0xe3, 0x03, 0x00, 0x0b, 0x27, 0x01, 0x01,
+    0x7f, 0x03, 0x40, 0x02, 0x04, 0x20, 0x01, 0xd2, 0x00, 0xe0, 0x03, 0xe3,
+    0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x1a, 0x1a, 0x20, 0x01, 0x41,
+    0x01, 0x6a, 0x22, 0x01, 0x20, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x01,
+    0x0b};
+
+WasmEdge::Configure contConf() {
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::StackSwitching);
+  return Conf;
+}
+
+auto callCont(WasmEdge::VM::VM &VM, std::string_view Name, uint32_t Arg) {
+  return VM.execute(Name, std::vector<WasmEdge::ValVariant>{Arg},
+                    {WasmEdge::ValType(WasmEdge::TypeCode::I32)});
+}
+
+TEST(Continuation, ResumeAndBind) {
+  WasmEdge::VM::VM VM(contConf());
+  ASSERT_TRUE(VM.loadWasm(ContWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  // Suspended with 5, resumed with 15, and returns 16.
+  auto Result = callCont(VM, "resume", 5U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 16U);
+  // The bound argument is passed at the first resumption.
+  Result = callCont(VM, "bind", 41U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 42U);
+  // The switched target returns to the resumer of the switching one.
+  Result = callCont(VM, "switch", 21U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 42U);
+}
+
+TEST(Continuation, ResumeThrow) {
+  WasmEdge::VM::VM VM(contConf());
+  ASSERT_TRUE(VM.loadWasm(ContWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  // Thrown at the suspension, and caught by the resumer.
+  auto Result = callCont(VM, "throw", 1U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 101U);
+  // Thrown at the resumer without starting the continuation.
+  Result = callCont(VM, "throw_new", 7U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 7U);
+}
+
+TEST(Continuation, TrapAndUnhandledTag) {
+  WasmEdge::VM::VM VM(contConf());
+  ASSERT_TRUE(VM.loadWasm(ContWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Result = callCont(VM, "trap", 0U);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::Unreachable);
+  Result = callCont(VM, "unhandled", 0U);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::UnhandledTag);
+  Result = callCont(VM, "suspend", 0U);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::UnhandledTag);
+  // The module is usable again for the following invocations.
+  Result = callCont(VM, "resume", 1U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 12U);
+}
+
+TEST(Continuation, FixedCapacityOverflow) {
+  WasmEdge::Configure Conf = contConf();
+  Conf.getRuntimeConfigure().setValueStackSize(4096U);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(ContWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Result = callCont(VM, "deep", 1000U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 1000U);
+  // The value stack of the continuation has the configured capacity.
+  Result = callCont(VM, "deep", 100000U);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::StackOverflow);
+  Result = callCont(VM, "deep", 10U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 10U);
+}
+
+TEST(Continuation, DropSuspended) {
+  // Only a few continuations fit in the budget, so the dropped ones must be
+  // collected and unwound.
+  constexpr uint64_t ContSize =
+      sizeof(WasmEdge::Runtime::Instance::ContInstance);
+  WasmEdge::Configure Conf = contConf();
+  Conf.getRuntimeConfigure().setMemoryBudget(0, 16 * ContSize);
+  Conf.getRuntimeConfigure().setGCThreshold(8 * ContSize);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(ContWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Result = callCont(VM, "drop", 1000U);
+  ASSERT_TRUE(Result);
+  EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 1000U);
+  EXPECT_LE(VM.getActiveModule()->getMemoryBudget().getUsage(),
+            16 * ContSize);
+  // The switching continuation dropped by the target is collected as well.
+  for (uint32_t I = 0; I < 100; ++I) {
+    Result = callCont(VM, "switch", I);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), 2 * I);
+  }
+  // The remaining ones are unwound when destroying the module instance.
+}
+
+TEST(StackManager, PooledHandlers) {
+  // (tag $e (param i32))
+  // (func (export "f") (param i32) (result i32)
+  //   block (result i32)
+  //     try_table (result i32) (catch $e 0)
+  //       local.get 0 call $throw i32.const 0
+  //     end
+  //   end)
+  // (func $throw (param i32) local.get 0 throw $e)
+  std::array<WasmEdge::Byte, 66> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0a, 0x02, 0x60,
+      0x01, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00,
+      0x01, 0x0d, 0x03, 0x01, 0x00, 0x01, 0x07, 0x05, 0x01, 0x01, 0x66, 0x00,
+      0x00, 0x0a, 0x1b, 0x02, 0x12, 0x00, 0x02, 0x7f, 0x1f, 0x7f, 0x01, 0x00,
+      0x00, 0x00, 0x20, 0x00, 0x10, 0x01, 0x41, 0x00, 0x0b, 0x0b, 0x0b, 0x06,
+      0x00, 0x20, 0x00, 0x08, 0x00, 0x0b};
+  std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  WasmEdge::Configure Conf;
+  Conf.addProposal(WasmEdge::Proposal::ExceptionHandling);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  // The invocations reuse the pooled stack managers and their shared handler
+  // stacks.
+  for (uint32_t I = 0; I < 16; ++I) {
+    std::vector<WasmEdge::ValVariant> Params = {I};
+    auto Result = VM.execute("f", Params, ParamTypes);
+    ASSERT_TRUE(Result);
+    EXPECT_EQ((*Result)[0].first.get<uint32_t>(), I);
+  }
+}
+
+TEST(StoreManager, ConcurrentLookup) {
+  using namespace WasmEdge::Runtime;
+  Instance::ModuleInstance ModA("a"), ModB("b");
+  ModA.addHostGlobal("g", std::make_unique<Instance::GlobalInstance>(
+                              WasmEdge::AST::GlobalType()));
+  StoreManager Store;
+  ASSERT_TRUE(Store.registerModule(&ModA));
+
+  // The lookups see either state of the store while the other module is
+  // registered and unregistered repeatedly.
+  std::atomic<bool> Done = false;
+  std::thread Writer([&]() {
+    for (uint32_t I = 0; I < 1000; ++I) {
+      EXPECT_TRUE(Store.registerModule(&ModB));
+      EXPECT_TRUE(Store.unregisterModule("b"));
+    }
+    Done = true;
+  });
+  std::vector<std::thread> Readers;
+  for (uint32_t I = 0; I < 4; ++I) {
+    Readers.emplace_back([&]() {
+      while (!Done) {
+        const auto *Mod = Store.findModule("a");
+        ASSERT_EQ(Mod, &ModA);
+        EXPECT_NE(Mod->findGlobalExports("g"), nullptr);
+        EXPECT_EQ(Mod->findGlobalExports("h"), nullptr);
+        const auto *Other = Store.findModule("b");
+        EXPECT_TRUE(Other == nullptr || Other == &ModB);
+      }
+    });
+  }
+  Writer.join();
+  for (auto &Reader : Readers) {
+    Reader.join();
+  }
+  EXPECT_EQ(Store.findModule("b"), nullptr);
+  EXPECT_EQ(Store.getModuleListSize(), 1U);
+}
+
+TEST(VM, ExecuteBatch) {
+  // (func (export "add") (param i32 i32) (result i32)
+  //   local.get 0 local.get 1 i32.add)
+  std::array<WasmEdge::Byte, 41> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01,
+      0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+      0x00, 0x20, 0x01, 0x6a, 0x0b};
+  const std::array<WasmEdge::ValType, 2> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32),
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  constexpr uint32_t Rows = 1000;
+  std::vector<int32_t> A(Rows), B(Rows);
+  for (uint32_t I = 0; I < Rows; ++I) {
+    A[I] = static_cast<int32_t>(I);
+    B[I] = -2 * static_cast<int32_t>(I) + 7;
+  }
+  const std::array<const void *, 2> Params = {A.data(), B.data()};
+  for (uint32_t Threads : {1U, 4U}) {
+    std::vector<int32_t> C(Rows, 0);
+    const std::array<void *, 1> Returns = {C.data()};
+    ASSERT_TRUE(
+        VM.executeBatch("add", ParamTypes, Params, Returns, Rows, Threads));
+    for (uint32_t I = 0; I < Rows; ++I) {
+      EXPECT_EQ(C[I], A[I] + B[I]);
+    }
+  }
+
+  // The columns should match the function type.
+  std::vector<int32_t> C(Rows, 0);
+  const std::array<void *, 1> Returns = {C.data()};
+  auto Res = VM.executeBatch(
+      "add", WasmEdge::Span<const WasmEdge::ValType>(ParamTypes).first(1),
+      WasmEdge::Span<const void *const>(Params).first(1), Returns, Rows);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::FuncSigMismatch);
+  Res = VM.executeBatch("sub", ParamTypes, Params, Returns, Rows);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::FuncNotFound);
+}
+
+/// Host function writing the counter into the caller memory and returning it,
+/// so its results differ from run to run.
+class HostCounter : public WasmEdge::Runtime::HostFunction<HostCounter> {
+public:
+  HostCounter(uint32_t &C) : Counter(C) {}
+  WasmEdge::Expect<uint32_t> body(const WasmEdge::Runtime::CallingFrame &Frame,
+                                  uint32_t Offset) {
+    auto *MemInst = Frame.getMemoryByIndex(0);
+    if (MemInst == nullptr) {
+      return WasmEdge::Unexpect(WasmEdge::ErrCode::Value::HostFuncError);
+    }
+    *MemInst->getPointer<uint32_t *>(Offset) = Counter * 10;
+    return Counter++;
+  }
+
+private:
+  uint32_t &Counter;
+};
+
+TEST(HostCallTrace, RecordAndReplay) {
+  // (module (import "env" "next" (func (param i32) (result i32)))
+  //   (memory (export "memory") 1)
+  //   (func (export "run") (result i32)
+  //     (i32.add (call 0 (i32.const 16)) (i32.load (i32.const 16)))))
+  std::array<WasmEdge::Byte, 77> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0a, 0x02,
+      0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x02, 0x0c,
+      0x01, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x6e, 0x65, 0x78, 0x74, 0x00,
+      0x00, 0x03, 0x02, 0x01, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07,
+      0x10, 0x02, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00,
+      0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x0e, 0x01, 0x0c, 0x00,
+      0x41, 0x10, 0x10, 0x00, 0x41, 0x10, 0x28, 0x02, 0x00, 0x6a, 0x0b};
+  const auto Path = std::filesystem::temp_directory_path() /
+                    "wasmedge-host-call-test.trace"sv;
+  using Mode = WasmEdge::Executor::HostCallTrace::Mode;
+
+  uint32_t Counter = 0;
+  auto Run = [&](Mode M, uint32_t Calls) {
+    std::vector<uint32_t> Results;
+    WasmEdge::Runtime::Instance::ModuleInstance Env("env");
+    Env.addHostFunc("next"sv, std::make_unique<HostCounter>(Counter));
+    WasmEdge::Configure Conf;
+    WasmEdge::VM::VM VM(Conf);
+    std::shared_ptr<WasmEdge::Executor::HostCallTrace> Trace =
+        WasmEdge::Executor::HostCallTrace::open(Path, M);
+    EXPECT_TRUE(Trace);
+    VM.getExecutor().registerHostCallTrace(Trace);
+    EXPECT_TRUE(VM.registerModule(Env));
+    EXPECT_TRUE(VM.loadWasm(Wasm));
+    EXPECT_TRUE(VM.validate());
+    EXPECT_TRUE(VM.instantiate());
+    for (uint32_t I = 0; I < Calls; ++I) {
+      auto Res = VM.execute("run");
+      if (!Res) {
+        EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::HostFuncError);
+        break;
+      }
+      Results.push_back((*Res)[0].first.get<uint32_t>());
+    }
+    const auto *MemInst = VM.getActiveModule()->findMemoryExports("memory");
+    Results.push_back(*MemInst->getPointer<uint32_t *>(16));
+    return Results;
+  };
+
+  // The results and the memory writes of the host calls are recorded.
+  Counter = 1;
+  EXPECT_EQ(Run(Mode::Record, 2), (std::vector<uint32_t>{11, 22, 20}));
+  EXPECT_EQ(Counter, 3U);
+
+  // They are replayed without running the host function, until the trace
+  // runs out.
+  Counter = 100;
+  EXPECT_EQ(Run(Mode::Replay, 3), (std::vector<uint32_t>{11, 22, 20}));
+  EXPECT_EQ(Counter, 100U);
+  std::filesystem::remove(Path);
+}
+
+TEST(Sampler, CollapsedStacks) {
+  // (func $spin_loop (export "spin") (param i32)
+  //   loop local.get 0 i32.const 1 i32.sub local.tee 0 br_if 0 end)
+  std::array<WasmEdge::Byte, 68> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+      0x01, 0x7f, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04, 0x73,
+      0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x10, 0x01, 0x0e, 0x00, 0x03, 0x40,
+      0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x0b, 0x00,
+      0x13, 0x04, 0x6e, 0x61, 0x6d, 0x65, 0x01, 0x0c, 0x01, 0x00, 0x09, 0x73,
+      0x70, 0x69, 0x6e, 0x5f, 0x6c, 0x6f, 0x6f, 0x70};
+  if (!WasmEdge::Sampler::start(1000)) {
+    GTEST_SKIP() << "Sampling is not supported";
+  }
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const std::vector<WasmEdge::ValVariant> Params = {1000000U};
+  const std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  // Spin until sampled, for at most about 2 seconds of CPU time.
+  const auto Deadline = std::chrono::steady_clock::now() + 2s;
+  while (WasmEdge::Sampler::getSampleCount() < 10 &&
+         std::chrono::steady_clock::now() < Deadline) {
+    ASSERT_TRUE(VM.execute("spin", Params, ParamTypes));
+  }
+  WasmEdge::Sampler::stop();
+  EXPECT_GT(WasmEdge::Sampler::getSampleCount(), 0U);
+
+  const auto Path = std::filesystem::temp_directory_path() /
+                    "wasmedge-sampler-test.folded"sv;
+  ASSERT_TRUE(WasmEdge::Sampler::saveCollapsed(Path));
+  std::ifstream IS(Path);
+  std::string Line;
+  bool Found = false;
+  while (std::getline(IS, Line)) {
+    if (Line.find("spin_loop"sv) != std::string::npos) {
+      Found = true;
+    }
+  }
+  IS.close();
+  std::filesystem::remove(Path);
+  EXPECT_TRUE(Found);
+}
+
+TEST(Statistics, FunctionProfiling) {
+  // (func $spin_loop (export "spin") (param i32)
+  //   loop local.get 0 i32.const 1 i32.sub local.tee 0 br_if 0 end)
+  std::array<WasmEdge::Byte, 47> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+      0x01, 0x7f, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04, 0x73,
+      0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x10, 0x01, 0x0e, 0x00, 0x03, 0x40,
+      0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setInstructionCounting(true);
+  Conf.getStatisticsConfigure().setFunctionProfiling(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const std::vector<WasmEdge::ValVariant> Params = {100U};
+  const std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+  ASSERT_TRUE(VM.execute("spin", Params, ParamTypes));
+  ASSERT_TRUE(VM.execute("spin", Params, ParamTypes));
+
+  // Every counted instruction belongs to the only function.
+  const auto Records = VM.getStatistics().getFunctionRecords();
+  ASSERT_EQ(Records.size(), 1U);
+  EXPECT_EQ(Records[0].Name, "spin"sv);
+  EXPECT_EQ(Records[0].Calls, 2U);
+  EXPECT_GE(Records[0].InstrCount, 2U * 5U * 100U);
+  EXPECT_EQ(Records[0].InstrCount, VM.getStatistics().getInstrCount());
+}
+
+TEST(Statistics, CostLimitBatched) {
+  // (func $spin_loop (export "spin") (param i32)
+  //   loop local.get 0 i32.const 1 i32.sub local.tee 0 br_if 0 end)
+  std::array<WasmEdge::Byte, 47> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+      0x01, 0x7f, 0x00, 0x03, 0x02, 0x01, 0x00, 0x07, 0x08, 0x01, 0x04, 0x73,
+      0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x10, 0x01, 0x0e, 0x00, 0x03, 0x40,
+      0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getStatisticsConfigure().setInstructionCounting(true);
+  Conf.getStatisticsConfigure().setCostMeasuring(true);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const std::vector<WasmEdge::ValType> ParamTypes = {
+      WasmEdge::ValType(WasmEdge::TypeCode::I32)};
+
+  // The batched counters are exact after returning.
+  ASSERT_TRUE(VM.execute("spin", std::vector<WasmEdge::ValVariant>{100U},
+                         ParamTypes));
+  EXPECT_EQ(VM.getStatistics().getInstrCount(), 1U + 5U * 100U + 2U);
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 1U + 5U * 100U + 2U);
+
+  // The execution traps at the instruction exceeding the limit.
+  VM.getStatistics().clear();
+  VM.getStatistics().setCostLimit(250U);
+  auto Result = VM.execute(
+      "spin", std::vector<WasmEdge::ValVariant>{1000U}, ParamTypes);
+  ASSERT_FALSE(Result);
+  EXPECT_EQ(Result.error(), WasmEdge::ErrCode::Value::CostLimitExceeded);
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 250U);
+  EXPECT_EQ(VM.getStatistics().getInstrCount(), 251U);
+}
+
 TEST(Coredump, generateCoredump) {
   WasmEdge::Configure Conf;
   Conf.getRuntimeConfigure().setEnableCoredump(true);
@@ -266,6 +1752,34 @@ TEST(Coredump, generateCoredump) {
   EXPECT_TRUE(FindCoredump);
 }
 
+TEST(Coredump, createSparseData) {
+  WasmEdge::Configure Conf;
+  WasmEdge::VM::VM VM(Conf);
+  std::array<WasmEdge::Byte, 70> Wasm{
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01, 0x60,
+      0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07,
+      0x1e, 0x02, 0x03, 0x6d, 0x65, 0x6d, 0x02, 0x00, 0x14, 0x61, 0x63, 0x63,
+      0x65, 0x73, 0x73, 0x5f, 0x6f, 0x75, 0x74, 0x5f, 0x6f, 0x66, 0x5f, 0x62,
+      0x6f, 0x75, 0x6e, 0x64, 0x73, 0x00, 0x00, 0x0a, 0x0d, 0x01, 0x0b, 0x00,
+      0x41, 0xf0, 0xa2, 0x04, 0x41, 0x00, 0x36, 0x02, 0x00, 0x0b};
+  ASSERT_TRUE(VM.loadWasm(Wasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto *Mem = VM.getActiveModule()->findMemoryExports("mem");
+  ASSERT_NE(Mem, nullptr);
+  // The non-zero bytes in the adjacent chunks are dumped in one segment.
+  Mem->getDataPtr()[40000] = 1;
+  Mem->getDataPtr()[40960] = 2;
+  const WasmEdge::Runtime::Instance::MemoryInstance *Mems[] = {Mem};
+  auto DataSec = WasmEdge::Coredump::createData(Mems);
+  ASSERT_EQ(DataSec.getContent().size(), 1U);
+  const auto &Seg = DataSec.getContent()[0];
+  EXPECT_EQ(Seg.getExpr().getInstrs()[0].getNum().get<uint32_t>(), 36864U);
+  ASSERT_EQ(Seg.getData().size(), 8192U);
+  EXPECT_EQ(Seg.getData()[40000 - 36864], 1U);
+  EXPECT_EQ(Seg.getData()[40960 - 36864], 2U);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -3,6 +3,17 @@
 #if WASMEDGE_OS_LINUX
 
 #include "../../../lib/host/wasi/linux.h"
+#include "host/wasi/eventloop.h"
+#include "host/wasi/fdtable.h"
+#include "host/wasi/inode.h"
+#include "host/wasi/resolver.h"
+#include "host/wasi/vinode.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <tuple>
 
 using namespace WasmEdge::Host::WASI::detail;
 
@@ -282,4 +293,526 @@ TEST(LinuxTest, toAddressFamily) {
   EXPECT_EQ(toAddressFamily(__WASI_ADDRESS_FAMILY_INET4), PF_INET);
   EXPECT_EQ(toAddressFamily(__WASI_ADDRESS_FAMILY_INET6), PF_INET6);
 }
+
+TEST(linuxTest, UringPoll) {
+  WasmEdge::Host::WASI::UringHolder Ring;
+  if (!Ring.create(4)) {
+    // io_uring may be unsupported or disabled.
+    GTEST_SKIP();
+  }
+  int Idle[2], Ready[2];
+  ASSERT_EQ(::pipe(Idle), 0);
+  ASSERT_EQ(::pipe(Ready), 0);
+  ASSERT_EQ(::write(Ready[1], "x", 1), 1);
+
+  // Only the ready fd completes.
+  ASSERT_TRUE(Ring.pollAdd(Idle[0], EPOLLIN, 1));
+  ASSERT_TRUE(Ring.pollAdd(Ready[0], EPOLLIN, 2));
+  ASSERT_TRUE(Ring.submit(1));
+  uint64_t UserData;
+  int32_t Result;
+  ASSERT_TRUE(Ring.pop(UserData, Result));
+  EXPECT_EQ(UserData, 2U);
+  EXPECT_TRUE(Result & EPOLLIN);
+  EXPECT_FALSE(Ring.pop(UserData, Result));
+
+  // The removed poll completes with cancellation.
+  ASSERT_TRUE(Ring.pollRemove(1));
+  ASSERT_TRUE(Ring.submit(2));
+  bool Canceled = false;
+  while (Ring.pop(UserData, Result)) {
+    if (UserData == 1U) {
+      Canceled = Result == -ECANCELED;
+    }
+  }
+  EXPECT_TRUE(Canceled);
+
+  for (int Fd : {Idle[0], Idle[1], Ready[0], Ready[1]}) {
+    ::close(Fd);
+  }
+}
+
+TEST(linuxTest, PollReusedFd) {
+  using namespace WasmEdge::Host::WASI;
+  PollerContext Ctx;
+  Poller P(Ctx);
+  ASSERT_TRUE(P.ok());
+  std::array<__wasi_event_t, 2> Events;
+  // The node is kept at the same address, and its fd number is reused.
+  std::optional<INode> Slot;
+  auto Poll = [&](__wasi_userdata_t UserData) {
+    ASSERT_TRUE(P.prepare(Events));
+    P.read(*Slot, TriggerType::Level, UserData);
+    // Time out instead of hanging if the read is never polled.
+    P.clock(__WASI_CLOCKID_MONOTONIC, UINT64_C(1000000000), 0,
+            static_cast<__wasi_subclockflags_t>(0), 0);
+    P.wait();
+    ASSERT_GE(P.result(), 1U);
+    EXPECT_EQ(Events[0].userdata, UserData);
+    EXPECT_EQ(Events[0].type, __WASI_EVENTTYPE_FD_READ);
+    P.reset();
+  };
+
+  int Sock[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, Sock), 0);
+  const int Reused = Sock[0];
+  Slot.emplace(Sock[0]);
+  ASSERT_EQ(::write(Sock[1], "x", 1), 1);
+  Poll(1);
+  Slot.reset();
+  ::close(Sock[1]);
+
+  // The closed fd was removed from the epoll set by the kernel.
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, Sock), 0);
+  EXPECT_EQ(Sock[0], Reused);
+  Slot.emplace(Sock[0]);
+  ASSERT_EQ(::write(Sock[1], "y", 1), 1);
+  Poll(2);
+  Slot.reset();
+  ::close(Sock[1]);
+}
+
+TEST(linuxTest, Sendfile) {
+  using WasmEdge::Host::WASI::INode;
+  char Path[] = "/tmp/wasmedgeSendfileXXXXXX";
+  const int File = ::mkstemp(Path);
+  ASSERT_GE(File, 0);
+  ::unlink(Path);
+  ASSERT_EQ(::write(File, "hello", 5), 5);
+  ASSERT_EQ(::lseek(File, 1, SEEK_SET), 1);
+  int Pipe[2], Sock[2];
+  ASSERT_EQ(::pipe(Pipe), 0);
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, Sock), 0);
+
+  auto FileNode = INode::fromFd(File);
+  auto PipeIn = INode::fromFd(Pipe[0]);
+  auto PipeOut = INode::fromFd(Pipe[1]);
+  auto SockIn = INode::fromFd(Sock[0]);
+  auto SockOut = INode::fromFd(Sock[1]);
+  ASSERT_TRUE(FileNode && PipeIn && PipeOut && SockIn && SockOut);
+  __wasi_filesize_t NWritten = 0;
+  char Buffer[8];
+
+  // File to pipe, from the current offset.
+  ASSERT_TRUE(PipeOut->fdSendfile(*FileNode, 3, NWritten));
+  EXPECT_EQ(NWritten, 3U);
+  ASSERT_EQ(::read(Pipe[0], Buffer, sizeof(Buffer)), 3);
+  EXPECT_EQ(std::string_view(Buffer, 3), "ell");
+
+  // Socket to socket, through the host buffer.
+  ASSERT_EQ(::write(Sock[1], "abc", 3), 3);
+  ASSERT_TRUE(SockOut->fdSendfile(*SockIn, 8, NWritten));
+  EXPECT_EQ(NWritten, 3U);
+  ASSERT_EQ(::read(Sock[0], Buffer, sizeof(Buffer)), 3);
+  EXPECT_EQ(std::string_view(Buffer, 3), "abc");
+
+  // A full non-blocking output takes nothing from the input.
+  int Full[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, Full), 0);
+  ASSERT_EQ(::fcntl(Full[0], F_SETFL, O_NONBLOCK), 0);
+  char Junk[4096] = {};
+  size_t Filled = 0;
+  while (true) {
+    const auto Res = ::write(Full[0], Junk, sizeof(Junk));
+    if (Res <= 0) {
+      break;
+    }
+    Filled += static_cast<size_t>(Res);
+  }
+  ASSERT_EQ(errno, EAGAIN);
+  auto FullOut = INode::fromFd(Full[0]);
+  ASSERT_TRUE(FullOut);
+  ASSERT_EQ(::write(Sock[1], "defgh", 5), 5);
+  auto Res = FullOut->fdSendfile(*SockIn, 8, NWritten);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), __WASI_ERRNO_AGAIN);
+  EXPECT_EQ(::recv(Sock[0], Buffer, sizeof(Buffer), MSG_PEEK), 5);
+  size_t Drained = 0;
+  while (Drained < Filled) {
+    const auto Got = ::recv(Full[1], Junk, sizeof(Junk), MSG_DONTWAIT);
+    ASSERT_GT(Got, 0);
+    Drained += static_cast<size_t>(Got);
+  }
+  ASSERT_TRUE(FullOut->fdSendfile(*SockIn, 8, NWritten));
+  EXPECT_EQ(NWritten, 5U);
+  ASSERT_EQ(::read(Full[1], Buffer, sizeof(Buffer)), 5);
+  EXPECT_EQ(std::string_view(Buffer, 5), "defgh");
+  EXPECT_EQ(::recv(Sock[0], Buffer, sizeof(Buffer), MSG_DONTWAIT), -1);
+
+  for (int Fd : {File, Pipe[0], Pipe[1], Sock[0], Sock[1], Full[0], Full[1]}) {
+    ::close(Fd);
+  }
+}
+
+TEST(linuxTest, PathCache) {
+  using WasmEdge::Host::WASI::VINode;
+  char Dir[] = "/tmp/wasmedgePathCacheXXXXXX";
+  ASSERT_NE(::mkdtemp(Dir), nullptr);
+  const std::string Root(Dir);
+  ASSERT_EQ(::mkdir((Root + "/a").c_str(), 0755), 0);
+  ASSERT_EQ(::mkdir((Root + "/a/b").c_str(), 0755), 0);
+  ASSERT_EQ(::mkdir((Root + "/a/b/f").c_str(), 0755), 0);
+
+  const auto Rights = static_cast<__wasi_rights_t>(~UINT64_C(0));
+  auto Preopen = VINode::bind(Rights, Rights, "/", Root);
+  ASSERT_TRUE(Preopen);
+  (*Preopen)->enablePathCache();
+  __wasi_filestat_t Filestat;
+  const auto Follow = __WASI_LOOKUPFLAGS_SYMLINK_FOLLOW;
+  EXPECT_TRUE(VINode::pathFilestatGet(*Preopen, "a/b/f", Follow, Filestat));
+  EXPECT_TRUE(VINode::pathFilestatGet(*Preopen, "a/b/f", Follow, Filestat));
+
+  // Replace the cached directory.
+  ASSERT_EQ(::rename((Root + "/a/b").c_str(), (Root + "/a/c").c_str()), 0);
+  ASSERT_EQ(::mkdir((Root + "/a/b").c_str(), 0755), 0);
+  ASSERT_EQ(::mkdir((Root + "/a/b/g").c_str(), 0755), 0);
+  EXPECT_TRUE(VINode::pathFilestatGet(*Preopen, "a/b/g", Follow, Filestat));
+  EXPECT_FALSE(VINode::pathFilestatGet(*Preopen, "a/b/f", Follow, Filestat));
+  EXPECT_TRUE(VINode::pathFilestatGet(*Preopen, "a/c/f", Follow, Filestat));
+
+  for (const char *Path : {"/a/b/g", "/a/b", "/a/c/f", "/a/c", "/a", ""}) {
+    ::rmdir((Root + Path).c_str());
+  }
+}
+
+TEST(linuxTest, Archive) {
+  using namespace WasmEdge::Host::WASI;
+  std::vector<uint8_t> Image;
+  auto Add = [&Image](std::string_view Name, char Type,
+                      std::string_view Content, std::string_view Link = {}) {
+    std::array<char, 512> Header{};
+    std::copy(Name.begin(), Name.end(), Header.begin());
+    std::snprintf(&Header[124], 12, "%011o",
+                  static_cast<unsigned>(Content.size()));
+    std::snprintf(&Header[136], 12, "%011o", 1U);
+    Header[156] = Type;
+    std::copy(Link.begin(), Link.end(), Header.begin() + 157);
+    std::copy_n("ustar", 6, Header.begin() + 257);
+    Image.insert(Image.end(), Header.begin(), Header.end());
+    Image.insert(Image.end(), Content.begin(), Content.end());
+    Image.resize((Image.size() + 511) / 512 * 512);
+  };
+  Add("./lib/", '5', {});
+  Add("./lib/os.py", '0', "import sys\n");
+  Add("./lib/site.py", '2', {}, "os.py");
+  Add("./data/icu.dat", '0', "icu");
+  Image.resize(Image.size() + 1024);
+
+  auto A = Archive::fromImage(Image);
+  ASSERT_TRUE(A);
+  const auto Rights = static_cast<__wasi_rights_t>(~UINT64_C(0));
+  auto Root = std::make_shared<VINode>(ArchiveNode(*A, 0), Rights, Rights);
+  const auto Follow = __WASI_LOOKUPFLAGS_SYMLINK_FOLLOW;
+  const auto NoFlags = static_cast<__wasi_oflags_t>(0);
+  const auto NoFdFlags = static_cast<__wasi_fdflags_t>(0);
+
+  // Read through the symbolic link.
+  auto File = VINode::pathOpen(Root, "lib/site.py", Follow, NoFlags,
+                               __WASI_RIGHTS_FD_READ, Rights, NoFdFlags);
+  ASSERT_TRUE(File);
+  std::array<uint8_t, 16> Buffer;
+  WasmEdge::Span<uint8_t> IOV(Buffer.data(), 4);
+  __wasi_size_t NRead = 0;
+  ASSERT_TRUE((*File)->fdRead(WasmEdge::Span<WasmEdge::Span<uint8_t>>(&IOV, 1),
+                              NRead));
+  EXPECT_EQ(NRead, 4U);
+  IOV = WasmEdge::Span<uint8_t>(Buffer.data() + 4, 12);
+  ASSERT_TRUE((*File)->fdRead(WasmEdge::Span<WasmEdge::Span<uint8_t>>(&IOV, 1),
+                              NRead));
+  EXPECT_EQ(NRead, 7U);
+  EXPECT_EQ(std::string_view(reinterpret_cast<char *>(Buffer.data()), 11),
+            "import sys\n");
+
+  __wasi_filestat_t Filestat;
+  ASSERT_TRUE(VINode::pathFilestatGet(Root, "data/icu.dat", Follow, Filestat));
+  EXPECT_EQ(Filestat.filetype, __WASI_FILETYPE_REGULAR_FILE);
+  EXPECT_EQ(Filestat.size, 3U);
+  EXPECT_EQ(Filestat.mtim, UINT64_C(1000000000));
+  EXPECT_FALSE(VINode::pathFilestatGet(Root, "lib/../../data", Follow,
+                                       Filestat));
+  EXPECT_FALSE(VINode::pathOpen(Root, "lib/new.py", Follow,
+                                __WASI_OFLAGS_CREAT, __WASI_RIGHTS_FD_READ,
+                                Rights, NoFdFlags));
+
+  // ".", "..", "os.py" and "site.py".
+  auto Dir = VINode::pathOpen(Root, "lib", Follow, __WASI_OFLAGS_DIRECTORY,
+                              Rights, Rights, NoFdFlags);
+  ASSERT_TRUE(Dir);
+  std::array<uint8_t, 256> Entries;
+  __wasi_size_t Size = 0;
+  ASSERT_TRUE((*Dir)->fdReaddir(Entries, 2, Size));
+  ASSERT_EQ(Size, 2 * sizeof(__wasi_dirent_t) + 5 + 7);
+  __wasi_dirent_t Dirent;
+  std::memcpy(&Dirent, Entries.data(), sizeof(Dirent));
+  EXPECT_EQ(Dirent.d_next, 3U);
+  EXPECT_EQ(Dirent.d_namlen, 5U);
+  EXPECT_EQ(Dirent.d_type, __WASI_FILETYPE_REGULAR_FILE);
+  EXPECT_EQ(std::string_view(reinterpret_cast<char *>(Entries.data()) +
+                                 sizeof(Dirent),
+                             5),
+            "os.py");
+}
+
+TEST(linuxTest, SockMmsg) {
+  using namespace WasmEdge::Host::WASI;
+  int Sock[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_DGRAM, 0, Sock), 0);
+  auto Sender = INode::fromFd(Sock[0]);
+  auto Receiver = INode::fromFd(Sock[1]);
+  ASSERT_TRUE(Sender && Receiver);
+
+  const std::array<std::string_view, 3> Datagrams = {"a", "bc", "def"};
+  std::array<WasmEdge::Span<const uint8_t>, 3> SendIOVs;
+  std::array<SendMessage, 3> SendMsgs;
+  for (size_t I = 0; I < Datagrams.size(); ++I) {
+    SendIOVs[I] = {reinterpret_cast<const uint8_t *>(Datagrams[I].data()),
+                   Datagrams[I].size()};
+    SendMsgs[I].Data = {&SendIOVs[I], 1};
+  }
+  __wasi_size_t NMsgs = 0;
+  ASSERT_TRUE(Sender->sockSendMmsg(SendMsgs, {}, NMsgs));
+  EXPECT_EQ(NMsgs, 3U);
+
+  // Only the arrived datagrams are returned without blocking.
+  std::array<std::array<uint8_t, 8>, 4> Buffers;
+  std::array<WasmEdge::Span<uint8_t>, 4> RecvIOVs;
+  std::array<RecvMessage, 4> RecvMsgs;
+  for (size_t I = 0; I < RecvMsgs.size(); ++I) {
+    RecvIOVs[I] = Buffers[I];
+    RecvMsgs[I].Data = {&RecvIOVs[I], 1};
+  }
+  ASSERT_TRUE(Receiver->sockRecvMmsg(RecvMsgs, {}, NMsgs));
+  ASSERT_EQ(NMsgs, 3U);
+  for (size_t I = 0; I < Datagrams.size(); ++I) {
+    EXPECT_EQ(std::string_view(reinterpret_cast<char *>(Buffers[I].data()),
+                               RecvMsgs[I].Size),
+              Datagrams[I]);
+  }
+
+  ::close(Sock[0]);
+  ::close(Sock[1]);
+}
+
+TEST(linuxTest, SockMmsgUnconvertedAddress) {
+  using namespace WasmEdge::Host::WASI;
+  // The abstract addresses of the peers do not fit in the address buffers.
+  auto Bind = [](std::string_view Name) {
+    const int Fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    sockaddr_un Addr = {};
+    Addr.sun_family = AF_UNIX;
+    const auto Path = std::string(Name) + std::to_string(::getpid());
+    std::copy(Path.begin(), Path.end(), Addr.sun_path + 1);
+    const auto Size = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) +
+                                             1 + Path.size());
+    EXPECT_EQ(::bind(Fd, reinterpret_cast<sockaddr *>(&Addr), Size), 0);
+    return std::make_tuple(Fd, Addr, Size);
+  };
+  const int Send = std::get<0>(Bind("wasmedgeMmsgSend"));
+  auto [Recv, RecvAddr, RecvSize] = Bind("wasmedgeMmsgRecv");
+  for (const char *Data : {"a", "bc"}) {
+    ASSERT_EQ(::sendto(Send, Data, std::strlen(Data), 0,
+                       reinterpret_cast<sockaddr *>(&RecvAddr), RecvSize),
+              static_cast<ssize_t>(std::strlen(Data)));
+  }
+  auto Receiver = INode::fromFd(Recv);
+  ASSERT_TRUE(Receiver);
+
+  // The received datagrams are returned even if their addresses fail.
+  std::array<std::array<uint8_t, 8>, 2> Buffers;
+  std::array<std::array<uint8_t, 16>, 2> Addresses;
+  std::array<WasmEdge::Span<uint8_t>, 2> RecvIOVs;
+  std::array<RecvMessage, 2> RecvMsgs;
+  for (size_t I = 0; I < RecvMsgs.size(); ++I) {
+    RecvIOVs[I] = Buffers[I];
+    RecvMsgs[I].Data = {&RecvIOVs[I], 1};
+    RecvMsgs[I].Address = Addresses[I];
+  }
+  __wasi_size_t NMsgs = 0;
+  ASSERT_TRUE(Receiver->sockRecvMmsg(RecvMsgs, {}, NMsgs));
+  ASSERT_EQ(NMsgs, 2U);
+  EXPECT_EQ(RecvMsgs[0].Size, 1U);
+  EXPECT_EQ(RecvMsgs[1].Size, 2U);
+  for (const auto &Msg : RecvMsgs) {
+    EXPECT_EQ(Msg.AddressFamily, __WASI_ADDRESS_FAMILY_UNSPEC);
+  }
+
+  ::close(Send);
+  ::close(Recv);
+}
+
+TEST(linuxTest, EventLoop) {
+  using namespace WasmEdge::Host::WASI;
+  int Sock[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, Sock), 0);
+  const auto Rights = static_cast<__wasi_rights_t>(~UINT64_C(0));
+  auto Reader = VINode::fromFd(Sock[0], Rights, Rights);
+  ASSERT_TRUE(Reader);
+
+  EventLoop Loop;
+  std::vector<std::string_view> Log;
+  ASSERT_TRUE(Loop.spawn([&]() noexcept {
+    EXPECT_EQ(EventLoop::current(), &Loop);
+    Log.push_back("wait");
+    EXPECT_TRUE(Loop.wait(**Reader, __WASI_EVENTTYPE_FD_READ));
+    char Buffer[8];
+    EXPECT_EQ(::read(Sock[0], Buffer, sizeof(Buffer)), 3);
+    Log.push_back("read");
+  }));
+  ASSERT_TRUE(Loop.spawn([&]() noexcept {
+    Log.push_back("yield");
+    Loop.yield();
+    // The reader is still parked, as nothing is written.
+    Log.push_back("write");
+    EXPECT_EQ(::write(Sock[1], "abc", 3), 3);
+  }));
+  ASSERT_TRUE(Loop.run());
+  EXPECT_EQ(EventLoop::current(), nullptr);
+  EXPECT_EQ(Log, (std::vector<std::string_view>{"wait", "yield", "write",
+                                                "read"}));
+
+  ::close(Sock[1]);
+}
+
+TEST(linuxTest, Resolver) {
+  using namespace WasmEdge::Host::WASI;
+  auto &R = Resolver::getDefault();
+  R.clear();
+  __wasi_addrinfo_t Hint = {};
+  Hint.ai_flags = __WASI_AIFLAGS_AI_NUMERICHOST | __WASI_AIFLAGS_AI_NUMERICSERV;
+  Hint.ai_family = __WASI_ADDRESS_FAMILY_INET4;
+  Hint.ai_socktype = __WASI_SOCK_TYPE_SOCK_STREAM;
+
+  auto First = R.resolve("127.0.0.1", "80", Hint);
+  ASSERT_TRUE(First);
+  ASSERT_EQ((*First)->size(), 1U);
+  const auto &Item = (**First)[0];
+  EXPECT_EQ(Item.SaFamily, __WASI_ADDRESS_FAMILY_INET4);
+  ASSERT_GE(Item.SaDataLen, 6U);
+  EXPECT_EQ(std::string_view(Item.SaData.data(), 6),
+            std::string_view("\0\x50\x7f\0\0\x01", 6));
+  // The second lookup is served by the cache.
+  auto Second = R.resolve("127.0.0.1", "80", Hint);
+  ASSERT_TRUE(Second);
+  EXPECT_EQ(*First, *Second);
+
+  // The lookup in a task runs on a background thread.
+  R.clear();
+  EventLoop Loop;
+  ASSERT_TRUE(Loop.spawn([&]() noexcept {
+    auto Res = R.resolve("127.0.0.1", "80", Hint);
+    ASSERT_TRUE(Res);
+    ASSERT_EQ((*Res)->size(), 1U);
+    EXPECT_EQ(std::string_view((**Res)[0].SaData.data(), 6),
+              std::string_view("\0\x50\x7f\0\0\x01", 6));
+  }));
+  ASSERT_TRUE(Loop.run());
+
+  // Nothing is kept without the TTL.
+  R.setTTL(std::chrono::seconds(0));
+  auto Third = R.resolve("127.0.0.1", "80", Hint);
+  auto Fourth = R.resolve("127.0.0.1", "80", Hint);
+  ASSERT_TRUE(Third && Fourth);
+  EXPECT_NE(*Third, *Fourth);
+  R.setTTL(std::chrono::seconds(30));
+}
+
+namespace {
+std::shared_ptr<WasmEdge::Host::WASI::VINode> openNull(int &Fd) {
+  using namespace WasmEdge::Host::WASI;
+  Fd = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+  const auto Rights = static_cast<__wasi_rights_t>(~UINT64_C(0));
+  return std::make_shared<VINode>(INode(Fd), Rights, Rights);
+}
+} // namespace
+
+TEST(linuxTest, FdTableReclaimOnRelease) {
+  using namespace WasmEdge::Host::WASI;
+  FdTable Table;
+  int Fd;
+  auto Node = openNull(Fd);
+  std::weak_ptr<VINode> Weak = Node;
+  Table.emplace(3, std::move(Node));
+  {
+    auto Ref = Table.find(3);
+    ASSERT_TRUE(Ref);
+    EXPECT_TRUE(Table.erase(3));
+    EXPECT_FALSE(Table.find(3));
+    // The node in use is kept open.
+    EXPECT_FALSE(Weak.expired());
+    EXPECT_NE(::fcntl(Fd, F_GETFD), -1);
+  }
+  // Released with the reference, without any later writer.
+  EXPECT_TRUE(Weak.expired());
+  EXPECT_EQ(::fcntl(Fd, F_GETFD), -1);
+}
+
+TEST(linuxTest, FdTableConcurrent) {
+  using namespace WasmEdge::Host::WASI;
+  constexpr const __wasi_fd_t kFds = 8;
+  constexpr const int kRounds = 1000;
+  FdTable Table;
+  std::vector<std::weak_ptr<VINode>> Nodes;
+  std::vector<int> OsFds;
+  auto Open = [&]() {
+    int Fd;
+    auto Node = openNull(Fd);
+    Nodes.push_back(Node);
+    OsFds.push_back(Fd);
+    return Node;
+  };
+  for (__wasi_fd_t Fd = 0; Fd < kFds; ++Fd) {
+    Table.emplace(Fd, Open());
+  }
+
+  std::atomic<bool> Done = false;
+  std::vector<std::thread> Readers;
+  for (int I = 0; I < 3; ++I) {
+    Readers.emplace_back([&Table, &Done, I]() {
+      for (uint32_t N = I; !Done.load(std::memory_order_relaxed); ++N) {
+        if (auto Ref = Table.find(static_cast<__wasi_fd_t>(N % kFds))) {
+          EXPECT_FALSE(Ref->isDirectory());
+          EXPECT_GE(Ref.share().use_count(), 2);
+        }
+      }
+    });
+  }
+  for (int I = 0; I < kRounds; ++I) {
+    const auto Fd = static_cast<__wasi_fd_t>(I % kFds);
+    switch (I % 4) {
+    case 0:
+      Table.erase(Fd);
+      break;
+    case 1:
+      EXPECT_TRUE(Table.insert(Open()));
+      break;
+    case 2:
+      Table.renumber(Fd, static_cast<__wasi_fd_t>((I + 3) % kFds));
+      break;
+    default:
+      Table.emplace(Fd, Open());
+      break;
+    }
+  }
+  Done.store(true, std::memory_order_relaxed);
+  for (auto &Reader : Readers) {
+    Reader.join();
+  }
+
+  // The removed nodes are all closed, and the others are closed on clear.
+  size_t Live = 0, Found = 0;
+  for (size_t I = 0; I < Nodes.size(); ++I) {
+    if (!Nodes[I].expired()) {
+      ++Live;
+      EXPECT_NE(::fcntl(OsFds[I], F_GETFD), -1);
+    }
+  }
+  for (__wasi_fd_t Fd = 0; Fd < kFds + kRounds; ++Fd) {
+    Found += Table.find(Fd) ? 1 : 0;
+  }
+  EXPECT_EQ(Live, Found);
+  Table.clear();
+  for (auto &Node : Nodes) {
+    EXPECT_TRUE(Node.expired());
+  }
+}
 #endif
@@ -5,6 +5,7 @@
 #include "common/types.h"
 #include "host/wasi/wasibase.h"
 #include "host/wasi/wasifunc.h"
+#include "host/wasi/wasimodule.h"
 #include "runtime/instance/module.h"
 #include "system/winapi.h"
 #include <algorithm>
@@ -17,6 +18,7 @@
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -3006,6 +3008,86 @@ TEST(WasiTest, ClockTimeGet) {
   Env.fini();
 }
 
+TEST(WasiTest, SharedFunctions) {
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+
+  // The WASI modules share the function objects, and the functions use the
+  // environment of the called module.
+  WasmEdge::Host::WasiModule WasiA, WasiB;
+  WasiA.init({}, "a"s, std::array{"one"s}, std::array{"X=1"s});
+  WasiB.init({}, "b"s, std::array{"two"s, "three"s}, {});
+  WasiA.setEnableIOStatistics(true);
+  WasiB.setEnableIOStatistics(true);
+  auto &ArgsSizesGet =
+      WasiA.findFuncExports("args_sizes_get")->getHostFunc();
+  auto &EnvironSizesGet =
+      WasiA.findFuncExports("environ_sizes_get")->getHostFunc();
+  auto &FdClose = WasiA.findFuncExports("fd_close")->getHostFunc();
+  auto &FdFdstatGet = WasiA.findFuncExports("fd_fdstat_get")->getHostFunc();
+  EXPECT_EQ(&WasiB.findFuncExports("args_sizes_get")->getHostFunc(),
+            &ArgsSizesGet);
+  const WasmEdge::Runtime::CallingFrame FrameA(nullptr, &Mod, &WasiA);
+  const WasmEdge::Runtime::CallingFrame FrameB(nullptr, &Mod, &WasiB);
+  std::array<WasmEdge::ValVariant, 1> Errno;
+
+  auto Count = [&](WasmEdge::Runtime::HostFunctionBase &Func,
+                   const WasmEdge::Runtime::CallingFrame &Frame) {
+    writeDummyMemoryContent(MemInst);
+    EXPECT_TRUE(Func.run(
+        Frame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0), UINT32_C(4)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+    return WasmEdge::EndianValue(*MemInst.getPointer<const uint32_t *>(0))
+        .le();
+  };
+  EXPECT_EQ(Count(ArgsSizesGet, FrameA), UINT32_C(2));
+  EXPECT_EQ(Count(ArgsSizesGet, FrameB), UINT32_C(3));
+  EXPECT_EQ(Count(ArgsSizesGet, FrameA), UINT32_C(2));
+  EXPECT_EQ(Count(EnvironSizesGet, FrameA), UINT32_C(1));
+  EXPECT_EQ(Count(EnvironSizesGet, FrameB), UINT32_C(0));
+
+  // Closing the stdout of a module keeps the one of the other.
+  auto FdstatGet = [&](const WasmEdge::Runtime::CallingFrame &Frame) {
+    EXPECT_TRUE(FdFdstatGet.run(
+        Frame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1), UINT32_C(0)},
+        Errno));
+    return Errno[0].get<int32_t>();
+  };
+  EXPECT_TRUE(FdClose.run(
+      FrameA, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(1)},
+      Errno));
+  EXPECT_EQ(Errno[0].get<int32_t>(), __WASI_ERRNO_SUCCESS);
+  EXPECT_EQ(FdstatGet(FrameA), __WASI_ERRNO_BADF);
+  EXPECT_EQ(FdstatGet(FrameB), __WASI_ERRNO_SUCCESS);
+
+  // The latencies are recorded in the histograms of each environment.
+  const auto *HistA = WasiA.getIOStatistics().getFunction("args_sizes_get"sv);
+  const auto *HistB = WasiB.getIOStatistics().getFunction("args_sizes_get"sv);
+  ASSERT_NE(HistA, nullptr);
+  ASSERT_NE(HistB, nullptr);
+  EXPECT_NE(HistA, HistB);
+  EXPECT_EQ(HistA->getCount(), UINT64_C(2));
+  EXPECT_EQ(HistB->getCount(), UINT64_C(1));
+
+  // The frames without the called module fail without a WASI module imported
+  // by the calling module.
+  const WasmEdge::Runtime::CallingFrame Frame(nullptr, &Mod);
+  auto Res = ArgsSizesGet.run(
+      Frame,
+      std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0), UINT32_C(4)},
+      Errno);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), WasmEdge::ErrCode::Value::HostFuncError);
+}
+
 TEST(WasiTest, ProcExit) {
   WasmEdge::Host::WASI::Environ Env;
   WasmEdge::Runtime::Instance::ModuleInstance Mod("");
@@ -5429,3 +5511,43 @@ TEST(WasiTest, PointerAlignment) {
     }
   }
 }
+
+#if !WASMEDGE_OS_WINDOWS
+TEST(WasiTest, ReusePort) {
+  // The environments of the worker processes bind the same port.
+  WasmEdge::Host::WASI::Environ Env1;
+  WasmEdge::Host::WASI::Environ Env2;
+  Env1.init({}, "test"s, {}, {});
+  Env2.init({}, "test"s, {}, {});
+  const std::array<uint8_t, 4> Address = {127, 0, 0, 1};
+
+  auto Bind = [&](WasmEdge::Host::WASI::Environ &Env,
+                  uint16_t Port) -> std::optional<__wasi_fd_t> {
+    auto Fd = Env.sockOpen(__WASI_ADDRESS_FAMILY_INET4,
+                           __WASI_SOCK_TYPE_SOCK_STREAM);
+    if (!Fd ||
+        !Env.sockBind(*Fd, __WASI_ADDRESS_FAMILY_INET4, Address, Port) ||
+        !Env.sockListen(*Fd, 1)) {
+      return std::nullopt;
+    }
+    return *Fd;
+  };
+
+  Env1.setEnableReusePort(true);
+  auto Fd1 = Bind(Env1, 0);
+  ASSERT_TRUE(Fd1);
+  __wasi_address_family_t Family;
+  std::array<uint8_t, 16> LocalAddress;
+  uint16_t Port = 0;
+  ASSERT_TRUE(Env1.sockGetLocalAddr(*Fd1, &Family, LocalAddress, &Port));
+  ASSERT_NE(Port, 0);
+
+  // Binding the listening port fails without SO_REUSEPORT.
+  EXPECT_FALSE(Bind(Env2, Port));
+  Env2.setEnableReusePort(true);
+  EXPECT_TRUE(Bind(Env2, Port));
+
+  Env1.fini();
+  Env2.fini();
+}
+#endif
@@ -14,11 +14,14 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "aot/cache.h"
 #include "common/defines.h"
+#include "common/metrics.h"
 #include "common/spdlog.h"
 #include "vm/vm.h"
 #include "llvm/codegen.h"
 #include "llvm/compiler.h"
+#include "llvm/jit.h"
 
 #include "../spec/hostfunc.h"
 #include "../spec/spectest.h"
@@ -32,6 +35,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -387,6 +391,246 @@ TEST_P(JITCoreTest, TestSuites) {
   T.run(Proposal, UnitName);
 }
 
+TEST(TieredJITTest, PromoteHotModule) {
+  // (func (param i32) (result i32) local.get 0 i32.const 1 i32.add) and three
+  // functions forwarding to it; the last one is exported as "f".
+  const std::vector<WasmEdge::Byte> Wasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+      0x01, 0x7f, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x07,
+      0x05, 0x01, 0x01, 0x66, 0x00, 0x03, 0x0a, 0x1e, 0x04, 0x07, 0x00, 0x20,
+      0x00, 0x41, 0x01, 0x6a, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x00, 0x0b,
+      0x06, 0x00, 0x20, 0x00, 0x10, 0x01, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10,
+      0x02, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableTieredJIT(true);
+  Conf.getRuntimeConfigure().setTierUpThreshold(10);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(WasmEdge::Span<const WasmEdge::Byte>(Wasm)));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const auto *FuncInst = VM.getActiveModule()->findFuncExports("f");
+  ASSERT_NE(FuncInst, nullptr);
+  auto Invoke = [&VM](uint32_t I) {
+    auto Res = VM.execute("f", std::array<ValVariant, 1>{ValVariant(I)},
+                          std::array<ValType, 1>{TypeCode::I32});
+    ASSERT_TRUE(Res);
+    EXPECT_EQ((*Res)[0].first.get<uint32_t>(), I + 1);
+  };
+  for (uint32_t I = 0; I < 20; ++I) {
+    Invoke(I);
+  }
+  // Wait for the background compilation to publish the compiled entries.
+  for (uint32_t I = 0; I < 100 && FuncInst->getTieredEntry() == nullptr; ++I) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  EXPECT_NE(FuncInst->getTieredEntry(), nullptr);
+  for (uint32_t I = 20; I < 40; ++I) {
+    Invoke(I);
+  }
+}
+
+TEST(LazyJITTest, CompileAtFirstCall) {
+  // Same module as above, with the calls going through the stubs.
+  const std::vector<WasmEdge::Byte> Wasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+      0x01, 0x7f, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x07,
+      0x05, 0x01, 0x01, 0x66, 0x00, 0x03, 0x0a, 0x1e, 0x04, 0x07, 0x00, 0x20,
+      0x00, 0x41, 0x01, 0x6a, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10, 0x00, 0x0b,
+      0x06, 0x00, 0x20, 0x00, 0x10, 0x01, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x10,
+      0x02, 0x0b};
+  for (const bool Speculate : {false, true}) {
+    WasmEdge::Configure Conf;
+    Conf.getRuntimeConfigure().setEnableJIT(true);
+    Conf.getRuntimeConfigure().setEnableLazyJIT(true);
+    Conf.getRuntimeConfigure().setEnableJITSpeculation(Speculate);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(WasmEdge::Span<const WasmEdge::Byte>(Wasm)));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    for (uint32_t I = 0; I < 10; ++I) {
+      auto Res = VM.execute("f", std::array<ValVariant, 1>{ValVariant(I)},
+                            std::array<ValType, 1>{TypeCode::I32});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), I + 1);
+    }
+  }
+}
+
+TEST(JITCacheTest, ShareExecutable) {
+  // (func (param i32) (result i32) local.get 0 i32.const 1 i32.add) exported
+  // as "f".
+  const std::vector<WasmEdge::Byte> Wasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01,
+      0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x05,
+      0x01, 0x01, 0x66, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+      0x00, 0x41, 0x01, 0x6a, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getCompilerConfigure().setOptimizationLevel(
+      WasmEdge::CompilerConfigure::OptimizationLevel::O0);
+  WasmEdge::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(WasmEdge::Span<const WasmEdge::Byte>(Wasm)));
+  ASSERT_TRUE(VM.validate());
+  auto Mod = VM.getLoader().parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(VM.getValidator().validate(**Mod));
+
+  uint32_t Loads = 0;
+  auto Load = [&](const WasmEdge::Configure &LoadConf)
+      -> Expect<std::shared_ptr<WasmEdge::Executable>> {
+    ++Loads;
+    LLVM::Compiler Compiler(LoadConf);
+    EXPECTED_TRY(auto Data, Compiler.compile(**Mod));
+    return LLVM::JIT(LoadConf).load(std::move(Data));
+  };
+  auto Get = [&](const WasmEdge::Configure &GetConf) {
+    return LLVM::JITCache::getOrLoad(Wasm, GetConf,
+                                     [&]() { return Load(GetConf); });
+  };
+
+  auto Exec1 = Get(Conf);
+  auto Exec2 = Get(Conf);
+  ASSERT_TRUE(Exec1 && Exec2);
+  EXPECT_EQ(Loads, 1U);
+  EXPECT_EQ(*Exec1, *Exec2);
+
+  // A configuration changing the generated code has its own executable.
+  WasmEdge::Configure GasConf = Conf;
+  GasConf.getStatisticsConfigure().setCostMeasuring(true);
+  auto Exec3 = Get(GasConf);
+  ASSERT_TRUE(Exec3);
+  EXPECT_EQ(Loads, 2U);
+  EXPECT_NE(*Exec1, *Exec3);
+
+  // The executable is released with its last user.
+  Exec1->reset();
+  Exec2->reset();
+  ASSERT_TRUE(Get(Conf));
+  EXPECT_EQ(Loads, 3U);
+
+  // The VMs of the same module run the shared executable.
+  ASSERT_TRUE(VM.instantiate());
+  auto Res = VM.execute("f", std::array<ValVariant, 1>{ValVariant(1U)},
+                        std::array<ValType, 1>{TypeCode::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 2U);
+}
+
+TEST(CompileReportTest, RecordFunctions) {
+  // (func (param i32) (result i32) local.get 0 i32.const 1 i32.add) exported
+  // as "f".
+  const std::vector<WasmEdge::Byte> Wasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01,
+      0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x05,
+      0x01, 0x01, 0x66, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+      0x00, 0x41, 0x01, 0x6a, 0x0b};
+  WasmEdge::Configure Conf;
+  Conf.getCompilerConfigure().setOutputFormat(
+      CompilerConfigure::OutputFormat::Native);
+  WasmEdge::Loader::Loader Loader(Conf);
+  WasmEdge::Validator::Validator ValidatorEngine(Conf);
+  auto Mod = Loader.parseModule(Wasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(ValidatorEngine.validate(**Mod));
+
+  const auto Dir = std::filesystem::temp_directory_path();
+  const auto SOPath = Dir / ("wasmedge_report_test" WASMEDGE_LIB_EXTENSION);
+  const auto ReportPath = Dir / "wasmedge_report_test.json";
+  LLVM::CompileReport Report;
+  LLVM::Compiler Compiler(Conf);
+  LLVM::CodeGen CodeGen(Conf);
+  Compiler.setReport(&Report);
+  CodeGen.setReport(&Report);
+  auto Data = Compiler.compile(**Mod);
+  ASSERT_TRUE(Data);
+  ASSERT_TRUE(CodeGen.codegen(Wasm, std::move(*Data), SOPath));
+
+  const auto *Func = Report.getFunction("f0");
+  ASSERT_NE(Func, nullptr);
+  EXPECT_GT(Func->Instructions, 0U);
+  EXPECT_GT(Func->OptimizedInstructions, 0U);
+  EXPECT_GT(Func->CodeSize, 0U);
+  EXPECT_EQ(Report.getFunction("missing"), nullptr);
+  ASSERT_TRUE(Report.save(ReportPath));
+  EXPECT_GT(std::filesystem::file_size(ReportPath), 0U);
+
+  std::filesystem::remove(SOPath);
+  std::filesystem::remove(ReportPath);
+}
+
+TEST(FunctionCacheTest, HitAndInvalidate) {
+  // (func (param i32) (result i32) local.get 0 i32.const K i32.add) for the
+  // two constants, exported as "a" and "b". The constants are padded to five
+  // bytes.
+  auto Generate = [](uint32_t A, uint32_t B) {
+    std::vector<WasmEdge::Byte> Wasm = {
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06,
+        0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00,
+        0x00, 0x07, 0x09, 0x02, 0x01, 0x61, 0x00, 0x00, 0x01, 0x62,
+        0x00, 0x01, 0x0a, 0x19, 0x02};
+    for (const uint32_t K : {A, B}) {
+      Wasm.insert(Wasm.end(), {0x0b, 0x00, 0x20, 0x00, 0x41});
+      for (uint32_t I = 0; I < 4; ++I) {
+        Wasm.push_back(static_cast<WasmEdge::Byte>(((K >> (I * 7)) & 0x7f) |
+                                                   0x80));
+      }
+      Wasm.insert(Wasm.end(), {static_cast<WasmEdge::Byte>(K >> 28), 0x6a,
+                               0x0b});
+    }
+    return Wasm;
+  };
+  // The entries are stored in a temporary directory instead of the home.
+  const auto Dir =
+      std::filesystem::temp_directory_path() / "wasmedge_function_cache_test";
+  std::filesystem::remove_all(Dir);
+  WasmEdge::AOT::Cache::setLocalRoot(Dir);
+
+  WasmEdge::Configure Conf;
+  Conf.getRuntimeConfigure().setEnableJIT(true);
+  Conf.getCompilerConfigure().setOptimizationLevel(
+      WasmEdge::CompilerConfigure::OptimizationLevel::O0);
+  Conf.getCompilerConfigure().setFunctionCache(true);
+  WasmEdge::Metrics::enable();
+  // Instantiate the module in a new VM, check the exports return their own
+  // constants, and check the lookups of the function cache.
+  auto Run = [&](uint32_t A, uint32_t B, uint32_t Hits, uint32_t Misses) {
+    WasmEdge::Metrics::clear();
+    const auto Wasm = Generate(A, B);
+    WasmEdge::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(WasmEdge::Span<const WasmEdge::Byte>(Wasm)));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    for (const auto &[Name, K] : {std::pair{"a"sv, A}, std::pair{"b"sv, B}}) {
+      const auto *FuncInst = VM.getActiveModule()->findFuncExports(Name);
+      ASSERT_NE(FuncInst, nullptr);
+      EXPECT_TRUE(FuncInst->isCompiledFunction());
+      auto Res = VM.execute(Name, std::array<ValVariant, 1>{ValVariant(1U)},
+                            std::array<ValType, 1>{TypeCode::I32});
+      ASSERT_TRUE(Res);
+      EXPECT_EQ((*Res)[0].first.get<uint32_t>(), K + 1);
+    }
+    const auto Rendered = WasmEdge::Metrics::render();
+    auto Counter = [](std::string_view Result, uint32_t Count) {
+      return fmt::format("wasmedge_cache_lookups_total{{cache=\"functions\","
+                         "result=\"{}\"}} {}\n"sv,
+                         Result, Count);
+    };
+    EXPECT_NE(Rendered.find(Counter("hit"sv, Hits)), std::string::npos);
+    EXPECT_NE(Rendered.find(Counter("miss"sv, Misses)), std::string::npos);
+  };
+
+  // Both functions are compiled and stored, then linked from the cache.
+  Run(1, 2, 0, 2);
+  EXPECT_FALSE(std::filesystem::is_empty(Dir / "functions"));
+  Run(1, 2, 2, 0);
+  // Only the changed function is compiled again.
+  Run(1, 3, 1, 1);
+  Run(1, 3, 2, 0);
+  WasmEdge::Metrics::clear();
+  WasmEdge::AOT::Cache::setLocalRoot({});
+  std::filesystem::remove_all(Dir);
+}
+
 // Initiate test suite.
 INSTANTIATE_TEST_SUITE_P(
     TestUnit, NativeCoreTest,
@@ -18,8 +18,13 @@
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <string>
+#include <thread>
 #include <vector>
 
+#ifdef WASMEDGE_USE_ZSTD
+#include <zstd.h>
+#endif
+
 namespace {
 
 WasmEdge::FileMgr Mgr;
@@ -509,6 +514,30 @@ TEST(FileManagerTest, File__ReadSigned33TooLarge) {
   EXPECT_EQ(WasmEdge::ErrCode::Value::IntegerTooLarge, ReadNum.error());
 }
 
+TEST(FileManagerTest, File__ReadSpan) {
+  // 23. Test unsigned char view reading.
+  WasmEdge::Expect<WasmEdge::Span<const uint8_t>> ReadSpan;
+  ASSERT_TRUE(Mgr.setPath("filemgrTestData/readByteTest.bin"));
+  auto Holder = Mgr.getDataHolder();
+  ASSERT_TRUE(Holder);
+  ASSERT_TRUE(ReadSpan = Mgr.readSpan(1));
+  EXPECT_EQ(0x00, ReadSpan.value()[0]);
+  ASSERT_TRUE(ReadSpan = Mgr.readSpan(2));
+  EXPECT_EQ(0xFF, ReadSpan.value()[0]);
+  EXPECT_EQ(0x1F, ReadSpan.value()[1]);
+  ASSERT_TRUE(ReadSpan = Mgr.readSpan(7));
+  ASSERT_FALSE(Mgr.readSpan(1));
+  EXPECT_EQ(10U, Mgr.getOffset());
+  // The view outlives the file manager data while the holder is kept.
+  Mgr.reset();
+  EXPECT_EQ(0x88, ReadSpan.value()[6]);
+  Holder.reset();
+  // The borrowed data has no holder.
+  const std::vector<uint8_t> Code = {0x00, 0xFF};
+  ASSERT_TRUE(Mgr.setCode(WasmEdge::Span<const uint8_t>(Code)));
+  EXPECT_FALSE(Mgr.getDataHolder());
+}
+
 TEST(FileManagerTest, Vector__ReadByte) {
   // 1. Test unsigned char reading.
   WasmEdge::Expect<uint8_t> ReadByte;
@@ -887,6 +916,47 @@ TEST(FileManagerTest, Vector__ReadSigned64TooLarge) {
   EXPECT_EQ(WasmEdge::ErrCode::Value::IntegerTooLarge, ReadNum.error());
 }
 
+TEST(FileManagerTest, Vector__ReadInWord) {
+  // 18. Test decoding in one word with the padding bytes after the integers.
+  WasmEdge::Expect<uint32_t> ReadU32;
+  WasmEdge::Expect<int32_t> ReadS32;
+  WasmEdge::Expect<int64_t> ReadS64;
+  WasmEdge::Expect<std::string> ReadStr;
+  const std::vector<uint8_t> Padding(8, 0x00);
+  std::vector<uint8_t> Code = {0x80, 0x80, 0x80, 0x80, 0x1F};
+  Code.insert(Code.end(), Padding.begin(), Padding.end());
+  ASSERT_TRUE(Mgr.setCode(Code));
+  ASSERT_FALSE(ReadU32 = Mgr.readU32());
+  EXPECT_EQ(WasmEdge::ErrCode::Value::IntegerTooLarge, ReadU32.error());
+
+  Code = {0xFF, 0xFF, 0xFF, 0xFF, 0x4F};
+  Code.insert(Code.end(), Padding.begin(), Padding.end());
+  ASSERT_TRUE(Mgr.setCode(Code));
+  ASSERT_FALSE(ReadS32 = Mgr.readS32());
+  EXPECT_EQ(WasmEdge::ErrCode::Value::IntegerTooLarge, ReadS32.error());
+
+  Code = {0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0xC0, 0xBB, 0x78, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+  Code.insert(Code.end(), Padding.begin(), Padding.end());
+  ASSERT_TRUE(Mgr.setCode(Code));
+  ASSERT_TRUE(ReadU32 = Mgr.readU32());
+  EXPECT_EQ(UINT32_MAX, ReadU32.value());
+  ASSERT_TRUE(ReadS32 = Mgr.readS32());
+  EXPECT_EQ(-123456, ReadS32.value());
+  ASSERT_TRUE(ReadS64 = Mgr.readS64());
+  EXPECT_EQ(INT64_C(1) << 56, ReadS64.value());
+  EXPECT_EQ(17U, Mgr.getOffset());
+
+  Code = {0x12, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0xC3,
+          0xA9, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70, 0x0B, 0x61, 0x62,
+          0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0xFF};
+  ASSERT_TRUE(Mgr.setCode(Code));
+  ASSERT_TRUE(ReadStr = Mgr.readName());
+  EXPECT_EQ("abcdefghi\xC3\xA9jklmnop", ReadStr.value());
+  ASSERT_FALSE(ReadStr = Mgr.readName());
+  EXPECT_EQ(WasmEdge::ErrCode::Value::MalformedUTF8, ReadStr.error());
+}
+
 TEST(FileManagerTest, Vector__PeekByte) {
   // 18. Test unsigned char peeking.
   WasmEdge::Expect<uint8_t> PeekByte;
@@ -927,6 +997,93 @@ TEST(FileManagerTest, Vector__PeekByte) {
   EXPECT_EQ(10U, Mgr.getOffset());
 }
 
+TEST(FileManagerTest, Stream__ReadBytes) {
+  // 19. Test reading the bytes arriving in a stream.
+  const std::vector<uint8_t> Bytes = {0x00, 0xFF, 0x1F, 0x2E, 0x3D,
+                                      0x4C, 0x5B, 0x6A, 0x79, 0x88};
+  auto Stream = std::make_shared<WasmEdge::CodeStream>(Bytes.size());
+  ASSERT_TRUE(Mgr.setCode(Stream));
+  EXPECT_TRUE(Mgr.isStreaming());
+  std::thread Producer([&]() {
+    for (size_t I = 0; I < Bytes.size(); I += 3) {
+      const size_t N = std::min<size_t>(3, Bytes.size() - I);
+      EXPECT_TRUE(Stream->append(WasmEdge::Span<const uint8_t>(&Bytes[I], N)));
+    }
+  });
+  WasmEdge::Expect<std::vector<uint8_t>> ReadBytes;
+  ASSERT_TRUE(ReadBytes = Mgr.readBytes(4));
+  EXPECT_EQ(ReadBytes.value(), std::vector<uint8_t>(Bytes.begin(),
+                                                    Bytes.begin() + 4));
+  ASSERT_TRUE(ReadBytes = Mgr.readBytes(6));
+  EXPECT_EQ(ReadBytes.value(), std::vector<uint8_t>(Bytes.begin() + 4,
+                                                    Bytes.end()));
+  Producer.join();
+  EXPECT_FALSE(Stream->append(WasmEdge::Span<const uint8_t>(Bytes.data(), 1)));
+
+  // 20. Test the stream closed before all bytes arrived.
+  Stream = std::make_shared<WasmEdge::CodeStream>(Bytes.size());
+  ASSERT_TRUE(Mgr.setCode(Stream));
+  ASSERT_TRUE(Stream->append(WasmEdge::Span<const uint8_t>(Bytes.data(), 4)));
+  Stream->close();
+  ASSERT_TRUE(ReadBytes = Mgr.readBytes(2));
+  ASSERT_FALSE(ReadBytes = Mgr.readBytes(4));
+  EXPECT_EQ(ReadBytes.error(), WasmEdge::ErrCode::Value::UnexpectedEnd);
+  EXPECT_EQ(4U, Mgr.getOffset());
+  Mgr.reset();
+}
+
+#ifdef WASMEDGE_USE_ZSTD
+TEST(FileManagerTest, Compressed__ReadBytes) {
+  // 21. Test reading the zstd-compressed data.
+  std::vector<uint8_t> Bytes(1 << 20);
+  for (size_t I = 0; I < Bytes.size(); ++I) {
+    Bytes[I] = static_cast<uint8_t>(I * 7 / 3);
+  }
+  std::vector<uint8_t> Compressed(ZSTD_compressBound(Bytes.size()));
+  Compressed.resize(ZSTD_compress(Compressed.data(), Compressed.size(),
+                                  Bytes.data(), Bytes.size(), 3));
+  ASSERT_LT(Compressed.size(), Bytes.size());
+  WasmEdge::Expect<std::vector<uint8_t>> ReadBytes;
+  ASSERT_TRUE(Mgr.setCode(Compressed));
+  EXPECT_TRUE(Mgr.isCompressed());
+  EXPECT_EQ(Bytes.size(), Mgr.getRemainSize());
+  ASSERT_TRUE(ReadBytes = Mgr.readBytes(Bytes.size()));
+  EXPECT_EQ(ReadBytes.value(), Bytes);
+  EXPECT_FALSE(Mgr.readByte());
+
+  // 22. Test reading the zstd-compressed data arriving in a stream.
+  auto Stream = std::make_shared<WasmEdge::CodeStream>(Compressed.size());
+  ASSERT_TRUE(Mgr.setCode(Stream));
+  std::thread Producer([&]() {
+    for (size_t I = 0; I < Compressed.size(); I += 1000) {
+      const size_t N = std::min<size_t>(1000, Compressed.size() - I);
+      EXPECT_TRUE(
+          Stream->append(WasmEdge::Span<const uint8_t>(&Compressed[I], N)));
+    }
+  });
+  EXPECT_EQ(WasmEdge::FileMgr::FileHeader::Unknown, Mgr.getHeaderType());
+  EXPECT_TRUE(Mgr.isCompressed());
+  ASSERT_TRUE(ReadBytes = Mgr.readBytes(Bytes.size()));
+  EXPECT_EQ(ReadBytes.value(), Bytes);
+  Producer.join();
+
+  // 23. Test the decompression cancelled while waiting for the stream.
+  Stream = std::make_shared<WasmEdge::CodeStream>(Compressed.size() + 1);
+  ASSERT_TRUE(Stream->append(Compressed));
+  ASSERT_TRUE(Mgr.setCode(Stream));
+  EXPECT_EQ(WasmEdge::FileMgr::FileHeader::Unknown, Mgr.getHeaderType());
+  Mgr.reset();
+  EXPECT_FALSE(Stream->append(Compressed));
+
+  // 24. Test the truncated data.
+  Compressed.resize(Compressed.size() / 2);
+  ASSERT_TRUE(Mgr.setCode(Compressed));
+  ASSERT_FALSE(ReadBytes = Mgr.readBytes(Bytes.size()));
+  EXPECT_EQ(ReadBytes.error(), WasmEdge::ErrCode::Value::UnexpectedEnd);
+  Mgr.reset();
+}
+#endif
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -16,7 +16,9 @@
 #include "loader/loader.h"
 
 #include <cstdint>
+#include <filesystem>
 #include <gtest/gtest.h>
+#include <system_error>
 #include <vector>
 
 namespace {
@@ -219,6 +221,120 @@ TEST(ModuleTest, LoadDupSecModule) {
   EXPECT_FALSE(Ldr.parseModule(Vec));
 }
 
+TEST(ModuleTest, LoadCodeCache) {
+  const auto Path = std::filesystem::temp_directory_path() /
+                    "wasmedgeLoaderCodeCacheTest";
+  std::error_code Error;
+  std::filesystem::remove(Path, Error);
+  auto Key = [&Path](WasmEdge::Span<const uint8_t>,
+                     const std::filesystem::path &)
+      -> WasmEdge::Expect<std::filesystem::path> { return Path; };
+  WasmEdge::Configure CacheConf;
+  CacheConf.getRuntimeConfigure().setEnableCodeCache(true);
+  WasmEdge::Loader::Loader CacheLdr(CacheConf);
+  CacheLdr.setCodeCacheKey(Key);
+
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x01U, 0x06U, 0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, // Type section
+      0x7FU,                                           //
+      0x03U, 0x02U, 0x01U, 0x00U,                      // Function section
+      0x0AU, 0x0FU, 0x01U, 0x0DU, 0x00U,               // Code section
+      0x02U, 0x40U,                                    //   block
+      0x20U, 0x00U,                                    //   local.get 0
+      0x0EU, 0x01U, 0x00U, 0x00U,                      //   br_table 0 0
+      0x0BU,                                           //   end
+      0x41U, 0x2AU,                                    //   i32.const 42
+      0x0BU                                            //   end
+  };
+
+  // 1. Test load module missing the cache, and save the bodies.
+  auto Mod = CacheLdr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  EXPECT_EQ((*Mod)->getCodeCachePath(), Path);
+  EXPECT_FALSE((*Mod)->getCodeSection().getContent()[0].isValidated());
+  ASSERT_TRUE(CacheLdr.saveCodeCache(**Mod));
+
+  // 2. Test load module restoring the bodies from the cache.
+  auto Cached = CacheLdr.parseModule(Vec);
+  ASSERT_TRUE(Cached);
+  EXPECT_TRUE((*Cached)->getCodeCachePath().empty());
+  const auto &CodeSeg = (*Cached)->getCodeSection().getContent()[0];
+  EXPECT_TRUE(CodeSeg.isValidated());
+  const auto &Origin =
+      (*Mod)->getCodeSection().getContent()[0].getExpr().getInstrs();
+  const auto &Instrs = CodeSeg.getExpr().getInstrs();
+  ASSERT_EQ(Instrs.size(), Origin.size());
+  for (size_t I = 0; I < Instrs.size(); ++I) {
+    EXPECT_EQ(Instrs[I].getOpCode(), Origin[I].getOpCode());
+    EXPECT_EQ(Instrs[I].getOffset(), Origin[I].getOffset());
+  }
+  EXPECT_EQ(Instrs[2].getLabelList().size(), 2U);
+  EXPECT_EQ(Instrs[4].getNum().get<uint32_t>(), 42U);
+
+  // 3. Test load module with the cache saved by another configuration.
+  WasmEdge::Configure OtherConf(CacheConf);
+  OtherConf.getRuntimeConfigure().setEnableSuperInstructions(
+      !CacheConf.getRuntimeConfigure().isEnableSuperInstructions());
+  WasmEdge::Loader::Loader OtherLdr(OtherConf);
+  OtherLdr.setCodeCacheKey(Key);
+  auto Stale = OtherLdr.parseModule(Vec);
+  ASSERT_TRUE(Stale);
+  EXPECT_FALSE((*Stale)->getCodeSection().getContent()[0].isValidated());
+  EXPECT_EQ((*Stale)->getCodeCachePath(), Path);
+
+  std::filesystem::remove(Path, Error);
+}
+
+TEST(ModuleTest, LoadParallelBodies) {
+  WasmEdge::Configure ParallelConf;
+  ParallelConf.getRuntimeConfigure().setLoadingThreadCount(4);
+  WasmEdge::Loader::Loader ParallelLdr(ParallelConf);
+
+  std::vector<uint8_t> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                      // Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                      // Version
+      0x01U, 0x05U, 0x01U, 0x60U, 0x00U, 0x01U, 0x7FU, // Type section
+      0x03U, 0x06U, 0x05U, 0x00U, 0x00U, 0x00U, 0x00U, // Function section
+      0x00U,                                           //
+      0x0AU, 0x1AU, 0x05U,                             // Code section
+      0x04U, 0x00U, 0x41U, 0x00U, 0x0BU,               //   i32.const 0
+      0x04U, 0x00U, 0x41U, 0x01U, 0x0BU,               //   i32.const 1
+      0x04U, 0x00U, 0x41U, 0x02U, 0x0BU,               //   i32.const 2
+      0x04U, 0x00U, 0x41U, 0x03U, 0x0BU,               //   i32.const 3
+      0x04U, 0x00U, 0x41U, 0x04U, 0x0BU                //   i32.const 4
+  };
+
+  // 1. Test load module decoding the bodies in parallel.
+  auto Mod = ParallelLdr.parseModule(Vec);
+  ASSERT_TRUE(Mod);
+  auto Origin = Ldr.parseModule(Vec);
+  ASSERT_TRUE(Origin);
+  const auto &Codes = (*Mod)->getCodeSection().getContent();
+  const auto &OriginCodes = (*Origin)->getCodeSection().getContent();
+  ASSERT_EQ(Codes.size(), 5U);
+  for (uint32_t I = 0; I < Codes.size(); ++I) {
+    const auto &Instrs = Codes[I].getExpr().getInstrs();
+    const auto &OriginInstrs = OriginCodes[I].getExpr().getInstrs();
+    ASSERT_EQ(Instrs.size(), OriginInstrs.size());
+    for (size_t J = 0; J < Instrs.size(); ++J) {
+      EXPECT_EQ(Instrs[J].getOpCode(), OriginInstrs[J].getOpCode());
+      EXPECT_EQ(Instrs[J].getOffset(), OriginInstrs[J].getOffset());
+    }
+    EXPECT_EQ(Instrs[0].getNum().get<uint32_t>(), I);
+  }
+
+  // 2. Test load module failing in the bodies reports the first failure.
+  Vec[38] = 0x43U;
+  Vec[48] = 0x27U;
+  auto Failed = ParallelLdr.parseModule(Vec);
+  ASSERT_FALSE(Failed);
+  auto OriginFailed = Ldr.parseModule(Vec);
+  ASSERT_FALSE(OriginFailed);
+  EXPECT_EQ(Failed.error(), OriginFailed.error());
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -442,6 +442,75 @@ TEST(SegmentTest, LoadCodeSegment) {
   EXPECT_FALSE(LdrWASM1.parseModule(prefixedVec(Vec)));
 }
 
+TEST(SegmentTest, LoadLazyCodeSegment) {
+  std::vector<uint8_t> Vec;
+
+  WasmEdge::Configure LazyConf;
+  LazyConf.getRuntimeConfigure().setEnableLazyFunctionBody(true);
+  WasmEdge::Loader::Loader LdrLazy(LazyConf);
+
+  // 5. Test load code segment in the lazy loading mode.
+  //
+  //   1.  Load code segment with the deferred body, and decode it later.
+  //   2.  Load code segment with an illegal opcode in the deferred body.
+
+  Vec = {
+      0x03U,                             // Function section
+      0x02U,                             // Content size = 2
+      0x01U,                             // Vector length = 1
+      0x00U,                             // Function index vector
+      0x0AU,                             // Code section
+      0x15U,                             // Content size = 21
+      0x01U,                             // Vector length = 1
+      0x13U,                             // Code segment size = 19
+      0x04U,                             // Vector length = 4
+      0x01U, 0x7CU,                      // vec[0]
+      0x03U, 0x7DU,                      // vec[1]
+      0xFFU, 0xFFU, 0xFFU, 0x0FU, 0x7EU, // vec[2]
+      0xF3U, 0xFFU, 0xFFU, 0x0FU, 0x7FU, // vec[3]
+      0x45U, 0x46U, 0x47U, 0x0BU         // Expression
+  };
+  auto Mod = LdrLazy.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Mod);
+  const auto &Seg = (*Mod)->getCodeSection().getContent()[0];
+  ASSERT_TRUE(Seg.getLazyBody());
+  EXPECT_EQ(Seg.getLocals().size(), 4U);
+  EXPECT_EQ(Seg.getExpr().getInstrs().size(), 0U);
+  EXPECT_EQ(Seg.getLazyBody()->getCode().size(), 4U);
+  EXPECT_FALSE(Seg.getLazyBody()->isMaterialized());
+  auto Instrs = Seg.getBodyInstrs();
+  ASSERT_TRUE(Instrs);
+  ASSERT_EQ(Instrs->size(), 4U);
+  EXPECT_EQ((*Instrs)[0].getOpCode(), WasmEdge::OpCode::I32__eqz);
+  // The offsets are in the whole input.
+  EXPECT_EQ((*Instrs)[0].getOffset(), 31U);
+  EXPECT_TRUE(Seg.getLazyBody()->isMaterialized());
+
+  Vec = {
+      0x03U,                             // Function section
+      0x02U,                             // Content size = 2
+      0x01U,                             // Vector length = 1
+      0x00U,                             // Function index vector
+      0x0AU,                             // Code section
+      0x15U,                             // Content size = 21
+      0x01U,                             // Vector length = 1
+      0x13U,                             // Code segment size = 19
+      0x04U,                             // Vector length = 4
+      0x01U, 0x7CU,                      // vec[0]
+      0x03U, 0x7DU,                      // vec[1]
+      0xFFU, 0xFFU, 0xFFU, 0x0FU, 0x7EU, // vec[2]
+      0xF3U, 0xFFU, 0xFFU, 0x0FU, 0x7FU, // vec[3]
+      0x45U, 0x27U, 0x47U, 0x0BU         // Expression, illegal opcode 0x27
+  };
+  Mod = LdrLazy.parseModule(prefixedVec(Vec));
+  ASSERT_TRUE(Mod);
+  const auto &InvalidSeg = (*Mod)->getCodeSection().getContent()[0];
+  EXPECT_FALSE(InvalidSeg.getBodyInstrs());
+  // The failure is kept.
+  EXPECT_FALSE(InvalidSeg.getBodyInstrs());
+  EXPECT_TRUE(InvalidSeg.getLazyBody()->isMaterialized());
+}
+
 TEST(SegmentTest, LoadDataSegment) {
   std::vector<uint8_t> Vec;
 
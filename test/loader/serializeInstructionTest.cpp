@@ -17,7 +17,7 @@ createCodeSec(std::vector<WasmEdge::AST::Instruction> Instructions) {
   WasmEdge::AST::CodeSection CodeSec;
   WasmEdge::AST::CodeSegment CodeSeg;
   WasmEdge::AST::Expression Expr;
-  Expr.getInstrs() = Instructions;
+  Expr.getInstrs().assign(Instructions.begin(), Instructions.end());
   CodeSeg.getExpr() = Expr;
   CodeSec.getContent().push_back(CodeSeg);
   return CodeSec;
@@ -1154,7 +1154,7 @@ TEST(SerializeInstructionTest, SerializeMemoryInstruction) {
   EXPECT_EQ(Output, Expected);
 
   I32Load.getMemoryAlign() = 0xFFFFFFFFU;
-  I32Load.getMemoryOffset() = 0xFFFFFFFEU;
+  I32Load.setMemoryOffset(0xFFFFFFFEU);
   Instructions = {I32Load, End};
   Output = {};
   EXPECT_TRUE(Ser.serializeSection(createCodeSec(Instructions), Output));
@@ -1172,7 +1172,7 @@ TEST(SerializeInstructionTest, SerializeMemoryInstruction) {
   EXPECT_EQ(Output, Expected);
 
   I32Load.getMemoryAlign() = 0xFFFFFFFFU;
-  I32Load.getMemoryOffset() = 0xFFFFFFFEU;
+  I32Load.setMemoryOffset(0xFFFFFFFEU);
   Instructions = {I32Load, End};
   Output = {};
   EXPECT_TRUE(Ser.serializeSection(createCodeSec(Instructions), Output));
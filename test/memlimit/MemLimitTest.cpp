@@ -3,9 +3,13 @@
 
 #include "common/configure.h"
 #include "runtime/instance/memory.h"
+#include "system/fault.h"
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstring>
+
 namespace {
 
 TEST(MemLimitTest, Limit__Pages) {
@@ -42,6 +46,154 @@ TEST(MemLimitTest, Limit__Pages) {
   ASSERT_FALSE(Inst6.growPage(0xFFFFFFFF));
 }
 
+TEST(MemLimitTest, Pool__Reuse) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  constexpr uint32_t Last = 3 * MemInst::kPageSize + 5;
+  WasmEdge::Allocator::setPoolCapacity(1);
+
+  uint8_t *Released = nullptr;
+  {
+    MemInst Inst(WasmEdge::AST::MemoryType(1));
+    ASSERT_FALSE(Inst.getDataPtr() == nullptr);
+    ASSERT_TRUE(Inst.growPage(3));
+    Inst.getDataPtr()[0] = 1;
+    Inst.getDataPtr()[Last] = 2;
+    Released = Inst.getDataPtr();
+  }
+  {
+    // The reused reservation is zeroed.
+    MemInst Inst(WasmEdge::AST::MemoryType(4));
+    ASSERT_FALSE(Inst.getDataPtr() == nullptr);
+    if (WasmEdge::Allocator::getPoolCapacity() > 0) {
+      EXPECT_EQ(Inst.getDataPtr(), Released);
+    }
+    EXPECT_EQ(Inst.getDataPtr()[0], 0U);
+    EXPECT_EQ(Inst.getDataPtr()[Last], 0U);
+  }
+
+  WasmEdge::Allocator::setPoolCapacity(0);
+}
+
+TEST(MemLimitTest, HugePages__Grow) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  constexpr uint32_t Last = 80 * MemInst::kPageSize - 1;
+  WasmEdge::Allocator::setHugePages(true);
+
+  {
+    MemInst Inst(WasmEdge::AST::MemoryType(16));
+    ASSERT_FALSE(Inst.getDataPtr() == nullptr);
+    if (WasmEdge::Allocator::isHugePages()) {
+      // The memory starts at a huge page boundary.
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(Inst.getDataPtr()) % 0x200000U,
+                0U);
+    }
+    ASSERT_TRUE(Inst.growPage(64));
+    EXPECT_EQ(Inst.getDataPtr()[0], 0U);
+    EXPECT_EQ(Inst.getDataPtr()[Last], 0U);
+    Inst.getDataPtr()[0] = 1;
+    Inst.getDataPtr()[Last] = 2;
+    EXPECT_EQ(Inst.getDataPtr()[0], 1U);
+    EXPECT_EQ(Inst.getDataPtr()[Last], 2U);
+  }
+
+  WasmEdge::Allocator::setHugePages(false);
+  EXPECT_FALSE(WasmEdge::Allocator::isHugePages());
+}
+
+TEST(MemLimitTest, BulkMemory__Tiers) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  MemInst Inst(WasmEdge::AST::MemoryType(64));
+  ASSERT_FALSE(Inst.getDataPtr() == nullptr);
+  const uint32_t Size = 64 * MemInst::kPageSize;
+  uint8_t *Data = Inst.getDataPtr();
+
+  // The large zero fill discards the whole pages and keeps the others.
+  ASSERT_TRUE(Inst.fillBytes(0xA5, 0, Size));
+  ASSERT_TRUE(Inst.fillBytes(0, 100, 40 * MemInst::kPageSize));
+  EXPECT_EQ(Data[99], 0xA5);
+  EXPECT_EQ(Data[100], 0U);
+  EXPECT_EQ(Data[MemInst::kPageSize], 0U);
+  EXPECT_EQ(Data[40 * MemInst::kPageSize + 99], 0U);
+  EXPECT_EQ(Data[40 * MemInst::kPageSize + 100], 0xA5);
+  for (uint32_t I = 100; I < 40 * MemInst::kPageSize + 100; I += 4093) {
+    ASSERT_EQ(Data[I], 0U);
+  }
+
+  // The small copies between the overlapped ranges.
+  for (uint32_t Len = 0; Len <= 20; ++Len) {
+    for (uint32_t Dst : {0U, 3U, 8U}) {
+      std::array<uint8_t, 32> Expected;
+      for (uint32_t I = 0; I < 32; ++I) {
+        Data[I] = static_cast<uint8_t>(I + 1);
+      }
+      std::memmove(Expected.data(), Data, 32);
+      std::memmove(Expected.data() + Dst, Expected.data() + 4, Len);
+      auto Src = Inst.getBytes(4, Len);
+      ASSERT_TRUE(Src);
+      ASSERT_TRUE(Inst.setBytes(*Src, Dst, 0, Len));
+      EXPECT_EQ(std::memcmp(Data, Expected.data(), 32), 0);
+    }
+  }
+}
+
+TEST(MemLimitTest, Striped__Isolation) {
+  using MemInst = WasmEdge::Runtime::Instance::MemoryInstance;
+  constexpr uint32_t Last = 16 * MemInst::kPageSize - 1;
+  // Enabled at last, as it is kept for the later memories in the process.
+  if (!WasmEdge::Allocator::enableStriping(256)) {
+    GTEST_SKIP() << "Memory protection keys are not supported";
+  }
+  // The slots are enlarged until the keys cover the 8G reach.
+  const uint32_t SlotPages = WasmEdge::Allocator::getStripedSlotPages();
+  EXPECT_GE(SlotPages, 256U);
+  EXPECT_LE(SlotPages, 65536U);
+
+  {
+    MemInst Inst1(WasmEdge::AST::MemoryType(1, 16));
+    MemInst Inst2(WasmEdge::AST::MemoryType(1, 16));
+    MemInst Unbounded(WasmEdge::AST::MemoryType(1));
+    ASSERT_TRUE(Inst1.isStriped());
+    ASSERT_TRUE(Inst2.isStriped());
+    EXPECT_FALSE(Unbounded.isStriped());
+    EXPECT_EQ(Inst1.getGuardedAddressLimit(), 0U);
+    EXPECT_EQ(Inst2.getDataPtr() - Inst1.getDataPtr(),
+              static_cast<ptrdiff_t>(SlotPages * MemInst::kPageSize));
+    ASSERT_TRUE(Inst1.growPage(15));
+    ASSERT_FALSE(Inst1.growPage(1));
+    Inst1.getDataPtr()[Last] = 1;
+    Inst2.getDataPtr()[0] = 2;
+
+    // The other striped memories are inaccessible with the restricted rights,
+    // and the others are not affected.
+    const std::array<uint8_t *, 1> Memories = {Inst1.getDataPtr()};
+    const uint32_t Rights = WasmEdge::Allocator::restrictProtectionKeys(
+        WasmEdge::Span<uint8_t *const>(Memories));
+    volatile bool Faulted = false;
+    {
+      WasmEdge::Fault FaultHandler;
+      if (PREPARE_FAULT(FaultHandler) != 0) {
+        Faulted = true;
+      } else {
+        Inst1.getDataPtr()[0] = 3;
+        Unbounded.getDataPtr()[0] = 4;
+        *static_cast<volatile uint8_t *>(Inst2.getDataPtr()) = 5;
+      }
+    }
+    WasmEdge::Allocator::restoreProtectionKeys(Rights);
+    EXPECT_TRUE(Faulted);
+    EXPECT_EQ(Inst1.getDataPtr()[0], 3U);
+    EXPECT_EQ(Unbounded.getDataPtr()[0], 4U);
+    EXPECT_EQ(Inst2.getDataPtr()[0], 2U);
+  }
+  {
+    // The reused slot is zeroed.
+    MemInst Inst(WasmEdge::AST::MemoryType(16, 16));
+    ASSERT_TRUE(Inst.isStriped());
+    EXPECT_EQ(Inst.getDataPtr()[0], 0U);
+    EXPECT_EQ(Inst.getDataPtr()[Last], 0U);
+  }
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -72,6 +72,53 @@ TEST_F(WasiCryptoTest, Aeads) {
     std::vector<uint8_t> Msg3(Msg.size());
     symmetricStateDecryptDetached(State4Handle, Msg3, Ciphertext, Tag);
     EXPECT_EQ("test"_u8, Msg3);
+
+    {
+      // Clone checking. The clone keeps the absorbed additional data.
+      WASI_CRYPTO_EXPECT_SUCCESS(
+          State5Handle, symmetricStateOpen(Name, KeyHandle, OptionsHandle));
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(State5Handle, "aad"_u8));
+      WASI_CRYPTO_EXPECT_SUCCESS(NewStateHandle,
+                                 symmetricStateClone(State5Handle));
+      EXPECT_NE(State5Handle, NewStateHandle);
+      std::vector<uint8_t> Ciphertext1(Msg.size() + MaxTagSize);
+      std::vector<uint8_t> Ciphertext2(Msg.size() + MaxTagSize);
+      WASI_CRYPTO_EXPECT_TRUE(
+          symmetricStateEncrypt(State5Handle, Ciphertext1, Msg));
+      WASI_CRYPTO_EXPECT_TRUE(
+          symmetricStateEncrypt(NewStateHandle, Ciphertext2, Msg));
+      EXPECT_EQ(Ciphertext1, Ciphertext2);
+      EXPECT_NE(Ciphertext1, CiphertextWithTag);
+      WASI_CRYPTO_EXPECT_FAILURE(symmetricStateClone(State5Handle),
+                                 __WASI_CRYPTO_ERRNO_INVALID_OPERATION);
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(NewStateHandle));
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(State5Handle));
+    }
+
+    {
+      // The clone keeps the additional data larger than the replayed bound.
+      WASI_CRYPTO_EXPECT_SUCCESS(
+          State6Handle, symmetricStateOpen(Name, KeyHandle, OptionsHandle));
+      WASI_CRYPTO_EXPECT_SUCCESS(
+          State7Handle, symmetricStateOpen(Name, KeyHandle, OptionsHandle));
+      const std::vector<uint8_t> Aad(40000, 7);
+      for (const auto Handle : {State6Handle, State7Handle}) {
+        WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(Handle, Aad));
+        WASI_CRYPTO_EXPECT_TRUE(symmetricStateAbsorb(Handle, Aad));
+      }
+      WASI_CRYPTO_EXPECT_SUCCESS(NewStateHandle,
+                                 symmetricStateClone(State6Handle));
+      std::vector<uint8_t> Ciphertext1(Msg.size() + MaxTagSize);
+      std::vector<uint8_t> Ciphertext2(Msg.size() + MaxTagSize);
+      WASI_CRYPTO_EXPECT_TRUE(
+          symmetricStateEncrypt(State7Handle, Ciphertext1, Msg));
+      WASI_CRYPTO_EXPECT_TRUE(
+          symmetricStateEncrypt(NewStateHandle, Ciphertext2, Msg));
+      EXPECT_EQ(Ciphertext1, Ciphertext2);
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(NewStateHandle));
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(State7Handle));
+      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(State6Handle));
+    }
     WASI_CRYPTO_EXPECT_TRUE(optionsClose(OptionsHandle));
 
     {
@@ -95,26 +142,6 @@ TEST_F(WasiCryptoTest, Aeads) {
                                  __WASI_CRYPTO_ERRNO_INVALID_OPERATION);
     }
 
-    bool IsSymmetricStateCloneImplemented = true;
-    // XXX: These cipher didn't implement context duplication from OpenSSL 3.0.0
-    // https://github.com/openssl/openssl/issues/20978
-    if (0x30000000 <= OPENSSL_VERSION_NUMBER &&
-        (Name == "AES-128-GCM"sv || Name == "AES-256-GCM"sv ||
-         Name == "CHACHA20-POLY1305"sv)) {
-      IsSymmetricStateCloneImplemented = false;
-    }
-
-    if (IsSymmetricStateCloneImplemented) {
-      // Clone checking.
-      WASI_CRYPTO_EXPECT_SUCCESS(NewStateHandle,
-                                 symmetricStateClone(State4Handle));
-      EXPECT_NE(State4Handle, NewStateHandle);
-      WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(NewStateHandle));
-    } else {
-      WASI_CRYPTO_EXPECT_FAILURE(symmetricStateClone(State4Handle),
-                                 __WASI_CRYPTO_ERRNO_NOT_IMPLEMENTED);
-    }
-
     WASI_CRYPTO_EXPECT_TRUE(symmetricStateClose(State4Handle));
   };
 
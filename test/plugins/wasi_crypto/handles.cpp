@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "utils/handles_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WasmEdge {
+namespace Host {
+namespace WasiCrypto {
+
+namespace {
+using Manager = RcHandlesManager<uint32_t, std::string>;
+} // namespace
+
+TEST(WasiCryptoHandles, CloseThenReuse) {
+  Manager Handles(0x01);
+  auto Handle1 = Handles.registerManager("foo");
+  ASSERT_TRUE(Handle1);
+  EXPECT_EQ(*Handle1 >> 24, 0x01U);
+  ASSERT_TRUE(Handles.get(*Handle1));
+  EXPECT_EQ(*Handles.get(*Handle1), "foo");
+  ASSERT_TRUE(Handles.close(*Handle1));
+
+  // The slot is reused with another handle, and the closed one is rejected.
+  auto Handle2 = Handles.registerManager("bar");
+  ASSERT_TRUE(Handle2);
+  EXPECT_NE(*Handle1, *Handle2);
+  EXPECT_EQ(*Handle1 & 0xFFFFU, *Handle2 & 0xFFFFU);
+  EXPECT_EQ(*Handles.get(*Handle2), "bar");
+  EXPECT_EQ(Handles.get(*Handle1).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  EXPECT_EQ(Handles.close(*Handle1).error(), __WASI_CRYPTO_ERRNO_CLOSED);
+  EXPECT_EQ(*Handles.get(*Handle2), "bar");
+
+  // The handles of the other types are rejected.
+  Manager Others(0x02);
+  EXPECT_EQ(Others.get(*Handle2).error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  EXPECT_EQ(Others.close(*Handle2).error(), __WASI_CRYPTO_ERRNO_CLOSED);
+}
+
+TEST(WasiCryptoHandles, StaleAfterReuse) {
+  Manager Handles(0x01);
+  auto Stale = Handles.registerManager("stale");
+  ASSERT_TRUE(Stale);
+  ASSERT_TRUE(Handles.close(*Stale));
+  // The stale handle is rejected until the generations wrap around.
+  for (uint32_t I = 1; I < 255; ++I) {
+    auto Handle = Handles.registerManager(std::to_string(I));
+    ASSERT_TRUE(Handle);
+    EXPECT_EQ(*Handle & 0xFFFFU, *Stale & 0xFFFFU);
+    EXPECT_FALSE(Handles.get(*Stale));
+    EXPECT_EQ(*Handles.get(*Handle), std::to_string(I));
+    ASSERT_TRUE(Handles.close(*Handle));
+  }
+}
+
+TEST(WasiCryptoHandles, Exhaustion) {
+  Manager Handles(0x01);
+  std::vector<uint32_t> Live;
+  for (uint32_t I = 0; I < Manager::MaxHandles; ++I) {
+    auto Handle = Handles.registerManager();
+    ASSERT_TRUE(Handle);
+    Live.push_back(*Handle);
+  }
+  EXPECT_EQ(Handles.registerManager().error(),
+            __WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
+
+  // A closed slot is available again.
+  ASSERT_TRUE(Handles.close(Live[100]));
+  auto Handle = Handles.registerManager("again");
+  ASSERT_TRUE(Handle);
+  EXPECT_EQ(*Handles.get(*Handle), "again");
+  EXPECT_EQ(Handles.registerManager().error(),
+            __WASI_CRYPTO_ERRNO_TOO_MANY_HANDLES);
+}
+
+TEST(WasiCryptoHandles, ConcurrentGetClose) {
+  // The readers get the contents while a writer closes and registers the
+  // handles again, and never see a destroyed or a foreign content.
+  Manager Handles(0x01);
+  constexpr uint32_t Count = 8;
+  auto Content = [](uint32_t I) { return std::string(64, char('a' + I)); };
+  std::array<std::atomic<uint32_t>, Count> Current;
+  for (uint32_t I = 0; I < Count; ++I) {
+    auto Handle = Handles.registerManager(Content(I));
+    ASSERT_TRUE(Handle);
+    Current[I].store(*Handle);
+  }
+
+  std::atomic_bool Done = false;
+  std::vector<std::thread> Readers;
+  for (uint32_t R = 0; R < 3; ++R) {
+    Readers.emplace_back([&]() {
+      while (!Done.load()) {
+        for (uint32_t I = 0; I < Count; ++I) {
+          if (auto Res = Handles.get(Current[I].load()); Res) {
+            EXPECT_EQ(*Res, Content(I));
+          } else {
+            EXPECT_EQ(Res.error(), __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+          }
+        }
+      }
+    });
+  }
+  for (uint32_t Round = 0; Round < 2000; ++Round) {
+    const uint32_t I = Round % Count;
+    ASSERT_TRUE(Handles.close(Current[I].load()));
+    auto Handle = Handles.registerManager(Content(I));
+    ASSERT_TRUE(Handle);
+    Current[I].store(*Handle);
+  }
+  Done.store(true);
+  for (auto &Reader : Readers) {
+    Reader.join();
+  }
+}
+
+} // namespace WasiCrypto
+} // namespace Host
+} // namespace WasmEdge
@@ -115,6 +115,45 @@ TEST_F(WasiCryptoTest, Hash) {
       "d1def71920a44d8b6c83b2eaa99379a16047cc82cec8d80689fbf02fbd0624"_u8v);
 }
 
+TEST_F(WasiCryptoTest, HashBatch) {
+  const std::vector<std::vector<uint8_t>> Inputs{"data"_u8,
+                                                 "datamore_data"_u8};
+  {
+    std::vector<uint8_t> Out(64);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricHashBatch("SHA-256"sv, Inputs, Out));
+    EXPECT_EQ(
+        Out,
+        "3a6eb0790f39ac87c94f3856b2dd2c5d110e6811602261a9a923d3bb23adc8b7"
+        "13c40eec22541a155e172010c7fd6ef654e4e138a0c20923f9a91062a27f57b6"_u8v);
+  }
+
+  {
+    // Truncate every digest to the slice of the output.
+    std::vector<uint8_t> Out(8);
+    WASI_CRYPTO_EXPECT_TRUE(symmetricHashBatch("SHA-512/256"sv, Inputs, Out));
+    EXPECT_EQ(Out, "99902eafd1def719"_u8v);
+  }
+
+  {
+    // No input.
+    WASI_CRYPTO_EXPECT_TRUE(symmetricHashBatch("SHA-512"sv, {}, {}));
+  }
+
+  {
+    // Some error cases checking.
+    std::vector<uint8_t> Out(65);
+    WASI_CRYPTO_EXPECT_FAILURE(symmetricHashBatch("SHA-256"sv, Inputs, Out),
+                               __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
+    Out.resize(66);
+    WASI_CRYPTO_EXPECT_FAILURE(symmetricHashBatch("SHA-256"sv, Inputs, Out),
+                               __WASI_CRYPTO_ERRNO_INVALID_LENGTH);
+    Out.resize(64);
+    WASI_CRYPTO_EXPECT_FAILURE(
+        symmetricHashBatch("HMAC/SHA-256"sv, Inputs, Out),
+        __WASI_CRYPTO_ERRNO_INVALID_OPERATION);
+  }
+}
+
 } // namespace WasiCrypto
 } // namespace Host
 } // namespace WasmEdge
@@ -67,6 +67,22 @@ void WasiCryptoTest::writeSpan(Span<const uint8_t> Content, uint32_t Ptr) {
             MemInst->getPointer<uint8_t *>(Ptr));
 }
 
+uint32_t WasiCryptoTest::writeBufferList(
+    const std::vector<std::vector<uint8_t>> &Buffers, uint32_t Ptr) {
+  auto Align = [](uint32_t P) { return (P + 3) & ~UINT32_C(3); };
+  Ptr = Align(Ptr);
+  uint32_t DataPtr = Ptr + static_cast<uint32_t>(Buffers.size()) * 8;
+  for (const auto &Buffer : Buffers) {
+    const uint32_t Size = static_cast<uint32_t>(Buffer.size());
+    *MemInst->getPointer<uint32_t *>(Ptr) = DataPtr;
+    *MemInst->getPointer<uint32_t *>(Ptr + 4) = Size;
+    writeSpan(Buffer, DataPtr);
+    Ptr += 8;
+    DataPtr += Size;
+  }
+  return Align(DataPtr);
+}
+
 void WasiCryptoTest::writeOptKey(std::optional<int32_t> OptKey, uint32_t Ptr) {
   __wasi_opt_symmetric_key_t Key;
   if (OptKey) {
@@ -564,6 +580,33 @@ WasiCryptoTest::symmetricStateSqueeze(__wasi_symmetric_state_t StateHandle,
   return {};
 }
 
+WasiCryptoExpect<void> WasiCryptoTest::symmetricHashBatch(
+    std::string_view Alg, const std::vector<std::vector<uint8_t>> &Inputs,
+    Span<uint8_t> Out) {
+  writeDummyMemoryContent();
+  writeString(Alg, 0);
+  uint32_t AlgSize = static_cast<uint32_t>(Alg.size());
+  uint32_t InputsPtr = (AlgSize + 3) & ~UINT32_C(3);
+  uint32_t OutPtr = writeBufferList(Inputs, InputsPtr);
+  uint32_t InputsCount = static_cast<uint32_t>(Inputs.size());
+  uint32_t OutSize = static_cast<uint32_t>(Out.size());
+
+  auto *Func = getHostFunc<Symmetric::HashBatch>(WasiCryptoSymmMod,
+                                                 "symmetric_hash_batch");
+  EXPECT_NE(Func, nullptr);
+  EXPECT_TRUE(Func->run(CallFrame,
+                        std::initializer_list<WasmEdge::ValVariant>{
+                            0, AlgSize, InputsPtr, InputsCount, OutPtr,
+                            OutSize},
+                        Errno));
+  ensureOrReturnOnTest(Errno[0].get<int32_t>());
+
+  std::copy(MemInst->getPointer<uint8_t *>(OutPtr),
+            MemInst->getPointer<uint8_t *>(OutPtr + OutSize), Out.begin());
+
+  return {};
+}
+
 WasiCryptoExpect<__wasi_symmetric_tag_t>
 WasiCryptoTest::symmetricStateSqueezeTag(__wasi_symmetric_state_t StateHandle) {
   writeDummyMemoryContent();
@@ -1411,6 +1454,36 @@ WasiCryptoExpect<void> WasiCryptoTest::signatureVerificationStateClose(
   return {};
 }
 
+WasiCryptoExpect<void> WasiCryptoTest::signatureBatchVerify(
+    Span<const __wasi_signature_publickey_t> PkHandles,
+    const std::vector<std::vector<uint8_t>> &Msgs,
+    Span<const __wasi_signature_t> SigHandles,
+    Span<__wasi_crypto_errno_e_t> Results) {
+  writeDummyMemoryContent();
+  uint32_t Count = static_cast<uint32_t>(PkHandles.size());
+  std::copy(PkHandles.begin(), PkHandles.end(),
+            MemInst->getPointer<__wasi_signature_publickey_t *>(0));
+  uint32_t MsgsPtr = Count * 4;
+  uint32_t SigHandlesPtr = writeBufferList(Msgs, MsgsPtr);
+  std::copy(SigHandles.begin(), SigHandles.end(),
+            MemInst->getPointer<__wasi_signature_t *>(SigHandlesPtr));
+  uint32_t ResultsPtr = SigHandlesPtr + Count * 4;
+
+  auto *Func = getHostFunc<Signatures::BatchVerify>(WasiCryptoSignMod,
+                                                    "signature_batch_verify");
+  EXPECT_NE(Func, nullptr);
+  EXPECT_TRUE(Func->run(CallFrame,
+                        std::initializer_list<WasmEdge::ValVariant>{
+                            0, MsgsPtr, SigHandlesPtr, Count, ResultsPtr},
+                        Errno));
+  auto *ResultsBegin =
+      MemInst->getPointer<__wasi_crypto_errno_e_t *>(ResultsPtr);
+  std::copy(ResultsBegin, ResultsBegin + Results.size(), Results.begin());
+  ensureOrReturnOnTest(Errno[0].get<int32_t>());
+
+  return {};
+}
+
 // WasiCryptoExpect<__wasi_secretkey_t> WasiCryptoTest::secretkeyImport(
 //     __wasi_algorithm_type_e_t AlgType, std::string_view AlgStr,
 //     Span<const uint8_t> Encoded, __wasi_secretkey_encoding_e_t Encoding) {
@@ -112,6 +112,11 @@ protected:
 
   void writeSpan(Span<const uint8_t> Content, uint32_t Ptr);
 
+  /// Write the (pointer, length) pairs of the buffers at the aligned pointer,
+  /// followed by the contents. Returns the aligned end of the contents.
+  uint32_t writeBufferList(const std::vector<std::vector<uint8_t>> &Buffers,
+                           uint32_t Ptr);
+
   void writeOptKey(std::optional<int32_t> OptKey, uint32_t Ptr);
 
   void writeOptOptions(std::optional<__wasi_options_t> OptOptions,
@@ -218,6 +223,11 @@ protected:
   WasiCryptoExpect<__wasi_symmetric_tag_t>
   symmetricStateSqueezeTag(__wasi_symmetric_state_t StateHandle);
 
+  WasiCryptoExpect<void>
+  symmetricHashBatch(std::string_view Alg,
+                     const std::vector<std::vector<uint8_t>> &Inputs,
+                     Span<uint8_t> Out);
+
   WasiCryptoExpect<__wasi_symmetric_key_t>
   symmetricStateSqueezeKey(__wasi_symmetric_state_t StateHandle,
                            std::string_view Alg);
@@ -382,6 +392,12 @@ protected:
   WasiCryptoExpect<void> signatureVerificationStateClose(
       __wasi_signature_verification_state_t StateHandle);
 
+  WasiCryptoExpect<void>
+  signatureBatchVerify(Span<const __wasi_signature_publickey_t> PkHandles,
+                       const std::vector<std::vector<uint8_t>> &Msgs,
+                       Span<const __wasi_signature_t> SigHandles,
+                       Span<__wasi_crypto_errno_e_t> Results);
+
   int32_t InvaildHandle = 9999;
 
   // Create the calling frame with memory instance.
@@ -52,6 +52,51 @@ TEST_F(WasiCryptoTest, Signatures) {
   SigTest(__WASI_ALGORITHM_TYPE_SIGNATURES, "RSA_PSS_3072_SHA512"sv);
   SigTest(__WASI_ALGORITHM_TYPE_SIGNATURES, "RSA_PSS_4096_SHA512"sv);
 
+  auto BatchVerifyTest = [this](std::string_view Alg) {
+    SCOPED_TRACE(Alg);
+    const std::vector<std::vector<uint8_t>> Msgs{"test"_u8, "more_test"_u8,
+                                                 "test"_u8};
+    std::vector<__wasi_signature_publickey_t> PkHandles;
+    std::vector<__wasi_signature_t> SigHandles;
+    for (const auto &Msg : Msgs) {
+      WASI_CRYPTO_EXPECT_SUCCESS(
+          KpHandle,
+          keypairGenerate(__WASI_ALGORITHM_TYPE_SIGNATURES, Alg, std::nullopt));
+      WASI_CRYPTO_EXPECT_SUCCESS(StateHandle, signatureStateOpen(KpHandle));
+      WASI_CRYPTO_EXPECT_TRUE(signatureStateUpdate(StateHandle, Msg));
+      WASI_CRYPTO_EXPECT_SUCCESS(SigHandle, signatureStateSign(StateHandle));
+      WASI_CRYPTO_EXPECT_TRUE(signatureStateClose(StateHandle));
+      WASI_CRYPTO_EXPECT_SUCCESS(PkHandle, keypairPublickey(KpHandle));
+      PkHandles.push_back(PkHandle);
+      SigHandles.push_back(SigHandle);
+    }
+
+    std::vector<__wasi_crypto_errno_e_t> Results(Msgs.size());
+    WASI_CRYPTO_EXPECT_TRUE(
+        signatureBatchVerify(PkHandles, Msgs, SigHandles, Results));
+    for (auto Result : Results) {
+      EXPECT_EQ(Result, __WASI_CRYPTO_ERRNO_SUCCESS);
+    }
+
+    // Swap the signatures of the last two items.
+    std::swap(SigHandles[1], SigHandles[2]);
+    WASI_CRYPTO_EXPECT_FAILURE(
+        signatureBatchVerify(PkHandles, Msgs, SigHandles, Results),
+        __WASI_CRYPTO_ERRNO_VERIFICATION_FAILED);
+    EXPECT_EQ(Results[0], __WASI_CRYPTO_ERRNO_SUCCESS);
+    EXPECT_EQ(Results[1], __WASI_CRYPTO_ERRNO_VERIFICATION_FAILED);
+    EXPECT_EQ(Results[2], __WASI_CRYPTO_ERRNO_VERIFICATION_FAILED);
+
+    // Invalid public key handle.
+    PkHandles[0] = InvaildHandle;
+    WASI_CRYPTO_EXPECT_FAILURE(
+        signatureBatchVerify(PkHandles, Msgs, SigHandles, Results),
+        __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+    EXPECT_EQ(Results[0], __WASI_CRYPTO_ERRNO_INVALID_HANDLE);
+  };
+  BatchVerifyTest("ECDSA_P256_SHA256"sv);
+  BatchVerifyTest("Ed25519"sv);
+
   auto SigEncodingTest =
       [this](
           std::string_view Alg,
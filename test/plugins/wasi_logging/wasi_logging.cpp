@@ -3,10 +3,12 @@
 
 #include "plugin/wasi_logging/func.h"
 #include "plugin/wasi_logging/module.h"
+#include "plugin/wasi_logging/queue.h"
 
 #include "common/defines.h"
 #include "runtime/instance/module.h"
 
+#include <fstream>
 #include <gtest/gtest.h>
 #include <memory>
 #include <sstream>
@@ -183,6 +185,48 @@ TEST(WasiLoggingTests, func_log) {
       {}));
 }
 
+TEST(WasiLoggingTests, func_log_async) {
+  using namespace std::literals::string_view_literals;
+  auto WasiLoggingMod = createModule();
+  ASSERT_TRUE(WasiLoggingMod);
+  WasiLoggingMod->getEnv().setAsync(true);
+
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_NE(MemInstPtr, nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+  fillMemContent(MemInst, 0, 256);
+  fillMemContent(MemInst, 0, "async.log"sv);
+  fillMemContent(MemInst, 128, "Queued message"sv);
+  std::remove("async.log");
+
+  auto *FuncInst = WasiLoggingMod->findFuncExports("log");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncInst =
+      dynamic_cast<WasmEdge::Host::WASILogging::Log &>(FuncInst->getHostFunc());
+  for (uint32_t I = 0; I < 100; ++I) {
+    EXPECT_TRUE(HostFuncInst.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(2), UINT32_C(0), UINT32_C(9), UINT32_C(128), UINT32_C(14)},
+        {}));
+  }
+  // The messages are written by the background thread.
+  WasmEdge::Host::WASILogging::LogQueue::getDefault().flush();
+  std::ifstream File("async.log");
+  std::string Line;
+  uint32_t Lines = 0;
+  while (std::getline(File, Line)) {
+    EXPECT_NE(Line.find("Queued message"), std::string::npos);
+    ++Lines;
+  }
+  EXPECT_EQ(Lines, 100U);
+}
+
 GTEST_API_ int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
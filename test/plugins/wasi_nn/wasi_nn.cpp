@@ -1566,6 +1566,127 @@ TEST(WasiNNTest, GGMLBackend) {
     auto BytesWritten = *MemInst.getPointer<uint32_t *>(BuilderPtr);
     EXPECT_GE(BytesWritten, 50);
   }
+
+  // GGML WASI-NN compute_stream tests.
+  FuncInst = NNMod->findFuncExports("compute_stream");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncComputeStream =
+      dynamic_cast<WasmEdge::Host::WasiNNComputeStream &>(
+          FuncInst->getHostFunc());
+  const uint32_t HeaderPtr = (StorePtr + 3) & ~UINT32_C(3);
+  const uint32_t RingPtr = HeaderPtr + 12;
+  writeBinaries<uint32_t>(MemInst, std::vector<uint32_t>{0, 0, 0}, HeaderPtr);
+
+  // Test: compute_stream -- context id exceeds.
+  {
+    EXPECT_TRUE(HostFuncComputeStream.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(3), RingPtr, UINT32_C(64), HeaderPtr},
+        Errno));
+    EXPECT_NE(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: compute_stream -- header ptr out of bounds.
+  {
+    EXPECT_TRUE(HostFuncComputeStream.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(0), RingPtr, UINT32_C(64), OutBoundPtr},
+        Errno));
+    EXPECT_NE(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: compute_stream -- generate until the ring buffer is full.
+  {
+    EXPECT_TRUE(HostFuncComputeStream.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            UINT32_C(0), RingPtr, UINT32_C(64), HeaderPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+    const uint32_t Written = *MemInst.getPointer<uint32_t *>(HeaderPtr);
+    EXPECT_GT(Written, 0U);
+    EXPECT_LE(Written, 64U);
+  }
+
+  // GGML WASI-NN compute_async and compute_poll tests.
+  FuncInst = NNMod->findFuncExports("compute_async");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncComputeAsync =
+      dynamic_cast<WasmEdge::Host::WasiNNComputeAsync &>(
+          FuncInst->getHostFunc());
+  FuncInst = NNMod->findFuncExports("compute_poll");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncComputePoll =
+      dynamic_cast<WasmEdge::Host::WasiNNComputePoll &>(
+          FuncInst->getHostFunc());
+  const uint32_t DonePtr = RingPtr + 64;
+
+  // Test: compute_async -- context id exceeds.
+  {
+    EXPECT_TRUE(HostFuncComputeAsync.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(3)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: compute_async -- start the compute in background.
+  {
+    EXPECT_TRUE(HostFuncComputeAsync.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  }
+
+  // Test: compute -- context busy before the compute is polled.
+  {
+    EXPECT_TRUE(HostFuncCompute.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0)},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(), static_cast<uint32_t>(ErrNo::Busy));
+  }
+
+  // Test: compute_poll -- done ptr out of bounds.
+  {
+    EXPECT_TRUE(HostFuncComputePoll.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0), UINT64_C(0),
+                                                    OutBoundPtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
+
+  // Test: compute_poll -- wait until the compute finishes.
+  {
+    writeBinaries<uint32_t>(MemInst, std::vector<uint32_t>{0}, DonePtr);
+    while (*MemInst.getPointer<uint32_t *>(DonePtr) == 0) {
+      EXPECT_TRUE(HostFuncComputePoll.run(
+          CallFrame,
+          std::initializer_list<WasmEdge::ValVariant>{
+              UINT32_C(0), UINT64_C(1000000000), DonePtr},
+          Errno));
+    }
+    EXPECT_TRUE(
+        Errno[0].get<int32_t>() == static_cast<uint32_t>(ErrNo::Success) ||
+        Errno[0].get<int32_t>() == static_cast<uint32_t>(ErrNo::ContextFull));
+  }
+
+  // Test: compute_poll -- no compute after the result is polled.
+  {
+    EXPECT_TRUE(HostFuncComputePoll.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{UINT32_C(0), UINT64_C(0),
+                                                    DonePtr},
+        Errno));
+    EXPECT_EQ(Errno[0].get<int32_t>(),
+              static_cast<uint32_t>(ErrNo::InvalidArgument));
+  }
 }
 #ifdef WASMEDGE_BUILD_WASI_NN_RPC
 TEST(WasiNNTest, GGMLBackendWithRPC) {
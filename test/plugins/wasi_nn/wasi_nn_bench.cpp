@@ -0,0 +1,463 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+// Benchmark of the wasi-nn backends. Every compiled-in backend runs the same
+// workload as its functional test through the wasi-nn host functions, and
+// the timings are reported as JSON on the standard output:
+//
+//   wasiNNBench [iterations]
+//
+// The fixtures are the ones downloaded for the functional tests, and the
+// backends with missing fixtures are reported as skipped.
+
+#include "wasinnfunc.h"
+#include "wasinnmodule.h"
+
+#include "common/types.h"
+#include "runtime/instance/module.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+using WasmEdge::Host::WASINN::Backend;
+using WasmEdge::Host::WASINN::Device;
+using WasmEdge::Host::WASINN::ErrNo;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T, typename U>
+inline std::unique_ptr<T> dynamicPointerCast(std::unique_ptr<U> &&R) noexcept {
+  static_assert(std::has_virtual_destructor_v<T>);
+  T *P = dynamic_cast<T *>(R.get());
+  if (P) {
+    R.release();
+  }
+  return std::unique_ptr<T>(P);
+}
+
+std::unique_ptr<WasmEdge::Host::WasiNNModule> createModule() {
+  WasmEdge::Plugin::Plugin::load(
+      std::filesystem::u8path("../../../plugins/wasi_nn/" WASMEDGE_LIB_PREFIX
+                              "wasmedgePluginWasiNN" WASMEDGE_LIB_EXTENSION));
+  if (const auto *Plugin = WasmEdge::Plugin::Plugin::find("wasi_nn"sv)) {
+    WasmEdge::PO::ArgumentParser Parser;
+    Plugin->registerOptions(Parser);
+    if (const auto *Module = Plugin->findModule("wasi_nn"sv)) {
+      return dynamicPointerCast<WasmEdge::Host::WasiNNModule>(Module->create());
+    }
+  }
+  return {};
+}
+
+std::vector<uint8_t> readEntireFile(const std::string &Path) {
+  std::ifstream Fin(Path, std::ios::in | std::ios::binary | std::ios::ate);
+  if (!Fin) {
+    return {};
+  }
+  std::vector<uint8_t> Buf(static_cast<std::size_t>(Fin.tellg()));
+  Fin.seekg(0, std::ios::beg);
+  if (!Fin.read(reinterpret_cast<char *>(Buf.data()),
+                static_cast<std::streamsize>(Buf.size()))) {
+    return {};
+  }
+  return Buf;
+}
+
+std::vector<uint8_t> toBytes(std::string_view Str) {
+  return std::vector<uint8_t>(Str.begin(), Str.end());
+}
+
+/// Workload of a backend, the same as its functional test.
+struct Workload {
+  std::string_view Name;
+  Backend Encoding;
+  std::vector<std::vector<uint8_t>> Builders;
+  std::vector<uint32_t> TensorDim;
+  uint32_t TensorType;
+  std::vector<uint8_t> TensorData;
+  /// Size of the output buffer of `get_output`.
+  uint32_t OutputSize;
+  /// Whether the backend reports the generated tokens in the metadata of the
+  /// output index 1.
+  bool HasTokenMetadata = false;
+};
+
+/// Latencies of a step in microseconds.
+struct Latency {
+  std::vector<double> Samples;
+
+  void add(Clock::duration D) {
+    Samples.push_back(std::chrono::duration<double, std::micro>(D).count());
+  }
+  std::string toJSON() const {
+    if (Samples.empty()) {
+      return "null";
+    }
+    double Sum = 0;
+    for (const double S : Samples) {
+      Sum += S;
+    }
+    const auto [Min, Max] = std::minmax_element(Samples.begin(), Samples.end());
+    return fmt::format(R"({{"mean": {:.1f}, "min": {:.1f}, "max": {:.1f}}})",
+                       Sum / static_cast<double>(Samples.size()), *Min, *Max);
+  }
+};
+
+/// Get the workload of the backend, or nullopt if the fixtures are missing.
+std::optional<Workload> getWorkload(Backend Encoding) {
+  Workload W;
+  W.Encoding = Encoding;
+  switch (Encoding) {
+  case Backend::OpenVINO: {
+    W.Name = "openvino"sv;
+    W.Builders.push_back(
+        readEntireFile("./wasinn_openvino_fixtures/mobilenet.xml"));
+    W.Builders.push_back(
+        readEntireFile("./wasinn_openvino_fixtures/mobilenet.bin"));
+    // Convert the NHWC to NCHW format as the functional test.
+    const auto NHWC =
+        readEntireFile("./wasinn_openvino_fixtures/tensor-1x224x224x3-f32.bgr");
+    if (NHWC.size() != 3 * 224 * 224 * 4) {
+      return std::nullopt;
+    }
+    W.TensorData.resize(NHWC.size());
+    for (size_t C = 0; C < 3; ++C) {
+      for (size_t Loc = 0; Loc < 224 * 224; ++Loc) {
+        for (size_t B = 0; B < 4; ++B) {
+          W.TensorData[(C * 224 * 224 + Loc) * 4 + B] =
+              NHWC[(3 * Loc + C) * 4 + B];
+        }
+      }
+    }
+    W.TensorDim = {1, 3, 224, 224};
+    W.TensorType = 1;
+    W.OutputSize = 1001 * 4;
+    break;
+  }
+  case Backend::PyTorch:
+    W.Name = "pytorch"sv;
+    W.Builders.push_back(
+        readEntireFile("./wasinn_pytorch_fixtures/mobilenet.pt"));
+    W.TensorData =
+        readEntireFile("./wasinn_pytorch_fixtures/image-1x3x224x224.rgb");
+    W.TensorDim = {1, 3, 224, 224};
+    W.TensorType = 1;
+    W.OutputSize = 1000 * 4;
+    break;
+  case Backend::TensorflowLite:
+    W.Name = "tflite"sv;
+    W.Builders.push_back(
+        readEntireFile("./wasinn_tflite_fixtures/"
+                       "lite-model_aiy_vision_classifier_birds_V1_3.tflite"));
+    W.TensorData =
+        readEntireFile("./wasinn_tflite_fixtures/birdx224x224x3.rgb");
+    W.TensorDim = {1, 224, 224, 3};
+    W.TensorType = 3;
+    W.OutputSize = 965;
+    break;
+  case Backend::GGML:
+    W.Name = "ggml"sv;
+    W.Builders.push_back(readEntireFile(
+        WasmEdge::Endian::native == WasmEdge::Endian::little
+            ? "./wasinn_ggml_fixtures/orca_mini.gguf"
+            : "./wasinn_ggml_fixtures/granite-3.gguf"));
+    W.TensorData = toBytes("Once upon a time, "sv);
+    W.TensorDim = {1};
+    W.TensorType = 1;
+    W.OutputSize = 65532;
+    W.HasTokenMetadata = true;
+    break;
+  case Backend::Whisper:
+    W.Name = "whisper"sv;
+    W.Builders.push_back(
+        readEntireFile("./wasinn_whisper_fixtures/ggml-base.bin"));
+    W.TensorData = readEntireFile("./wasinn_whisper_fixtures/test.wav");
+    W.TensorDim = {1, static_cast<uint32_t>(W.TensorData.size())};
+    W.TensorType = 1;
+    W.OutputSize = 65532;
+    break;
+  case Backend::MLX:
+    W.Name = "mlx"sv;
+    W.Builders.push_back(
+        readEntireFile("./wasinn_mlx_fixtures/model.safetensors"));
+    W.Builders.push_back(toBytes(
+        R"({"model_type":"tiny_llama_1.1B_chat_v1.0", )"
+        R"("tokenizer":"./wasinn_mlx_fixtures/tokenizer.json", )"
+        R"("q_bits": 4, "group_size": 128, "is_quantized": false})"sv));
+    W.TensorData = toBytes("How are you?"sv);
+    W.TensorDim = {1};
+    W.TensorType = 1;
+    W.OutputSize = 65532;
+    break;
+  default:
+    return std::nullopt;
+  }
+  for (const auto &Builder : W.Builders) {
+    if (Builder.empty()) {
+      return std::nullopt;
+    }
+  }
+  if (W.TensorData.empty()) {
+    return std::nullopt;
+  }
+  return W;
+}
+
+/// Runner of a workload through the wasi-nn host functions, with the guest
+/// memory sized for the workload.
+class Runner {
+public:
+  Runner(WasmEdge::Host::WasiNNModule &NNMod, const Workload &W)
+      : W(W), Mod(""), CallFrame(nullptr, &Mod) {
+    uint64_t Bytes = W.TensorData.size() + W.OutputSize + 65536;
+    for (const auto &Builder : W.Builders) {
+      Bytes += Builder.size();
+    }
+    const auto Pages = static_cast<uint32_t>(
+        std::min<uint64_t>(Bytes / 65536 + 2, UINT64_C(65536)));
+    Mod.addHostMemory(
+        "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                      WasmEdge::AST::MemoryType(Pages)));
+    MemInst = Mod.findMemoryExports("memory");
+    Load = &getHostFunc<WasmEdge::Host::WasiNNLoad>(NNMod, "load"sv);
+    Init = &getHostFunc<WasmEdge::Host::WasiNNInitExecCtx>(
+        NNMod, "init_execution_context"sv);
+    SetInput =
+        &getHostFunc<WasmEdge::Host::WasiNNSetInput>(NNMod, "set_input"sv);
+    Compute = &getHostFunc<WasmEdge::Host::WasiNNCompute>(NNMod, "compute"sv);
+    GetOutput =
+        &getHostFunc<WasmEdge::Host::WasiNNGetOutput>(NNMod, "get_output"sv);
+  }
+
+  /// Run the workload, and return the JSON report of the backend.
+  std::string run(uint32_t Iterations) {
+    // Write the builders into the guest memory, and load the graph.
+    const uint32_t BuilderPtr = alloc(8 * W.Builders.size());
+    for (size_t I = 0; I < W.Builders.size(); ++I) {
+      const uint32_t Ptr = write(W.Builders[I]);
+      store(BuilderPtr + I * 8, Ptr);
+      store(BuilderPtr + I * 8 + 4, W.Builders[I].size());
+    }
+    const uint32_t IdPtr = alloc(4);
+    auto Start = Clock::now();
+    uint32_t Err = call(*Load, {BuilderPtr,
+                                static_cast<uint32_t>(W.Builders.size()),
+                                static_cast<uint32_t>(W.Encoding),
+                                static_cast<uint32_t>(Device::CPU), IdPtr});
+    const auto LoadTime = Clock::now() - Start;
+    if (Err != static_cast<uint32_t>(ErrNo::Success)) {
+      return error("load"sv, Err);
+    }
+    const uint32_t GraphId = load(IdPtr);
+    Err = call(*Init, {GraphId, IdPtr});
+    if (Err != static_cast<uint32_t>(ErrNo::Success)) {
+      return error("init_execution_context"sv, Err);
+    }
+    const uint32_t ContextId = load(IdPtr);
+
+    // Write the input tensor into the guest memory.
+    const uint32_t TensorPtr = alloc(20);
+    const uint32_t DimPtr = alloc(4 * W.TensorDim.size());
+    for (size_t I = 0; I < W.TensorDim.size(); ++I) {
+      store(DimPtr + I * 4, W.TensorDim[I]);
+    }
+    const uint32_t DataPtr = write(W.TensorData);
+    store(TensorPtr, DimPtr);
+    store(TensorPtr + 4, W.TensorDim.size());
+    store(TensorPtr + 8, W.TensorType);
+    store(TensorPtr + 12, DataPtr);
+    store(TensorPtr + 16, W.TensorData.size());
+    const uint32_t OutPtr = alloc(W.OutputSize);
+    const uint32_t WrittenPtr = alloc(4);
+
+    Latency SetInputTime, ComputeTime, GetOutputTime;
+    uint64_t OutputBytes = 0;
+    uint64_t Tokens = 0;
+    for (uint32_t I = 0; I < Iterations; ++I) {
+      Start = Clock::now();
+      Err = call(*SetInput, {ContextId, UINT32_C(0), TensorPtr});
+      SetInputTime.add(Clock::now() - Start);
+      if (Err != static_cast<uint32_t>(ErrNo::Success)) {
+        return error("set_input"sv, Err);
+      }
+      Start = Clock::now();
+      Err = call(*Compute, {ContextId});
+      ComputeTime.add(Clock::now() - Start);
+      if (Err != static_cast<uint32_t>(ErrNo::Success) &&
+          Err != static_cast<uint32_t>(ErrNo::ContextFull)) {
+        return error("compute"sv, Err);
+      }
+      Start = Clock::now();
+      Err = call(*GetOutput,
+                 {ContextId, UINT32_C(0), OutPtr, W.OutputSize, WrittenPtr});
+      GetOutputTime.add(Clock::now() - Start);
+      if (Err != static_cast<uint32_t>(ErrNo::Success)) {
+        return error("get_output"sv, Err);
+      }
+      OutputBytes += load(WrittenPtr);
+      if (W.HasTokenMetadata) {
+        Tokens += getOutputTokens(ContextId, OutPtr, WrittenPtr);
+      }
+    }
+
+    double ComputeSeconds = 0;
+    for (const double S : ComputeTime.Samples) {
+      ComputeSeconds += S / 1e6;
+    }
+    const std::string TokensPerSecond =
+        W.HasTokenMetadata && ComputeSeconds > 0
+            ? fmt::format("{:.2f}", static_cast<double>(Tokens) /
+                                        ComputeSeconds)
+            : "null"s;
+    // The input is copied from the guest memory by `set_input`, and the
+    // output is copied into the guest memory by `get_output`.
+    const uint64_t InputBytes = W.TensorData.size();
+    const uint64_t OutputBytesPerCall = OutputBytes / Iterations;
+    return fmt::format(
+        R"({{"backend": "{}", "status": "ok", "iterations": {}, )"
+        R"("load_ms": {:.3f}, "set_input_us": {}, "compute_us": {}, )"
+        R"("get_output_us": {}, "tokens_per_second": {}, )"
+        R"("input_bytes_per_call": {}, "output_bytes_per_call": {}, )"
+        R"("guest_copies_per_call": 2, "guest_copied_bytes_per_call": {}}})",
+        W.Name, Iterations,
+        std::chrono::duration<double, std::milli>(LoadTime).count(),
+        SetInputTime.toJSON(), ComputeTime.toJSON(), GetOutputTime.toJSON(),
+        TokensPerSecond, InputBytes, OutputBytesPerCall,
+        InputBytes + OutputBytesPerCall);
+  }
+
+private:
+  template <typename T>
+  static T &getHostFunc(WasmEdge::Host::WasiNNModule &NNMod,
+                        std::string_view Name) {
+    auto *FuncInst = NNMod.findFuncExports(Name);
+    return dynamic_cast<T &>(FuncInst->getHostFunc());
+  }
+
+  uint32_t call(WasmEdge::Runtime::HostFunctionBase &Func,
+                std::initializer_list<WasmEdge::ValVariant> Args) {
+    std::array<WasmEdge::ValVariant, 1> Errno = {UINT32_C(0)};
+    if (!Func.run(CallFrame, Args, Errno)) {
+      return UINT32_MAX;
+    }
+    return Errno[0].get<uint32_t>();
+  }
+
+  uint32_t alloc(uint64_t Size) {
+    const uint32_t Ptr = Top;
+    Top = static_cast<uint32_t>((Top + Size + 7) & ~UINT64_C(7));
+    return Ptr;
+  }
+  uint32_t write(const std::vector<uint8_t> &Data) {
+    const uint32_t Ptr = alloc(Data.size());
+    std::copy(Data.begin(), Data.end(), MemInst->getPointer<uint8_t *>(Ptr));
+    return Ptr;
+  }
+  void store(uint64_t Ptr, uint64_t Value) {
+    MemInst->storeValue(static_cast<uint32_t>(Value),
+                        static_cast<uint32_t>(Ptr));
+  }
+  uint32_t load(uint32_t Ptr) { return *MemInst->getPointer<uint32_t *>(Ptr); }
+
+  /// Get the count of the generated tokens from the metadata.
+  uint64_t getOutputTokens(uint32_t ContextId, uint32_t OutPtr,
+                           uint32_t WrittenPtr) {
+    if (call(*GetOutput, {ContextId, UINT32_C(1), OutPtr, W.OutputSize,
+                          WrittenPtr}) !=
+        static_cast<uint32_t>(ErrNo::Success)) {
+      return 0;
+    }
+    const std::string_view Metadata(MemInst->getPointer<char *>(OutPtr),
+                                    load(WrittenPtr));
+    const auto Pos = Metadata.find(R"("output_tokens": )"sv);
+    if (Pos == std::string_view::npos) {
+      return 0;
+    }
+    return std::strtoull(Metadata.data() + Pos + 17, nullptr, 10);
+  }
+
+  std::string error(std::string_view Step, uint32_t Err) const {
+    return fmt::format(
+        R"({{"backend": "{}", "status": "error", "step": "{}", "errno": {}}})",
+        W.Name, Step, Err);
+  }
+
+  const Workload &W;
+  WasmEdge::Runtime::Instance::ModuleInstance Mod;
+  WasmEdge::Runtime::CallingFrame CallFrame;
+  WasmEdge::Runtime::Instance::MemoryInstance *MemInst = nullptr;
+  WasmEdge::Host::WasiNNLoad *Load = nullptr;
+  WasmEdge::Host::WasiNNInitExecCtx *Init = nullptr;
+  WasmEdge::Host::WasiNNSetInput *SetInput = nullptr;
+  WasmEdge::Host::WasiNNCompute *Compute = nullptr;
+  WasmEdge::Host::WasiNNGetOutput *GetOutput = nullptr;
+  /// Top of the allocated guest memory.
+  uint32_t Top = 0;
+};
+
+} // namespace
+
+int main(int Argc, const char *Argv[]) {
+  const uint32_t Iterations =
+      Argc > 1 ? std::max(1U, static_cast<uint32_t>(std::atoi(Argv[1]))) : 5U;
+  std::vector<std::pair<std::string_view, Backend>> Backends;
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_OPENVINO
+  Backends.emplace_back("openvino"sv, Backend::OpenVINO);
+#endif
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TORCH
+  Backends.emplace_back("pytorch"sv, Backend::PyTorch);
+#endif
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_TFLITE
+  Backends.emplace_back("tflite"sv, Backend::TensorflowLite);
+#endif
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_GGML
+  Backends.emplace_back("ggml"sv, Backend::GGML);
+#endif
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_WHISPER
+  Backends.emplace_back("whisper"sv, Backend::Whisper);
+#endif
+#ifdef WASMEDGE_PLUGIN_WASI_NN_BACKEND_MLX
+  Backends.emplace_back("mlx"sv, Backend::MLX);
+#endif
+
+  auto NNMod = createModule();
+  if (!NNMod) {
+    std::cerr << "Cannot load the wasi_nn plugin.\n";
+    return EXIT_FAILURE;
+  }
+  std::vector<std::string> Reports;
+  for (const auto &[Name, Encoding] : Backends) {
+    if (auto W = getWorkload(Encoding)) {
+      Runner R(*NNMod, *W);
+      Reports.push_back(R.run(Iterations));
+    } else {
+      Reports.push_back(fmt::format(
+          R"({{"backend": "{}", "status": "skipped", )"
+          R"("reason": "missing fixtures"}})",
+          Name));
+    }
+  }
+  std::cout << "[\n";
+  for (size_t I = 0; I < Reports.size(); ++I) {
+    std::cout << "  " << Reports[I] << (I + 1 < Reports.size() ? ",\n" : "\n");
+  }
+  std::cout << "]\n";
+  return EXIT_SUCCESS;
+}
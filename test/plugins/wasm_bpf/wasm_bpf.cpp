@@ -74,13 +74,15 @@ TEST(WasmBpfTest, Module) {
   auto module = createModule();
   ASSERT_TRUE(module);
   // Test whether functions are exported
-  EXPECT_EQ(module->getFuncExportNum(), 6U);
+  EXPECT_EQ(module->getFuncExportNum(), 8U);
   EXPECT_NE(module->findFuncExports("wasm_load_bpf_object"), nullptr);
   EXPECT_NE(module->findFuncExports("wasm_close_bpf_object"), nullptr);
   EXPECT_NE(module->findFuncExports("wasm_attach_bpf_program"), nullptr);
   EXPECT_NE(module->findFuncExports("wasm_bpf_buffer_poll"), nullptr);
   EXPECT_NE(module->findFuncExports("wasm_bpf_map_fd_by_name"), nullptr);
   EXPECT_NE(module->findFuncExports("wasm_bpf_map_operate"), nullptr);
+  EXPECT_NE(module->findFuncExports("wasm_bpf_buffer_poll_batch"), nullptr);
+  EXPECT_NE(module->findFuncExports("wasm_bpf_map_operate_batch"), nullptr);
 }
 
 static const size_t TASK_COMM_LEN = 16;
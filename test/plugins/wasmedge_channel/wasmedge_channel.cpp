@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "channelfunc.h"
+#include "channelmodule.h"
+#include "common/defines.h"
+#include "runtime/instance/module.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+using WasmEdge::Host::Channel::ErrNo;
+using WasmEdge::Host::Channel::Layout;
+
+template <typename T, typename U>
+inline std::unique_ptr<T> dynamicPointerCast(std::unique_ptr<U> &&R) noexcept {
+  static_assert(std::has_virtual_destructor_v<T>);
+  T *P = dynamic_cast<T *>(R.get());
+  if (P) {
+    R.release();
+  }
+  return std::unique_ptr<T>(P);
+}
+
+std::unique_ptr<WasmEdge::Host::WasmEdgeChannelModule> createModule() {
+  using namespace std::literals::string_view_literals;
+  WasmEdge::Plugin::Plugin::load(std::filesystem::u8path(
+      "../../../plugins/wasmedge_channel/" WASMEDGE_LIB_PREFIX
+      "wasmedgePluginWasmEdgeChannel" WASMEDGE_LIB_EXTENSION));
+  if (const auto *Plugin =
+          WasmEdge::Plugin::Plugin::find("wasmedge_channel"sv)) {
+    if (const auto *Module = Plugin->findModule("wasmedge_channel"sv)) {
+      return dynamicPointerCast<WasmEdge::Host::WasmEdgeChannelModule>(
+          Module->create());
+    }
+  }
+  return {};
+}
+
+/// Stage of a pipeline with its own memory and the channel module.
+struct Stage {
+  Stage() : ChMod(createModule()), Mod(""), CallFrame(nullptr, &Mod) {
+    Mod.addHostMemory(
+        "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                      WasmEdge::AST::MemoryType(1)));
+    MemInst = Mod.findMemoryExports("memory");
+  }
+
+  template <typename T> T &func(std::string_view Name) {
+    auto *FuncInst = ChMod->findFuncExports(Name);
+    EXPECT_NE(FuncInst, nullptr);
+    return dynamic_cast<T &>(FuncInst->getHostFunc());
+  }
+
+  uint32_t call(WasmEdge::Runtime::HostFunctionBase &Func,
+                std::initializer_list<WasmEdge::ValVariant> Args) {
+    std::array<WasmEdge::ValVariant, 1> RetVal;
+    EXPECT_TRUE(Func.run(CallFrame, Args, RetVal));
+    return RetVal[0].get<uint32_t>();
+  }
+
+  ErrNo open(std::string_view Name, uint32_t Capacity, uint32_t &Id,
+             uint32_t &Offset) {
+    std::copy(Name.begin(), Name.end(), MemInst->getPointer<char *>(16));
+    const auto Err = static_cast<ErrNo>(call(
+        func<WasmEdge::Host::WasmEdgeChannelOpen>("wasmedge_channel_open"),
+        {UINT32_C(16), static_cast<uint32_t>(Name.size()), Capacity,
+         UINT32_C(0), UINT32_C(4)}));
+    Id = *MemInst->getPointer<uint32_t *>(0);
+    Offset = *MemInst->getPointer<uint32_t *>(4);
+    return Err;
+  }
+
+  std::unique_ptr<WasmEdge::Host::WasmEdgeChannelModule> ChMod;
+  WasmEdge::Runtime::Instance::ModuleInstance Mod;
+  WasmEdge::Runtime::Instance::MemoryInstance *MemInst = nullptr;
+  WasmEdge::Runtime::CallingFrame CallFrame;
+};
+
+} // namespace
+
+TEST(WasmEdgeChannelTest, Open) {
+  Stage Producer, Consumer;
+  ASSERT_TRUE(Producer.ChMod && Consumer.ChMod);
+
+  // The channel memory is shared by the module instances.
+  auto *ChMem = Producer.ChMod->findMemoryExports("memory");
+  ASSERT_NE(ChMem, nullptr);
+  EXPECT_EQ(ChMem, Consumer.ChMod->findMemoryExports("memory"));
+  EXPECT_TRUE(ChMem->isShared());
+
+  // The capacity is rounded up to a power of two.
+  uint32_t Id1, Offset1, Id2, Offset2;
+  ASSERT_EQ(Producer.open("frames", 1000, Id1, Offset1), ErrNo::Success);
+  ASSERT_EQ(Consumer.open("frames", 0, Id2, Offset2), ErrNo::Success);
+  EXPECT_EQ(Id1, Id2);
+  EXPECT_EQ(Offset1, Offset2);
+  EXPECT_EQ(*ChMem->getPointer<uint32_t *>(Offset1 + Layout::kCapacityOffset),
+            1024U);
+
+  // Invalid arguments.
+  EXPECT_EQ(Producer.open("", 64, Id2, Offset2), ErrNo::InvalidArgument);
+  EXPECT_EQ(Producer.open("huge", UINT32_MAX, Id2, Offset2),
+            ErrNo::InvalidArgument);
+
+  // The peer sees the channel closed, and the region is reused after both
+  // ends closed it.
+  auto &Close = Producer.func<WasmEdge::Host::WasmEdgeChannelClose>(
+      "wasmedge_channel_close");
+  EXPECT_EQ(static_cast<ErrNo>(Producer.call(Close, {Id1})), ErrNo::Success);
+  EXPECT_EQ(static_cast<ErrNo>(Producer.call(Close, {Id1})), ErrNo::NotFound);
+  EXPECT_EQ(*ChMem->getPointer<uint32_t *>(Offset1 + Layout::kClosedOffset),
+            1U);
+  EXPECT_EQ(static_cast<ErrNo>(Consumer.call(Close, {Id1})), ErrNo::Success);
+  ASSERT_EQ(Consumer.open("events", 1024, Id2, Offset2), ErrNo::Success);
+  EXPECT_NE(Id1, Id2);
+  EXPECT_EQ(Offset1, Offset2);
+}
+
+TEST(WasmEdgeChannelTest, Transfer) {
+  Stage Producer, Consumer;
+  ASSERT_TRUE(Producer.ChMod && Consumer.ChMod);
+  auto &ChMem = *Producer.ChMod->findMemoryExports("memory");
+  uint32_t Id, Offset;
+  ASSERT_EQ(Producer.open("bytes", 64, Id, Offset), ErrNo::Success);
+  ASSERT_EQ(Consumer.open("bytes", 64, Id, Offset), ErrNo::Success);
+  auto &Head =
+      *ChMem.getPointer<std::atomic<uint32_t> *>(Offset + Layout::kHeadOffset);
+  auto &Tail =
+      *ChMem.getPointer<std::atomic<uint32_t> *>(Offset + Layout::kTailOffset);
+  auto *Data = ChMem.getPointer<uint8_t *>(Offset + Layout::kHeaderSize);
+  constexpr uint32_t Total = 100000;
+
+  // The consumer reads the bytes in place, and waits on the head counter.
+  std::thread Reader([&]() {
+    auto &Wait = Consumer.func<WasmEdge::Host::WasmEdgeChannelWait>(
+        "wasmedge_channel_wait");
+    auto &Notify = Consumer.func<WasmEdge::Host::WasmEdgeChannelNotify>(
+        "wasmedge_channel_notify");
+    uint32_t Read = 0;
+    while (Read < Total) {
+      const uint32_t Written = Head.load();
+      if (Written == Read) {
+        Consumer.call(Wait, {Id, UINT32_C(0), Read, UINT64_C(1000000000)});
+        continue;
+      }
+      for (; Read != Written; ++Read) {
+        EXPECT_EQ(Data[Read & 63], static_cast<uint8_t>(Read));
+      }
+      Tail.store(Read);
+      Consumer.call(Notify, {Id});
+    }
+  });
+
+  // The producer writes the bytes in place, and waits on the tail counter.
+  auto &Wait = Producer.func<WasmEdge::Host::WasmEdgeChannelWait>(
+      "wasmedge_channel_wait");
+  auto &Notify = Producer.func<WasmEdge::Host::WasmEdgeChannelNotify>(
+      "wasmedge_channel_notify");
+  uint32_t Written = 0;
+  while (Written < Total) {
+    const uint32_t Read = Tail.load();
+    if (Written - Read == 64) {
+      Producer.call(Wait, {Id, UINT32_C(1), Read, UINT64_C(1000000000)});
+      continue;
+    }
+    const uint32_t End = std::min(Read + 64, Total);
+    for (; Written != End; ++Written) {
+      Data[Written & 63] = static_cast<uint8_t>(Written);
+    }
+    Head.store(Written);
+    Producer.call(Notify, {Id});
+  }
+  Reader.join();
+  EXPECT_EQ(Tail.load(), Total);
+
+  // Waiting on the unchanged counter times out.
+  EXPECT_EQ(static_cast<ErrNo>(
+                Producer.call(Wait, {Id, UINT32_C(0), Total, UINT64_C(1000)})),
+            ErrNo::TimedOut);
+  EXPECT_EQ(static_cast<ErrNo>(
+                Producer.call(Wait, {Id, UINT32_C(2), Total, UINT64_C(1000)})),
+            ErrNo::InvalidArgument);
+  EXPECT_EQ(static_cast<ErrNo>(Producer.call(Notify, {Id + 1})),
+            ErrNo::NotFound);
+}
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+#include "pipeline/pipeline_func.h"
+#include "avutil/avFrame.h"
+#include "pipeline/module.h"
+
+#include "utils.h"
+
+#include <gtest/gtest.h>
+
+namespace WasmEdge {
+namespace Host {
+namespace WasmEdgeFFmpeg {
+
+// ============================================================================
+// This test deals with the host-side frame pipelines.
+// ============================================================================
+
+TEST_F(FFmpegTest, FramePipeline) {
+  ASSERT_TRUE(PipelineMod != nullptr);
+
+  uint32_t PipelinePtr = UINT32_C(4);
+  uint32_t FramePtr = UINT32_C(72);
+  uint32_t Frame2Ptr = UINT32_C(124);
+  uint32_t AVCodecCtxPtr = UINT32_C(64);
+  uint32_t TypePtr = UINT32_C(200);
+
+  std::string FileName = "ffmpeg-assets/sample_video.mp4"; // 32 chars
+  initFFmpegStructs(UINT32_C(12), UINT32_C(24), UINT32_C(28), FileName,
+                    UINT32_C(60), AVCodecCtxPtr, UINT32_C(68), FramePtr);
+  initEmptyFrame(Frame2Ptr);
+
+  uint32_t AVCodecCtxId = readUInt32(MemInst, AVCodecCtxPtr);
+  uint32_t Frame2Id = readUInt32(MemInst, Frame2Ptr);
+  uint32_t RGB24Id = 3; // RGB24  AVPixFormatId (From Bindings.h)
+
+  auto *FuncInst = PipelineMod->findFuncExports(
+      "wasmedge_ffmpeg_pipeline_pipeline_new");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncPipelineNew =
+      dynamic_cast<WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::PipelineNew &>(
+          FuncInst->getHostFunc());
+
+  // A null decoder is rejected.
+  {
+    EXPECT_TRUE(HostFuncPipelineNew.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{PipelinePtr, UINT32_C(0),
+                                                    200, 100, RGB24Id,
+                                                    UINT32_C(0)},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(),
+              static_cast<int32_t>(ErrNo::NullStructId));
+  }
+
+  // Decode and scale without an encoder.
+  {
+    EXPECT_TRUE(HostFuncPipelineNew.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{PipelinePtr, AVCodecCtxId,
+                                                    200, 100, RGB24Id,
+                                                    UINT32_C(0)},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), static_cast<int32_t>(ErrNo::Success));
+    ASSERT_TRUE(readUInt32(MemInst, PipelinePtr) > 0);
+  }
+  uint32_t PipelineId = readUInt32(MemInst, PipelinePtr);
+
+  FuncInst = PipelineMod->findFuncExports(
+      "wasmedge_ffmpeg_pipeline_pipeline_receive_frame");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncPipelineReceiveFrame = dynamic_cast<
+      WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::PipelineReceiveFrame &>(
+      FuncInst->getHostFunc());
+
+  {
+    EXPECT_TRUE(HostFuncPipelineReceiveFrame.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{PipelineId, Frame2Id},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), AVERROR(EAGAIN));
+  }
+
+  FuncInst = PipelineMod->findFuncExports(
+      "wasmedge_ffmpeg_pipeline_pipeline_send_packet");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncPipelineSendPacket = dynamic_cast<
+      WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::PipelineSendPacket &>(
+      FuncInst->getHostFunc());
+
+  // Flush the frames buffered in the decoder.
+  {
+    EXPECT_TRUE(HostFuncPipelineSendPacket.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{PipelineId, UINT32_C(0)},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), static_cast<int32_t>(ErrNo::Success));
+  }
+
+  FuncInst =
+      AVUtilMod->findFuncExports("wasmedge_ffmpeg_avutil_av_frame_width");
+  auto &HostFuncAVFrameWidth =
+      dynamic_cast<WasmEdge::Host::WasmEdgeFFmpeg::AVUtil::AVFrameWidth &>(
+          FuncInst->getHostFunc());
+
+  // Every frame is scaled, until the end of the stream.
+  while (true) {
+    EXPECT_TRUE(HostFuncPipelineReceiveFrame.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{PipelineId, Frame2Id},
+        Result));
+    int32_t Res = Result[0].get<int32_t>();
+    if (Res == AVERROR_EOF) {
+      break;
+    }
+    ASSERT_EQ(Res, 0);
+    EXPECT_TRUE(HostFuncAVFrameWidth.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{Frame2Id},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), 200);
+  }
+
+  FuncInst = PipelineMod->findFuncExports(
+      "wasmedge_ffmpeg_pipeline_pipeline_free");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncPipelineFree =
+      dynamic_cast<WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::PipelineFree &>(
+          FuncInst->getHostFunc());
+
+  {
+    EXPECT_TRUE(HostFuncPipelineFree.run(
+        CallFrame, std::initializer_list<WasmEdge::ValVariant>{PipelineId},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), static_cast<int32_t>(ErrNo::Success));
+  }
+
+  FuncInst = PipelineMod->findFuncExports(
+      "wasmedge_ffmpeg_pipeline_av_hwdevice_ctx_create");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncAVHWDeviceCtxCreate = dynamic_cast<
+      WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::AVHWDeviceCtxCreate &>(
+      FuncInst->getHostFunc());
+
+  // Unknown device types are not supported.
+  {
+    std::string_view Type = "unknown";
+    fillMemContent(MemInst, TypePtr, Type);
+    EXPECT_TRUE(HostFuncAVHWDeviceCtxCreate.run(
+        CallFrame,
+        std::initializer_list<WasmEdge::ValVariant>{
+            AVCodecCtxId, TypePtr, static_cast<uint32_t>(Type.size())},
+        Result));
+    EXPECT_EQ(Result[0].get<int32_t>(), AVERROR(ENOSYS));
+  }
+}
+
+} // namespace WasmEdgeFFmpeg
+} // namespace Host
+} // namespace WasmEdge
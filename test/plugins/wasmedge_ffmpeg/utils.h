@@ -7,6 +7,7 @@
 #include "avfilter/module.h"
 #include "avformat/module.h"
 #include "avutil/module.h"
+#include "pipeline/module.h"
 #include "swresample/module.h"
 #include "swscale/module.h"
 
@@ -121,6 +122,13 @@ public:
                                    WasmEdgeFFmpegAVFilterModule>(
                 Module->create());
       }
+      if (const auto *Module =
+              Plugin->findModule("wasmedge_ffmpeg_pipeline"sv)) {
+        PipelineMod =
+            dynamicPointerCast<WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::
+                                   WasmEdgeFFmpegPipelineModule>(
+                Module->create());
+      }
     }
   }
 
@@ -165,6 +173,9 @@ protected:
   std::unique_ptr<
       WasmEdge::Host::WasmEdgeFFmpeg::AVFilter::WasmEdgeFFmpegAVFilterModule>
       AVFilterMod;
+  std::unique_ptr<
+      WasmEdge::Host::WasmEdgeFFmpeg::Pipeline::WasmEdgeFFmpegPipelineModule>
+      PipelineMod;
 };
 
 } // namespace WasmEdgeFFmpeg
@@ -140,10 +140,11 @@ TEST(WasmEdgeImageTest, Module) {
   // Create the wasmedge_image module instance.
   auto ImgMod = createModule();
   ASSERT_TRUE(ImgMod);
-  EXPECT_EQ(ImgMod->getFuncExportNum(), 3U);
+  EXPECT_EQ(ImgMod->getFuncExportNum(), 4U);
   EXPECT_NE(ImgMod->findFuncExports("load_jpg"), nullptr);
   EXPECT_NE(ImgMod->findFuncExports("load_png"), nullptr);
   EXPECT_NE(ImgMod->findFuncExports("load_image"), nullptr);
+  EXPECT_NE(ImgMod->findFuncExports("load_image_batch"), nullptr);
 }
 
 TEST(WasmEdgeImageTest, LoadJPG) {
@@ -514,6 +515,80 @@ TEST(WasmEdgeImageTest, LoadImage) {
   EXPECT_TRUE(std::fabs(OutSpanF32[Position * 3 + 2] - 0.0f) < 0.00001f);
 }
 
+TEST(WasmEdgeImageTest, LoadImageBatch) {
+  // Create the wasmedge_image module instance.
+  auto ImgMod = createModule();
+  ASSERT_TRUE(ImgMod);
+
+  // Create the calling frame with memory instance.
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+  std::array<WasmEdge::ValVariant, 1> Errno = {UINT32_C(0)};
+
+  // Set the target size. Smaller than the images to downscale them.
+  uint32_t TargetW = 10, TargetH = 12;
+  uint32_t TargetSize = TargetW * TargetH * 3;
+  // Assume the pixel position (5, 6).
+  uint32_t Position = 6 * TargetW + 5;
+  // Input payloads and list offsets.
+  uint32_t JPGOffset = 0;
+  uint32_t PNGOffset = 1024;
+  uint32_t ListOffset = 2048;
+  // Output image data offset.
+  uint32_t OutOffset = 4096;
+
+  // Get the function "load_image_batch".
+  auto *FuncInst = ImgMod->findFuncExports("load_image_batch");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &HostFuncInst =
+      dynamic_cast<WasmEdge::Host::WasmEdgeImage::LoadImageBatch &>(
+          FuncInst->getHostFunc());
+
+  // Clear the memory[0, 32768].
+  fillMemContent(MemInst, 0, 32768);
+  // Set the JPG and PNG image payloads and the list of them.
+  fillMemContent(MemInst, JPGOffset, TestRedJPG);
+  fillMemContent(MemInst, PNGOffset, TestRedPNG);
+  auto List = MemInst.getSpan<uint32_t>(ListOffset, 4);
+  List[0] = JPGOffset;
+  List[1] = static_cast<uint32_t>(TestRedJPG.size());
+  List[2] = PNGOffset;
+  List[3] = static_cast<uint32_t>(TestRedPNG.size());
+
+  // Test: Output buffer too small for both images.
+  EXPECT_TRUE(HostFuncInst.run(CallFrame,
+                               std::initializer_list<WasmEdge::ValVariant>{
+                                   ListOffset, 2U, TargetW, TargetH,
+                                   1U, // Target type: BGR8.
+                                   OutOffset, TargetSize},
+                               Errno));
+  EXPECT_EQ(Errno[0].get<uint32_t>(), static_cast<uint32_t>(ErrNo::Fail));
+
+  // Test: Load both images and resize into 10x12 BGR u8 format.
+  EXPECT_TRUE(HostFuncInst.run(CallFrame,
+                               std::initializer_list<WasmEdge::ValVariant>{
+                                   ListOffset, 2U, TargetW, TargetH,
+                                   1U, // Target type: BGR8.
+                                   OutOffset, TargetSize * 2},
+                               Errno));
+  EXPECT_EQ(Errno[0].get<uint32_t>(), static_cast<uint32_t>(ErrNo::Success));
+  auto OutSpanU8 = MemInst.getSpan<const uint8_t>(OutOffset, TargetSize * 2);
+  for (uint32_t I = 0; I < 2; ++I) {
+    const uint32_t Base = I * TargetSize + Position * 3;
+    // Note: Due to the JPG compression, the R may not be 255 here.
+    EXPECT_LE(OutSpanU8[Base], UINT8_C(2));
+    EXPECT_LE(OutSpanU8[Base + 1], UINT8_C(2));
+    EXPECT_GE(OutSpanU8[Base + 2], UINT8_C(250));
+  }
+}
+
 GTEST_API_ int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -48,11 +48,14 @@ TEST(WasmEdgeOpecvminiTest, Module) {
   // Create the wasmedge_opencvmini module instance.
   auto ImgMod = createModule();
   ASSERT_TRUE(ImgMod);
-  EXPECT_EQ(ImgMod->getFuncExportNum(), 19U);
+  EXPECT_EQ(ImgMod->getFuncExportNum(), 21U);
   EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_imdecode"), nullptr);
   EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_imencode"), nullptr);
   EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_rectangle"), nullptr);
   EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_cvt_color"), nullptr);
+  EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_run_ops"), nullptr);
+  EXPECT_NE(ImgMod->findFuncExports("wasmedge_opencvmini_release_mat"),
+            nullptr);
 }
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -528,13 +528,123 @@ TEST(WasmEdgeProcessTest, GetStdErr) {
                          MemInst.getPointer<uint8_t *>(0)));
 }
 
+TEST(WasmEdgeProcessTest, Spawn) {
+  // Create the wasmedge_process module instance.
+  auto ProcMod = createModule();
+  ASSERT_TRUE(ProcMod);
+
+  // Create the calling frame with memory instance.
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+
+  // Clear the memory[0, 64].
+  fillMemContent(MemInst, 0, 64);
+  // Set the memory[0, 16] as string "hello, wasmedge\n".
+  fillMemContent(MemInst, 0, "hello, wasmedge\n"sv);
+
+  // Get the functions.
+  auto *FuncInst = ProcMod->findFuncExports("wasmedge_process_spawn");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncSpawn = dynamic_cast<WasmEdge::Host::WasmEdgeProcessSpawn &>(
+      FuncInst->getHostFunc());
+  FuncInst = ProcMod->findFuncExports("wasmedge_process_write_stdin");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncWriteStdIn =
+      dynamic_cast<WasmEdge::Host::WasmEdgeProcessWriteStdIn &>(
+          FuncInst->getHostFunc());
+  FuncInst = ProcMod->findFuncExports("wasmedge_process_close_stdin");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncCloseStdIn =
+      dynamic_cast<WasmEdge::Host::WasmEdgeProcessCloseStdIn &>(
+          FuncInst->getHostFunc());
+  FuncInst = ProcMod->findFuncExports("wasmedge_process_wait");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncWait = dynamic_cast<WasmEdge::Host::WasmEdgeProcessWait &>(
+      FuncInst->getHostFunc());
+  FuncInst = ProcMod->findFuncExports("wasmedge_process_read");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncRead = dynamic_cast<WasmEdge::Host::WasmEdgeProcessRead &>(
+      FuncInst->getHostFunc());
+  FuncInst = ProcMod->findFuncExports("wasmedge_process_release");
+  ASSERT_NE(FuncInst, nullptr);
+  auto &HostFuncRelease =
+      dynamic_cast<WasmEdge::Host::WasmEdgeProcessRelease &>(
+          FuncInst->getHostFunc());
+
+  // Return value.
+  std::array<WasmEdge::ValVariant, 1> RetVal;
+
+  // Test: Spawn function failed to spawn "cat" without allowing all commands.
+  ProcMod->getEnv().AllowedAll = false;
+  ProcMod->getEnv().Name = "cat";
+  EXPECT_TRUE(HostFuncSpawn.run(DummyCallFrame, {}, RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), -1);
+  EXPECT_TRUE(ProcMod->getEnv().StdErr.size() > 0);
+
+  // Test: Spawn function successfully to spawn "cat".
+  ProcMod->getEnv().AllowedAll = true;
+  ProcMod->getEnv().Name = "cat";
+  EXPECT_TRUE(HostFuncSpawn.run(DummyCallFrame, {}, RetVal));
+  const int32_t Handle = RetVal[0].get<int32_t>();
+  EXPECT_GT(Handle, 0);
+
+  // Test: Write the stdin and close it to end the process.
+  EXPECT_TRUE(HostFuncWriteStdIn.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Handle, UINT32_C(0),
+                                                  UINT32_C(16)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 16);
+  EXPECT_TRUE(HostFuncCloseStdIn.run(
+      CallFrame, std::initializer_list<WasmEdge::ValVariant>{Handle}, RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 0);
+  EXPECT_TRUE(HostFuncWait.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Handle, UINT32_C(10000)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 0);
+
+  // Test: Read the stdout echoed by "cat".
+  EXPECT_TRUE(HostFuncRead.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Handle, UINT32_C(1),
+                                                  UINT32_C(32), UINT32_C(32)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 16);
+  EXPECT_TRUE(std::equal(MemInst.getPointer<uint8_t *>(0),
+                         MemInst.getPointer<uint8_t *>(16),
+                         MemInst.getPointer<uint8_t *>(32)));
+  EXPECT_TRUE(HostFuncRead.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Handle, UINT32_C(1),
+                                                  UINT32_C(32), UINT32_C(32)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), 0);
+
+  // Test: Release the handle.
+  EXPECT_TRUE(HostFuncRelease.run(
+      CallFrame, std::initializer_list<WasmEdge::ValVariant>{Handle}, {}));
+  EXPECT_TRUE(HostFuncRead.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Handle, UINT32_C(1),
+                                                  UINT32_C(32), UINT32_C(32)},
+      RetVal));
+  EXPECT_LT(RetVal[0].get<int32_t>(), 0);
+}
+
 TEST(WasmEdgeProcessTest, Module) {
   // Create the wasmedge_process module instance.
   auto ProcMod = createModule();
   ASSERT_TRUE(ProcMod);
 
   EXPECT_EQ(ProcMod->getEnv().ExitCode, 0U);
-  EXPECT_EQ(ProcMod->getFuncExportNum(), 11U);
+  EXPECT_EQ(ProcMod->getFuncExportNum(), 18U);
   EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_set_prog_name"),
             nullptr);
   EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_add_arg"), nullptr);
@@ -550,6 +660,13 @@ TEST(WasmEdgeProcessTest, Module) {
   EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_get_stderr_len"),
             nullptr);
   EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_get_stderr"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_spawn"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_poll"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_write_stdin"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_close_stdin"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_read"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_wait"), nullptr);
+  EXPECT_NE(ProcMod->findFuncExports("wasmedge_process_release"), nullptr);
 }
 
 GTEST_API_ int main(int argc, char **argv) {
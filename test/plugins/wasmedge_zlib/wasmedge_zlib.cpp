@@ -260,13 +260,99 @@ TEST(WasmEdgeZlibTest, DeflateInflateCycle) {
                          MemInst.getPointer<uint8_t *>(WasmData)));
 }
 
+TEST(WasmEdgeZlibTest, BatchCycle) {
+  auto ZlibMod = createModule();
+  ASSERT_TRUE(ZlibMod);
+
+  // Create the calling frame with memory instance.
+  WasmEdge::Runtime::Instance::ModuleInstance Mod("");
+  Mod.addHostMemory(
+      "memory", std::make_unique<WasmEdge::Runtime::Instance::MemoryInstance>(
+                    WasmEdge::AST::MemoryType(1, 1)));
+  auto *MemInstPtr = Mod.findMemoryExports("memory");
+  ASSERT_TRUE(MemInstPtr != nullptr);
+  auto &MemInst = *MemInstPtr;
+  WasmEdge::Runtime::CallingFrame CallFrame(nullptr, &Mod);
+
+  auto *FuncInst = ZlibMod->findFuncExports("compressBatch");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &CompressBatch =
+      dynamic_cast<WasmEdge::Host::WasmEdgeZlibCompressBatch &>(
+          FuncInst->getHostFunc());
+
+  FuncInst = ZlibMod->findFuncExports("uncompressBatch");
+  EXPECT_NE(FuncInst, nullptr);
+  EXPECT_TRUE(FuncInst->isHostFunction());
+  auto &UncompressBatch =
+      dynamic_cast<WasmEdge::Host::WasmEdgeZlibUncompressBatch &>(
+          FuncInst->getHostFunc());
+
+  std::array<WasmEdge::ValVariant, 1> RetVal;
+  constexpr uint32_t Count = 4, BufferSize = 1024;
+  constexpr uint32_t Entries = 0, Sources = 256;
+  constexpr uint32_t Compressed = Sources + Count * BufferSize;
+  constexpr uint32_t Decompressed = Compressed + Count * BufferSize;
+  auto *Entry = MemInst.getPointer<WasmZBatchEntry *>(Entries);
+  for (uint32_t I = 0; I < Count; ++I) {
+    // Buffers of different sizes and contents.
+    fillMemContent(MemInst, Sources + I * BufferSize, 100 * (I + 1),
+                   static_cast<uint8_t>('a' + I));
+    Entry[I] = {Sources + I * BufferSize, 100 * (I + 1),
+                Compressed + I * BufferSize, BufferSize, -1};
+  }
+
+  // Gzip format.
+  EXPECT_TRUE(CompressBatch.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Entries, Count, INT32_C(6),
+                                                  INT32_C(31)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), Z_OK);
+  for (uint32_t I = 0; I < Count; ++I) {
+    EXPECT_EQ(Entry[I].Result, Z_OK);
+    EXPECT_EQ(MemInst.getPointer<uint8_t *>(Entry[I].Dest)[0], 0x1f);
+    EXPECT_LT(Entry[I].DestLen, Entry[I].SourceLen);
+    Entry[I] = {Entry[I].Dest, Entry[I].DestLen, Decompressed + I * BufferSize,
+                BufferSize, -1};
+  }
+
+  EXPECT_TRUE(UncompressBatch.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Entries, Count, INT32_C(31)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), Z_OK);
+  for (uint32_t I = 0; I < Count; ++I) {
+    EXPECT_EQ(Entry[I].Result, Z_OK);
+    EXPECT_EQ(Entry[I].DestLen, 100 * (I + 1));
+    EXPECT_TRUE(std::equal(MemInst.getPointer<uint8_t *>(Entry[I].Dest),
+                           MemInst.getPointer<uint8_t *>(Entry[I].Dest +
+                                                         Entry[I].DestLen),
+                           MemInst.getPointer<uint8_t *>(Sources +
+                                                         I * BufferSize)));
+  }
+
+  // Truncated input and small output of a single buffer.
+  Entry[0] = {Compressed, Entry[0].SourceLen - 4, Decompressed, BufferSize, -1};
+  Entry[1].DestLen = 10;
+  Entry[1].Result = -1;
+  EXPECT_TRUE(UncompressBatch.run(
+      CallFrame,
+      std::initializer_list<WasmEdge::ValVariant>{Entries, UINT32_C(2),
+                                                  INT32_C(31)},
+      RetVal));
+  EXPECT_EQ(RetVal[0].get<int32_t>(), Z_DATA_ERROR);
+  EXPECT_EQ(Entry[0].Result, Z_DATA_ERROR);
+  EXPECT_EQ(Entry[1].Result, Z_BUF_ERROR);
+}
+
 TEST(WasmEdgeZlibTest, Module) {
   // Create the wasmedge_zlib module instance.
   auto ZlibMod = createModule();
   ASSERT_TRUE(ZlibMod);
 
   EXPECT_TRUE(ZlibMod->getEnv().ZStreamMap.empty());
-  EXPECT_EQ(ZlibMod->getFuncExportNum(), 76U);
+  EXPECT_EQ(ZlibMod->getFuncExportNum(), 78U);
 
   EXPECT_NE(ZlibMod->findFuncExports("deflateInit"), nullptr);
   EXPECT_NE(ZlibMod->findFuncExports("deflate"), nullptr);
@@ -344,6 +430,8 @@ TEST(WasmEdgeZlibTest, Module) {
   EXPECT_NE(ZlibMod->findFuncExports("inflateCodesUsed"), nullptr);
   EXPECT_NE(ZlibMod->findFuncExports("inflateResetKeep"), nullptr);
   EXPECT_NE(ZlibMod->findFuncExports("deflateResetKeep"), nullptr);
+  EXPECT_NE(ZlibMod->findFuncExports("compressBatch"), nullptr);
+  EXPECT_NE(ZlibMod->findFuncExports("uncompressBatch"), nullptr);
 }
 
 GTEST_API_ int main(int ArgC, char **ArgV) {
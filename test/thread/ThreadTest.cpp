@@ -13,6 +13,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/spdlog.h"
+#include "runtime/instance/memory.h"
 #include "vm/vm.h"
 
 #ifdef WASMEDGE_USE_LLVM
@@ -22,9 +23,12 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <fstream>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -228,6 +232,61 @@ TEST(AsyncExecute, GasThreadTest) {
   }
 }
 
+TEST(SharedMemory, ConcurrentGrow) {
+  using WasmEdge::Runtime::Instance::MemoryInstance;
+  // Every page is grown by one of the threads, and the pages up to the size
+  // observed by the others are always accessible.
+  MemoryInstance Mem(WasmEdge::AST::MemoryType(1, 1025, true));
+  std::array<std::vector<uint32_t>, 8> OldPages;
+  std::atomic_bool Done = false;
+  std::thread Reader([&]() {
+    uint32_t Last = 0;
+    while (!Done.load(std::memory_order_acquire)) {
+      const uint32_t Pages = Mem.getPageSize();
+      EXPECT_GE(Pages, Last);
+      EXPECT_GE(Mem.getMemoryType().getLimit().getMin(), Pages);
+      uint32_t Byte;
+      EXPECT_TRUE((Mem.loadValue<uint32_t, 1>(
+          Byte, Pages * MemoryInstance::kPageSize - 1)));
+      Last = Pages;
+    }
+  });
+  std::vector<std::thread> Growers;
+  for (uint32_t I = 0; I < OldPages.size(); ++I) {
+    Growers.emplace_back([&, I]() {
+      uint32_t Old;
+      while (Mem.growPage(1, Old)) {
+        EXPECT_GT(Mem.getPageSize(), Old);
+        EXPECT_TRUE(Mem.storeValue(I, Old * MemoryInstance::kPageSize));
+        OldPages[I].push_back(Old);
+      }
+    });
+  }
+  for (auto &Grower : Growers) {
+    Grower.join();
+  }
+  Done.store(true, std::memory_order_release);
+  Reader.join();
+
+  EXPECT_EQ(Mem.getPageSize(), 1025U);
+  EXPECT_EQ(Mem.getMemoryType().getLimit().getMin(), 1025U);
+  EXPECT_EQ(Mem.getInitialMemoryType().getLimit().getMin(), 1U);
+  EXPECT_EQ(Mem.getDataSize(), 1025U * MemoryInstance::kPageSize);
+  EXPECT_EQ(Mem.getGeneration(), 1024U);
+  std::set<uint32_t> Grown;
+  for (uint32_t I = 0; I < OldPages.size(); ++I) {
+    for (const uint32_t Old : OldPages[I]) {
+      EXPECT_TRUE(Grown.insert(Old).second);
+      uint32_t Value = 0;
+      EXPECT_TRUE(Mem.loadValue(Value, Old * MemoryInstance::kPageSize));
+      EXPECT_EQ(Value, I);
+    }
+  }
+  ASSERT_EQ(Grown.size(), 1024U);
+  EXPECT_EQ(*Grown.begin(), 1U);
+  EXPECT_EQ(*Grown.rbegin(), 1024U);
+}
+
 #ifdef WASMEDGE_USE_LLVM
 
 TEST(AOTAsyncExecute, ThreadTest) {
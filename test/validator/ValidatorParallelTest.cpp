@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/test/validator/ValidatorParallelTest.cpp - Parallel tests ===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains tests for validating the function bodies in multiple
+/// threads.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/spdlog.h"
+#include "vm/vm.h"
+
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using namespace WasmEdge;
+
+// Encode an unsigned 32-bit integer as LEB128.
+std::vector<Byte> encodeLEB128(uint32_t Value) {
+  std::vector<Byte> Leb;
+  do {
+    Byte B = Value & 0x7FU;
+    Value >>= 7;
+    if (Value != 0) {
+      B |= 0x80U;
+    }
+    Leb.push_back(B);
+  } while (Value != 0);
+  return Leb;
+}
+
+// Append a section with the content size prefix.
+void appendSection(std::vector<Byte> &Wasm, Byte Id,
+                   const std::vector<Byte> &Content) {
+  Wasm.push_back(Id);
+  auto Size = encodeLEB128(static_cast<uint32_t>(Content.size()));
+  Wasm.insert(Wasm.end(), Size.begin(), Size.end());
+  Wasm.insert(Wasm.end(), Content.begin(), Content.end());
+}
+
+// Generate a module of `(param i32) (result i32)` functions. The function K
+// returns the parameter added by K in a block. The functions in `Invalid`
+// underflow the value stack, and the ones in `BadLocal` get an undefined
+// local. The last function is exported as "f".
+std::vector<Byte> generateWasm(uint32_t FuncCount,
+                               const std::vector<uint32_t> &Invalid = {},
+                               const std::vector<uint32_t> &BadLocal = {}) {
+  std::vector<Byte> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU,
+                            0x01U, 0x00U, 0x00U, 0x00U};
+  appendSection(Wasm, 0x01U, {0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU});
+
+  std::vector<Byte> Funcs = encodeLEB128(FuncCount);
+  Funcs.insert(Funcs.end(), FuncCount, 0x00U);
+  appendSection(Wasm, 0x03U, Funcs);
+
+  std::vector<Byte> Exports = {0x01U, 0x01U, 'f', 0x00U};
+  auto LastIdx = encodeLEB128(FuncCount - 1);
+  Exports.insert(Exports.end(), LastIdx.begin(), LastIdx.end());
+  appendSection(Wasm, 0x07U, Exports);
+
+  std::vector<Byte> Codes = encodeLEB128(FuncCount);
+  for (uint32_t K = 0; K < FuncCount; ++K) {
+    std::vector<Byte> Body;
+    if (std::find(Invalid.begin(), Invalid.end(), K) != Invalid.end()) {
+      Body = {0x00U, 0x6AU, 0x0BU};
+    } else if (std::find(BadLocal.begin(), BadLocal.end(), K) !=
+               BadLocal.end()) {
+      // local.get 5 end
+      Body = {0x00U, 0x20U, 0x05U, 0x0BU};
+    } else {
+      // block (result i32) local.get 0 i32.const K i32.add end end
+      Body = {0x00U, 0x02U, 0x7FU, 0x20U, 0x00U, 0x41U};
+      Byte Imm = static_cast<Byte>(K % 64);
+      Body.push_back(Imm);
+      Body.insert(Body.end(), {0x6AU, 0x0BU, 0x0BU});
+    }
+    auto Size = encodeLEB128(static_cast<uint32_t>(Body.size()));
+    Codes.insert(Codes.end(), Size.begin(), Size.end());
+    Codes.insert(Codes.end(), Body.begin(), Body.end());
+  }
+  appendSection(Wasm, 0x0AU, Codes);
+  return Wasm;
+}
+
+Expect<void> validateWasm(const std::vector<Byte> &Wasm,
+                          uint32_t ThreadCount) {
+  Configure Conf;
+  Conf.getRuntimeConfigure().setValidationThreadCount(ThreadCount);
+  Loader::Loader Load(Conf);
+  Validator::Validator Valid(Conf);
+  EXPECTED_TRY(auto Mod, Load.parseModule(Wasm));
+  return Valid.validate(*Mod);
+}
+
+TEST(ValidatorParallelTest, ValidModule) {
+  const auto Wasm = generateWasm(200);
+  for (uint32_t ThreadCount : {1U, 4U, 0U}) {
+    EXPECT_TRUE(validateWasm(Wasm, ThreadCount));
+  }
+}
+
+TEST(ValidatorParallelTest, InvalidModule) {
+  // The failure of the smallest function index is reported, whichever of the
+  // failing bodies is validated first.
+  for (const auto &[Underflow, BadLocal, Expected] :
+       {std::make_tuple(150U, 37U, ErrCode::Value::InvalidLocalIdx),
+        std::make_tuple(37U, 150U, ErrCode::Value::TypeCheckFailed)}) {
+    const auto Wasm = generateWasm(200, {Underflow}, {BadLocal});
+    for (uint32_t ThreadCount : {1U, 4U, 0U}) {
+      auto Res = validateWasm(Wasm, ThreadCount);
+      ASSERT_FALSE(Res);
+      EXPECT_EQ(Res.error(), Expected);
+    }
+  }
+}
+
+TEST(ValidatorParallelTest, ExecuteAfterValidation) {
+  // The jump descriptors filled by the workers are used by the interpreter.
+  Configure Conf;
+  Conf.getRuntimeConfigure().setValidationThreadCount(4);
+  Conf.getRuntimeConfigure().setEnableSuperInstructions(true);
+  VM::VM VM(Conf);
+  auto Res = VM.runWasmFile(generateWasm(100), "f",
+                            std::array<ValVariant, 1>{ValVariant(1U)},
+                            std::array<ValType, 1>{TypeCode::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1U + 99U % 64U);
+}
+
+// Generate a module of a `(param i32) (result i64)` function exported as "f",
+// with 100000 i32 locals, an i64 local, and 50000 i32 locals. The function
+// returns the parameter added by the local `Last`.
+std::vector<Byte> generateLocalsWasm(uint32_t Last) {
+  std::vector<Byte> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU,
+                            0x01U, 0x00U, 0x00U, 0x00U};
+  appendSection(Wasm, 0x01U, {0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7EU});
+  appendSection(Wasm, 0x03U, {0x01U, 0x00U});
+  appendSection(Wasm, 0x07U, {0x01U, 0x01U, 'f', 0x00U, 0x00U});
+
+  std::vector<Byte> Body = {0x03U};
+  auto Append = [&Body](const std::vector<Byte> &Bytes) {
+    Body.insert(Body.end(), Bytes.begin(), Bytes.end());
+  };
+  Append(encodeLEB128(100000));
+  Append({0x7FU, 0x01U, 0x7EU});
+  Append(encodeLEB128(50000));
+  Append({0x7FU});
+  // local.get 0 i64.extend_i32_u local.set 100001 local.get 100001
+  // local.get Last i64.extend_i32_u i64.add end
+  Append({0x20U, 0x00U, 0xADU, 0x21U});
+  Append(encodeLEB128(100001));
+  Append({0x20U});
+  Append(encodeLEB128(100001));
+  Append({0x20U});
+  Append(encodeLEB128(Last));
+  Append({0xADU, 0x7CU, 0x0BU});
+
+  std::vector<Byte> Codes = {0x01U};
+  auto Size = encodeLEB128(static_cast<uint32_t>(Body.size()));
+  Codes.insert(Codes.end(), Size.begin(), Size.end());
+  Codes.insert(Codes.end(), Body.begin(), Body.end());
+  appendSection(Wasm, 0x0AU, Codes);
+  return Wasm;
+}
+
+TEST(ValidatorParallelTest, LocalGroups) {
+  // The locals are looked up in the groups and zeroed when entering.
+  EXPECT_TRUE(validateWasm(generateLocalsWasm(150001), 1));
+  EXPECT_FALSE(validateWasm(generateLocalsWasm(150002), 1));
+  // The i64 local is not an i32.
+  EXPECT_FALSE(validateWasm(generateLocalsWasm(100001), 1));
+
+  VM::VM VM(Configure{});
+  auto Res = VM.runWasmFile(generateLocalsWasm(150001), "f",
+                            std::array<ValVariant, 1>{ValVariant(7U)},
+                            std::array<ValType, 1>{TypeCode::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint64_t>(), 7U);
+}
+
+TEST(ValidatorParallelTest, FusedValidation) {
+  // The invalid body fails when loaded, and the fused bodies are executed
+  // after skipped in the validation.
+  Configure Conf;
+  Conf.getRuntimeConfigure().setEnableFusedValidation(true);
+  Conf.getRuntimeConfigure().setEnableSuperInstructions(true);
+  VM::VM VM(Conf);
+  EXPECT_FALSE(VM.loadWasm(generateWasm(200, {150, 37})));
+  auto Res = VM.runWasmFile(generateWasm(100), "f",
+                            std::array<ValVariant, 1>{ValVariant(1U)},
+                            std::array<ValType, 1>{TypeCode::I32});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ((*Res)[0].first.get<uint32_t>(), 1U + 99U % 64U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  WasmEdge::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
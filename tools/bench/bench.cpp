@@ -0,0 +1,640 @@
+// SPDX-License-Identifier: Apache-2.0
+// SPDX-FileCopyrightText: 2019-2024 Second State INC
+
+//===-- wasmedge/tools/bench/bench.cpp - Benchmark harness ----------------===//
+//
+// Part of the WasmEdge Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the benchmark harness of the runtime. It runs the
+/// micro-benchmarks of the embedded modules and the macro-benchmarks of the
+/// given WASI command modules in the interpreter, JIT, and AOT modes, and
+/// reports the time per operation in JSON.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/spdlog.h"
+#include "common/version.h"
+#include "host/wasi/wasimodule.h"
+#include "loader/loader.h"
+#include "po/argument_parser.h"
+#include "runtime/callingframe.h"
+#include "runtime/instance/module.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#ifdef WASMEDGE_USE_LLVM
+#include "llvm/codegen.h"
+#include "llvm/compiler.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace std::literals;
+using namespace WasmEdge;
+
+// (module
+//   (func (export "run") (param $n i32) (result i32) (local $acc i32)
+//     (loop $l
+//       (local.set $acc (i32.xor (i32.add (i32.mul (local.get $acc)
+//         (i32.const 31)) (local.get $n)) (i32.shr_u (local.get $acc)
+//         (i32.const 3))))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $acc)))
+const std::array<Byte, 67> kDispatchWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01, 0x03,
+    0x72, 0x75, 0x6e, 0x00, 0x00, 0x0a, 0x24, 0x01, 0x22, 0x01, 0x01, 0x7f,
+    0x03, 0x40, 0x20, 0x01, 0x41, 0x1f, 0x6c, 0x20, 0x00, 0x6a, 0x20, 0x01,
+    0x41, 0x03, 0x76, 0x73, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22,
+    0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b};
+
+// (module
+//   (import "bench" "echo" (func $echo (param i32) (result i32)))
+//   (func (export "run") (param $n i32) (result i32) (local $acc i32)
+//     (loop $l
+//       (local.set $acc (call $echo (i32.add (local.get $acc) (i32.const 1))))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $acc)))
+const std::array<Byte, 76> kHostCallWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0e, 0x01, 0x05, 0x62, 0x65, 0x6e, 0x63,
+    0x68, 0x04, 0x65, 0x63, 0x68, 0x6f, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00,
+    0x07, 0x07, 0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x1d, 0x01,
+    0x1b, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x10,
+    0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00,
+    0x0b, 0x20, 0x01, 0x0b};
+
+// (module
+//   (memory 1)
+//   (func (export "load_store") (param $n i32) (result i32) (local $acc i32)
+//     (loop $l
+//       (i32.store (i32.and (local.get $n) (i32.const 0xfffc))
+//         (local.tee $acc (i32.add (local.get $acc)
+//           (i32.load (i32.and (i32.mul (local.get $n) (i32.const 4))
+//             (i32.const 0xfffc))))))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $acc))
+//   (func (export "bulk") (param $n i32) (result i32)
+//     (loop $l
+//       (memory.copy (i32.const 0) (i32.const 32768) (i32.const 4096))
+//       (memory.fill (i32.const 8192) (local.get $n) (i32.const 4096))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (i32.const 0)))
+const std::array<Byte, 141> kMemoryWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x05, 0x03, 0x01,
+    0x00, 0x01, 0x07, 0x15, 0x02, 0x0a, 0x6c, 0x6f, 0x61, 0x64, 0x5f, 0x73,
+    0x74, 0x6f, 0x72, 0x65, 0x00, 0x00, 0x04, 0x62, 0x75, 0x6c, 0x6b, 0x00,
+    0x01, 0x0a, 0x5a, 0x02, 0x2e, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x00,
+    0x41, 0xfc, 0xff, 0x03, 0x71, 0x20, 0x01, 0x20, 0x00, 0x41, 0x04, 0x6c,
+    0x41, 0xfc, 0xff, 0x03, 0x71, 0x28, 0x02, 0x00, 0x6a, 0x22, 0x01, 0x36,
+    0x02, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b,
+    0x20, 0x01, 0x0b, 0x29, 0x00, 0x03, 0x40, 0x41, 0x00, 0x41, 0x80, 0x80,
+    0x02, 0x41, 0x80, 0x20, 0xfc, 0x0a, 0x00, 0x00, 0x41, 0x80, 0xc0, 0x00,
+    0x20, 0x00, 0x41, 0x80, 0x20, 0xfc, 0x0b, 0x00, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x41, 0x00, 0x0b};
+
+// (module
+//   (type $t (func (param i32) (result i32)))
+//   (table 4 funcref)
+//   (elem (i32.const 0) $f1 $f2 $f3 $f4)
+//   (func $fK (type $t) (i32.add (local.get 0) (i32.const K)))
+//   (func (export "run") (param $n i32) (result i32) (local $acc i32)
+//     (loop $l
+//       (local.set $acc (call_indirect (type $t) (local.get $acc)
+//         (i32.and (local.get $n) (i32.const 3))))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $acc)))
+const std::array<Byte, 117> kCallIndirectWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x04, 0x01, 0x70, 0x00, 0x04, 0x07, 0x07, 0x01, 0x03, 0x72, 0x75,
+    0x6e, 0x00, 0x04, 0x09, 0x0a, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x04, 0x00,
+    0x01, 0x02, 0x03, 0x0a, 0x40, 0x05, 0x07, 0x00, 0x20, 0x00, 0x41, 0x01,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x02, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x03, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x04,
+    0x6a, 0x0b, 0x1e, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00,
+    0x41, 0x03, 0x71, 0x11, 0x00, 0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b};
+
+// (module
+//   (memory 16)
+//   (table 64 funcref)
+//   (global $g0 (mut i32) (i32.const 0)) ... (global $g3 ...)
+//   (func $f0 (export "f0") (param i32) (result i32)
+//     (i32.add (local.get 0) (i32.const 0)))
+//   ... (func $f15 (export "f15") ...)
+//   (elem (i32.const 0) $f0 ... $f15)
+//   (data (i32.const 0) "\00\01\02 ... \3f"))
+const std::array<Byte, 386> kInstantiateWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x11, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04,
+    0x04, 0x01, 0x70, 0x00, 0x40, 0x05, 0x03, 0x01, 0x00, 0x10, 0x06, 0x15,
+    0x04, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x7f,
+    0x01, 0x41, 0x00, 0x0b, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x57, 0x10,
+    0x02, 0x66, 0x30, 0x00, 0x00, 0x02, 0x66, 0x31, 0x00, 0x01, 0x02, 0x66,
+    0x32, 0x00, 0x02, 0x02, 0x66, 0x33, 0x00, 0x03, 0x02, 0x66, 0x34, 0x00,
+    0x04, 0x02, 0x66, 0x35, 0x00, 0x05, 0x02, 0x66, 0x36, 0x00, 0x06, 0x02,
+    0x66, 0x37, 0x00, 0x07, 0x02, 0x66, 0x38, 0x00, 0x08, 0x02, 0x66, 0x39,
+    0x00, 0x09, 0x03, 0x66, 0x31, 0x30, 0x00, 0x0a, 0x03, 0x66, 0x31, 0x31,
+    0x00, 0x0b, 0x03, 0x66, 0x31, 0x32, 0x00, 0x0c, 0x03, 0x66, 0x31, 0x33,
+    0x00, 0x0d, 0x03, 0x66, 0x31, 0x34, 0x00, 0x0e, 0x03, 0x66, 0x31, 0x35,
+    0x00, 0x0f, 0x09, 0x16, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x10, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+    0x0e, 0x0f, 0x0a, 0x81, 0x01, 0x10, 0x07, 0x00, 0x20, 0x00, 0x41, 0x00,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x02, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x03,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x04, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x05, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x06,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x07, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x08, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x09,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x0a, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x0b, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x0c,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x0d, 0x6a, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x41, 0x0e, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x0f,
+    0x6a, 0x0b, 0x0b, 0x46, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x40, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d,
+    0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+    0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25,
+    0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31,
+    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d,
+    0x3e, 0x3f};
+
+// (module
+//   (import "wasi_snapshot_preview1" "fd_fdstat_get"
+//     (func $fdstat (param i32 i32) (result i32)))
+//   (memory (export "memory") 1)
+//   (func (export "run") (param $n i32) (result i32) (local $acc i32)
+//     (loop $l
+//       (local.set $acc (i32.add (local.get $acc)
+//         (call $fdstat (i32.const 1) (i32.const 0))))
+//       (br_if $l (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+//     (local.get $acc)))
+const std::array<Byte, 124> kWasiWasm{
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x28,
+    0x01, 0x16, 0x77, 0x61, 0x73, 0x69, 0x5f, 0x73, 0x6e, 0x61, 0x70, 0x73,
+    0x68, 0x6f, 0x74, 0x5f, 0x70, 0x72, 0x65, 0x76, 0x69, 0x65, 0x77, 0x31,
+    0x0d, 0x66, 0x64, 0x5f, 0x66, 0x64, 0x73, 0x74, 0x61, 0x74, 0x5f, 0x67,
+    0x65, 0x74, 0x00, 0x00, 0x03, 0x02, 0x01, 0x01, 0x05, 0x03, 0x01, 0x00,
+    0x01, 0x07, 0x10, 0x02, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02,
+    0x00, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x1f, 0x01, 0x1d, 0x01,
+    0x01, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x41, 0x01, 0x41, 0x00, 0x10, 0x00,
+    0x6a, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00,
+    0x0b, 0x20, 0x01, 0x0b};
+
+class BenchEcho : public Runtime::HostFunction<BenchEcho> {
+public:
+  Expect<uint32_t> body(const Runtime::CallingFrame &, uint32_t Value) {
+    return Value;
+  }
+};
+
+class BenchModule : public Runtime::Instance::ModuleInstance {
+public:
+  BenchModule() : ModuleInstance("bench") {
+    addHostFunc("echo", std::make_unique<BenchEcho>());
+  }
+};
+
+enum class Mode : uint8_t { Interpreter, JIT, AOT };
+
+std::string_view getModeName(Mode M) noexcept {
+  switch (M) {
+  case Mode::Interpreter:
+    return "interpreter"sv;
+  case Mode::JIT:
+    return "jit"sv;
+  case Mode::AOT:
+    return "aot"sv;
+  default:
+    assumingUnreachable();
+  }
+}
+
+/// Samples of a benchmark in nanoseconds per operation.
+struct Result {
+  std::string Name;
+  Mode M;
+  uint64_t Iterations = 0;
+  std::vector<double> Samples;
+  std::optional<ErrCode> Error;
+};
+
+/// Options of the benchmark runs.
+struct Options {
+  std::vector<Mode> Modes;
+  std::string Filter;
+  uint32_t Repetitions;
+  double Scale;
+  std::filesystem::path WorkDir;
+};
+
+/// Runner of the benchmarks in one mode. The modules are compiled into the
+/// work directory in the AOT mode, and by the JIT compiler in the JIT mode.
+class Runner {
+public:
+  Runner(const Options &O, Mode M) noexcept : Opt(O), M(M) {
+    if (M == Mode::JIT) {
+      Conf.getRuntimeConfigure().setEnableJIT(true);
+    }
+  }
+
+  /// Run the loop of the exported function with the iteration count, and
+  /// sample the time per iteration.
+  Result runLoop(std::string_view Name, Span<const Byte> Wasm,
+                 std::string_view Func, uint64_t Iterations, bool IsWasi) {
+    Result Res = makeResult(Name, Iterations);
+    BenchModule HostMod;
+    Configure LocalConf = Conf;
+    if (IsWasi) {
+      LocalConf.addHostRegistration(HostRegistration::Wasi);
+    }
+    VM::VM VM(LocalConf);
+    auto Run = [&]() -> Expect<void> {
+      EXPECTED_TRY(VM.registerModule(HostMod));
+      if (IsWasi) {
+        auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+            VM.getImportModule(HostRegistration::Wasi));
+        WasiMod->init({}, "wasmedge-bench"s, {}, {});
+      }
+      EXPECTED_TRY(load(VM, Name, Wasm));
+      EXPECTED_TRY(VM.validate());
+      EXPECTED_TRY(VM.instantiate());
+      const std::vector<ValType> Types = {ValType(TypeCode::I32)};
+      const auto Count = static_cast<uint32_t>(Iterations);
+      // Warm up, which also triggers the tiered-up compilations.
+      EXPECTED_TRY(VM.execute(
+          Func, std::vector<ValVariant>{std::max(Count / 10, 1U)}, Types));
+      for (uint32_t I = 0; I < Opt.Repetitions; ++I) {
+        const auto Start = Clock::now();
+        EXPECTED_TRY(
+            VM.execute(Func, std::vector<ValVariant>{Count}, Types));
+        Res.Samples.push_back(perOp(Clock::now() - Start, Iterations));
+      }
+      return {};
+    };
+    if (auto Status = Run(); !Status) {
+      Res.Error = Status.error();
+    }
+    return Res;
+  }
+
+  /// Sample the time of instantiating the module and tearing down the
+  /// previous instance.
+  Result runInstantiate(std::string_view Name, Span<const Byte> Wasm,
+                        uint64_t Iterations) {
+    Result Res = makeResult(Name, Iterations);
+    VM::VM VM(Conf);
+    auto Run = [&]() -> Expect<void> {
+      EXPECTED_TRY(load(VM, Name, Wasm));
+      EXPECTED_TRY(VM.validate());
+      EXPECTED_TRY(VM.instantiate());
+      for (uint32_t I = 0; I < Opt.Repetitions; ++I) {
+        const auto Start = Clock::now();
+        for (uint64_t J = 0; J < Iterations; ++J) {
+          EXPECTED_TRY(VM.instantiate());
+        }
+        Res.Samples.push_back(perOp(Clock::now() - Start, Iterations));
+      }
+      return {};
+    };
+    if (auto Status = Run(); !Status) {
+      Res.Error = Status.error();
+    }
+    return Res;
+  }
+
+  /// Sample the time of loading, validating, and instantiating the compiled
+  /// shared library. Only for the AOT mode.
+  Result runAOTLoad(std::string_view Name, Span<const Byte> Wasm,
+                    uint64_t Iterations) {
+    Result Res = makeResult(Name, Iterations);
+    auto Run = [&]() -> Expect<void> {
+      EXPECTED_TRY(const auto Path, compile(Name, Wasm));
+      for (uint32_t I = 0; I < Opt.Repetitions; ++I) {
+        const auto Start = Clock::now();
+        for (uint64_t J = 0; J < Iterations; ++J) {
+          VM::VM VM(Conf);
+          EXPECTED_TRY(VM.loadWasm(Path));
+          EXPECTED_TRY(VM.validate());
+          EXPECTED_TRY(VM.instantiate());
+        }
+        Res.Samples.push_back(perOp(Clock::now() - Start, Iterations));
+      }
+      return {};
+    };
+    if (auto Status = Run(); !Status) {
+      Res.Error = Status.error();
+    }
+    return Res;
+  }
+
+  /// Sample the time of running the `_start` function of the WASI module,
+  /// including the loading and the instantiation.
+  Result runCommand(const std::filesystem::path &Path) {
+    Result Res = makeResult(Path.filename().u8string(), 1);
+    auto Run = [&]() -> Expect<void> {
+      Loader::Loader Loader(Conf);
+      EXPECTED_TRY(const auto Wasm, Loader.loadFile(Path));
+      // The compilation of the AOT mode is not measured.
+      std::filesystem::path SOPath;
+      if (M == Mode::AOT) {
+        EXPECTED_TRY(SOPath, compile(Res.Name, Wasm));
+      }
+      for (uint32_t I = 0; I <= Opt.Repetitions; ++I) {
+        Configure LocalConf = Conf;
+        LocalConf.addHostRegistration(HostRegistration::Wasi);
+        VM::VM VM(LocalConf);
+        auto *WasiMod = dynamic_cast<Host::WasiModule *>(
+            VM.getImportModule(HostRegistration::Wasi));
+        WasiMod->init({}, Path.filename().u8string(), {}, {});
+        const auto Start = Clock::now();
+        if (M == Mode::AOT) {
+          EXPECTED_TRY(VM.loadWasm(SOPath));
+        } else {
+          EXPECTED_TRY(VM.loadWasm(Wasm));
+        }
+        EXPECTED_TRY(VM.validate());
+        EXPECTED_TRY(VM.instantiate());
+        EXPECTED_TRY(VM.execute("_start"sv));
+        // The first run is the warm-up.
+        if (I > 0) {
+          Res.Samples.push_back(perOp(Clock::now() - Start, 1));
+        }
+      }
+      return {};
+    };
+    if (auto Status = Run(); !Status) {
+      Res.Error = Status.error();
+    }
+    return Res;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static double perOp(Clock::duration Time, uint64_t Iterations) noexcept {
+    return static_cast<double>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(Time)
+                   .count()) /
+           static_cast<double>(Iterations);
+  }
+
+  Result makeResult(std::string_view Name, uint64_t Iterations) const {
+    Result Res;
+    Res.Name = Name;
+    Res.M = M;
+    Res.Iterations = Iterations;
+    return Res;
+  }
+
+  /// Load the module into the VM, or the compiled shared library in the AOT
+  /// mode.
+  Expect<void> load(VM::VM &VM, std::string_view Name, Span<const Byte> Wasm) {
+    if (M == Mode::AOT) {
+      EXPECTED_TRY(const auto Path, compile(Name, Wasm));
+      return VM.loadWasm(Path);
+    }
+    return VM.loadWasm(Wasm);
+  }
+
+  /// Compile the module into a shared library in the work directory.
+  Expect<std::filesystem::path> compile(std::string_view Name,
+                                        Span<const Byte> Wasm) {
+#ifdef WASMEDGE_USE_LLVM
+    auto Path = Opt.WorkDir / std::filesystem::u8path(
+                                  std::string(Name) + WASMEDGE_LIB_EXTENSION);
+    Configure CompilerConf = Conf;
+    CompilerConf.getCompilerConfigure().setOutputFormat(
+        CompilerConfigure::OutputFormat::Native);
+    Loader::Loader Loader(CompilerConf);
+    Validator::Validator Validator(CompilerConf);
+    LLVM::Compiler Compiler(CompilerConf);
+    LLVM::CodeGen CodeGen(CompilerConf);
+    EXPECTED_TRY(auto Mod, Loader.parseModule(Wasm));
+    EXPECTED_TRY(Validator.validate(*Mod));
+    EXPECTED_TRY(Compiler.checkConfigure());
+    EXPECTED_TRY(auto Data, Compiler.compile(*Mod));
+    EXPECTED_TRY(CodeGen.codegen(Wasm, std::move(Data), Path));
+    return Path;
+#else
+    static_cast<void>(Name);
+    static_cast<void>(Wasm);
+    return Unexpect(ErrCode::Value::InvalidAOTConfigure);
+#endif
+  }
+
+  const Options &Opt;
+  const Mode M;
+  Configure Conf;
+};
+
+/// Statistics of the samples.
+struct Summary {
+  double Min;
+  double Median;
+  double Mean;
+};
+
+Summary summarize(std::vector<double> Samples) noexcept {
+  std::sort(Samples.begin(), Samples.end());
+  const size_t Size = Samples.size();
+  const double Median =
+      Size % 2 ? Samples[Size / 2]
+               : (Samples[Size / 2 - 1] + Samples[Size / 2]) / 2.0;
+  const double Sum = std::accumulate(Samples.begin(), Samples.end(), 0.0);
+  return {Samples.front(), Median, Sum / static_cast<double>(Size)};
+}
+
+void printJSON(std::FILE *Out, const Options &Opt,
+               const std::vector<Result> &Results) {
+  fmt::print(Out, "{{\n  \"version\": \"{}\",\n"sv, kVersionString);
+  fmt::print(Out, "  \"repetitions\": {},\n  \"scale\": {},\n"sv,
+             Opt.Repetitions, Opt.Scale);
+  fmt::print(Out, "  \"benchmarks\": ["sv);
+  for (size_t I = 0; I < Results.size(); ++I) {
+    const auto &Res = Results[I];
+    fmt::print(Out, "{}\n    {{\"name\": \"{}\", \"mode\": \"{}\""sv,
+               I ? ","sv : ""sv, Res.Name, getModeName(Res.M));
+    if (Res.Error) {
+      fmt::print(Out, ", \"error\": \"{}\"}}"sv,
+                 ErrCodeStr[Res.Error->getEnum()]);
+      continue;
+    }
+    const auto Sum = summarize(Res.Samples);
+    fmt::print(Out,
+               ", \"iterations\": {}, \"unit\": \"ns/op\", \"min\": {:.3f}, "
+               "\"median\": {:.3f}, \"mean\": {:.3f}}}"sv,
+               Res.Iterations, Sum.Min, Sum.Median, Sum.Mean);
+  }
+  fmt::print(Out, "\n  ]\n}}\n"sv);
+}
+
+} // namespace
+
+int main(int Argc, const char *Argv[]) {
+  std::ios::sync_with_stdio(false);
+  Log::setErrorLoggingLevel();
+
+  PO::List<std::string> Files(
+      PO::Description("WASI command modules to run as the macro-benchmarks"sv),
+      PO::MetaVar("WASM"sv));
+  PO::List<std::string> Modes(
+      PO::Description("Execution modes to benchmark: interpreter, jit, or "
+                      "aot. All available modes by default."sv),
+      PO::MetaVar("MODE"sv));
+  PO::Option<std::string> Filter(
+      PO::Description("Only run the benchmarks whose names contain the "
+                      "string."sv),
+      PO::MetaVar("NAME"sv));
+  PO::Option<uint32_t> Repetitions(
+      PO::Description("Count of the measured repetitions of every "
+                      "benchmark."sv),
+      PO::MetaVar("COUNT"sv), PO::DefaultValue<uint32_t>(5));
+  PO::Option<double> Scale(
+      PO::Description("Multiplier of the iteration counts."sv),
+      PO::MetaVar("SCALE"sv), PO::DefaultValue<double>(1.0));
+  PO::Option<std::string> Output(
+      PO::Description("Write the JSON results into the file instead of the "
+                      "standard output."sv),
+      PO::MetaVar("FILE"sv));
+
+  auto Parser = PO::ArgumentParser();
+  Parser.add_option(Files)
+      .add_option("mode"sv, Modes)
+      .add_option("filter"sv, Filter)
+      .add_option("repetitions"sv, Repetitions)
+      .add_option("scale"sv, Scale)
+      .add_option("output"sv, Output);
+  if (!Parser.parse(stdout, Argc, Argv)) {
+    return EXIT_FAILURE;
+  }
+  if (Parser.isHelp() || Parser.isVersion()) {
+    return EXIT_SUCCESS;
+  }
+
+  Options Opt;
+  Opt.Filter = Filter.value();
+  Opt.Repetitions = std::max(Repetitions.value(), 1U);
+  Opt.Scale = Scale.value() > 0.0 ? Scale.value() : 1.0;
+  for (const auto &Name : Modes.value()) {
+    if (Name == "interpreter"sv) {
+      Opt.Modes.push_back(Mode::Interpreter);
+    } else if (Name == "jit"sv || Name == "aot"sv) {
+#ifdef WASMEDGE_USE_LLVM
+      Opt.Modes.push_back(Name == "jit"sv ? Mode::JIT : Mode::AOT);
+#else
+      spdlog::error("LLVM disabled, the {} mode is unsupported."sv, Name);
+      return EXIT_FAILURE;
+#endif
+    } else {
+      spdlog::error("Unknown mode {}."sv, Name);
+      return EXIT_FAILURE;
+    }
+  }
+  if (Opt.Modes.empty()) {
+    Opt.Modes.push_back(Mode::Interpreter);
+#ifdef WASMEDGE_USE_LLVM
+    Opt.Modes.push_back(Mode::JIT);
+    Opt.Modes.push_back(Mode::AOT);
+#endif
+  }
+
+  std::error_code Error;
+  Opt.WorkDir =
+      std::filesystem::temp_directory_path(Error) /
+      std::filesystem::u8path("wasmedge-bench-"s +
+                              std::to_string(std::random_device()()));
+  std::filesystem::create_directories(Opt.WorkDir, Error);
+
+  auto Count = [&Opt](uint64_t Base) {
+    const double Scaled = static_cast<double>(Base) * Opt.Scale;
+    return std::clamp<uint64_t>(static_cast<uint64_t>(std::min(
+                                    Scaled, static_cast<double>(UINT32_MAX))),
+                                1, UINT32_MAX);
+  };
+  auto Selected = [&Opt](std::string_view Name) {
+    return Name.find(Opt.Filter) != std::string_view::npos;
+  };
+
+  std::vector<Result> Results;
+  for (const auto M : Opt.Modes) {
+    Runner R(Opt, M);
+    if (Selected("dispatch"sv)) {
+      Results.push_back(R.runLoop("dispatch"sv, kDispatchWasm, "run"sv,
+                                  Count(10000000), false));
+    }
+    if (Selected("host_call"sv)) {
+      Results.push_back(R.runLoop("host_call"sv, kHostCallWasm, "run"sv,
+                                  Count(1000000), false));
+    }
+    if (Selected("memory_load_store"sv)) {
+      Results.push_back(R.runLoop("memory_load_store"sv, kMemoryWasm,
+                                  "load_store"sv, Count(10000000), false));
+    }
+    if (Selected("memory_bulk"sv)) {
+      Results.push_back(R.runLoop("memory_bulk"sv, kMemoryWasm, "bulk"sv,
+                                  Count(100000), false));
+    }
+    if (Selected("call_indirect"sv)) {
+      Results.push_back(R.runLoop("call_indirect"sv, kCallIndirectWasm, "run"sv,
+                                  Count(1000000), false));
+    }
+    if (Selected("wasi_fdstat"sv)) {
+      Results.push_back(R.runLoop("wasi_fdstat"sv, kWasiWasm, "run"sv,
+                                  Count(100000), true));
+    }
+    if (Selected("instantiate"sv)) {
+      Results.push_back(
+          R.runInstantiate("instantiate"sv, kInstantiateWasm, Count(1000)));
+    }
+    if (M == Mode::AOT && Selected("aot_load"sv)) {
+      Results.push_back(
+          R.runAOTLoad("aot_load"sv, kInstantiateWasm, Count(100)));
+    }
+    for (const auto &File : Files.value()) {
+      const auto Path = std::filesystem::u8path(File);
+      if (Selected(Path.filename().u8string())) {
+        Results.push_back(R.runCommand(Path));
+      }
+    }
+  }
+  std::filesystem::remove_all(Opt.WorkDir, Error);
+
+  if (Output.value().empty()) {
+    printJSON(stdout, Opt, Results);
+  } else {
+    std::FILE *Out = std::fopen(Output.value().c_str(), "w");
+    if (!Out) {
+      spdlog::error("Failed to open the output file {}."sv, Output.value());
+      return EXIT_FAILURE;
+    }
+    printJSON(Out, Opt, Results);
+    std::fclose(Out);
+  }
+  return std::any_of(Results.begin(), Results.end(),
+                     [](const Result &Res) { return Res.Error.has_value(); })
+             ? EXIT_FAILURE
+             : EXIT_SUCCESS;
+}